@@ -135,3 +135,82 @@ msg_t tsInvokeServiceNoYield(ts_service_t handle, ts_params_area_t data,
   }
   return result;
 }
+
+/**
+ * @brief   Initializes a requests ring.
+ *
+ * @param[out] ringp        Pointer to the ring, it must be large
+ *                          TS_RING_SIZE(n) bytes.
+ * @param[in] n             Number of requests slots.
+ *
+ * @api
+ */
+void tsRingInit(ts_ring_t *ringp, uint32_t n)
+{
+  ringp->ts_size = n;
+  ringp->ts_wridx = 0;
+  ringp->ts_rdidx = 0;
+}
+
+/**
+ * @brief   Posts a request in a requests ring.
+ * @details The request is not executed until the ring is passed to
+ *          @p tsInvokeBatch().
+ *
+ * @param[in] ringp         Pointer to the ring.
+ * @param[in] handle        The handle of the service to invoke.
+ * @param[in,out] data      Service request data.
+ * @param[in] size          Size of the data memory area.
+ *
+ * @return                  The posted request, its status is valid after
+ *                          the batch completion.
+ * @retval NULL             if the ring is full.
+ *
+ * @api
+ */
+ts_request_t *tsRingPost(ts_ring_t *ringp, ts_service_t handle,
+                         ts_params_area_t data, size_t size)
+{
+  ts_request_t *reqp;
+
+  if ((ringp->ts_wridx - ringp->ts_rdidx) >= ringp->ts_size)
+    return NULL;
+  reqp = &ringp->ts_reqs[ringp->ts_wridx % ringp->ts_size];
+  reqp->ts_handle = handle;
+  reqp->ts_datap = data;
+  reqp->ts_datalen = size;
+  reqp->ts_status = SMC_SVC_OK;
+  ringp->ts_wridx++;
+  return reqp;
+}
+
+/**
+ * @brief   Executes all the requests posted in a ring.
+ * @details The requests are served by the secure world in batches, each
+ *          smc call processes as many requests as possible within the
+ *          granted time slice. No requests must be posted meanwhile.
+ *
+ * @param[in] ringp         Pointer to the ring.
+ * @param[in] size          Size of the ring memory area.
+ *
+ * @return                  The batch status, the status of the single
+ *                          requests is in the ring.
+ *
+ * @retval SMC_SVC_OK       all requests processed.
+ * @retval SMC_SVC_INVALID  bad ring.
+ *
+ * @api
+ */
+msg_t tsInvokeBatch(ts_ring_t *ringp, size_t size)
+{
+  msg_t result;
+
+  result = tsInvoke1(TS_HND_BATCH, (ts_params_area_t)ringp, size,
+                     TS_GRANTED_TIMESLICE);
+  while (result == SMC_SVC_INTR) {
+    chThdSleepMicroseconds(TS_GRANTED_TIMESLICE);
+    result = tsInvoke1(TS_HND_BATCH, (ts_params_area_t)ringp, size,
+                       TS_GRANTED_TIMESLICE);
+  }
+  return result;
+}
@@ -43,6 +43,7 @@
 #define TS_HND_DISCOVERY      ((ts_service_t *)1)  /* Discovery service handle.*/
 #define TS_HND_STQRY          ((ts_service_t *)2)  /* Query status service handle.*/
 #define TS_HND_IDLE           ((ts_service_t *)3)  /* Idle service handle.*/
+#define TS_HND_BATCH          ((ts_service_t *)5)  /* Batch of requests service handle.*/
 
 /*===========================================================================*/
 /* Module pre-compile time settings.                                         */
@@ -69,6 +70,33 @@
 typedef uint8_t * ts_params_area_t;
 typedef void * ts_service_t;
 
+/**
+ * @brief   Type of a batched service request.
+ * @note    Must match the secure side definition.
+ */
+typedef struct tssi_request {
+  ts_service_t        ts_handle;      /* Handle of the invoked service.*/
+  ts_params_area_t    ts_datap;       /* Service request data.*/
+  uint32_t            ts_datalen;     /* Size of the service request data.*/
+  int32_t             ts_status;      /* Service status.*/
+} ts_request_t;
+
+/**
+ * @brief   Type of a requests ring shared with the secure world.
+ * @note    Must match the secure side definition.
+ */
+typedef struct tssi_ring {
+  uint32_t            ts_size;        /* Number of requests slots.*/
+  uint32_t            ts_wridx;       /* Next slot to be posted.*/
+  uint32_t            ts_rdidx;       /* Next slot to be processed.*/
+  ts_request_t        ts_reqs[];      /* Requests slots.*/
+} ts_ring_t;
+
+/**
+ * @brief   Size of a requests ring with n slots.
+ */
+#define TS_RING_SIZE(n)       (sizeof (ts_ring_t) + (n) * sizeof (ts_request_t))
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -164,6 +192,10 @@ extern "C" {
                           size_t size);
   msg_t tsInvokeServiceNoYield(ts_service_t handle, ts_params_area_t data,
                                  size_t size);
+  void tsRingInit(ts_ring_t *ringp, uint32_t n);
+  ts_request_t *tsRingPost(ts_ring_t *ringp, ts_service_t handle,
+                           ts_params_area_t data, size_t size);
+  msg_t tsInvokeBatch(ts_ring_t *ringp, size_t size);
   extern event_source_t stubsEventSource;
 #ifdef __cplusplus
 }
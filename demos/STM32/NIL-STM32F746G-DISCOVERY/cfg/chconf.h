@@ -43,7 +43,14 @@
  * @note    This number is not inclusive of the idle thread which is
  *          Implicitly handled.
  */
-#define CH_CFG_NUM_THREADS                  3
+#define CH_CFG_NUM_THREADS                  4
+
+/**
+ * @brief   Number of run-to-completion tasks in the application.
+ * @note    Tasks are executed by the @p chTaskDispatcher() thread, zero
+ *          disables the tasks support.
+ */
+#define CH_CFG_NUM_TASKS                    2
 
 /** @} */
 
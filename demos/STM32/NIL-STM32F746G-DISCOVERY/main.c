@@ -73,10 +73,20 @@ THD_FUNCTION(Thread2, arg) {
  */
 THD_TABLE_BEGIN
   THD_TABLE_ENTRY(waThread1, "blinker1", Thread1, NULL)
-  THD_TABLE_ENTRY(wa_test_support, "test_support", test_support, (void *)&nil.threads[2])
+  THD_TABLE_ENTRY(wa_test_support, "test_support", test_support, (void *)&nil.threads[3])
+  THD_TABLE_ENTRY(wa_test_dispatcher, "tasks", chTaskDispatcher, NULL)
   THD_TABLE_ENTRY(waThread2, "tester", Thread2, NULL)
 THD_TABLE_END
 
+/*
+ * Tasks static table, one entry per task. The number of entries must
+ * match CH_CFG_NUM_TASKS.
+ */
+TASK_TABLE_BEGIN
+  TASK_TABLE_ENTRY("A", test_task, (void *)'A')
+  TASK_TABLE_ENTRY("B", test_task, (void *)'B')
+TASK_TABLE_END
+
 /*
  * Application entry point.
  */
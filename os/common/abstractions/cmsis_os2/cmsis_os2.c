@@ -0,0 +1,1508 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    cmsis_os2.c
+ * @brief   CMSIS RTOS2 module code.
+ *
+ * @addtogroup CMSIS_OS2
+ * @{
+ */
+
+#include "cmsis_os2.h"
+#include <string.h>
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Kernel version encoded for CMSIS.
+ */
+#define CMSIS_OS2_KERNEL_VERSION    (((uint32_t)CH_KERNEL_MAJOR * 10000000U) + \
+                                     ((uint32_t)CH_KERNEL_MINOR * 10000U) +    \
+                                     (uint32_t)CH_KERNEL_PATCH)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static osKernelState_t kernel_state = osKernelInactive;
+
+#if CMSIS_CFG_NUM_THREADS > 0
+static memory_pool_t thdpool;
+static THD_WORKING_AREA(thread_was, CMSIS_CFG_DEFAULT_STACK)[CMSIS_CFG_NUM_THREADS];
+#endif
+
+static memory_pool_t timpool;
+static cmsis_os2_timer_t timers[CMSIS_CFG_NUM_TIMERS];
+
+static memory_pool_t efpool;
+static cmsis_os2_event_flags_t event_flags[CMSIS_CFG_NUM_EVENT_FLAGS];
+
+static memory_pool_t mtxpool;
+static cmsis_os2_mutex_t mutexes[CMSIS_CFG_NUM_MUTEXES];
+
+static memory_pool_t sempool;
+static cmsis_os2_semaphore_t semaphores[CMSIS_CFG_NUM_SEMAPHORES];
+
+static memory_pool_t mppool;
+static cmsis_os2_memory_pool_t memory_pools[CMSIS_CFG_NUM_MEMORY_POOLS];
+
+static memory_pool_t mqpool;
+static cmsis_os2_message_queue_t message_queues[CMSIS_CFG_NUM_MESSAGE_QUEUES];
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Converts a CMSIS timeout in a system interval.
+ */
+static sysinterval_t os_timeout(uint32_t ticks) {
+
+  if (ticks == osWaitForever) {
+    return TIME_INFINITE;
+  }
+  if (ticks > (uint32_t)TIME_MAX_INTERVAL) {
+    return TIME_MAX_INTERVAL;
+  }
+  return (sysinterval_t)ticks;
+}
+
+/**
+ * @brief   Converts a CMSIS priority in a thread priority.
+ */
+static tprio_t os_prio(osPriority_t priority) {
+
+  if (priority == osPriorityNone) {
+    return NORMALPRIO;
+  }
+  return (tprio_t)((int)NORMALPRIO + ((int)priority - (int)osPriorityNormal));
+}
+
+/**
+ * @brief   Converts a wait result in a CMSIS status.
+ */
+static osStatus_t os_status(msg_t msg, uint32_t timeout) {
+
+  if (msg == MSG_OK) {
+    return osOK;
+  }
+  if ((msg == MSG_TIMEOUT) && (timeout != 0U)) {
+    return osErrorTimeout;
+  }
+  return osErrorResource;
+}
+
+/**
+ * @brief   Gets a control block from the attributes or from a pool.
+ */
+static void *os_cb_alloc(memory_pool_t *mp, void *cb_mem,
+                         uint32_t cb_size, size_t size, bool *pooledp) {
+
+  if (cb_mem != NULL) {
+    *pooledp = false;
+    return (size_t)cb_size >= size ? cb_mem : NULL;
+  }
+
+  *pooledp = true;
+  return chPoolAlloc(mp);
+}
+
+/**
+ * @brief   Virtual timers common callback.
+ * @note    Periodic timers are re-armed before invoking the callback so
+ *          the period does not drift.
+ */
+static void timer_cb(void *arg) {
+  cmsis_os2_timer_t *tp = (cmsis_os2_timer_t *)arg;
+
+  if (tp->type == osTimerPeriodic) {
+    chSysLockFromISR();
+    chVTDoSetI(&tp->vt, tp->interval, timer_cb, tp);
+    chSysUnlockFromISR();
+  }
+  tp->func(tp->argument);
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Kernel initialization.
+ */
+osStatus_t osKernelInitialize(void) {
+
+  if (port_is_isr_context()) {
+    return osErrorISR;
+  }
+  if (kernel_state != osKernelInactive) {
+    return osError;
+  }
+
+  chSysInit();
+  chThdSetPriority(HIGHPRIO);
+
+#if CMSIS_CFG_NUM_THREADS > 0
+  chPoolObjectInit(&thdpool, sizeof (thread_was[0]), NULL);
+  chPoolLoadArray(&thdpool, thread_was, CMSIS_CFG_NUM_THREADS);
+#endif
+
+  chPoolObjectInit(&timpool, sizeof (cmsis_os2_timer_t), NULL);
+  chPoolLoadArray(&timpool, timers, CMSIS_CFG_NUM_TIMERS);
+
+  chPoolObjectInit(&efpool, sizeof (cmsis_os2_event_flags_t), NULL);
+  chPoolLoadArray(&efpool, event_flags, CMSIS_CFG_NUM_EVENT_FLAGS);
+
+  chPoolObjectInit(&mtxpool, sizeof (cmsis_os2_mutex_t), NULL);
+  chPoolLoadArray(&mtxpool, mutexes, CMSIS_CFG_NUM_MUTEXES);
+
+  chPoolObjectInit(&sempool, sizeof (cmsis_os2_semaphore_t), NULL);
+  chPoolLoadArray(&sempool, semaphores, CMSIS_CFG_NUM_SEMAPHORES);
+
+  chPoolObjectInit(&mppool, sizeof (cmsis_os2_memory_pool_t), NULL);
+  chPoolLoadArray(&mppool, memory_pools, CMSIS_CFG_NUM_MEMORY_POOLS);
+
+  chPoolObjectInit(&mqpool, sizeof (cmsis_os2_message_queue_t), NULL);
+  chPoolLoadArray(&mqpool, message_queues, CMSIS_CFG_NUM_MESSAGE_QUEUES);
+
+  kernel_state = osKernelReady;
+
+  return osOK;
+}
+
+/**
+ * @brief   Returns the kernel information.
+ */
+osStatus_t osKernelGetInfo(osVersion_t *version, char *id_buf,
+                           uint32_t id_size) {
+
+  if (version != NULL) {
+    version->api    = osCMSIS_API;
+    version->kernel = CMSIS_OS2_KERNEL_VERSION;
+  }
+
+  if ((id_buf != NULL) && (id_size > 0U)) {
+    strncpy(id_buf, osKernelId, (size_t)id_size - 1U);
+    id_buf[id_size - 1U] = '\0';
+  }
+
+  return osOK;
+}
+
+/**
+ * @brief   Returns the kernel state.
+ */
+osKernelState_t osKernelGetState(void) {
+
+  return kernel_state;
+}
+
+/**
+ * @brief   Kernel start.
+ * @note    Unlike the specification the function returns, the caller
+ *          continues as a normal priority thread.
+ */
+osStatus_t osKernelStart(void) {
+
+  if (port_is_isr_context()) {
+    return osErrorISR;
+  }
+  if (kernel_state != osKernelReady) {
+    return osError;
+  }
+
+  kernel_state = osKernelRunning;
+
+  chThdSetPriority(NORMALPRIO);
+
+  return osOK;
+}
+
+/**
+ * @brief   Returns the system ticks counter.
+ */
+uint32_t osKernelGetTickCount(void) {
+
+  return (uint32_t)chVTGetSystemTimeX();
+}
+
+/**
+ * @brief   Returns the system ticks frequency.
+ */
+uint32_t osKernelGetTickFreq(void) {
+
+  return (uint32_t)CH_CFG_ST_FREQUENCY;
+}
+
+/**
+ * @brief   Creates a thread.
+ * @note    If @p stack_mem is not specified then a working area is taken
+ *          from the static pool, in that case @p stack_size cannot exceed
+ *          @p CMSIS_CFG_DEFAULT_STACK. Pool working areas are recovered
+ *          by @p osThreadJoin().
+ */
+osThreadId_t osThreadNew(osThreadFunc_t func, void *argument,
+                         const osThreadAttr_t *attr) {
+  const char *name = "noname";
+  tprio_t prio = NORMALPRIO;
+
+  if (port_is_isr_context() || (func == NULL)) {
+    return NULL;
+  }
+
+  if (attr != NULL) {
+    if (attr->name != NULL) {
+      name = attr->name;
+    }
+    prio = os_prio(attr->priority);
+
+    if (attr->stack_mem != NULL) {
+      thread_descriptor_t td = {
+        name,
+        (stkalign_t *)attr->stack_mem,
+        (stkalign_t *)((uint8_t *)attr->stack_mem + attr->stack_size),
+        prio,
+        (tfunc_t)func,
+        argument
+      };
+
+      if ((size_t)attr->stack_size < THD_WORKING_AREA_SIZE(0)) {
+        return NULL;
+      }
+
+      return (osThreadId_t)chThdCreate(&td);
+    }
+
+    if (attr->stack_size > (uint32_t)CMSIS_CFG_DEFAULT_STACK) {
+      return NULL;
+    }
+  }
+
+#if CMSIS_CFG_NUM_THREADS > 0
+  return (osThreadId_t)chThdCreateFromMemoryPool(&thdpool, name, prio,
+                                                 (tfunc_t)func, argument);
+#else
+  return NULL;
+#endif
+}
+
+/**
+ * @brief   Returns the name of a thread.
+ */
+const char *osThreadGetName(osThreadId_t thread_id) {
+
+  if (thread_id == NULL) {
+    return NULL;
+  }
+
+#if CH_CFG_USE_REGISTRY == TRUE
+  return chRegGetThreadNameX((thread_t *)thread_id);
+#else
+  return NULL;
+#endif
+}
+
+/**
+ * @brief   Returns the current thread.
+ */
+osThreadId_t osThreadGetId(void) {
+
+  return (osThreadId_t)chThdGetSelfX();
+}
+
+/**
+ * @brief   Returns the state of a thread.
+ */
+osThreadState_t osThreadGetState(osThreadId_t thread_id) {
+  tstate_t state;
+
+  if ((thread_id == NULL) || port_is_isr_context()) {
+    return osThreadError;
+  }
+
+  state = ((thread_t *)thread_id)->state;
+  switch (state) {
+  case CH_STATE_CURRENT:
+    return osThreadRunning;
+  case CH_STATE_READY:
+    return osThreadReady;
+  case CH_STATE_WTSTART:
+    return osThreadInactive;
+  case CH_STATE_FINAL:
+    return osThreadTerminated;
+  default:
+    return osThreadBlocked;
+  }
+}
+
+/**
+ * @brief   Changes the priority of a thread.
+ * @note    Only the priority of the current thread can be changed.
+ */
+osStatus_t osThreadSetPriority(osThreadId_t thread_id,
+                               osPriority_t priority) {
+
+  if ((thread_id == NULL) || (priority < osPriorityIdle) ||
+      (priority > osPriorityISR)) {
+    return osErrorParameter;
+  }
+  if (port_is_isr_context()) {
+    return osErrorISR;
+  }
+  if ((thread_t *)thread_id != chThdGetSelfX()) {
+    return osErrorResource;
+  }
+
+  (void) chThdSetPriority(os_prio(priority));
+
+  return osOK;
+}
+
+/**
+ * @brief   Returns the priority of a thread.
+ */
+osPriority_t osThreadGetPriority(osThreadId_t thread_id) {
+
+  if ((thread_id == NULL) || port_is_isr_context()) {
+    return osPriorityError;
+  }
+
+  return (osPriority_t)((int)((thread_t *)thread_id)->realprio -
+                        (int)NORMALPRIO + (int)osPriorityNormal);
+}
+
+/**
+ * @brief   Thread time slice yield.
+ */
+osStatus_t osThreadYield(void) {
+
+  if (port_is_isr_context()) {
+    return osErrorISR;
+  }
+
+  chThdYield();
+
+  return osOK;
+}
+
+/**
+ * @brief   Waits for a thread termination.
+ * @note    The thread reference is released, the thread working area is
+ *          returned to the pool if it was taken from it.
+ */
+osStatus_t osThreadJoin(osThreadId_t thread_id) {
+
+  if (thread_id == NULL) {
+    return osErrorParameter;
+  }
+  if (port_is_isr_context()) {
+    return osErrorISR;
+  }
+  if ((thread_t *)thread_id == chThdGetSelfX()) {
+    return osErrorResource;
+  }
+
+#if CH_CFG_USE_WAITEXIT == TRUE
+  (void) chThdWait((thread_t *)thread_id);
+
+  return osOK;
+#else
+  return osError;
+#endif
+}
+
+/**
+ * @brief   Terminates the current thread.
+ */
+void osThreadExit(void) {
+
+  chThdExit((msg_t)0);
+}
+
+/**
+ * @brief   Thread termination.
+ * @note    The thread is not really terminated but asked to terminate which
+ *          is not compliant.
+ */
+osStatus_t osThreadTerminate(osThreadId_t thread_id) {
+
+  if (thread_id == NULL) {
+    return osErrorParameter;
+  }
+  if (port_is_isr_context()) {
+    return osErrorISR;
+  }
+
+  if ((thread_t *)thread_id == chThdGetSelfX()) {
+    chThdExit((msg_t)0);
+  }
+  chThdTerminate((thread_t *)thread_id);
+
+  return osOK;
+}
+
+/**
+ * @brief   Sets thread flags.
+ * @note    Thread flags are the thread events mask.
+ */
+uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags) {
+  thread_t *tp = (thread_t *)thread_id;
+  uint32_t rflags;
+  syssts_t sts;
+
+  if ((tp == NULL) || ((flags & osFlagsError) != 0U)) {
+    return osFlagsErrorParameter;
+  }
+
+  sts = chSysGetStatusAndLockX();
+  chEvtSignalI(tp, (eventmask_t)flags);
+  rflags = (uint32_t)tp->epending;
+  chSysRestoreStatusX(sts);
+
+  return rflags;
+}
+
+/**
+ * @brief   Clears flags of the current thread.
+ */
+uint32_t osThreadFlagsClear(uint32_t flags) {
+  thread_t *tp = chThdGetSelfX();
+  uint32_t rflags;
+
+  if (port_is_isr_context()) {
+    return osFlagsErrorISR;
+  }
+  if ((flags & osFlagsError) != 0U) {
+    return osFlagsErrorParameter;
+  }
+
+  chSysLock();
+  rflags = (uint32_t)tp->epending;
+  tp->epending &= ~(eventmask_t)flags;
+  chSysUnlock();
+
+  return rflags;
+}
+
+/**
+ * @brief   Returns the flags of the current thread.
+ */
+uint32_t osThreadFlagsGet(void) {
+
+  if (port_is_isr_context()) {
+    return 0U;
+  }
+
+  return (uint32_t)chThdGetSelfX()->epending;
+}
+
+/**
+ * @brief   Waits for flags of the current thread.
+ * @note    The returned value is the set of flags that satisfied the
+ *          wait.
+ */
+uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options,
+                           uint32_t timeout) {
+  eventmask_t m;
+
+  if (port_is_isr_context()) {
+    return osFlagsErrorISR;
+  }
+  if ((flags & osFlagsError) != 0U) {
+    return osFlagsErrorParameter;
+  }
+
+  if ((options & osFlagsWaitAll) != 0U) {
+    m = chEvtWaitAllTimeout((eventmask_t)flags, os_timeout(timeout));
+  }
+  else {
+    m = chEvtWaitAnyTimeout((eventmask_t)flags, os_timeout(timeout));
+  }
+
+  if (m == (eventmask_t)0) {
+    return timeout == 0U ? osFlagsErrorResource : osFlagsErrorTimeout;
+  }
+
+  if ((options & osFlagsNoClear) != 0U) {
+    (void) chEvtAddEvents(m);
+  }
+
+  return (uint32_t)m;
+}
+
+/**
+ * @brief   Delays the current thread.
+ */
+osStatus_t osDelay(uint32_t ticks) {
+
+  if (port_is_isr_context()) {
+    return osErrorISR;
+  }
+  if (ticks == 0U) {
+    return osErrorParameter;
+  }
+
+  chThdSleep(os_timeout(ticks));
+
+  return osOK;
+}
+
+/**
+ * @brief   Delays the current thread until an absolute time.
+ */
+osStatus_t osDelayUntil(uint32_t ticks) {
+  sysinterval_t delta;
+
+  if (port_is_isr_context()) {
+    return osErrorISR;
+  }
+
+  delta = chTimeDiffX(chVTGetSystemTimeX(), (systime_t)ticks);
+  if ((delta == (sysinterval_t)0) || (delta > (TIME_MAX_INTERVAL / 2U))) {
+    return osErrorParameter;
+  }
+
+  chThdSleep(delta);
+
+  return osOK;
+}
+
+/**
+ * @brief   Creates a timer.
+ */
+osTimerId_t osTimerNew(osTimerFunc_t func, osTimerType_t type,
+                       void *argument, const osTimerAttr_t *attr) {
+  cmsis_os2_timer_t *tp;
+  bool pooled;
+
+  if (port_is_isr_context() || (func == NULL)) {
+    return NULL;
+  }
+
+  tp = os_cb_alloc(&timpool,
+                   attr != NULL ? attr->cb_mem : NULL,
+                   attr != NULL ? attr->cb_size : 0U,
+                   sizeof (cmsis_os2_timer_t), &pooled);
+  if (tp == NULL) {
+    return NULL;
+  }
+
+  chVTObjectInit(&tp->vt);
+  tp->type     = type;
+  tp->func     = func;
+  tp->argument = argument;
+  tp->interval = (sysinterval_t)0;
+  tp->pooled   = pooled;
+
+  return (osTimerId_t)tp;
+}
+
+/**
+ * @brief   Starts or restarts a timer.
+ */
+osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks) {
+  cmsis_os2_timer_t *tp = (cmsis_os2_timer_t *)timer_id;
+
+  if ((tp == NULL) || (ticks == 0U) || (ticks == osWaitForever)) {
+    return osErrorParameter;
+  }
+  if (port_is_isr_context()) {
+    return osErrorISR;
+  }
+
+  tp->interval = os_timeout(ticks);
+  chVTSet(&tp->vt, tp->interval, timer_cb, tp);
+
+  return osOK;
+}
+
+/**
+ * @brief   Stops a timer.
+ */
+osStatus_t osTimerStop(osTimerId_t timer_id) {
+  cmsis_os2_timer_t *tp = (cmsis_os2_timer_t *)timer_id;
+
+  if (tp == NULL) {
+    return osErrorParameter;
+  }
+  if (port_is_isr_context()) {
+    return osErrorISR;
+  }
+
+  chSysLock();
+  if (!chVTIsArmedI(&tp->vt)) {
+    chSysUnlock();
+    return osErrorResource;
+  }
+  chVTDoResetI(&tp->vt);
+  chSysUnlock();
+
+  return osOK;
+}
+
+/**
+ * @brief   Returns 1 if the timer is running.
+ */
+uint32_t osTimerIsRunning(osTimerId_t timer_id) {
+
+  if ((timer_id == NULL) || port_is_isr_context()) {
+    return 0U;
+  }
+
+  return chVTIsArmed(&((cmsis_os2_timer_t *)timer_id)->vt) ? 1U : 0U;
+}
+
+/**
+ * @brief   Deletes a timer.
+ */
+osStatus_t osTimerDelete(osTimerId_t timer_id) {
+  cmsis_os2_timer_t *tp = (cmsis_os2_timer_t *)timer_id;
+
+  if (tp == NULL) {
+    return osErrorParameter;
+  }
+  if (port_is_isr_context()) {
+    return osErrorISR;
+  }
+
+  chVTReset(&tp->vt);
+  if (tp->pooled) {
+    chPoolFree(&timpool, (void *)tp);
+  }
+
+  return osOK;
+}
+
+/**
+ * @brief   Creates an event flags object.
+ */
+osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t *attr) {
+  cmsis_os2_event_flags_t *efp;
+  bool pooled;
+
+  if (port_is_isr_context()) {
+    return NULL;
+  }
+
+  efp = os_cb_alloc(&efpool,
+                    attr != NULL ? attr->cb_mem : NULL,
+                    attr != NULL ? attr->cb_size : 0U,
+                    sizeof (cmsis_os2_event_flags_t), &pooled);
+  if (efp == NULL) {
+    return NULL;
+  }
+
+  chThdQueueObjectInit(&efp->queue);
+  efp->flags  = 0U;
+  efp->pooled = pooled;
+
+  return (osEventFlagsId_t)efp;
+}
+
+/**
+ * @brief   Sets event flags.
+ * @details All the waiting threads are made ready, each one checks its
+ *          own wait condition.
+ */
+uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags) {
+  cmsis_os2_event_flags_t *efp = (cmsis_os2_event_flags_t *)ef_id;
+  uint32_t rflags;
+  syssts_t sts;
+
+  if ((efp == NULL) || ((flags & osFlagsError) != 0U)) {
+    return osFlagsErrorParameter;
+  }
+
+  sts = chSysGetStatusAndLockX();
+  efp->flags |= flags;
+  rflags = efp->flags;
+  chThdDequeueAllI(&efp->queue, MSG_OK);
+  chSysRestoreStatusX(sts);
+
+  return rflags;
+}
+
+/**
+ * @brief   Clears event flags.
+ */
+uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags) {
+  cmsis_os2_event_flags_t *efp = (cmsis_os2_event_flags_t *)ef_id;
+  uint32_t rflags;
+  syssts_t sts;
+
+  if ((efp == NULL) || ((flags & osFlagsError) != 0U)) {
+    return osFlagsErrorParameter;
+  }
+
+  sts = chSysGetStatusAndLockX();
+  rflags = efp->flags;
+  efp->flags &= ~flags;
+  chSysRestoreStatusX(sts);
+
+  return rflags;
+}
+
+/**
+ * @brief   Returns the current event flags.
+ */
+uint32_t osEventFlagsGet(osEventFlagsId_t ef_id) {
+
+  if (ef_id == NULL) {
+    return 0U;
+  }
+
+  return ((cmsis_os2_event_flags_t *)ef_id)->flags;
+}
+
+/**
+ * @brief   Waits for event flags.
+ * @note    From ISR context the timeout must be zero.
+ */
+uint32_t osEventFlagsWait(osEventFlagsId_t ef_id, uint32_t flags,
+                          uint32_t options, uint32_t timeout) {
+  cmsis_os2_event_flags_t *efp = (cmsis_os2_event_flags_t *)ef_id;
+  sysinterval_t interval = os_timeout(timeout);
+  systime_t start = chVTGetSystemTimeX();
+  uint32_t rflags;
+  syssts_t sts;
+
+  if ((efp == NULL) || ((flags & osFlagsError) != 0U)) {
+    return osFlagsErrorParameter;
+  }
+  if (port_is_isr_context() && (timeout != 0U)) {
+    return osFlagsErrorParameter;
+  }
+
+  sts = chSysGetStatusAndLockX();
+  while (true) {
+    uint32_t m = efp->flags & flags;
+    sysinterval_t remaining = interval;
+    msg_t msg;
+
+    if ((options & osFlagsWaitAll) != 0U ? m == flags : m != 0U) {
+      rflags = efp->flags;
+      if ((options & osFlagsNoClear) == 0U) {
+        efp->flags &= ~flags;
+      }
+      break;
+    }
+
+    if (interval == TIME_IMMEDIATE) {
+      rflags = osFlagsErrorResource;
+      break;
+    }
+
+    /* The flags can be set while not matching the condition, the wait is
+       restarted with the remaining time.*/
+    if (interval != TIME_INFINITE) {
+      sysinterval_t elapsed = chTimeDiffX(start, chVTGetSystemTimeX());
+
+      if (elapsed >= interval) {
+        rflags = osFlagsErrorTimeout;
+        break;
+      }
+      remaining = interval - elapsed;
+    }
+
+    msg = chThdEnqueueTimeoutS(&efp->queue, remaining);
+    if (msg != MSG_OK) {
+      rflags = msg == MSG_TIMEOUT ? osFlagsErrorTimeout :
+                                    osFlagsErrorResource;
+      break;
+    }
+  }
+  chSysRestoreStatusX(sts);
+
+  return rflags;
+}
+
+/**
+ * @brief   Deletes an event flags object.
+ */
+osStatus_t osEventFlagsDelete(osEventFlagsId_t ef_id) {
+  cmsis_os2_event_flags_t *efp = (cmsis_os2_event_flags_t *)ef_id;
+
+  if (efp == NULL) {
+    return osErrorParameter;
+  }
+  if (port_is_isr_context()) {
+    return osErrorISR;
+  }
+
+  chSysLock();
+  chThdDequeueAllI(&efp->queue, MSG_RESET);
+  chSchRescheduleS();
+  chSysUnlock();
+
+  if (efp->pooled) {
+    chPoolFree(&efpool, (void *)efp);
+  }
+
+  return osOK;
+}
+
+/**
+ * @brief   Creates a mutex.
+ * @note    Mutexes always have priority inheritance.
+ */
+osMutexId_t osMutexNew(const osMutexAttr_t *attr) {
+  cmsis_os2_mutex_t *mp;
+  uint32_t attr_bits = attr != NULL ? attr->attr_bits : 0U;
+  bool pooled;
+
+  if (port_is_isr_context()) {
+    return NULL;
+  }
+
+#if CH_CFG_USE_MUTEXES_RECURSIVE == FALSE
+  if ((attr_bits & osMutexRecursive) != 0U) {
+    return NULL;
+  }
+#endif
+
+  mp = os_cb_alloc(&mtxpool,
+                   attr != NULL ? attr->cb_mem : NULL,
+                   attr != NULL ? attr->cb_size : 0U,
+                   sizeof (cmsis_os2_mutex_t), &pooled);
+  if (mp == NULL) {
+    return NULL;
+  }
+
+  chMtxObjectInit(&mp->mtx);
+  mp->attr_bits = attr_bits;
+  mp->pooled    = pooled;
+
+  return (osMutexId_t)mp;
+}
+
+/**
+ * @brief   Acquires a mutex.
+ * @note    Kernel mutexes have no timeout, finite timeouts are implemented
+ *          by retrying once per system tick.
+ */
+osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout) {
+  cmsis_os2_mutex_t *mp = (cmsis_os2_mutex_t *)mutex_id;
+  sysinterval_t interval = os_timeout(timeout);
+  systime_t start;
+
+  if (mp == NULL) {
+    return osErrorParameter;
+  }
+  if (port_is_isr_context()) {
+    return osErrorISR;
+  }
+  if (((mp->attr_bits & osMutexRecursive) == 0U) &&
+      (mp->mtx.owner == chThdGetSelfX())) {
+    return osErrorResource;
+  }
+
+  if (interval == TIME_INFINITE) {
+    chMtxLock(&mp->mtx);
+    return osOK;
+  }
+
+  start = chVTGetSystemTimeX();
+  while (!chMtxTryLock(&mp->mtx)) {
+    if (interval == TIME_IMMEDIATE) {
+      return osErrorResource;
+    }
+    if (chTimeDiffX(start, chVTGetSystemTimeX()) >= interval) {
+      return osErrorTimeout;
+    }
+    chThdSleep((sysinterval_t)1);
+  }
+
+  return osOK;
+}
+
+/**
+ * @brief   Releases a mutex.
+ * @note    Mutexes must be released in reverse lock order.
+ */
+osStatus_t osMutexRelease(osMutexId_t mutex_id) {
+  cmsis_os2_mutex_t *mp = (cmsis_os2_mutex_t *)mutex_id;
+
+  if (mp == NULL) {
+    return osErrorParameter;
+  }
+  if (port_is_isr_context()) {
+    return osErrorISR;
+  }
+  if (mp->mtx.owner != chThdGetSelfX()) {
+    return osErrorResource;
+  }
+
+  chMtxUnlock(&mp->mtx);
+
+  return osOK;
+}
+
+/**
+ * @brief   Returns the owner of a mutex.
+ */
+osThreadId_t osMutexGetOwner(osMutexId_t mutex_id) {
+
+  if ((mutex_id == NULL) || port_is_isr_context()) {
+    return NULL;
+  }
+
+  return (osThreadId_t)((cmsis_os2_mutex_t *)mutex_id)->mtx.owner;
+}
+
+/**
+ * @brief   Deletes a mutex.
+ */
+osStatus_t osMutexDelete(osMutexId_t mutex_id) {
+  cmsis_os2_mutex_t *mp = (cmsis_os2_mutex_t *)mutex_id;
+
+  if (mp == NULL) {
+    return osErrorParameter;
+  }
+  if (port_is_isr_context()) {
+    return osErrorISR;
+  }
+  if (mp->mtx.owner != NULL) {
+    return osErrorResource;
+  }
+
+  if (mp->pooled) {
+    chPoolFree(&mtxpool, (void *)mp);
+  }
+
+  return osOK;
+}
+
+/**
+ * @brief   Creates a semaphore.
+ */
+osSemaphoreId_t osSemaphoreNew(uint32_t max_count, uint32_t initial_count,
+                               const osSemaphoreAttr_t *attr) {
+  cmsis_os2_semaphore_t *sp;
+  bool pooled;
+
+  if (port_is_isr_context() || (max_count == 0U) ||
+      (initial_count > max_count) || ((cnt_t)max_count <= (cnt_t)0)) {
+    return NULL;
+  }
+
+  sp = os_cb_alloc(&sempool,
+                   attr != NULL ? attr->cb_mem : NULL,
+                   attr != NULL ? attr->cb_size : 0U,
+                   sizeof (cmsis_os2_semaphore_t), &pooled);
+  if (sp == NULL) {
+    return NULL;
+  }
+
+  chSemObjectInit(&sp->sem, (cnt_t)initial_count);
+  sp->max_count = max_count;
+  sp->pooled    = pooled;
+
+  return (osSemaphoreId_t)sp;
+}
+
+/**
+ * @brief   Acquires a semaphore token.
+ * @note    From ISR context the timeout must be zero.
+ */
+osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id,
+                              uint32_t timeout) {
+  cmsis_os2_semaphore_t *sp = (cmsis_os2_semaphore_t *)semaphore_id;
+  msg_t msg;
+
+  if (sp == NULL) {
+    return osErrorParameter;
+  }
+
+  if (port_is_isr_context()) {
+    if (timeout != 0U) {
+      return osErrorParameter;
+    }
+
+    chSysLockFromISR();
+    if (chSemGetCounterI(&sp->sem) > (cnt_t)0) {
+      chSemFastWaitI(&sp->sem);
+      msg = MSG_OK;
+    }
+    else {
+      msg = MSG_TIMEOUT;
+    }
+    chSysUnlockFromISR();
+  }
+  else {
+    msg = chSemWaitTimeout(&sp->sem, os_timeout(timeout));
+  }
+
+  return os_status(msg, timeout);
+}
+
+/**
+ * @brief   Releases a semaphore token.
+ */
+osStatus_t osSemaphoreRelease(osSemaphoreId_t semaphore_id) {
+  cmsis_os2_semaphore_t *sp = (cmsis_os2_semaphore_t *)semaphore_id;
+  osStatus_t status = osOK;
+  syssts_t sts;
+
+  if (sp == NULL) {
+    return osErrorParameter;
+  }
+
+  sts = chSysGetStatusAndLockX();
+  if (chSemGetCounterI(&sp->sem) >= (cnt_t)sp->max_count) {
+    status = osErrorResource;
+  }
+  else {
+    chSemSignalI(&sp->sem);
+  }
+  chSysRestoreStatusX(sts);
+
+  return status;
+}
+
+/**
+ * @brief   Returns the number of available tokens.
+ */
+uint32_t osSemaphoreGetCount(osSemaphoreId_t semaphore_id) {
+  cnt_t cnt;
+
+  if (semaphore_id == NULL) {
+    return 0U;
+  }
+
+  cnt = ((cmsis_os2_semaphore_t *)semaphore_id)->sem.cnt;
+
+  return cnt > (cnt_t)0 ? (uint32_t)cnt : 0U;
+}
+
+/**
+ * @brief   Deletes a semaphore.
+ */
+osStatus_t osSemaphoreDelete(osSemaphoreId_t semaphore_id) {
+  cmsis_os2_semaphore_t *sp = (cmsis_os2_semaphore_t *)semaphore_id;
+
+  if (sp == NULL) {
+    return osErrorParameter;
+  }
+  if (port_is_isr_context()) {
+    return osErrorISR;
+  }
+
+  chSemReset(&sp->sem, (cnt_t)0);
+  if (sp->pooled) {
+    chPoolFree(&sempool, (void *)sp);
+  }
+
+  return osOK;
+}
+
+/**
+ * @brief   Creates a memory pool.
+ * @note    The @p mp_mem area is mandatory, its size must be at least
+ *          @p CMSIS_OS2_MEMPOOL_MEM_SIZE().
+ */
+osMemoryPoolId_t osMemoryPoolNew(uint32_t block_count, uint32_t block_size,
+                                 const osMemoryPoolAttr_t *attr) {
+  cmsis_os2_memory_pool_t *mpp;
+  bool pooled;
+
+  if (port_is_isr_context() || (block_count == 0U) ||
+      (block_size == 0U) || (attr == NULL) || (attr->mp_mem == NULL) ||
+      ((size_t)attr->mp_size < CMSIS_OS2_MEMPOOL_MEM_SIZE((size_t)block_count,
+                                                          (size_t)block_size))) {
+    return NULL;
+  }
+
+  mpp = os_cb_alloc(&mppool, attr->cb_mem, attr->cb_size,
+                    sizeof (cmsis_os2_memory_pool_t), &pooled);
+  if (mpp == NULL) {
+    return NULL;
+  }
+
+  chGuardedPoolObjectInitAligned(&mpp->pool,
+                                 CMSIS_OS2_BLOCK_SIZE((size_t)block_size),
+                                 CMSIS_OS2_MEM_ALIGN);
+  chGuardedPoolLoadArray(&mpp->pool, attr->mp_mem, (size_t)block_count);
+  mpp->block_count = block_count;
+  mpp->block_size  = block_size;
+  mpp->pooled      = pooled;
+
+  return (osMemoryPoolId_t)mpp;
+}
+
+/**
+ * @brief   Allocates a memory block.
+ * @note    From ISR context the timeout must be zero.
+ */
+void *osMemoryPoolAlloc(osMemoryPoolId_t mp_id, uint32_t timeout) {
+  cmsis_os2_memory_pool_t *mpp = (cmsis_os2_memory_pool_t *)mp_id;
+  void *block;
+
+  if (mpp == NULL) {
+    return NULL;
+  }
+
+  if (port_is_isr_context()) {
+    if (timeout != 0U) {
+      return NULL;
+    }
+
+    chSysLockFromISR();
+    block = chGuardedPoolAllocI(&mpp->pool);
+    chSysUnlockFromISR();
+  }
+  else {
+    block = chGuardedPoolAllocTimeout(&mpp->pool, os_timeout(timeout));
+  }
+
+  return block;
+}
+
+/**
+ * @brief   Returns a memory block.
+ */
+osStatus_t osMemoryPoolFree(osMemoryPoolId_t mp_id, void *block) {
+  cmsis_os2_memory_pool_t *mpp = (cmsis_os2_memory_pool_t *)mp_id;
+  syssts_t sts;
+
+  if ((mpp == NULL) || (block == NULL)) {
+    return osErrorParameter;
+  }
+
+  sts = chSysGetStatusAndLockX();
+  chGuardedPoolFreeI(&mpp->pool, block);
+  chSysRestoreStatusX(sts);
+
+  return osOK;
+}
+
+/**
+ * @brief   Returns the number of blocks in a memory pool.
+ */
+uint32_t osMemoryPoolGetCapacity(osMemoryPoolId_t mp_id) {
+
+  if (mp_id == NULL) {
+    return 0U;
+  }
+
+  return ((cmsis_os2_memory_pool_t *)mp_id)->block_count;
+}
+
+/**
+ * @brief   Returns the size of the blocks of a memory pool.
+ */
+uint32_t osMemoryPoolGetBlockSize(osMemoryPoolId_t mp_id) {
+
+  if (mp_id == NULL) {
+    return 0U;
+  }
+
+  return ((cmsis_os2_memory_pool_t *)mp_id)->block_size;
+}
+
+/**
+ * @brief   Returns the number of free blocks.
+ */
+uint32_t osMemoryPoolGetSpace(osMemoryPoolId_t mp_id) {
+  cnt_t cnt;
+
+  if (mp_id == NULL) {
+    return 0U;
+  }
+
+  cnt = ((cmsis_os2_memory_pool_t *)mp_id)->pool.sem.cnt;
+
+  return cnt > (cnt_t)0 ? (uint32_t)cnt : 0U;
+}
+
+/**
+ * @brief   Returns the number of allocated blocks.
+ */
+uint32_t osMemoryPoolGetCount(osMemoryPoolId_t mp_id) {
+
+  return osMemoryPoolGetCapacity(mp_id) - osMemoryPoolGetSpace(mp_id);
+}
+
+/**
+ * @brief   Deletes a memory pool.
+ */
+osStatus_t osMemoryPoolDelete(osMemoryPoolId_t mp_id) {
+  cmsis_os2_memory_pool_t *mpp = (cmsis_os2_memory_pool_t *)mp_id;
+
+  if (mpp == NULL) {
+    return osErrorParameter;
+  }
+  if (port_is_isr_context()) {
+    return osErrorISR;
+  }
+
+  if (mpp->pooled) {
+    chPoolFree(&mppool, (void *)mpp);
+  }
+
+  return osOK;
+}
+
+/**
+ * @brief   Creates a message queue.
+ * @details The queue is an objects FIFO, messages are copied in the FIFO
+ *          objects and their references are exchanged.
+ * @note    The @p mq_mem area is mandatory, its size must be at least
+ *          @p CMSIS_OS2_MSGQUEUE_MEM_SIZE().
+ */
+osMessageQueueId_t osMessageQueueNew(uint32_t msg_count, uint32_t msg_size,
+                                     const osMessageQueueAttr_t *attr) {
+  cmsis_os2_message_queue_t *mqp;
+  size_t objsize = CMSIS_OS2_BLOCK_SIZE((size_t)msg_size);
+  bool pooled;
+
+  if (port_is_isr_context() || (msg_count == 0U) || (msg_size == 0U) ||
+      (attr == NULL) || (attr->mq_mem == NULL) ||
+      ((size_t)attr->mq_size < CMSIS_OS2_MSGQUEUE_MEM_SIZE((size_t)msg_count,
+                                                           (size_t)msg_size))) {
+    return NULL;
+  }
+
+  mqp = os_cb_alloc(&mqpool, attr->cb_mem, attr->cb_size,
+                    sizeof (cmsis_os2_message_queue_t), &pooled);
+  if (mqp == NULL) {
+    return NULL;
+  }
+
+  chFifoObjectInit(&mqp->fifo, objsize, (size_t)msg_count,
+                   CMSIS_OS2_MEM_ALIGN, attr->mq_mem,
+                   (msg_t *)((uint8_t *)attr->mq_mem +
+                             ((size_t)msg_count * objsize)));
+  mqp->msg_count = msg_count;
+  mqp->msg_size  = msg_size;
+  mqp->pooled    = pooled;
+
+  return (osMessageQueueId_t)mqp;
+}
+
+/**
+ * @brief   Puts a message in a queue.
+ * @note    Messages with non-zero priority are put in front of the queue.
+ * @note    From ISR context the timeout must be zero.
+ */
+osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id, const void *msg_ptr,
+                             uint8_t msg_prio, uint32_t timeout) {
+  cmsis_os2_message_queue_t *mqp = (cmsis_os2_message_queue_t *)mq_id;
+  void *objp;
+
+  if ((mqp == NULL) || (msg_ptr == NULL)) {
+    return osErrorParameter;
+  }
+
+  if (port_is_isr_context()) {
+    if (timeout != 0U) {
+      return osErrorParameter;
+    }
+
+    chSysLockFromISR();
+    objp = chFifoTakeObjectI(&mqp->fifo);
+    if (objp == NULL) {
+      chSysUnlockFromISR();
+      return osErrorResource;
+    }
+    memcpy(objp, msg_ptr, (size_t)mqp->msg_size);
+    if (msg_prio > 0U) {
+      chFifoSendObjectAheadI(&mqp->fifo, objp);
+    }
+    else {
+      chFifoSendObjectI(&mqp->fifo, objp);
+    }
+    chSysUnlockFromISR();
+
+    return osOK;
+  }
+
+  objp = chFifoTakeObjectTimeout(&mqp->fifo, os_timeout(timeout));
+  if (objp == NULL) {
+    return timeout == 0U ? osErrorResource : osErrorTimeout;
+  }
+  memcpy(objp, msg_ptr, (size_t)mqp->msg_size);
+  if (msg_prio > 0U) {
+    chFifoSendObjectAhead(&mqp->fifo, objp);
+  }
+  else {
+    chFifoSendObject(&mqp->fifo, objp);
+  }
+
+  return osOK;
+}
+
+/**
+ * @brief   Gets a message from a queue.
+ * @note    Messages priorities are not stored, @p msg_prio is set to zero.
+ * @note    From ISR context the timeout must be zero.
+ */
+osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id, void *msg_ptr,
+                             uint8_t *msg_prio, uint32_t timeout) {
+  cmsis_os2_message_queue_t *mqp = (cmsis_os2_message_queue_t *)mq_id;
+  void *objp;
+  msg_t msg;
+
+  if ((mqp == NULL) || (msg_ptr == NULL)) {
+    return osErrorParameter;
+  }
+
+  if (port_is_isr_context()) {
+    if (timeout != 0U) {
+      return osErrorParameter;
+    }
+
+    chSysLockFromISR();
+    msg = chFifoReceiveObjectI(&mqp->fifo, &objp);
+    if (msg == MSG_OK) {
+      memcpy(msg_ptr, objp, (size_t)mqp->msg_size);
+      chFifoReturnObjectI(&mqp->fifo, objp);
+    }
+    chSysUnlockFromISR();
+  }
+  else {
+    msg = chFifoReceiveObjectTimeout(&mqp->fifo, &objp, os_timeout(timeout));
+    if (msg == MSG_OK) {
+      memcpy(msg_ptr, objp, (size_t)mqp->msg_size);
+      chFifoReturnObject(&mqp->fifo, objp);
+    }
+  }
+
+  if ((msg == MSG_OK) && (msg_prio != NULL)) {
+    *msg_prio = 0U;
+  }
+
+  return os_status(msg, timeout);
+}
+
+/**
+ * @brief   Returns the maximum number of messages in a queue.
+ */
+uint32_t osMessageQueueGetCapacity(osMessageQueueId_t mq_id) {
+
+  if (mq_id == NULL) {
+    return 0U;
+  }
+
+  return ((cmsis_os2_message_queue_t *)mq_id)->msg_count;
+}
+
+/**
+ * @brief   Returns the size of the messages of a queue.
+ */
+uint32_t osMessageQueueGetMsgSize(osMessageQueueId_t mq_id) {
+
+  if (mq_id == NULL) {
+    return 0U;
+  }
+
+  return ((cmsis_os2_message_queue_t *)mq_id)->msg_size;
+}
+
+/**
+ * @brief   Returns the number of queued messages.
+ */
+uint32_t osMessageQueueGetCount(osMessageQueueId_t mq_id) {
+  uint32_t n;
+  syssts_t sts;
+
+  if (mq_id == NULL) {
+    return 0U;
+  }
+
+  sts = chSysGetStatusAndLockX();
+  n = (uint32_t)chMBGetUsedCountI(&((cmsis_os2_message_queue_t *)mq_id)->fifo.mbx);
+  chSysRestoreStatusX(sts);
+
+  return n;
+}
+
+/**
+ * @brief   Returns the number of free messages slots.
+ */
+uint32_t osMessageQueueGetSpace(osMessageQueueId_t mq_id) {
+  cnt_t cnt;
+
+  if (mq_id == NULL) {
+    return 0U;
+  }
+
+  cnt = ((cmsis_os2_message_queue_t *)mq_id)->fifo.free.sem.cnt;
+
+  return cnt > (cnt_t)0 ? (uint32_t)cnt : 0U;
+}
+
+/**
+ * @brief   Discards the queued messages.
+ */
+osStatus_t osMessageQueueReset(osMessageQueueId_t mq_id) {
+  cmsis_os2_message_queue_t *mqp = (cmsis_os2_message_queue_t *)mq_id;
+  void *objp;
+
+  if (mqp == NULL) {
+    return osErrorParameter;
+  }
+  if (port_is_isr_context()) {
+    return osErrorISR;
+  }
+
+  chSysLock();
+  while (chFifoReceiveObjectI(&mqp->fifo, &objp) == MSG_OK) {
+    chFifoReturnObjectI(&mqp->fifo, objp);
+  }
+  chSchRescheduleS();
+  chSysUnlock();
+
+  return osOK;
+}
+
+/**
+ * @brief   Deletes a message queue.
+ * @note    Threads waiting for messages are released with an error,
+ *          there must be no threads waiting for free slots.
+ */
+osStatus_t osMessageQueueDelete(osMessageQueueId_t mq_id) {
+  cmsis_os2_message_queue_t *mqp = (cmsis_os2_message_queue_t *)mq_id;
+
+  if (mqp == NULL) {
+    return osErrorParameter;
+  }
+  if (port_is_isr_context()) {
+    return osErrorISR;
+  }
+
+  chMBReset(&mqp->fifo.mbx);
+  if (mqp->pooled) {
+    chPoolFree(&mqpool, (void *)mqp);
+  }
+
+  return osOK;
+}
+
+/** @} */
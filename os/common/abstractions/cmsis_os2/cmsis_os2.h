@@ -0,0 +1,565 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    cmsis_os2.h
+ * @brief   CMSIS RTOS2 module macros and structures.
+ * @details The API objects are mapped directly on the kernel objects, there
+ *          is no dispatcher thread. Control blocks are taken from the
+ *          @p cb_mem area passed in the attributes or, if not specified,
+ *          from static pools sized by the configuration options. Message
+ *          queues and memory pools data must always be provided using the
+ *          @p mq_mem and @p mp_mem attributes, the heap is never used for
+ *          objects.
+ * @note    Timer callbacks are invoked from the virtual timers callback
+ *          context, they can only use the API functions allowed from ISRs.
+ *
+ * @addtogroup CMSIS_OS2
+ * @{
+ */
+
+#ifndef CMSIS_OS2_H
+#define CMSIS_OS2_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ch.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   API version.
+ */
+#define osCMSIS_API                 20010003U
+
+/**
+ * @brief   Kernel identification string.
+ */
+#define osKernelId                  "ChibiOS/RT"
+
+/**
+ * @brief   Wait forever specification for timeouts.
+ */
+#define osWaitForever               0xFFFFFFFFU
+
+/**
+ * @name    Flags options
+ * @{
+ */
+#define osFlagsWaitAny              0x00000000U
+#define osFlagsWaitAll              0x00000001U
+#define osFlagsNoClear              0x00000002U
+/** @} */
+
+/**
+ * @name    Flags error codes
+ * @{
+ */
+#define osFlagsError                0x80000000U
+#define osFlagsErrorUnknown         0xFFFFFFFFU
+#define osFlagsErrorTimeout         0xFFFFFFFEU
+#define osFlagsErrorResource        0xFFFFFFFDU
+#define osFlagsErrorParameter       0xFFFFFFFCU
+#define osFlagsErrorISR             0xFFFFFFFAU
+/** @} */
+
+/**
+ * @name    Objects attribute bits
+ * @{
+ */
+#define osThreadDetached            0x00000000U
+#define osThreadJoinable            0x00000001U
+#define osMutexRecursive            0x00000001U
+#define osMutexPrioInherit          0x00000002U
+#define osMutexRobust               0x00000008U
+/** @} */
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Stack size of the pre-allocated threads working areas.
+ */
+#if !defined(CMSIS_CFG_DEFAULT_STACK)
+#define CMSIS_CFG_DEFAULT_STACK     256
+#endif
+
+/**
+ * @brief   Number of pre-allocated threads working areas.
+ * @details Working areas are used by @p osThreadNew() when @p stack_mem
+ *          is not specified, zero disables the pool.
+ * @note    Requires @p CH_CFG_USE_DYNAMIC.
+ */
+#if !defined(CMSIS_CFG_NUM_THREADS)
+#define CMSIS_CFG_NUM_THREADS       4
+#endif
+
+/**
+ * @brief   Number of pre-allocated static timers.
+ */
+#if !defined(CMSIS_CFG_NUM_TIMERS)
+#define CMSIS_CFG_NUM_TIMERS        4
+#endif
+
+/**
+ * @brief   Number of pre-allocated static event flags.
+ */
+#if !defined(CMSIS_CFG_NUM_EVENT_FLAGS)
+#define CMSIS_CFG_NUM_EVENT_FLAGS   4
+#endif
+
+/**
+ * @brief   Number of pre-allocated static mutexes.
+ */
+#if !defined(CMSIS_CFG_NUM_MUTEXES)
+#define CMSIS_CFG_NUM_MUTEXES       4
+#endif
+
+/**
+ * @brief   Number of pre-allocated static semaphores.
+ */
+#if !defined(CMSIS_CFG_NUM_SEMAPHORES)
+#define CMSIS_CFG_NUM_SEMAPHORES    4
+#endif
+
+/**
+ * @brief   Number of pre-allocated static memory pools.
+ */
+#if !defined(CMSIS_CFG_NUM_MEMORY_POOLS)
+#define CMSIS_CFG_NUM_MEMORY_POOLS  2
+#endif
+
+/**
+ * @brief   Number of pre-allocated static message queues.
+ */
+#if !defined(CMSIS_CFG_NUM_MESSAGE_QUEUES)
+#define CMSIS_CFG_NUM_MESSAGE_QUEUES 2
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !CH_CFG_USE_MEMPOOLS
+#error "CMSIS RTOS2 requires CH_CFG_USE_MEMPOOLS"
+#endif
+
+#if !CH_CFG_USE_EVENTS
+#error "CMSIS RTOS2 requires CH_CFG_USE_EVENTS"
+#endif
+
+#if !CH_CFG_USE_EVENTS_TIMEOUT
+#error "CMSIS RTOS2 requires CH_CFG_USE_EVENTS_TIMEOUT"
+#endif
+
+#if !CH_CFG_USE_SEMAPHORES
+#error "CMSIS RTOS2 requires CH_CFG_USE_SEMAPHORES"
+#endif
+
+#if !CH_CFG_USE_MUTEXES
+#error "CMSIS RTOS2 requires CH_CFG_USE_MUTEXES"
+#endif
+
+#if !CH_CFG_USE_OBJ_FIFOS
+#error "CMSIS RTOS2 requires CH_CFG_USE_OBJ_FIFOS"
+#endif
+
+#if (CMSIS_CFG_NUM_THREADS > 0) && !CH_CFG_USE_DYNAMIC
+#error "CMSIS_CFG_NUM_THREADS requires CH_CFG_USE_DYNAMIC"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of status codes.
+ */
+typedef enum {
+  osOK                      = 0,
+  osError                   = -1,
+  osErrorTimeout            = -2,
+  osErrorResource           = -3,
+  osErrorParameter          = -4,
+  osErrorNoMemory           = -5,
+  osErrorISR                = -6,
+  osStatusReserved          = 0x7FFFFFFF
+} osStatus_t;
+
+/**
+ * @brief   Type of the kernel state.
+ */
+typedef enum {
+  osKernelInactive          = 0,
+  osKernelReady             = 1,
+  osKernelRunning           = 2,
+  osKernelLocked            = 3,
+  osKernelSuspended         = 4,
+  osKernelError             = -1,
+  osKernelReserved          = 0x7FFFFFFF
+} osKernelState_t;
+
+/**
+ * @brief   Type of a thread state.
+ */
+typedef enum {
+  osThreadInactive          = 0,
+  osThreadReady             = 1,
+  osThreadRunning           = 2,
+  osThreadBlocked           = 3,
+  osThreadTerminated        = 4,
+  osThreadError             = -1,
+  osThreadReserved          = 0x7FFFFFFF
+} osThreadState_t;
+
+/**
+ * @brief   Type of priority levels.
+ * @note    Priorities are mapped linearly around @p NORMALPRIO.
+ */
+typedef enum {
+  osPriorityNone            = 0,
+  osPriorityIdle            = 1,
+  osPriorityLow             = 8,
+  osPriorityBelowNormal     = 16,
+  osPriorityNormal          = 24,
+  osPriorityAboveNormal     = 32,
+  osPriorityHigh            = 40,
+  osPriorityRealtime        = 48,
+  osPriorityISR             = 56,
+  osPriorityError           = -1,
+  osPriorityReserved        = 0x7FFFFFFF
+} osPriority_t;
+
+/**
+ * @brief   Type of a timer mode.
+ */
+typedef enum {
+  osTimerOnce               = 0,
+  osTimerPeriodic           = 1
+} osTimerType_t;
+
+/**
+ * @brief   Type of thread functions.
+ */
+typedef void (*osThreadFunc_t)(void *argument);
+
+/**
+ * @brief   Type of timer callbacks.
+ */
+typedef void (*osTimerFunc_t)(void *argument);
+
+/**
+ * @brief   Type of kernel version information.
+ */
+typedef struct {
+  uint32_t                  api;
+  uint32_t                  kernel;
+} osVersion_t;
+
+/**
+ * @brief   Type of a timer control block.
+ */
+typedef struct cmsis_os2_timer {
+  virtual_timer_t           vt;
+  osTimerType_t             type;
+  osTimerFunc_t             func;
+  void                      *argument;
+  sysinterval_t             interval;
+  bool                      pooled;
+} cmsis_os2_timer_t;
+
+/**
+ * @brief   Type of an event flags control block.
+ */
+typedef struct cmsis_os2_event_flags {
+  threads_queue_t           queue;
+  uint32_t                  flags;
+  bool                      pooled;
+} cmsis_os2_event_flags_t;
+
+/**
+ * @brief   Type of a mutex control block.
+ */
+typedef struct cmsis_os2_mutex {
+  mutex_t                   mtx;
+  uint32_t                  attr_bits;
+  bool                      pooled;
+} cmsis_os2_mutex_t;
+
+/**
+ * @brief   Type of a semaphore control block.
+ */
+typedef struct cmsis_os2_semaphore {
+  semaphore_t               sem;
+  uint32_t                  max_count;
+  bool                      pooled;
+} cmsis_os2_semaphore_t;
+
+/**
+ * @brief   Type of a memory pool control block.
+ */
+typedef struct cmsis_os2_memory_pool {
+  guarded_memory_pool_t     pool;
+  uint32_t                  block_count;
+  uint32_t                  block_size;
+  bool                      pooled;
+} cmsis_os2_memory_pool_t;
+
+/**
+ * @brief   Type of a message queue control block.
+ */
+typedef struct cmsis_os2_message_queue {
+  objects_fifo_t            fifo;
+  uint32_t                  msg_count;
+  uint32_t                  msg_size;
+  bool                      pooled;
+} cmsis_os2_message_queue_t;
+
+/**
+ * @name    Objects identifiers
+ * @{
+ */
+typedef void *osThreadId_t;
+typedef void *osTimerId_t;
+typedef void *osEventFlagsId_t;
+typedef void *osMutexId_t;
+typedef void *osSemaphoreId_t;
+typedef void *osMemoryPoolId_t;
+typedef void *osMessageQueueId_t;
+/** @} */
+
+/**
+ * @brief   Type of the TrustZone module identifier.
+ */
+typedef uint32_t TZ_ModuleId_t;
+
+/**
+ * @brief   Type of thread attributes.
+ * @note    The thread control block is part of the working area so
+ *          @p cb_mem is ignored, @p stack_mem is the working area and
+ *          must be declared using @p THD_WORKING_AREA().
+ */
+typedef struct {
+  const char                *name;
+  uint32_t                  attr_bits;
+  void                      *cb_mem;
+  uint32_t                  cb_size;
+  void                      *stack_mem;
+  uint32_t                  stack_size;
+  osPriority_t              priority;
+  TZ_ModuleId_t             tz_module;
+  uint32_t                  reserved;
+} osThreadAttr_t;
+
+/**
+ * @brief   Type of timer attributes.
+ */
+typedef struct {
+  const char                *name;
+  uint32_t                  attr_bits;
+  void                      *cb_mem;
+  uint32_t                  cb_size;
+} osTimerAttr_t;
+
+/**
+ * @brief   Type of event flags attributes.
+ */
+typedef struct {
+  const char                *name;
+  uint32_t                  attr_bits;
+  void                      *cb_mem;
+  uint32_t                  cb_size;
+} osEventFlagsAttr_t;
+
+/**
+ * @brief   Type of mutex attributes.
+ */
+typedef struct {
+  const char                *name;
+  uint32_t                  attr_bits;
+  void                      *cb_mem;
+  uint32_t                  cb_size;
+} osMutexAttr_t;
+
+/**
+ * @brief   Type of semaphore attributes.
+ */
+typedef struct {
+  const char                *name;
+  uint32_t                  attr_bits;
+  void                      *cb_mem;
+  uint32_t                  cb_size;
+} osSemaphoreAttr_t;
+
+/**
+ * @brief   Type of memory pool attributes.
+ */
+typedef struct {
+  const char                *name;
+  uint32_t                  attr_bits;
+  void                      *cb_mem;
+  uint32_t                  cb_size;
+  void                      *mp_mem;
+  uint32_t                  mp_size;
+} osMemoryPoolAttr_t;
+
+/**
+ * @brief   Type of message queue attributes.
+ */
+typedef struct {
+  const char                *name;
+  uint32_t                  attr_bits;
+  void                      *cb_mem;
+  uint32_t                  cb_size;
+  void                      *mq_mem;
+  uint32_t                  mq_size;
+} osMessageQueueAttr_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Alignment of memory pool blocks and message queue slots.
+ */
+#define CMSIS_OS2_MEM_ALIGN         PORT_NATURAL_ALIGN
+
+/**
+ * @brief   Size of a memory pool block or of a message queue slot.
+ *
+ * @param[in] size      the block or message size
+ */
+#define CMSIS_OS2_BLOCK_SIZE(size)                                          \
+  MEM_ALIGN_NEXT((size) < sizeof (void *) ? sizeof (void *) : (size),       \
+                 CMSIS_OS2_MEM_ALIGN)
+
+/**
+ * @brief   Size of the @p mp_mem area of a memory pool.
+ *
+ * @param[in] count     number of blocks
+ * @param[in] size      the block size
+ */
+#define CMSIS_OS2_MEMPOOL_MEM_SIZE(count, size)                             \
+  ((count) * CMSIS_OS2_BLOCK_SIZE(size))
+
+/**
+ * @brief   Size of the @p mq_mem area of a message queue.
+ * @details The area contains the messages slots followed by the mailbox
+ *          buffer.
+ *
+ * @param[in] count     number of messages
+ * @param[in] size      the message size
+ */
+#define CMSIS_OS2_MSGQUEUE_MEM_SIZE(count, size)                            \
+  (((count) * CMSIS_OS2_BLOCK_SIZE(size)) + ((count) * sizeof (msg_t)))
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  osStatus_t osKernelInitialize(void);
+  osStatus_t osKernelGetInfo(osVersion_t *version, char *id_buf,
+                             uint32_t id_size);
+  osKernelState_t osKernelGetState(void);
+  osStatus_t osKernelStart(void);
+  uint32_t osKernelGetTickCount(void);
+  uint32_t osKernelGetTickFreq(void);
+  osThreadId_t osThreadNew(osThreadFunc_t func, void *argument,
+                           const osThreadAttr_t *attr);
+  const char *osThreadGetName(osThreadId_t thread_id);
+  osThreadId_t osThreadGetId(void);
+  osThreadState_t osThreadGetState(osThreadId_t thread_id);
+  osStatus_t osThreadSetPriority(osThreadId_t thread_id,
+                                 osPriority_t priority);
+  osPriority_t osThreadGetPriority(osThreadId_t thread_id);
+  osStatus_t osThreadYield(void);
+  osStatus_t osThreadJoin(osThreadId_t thread_id);
+  void osThreadExit(void);
+  osStatus_t osThreadTerminate(osThreadId_t thread_id);
+  uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags);
+  uint32_t osThreadFlagsClear(uint32_t flags);
+  uint32_t osThreadFlagsGet(void);
+  uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options,
+                             uint32_t timeout);
+  osStatus_t osDelay(uint32_t ticks);
+  osStatus_t osDelayUntil(uint32_t ticks);
+  osTimerId_t osTimerNew(osTimerFunc_t func, osTimerType_t type,
+                         void *argument, const osTimerAttr_t *attr);
+  osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks);
+  osStatus_t osTimerStop(osTimerId_t timer_id);
+  uint32_t osTimerIsRunning(osTimerId_t timer_id);
+  osStatus_t osTimerDelete(osTimerId_t timer_id);
+  osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t *attr);
+  uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags);
+  uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags);
+  uint32_t osEventFlagsGet(osEventFlagsId_t ef_id);
+  uint32_t osEventFlagsWait(osEventFlagsId_t ef_id, uint32_t flags,
+                            uint32_t options, uint32_t timeout);
+  osStatus_t osEventFlagsDelete(osEventFlagsId_t ef_id);
+  osMutexId_t osMutexNew(const osMutexAttr_t *attr);
+  osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout);
+  osStatus_t osMutexRelease(osMutexId_t mutex_id);
+  osThreadId_t osMutexGetOwner(osMutexId_t mutex_id);
+  osStatus_t osMutexDelete(osMutexId_t mutex_id);
+  osSemaphoreId_t osSemaphoreNew(uint32_t max_count, uint32_t initial_count,
+                                 const osSemaphoreAttr_t *attr);
+  osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id,
+                                uint32_t timeout);
+  osStatus_t osSemaphoreRelease(osSemaphoreId_t semaphore_id);
+  uint32_t osSemaphoreGetCount(osSemaphoreId_t semaphore_id);
+  osStatus_t osSemaphoreDelete(osSemaphoreId_t semaphore_id);
+  osMemoryPoolId_t osMemoryPoolNew(uint32_t block_count, uint32_t block_size,
+                                   const osMemoryPoolAttr_t *attr);
+  void *osMemoryPoolAlloc(osMemoryPoolId_t mp_id, uint32_t timeout);
+  osStatus_t osMemoryPoolFree(osMemoryPoolId_t mp_id, void *block);
+  uint32_t osMemoryPoolGetCapacity(osMemoryPoolId_t mp_id);
+  uint32_t osMemoryPoolGetBlockSize(osMemoryPoolId_t mp_id);
+  uint32_t osMemoryPoolGetCount(osMemoryPoolId_t mp_id);
+  uint32_t osMemoryPoolGetSpace(osMemoryPoolId_t mp_id);
+  osStatus_t osMemoryPoolDelete(osMemoryPoolId_t mp_id);
+  osMessageQueueId_t osMessageQueueNew(uint32_t msg_count, uint32_t msg_size,
+                                       const osMessageQueueAttr_t *attr);
+  osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id, const void *msg_ptr,
+                               uint8_t msg_prio, uint32_t timeout);
+  osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id, void *msg_ptr,
+                               uint8_t *msg_prio, uint32_t timeout);
+  uint32_t osMessageQueueGetCapacity(osMessageQueueId_t mq_id);
+  uint32_t osMessageQueueGetMsgSize(osMessageQueueId_t mq_id);
+  uint32_t osMessageQueueGetCount(osMessageQueueId_t mq_id);
+  uint32_t osMessageQueueGetSpace(osMessageQueueId_t mq_id);
+  osStatus_t osMessageQueueReset(osMessageQueueId_t mq_id);
+  osStatus_t osMessageQueueDelete(osMessageQueueId_t mq_id);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* CMSIS_OS2_H */
+
+/** @} */
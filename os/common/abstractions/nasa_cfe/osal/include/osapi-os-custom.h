@@ -55,6 +55,13 @@ extern "C" {
   void OS_set_printf(int (*printf)(const char *fmt, ...));
   boolean OS_TaskDeleteCheck(void);
   int32 OS_TaskWait(uint32 task_id);
+  int32 OS_QueueAllocPtr(uint32 queue_id, void **data, int32 timeout);
+  int32 OS_QueuePutPtr(uint32 queue_id, void *data, uint32 size);
+  int32 OS_QueueGetPtr(uint32 queue_id, void **data,
+                       uint32 *size_copied, int32 timeout);
+  int32 OS_QueueGetPtrs(uint32 queue_id, void **data, uint32 *sizes,
+                        uint32 n, uint32 *count, int32 timeout);
+  int32 OS_QueueReleasePtr(uint32 queue_id, void *data);
 #ifdef __cplusplus
 }
 #endif
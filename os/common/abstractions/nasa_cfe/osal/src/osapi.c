@@ -23,6 +23,7 @@
  */
 
 #include <stdarg.h>
+#include <stddef.h>
 #include <string.h>
 
 #include "ch.h"
@@ -66,6 +67,10 @@
 #error "NASA OSAL requires CH_CFG_USE_HEAP"
 #endif
 
+#if CH_CFG_USE_OBJ_FIFOS == FALSE
+#error "NASA OSAL requires CH_CFG_USE_OBJ_FIFOS"
+#endif
+
 /*===========================================================================*/
 /* Module local definitions.                                                 */
 /*===========================================================================*/
@@ -110,11 +115,8 @@ typedef struct {
 typedef struct {
   uint32                is_free;
   char                  name[OS_MAX_API_NAME];
-  semaphore_t           free_msgs;
-  memory_pool_t         messages;
-  mailbox_t             mb;
-  msg_t                 *mb_buffer;
-  void                  *q_buffer;
+  objects_fifo_t        fifo;
+  void                  *buffer;
   uint32                depth;
   uint32                size;
 } osal_queue_t;
@@ -215,6 +217,48 @@ uint32 queue_find(const char *queue_name) {
   return 0;
 }
 
+/**
+ * @brief   Returns the message containing a message body.
+ */
+static inline osal_message_t *queue_message(void *body) {
+
+  return (osal_message_t *)((uint8_t *)body - offsetof(osal_message_t, buf));
+}
+
+/**
+ * @brief   Fetches a message from a queue.
+ */
+static int32 queue_fetch(osal_queue_t *oqp, osal_message_t **omsgp,
+                         int32 timeout) {
+  msg_t msgsts;
+  void *objp;
+
+  /* Special time handling.*/
+  if (timeout == OS_PEND) {
+    msgsts = chFifoReceiveObjectTimeout(&oqp->fifo, &objp, TIME_INFINITE);
+    if (msgsts < MSG_OK) {
+      return OS_ERROR;
+    }
+  }
+  else if (timeout == OS_CHECK) {
+    msgsts = chFifoReceiveObjectTimeout(&oqp->fifo, &objp, TIME_IMMEDIATE);
+    if (msgsts < MSG_OK) {
+      return OS_QUEUE_EMPTY;
+    }
+  }
+  else {
+    msgsts = chFifoReceiveObjectTimeout(&oqp->fifo, &objp,
+                                        (sysinterval_t)timeout);
+    if (msgsts < MSG_OK) {
+      return OS_QUEUE_TIMEOUT;
+    }
+  }
+
+  *omsgp = (osal_message_t *)objp;
+
+  return OS_SUCCESS;
+}
+
 /**
  * @brief   Finds a timer by name.
  */
@@ -699,32 +743,25 @@ int32 OS_QueueCreate(uint32 *queue_id, const char *queue_name,
     return OS_ERR_NO_FREE_IDS;
   }
 
-  /* Attempting messages buffer allocation.*/
+  /* Attempting buffer allocation, messages followed by the FIFO mailbox
+     buffer.*/
   msgsize = MEM_ALIGN_NEXT(data_size + sizeof (size_t), PORT_NATURAL_ALIGN);
-  oqp->mb_buffer = chHeapAllocAligned(NULL,
-                                      msgsize * (size_t)queue_depth,
-                                      PORT_NATURAL_ALIGN);
-  if (oqp->mb_buffer == NULL) {
-    *queue_id = 0;
-    return OS_ERROR;
-  }
-
-  /* Attempting queue buffer allocation.*/
-  oqp->q_buffer = chHeapAllocAligned(NULL,
-                                     sizeof (msg_t) * (size_t)queue_depth,
-                                     PORT_NATURAL_ALIGN);
-  if (oqp->q_buffer == NULL) {
+  oqp->buffer = chHeapAllocAligned(NULL,
+                                   (msgsize + sizeof (msg_t)) *
+                                   (size_t)queue_depth,
+                                   PORT_NATURAL_ALIGN);
+  if (oqp->buffer == NULL) {
+    chPoolFree(&osal.queues_pool, (void *)oqp);
     *queue_id = 0;
-    chHeapFree(oqp->mb_buffer);
     return OS_ERROR;
   }
 
   /* Initializing object static parts.*/
   strncpy(oqp->name, queue_name, OS_MAX_API_NAME - 1);
-  chMBObjectInit(&oqp->mb, oqp->q_buffer, (size_t)queue_depth);
-  chSemObjectInit(&oqp->free_msgs, (cnt_t)queue_depth);
-  chPoolObjectInit(&oqp->messages, msgsize, NULL);
-  chPoolLoadArray(&oqp->messages, oqp->mb_buffer, (size_t)queue_depth);
+  chFifoObjectInit(&oqp->fifo, msgsize, (size_t)queue_depth,
+                   PORT_NATURAL_ALIGN, oqp->buffer,
+                   (msg_t *)((uint8_t *)oqp->buffer +
+                             (msgsize * (size_t)queue_depth)));
   oqp->depth   = queue_depth;
   oqp->size    = data_size;
   oqp->is_free = 0;   /* Note, last.*/
@@ -743,7 +780,7 @@ int32 OS_QueueCreate(uint32 *queue_id, const char *queue_name,
  */
 int32 OS_QueueDelete(uint32 queue_id) {
   osal_queue_t *oqp = (osal_queue_t *)queue_id;
-  void *q_buffer, *mb_buffer;
+  void *buffer;
 
   /* Range check.*/
   if ((oqp < &osal.queues[0]) ||
@@ -758,13 +795,12 @@ int32 OS_QueueDelete(uint32 queue_id) {
   /* Marking as no more free, will be overwritten by the pool pointer.*/
   oqp->is_free = 1;
 
-  /* Pointers to areas to be freed.*/
-  q_buffer  = oqp->q_buffer;
-  mb_buffer = oqp->mb_buffer;
+  /* Pointer to the area to be freed.*/
+  buffer = oqp->buffer;
 
   /* Resetting the queue.*/
-  chMBResetI(&oqp->mb);
-  chSemResetI(&oqp->free_msgs, 0);
+  chMBResetI(&oqp->fifo.mbx);
+  chSemResetI(&oqp->fifo.free.sem, 0);
 
   /* Flagging it as unused and returning it to the pool.*/
   chPoolFreeI(&osal.queues_pool, (void *)oqp);
@@ -774,9 +810,8 @@ int32 OS_QueueDelete(uint32 queue_id) {
   /* Leaving critical zone.*/
   chSysUnlock();
 
-  /* Freeing buffers, outside critical zone, slow heap operation.*/
-  chHeapFree(q_buffer);
-  chHeapFree(mb_buffer);
+  /* Freeing buffer, outside critical zone, slow heap operation.*/
+  chHeapFree(buffer);
 
   return OS_SUCCESS;
 }
@@ -797,8 +832,8 @@ int32 OS_QueueDelete(uint32 queue_id) {
 int32 OS_QueueGet(uint32 queue_id, void *data, uint32 size,
                   uint32 *size_copied, int32 timeout) {
   osal_queue_t *oqp = (osal_queue_t *)queue_id;
-  msg_t msg, msgsts;
-  void *body;
+  osal_message_t *omsg;
+  int32 err;
 
   /* NULL pointer checks.*/
   if ((data == NULL) || (size_copied == NULL)) {
@@ -817,39 +852,18 @@ int32 OS_QueueGet(uint32 queue_id, void *data, uint32 size,
     return OS_QUEUE_INVALID_SIZE;
   }
 
-  /* Special time handling.*/
-  if (timeout == OS_PEND) {
-    msgsts = chMBFetchTimeout(&oqp->mb, &msg, TIME_INFINITE);
-    if (msgsts < MSG_OK) {
-      *size_copied = 0;
-      return OS_ERROR;
-    }
+  err = queue_fetch(oqp, &omsg, timeout);
+  if (err != OS_SUCCESS) {
+    *size_copied = 0;
+    return err;
   }
-  else if (timeout == OS_CHECK) {
-    msgsts = chMBFetchTimeout(&oqp->mb, &msg, TIME_IMMEDIATE);
-    if (msgsts < MSG_OK) {
-      *size_copied = 0;
-      return OS_QUEUE_EMPTY;
-    }
-  }
-  else {
-    msgsts = chMBFetchTimeout(&oqp->mb, &msg, (sysinterval_t)timeout);
-    if (msgsts < MSG_OK) {
-      *size_copied = 0;
-      return OS_QUEUE_TIMEOUT;
-    }
-  }
-
-  /* Message body and size.*/
-  *size_copied = ((osal_message_t *)msg)->size;
-  body  = (void *)((osal_message_t *)msg)->buf;
 
   /* Copying the message body.*/
-  memcpy(data, body, *size_copied);
+  *size_copied = (uint32)omsg->size;
+  memcpy(data, omsg->buf, omsg->size);
 
-  /* Freeing the message buffer.*/
-  chPoolFree(&oqp->messages, (void *)msg);
-  chSemSignal(&oqp->free_msgs);
+  /* Returning the message to the free messages.*/
+  chFifoReturnObject(&oqp->fifo, (void *)omsg);
 
   return OS_SUCCESS;
 }
@@ -867,7 +881,6 @@ int32 OS_QueueGet(uint32 queue_id, void *data, uint32 size,
  */
 int32 OS_QueuePut(uint32 queue_id, void *data, uint32 size, uint32 flags) {
   osal_queue_t *oqp = (osal_queue_t *)queue_id;
-  msg_t msgsts;
   osal_message_t *omsg;
 
   (void)flags;
@@ -889,23 +902,249 @@ int32 OS_QueuePut(uint32 queue_id, void *data, uint32 size, uint32 flags) {
     return OS_QUEUE_INVALID_SIZE;
   }
 
-  /* Getting a message buffer from the pool.*/
-  msgsts = chSemWait(&oqp->free_msgs);
-  if (msgsts < MSG_OK) {
+  /* Getting a free message, NULL if the queue has been deleted.*/
+  omsg = chFifoTakeObjectTimeout(&oqp->fifo, TIME_INFINITE);
+  if (omsg == NULL) {
     return OS_ERROR;
   }
-  omsg = chPoolAlloc(&oqp->messages);
 
   /* Filling message size and data.*/
   omsg->size = (size_t)size;
   memcpy(omsg->buf, data, size);
 
-  /* Posting the message.*/
-  msgsts = chMBPostTimeout(&oqp->mb, (msg_t)omsg, TIME_INFINITE);
-  if (msgsts < MSG_OK) {
-    return OS_ERROR;
+  /* Posting the message, it cannot fail because there is a free slot in
+     the mailbox for each free message.*/
+  chFifoSendObject(&oqp->fifo, (void *)omsg);
+
+  return OS_SUCCESS;
+}
+
+/**
+ * @brief   Takes a free message buffer from the queue.
+ * @details The buffer is filled in place and posted using
+ *          @p OS_QueuePutPtr(), the message is not copied.
+ *
+ * @param[in] queue_id          queue id variable
+ * @param[out] data             pointer to the message buffer pointer, the
+ *                              buffer size is the queue message size
+ * @param[in] timeout           timeout in ticks, the special values @p OS_PEND
+ *                              and @p OS_CHECK can be specified
+ * @return                      An error code.
+ *
+ * @api
+ */
+int32 OS_QueueAllocPtr(uint32 queue_id, void **data, int32 timeout) {
+  osal_queue_t *oqp = (osal_queue_t *)queue_id;
+  osal_message_t *omsg;
+  sysinterval_t interval;
+
+  /* NULL pointer checks.*/
+  if (data == NULL) {
+    return OS_INVALID_POINTER;
+  }
+
+  /* Range check.*/
+  if ((oqp < &osal.queues[0]) ||
+      (oqp >= &osal.queues[OS_MAX_QUEUES]) ||
+      (oqp->is_free)) {
+    return OS_ERR_INVALID_ID;
+  }
+
+  /* Special time handling.*/
+  if (timeout == OS_PEND) {
+    interval = TIME_INFINITE;
+  }
+  else if (timeout == OS_CHECK) {
+    interval = TIME_IMMEDIATE;
+  }
+  else {
+    interval = (sysinterval_t)timeout;
+  }
+
+  omsg = chFifoTakeObjectTimeout(&oqp->fifo, interval);
+  if (omsg == NULL) {
+    *data = NULL;
+    return timeout == OS_PEND ? OS_ERROR : OS_QUEUE_FULL;
+  }
+  *data = (void *)omsg->buf;
+
+  return OS_SUCCESS;
+}
+
+/**
+ * @brief   Posts a message buffer taken using @p OS_QueueAllocPtr().
+ *
+ * @param[in] queue_id          queue id variable
+ * @param[in] data              message buffer pointer
+ * @param[in] size              size of the message
+ * @return                      An error code.
+ *
+ * @api
+ */
+int32 OS_QueuePutPtr(uint32 queue_id, void *data, uint32 size) {
+  osal_queue_t *oqp = (osal_queue_t *)queue_id;
+  osal_message_t *omsg;
+
+  /* NULL pointer checks.*/
+  if (data == NULL) {
+    return OS_INVALID_POINTER;
+  }
+
+  /* Range check.*/
+  if ((oqp < &osal.queues[0]) ||
+      (oqp >= &osal.queues[OS_MAX_QUEUES]) ||
+      (oqp->is_free)) {
+    return OS_ERR_INVALID_ID;
+  }
+
+  /* Check on maximum size.*/
+  if (size > oqp->size) {
+    return OS_QUEUE_INVALID_SIZE;
+  }
+
+  omsg = queue_message(data);
+  omsg->size = (size_t)size;
+  chFifoSendObject(&oqp->fifo, (void *)omsg);
+
+  return OS_SUCCESS;
+}
+
+/**
+ * @brief   Retrieves a message from the queue without copying it.
+ * @details The message buffer must be returned to the queue using
+ *          @p OS_QueueReleasePtr().
+ *
+ * @param[in] queue_id          queue id variable
+ * @param[out] data             pointer to the message buffer pointer
+ * @param[out] size_copied      size of the received message
+ * @param[in] timeout           timeout in ticks, the special values @p OS_PEND
+ *                              and @p OS_CHECK can be specified
+ * @return                      An error code.
+ *
+ * @api
+ */
+int32 OS_QueueGetPtr(uint32 queue_id, void **data,
+                     uint32 *size_copied, int32 timeout) {
+  osal_queue_t *oqp = (osal_queue_t *)queue_id;
+  osal_message_t *omsg;
+  int32 err;
+
+  /* NULL pointer checks.*/
+  if ((data == NULL) || (size_copied == NULL)) {
+    return OS_INVALID_POINTER;
   }
 
+  /* Range check.*/
+  if ((oqp < &osal.queues[0]) ||
+      (oqp >= &osal.queues[OS_MAX_QUEUES]) ||
+      (oqp->is_free)) {
+    return OS_ERR_INVALID_ID;
+  }
+
+  err = queue_fetch(oqp, &omsg, timeout);
+  if (err != OS_SUCCESS) {
+    *data = NULL;
+    *size_copied = 0;
+    return err;
+  }
+
+  *data = (void *)omsg->buf;
+  *size_copied = (uint32)omsg->size;
+
+  return OS_SUCCESS;
+}
+
+/**
+ * @brief   Retrieves multiple messages from the queue without copying them.
+ * @details The function waits for the first message then takes, within
+ *          a single critical zone, all the messages already queued up to
+ *          the specified number. Each buffer must be returned to the queue
+ *          using @p OS_QueueReleasePtr().
+ *
+ * @param[in] queue_id          queue id variable
+ * @param[out] data             array of message buffer pointers
+ * @param[out] sizes            array of received message sizes
+ * @param[in] n                 size of the arrays
+ * @param[out] count            number of received messages
+ * @param[in] timeout           timeout in ticks for the first message, the
+ *                              special values @p OS_PEND and @p OS_CHECK can
+ *                              be specified
+ * @return                      An error code.
+ *
+ * @api
+ */
+int32 OS_QueueGetPtrs(uint32 queue_id, void **data, uint32 *sizes,
+                      uint32 n, uint32 *count, int32 timeout) {
+  osal_queue_t *oqp = (osal_queue_t *)queue_id;
+  osal_message_t *omsg;
+  uint32 i;
+  int32 err;
+
+  /* NULL pointer checks.*/
+  if ((data == NULL) || (sizes == NULL) || (count == NULL)) {
+    return OS_INVALID_POINTER;
+  }
+
+  /* Range check.*/
+  if ((oqp < &osal.queues[0]) ||
+      (oqp >= &osal.queues[OS_MAX_QUEUES]) ||
+      (oqp->is_free) || (n == 0)) {
+    return OS_ERR_INVALID_ID;
+  }
+
+  err = queue_fetch(oqp, &omsg, timeout);
+  if (err != OS_SUCCESS) {
+    *count = 0;
+    return err;
+  }
+  data[0]  = (void *)omsg->buf;
+  sizes[0] = (uint32)omsg->size;
+
+  /* Draining the messages already in the queue.*/
+  chSysLock();
+  for (i = 1; i < n; i++) {
+    void *objp;
+
+    if (chFifoReceiveObjectI(&oqp->fifo, &objp) != MSG_OK) {
+      break;
+    }
+    data[i]  = (void *)((osal_message_t *)objp)->buf;
+    sizes[i] = (uint32)((osal_message_t *)objp)->size;
+  }
+  chSysUnlock();
+  *count = i;
+
+  return OS_SUCCESS;
+}
+
+/**
+ * @brief   Returns a message buffer to the queue.
+ * @details Buffers obtained using @p OS_QueueGetPtr(), @p OS_QueueGetPtrs()
+ *          or @p OS_QueueAllocPtr() can be released.
+ *
+ * @param[in] queue_id          queue id variable
+ * @param[in] data              message buffer pointer
+ * @return                      An error code.
+ *
+ * @api
+ */
+int32 OS_QueueReleasePtr(uint32 queue_id, void *data) {
+  osal_queue_t *oqp = (osal_queue_t *)queue_id;
+
+  /* NULL pointer checks.*/
+  if (data == NULL) {
+    return OS_INVALID_POINTER;
+  }
+
+  /* Range check.*/
+  if ((oqp < &osal.queues[0]) ||
+      (oqp >= &osal.queues[OS_MAX_QUEUES]) ||
+      (oqp->is_free)) {
+    return OS_ERR_INVALID_ID;
+  }
+
+  chFifoReturnObject(&oqp->fifo, (void *)queue_message(data));
+
   return OS_SUCCESS;
 }
 
@@ -2025,12 +2264,8 @@ int32 OS_TaskSetPriority(uint32 task_id, uint32 new_priority) {
                       (threads_queue_t *)tp->u.wtobjp);
     break;
   case CH_STATE_READY:
-#if CH_DBG_ENABLE_ASSERTS
-    /* Prevents an assertion in chSchReadyI().*/
-    tp->state = CH_STATE_CURRENT;
-#endif
     /* Re-enqueues tp with its new priority on the ready list.*/
-    chSchReadyI(queue_dequeue(tp));
+    (void) chSchRequeueReadyI(tp);
     break;
   }
 
@@ -88,6 +88,71 @@ static bool isHndlValid(ts_state_t *handle)
   return TRUE;
 }
 
+static bool isRingValid(ts_ring_t *ringp, size_t size)
+{
+  if ((size < sizeof *ringp) || (ringp->ts_size == 0))
+    return FALSE;
+  if (ringp->ts_size > (size - sizeof *ringp) / sizeof ringp->ts_reqs[0])
+    return FALSE;
+  return (bool)((ringp->ts_wridx - ringp->ts_rdidx) <= ringp->ts_size);
+}
+
+/*
+ * Serves the pending requests of a ring within the time slice. Each
+ * request is dispatched to its service and its completion awaited, an
+ * interrupted request is left at the ring head with status SMC_SVC_INTR
+ * and its completion is awaited again by the next batch invocation.
+ */
+static msg_t processBatch(ts_ring_t *ringp, sysinterval_t timeout)
+{
+  uint32_t rdidx, wridx, size;
+  systime_t start;
+  sysinterval_t elapsed;
+  ts_request_t req;
+  ts_state_t *tssp;
+  msg_t r;
+
+  size = ringp->ts_size;
+  wridx = ringp->ts_wridx;
+  rdidx = ringp->ts_rdidx;
+  start = chVTGetSystemTimeX();
+  while (rdidx != wridx) {
+    elapsed = chTimeDiffX(start, chVTGetSystemTimeX());
+    if (elapsed >= timeout)
+      return SMC_SVC_INTR;
+
+    /* The request is copied in the secure memory before validation.*/
+    req = ringp->ts_reqs[rdidx % size];
+    tssp = req.ts_handle;
+    if (!isHndlValid(tssp))
+      r = SMC_SVC_BADH;
+    else if (req.ts_status == SMC_SVC_INTR) {
+
+      /* Request interrupted by a previous invocation, if the service has
+         done then its last status is taken.*/
+      if (tssp->ts_thdp != NULL)
+        r = tssp->ts_status;
+      else
+        r = chThdSuspendTimeoutS(&_ns_thread, timeout - elapsed);
+    }
+    else if (!isAddrSpaceValid(req.ts_datap, req.ts_datalen))
+      r = SMC_SVC_INVALID;
+    else if (tssp->ts_thdp == NULL)
+      r = SMC_SVC_BUSY;
+    else {
+      tssp->ts_datap = req.ts_datap;
+      tssp->ts_datalen = req.ts_datalen;
+      chThdResumeS(&tssp->ts_thdp, MSG_OK);
+      r = chThdSuspendTimeoutS(&_ns_thread, timeout - elapsed);
+    }
+    ringp->ts_reqs[rdidx % size].ts_status = r;
+    if (r == SMC_SVC_INTR)
+      return SMC_SVC_INTR;
+    ringp->ts_rdidx = ++rdidx;
+  }
+  return SMC_SVC_OK;
+}
+
 static ts_state_t *findSvcsEntry(const char *name)
 {
   int i;
@@ -130,12 +195,19 @@ static ts_state_t *findSvcsEntry(const char *name)
  * @retval SMC_SVC_INVALID  bad parameters.
  * @retval SMC_SVC_NOENT    no such service.
  * @retval SMC_SVC_BADH     bad handle.
+ * @note    The TS_HND_BATCH service serves the requests posted in the
+ *          @p ts_ring_t structure pointed by @p svc_data, many requests
+ *          are processed by a single world switch. It returns SMC_SVC_OK
+ *          when the ring is empty or SMC_SVC_INTR if the time slice
+ *          expired with requests still pending, the status of
+ *          each request is written in the ring.
  *
  * @notapi
  */
 int64_t smcEntry(ts_state_t *svc_handle, ts_params_area_t svc_data,
                size_t svc_datalen, sysinterval_t svc_timeout) {
   ts_state_t *tssp = NULL;
+  ts_ring_t *ringp = NULL;
   msg_t r;
 
   /* Internal query service.*/
@@ -175,19 +247,26 @@ int64_t smcEntry(ts_state_t *svc_handle, ts_params_area_t svc_data,
         return LOWORD(SMC_SVC_NOENT);
       return LOWORD((int32_t)tssp);
     }
+    else if (svc_handle == TS_HND_BATCH) {
+
+      /* Internal batch service, the ring is processed below.*/
+      ringp = (ts_ring_t *)svc_data;
+      if (!isRingValid(ringp, svc_datalen))
+        return LOWORD(SMC_SVC_INVALID);
+    }
     else {
 
       /* User service.*/
       if (!isHndlValid(svc_handle))
         return LOWORD(SMC_SVC_BADH);
       tssp = svc_handle;
-    }
 
-    /* If the service is not waiting requests, it's busy.*/
-    if (tssp->ts_thdp == NULL)
-      return LOWORD(SMC_SVC_BUSY);
-    tssp->ts_datap = svc_data;
-    tssp->ts_datalen = svc_datalen;
+      /* If the service is not waiting requests, it's busy.*/
+      if (tssp->ts_thdp == NULL)
+        return LOWORD(SMC_SVC_BUSY);
+      tssp->ts_datap = svc_data;
+      tssp->ts_datalen = svc_datalen;
+    }
   }
 
 #if (CH_DBG_SYSTEM_STATE_CHECK == TRUE)
@@ -198,9 +277,13 @@ int64_t smcEntry(ts_state_t *svc_handle, ts_params_area_t svc_data,
   if (svc_timeout > TS_MAX_TMO)
     svc_timeout = TS_MAX_TMO;
 
-  if (tssp)
-    chThdResumeS(&tssp->ts_thdp, MSG_OK);
-  r = chThdSuspendTimeoutS(&_ns_thread, TIME_US2I(svc_timeout));
+  if (ringp)
+    r = processBatch(ringp, TIME_US2I(svc_timeout));
+  else {
+    if (tssp)
+      chThdResumeS(&tssp->ts_thdp, MSG_OK);
+    r = chThdSuspendTimeoutS(&_ns_thread, TIME_US2I(svc_timeout));
+  }
 
   /* Get and clear any pending event flags.*/
   eventflags_t f = chEvtGetAndClearFlagsI(&tsEventListener);
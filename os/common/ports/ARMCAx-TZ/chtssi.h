@@ -56,6 +56,7 @@
 #define TS_HND_STQRY          ((ts_state_t *)2)  /* Query status service handle.*/
 #define TS_HND_IDLE           ((ts_state_t *)3)  /* Idle service handle.*/
 #define TS_HND_VERSION        ((ts_state_t *)4)  /* Get version service handle.*/
+#define TS_HND_BATCH          ((ts_state_t *)5)  /* Batch of requests service handle.*/
 
 /* Services events event mask.*/
 #define EVT_DAEMON_REQ_ATN    EVENT_MASK(0)
@@ -116,6 +117,33 @@ typedef struct tssi_service_state {
   uint32_t            ts_datalen;
 } ts_state_t;
 
+/**
+ * @brief   Type of a batched service request.
+ * @note    The fields are written by the client, except @p ts_status that
+ *          is written by the server when the request is processed.
+ */
+typedef struct tssi_request {
+  ts_state_t          *ts_handle;     /* Handle of the invoked service.*/
+  ts_params_area_t    ts_datap;       /* Service request data.*/
+  uint32_t            ts_datalen;     /* Size of the service request data.*/
+  int32_t             ts_status;      /* Service status.*/
+} ts_request_t;
+
+/**
+ * @brief   Type of a requests ring shared with the non secure world.
+ * @details The ring is allocated in the non secure memory space and passed
+ *          to the TS_HND_BATCH service, the requests follow the header.
+ *          Indexes are free running, the client advances @p ts_wridx
+ *          after posting requests, the server advances @p ts_rdidx after
+ *          completing them.
+ */
+typedef struct tssi_ring {
+  uint32_t            ts_size;        /* Number of requests slots.*/
+  uint32_t            ts_wridx;       /* Next slot to be posted.*/
+  uint32_t            ts_rdidx;       /* Next slot to be processed.*/
+  ts_request_t        ts_reqs[];      /* Requests slots.*/
+} ts_ring_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
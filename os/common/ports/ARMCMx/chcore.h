@@ -83,10 +83,26 @@
 #define PORT_USE_ALT_TIMER              FALSE
 #endif
 
+/**
+ * @brief   Number of per-thread MPU regions.
+ * @details Each thread can be associated to a set of MPU regions, on
+ *          context switch only the regions differing from the ones
+ *          currently programmed are rewritten.
+ * @note    Zero disables the feature, only supported on ARMv7-M.
+ */
+#if !defined(PORT_THREAD_MPU_REGIONS) || defined(__DOXYGEN__)
+#define PORT_THREAD_MPU_REGIONS         0
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (PORT_THREAD_MPU_REGIONS > 0) &&                                        \
+    (CORTEX_MODEL != 3) && (CORTEX_MODEL != 4) && (CORTEX_MODEL != 7)
+#error "PORT_THREAD_MPU_REGIONS requires an ARMv7-M core"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -128,14 +144,53 @@ struct port_extctx {};
 struct port_intctx {};
 #endif /* defined(__DOXYGEN__) */
 
+#if (PORT_THREAD_MPU_REGIONS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a MPU region registers pair.
+ * @note    The @p rbar field includes the region number and the
+ *          @p MPU_RBAR_VALID bit so the region is selected by the
+ *          @p RBAR write.
+ */
+typedef struct {
+  uint32_t           rbar;
+  uint32_t           rasr;
+} port_mpu_region_t;
+
+/**
+ * @brief   Type of a per-thread MPU regions set.
+ */
+typedef struct {
+  port_mpu_region_t  regions[PORT_THREAD_MPU_REGIONS];
+} port_mpu_set_t;
+#endif
+
 /**
  * @brief   Platform dependent part of the @p thread_t structure.
  * @details In this port the structure just holds a pointer to the
  *          @p port_intctx structure representing the stack pointer
  *          at context switch time.
+ * @note    On ARMv8-M the structure also holds the thread stack limit and
+ *          the secure context identifier, the offsets of the fields are
+ *          used by the asm context switch code.
  */
 struct port_context {
   struct port_intctx *sp;
+#if (CORTEX_MODEL == 33) || (CORTEX_MODEL == 55) || defined(__DOXYGEN__)
+  /**
+   * @brief   Thread stack limit, value of PSPLIM.
+   */
+  void               *splim;
+  /**
+   * @brief   Secure context of the thread or zero if none.
+   */
+  uint32_t           tzmem;
+#endif
+#if (PORT_THREAD_MPU_REGIONS > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   MPU regions set of the thread or @p NULL if none.
+   */
+  const port_mpu_set_t *mpu;
+#endif
 };
 
 #endif /* !defined(_FROM_ASM_) */
@@ -194,6 +249,8 @@ struct port_context {
 #elif (CORTEX_MODEL == 3) || (CORTEX_MODEL == 4) || (CORTEX_MODEL == 7)
 #include "mpu.h"
 #include "chcore_v7m.h"
+#elif (CORTEX_MODEL == 33) || (CORTEX_MODEL == 55)
+#include "chcore_v8m.h"
 #else
 #error "unknown Cortex-M variant"
 #endif
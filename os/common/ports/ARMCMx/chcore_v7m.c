@@ -31,6 +31,21 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+/**
+ * @brief   EXC_RETURN bit signaling a basic (non-FPU) exception frame.
+ */
+#define PORT_EXC_RETURN_FTYPE           0x00000010U
+
+/**
+ * @brief   Size of a basic exception frame.
+ */
+#define PORT_BASIC_EXTCTX_SIZE          (8U * sizeof (regarm_t))
+
+/* The hot path marker is only defined by the RT kernel.*/
+#if !defined(CH_HOTPATH)
+#define CH_HOTPATH
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -39,14 +54,85 @@
 /* Module local types.                                                       */
 /*===========================================================================*/
 
+#if (CORTEX_USE_FAST_MAILBOX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Fast IRQ mailbox type.
+ * @note    The counters are free running, the number of pending entries
+ *          is <tt>wr - rd</tt>.
+ */
+typedef struct {
+  /**
+   * @brief   Write counter, updated by producers using exclusive accesses.
+   */
+  volatile uint32_t             wr;
+  /**
+   * @brief   Read counter, only updated by the PendSV handler.
+   */
+  volatile uint32_t             rd;
+  /**
+   * @brief   Entries, a @p NULL callback marks a free or incomplete entry.
+   */
+  volatile struct {
+    port_fastcb_t               cb;
+    void                        *arg;
+  } entries[CORTEX_FAST_MAILBOX_SIZE];
+} port_fastmb_t;
+#endif
+
 /*===========================================================================*/
 /* Module local variables.                                                   */
 /*===========================================================================*/
 
+#if (CORTEX_USE_FAST_MAILBOX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Fast IRQ mailbox.
+ */
+static port_fastmb_t fast_mailbox;
+#endif
+
+#if (PORT_THREAD_MPU_REGIONS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Cached values of the per-thread MPU regions registers.
+ * @note    The cache mirrors the MPU content, it is used to rewrite only
+ *          the regions that differ on context switch.
+ */
+static port_mpu_region_t mpu_cache[PORT_THREAD_MPU_REGIONS];
+#endif
+
 /*===========================================================================*/
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CORTEX_USE_FAST_MAILBOX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Invokes the callbacks posted in the fast IRQ mailbox.
+ * @note    An entry reserved but not yet written by a preempted producer
+ *          stops the loop, the producer pends PendSV again after writing
+ *          it.
+ *
+ * @iclass
+ */
+static void fast_mailbox_serve(void) {
+
+  while (fast_mailbox.rd != fast_mailbox.wr) {
+    uint32_t i = fast_mailbox.rd & ((uint32_t)CORTEX_FAST_MAILBOX_SIZE - 1U);
+    port_fastcb_t cb = fast_mailbox.entries[i].cb;
+    void *arg;
+
+    if (cb == NULL) {
+      break;
+    }
+    arg = fast_mailbox.entries[i].arg;
+
+    /* Freeing the entry before invoking the callback.*/
+    fast_mailbox.entries[i].cb = NULL;
+    fast_mailbox.rd++;
+
+    cb(arg);
+  }
+}
+#endif
+
 /*===========================================================================*/
 /* Module interrupt handlers.                                                */
 /*===========================================================================*/
@@ -59,21 +145,36 @@
  * @note    The PendSV vector is only used in advanced kernel mode.
  */
 /*lint -save -e9075 [8.4] All symbols are invoked from asm context.*/
-void SVC_Handler(void) {
+CH_HOTPATH void SVC_Handler(void) {
 /*lint -restore*/
   struct port_extctx *ctxp;
+#if CORTEX_USE_FPU_TRACKING == TRUE
+  uint32_t lr = port_get_exc_return();
+#endif
+
+  /* The port_extctx structure is pointed by the PSP register.*/
+  ctxp = (struct port_extctx *)__get_PSP();
 
+#if CORTEX_USE_FPU_TRACKING == TRUE
+  if ((lr & PORT_EXC_RETURN_FTYPE) != 0U) {
+    /* Basic frame, the switched-in thread has no FPU context.*/
+    ctxp = (struct port_extctx *)((uint8_t *)ctxp + PORT_BASIC_EXTCTX_SIZE);
+  }
+  else {
+    /* Enforcing unstacking of the FP part of the context.*/
+    FPU->FPCCR &= ~FPU_FPCCR_LSPACT_Msk;
+    ctxp++;
+  }
+#else
 #if CORTEX_USE_FPU
   /* Enforcing unstacking of the FP part of the context.*/
   FPU->FPCCR &= ~FPU_FPCCR_LSPACT_Msk;
 #endif
 
-  /* The port_extctx structure is pointed by the PSP register.*/
-  ctxp = (struct port_extctx *)__get_PSP();
-
   /* Discarding the current exception context and positioning the stack to
      point to the real one.*/
   ctxp++;
+#endif
 
   /* Restoring real position of the original stack frame.*/
   __set_PSP((uint32_t)ctxp);
@@ -91,48 +192,109 @@ void SVC_Handler(void) {
  * @note    The PendSV vector is only used in compact kernel mode.
  */
 /*lint -save -e9075 [8.4] All symbols are invoked from asm context.*/
-void PendSV_Handler(void) {
+CH_HOTPATH void PendSV_Handler(void) {
 /*lint -restore*/
   struct port_extctx *ctxp;
+#if CORTEX_USE_FPU_TRACKING == TRUE
+  uint32_t lr = port_get_exc_return();
+#endif
+
+  /* The port_extctx structure is pointed by the PSP register.*/
+  ctxp = (struct port_extctx *)__get_PSP();
 
+#if CORTEX_USE_FPU_TRACKING == TRUE
+  if ((lr & PORT_EXC_RETURN_FTYPE) != 0U) {
+    /* Basic frame, the switched-in thread has no FPU context.*/
+    ctxp = (struct port_extctx *)((uint8_t *)ctxp + PORT_BASIC_EXTCTX_SIZE);
+  }
+  else {
+    /* Enforcing unstacking of the FP part of the context.*/
+    FPU->FPCCR &= ~FPU_FPCCR_LSPACT_Msk;
+    ctxp++;
+  }
+#else
 #if CORTEX_USE_FPU
   /* Enforcing unstacking of the FP part of the context.*/
   FPU->FPCCR &= ~FPU_FPCCR_LSPACT_Msk;
 #endif
 
-  /* The port_extctx structure is pointed by the PSP register.*/
-  ctxp = (struct port_extctx *)__get_PSP();
-
   /* Discarding the current exception context and positioning the stack to
      point to the real one.*/
   ctxp++;
+#endif
 
   /* Writing back the modified PSP value.*/
   __set_PSP((uint32_t)ctxp);
 }
 #endif /* CORTEX_SIMPLIFIED_PRIORITY == TRUE */
 
+#if (CORTEX_USE_FAST_MAILBOX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   PendSV vector.
+ * @details In advanced kernel mode the PendSV vector is used for serving
+ *          the fast IRQ mailbox, it is a normal kernel ISR at the highest
+ *          kernel priority.
+ *
+ * @isr
+ */
+/*lint -save -e9075 [8.4] All symbols are invoked from asm context.*/
+CH_IRQ_HANDLER(PendSV_Handler) {
+/*lint -restore*/
+
+  CH_IRQ_PROLOGUE();
+
+  chSysLockFromISR();
+  fast_mailbox_serve();
+  chSysUnlockFromISR();
+
+  CH_IRQ_EPILOGUE();
+}
+#endif /* CORTEX_USE_FAST_MAILBOX == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
 
 /**
  * @brief   Exception exit redirection to _port_switch_from_isr().
+ * @note    If @p CORTEX_USE_FPU_TRACKING is enabled then the function
+ *          receives the @p EXC_RETURN value of the exception and the
+ *          artificial context has the same format of the thread frame.
  */
-void _port_irq_epilogue(void) {
+#if (CORTEX_USE_FPU_TRACKING == FALSE) || defined(__DOXYGEN__)
+CH_HOTPATH void _port_irq_epilogue(void) {
+#else
+CH_HOTPATH void _port_irq_epilogue(uint32_t lr) {
+#endif
 
   port_lock_from_isr();
   if ((SCB->ICSR & SCB_ICSR_RETTOBASE_Msk) != 0U) {
     struct port_extctx *ctxp;
 
+    /* The port_extctx structure is pointed by the PSP register.*/
+    ctxp = (struct port_extctx *)__get_PSP();
+
+#if CORTEX_USE_FPU_TRACKING == TRUE
+    if ((lr & PORT_EXC_RETURN_FTYPE) != 0U) {
+      /* Basic frame, the preempted thread has no FPU context.*/
+      ctxp = (struct port_extctx *)((uint8_t *)ctxp - PORT_BASIC_EXTCTX_SIZE);
+    }
+    else {
+      /* Enforcing a lazy FPU state save by accessing the FPCSR register.*/
+      (void) __get_FPSCR();
+
+      ctxp--;
+      ctxp->fpscr = (regarm_t)FPU->FPDSCR;
+    }
+
+    /* Setting up a fake XPSR register value.*/
+    ctxp->xpsr = (regarm_t)0x01000000;
+#else
 #if CORTEX_USE_FPU == TRUE
       /* Enforcing a lazy FPU state save by accessing the FPCSR register.*/
       (void) __get_FPSCR();
 #endif
 
-    /* The port_extctx structure is pointed by the PSP register.*/
-    ctxp = (struct port_extctx *)__get_PSP();
-
     /* Adding an artificial exception return context, there is no need to
        populate it fully.*/
     ctxp--;
@@ -141,6 +303,7 @@ void _port_irq_epilogue(void) {
     ctxp->xpsr = (regarm_t)0x01000000;
 #if CORTEX_USE_FPU == TRUE
     ctxp->fpscr = (regarm_t)FPU->FPDSCR;
+#endif
 #endif
 
     /* Writing back the modified PSP value.*/
@@ -165,4 +328,137 @@ void _port_irq_epilogue(void) {
   port_unlock_from_isr();
 }
 
+#if (CORTEX_USE_FAST_MAILBOX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Posts a callback in the fast IRQ mailbox.
+ * @details The callback is invoked, with the kernel locked, by the PendSV
+ *          handler, it can use I-Class APIs in order to signal threads.
+ *          The function is lock-free, it does not touch @p BASEPRI and
+ *          can be called from fast interrupts.
+ * @note    Callbacks are invoked in posting order.
+ *
+ * @param[in] cb        callback function, it cannot be @p NULL
+ * @param[in] arg       argument to be passed to the callback
+ * @return              The operation status.
+ * @retval true         if the callback has been posted.
+ * @retval false        if the mailbox is full.
+ *
+ * @special
+ */
+bool port_fast_post(port_fastcb_t cb, void *arg) {
+  uint32_t wr, i;
+
+  /* Reserving an entry, an exception between the exclusive load and store
+     makes the store fail and the operation is retried.*/
+  do {
+    wr = __LDREXW(&fast_mailbox.wr);
+    if ((wr - fast_mailbox.rd) >= (uint32_t)CORTEX_FAST_MAILBOX_SIZE) {
+      __CLREX();
+      return false;
+    }
+  } while (__STREXW(wr + 1U, &fast_mailbox.wr) != 0U);
+
+  /* Writing the entry, the callback is written last because it marks
+     the entry as complete.*/
+  i = wr & ((uint32_t)CORTEX_FAST_MAILBOX_SIZE - 1U);
+  fast_mailbox.entries[i].arg = arg;
+  fast_mailbox.entries[i].cb  = cb;
+
+  /* Triggering the mailbox serving.*/
+  SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+
+  return true;
+}
+#endif /* CORTEX_USE_FAST_MAILBOX == TRUE */
+
+#if (PORT_THREAD_MPU_REGIONS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Per-thread MPU regions initialization.
+ * @details All the per-thread regions are disabled.
+ *
+ * @notapi
+ */
+void _port_mpu_init(void) {
+  uint32_t i;
+
+  for (i = 0U; i < (uint32_t)PORT_THREAD_MPU_REGIONS; i++) {
+    mpu_cache[i].rbar = MPU_RBAR_VALID |
+                        MPU_RBAR_REGION(PORT_THREAD_MPU_BASE_REGION + i);
+    mpu_cache[i].rasr = 0U;
+    MPU->RBAR = mpu_cache[i].rbar;
+    MPU->RASR = mpu_cache[i].rasr;
+  }
+}
+
+/**
+ * @brief   Loads the MPU regions set of the current thread.
+ * @details Only the regions differing from the cached values are
+ *          written, threads sharing the same settings cost just the
+ *          comparisons. A thread without a set has all the per-thread
+ *          regions disabled.
+ * @note    This function is invoked after each context switch and on
+ *          threads start, with the kernel locked.
+ *
+ * @notapi
+ */
+CH_HOTPATH void _port_mpu_switch(void) {
+  const port_mpu_set_t *setp = chThdGetSelfX()->ctx.mpu;
+  bool changed = false;
+  uint32_t i;
+
+  for (i = 0U; i < (uint32_t)PORT_THREAD_MPU_REGIONS; i++) {
+    uint32_t rbar, rasr;
+
+    if (setp != NULL) {
+      rbar = setp->regions[i].rbar;
+      rasr = setp->regions[i].rasr;
+    }
+    else {
+      rbar = MPU_RBAR_VALID |
+             MPU_RBAR_REGION(PORT_THREAD_MPU_BASE_REGION + i);
+      rasr = 0U;
+    }
+
+    if ((rbar != mpu_cache[i].rbar) || (rasr != mpu_cache[i].rasr)) {
+      /* The region is selected by the RBAR write because the VALID bit
+         is set.*/
+      MPU->RBAR = rbar;
+      MPU->RASR = rasr;
+      mpu_cache[i].rbar = rbar;
+      mpu_cache[i].rasr = rasr;
+      changed = true;
+    }
+  }
+
+  /* New settings must be effective before returning to the thread.*/
+  if (changed) {
+    __DSB();
+    __ISB();
+  }
+}
+
+/**
+ * @brief   Assigns a MPU regions set to a thread.
+ * @details If the thread is the current thread then the MPU is updated
+ *          immediately, this function can also be used to make effective
+ *          the changes made to the set of the current thread.
+ * @note    The set is not copied, it must remain valid while assigned.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] setp      pointer to the @p port_mpu_set_t structure or
+ *                      @p NULL for no per-thread regions
+ *
+ * @api
+ */
+void port_thread_set_mpu(thread_t *tp, const port_mpu_set_t *setp) {
+
+  port_lock();
+  tp->ctx.mpu = setp;
+  if (tp == chThdGetSelfX()) {
+    _port_mpu_switch();
+  }
+  port_unlock();
+}
+#endif /* PORT_THREAD_MPU_REGIONS > 0 */
+
 /** @} */
@@ -57,8 +57,14 @@
  * @brief   Working Areas alignment constant.
  * @note    It is the alignment to be enforced for thread working areas.
  */
-#define PORT_WORKING_AREA_ALIGN         (PORT_ENABLE_GUARD_PAGES == TRUE ?  \
+#define PORT_WORKING_AREA_ALIGN         (((PORT_ENABLE_GUARD_PAGES == TRUE) || \
+                                          (CH_CFG_CACHE_LAYOUT == TRUE)) ?  \
                                          32U : PORT_STACK_ALIGN)
+
+/**
+ * @brief   Data cache line size.
+ */
+#define PORT_CACHE_LINE_SIZE            32U
 /** @} */
 
 /**
@@ -81,6 +87,22 @@
 #define PORT_ENABLE_GUARD_PAGES         FALSE
 #endif
 
+/**
+ * @brief   First MPU region used for the per-thread regions.
+ * @details The regions from @p PORT_THREAD_MPU_BASE_REGION to
+ *          <tt>PORT_THREAD_MPU_BASE_REGION + PORT_THREAD_MPU_REGIONS - 1</tt>
+ *          are reserved to the per-thread sets, lower regions can be used
+ *          for static settings.
+ * @note    Region zero is used by the guard pages if enabled.
+ */
+#if !defined(PORT_THREAD_MPU_BASE_REGION) || defined(__DOXYGEN__)
+#if (PORT_ENABLE_GUARD_PAGES == TRUE) || defined(__DOXYGEN__)
+#define PORT_THREAD_MPU_BASE_REGION     1
+#else
+#define PORT_THREAD_MPU_BASE_REGION     0
+#endif
+#endif
+
 /**
  * @brief   Stack size for the system idle thread.
  * @details This size depends on the idle thread implementation, usually
@@ -126,6 +148,46 @@
 #error "the selected core does not have an FPU"
 #endif
 
+/**
+ * @brief   Per-thread FPU context tracking.
+ * @details If enabled, the high FPU registers S16...S31 are saved and
+ *          restored during a context switch only for threads having an
+ *          active FPU context (@p CONTROL.FPCA set), threads that never
+ *          executed an FPU instruction are switched as on a core without
+ *          FPU. The exception frames are also basic or extended depending
+ *          on the thread, this reduces the switch time and the actual
+ *          stack usage of integer-only threads.
+ * @note    The working area size is still computed for the worst case
+ *          because the FPU usage of a thread is not known statically.
+ * @note    The kernel code executed during an ISR-triggered reschedule
+ *          must not use FPU instructions, this is the normal case unless
+ *          the FPU is used from the debug or statistics hooks.
+ */
+#if !defined(CORTEX_USE_FPU_TRACKING) || defined(__DOXYGEN__)
+#define CORTEX_USE_FPU_TRACKING         FALSE
+#endif
+
+/**
+ * @brief   Fast IRQ mailbox.
+ * @details If enabled, fast interrupts, whose priority is above the kernel
+ *          priority levels, can post callbacks using @p port_fast_post().
+ *          The callbacks are then invoked by the PendSV handler with the
+ *          kernel locked, I-Class APIs can be used there.
+ * @note    Requires the advanced kernel mode, in compact mode the PendSV
+ *          vector is used for context switching.
+ */
+#if !defined(CORTEX_USE_FAST_MAILBOX) || defined(__DOXYGEN__)
+#define CORTEX_USE_FAST_MAILBOX         FALSE
+#endif
+
+/**
+ * @brief   Number of entries in the fast IRQ mailbox.
+ * @note    Must be a power of two.
+ */
+#if !defined(CORTEX_FAST_MAILBOX_SIZE) || defined(__DOXYGEN__)
+#define CORTEX_FAST_MAILBOX_SIZE        8
+#endif
+
 /**
  * @brief   Simplified priority handling flag.
  * @details Activating this option makes the Kernel work in compact mode.
@@ -163,6 +225,31 @@
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (CORTEX_USE_FPU_TRACKING == TRUE) && (CORTEX_USE_FPU == FALSE)
+#error "CORTEX_USE_FPU_TRACKING requires CORTEX_USE_FPU"
+#endif
+
+#if CORTEX_USE_FAST_MAILBOX == TRUE
+#if CORTEX_SIMPLIFIED_PRIORITY == TRUE
+#error "CORTEX_USE_FAST_MAILBOX requires the advanced kernel mode"
+#endif
+
+#if (CORTEX_FAST_MAILBOX_SIZE <= 0) ||                                      \
+    ((CORTEX_FAST_MAILBOX_SIZE & (CORTEX_FAST_MAILBOX_SIZE - 1)) != 0)
+#error "CORTEX_FAST_MAILBOX_SIZE must be a power of two"
+#endif
+#endif
+
+/**
+ * @brief   Worst case stack space of the optional FPU part of the
+ *          internal context.
+ */
+#if (CORTEX_USE_FPU_TRACKING == TRUE) || defined(__DOXYGEN__)
+#define PORT_INTCTX_FPU_SIZE            (16U * 4U)
+#else
+#define PORT_INTCTX_FPU_SIZE            0U
+#endif
+
 #if !defined(_FROM_ASM_)
 /**
  * @brief   MPU guard page size.
@@ -178,6 +265,18 @@
 #else
   #define PORT_GUARD_PAGE_SIZE          0U
 #endif
+
+#if PORT_THREAD_MPU_REGIONS > 0
+  #if __MPU_PRESENT == 0
+    #error "MPU not present in current device"
+  #endif
+  #if (PORT_THREAD_MPU_BASE_REGION + PORT_THREAD_MPU_REGIONS) > 16
+    #error "invalid PORT_THREAD_MPU_BASE_REGION/PORT_THREAD_MPU_REGIONS"
+  #endif
+  #if (PORT_ENABLE_GUARD_PAGES == TRUE) && (PORT_THREAD_MPU_BASE_REGION == 0)
+    #error "MPU region 0 is used by the guard pages"
+  #endif
+#endif
 #endif /* !defined(_FROM_ASM_) */
 
 /**
@@ -343,7 +442,10 @@ struct port_extctx {
 };
 
 struct port_intctx {
-#if CORTEX_USE_FPU
+#if CORTEX_USE_FPU_TRACKING
+  /* Saved CONTROL.FPCA bit, S16...S31 follow only if it is set.*/
+  regarm_t      fpca;
+#elif CORTEX_USE_FPU
   regarm_t      s16;
   regarm_t      s17;
   regarm_t      s18;
@@ -373,6 +475,15 @@ struct port_intctx {
 };
 #endif /* !defined(__DOXYGEN__) */
 
+#if (CORTEX_USE_FAST_MAILBOX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a fast IRQ mailbox callback.
+ *
+ * @param[in] arg       the argument posted with the callback
+ */
+typedef void (*port_fastcb_t)(void *arg);
+#endif
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -388,14 +499,64 @@ struct port_intctx {
   (tp)->ctx.sp->r4 = (regarm_t)(pf);                                        \
   (tp)->ctx.sp->r5 = (regarm_t)(arg);                                       \
   (tp)->ctx.sp->lr = (regarm_t)_port_thread_start;                          \
+  PORT_SETUP_CONTEXT_FPU(tp);                                               \
+  PORT_SETUP_CONTEXT_MPU(tp);                                               \
 }
 
+#if (CORTEX_USE_FPU_TRACKING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   New threads start without an FPU context.
+ */
+#define PORT_SETUP_CONTEXT_FPU(tp) ((tp)->ctx.sp->fpca = (regarm_t)0)
+#else
+#define PORT_SETUP_CONTEXT_FPU(tp)
+#endif
+
+#if (PORT_THREAD_MPU_REGIONS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   New threads start without per-thread MPU regions.
+ */
+#define PORT_SETUP_CONTEXT_MPU(tp) ((tp)->ctx.mpu = NULL)
+
+/**
+ * @brief   Updates the per-thread MPU regions after a context switch.
+ */
+#define PORT_SWITCH_MPU() _port_mpu_switch()
+#else
+#define PORT_SETUP_CONTEXT_MPU(tp)
+#define PORT_SWITCH_MPU()
+#endif
+
+#if (PORT_THREAD_MPU_REGIONS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Sets a region in a per-thread MPU regions set.
+ * @note    If the set is assigned to the current thread then the change
+ *          takes effect on the next call to @p port_thread_set_mpu() or
+ *          on the next context switch.
+ *
+ * @param[out] setp     pointer to the @p port_mpu_set_t structure
+ * @param[in] n         region index in the set, from zero to
+ *                      @p PORT_THREAD_MPU_REGIONS - 1
+ * @param[in] addr      region base address
+ * @param[in] attribs   region attributes, the @p MPU_RASR_* values, a
+ *                      zero value disables the region
+ */
+#define port_mpu_set_region(setp, n, addr, attribs) {                       \
+  (setp)->regions[n].rbar = ((uint32_t)(addr) & MPU_RBAR_ADDR_MASK) |       \
+                            MPU_RBAR_VALID |                                \
+                            MPU_RBAR_REGION(PORT_THREAD_MPU_BASE_REGION +   \
+                                            (uint32_t)(n));                 \
+  (setp)->regions[n].rasr = (uint32_t)(attribs);                            \
+}
+#endif
+
 /**
  * @brief   Computes the thread working area global size.
  * @note    There is no need to perform alignments in this macro.
  */
 #define PORT_WA_SIZE(n) ((size_t)PORT_GUARD_PAGE_SIZE +                     \
                          sizeof (struct port_intctx) +                      \
+                         (size_t)PORT_INTCTX_FPU_SIZE +                     \
                          sizeof (struct port_extctx) +                      \
                          (size_t)(n) +                                      \
                          (size_t)PORT_INT_REQUIRED_STACK)
@@ -416,6 +577,40 @@ struct port_intctx {
   ALIGNED_VAR(32) stkalign_t s[THD_WORKING_AREA_SIZE(n) / sizeof (stkalign_t)]
 #endif
 
+/**
+ * @brief   Returns the @p EXC_RETURN value of the current exception.
+ * @note    The value is only meaningful at the start of the body of an
+ *          exception handler.
+ */
+#if defined(__GNUC__) || defined(__DOXYGEN__)
+#define port_get_exc_return() ((uint32_t)__builtin_return_address(0))
+#elif defined(__ICCARM__)
+#define port_get_exc_return() ((uint32_t)__get_LR())
+#elif defined(__CC_ARM)
+#define port_get_exc_return() ((uint32_t)__return_address())
+#endif
+
+#if defined(__GNUC__) || defined(__DOXYGEN__)
+/**
+ * @brief   Places a function in the @p .itcm section.
+ * @note    The section is copied in ITCM RAM at startup by the linker
+ *          scripts of the devices having one.
+ */
+#define PORT_HOTPATH        __attribute__((section(".itcm")))
+
+/**
+ * @brief   Places a variable in the @p .dtcm section.
+ * @note    The section is not initialized.
+ */
+#define PORT_FASTDATA       __attribute__((section(".dtcm")))
+
+/**
+ * @brief   Aligns a structure field to a data cache line.
+ */
+#define PORT_CACHE_ALIGNED  __attribute__((aligned(PORT_CACHE_LINE_SIZE)))
+#endif
+
+#if (CORTEX_USE_FPU_TRACKING == FALSE) || defined(__DOXYGEN__)
 /**
  * @brief   IRQ prologue code.
  * @details This macro must be inserted at the start of all IRQ handlers
@@ -429,6 +624,12 @@ struct port_intctx {
  *          enabled to invoke system APIs.
  */
 #define PORT_IRQ_EPILOGUE() _port_irq_epilogue()
+#else
+#define PORT_IRQ_PROLOGUE()                                                 \
+  uint32_t _saved_lr = port_get_exc_return()
+
+#define PORT_IRQ_EPILOGUE() _port_irq_epilogue(_saved_lr)
+#endif
 
 /**
  * @brief   IRQ handler function declaration.
@@ -455,8 +656,15 @@ struct port_intctx {
  * @param[in] otp       the thread to be switched out
  */
 #if (CH_DBG_ENABLE_STACK_CHECK == FALSE) || defined(__DOXYGEN__)
+#if (PORT_THREAD_MPU_REGIONS == 0) || defined(__DOXYGEN__)
 #define port_switch(ntp, otp) _port_switch(ntp, otp)
 #else
+#define port_switch(ntp, otp) {                                             \
+  _port_switch(ntp, otp);                                                   \
+  PORT_SWITCH_MPU();                                                        \
+}
+#endif
+#else
 #if PORT_ENABLE_GUARD_PAGES == FALSE
 #define port_switch(ntp, otp) {                                             \
   struct port_intctx *r13 = (struct port_intctx *)__get_PSP();              \
@@ -464,6 +672,7 @@ struct port_intctx {
     chSysHalt("stack overflow");                                            \
   }                                                                         \
   _port_switch(ntp, otp);                                                   \
+  PORT_SWITCH_MPU();                                                        \
 }
 #else
 #define port_switch(ntp, otp) {                                             \
@@ -476,6 +685,7 @@ struct port_intctx {
                      MPU_RASR_ATTR_NON_CACHEABLE |                          \
                      MPU_RASR_SIZE_32 |                                     \
                      MPU_RASR_ENABLE);                                      \
+  PORT_SWITCH_MPU();                                                        \
 }
 #endif
 #endif
@@ -487,11 +697,23 @@ struct port_intctx {
 #ifdef __cplusplus
 extern "C" {
 #endif
+#if CORTEX_USE_FPU_TRACKING == FALSE
   void _port_irq_epilogue(void);
+#else
+  void _port_irq_epilogue(uint32_t lr);
+#endif
   void _port_switch(thread_t *ntp, thread_t *otp);
+#if CORTEX_USE_FAST_MAILBOX == TRUE
+  bool port_fast_post(port_fastcb_t cb, void *arg);
+#endif
   void _port_thread_start(void);
   void _port_switch_from_isr(void);
   void _port_exit_from_isr(void);
+#if PORT_THREAD_MPU_REGIONS > 0
+  void _port_mpu_init(void);
+  void _port_mpu_switch(void);
+  void port_thread_set_mpu(thread_t *tp, const port_mpu_set_t *setp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -534,9 +756,17 @@ static inline void port_init(void) {
                        MPU_RASR_SIZE_32 |
                        MPU_RASR_ENABLE);
 
+#if PORT_THREAD_MPU_REGIONS > 0
+    _port_mpu_init();
+#endif
+
     /* MPU is enabled.*/
     mpuEnable(MPU_CTRL_PRIVDEFENA);
   }
+#elif PORT_THREAD_MPU_REGIONS > 0
+  /* Per-thread regions initially disabled, MPU enabled.*/
+  _port_mpu_init();
+  mpuEnable(MPU_CTRL_PRIVDEFENA);
 #endif
 }
 
@@ -0,0 +1,245 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chcore_v8m.c
+ * @brief   ARMv8-M Mainline architecture port code.
+ *
+ * @addtogroup ARMCMx_V8M_CORE
+ * @{
+ */
+
+#include "ch.h"
+
+#if (PORT_USE_SECURE_CONTEXT == TRUE) || defined(__DOXYGEN__)
+#include "tz_context.h"
+#endif
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   EXC_RETURN bit signaling a frame stacked on the secure stack.
+ */
+#define PORT_EXC_RETURN_S               0x00000040U
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module interrupt handlers.                                                */
+/*===========================================================================*/
+
+#if (CORTEX_SIMPLIFIED_PRIORITY == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   SVC vector.
+ * @details The SVC vector is used for exception mode re-entering after a
+ *          context switch.
+ * @note    The PendSV vector is only used in advanced kernel mode.
+ */
+/*lint -save -e9075 [8.4] All symbols are invoked from asm context.*/
+void SVC_Handler(void) {
+/*lint -restore*/
+  struct port_extctx *ctxp;
+
+#if CORTEX_USE_FPU
+  /* Enforcing unstacking of the FP part of the context.*/
+  FPU->FPCCR &= ~FPU_FPCCR_LSPACT_Msk;
+#endif
+
+  /* The port_extctx structure is pointed by the PSP register.*/
+  ctxp = (struct port_extctx *)__get_PSP();
+
+  /* Discarding the current exception context and positioning the stack to
+     point to the real one.*/
+  ctxp++;
+
+  /* Restoring real position of the original stack frame.*/
+  __set_PSP((uint32_t)ctxp);
+
+  /* Restoring the normal interrupts status.*/
+  port_unlock_from_isr();
+}
+#endif /* CORTEX_SIMPLIFIED_PRIORITY == FALSE */
+
+#if (CORTEX_SIMPLIFIED_PRIORITY == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   PendSV vector.
+ * @details The PendSV vector is used for exception mode re-entering after a
+ *          context switch.
+ * @note    The PendSV vector is only used in compact kernel mode.
+ */
+/*lint -save -e9075 [8.4] All symbols are invoked from asm context.*/
+void PendSV_Handler(void) {
+/*lint -restore*/
+  struct port_extctx *ctxp;
+
+#if CORTEX_USE_FPU
+  /* Enforcing unstacking of the FP part of the context.*/
+  FPU->FPCCR &= ~FPU_FPCCR_LSPACT_Msk;
+#endif
+
+  /* The port_extctx structure is pointed by the PSP register.*/
+  ctxp = (struct port_extctx *)__get_PSP();
+
+  /* Discarding the current exception context and positioning the stack to
+     point to the real one.*/
+  ctxp++;
+
+  /* Writing back the modified PSP value.*/
+  __set_PSP((uint32_t)ctxp);
+}
+#endif /* CORTEX_SIMPLIFIED_PRIORITY == TRUE */
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Exception exit redirection to _port_switch_from_isr().
+ * @note    If the interrupted thread was executing secure code then its
+ *          frame is on the secure stack and cannot be redirected, the
+ *          preemption is deferred to the next interrupt or kernel call
+ *          after the secure function returns.
+ *
+ * @param[in] lr        the EXC_RETURN value of the exception
+ */
+void _port_irq_epilogue(uint32_t lr) {
+
+#if PORT_USE_SECURE_CONTEXT == FALSE
+  (void)lr;
+#endif
+
+  port_lock_from_isr();
+#if PORT_USE_SECURE_CONTEXT == TRUE
+  if (((SCB->ICSR & SCB_ICSR_RETTOBASE_Msk) != 0U) &&
+      ((lr & PORT_EXC_RETURN_S) == 0U)) {
+#else
+  if ((SCB->ICSR & SCB_ICSR_RETTOBASE_Msk) != 0U) {
+#endif
+    struct port_extctx *ctxp;
+
+#if CORTEX_USE_FPU == TRUE
+      /* Enforcing a lazy FPU state save by accessing the FPCSR register.*/
+      (void) __get_FPSCR();
+#endif
+
+    /* The port_extctx structure is pointed by the PSP register.*/
+    ctxp = (struct port_extctx *)__get_PSP();
+
+    /* Adding an artificial exception return context, there is no need to
+       populate it fully.*/
+    ctxp--;
+
+    /* Setting up a fake XPSR register value.*/
+    ctxp->xpsr = (regarm_t)0x01000000;
+#if CORTEX_USE_FPU == TRUE
+    ctxp->fpscr = (regarm_t)FPU->FPDSCR;
+#endif
+
+    /* Writing back the modified PSP value.*/
+    __set_PSP((uint32_t)ctxp);
+
+    /* The exit sequence is different depending on if a preemption is
+       required or not.*/
+    if (chSchIsPreemptionRequired()) {
+      /* Preemption is required we need to enforce a context switch.*/
+      ctxp->pc = (regarm_t)_port_switch_from_isr;
+    }
+    else {
+      /* Preemption not required, we just need to exit the exception
+         atomically.*/
+      ctxp->pc = (regarm_t)_port_exit_from_isr;
+    }
+
+    /* Note, returning without unlocking is intentional, this is done in
+       order to keep the rest of the context switch atomic.*/
+    return;
+  }
+  port_unlock_from_isr();
+}
+
+#if (PORT_USE_SECURE_CONTEXT == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Allocates a secure context for the current thread.
+ * @details The context is loaded immediately, from now on it is saved and
+ *          restored by the context switch together with the thread
+ *          non-secure context.
+ * @note    A thread must own a secure context before calling secure
+ *          services that use the secure stack.
+ *
+ * @param[in] module    the secure module identifier
+ * @return              The operation status.
+ * @retval false        if the operation succeeded.
+ * @retval true         if the secure side failed to allocate a context.
+ */
+bool port_secure_context_alloc(uint32_t module) {
+  thread_t *tp = chThdGetSelfX();
+  TZ_MemoryId_t id;
+
+  chDbgAssert(tp->ctx.tzmem == 0U, "context already allocated");
+
+  id = TZ_AllocModuleContext_S((TZ_ModuleId_t)module);
+  if (id == 0U) {
+    return true;
+  }
+
+  chSysLock();
+  tp->ctx.tzmem = (uint32_t)id;
+  (void) TZ_LoadContext_S(id);
+  chSysUnlock();
+
+  return false;
+}
+
+/**
+ * @brief   Releases the secure context of the current thread.
+ * @note    Threads owning a secure context must call this function before
+ *          terminating.
+ */
+void port_secure_context_free(void) {
+  thread_t *tp = chThdGetSelfX();
+  TZ_MemoryId_t id;
+
+  chSysLock();
+  id = (TZ_MemoryId_t)tp->ctx.tzmem;
+  tp->ctx.tzmem = 0U;
+  chSysUnlock();
+
+  if (id != 0U) {
+    (void) TZ_FreeModuleContext_S(id);
+  }
+}
+#endif /* PORT_USE_SECURE_CONTEXT == TRUE */
+
+/** @} */
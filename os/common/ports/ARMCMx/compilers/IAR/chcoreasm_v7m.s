@@ -58,6 +58,7 @@
 
 SCB_ICSR        SET 0xE000ED04
 ICSR_PENDSVSET  SET 0x10000000
+CONTROL_FPCA    SET 4
 
                 SECTION .text:CODE:NOROOT(2)
 
@@ -72,6 +73,9 @@ ICSR_PENDSVSET  SET 0x10000000
                 EXTERN  _dbg_check_unlock
                 EXTERN  _dbg_check_lock
 #endif
+#if PORT_THREAD_MPU_REGIONS > 0
+                EXTERN  _port_mpu_switch
+#endif
 
                 THUMB
 
@@ -81,7 +85,15 @@ ICSR_PENDSVSET  SET 0x10000000
                 PUBLIC _port_switch
 _port_switch:
                 push    {r4, r5, r6, r7, r8, r9, r10, r11, lr}
-#if CORTEX_USE_FPU
+#if CORTEX_USE_FPU_TRACKING
+                /* The high FPU registers are saved only if the thread
+                   has an active FPU context, the FPCA bit is saved.*/
+                mrs     r3, CONTROL
+                ands    r3, r3, #CONTROL_FPCA
+                it      ne
+                vpushne {s16-s31}
+                push    {r3}
+#elif CORTEX_USE_FPU
                 vpush   {s16-s31}
 #endif
 
@@ -96,7 +108,19 @@ _port_switch:
                 ldr     sp, [r0, #CONTEXT_OFFSET]
 #endif
 
-#if CORTEX_USE_FPU
+#if CORTEX_USE_FPU_TRACKING
+                /* Restoring the FPU context and the FPCA bit of the
+                   switched-in thread.*/
+                pop     {r3}
+                cmp     r3, #0
+                it      ne
+                vpopne  {s16-s31}
+                mrs     r2, CONTROL
+                bic     r2, r2, #CONTROL_FPCA
+                orr     r2, r2, r3
+                msr     CONTROL, r2
+                isb
+#elif CORTEX_USE_FPU
                 vpop    {s16-s31}
 #endif
                 pop     {r4, r5, r6, r7, r8, r9, r10, r11, pc}
@@ -107,6 +131,9 @@ _port_switch:
  */
                 PUBLIC  _port_thread_start
 _port_thread_start:
+#if PORT_THREAD_MPU_REGIONS > 0
+                bl      _port_mpu_switch
+#endif
 #if CH_DBG_SYSTEM_STATE_CHECK
                 bl      _dbg_check_unlock
 #endif
@@ -53,6 +53,7 @@
 
 SCB_ICSR        EQU     0xE000ED04
 ICSR_PENDSVSET  EQU     0x10000000
+CONTROL_FPCA    EQU     4
 
                 PRESERVE8
                 THUMB
@@ -68,6 +69,9 @@ ICSR_PENDSVSET  EQU     0x10000000
                 IMPORT  _dbg_check_unlock
                 IMPORT  _dbg_check_lock
 #endif
+#if PORT_THREAD_MPU_REGIONS > 0
+                IMPORT  _port_mpu_switch
+#endif
 
 /*
  * Performs a context switch between two threads.
@@ -75,7 +79,15 @@ ICSR_PENDSVSET  EQU     0x10000000
                 EXPORT _port_switch
 _port_switch    PROC
                 push    {r4, r5, r6, r7, r8, r9, r10, r11, lr}
-#if CORTEX_USE_FPU
+#if CORTEX_USE_FPU_TRACKING
+                /* The high FPU registers are saved only if the thread
+                   has an active FPU context, the FPCA bit is saved.*/
+                mrs     r3, CONTROL
+                ands    r3, r3, #CONTROL_FPCA
+                it      ne
+                vpushne {s16-s31}
+                push    {r3}
+#elif CORTEX_USE_FPU
                 vpush   {s16-s31}
 #endif
 
@@ -90,7 +102,19 @@ _port_switch    PROC
                 ldr     sp, [r0, #CONTEXT_OFFSET]
 #endif
 
-#if CORTEX_USE_FPU
+#if CORTEX_USE_FPU_TRACKING
+                /* Restoring the FPU context and the FPCA bit of the
+                   switched-in thread.*/
+                pop     {r3}
+                cmp     r3, #0
+                it      ne
+                vpopne  {s16-s31}
+                mrs     r2, CONTROL
+                bic     r2, r2, #CONTROL_FPCA
+                orr     r2, r2, r3
+                msr     CONTROL, r2
+                isb
+#elif CORTEX_USE_FPU
                 vpop    {s16-s31}
 #endif
                 pop     {r4, r5, r6, r7, r8, r9, r10, r11, pc}
@@ -102,6 +126,9 @@ _port_switch    PROC
  */
                 EXPORT  _port_thread_start
 _port_thread_start PROC
+#if PORT_THREAD_MPU_REGIONS > 0
+                bl      _port_mpu_switch
+#endif
 #if CH_DBG_SYSTEM_STATE_CHECK
                 bl      _dbg_check_unlock
 #endif
@@ -319,11 +319,27 @@ struct port_context {
 #define PORT_IRQ_EPILOGUE() {                                               \
   __avr_in_isr = false;                                                     \
   _dbg_check_lock();                                                        \
-  if (chSchIsPreemptionRequired())                                          \
+  if (port_is_preemption_possible() && chSchIsPreemptionRequired())         \
     chSchDoReschedule();                                                    \
   _dbg_check_unlock();                                                      \
 }
 
+/**
+ * @brief   Inline preemption pre-check of the IRQ epilogue.
+ * @details Preemption cannot be required if the first ready thread has a
+ *          lower priority than the current one, this is the common case
+ *          and the call to @p chSchIsPreemptionRequired() is avoided.
+ * @note    In RT this saves a function call from most interrupts, in NIL
+ *          the check is left to @p chSchIsPreemptionRequired().
+ */
+#if (defined(_CHIBIOS_RT_) &&                                               \
+     !defined(CH_SCH_IS_PREEMPTION_REQUIRED_HOOKED)) || defined(__DOXYGEN__)
+#define port_is_preemption_possible()                                       \
+  (firstprio(&ch.rlist.queue) >= currp->prio)
+#else
+#define port_is_preemption_possible() true
+#endif
+
 /**
  * @brief   IRQ handler function declaration.
  * @note    @p id can be a function name or a vector number depending on the
@@ -162,6 +162,18 @@
 #define PPC_USE_VLE                     TRUE
 #endif
 
+/**
+ * @brief   Enables interrupts nesting.
+ * @details If enabled the IVOR handlers re-enable the external interrupts
+ *          before invoking the software handlers, higher priority INTC
+ *          sources can then preempt lower priority handlers.
+ * @note    Nested handlers return directly to the preempted handler, the
+ *          reschedule check is only performed by the outermost one.
+ */
+#if !defined(PPC_USE_IRQ_PREEMPTION) || defined(__DOXYGEN__)
+#define PPC_USE_IRQ_PREEMPTION          FALSE
+#endif
+
 /**
  * @brief   Enables the use of the @p WFI instruction.
  */
@@ -612,18 +624,24 @@ static inline void port_unlock(void) {
 
 /**
  * @brief   Kernel-lock action from an interrupt handler.
- * @note    Implementation not needed.
+ * @note    Implementation not needed if interrupts nesting is disabled.
  */
 static inline void port_lock_from_isr(void) {
 
+#if PPC_USE_IRQ_PREEMPTION
+  port_lock();
+#endif
 }
 
 /**
  * @brief   Kernel-unlock action from an interrupt handler.
- * @note    Implementation not needed.
+ * @note    Implementation not needed if interrupts nesting is disabled.
  */
 static inline void port_unlock_from_isr(void) {
 
+#if PPC_USE_IRQ_PREEMPTION
+  port_unlock();
+#endif
 }
 
 /**
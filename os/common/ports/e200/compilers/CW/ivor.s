@@ -88,10 +88,9 @@ _IVOR10:
 
         /* Restoring pre-IRQ MSR register value.*/
         mfSRR1      r0
-#if !PPC_USE_IRQ_PREEMPTION
-        /* No preemption, keeping EE disabled.*/
+        /* The system tick handler runs in a critical zone, EE is kept
+           disabled also when interrupts nesting is enabled.*/
         se_bclri    r0, 16                 /* EE = bit 16.                 */
-#endif
         mtMSR       r0
 
 #if CH_DBG_SYSTEM_STATE_CHECK
@@ -105,11 +104,6 @@ _IVOR10:
         bl          _dbg_check_leave_isr
 #endif
 
-#if PPC_USE_IRQ_PREEMPTION
-        /* Prevents preemption again.*/
-        wrteei      0
-#endif
-
         /* Jumps to the common IVOR epilogue code.*/
         se_b        _ivor_exit
 #endif /* PPC_SUPPORTS_DECREMENTER */
@@ -169,6 +163,13 @@ _ivor_exit:
         se_subi     r0, 1
         mtspr       272, r0
 
+#if PPC_USE_IRQ_PREEMPTION
+        /* Nested interrupts return to the preempted ISR, the reschedule
+           check is only performed when leaving the outermost ISR.*/
+        e_cmpli     cr0, r0, 0
+        se_bne      .ivor_restore
+#endif
+
 #if CH_DBG_STATISTICS
         e_bl        _stats_start_measure_crit_thd
 #endif
@@ -187,6 +188,7 @@ _ivor_exit:
         e_bl        _stats_stop_measure_crit_thd
 #endif
 
+.ivor_restore:
         /* Restoring the external context.*/
         e_lmvgprw   32(r1)                 /* Restores GPR0, GPR3...GPR12. */
         e_lmvsprw   16(r1)                 /* Restores CR, LR, CTR, XER.   */
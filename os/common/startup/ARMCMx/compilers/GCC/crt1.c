@@ -22,6 +22,7 @@
  * @{
  */
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -86,6 +87,25 @@ extern uint32_t __ram6_init_text__, __ram6_init__, __ram6_clear__, __ram6_noinit
 extern uint32_t __ram7_init_text__, __ram7_init__, __ram7_clear__, __ram7_noinit__;
 #endif
 
+/* ITCM code area, the symbols are only defined by the linker scripts of
+   devices having an ITCM RAM.*/
+extern uint32_t __itcm_init_text__ __attribute__((weak));
+extern uint32_t __itcm_init__ __attribute__((weak));
+extern uint32_t __itcm_end__ __attribute__((weak));
+
+/* Deferred BSS area, the symbols are only defined by the linker scripts
+   including rules_data.ld.*/
+extern uint32_t __bss_deferred_start__ __attribute__((weak));
+extern uint32_t __bss_deferred_end__ __attribute__((weak));
+
+/**
+ * @brief   Deferred BSS clear pointer.
+ * @details Everything below this pointer in the deferred BSS area has
+ *          been zeroed, @p NULL means that the clear is not started.
+ * @note    This variable is in the normal BSS so it is zero at startup.
+ */
+static uint32_t *bss_deferred_p;
+
 /**
  * @brief   Static table of areas to be initialized.
  */
@@ -214,6 +234,77 @@ void __init_ram_areas(void) {
   }
   while (rap < &ram_areas[CRT1_AREAS_NUMBER]);
 #endif
+
+  /* Copying the ITCM code, nothing is done if the area is not defined.*/
+  {
+    uint32_t *tp = &__itcm_init_text__;
+    uint32_t *p = &__itcm_init__;
+
+    while (p < &__itcm_end__) {
+      *p = *tp;
+      p++;
+      tp++;
+    }
+
+    /* The copied code must be visible to the instruction fetches.*/
+    __asm volatile ("dsb\n\tisb" : : : "memory");
+  }
+}
+
+/**
+ * @brief   Incremental clear of the deferred BSS area.
+ * @details The @p .bss_deferred section is not initialized at startup, it
+ *          is meant for large buffers whose zeroing would delay the start
+ *          of the application. This function zeroes the next @p n bytes
+ *          of the area, it can be invoked repeatedly by a low priority
+ *          thread or in a single call before the first use.
+ * @note    The function is not reentrant, a single thread must perform
+ *          the clear, other users can check the progress using
+ *          @p __bss_deferred_is_clear().
+ *
+ * @param[in] n         maximum number of bytes to be cleared, zero means
+ *                      the whole remaining area
+ * @return              The clear state.
+ * @retval false        if part of the area is still to be cleared.
+ * @retval true         if the whole area has been cleared.
+ */
+bool __bss_deferred_clear(size_t n) {
+  uint32_t *p = bss_deferred_p;
+  uint32_t *end = &__bss_deferred_end__;
+
+  if (p == NULL) {
+    p = &__bss_deferred_start__;
+  }
+
+  if ((n > 0U) && ((size_t)(end - p) > (n / sizeof (uint32_t)))) {
+    end = p + ((n + sizeof (uint32_t) - 1U) / sizeof (uint32_t));
+  }
+
+  while (p < end) {
+    *p = 0U;
+    p++;
+  }
+
+  /* The zeroed memory is visible before the progress is advanced.*/
+  __asm volatile ("dmb" : : : "memory");
+  bss_deferred_p = p;
+
+  return p >= &__bss_deferred_end__;
+}
+
+/**
+ * @brief   Checks if part of the deferred BSS area has been cleared.
+ *
+ * @param[in] p         pointer to an object in the deferred BSS area
+ * @param[in] n         size of the object
+ * @return              The object state.
+ * @retval false        if the object is not yet cleared.
+ * @retval true         if the object is cleared.
+ */
+bool __bss_deferred_is_clear(const void *p, size_t n) {
+  const uint8_t *cp = (const uint8_t *)bss_deferred_p;
+
+  return (cp != NULL) && (((const uint8_t *)p + n) <= cp);
 }
 
 /** @} */
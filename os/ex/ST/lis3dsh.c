@@ -42,6 +42,13 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Sampling periods in microseconds indexed by the ODR field.
+ */
+static const uint32_t acc_odr_periods[] = {
+  0U, 320000U, 160000U, 80000U, 40000U, 20000U, 10000U, 2500U, 1250U, 625U
+};
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -156,6 +163,97 @@ static msg_t acc_read_raw(void *ip, int32_t axes[]) {
   return msg;
 }
 
+/**
+ * @brief   Retrieves a batch of raw samples from the FIFO.
+ * @details The FIFO level is read first then all the available samples,
+ *          up to @p n, are read with a single SPI transaction. The bytes
+ *          are received into the upper part of @p axes and expanded in
+ *          place so there is no intermediate buffer.
+ * @note    The output registers address wraps from @p OUT_Z_H to
+ *          @p OUT_X_L when the FIFO is enabled, consecutive samples are
+ *          read by a single burst.
+ * @note    The buffer could be written by DMA, on cached architectures it
+ *          must be located in a non-cacheable memory area.
+ *
+ * @param[in] ip        pointer to @p BaseAccelerometer interface.
+ * @param[out] axes     a buffer able to hold @p n raw samples.
+ * @param[in] n         maximum number of samples
+ * @param[out] bp       pointer to the batch descriptor
+ *
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ */
+static msg_t acc_read_fifo(void *ip, int32_t axes[], size_t n,
+                           sensor_fifo_batch_t *bp) {
+  LIS3DSHDriver* devp;
+  uint8_t src, *rp;
+  size_t i, m;
+  int16_t tmp;
+  msg_t msg = MSG_OK;
+
+  osalDbgCheck((ip != NULL) && (axes != NULL) && (n > 0U) && (bp != NULL));
+
+  /* Getting parent instance pointer.*/
+  devp = objGetInstance(LIS3DSHDriver*, (BaseAccelerometer*)ip);
+
+  osalDbgAssert((devp->state == LIS3DSH_READY),
+                "acc_read_fifo(), invalid state");
+  osalDbgAssert((devp->config->accfifowatermark > 0U),
+                "acc_read_fifo(), FIFO not enabled");
+
+  /* The raw data is received at the end of the buffer.*/
+  rp = (uint8_t *)&axes[n * LIS3DSH_ACC_NUMBER_OF_AXES] -
+       (n * LIS3DSH_ACC_NUMBER_OF_AXES * 2U);
+
+#if LIS3DSH_USE_SPI
+#if	LIS3DSH_SHARED_SPI
+  osalDbgAssert((devp->config->spip->state == SPI_READY),
+                "acc_read_fifo(), channel not ready");
+
+  spiAcquireBus(devp->config->spip);
+  spiStart(devp->config->spip,
+           devp->config->spicfg);
+#endif /* LIS3DSH_SHARED_SPI */
+
+  lis3dshSPIReadRegister(devp->config->spip, LIS3DSH_AD_FIFO_SRC, 1, &src);
+  bp->time = osalOsGetSystemTimeX();
+
+  /* FSS is a 5 bits counter, a full FIFO is reported by the overrun flag.*/
+  if ((src & LIS3DSH_FIFO_SRC_OVRN_FIFO) != 0U) {
+    m = LIS3DSH_ACC_FIFO_SIZE;
+  }
+  else {
+    m = (size_t)(src & LIS3DSH_FIFO_SRC_FSS_MASK);
+  }
+  if (m > n) {
+    m = n;
+  }
+  rp += (n - m) * LIS3DSH_ACC_NUMBER_OF_AXES * 2U;
+
+  if (m > 0U) {
+    lis3dshSPIReadRegister(devp->config->spip, LIS3DSH_AD_OUT_X_L,
+                           m * LIS3DSH_ACC_NUMBER_OF_AXES * 2U, rp);
+  }
+
+#if	LIS3DSH_SHARED_SPI
+  spiReleaseBus(devp->config->spip);
+#endif /* LIS3DSH_SHARED_SPI */
+#endif /* LIS3DSH_USE_SPI */
+
+  /* Expanding forward, each 32 bits element is written over raw bytes
+     already consumed.*/
+  for(i = 0; i < m * LIS3DSH_ACC_NUMBER_OF_AXES; i++) {
+    tmp = rp[2 * i] + (rp[2 * i + 1] << 8);
+    axes[i] = (int32_t)tmp;
+  }
+
+  bp->samples = m;
+  bp->period  = acc_odr_periods[devp->config->accoutputdatarate >> 4];
+  bp->overrun = (src & LIS3DSH_FIFO_SRC_OVRN_FIFO) != 0U;
+
+  return msg;
+}
+
 /**
  * @brief   Retrieves cooked data from the BaseAccelerometer.
  * @note    This data is manipulated according to the formula
@@ -431,7 +529,8 @@ static const struct LIS3DSHVMT vmt_device = {
 static const struct BaseAccelerometerVMT vmt_accelerometer = {
   sizeof(struct LIS3DSHVMT*),
   acc_get_axes_number, acc_read_raw, acc_read_cooked,
-  acc_set_bias, acc_reset_bias, acc_set_sensivity, acc_reset_sensivity
+  acc_set_bias, acc_reset_bias, acc_set_sensivity, acc_reset_sensivity,
+  acc_read_fifo
 };
 
 /*===========================================================================*/
@@ -467,7 +566,8 @@ void lis3dshObjectInit(LIS3DSHDriver *devp) {
 void lis3dshStart(LIS3DSHDriver *devp, const LIS3DSHConfig *config) {
   uint32_t i;
   uint8_t cr;
-  osalDbgCheck((devp != NULL) && (config != NULL));
+  osalDbgCheck((devp != NULL) && (config != NULL) &&
+               (config->accfifowatermark < LIS3DSH_ACC_FIFO_SIZE));
 
   osalDbgAssert((devp->state == LIS3DSH_STOP) ||
                 (devp->state == LIS3DSH_READY),
@@ -524,6 +624,10 @@ void lis3dshStart(LIS3DSHDriver *devp, const LIS3DSHConfig *config) {
 #if LIS3DSH_USE_ADVANCED || defined(__DOXYGEN__)
     cr |= devp->config->accblockdataupdate;
 #endif
+    if(devp->config->accfifowatermark > 0U) {
+      cr |= LIS3DSH_CTRL_REG6_FIFO_EN | LIS3DSH_CTRL_REG6_WTM_EN |
+            LIS3DSH_CTRL_REG6_P1_WTM;
+    }
   }
 
 #if LIS3DSH_USE_SPI
@@ -539,6 +643,32 @@ void lis3dshStart(LIS3DSHDriver *devp, const LIS3DSHConfig *config) {
 #endif /* LIS3DSH_SHARED_SPI */
 #endif /* LIS3DSH_USE_SPI */
 
+  /* FIFO configuration block, stream mode with the watermark routed on
+     the INT1 pin as an active high signal.*/
+  if(devp->config->accfifowatermark > 0U) {
+    uint8_t fcr[2];
+
+    fcr[0] = LIS3DSH_FIFO_CTRL_FMODE_STREAM |
+             (devp->config->accfifowatermark & LIS3DSH_FIFO_CTRL_WTMP_MASK);
+    fcr[1] = LIS3DSH_CTRL_REG3_INT1_EN | LIS3DSH_CTRL_REG3_IEA;
+
+#if LIS3DSH_USE_SPI
+#if LIS3DSH_SHARED_SPI
+    spiAcquireBus(devp->config->spip);
+    spiStart(devp->config->spip, devp->config->spicfg);
+#endif /* LIS3DSH_SHARED_SPI */
+
+    lis3dshSPIWriteRegister(devp->config->spip, LIS3DSH_AD_FIFO_CTRL, 1,
+                            &fcr[0]);
+    lis3dshSPIWriteRegister(devp->config->spip, LIS3DSH_AD_CTRL_REG3, 1,
+                            &fcr[1]);
+
+#if LIS3DSH_SHARED_SPI
+    spiReleaseBus(devp->config->spip);
+#endif /* LIS3DSH_SHARED_SPI */
+#endif /* LIS3DSH_USE_SPI */
+  }
+
   /* Storing sensitivity information according to user setting */
   if(devp->config->accfullscale == LIS3DSH_ACC_FS_2G) {
     devp->accfullscale = LIS3DSH_ACC_2G;
@@ -286,6 +286,34 @@
 #define LIS3DSH_CTRL_REG6_BOOT              (1 << 7)
 /** @} */
 
+/**
+ * @name    LIS3DSH_FIFO_CTRL register bits definitions
+ * @{
+ */
+#define LIS3DSH_FIFO_CTRL_MASK              0xFF
+#define LIS3DSH_FIFO_CTRL_WTMP_MASK         0x1F
+#define LIS3DSH_FIFO_CTRL_FMODE_MASK        0xE0
+#define LIS3DSH_FIFO_CTRL_FMODE_BYPASS      (0 << 5)
+#define LIS3DSH_FIFO_CTRL_FMODE_FIFO        (1 << 5)
+#define LIS3DSH_FIFO_CTRL_FMODE_STREAM      (2 << 5)
+/** @} */
+
+/**
+ * @name    LIS3DSH_FIFO_SRC register bits definitions
+ * @{
+ */
+#define LIS3DSH_FIFO_SRC_MASK               0xFF
+#define LIS3DSH_FIFO_SRC_FSS_MASK           0x1F
+#define LIS3DSH_FIFO_SRC_EMPTY              (1 << 5)
+#define LIS3DSH_FIFO_SRC_OVRN_FIFO          (1 << 6)
+#define LIS3DSH_FIFO_SRC_WTM                (1 << 7)
+/** @} */
+
+/**
+ * @brief   LIS3DSH FIFO depth in samples.
+ */
+#define LIS3DSH_ACC_FIFO_SIZE               32U
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -492,6 +520,14 @@ typedef struct {
    */
   lis3dsh_acc_bdu_t         accblockdataupdate;
 #endif
+  /**
+   * @brief   LIS3DSH FIFO watermark in samples.
+   * @details If non-zero the FIFO is enabled in stream mode and the INT1
+   *          pin is asserted while the FIFO level exceeds the watermark,
+   *          the FIFO is read using @p accelerometerReadFIFO(). The value
+   *          must be lower than @p LIS3DSH_ACC_FIFO_SIZE.
+   */
+  uint8_t                   accfifowatermark;
 } LIS3DSHConfig;
 
 /**
@@ -671,6 +707,40 @@ struct LIS3DSHDriver {
 #define lis3dshAccelerometerResetSensitivity(devp)                          \
         accelerometerResetSensitivity(&((devp)->acc_if))
 
+/**
+ * @brief   Reads a batch of raw samples from the LIS3DSH FIFO.
+ * @note    The FIFO must be enabled in the configuration.
+ *
+ * @param[in] devp      pointer to @p LIS3DSHDriver.
+ * @param[out] axes     a buffer able to hold @p n raw samples.
+ * @param[in] n         maximum number of samples
+ * @param[out] bp       pointer to the batch descriptor
+ *
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ *
+ * @api
+ */
+#define lis3dshAccelerometerReadFIFO(devp, axes, n, bp)                     \
+        accelerometerReadFIFO(&((devp)->acc_if), axes, n, bp)
+
+/**
+ * @brief   Converts a batch of raw accelerometer samples to cooked data.
+ * @details The current sensitivities and biases are applied, the result
+ *          is the same of @p lis3dshAccelerometerReadCooked() for each sample.
+ *
+ * @param[in] devp      pointer to @p LIS3DSHDriver.
+ * @param[in] raw       raw samples as returned by
+ *                      @p lis3dshAccelerometerReadFIFO().
+ * @param[out] cooked   a buffer able to hold @p n cooked samples.
+ * @param[in] n         number of samples
+ *
+ * @api
+ */
+#define lis3dshAccelerometerCookFIFO(devp, raw, cooked, n)                  \
+        sensorCookBlock(raw, cooked, n, LIS3DSH_ACC_NUMBER_OF_AXES,         \
+                        (devp)->accsensitivity, (devp)->accbias)
+
 /**
  * @brief   Changes the LIS3DSHDriver accelerometer fullscale value.
  * @note    This function also rescale sensitivities and biases based on
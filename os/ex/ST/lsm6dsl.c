@@ -42,6 +42,13 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Sampling periods in microseconds indexed by the ODR field.
+ */
+static const uint32_t odr_periods[] = {
+  0U, 80000U, 38462U, 19231U, 9615U, 4808U, 2404U, 1200U, 600U, 300U, 150U
+};
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -85,6 +92,99 @@ msg_t lsm6dslI2CReadRegister(I2CDriver *i2cp, lsm6dsl_sad_t sad, uint8_t reg,
                                   TIME_INFINITE)
 #endif /* LSM6DSL_USE_I2C */
 
+/**
+ * @brief   Retrieves a batch of raw samples from the FIFO.
+ * @details The FIFO level is read first then all the available samples,
+ *          up to @p n, are read with a single I2C transaction. The bytes
+ *          are received into the upper part of @p axes and expanded in
+ *          place so there is no intermediate buffer.
+ * @note    The register address rolls back from @p FIFO_DATA_OUT_H to
+ *          @p FIFO_DATA_OUT_L during a multiple read, consecutive samples
+ *          are read by a single burst.
+ * @note    The buffer could be written by DMA, on cached architectures it
+ *          must be located in a non-cacheable memory area.
+ *
+ * @param[in] devp      pointer to the @p LSM6DSLDriver object
+ * @param[out] axes     a buffer able to hold @p n raw samples.
+ * @param[in] n         maximum number of samples
+ * @param[out] bp       pointer to the batch descriptor
+ *
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred, the errors can
+ *                      be retrieved using @p i2cGetErrors().
+ * @retval MSG_TIMEOUT  if a timeout occurred before operation end.
+ */
+static msg_t fifo_read(LSM6DSLDriver *devp, int32_t axes[], size_t n,
+                       sensor_fifo_batch_t *bp) {
+  uint8_t status[2] = {0U, 0U}, odr, *rp;
+  size_t i, m = 0U;
+  int16_t tmp;
+  msg_t msg;
+
+  /* The raw data is received at the end of the buffer, each sample is
+     made of three 16 bits words.*/
+  rp = (uint8_t *)&axes[n * 3U] - (n * 3U * 2U);
+
+#if LSM6DSL_USE_I2C
+  osalDbgAssert((devp->config->i2cp->state == I2C_READY),
+                "fifo_read(), channel not ready");
+
+#if LSM6DSL_SHARED_I2C
+  i2cAcquireBus(devp->config->i2cp);
+  i2cStart(devp->config->i2cp,
+           devp->config->i2ccfg);
+#endif /* LSM6DSL_SHARED_I2C */
+
+  msg = lsm6dslI2CReadRegister(devp->config->i2cp, devp->config->slaveaddress,
+                               LSM6DSL_AD_FIFO_STATUS1, status, 2);
+  bp->time = osalOsGetSystemTimeX();
+
+  if(msg == MSG_OK) {
+    m = (((size_t)(status[1] & LSMDSL_FIFO_STATUS2_DIFF_FIFO_MASK) << 8) |
+         (size_t)status[0]) / 3U;
+    if(m > n) {
+      m = n;
+    }
+    rp += (n - m) * 3U * 2U;
+
+    if(m > 0U) {
+      msg = lsm6dslI2CReadRegister(devp->config->i2cp,
+                                   devp->config->slaveaddress,
+                                   LSM6DSL_AD_FIFO_DATA_OUT_L, rp,
+                                   m * 3U * 2U);
+    }
+  }
+
+#if LSM6DSL_SHARED_I2C
+  i2cReleaseBus(devp->config->i2cp);
+#endif /* LSM6DSL_SHARED_I2C */
+#endif /* LSM6DSL_USE_I2C */
+
+  if(msg != MSG_OK) {
+    m = 0U;
+  }
+
+  /* Expanding forward, each 32 bits element is written over raw bytes
+     already consumed.*/
+  for(i = 0; i < m * 3U; i++) {
+    tmp = rp[2 * i] + (rp[2 * i + 1] << 8);
+    axes[i] = (int32_t)tmp;
+  }
+
+  if(devp->config->fifosource == LSM6DSL_FIFO_ACC) {
+    odr = (uint8_t)devp->config->accoutdatarate;
+  }
+  else {
+    odr = (uint8_t)devp->config->gyrooutdatarate;
+  }
+  bp->samples = m;
+  bp->period  = odr_periods[odr >> 4];
+  bp->overrun = (status[1] & LSMDSL_FIFO_STATUS2_OVER_RUN) != 0U;
+
+  return msg;
+}
+
 /**
  * @brief   Return the number of axes of the BaseAccelerometer.
  *
@@ -153,6 +253,38 @@ static msg_t acc_read_raw(void *ip, int32_t axes[]) {
   return msg;
 }
 
+/**
+ * @brief   Retrieves a batch of raw samples from the BaseAccelerometer FIFO.
+ * @pre     The FIFO source must be @p LSM6DSL_FIFO_ACC.
+ *
+ * @param[in] ip        pointer to @p BaseAccelerometer interface.
+ * @param[out] axes     a buffer able to hold @p n raw samples.
+ * @param[in] n         maximum number of samples
+ * @param[out] bp       pointer to the batch descriptor
+ *
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred, the errors can
+ *                      be retrieved using @p i2cGetErrors().
+ * @retval MSG_TIMEOUT  if a timeout occurred before operation end.
+ */
+static msg_t acc_read_fifo(void *ip, int32_t axes[], size_t n,
+                           sensor_fifo_batch_t *bp) {
+  LSM6DSLDriver* devp;
+
+  osalDbgCheck((ip != NULL) && (axes != NULL) && (n > 0U) && (bp != NULL));
+
+  /* Getting parent instance pointer.*/
+  devp = objGetInstance(LSM6DSLDriver*, (BaseAccelerometer*)ip);
+
+  osalDbgAssert((devp->state == LSM6DSL_READY),
+                "acc_read_fifo(), invalid state");
+  osalDbgAssert((devp->config->fifosource == LSM6DSL_FIFO_ACC),
+                "acc_read_fifo(), FIFO not enabled");
+
+  return fifo_read(devp, axes, n, bp);
+}
+
 /**
  * @brief   Retrieves cooked data from the BaseAccelerometer.
  * @note    This data is manipulated according to the formula
@@ -485,6 +617,38 @@ static msg_t gyro_read_raw(void *ip, int32_t axes[LSM6DSL_GYRO_NUMBER_OF_AXES])
   return msg;
 }
 
+/**
+ * @brief   Retrieves a batch of raw samples from the BaseGyroscope FIFO.
+ * @pre     The FIFO source must be @p LSM6DSL_FIFO_GYRO.
+ *
+ * @param[in] ip        pointer to @p BaseGyroscope interface.
+ * @param[out] axes     a buffer able to hold @p n raw samples.
+ * @param[in] n         maximum number of samples
+ * @param[out] bp       pointer to the batch descriptor
+ *
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred, the errors can
+ *                      be retrieved using @p i2cGetErrors().
+ * @retval MSG_TIMEOUT  if a timeout occurred before operation end.
+ */
+static msg_t gyro_read_fifo(void *ip, int32_t axes[], size_t n,
+                            sensor_fifo_batch_t *bp) {
+  LSM6DSLDriver* devp;
+
+  osalDbgCheck((ip != NULL) && (axes != NULL) && (n > 0U) && (bp != NULL));
+
+  /* Getting parent instance pointer.*/
+  devp = objGetInstance(LSM6DSLDriver*, (BaseGyroscope*)ip);
+
+  osalDbgAssert((devp->state == LSM6DSL_READY),
+                "gyro_read_fifo(), invalid state");
+  osalDbgAssert((devp->config->fifosource == LSM6DSL_FIFO_GYRO),
+                "gyro_read_fifo(), FIFO not enabled");
+
+  return fifo_read(devp, axes, n, bp);
+}
+
 /**
  * @brief   Retrieves cooked data from the BaseGyroscope.
  * @note    This data is manipulated according to the formula
@@ -808,14 +972,15 @@ static const struct LSM6DSLVMT vmt_device = {
 static const struct BaseAccelerometerVMT vmt_accelerometer = {
   sizeof(struct LSM6DSLVMT*),
   acc_get_axes_number, acc_read_raw, acc_read_cooked,
-  acc_set_bias, acc_reset_bias, acc_set_sensivity, acc_reset_sensivity
+  acc_set_bias, acc_reset_bias, acc_set_sensivity, acc_reset_sensivity,
+  acc_read_fifo
 };
 
 static const struct BaseGyroscopeVMT vmt_gyroscope = {
   sizeof(struct LSM6DSLVMT*) + sizeof(BaseAccelerometer),
   gyro_get_axes_number, gyro_read_raw, gyro_read_cooked,
   gyro_sample_bias, gyro_set_bias, gyro_reset_bias,
-  gyro_set_sensivity, gyro_reset_sensivity
+  gyro_set_sensivity, gyro_reset_sensivity, gyro_read_fifo
 };
 
 /*===========================================================================*/
@@ -853,7 +1018,8 @@ void lsm6dslObjectInit(LSM6DSLDriver *devp) {
 void lsm6dslStart(LSM6DSLDriver *devp, const LSM6DSLConfig *config) {
   uint32_t i;
   uint8_t cr[11];
-  osalDbgCheck((devp != NULL) && (config != NULL));
+  osalDbgCheck((devp != NULL) && (config != NULL) &&
+               ((size_t)config->fifowatermark * 3U < LSM6DSL_FIFO_SIZE));
 
   osalDbgAssert((devp->state == LSM6DSL_STOP) ||
                 (devp->state == LSM6DSL_READY),
@@ -962,6 +1128,62 @@ void lsm6dslStart(LSM6DSLDriver *devp, const LSM6DSLConfig *config) {
   lsm6dslI2CWriteRegister(devp->config->i2cp, devp->config->slaveaddress,
                           cr, 10);
 
+#if LSM6DSL_SHARED_I2C
+  i2cReleaseBus(devp->config->i2cp);
+#endif /* LSM6DSL_SHARED_I2C */
+#endif /* LSM6DSL_USE_I2C */
+
+  /* FIFO control registers configuration block, the threshold is
+     expressed in 16 bits words and the FIFO runs at the ODR of the
+     selected subsystem.*/
+  cr[0] = LSM6DSL_AD_FIFO_CTRL1;
+  {
+    uint32_t fth = (uint32_t)devp->config->fifowatermark * 3U;
+
+    cr[1] = (uint8_t)fth;
+    cr[2] = (uint8_t)(fth >> 8) & LSMDSL_FIFO_CTRL2_FTH_MASK;
+    cr[4] = 0;
+    if(devp->config->fifosource == LSM6DSL_FIFO_ACC) {
+      osalDbgAssert((devp->config->accoutdatarate != LSM6DSL_ACC_ODR_PD) &&
+                    (devp->config->accoutdatarate != LSM6DSL_ACC_ODR_1P6Hz),
+                    "lsm6dslStart(), invalid FIFO data rate");
+      cr[3] = LSMDSL_FIFO_CTRL3_DEC_FIFO_XL0;
+      cr[5] = (devp->config->accoutdatarate >> 1) |
+              LSMDSL_FIFO_CTRL5_FIFO_MODE_CONT;
+    }
+    else if(devp->config->fifosource == LSM6DSL_FIFO_GYRO) {
+      osalDbgAssert((devp->config->gyrooutdatarate != LSM6DSL_GYRO_ODR_PD),
+                    "lsm6dslStart(), invalid FIFO data rate");
+      cr[3] = LSMDSL_FIFO_CTRL3_DEC_FIFO_G0;
+      cr[5] = (devp->config->gyrooutdatarate >> 1) |
+              LSMDSL_FIFO_CTRL5_FIFO_MODE_CONT;
+    }
+    else {
+      cr[3] = 0;
+      cr[5] = LSMDSL_FIFO_CTRL5_FIFO_MODE_BYPASS;
+    }
+  }
+  /* Interrupt 1 control register configuration block.*/
+  cr[6] = LSM6DSL_AD_INT1_CTRL;
+  {
+    cr[7] = 0;
+    if((devp->config->fifosource != LSM6DSL_FIFO_DISABLED) &&
+       (devp->config->fifowatermark > 0U)) {
+      cr[7] |= LSMDSL_INT1_CTRL_FTH;
+    }
+  }
+
+#if LSM6DSL_USE_I2C
+#if LSM6DSL_SHARED_I2C
+  i2cAcquireBus(devp->config->i2cp);
+  i2cStart(devp->config->i2cp, devp->config->i2ccfg);
+#endif /* LSM6DSL_SHARED_I2C */
+
+  lsm6dslI2CWriteRegister(devp->config->i2cp, devp->config->slaveaddress,
+                          &cr[0], 5);
+  lsm6dslI2CWriteRegister(devp->config->i2cp, devp->config->slaveaddress,
+                          &cr[6], 1);
+
 #if LSM6DSL_SHARED_I2C
   i2cReleaseBus(devp->config->i2cp);
 #endif /* LSM6DSL_SHARED_I2C */
@@ -352,6 +352,59 @@
 #define LSMDSL_CTRL10_C_WRIST_TILT          (1 << 7)
 /** @} */
 
+/**
+ * @name    LSM6DSL_AD_FIFO_CTRL2 register bits definitions
+ * @{
+ */
+#define LSMDSL_FIFO_CTRL2_FTH_MASK          0x07
+/** @} */
+
+/**
+ * @name    LSM6DSL_AD_FIFO_CTRL3 register bits definitions
+ * @{
+ */
+#define LSMDSL_FIFO_CTRL3_DEC_FIFO_XL0      (1 << 0)
+#define LSMDSL_FIFO_CTRL3_DEC_FIFO_G0       (1 << 3)
+/** @} */
+
+/**
+ * @name    LSM6DSL_AD_FIFO_CTRL5 register bits definitions
+ * @{
+ */
+#define LSMDSL_FIFO_CTRL5_FIFO_MODE_MASK    0x07
+#define LSMDSL_FIFO_CTRL5_FIFO_MODE_BYPASS  0x00
+#define LSMDSL_FIFO_CTRL5_FIFO_MODE_CONT    0x06
+#define LSMDSL_FIFO_CTRL5_ODR_FIFO_MASK     0x78
+/** @} */
+
+/**
+ * @name    LSM6DSL_AD_INT1_CTRL register bits definitions
+ * @{
+ */
+#define LSMDSL_INT1_CTRL_DRDY_XL            (1 << 0)
+#define LSMDSL_INT1_CTRL_DRDY_G             (1 << 1)
+#define LSMDSL_INT1_CTRL_BOOT               (1 << 2)
+#define LSMDSL_INT1_CTRL_FTH                (1 << 3)
+#define LSMDSL_INT1_CTRL_FIFO_OVR           (1 << 4)
+#define LSMDSL_INT1_CTRL_FULL_FLAG          (1 << 5)
+/** @} */
+
+/**
+ * @name    LSM6DSL_AD_FIFO_STATUS2 register bits definitions
+ * @{
+ */
+#define LSMDSL_FIFO_STATUS2_DIFF_FIFO_MASK  0x07
+#define LSMDSL_FIFO_STATUS2_FIFO_EMPTY      (1 << 4)
+#define LSMDSL_FIFO_STATUS2_FULL_SMART      (1 << 5)
+#define LSMDSL_FIFO_STATUS2_OVER_RUN        (1 << 6)
+#define LSMDSL_FIFO_STATUS2_WATERM          (1 << 7)
+/** @} */
+
+/**
+ * @brief   LSM6DSL FIFO depth in 16 bits words.
+ */
+#define LSM6DSL_FIFO_SIZE                   2048U
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -596,6 +649,17 @@ typedef enum {
   LSM6DSL_END_BIG = 0x20            /**< Big endian.                        */
 } lsm6dsl_end_t;
 
+/**
+ * @brief LSM6DSL FIFO data source.
+ * @note  The FIFO stores a single data set, samples of the selected
+ *        subsystem are stored at its own output data rate.
+ */
+typedef enum {
+  LSM6DSL_FIFO_DISABLED = 0,        /**< FIFO in bypass mode.               */
+  LSM6DSL_FIFO_ACC = 1,             /**< Accelerometer samples.             */
+  LSM6DSL_FIFO_GYRO = 2             /**< Gyroscope samples.                 */
+} lsm6dsl_fifo_t;
+
 /**
  * @brief   Driver state machine possible states.
  */
@@ -693,6 +757,18 @@ typedef struct {
    */
   lsm6dsl_end_t             endianness;
 #endif /* LSM6DSL_USE_ADVANCED */
+  /**
+   * @brief LSM6DSL FIFO data source.
+   * @details If enabled the FIFO runs in continuous mode and it is read
+   *          using the @p read_fifo method of the selected interface.
+   */
+  lsm6dsl_fifo_t            fifosource;
+  /**
+   * @brief LSM6DSL FIFO watermark in samples.
+   * @details The INT1 pin is asserted while the FIFO level is equal or
+   *          greater than the watermark, zero disables the interrupt.
+   */
+  uint16_t                  fifowatermark;
 } LSM6DSLConfig;
 
 /**
@@ -883,6 +959,43 @@ struct LSM6DSLDriver {
 #define lsm6dslAccelerometerResetSensitivity(devp)                          \
         accelerometerResetSensitivity(&((devp)->acc_if))
 
+/**
+ * @brief   Reads a batch of raw samples from the LSM6DSL FIFO.
+ * @note    The FIFO source must be @p LSM6DSL_FIFO_ACC.
+ *
+ * @param[in] devp      pointer to @p LSM6DSLDriver.
+ * @param[out] axes     a buffer able to hold @p n raw samples.
+ * @param[in] n         maximum number of samples
+ * @param[out] bp       pointer to the batch descriptor
+ *
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred, the errors can
+ *                      be retrieved using @p i2cGetErrors().
+ * @retval MSG_TIMEOUT  if a timeout occurred before operation end.
+ *
+ * @api
+ */
+#define lsm6dslAccelerometerReadFIFO(devp, axes, n, bp)                     \
+        accelerometerReadFIFO(&((devp)->acc_if), axes, n, bp)
+
+/**
+ * @brief   Converts a batch of raw accelerometer samples to cooked data.
+ * @details The current sensitivities and biases are applied, the result
+ *          is the same of @p lsm6dslAccelerometerReadCooked() for each sample.
+ *
+ * @param[in] devp      pointer to @p LSM6DSLDriver.
+ * @param[in] raw       raw samples as returned by
+ *                      @p lsm6dslAccelerometerReadFIFO().
+ * @param[out] cooked   a buffer able to hold @p n cooked samples.
+ * @param[in] n         number of samples
+ *
+ * @api
+ */
+#define lsm6dslAccelerometerCookFIFO(devp, raw, cooked, n)                  \
+        sensorCookBlock(raw, cooked, n, LSM6DSL_ACC_NUMBER_OF_AXES,         \
+                        (devp)->accsensitivity, (devp)->accbias)
+
 /**
  * @brief   Changes the LSM6DSLDriver accelerometer fullscale value.
  * @note    This function also rescale sensitivities and biases based on
@@ -1040,6 +1153,43 @@ struct LSM6DSLDriver {
 #define lsm6dslGyroscopeResetSensitivity(devp)                              \
         gyroscopeResetSensitivity(&((devp)->gyro_if))
 
+/**
+ * @brief   Reads a batch of raw samples from the LSM6DSL FIFO.
+ * @note    The FIFO source must be @p LSM6DSL_FIFO_GYRO.
+ *
+ * @param[in] devp      pointer to @p LSM6DSLDriver.
+ * @param[out] axes     a buffer able to hold @p n raw samples.
+ * @param[in] n         maximum number of samples
+ * @param[out] bp       pointer to the batch descriptor
+ *
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred, the errors can
+ *                      be retrieved using @p i2cGetErrors().
+ * @retval MSG_TIMEOUT  if a timeout occurred before operation end.
+ *
+ * @api
+ */
+#define lsm6dslGyroscopeReadFIFO(devp, axes, n, bp)                         \
+        gyroscopeReadFIFO(&((devp)->gyro_if), axes, n, bp)
+
+/**
+ * @brief   Converts a batch of raw gyroscope samples to cooked data.
+ * @details The current sensitivities and biases are applied, the result
+ *          is the same of @p lsm6dslGyroscopeReadCooked() for each sample.
+ *
+ * @param[in] devp      pointer to @p LSM6DSLDriver.
+ * @param[in] raw       raw samples as returned by
+ *                      @p lsm6dslGyroscopeReadFIFO().
+ * @param[out] cooked   a buffer able to hold @p n cooked samples.
+ * @param[in] n         number of samples
+ *
+ * @api
+ */
+#define lsm6dslGyroscopeCookFIFO(devp, raw, cooked, n)                      \
+        sensorCookBlock(raw, cooked, n, LSM6DSL_GYRO_NUMBER_OF_AXES,        \
+                        (devp)->gyrosensitivity, (devp)->gyrobias)
+
 /**
  * @brief   Changes the LSM6DSLDriver gyroscope fullscale value.
  * @note    This function also rescale sensitivities and biases based on
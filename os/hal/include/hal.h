@@ -50,6 +50,10 @@
 #define HAL_USE_DAC                         FALSE
 #endif
 
+#if !defined(HAL_USE_EFL)
+#define HAL_USE_EFL                         FALSE
+#endif
+
 #if !defined(HAL_USE_EXT)
 #define HAL_USE_ETX                         FALSE
 #endif
@@ -74,6 +78,10 @@
 #define HAL_USE_MAC                         FALSE
 #endif
 
+#if !defined(HAL_USE_PM)
+#define HAL_USE_PM                          FALSE
+#endif
+
 #if !defined(HAL_USE_PWM)
 #define HAL_USE_PWM                         FALSE
 #endif
@@ -110,6 +118,10 @@
 #define HAL_USE_USB                         FALSE
 #endif
 
+#if !defined(HAL_USE_USBH)
+#define HAL_USE_USBH                        FALSE
+#endif
+
 #if !defined(HAL_USE_WDG)
 #define HAL_USE_WDG                         FALSE
 #endif
@@ -140,6 +152,7 @@
 #include "hal_can.h"
 #include "hal_crypto.h"
 #include "hal_dac.h"
+#include "hal_efl.h"
 #include "hal_ext.h"
 #include "hal_gpt.h"
 #include "hal_i2c.h"
@@ -155,6 +168,7 @@
 #include "hal_trng.h"
 #include "hal_uart.h"
 #include "hal_usb.h"
+#include "hal_usbh.h"
 #include "hal_wdg.h"
 #include "hal_wspi.h"
 
@@ -166,6 +180,9 @@
 #include "hal_st.h"
 #endif
 
+/* Power management.*/
+#include "hal_pm.h"
+
 /* Complex drivers.*/
 #include "hal_mmc_spi.h"
 #include "hal_serial_usb.h"
@@ -54,6 +54,14 @@
 #if !defined(ADC_USE_MUTUAL_EXCLUSION) || defined(__DOXYGEN__)
 #define ADC_USE_MUTUAL_EXCLUSION    TRUE
 #endif
+
+/**
+ * @brief   Enables the streaming to buffers queue APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(ADC_USE_STREAMING) || defined(__DOXYGEN__)
+#define ADC_USE_STREAMING           FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -78,10 +86,39 @@ typedef enum {
 
 #include "hal_adc_lld.h"
 
+/* Some more checks, must happen after inclusion of the LLD header, this is
+   why are placed here.*/
+#if !defined(ADC_SUPPORTS_STREAMING)
+#define ADC_SUPPORTS_STREAMING      FALSE
+#endif
+
+#if (ADC_USE_STREAMING == TRUE) && (ADC_SUPPORTS_STREAMING == FALSE)
+#error "ADC streaming not supported by the low level driver"
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+#if (ADC_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Returns the number of half buffers lost while streaming.
+ * @details The counter is incremented when no empty buffer is available
+ *          in the queue at the end of an half buffer conversion.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ * @return              The number of lost half buffers.
+ *
+ * @xclass
+ */
+#define adcStreamGetOverrunsX(adcp) ((adcp)->overruns)
+/** @} */
+#endif
+
 /**
  * @name    Low level driver helper macros
  * @{
@@ -140,9 +177,65 @@ typedef enum {
 #define _adc_timeout_isr(adcp)
 #endif /* !ADC_USE_WAIT */
 
+#if (HAL_USE_PM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Forbids the deep sleep depths while a conversion is ongoing.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ *
+ * @notapi
+ */
+#define _adc_pm_lock(adcp) pmLockDepthI(PM_DEPTH_SLEEP)
+
+/**
+ * @brief   Releases the lock taken by @p _adc_pm_lock().
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ *
+ * @notapi
+ */
+#define _adc_pm_unlock_i(adcp) pmUnlockDepthI(PM_DEPTH_SLEEP)
+
+/**
+ * @brief   Releases the lock taken by @p _adc_pm_lock() from ISR context.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ *
+ * @notapi
+ */
+#define _adc_pm_unlock_isr(adcp) {                                          \
+  osalSysLockFromISR();                                                     \
+  pmUnlockDepthI(PM_DEPTH_SLEEP);                                           \
+  osalSysUnlockFromISR();                                                   \
+}
+#else /* HAL_USE_PM != TRUE */
+#define _adc_pm_lock(adcp)
+#define _adc_pm_unlock_i(adcp)
+#define _adc_pm_unlock_isr(adcp)
+#endif /* HAL_USE_PM != TRUE */
+
+#if (ADC_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Posts half of the samples buffer in the streaming queue.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ * @param[in] buf       pointer to the completed half buffer
+ *
+ * @notapi
+ */
+#define _adc_isr_stream_code(adcp, buf) {                                   \
+  if ((adcp)->ibqp != NULL) {                                               \
+    _adc_stream_post(adcp, buf);                                            \
+  }                                                                         \
+}
+#else /* !ADC_USE_STREAMING */
+#define _adc_isr_stream_code(adcp, buf)
+#endif /* !ADC_USE_STREAMING */
+
 /**
  * @brief   Common ISR code, half buffer event.
  * @details This code handles the portable part of the ISR code:
+ *          - Streaming queue handling, if enabled.
  *          - Callback invocation.
  *          .
  * @note    This macro is meant to be used in the low level drivers
@@ -153,6 +246,7 @@ typedef enum {
  * @notapi
  */
 #define _adc_isr_half_code(adcp) {                                          \
+  _adc_isr_stream_code(adcp, (adcp)->samples);                              \
   if ((adcp)->grpp->end_cb != NULL) {                                       \
     (adcp)->grpp->end_cb(adcp, (adcp)->samples, (adcp)->depth / 2);         \
   }                                                                         \
@@ -161,6 +255,7 @@ typedef enum {
 /**
  * @brief   Common ISR code, full buffer event.
  * @details This code handles the portable part of the ISR code:
+ *          - Streaming queue handling, if enabled.
  *          - Callback invocation.
  *          - Waiting thread wakeup, if any.
  *          - Driver state transitions.
@@ -174,6 +269,9 @@ typedef enum {
  */
 #define _adc_isr_full_code(adcp) {                                          \
   if ((adcp)->grpp->circular) {                                             \
+    /* Streaming of the 2nd half of the buffer.*/                           \
+    _adc_isr_stream_code(adcp, (adcp)->samples +                            \
+                         ((adcp)->depth / 2) * (adcp)->grpp->num_channels); \
     /* Callback handling.*/                                                 \
     if ((adcp)->grpp->end_cb != NULL) {                                     \
       if ((adcp)->depth > 1) {                                              \
@@ -191,6 +289,7 @@ typedef enum {
   else {                                                                    \
     /* End conversion.*/                                                    \
     adc_lld_stop_conversion(adcp);                                          \
+    _adc_pm_unlock_isr(adcp);                                               \
     if ((adcp)->grpp->end_cb != NULL) {                                     \
       (adcp)->state = ADC_COMPLETE;                                         \
       /* Invoke the callback passing the whole buffer.*/                    \
@@ -225,6 +324,7 @@ typedef enum {
  */
 #define _adc_isr_error_code(adcp, err) {                                    \
   adc_lld_stop_conversion(adcp);                                            \
+  _adc_pm_unlock_isr(adcp);                                                 \
   if ((adcp)->grpp->error_cb != NULL) {                                     \
     (adcp)->state = ADC_ERROR;                                              \
     (adcp)->grpp->error_cb(adcp, err);                                      \
@@ -271,6 +371,19 @@ extern "C" {
   void adcAcquireBus(ADCDriver *adcp);
   void adcReleaseBus(ADCDriver *adcp);
 #endif
+#if ADC_USE_STREAMING == TRUE
+  void adcStartStreamI(ADCDriver *adcp,
+                       const ADCConversionGroup *grpp,
+                       adcsample_t *samples,
+                       size_t depth,
+                       input_buffers_queue_t *ibqp);
+  void adcStartStream(ADCDriver *adcp,
+                      const ADCConversionGroup *grpp,
+                      adcsample_t *samples,
+                      size_t depth,
+                      input_buffers_queue_t *ibqp);
+  void _adc_stream_post(ADCDriver *adcp, const adcsample_t *buf);
+#endif
 #ifdef __cplusplus
 }
 #endif
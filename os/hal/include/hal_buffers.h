@@ -125,6 +125,22 @@ typedef io_buffers_queue_t input_buffers_queue_t;
  */
 typedef io_buffers_queue_t output_buffers_queue_t;
 
+/**
+ * @brief   Type of a buffer segment descriptor.
+ * @details Describes the data area of one buffer of a queue, an array of
+ *          segments gives a scatter-gather view of several buffers.
+ */
+typedef struct {
+  /**
+   * @brief   Pointer to the segment data.
+   */
+  uint8_t               *buf;
+  /**
+   * @brief   Size of the segment data.
+   */
+  size_t                size;
+} bqsegment_t;
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -292,6 +308,7 @@ extern "C" {
                      size_t size, size_t n, bqnotify_t infy, void *link);
   void ibqResetI(input_buffers_queue_t *ibqp);
   uint8_t *ibqGetEmptyBufferI(input_buffers_queue_t *ibqp);
+  uint8_t *ibqGetNextEmptyBufferI(input_buffers_queue_t *ibqp);
   void ibqPostFullBufferI(input_buffers_queue_t *ibqp, size_t size);
   msg_t ibqGetFullBufferTimeout(input_buffers_queue_t *ibqp,
                                 sysinterval_t timeout);
@@ -299,6 +316,14 @@ extern "C" {
                                  sysinterval_t timeout);
   void ibqReleaseEmptyBuffer(input_buffers_queue_t *ibqp);
   void ibqReleaseEmptyBufferS(input_buffers_queue_t *ibqp);
+  size_t ibqGetFullBuffersTimeout(input_buffers_queue_t *ibqp,
+                                  bqsegment_t *sgp, size_t n,
+                                  sysinterval_t timeout);
+  size_t ibqGetFullBuffersTimeoutS(input_buffers_queue_t *ibqp,
+                                   bqsegment_t *sgp, size_t n,
+                                   sysinterval_t timeout);
+  void ibqReleaseEmptyBuffers(input_buffers_queue_t *ibqp, size_t n);
+  void ibqReleaseEmptyBuffersS(input_buffers_queue_t *ibqp, size_t n);
   msg_t ibqGetTimeout(input_buffers_queue_t *ibqp, sysinterval_t timeout);
   size_t ibqReadTimeout(input_buffers_queue_t *ibqp, uint8_t *bp,
                         size_t n, sysinterval_t timeout);
@@ -307,6 +332,8 @@ extern "C" {
   void obqResetI(output_buffers_queue_t *obqp);
   uint8_t *obqGetFullBufferI(output_buffers_queue_t *obqp,
                              size_t *sizep);
+  uint8_t *obqGetNextFullBufferI(output_buffers_queue_t *obqp,
+                                 size_t *sizep);
   void obqReleaseEmptyBufferI(output_buffers_queue_t *obqp);
   msg_t obqGetEmptyBufferTimeout(output_buffers_queue_t *obqp,
                                  sysinterval_t timeout);
@@ -314,6 +341,16 @@ extern "C" {
                                   sysinterval_t timeout);
   void obqPostFullBuffer(output_buffers_queue_t *obqp, size_t size);
   void obqPostFullBufferS(output_buffers_queue_t *obqp, size_t size);
+  size_t obqGetEmptyBuffersTimeout(output_buffers_queue_t *obqp,
+                                   bqsegment_t *sgp, size_t n,
+                                   sysinterval_t timeout);
+  size_t obqGetEmptyBuffersTimeoutS(output_buffers_queue_t *obqp,
+                                    bqsegment_t *sgp, size_t n,
+                                    sysinterval_t timeout);
+  void obqPostFullBuffers(output_buffers_queue_t *obqp,
+                          const bqsegment_t *sgp, size_t n);
+  void obqPostFullBuffersS(output_buffers_queue_t *obqp,
+                           const bqsegment_t *sgp, size_t n);
   msg_t obqPutTimeout(output_buffers_queue_t *obqp, uint8_t b,
                       sysinterval_t timeout);
   size_t obqWriteTimeout(output_buffers_queue_t *obqp, const uint8_t *bp,
@@ -107,8 +107,51 @@ typedef enum {
   CAN_SLEEP = 4                             /**< Sleep state.               */
 } canstate_t;
 
+/**
+ * @brief   Type of a CAN identifier filter.
+ */
+typedef struct CANIdFilter CANIdFilter;
+
 #include "hal_can_lld.h"
 
+/* Some more checks, must happen after inclusion of the LLD header, this is
+   why are placed here.*/
+#if !defined(CAN_SUPPORTS_ID_FILTERS)
+#define CAN_SUPPORTS_ID_FILTERS     FALSE
+#endif
+
+#if !defined(CAN_SUPPORTS_FD)
+#define CAN_SUPPORTS_FD             FALSE
+#endif
+
+#if (CAN_SUPPORTS_ID_FILTERS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Structure representing a CAN identifier filter.
+ * @details A received frame is accepted if the identifier bits selected by
+ *          @p mask match the corresponding bits of @p id and the identifier
+ *          type matches @p ide.
+ */
+struct CANIdFilter {
+  /**
+   * @brief   Identifier, 11 or 29 bits depending on @p ide.
+   */
+  uint32_t                  id;
+  /**
+   * @brief   Identifier bits to be compared, a zero mask accepts any frame
+   *          of the specified type.
+   */
+  uint32_t                  mask;
+  /**
+   * @brief   Identifier type, @p CAN_IDE_STD or @p CAN_IDE_EXT.
+   */
+  uint8_t                   ide;
+  /**
+   * @brief   Receive mailbox for the accepted frames.
+   */
+  canmbx_t                  mailbox;
+};
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -122,6 +165,21 @@ typedef enum {
  */
 #define CAN_MAILBOX_TO_MASK(mbx) (1U << ((mbx) - 1U))
 
+/**
+ * @brief   Converts a CAN FD data length code to a payload size in bytes.
+ */
+#define CAN_FD_DLC_TO_SIZE(dlc)                                             \
+  ((dlc) <= 8U ? (dlc) : ((dlc) <= 12U ? ((dlc) - 6U) * 4U :               \
+                                         ((dlc) - 11U) * 16U))
+
+/**
+ * @brief   Converts a payload size in bytes to a CAN FD data length code.
+ * @note    Sizes not matching a CAN FD payload size are rounded up.
+ */
+#define CAN_FD_SIZE_TO_DLC(n)                                               \
+  ((n) <= 8U ? (n) : ((n) <= 24U ? (((n) + 3U) / 4U) + 6U :                 \
+                                   (((n) + 15U) / 16U) + 11U))
+
 /**
  * @brief   Legacy name for @p canTransmitTimeout().
  *
@@ -239,6 +297,14 @@ extern "C" {
                           canmbx_t mailbox,
                           CANRxFrame *crfp,
                           sysinterval_t timeout);
+  size_t canReceiveBatchTimeout(CANDriver *canp,
+                                canmbx_t mailbox,
+                                CANRxFrame *crfp,
+                                size_t n,
+                                sysinterval_t timeout);
+#if CAN_SUPPORTS_ID_FILTERS == TRUE
+  void canSetIdFilters(CANDriver *canp, const CANIdFilter *fp, size_t n);
+#endif
 #if CAN_USE_SLEEP_MODE
   void canSleep(CANDriver *canp);
   void canWakeup(CANDriver *canp);
@@ -54,6 +54,17 @@
 #define HAL_CRY_ENFORCE_FALLBACK            FALSE
 #endif
 
+/**
+ * @brief   Size of the chunks processed by the combined AES-CTR and SHA256
+ *          streaming operation.
+ * @details Each chunk is first processed by one algorithm and then by the
+ *          other while the data is still in cache.
+ * @note    It must be a multiple of 64.
+ */
+#if !defined(HAL_CRY_PIPELINE_CHUNK_SIZE) || defined(__DOXYGEN__)
+#define HAL_CRY_PIPELINE_CHUNK_SIZE         512
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -63,6 +74,11 @@
 #define HAL_CRY_USE_FALLBACK                TRUE
 #endif
 
+#if (HAL_CRY_PIPELINE_CHUNK_SIZE <= 0) ||                                   \
+    ((HAL_CRY_PIPELINE_CHUNK_SIZE % 64) != 0)
+#error "invalid HAL_CRY_PIPELINE_CHUNK_SIZE value"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -206,6 +222,30 @@ typedef struct {
 } HMACSHA512Context;
 #endif
 
+/**
+ * @brief   Type of an AES-CTR streaming context.
+ * @details The context allows to process a message in chunks of any size,
+ *          whole blocks are processed by the driver in a single operation.
+ */
+typedef struct {
+  /**
+   * @brief   Key used by the stream.
+   */
+  crykey_t                  key_id;
+  /**
+   * @brief   Counter block of the next keystream block.
+   */
+  uint8_t                   iv[16];
+  /**
+   * @brief   Keystream of the current partial block.
+   */
+  uint8_t                   stream[16];
+  /**
+   * @brief   Number of bytes of @p stream already used.
+   */
+  size_t                    used;
+} AESCTRContext;
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -348,6 +388,23 @@ extern "C" {
                              size_t size, const uint8_t *in);
   cryerror_t crySHA512Final(CRYDriver *cryp, SHA512Context *sha512ctxp,
                             uint8_t *out);
+  cryerror_t cryAESCTRInit(CRYDriver *cryp,
+                           AESCTRContext *ctrctxp,
+                           crykey_t key_id,
+                           const uint8_t *iv);
+  cryerror_t cryAESCTRUpdate(CRYDriver *cryp,
+                             AESCTRContext *ctrctxp,
+                             size_t size,
+                             const uint8_t *in,
+                             uint8_t *out);
+  cryerror_t cryAESCTRFinal(CRYDriver *cryp, AESCTRContext *ctrctxp);
+  cryerror_t cryAESCTRSHA256Update(CRYDriver *cryp,
+                                   AESCTRContext *ctrctxp,
+                                   SHA256Context *sha256ctxp,
+                                   bool encrypt,
+                                   size_t size,
+                                   const uint8_t *in,
+                                   uint8_t *out);
   cryerror_t cryHMACSHA256Init(CRYDriver *cryp,
                                HMACSHA256Context *hmacsha256ctxp);
   cryerror_t cryHMACSHA256Update(CRYDriver *cryp,
@@ -54,6 +54,14 @@
 #if !defined(DAC_USE_MUTUAL_EXCLUSION) || defined(__DOXYGEN__)
 #define DAC_USE_MUTUAL_EXCLUSION    TRUE
 #endif
+
+/**
+ * @brief   Enables the streaming from buffers queue APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(DAC_USE_STREAMING) || defined(__DOXYGEN__)
+#define DAC_USE_STREAMING           FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -78,10 +86,39 @@ typedef enum {
 
 #include "hal_dac_lld.h"
 
+/* Some more checks, must happen after inclusion of the LLD header, this is
+   why are placed here.*/
+#if !defined(DAC_SUPPORTS_STREAMING)
+#define DAC_SUPPORTS_STREAMING      FALSE
+#endif
+
+#if (DAC_USE_STREAMING == TRUE) && (DAC_SUPPORTS_STREAMING == FALSE)
+#error "DAC streaming not supported by the low level driver"
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+#if (DAC_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Returns the number of half buffers not refilled while streaming.
+ * @details The counter is incremented when no full buffer is available
+ *          in the queue when an half buffer has to be refilled.
+ *
+ * @param[in] dacp      pointer to the @p DACDriver object
+ * @return              The number of underruns.
+ *
+ * @xclass
+ */
+#define dacStreamGetUnderrunsX(dacp) ((dacp)->underruns)
+/** @} */
+#endif
+
 /**
  * @name    Low level driver helper macros
  * @{
@@ -153,9 +190,28 @@ typedef enum {
 #define _dac_timeout_isr(dacp)
 #endif /* !DAC_USE_WAIT */
 
+#if (DAC_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Refills half of the samples buffer from the streaming queue.
+ *
+ * @param[in] dacp      pointer to the @p DACDriver object
+ * @param[in] buf       pointer to the half buffer to be refilled
+ *
+ * @notapi
+ */
+#define _dac_isr_stream_code(dacp, buf) {                                   \
+  if ((dacp)->obqp != NULL) {                                               \
+    _dac_stream_fetch(dacp, buf);                                           \
+  }                                                                         \
+}
+#else /* !DAC_USE_STREAMING */
+#define _dac_isr_stream_code(dacp, buf)
+#endif /* !DAC_USE_STREAMING */
+
 /**
  * @brief   Common ISR code, half buffer event.
  * @details This code handles the portable part of the ISR code:
+ *          - Streaming queue handling, if enabled.
  *          - Callback invocation.
  *          .
  * @note    This macro is meant to be used in the low level drivers
@@ -166,6 +222,7 @@ typedef enum {
  * @notapi
  */
 #define _dac_isr_half_code(dacp) {                                          \
+  _dac_isr_stream_code(dacp, (dacp)->samples);                              \
   if ((dacp)->grpp->end_cb != NULL) {                                       \
     (dacp)->grpp->end_cb(dacp, (dacp)->samples, (dacp)->depth / 2);         \
   }                                                                         \
@@ -174,6 +231,7 @@ typedef enum {
 /**
  * @brief   Common ISR code, full buffer event.
  * @details This code handles the portable part of the ISR code:
+ *          - Streaming queue handling, if enabled.
  *          - Callback invocation.
  *          - Waiting thread wakeup, if any.
  *          - Driver state transitions.
@@ -186,6 +244,8 @@ typedef enum {
  * @notapi
  */
 #define _dac_isr_full_code(dacp) {                                          \
+  _dac_isr_stream_code(dacp, (dacp)->samples +                              \
+                       ((dacp)->depth / 2) * (dacp)->grpp->num_channels);   \
   if ((dacp)->grpp->end_cb != NULL) {                                       \
     if ((dacp)->depth > 1) {                                                \
       /* Invokes the callback passing the 2nd half of the buffer.*/         \
@@ -256,6 +316,15 @@ extern "C" {
   void dacAcquireBus(DACDriver *dacp);
   void dacReleaseBus(DACDriver *dacp);
 #endif
+#if DAC_USE_STREAMING == TRUE
+  void dacStartStreamI(DACDriver *dacp, const DACConversionGroup *grpp,
+                       dacsample_t *samples, size_t depth,
+                       output_buffers_queue_t *obqp);
+  void dacStartStream(DACDriver *dacp, const DACConversionGroup *grpp,
+                      dacsample_t *samples, size_t depth,
+                      output_buffers_queue_t *obqp);
+  void _dac_stream_fetch(DACDriver *dacp, dacsample_t *buf);
+#endif
 #ifdef __cplusplus
 }
 #endif
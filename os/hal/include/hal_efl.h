@@ -0,0 +1,100 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_efl.h
+ * @brief   Embedded Flash Driver macros and structures.
+ * @details The driver implements the @p BaseFlash interface on the
+ *          microcontroller internal flash, it can be used as the storage
+ *          of the MFS module.
+ * @note    The @p hal_flash.c helpers are not part of the HAL sources,
+ *          applications using @p flashWaitErase() must add
+ *          @p os/hal/lib/peripherals/flash/hal_flash.c to the build unless
+ *          already brought in by a serial NOR device makefile.
+ *
+ * @addtogroup EFL
+ * @{
+ */
+
+#ifndef HAL_EFL_H
+#define HAL_EFL_H
+
+#if (HAL_USE_EFL == TRUE) || defined(__DOXYGEN__)
+
+#include "hal_flash.h"
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a structure representing an embedded flash driver.
+ */
+typedef struct EFlashDriver EFlashDriver;
+
+/**
+ * @brief   @p EFlashDriver specific methods.
+ */
+#define _efl_driver_methods                                                 \
+  _base_flash_methods
+
+/**
+ * @extends BaseFlashVMT
+ *
+ * @brief   @p EFlashDriver virtual methods table.
+ */
+struct EFlashDriverVMT {
+  _efl_driver_methods
+};
+
+#include "hal_efl_lld.h"
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void eflInit(void);
+  void eflObjectInit(EFlashDriver *eflp);
+  void eflStart(EFlashDriver *eflp, const EFlashConfig *config);
+  void eflStop(EFlashDriver *eflp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_EFL == TRUE */
+
+#endif /* HAL_EFL_H */
+
+/** @} */
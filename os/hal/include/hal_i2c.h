@@ -62,6 +62,14 @@
 #define I2C_USE_MUTUAL_EXCLUSION    TRUE
 #endif
 
+/**
+ * @brief   Enables the asynchronous transactions APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(I2C_USE_TRANSACTIONS) || defined(__DOXYGEN__)
+#define I2C_USE_TRANSACTIONS        FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -82,37 +90,129 @@ typedef enum {
   I2C_LOCKED = 5                            /**> Bus or driver locked.      */
 } i2cstate_t;
 
+#if (I2C_USE_TRANSACTIONS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of an I2C transaction descriptor.
+ */
+typedef struct I2CTransaction I2CTransaction;
+#endif
+
 #include "hal_i2c_lld.h"
 
+/* Some more checks, must happen after inclusion of the LLD header, this is
+   why are placed here.*/
+#if !defined(I2C_SUPPORTS_TRANSACTIONS)
+#define I2C_SUPPORTS_TRANSACTIONS   FALSE
+#endif
+
+#if (I2C_USE_TRANSACTIONS == TRUE) && (I2C_SUPPORTS_TRANSACTIONS == FALSE)
+#error "I2C transactions not supported by the low level driver"
+#endif
+
+#if (I2C_USE_TRANSACTIONS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   I2C notification callback type.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ */
+typedef void (*i2ccallback_t)(I2CDriver *i2cp);
+
+/**
+ * @brief   Structure representing an I2C transaction.
+ * @details A transaction is a write phase followed by an optional read
+ *          phase on the same slave, or a read phase only if @p txbytes
+ *          is zero. Each transaction is terminated by a STOP condition.
+ */
+struct I2CTransaction {
+  /**
+   * @brief   Slave device address (7 bits) without R/W bit.
+   */
+  i2caddr_t                 addr;
+  /**
+   * @brief   Transmit buffer.
+   */
+  const uint8_t             *txbuf;
+  /**
+   * @brief   Number of bytes to be transmitted, zero for a read only
+   *          transaction.
+   */
+  size_t                    txbytes;
+  /**
+   * @brief   Receive buffer.
+   */
+  uint8_t                   *rxbuf;
+  /**
+   * @brief   Number of bytes to be received, zero for a write only
+   *          transaction.
+   */
+  size_t                    rxbytes;
+  /**
+   * @brief   Transaction end callback or @p NULL.
+   * @note    It is invoked from ISR context also when the transaction
+   *          failed, errors can be retrieved using @p i2cGetErrors().
+   */
+  i2ccallback_t             end_cb;
+};
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
 /**
- * @brief   Wakes up the waiting thread notifying no errors.
+ * @brief   Wakes up the waiting thread.
  *
  * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] msg       wakeup message
  *
  * @notapi
  */
-#define _i2c_wakeup_isr(i2cp) do {                                          \
+#define _i2c_wakeup_msg_isr(i2cp, msg) do {                                 \
   osalSysLockFromISR();                                                     \
-  osalThreadResumeI(&(i2cp)->thread, MSG_OK);                               \
+  osalThreadResumeI(&(i2cp)->thread, msg);                                  \
   osalSysUnlockFromISR();                                                   \
 } while(0)
 
 /**
- * @brief   Wakes up the waiting thread notifying errors.
+ * @brief   Ends the current operation.
+ * @details If a transactions sequence is running then the next transaction
+ *          is started, else the waiting thread is woken up.
  *
  * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] msg       wakeup message
  *
  * @notapi
  */
-#define _i2c_wakeup_error_isr(i2cp) do {                                    \
-  osalSysLockFromISR();                                                     \
-  osalThreadResumeI(&(i2cp)->thread, MSG_RESET);                            \
-  osalSysUnlockFromISR();                                                   \
+#if (I2C_USE_TRANSACTIONS == TRUE) || defined(__DOXYGEN__)
+#define _i2c_end_isr(i2cp, msg) do {                                        \
+  if ((i2cp)->tcurr != NULL) {                                              \
+    _i2c_isr_transactions_code(i2cp, msg);                                  \
+  }                                                                         \
+  else {                                                                    \
+    _i2c_wakeup_msg_isr(i2cp, msg);                                         \
+  }                                                                         \
 } while(0)
+#else
+#define _i2c_end_isr(i2cp, msg) _i2c_wakeup_msg_isr(i2cp, msg)
+#endif
+
+/**
+ * @brief   Wakes up the waiting thread notifying no errors.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+#define _i2c_wakeup_isr(i2cp) _i2c_end_isr(i2cp, MSG_OK)
+
+/**
+ * @brief   Wakes up the waiting thread notifying errors.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+#define _i2c_wakeup_error_isr(i2cp) _i2c_end_isr(i2cp, MSG_RESET)
 
 /**
  * @brief   Wrap i2cMasterTransmitTimeout function with TIME_INFINITE timeout.
@@ -129,6 +229,21 @@ typedef enum {
 #define i2cMasterReceive(i2cp, addr, rxbuf, rxbytes)                        \
   (i2cMasterReceiveTimeout(i2cp, addr, rxbuf, rxbytes, TIME_INFINITE))
 
+#if (I2C_USE_TRANSACTIONS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a single asynchronous transaction.
+ * @api
+ */
+#define i2cStartTransaction(i2cp, tp) i2cStartTransactions(i2cp, tp, 1U)
+
+/**
+ * @brief   Wrap i2cTransactionsTimeout function with TIME_INFINITE timeout.
+ * @api
+ */
+#define i2cTransactions(i2cp, tp, n)                                        \
+  (i2cTransactionsTimeout(i2cp, tp, n, TIME_INFINITE))
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -154,6 +269,16 @@ extern "C" {
   void i2cAcquireBus(I2CDriver *i2cp);
   void i2cReleaseBus(I2CDriver *i2cp);
 #endif
+#if I2C_USE_TRANSACTIONS == TRUE
+  void i2cStartTransactionsI(I2CDriver *i2cp,
+                             const I2CTransaction *tp, size_t n);
+  void i2cStartTransactions(I2CDriver *i2cp,
+                            const I2CTransaction *tp, size_t n);
+  msg_t i2cTransactionsTimeout(I2CDriver *i2cp,
+                               const I2CTransaction *tp, size_t n,
+                               sysinterval_t timeout);
+  void _i2c_isr_transactions_code(I2CDriver *i2cp, msg_t msg);
+#endif
 
 #ifdef __cplusplus
 }
@@ -43,6 +43,19 @@
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @name    I2S configuration options
+ * @{
+ */
+/**
+ * @brief   Enables the streaming on buffers queues API.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(I2S_USE_STREAMING) || defined(__DOXYGEN__)
+#define I2S_USE_STREAMING                   FALSE
+#endif
+/** @} */
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -64,6 +77,16 @@ typedef enum {
 
 #include "hal_i2s_lld.h"
 
+/* Some more checks, must happen after inclusion of the LLD header, this is
+   why are placed here.*/
+#if !defined(I2S_SUPPORTS_STREAMING)
+#define I2S_SUPPORTS_STREAMING      FALSE
+#endif
+
+#if (I2S_USE_STREAMING == TRUE) && (I2S_SUPPORTS_STREAMING == FALSE)
+#error "I2S streaming not supported by the low level driver"
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -98,6 +121,50 @@ typedef enum {
   (i2sp)->state = I2S_READY;                                                \
 }
 
+#if (I2S_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a I2S streaming on buffers queues.
+ *
+ * @param[in] i2sp      pointer to the @p I2SDriver object
+ * @param[in] iqp       pointer to the input buffers queue or @p NULL
+ * @param[in] oqp       pointer to the output buffers queue or @p NULL
+ *
+ * @iclass
+ */
+#define i2sStartStreamingI(i2sp, iqp, oqp) {                                \
+  (i2sp)->ibqp      = (iqp);                                                \
+  (i2sp)->obqp      = (oqp);                                                \
+  (i2sp)->overruns  = 0U;                                                   \
+  (i2sp)->underruns = 0U;                                                   \
+  i2s_lld_start_streaming(i2sp);                                            \
+  (i2sp)->state = I2S_ACTIVE;                                               \
+}
+
+/**
+ * @brief   Returns the number of received blocks dropped.
+ * @details A block is dropped when the input queue has no empty buffers
+ *          when the block reception starts.
+ *
+ * @param[in] i2sp      pointer to the @p I2SDriver object
+ * @return              The overruns counter.
+ *
+ * @xclass
+ */
+#define i2sGetOverrunsX(i2sp) ((i2sp)->overruns)
+
+/**
+ * @brief   Returns the number of silence blocks transmitted.
+ * @details A silence block is transmitted when the output queue has no
+ *          filled buffers when the block transmission starts.
+ *
+ * @param[in] i2sp      pointer to the @p I2SDriver object
+ * @return              The underruns counter.
+ *
+ * @xclass
+ */
+#define i2sGetUnderrunsX(i2sp) ((i2sp)->underruns)
+#endif /* I2S_USE_STREAMING == TRUE */
+
 /**
  * @brief   Common ISR code, half buffer event.
  * @details This code handles the portable part of the ISR code:
@@ -155,6 +222,14 @@ extern "C" {
   void i2sStop(I2SDriver *i2sp);
   void i2sStartExchange(I2SDriver *i2sp);
   void i2sStopExchange(I2SDriver *i2sp);
+#if I2S_USE_STREAMING == TRUE
+  void i2sStartStreaming(I2SDriver *i2sp,
+                         input_buffers_queue_t *ibqp,
+                         output_buffers_queue_t *obqp);
+  uint8_t *_i2s_rx_block(I2SDriver *i2sp, uint8_t *done, uint8_t *next);
+  const uint8_t *_i2s_tx_block(I2SDriver *i2sp, const uint8_t *done,
+                               const uint8_t *next);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -55,6 +55,9 @@ typedef enum {
 typedef struct {
   uint32_t      blk_size;           /**< @brief Block size in bytes.        */
   uint32_t      blk_num;            /**< @brief Total number of blocks.     */
+  uint32_t      bus_rate;           /**< @brief Interface transfer rate in
+                                         bytes per second, zero if
+                                         unknown.                       */
 } BlockDeviceInfo;
 
 /**
@@ -30,6 +30,27 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @name    Checksum offload flags
+ * @{
+ */
+#define MAC_CHECKSUM_IP             1U  /**< IPv4 header checksum.         */
+#define MAC_CHECKSUM_TCP            2U  /**< TCP checksum.                  */
+#define MAC_CHECKSUM_UDP            4U  /**< UDP checksum.                  */
+#define MAC_CHECKSUM_ICMP           8U  /**< ICMP checksum.                 */
+#define MAC_CHECKSUM_ALL            (MAC_CHECKSUM_IP | MAC_CHECKSUM_TCP |   \
+                                     MAC_CHECKSUM_UDP | MAC_CHECKSUM_ICMP)
+/** @} */
+
+/**
+ * @name    Frame filter mode flags
+ * @{
+ */
+#define MAC_FILTER_PROMISCUOUS      1U  /**< All frames are received.      */
+#define MAC_FILTER_ALL_MULTICAST    2U  /**< All multicast frames received.*/
+#define MAC_FILTER_NO_BROADCAST     4U  /**< Broadcast frames discarded.   */
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -75,8 +96,76 @@ typedef enum {
  */
 typedef struct MACDriver MACDriver;
 
+#if (MAC_USE_ZERO_COPY == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Structure representing a buffer of a frame to be transmitted.
+ */
+typedef struct {
+  /**
+   * @brief   Pointer to the buffer data.
+   */
+  const uint8_t             *buf;
+  /**
+   * @brief   Buffer size in bytes.
+   */
+  size_t                    size;
+} MACTransmitBuffer;
+
+/**
+ * @brief   Type of a transmitted frame release callback.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] frame     frame identifier passed to @p macWaitTransmitBuffers()
+ */
+typedef void (*macframecb_t)(MACDriver *macp, void *frame);
+#endif
+
+/**
+ * @brief   Type of an IEEE 1588 time stamp.
+ */
+typedef struct {
+  /**
+   * @brief   Seconds.
+   */
+  uint32_t                  sec;
+  /**
+   * @brief   Nanoseconds, always less than one second.
+   */
+  uint32_t                  nsec;
+} mac_timestamp_t;
+
 #include "hal_mac_lld.h"
 
+/* Some more checks, must happen after inclusion of the LLD header, this is
+   why are placed here.*/
+#if !defined(MAC_SUPPORTS_BUFFERS_LENDING)
+#define MAC_SUPPORTS_BUFFERS_LENDING    FALSE
+#endif
+
+#if !defined(MAC_SUPPORTS_RECEIVE_POLLING)
+#define MAC_SUPPORTS_RECEIVE_POLLING    FALSE
+#endif
+
+#if !defined(MAC_SUPPORTS_LINK_EVENTS)
+#define MAC_SUPPORTS_LINK_EVENTS        FALSE
+#endif
+
+#if !defined(MAC_SUPPORTS_TIMESTAMPS)
+#define MAC_SUPPORTS_TIMESTAMPS         FALSE
+#endif
+
+#if !defined(MAC_SUPPORTS_FILTERS)
+#define MAC_SUPPORTS_FILTERS            FALSE
+#endif
+
+#if !defined(MAC_CHECKSUM_TX_OFFLOAD)
+#define MAC_CHECKSUM_TX_OFFLOAD         0U
+#endif
+
+#if !defined(MAC_CHECKSUM_RX_OFFLOAD)
+#define MAC_CHECKSUM_RX_OFFLOAD         0U
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -97,6 +186,34 @@ typedef struct MACDriver MACDriver;
 #define macGetReceiveEventSource(macp)  (&(macp)->rdevent)
 #endif
 
+#if ((MAC_USE_EVENTS == TRUE) && (MAC_SUPPORTS_LINK_EVENTS == TRUE)) ||     \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Returns the link change event source.
+ * @details The source is broadcast by @p macLinkChangedI(), listeners are
+ *          expected to invoke @p macPollLinkStatus() in order to read the
+ *          new link status.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The pointer to the @p EventSource structure.
+ *
+ * @api
+ */
+#define macGetLinkEventSource(macp)     (&(macp)->lsevent)
+
+/**
+ * @brief   Notifies a link change.
+ * @details This function is meant to be invoked from the PHY interrupt
+ *          line callback, the PHY registers are not accessed.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @iclass
+ */
+#define macLinkChangedI(macp)                                               \
+    osalEventBroadcastFlagsI(&(macp)->lsevent, (eventflags_t)0)
+#endif
+
 /**
  * @brief   Writes to a transmit descriptor's stream.
  *
@@ -128,6 +245,127 @@ typedef struct MACDriver MACDriver;
 #define macReadReceiveDescriptor(rdp, buf, size)                            \
     mac_lld_read_receive_descriptor(rdp, buf, size)
 
+#if (MAC_CHECKSUM_TX_OFFLOAD != 0U) || defined(__DOXYGEN__)
+/**
+ * @brief   Selects the checksums inserted by the MAC in a transmit frame.
+ * @details By default all the checksums in @p MAC_CHECKSUM_TX_OFFLOAD are
+ *          inserted, this function restricts them for a single frame.
+ * @note    Flags not present in @p MAC_CHECKSUM_TX_OFFLOAD are ignored.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ * @param[in] flags     checksum offload flags
+ *
+ * @api
+ */
+#define macSetTransmitChecksumOffload(tdp, flags)                           \
+    mac_lld_set_transmit_checksum_offload(tdp, flags)
+#endif
+
+#if (MAC_SUPPORTS_RECEIVE_POLLING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Enables the frame received interrupt.
+ * @note    A frame received while the interrupt was disabled is notified
+ *          as soon as the interrupt is enabled again.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @iclass
+ */
+#define macEnableReceiveInterruptI(macp)                                    \
+    mac_lld_enable_receive_interrupt(macp)
+
+/**
+ * @brief   Disables the frame received interrupt.
+ * @details Received frames are no more notified, the application is expected
+ *          to poll the receive descriptors.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @iclass
+ */
+#define macDisableReceiveInterruptI(macp)                                   \
+    mac_lld_disable_receive_interrupt(macp)
+#endif /* MAC_SUPPORTS_RECEIVE_POLLING == TRUE */
+
+#if (MAC_SUPPORTS_TIMESTAMPS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the time stamp of a received frame.
+ * @details The time stamp is captured by the MAC when the frame start is
+ *          detected on the line and is read from the descriptor, the
+ *          descriptor must not have been released yet.
+ *
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @param[out] tsp      pointer to a @p mac_timestamp_t structure
+ * @return              The time stamp availability.
+ * @retval true         if the time stamp has been returned.
+ * @retval false        if the frame has not been time stamped.
+ *
+ * @api
+ */
+#define macGetReceiveTimestamp(rdp, tsp)                                    \
+    mac_lld_get_receive_timestamp(rdp, tsp)
+
+/**
+ * @brief   Requests the time stamp of a transmit frame.
+ * @details The time stamp is captured by the MAC when the frame is sent,
+ *          it is retrieved using @p macWaitTransmitTimestamp() after
+ *          releasing the descriptor.
+ * @note    Only the last requested time stamp is retained.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ *
+ * @api
+ */
+#define macRequestTransmitTimestamp(tdp)                                    \
+    mac_lld_request_transmit_timestamp(tdp)
+
+/**
+ * @brief   Returns the current PTP clock time.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] tsp      pointer to a @p mac_timestamp_t structure
+ *
+ * @api
+ */
+#define macPTPGetTime(macp, tsp) mac_lld_ptp_get_time(macp, tsp)
+
+/**
+ * @brief   Sets the PTP clock time.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] tsp       pointer to a @p mac_timestamp_t structure
+ *
+ * @api
+ */
+#define macPTPSetTime(macp, tsp) mac_lld_ptp_set_time(macp, tsp)
+
+/**
+ * @brief   Adds an offset to the PTP clock time.
+ * @details This is a coarse step correction, the clock frequency is not
+ *          changed.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] offset    offset in nanoseconds, can be negative
+ *
+ * @api
+ */
+#define macPTPAdjustTime(macp, offset) mac_lld_ptp_adjust_time(macp, offset)
+
+/**
+ * @brief   Adjusts the PTP clock frequency.
+ * @details This is a fine correction, the clock rate is changed by the
+ *          specified amount relative to its nominal frequency.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] ppb       frequency correction in parts per billion, can be
+ *                      negative
+ *
+ * @api
+ */
+#define macPTPAdjustFrequency(macp, ppb)                                    \
+    mac_lld_ptp_adjust_frequency(macp, ppb)
+#endif /* MAC_SUPPORTS_TIMESTAMPS == TRUE */
+
 #if (MAC_USE_ZERO_COPY == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Returns a pointer to the next transmit buffer in the descriptor
@@ -167,6 +405,48 @@ typedef struct MACDriver MACDriver;
  */
 #define macGetNextReceiveBuffer(rdp, sizep)                                 \
   mac_lld_get_next_receive_buffer(rdp, sizep)
+
+#if (MAC_SUPPORTS_BUFFERS_LENDING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Lends the buffer of a received frame.
+ * @details The buffer containing the frame is detached from the descriptor
+ *          and replaced with a spare one, the descriptor can be released
+ *          immediately while the frame buffer is retained by the caller.
+ * @note    The frame size is the @p size field of the receive descriptor,
+ *          the buffer must be given back using @p macReturnReceiveBuffer().
+ *
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @return              Pointer to the frame buffer.
+ * @retval NULL         if no spare buffers are available, the frame must
+ *                      be read using the other APIs.
+ *
+ * @api
+ */
+#define macLendReceiveBuffer(rdp) mac_lld_lend_receive_buffer(rdp)
+
+/**
+ * @brief   Gives back a buffer lent by @p macLendReceiveBuffer().
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] buf       pointer to the buffer
+ *
+ * @api
+ */
+#define macReturnReceiveBuffer(macp, buf)                                   \
+  mac_lld_return_receive_buffer(macp, buf)
+
+/**
+ * @brief   Releases the frames already transmitted.
+ * @details The release callback is invoked for each frame queued using
+ *          @p macWaitTransmitBuffers() and completely transmitted.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @api
+ */
+#define macReleaseTransmittedFrames(macp)                                   \
+  mac_lld_release_transmitted_frames(macp)
+#endif /* MAC_SUPPORTS_BUFFERS_LENDING == TRUE */
 #endif /* MAC_USE_ZERO_COPY */
 /** @} */
 
@@ -191,6 +471,21 @@ extern "C" {
                                  sysinterval_t timeout);
   void macReleaseReceiveDescriptor(MACReceiveDescriptor *rdp);
   bool macPollLinkStatus(MACDriver *macp);
+#if (MAC_USE_ZERO_COPY == TRUE) && (MAC_SUPPORTS_BUFFERS_LENDING == TRUE)
+  msg_t macWaitTransmitBuffers(MACDriver *macp,
+                               const MACTransmitBuffer *tbp, size_t n,
+                               void *frame, sysinterval_t timeout);
+#endif
+#if MAC_SUPPORTS_TIMESTAMPS == TRUE
+  msg_t macWaitTransmitTimestamp(MACDriver *macp, mac_timestamp_t *tsp,
+                                 sysinterval_t timeout);
+#endif
+#if MAC_SUPPORTS_FILTERS == TRUE
+  void macSetFilterMode(MACDriver *macp, uint32_t mode);
+  msg_t macAddFilterAddress(MACDriver *macp, const uint8_t *addr);
+  msg_t macRemoveFilterAddress(MACDriver *macp, const uint8_t *addr);
+  void macSetVLANFilter(MACDriver *macp, uint16_t vid);
+#endif
 #ifdef __cplusplus
 }
 #endif
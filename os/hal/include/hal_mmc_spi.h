@@ -35,6 +35,8 @@
 #define MMC_CMD1_RETRY              100U
 #define MMC_ACMD41_RETRY            100U
 #define MMC_WAIT_DATA               10000U
+#define MMC_WAIT_BUSY               64U
+#define MMC_SCAN_SIZE               8U
 
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
@@ -43,6 +43,11 @@
  */
 #define MMCSD_R1_ERROR_MASK             0xFDFFE008U
 
+/**
+ * @brief   SWITCH_ERROR bit in R1 responses.
+ */
+#define MMCSD_R1_SWITCH_ERROR           0x00000080U
+
 /**
  * @brief   Fixed pattern for CMD8.
  */
@@ -91,10 +96,33 @@
 #define MMCSD_CMD_ERASE                 38U
 #define MMCSD_CMD_APP_OP_COND           41U
 #define MMCSD_CMD_LOCK_UNLOCK           42U
+#define MMCSD_CMD_APP_SEND_SCR          51U
 #define MMCSD_CMD_APP_CMD               55U
 #define MMCSD_CMD_READ_OCR              58U
 /** @} */
 
+/**
+ * @name    MMC EXT_CSD fields offsets
+ * @{
+ */
+#define MMCSD_EXT_CSD_FLUSH_CACHE       32U
+#define MMCSD_EXT_CSD_CACHE_CTRL        33U
+#define MMCSD_EXT_CSD_BUS_WIDTH         183U
+#define MMCSD_EXT_CSD_HS_TIMING         185U
+#define MMCSD_EXT_CSD_REV               192U
+#define MMCSD_EXT_CSD_CARD_TYPE         196U
+#define MMCSD_EXT_CSD_CACHE_SIZE        249U
+/** @} */
+
+/**
+ * @name    MMC EXT_CSD CARD_TYPE bits
+ * @{
+ */
+#define MMCSD_EXT_CSD_CARD_TYPE_HS_26   0x01U
+#define MMCSD_EXT_CSD_CARD_TYPE_HS_52   0x02U
+#define MMCSD_EXT_CSD_CARD_TYPE_HS200   0x30U
+/** @} */
+
 /**
  * @name   CSD record offsets
  */
@@ -132,6 +132,18 @@
 #if !defined(PAL_USE_WAIT) || defined(__DOXYGEN__)
 #define PAL_USE_WAIT                TRUE
 #endif
+
+/**
+ * @brief   Enables the grouped events APIs.
+ * @details A group of lines is notified once per interrupt with the mask
+ *          of the lines that triggered, this allows to serve bursts of
+ *          edges on many lines with a single callback or wakeup.
+ * @note    The port driver must invoke @p _pal_isr_group_code() from its
+ *          events interrupt handlers.
+ */
+#if !defined(PAL_USE_EVENT_GROUPS) || defined(__DOXYGEN__)
+#define PAL_USE_EVENT_GROUPS        FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -171,6 +183,58 @@ typedef struct {
 
 #include "hal_pal_lld.h"
 
+#if (PAL_USE_EVENT_GROUPS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a PAL events group callback.
+ *
+ * @param[in] arg       callback argument
+ * @param[in] events    mask of the lines that triggered
+ * @param[in] timestamp system time of the interrupt that triggered
+ */
+typedef void (*palgroupcallback_t)(void *arg,
+                                   ioportmask_t events,
+                                   systime_t timestamp);
+
+/**
+ * @brief   Type of a PAL events group.
+ * @note    Lines are identified by their event channel number, on ports
+ *          where the channel is the pad number this is the same as a
+ *          port mask.
+ */
+typedef struct paleventgroup {
+  /**
+   * @brief   Next group in the list of the attached groups.
+   */
+  struct paleventgroup  *next;
+  /**
+   * @brief   Mask of the lines belonging to this group.
+   */
+  ioportmask_t          mask;
+  /**
+   * @brief   Lines triggered since the last wait.
+   */
+  volatile ioportmask_t events;
+  /**
+   * @brief   System time of the last triggering interrupt.
+   */
+  volatile systime_t    timestamp;
+  /**
+   * @brief   Group callback or @p NULL.
+   */
+  palgroupcallback_t    cb;
+  /**
+   * @brief   Group callback argument.
+   */
+  void                  *arg;
+#if (PAL_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Threads waiting for the group.
+   */
+  threads_queue_t       threads;
+#endif
+} paleventgroup_t;
+#endif /* PAL_USE_EVENT_GROUPS == TRUE */
+
 /**
  * @brief   I/O bus descriptor.
  * @details This structure describes a group of contiguous digital I/O lines
@@ -352,6 +416,25 @@ typedef struct {
 } while (false)
 #endif /* (PAL_USE_CALLBACKS == FALSE) && (PAL_USE_WAIT == TRUE) */
 
+/**
+ * @brief   PAL events groups code for events interrupts.
+ * @details This macro must be invoked once per interrupt, after the single
+ *          events have been served, with the mask of all the events
+ *          channels that triggered.
+ *
+ * @param[in] events    mask of the triggered events channels
+ *
+ * @notapi
+ */
+#if (PAL_USE_EVENT_GROUPS == TRUE) || defined(__DOXYGEN__)
+#define _pal_isr_group_code(events) do {                                    \
+  if ((events) != 0U) {                                                     \
+    _pal_serve_event_groups((ioportmask_t)(events));                        \
+  }                                                                         \
+} while (false)
+#else
+#define _pal_isr_group_code(events) (void)(events)
+#endif
 /** @} */
 #endif /* (PAL_USE_CALLBACKS == TRUE) || (PAL_USE_WAIT == TRUE) */
 
@@ -974,6 +1057,19 @@ extern "C" {
   msg_t palWaitLineTimeoutS(ioline_t line, sysinterval_t timeout);
   msg_t palWaitLineTimeout(ioline_t line, sysinterval_t timeout);
 #endif /* PAL_USE_WAIT == TRUE */
+#if (PAL_USE_EVENT_GROUPS == TRUE) || defined(__DOXYGEN__)
+  void palEventGroupObjectInit(paleventgroup_t *gp, ioportmask_t mask,
+                               palgroupcallback_t cb, void *arg);
+  void palAttachEventGroupI(paleventgroup_t *gp);
+  void palDetachEventGroupI(paleventgroup_t *gp);
+#if (PAL_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+  ioportmask_t palWaitEventGroupTimeoutS(paleventgroup_t *gp,
+                                         sysinterval_t timeout);
+  ioportmask_t palWaitEventGroupTimeout(paleventgroup_t *gp,
+                                        sysinterval_t timeout);
+#endif
+  void _pal_serve_event_groups(ioportmask_t events);
+#endif /* PAL_USE_EVENT_GROUPS == TRUE */
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,149 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_pm.h
+ * @brief   PM Driver macros and structures.
+ *
+ * @addtogroup PM
+ * @{
+ */
+
+#ifndef HAL_PM_H
+#define HAL_PM_H
+
+#if (HAL_USE_PM == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Sleep depths
+ * @{
+ */
+/**
+ * @brief   CPU clock stopped, peripherals running.
+ */
+#define PM_DEPTH_SLEEP                      0U
+/**
+ * @brief   All clocks stopped, RAM and registers retained.
+ */
+#define PM_DEPTH_STOP                       1U
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    PM configuration options
+ * @{
+ */
+/**
+ * @brief   Sleep margin.
+ * @details Time, in microseconds, added to the entry and exit latency of
+ *          a sleep depth when checking if it fits before the next timer
+ *          event.
+ */
+#if !defined(PM_SLEEP_MARGIN_US) || defined(__DOXYGEN__)
+#define PM_SLEEP_MARGIN_US                  100
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if OSAL_ST_MODE != OSAL_ST_MODE_FREERUNNING
+#error "PM driver requires the tick-less mode"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a sleep depth.
+ */
+typedef unsigned pmdepth_t;
+
+#include "hal_pm_lld.h"
+
+#if PM_LLD_DEPTHS_NUM < 1
+#error "invalid PM_LLD_DEPTHS_NUM value"
+#endif
+
+/**
+ * @brief   Structure representing the PM driver.
+ */
+typedef struct {
+  /**
+   * @brief   Depth locks.
+   * @details The element @p n counts the requests to not go deeper than
+   *          the depth @p n.
+   */
+  uint32_t                  locks[PM_LLD_DEPTHS_NUM];
+  /**
+   * @brief   Number of times each depth has been entered.
+   */
+  uint32_t                  entries[PM_LLD_DEPTHS_NUM];
+} PMDriver;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Returns the number of times a depth has been entered.
+ *
+ * @param[in] depth     the sleep depth
+ * @return              The entries counter.
+ *
+ * @xclass
+ */
+#define pmGetEntriesX(depth) (PMD1.entries[depth])
+/** @} */
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern PMDriver PMD1;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void pmInit(void);
+  void pmLockDepthI(pmdepth_t depth);
+  void pmLockDepth(pmdepth_t depth);
+  void pmUnlockDepthI(pmdepth_t depth);
+  void pmUnlockDepth(pmdepth_t depth);
+  pmdepth_t pmGetMaxDepthI(void);
+  void pmIdle(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_PM == TRUE */
+
+#endif /* HAL_PM_H */
+
+/** @} */
@@ -304,11 +304,15 @@ extern "C" {
                     qnotify_t infy, void *link);
   void iqResetI(input_queue_t *iqp);
   msg_t iqPutI(input_queue_t *iqp, uint8_t b);
+  size_t iqWriteBlockI(input_queue_t *iqp, const uint8_t *bp, size_t n);
   msg_t iqGetI(input_queue_t *iqp);
   msg_t iqGetTimeout(input_queue_t *iqp, sysinterval_t timeout);
   size_t iqReadI(input_queue_t *iqp, uint8_t *bp, size_t n);
   size_t iqReadTimeout(input_queue_t *iqp, uint8_t *bp,
                        size_t n, sysinterval_t timeout);
+  const uint8_t *iqGetReadBufferTimeout(input_queue_t *iqp, size_t *np,
+                                        sysinterval_t timeout);
+  void iqReleaseReadBuffer(input_queue_t *iqp, size_t n);
 
   void oqObjectInit(output_queue_t *oqp, uint8_t *bp, size_t size,
                     qnotify_t onfy, void *link);
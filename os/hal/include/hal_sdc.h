@@ -40,6 +40,9 @@
 #define SDC_MODE_CARDTYPE_SDV20             1U
 #define SDC_MODE_CARDTYPE_MMC               2U
 #define SDC_MODE_HIGH_CAPACITY              0x10U
+#define SDC_MODE_BLOCK_COUNT                0x20U
+#define SDC_MODE_HIGH_SPEED                 0x40U
+#define SDC_MODE_CACHE                      0x80U
 /** @} */
 
 /**
@@ -106,6 +109,26 @@
 #if !defined(SDC_INIT_OCR) || defined(__DOXYGEN__)
 #define SDC_INIT_OCR                        0x80100000U
 #endif
+
+/**
+ * @brief   Enables the asynchronous transfers API.
+ * @details Transfers are started by @p sdcStartRead() and
+ *          @p sdcStartWrite() and completed from the ISR, one more
+ *          transfer can be queued while another is in progress.
+ */
+#if !defined(SDC_USE_ASYNC_TRANSFERS) || defined(__DOXYGEN__)
+#define SDC_USE_ASYNC_TRANSFERS             FALSE
+#endif
+
+/**
+ * @brief   Enables the eMMC volatile cache.
+ * @details If the card has a cache then it is enabled on connection and
+ *          flushed by @p sdcSync() and @p sdcDisconnect().
+ * @note    Written data is not persistent until the cache is flushed.
+ */
+#if !defined(SDC_MMC_USE_CACHE) || defined(__DOXYGEN__)
+#define SDC_MMC_USE_CACHE                   FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -133,8 +156,55 @@ typedef enum {
   SDC_CLK_50MHz
 } sdcbusclk_t;
 
+#if (SDC_USE_ASYNC_TRANSFERS == TRUE) || defined(__DOXYGEN__)
+struct SDCDriver;
+
+/**
+ * @brief   Asynchronous transfer end callback type.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] result    the transfer status
+ */
+typedef void (*sdccallback_t)(struct SDCDriver *sdcp, bool result);
+
+/**
+ * @brief   Asynchronous transfer request.
+ */
+typedef struct {
+  /**
+   * @brief   First block of the transfer.
+   */
+  uint32_t                  startblk;
+  /**
+   * @brief   Data buffer.
+   */
+  uint8_t                   *buf;
+  /**
+   * @brief   Number of blocks.
+   */
+  uint32_t                  n;
+  /**
+   * @brief   Write transfer if @p true.
+   */
+  bool                      write;
+  /**
+   * @brief   Callback invoked from ISR context at transfer end, can
+   *          be @p NULL.
+   */
+  sdccallback_t             end_cb;
+} SDCRequest;
+#endif
+
 #include "hal_sdc_lld.h"
 
+#if !defined(SDC_SUPPORTS_ASYNC_TRANSFERS)
+#define SDC_SUPPORTS_ASYNC_TRANSFERS        FALSE
+#endif
+
+#if (SDC_USE_ASYNC_TRANSFERS == TRUE) && (SDC_SUPPORTS_ASYNC_TRANSFERS == FALSE)
+#error "SDC_USE_ASYNC_TRANSFERS not supported by this implementation"
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -197,6 +267,14 @@ extern "C" {
   bool sdcSync(SDCDriver *sdcp);
   bool sdcGetInfo(SDCDriver *sdcp, BlockDeviceInfo *bdip);
   bool sdcErase(SDCDriver *sdcp, uint32_t startblk, uint32_t endblk);
+#if SDC_USE_ASYNC_TRANSFERS == TRUE
+  bool sdcStartRead(SDCDriver *sdcp, uint32_t startblk,
+                    uint8_t *buf, uint32_t n, sdccallback_t end_cb);
+  bool sdcStartWrite(SDCDriver *sdcp, uint32_t startblk,
+                     const uint8_t *buf, uint32_t n, sdccallback_t end_cb);
+  bool sdcWaitTransfers(SDCDriver *sdcp);
+  void _sdc_isr_transfer_code(SDCDriver *sdcp, bool result);
+#endif
   bool _sdc_wait_for_transfer_state(SDCDriver *sdcp);
 #ifdef __cplusplus
 }
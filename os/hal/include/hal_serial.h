@@ -41,6 +41,7 @@
 #define SD_NOISE_ERROR          (eventflags_t)256   /**< @brief Line noise. */
 #define SD_BREAK_DETECTED       (eventflags_t)512   /**< @brief LIN Break.  */
 #define SD_QUEUE_FULL_ERROR     (eventflags_t)1024  /**< @brief Queue full. */
+#define SD_FRAME_END            (eventflags_t)2048  /**< @brief RX timeout. */
 /** @} */
 
 /*===========================================================================*/
@@ -297,6 +298,7 @@ extern "C" {
   void sdStart(SerialDriver *sdp, const SerialConfig *config);
   void sdStop(SerialDriver *sdp);
   void sdIncomingDataI(SerialDriver *sdp, uint8_t b);
+  void sdIncomingDataBlockI(SerialDriver *sdp, const uint8_t *bp, size_t n);
   msg_t sdRequestDataI(SerialDriver *sdp);
   bool sdPutWouldBlock(SerialDriver *sdp);
   bool sdGetWouldBlock(SerialDriver *sdp);
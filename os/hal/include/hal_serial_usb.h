@@ -47,6 +47,9 @@
  *          the USB data endpoint maximum packet size.
  * @note    The default is 256 bytes for both the transmission and receive
  *          buffers.
+ * @note    Each buffer is moved as a single multi-packet transfer, on
+ *          high speed ports a size of several packets (2048 or more) is
+ *          required in order to approach the bulk bandwidth.
  */
 #if !defined(SERIAL_USB_BUFFERS_SIZE) || defined(__DOXYGEN__)
 #define SERIAL_USB_BUFFERS_SIZE     256
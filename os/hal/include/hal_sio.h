@@ -51,7 +51,13 @@
  * @name    SIO configuration options
  * @{
  */
-
+/**
+ * @brief   Enables synchronous APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(SIO_USE_SYNCHRONIZATION) || defined(__DOXYGEN__)
+#define SIO_USE_SYNCHRONIZATION             FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -185,6 +191,128 @@ typedef enum {
  */
 #define sioControlX(siop, operation, arg) sio_lld_control(siop, operation, arg)
 
+/**
+ * @name    Low level driver helper macros
+ * @{
+ */
+#if (SIO_USE_SYNCHRONIZATION == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Wakes up the RX-waiting thread.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @param[in] msg       the wake up message
+ *
+ * @notapi
+ */
+#define __sio_wakeup_rx(siop, msg) {                                        \
+  osalSysLockFromISR();                                                     \
+  osalThreadResumeI(&(siop)->sync_rx, msg);                                 \
+  osalSysUnlockFromISR();                                                   \
+}
+
+/**
+ * @brief   Wakes up the TX-waiting thread.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @param[in] msg       the wake up message
+ *
+ * @notapi
+ */
+#define __sio_wakeup_tx(siop, msg) {                                        \
+  osalSysLockFromISR();                                                     \
+  osalThreadResumeI(&(siop)->sync_tx, msg);                                 \
+  osalSysUnlockFromISR();                                                   \
+}
+#else /* !SIO_USE_SYNCHRONIZATION */
+#define __sio_wakeup_rx(siop, msg)
+#define __sio_wakeup_tx(siop, msg)
+#endif /* !SIO_USE_SYNCHRONIZATION */
+
+/**
+ * @brief   Common ISR code for RX data available.
+ * @details This code handles the portable part of the ISR code:
+ *          - Callback invocation.
+ *          - Waiting thread wakeup, if any.
+ *          .
+ * @note    This macro is meant to be used in the low level drivers
+ *          implementation only.
+ * @note    Implementations with an hardware FIFO should invoke this code
+ *          only when the RX FIFO threshold is reached or the line goes
+ *          idle, coalescing the per-frame events.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ *
+ * @notapi
+ */
+#define _sio_isr_rx_code(siop) {                                            \
+  if ((siop)->config->rxne_cb != NULL) {                                    \
+    (siop)->config->rxne_cb(siop);                                          \
+  }                                                                         \
+  __sio_wakeup_rx(siop, MSG_OK);                                            \
+}
+
+/**
+ * @brief   Common ISR code for RX error events.
+ * @details This code handles the portable part of the ISR code:
+ *          - Callback invocation.
+ *          - Waiting thread wakeup, if any.
+ *          .
+ * @note    This macro is meant to be used in the low level drivers
+ *          implementation only.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @param[in] flags     mask of the events to be reported
+ *
+ * @notapi
+ */
+#define _sio_isr_rxevt_code(siop, flags) {                                  \
+  if ((siop)->config->rxevt_cb != NULL) {                                   \
+    (siop)->config->rxevt_cb(siop, flags);                                  \
+  }                                                                         \
+  __sio_wakeup_rx(siop, MSG_RESET);                                         \
+}
+
+/**
+ * @brief   Common ISR code for TX space available.
+ * @details This code handles the portable part of the ISR code:
+ *          - Callback invocation.
+ *          - Waiting thread wakeup, if any.
+ *          .
+ * @note    This macro is meant to be used in the low level drivers
+ *          implementation only.
+ * @note    Implementations with an hardware FIFO should invoke this code
+ *          only when the TX FIFO threshold is reached.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ *
+ * @notapi
+ */
+#define _sio_isr_tx_code(siop) {                                            \
+  if ((siop)->config->txnf_cb != NULL) {                                    \
+    (siop)->config->txnf_cb(siop);                                          \
+  }                                                                         \
+  __sio_wakeup_tx(siop, MSG_OK);                                            \
+}
+
+/**
+ * @brief   Common ISR code for physical end of transmission.
+ * @details This code handles the portable part of the ISR code:
+ *          - Callback invocation.
+ *          .
+ * @note    This macro is meant to be used in the low level drivers
+ *          implementation only.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ *
+ * @notapi
+ */
+#define _sio_isr_txend_code(siop) {                                         \
+  if ((siop)->config->txend_cb != NULL) {                                   \
+    (siop)->config->txend_cb(siop);                                         \
+  }                                                                         \
+}
+/** @} */
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -196,6 +324,12 @@ extern "C" {
   void sioObjectInit(SIODriver *siop);
   void sioStart(SIODriver *siop, const SIOConfig *config);
   void sioStop(SIODriver *siop);
+#if SIO_USE_SYNCHRONIZATION == TRUE
+  size_t sioSynchronousRead(SIODriver *siop, void *buffer, size_t n,
+                            sysinterval_t timeout);
+  size_t sioSynchronousWrite(SIODriver *siop, const void *buffer, size_t n,
+                             sysinterval_t timeout);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -68,6 +68,14 @@
 #define SPI_USE_CIRCULAR                    FALSE
 #endif
 
+/**
+ * @brief   Enables the transactions queue APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(SPI_USE_TRANSACTIONS) || defined(__DOXYGEN__)
+#define SPI_USE_TRANSACTIONS                FALSE
+#endif
+
 /**
  * @brief   Enables the @p spiAcquireBus() and @p spiReleaseBus() APIs.
  * @note    Disabling this option saves both code and data space.
@@ -112,6 +120,13 @@ typedef enum {
   SPI_COMPLETE = 4                  /**< Asynchronous operation complete.   */
 } spistate_t;
 
+#if (SPI_USE_TRANSACTIONS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of an SPI transaction descriptor.
+ */
+typedef struct SPITransaction SPITransaction;
+#endif
+
 #include "hal_spi_lld.h"
 
 /* Some more checks, must happen after inclusion of the LLD header, this is
@@ -120,6 +135,49 @@ typedef enum {
 #define SPI_SUPPORTS_CIRCULAR               FALSE
 #endif
 
+#if !defined(SPI_SUPPORTS_TRANSACTIONS)
+#define SPI_SUPPORTS_TRANSACTIONS           FALSE
+#endif
+
+#if (SPI_USE_TRANSACTIONS == TRUE) && (SPI_SUPPORTS_TRANSACTIONS == FALSE)
+#error "SPI transactions not supported by the low level driver"
+#endif
+
+#if (SPI_USE_TRANSACTIONS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Structure representing an SPI transaction.
+ * @details Transactions are executed back to back, the slave is selected
+ *          using the chip select settings of the transaction configuration
+ *          and deselected at the end of the transaction.
+ */
+struct SPITransaction {
+  /**
+   * @brief   Configuration used for the transaction.
+   * @note    The configuration callback is not invoked, circular mode is
+   *          not allowed.
+   */
+  const SPIConfig           *config;
+  /**
+   * @brief   Number of frames to be exchanged.
+   */
+  size_t                    n;
+  /**
+   * @brief   Transmit buffer or @p NULL for idle frames.
+   */
+  const void                *txbuf;
+  /**
+   * @brief   Receive buffer or @p NULL if received data is ignored.
+   */
+  void                      *rxbuf;
+  /**
+   * @brief   Transaction end callback or @p NULL.
+   * @note    It is invoked from ISR context after the slave has been
+   *          deselected.
+   */
+  spicallback_t             end_cb;
+};
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -207,6 +265,7 @@ do {                                                                        \
  * @iclass
  */
 #define spiStartIgnoreI(spip, n) {                                          \
+  _spi_pm_lock(spip);                                                       \
   (spip)->state = SPI_ACTIVE;                                               \
   spi_lld_ignore(spip, n);                                                  \
 }
@@ -229,6 +288,7 @@ do {                                                                        \
  * @iclass
  */
 #define spiStartExchangeI(spip, n, txbuf, rxbuf) {                          \
+  _spi_pm_lock(spip);                                                       \
   (spip)->state = SPI_ACTIVE;                                               \
   spi_lld_exchange(spip, n, txbuf, rxbuf);                                  \
 }
@@ -249,6 +309,7 @@ do {                                                                        \
  * @iclass
  */
 #define spiStartSendI(spip, n, txbuf) {                                     \
+  _spi_pm_lock(spip);                                                       \
   (spip)->state = SPI_ACTIVE;                                               \
   spi_lld_send(spip, n, txbuf);                                             \
 }
@@ -269,6 +330,7 @@ do {                                                                        \
  * @iclass
  */
 #define spiStartReceiveI(spip, n, rxbuf) {                                  \
+  _spi_pm_lock(spip);                                                       \
   (spip)->state = SPI_ACTIVE;                                               \
   spi_lld_receive(spip, n, rxbuf);                                          \
 }
@@ -293,6 +355,33 @@ do {                                                                        \
  * @name    Low level driver helper macros
  * @{
  */
+#if (HAL_USE_PM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Forbids the deep sleep depths while a transfer is ongoing.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+#define _spi_pm_lock(spip) pmLockDepthI(PM_DEPTH_SLEEP)
+
+/**
+ * @brief   Releases the lock taken by @p _spi_pm_lock() from ISR context.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+#define _spi_pm_unlock_isr(spip) {                                          \
+  osalSysLockFromISR();                                                     \
+  pmUnlockDepthI(PM_DEPTH_SLEEP);                                           \
+  osalSysUnlockFromISR();                                                   \
+}
+#else /* HAL_USE_PM != TRUE */
+#define _spi_pm_lock(spip)
+#define _spi_pm_unlock_isr(spip)
+#endif /* HAL_USE_PM != TRUE */
+
 #if (SPI_USE_WAIT == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Wakes up the waiting thread.
@@ -316,6 +405,7 @@ do {                                                                        \
  *          - Callback invocation.
  *          - Waiting thread wakeup, if any.
  *          - Driver state transitions.
+ *          - Start of the next queued transaction, if any.
  *          .
  * @note    This macro is meant to be used in the low level drivers
  *          implementation only.
@@ -324,7 +414,28 @@ do {                                                                        \
  *
  * @notapi
  */
+#if (SPI_USE_TRANSACTIONS == TRUE) || defined(__DOXYGEN__)
 #define _spi_isr_code(spip) {                                               \
+  if ((spip)->tcurr != NULL) {                                              \
+    _spi_isr_transactions_code(spip);                                       \
+  }                                                                         \
+  else {                                                                    \
+    _spi_isr_single_code(spip);                                             \
+  }                                                                         \
+}
+#else
+#define _spi_isr_code(spip) _spi_isr_single_code(spip)
+#endif
+
+/**
+ * @brief   Common ISR code for single operations.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+#define _spi_isr_single_code(spip) {                                        \
+  _spi_pm_unlock_isr(spip);                                                 \
   if ((spip)->config->end_cb) {                                             \
     (spip)->state = SPI_COMPLETE;                                           \
     (spip)->config->end_cb(spip);                                           \
@@ -373,6 +484,9 @@ do {                                                                        \
     (spip)->config->end_cb(spip);                                           \
     if ((spip)->state == SPI_COMPLETE)                                      \
       (spip)->state = SPI_ACTIVE;                                           \
+    else if ((spip)->state == SPI_READY) {                                  \
+      _spi_pm_unlock_isr(spip);                                             \
+    }                                                                       \
   }                                                                         \
 }
 /** @} */
@@ -409,6 +523,16 @@ extern "C" {
   void spiAcquireBus(SPIDriver *spip);
   void spiReleaseBus(SPIDriver *spip);
 #endif
+#if SPI_USE_TRANSACTIONS == TRUE
+  void spiStartTransactionsI(SPIDriver *spip,
+                             const SPITransaction *tp, size_t n);
+  void spiStartTransactions(SPIDriver *spip,
+                            const SPITransaction *tp, size_t n);
+#if SPI_USE_WAIT == TRUE
+  void spiTransactions(SPIDriver *spip, const SPITransaction *tp, size_t n);
+#endif
+  void _spi_isr_transactions_code(SPIDriver *spip);
+#endif
 #ifdef __cplusplus
 }
 #endif
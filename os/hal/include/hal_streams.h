@@ -22,7 +22,8 @@
  *
  * @addtogroup HAL_STREAMS
  * @details This module define an abstract interface for generic data streams.
- *          Note that no code is present, just abstract interfaces-like
+ *          Note that no code is present except default implementations
+ *          of the optional methods, just abstract interfaces-like
  *          structures, you should look at the system as to a set of
  *          abstract C++ classes (even if written in C). This system
  *          has then advantage to make the access to data streams
@@ -44,6 +45,16 @@
 #define STM_RESET            MSG_RESET
 /** @} */
 
+/**
+ * @brief   Type of a stream I/O vector element.
+ */
+typedef struct {
+  /** @brief Pointer to the data buffer.*/
+  const uint8_t         *bp;
+  /** @brief Size of the data buffer.*/
+  size_t                n;
+} stream_iovec_t;
+
 /**
  * @brief   BaseSequentialStream specific methods.
  */
@@ -57,6 +68,12 @@
   msg_t (*put)(void *instance, uint8_t b);                                  \
   /* Channel get method, blocking.*/                                        \
   msg_t (*get)(void *instance);                                             \
+  /* Stream vectored write method.*/                                        \
+  size_t (*writev)(void *instance, const stream_iovec_t *iov, size_t n);    \
+  /* Stream get read buffer method, blocking.*/                             \
+  const uint8_t *(*getrbuf)(void *instance, size_t *np);                    \
+  /* Stream release read buffer method.*/                                   \
+  void (*relrbuf)(void *instance, size_t n);                                \
 
 /**
  * @brief   @p BaseSequentialStream specific data.
@@ -149,8 +166,85 @@ typedef struct {
  * @api
  */
 #define streamGet(ip) ((ip)->vmt->get(ip))
+
+/**
+ * @brief   Sequential Stream vectored write.
+ * @details The function writes data from a list of buffers to a stream
+ *          as a single operation, streams without a native implementation
+ *          use @p streamDefaultWriteV() which writes the buffers in
+ *          sequence.
+ *
+ * @param[in] ip        pointer to a @p BaseSequentialStream or derived class
+ * @param[in] iov       pointer to an array of @p stream_iovec_t elements
+ * @param[in] n         number of elements in the array
+ * @return              The number of bytes transferred. The return value can
+ *                      be less than the total size of the buffers if an
+ *                      end-of-file condition has been met.
+ *
+ * @api
+ */
+#define streamWriteV(ip, iov, n) ((ip)->vmt->writev(ip, iov, n))
+
+/**
+ * @brief   Sequential Stream get read buffer.
+ * @details The function returns a pointer to the data available in the
+ *          stream internal buffers without copying it, the data must be
+ *          consumed using @p streamReleaseReadBuffer(). If no data is
+ *          available then the calling thread is suspended.
+ * @note    Streams without internal buffers always return @p NULL, use
+ *          @p streamHasReadBuffer() in order to fall back to
+ *          @p streamRead().
+ *
+ * @param[in] ip        pointer to a @p BaseSequentialStream or derived class
+ * @param[out] np       pointer to a variable receiving the number of
+ *                      contiguous bytes available in the buffer
+ * @return              A pointer to the available data.
+ * @retval NULL         if an end-of-file condition has been met or the
+ *                      stream has no internal buffers.
+ *
+ * @api
+ */
+#define streamGetReadBuffer(ip, np) ((ip)->vmt->getrbuf(ip, np))
+
+/**
+ * @brief   Sequential Stream release read buffer.
+ * @details The function consumes data previously obtained using
+ *          @p streamGetReadBuffer().
+ *
+ * @param[in] ip        pointer to a @p BaseSequentialStream or derived class
+ * @param[in] n         number of bytes consumed, it must not exceed the
+ *                      size returned by @p streamGetReadBuffer()
+ *
+ * @api
+ */
+#define streamReleaseReadBuffer(ip, n) ((ip)->vmt->relrbuf(ip, n))
+
+/**
+ * @brief   Checks if a stream supports the zero-copy read buffer methods.
+ *
+ * @param[in] ip        pointer to a @p BaseSequentialStream or derived class
+ * @return              The read buffer support status.
+ *
+ * @xclass
+ */
+#define streamHasReadBuffer(ip)                                             \
+  ((ip)->vmt->getrbuf != streamDefaultGetReadBuffer)
 /** @} */
 
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  size_t streamDefaultWriteV(void *ip, const stream_iovec_t *iov, size_t n);
+  const uint8_t *streamDefaultGetReadBuffer(void *ip, size_t *np);
+  void streamDefaultReleaseReadBuffer(void *ip, size_t n);
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* HAL_STREAMS_H */
 
 /** @} */
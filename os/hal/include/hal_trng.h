@@ -35,10 +35,39 @@
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @name    TRNG configuration options
+ * @{
+ */
+/**
+ * @brief   Enables the DRBG stretching layer.
+ * @details If set to @p TRUE the data returned by @p trngGenerate() is
+ *          produced by a ChaCha20 based generator with fast key erasure,
+ *          periodically reseeded from the hardware.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(TRNG_USE_DRBG) || defined(__DOXYGEN__)
+#define TRNG_USE_DRBG                       FALSE
+#endif
+
+/**
+ * @brief   DRBG reseed interval.
+ * @details Number of output bytes after which the DRBG key is mixed with
+ *          new hardware entropy.
+ */
+#if !defined(TRNG_DRBG_RESEED_INTERVAL) || defined(__DOXYGEN__)
+#define TRNG_DRBG_RESEED_INTERVAL           1024
+#endif
+/** @} */
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if TRNG_DRBG_RESEED_INTERVAL < 32
+#error "invalid TRNG_DRBG_RESEED_INTERVAL value"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -58,8 +87,61 @@ typedef enum {
  */
 typedef struct TRNGDriver TRNGDriver;
 
+#if (TRNG_USE_DRBG == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a DRBG state.
+ */
+typedef struct {
+  /**
+   * @brief   Current ChaCha20 key.
+   */
+  uint32_t                  key[8];
+  /**
+   * @brief   Output of the last generated block.
+   */
+  uint8_t                   buf[32];
+  /**
+   * @brief   Number of unused bytes at the end of @p buf.
+   */
+  size_t                    avail;
+  /**
+   * @brief   Bytes produced since the last reseed.
+   */
+  size_t                    count;
+  /**
+   * @brief   The generator has been seeded.
+   */
+  bool                      seeded;
+} trngdrbg_t;
+#endif
+
 #include "hal_trng_lld.h"
 
+/**
+ * @brief   Structure representing a TRNG driver.
+ */
+struct TRNGDriver {
+  /**
+   * @brief Driver state.
+   */
+  trngstate_t                state;
+  /**
+   * @brief Current configuration data.
+   */
+  const TRNGConfig           *config;
+#if (TRNG_USE_DRBG == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   DRBG state.
+   */
+  trngdrbg_t                 drbg;
+#endif
+#if defined(TRNG_DRIVER_EXT_FIELDS)
+  TRNG_DRIVER_EXT_FIELDS
+#endif
+  /* End of the mandatory fields.*/
+  _trng_lld_driver_fields
+};
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -73,6 +73,17 @@
 #if !defined(UART_USE_MUTUAL_EXCLUSION) || defined(__DOXYGEN__)
 #define UART_USE_MUTUAL_EXCLUSION           FALSE
 #endif
+
+/**
+ * @brief   Enables the circular receive APIs.
+ * @details In circular mode the receiver continuously fills a rolling
+ *          buffer, the received data is delivered on line idle, on buffer
+ *          half and full and on character match instead of per frame.
+ * @note    The feature must be supported by the low level driver.
+ */
+#if !defined(UART_USE_RX_CIRCULAR) || defined(__DOXYGEN__)
+#define UART_USE_RX_CIRCULAR                FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -107,11 +118,16 @@ typedef enum {
 typedef enum {
   UART_RX_IDLE = 0,                 /**< Not receiving.                     */
   UART_RX_ACTIVE = 1,               /**< Receiving.                         */
-  UART_RX_COMPLETE = 2              /**< Buffer complete.                   */
+  UART_RX_COMPLETE = 2,             /**< Buffer complete.                   */
+  UART_RX_CIRCULAR = 3              /**< Receiving in circular mode.        */
 } uartrxstate_t;
 
 #include "hal_uart_lld.h"
 
+#if (UART_USE_RX_CIRCULAR == TRUE) && !defined(UART_LLD_SUPPORTS_RX_CIRCULAR)
+#error "UART_USE_RX_CIRCULAR not supported by the low level driver"
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -402,6 +418,10 @@ extern "C" {
   void uartStartReceiveI(UARTDriver *uartp, size_t n, void *rxbuf);
   size_t uartStopReceive(UARTDriver *uartp);
   size_t uartStopReceiveI(UARTDriver *uartp);
+#if UART_USE_RX_CIRCULAR == TRUE
+  void uartStartReceiveCircular(UARTDriver *uartp, size_t n, void *rxbuf);
+  void uartStartReceiveCircularI(UARTDriver *uartp, size_t n, void *rxbuf);
+#endif
 #if UART_USE_WAIT == TRUE
   msg_t uartSendTimeout(UARTDriver *uartp, size_t *np,
                         const void *txbuf, sysinterval_t timeout);
@@ -409,6 +429,10 @@ extern "C" {
                             const void *txbuf, sysinterval_t timeout);
   msg_t uartReceiveTimeout(UARTDriver *uartp, size_t *np,
                            void *rxbuf, sysinterval_t timeout);
+#if UART_USE_RX_CIRCULAR == TRUE
+  msg_t uartReceiveCircularTimeout(UARTDriver *uartp, size_t *np,
+                                   void *rxbuf, sysinterval_t timeout);
+#endif
 #endif
 #if UART_USE_MUTUAL_EXCLUSION == TRUE
   void uartAcquireBus(UARTDriver *uartp);
@@ -0,0 +1,361 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_usbh.h
+ * @brief   USB Host Driver macros and structures.
+ *
+ * @addtogroup USBH
+ * @{
+ */
+
+#ifndef HAL_USBH_H
+#define HAL_USBH_H
+
+#if (HAL_USE_USBH == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Address assigned to the attached device.
+ */
+#define USBH_DEVICE_ADDRESS                 1U
+
+/**
+ * @brief   Size of the device descriptor buffer.
+ */
+#define USBH_DEVICE_BUFFER_SIZE             64U
+
+/**
+ * @name    Standard requests, types and descriptors
+ * @{
+ */
+#define USBH_RTYPE_HOST2DEV                 0x00U
+#define USBH_RTYPE_DEV2HOST                 0x80U
+#define USBH_RTYPE_STANDARD                 0x00U
+#define USBH_RTYPE_CLASS                    0x20U
+#define USBH_RTYPE_DEVICE                   0x00U
+#define USBH_RTYPE_INTERFACE                0x01U
+#define USBH_RTYPE_ENDPOINT                 0x02U
+
+#define USBH_REQ_CLEAR_FEATURE              1U
+#define USBH_REQ_SET_ADDRESS                5U
+#define USBH_REQ_GET_DESCRIPTOR             6U
+#define USBH_REQ_SET_CONFIGURATION          9U
+
+#define USBH_DT_DEVICE                      1U
+#define USBH_DT_CONFIGURATION               2U
+#define USBH_DT_INTERFACE                   4U
+#define USBH_DT_ENDPOINT                    5U
+
+#define USBH_FEATURE_ENDPOINT_HALT          0U
+/** @} */
+
+/**
+ * @name    Endpoint types
+ * @{
+ */
+#define USBH_EPTYPE_CTRL                    0U
+#define USBH_EPTYPE_ISOC                    1U
+#define USBH_EPTYPE_BULK                    2U
+#define USBH_EPTYPE_INTR                    3U
+/** @} */
+
+/**
+ * @name    Endpoint address direction bit
+ * @{
+ */
+#define USBH_EP_IN                          0x80U
+/** @} */
+
+/**
+ * @name    Event flags
+ * @{
+ */
+#define USBH_EVENT_CONNECTED                (eventflags_t)1
+#define USBH_EVENT_DISCONNECTED             (eventflags_t)2
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    USBH configuration options
+ * @{
+ */
+/**
+ * @brief   Configuration descriptor buffer size.
+ * @details Devices with a larger configuration descriptor are refused.
+ * @note    Must be a multiple of 64.
+ */
+#if !defined(USBH_CONFIG_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define USBH_CONFIG_BUFFER_SIZE             256
+#endif
+
+/**
+ * @brief   Timeout of control requests in milliseconds.
+ */
+#if !defined(USBH_CONTROL_TIMEOUT) || defined(__DOXYGEN__)
+#define USBH_CONTROL_TIMEOUT                500
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (USBH_CONFIG_BUFFER_SIZE < 64) || ((USBH_CONFIG_BUFFER_SIZE % 64) != 0)
+#error "USBH_CONFIG_BUFFER_SIZE must be a non-zero multiple of 64"
+#endif
+
+#if USBH_CONTROL_TIMEOUT < 1
+#error "invalid USBH_CONTROL_TIMEOUT value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a structure representing an USB host driver.
+ */
+typedef struct USBHDriver USBHDriver;
+
+/**
+ * @brief   Type of a structure representing a pipe to a device endpoint.
+ */
+typedef struct USBHPipe USBHPipe;
+
+/**
+ * @brief   Type of a structure representing an USB request block.
+ */
+typedef struct USBHURB USBHURB;
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  USBH_UNINIT = 0,                  /**< Not initialized.                   */
+  USBH_STOP = 1,                    /**< Stopped.                           */
+  USBH_READY = 2,                   /**< Ready, no device configured.       */
+  USBH_ACTIVE = 3                   /**< Device configured.                 */
+} usbhstate_t;
+
+/**
+ * @brief   Attached device speed.
+ */
+typedef enum {
+  USBH_SPEED_LOW = 0,               /**< Low speed.                         */
+  USBH_SPEED_FULL = 1,              /**< Full speed.                        */
+  USBH_SPEED_HIGH = 2               /**< High speed.                        */
+} usbhspeed_t;
+
+/**
+ * @brief   URB status.
+ */
+typedef enum {
+  USBH_URB_IDLE = 0,                /**< Never submitted.                   */
+  USBH_URB_PENDING = 1,             /**< Submitted, not yet completed.      */
+  USBH_URB_OK = 2,                  /**< Completed.                         */
+  USBH_URB_STALL = 3,               /**< Endpoint stalled.                  */
+  USBH_URB_ERROR = 4,               /**< Transaction error.                 */
+  USBH_URB_ABORTED = 5              /**< Not executed or interrupted.       */
+} usbhurbstatus_t;
+
+/**
+ * @brief   URB data PID.
+ */
+typedef enum {
+  USBH_PID_TOGGLE = 0,              /**< Current toggle of the pipe.        */
+  USBH_PID_DATA0 = 1,               /**< Forced DATA0.                      */
+  USBH_PID_DATA1 = 2,               /**< Forced DATA1.                      */
+  USBH_PID_SETUP = 3                /**< SETUP packet.                      */
+} usbhpid_t;
+
+/**
+ * @brief   Structure representing an USB request block.
+ * @details URBs can be linked in chains, a chain is executed as a whole
+ *          by the low level driver without returning to the calling
+ *          thread between URBs.
+ */
+struct USBHURB {
+  /**
+   * @brief   Next URB in the chain or @p NULL.
+   */
+  USBHURB                   *next;
+  /**
+   * @brief   Pipe used by the URB.
+   */
+  USBHPipe                  *pipe;
+  /**
+   * @brief   Data PID.
+   */
+  usbhpid_t                 pid;
+  /**
+   * @brief   Data buffer.
+   * @note    The buffer must be word aligned, IN buffers must be large
+   *          enough for an integral number of packets.
+   */
+  uint8_t                   *buf;
+  /**
+   * @brief   Requested transfer size.
+   */
+  size_t                    size;
+  /**
+   * @brief   Transferred bytes.
+   */
+  size_t                    actual;
+  /**
+   * @brief   URB status.
+   */
+  usbhurbstatus_t           status;
+};
+
+#include "hal_usbh_lld.h"
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Returns the driver state.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @return              The driver state.
+ *
+ * @iclass
+ */
+#define usbhGetDriverStateI(usbhp) ((usbhp)->state)
+
+/**
+ * @brief   Returns the speed of the attached device.
+ * @note    The value is valid after a successful @p usbhConnect().
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @return              The device speed.
+ *
+ * @xclass
+ */
+#define usbhGetSpeedX(usbhp) ((usbhp)->speed)
+
+/**
+ * @brief   Determines if a device is attached to the port.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @return              The attach status.
+ *
+ * @xclass
+ */
+#define usbhIsConnectedX(usbhp) usbh_lld_is_connected(usbhp)
+
+/**
+ * @brief   Returns a pointer to the driver event source.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @return              The pointer to the event source.
+ *
+ * @xclass
+ */
+#define usbhGetEventSource(usbhp) (&(usbhp)->event)
+
+/**
+ * @brief   Returns a pointer to the device descriptor.
+ * @note    The descriptor is valid in the @p USBH_ACTIVE state.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @return              The pointer to the device descriptor.
+ *
+ * @xclass
+ */
+#define usbhGetDeviceDescriptorX(usbhp) ((const uint8_t *)(usbhp)->devbuf)
+
+/**
+ * @brief   Returns a pointer to the configuration descriptor.
+ * @details The whole configuration descriptor is returned including the
+ *          interface and endpoint descriptors.
+ * @note    The descriptor is valid in the @p USBH_ACTIVE state.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @return              The pointer to the configuration descriptor.
+ *
+ * @xclass
+ */
+#define usbhGetConfigDescriptorX(usbhp) ((const uint8_t *)(usbhp)->cfgbuf)
+
+/**
+ * @brief   Returns the total size of the configuration descriptor.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @return              The value of the @p wTotalLength field.
+ *
+ * @xclass
+ */
+#define usbhGetConfigSizeX(usbhp)                                           \
+  ((size_t)usbhGetConfigDescriptorX(usbhp)[2] |                             \
+   ((size_t)usbhGetConfigDescriptorX(usbhp)[3] << 8))
+
+/**
+ * @brief   Links an URB to the next URB of a chain.
+ *
+ * @param[in] urbp      pointer to the @p USBHURB object
+ * @param[in] nextp     pointer to the next @p USBHURB object or @p NULL
+ *
+ * @xclass
+ */
+#define usbhURBLinkX(urbp, nextp) ((urbp)->next = (nextp))
+/** @} */
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void usbhInit(void);
+  void usbhObjectInit(USBHDriver *usbhp);
+  void usbhStart(USBHDriver *usbhp, const USBHConfig *config);
+  void usbhStop(USBHDriver *usbhp);
+  msg_t usbhConnect(USBHDriver *usbhp, sysinterval_t timeout);
+  bool usbhOpenPipe(USBHDriver *usbhp, USBHPipe *pipe, uint8_t epaddr,
+                    uint8_t type, uint16_t mps);
+  void usbhClosePipe(USBHDriver *usbhp, USBHPipe *pipe);
+  void usbhURBObjectInit(USBHURB *urbp, USBHPipe *pipe, usbhpid_t pid,
+                         uint8_t *buf, size_t size);
+  msg_t usbhTransfer(USBHDriver *usbhp, USBHURB *urbp, sysinterval_t timeout);
+  msg_t usbhControlRequest(USBHDriver *usbhp, uint8_t rtype, uint8_t req,
+                           uint16_t value, uint16_t index, uint16_t length,
+                           uint8_t *buf);
+  msg_t usbhClearHalt(USBHDriver *usbhp, USBHPipe *pipe);
+  void _usbh_connected_i(USBHDriver *usbhp);
+  void _usbh_disconnected_i(USBHDriver *usbhp);
+  void _usbh_complete_i(USBHDriver *usbhp, msg_t msg);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_USBH == TRUE */
+
+#endif /* HAL_USBH_H */
+
+/** @} */
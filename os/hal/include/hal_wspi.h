@@ -126,6 +126,10 @@ typedef struct {
 #error "low level does not define WSPI_SUPPORTS_MEMMAP"
 #endif
 
+#if !defined(WSPI_SUPPORTS_POLLING)
+#error "low level does not define WSPI_SUPPORTS_POLLING"
+#endif
+
 #if !defined(WSPI_DEFAULT_CFG_MASKS)
 #error "low level does not define WSPI_DEFAULT_CFG_MASKS"
 #endif
@@ -269,6 +273,35 @@ typedef struct {
   wspi_lld_receive(wspip, cmdp, n, rxbuf);                                  \
 }
 
+#if (WSPI_SUPPORTS_POLLING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Polls data from the WSPI bus until a match.
+ * @details This asynchronous function starts an automatic polling
+ *          operation, the command is repeated by the hardware until the
+ *          received data masked by @p mask is equal to @p match.
+ * @post    At the end of the operation the configured callback is invoked.
+ * @note    The first received byte is the least significant byte of
+ *          @p mask and @p match.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[in] n         number of bytes to receive, from 1 to 4
+ * @param[in] mask      mask of the compared bits
+ * @param[in] match     expected value of the compared bits
+ * @param[out] rxbuf    the pointer to the buffer receiving the matched
+ *                      data or @p NULL
+ *
+ * @iclass
+ */
+#define wspiStartPollI(wspip, cmdp, n, mask, match, rxbuf) {                \
+  osalDbgAssert(((cmdp)->cfg & WSPI_CFG_DATA_MODE_MASK) !=                  \
+                WSPI_CFG_DATA_MODE_NONE,                                    \
+                "data mode required");                                      \
+  (wspip)->state = WSPI_ACTIVE;                                             \
+  wspi_lld_poll(wspip, cmdp, n, mask, match, rxbuf);                        \
+}
+#endif /* WSPI_SUPPORTS_POLLING == TRUE */
+
 #if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Maps in memory space a WSPI flash device.
@@ -363,12 +396,21 @@ extern "C" {
                      size_t n, const uint8_t *txbuf);
   void wspiStartReceive(WSPIDriver *wspip, const wspi_command_t *cmdp,
                         size_t n, uint8_t *rxbuf);
+#if WSPI_SUPPORTS_POLLING == TRUE
+  void wspiStartPoll(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                     size_t n, uint32_t mask, uint32_t match,
+                     uint8_t *rxbuf);
+#endif
 #if WSPI_USE_WAIT == TRUE
   void wspiCommand(WSPIDriver *wspip, const wspi_command_t *cmdp);
   void wspiSend(WSPIDriver *wspip, const wspi_command_t *cmdp,
                 size_t n, const uint8_t *txbuf);
   void wspiReceive(WSPIDriver *wspip, const wspi_command_t *cmdp,
                    size_t n, uint8_t *rxbuf);
+#if WSPI_SUPPORTS_POLLING == TRUE
+  void wspiPoll(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                size_t n, uint32_t mask, uint32_t match, uint8_t *rxbuf);
+#endif
 #endif
 #if WSPI_SUPPORTS_MEMMAP == TRUE
 void wspiMapFlash(WSPIDriver *wspip,
@@ -0,0 +1,624 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_block_cache.c
+ * @brief   Block devices cache module code.
+ * @details This module implements a block device stacked on another block
+ *          device, it adds a LRU blocks cache with an optional write-back
+ *          policy. Adjacent missing blocks are read using multi-block
+ *          transfers and dirty blocks are written back in ascending order
+ *          merging adjacent blocks into multi-block transfers.
+ *
+ * @addtogroup HAL_BLOCK_CACHE
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "hal_block_cache.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the data buffer of a slot.
+ */
+#define BC_SLOT_BUFFER(bcp, sp)                                             \
+  ((bcp)->config->buffer +                                                  \
+   ((size_t)((sp) - (bcp)->config->slots) * (size_t)BC_CFG_BLOCK_SIZE))
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+static bool bc_is_inserted(void *instance);
+static bool bc_is_protected(void *instance);
+
+/**
+ * @brief   Virtual methods table.
+ */
+static const struct BlockCacheDriverVMT bc_vmt = {
+  (size_t)0,
+  bc_is_inserted,
+  bc_is_protected,
+  (bool (*)(void *))bcConnect,
+  (bool (*)(void *))bcDisconnect,
+  (bool (*)(void *, uint32_t, uint8_t *, uint32_t))bcRead,
+  (bool (*)(void *, uint32_t, const uint8_t *, uint32_t))bcWrite,
+  (bool (*)(void *))bcSync,
+  (bool (*)(void *, BlockDeviceInfo *))bcGetInfo
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static bool bc_is_inserted(void *instance) {
+  BlockCacheDriver *bcp = (BlockCacheDriver *)instance;
+
+  return blkIsInserted(bcp->config->bdp);
+}
+
+static bool bc_is_protected(void *instance) {
+  BlockCacheDriver *bcp = (BlockCacheDriver *)instance;
+
+  return blkIsWriteProtected(bcp->config->bdp);
+}
+
+/**
+ * @brief   Searches a block in the cache.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @param[in] blk       block number
+ * @return              The slot containing the block or @p NULL.
+ *
+ * @notapi
+ */
+static bc_slot_t *bc_lookup(BlockCacheDriver *bcp, uint32_t blk) {
+  bc_slot_t *sp;
+
+  for (sp = bcp->config->slots;
+       sp < &bcp->config->slots[bcp->config->nslots];
+       sp++) {
+    if (((sp->flags & BC_SLOT_VALID) != 0U) && (sp->blk == blk)) {
+      return sp;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Marks a slot as most recently used.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @param[in] sp        pointer to the slot
+ *
+ * @notapi
+ */
+static void bc_touch(BlockCacheDriver *bcp, bc_slot_t *sp) {
+
+  sp->stamp = ++bcp->stamp;
+}
+
+/**
+ * @brief   Writes back all the dirty slots.
+ * @details Dirty slots are written in ascending blocks order in a single
+ *          sweep, adjacent blocks are gathered in the merge buffer and
+ *          written using a single multi-block transfer.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed, the failed slots are still dirty.
+ *
+ * @notapi
+ */
+static bool bc_flush(BlockCacheDriver *bcp) {
+  const BlockCacheConfig *config = bcp->config;
+  uint32_t next = 0U;
+
+  while (true) {
+    bc_slot_t *sp, *first = NULL;
+    const uint8_t *wp;
+    uint32_t i, n;
+
+    /* Next dirty block in the current sweep.*/
+    for (sp = config->slots; sp < &config->slots[config->nslots]; sp++) {
+      if (((sp->flags & BC_SLOT_DIRTY) != 0U) && (sp->blk >= next) &&
+          ((first == NULL) || (sp->blk < first->blk))) {
+        first = sp;
+      }
+    }
+    if (first == NULL) {
+      return HAL_SUCCESS;
+    }
+
+    /* Gathering adjacent dirty blocks.*/
+    n  = 1U;
+    wp = BC_SLOT_BUFFER(bcp, first);
+    if ((config->mbuffer != NULL) && (config->mblocks > 1U)) {
+      while (n < config->mblocks) {
+        sp = bc_lookup(bcp, first->blk + n);
+        if ((sp == NULL) || ((sp->flags & BC_SLOT_DIRTY) == 0U)) {
+          break;
+        }
+        if (n == 1U) {
+          memcpy(config->mbuffer, wp, BC_CFG_BLOCK_SIZE);
+          wp = config->mbuffer;
+        }
+        memcpy(config->mbuffer + (n * BC_CFG_BLOCK_SIZE),
+               BC_SLOT_BUFFER(bcp, sp), BC_CFG_BLOCK_SIZE);
+        n++;
+      }
+    }
+
+    if (blkWrite(config->bdp, first->blk, wp, n) != HAL_SUCCESS) {
+      return HAL_FAILED;
+    }
+
+    for (i = 0U; i < n; i++) {
+      bc_lookup(bcp, first->blk + i)->flags &= ~BC_SLOT_DIRTY;
+    }
+    next = first->blk + n;
+  }
+}
+
+/**
+ * @brief   Allocates a slot for a block.
+ * @details A free slot is used if available else the least recently used
+ *          one is reused, dirty slots are written back before reuse.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @param[in] blk       block number
+ * @return              The allocated slot or @p NULL if the write back
+ *                      failed.
+ *
+ * @notapi
+ */
+static bc_slot_t *bc_alloc(BlockCacheDriver *bcp, uint32_t blk) {
+  bc_slot_t *sp, *victim = NULL;
+
+  for (sp = bcp->config->slots;
+       sp < &bcp->config->slots[bcp->config->nslots];
+       sp++) {
+    if ((sp->flags & BC_SLOT_VALID) == 0U) {
+      victim = sp;
+      break;
+    }
+    if ((victim == NULL) || ((int32_t)(sp->stamp - victim->stamp) < 0)) {
+      victim = sp;
+    }
+  }
+
+  /* All the dirty slots are written back together, this is more efficient
+     because adjacent blocks are merged.*/
+  if ((victim->flags & BC_SLOT_DIRTY) != 0U) {
+    if (bc_flush(bcp) != HAL_SUCCESS) {
+      return NULL;
+    }
+  }
+
+  victim->blk   = blk;
+  victim->flags = BC_SLOT_VALID;
+  bc_touch(bcp, victim);
+
+  return victim;
+}
+
+/**
+ * @brief   Updates the cached copies of the specified blocks.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @param[in] startblk  first block
+ * @param[in] buf       pointer to the blocks data
+ * @param[in] n         number of blocks
+ * @param[in] insert    missing blocks are also inserted if @p true
+ *
+ * @notapi
+ */
+static void bc_update(BlockCacheDriver *bcp, uint32_t startblk,
+                      const uint8_t *buf, uint32_t n, bool insert) {
+  uint32_t i;
+
+  for (i = 0U; i < n; i++) {
+    bc_slot_t *sp = bc_lookup(bcp, startblk + i);
+
+    if (sp != NULL) {
+      sp->flags &= ~BC_SLOT_DIRTY;
+      bc_touch(bcp, sp);
+    }
+    else if (insert) {
+      sp = bc_alloc(bcp, startblk + i);
+      if (sp == NULL) {
+        continue;
+      }
+    }
+    else {
+      continue;
+    }
+    memcpy(BC_SLOT_BUFFER(bcp, sp), buf + (i * BC_CFG_BLOCK_SIZE),
+           BC_CFG_BLOCK_SIZE);
+  }
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ *
+ * @param[out] bcp      pointer to the @p BlockCacheDriver object
+ *
+ * @init
+ */
+void bcObjectInit(BlockCacheDriver *bcp) {
+
+  osalDbgCheck(bcp != NULL);
+
+  bcp->vmt    = &bc_vmt;
+  bcp->state  = BLK_STOP;
+  bcp->config = NULL;
+  bcp->stamp  = 0U;
+}
+
+/**
+ * @brief   Configures and activates the block cache.
+ * @note    The underlying block device must be already started.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @param[in] config    pointer to the configuration
+ *
+ * @api
+ */
+void bcStart(BlockCacheDriver *bcp, const BlockCacheConfig *config) {
+
+  osalDbgCheck((bcp != NULL) && (config != NULL) && (config->bdp != NULL) &&
+               (config->slots != NULL) && (config->buffer != NULL) &&
+               (config->nslots > 0U));
+  osalDbgAssert((bcp->state == BLK_STOP) || (bcp->state == BLK_ACTIVE),
+                "invalid state");
+
+  bcp->config = config;
+  bcInvalidate(bcp);
+  bcp->state  = BLK_ACTIVE;
+}
+
+/**
+ * @brief   Deactivates the block cache.
+ * @note    Dirty blocks are not written back, the cache must be
+ *          disconnected before stopping it.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ *
+ * @api
+ */
+void bcStop(BlockCacheDriver *bcp) {
+
+  osalDbgCheck(bcp != NULL);
+  osalDbgAssert((bcp->state == BLK_STOP) || (bcp->state == BLK_ACTIVE),
+                "invalid state");
+
+  bcp->state = BLK_STOP;
+}
+
+/**
+ * @brief   Connects the underlying device.
+ * @details The cache is invalidated.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool bcConnect(BlockCacheDriver *bcp) {
+  BlockDeviceInfo bdi;
+
+  osalDbgCheck(bcp != NULL);
+  osalDbgAssert((bcp->state == BLK_ACTIVE) || (bcp->state == BLK_READY),
+                "invalid state");
+
+  /* Connection procedure in progress.*/
+  bcp->state = BLK_CONNECTING;
+  bcInvalidate(bcp);
+
+  if ((blkConnect(bcp->config->bdp) != HAL_SUCCESS) ||
+      (blkGetInfo(bcp->config->bdp, &bdi) != HAL_SUCCESS) ||
+      (bdi.blk_size != BC_CFG_BLOCK_SIZE)) {
+    bcp->state = BLK_ACTIVE;
+    return HAL_FAILED;
+  }
+
+  bcp->state = BLK_READY;
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Disconnects the underlying device.
+ * @details Dirty blocks are written back before disconnecting.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool bcDisconnect(BlockCacheDriver *bcp) {
+  bool result;
+
+  osalDbgCheck(bcp != NULL);
+  osalDbgAssert((bcp->state == BLK_ACTIVE) || (bcp->state == BLK_READY),
+                "invalid state");
+
+  /* Checks if already disconnected.*/
+  if (bcp->state == BLK_ACTIVE) {
+    return HAL_SUCCESS;
+  }
+
+  /* Disconnection procedure in progress.*/
+  bcp->state = BLK_DISCONNECTING;
+  result = bc_flush(bcp);
+  if (blkDisconnect(bcp->config->bdp) != HAL_SUCCESS) {
+    result = HAL_FAILED;
+  }
+  bcInvalidate(bcp);
+  bcp->state = BLK_ACTIVE;
+
+  return result;
+}
+
+/**
+ * @brief   Reads one or more blocks.
+ * @details Cached blocks are copied from the cache, runs of adjacent
+ *          missing blocks are read using single multi-block transfers.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @param[in] startblk  first block to read
+ * @param[out] buf      pointer to the read buffer
+ * @param[in] n         number of blocks to read
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool bcRead(BlockCacheDriver *bcp, uint32_t startblk,
+            uint8_t *buf, uint32_t n) {
+  uint32_t i = 0U;
+  bool result = HAL_SUCCESS;
+
+  osalDbgCheck((bcp != NULL) && (buf != NULL) && (n > 0U));
+  osalDbgAssert(bcp->state == BLK_READY, "invalid state");
+
+  /* Read operation in progress.*/
+  bcp->state = BLK_READING;
+
+  while (i < n) {
+    bc_slot_t *sp = bc_lookup(bcp, startblk + i);
+    uint32_t j;
+
+    if (sp != NULL) {
+      /* Cache hit.*/
+      memcpy(buf + (i * BC_CFG_BLOCK_SIZE), BC_SLOT_BUFFER(bcp, sp),
+             BC_CFG_BLOCK_SIZE);
+      bc_touch(bcp, sp);
+      i++;
+      continue;
+    }
+
+    /* Run of missing blocks, read in a single transfer.*/
+    j = i + 1U;
+    while ((j < n) && (bc_lookup(bcp, startblk + j) == NULL)) {
+      j++;
+    }
+    if (blkRead(bcp->config->bdp, startblk + i,
+                buf + (i * BC_CFG_BLOCK_SIZE), j - i) != HAL_SUCCESS) {
+      result = HAL_FAILED;
+      break;
+    }
+
+    /* Small transfers are cached.*/
+    if (n <= BC_CFG_CACHE_THRESHOLD) {
+      bc_update(bcp, startblk + i, buf + (i * BC_CFG_BLOCK_SIZE),
+                j - i, true);
+    }
+    i = j;
+  }
+
+  bcp->state = BLK_READY;
+  return result;
+}
+
+/**
+ * @brief   Writes one or more blocks.
+ * @details Small writes are performed on the cache if the write-back
+ *          policy is enabled, large writes are performed on the device
+ *          using a single multi-block transfer.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @param[in] startblk  first block to write
+ * @param[in] buf       pointer to the write buffer
+ * @param[in] n         number of blocks to write
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool bcWrite(BlockCacheDriver *bcp, uint32_t startblk,
+             const uint8_t *buf, uint32_t n) {
+  bool result = HAL_SUCCESS;
+
+  osalDbgCheck((bcp != NULL) && (buf != NULL) && (n > 0U));
+  osalDbgAssert(bcp->state == BLK_READY, "invalid state");
+
+  /* Write operation in progress.*/
+  bcp->state = BLK_WRITING;
+
+#if BC_CFG_WRITE_BACK == TRUE
+  if (n <= BC_CFG_CACHE_THRESHOLD) {
+    uint32_t i;
+
+    for (i = 0U; i < n; i++) {
+      bc_slot_t *sp = bc_lookup(bcp, startblk + i);
+
+      if (sp == NULL) {
+        sp = bc_alloc(bcp, startblk + i);
+        if (sp == NULL) {
+          result = HAL_FAILED;
+          break;
+        }
+      }
+      else {
+        bc_touch(bcp, sp);
+      }
+      memcpy(BC_SLOT_BUFFER(bcp, sp), buf + (i * BC_CFG_BLOCK_SIZE),
+             BC_CFG_BLOCK_SIZE);
+      sp->flags |= BC_SLOT_DIRTY;
+    }
+
+    bcp->state = BLK_READY;
+    return result;
+  }
+#endif
+
+  /* Write through, the cached copies are updated after the write.*/
+  result = blkWrite(bcp->config->bdp, startblk, buf, n);
+  if (result == HAL_SUCCESS) {
+    bc_update(bcp, startblk, buf, n, n <= BC_CFG_CACHE_THRESHOLD);
+  }
+
+  bcp->state = BLK_READY;
+  return result;
+}
+
+/**
+ * @brief   Writes back the dirty blocks and synchronizes the device.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool bcSync(BlockCacheDriver *bcp) {
+  bool result;
+
+  osalDbgCheck(bcp != NULL);
+
+  if (bcp->state != BLK_READY) {
+    return HAL_FAILED;
+  }
+
+  /* Synchronization operation in progress.*/
+  bcp->state = BLK_SYNCING;
+
+  result = bc_flush(bcp);
+  if (blkSync(bcp->config->bdp) != HAL_SUCCESS) {
+    result = HAL_FAILED;
+  }
+
+  bcp->state = BLK_READY;
+  return result;
+}
+
+/**
+ * @brief   Returns the media info.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ * @param[out] bdip     pointer to a @p BlockDeviceInfo structure
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool bcGetInfo(BlockCacheDriver *bcp, BlockDeviceInfo *bdip) {
+
+  osalDbgCheck((bcp != NULL) && (bdip != NULL));
+
+  if (bcp->state != BLK_READY) {
+    return HAL_FAILED;
+  }
+
+  return blkGetInfo(bcp->config->bdp, bdip);
+}
+
+/**
+ * @brief   Writes back the dirty blocks.
+ * @details The blocks are kept in the cache.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool bcFlush(BlockCacheDriver *bcp) {
+  bool result;
+
+  osalDbgCheck(bcp != NULL);
+  osalDbgAssert(bcp->state == BLK_READY, "invalid state");
+
+  bcp->state = BLK_WRITING;
+  result = bc_flush(bcp);
+  bcp->state = BLK_READY;
+
+  return result;
+}
+
+/**
+ * @brief   Invalidates the cache.
+ * @note    Dirty blocks are discarded.
+ *
+ * @param[in] bcp       pointer to the @p BlockCacheDriver object
+ *
+ * @api
+ */
+void bcInvalidate(BlockCacheDriver *bcp) {
+  uint32_t i;
+
+  osalDbgCheck((bcp != NULL) && (bcp->config != NULL));
+
+  for (i = 0U; i < bcp->config->nslots; i++) {
+    bcp->config->slots[i].flags = 0U;
+  }
+}
+
+/** @} */
@@ -0,0 +1,216 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_block_cache.h
+ * @brief   Block devices cache module header.
+ *
+ * @addtogroup HAL_BLOCK_CACHE
+ * @{
+ */
+
+#ifndef HAL_BLOCK_CACHE_H
+#define HAL_BLOCK_CACHE_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Cache slot flags
+ * @{
+ */
+#define BC_SLOT_VALID                       0x01U
+#define BC_SLOT_DIRTY                       0x02U
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Size of the blocks of the underlying devices.
+ */
+#if !defined(BC_CFG_BLOCK_SIZE) || defined(__DOXYGEN__)
+#define BC_CFG_BLOCK_SIZE                   512
+#endif
+
+/**
+ * @brief   Enables the write-back policy.
+ * @details If enabled small writes are performed on the cache and written
+ *          to the device on sync, on disconnection or when a dirty slot
+ *          has to be reused. If disabled writes go through the cache.
+ */
+#if !defined(BC_CFG_WRITE_BACK) || defined(__DOXYGEN__)
+#define BC_CFG_WRITE_BACK                   TRUE
+#endif
+
+/**
+ * @brief   Maximum number of blocks of a cached transfer.
+ * @details Larger transfers are performed directly on the device as
+ *          multi-block operations in order to not pollute the cache,
+ *          cached blocks are still used and updated.
+ */
+#if !defined(BC_CFG_CACHE_THRESHOLD) || defined(__DOXYGEN__)
+#define BC_CFG_CACHE_THRESHOLD              2
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (BC_CFG_BLOCK_SIZE < 16) || ((BC_CFG_BLOCK_SIZE % 4) != 0)
+#error "invalid BC_CFG_BLOCK_SIZE value"
+#endif
+
+#if BC_CFG_CACHE_THRESHOLD < 1
+#error "invalid BC_CFG_CACHE_THRESHOLD value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a cache slot descriptor.
+ */
+typedef struct {
+  /**
+   * @brief   Cached block number.
+   */
+  uint32_t                  blk;
+  /**
+   * @brief   Last access stamp.
+   */
+  uint32_t                  stamp;
+  /**
+   * @brief   Slot flags.
+   */
+  uint32_t                  flags;
+} bc_slot_t;
+
+/**
+ * @brief   Type of a block cache configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Underlying block device.
+   */
+  BaseBlockDevice           *bdp;
+  /**
+   * @brief   Array of slot descriptors.
+   */
+  bc_slot_t                 *slots;
+  /**
+   * @brief   Slots data buffer.
+   * @note    The buffer must be word aligned and large enough for
+   *          @p nslots blocks.
+   */
+  uint8_t                   *buffer;
+  /**
+   * @brief   Number of cache slots.
+   */
+  uint32_t                  nslots;
+  /**
+   * @brief   Merge buffer.
+   * @details It is used to gather adjacent dirty blocks into single
+   *          multi-block writes, it can be @p NULL.
+   * @note    The buffer must be word aligned and large enough for
+   *          @p mblocks blocks.
+   */
+  uint8_t                   *mbuffer;
+  /**
+   * @brief   Size of the merge buffer in blocks.
+   */
+  uint32_t                  mblocks;
+} BlockCacheConfig;
+
+/**
+ * @brief   @p BlockCacheDriver specific methods.
+ */
+#define _block_cache_driver_methods                                         \
+  _base_block_device_methods
+
+/**
+ * @extends BaseBlockDeviceVMT
+ *
+ * @brief   @p BlockCacheDriver virtual methods table.
+ */
+struct BlockCacheDriverVMT {
+  _block_cache_driver_methods
+};
+
+/**
+ * @extends BaseBlockDevice
+ *
+ * @brief   Type of a block cache driver.
+ * @details The driver is a block device stacked on another block device.
+ */
+typedef struct {
+  /**
+   * @brief   Virtual Methods Table.
+   */
+  const struct BlockCacheDriverVMT  *vmt;
+  _base_block_device_data
+  /**
+   * @brief   Current configuration data.
+   */
+  const BlockCacheConfig            *config;
+  /**
+   * @brief   Access stamps counter.
+   */
+  uint32_t                          stamp;
+} BlockCacheDriver;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void bcObjectInit(BlockCacheDriver *bcp);
+  void bcStart(BlockCacheDriver *bcp, const BlockCacheConfig *config);
+  void bcStop(BlockCacheDriver *bcp);
+  bool bcConnect(BlockCacheDriver *bcp);
+  bool bcDisconnect(BlockCacheDriver *bcp);
+  bool bcRead(BlockCacheDriver *bcp, uint32_t startblk,
+              uint8_t *buf, uint32_t n);
+  bool bcWrite(BlockCacheDriver *bcp, uint32_t startblk,
+               const uint8_t *buf, uint32_t n);
+  bool bcSync(BlockCacheDriver *bcp);
+  bool bcGetInfo(BlockCacheDriver *bcp, BlockDeviceInfo *bdip);
+  bool bcFlush(BlockCacheDriver *bcp);
+  void bcInvalidate(BlockCacheDriver *bcp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_BLOCK_CACHE_H */
+
+/** @} */
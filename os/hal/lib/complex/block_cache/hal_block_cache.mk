@@ -0,0 +1,9 @@
+# List of all the block cache subsystem files.
+BLOCKCACHESRC := $(CHIBIOS)/os/hal/lib/complex/block_cache/hal_block_cache.c
+
+# Required include directories
+BLOCKCACHEINC := $(CHIBIOS)/os/hal/lib/complex/block_cache
+
+# Shared variables
+ALLCSRC += $(BLOCKCACHESRC)
+ALLINC  += $(BLOCKCACHEINC)
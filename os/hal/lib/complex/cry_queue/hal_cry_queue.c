@@ -0,0 +1,412 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_cry_queue.c
+ * @brief   Crypto jobs queue module code.
+ * @details This module puts an asynchronous jobs queue in front of a
+ *          crypto driver. Threads and ISRs submit jobs, each job is an
+ *          operation using a key descriptor, jobs are served in priority
+ *          order and completed by a callback, event flags or by waking
+ *          the waiting thread.
+ *          The key is loaded in the crypto driver only when it changes,
+ *          among the jobs with the same priority the ones using the
+ *          loaded key are served first in order to reduce the driver
+ *          reconfigurations.
+ *          The application serves the queue by calling @p crqServe() in
+ *          a loop from a dedicated thread, the thread priority should be
+ *          the highest priority of the clients:
+ * @code
+ *          static THD_FUNCTION(crq_thread, arg) {
+ *
+ *            (void)arg;
+ *            while (crqServe(&CRQ1) == MSG_OK) {
+ *            }
+ *          }
+ * @endcode
+ *
+ * @addtogroup HAL_CRY_QUEUE
+ * @{
+ */
+
+#include "hal.h"
+#include "hal_cry_queue.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Removes the next job to be served from the queue.
+ * @details The oldest job with the highest priority is served unless a
+ *          job with the same priority does not require a key change.
+ * @note    Must be called with the queue not empty.
+ *
+ * @param[in] crqp      pointer to the @p CryptoQueueDriver object
+ * @return              The job to be served.
+ *
+ * @notapi
+ */
+static CryptoJob *crq_dequeue(CryptoQueueDriver *crqp) {
+  CryptoJob **pp = &crqp->queue;
+  CryptoJob *hp = crqp->queue;
+  CryptoJob *jp;
+
+  if ((hp->key != NULL) && (hp->key != crqp->key) &&
+      (crqp->grouped < crqp->config->group)) {
+    CryptoJob **sp = &hp->next;
+
+    while ((*sp != NULL) && ((*sp)->prio == hp->prio)) {
+      if (((*sp)->key == NULL) || ((*sp)->key == crqp->key)) {
+        pp = sp;
+        break;
+      }
+      sp = &(*sp)->next;
+    }
+  }
+
+  if (pp == &crqp->queue) {
+    crqp->grouped = 0U;
+  }
+  else {
+    crqp->grouped++;
+  }
+
+  jp  = *pp;
+  *pp = jp->next;
+
+  return jp;
+}
+
+/**
+ * @brief   Completes a job.
+ *
+ * @param[in] crqp      pointer to the @p CryptoQueueDriver object
+ * @param[in] jp        pointer to the @p CryptoJob object
+ * @param[in] err       job result
+ *
+ * @iclass
+ */
+static void crq_complete_i(CryptoQueueDriver *crqp, CryptoJob *jp,
+                           cryerror_t err) {
+
+  jp->error = err;
+  jp->state = CRQ_JOB_DONE;
+  osalThreadResumeI(&jp->thread, MSG_OK);
+  if (jp->flags != (eventflags_t)0) {
+    osalEventBroadcastFlagsI(&crqp->event, jp->flags);
+  }
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ *
+ * @param[out] crqp     pointer to the @p CryptoQueueDriver object
+ *
+ * @init
+ */
+void crqObjectInit(CryptoQueueDriver *crqp) {
+
+  osalDbgCheck(crqp != NULL);
+
+  crqp->state   = CRQ_STOP;
+  crqp->config  = NULL;
+  crqp->queue   = NULL;
+  crqp->key     = NULL;
+  crqp->grouped = 0U;
+  crqp->loads   = 0U;
+  crqp->thread  = NULL;
+  osalEventObjectInit(&crqp->event);
+}
+
+/**
+ * @brief   Configures and activates the driver.
+ *
+ * @param[in] crqp      pointer to the @p CryptoQueueDriver object
+ * @param[in] config    pointer to the configuration
+ *
+ * @api
+ */
+void crqStart(CryptoQueueDriver *crqp, const CryptoQueueConfig *config) {
+
+  osalDbgCheck((crqp != NULL) && (config != NULL) && (config->cryp != NULL));
+
+  osalSysLock();
+  osalDbgAssert(crqp->state == CRQ_STOP, "invalid state");
+  crqp->config  = config;
+  crqp->key     = NULL;
+  crqp->grouped = 0U;
+  crqp->state   = CRQ_READY;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Deactivates the driver.
+ * @details The queued jobs are completed with @p CRY_ERR_OP_FAILURE, the
+ *          serving thread returns @p MSG_RESET after completing the job
+ *          being executed, if any.
+ *
+ * @param[in] crqp      pointer to the @p CryptoQueueDriver object
+ *
+ * @api
+ */
+void crqStop(CryptoQueueDriver *crqp) {
+
+  osalDbgCheck(crqp != NULL);
+
+  osalSysLock();
+  osalDbgAssert((crqp->state == CRQ_STOP) || (crqp->state == CRQ_READY),
+                "invalid state");
+  crqp->state = CRQ_STOP;
+  while (crqp->queue != NULL) {
+    CryptoJob *jp = crqp->queue;
+
+    crqp->queue = jp->next;
+    crq_complete_i(crqp, jp, CRY_ERR_OP_FAILURE);
+  }
+  osalThreadResumeS(&crqp->thread, MSG_RESET);
+  osalOsRescheduleS();
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Initializes a job.
+ * @note    The @p cb and @p flags fields are cleared, they can be set
+ *          after initialization.
+ *
+ * @param[out] jp       pointer to the @p CryptoJob object
+ * @param[in] prio      job priority, higher values are served first
+ * @param[in] key       key descriptor or @p NULL
+ * @param[in] func      job operation
+ * @param[in] arg       job operation argument
+ *
+ * @init
+ */
+void crqJobObjectInit(CryptoJob *jp, uint32_t prio, const CryptoKey *key,
+                      crqfunc_t func, void *arg) {
+
+  osalDbgCheck((jp != NULL) && (func != NULL));
+
+  jp->next   = NULL;
+  jp->prio   = prio;
+  jp->key    = key;
+  jp->func   = func;
+  jp->arg    = arg;
+  jp->cb     = NULL;
+  jp->flags  = (eventflags_t)0;
+  jp->state  = CRQ_JOB_IDLE;
+  jp->error  = CRY_NOERROR;
+  jp->thread = NULL;
+}
+
+/**
+ * @brief   Submits a job.
+ * @details The job is inserted after the queued jobs with the same or
+ *          higher priority.
+ *
+ * @param[in] crqp      pointer to the @p CryptoQueueDriver object
+ * @param[in] jp        pointer to the @p CryptoJob object
+ *
+ * @iclass
+ */
+void crqSubmitI(CryptoQueueDriver *crqp, CryptoJob *jp) {
+  CryptoJob **pp = &crqp->queue;
+
+  osalDbgCheckClassI();
+  osalDbgCheck((crqp != NULL) && (jp != NULL));
+  osalDbgAssert(crqp->state == CRQ_READY, "invalid state");
+  osalDbgAssert((jp->state == CRQ_JOB_IDLE) || (jp->state == CRQ_JOB_DONE),
+                "job busy");
+
+  while ((*pp != NULL) && ((*pp)->prio >= jp->prio)) {
+    pp = &(*pp)->next;
+  }
+  jp->next  = *pp;
+  *pp       = jp;
+  jp->state = CRQ_JOB_QUEUED;
+  jp->error = CRY_NOERROR;
+
+  osalThreadResumeI(&crqp->thread, MSG_OK);
+}
+
+/**
+ * @brief   Submits a job.
+ * @details The job is inserted after the queued jobs with the same or
+ *          higher priority.
+ *
+ * @param[in] crqp      pointer to the @p CryptoQueueDriver object
+ * @param[in] jp        pointer to the @p CryptoJob object
+ *
+ * @api
+ */
+void crqSubmit(CryptoQueueDriver *crqp, CryptoJob *jp) {
+
+  osalSysLock();
+  crqSubmitI(crqp, jp);
+  osalOsRescheduleS();
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Waits for a job completion.
+ * @note    Only one thread can wait for a job.
+ *
+ * @param[in] crqp      pointer to the @p CryptoQueueDriver object
+ * @param[in] jp        pointer to the submitted @p CryptoJob object
+ * @return              The job result.
+ *
+ * @api
+ */
+cryerror_t crqWait(CryptoQueueDriver *crqp, CryptoJob *jp) {
+
+  osalDbgCheck((crqp != NULL) && (jp != NULL));
+
+  osalSysLock();
+  osalDbgAssert(jp->state != CRQ_JOB_IDLE, "not submitted");
+  if (jp->state != CRQ_JOB_DONE) {
+    (void) osalThreadSuspendS(&jp->thread);
+  }
+  osalSysUnlock();
+
+  return jp->error;
+}
+
+/**
+ * @brief   Submits a job and waits for its completion.
+ *
+ * @param[in] crqp      pointer to the @p CryptoQueueDriver object
+ * @param[in] jp        pointer to the @p CryptoJob object
+ * @return              The job result.
+ *
+ * @api
+ */
+cryerror_t crqExecute(CryptoQueueDriver *crqp, CryptoJob *jp) {
+
+  osalSysLock();
+  crqSubmitI(crqp, jp);
+  (void) osalThreadSuspendS(&jp->thread);
+  osalSysUnlock();
+
+  return jp->error;
+}
+
+/**
+ * @brief   Invalidates a loaded key.
+ * @details The key is loaded again by the next job using it, this must
+ *          be done after changing the key data.
+ *
+ * @param[in] crqp      pointer to the @p CryptoQueueDriver object
+ * @param[in] key       key descriptor or @p NULL for any key
+ *
+ * @api
+ */
+void crqInvalidateKey(CryptoQueueDriver *crqp, const CryptoKey *key) {
+
+  osalDbgCheck(crqp != NULL);
+
+  osalSysLock();
+  if ((key == NULL) || (crqp->key == key)) {
+    crqp->key = NULL;
+  }
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Serves a job.
+ * @details This function must be called in a loop from a dedicated
+ *          thread, it waits for a job, loads its key if required and
+ *          executes it.
+ *
+ * @param[in] crqp      pointer to the @p CryptoQueueDriver object
+ * @return              The operation status.
+ * @retval MSG_OK       if a job has been served.
+ * @retval MSG_RESET    if the driver has been stopped.
+ *
+ * @api
+ */
+msg_t crqServe(CryptoQueueDriver *crqp) {
+  CryptoJob *jp;
+  bool load;
+  cryerror_t err = CRY_NOERROR;
+
+  osalDbgCheck(crqp != NULL);
+
+  osalSysLock();
+  while (crqp->queue == NULL) {
+    if ((crqp->state != CRQ_READY) ||
+        (osalThreadSuspendS(&crqp->thread) == MSG_RESET)) {
+      osalSysUnlock();
+      return MSG_RESET;
+    }
+  }
+  jp        = crq_dequeue(crqp);
+  jp->state = CRQ_JOB_RUNNING;
+  load      = (jp->key != NULL) && (jp->key != crqp->key);
+  if (load) {
+    crqp->key = jp->key;
+  }
+  osalSysUnlock();
+
+  /* Key change, the key schedule is loaded once for all the jobs sharing
+     the same key.*/
+  if (load) {
+    crqp->loads++;
+    err = cryLoadTransientKey(crqp->config->cryp, jp->key->algorithm,
+                              jp->key->size, jp->key->keyp);
+    if (err != CRY_NOERROR) {
+      crqInvalidateKey(crqp, NULL);
+    }
+  }
+
+  if (err == CRY_NOERROR) {
+    err = jp->func(crqp->config->cryp, (crykey_t)0, jp->arg);
+  }
+
+  /* The callback is invoked before releasing the job, the job can be
+     reused after the completion.*/
+  jp->error = err;
+  if (jp->cb != NULL) {
+    jp->cb(crqp, jp);
+  }
+
+  osalSysLock();
+  crq_complete_i(crqp, jp, err);
+  osalOsRescheduleS();
+  osalSysUnlock();
+
+  return MSG_OK;
+}
+
+/** @} */
@@ -0,0 +1,288 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_cry_queue.h
+ * @brief   Crypto jobs queue module header.
+ *
+ * @addtogroup HAL_CRY_QUEUE
+ * @{
+ */
+
+#ifndef HAL_CRY_QUEUE_H
+#define HAL_CRY_QUEUE_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if HAL_USE_CRY == FALSE
+#error "CRY_QUEUE requires HAL_USE_CRY"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  CRQ_UNINIT = 0,                   /**< Not initialized.                   */
+  CRQ_STOP = 1,                     /**< Stopped.                           */
+  CRQ_READY = 2                     /**< Ready.                             */
+} crqstate_t;
+
+/**
+ * @brief   Job possible states.
+ */
+typedef enum {
+  CRQ_JOB_IDLE = 0,                 /**< Not submitted.                     */
+  CRQ_JOB_QUEUED = 1,               /**< Waiting in the queue.              */
+  CRQ_JOB_RUNNING = 2,              /**< Being executed.                    */
+  CRQ_JOB_DONE = 3                  /**< Completed.                         */
+} crqjobstate_t;
+
+/**
+ * @brief   Type of a crypto jobs queue driver.
+ */
+typedef struct CryptoQueueDriver CryptoQueueDriver;
+
+/**
+ * @brief   Type of a crypto job.
+ */
+typedef struct CryptoJob CryptoJob;
+
+/**
+ * @brief   Type of a job operation.
+ * @details The operation is executed by the serving thread, it performs
+ *          one or more calls to the crypto driver using the specified key.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] key_id    key to be used, the transient key if the job has
+ *                      a key associated
+ * @param[in] arg       job argument
+ * @return              The operation status.
+ */
+typedef cryerror_t (*crqfunc_t)(CRYDriver *cryp, crykey_t key_id, void *arg);
+
+/**
+ * @brief   Type of a job completion callback.
+ *
+ * @param[in] crqp      pointer to the @p CryptoQueueDriver object
+ * @param[in] jp        pointer to the completed @p CryptoJob object
+ */
+typedef void (*crqcallback_t)(CryptoQueueDriver *crqp, CryptoJob *jp);
+
+/**
+ * @brief   Type of a key descriptor.
+ * @details Jobs refer to keys by descriptor, the key is loaded in the
+ *          crypto driver only when it differs from the last loaded one.
+ * @note    The key data must not be modified while the descriptor is
+ *          in use, @p crqInvalidateKey() must be called after changing
+ *          it.
+ */
+typedef struct {
+  /**
+   * @brief   Key algorithm.
+   */
+  cryalgorithm_t            algorithm;
+  /**
+   * @brief   Key size in bytes.
+   */
+  size_t                    size;
+  /**
+   * @brief   Key data.
+   */
+  const uint8_t             *keyp;
+} CryptoKey;
+
+/**
+ * @brief   Structure representing a crypto job.
+ */
+struct CryptoJob {
+  /**
+   * @brief   Next job in the queue.
+   */
+  CryptoJob                 *next;
+  /**
+   * @brief   Job priority, higher values are served first.
+   */
+  uint32_t                  prio;
+  /**
+   * @brief   Key used by the job or @p NULL.
+   * @details Jobs without a key receive the key identifier zero and can
+   *          use hash functions or keys stored in the crypto driver.
+   */
+  const CryptoKey           *key;
+  /**
+   * @brief   Job operation.
+   */
+  crqfunc_t                 func;
+  /**
+   * @brief   Job operation argument.
+   */
+  void                      *arg;
+  /**
+   * @brief   Completion callback or @p NULL.
+   * @note    The callback is invoked from the serving thread.
+   */
+  crqcallback_t             cb;
+  /**
+   * @brief   Event flags broadcast on completion, zero for none.
+   */
+  eventflags_t              flags;
+  /**
+   * @brief   Job state.
+   */
+  volatile crqjobstate_t    state;
+  /**
+   * @brief   Job result.
+   */
+  cryerror_t                error;
+  /**
+   * @brief   Waiting thread.
+   */
+  thread_reference_t        thread;
+};
+
+/**
+ * @brief   Type of a crypto jobs queue configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Underlying crypto driver.
+   * @note    The driver must be started and it is owned by the queue,
+   *          it must not be used directly while the queue is active.
+   */
+  CRYDriver                 *cryp;
+  /**
+   * @brief   Maximum number of jobs served out of order.
+   * @details Among the jobs with the highest priority the ones using the
+   *          loaded key are served first, after this number of
+   *          consecutive jobs the oldest job is served regardless of its
+   *          key. Zero disables grouping.
+   */
+  unsigned                  group;
+} CryptoQueueConfig;
+
+/**
+ * @brief   Structure representing a crypto jobs queue driver.
+ */
+struct CryptoQueueDriver {
+  /**
+   * @brief   Driver state.
+   */
+  crqstate_t                state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const CryptoQueueConfig   *config;
+  /**
+   * @brief   Jobs queue ordered by priority.
+   */
+  CryptoJob                 *queue;
+  /**
+   * @brief   Key loaded in the crypto driver or @p NULL.
+   */
+  const CryptoKey           *key;
+  /**
+   * @brief   Consecutive jobs served out of order.
+   */
+  unsigned                  grouped;
+  /**
+   * @brief   Number of key loads.
+   */
+  uint32_t                  loads;
+  /**
+   * @brief   Waiting serving thread.
+   */
+  thread_reference_t        thread;
+  /**
+   * @brief   Completion event source.
+   * @details The event flags are the @p flags field of the completed
+   *          jobs.
+   */
+  event_source_t            event;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the completion event source.
+ *
+ * @param[in] crqp      pointer to the @p CryptoQueueDriver object
+ *
+ * @xclass
+ */
+#define crqGetEventSource(crqp) (&(crqp)->event)
+
+/**
+ * @brief   Returns the number of key loads performed.
+ *
+ * @param[in] crqp      pointer to the @p CryptoQueueDriver object
+ *
+ * @xclass
+ */
+#define crqGetKeyLoadsX(crqp) ((crqp)->loads)
+
+/**
+ * @brief   Returns @p true if the job is completed.
+ *
+ * @param[in] jp        pointer to the @p CryptoJob object
+ *
+ * @xclass
+ */
+#define crqIsJobDoneX(jp) ((jp)->state == CRQ_JOB_DONE)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void crqObjectInit(CryptoQueueDriver *crqp);
+  void crqStart(CryptoQueueDriver *crqp, const CryptoQueueConfig *config);
+  void crqStop(CryptoQueueDriver *crqp);
+  void crqJobObjectInit(CryptoJob *jp, uint32_t prio, const CryptoKey *key,
+                        crqfunc_t func, void *arg);
+  void crqSubmitI(CryptoQueueDriver *crqp, CryptoJob *jp);
+  void crqSubmit(CryptoQueueDriver *crqp, CryptoJob *jp);
+  cryerror_t crqWait(CryptoQueueDriver *crqp, CryptoJob *jp);
+  cryerror_t crqExecute(CryptoQueueDriver *crqp, CryptoJob *jp);
+  void crqInvalidateKey(CryptoQueueDriver *crqp, const CryptoKey *key);
+  msg_t crqServe(CryptoQueueDriver *crqp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_CRY_QUEUE_H */
+
+/** @} */
@@ -0,0 +1,9 @@
+# List of all the crypto jobs queue subsystem files.
+CRYQUEUESRC := $(CHIBIOS)/os/hal/lib/complex/cry_queue/hal_cry_queue.c
+
+# Required include directories
+CRYQUEUEINC := $(CHIBIOS)/os/hal/lib/complex/cry_queue
+
+# Shared variables
+ALLCSRC += $(CRYQUEUESRC)
+ALLINC  += $(CRYQUEUEINC)
@@ -0,0 +1,238 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_debounce.c
+ * @brief   PAL inputs debounce module code.
+ * @details This module debounces many PAL input lines from a single
+ *          periodic callback. Whole ports are sampled and filtered using
+ *          vertical counters, the cost of a sample depends on the number
+ *          of ports only, not on the number of lines or edges.<br>
+ *          A line changes its debounced state after @p DEB_SAMPLES
+ *          consecutive samples different from the current state, changed
+ *          lines are accumulated per port and notified as event flags.
+ *          <br>
+ *          The application calls @p debSampleI() from a periodic source,
+ *          for example a GPT driver in continuous mode. The function
+ *          returns @p false when all lines are stable, so sampling can be
+ *          stopped and restarted on demand from a PAL edge callback:
+ * @code
+ *          static void gpt_cb(GPTDriver *gptp) {
+ *
+ *            osalSysLockFromISR();
+ *            if (!debSampleI(&DEB1)) {
+ *              gptStopTimerI(gptp);
+ *            }
+ *            osalSysUnlockFromISR();
+ *          }
+ * @endcode
+ *
+ * @addtogroup HAL_DEBOUNCE
+ * @{
+ */
+
+#include "hal.h"
+#include "hal_debounce.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ *
+ * @param[out] debp     pointer to the @p DebounceDriver object
+ *
+ * @init
+ */
+void debObjectInit(DebounceDriver *debp) {
+
+  osalDbgCheck(debp != NULL);
+
+  debp->state  = DEB_STOP;
+  debp->config = NULL;
+  osalEventObjectInit(&debp->event);
+}
+
+/**
+ * @brief   Configures and activates the driver.
+ * @details The debounced state is initialized from the current state of
+ *          the lines.
+ * @note    The lines must be already programmed as inputs.
+ *
+ * @param[in] debp      pointer to the @p DebounceDriver object
+ * @param[in] config    pointer to the configuration
+ *
+ * @api
+ */
+void debStart(DebounceDriver *debp, const DebounceConfig *config) {
+  unsigned i;
+
+  osalDbgCheck((debp != NULL) && (config != NULL) &&
+               (config->ports != NULL) && (config->states != NULL) &&
+               (config->nports > 0U) && (config->nports <= 32U));
+
+  osalSysLock();
+  osalDbgAssert(debp->state == DEB_STOP, "invalid state");
+
+  for (i = 0U; i < config->nports; i++) {
+    DebouncePortState *dsp = &config->states[i];
+
+    dsp->state   = palReadPort(config->ports[i].port) & config->ports[i].mask;
+    dsp->cnt0    = (ioportmask_t)~0U;
+    dsp->cnt1    = (ioportmask_t)~0U;
+    dsp->changes = 0U;
+  }
+  debp->config = config;
+  debp->state  = DEB_READY;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Deactivates the driver.
+ *
+ * @param[in] debp      pointer to the @p DebounceDriver object
+ *
+ * @api
+ */
+void debStop(DebounceDriver *debp) {
+
+  osalDbgCheck(debp != NULL);
+
+  osalSysLock();
+  osalDbgAssert((debp->state == DEB_STOP) || (debp->state == DEB_READY),
+                "invalid state");
+  debp->state = DEB_STOP;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Samples all the debounced ports.
+ * @details The counter of a line differing from its debounced state is
+ *          advanced, the counter of a line equal to its state is reset.
+ *          When a counter wraps the line state is toggled, the changed
+ *          ports are broadcast once as event flags.
+ * @note    Ignored if the driver is not active.
+ *
+ * @param[in] debp      pointer to the @p DebounceDriver object
+ * @return              The lines stability.
+ * @retval false        if all the lines are stable.
+ * @retval true         if some lines are still bouncing.
+ *
+ * @iclass
+ */
+bool debSampleI(DebounceDriver *debp) {
+  const DebounceConfig *config;
+  eventflags_t flags = 0U;
+  ioportmask_t bouncing = 0U;
+  unsigned i;
+
+  osalDbgCheckClassI();
+  osalDbgCheck(debp != NULL);
+
+  if (debp->state != DEB_READY) {
+    return false;
+  }
+
+  config = debp->config;
+  for (i = 0U; i < config->nports; i++) {
+    DebouncePortState *dsp = &config->states[i];
+    ioportmask_t mask = config->ports[i].mask;
+    ioportmask_t delta;
+
+    /* Lines differing from the debounced state, the counters count down
+       from three while the difference persists and are reset to three
+       otherwise, lines toggle when their counter wraps.*/
+    delta     = (palReadPort(config->ports[i].port) ^ dsp->state) & mask;
+    dsp->cnt0 = ~(dsp->cnt0 & delta);
+    dsp->cnt1 = dsp->cnt0 ^ (dsp->cnt1 & delta);
+    delta    &= dsp->cnt0 & dsp->cnt1;
+    if (delta != 0U) {
+      dsp->state   ^= delta;
+      dsp->changes |= delta;
+      flags        |= (eventflags_t)1U << i;
+    }
+    bouncing |= ~(dsp->cnt0 & dsp->cnt1) & mask;
+  }
+
+  if (flags != 0U) {
+    osalEventBroadcastFlagsI(&debp->event, flags);
+  }
+
+  return bouncing != 0U;
+}
+
+/**
+ * @brief   Returns and clears the changed lines of a port.
+ *
+ * @param[in] debp      pointer to the @p DebounceDriver object
+ * @param[in] n         index of the port in the configuration
+ * @return              The lines changed since the previous call.
+ *
+ * @iclass
+ */
+ioportmask_t debGetChangesI(DebounceDriver *debp, unsigned n) {
+  ioportmask_t changes;
+
+  osalDbgCheckClassI();
+  osalDbgCheck((debp != NULL) && (debp->config != NULL) &&
+               (n < debp->config->nports));
+
+  changes = debp->config->states[n].changes;
+  debp->config->states[n].changes = 0U;
+
+  return changes;
+}
+
+/**
+ * @brief   Returns and clears the changed lines of a port.
+ *
+ * @param[in] debp      pointer to the @p DebounceDriver object
+ * @param[in] n         index of the port in the configuration
+ * @return              The lines changed since the previous call.
+ *
+ * @api
+ */
+ioportmask_t debGetChanges(DebounceDriver *debp, unsigned n) {
+  ioportmask_t changes;
+
+  osalSysLock();
+  changes = debGetChangesI(debp, n);
+  osalSysUnlock();
+
+  return changes;
+}
+
+/** @} */
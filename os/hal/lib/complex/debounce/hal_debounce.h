@@ -0,0 +1,187 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_debounce.h
+ * @brief   PAL inputs debounce module header.
+ *
+ * @addtogroup HAL_DEBOUNCE
+ * @{
+ */
+
+#ifndef HAL_DEBOUNCE_H
+#define HAL_DEBOUNCE_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of consecutive equal samples required for a change.
+ */
+#define DEB_SAMPLES                 4U
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if HAL_USE_PAL == FALSE
+#error "DEBOUNCE requires HAL_USE_PAL"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  DEB_UNINIT = 0,                   /**< Not initialized.                   */
+  DEB_STOP = 1,                     /**< Stopped.                           */
+  DEB_READY = 2                     /**< Ready.                             */
+} debstate_t;
+
+/**
+ * @brief   Debounced port descriptor.
+ */
+typedef struct {
+  /**
+   * @brief   Port identifier.
+   */
+  ioportid_t                port;
+  /**
+   * @brief   Mask of the debounced lines.
+   */
+  ioportmask_t              mask;
+} DebouncePort;
+
+/**
+ * @brief   Debounced port state.
+ * @details The two counters are a vertical counter, each line has a two
+ *          bits counter made of one bit in each word.
+ */
+typedef struct {
+  /**
+   * @brief   Debounced lines state.
+   */
+  ioportmask_t              state;
+  /**
+   * @brief   Vertical counter, bit 0.
+   */
+  ioportmask_t              cnt0;
+  /**
+   * @brief   Vertical counter, bit 1.
+   */
+  ioportmask_t              cnt1;
+  /**
+   * @brief   Lines changed since the last read.
+   */
+  ioportmask_t              changes;
+} DebouncePortState;
+
+/**
+ * @brief   Type of a debounce configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Array of debounced ports.
+   */
+  const DebouncePort        *ports;
+  /**
+   * @brief   Array of ports states.
+   * @note    The array must have @p nports elements.
+   */
+  DebouncePortState         *states;
+  /**
+   * @brief   Number of debounced ports.
+   * @note    Up to 32 ports, one event flag is used for each port.
+   */
+  unsigned                  nports;
+} DebounceConfig;
+
+/**
+ * @brief   Type of a debounce driver.
+ */
+typedef struct {
+  /**
+   * @brief   Driver state.
+   */
+  debstate_t                state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const DebounceConfig      *config;
+  /**
+   * @brief   Changes event source.
+   * @details The event flags carry the mask of the changed ports, bit
+   *          @p n for the port @p n of the configuration.
+   */
+  event_source_t            event;
+} DebounceDriver;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the changes event source.
+ *
+ * @param[in] debp      pointer to the @p DebounceDriver object
+ *
+ * @xclass
+ */
+#define debGetEventSource(debp) (&(debp)->event)
+
+/**
+ * @brief   Returns the debounced state of a port.
+ *
+ * @param[in] debp      pointer to the @p DebounceDriver object
+ * @param[in] n         index of the port in the configuration
+ * @return              The debounced lines state, only the lines in the
+ *                      port mask are meaningful.
+ *
+ * @xclass
+ */
+#define debGetStateX(debp, n) ((debp)->config->states[n].state)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void debObjectInit(DebounceDriver *debp);
+  void debStart(DebounceDriver *debp, const DebounceConfig *config);
+  void debStop(DebounceDriver *debp);
+  bool debSampleI(DebounceDriver *debp);
+  ioportmask_t debGetChangesI(DebounceDriver *debp, unsigned n);
+  ioportmask_t debGetChanges(DebounceDriver *debp, unsigned n);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_DEBOUNCE_H */
+
+/** @} */
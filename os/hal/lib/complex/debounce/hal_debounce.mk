@@ -0,0 +1,9 @@
+# List of all the PAL inputs debounce subsystem files.
+DEBOUNCESRC := $(CHIBIOS)/os/hal/lib/complex/debounce/hal_debounce.c
+
+# Required include directories
+DEBOUNCEINC := $(CHIBIOS)/os/hal/lib/complex/debounce
+
+# Shared variables
+ALLCSRC += $(DEBOUNCESRC)
+ALLINC  += $(DEBOUNCEINC)
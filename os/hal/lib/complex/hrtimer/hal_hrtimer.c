@@ -0,0 +1,415 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_hrtimer.c
+ * @brief   High resolution timers module code.
+ * @details This module implements one-shot timers and thread sleeps with
+ *          a resolution independent from the system tick. Two GPT units
+ *          are used, the first is free running and provides the time
+ *          base, the second is programmed in one-shot mode for the most
+ *          urgent deadline. The time base is never stopped or reloaded so
+ *          no time is lost between alarms.<br>
+ *          The service is independent from the system virtual timers,
+ *          coarse timeouts should still use the system time.
+ *
+ * @addtogroup HAL_HRTIMER
+ * @{
+ */
+
+#include "hal.h"
+#include "hal_hrtimer.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+static void hrt_base_cb(GPTDriver *gptp);
+static void hrt_alarm_cb(GPTDriver *gptp);
+
+/**
+ * @brief   Service state.
+ */
+static struct {
+  /**
+   * @brief   Current configuration or @p NULL if stopped.
+   */
+  const HRTConfig           *config;
+  /**
+   * @brief   Time at the start of the current time base period.
+   */
+  hrtime_t                  base;
+  /**
+   * @brief   Last returned time.
+   */
+  hrtime_t                  last;
+  /**
+   * @brief   Armed timers ordered by deadline.
+   */
+  hr_timer_t                *head;
+} hrt;
+
+/**
+ * @brief   Time base unit configuration.
+ */
+static const GPTConfig hrt_basecfg = {
+  .frequency    = HRT_CFG_FREQUENCY,
+  .callback     = hrt_base_cb
+};
+
+/**
+ * @brief   Alarm unit configuration.
+ */
+static const GPTConfig hrt_alarmcfg = {
+  .frequency    = HRT_CFG_FREQUENCY,
+  .callback     = hrt_alarm_cb
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the current time.
+ * @note    Must be invoked from within a critical zone.
+ *
+ * @return              The current time.
+ *
+ * @notapi
+ */
+static hrtime_t hrt_now(void) {
+  hrtime_t now;
+
+  now = hrt.base + (hrtime_t)gptGetCounterX(hrt.config->basep);
+
+  /* A counter wrap not yet served by the time base ISR is detected
+     because the time would appear to go back.*/
+  if ((int32_t)(now - hrt.last) < (int32_t)0) {
+    now += (hrtime_t)hrt.config->period;
+  }
+  hrt.last = now;
+
+  return now;
+}
+
+/**
+ * @brief   Programs the alarm unit for the most urgent timer.
+ * @note    Must be invoked from within a critical zone.
+ *
+ * @param[in] now       the current time
+ *
+ * @notapi
+ */
+static void hrt_arm(hrtime_t now) {
+  GPTDriver *alarmp = hrt.config->alarmp;
+  int32_t delta;
+
+  gptStopTimerI(alarmp);
+  if (hrt.head == NULL) {
+    return;
+  }
+
+  /* The alarm is anticipated by the expiration latency, too short and
+     too long alarms are clamped, the remaining time of split alarms is
+     served on the next alarm event.*/
+  delta = (int32_t)(hrt.head->deadline - now) - (int32_t)HRT_CFG_COMPENSATION;
+  if (delta < (int32_t)HRT_CFG_MIN_INTERVAL) {
+    delta = (int32_t)HRT_CFG_MIN_INTERVAL;
+  }
+  else if ((uint32_t)delta > (uint32_t)hrt.config->alarm_max) {
+    delta = (int32_t)hrt.config->alarm_max;
+  }
+  gptStartOneShotI(alarmp, (gptcnt_t)delta);
+}
+
+/**
+ * @brief   Time base period callback.
+ *
+ * @param[in] gptp      pointer to the @p GPTDriver object
+ *
+ * @notapi
+ */
+static void hrt_base_cb(GPTDriver *gptp) {
+
+  (void)gptp;
+
+  osalSysLockFromISR();
+  hrt.base += (hrtime_t)hrt.config->period;
+  (void)hrt_now();
+  osalSysUnlockFromISR();
+}
+
+/**
+ * @brief   Alarm callback.
+ *
+ * @param[in] gptp      pointer to the @p GPTDriver object
+ *
+ * @notapi
+ */
+static void hrt_alarm_cb(GPTDriver *gptp) {
+  hrtime_t now;
+
+  (void)gptp;
+
+  osalSysLockFromISR();
+  now = hrt_now();
+  while ((hrt.head != NULL) &&
+         ((int32_t)(hrt.head->deadline - now) <=
+          (int32_t)HRT_CFG_COMPENSATION)) {
+    hr_timer_t *htp = hrt.head;
+
+    hrt.head   = htp->next;
+    htp->armed = false;
+    htp->func(htp, htp->par);
+    now = hrt_now();
+  }
+  hrt_arm(now);
+  osalSysUnlockFromISR();
+}
+
+/**
+ * @brief   Sleep timer callback.
+ *
+ * @param[in] htp       pointer to the expired @p hr_timer_t object
+ * @param[in] par       pointer to the thread reference
+ *
+ * @notapi
+ */
+static void hrt_wakeup(hr_timer_t *htp, void *par) {
+
+  (void)htp;
+
+  osalThreadResumeI((thread_reference_t *)par, MSG_OK);
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Starts the high resolution timers service.
+ * @pre     The GPT units must be stopped, they are reserved to the service
+ *          until @p hrtStop() is invoked.
+ *
+ * @param[in] config    pointer to the @p HRTConfig structure
+ *
+ * @api
+ */
+void hrtStart(const HRTConfig *config) {
+
+  osalDbgCheck((config != NULL) && (config->basep != NULL) &&
+               (config->alarmp != NULL) && (config->basep != config->alarmp) &&
+               (config->alarm_max > (gptcnt_t)HRT_CFG_MIN_INTERVAL));
+  osalDbgAssert(hrt.config == NULL, "already started");
+
+  hrt.config = config;
+  hrt.base   = (hrtime_t)0;
+  hrt.last   = (hrtime_t)0;
+  hrt.head   = NULL;
+
+  gptStart(config->alarmp, &hrt_alarmcfg);
+  gptStart(config->basep, &hrt_basecfg);
+  gptStartContinuous(config->basep, config->period);
+}
+
+/**
+ * @brief   Stops the high resolution timers service.
+ * @pre     There must be no armed timers.
+ *
+ * @api
+ */
+void hrtStop(void) {
+
+  osalDbgAssert(hrt.config != NULL, "not started");
+
+  osalSysLock();
+  osalDbgAssert(hrt.head == NULL, "armed timers");
+  gptStopTimerI(hrt.config->alarmp);
+  gptStopTimerI(hrt.config->basep);
+  osalSysUnlock();
+
+  gptStop(hrt.config->alarmp);
+  gptStop(hrt.config->basep);
+  hrt.config = NULL;
+}
+
+/**
+ * @brief   Returns the current high resolution time.
+ * @note    The time is monotonic as long as it is read at least once per
+ *          time base period, this is ensured by the time base ISR.
+ *
+ * @return              The current time.
+ *
+ * @iclass
+ */
+hrtime_t hrtGetTimeI(void) {
+
+  osalDbgCheckClassI();
+
+  return hrt_now();
+}
+
+/**
+ * @brief   Returns the current high resolution time.
+ *
+ * @return              The current time.
+ *
+ * @api
+ */
+hrtime_t hrtGetTime(void) {
+  hrtime_t now;
+
+  osalSysLock();
+  now = hrt_now();
+  osalSysUnlock();
+
+  return now;
+}
+
+/**
+ * @brief   Initializes a high resolution timer object.
+ *
+ * @param[out] htp      pointer to a @p hr_timer_t object
+ *
+ * @init
+ */
+void hrtObjectInit(hr_timer_t *htp) {
+
+  osalDbgCheck(htp != NULL);
+
+  htp->armed = false;
+}
+
+/**
+ * @brief   Arms a high resolution timer.
+ * @details The callback is invoked from the alarm ISR when the deadline is
+ *          reached, a deadline already passed expires on the next alarm
+ *          event.
+ * @pre     The timer must not be already armed.
+ *
+ * @param[in] htp       pointer to a @p hr_timer_t object
+ * @param[in] deadline  absolute deadline
+ * @param[in] func      the timer callback
+ * @param[in] par       a parameter that will be passed to the callback
+ *
+ * @iclass
+ */
+void hrtSetI(hr_timer_t *htp, hrtime_t deadline,
+             hrtfunc_t func, void *par) {
+  hr_timer_t **pp;
+
+  osalDbgCheckClassI();
+  osalDbgCheck((htp != NULL) && (func != NULL));
+  osalDbgAssert(hrt.config != NULL, "not started");
+  osalDbgAssert(!htp->armed, "already armed");
+
+  htp->deadline = deadline;
+  htp->func     = func;
+  htp->par      = par;
+  htp->armed    = true;
+
+  /* Timers with the same deadline expire in arming order.*/
+  pp = &hrt.head;
+  while ((*pp != NULL) &&
+         ((int32_t)((*pp)->deadline - deadline) <= (int32_t)0)) {
+    pp = &(*pp)->next;
+  }
+  htp->next = *pp;
+  *pp = htp;
+
+  if (hrt.head == htp) {
+    hrt_arm(hrt_now());
+  }
+}
+
+/**
+ * @brief   Disarms a high resolution timer.
+ * @note    If the timer is not armed then the function has no effect.
+ *
+ * @param[in] htp       pointer to a @p hr_timer_t object
+ *
+ * @iclass
+ */
+void hrtResetI(hr_timer_t *htp) {
+  hr_timer_t **pp;
+
+  osalDbgCheckClassI();
+  osalDbgCheck(htp != NULL);
+
+  if (!htp->armed) {
+    return;
+  }
+
+  pp = &hrt.head;
+  while (*pp != htp) {
+    pp = &(*pp)->next;
+  }
+  *pp = htp->next;
+  htp->armed = false;
+
+  if (pp == &hrt.head) {
+    hrt_arm(hrt_now());
+  }
+}
+
+/**
+ * @brief   Suspends the invoking thread until a deadline.
+ * @details The thread is made ready by the alarm ISR, the wakeup latency
+ *          is not affected by the system tick frequency.
+ * @note    If the deadline is already passed then the function returns
+ *          immediately.
+ *
+ * @param[in] deadline  absolute deadline
+ *
+ * @api
+ */
+void hrtSleepUntil(hrtime_t deadline) {
+  thread_reference_t tr = NULL;
+  hr_timer_t ht;
+
+  osalSysLock();
+  if ((int32_t)(deadline - hrt_now()) > (int32_t)HRT_CFG_COMPENSATION) {
+    hrtObjectInit(&ht);
+    hrtSetI(&ht, deadline, hrt_wakeup, (void *)&tr);
+    (void) osalThreadSuspendS(&tr);
+  }
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Suspends the invoking thread for an interval.
+ *
+ * @param[in] ticks     the interval in high resolution ticks
+ *
+ * @api
+ */
+void hrtSleep(hrtime_t ticks) {
+
+  hrtSleepUntil(hrtGetTime() + ticks);
+}
+
+/** @} */
@@ -0,0 +1,250 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_hrtimer.h
+ * @brief   High resolution timers module header.
+ *
+ * @addtogroup HAL_HRTIMER
+ * @{
+ */
+
+#ifndef HAL_HRTIMER_H
+#define HAL_HRTIMER_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Frequency of the high resolution time base.
+ * @note    Both GPT units must be able to run at this frequency.
+ */
+#if !defined(HRT_CFG_FREQUENCY) || defined(__DOXYGEN__)
+#define HRT_CFG_FREQUENCY                   1000000
+#endif
+
+/**
+ * @brief   Expiration latency compensation.
+ * @details Number of ticks between the alarm event and the execution of
+ *          the timer callback, alarms are programmed early by this amount.
+ *          It should be calibrated on the target, it includes the IRQ
+ *          entry and the GPT driver overhead.
+ */
+#if !defined(HRT_CFG_COMPENSATION) || defined(__DOXYGEN__)
+#define HRT_CFG_COMPENSATION                1
+#endif
+
+/**
+ * @brief   Minimum alarm interval.
+ * @details Shorter alarms are programmed with this interval, the value
+ *          must be large enough to not miss the alarm while programming
+ *          the timer.
+ */
+#if !defined(HRT_CFG_MIN_INTERVAL) || defined(__DOXYGEN__)
+#define HRT_CFG_MIN_INTERVAL                2
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if HAL_USE_GPT == FALSE
+#error "HRT requires HAL_USE_GPT"
+#endif
+
+#if HRT_CFG_FREQUENCY <= 0
+#error "invalid HRT_CFG_FREQUENCY value"
+#endif
+
+#if HRT_CFG_COMPENSATION < 0
+#error "invalid HRT_CFG_COMPENSATION value"
+#endif
+
+#if HRT_CFG_MIN_INTERVAL < 1
+#error "invalid HRT_CFG_MIN_INTERVAL value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a high resolution time.
+ * @details Times are compared using serial numbers arithmetic, deadlines
+ *          must lie within half of the range in the future.
+ */
+typedef uint32_t hrtime_t;
+
+/**
+ * @brief   Type of a high resolution timer.
+ */
+typedef struct hr_timer hr_timer_t;
+
+/**
+ * @brief   Type of a high resolution timer callback.
+ * @note    Callbacks are invoked from ISR context within a system locked
+ *          zone, only I-class functions can be used.
+ *
+ * @param[in] htp       pointer to the expired @p hr_timer_t object
+ * @param[in] par       the callback parameter
+ */
+typedef void (*hrtfunc_t)(hr_timer_t *htp, void *par);
+
+/**
+ * @brief   Structure representing a high resolution timer.
+ */
+struct hr_timer {
+  /**
+   * @brief   Next armed timer.
+   */
+  hr_timer_t                *next;
+  /**
+   * @brief   Absolute deadline.
+   */
+  hrtime_t                  deadline;
+  /**
+   * @brief   Timer callback.
+   */
+  hrtfunc_t                 func;
+  /**
+   * @brief   Callback parameter.
+   */
+  void                      *par;
+  /**
+   * @brief   Timer armed flag.
+   */
+  bool                      armed;
+};
+
+/**
+ * @brief   Type of a high resolution timers configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   GPT unit used as free running time base.
+   */
+  GPTDriver                 *basep;
+  /**
+   * @brief   Time base period in ticks.
+   * @details It must be the counter range, zero is used for the full
+   *          range of 32 bits timers.
+   */
+  gptcnt_t                  period;
+  /**
+   * @brief   GPT unit used for alarms.
+   */
+  GPTDriver                 *alarmp;
+  /**
+   * @brief   Longest interval of the alarm unit.
+   * @details Longer alarms are split.
+   */
+  gptcnt_t                  alarm_max;
+} HRTConfig;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @name    Time conversion utilities
+ * @{
+ */
+/**
+ * @brief   Microseconds to high resolution ticks.
+ * @details Converts from microseconds to high resolution ticks number.
+ * @note    The result is rounded upward to the next tick boundary.
+ *
+ * @param[in] usecs     number of microseconds
+ * @return              The number of ticks.
+ *
+ * @api
+ */
+#define HRT_US2HRT(usecs)                                                   \
+  ((hrtime_t)((((uint64_t)(usecs) * (uint64_t)HRT_CFG_FREQUENCY) +          \
+               (uint64_t)999999) / (uint64_t)1000000))
+
+/**
+ * @brief   High resolution ticks to microseconds.
+ * @details Converts from high resolution ticks number to microseconds.
+ * @note    The result is rounded upward to the next microsecond boundary.
+ *
+ * @param[in] ticks     number of ticks
+ * @return              The number of microseconds.
+ *
+ * @api
+ */
+#define HRT_HRT2US(ticks)                                                   \
+  ((uint32_t)((((uint64_t)(ticks) * (uint64_t)1000000) +                    \
+               (uint64_t)HRT_CFG_FREQUENCY - (uint64_t)1) /                 \
+              (uint64_t)HRT_CFG_FREQUENCY))
+/** @} */
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void hrtStart(const HRTConfig *config);
+  void hrtStop(void);
+  hrtime_t hrtGetTimeI(void);
+  hrtime_t hrtGetTime(void);
+  void hrtObjectInit(hr_timer_t *htp);
+  void hrtSetI(hr_timer_t *htp, hrtime_t deadline,
+               hrtfunc_t func, void *par);
+  void hrtResetI(hr_timer_t *htp);
+  void hrtSleepUntil(hrtime_t deadline);
+  void hrtSleep(hrtime_t ticks);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns @p true if the timer is armed.
+ *
+ * @param[in] htp       pointer to a @p hr_timer_t object
+ * @return              The timer state.
+ *
+ * @iclass
+ */
+static inline bool hrtIsArmedI(const hr_timer_t *htp) {
+
+  osalDbgCheckClassI();
+
+  return htp->armed;
+}
+
+#endif /* HAL_HRTIMER_H */
+
+/** @} */
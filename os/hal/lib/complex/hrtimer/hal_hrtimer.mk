@@ -0,0 +1,9 @@
+# List of all the high resolution timers subsystem files.
+HRTIMERSRC := $(CHIBIOS)/os/hal/lib/complex/hrtimer/hal_hrtimer.c
+
+# Required include directories
+HRTIMERINC := $(CHIBIOS)/os/hal/lib/complex/hrtimer
+
+# Shared variables
+ALLCSRC += $(HRTIMERSRC)
+ALLINC  += $(HRTIMERINC)
@@ -46,6 +46,22 @@
 
 #define PAIR(a, b) (((unsigned)(a) << 2U) | (unsigned)(b))
 
+/**
+ * @brief   Record data size without the compression flag.
+ */
+#define MFS_SIZE(size) ((size) & ~MFS_SIZE_COMPRESSED)
+
+/**
+ * @brief   Compression minimum match length.
+ */
+#define MFS_LZ_MIN_MATCH                    3U
+
+/**
+ * @brief   Compression maximum match length.
+ * @note    Match lengths above 17 bytes require an extension byte.
+ */
+#define MFS_LZ_MAX_MATCH                    (MFS_LZ_MIN_MATCH + 15U + 255U)
+
 /**
  * @brief   Error check helper.
  */
@@ -99,6 +115,64 @@ static const uint16_t crc16_table[256] = {
   0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
 };
 
+#if (MFS_CFG_USE_COMPRESSION == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Compressed data writer.
+ * @details Compressed data is accumulated in the driver buffer and written
+ *          in program pages, either written or just accounted.
+ */
+typedef struct {
+  /**
+   * @brief   Flash offset of the buffered data.
+   */
+  flash_offset_t            offset;
+  /**
+   * @brief   Number of buffered bytes.
+   */
+  size_t                    n;
+  /**
+   * @brief   Total size of the flushed data.
+   */
+  size_t                    size;
+  /**
+   * @brief   CRC of the flushed data.
+   */
+  uint16_t                  crc;
+  /**
+   * @brief   Data is written in flash if @p true, accounted only if
+   *          @p false.
+   */
+  bool                      write;
+} mfs_lz_writer_t;
+
+/**
+ * @brief   Compressed data reader.
+ * @details Compressed data is read from flash in the driver buffer.
+ */
+typedef struct {
+  /**
+   * @brief   Flash offset of the data to be read.
+   */
+  flash_offset_t            offset;
+  /**
+   * @brief   Bytes still to be read from flash.
+   */
+  size_t                    remaining;
+  /**
+   * @brief   Position of the next byte in the buffer.
+   */
+  size_t                    pos;
+  /**
+   * @brief   Number of buffered bytes.
+   */
+  size_t                    n;
+  /**
+   * @brief   CRC of the read data.
+   */
+  uint16_t                  crc;
+} mfs_lz_reader_t;
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -115,16 +189,120 @@ uint16_t crc16(uint16_t crc, const uint8_t *data, size_t n) {
 }
 
 static void mfs_state_reset(MFSDriver *mfsp) {
-  unsigned i;
 
   mfsp->current_bank    = MFS_BANK_0;
   mfsp->current_counter = 0U;
   mfsp->next_offset     = 0U;
   mfsp->used_space      = 0U;
+  mfsp->locators        = 0U;
+  mfsp->index_end       = 0U;
+  mfsp->records         = 0U;
+  mfsp->gc_state        = MFS_GC_IDLE;
+#if MFS_CFG_WRITE_CACHE_RECORDS > 0
+  mfsp->cache_count     = 0U;
+#endif
+}
+
+/**
+ * @brief   Returns the position of the first descriptor with an identifier
+ *          not lower than the specified one.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record identifier
+ * @return              The descriptor position, @p records if there is
+ *                      no such descriptor.
+ *
+ * @notapi
+ */
+static unsigned mfs_index_lower_bound(MFSDriver *mfsp, uint32_t id) {
+  unsigned lo = 0U, hi = mfsp->records;
+
+  while (lo < hi) {
+    unsigned mid = lo + ((hi - lo) / 2U);
+
+    if (mfsp->descriptors[mid].id < id) {
+      lo = mid + 1U;
+    }
+    else {
+      hi = mid;
+    }
+  }
 
-  for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
-    mfsp->descriptors[i].offset = 0U;
-    mfsp->descriptors[i].size   = 0U;
+  return lo;
+}
+
+/**
+ * @brief   Finds the descriptor of an existing record.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record identifier
+ * @return              Pointer to the descriptor.
+ * @retval NULL         if the record does not exist.
+ *
+ * @notapi
+ */
+static mfs_record_descriptor_t *mfs_index_find(MFSDriver *mfsp,
+                                               mfs_id_t id) {
+  unsigned i = mfs_index_lower_bound(mfsp, id);
+
+  if ((i < mfsp->records) && (mfsp->descriptors[i].id == id)) {
+    return &mfsp->descriptors[i];
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Creates or updates the descriptor of a record.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record identifier
+ * @param[in] offset    offset of the record header
+ * @param[in] size      record data size
+ * @return              The operation status.
+ * @retval MFS_ERR_OUT_OF_MEM if the index is full.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_index_update(MFSDriver *mfsp, mfs_id_t id,
+                                    flash_offset_t offset, uint32_t size) {
+  unsigned i = mfs_index_lower_bound(mfsp, id);
+
+  if ((i >= mfsp->records) || (mfsp->descriptors[i].id != id)) {
+    if (mfsp->records >= (unsigned)MFS_CFG_INDEX_SIZE) {
+      return MFS_ERR_OUT_OF_MEM;
+    }
+
+    /* Making room for the new descriptor.*/
+    memmove((void *)&mfsp->descriptors[i + 1U],
+            (void *)&mfsp->descriptors[i],
+            (mfsp->records - i) * sizeof (mfs_record_descriptor_t));
+    mfsp->records++;
+    mfsp->descriptors[i].id = (uint32_t)id;
+  }
+
+  mfsp->descriptors[i].offset = offset;
+  mfsp->descriptors[i].size   = size;
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Removes the descriptor of a record, if present.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record identifier
+ *
+ * @notapi
+ */
+static void mfs_index_remove(MFSDriver *mfsp, mfs_id_t id) {
+  unsigned i = mfs_index_lower_bound(mfsp, id);
+
+  if ((i < mfsp->records) && (mfsp->descriptors[i].id == id)) {
+    mfsp->records--;
+    memmove((void *)&mfsp->descriptors[i],
+            (void *)&mfsp->descriptors[i + 1U],
+            (mfsp->records - i) * sizeof (mfs_record_descriptor_t));
   }
 }
 
@@ -137,6 +315,38 @@ static flash_offset_t mfs_flash_get_bank_offset(MFSDriver *mfsp,
                                                    mfsp->config->bank1_start);
 }
 
+static mfs_bank_t mfs_get_other_bank(mfs_bank_t bank) {
+
+  return bank == MFS_BANK_0 ? MFS_BANK_1 : MFS_BANK_0;
+}
+
+static void mfs_bank_get_sectors(MFSDriver *mfsp, mfs_bank_t bank,
+                                 flash_sector_t *startp,
+                                 flash_sector_t *endp) {
+
+  if (bank == MFS_BANK_0) {
+    *startp = mfsp->config->bank0_start;
+    *endp   = mfsp->config->bank0_start + mfsp->config->bank0_sectors;
+  }
+  else {
+    *startp = mfsp->config->bank1_start;
+    *endp   = mfsp->config->bank1_start + mfsp->config->bank1_sectors;
+  }
+}
+
+static flash_offset_t mfs_bank_get_limit(MFSDriver *mfsp) {
+
+  return (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
+          mfsp->config->bank_size) -
+         ((flash_offset_t)mfsp->locators *
+          (flash_offset_t)sizeof (mfs_index_locator_t));
+}
+
+static flash_offset_t mfs_bank_get_free(MFSDriver *mfsp) {
+
+  return mfs_bank_get_limit(mfsp) - mfsp->next_offset;
+}
+
 /**
  * @brief   Flash read.
  *
@@ -265,11 +475,12 @@ static mfs_error_t mfs_record_check(MFSDriver *mfsp,
 
   for (i = 0; i < 3; i++) {
     if (dhdrp->hdr32[i] != mfsp->config->erased) {
-      /* Not erased must verify the header.*/
+      /* Not erased must verify the header, identifier zero is used by
+         index checkpoints.*/
       if ((dhdrp->fields.magic != MFS_HEADER_MAGIC) ||
-          (dhdrp->fields.id < (uint16_t)1) ||
           (dhdrp->fields.id > (uint16_t)MFS_CFG_MAX_RECORDS) ||
-          (dhdrp->fields.size + sizeof (mfs_data_header_t) > limit - offset)) {
+          (MFS_SIZE(dhdrp->fields.size) + sizeof (mfs_data_header_t) >
+           limit - offset)) {
         *sts = MFS_RECORD_GARBAGE;
         return MFS_NO_ERROR;
       }
@@ -281,6 +492,8 @@ static mfs_error_t mfs_record_check(MFSDriver *mfsp,
 #else
       (void)mfsp;
 #endif
+      *sts = MFS_RECORD_OK;
+      return MFS_NO_ERROR;
     }
   }
 
@@ -290,45 +503,52 @@ static mfs_error_t mfs_record_check(MFSDriver *mfsp,
 }
 
 /**
- * @brief   Erases and verifies all sectors belonging to a bank.
+ * @brief   Erases and verifies a sector.
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
- * @param[in] bank      bank to be erased
+ * @param[in] sector    sector to be erased
  * @return              The operation status.
  *
  * @notapi
  */
-static mfs_error_t mfs_bank_erase(MFSDriver *mfsp, mfs_bank_t bank) {
-  flash_sector_t sector, end;
+static mfs_error_t mfs_flash_erase_sector(MFSDriver *mfsp,
+                                          flash_sector_t sector) {
+  flash_error_t ferr;
 
-  if (bank == MFS_BANK_0) {
-    sector = mfsp->config->bank0_start;
-    end    = mfsp->config->bank0_start + mfsp->config->bank0_sectors;
+  ferr = flashStartEraseSector(mfsp->config->flashp, sector);
+  if (ferr != FLASH_NO_ERROR) {
+    mfsp->state = MFS_ERROR;
+    return MFS_ERR_FLASH_FAILURE;
   }
-  else {
-    sector = mfsp->config->bank1_start;
-    end    = mfsp->config->bank1_start + mfsp->config->bank1_sectors;
+  ferr = flashWaitErase(mfsp->config->flashp);
+  if (ferr != FLASH_NO_ERROR) {
+    mfsp->state = MFS_ERROR;
+    return MFS_ERR_FLASH_FAILURE;
+  }
+  ferr = flashVerifyErase(mfsp->config->flashp, sector);
+  if (ferr != FLASH_NO_ERROR) {
+    mfsp->state = MFS_ERROR;
+    return MFS_ERR_FLASH_FAILURE;
   }
 
-  while (sector < end) {
-    flash_error_t ferr;
+  return MFS_NO_ERROR;
+}
 
-    ferr = flashStartEraseSector(mfsp->config->flashp, sector);
-    if (ferr != FLASH_NO_ERROR) {
-      mfsp->state = MFS_ERROR;
-      return MFS_ERR_FLASH_FAILURE;
-    }
-    ferr = flashWaitErase(mfsp->config->flashp);
-    if (ferr != FLASH_NO_ERROR) {
-      mfsp->state = MFS_ERROR;
-      return MFS_ERR_FLASH_FAILURE;
-    }
-    ferr = flashVerifyErase(mfsp->config->flashp, sector);
-    if (ferr != FLASH_NO_ERROR) {
-      mfsp->state = MFS_ERROR;
-      return MFS_ERR_FLASH_FAILURE;
-    }
+/**
+ * @brief   Erases and verifies all sectors belonging to a bank.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] bank      bank to be erased
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_bank_erase(MFSDriver *mfsp, mfs_bank_t bank) {
+  flash_sector_t sector, end;
 
+  mfs_bank_get_sectors(mfsp, bank, &sector, &end);
+  while (sector < end) {
+    RET_ON_ERROR(mfs_flash_erase_sector(mfsp, sector));
     sector++;
   }
 
@@ -412,11 +632,11 @@ static mfs_error_t mfs_bank_write_header(MFSDriver *mfsp,
 }
 
 /**
- * @brief   Scans blocks searching for records.
+ * @brief   Scans the current bank searching for records.
  * @note    The block integrity is strongly checked.
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
- * @param[in] bank      the bank identifier
+ * @param[in] offset    offset of the first record header to be scanned
  * @param[out] statep   bank state, it can be:
  *                      - MFS_BANK_PARTIAL
  *                      - MFS_BANK_OK
@@ -427,17 +647,17 @@ static mfs_error_t mfs_bank_write_header(MFSDriver *mfsp,
  * @notapi
  */
 static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
-                                         mfs_bank_t bank,
+                                         flash_offset_t offset,
                                          mfs_bank_state_t *statep) {
-  flash_offset_t hdr_offset, start_offset, end_offset;
+  flash_offset_t hdr_offset, end_offset;
   mfs_record_state_t sts;
   bool warning = false;
 
-  start_offset = mfs_flash_get_bank_offset(mfsp, bank);
-  end_offset   = start_offset + mfsp->config->bank_size;
+  /* The scan stops before the index locators.*/
+  end_offset = mfs_bank_get_limit(mfsp);
 
   /* Scanning records.*/
-  hdr_offset = start_offset + (flash_offset_t)sizeof(mfs_bank_header_t);
+  hdr_offset = offset;
   while (hdr_offset < end_offset) {
     /* Reading the current record header.*/
     RET_ON_ERROR(mfs_flash_read(mfsp, hdr_offset,
@@ -453,16 +673,21 @@ static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
     }
     else if (sts == MFS_RECORD_OK) {
       /* Record OK.*/
-      uint32_t size = mfsp->buffer.dhdr.fields.size;
-
-      /* Zero-sized records are erase markers.*/
-      if (size == 0U) {
-        mfsp->descriptors[mfsp->buffer.dhdr.fields.id - 1U].offset = 0U;
-        mfsp->descriptors[mfsp->buffer.dhdr.fields.id - 1U].size   = 0U;
-      }
-      else {
-        mfsp->descriptors[mfsp->buffer.dhdr.fields.id - 1U].offset = hdr_offset;
-        mfsp->descriptors[mfsp->buffer.dhdr.fields.id - 1U].size   = size;
+      mfs_id_t id = (mfs_id_t)mfsp->buffer.dhdr.fields.id;
+      uint32_t size = MFS_SIZE(mfsp->buffer.dhdr.fields.size);
+
+      /* Index checkpoints are skipped.*/
+      if (id != (mfs_id_t)MFS_INDEX_ID) {
+        /* Zero-sized records are erase markers.*/
+        if (size == 0U) {
+          mfs_index_remove(mfsp, id);
+        }
+        /* The index cannot overflow, records are not created when it is
+           full.*/
+        else if (mfs_index_update(mfsp, id, hdr_offset, size) !=
+                 MFS_NO_ERROR) {
+          return MFS_ERR_INTERNAL;
+        }
       }
     }
     else if (sts == MFS_RECORD_CRC) {
@@ -475,6 +700,10 @@ static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
       warning = true;
       break;
     }
+
+    /* Next record header.*/
+    hdr_offset += (flash_offset_t)sizeof (mfs_data_header_t) +
+                  (flash_offset_t)MFS_SIZE(mfsp->buffer.dhdr.fields.size);
   }
 
   if (hdr_offset > end_offset) {
@@ -554,179 +783,1311 @@ static mfs_error_t mfs_bank_get_state(MFSDriver *mfsp,
     }
   }
 
-  /* If the header is erased then it could be the whole block erased.*/
+  /* If the header is erased then it could be the whole block erased,
+     else it is a bank left incomplete by an interrupted garbage
+     collection.*/
   err = mfs_bank_verify_erase(mfsp, bank);
   if (err == MFS_NO_ERROR) {
     *statep = MFS_BANK_ERASED;
   }
+  else if (err == MFS_ERR_NOT_ERASED) {
+    err = MFS_NO_ERROR;
+  }
 
   return err;
 }
 
 /**
- * @brief   Selects a bank as current.
- * @note    The bank header is assumed to be valid.
+ * @brief   Checks if a flash area is erased.
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
- * @param[in] bank      bank to be scanned
- * @param[out] statep   bank state, it can be:
- *                      - MFS_BANK_ERASED
- *                      - MFS_BANK_GARBAGE
- *                      - MFS_BANK_PARTIAL
- *                      - MFS_BANK_OK
- *                      .
+ * @param[in] offset    flash offset of the area
+ * @param[in] n         size of the area, it must be a multiple of four
+ * @param[out] erasedp  set to @p true if the area is erased
  * @return              The operation status.
  *
  * @notapi
  */
-static mfs_error_t mfs_bank_mount(MFSDriver *mfsp,
-                                  mfs_bank_t bank,
-                                  mfs_bank_state_t *statep) {
-  unsigned i;
-
-  /* Resetting the bank state, then reading the required header data.*/
-  mfs_state_reset(mfsp);
-  RET_ON_ERROR(mfs_bank_get_state(mfsp, bank, statep, &mfsp->current_counter));
-  mfsp->current_bank = bank;
+static mfs_error_t mfs_flash_is_erased(MFSDriver *mfsp,
+                                       flash_offset_t offset,
+                                       size_t n,
+                                       bool *erasedp) {
 
-  /* Scanning for the most recent instance of all records.*/
-  RET_ON_ERROR(mfs_bank_scan_records(mfsp, bank, statep));
+  *erasedp = true;
+  while (n > 0U) {
+    size_t i, chunk = n <= MFS_CFG_BUFFER_SIZE ? n : MFS_CFG_BUFFER_SIZE;
 
-  /* Calculating the effective used size.*/
-  mfsp->used_space = sizeof (mfs_bank_header_t);
-  for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
-    if (mfsp->descriptors[i].offset != 0U) {
-      mfsp->used_space += mfsp->descriptors[i].size + sizeof (mfs_data_header_t);
+    RET_ON_ERROR(mfs_flash_read(mfsp, offset, chunk, mfsp->buffer.data8));
+    for (i = 0U; i < chunk / sizeof (uint32_t); i++) {
+      if (mfsp->buffer.data32[i] != mfsp->config->erased) {
+        *erasedp = false;
+        return MFS_NO_ERROR;
+      }
     }
+    n      -= chunk;
+    offset += (flash_offset_t)chunk;
   }
 
   return MFS_NO_ERROR;
 }
 
 /**
- * @brief   Enforces a garbage collection.
- * @details Storage data is compacted into a single bank.
+ * @brief   Reads the index locators of the current bank.
+ * @details Locators are counted starting from the bank end, the scan stops
+ *          at the first invalid one.
  *
- * @param[out] mfsp     pointer to the @p MFSDriver object
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[out] offsetp  offset of the most recent index checkpoint, zero if
+ *                      there is no valid locator
  * @return              The operation status.
  *
  * @notapi
  */
-static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp) {
-  unsigned i;
-  mfs_bank_t sbank, dbank;
-  flash_offset_t dest_offset;
+static mfs_error_t mfs_index_read_locators(MFSDriver *mfsp,
+                                           flash_offset_t *offsetp) {
+  flash_offset_t start, slot;
 
-  sbank = mfsp->current_bank;
-  if (sbank == MFS_BANK_0) {
-    dbank = MFS_BANK_1;
-  }
-  else {
-    dbank = MFS_BANK_0;
-  }
-
-  /* Write address.*/
-  dest_offset = mfs_flash_get_bank_offset(mfsp, dbank) +
-                sizeof (mfs_bank_header_t);
-
-  /* Copying the most recent record instances only.*/
-  for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
-    uint32_t totsize = mfsp->descriptors[i].size + sizeof (mfs_data_header_t);
-    if (mfsp->descriptors[i].offset != 0) {
-      RET_ON_ERROR(mfs_flash_copy(mfsp, dest_offset,
-                                  mfsp->descriptors[i].offset,
-                                  totsize));
-      mfsp->descriptors[i].offset = dest_offset;
-      dest_offset += totsize;
-    }
-  }
+  start = mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
+          (flash_offset_t)sizeof (mfs_bank_header_t);
 
-  /* New current bank.*/
-  mfsp->current_bank = dbank;
-  mfsp->current_counter += 1U;
-  mfsp->next_offset = dest_offset;
+  *offsetp = 0U;
+  mfsp->locators = 0U;
+  while (true) {
+    uint16_t crc;
 
-  /* The header is written after the data.*/
-  RET_ON_ERROR(mfs_bank_write_header(mfsp, dbank, mfsp->current_counter));
+    slot = mfs_bank_get_limit(mfsp) -
+           (flash_offset_t)sizeof (mfs_index_locator_t);
+    if (slot < start + (flash_offset_t)sizeof (mfs_data_header_t)) {
+      break;
+    }
+
+    RET_ON_ERROR(mfs_flash_read(mfsp, slot,
+                                sizeof (mfs_index_locator_t),
+                                (void *)&mfsp->buffer.iloc));
+
+    /* Checking locator fields integrity.*/
+    crc = crc16(0xFFFFU, mfsp->buffer.iloc.hdr8,
+                sizeof (mfs_index_locator_t) - sizeof (uint16_t));
+    if ((mfsp->buffer.iloc.fields.magic != MFS_INDEX_MAGIC) ||
+        (mfsp->buffer.iloc.fields.counter != mfsp->current_counter) ||
+        (mfsp->buffer.iloc.fields.reserved1 != (uint16_t)mfsp->config->erased) ||
+        (mfsp->buffer.iloc.fields.crc != crc) ||
+        (mfsp->buffer.iloc.fields.offset < start) ||
+        (mfsp->buffer.iloc.fields.offset >= slot)) {
+      break;
+    }
 
-  /* The source bank is erased last.*/
-  RET_ON_ERROR(mfs_bank_erase(mfsp, sbank));
+    *offsetp = (flash_offset_t)mfsp->buffer.iloc.fields.offset;
+    mfsp->locators++;
+  }
 
   return MFS_NO_ERROR;
 }
 
 /**
- * @brief   Performs a flash partition mount attempt.
+ * @brief   Loads an index checkpoint.
+ * @details The checkpoint is validated, records written after it are
+ *          then found by scanning the bank starting from its end.
+ * @note    On failure the index is left empty and @p index_end is zero.
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] offset    offset of the index checkpoint record header
  * @return              The operation status.
  *
- * @api
+ * @notapi
  */
-static mfs_error_t mfs_try_mount(MFSDriver *mfsp) {
-  mfs_bank_state_t sts, sts0, sts1;
-  mfs_bank_t bank;
-  uint32_t cnt0 = 0, cnt1 = 0;
-  bool warning = false;
+static mfs_error_t mfs_index_load(MFSDriver *mfsp, flash_offset_t offset) {
+  flash_offset_t start;
+  mfs_record_state_t sts;
+  uint32_t size, prev;
+  unsigned i, n;
 
-  /* Assessing the state of the two banks.*/
-  RET_ON_ERROR(mfs_bank_get_state(mfsp, MFS_BANK_0, &sts0, &cnt0));
-  RET_ON_ERROR(mfs_bank_get_state(mfsp, MFS_BANK_1, &sts1, &cnt1));
+  start = mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
+          (flash_offset_t)sizeof (mfs_bank_header_t);
 
-  /* Handling all possible scenarios, each one requires its own recovery
-     strategy.*/
-  switch (PAIR(sts0, sts1)) {
+  /* Checking the checkpoint record header.*/
+  RET_ON_ERROR(mfs_flash_read(mfsp, offset,
+                              sizeof (mfs_data_header_t),
+                              (void *)&mfsp->buffer.dhdr));
+  RET_ON_ERROR(mfs_record_check(mfsp, &mfsp->buffer.dhdr,
+                                offset, mfs_bank_get_limit(mfsp), &sts));
+  size = mfsp->buffer.dhdr.fields.size;
+  n    = (unsigned)(size / sizeof (mfs_record_descriptor_t));
+  if ((sts != MFS_RECORD_OK) ||
+      (mfsp->buffer.dhdr.fields.id != (uint16_t)MFS_INDEX_ID) ||
+      ((size % sizeof (mfs_record_descriptor_t)) != 0U) ||
+      (n > (unsigned)MFS_CFG_INDEX_SIZE)) {
+    return MFS_NO_ERROR;
+  }
 
-  case PAIR(MFS_BANK_ERASED, MFS_BANK_ERASED):
-    /* Both banks erased, first initialization.*/
-    RET_ON_ERROR(mfs_bank_write_header(mfsp, MFS_BANK_0, 1));
-    bank = MFS_BANK_0;
-    break;
+  /* Reading the descriptors directly into the index.*/
+  RET_ON_ERROR(mfs_flash_read(mfsp, offset + sizeof (mfs_data_header_t),
+                              size, (uint8_t *)mfsp->descriptors));
+  if (crc16(0xFFFFU, (const uint8_t *)mfsp->descriptors, size) !=
+      mfsp->buffer.dhdr.fields.crc) {
+    return MFS_NO_ERROR;
+  }
 
-  case PAIR(MFS_BANK_OK, MFS_BANK_OK):
-    /* Both banks appear to be valid but one must be newer, erasing the
-       older one.*/
-    if (cnt0 > cnt1) {
-      /* Bank 0 is newer.*/
-      RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_1));
-      bank = MFS_BANK_0;
-    }
-    else {
-      /* Bank 1 is newer.*/
-      RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_0));
-      bank = MFS_BANK_1;
+  /* Descriptors must be sorted and must point to records placed before
+     the checkpoint.*/
+  prev = 0U;
+  for (i = 0U; i < n; i++) {
+    mfs_record_descriptor_t *dp = &mfsp->descriptors[i];
+
+    if ((dp->id <= prev) || (dp->id > (uint32_t)MFS_CFG_MAX_RECORDS) ||
+        (dp->size == 0U) || (dp->offset < start) || (dp->offset >= offset) ||
+        (dp->size + sizeof (mfs_data_header_t) > offset - dp->offset)) {
+      return MFS_NO_ERROR;
     }
-    warning = true;
-    break;
+    prev = dp->id;
+  }
 
-  case PAIR(MFS_BANK_GARBAGE, MFS_BANK_GARBAGE):
-    /* Both banks are unreadable, reinitializing.*/
-    RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_0));
-    RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_1));
-    RET_ON_ERROR(mfs_bank_write_header(mfsp, MFS_BANK_0, 1));
-    bank = MFS_BANK_0;
-    warning = true;
-    break;
+  mfsp->records   = n;
+  mfsp->index_end = offset + (flash_offset_t)sizeof (mfs_data_header_t) +
+                    (flash_offset_t)size;
 
-  case PAIR(MFS_BANK_ERASED, MFS_BANK_OK):
-    /* Normal situation, bank one is used.*/
-    bank = MFS_BANK_1;
-    break;
+  return MFS_NO_ERROR;
+}
 
-  case PAIR(MFS_BANK_OK, MFS_BANK_ERASED):
-    /* Normal situation, bank zero is used.*/
-    bank = MFS_BANK_0;
-    break;
+/**
+ * @brief   Writes an index checkpoint in the current bank.
+ * @details The checkpoint record is written in the log like a normal
+ *          record, then a locator pointing to it is written at the bank
+ *          end. The checkpoint is not written if the index did not change
+ *          since the previous checkpoint or if it would take more than
+ *          half of the free space.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_index_checkpoint(MFSDriver *mfsp) {
+  flash_offset_t size, slot;
 
-  case PAIR(MFS_BANK_ERASED, MFS_BANK_GARBAGE):
-    /* Bank zero is erased, bank one is not readable.*/
-    RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_1));
-    RET_ON_ERROR(mfs_bank_write_header(mfsp, MFS_BANK_0, 1));
-    bank = MFS_BANK_0;
-    warning = true;
-    break;
+  if (mfsp->next_offset == mfsp->index_end) {
+    return MFS_NO_ERROR;
+  }
 
-  case PAIR(MFS_BANK_GARBAGE, MFS_BANK_ERASED):
+  size = (flash_offset_t)mfsp->records *
+         (flash_offset_t)sizeof (mfs_record_descriptor_t);
+  if (((flash_offset_t)sizeof (mfs_data_header_t) + size +
+       (flash_offset_t)sizeof (mfs_index_locator_t)) * 2U >
+      mfs_bank_get_free(mfsp)) {
+    return MFS_NO_ERROR;
+  }
+
+  /* Writing the checkpoint header without the magic, it will be written
+     last.*/
+  mfsp->buffer.dhdr.fields.magic = (uint32_t)mfsp->config->erased;
+  mfsp->buffer.dhdr.fields.id    = (uint16_t)MFS_INDEX_ID;
+  mfsp->buffer.dhdr.fields.size  = (uint32_t)size;
+  mfsp->buffer.dhdr.fields.crc   = crc16(0xFFFFU,
+                                         (const uint8_t *)mfsp->descriptors,
+                                         size);
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfsp->next_offset,
+                               sizeof (mfs_data_header_t),
+                               mfsp->buffer.data8));
+
+  /* Writing the descriptors.*/
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfsp->next_offset + sizeof (mfs_data_header_t),
+                               size,
+                               (const uint8_t *)mfsp->descriptors));
+
+  /* Writing the magic number, the checkpoint is now a valid record.*/
+  mfsp->buffer.dhdr.fields.magic = (uint32_t)MFS_HEADER_MAGIC;
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfsp->next_offset,
+                               sizeof (uint32_t),
+                               mfsp->buffer.data8));
+
+  /* Finally writing the locator, it makes the checkpoint visible to the
+     next mount.*/
+  slot = mfs_bank_get_limit(mfsp) -
+         (flash_offset_t)sizeof (mfs_index_locator_t);
+  mfsp->buffer.iloc.fields.magic     = MFS_INDEX_MAGIC;
+  mfsp->buffer.iloc.fields.offset    = (uint32_t)mfsp->next_offset;
+  mfsp->buffer.iloc.fields.counter   = mfsp->current_counter;
+  mfsp->buffer.iloc.fields.reserved1 = (uint16_t)mfsp->config->erased;
+  mfsp->buffer.iloc.fields.crc       = crc16(0xFFFFU, mfsp->buffer.iloc.hdr8,
+                                             sizeof (mfs_index_locator_t) -
+                                             sizeof (uint16_t));
+  mfsp->locators++;
+  mfsp->next_offset += (flash_offset_t)sizeof (mfs_data_header_t) + size;
+  mfsp->index_end    = mfsp->next_offset;
+
+  return mfs_flash_write(mfsp, slot,
+                         sizeof (mfs_index_locator_t),
+                         mfsp->buffer.data8);
+}
+
+/**
+ * @brief   Selects a bank as current.
+ * @note    The bank header is assumed to be valid.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] bank      bank to be scanned
+ * @param[out] statep   bank state, it can be:
+ *                      - MFS_BANK_ERASED
+ *                      - MFS_BANK_GARBAGE
+ *                      - MFS_BANK_PARTIAL
+ *                      - MFS_BANK_OK
+ *                      .
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_bank_mount(MFSDriver *mfsp,
+                                  mfs_bank_t bank,
+                                  mfs_bank_state_t *statep) {
+  flash_offset_t offset, slot;
+  bool erased;
+  unsigned i;
+
+  /* Resetting the bank state, then reading the required header data.*/
+  mfs_state_reset(mfsp);
+  RET_ON_ERROR(mfs_bank_get_state(mfsp, bank, statep, &mfsp->current_counter));
+  mfsp->current_bank = bank;
+
+  /* Loading the most recent index checkpoint, if any, only the records
+     written after it need to be scanned.*/
+  RET_ON_ERROR(mfs_index_read_locators(mfsp, &offset));
+  if (offset != 0U) {
+    RET_ON_ERROR(mfs_index_load(mfsp, offset));
+  }
+  if (mfsp->index_end != 0U) {
+    offset = mfsp->index_end;
+  }
+  else {
+    offset = mfs_flash_get_bank_offset(mfsp, bank) +
+             (flash_offset_t)sizeof (mfs_bank_header_t);
+  }
+
+  /* Scanning for the most recent instance of all records.*/
+  RET_ON_ERROR(mfs_bank_scan_records(mfsp, offset, statep));
+
+  /* A dirty locator slot above the records area is left by an interrupted
+     checkpoint, the bank needs to be repaired.*/
+  slot = mfs_bank_get_limit(mfsp) -
+         (flash_offset_t)sizeof (mfs_index_locator_t);
+  if (slot >= mfsp->next_offset) {
+    RET_ON_ERROR(mfs_flash_is_erased(mfsp, slot,
+                                     sizeof (mfs_index_locator_t),
+                                     &erased));
+    if (!erased) {
+      *statep = MFS_BANK_PARTIAL;
+    }
+  }
+
+  /* Calculating the effective used size.*/
+  mfsp->used_space = sizeof (mfs_bank_header_t);
+  for (i = 0U; i < mfsp->records; i++) {
+    mfsp->used_space += mfsp->descriptors[i].size + sizeof (mfs_data_header_t);
+  }
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Starts a garbage collection.
+ * @details The collection is performed by @p mfs_gc_step(), the other
+ *          bank is assumed to be erased.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ *
+ * @notapi
+ */
+static void mfs_gc_start(MFSDriver *mfsp) {
+
+  mfsp->gc_state  = MFS_GC_COPY;
+  mfsp->gc_id     = 0U;
+  mfsp->gc_offset = mfs_flash_get_bank_offset(mfsp,
+                      mfs_get_other_bank(mfsp->current_bank)) +
+                    sizeof (mfs_bank_header_t);
+}
+
+/**
+ * @brief   Copies a record in the other bank.
+ * @note    Records updated in the current bank after having been copied
+ *          are copied again, each copy is matched by the same amount of
+ *          space consumed in the current bank so the other bank cannot
+ *          overflow if the collection started with an amount of obsolete
+ *          data not smaller than the free space.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        identifier of the record to be copied
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_gc_copy_record(MFSDriver *mfsp, mfs_id_t id) {
+  mfs_record_descriptor_t *dp;
+  flash_offset_t end, totsize;
+
+  dp  = mfs_index_find(mfsp, id);
+  end = mfs_flash_get_bank_offset(mfsp,
+          mfs_get_other_bank(mfsp->current_bank)) + mfsp->config->bank_size;
+  totsize = (flash_offset_t)sizeof (mfs_data_header_t) +
+            (dp != NULL ? (flash_offset_t)dp->size : 0U);
+  if (totsize > end - mfsp->gc_offset) {
+    return MFS_ERR_INTERNAL;
+  }
+
+  if (dp != NULL) {
+    /* Copying the most recent record instance.*/
+    RET_ON_ERROR(mfs_flash_copy(mfsp, mfsp->gc_offset, dp->offset, totsize));
+    dp->offset = mfsp->gc_offset;
+  }
+  else {
+    /* The record has been erased after having been copied, writing an
+       erase marker.*/
+    mfsp->buffer.dhdr.fields.magic = (uint32_t)MFS_HEADER_MAGIC;
+    mfsp->buffer.dhdr.fields.id    = (uint16_t)id;
+    mfsp->buffer.dhdr.fields.size  = (uint32_t)0;
+    mfsp->buffer.dhdr.fields.crc   = (uint16_t)0;
+    RET_ON_ERROR(mfs_flash_write(mfsp,
+                                 mfsp->gc_offset,
+                                 sizeof (mfs_data_header_t),
+                                 mfsp->buffer.data8));
+  }
+  mfsp->gc_offset += totsize;
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Performs a garbage collection elementary operation.
+ * @details Records are copied one at time in the other bank, the bank
+ *          header is written after the data and the old bank becomes
+ *          the other bank, its sectors are then erased one at time.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_gc_step(MFSDriver *mfsp) {
+  flash_sector_t start, end;
+
+  if (mfsp->gc_state == MFS_GC_COPY) {
+
+    unsigned i = mfs_index_lower_bound(mfsp, (uint32_t)mfsp->gc_id + 1U);
+
+    /* Copying the next existing record, if any.*/
+    if (i < mfsp->records) {
+      mfsp->gc_id = (mfs_id_t)mfsp->descriptors[i].id;
+      return mfs_gc_copy_record(mfsp, mfsp->gc_id);
+    }
+
+    /* New current bank.*/
+    mfsp->current_bank = mfs_get_other_bank(mfsp->current_bank);
+    mfsp->current_counter += 1U;
+    mfsp->next_offset = mfsp->gc_offset;
+    mfsp->locators    = 0U;
+    mfsp->index_end   = 0U;
+
+    /* The header is written after the data.*/
+    RET_ON_ERROR(mfs_bank_write_header(mfsp, mfsp->current_bank,
+                                       mfsp->current_counter));
+
+    /* The source bank is erased last.*/
+    mfs_bank_get_sectors(mfsp, mfs_get_other_bank(mfsp->current_bank),
+                         &mfsp->gc_sector, &end);
+    mfsp->gc_state = MFS_GC_ERASE;
+  }
+  else if (mfsp->gc_state == MFS_GC_ERASE) {
+    RET_ON_ERROR(mfs_flash_erase_sector(mfsp, mfsp->gc_sector));
+    mfsp->gc_sector++;
+
+    mfs_bank_get_sectors(mfsp, mfs_get_other_bank(mfsp->current_bank),
+                         &start, &end);
+    if (mfsp->gc_sector >= end) {
+      mfsp->gc_state = MFS_GC_IDLE;
+    }
+  }
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Completes a garbage collection in progress, if any.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_gc_finish(MFSDriver *mfsp) {
+
+  while (mfsp->gc_state != MFS_GC_IDLE) {
+    RET_ON_ERROR(mfs_gc_step(mfsp));
+  }
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Enforces a garbage collection.
+ * @details Storage data is compacted into a single bank.
+ *
+ * @param[out] mfsp     pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp) {
+
+  /* A collection in progress is completed first, the other bank must be
+     erased before starting a new one.*/
+  RET_ON_ERROR(mfs_gc_finish(mfsp));
+
+  mfs_gc_start(mfsp);
+
+  return mfs_gc_finish(mfsp);
+}
+
+/**
+ * @brief   Makes sure that the required space is available in the current
+ *          bank.
+ * @details A garbage collection in progress is completed first, a full
+ *          garbage collection is then performed if the space is still not
+ *          enough.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] required  required space
+ * @param[out] gcp      set to @p true if a garbage collection has been
+ *                      performed
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_reserve_space(MFSDriver *mfsp,
+                                     flash_offset_t required,
+                                     bool *gcp) {
+
+  if (required > mfs_bank_get_free(mfsp)) {
+    /* We need to perform a garbage collection, there is enough space
+       but it has to be freed.*/
+    *gcp = true;
+    RET_ON_ERROR(mfs_gc_finish(mfsp));
+    if (required > mfs_bank_get_free(mfsp)) {
+      RET_ON_ERROR(mfs_garbage_collect(mfsp));
+    }
+  }
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Makes sure that a record can be written at @p next_offset.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record numeric identifier
+ * @param[in] n         size of data to be written
+ * @param[out] gcp      set to @p true if a garbage collection has been
+ *                      performed
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_record_prepare(MFSDriver *mfsp, mfs_id_t id,
+                                      size_t n, bool *gcp) {
+  flash_offset_t required;
+
+  /* If the required space is beyond the available (compacted) block
+     size then an error is returned.
+     NOTE: The space for one extra header is reserved in order to allow
+     for an erase operation after the space has been fully allocated.*/
+  required = ((flash_offset_t)sizeof (mfs_data_header_t) * 2U) +
+             (flash_offset_t)n;
+  if (required > mfsp->config->bank_size - mfsp->used_space) {
+    return MFS_ERR_OUT_OF_MEM;
+  }
+
+  /* A new record requires a free index entry.*/
+  if ((mfs_index_find(mfsp, id) == NULL) &&
+      (mfsp->records >= (unsigned)MFS_CFG_INDEX_SIZE)) {
+    return MFS_ERR_OUT_OF_MEM;
+  }
+
+  /* Checking for immediately (not compacted) available space.*/
+  return mfs_reserve_space(mfsp, required, gcp);
+}
+
+/**
+ * @brief   Updates the driver state after a record has been written at
+ *          @p next_offset.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record numeric identifier
+ * @param[in] n         size of the written data
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_record_commit(MFSDriver *mfsp, mfs_id_t id,
+                                     size_t n) {
+  mfs_record_descriptor_t *dp;
+
+  /* The size of the old record instance, if present, must be subtracted
+     to the total used size.*/
+  dp = mfs_index_find(mfsp, id);
+  if (dp != NULL) {
+    mfsp->used_space -= sizeof (mfs_data_header_t) + dp->size;
+  }
+
+  /* Adjusting bank-related metadata.*/
+  RET_ON_ERROR(mfs_index_update(mfsp, id, mfsp->next_offset, (uint32_t)n));
+  mfsp->next_offset += sizeof (mfs_data_header_t) + n;
+  mfsp->used_space  += sizeof (mfs_data_header_t) + n;
+
+  /* If the record has already been copied by a garbage collection in
+     progress then it has to be copied again.*/
+  if ((mfsp->gc_state == MFS_GC_COPY) && (id <= mfsp->gc_id)) {
+    RET_ON_ERROR(mfs_gc_copy_record(mfsp, id));
+  }
+
+  return MFS_NO_ERROR;
+}
+
+#if (MFS_CFG_USE_COMPRESSION == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Flushes the buffered compressed data.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] wp        pointer to the writer object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_lz_flush(MFSDriver *mfsp, mfs_lz_writer_t *wp) {
+
+  if (wp->n > 0U) {
+    wp->crc = crc16(wp->crc, mfsp->buffer.data8, wp->n);
+    if (wp->write) {
+      RET_ON_ERROR(mfs_flash_write(mfsp, wp->offset, wp->n,
+                                   mfsp->buffer.data8));
+    }
+    wp->offset += (flash_offset_t)wp->n;
+    wp->size   += wp->n;
+    wp->n       = 0U;
+  }
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Emits compressed data.
+ * @note    The buffer is flushed at program page boundaries.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] wp        pointer to the writer object
+ * @param[in] p         pointer to the data to be emitted
+ * @param[in] n         number of bytes to be emitted
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_lz_emit(MFSDriver *mfsp, mfs_lz_writer_t *wp,
+                               const uint8_t *p, size_t n) {
+
+  while (n > 0U) {
+    mfsp->buffer.data8[wp->n] = *p;
+    wp->n++;
+    p++;
+    n--;
+    if (((wp->offset + wp->n) & (MFS_CFG_BUFFER_SIZE - 1U)) == 0U) {
+      RET_ON_ERROR(mfs_lz_flush(mfsp, wp));
+    }
+  }
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Compresses a record.
+ * @details The stream is composed by the uncompressed size, 32 bits little
+ *          endian, followed by groups of eight items preceded by a flags
+ *          byte. A clear flag is a literal byte, a set flag is a two bytes
+ *          match: 4 bits length minus 3 and 12 bits offset minus one, the
+ *          length 18 is followed by a byte to be added to the length.
+ * @note    The compression stops when the compressed size reaches
+ *          @p limit, the reported size is then @p limit.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] wp        pointer to the writer object
+ * @param[in] src       pointer to the record data
+ * @param[in] n         size of the record data
+ * @param[in] limit     compressed size limit
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_lz_compress(MFSDriver *mfsp, mfs_lz_writer_t *wp,
+                                   const uint8_t *src, size_t n,
+                                   size_t limit) {
+  uint8_t grp[1U + (8U * 3U)];
+  size_t i, glen;
+  unsigned items;
+
+  grp[0] = (uint8_t)n;
+  grp[1] = (uint8_t)(n >> 8);
+  grp[2] = (uint8_t)(n >> 16);
+  grp[3] = (uint8_t)(n >> 24);
+  RET_ON_ERROR(mfs_lz_emit(mfsp, wp, grp, 4U));
+
+  i     = 0U;
+  glen  = 1U;
+  items = 0U;
+  grp[0] = 0U;
+  while (i < n) {
+    size_t best = 0U, boff = 0U, off;
+
+    /* Longest match search in the window, matches can overlap the
+       current position.*/
+    for (off = 1U; (off <= MFS_CFG_COMPRESSION_WINDOW) && (off <= i); off++) {
+      size_t len = 0U;
+
+      while ((len < MFS_LZ_MAX_MATCH) && (i + len < n) &&
+             (src[i + len] == src[i + len - off])) {
+        len++;
+      }
+      if (len > best) {
+        best = len;
+        boff = off;
+        if (len == MFS_LZ_MAX_MATCH) {
+          break;
+        }
+      }
+    }
+
+    if (best >= MFS_LZ_MIN_MATCH) {
+      size_t code = best - MFS_LZ_MIN_MATCH;
+
+      grp[0] |= (uint8_t)(1U << items);
+      grp[glen++] = (uint8_t)(((code < 15U ? code : 15U) << 4) |
+                              ((boff - 1U) >> 8));
+      grp[glen++] = (uint8_t)(boff - 1U);
+      if (code >= 15U) {
+        grp[glen++] = (uint8_t)(code - 15U);
+      }
+      i += best;
+    }
+    else {
+      grp[glen++] = src[i];
+      i++;
+    }
+
+    /* Groups are emitted when complete or at the end of data.*/
+    items++;
+    if ((items == 8U) || (i >= n)) {
+      RET_ON_ERROR(mfs_lz_emit(mfsp, wp, grp, glen));
+      if (wp->size + wp->n >= limit) {
+        wp->size = limit;
+        return MFS_NO_ERROR;
+      }
+      glen  = 1U;
+      items = 0U;
+      grp[0] = 0U;
+    }
+  }
+
+  return mfs_lz_flush(mfsp, wp);
+}
+
+/**
+ * @brief   Returns the next compressed data byte.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] rp        pointer to the reader object
+ * @param[out] bp       pointer to the returned byte
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_lz_get(MFSDriver *mfsp, mfs_lz_reader_t *rp,
+                              uint8_t *bp) {
+
+  if (rp->pos >= rp->n) {
+    if (rp->remaining == 0U) {
+      /* Truncated data.*/
+      mfsp->state = MFS_ERROR;
+      return MFS_ERR_FLASH_FAILURE;
+    }
+    rp->n = rp->remaining <= MFS_CFG_BUFFER_SIZE ? rp->remaining :
+                                                   MFS_CFG_BUFFER_SIZE;
+    RET_ON_ERROR(mfs_flash_read(mfsp, rp->offset, rp->n,
+                                mfsp->buffer.data8));
+    rp->crc        = crc16(rp->crc, mfsp->buffer.data8, rp->n);
+    rp->offset    += (flash_offset_t)rp->n;
+    rp->remaining -= rp->n;
+    rp->pos        = 0U;
+  }
+
+  *bp = mfsp->buffer.data8[rp->pos];
+  rp->pos++;
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Reads and decompresses a record from flash.
+ * @pre     The record header is in the driver buffer.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] dp        pointer to the record descriptor
+ * @param[in,out] np    on input is the maximum buffer size, on return it is
+ *                      the size of the data copied into the buffer
+ * @param[out] buffer   pointer to a buffer for record data
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_lz_read_record(MFSDriver *mfsp,
+                                      mfs_record_descriptor_t *dp,
+                                      size_t *np, uint8_t *buffer) {
+  mfs_lz_reader_t lzr;
+  uint16_t hcrc = mfsp->buffer.dhdr.fields.crc;
+  uint8_t b[4];
+  size_t size, out;
+  unsigned i;
+
+  lzr.offset    = dp->offset + (flash_offset_t)sizeof (mfs_data_header_t);
+  lzr.remaining = (size_t)dp->size;
+  lzr.pos       = 0U;
+  lzr.n         = 0U;
+  lzr.crc       = 0xFFFFU;
+
+  /* Uncompressed size.*/
+  for (i = 0U; i < 4U; i++) {
+    RET_ON_ERROR(mfs_lz_get(mfsp, &lzr, &b[i]));
+  }
+  size = (size_t)b[0] | ((size_t)b[1] << 8) |
+         ((size_t)b[2] << 16) | ((size_t)b[3] << 24);
+
+  /* Making sure to not overflow the buffer.*/
+  if (*np < size) {
+    return MFS_ERR_INV_SIZE;
+  }
+
+  out = 0U;
+  while (out < size) {
+    uint8_t flags;
+    unsigned bit;
+
+    RET_ON_ERROR(mfs_lz_get(mfsp, &lzr, &flags));
+    for (bit = 0U; (bit < 8U) && (out < size); bit++) {
+      if ((flags & (1U << bit)) != 0U) {
+        size_t len, off;
+
+        RET_ON_ERROR(mfs_lz_get(mfsp, &lzr, &b[0]));
+        RET_ON_ERROR(mfs_lz_get(mfsp, &lzr, &b[1]));
+        len = ((size_t)b[0] >> 4) + MFS_LZ_MIN_MATCH;
+        off = ((((size_t)b[0] & 15U) << 8) | (size_t)b[1]) + 1U;
+        if (len == MFS_LZ_MIN_MATCH + 15U) {
+          RET_ON_ERROR(mfs_lz_get(mfsp, &lzr, &b[2]));
+          len += (size_t)b[2];
+        }
+        if ((off > out) || (len > size - out)) {
+          mfsp->state = MFS_ERROR;
+          return MFS_ERR_FLASH_FAILURE;
+        }
+        while (len > 0U) {
+          buffer[out] = buffer[out - off];
+          out++;
+          len--;
+        }
+      }
+      else {
+        RET_ON_ERROR(mfs_lz_get(mfsp, &lzr, &buffer[out]));
+        out++;
+      }
+    }
+  }
+
+  /* Checking that all data has been consumed and the CRC.*/
+  if ((lzr.remaining > 0U) || (lzr.pos < lzr.n) || (lzr.crc != hcrc)) {
+    mfsp->state = MFS_ERROR;
+    return MFS_ERR_FLASH_FAILURE;
+  }
+
+  *np = size;
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Writes a compressed record in flash.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record numeric identifier
+ * @param[in] n         size of data to be written
+ * @param[in] buffer    pointer to a buffer for record data
+ * @param[in] size      size of the compressed data
+ * @param[in] crc       CRC of the compressed data
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_lz_write_record(MFSDriver *mfsp, mfs_id_t id,
+                                       size_t n, const uint8_t *buffer,
+                                       size_t size, uint16_t crc) {
+  mfs_lz_writer_t lzw;
+  bool warning = false;
+
+  RET_ON_ERROR(mfs_record_prepare(mfsp, id, size, &warning));
+
+  /* Writing the data header without the magic, it will be written last.*/
+  mfsp->buffer.dhdr.fields.magic = (uint32_t)mfsp->config->erased;
+  mfsp->buffer.dhdr.fields.id    = (uint16_t)id;
+  mfsp->buffer.dhdr.fields.size  = (uint32_t)size | MFS_SIZE_COMPRESSED;
+  mfsp->buffer.dhdr.fields.crc   = crc;
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfsp->next_offset,
+                               sizeof (mfs_data_header_t),
+                               mfsp->buffer.data8));
+
+  /* Writing the compressed data, it must match the first pass.*/
+  lzw.offset = mfsp->next_offset + (flash_offset_t)sizeof (mfs_data_header_t);
+  lzw.n      = 0U;
+  lzw.size   = 0U;
+  lzw.crc    = 0xFFFFU;
+  lzw.write  = true;
+  RET_ON_ERROR(mfs_lz_compress(mfsp, &lzw, buffer, n, n));
+  if ((lzw.size != size) || (lzw.crc != crc)) {
+    return MFS_ERR_INTERNAL;
+  }
+
+  /* Finally writing the magic number, it seals the transaction.*/
+  mfsp->buffer.dhdr.fields.magic = (uint32_t)MFS_HEADER_MAGIC;
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfsp->next_offset,
+                               sizeof (uint32_t),
+                               mfsp->buffer.data8));
+
+  RET_ON_ERROR(mfs_record_commit(mfsp, id, size));
+
+  return warning ? MFS_WARN_GC : MFS_NO_ERROR;
+}
+#endif /* MFS_CFG_USE_COMPRESSION == TRUE */
+
+/**
+ * @brief   Writes a record in flash.
+ * @note    If the option @p MFS_CFG_USE_COMPRESSION is enabled then the
+ *          record is written compressed if it shrinks.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record numeric identifier
+ * @param[in] n         size of data to be written
+ * @param[in] buffer    pointer to a buffer for record data
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_record_write(MFSDriver *mfsp, mfs_id_t id,
+                                    size_t n, const uint8_t *buffer) {
+  bool warning = false;
+
+#if MFS_CFG_USE_COMPRESSION == TRUE
+  {
+    mfs_lz_writer_t lzw;
+
+    /* First pass, the compressed size and CRC are calculated without
+       writing anything.*/
+    lzw.offset = (flash_offset_t)0;
+    lzw.n      = 0U;
+    lzw.size   = 0U;
+    lzw.crc    = 0xFFFFU;
+    lzw.write  = false;
+    RET_ON_ERROR(mfs_lz_compress(mfsp, &lzw, buffer, n, n));
+    if (lzw.size < n) {
+      return mfs_lz_write_record(mfsp, id, n, buffer, lzw.size, lzw.crc);
+    }
+  }
+#endif
+
+  RET_ON_ERROR(mfs_record_prepare(mfsp, id, n, &warning));
+
+  /* Writing the data header without the magic, it will be written last.*/
+  mfsp->buffer.dhdr.fields.magic = (uint32_t)mfsp->config->erased;
+  mfsp->buffer.dhdr.fields.id    = (uint16_t)id;
+  mfsp->buffer.dhdr.fields.size  = (uint32_t)n;
+  mfsp->buffer.dhdr.fields.crc   = crc16(0xFFFFU, buffer, n);
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfsp->next_offset,
+                               sizeof (mfs_data_header_t),
+                               mfsp->buffer.data8));
+
+  /* Writing the data part.*/
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfsp->next_offset + sizeof (mfs_data_header_t),
+                               n,
+                               buffer));
+
+  /* Finally writing the magic number, it seals the transaction.*/
+  mfsp->buffer.dhdr.fields.magic = (uint32_t)MFS_HEADER_MAGIC;
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfsp->next_offset,
+                               sizeof (uint32_t),
+                               mfsp->buffer.data8));
+
+  RET_ON_ERROR(mfs_record_commit(mfsp, id, n));
+
+  return warning ? MFS_WARN_GC : MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Erases a record in flash.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record numeric identifier
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_record_erase(MFSDriver *mfsp, mfs_id_t id) {
+  mfs_record_descriptor_t *dp;
+  flash_offset_t required;
+  bool warning = false;
+
+  /* Checking if the requested record actually exists.*/
+  if (mfs_index_find(mfsp, id) == NULL) {
+    return MFS_ERR_NOT_FOUND;
+  }
+
+  /* If the required space is beyond the available (compacted) block
+     size then an internal error is returned, it should never happen.*/
+  required = (flash_offset_t)sizeof (mfs_data_header_t);
+  if (required > mfsp->config->bank_size - mfsp->used_space) {
+    return MFS_ERR_INTERNAL;
+  }
+
+  /* Checking for immediately (not compacted) available space.*/
+  RET_ON_ERROR(mfs_reserve_space(mfsp, required, &warning));
+
+  /* Writing the data header with size set to zero, it means that the
+     record is logically erased.*/
+  mfsp->buffer.dhdr.fields.magic = (uint32_t)MFS_HEADER_MAGIC;
+  mfsp->buffer.dhdr.fields.id    = (uint16_t)id;
+  mfsp->buffer.dhdr.fields.size  = (uint32_t)0;
+  mfsp->buffer.dhdr.fields.crc   = (uint16_t)0;
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfsp->next_offset,
+                               sizeof (mfs_data_header_t),
+                               mfsp->buffer.data8));
+
+  /* Adjusting bank-related metadata, the descriptor is looked up again
+     because a garbage collection could have moved the record.*/
+  dp = mfs_index_find(mfsp, id);
+  mfsp->used_space  -= sizeof (mfs_data_header_t) + dp->size;
+  mfsp->next_offset += sizeof (mfs_data_header_t);
+  mfs_index_remove(mfsp, id);
+
+  /* If the record has already been copied by a garbage collection in
+     progress then an erase marker is required in the other bank too.*/
+  if ((mfsp->gc_state == MFS_GC_COPY) && (id <= mfsp->gc_id)) {
+    RET_ON_ERROR(mfs_gc_copy_record(mfsp, id));
+  }
+
+  return warning ? MFS_WARN_GC : MFS_NO_ERROR;
+}
+
+#if (MFS_CFG_WRITE_CACHE_RECORDS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Finds the pending update of a record.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record numeric identifier
+ * @return              Pointer to the cache entry.
+ * @retval NULL         if there is no pending update for the record.
+ *
+ * @notapi
+ */
+static mfs_cache_entry_t *mfs_cache_find(MFSDriver *mfsp, mfs_id_t id) {
+  unsigned i;
+
+  for (i = 0U; i < mfsp->cache_count; i++) {
+    if (mfsp->cache[i].id == id) {
+      return &mfsp->cache[i];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Discards the pending update of a record, if any.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record numeric identifier
+ * @return              The discard status.
+ * @retval false        if there was no pending update for the record.
+ * @retval true         if the pending update has been discarded.
+ *
+ * @notapi
+ */
+static bool mfs_cache_remove(MFSDriver *mfsp, mfs_id_t id) {
+  mfs_cache_entry_t *cep = mfs_cache_find(mfsp, id);
+
+  if (cep == NULL) {
+    return false;
+  }
+
+  /* Keeping the updates in arrival order.*/
+  mfsp->cache_count--;
+  memmove((void *)cep, (void *)(cep + 1),
+          (size_t)(&mfsp->cache[mfsp->cache_count] - cep) *
+          sizeof (mfs_cache_entry_t));
+
+  return true;
+}
+
+/**
+ * @brief   Checks if a record update can be cached.
+ * @details The update can be cached if all pending updates would fit in
+ *          the storage as new records, this way writing them back cannot
+ *          fail for lack of space.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record numeric identifier
+ * @param[in] n         size of data to be written
+ * @return              The check result.
+ *
+ * @notapi
+ */
+static bool mfs_cache_fits(MFSDriver *mfsp, mfs_id_t id, size_t n) {
+  flash_offset_t required;
+  unsigned i, records;
+
+  if (n > (size_t)MFS_CFG_WRITE_CACHE_DATA_SIZE) {
+    return false;
+  }
+
+  /* A new entry requires the cache to be written back first.*/
+  if ((mfs_cache_find(mfsp, id) == NULL) &&
+      (mfsp->cache_count >= (unsigned)MFS_CFG_WRITE_CACHE_RECORDS)) {
+    return false;
+  }
+
+  /* Same space reservation of mfsWriteRecord() for the new update.*/
+  required = ((flash_offset_t)sizeof (mfs_data_header_t) * 2U) +
+             (flash_offset_t)n;
+  records  = mfs_index_find(mfsp, id) == NULL ? 1U : 0U;
+  for (i = 0U; i < mfsp->cache_count; i++) {
+    if (mfsp->cache[i].id != id) {
+      required += (flash_offset_t)sizeof (mfs_data_header_t) +
+                  (flash_offset_t)mfsp->cache[i].size;
+      if (mfs_index_find(mfsp, mfsp->cache[i].id) == NULL) {
+        records++;
+      }
+    }
+  }
+
+  return (required <= mfsp->config->bank_size - mfsp->used_space) &&
+         (records <= (unsigned)MFS_CFG_INDEX_SIZE - mfsp->records);
+}
+
+/**
+ * @brief   Writes the pending updates to flash.
+ * @note    Updates are written in arrival order.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_cache_flush(MFSDriver *mfsp) {
+  mfs_error_t warning = MFS_NO_ERROR;
+
+  while (mfsp->cache_count > 0U) {
+    mfs_error_t err;
+
+    err = mfs_record_write(mfsp, mfsp->cache[0].id,
+                           mfsp->cache[0].size, mfsp->cache[0].data);
+    if (MFS_IS_ERROR(err)) {
+      return err;
+    }
+    if (err != MFS_NO_ERROR) {
+      warning = err;
+    }
+    (void)mfs_cache_remove(mfsp, mfsp->cache[0].id);
+  }
+
+  return warning;
+}
+
+/**
+ * @brief   Writes the pending updates to flash if the oldest one is
+ *          expired.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_cache_check_timeout(MFSDriver *mfsp) {
+
+#if MFS_CFG_WRITE_CACHE_TIMEOUT > 0
+  if ((mfsp->cache_count > 0U) &&
+      (osalTimeDiffX(mfsp->cache_time, osalOsGetSystemTimeX()) >=
+       TIME_MS2I(MFS_CFG_WRITE_CACHE_TIMEOUT))) {
+    return mfs_cache_flush(mfsp);
+  }
+#else
+  (void)mfsp;
+#endif
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Caches a record update.
+ * @note    The cache space must have been checked using
+ *          @p mfs_cache_fits().
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record numeric identifier
+ * @param[in] n         size of data to be written
+ * @param[in] buffer    pointer to a buffer for record data
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_cache_write(MFSDriver *mfsp, mfs_id_t id,
+                                   size_t n, const uint8_t *buffer) {
+  mfs_cache_entry_t *cep = mfs_cache_find(mfsp, id);
+
+  if (cep == NULL) {
+    if (mfsp->cache_count == 0U) {
+      mfsp->cache_time = osalOsGetSystemTimeX();
+    }
+    cep = &mfsp->cache[mfsp->cache_count];
+    cep->id = id;
+    mfsp->cache_count++;
+  }
+  memcpy((void *)cep->data, (const void *)buffer, n);
+  cep->size = n;
+
+  return mfs_cache_check_timeout(mfsp);
+}
+#endif /* MFS_CFG_WRITE_CACHE_RECORDS > 0 */
+
+/**
+ * @brief   Makes sure that a read stream still refers to its record.
+ * @details Records moved by a garbage collection are located again, an
+ *          updated or erased record makes the stream invalid.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] rsp       pointer to the stream object
+ * @return              The operation status.
+ * @retval MFS_ERR_NOT_FOUND if the record has been updated or erased.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_stream_locate(MFSDriver *mfsp,
+                                     mfs_record_stream_t *rsp) {
+  mfs_record_descriptor_t *dp;
+
+#if MFS_CFG_WRITE_CACHE_RECORDS > 0
+  if (mfs_cache_find(mfsp, rsp->id) != NULL) {
+    return MFS_ERR_NOT_FOUND;
+  }
+#endif
+
+  dp = mfs_index_find(mfsp, rsp->id);
+  if ((dp == NULL) || (dp->size != rsp->size)) {
+    return MFS_ERR_NOT_FOUND;
+  }
+
+  if ((dp->offset != rsp->offset) ||
+      (mfsp->current_counter != rsp->counter)) {
+    /* The record moved, it is the same record if the CRC matches.*/
+    RET_ON_ERROR(mfs_flash_read(mfsp, dp->offset,
+                                sizeof (mfs_data_header_t),
+                                mfsp->buffer.data8));
+    if (mfsp->buffer.dhdr.fields.crc != rsp->hcrc) {
+      return MFS_ERR_NOT_FOUND;
+    }
+    rsp->offset  = dp->offset;
+    rsp->counter = mfsp->current_counter;
+  }
+
+  return MFS_NO_ERROR;
+}
+/**
+ * @brief   Performs a flash partition mount attempt.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @api
+ */
+static mfs_error_t mfs_try_mount(MFSDriver *mfsp) {
+  mfs_bank_state_t sts, sts0, sts1;
+  mfs_bank_t bank;
+  uint32_t cnt0 = 0, cnt1 = 0;
+  bool warning = false;
+
+  /* Assessing the state of the two banks.*/
+  RET_ON_ERROR(mfs_bank_get_state(mfsp, MFS_BANK_0, &sts0, &cnt0));
+  RET_ON_ERROR(mfs_bank_get_state(mfsp, MFS_BANK_1, &sts1, &cnt1));
+
+  /* Handling all possible scenarios, each one requires its own recovery
+     strategy.*/
+  switch (PAIR(sts0, sts1)) {
+
+  case PAIR(MFS_BANK_ERASED, MFS_BANK_ERASED):
+    /* Both banks erased, first initialization.*/
+    RET_ON_ERROR(mfs_bank_write_header(mfsp, MFS_BANK_0, 1));
+    bank = MFS_BANK_0;
+    break;
+
+  case PAIR(MFS_BANK_OK, MFS_BANK_OK):
+    /* Both banks appear to be valid but one must be newer, erasing the
+       older one.*/
+    if (cnt0 > cnt1) {
+      /* Bank 0 is newer.*/
+      RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_1));
+      bank = MFS_BANK_0;
+    }
+    else {
+      /* Bank 1 is newer.*/
+      RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_0));
+      bank = MFS_BANK_1;
+    }
+    warning = true;
+    break;
+
+  case PAIR(MFS_BANK_GARBAGE, MFS_BANK_GARBAGE):
+    /* Both banks are unreadable, reinitializing.*/
+    RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_0));
+    RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_1));
+    RET_ON_ERROR(mfs_bank_write_header(mfsp, MFS_BANK_0, 1));
+    bank = MFS_BANK_0;
+    warning = true;
+    break;
+
+  case PAIR(MFS_BANK_ERASED, MFS_BANK_OK):
+    /* Normal situation, bank one is used.*/
+    bank = MFS_BANK_1;
+    break;
+
+  case PAIR(MFS_BANK_OK, MFS_BANK_ERASED):
+    /* Normal situation, bank zero is used.*/
+    bank = MFS_BANK_0;
+    break;
+
+  case PAIR(MFS_BANK_ERASED, MFS_BANK_GARBAGE):
+    /* Bank zero is erased, bank one is not readable.*/
+    RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_1));
+    RET_ON_ERROR(mfs_bank_write_header(mfsp, MFS_BANK_0, 1));
+    bank = MFS_BANK_0;
+    warning = true;
+    break;
+
+  case PAIR(MFS_BANK_GARBAGE, MFS_BANK_ERASED):
     /* Bank zero is not readable, bank one is erased.*/
     RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_0));
     RET_ON_ERROR(mfs_bank_write_header(mfsp, MFS_BANK_1, 1));
@@ -831,134 +2192,496 @@ void mfsObjectInit(MFSDriver *mfsp) {
 }
 
 /**
- * @brief   Configures and activates a MFS driver.
+ * @brief   Configures and activates a MFS driver.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] config    pointer to the configuration
+ * @return              The operation status.
+ * @retval MFS_NO_ERROR if the operation has been successfully completed.
+ * @retval MFS_WARN_GC  if the operation triggered a garbage collection.
+ * @retval MFS_ERR_FLASH_FAILURE if the flash memory is unusable because HW
+ *                      failures. Makes the driver enter the @p MFS_ERROR state.
+ * @retval MFS_ERR_INTERNAL if an internal logic failure is detected.
+ *
+ * @api
+ */
+mfs_error_t mfsStart(MFSDriver *mfsp, const MFSConfig *config) {
+
+  osalDbgCheck((mfsp != NULL) && (config != NULL));
+  osalDbgAssert((mfsp->state == MFS_STOP) || (mfsp->state == MFS_READY) ||
+                (mfsp->state == MFS_ERROR), "invalid state");
+
+  /* Storing configuration.*/
+  mfsp->config = config;
+
+  return mfs_mount(mfsp);
+} 
+
+/**
+ * @brief   Deactivates a MFS driver.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ *
+ * @api
+ */
+void mfsStop(MFSDriver *mfsp) {
+
+  osalDbgCheck(mfsp != NULL);
+  osalDbgAssert((mfsp->state == MFS_STOP) || (mfsp->state == MFS_READY) ||
+                (mfsp->state == MFS_ERROR) || (mfsp->state == MFS_STREAMING),
+                "invalid state");
+
+  /* Writing the pending updates and saving the index for a fast mount,
+     errors are not recoverable at this point.*/
+  if (mfsp->state == MFS_READY) {
+#if MFS_CFG_WRITE_CACHE_RECORDS > 0
+    (void)mfs_cache_flush(mfsp);
+#endif
+    (void)mfs_index_checkpoint(mfsp);
+  }
+
+  mfsp->config = NULL;
+  mfsp->state = MFS_STOP;
+}
+
+/**
+ * @brief   Destroys the state of the managed storage by erasing the flash.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ * @retval MFS_ERR_INV_STATE if the driver is in not in @p MSG_READY state.
+ * @retval MFS_NO_ERROR if the operation has been successfully completed.
+ * @retval MFS_ERR_FLASH_FAILURE if the flash memory is unusable because HW
+ *                      failures. Makes the driver enter the @p MFS_ERROR state.
+ * @retval MFS_ERR_INTERNAL if an internal logic failure is detected.
+ *
+ * @api
+ */
+mfs_error_t mfsErase(MFSDriver *mfsp) {
+
+  osalDbgCheck(mfsp != NULL);
+
+  if (mfsp->state != MFS_READY) {
+    return MFS_ERR_INV_STATE;
+  }
+
+  RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_0));
+  RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_1));
+
+  return mfs_mount(mfsp);
+}
+
+/**
+ * @brief   Retrieves and reads a data record.
+ * @details Compressed records are transparently decompressed, @p np is
+ *          compared with the uncompressed size.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record numeric identifier, the valid range is between
+ *                      @p 1 and @p MFS_CFG_MAX_RECORDS
+ * @param[in,out] np    on input is the maximum buffer size, on return it is
+ *                      the size of the data copied into the buffer
+ * @param[out] buffer   pointer to a buffer for record data
+ * @return              The operation status.
+ * @retval MFS_NO_ERROR if the operation has been successfully completed.
+ * @retval MFS_ERR_INV_STATE if the driver is in not in @p MSG_READY state
+ *                      or if the record is compressed and
+ *                      @p MFS_CFG_USE_COMPRESSION is disabled.
+ * @retval MFS_ERR_INV_SIZE if the passed buffer is not large enough to
+ *                      contain the record data.
+ * @retval MFS_ERR_NOT_FOUND if the specified id does not exists.
+ * @retval MFS_ERR_FLASH_FAILURE if the flash memory is unusable because HW
+ *                      failures. Makes the driver enter the @p MFS_ERROR state.
+ * @retval MFS_ERR_INTERNAL if an internal logic failure is detected.
+ *
+ * @api
+ */
+mfs_error_t mfsReadRecord(MFSDriver *mfsp, mfs_id_t id,
+                          size_t *np, uint8_t *buffer) {
+  mfs_record_descriptor_t *dp;
+  uint16_t crc;
+
+  osalDbgCheck((mfsp != NULL) &&
+               (id >= 1) && (id <= (mfs_id_t)MFS_CFG_MAX_RECORDS) &&
+               (np != NULL) && (buffer != NULL));
+
+  /* Reads are allowed while a write stream is open.*/
+  if ((mfsp->state != MFS_READY) && (mfsp->state != MFS_STREAMING)) {
+    return MFS_ERR_INV_STATE;
+  }
+
+#if MFS_CFG_WRITE_CACHE_RECORDS > 0
+  {
+    /* A pending update is more recent than the flash content.*/
+    mfs_cache_entry_t *cep = mfs_cache_find(mfsp, id);
+
+    if (cep != NULL) {
+      if (*np < cep->size) {
+        return MFS_ERR_INV_SIZE;
+      }
+      memcpy((void *)buffer, (const void *)cep->data, cep->size);
+      *np = cep->size;
+
+      return MFS_NO_ERROR;
+    }
+  }
+#endif
+
+  /* Checking if the requested record actually exists.*/
+  dp = mfs_index_find(mfsp, id);
+  if (dp == NULL) {
+    return MFS_ERR_NOT_FOUND;
+  }
+
+  /* Header read from flash.*/
+  RET_ON_ERROR(mfs_flash_read(mfsp,
+                              dp->offset,
+                              sizeof (mfs_data_header_t),
+                              mfsp->buffer.data8));
+
+  /* Compressed records are decompressed in the buffer.*/
+  if ((mfsp->buffer.dhdr.fields.size & MFS_SIZE_COMPRESSED) != 0U) {
+#if MFS_CFG_USE_COMPRESSION == TRUE
+    return mfs_lz_read_record(mfsp, dp, np, buffer);
+#else
+    return MFS_ERR_INV_STATE;
+#endif
+  }
+
+  /* Making sure to not overflow the buffer.*/
+  if (*np < dp->size) {
+    return MFS_ERR_INV_SIZE;
+  }
+
+  /* Data read from flash.*/
+  *np = dp->size;
+  RET_ON_ERROR(mfs_flash_read(mfsp,
+                              dp->offset + sizeof (mfs_data_header_t),
+                              *np,
+                              buffer));
+
+  /* Checking CRC.*/
+  crc = crc16(0xFFFFU, buffer, *np);
+  if (crc != mfsp->buffer.dhdr.fields.crc) {
+    mfsp->state = MFS_ERROR;
+    return MFS_ERR_FLASH_FAILURE;
+  }
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Creates or updates a data record.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record numeric identifier, the valid range is between
+ *                      @p 1 and @p MFS_CFG_MAX_RECORDS
+ * @param[in] n         size of data to be written, it cannot be zero
+ * @param[in] buffer    pointer to a buffer for record data
+ * @return              The operation status.
+ * @retval MFS_NO_ERROR if the operation has been successfully completed.
+ * @retval MFS_WARN_GC  if the operation triggered a garbage collection.
+ * @retval MFS_ERR_INV_STATE if the driver is in not in @p MSG_READY state.
+ * @retval MFS_ERR_OUT_OF_MEM if there is not enough flash space for the
+ *                      operation or if the record does not exist and the
+ *                      index is full.
+ * @retval MFS_ERR_FLASH_FAILURE if the flash memory is unusable because HW
+ *                      failures. Makes the driver enter the @p MFS_ERROR state.
+ * @retval MFS_ERR_INTERNAL if an internal logic failure is detected.
+ *
+ * @api
+ */
+mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
+                           size_t n, const uint8_t *buffer) {
+
+  osalDbgCheck((mfsp != NULL) &&
+               (id >= 1) && (id <= (mfs_id_t)MFS_CFG_MAX_RECORDS) &&
+               (n > 0U) && (buffer != NULL));
+
+  if (mfsp->state != MFS_READY) {
+    return MFS_ERR_INV_STATE;
+  }
+
+#if MFS_CFG_WRITE_CACHE_RECORDS > 0
+  {
+    mfs_error_t err = MFS_NO_ERROR, werr;
+
+    /* Small records are cached if the pending updates are guaranteed to
+       fit in the storage. If the update cannot be cached, because the
+       cache is full or the free space is low, then the pending updates
+       are written first.*/
+    if (!mfs_cache_fits(mfsp, id, n)) {
+      err = mfs_cache_flush(mfsp);
+      if (MFS_IS_ERROR(err)) {
+        return err;
+      }
+    }
+
+    if (mfs_cache_fits(mfsp, id, n)) {
+      werr = mfs_cache_write(mfsp, id, n, buffer);
+    }
+    else {
+      werr = mfs_record_write(mfsp, id, n, buffer);
+    }
+
+    return werr == MFS_NO_ERROR ? err : werr;
+  }
+#else
+  return mfs_record_write(mfsp, id, n, buffer);
+#endif
+}
+
+/**
+ * @brief   Erases a data record.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record numeric identifier, the valid range is between
+ *                      @p 1 and @p MFS_CFG_MAX_RECORDS
+ * @return              The operation status.
+ * @retval MFS_NO_ERROR if the operation has been successfully completed.
+ * @retval MFS_WARN_GC  if the operation triggered a garbage collection.
+ * @retval MFS_ERR_INV_STATE if the driver is in not in @p MSG_READY state.
+ * @retval MFS_ERR_FLASH_FAILURE if the flash memory is unusable because HW
+ *                      failures. Makes the driver enter the @p MFS_ERROR state.
+ * @retval MFS_ERR_INTERNAL if an internal logic failure is detected.
+ *
+ * @api
+ */
+mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
+
+  osalDbgCheck((mfsp != NULL) &&
+               (id >= 1U) && (id <= (mfs_id_t)MFS_CFG_MAX_RECORDS));
+
+  if (mfsp->state != MFS_READY) {
+    return MFS_ERR_INV_STATE;
+  }
+
+#if MFS_CFG_WRITE_CACHE_RECORDS > 0
+  /* A pending update is discarded only after the record has been erased
+     in flash, if it has been written before, so that a failure does not
+     lose it.*/
+  if (mfs_index_find(mfsp, id) == NULL) {
+    return mfs_cache_remove(mfsp, id) ? MFS_NO_ERROR : MFS_ERR_NOT_FOUND;
+  }
+  else {
+    mfs_error_t err = mfs_record_erase(mfsp, id);
+    if (!MFS_IS_ERROR(err)) {
+      (void)mfs_cache_remove(mfsp, id);
+    }
+    return err;
+  }
+#else
+  return mfs_record_erase(mfsp, id);
+#endif
+}
+
+/**
+ * @brief   Opens a stream for reading a record.
+ * @details The record data can then be read in chunks using
+ *          @p mfsReadRecordStream(), the record size is available in the
+ *          @p size field of the stream object.
+ * @note    Streams survive garbage collections, updating or erasing the
+ *          record makes the following stream reads fail.
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
- * @param[in] config    pointer to the configuration
+ * @param[in] id        record numeric identifier, the valid range is between
+ *                      @p 1 and @p MFS_CFG_MAX_RECORDS
+ * @param[out] rsp      pointer to the stream object
  * @return              The operation status.
  * @retval MFS_NO_ERROR if the operation has been successfully completed.
- * @retval MFS_WARN_GC  if the operation triggered a garbage collection.
+ * @retval MFS_ERR_INV_STATE if the driver is in not in @p MSG_READY or
+ *                      @p MFS_STREAMING state or if the record is stored
+ *                      compressed.
+ * @retval MFS_ERR_NOT_FOUND if the specified id does not exists.
  * @retval MFS_ERR_FLASH_FAILURE if the flash memory is unusable because HW
  *                      failures. Makes the driver enter the @p MFS_ERROR state.
  * @retval MFS_ERR_INTERNAL if an internal logic failure is detected.
  *
  * @api
  */
-mfs_error_t mfsStart(MFSDriver *mfsp, const MFSConfig *config) {
+mfs_error_t mfsOpenRecordStream(MFSDriver *mfsp, mfs_id_t id,
+                                mfs_record_stream_t *rsp) {
+  mfs_record_descriptor_t *dp;
 
-  osalDbgCheck((mfsp != NULL) && (config != NULL));
-  osalDbgAssert((mfsp->state == MFS_STOP) || (mfsp->state == MFS_READY) ||
-                (mfsp->state == MFS_ERROR), "invalid state");
+  osalDbgCheck((mfsp != NULL) &&
+               (id >= 1U) && (id <= (mfs_id_t)MFS_CFG_MAX_RECORDS) &&
+               (rsp != NULL));
 
-  /* Storing configuration.*/
-  mfsp->config = config;
+  if ((mfsp->state != MFS_READY) && (mfsp->state != MFS_STREAMING)) {
+    return MFS_ERR_INV_STATE;
+  }
 
-  return mfs_mount(mfsp);
-} 
+#if MFS_CFG_WRITE_CACHE_RECORDS > 0
+  /* A pending update of the record is written first, the cache is always
+     empty while a write stream is open.*/
+  if (mfs_cache_find(mfsp, id) != NULL) {
+    mfs_error_t err = mfs_cache_flush(mfsp);
+    if (MFS_IS_ERROR(err)) {
+      return err;
+    }
+  }
+#endif
 
-/**
- * @brief   Deactivates a MFS driver.
- *
- * @param[in] mfsp      pointer to the @p MFSDriver object
- *
- * @api
- */
-void mfsStop(MFSDriver *mfsp) {
+  /* Checking if the requested record actually exists.*/
+  dp = mfs_index_find(mfsp, id);
+  if (dp == NULL) {
+    return MFS_ERR_NOT_FOUND;
+  }
 
-  osalDbgCheck(mfsp != NULL);
-  osalDbgAssert((mfsp->state == MFS_STOP) || (mfsp->state == MFS_READY) ||
-                (mfsp->state == MFS_ERROR), "invalid state");
+  /* The header CRC identifies the record instance.*/
+  RET_ON_ERROR(mfs_flash_read(mfsp, dp->offset,
+                              sizeof (mfs_data_header_t),
+                              mfsp->buffer.data8));
 
-  mfsp->config = NULL;
-  mfsp->state = MFS_STOP;
+  /* Compressed records cannot be streamed.*/
+  if ((mfsp->buffer.dhdr.fields.size & MFS_SIZE_COMPRESSED) != 0U) {
+    return MFS_ERR_INV_STATE;
+  }
+
+  rsp->id       = id;
+  rsp->write    = false;
+  rsp->offset   = dp->offset;
+  rsp->counter  = mfsp->current_counter;
+  rsp->size     = dp->size;
+  rsp->position = 0U;
+  rsp->hcrc     = mfsp->buffer.dhdr.fields.crc;
+  rsp->crc      = 0xFFFFU;
+
+  return MFS_NO_ERROR;
 }
 
 /**
- * @brief   Destroys the state of the managed storage by erasing the flash.
+ * @brief   Opens a stream for creating or updating a record.
+ * @details The record data is then written in chunks using
+ *          @p mfsWriteRecordStream() and the record is made valid by
+ *          @p mfsCloseRecordStream().
+ * @note    The driver enters the @p MFS_STREAMING state, only reads are
+ *          allowed until the stream is closed.
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record numeric identifier, the valid range is between
+ *                      @p 1 and @p MFS_CFG_MAX_RECORDS
+ * @param[in] n         record data size, it cannot be zero
+ * @param[out] rsp      pointer to the stream object
  * @return              The operation status.
- * @retval MFS_ERR_INV_STATE if the driver is in not in @p MSG_READY state.
  * @retval MFS_NO_ERROR if the operation has been successfully completed.
+ * @retval MFS_WARN_GC  if the operation triggered a garbage collection.
+ * @retval MFS_ERR_INV_STATE if the driver is in not in @p MSG_READY state.
+ * @retval MFS_ERR_OUT_OF_MEM if there is not enough flash space for the
+ *                      operation or if the record does not exist and the
+ *                      index is full.
  * @retval MFS_ERR_FLASH_FAILURE if the flash memory is unusable because HW
  *                      failures. Makes the driver enter the @p MFS_ERROR state.
  * @retval MFS_ERR_INTERNAL if an internal logic failure is detected.
  *
  * @api
  */
-mfs_error_t mfsErase(MFSDriver *mfsp) {
+mfs_error_t mfsCreateRecordStream(MFSDriver *mfsp, mfs_id_t id, size_t n,
+                                  mfs_record_stream_t *rsp) {
+  bool warning = false;
 
-  osalDbgCheck(mfsp != NULL);
+  osalDbgCheck((mfsp != NULL) &&
+               (id >= 1U) && (id <= (mfs_id_t)MFS_CFG_MAX_RECORDS) &&
+               (n > 0U) && (rsp != NULL));
 
   if (mfsp->state != MFS_READY) {
     return MFS_ERR_INV_STATE;
   }
 
-  RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_0));
-  RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_1));
+#if MFS_CFG_WRITE_CACHE_RECORDS > 0
+  {
+    /* Pending updates are written first, the record previous update too
+       because the stream could be discarded.*/
+    mfs_error_t err;
 
-  return mfs_mount(mfsp);
+    err = mfs_cache_flush(mfsp);
+    if (MFS_IS_ERROR(err)) {
+      return err;
+    }
+    warning = err == MFS_WARN_GC;
+  }
+#endif
+
+  RET_ON_ERROR(mfs_record_prepare(mfsp, id, n, &warning));
+
+  /* Writing only the data size in the header, identifier, CRC and magic
+     are written when the stream is closed.*/
+  mfsp->buffer.dhdr.fields.magic = (uint32_t)mfsp->config->erased;
+  mfsp->buffer.dhdr.fields.id    = (uint16_t)mfsp->config->erased;
+  mfsp->buffer.dhdr.fields.crc   = (uint16_t)mfsp->config->erased;
+  mfsp->buffer.dhdr.fields.size  = (uint32_t)n;
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfsp->next_offset,
+                               sizeof (mfs_data_header_t),
+                               mfsp->buffer.data8));
+
+  rsp->id       = id;
+  rsp->write    = true;
+  rsp->offset   = mfsp->next_offset;
+  rsp->counter  = mfsp->current_counter;
+  rsp->size     = (uint32_t)n;
+  rsp->position = 0U;
+  rsp->hcrc     = 0U;
+  rsp->crc      = 0xFFFFU;
+  mfsp->state   = MFS_STREAMING;
+
+  return warning ? MFS_WARN_GC : MFS_NO_ERROR;
 }
 
 /**
- * @brief   Retrieves and reads a data record.
+ * @brief   Reads a chunk of record data from a stream.
+ * @details Data is read directly from flash into the caller buffer, the
+ *          record CRC is verified when the last chunk is read.
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
- * @param[in] id        record numeric identifier, the valid range is between
- *                      @p 1 and @p MFS_CFG_MAX_RECORDS
- * @param[in,out] np    on input is the maximum buffer size, on return it is
- *                      the size of the data copied into the buffer
+ * @param[in] rsp       pointer to a read stream object
+ * @param[in,out] np    on input is the maximum chunk size, on return it is
+ *                      the size of the data copied into the buffer, zero at
+ *                      the end of the record
  * @param[out] buffer   pointer to a buffer for record data
  * @return              The operation status.
  * @retval MFS_NO_ERROR if the operation has been successfully completed.
- * @retval MFS_ERR_INV_STATE if the driver is in not in @p MSG_READY state.
- * @retval MFS_ERR_INV_SIZE if the passed buffer is not large enough to
- *                      contain the record data.
- * @retval MFS_ERR_NOT_FOUND if the specified id does not exists.
+ * @retval MFS_ERR_INV_STATE if the driver is in not in @p MSG_READY or
+ *                      @p MFS_STREAMING state.
+ * @retval MFS_ERR_NOT_FOUND if the record has been updated or erased.
  * @retval MFS_ERR_FLASH_FAILURE if the flash memory is unusable because HW
  *                      failures. Makes the driver enter the @p MFS_ERROR state.
  * @retval MFS_ERR_INTERNAL if an internal logic failure is detected.
  *
  * @api
  */
-mfs_error_t mfsReadRecord(MFSDriver *mfsp, mfs_id_t id,
-                          size_t *np, uint8_t *buffer) {
-  uint16_t crc;
+mfs_error_t mfsReadRecordStream(MFSDriver *mfsp, mfs_record_stream_t *rsp,
+                                size_t *np, uint8_t *buffer) {
+  size_t n;
 
-  osalDbgCheck((mfsp != NULL) &&
-               (id >= 1) && (id <= (mfs_id_t)MFS_CFG_MAX_RECORDS) &&
+  osalDbgCheck((mfsp != NULL) && (rsp != NULL) && !rsp->write &&
                (np != NULL) && (buffer != NULL));
 
-  if (mfsp->state != MFS_READY) {
+  if ((mfsp->state != MFS_READY) && (mfsp->state != MFS_STREAMING)) {
     return MFS_ERR_INV_STATE;
   }
 
-  /* Checking if the requested record actually exists.*/
-  if (mfsp->descriptors[id - 1U].offset == 0U) {
-    return MFS_ERR_NOT_FOUND;
+  n = (size_t)(rsp->size - rsp->position);
+  if (n > *np) {
+    n = *np;
   }
-
-  /* Making sure to not overflow the buffer.*/
-  if (*np < mfsp->descriptors[id - 1U].size) {
-    return MFS_ERR_INV_SIZE;
+  *np = n;
+  if (n == 0U) {
+    return MFS_NO_ERROR;
   }
 
-  /* Header read from flash.*/
-  RET_ON_ERROR(mfs_flash_read(mfsp,
-                              mfsp->descriptors[id - 1U].offset,
-                              sizeof (mfs_data_header_t),
-                              mfsp->buffer.data8));
-
   /* Data read from flash.*/
-  *np = mfsp->descriptors[id - 1U].size;
+  RET_ON_ERROR(mfs_stream_locate(mfsp, rsp));
   RET_ON_ERROR(mfs_flash_read(mfsp,
-                              mfsp->descriptors[id - 1U].offset + sizeof (mfs_data_header_t),
-                              *np,
+                              rsp->offset + sizeof (mfs_data_header_t) +
+                              rsp->position,
+                              n,
                               buffer));
+  rsp->crc       = crc16(rsp->crc, buffer, n);
+  rsp->position += (uint32_t)n;
 
-  /* Checking CRC.*/
-  crc = crc16(0xFFFFU, buffer, *np);
-  if (crc != mfsp->buffer.dhdr.fields.crc) {
+  /* Checking CRC at the end of the record.*/
+  if ((rsp->position == rsp->size) && (rsp->crc != rsp->hcrc)) {
     mfsp->state = MFS_ERROR;
     return MFS_ERR_FLASH_FAILURE;
   }
@@ -967,103 +2690,114 @@ mfs_error_t mfsReadRecord(MFSDriver *mfsp, mfs_id_t id,
 }
 
 /**
- * @brief   Creates or updates a data record.
+ * @brief   Writes a chunk of record data to a stream.
+ * @details Data is written directly from the caller buffer to flash.
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
- * @param[in] id        record numeric identifier, the valid range is between
- *                      @p 1 and @p MFS_CFG_MAX_RECORDS
- * @param[in] n         size of data to be written, it cannot be zero
+ * @param[in] rsp       pointer to a write stream object
+ * @param[in] n         size of the data chunk
  * @param[in] buffer    pointer to a buffer for record data
  * @return              The operation status.
  * @retval MFS_NO_ERROR if the operation has been successfully completed.
- * @retval MFS_WARN_GC  if the operation triggered a garbage collection.
- * @retval MFS_ERR_INV_STATE if the driver is in not in @p MSG_READY state.
- * @retval MFS_ERR_OUT_OF_MEM if there is not enough flash space for the
- *                      operation.
+ * @retval MFS_ERR_INV_STATE if the driver is in not in @p MFS_STREAMING
+ *                      state.
+ * @retval MFS_ERR_INV_SIZE if the chunk exceeds the record size.
  * @retval MFS_ERR_FLASH_FAILURE if the flash memory is unusable because HW
  *                      failures. Makes the driver enter the @p MFS_ERROR state.
- * @retval MFS_ERR_INTERNAL if an internal logic failure is detected.
  *
  * @api
  */
-mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
-                           size_t n, const uint8_t *buffer) {
-  flash_offset_t free, required;
-  bool warning = false;
+mfs_error_t mfsWriteRecordStream(MFSDriver *mfsp, mfs_record_stream_t *rsp,
+                                 size_t n, const uint8_t *buffer) {
 
-  osalDbgCheck((mfsp != NULL) &&
-               (id >= 1) && (id <= (mfs_id_t)MFS_CFG_MAX_RECORDS) &&
-               (n > 0U) && (buffer != NULL));
+  osalDbgCheck((mfsp != NULL) && (rsp != NULL) && rsp->write &&
+               (buffer != NULL));
 
-  if (mfsp->state != MFS_READY) {
+  if (mfsp->state != MFS_STREAMING) {
     return MFS_ERR_INV_STATE;
   }
 
-  /* If the required space is beyond the available (compacted) block
-     size then an error is returned.
-     NOTE: The space for one extra header is reserved in order to allow
-     for an erase operation after the space has been fully allocated.*/
-  required = ((flash_offset_t)sizeof (mfs_data_header_t) * 2U) +
-             (flash_offset_t)n;
-  if (required > mfsp->config->bank_size - mfsp->used_space) {
-    return MFS_ERR_OUT_OF_MEM;
-  }
-
-  /* Checking for immediately (not compacted) available space.*/
-  free = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
-          mfsp->config->bank_size) - mfsp->next_offset;
-  if (required > free) {
-    /* We need to perform a garbage collection, there is enough space
-       but it has to be freed.*/
-    warning = true;
-    RET_ON_ERROR(mfs_garbage_collect(mfsp));
+  if (n > (size_t)(rsp->size - rsp->position)) {
+    return MFS_ERR_INV_SIZE;
   }
 
-  /* Writing the data header without the magic, it will be written last.*/
-  mfsp->buffer.dhdr.fields.magic = (uint32_t)mfsp->config->erased;
-  mfsp->buffer.dhdr.fields.id    = (uint16_t)id;
-  mfsp->buffer.dhdr.fields.size  = (uint32_t)n;
-  mfsp->buffer.dhdr.fields.crc   = crc16(0xFFFFU, buffer, n);
-  RET_ON_ERROR(mfs_flash_write(mfsp,
-                               mfsp->next_offset,
-                               sizeof (mfs_data_header_t),
-                               mfsp->buffer.data8));
-
   /* Writing the data part.*/
   RET_ON_ERROR(mfs_flash_write(mfsp,
-                               mfsp->next_offset + sizeof (mfs_data_header_t),
+                               rsp->offset + sizeof (mfs_data_header_t) +
+                               rsp->position,
                                n,
                                buffer));
+  rsp->crc       = crc16(rsp->crc, buffer, n);
+  rsp->position += (uint32_t)n;
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Closes a record stream.
+ * @details Closing a write stream seals the record, if the record data has
+ *          not been completely written then the record is discarded and
+ *          the previous instance, if any, is retained.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] rsp       pointer to the stream object
+ * @return              The operation status.
+ * @retval MFS_NO_ERROR if the operation has been successfully completed.
+ * @retval MFS_ERR_INV_STATE if the driver is in not in the expected state.
+ * @retval MFS_ERR_INV_SIZE if the record has been discarded.
+ * @retval MFS_ERR_FLASH_FAILURE if the flash memory is unusable because HW
+ *                      failures. Makes the driver enter the @p MFS_ERROR state.
+ * @retval MFS_ERR_INTERNAL if an internal logic failure is detected.
+ *
+ * @api
+ */
+mfs_error_t mfsCloseRecordStream(MFSDriver *mfsp, mfs_record_stream_t *rsp) {
+  bool complete;
+
+  osalDbgCheck((mfsp != NULL) && (rsp != NULL));
+
+  if (!rsp->write) {
+    return (mfsp->state == MFS_READY) || (mfsp->state == MFS_STREAMING) ?
+           MFS_NO_ERROR : MFS_ERR_INV_STATE;
+  }
+
+  if (mfsp->state != MFS_STREAMING) {
+    return MFS_ERR_INV_STATE;
+  }
+  mfsp->state = MFS_READY;
+
+  /* Writing identifier and CRC, an incomplete record is turned into an
+     unreferenced index record that is skipped by the mount scan.*/
+  complete = rsp->position == rsp->size;
+  mfsp->buffer.dhdr.fields.id  = complete ? (uint16_t)rsp->id :
+                                            (uint16_t)MFS_INDEX_ID;
+  mfsp->buffer.dhdr.fields.crc = complete ? rsp->crc : (uint16_t)0;
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               rsp->offset + sizeof (uint32_t),
+                               sizeof (uint32_t),
+                               &mfsp->buffer.dhdr.hdr8[sizeof (uint32_t)]));
 
   /* Finally writing the magic number, it seals the transaction.*/
   mfsp->buffer.dhdr.fields.magic = (uint32_t)MFS_HEADER_MAGIC;
   RET_ON_ERROR(mfs_flash_write(mfsp,
-                               mfsp->next_offset,
+                               rsp->offset,
                                sizeof (uint32_t),
                                mfsp->buffer.data8));
 
-  /* The size of the old record instance, if present, must be subtracted
-     to the total used size.*/
-  if (mfsp->descriptors[id - 1U].offset != 0U) {
-    mfsp->used_space -= sizeof (mfs_data_header_t) +
-                        mfsp->descriptors[id - 1U].size;
+  if (!complete) {
+    mfsp->next_offset += sizeof (mfs_data_header_t) + rsp->size;
+    return MFS_ERR_INV_SIZE;
   }
 
-  /* Adjusting bank-related metadata.*/
-  mfsp->descriptors[id - 1U].offset = mfsp->next_offset;
-  mfsp->descriptors[id - 1U].size   = (uint32_t)n;
-  mfsp->next_offset += sizeof (mfs_data_header_t) + n;
-  mfsp->used_space  += sizeof (mfs_data_header_t) + n;
-
-  return warning ? MFS_WARN_GC : MFS_NO_ERROR;
+  return mfs_record_commit(mfsp, rsp->id, rsp->size);
 }
 
 /**
- * @brief   Erases a data record.
+ * @brief   Writes the pending record updates to flash.
+ * @note    This function does nothing if the write-back cache is disabled
+ *          by @p MFS_CFG_WRITE_CACHE_RECORDS.
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
- * @param[in] id        record numeric identifier, the valid range is between
- *                      @p 1 and @p MFS_CFG_MAX_RECORDS
  * @return              The operation status.
  * @retval MFS_NO_ERROR if the operation has been successfully completed.
  * @retval MFS_WARN_GC  if the operation triggered a garbage collection.
@@ -1074,66 +2808,70 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
  *
  * @api
  */
-mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
-  flash_offset_t free, required;
-  bool warning = false;
+mfs_error_t mfsSync(MFSDriver *mfsp) {
 
-  osalDbgCheck((mfsp != NULL) &&
-               (id >= 1U) && (id <= (mfs_id_t)MFS_CFG_MAX_RECORDS));
+  osalDbgCheck(mfsp != NULL);
 
   if (mfsp->state != MFS_READY) {
     return MFS_ERR_INV_STATE;
   }
 
-  /* Checking if the requested record actually exists.*/
-  if (mfsp->descriptors[id - 1U].offset == 0U) {
-    return MFS_ERR_NOT_FOUND;
-  }
+#if MFS_CFG_WRITE_CACHE_RECORDS > 0
+  return mfs_cache_flush(mfsp);
+#else
+  return MFS_NO_ERROR;
+#endif
+}
 
-  /* If the required space is beyond the available (compacted) block
-     size then an internal error is returned, it should never happen.*/
-  required = (flash_offset_t)sizeof (mfs_data_header_t);
-  if (required > mfsp->config->bank_size - mfsp->used_space) {
-    return MFS_ERR_INTERNAL;
-  }
+/**
+ * @brief   Enforces a garbage collection operation.
+ * @details Garbage collection involves: integrity check, optionally repairs,
+ *          obsolete data removal, data compaction and a flash bank swap.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ * @retval MFS_NO_ERROR if the operation has been successfully completed.
+ * @retval MFS_ERR_INV_STATE if the driver is in not in @p MSG_READY state.
+ * @retval MFS_ERR_FLASH_FAILURE if the flash memory is unusable because HW
+ *                      failures. Makes the driver enter the @p MFS_ERROR state.
+ * @retval MFS_ERR_INTERNAL if an internal logic failure is detected.
+ *
+ * @api
+ */
+mfs_error_t mfsPerformGarbageCollection(MFSDriver *mfsp) {
 
-  /* Checking for immediately (not compacted) available space.*/
-  free = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
-          mfsp->config->bank_size) - mfsp->next_offset;
-  if (required > free) {
-    /* We need to perform a garbage collection, there is enough space
-       but it has to be freed.*/
-    warning = true;
-    RET_ON_ERROR(mfs_garbage_collect(mfsp));
-  }
+  osalDbgCheck(mfsp != NULL);
 
-  /* Writing the data header with size set to zero, it means that the
-     record is logically erased.*/
-  mfsp->buffer.dhdr.fields.magic = (uint32_t)MFS_HEADER_MAGIC;
-  mfsp->buffer.dhdr.fields.id    = (uint16_t)id;
-  mfsp->buffer.dhdr.fields.size  = (uint32_t)0;
-  mfsp->buffer.dhdr.fields.crc   = (uint16_t)0;
-  RET_ON_ERROR(mfs_flash_write(mfsp,
-                               mfsp->next_offset,
-                               sizeof (mfs_data_header_t),
-                               mfsp->buffer.data8));
+  if (mfsp->state != MFS_READY) {
+    return MFS_ERR_INV_STATE;
+  }
 
-  /* Adjusting bank-related metadata.*/
-  mfsp->used_space  -= sizeof (mfs_data_header_t) +
-                       mfsp->descriptors[id - 1U].size;
-  mfsp->next_offset += sizeof (mfs_data_header_t);
-  mfsp->descriptors[id - 1U].offset = 0U;
-  mfsp->descriptors[id - 1U].size   = 0U;
+  RET_ON_ERROR(mfs_garbage_collect(mfsp));
 
-  return warning ? MFS_WARN_GC : MFS_NO_ERROR;
+  /* The compacted bank is a good point for an index checkpoint.*/
+  return mfs_index_checkpoint(mfsp);
 }
 
 /**
- * @brief   Enforces a garbage collection operation.
- * @details Garbage collection involves: integrity check, optionally repairs,
- *          obsolete data removal, data compaction and a flash bank swap.
+ * @brief   Performs a time-bounded garbage collection step.
+ * @details If there is no garbage collection in progress then a new one
+ *          is started when the free space falls below the threshold
+ *          specified by @p MFS_CFG_GC_THRESHOLD. Elementary operations,
+ *          the copy of a single record or the erase of a single sector,
+ *          are then performed until the time budget is exhausted.<br>
+ *          Write and erase operations can be freely interleaved with
+ *          the collection steps, only operations exhausting the current
+ *          bank space complete the collection synchronously.
+ * @note    The function is meant to be called periodically from a low
+ *          priority thread, the MFS driver is not thread safe so calls
+ *          must be serialized with the other MFS functions.
+ * @note    Expired updates in the write-back cache are written before
+ *          performing the step.
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] budget    time budget for the step, at least one elementary
+ *                      operation is performed, @p TIME_INFINITE completes
+ *                      the collection
  * @return              The operation status.
  * @retval MFS_NO_ERROR if the operation has been successfully completed.
  * @retval MFS_ERR_INV_STATE if the driver is in not in @p MSG_READY state.
@@ -1143,7 +2881,10 @@ mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
  *
  * @api
  */
-mfs_error_t mfsPerformGarbageCollection(MFSDriver *mfsp) {
+mfs_error_t mfsPerformGarbageCollectionStep(MFSDriver *mfsp,
+                                            sysinterval_t budget) {
+  systime_t start;
+  uint32_t counter;
 
   osalDbgCheck(mfsp != NULL);
 
@@ -1151,7 +2892,47 @@ mfs_error_t mfsPerformGarbageCollection(MFSDriver *mfsp) {
     return MFS_ERR_INV_STATE;
   }
 
-  return mfs_garbage_collect(mfsp);
+#if MFS_CFG_WRITE_CACHE_RECORDS > 0
+  {
+    /* Expired pending updates are written first.*/
+    mfs_error_t err = mfs_cache_check_timeout(mfsp);
+    if (MFS_IS_ERROR(err)) {
+      return err;
+    }
+  }
+#endif
+
+  if (mfsp->gc_state == MFS_GC_IDLE) {
+    flash_offset_t free, garbage;
+
+    /* Starting a collection only if it would at least double the free
+       space.*/
+    free    = mfs_bank_get_free(mfsp);
+    garbage = (mfsp->next_offset -
+               mfs_flash_get_bank_offset(mfsp, mfsp->current_bank)) -
+              mfsp->used_space;
+    if (((free * 100U) >= ((flash_offset_t)MFS_CFG_GC_THRESHOLD *
+                           mfsp->config->bank_size)) ||
+        (garbage < free)) {
+      return MFS_NO_ERROR;
+    }
+    mfs_gc_start(mfsp);
+  }
+
+  counter = mfsp->current_counter;
+  start = osalOsGetSystemTimeX();
+  do {
+    RET_ON_ERROR(mfs_gc_step(mfsp));
+  } while ((mfsp->gc_state != MFS_GC_IDLE) &&
+           ((budget == TIME_INFINITE) ||
+            (osalTimeDiffX(start, osalOsGetSystemTimeX()) < budget)));
+
+  /* Writing an index checkpoint in a newly compacted bank.*/
+  if (mfsp->current_counter != counter) {
+    return mfs_index_checkpoint(mfsp);
+  }
+
+  return MFS_NO_ERROR;
 }
 
 /** @} */
@@ -37,6 +37,17 @@
 #define MFS_BANK_MAGIC_1                    0xEC705ADEU
 #define MFS_BANK_MAGIC_2                    0xF0339CC5U
 #define MFS_HEADER_MAGIC                    0x5FAE45F0U
+#define MFS_INDEX_MAGIC                     0x3C8A61E9U
+
+/**
+ * @brief   Data header size flag of compressed records.
+ */
+#define MFS_SIZE_COMPRESSED                 0x80000000U
+
+/**
+ * @brief   Identifier of the index checkpoint records.
+ */
+#define MFS_INDEX_ID                        0U
 
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
@@ -47,13 +58,24 @@
  * @{
  */
 /**
- * @brief   Maximum number of indexed records in the managed storage.
- * @note    Record indexes go from 0 to @p MFS_CFG_MAX_RECORDS - 1.
+ * @brief   Maximum record identifier in the managed storage.
+ * @note    Record identifiers go from 1 to @p MFS_CFG_MAX_RECORDS, the
+ *          maximum value is 65535.
  */
 #if !defined(MFS_CFG_MAX_RECORDS) || defined(__DOXYGEN__)
 #define MFS_CFG_MAX_RECORDS                 32
 #endif
 
+/**
+ * @brief   Size of the in-RAM records index.
+ * @details This is the maximum number of records that can exist at the
+ *          same time, the index only contains the existing records so it
+ *          can be much smaller than the identifiers range.
+ */
+#if !defined(MFS_CFG_INDEX_SIZE) || defined(__DOXYGEN__)
+#define MFS_CFG_INDEX_SIZE                  MFS_CFG_MAX_RECORDS
+#endif
+
 /**
  * @brief   Maximum number of repair attempts on partition mount.
  */
@@ -88,16 +110,89 @@
 #if !defined(MFS_CFG_BUFFER_SIZE) || defined(__DOXYGEN__)
 #define MFS_CFG_BUFFER_SIZE                 32
 #endif
+
+/**
+ * @brief   Incremental garbage collection threshold.
+ * @details An incremental garbage collection is started by
+ *          @p mfsPerformGarbageCollectionStep() when the free space in
+ *          the current bank falls below this percentage of the bank size
+ *          and the obsolete data is larger than the free space.
+ * @note    Zero disables the incremental garbage collection, collections
+ *          are then only performed when a write operation runs out of
+ *          space.
+ */
+#if !defined(MFS_CFG_GC_THRESHOLD) || defined(__DOXYGEN__)
+#define MFS_CFG_GC_THRESHOLD                25
+#endif
+
+/**
+ * @brief   Number of records in the write-back cache.
+ * @details Updates of cached records are coalesced in RAM and written to
+ *          flash by @p mfsSync(), when the cache is full or when the
+ *          oldest pending update is older than
+ *          @p MFS_CFG_WRITE_CACHE_TIMEOUT.
+ * @note    Updates not yet written are lost on power failure, the flash
+ *          content is always consistent.
+ * @note    Zero disables the cache, records are written immediately.
+ */
+#if !defined(MFS_CFG_WRITE_CACHE_RECORDS) || defined(__DOXYGEN__)
+#define MFS_CFG_WRITE_CACHE_RECORDS         0
+#endif
+
+/**
+ * @brief   Maximum data size of a cached record.
+ * @note    Larger records are written immediately.
+ */
+#if !defined(MFS_CFG_WRITE_CACHE_DATA_SIZE) || defined(__DOXYGEN__)
+#define MFS_CFG_WRITE_CACHE_DATA_SIZE       32
+#endif
+
+/**
+ * @brief   Write-back cache timeout in milliseconds.
+ * @details The timeout is checked by @p mfsWriteRecord() and
+ *          @p mfsPerformGarbageCollectionStep().
+ * @note    Zero disables the timeout.
+ */
+#if !defined(MFS_CFG_WRITE_CACHE_TIMEOUT) || defined(__DOXYGEN__)
+#define MFS_CFG_WRITE_CACHE_TIMEOUT         1000
+#endif
+
+/**
+ * @brief   Enables the records compression.
+ * @details Records are compressed using a LZSS scheme when written by
+ *          @p mfsWriteRecord() and transparently decompressed by
+ *          @p mfsReadRecord(), records that do not shrink are stored
+ *          uncompressed. No RAM buffers are required, the record buffer
+ *          itself is used as dictionary.
+ * @note    Compressed records cannot be read using streams.
+ */
+#if !defined(MFS_CFG_USE_COMPRESSION) || defined(__DOXYGEN__)
+#define MFS_CFG_USE_COMPRESSION             FALSE
+#endif
+
+/**
+ * @brief   Compression search window in bytes.
+ * @details Larger windows improve the compression ratio at the cost of
+ *          write time, the decompression time is not affected.
+ * @note    The maximum value is 4096.
+ */
+#if !defined(MFS_CFG_COMPRESSION_WINDOW) || defined(__DOXYGEN__)
+#define MFS_CFG_COMPRESSION_WINDOW          256
+#endif
 /** @} */
 
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
-#if MFS_CFG_MAX_RECORDS < 0
+#if (MFS_CFG_MAX_RECORDS < 1) || (MFS_CFG_MAX_RECORDS > 65535)
 #error "invalid MFS_CFG_MAX_RECORDS value"
 #endif
 
+#if (MFS_CFG_INDEX_SIZE < 1) || (MFS_CFG_INDEX_SIZE > MFS_CFG_MAX_RECORDS)
+#error "invalid MFS_CFG_INDEX_SIZE value"
+#endif
+
 #if (MFS_CFG_MAX_REPAIR_ATTEMPTS < 1) || (MFS_CFG_MAX_REPAIR_ATTEMPTS > 10)
 #error "invalid MFS_MAX_REPAIR_ATTEMPTS value"
 #endif
@@ -110,6 +205,27 @@
 #error "MFS_CFG_BUFFER_SIZE is not a power of two"
 #endif
 
+#if (MFS_CFG_GC_THRESHOLD < 0) || (MFS_CFG_GC_THRESHOLD > 100)
+#error "invalid MFS_CFG_GC_THRESHOLD value"
+#endif
+
+#if (MFS_CFG_WRITE_CACHE_RECORDS < 0) ||                                    \
+    (MFS_CFG_WRITE_CACHE_RECORDS > MFS_CFG_INDEX_SIZE)
+#error "invalid MFS_CFG_WRITE_CACHE_RECORDS value"
+#endif
+
+#if MFS_CFG_WRITE_CACHE_DATA_SIZE < 1
+#error "invalid MFS_CFG_WRITE_CACHE_DATA_SIZE value"
+#endif
+
+#if MFS_CFG_WRITE_CACHE_TIMEOUT < 0
+#error "invalid MFS_CFG_WRITE_CACHE_TIMEOUT value"
+#endif
+
+#if (MFS_CFG_COMPRESSION_WINDOW < 1) || (MFS_CFG_COMPRESSION_WINDOW > 4096)
+#error "invalid MFS_CFG_COMPRESSION_WINDOW value"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -129,7 +245,8 @@ typedef enum {
   MFS_UNINIT = 0,
   MFS_STOP = 1,
   MFS_READY = 2,
-  MFS_ERROR = 3
+  MFS_ERROR = 3,
+  MFS_STREAMING = 4
 } mfs_state_t;
 
 /**
@@ -150,6 +267,15 @@ typedef enum {
   MFS_ERR_INTERNAL = -7
 } mfs_error_t;
 
+/**
+ * @brief   Type of an incremental garbage collection phase.
+ */
+typedef enum {
+  MFS_GC_IDLE = 0,
+  MFS_GC_COPY = 1,
+  MFS_GC_ERASE = 2
+} mfs_gc_state_t;
+
 /**
  * @brief   Type of a bank state assessment.
  */
@@ -228,6 +354,8 @@ typedef union {
     uint16_t                crc;
     /**
      * @brief   Data size.
+     * @note    The @p MFS_SIZE_COMPRESSED flag marks compressed records,
+     *          the size is then the size of the compressed data.
      */
     uint32_t                size;
   } fields;
@@ -235,7 +363,47 @@ typedef union {
   uint32_t                  hdr32[3];
 } mfs_data_header_t;
 
+/**
+ * @brief   Type of an index checkpoint locator.
+ * @details Locators are written downward from the end of a bank, the
+ *          last valid one points to the most recent index checkpoint.
+ */
+typedef union {
+  struct {
+    /**
+     * @brief   Locator magic.
+     */
+    uint32_t                magic;
+    /**
+     * @brief   Offset of the index checkpoint record header.
+     */
+    uint32_t                offset;
+    /**
+     * @brief   Usage counter of the bank.
+     */
+    uint32_t                counter;
+    /**
+     * @brief   Reserved field.
+     */
+    uint16_t                reserved1;
+    /**
+     * @brief   Locator CRC.
+     */
+    uint16_t                crc;
+  } fields;
+  uint8_t                   hdr8[16];
+  uint32_t                  hdr32[4];
+} mfs_index_locator_t;
+
+/**
+ * @brief   Type of a record descriptor.
+ * @note    Index checkpoints are arrays of descriptors.
+ */
 typedef struct {
+  /**
+   * @brief   Record identifier.
+   */
+  uint32_t                  id;
   /**
    * @brief   Offset of the record header.
    */
@@ -246,6 +414,66 @@ typedef struct {
   uint32_t                  size;
 } mfs_record_descriptor_t;
 
+/**
+ * @brief   Type of a record stream.
+ * @details Streams transfer record data in chunks directly between the
+ *          flash and the caller buffers.
+ */
+typedef struct {
+  /**
+   * @brief   Record identifier.
+   */
+  mfs_id_t                  id;
+  /**
+   * @brief   Stream direction, @p true for write streams.
+   */
+  bool                      write;
+  /**
+   * @brief   Offset of the record header.
+   */
+  flash_offset_t            offset;
+  /**
+   * @brief   Bank usage counter when @p offset has been read.
+   */
+  uint32_t                  counter;
+  /**
+   * @brief   Record data size.
+   */
+  uint32_t                  size;
+  /**
+   * @brief   Current position in the record data.
+   */
+  uint32_t                  position;
+  /**
+   * @brief   Record data CRC as stored in the header.
+   */
+  uint16_t                  hcrc;
+  /**
+   * @brief   CRC of the data transferred so far.
+   */
+  uint16_t                  crc;
+} mfs_record_stream_t;
+
+#if (MFS_CFG_WRITE_CACHE_RECORDS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a write-back cache entry.
+ */
+typedef struct {
+  /**
+   * @brief   Record identifier.
+   */
+  mfs_id_t                  id;
+  /**
+   * @brief   Record data size.
+   */
+  size_t                    size;
+  /**
+   * @brief   Record data.
+   */
+  uint8_t                   data[MFS_CFG_WRITE_CACHE_DATA_SIZE];
+} mfs_cache_entry_t;
+#endif
+
 /**
  * @brief   Type of a MFS configuration structure.
  */
@@ -315,16 +543,59 @@ typedef struct {
    */
   flash_offset_t            used_space;
   /**
-   * @brief   Offsets of the most recent instance of the records.
-   * @note    Zero means that there is not a record with that id.
+   * @brief   Number of valid index checkpoint locators in the current bank.
    */
-  mfs_record_descriptor_t   descriptors[MFS_CFG_MAX_RECORDS];
+  unsigned                  locators;
+  /**
+   * @brief   End of the most recent index checkpoint or zero.
+   */
+  flash_offset_t            index_end;
+  /**
+   * @brief   Number of existing records.
+   */
+  unsigned                  records;
+  /**
+   * @brief   Most recent instance of the existing records.
+   * @note    Descriptors are sorted by identifier.
+   */
+  mfs_record_descriptor_t   descriptors[MFS_CFG_INDEX_SIZE];
+  /**
+   * @brief   Incremental garbage collection phase.
+   */
+  mfs_gc_state_t            gc_state;
+  /**
+   * @brief   Identifier of the last record copied in the other bank.
+   */
+  mfs_id_t                  gc_id;
+  /**
+   * @brief   Next free position in the other bank.
+   */
+  flash_offset_t            gc_offset;
+  /**
+   * @brief   Next sector to be erased in the other bank.
+   */
+  flash_sector_t            gc_sector;
+#if (MFS_CFG_WRITE_CACHE_RECORDS > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   Number of pending updates in the write-back cache.
+   */
+  unsigned                  cache_count;
+  /**
+   * @brief   Time of the oldest pending update.
+   */
+  systime_t                 cache_time;
+  /**
+   * @brief   Pending record updates.
+   */
+  mfs_cache_entry_t         cache[MFS_CFG_WRITE_CACHE_RECORDS];
+#endif
   /**
    * @brief   Transient buffer.
    */
   union {
     mfs_data_header_t       dhdr;
     mfs_bank_header_t       bhdr;
+    mfs_index_locator_t     iloc;
     uint8_t                 data8[MFS_CFG_BUFFER_SIZE];
     uint16_t                data16[MFS_CFG_BUFFER_SIZE / sizeof (uint16_t)];
     uint32_t                data32[MFS_CFG_BUFFER_SIZE / sizeof (uint32_t)];
@@ -343,6 +614,16 @@ typedef struct {
 #define MFS_IS_WARNING(err) ((err) > MFS_NO_ERROR)
 /** @} */
 
+/**
+ * @brief   Returns @p true if a garbage collection is in progress.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ *
+ * @api
+ */
+#define mfsIsGarbageCollectionPending(mfsp)                                 \
+  ((bool)((mfsp)->gc_state != MFS_GC_IDLE))
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -359,7 +640,19 @@ extern "C" {
   mfs_error_t mfsWriteRecord(MFSDriver *devp, mfs_id_t id,
                              size_t n, const uint8_t *buffer);
   mfs_error_t mfsEraseRecord(MFSDriver *devp, mfs_id_t id);
+  mfs_error_t mfsSync(MFSDriver *mfsp);
+  mfs_error_t mfsOpenRecordStream(MFSDriver *mfsp, mfs_id_t id,
+                                  mfs_record_stream_t *rsp);
+  mfs_error_t mfsCreateRecordStream(MFSDriver *mfsp, mfs_id_t id, size_t n,
+                                    mfs_record_stream_t *rsp);
+  mfs_error_t mfsReadRecordStream(MFSDriver *mfsp, mfs_record_stream_t *rsp,
+                                  size_t *np, uint8_t *buffer);
+  mfs_error_t mfsWriteRecordStream(MFSDriver *mfsp, mfs_record_stream_t *rsp,
+                                   size_t n, const uint8_t *buffer);
+  mfs_error_t mfsCloseRecordStream(MFSDriver *mfsp, mfs_record_stream_t *rsp);
   mfs_error_t mfsPerformGarbageCollection(MFSDriver *mfsp);
+  mfs_error_t mfsPerformGarbageCollectionStep(MFSDriver *mfsp,
+                                              sysinterval_t budget);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,453 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_ps_cache.c
+ * @brief   Persistent storage cache module code.
+ * @details This module implements a persistent storage stacked on another
+ *          persistent storage, the whole storage is shadowed in RAM.
+ *          Reads are served from the shadow, writes update the shadow and
+ *          mark the touched pages as dirty, dirty pages are written back
+ *          one page at time after a coalescing delay.
+ *          The application serves the write-back by calling
+ *          @p pscServe() in a loop from a dedicated thread, a power-fail
+ *          interrupt can call @p pscRequestFlushI() in order to start
+ *          the write-back immediately:
+ * @code
+ *          static THD_FUNCTION(psc_thread, arg) {
+ *
+ *            (void)arg;
+ *            while (pscServe(&PSC1) == MSG_OK) {
+ *            }
+ *          }
+ * @endcode
+ *
+ * @addtogroup HAL_PS_CACHE
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "hal_ps_cache.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Virtual methods table.
+ */
+static const struct PersistentCacheDriverVMT psc_vmt = {
+  (size_t)0,
+  (size_t (*)(void *))pscGetSize,
+  (ps_error_t (*)(void *, ps_offset_t, size_t, uint8_t *))pscRead,
+  (ps_error_t (*)(void *, ps_offset_t, size_t, const uint8_t *))pscWrite
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Marks a range of pages as dirty.
+ * @note    Must be called with the shadow mutex locked.
+ *
+ * @param[in] pscp      pointer to the @p PersistentCacheDriver object
+ * @param[in] first     first page
+ * @param[in] last      last page
+ *
+ * @notapi
+ */
+static void psc_mark_dirty(PersistentCacheDriver *pscp,
+                           size_t first, size_t last) {
+  uint32_t *dirty = pscp->config->dirty;
+
+  while (first <= last) {
+    uint32_t mask = 1U << (first % 32U);
+
+    if ((dirty[first / 32U] & mask) == 0U) {
+      dirty[first / 32U] |= mask;
+      pscp->ndirty++;
+    }
+    first++;
+  }
+}
+
+/**
+ * @brief   Writes back all the dirty pages.
+ * @details Each page is copied in the page buffer with the shadow locked
+ *          and then written with the shadow unlocked, pages written again
+ *          during their write-back are marked dirty again.
+ *
+ * @param[in] pscp      pointer to the @p PersistentCacheDriver object
+ * @return              An error code.
+ * @retval PS_NO_ERROR  if all the dirty pages have been written.
+ * @return              The error of the last failed page write, the
+ *                      failed pages are still dirty.
+ *
+ * @notapi
+ */
+static ps_error_t psc_writeback(PersistentCacheDriver *pscp) {
+  const PersistentCacheConfig *config = pscp->config;
+  size_t page, npages;
+  ps_error_t err = PS_NO_ERROR;
+
+  npages = (pscp->size + config->page_size - 1U) / config->page_size;
+
+  osalMutexLock(&pscp->wmtx);
+  for (page = 0U; page < npages; page++) {
+    uint32_t mask = 1U << (page % 32U);
+    ps_offset_t offset;
+    size_t n;
+    ps_error_t e;
+
+    /* Skipping clean words of the bitmap without locking.*/
+    if ((page % 32U == 0U) && (config->dirty[page / 32U] == 0U)) {
+      page += 31U;
+      continue;
+    }
+
+    osalMutexLock(&pscp->mtx);
+    if ((config->dirty[page / 32U] & mask) == 0U) {
+      osalMutexUnlock(&pscp->mtx);
+      continue;
+    }
+    config->dirty[page / 32U] &= ~mask;
+    pscp->ndirty--;
+    offset = (ps_offset_t)(page * config->page_size);
+    n = pscp->size - (size_t)offset;
+    if (n > config->page_size) {
+      n = config->page_size;
+    }
+    memcpy(config->pbuf, &config->shadow[offset], n);
+    osalMutexUnlock(&pscp->mtx);
+
+    e = psWrite(config->psp, offset, n, config->pbuf);
+    if (e != PS_NO_ERROR) {
+      osalMutexLock(&pscp->mtx);
+      psc_mark_dirty(pscp, page, page);
+      osalMutexUnlock(&pscp->mtx);
+      err = e;
+    }
+  }
+  pscp->error = err;
+  osalMutexUnlock(&pscp->wmtx);
+
+  return err;
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ *
+ * @param[out] pscp     pointer to the @p PersistentCacheDriver object
+ *
+ * @init
+ */
+void pscObjectInit(PersistentCacheDriver *pscp) {
+
+  osalDbgCheck(pscp != NULL);
+
+  pscp->vmt    = &psc_vmt;
+  pscp->state  = PSC_STOP;
+  pscp->config = NULL;
+  pscp->size   = 0U;
+  pscp->ndirty = 0U;
+  pscp->urgent = false;
+  pscp->error  = PS_NO_ERROR;
+  pscp->thread = NULL;
+  osalMutexObjectInit(&pscp->mtx);
+  osalMutexObjectInit(&pscp->wmtx);
+}
+
+/**
+ * @brief   Configures and activates the cache.
+ * @details The whole underlying storage is loaded in the shadow.
+ * @note    The underlying storage must be already started.
+ *
+ * @param[in] pscp      pointer to the @p PersistentCacheDriver object
+ * @param[in] config    pointer to the configuration
+ * @return              An error code.
+ * @retval PS_NO_ERROR  if the cache has been activated.
+ * @return              The underlying storage read error, the cache is
+ *                      not activated.
+ *
+ * @api
+ */
+ps_error_t pscStart(PersistentCacheDriver *pscp,
+                    const PersistentCacheConfig *config) {
+  BasePersistentStorage *psp;
+  ps_error_t err;
+
+  osalDbgCheck((pscp != NULL) && (config != NULL) && (config->psp != NULL) &&
+               (config->shadow != NULL) && (config->dirty != NULL) &&
+               (config->pbuf != NULL) && (config->page_size > 0U));
+  osalDbgAssert(pscp->state == PSC_STOP, "invalid state");
+
+  psp = config->psp;
+  pscp->size = psp->vmt->getsize(psp);
+  osalDbgAssert(pscp->size <= config->size, "shadow too small");
+
+  err = psRead(psp, 0U, pscp->size, config->shadow);
+  if (err != PS_NO_ERROR) {
+    return err;
+  }
+
+  memset(config->dirty, 0,
+         PSC_DIRTY_WORDS(pscp->size, config->page_size) * sizeof (uint32_t));
+  pscp->config = config;
+  pscp->ndirty = 0U;
+  pscp->urgent = false;
+  pscp->error  = PS_NO_ERROR;
+  pscp->state  = PSC_READY;
+
+  return PS_NO_ERROR;
+}
+
+/**
+ * @brief   Deactivates the cache.
+ * @details The dirty pages are written back and the serving thread, if
+ *          any, is released.
+ *
+ * @param[in] pscp      pointer to the @p PersistentCacheDriver object
+ * @return              An error code.
+ * @retval PS_NO_ERROR  if all the dirty pages have been written.
+ * @return              The error of the last failed page write.
+ *
+ * @api
+ */
+ps_error_t pscStop(PersistentCacheDriver *pscp) {
+  ps_error_t err;
+
+  osalDbgCheck(pscp != NULL);
+  osalDbgAssert(pscp->state == PSC_READY, "invalid state");
+
+  err = psc_writeback(pscp);
+
+  osalSysLock();
+  pscp->state = PSC_STOP;
+  osalThreadResumeS(&pscp->thread, MSG_RESET);
+  osalOsRescheduleS();
+  osalSysUnlock();
+
+  return err;
+}
+
+/**
+ * @brief   Returns the storage size.
+ *
+ * @param[in] pscp      pointer to the @p PersistentCacheDriver object
+ * @return              The storage size in bytes.
+ *
+ * @api
+ */
+size_t pscGetSize(PersistentCacheDriver *pscp) {
+
+  osalDbgCheck(pscp != NULL);
+
+  return pscp->size;
+}
+
+/**
+ * @brief   Read operation.
+ * @details Data is copied from the RAM shadow.
+ *
+ * @param[in] pscp      pointer to the @p PersistentCacheDriver object
+ * @param[in] offset    persistent storage offset
+ * @param[in] n         number of bytes to be read
+ * @param[out] rp       pointer to the data buffer
+ * @return              An error code.
+ * @retval PS_NO_ERROR  always.
+ *
+ * @api
+ */
+ps_error_t pscRead(PersistentCacheDriver *pscp, ps_offset_t offset,
+                   size_t n, uint8_t *rp) {
+
+  osalDbgCheck((pscp != NULL) && (rp != NULL) &&
+               ((size_t)offset + n <= pscp->size));
+  osalDbgAssert(pscp->state == PSC_READY, "invalid state");
+
+  osalMutexLock(&pscp->mtx);
+  memcpy(rp, &pscp->config->shadow[offset], n);
+  osalMutexUnlock(&pscp->mtx);
+
+  return PS_NO_ERROR;
+}
+
+/**
+ * @brief   Write operation.
+ * @details Data is copied in the RAM shadow and the touched pages are
+ *          marked dirty, the function does not wait for the underlying
+ *          storage.
+ *
+ * @param[in] pscp      pointer to the @p PersistentCacheDriver object
+ * @param[in] offset    persistent storage offset
+ * @param[in] n         number of bytes to be written
+ * @param[in] wp        pointer to the data buffer
+ * @return              An error code.
+ * @retval PS_NO_ERROR  always.
+ *
+ * @api
+ */
+ps_error_t pscWrite(PersistentCacheDriver *pscp, ps_offset_t offset,
+                    size_t n, const uint8_t *wp) {
+  const PersistentCacheConfig *config;
+  bool wakeup;
+
+  osalDbgCheck((pscp != NULL) && (wp != NULL) &&
+               ((size_t)offset + n <= pscp->size));
+  osalDbgAssert(pscp->state == PSC_READY, "invalid state");
+
+  if (n == 0U) {
+    return PS_NO_ERROR;
+  }
+
+  config = pscp->config;
+  osalMutexLock(&pscp->mtx);
+  memcpy(&config->shadow[offset], wp, n);
+  wakeup = pscp->ndirty == 0U;
+  psc_mark_dirty(pscp, (size_t)offset / config->page_size,
+                 ((size_t)offset + n - 1U) / config->page_size);
+  if ((config->threshold > 0U) && (pscp->ndirty >= config->threshold)) {
+    wakeup = true;
+    pscp->urgent = true;
+  }
+  osalMutexUnlock(&pscp->mtx);
+
+  /* The serving thread is woken when the first page becomes dirty and
+     when the threshold is reached, other writes do not shorten the
+     coalescing delay.*/
+  if (wakeup) {
+    osalSysLock();
+    osalThreadResumeS(&pscp->thread, MSG_OK);
+    osalOsRescheduleS();
+    osalSysUnlock();
+  }
+
+  return PS_NO_ERROR;
+}
+
+/**
+ * @brief   Writes back all the dirty pages.
+ * @details The write-back is performed by the calling thread, the function
+ *          returns when all the pages dirty at the time of the call have
+ *          been written.
+ *
+ * @param[in] pscp      pointer to the @p PersistentCacheDriver object
+ * @return              An error code.
+ * @retval PS_NO_ERROR  if all the dirty pages have been written.
+ * @return              The error of the last failed page write, the
+ *                      failed pages are still dirty.
+ *
+ * @api
+ */
+ps_error_t pscFlush(PersistentCacheDriver *pscp) {
+
+  osalDbgCheck(pscp != NULL);
+  osalDbgAssert(pscp->state == PSC_READY, "invalid state");
+
+  return psc_writeback(pscp);
+}
+
+/**
+ * @brief   Requests an immediate write-back.
+ * @details The serving thread starts the write-back without waiting the
+ *          coalescing delay, this function is meant to be called from a
+ *          power-fail interrupt handler.
+ *
+ * @param[in] pscp      pointer to the @p PersistentCacheDriver object
+ *
+ * @iclass
+ */
+void pscRequestFlushI(PersistentCacheDriver *pscp) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck(pscp != NULL);
+
+  if (pscp->state == PSC_READY) {
+    pscp->urgent = true;
+    osalThreadResumeI(&pscp->thread, MSG_OK);
+  }
+}
+
+/**
+ * @brief   Serves the write-back.
+ * @details The function waits for dirty pages, waits the coalescing delay
+ *          unless an immediate write-back is requested, then writes back
+ *          all the dirty pages.
+ * @note    Failed pages are retried on the next invocation after the
+ *          coalescing delay.
+ *
+ * @param[in] pscp      pointer to the @p PersistentCacheDriver object
+ * @return              The operation status.
+ * @retval MSG_OK       if a write-back has been performed, check the
+ *                      @p error field for the outcome.
+ * @retval MSG_RESET    if the driver has been stopped.
+ *
+ * @api
+ */
+msg_t pscServe(PersistentCacheDriver *pscp) {
+
+  osalDbgCheck(pscp != NULL);
+
+  osalSysLock();
+  if (pscp->state != PSC_READY) {
+    osalSysUnlock();
+    return MSG_RESET;
+  }
+
+  /* Waiting for dirty pages.*/
+  if ((pscp->ndirty == 0U) && !pscp->urgent) {
+    if (osalThreadSuspendS(&pscp->thread) == MSG_RESET) {
+      osalSysUnlock();
+      return MSG_RESET;
+    }
+  }
+
+  /* Coalescing delay, an immediate write-back request or the threshold
+     interrupt it.*/
+  if (!pscp->urgent && (pscp->config->delay > (sysinterval_t)0)) {
+    if (osalThreadSuspendTimeoutS(&pscp->thread,
+                                  pscp->config->delay) == MSG_RESET) {
+      osalSysUnlock();
+      return MSG_RESET;
+    }
+  }
+  pscp->urgent = false;
+  osalSysUnlock();
+
+  (void) psc_writeback(pscp);
+
+  return MSG_OK;
+}
+
+/** @} */
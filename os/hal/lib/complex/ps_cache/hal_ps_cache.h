@@ -0,0 +1,219 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_ps_cache.h
+ * @brief   Persistent storage cache module header.
+ *
+ * @addtogroup HAL_PS_CACHE
+ * @{
+ */
+
+#ifndef HAL_PS_CACHE_H
+#define HAL_PS_CACHE_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  PSC_UNINIT = 0,                   /**< Not initialized.                   */
+  PSC_STOP = 1,                     /**< Stopped.                           */
+  PSC_READY = 2                     /**< Ready.                             */
+} pscstate_t;
+
+/**
+ * @brief   Type of a persistent storage cache configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Underlying persistent storage.
+   */
+  BasePersistentStorage     *psp;
+  /**
+   * @brief   RAM shadow of the storage.
+   * @note    The buffer must be large enough for the whole underlying
+   *          storage.
+   */
+  uint8_t                   *shadow;
+  /**
+   * @brief   Size of the RAM shadow.
+   */
+  size_t                    size;
+  /**
+   * @brief   Dirty pages bitmap.
+   * @note    The bitmap must be @p PSC_DIRTY_WORDS() words large.
+   */
+  uint32_t                  *dirty;
+  /**
+   * @brief   Page buffer.
+   * @details Pages are copied in this buffer before being written back so
+   *          the shadow is not locked during the storage write cycles.
+   * @note    The buffer must be @p page_size bytes large.
+   */
+  uint8_t                   *pbuf;
+  /**
+   * @brief   Write-back page size.
+   * @note    Write-back operations never cross page boundaries.
+   */
+  size_t                    page_size;
+  /**
+   * @brief   Write-back delay.
+   * @details Dirty pages are written back after this delay from the
+   *          first write, further writes in this interval are coalesced.
+   *          Zero means write-back as soon as possible.
+   */
+  sysinterval_t             delay;
+  /**
+   * @brief   Dirty pages threshold.
+   * @details Write-back starts without waiting the delay when this number
+   *          of dirty pages is reached, zero disables the threshold.
+   */
+  size_t                    threshold;
+} PersistentCacheConfig;
+
+/**
+ * @brief   @p PersistentCacheDriver specific methods.
+ */
+#define _persistent_cache_driver_methods                                    \
+  _base_persistent_storage_methods
+
+/**
+ * @extends BasePersistentStorageVMT
+ *
+ * @brief   @p PersistentCacheDriver virtual methods table.
+ */
+struct PersistentCacheDriverVMT {
+  _persistent_cache_driver_methods
+};
+
+/**
+ * @extends BasePersistentStorage
+ *
+ * @brief   Type of a persistent storage cache driver.
+ * @details The driver is a persistent storage stacked on another
+ *          persistent storage.
+ */
+typedef struct {
+  /**
+   * @brief   Virtual Methods Table.
+   */
+  const struct PersistentCacheDriverVMT *vmt;
+  _base_persistent_storage_data
+  /**
+   * @brief   Driver state.
+   */
+  pscstate_t                state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const PersistentCacheConfig *config;
+  /**
+   * @brief   Storage size.
+   */
+  size_t                    size;
+  /**
+   * @brief   Number of dirty pages.
+   */
+  size_t                    ndirty;
+  /**
+   * @brief   Immediate write-back request.
+   */
+  bool                      urgent;
+  /**
+   * @brief   Last write-back error.
+   */
+  ps_error_t                error;
+  /**
+   * @brief   Waiting serving thread.
+   */
+  thread_reference_t        thread;
+  /**
+   * @brief   Shadow and dirty pages bitmap access mutex.
+   */
+  mutex_t                   mtx;
+  /**
+   * @brief   Underlying storage access mutex.
+   */
+  mutex_t                   wmtx;
+} PersistentCacheDriver;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of the dirty pages bitmap in words.
+ *
+ * @param[in] size      storage size
+ * @param[in] psize     page size
+ */
+#define PSC_DIRTY_WORDS(size, psize)                                        \
+  (((((size) + (psize) - 1U) / (psize)) + 31U) / 32U)
+
+/**
+ * @brief   Returns the number of dirty pages.
+ *
+ * @param[in] pscp      pointer to the @p PersistentCacheDriver object
+ *
+ * @xclass
+ */
+#define pscGetDirtyPagesX(pscp) ((pscp)->ndirty)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void pscObjectInit(PersistentCacheDriver *pscp);
+  ps_error_t pscStart(PersistentCacheDriver *pscp,
+                      const PersistentCacheConfig *config);
+  ps_error_t pscStop(PersistentCacheDriver *pscp);
+  size_t pscGetSize(PersistentCacheDriver *pscp);
+  ps_error_t pscRead(PersistentCacheDriver *pscp, ps_offset_t offset,
+                     size_t n, uint8_t *rp);
+  ps_error_t pscWrite(PersistentCacheDriver *pscp, ps_offset_t offset,
+                      size_t n, const uint8_t *wp);
+  ps_error_t pscFlush(PersistentCacheDriver *pscp);
+  void pscRequestFlushI(PersistentCacheDriver *pscp);
+  msg_t pscServe(PersistentCacheDriver *pscp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_PS_CACHE_H */
+
+/** @} */
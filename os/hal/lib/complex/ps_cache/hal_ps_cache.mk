@@ -0,0 +1,9 @@
+# List of all the persistent storage cache subsystem files.
+PSCACHESRC := $(CHIBIOS)/os/hal/lib/complex/ps_cache/hal_ps_cache.c
+
+# Required include directories
+PSCACHEINC := $(CHIBIOS)/os/hal/lib/complex/ps_cache
+
+# Shared variables
+ALLCSRC += $(PSCACHESRC)
+ALLINC  += $(PSCACHEINC)
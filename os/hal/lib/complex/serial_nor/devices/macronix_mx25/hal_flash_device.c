@@ -133,9 +133,18 @@ static bool mx25_find_id(const uint8_t *set, size_t size, uint8_t element) {
   return false;
 }
 
-static flash_error_t mx25_poll_status(SNORDriver *devp) {
-  uint8_t sts[2], sec[2];
+static void mx25_wait_ready(SNORDriver *devp) {
+  uint8_t sts[2];
 
+#if SNOR_BUS_SUPPORTS_POLLING == TRUE
+  /* Read status command polled by the bus until the WIP bit is zero.*/
+#if MX25_BUS_MODE == MX25_BUS_MODE_SPI
+  bus_cmd_poll(devp->config->busp, MX25_CMD_SPI_RDSR, 1U, 0U, 1U, sts);
+#else
+  bus_cmd_addr_dummy_poll(devp->config->busp, MX25_CMD_OPI_RDSR,
+                          0U, 4U, 1U, 0U, 2U, sts); /*Note: always 4 dummies.*/
+#endif
+#else
   do {
 #if MX25_NICE_WAITING == TRUE
     osalThreadSleepMilliseconds(1);
@@ -148,6 +157,13 @@ static flash_error_t mx25_poll_status(SNORDriver *devp) {
                                0U, 4U, 2U, sts);   /*Note: always 4 dummies.*/
 #endif
   } while ((sts[0] & 1U) != 0U);
+#endif
+}
+
+static flash_error_t mx25_poll_status(SNORDriver *devp) {
+  uint8_t sec[2];
+
+  mx25_wait_ready(devp);
 
   /* Reading security register and checking for errors.*/
 #if MX25_BUS_MODE == MX25_BUS_MODE_SPI
@@ -650,13 +666,94 @@ flash_error_t snor_device_query_erase(SNORDriver *devp, uint32_t *msec) {
   return FLASH_NO_ERROR;
 }
 
+/**
+ * @brief   Suspends an erase in progress.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ * @return              An error code.
+ * @retval FLASH_NO_ERROR if the erase was already over.
+ * @retval FLASH_BUSY_ERASING if the erase has been suspended.
+ */
+flash_error_t snor_device_suspend_erase(SNORDriver *devp) {
+  uint8_t sec[2];
+#if SNOR_BUS_SUPPORTS_POLLING == FALSE
+  uint8_t sts[2];
+#endif
+
+  /* Suspend command.*/
+#if MX25_BUS_MODE == MX25_BUS_MODE_SPI
+  bus_cmd(devp->config->busp, MX25_CMD_SPI_PE_SUSPEND);
+#else
+  bus_cmd(devp->config->busp, MX25_CMD_OPI_PE_SUSPEND);
+#endif
+
+  /* Waiting for the device to accept commands.*/
+#if SNOR_BUS_SUPPORTS_POLLING == TRUE
+  mx25_wait_ready(devp);
+#else
+  do {
+#if MX25_BUS_MODE == MX25_BUS_MODE_SPI
+    bus_cmd_receive(devp->config->busp, MX25_CMD_SPI_RDSR, 1U, sts);
+#else
+    bus_cmd_addr_dummy_receive(devp->config->busp, MX25_CMD_OPI_RDSR,
+                               0U, 4U, 2U, sts);   /*Note: always 4 dummies.*/
+#endif
+  } while ((sts[0] & 1U) != 0U);
+#endif
+
+  /* If the erase suspend bit is not set then the erase was already over.*/
+#if MX25_BUS_MODE == MX25_BUS_MODE_SPI
+  bus_cmd_receive(devp->config->busp, MX25_CMD_SPI_RDSCUR, 1U, sec);
+#else
+  bus_cmd_addr_dummy_receive(devp->config->busp, MX25_CMD_OPI_RDSCUR,
+                             0U, 4U, 2U, sec);     /*Note: always 4 dummies.*/
+#endif
+  if ((sec[0] & MX25_FLAGS_ESB) == 0U) {
+
+    return FLASH_NO_ERROR;
+  }
+
+  return FLASH_BUSY_ERASING;
+}
+
+/**
+ * @brief   Resumes a suspended erase.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ */
+void snor_device_resume_erase(SNORDriver *devp) {
+
+#if MX25_BUS_MODE == MX25_BUS_MODE_SPI
+  bus_cmd(devp->config->busp, MX25_CMD_SPI_PE_RESUME);
+#else
+  bus_cmd(devp->config->busp, MX25_CMD_OPI_PE_RESUME);
+#endif
+}
+
 flash_error_t snor_device_read_sfdp(SNORDriver *devp, flash_offset_t offset,
                                     size_t n, uint8_t *rp) {
 
-  (void)devp;
-  (void)rp;
-  (void)offset;
-  (void)n;
+#if SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI
+#if MX25_BUS_MODE == MX25_BUS_MODE_SPI
+  wspi_command_t cmd;
+
+  /* The SFDP area always uses 24 bits addressing in SPI mode.*/
+  cmd.cmd   = MX25_CMD_SPI_RDSFDP;
+  cmd.cfg   = (MX25_CFG_C8_A32_DATA_SPI & ~WSPI_CFG_ADDR_SIZE_MASK) |
+              WSPI_CFG_ADDR_SIZE_24;
+  cmd.addr  = offset;
+  cmd.alt   = 0U;
+  cmd.dummy = 8U;
+  wspiReceive(devp->config->busp, &cmd, n, rp);
+#else
+  /* Note, always 20 dummy cycles in OPI modes.*/
+  bus_cmd_addr_dummy_receive(devp->config->busp, MX25_CMD_OPI_RDSFDP,
+                             offset, 20U, n, rp);
+#endif
+#else
+  bus_cmd_addr_dummy_receive(devp->config->busp, MX25_CMD_SPI_RDSFDP,
+                             offset, 8U, n, rp);
+#endif
 
   return FLASH_NO_ERROR;
 }
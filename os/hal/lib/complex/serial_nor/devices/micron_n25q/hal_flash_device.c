@@ -198,6 +198,11 @@ static bool n25q_find_id(const uint8_t *set, size_t size, uint8_t element) {
 static flash_error_t n25q_poll_status(SNORDriver *devp) {
   uint8_t sts;
 
+#if SNOR_BUS_SUPPORTS_POLLING == TRUE
+  /* Read status command polled by the bus until the P/E bit is one.*/
+  bus_cmd_poll(devp->config->busp, N25Q_CMD_READ_FLAG_STATUS_REGISTER,
+               N25Q_FLAGS_PROGRAM_ERASE, N25Q_FLAGS_PROGRAM_ERASE, 1, &sts);
+#else
   do {
 #if N25Q_NICE_WAITING == TRUE
     osalThreadSleepMilliseconds(1);
@@ -206,6 +211,7 @@ static flash_error_t n25q_poll_status(SNORDriver *devp) {
     bus_cmd_receive(devp->config->busp, N25Q_CMD_READ_FLAG_STATUS_REGISTER,
                     1, &sts);
   } while ((sts & N25Q_FLAGS_PROGRAM_ERASE) == 0U);
+#endif
 
   /* Checking for errors.*/
   if ((sts & N25Q_FLAGS_ALL_ERRORS) != 0U) {
@@ -517,13 +523,41 @@ flash_error_t snor_device_query_erase(SNORDriver *devp, uint32_t *msec) {
   return FLASH_NO_ERROR;
 }
 
+flash_error_t snor_device_suspend_erase(SNORDriver *devp) {
+  uint8_t sts;
+
+  /* Suspend command, then waiting for the device to accept commands.*/
+  bus_cmd(devp->config->busp, N25Q_CMD_PROGRAM_ERASE_SUSPEND);
+#if SNOR_BUS_SUPPORTS_POLLING == TRUE
+  bus_cmd_poll(devp->config->busp, N25Q_CMD_READ_FLAG_STATUS_REGISTER,
+               N25Q_FLAGS_PROGRAM_ERASE, N25Q_FLAGS_PROGRAM_ERASE, 1, &sts);
+#else
+  do {
+    bus_cmd_receive(devp->config->busp, N25Q_CMD_READ_FLAG_STATUS_REGISTER,
+                    1, &sts);
+  } while ((sts & N25Q_FLAGS_PROGRAM_ERASE) == 0U);
+#endif
+
+  /* If the suspend flag is not set then the erase was already over.*/
+  if ((sts & N25Q_FLAGS_ERASE_SUSPEND) == 0U) {
+    return FLASH_NO_ERROR;
+  }
+
+  return FLASH_BUSY_ERASING;
+}
+
+void snor_device_resume_erase(SNORDriver *devp) {
+
+  bus_cmd(devp->config->busp, N25Q_CMD_PROGRAM_ERASE_RESUME);
+}
+
 flash_error_t snor_device_read_sfdp(SNORDriver *devp, flash_offset_t offset,
                                     size_t n, uint8_t *rp) {
 
-  (void)devp;
-  (void)rp;
-  (void)offset;
-  (void)n;
+  /* Note, always 8 dummy cycles regardless the configured protocol.*/
+  bus_cmd_addr_dummy_receive(devp->config->busp,
+                             N25Q_CMD_READ_DISCOVERY_PARAMETER,
+                             offset, 8U, n, rp);
 
   return FLASH_NO_ERROR;
 }
@@ -22,6 +22,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 #include "hal_serial_nor.h"
 
@@ -29,6 +31,11 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+#if (SNOR_USE_ERASE_SUSPEND == TRUE) &&                                     \
+    (SNOR_DEVICE_SUPPORTS_ERASE_SUSPEND == FALSE)
+#error "SNOR_USE_ERASE_SUSPEND requires a device supporting erase suspend"
+#endif
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -119,6 +126,143 @@ void bus_release(BUSDriver *busp) {
 #define bus_release(busp)
 #endif
 
+#if ((SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) &&                           \
+     (WSPI_SUPPORTS_MEMMAP == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @brief   Suspends the memory mapped mode for a command operation.
+ * @details The part of the mapped area that is going to be modified is
+ *          invalidated from the data cache, no cache lines can be loaded
+ *          while the mapping is suspended.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[in] offset    offset of the area to be modified
+ * @param[in] n         size of the area to be modified, zero if none
+ *
+ * @notapi
+ */
+static void snor_mmap_suspend(SNORDriver *devp,
+                              flash_offset_t offset, size_t n) {
+
+  if (devp->mapaddr != NULL) {
+
+    /* Stopping WSPI memory mapped mode.*/
+    wspiUnmapFlash(devp->config->busp);
+
+#if SNOR_DEVICE_SUPPORTS_XIP == TRUE
+    snor_reset_xip(devp);
+#endif
+
+    if (n > 0U) {
+      cacheBufferInvalidate(devp->mapaddr + offset, n);
+    }
+  }
+}
+
+/**
+ * @brief   Resumes the memory mapped mode after a command operation.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ *
+ * @notapi
+ */
+static void snor_mmap_resume(SNORDriver *devp) {
+
+  if (devp->mapaddr != NULL) {
+
+#if SNOR_DEVICE_SUPPORTS_XIP == TRUE
+    /* Activating XIP mode in the device.*/
+    snor_activate_xip(devp);
+#endif
+
+    /* Starting WSPI memory mapped mode.*/
+    wspiMapFlash(devp->config->busp, &snor_memmap_read, NULL);
+  }
+}
+#else
+/* No memory mapping, empty macros.*/
+#define snor_mmap_suspend(devp, offset, n)
+#define snor_mmap_resume(devp)
+#endif
+
+#if (SNOR_USE_ERASE_SUSPEND == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Reads data while an erase operation is in progress.
+ * @details The erase is suspended for the duration of the read and then
+ *          resumed, the area being erased cannot be read.
+ * @note    The memory mapped mode is suspended during erase operations so
+ *          data is read using commands.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[in] offset    flash offset
+ * @param[in] n         number of bytes to be read
+ * @param[out] rp       pointer to the data buffer
+ * @return              An error code.
+ *
+ * @notapi
+ */
+static flash_error_t snor_read_suspended(SNORDriver *devp,
+                                         flash_offset_t offset,
+                                         size_t n, uint8_t *rp) {
+  flash_error_t err;
+  bool suspended;
+
+  if (((size_t)offset < (size_t)devp->erase_offset + devp->erase_size) &&
+      ((size_t)offset + n > (size_t)devp->erase_offset)) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* Bus acquired.*/
+  bus_acquire(devp->config->busp, devp->config->buscfg);
+
+  /* If the erase was already over then nothing has to be resumed, the
+     end of the erase is detected by the next query.*/
+  suspended = snor_device_suspend_erase(devp) == FLASH_BUSY_ERASING;
+  err = snor_device_read(devp, offset, n, rp);
+  if (suspended) {
+    snor_device_resume_erase(devp);
+  }
+
+  /* Bus released.*/
+  bus_release(devp->config->busp);
+
+  return err;
+}
+#endif
+
+/**
+ * @brief   Fetches a little endian SFDP double word.
+ *
+ * @param[in] p         pointer to the SFDP table
+ * @param[in] n         double word number, starting from one
+ * @return              The double word value.
+ *
+ * @notapi
+ */
+static uint32_t sfdp_dword(const uint8_t *p, unsigned n) {
+
+  p += (n - 1U) * 4U;
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+         ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief   Decodes an SFDP 16 bits fast read instruction descriptor.
+ *
+ * @param[out] rdp      pointer to the descriptor to be filled
+ * @param[in] protocol  the protocol bit
+ * @param[in] field     the 16 bits field
+ *
+ * @notapi
+ */
+static void sfdp_set_read(snor_sfdp_read_t *rdp, uint32_t protocol,
+                          uint32_t field) {
+
+  rdp->protocol     = protocol;
+  rdp->opcode       = (uint8_t)(field >> 8);
+  rdp->mode_clocks  = (uint8_t)((field >> 5) & 7U);
+  rdp->dummy_clocks = (uint8_t)(field & 31U);
+}
+
 /**
  * @brief   Returns a pointer to the device descriptor.
  *
@@ -146,7 +290,11 @@ static flash_error_t snor_read(void *instance, flash_offset_t offset,
                 "invalid state");
 
   if (devp->state == FLASH_ERASE) {
+#if SNOR_USE_ERASE_SUSPEND == TRUE
+    return snor_read_suspended(devp, offset, n, rp);
+#else
     return FLASH_BUSY_ERASING;
+#endif
   }
 
   /* Bus acquired.*/
@@ -155,8 +303,18 @@ static flash_error_t snor_read(void *instance, flash_offset_t offset,
   /* FLASH_READY state while the operation is performed.*/
   devp->state = FLASH_READ;
 
-  /* Actual read implementation.*/
-  err = snor_device_read(devp, offset, n, rp);
+#if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) && (WSPI_SUPPORTS_MEMMAP == TRUE)
+  /* Reading from the mapped area if the memory mapped mode is active.*/
+  if (devp->mapaddr != NULL) {
+    memcpy(rp, devp->mapaddr + offset, n);
+    err = FLASH_NO_ERROR;
+  }
+  else
+#endif
+  {
+    /* Actual read implementation.*/
+    err = snor_device_read(devp, offset, n, rp);
+  }
 
   /* Ready state again.*/
   devp->state = FLASH_READY;
@@ -189,7 +347,9 @@ static flash_error_t snor_program(void *instance, flash_offset_t offset,
   devp->state = FLASH_PGM;
 
   /* Actual program implementation.*/
+  snor_mmap_suspend(devp, offset, n);
   err = snor_device_program(devp, offset, n, pp);
+  snor_mmap_resume(devp);
 
   /* Ready state again.*/
   devp->state = FLASH_READY;
@@ -217,13 +377,18 @@ static flash_error_t snor_start_erase_all(void *instance) {
 
   /* FLASH_ERASE state while the operation is performed.*/
   devp->state = FLASH_ERASE;
+#if SNOR_USE_ERASE_SUSPEND == TRUE
+  devp->erase_offset = 0U;
+  devp->erase_size   = (size_t)snor_descriptor.sectors_count *
+                       (size_t)snor_descriptor.sectors_size;
+#endif
 
-  /* Actual erase implementation.*/
+  /* Actual erase implementation, the memory mapped mode is resumed
+     when the erase is over.*/
+  snor_mmap_suspend(devp, 0U, (size_t)snor_descriptor.sectors_count *
+                              (size_t)snor_descriptor.sectors_size);
   err = snor_device_start_erase_all(devp);
 
-  /* Ready state again.*/
-  devp->state = FLASH_READY;
-
   /* Bus released.*/
   bus_release(devp->config->busp);
 
@@ -249,8 +414,15 @@ static flash_error_t snor_start_erase_sector(void *instance,
 
   /* FLASH_ERASE state while the operation is performed.*/
   devp->state = FLASH_ERASE;
+#if SNOR_USE_ERASE_SUSPEND == TRUE
+  devp->erase_offset = flashGetSectorOffset(getBaseFlash(devp), sector);
+  devp->erase_size   = (size_t)flashGetSectorSize(getBaseFlash(devp), sector);
+#endif
 
-  /* Actual erase implementation.*/
+  /* Actual erase implementation, the memory mapped mode is resumed
+     when the erase is over.*/
+  snor_mmap_suspend(devp, flashGetSectorOffset(getBaseFlash(devp), sector),
+                    flashGetSectorSize(getBaseFlash(devp), sector));
   err = snor_device_start_erase_sector(devp, sector);
 
   /* Bus released.*/
@@ -280,7 +452,9 @@ static flash_error_t snor_verify_erase(void *instance,
   devp->state = FLASH_READ;
 
   /* Actual verify erase implementation.*/
+  snor_mmap_suspend(devp, 0U, 0U);
   err = snor_device_verify_erase(devp, sector);
+  snor_mmap_resume(devp);
 
   /* Ready state again.*/
   devp->state = FLASH_READY;
@@ -308,13 +482,24 @@ static flash_error_t snor_query_erase(void *instance, uint32_t *msec) {
     /* Actual query erase implementation.*/
     err = snor_device_query_erase(devp, msec);
 
-    /* The device is ready to accept commands.*/
+    /* The device is ready to accept commands, the memory mapped mode
+       is resumed.*/
     if (err == FLASH_NO_ERROR) {
       devp->state = FLASH_READY;
+      snor_mmap_resume(devp);
     }
 
     /* Bus released.*/
     bus_release(devp->config->busp);
+
+#if SNOR_USE_EVENTS == TRUE
+    /* Notifying the end of the erase operation.*/
+    if (err != FLASH_BUSY_ERASING) {
+      osalEventBroadcastFlags(&devp->event,
+                              err == FLASH_NO_ERROR ? SNOR_ERASE_COMPLETED :
+                                                      SNOR_ERASE_FAILED);
+    }
+#endif
   }
   else {
     err = FLASH_NO_ERROR;
@@ -340,7 +525,9 @@ static flash_error_t snor_read_sfdp(void *instance, flash_offset_t offset,
   bus_acquire(devp->config->busp, devp->config->buscfg);
 
   /* Actual read SFDP implementation.*/
+  snor_mmap_suspend(devp, 0U, 0U);
   err = snor_device_read_sfdp(devp, offset, n, rp);
+  snor_mmap_resume(devp);
 
   /* The device is ready to accept commands.*/
   if (err == FLASH_NO_ERROR) {
@@ -605,10 +792,12 @@ void bus_cmd_dummy_receive(BUSDriver *busp,
   mode.dummy = dummy;
   wspiReceive(busp, &mode, n, p);
 }
+#endif /* SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI */
 
 /**
  * @brief   Sends a command followed by a flash address, dummy cycles and a
  *          data receive phase.
+ * @note    In SPI mode the dummy cycles are rounded down to whole bytes.
  *
  * @param[in] busp      pointer to the bus driver
  * @param[in] cmd       instruction code
@@ -625,6 +814,7 @@ void bus_cmd_addr_dummy_receive(BUSDriver *busp,
                                 uint32_t dummy,
                                 size_t n,
                                 uint8_t *p) {
+#if SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI
   wspi_command_t mode;
 
   mode.cmd   = cmd;
@@ -633,8 +823,91 @@ void bus_cmd_addr_dummy_receive(BUSDriver *busp,
   mode.alt   = 0U;
   mode.dummy = dummy;
   wspiReceive(busp, &mode, n, p);
+#else
+  uint8_t buf[4];
+
+  spiSelect(busp);
+  buf[0] = cmd;
+  buf[1] = (uint8_t)(offset >> 16);
+  buf[2] = (uint8_t)(offset >> 8);
+  buf[3] = (uint8_t)(offset >> 0);
+  spiSend(busp, 4, buf);
+  if (dummy >= 8U) {
+    spiIgnore(busp, (size_t)(dummy / 8U));
+  }
+  spiReceive(busp, n, p);
+  spiUnselect(busp);
+#endif
 }
-#endif /* SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI */
+
+#if (SNOR_BUS_SUPPORTS_POLLING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Sends a command followed by a data receive phase until a match.
+ * @details The command is repeated by the bus hardware until the received
+ *          data masked by @p mask is equal to @p match, the thread sleeps
+ *          meanwhile.
+ *
+ * @param[in] busp      pointer to the bus driver
+ * @param[in] cmd       instruction code
+ * @param[in] mask      mask of the compared bits
+ * @param[in] match     expected value of the compared bits
+ * @param[in] n         number of bytes to receive, from 1 to 4
+ * @param[out] p        buffer receiving the matched data
+ *
+ * @notapi
+ */
+void bus_cmd_poll(BUSDriver *busp,
+                  uint32_t cmd,
+                  uint32_t mask,
+                  uint32_t match,
+                  size_t n,
+                  uint8_t *p) {
+  wspi_command_t mode;
+
+  mode.cmd   = cmd;
+  mode.cfg   = SNOR_WSPI_CFG_CMD_DATA;
+  mode.addr  = 0U;
+  mode.alt   = 0U;
+  mode.dummy = 0U;
+  wspiPoll(busp, &mode, n, mask, match, p);
+}
+
+/**
+ * @brief   Sends a command followed by a flash address, dummy cycles and a
+ *          data receive phase until a match.
+ * @details The command is repeated by the bus hardware until the received
+ *          data masked by @p mask is equal to @p match, the thread sleeps
+ *          meanwhile.
+ *
+ * @param[in] busp      pointer to the bus driver
+ * @param[in] cmd       instruction code
+ * @param[in] offset    flash offset
+ * @param[in] dummy     number of dummy cycles
+ * @param[in] mask      mask of the compared bits
+ * @param[in] match     expected value of the compared bits
+ * @param[in] n         number of bytes to receive, from 1 to 4
+ * @param[out] p        buffer receiving the matched data
+ *
+ * @notapi
+ */
+void bus_cmd_addr_dummy_poll(BUSDriver *busp,
+                             uint32_t cmd,
+                             flash_offset_t offset,
+                             uint32_t dummy,
+                             uint32_t mask,
+                             uint32_t match,
+                             size_t n,
+                             uint8_t *p) {
+  wspi_command_t mode;
+
+  mode.cmd   = cmd;
+  mode.cfg   = SNOR_WSPI_CFG_CMD_ADDR_DATA;
+  mode.addr  = offset;
+  mode.alt   = 0U;
+  mode.dummy = dummy;
+  wspiPoll(busp, &mode, n, mask, match, p);
+}
+#endif /* SNOR_BUS_SUPPORTS_POLLING == TRUE */
 
 /**
  * @brief   Initializes an instance.
@@ -650,6 +923,12 @@ void snorObjectInit(SNORDriver *devp) {
   devp->vmt         = &snor_vmt;
   devp->state       = FLASH_STOP;
   devp->config      = NULL;
+#if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) && (WSPI_SUPPORTS_MEMMAP == TRUE)
+  devp->mapaddr     = NULL;
+#endif
+#if SNOR_USE_EVENTS == TRUE
+  osalEventObjectInit(&devp->event);
+#endif
 }
 
 /**
@@ -694,6 +973,9 @@ void snorStop(SNORDriver *devp) {
 
   osalDbgCheck(devp != NULL);
   osalDbgAssert(devp->state != FLASH_UNINIT, "invalid state");
+#if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) && (WSPI_SUPPORTS_MEMMAP == TRUE)
+  osalDbgAssert(devp->mapaddr == NULL, "memory mapped");
+#endif
 
   if (devp->state != FLASH_STOP) {
 
@@ -714,6 +996,144 @@ void snorStop(SNORDriver *devp) {
   }
 }
 
+/**
+ * @brief   Retrieves the JEDEC basic flash parameters from SFDP.
+ * @details The SFDP header and the JESD216 basic flash parameters table
+ *          are read and decoded, devices can use the result in order to
+ *          select the fastest read protocol supported by both the device
+ *          and the bus interface.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[out] sfdpp    pointer to the parameters structure to be filled
+ * @return              An error code.
+ * @retval FLASH_NO_ERROR       if the operation succeeded.
+ * @retval FLASH_BUSY_ERASING   if there is an erase operation in progress.
+ * @retval FLASH_ERROR_READ     if the SFDP data is missing or invalid.
+ *
+ * @api
+ */
+flash_error_t snorGetSFDPParameters(SNORDriver *devp, snor_sfdp_t *sfdpp) {
+  uint8_t buf[64];
+  uint32_t ptp, dw;
+  unsigned ndw, i;
+  flash_error_t err;
+
+  osalDbgCheck((devp != NULL) && (sfdpp != NULL));
+
+  /* SFDP header followed by the mandatory basic parameters header.*/
+  err = snorReadSFDP(devp, 0U, 16U, buf);
+  if (err != FLASH_NO_ERROR) {
+    return err;
+  }
+  if ((buf[0] != 'S') || (buf[1] != 'F') || (buf[2] != 'D') ||
+      (buf[3] != 'P') || (buf[8] != 0x00U) || (buf[10] != 1U) ||
+      (buf[15] != 0xFFU) || (buf[11] < 9U)) {
+    return FLASH_ERROR_READ;
+  }
+  ndw = (buf[11] > 16U) ? 16U : (unsigned)buf[11];
+  ptp = (uint32_t)buf[12] | ((uint32_t)buf[13] << 8) |
+        ((uint32_t)buf[14] << 16);
+  memset(sfdpp, 0, sizeof (snor_sfdp_t));
+  sfdpp->revision = (uint16_t)(((uint16_t)buf[10] << 8) | buf[9]);
+
+  /* Basic flash parameters table.*/
+  err = snorReadSFDP(devp, ptp, ndw * 4U, buf);
+  if (err != FLASH_NO_ERROR) {
+    return err;
+  }
+
+  /* Density, in bits.*/
+  dw = sfdp_dword(buf, 2U);
+  if ((dw & 0x80000000U) == 0U) {
+    sfdpp->size = (dw / 8U) + 1U;
+  }
+  else {
+    dw &= 0x7FFFFFFFU;
+    if ((dw < 3U) || (dw > 34U)) {
+      return FLASH_ERROR_READ;
+    }
+    sfdpp->size = (uint32_t)1U << (dw - 3U);
+  }
+
+  /* Fast read protocols.*/
+  dw = sfdp_dword(buf, 1U);
+  if ((dw & (1U << 16)) != 0U) {
+    sfdp_set_read(&sfdpp->reads[0], SNOR_SFDP_READ_1_1_2,
+                  sfdp_dword(buf, 4U) & 0xFFFFU);
+  }
+  if ((dw & (1U << 20)) != 0U) {
+    sfdp_set_read(&sfdpp->reads[1], SNOR_SFDP_READ_1_2_2,
+                  sfdp_dword(buf, 4U) >> 16);
+  }
+  if ((sfdp_dword(buf, 5U) & (1U << 0)) != 0U) {
+    sfdp_set_read(&sfdpp->reads[2], SNOR_SFDP_READ_2_2_2,
+                  sfdp_dword(buf, 6U) >> 16);
+  }
+  if ((dw & (1U << 22)) != 0U) {
+    sfdp_set_read(&sfdpp->reads[3], SNOR_SFDP_READ_1_1_4,
+                  sfdp_dword(buf, 3U) >> 16);
+  }
+  if ((dw & (1U << 21)) != 0U) {
+    sfdp_set_read(&sfdpp->reads[4], SNOR_SFDP_READ_1_4_4,
+                  sfdp_dword(buf, 3U) & 0xFFFFU);
+  }
+  if ((sfdp_dword(buf, 5U) & (1U << 4)) != 0U) {
+    sfdp_set_read(&sfdpp->reads[5], SNOR_SFDP_READ_4_4_4,
+                  sfdp_dword(buf, 7U) >> 16);
+  }
+  for (i = 0U; i < SNOR_SFDP_READ_PROTOCOLS; i++) {
+    sfdpp->read_protocols |= sfdpp->reads[i].protocol;
+  }
+
+  /* Erase types, sizes are encoded as powers of two.*/
+  for (i = 0U; i < 4U; i++) {
+    dw = sfdp_dword(buf, 8U + (i / 2U)) >> ((i & 1U) * 16U);
+    if (((dw & 0xFFU) != 0U) && ((dw & 0xFFU) < 32U)) {
+      sfdpp->erase_sizes[i]   = (uint32_t)1U << (dw & 0xFFU);
+      sfdpp->erase_opcodes[i] = (uint8_t)(dw >> 8);
+    }
+  }
+
+  /* Page size, only present in JESD216A and later tables.*/
+  if (ndw >= 11U) {
+    sfdpp->page_size = (uint32_t)1U << ((sfdp_dword(buf, 11U) >> 4) & 15U);
+  }
+  else {
+    sfdpp->page_size = 256U;
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Selects the fastest SFDP read protocol.
+ *
+ * @param[in] sfdpp     pointer to the parameters retrieved from SFDP
+ * @param[in] protocols mask of the @p SNOR_SFDP_READ_x protocols supported
+ *                      by the bus interface
+ * @return              Pointer to the read instruction descriptor.
+ * @retval NULL         if no common fast read protocol exists.
+ *
+ * @api
+ */
+const snor_sfdp_read_t *snorSFDPGetFastestRead(const snor_sfdp_t *sfdpp,
+                                               uint32_t protocols) {
+  unsigned i;
+
+  osalDbgCheck(sfdpp != NULL);
+
+  protocols &= sfdpp->read_protocols;
+  i = SNOR_SFDP_READ_PROTOCOLS;
+  while (i > 0U) {
+    i--;
+    if ((protocols & (1U << i)) != 0U) {
+      return &sfdpp->reads[i];
+    }
+  }
+
+  return NULL;
+}
+
 #if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) || defined(__DOXYGEN__)
 #if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
 /**
@@ -721,6 +1141,10 @@ void snorStop(SNORDriver *devp) {
  * @details The memory mapping mode is only available when the WSPI mode
  *          is selected and the underlying WSPI controller supports the
  *          feature.
+ * @note    While the memory mapped mode is active the driver reads from
+ *          the mapped area, program and erase operations temporarily
+ *          suspend the mapping. The mapped area cannot be accessed while
+ *          an erase operation is in progress.
  *
  * @param[in] devp      pointer to the @p SNORDriver object
  * @param[out] addrp    pointer to the memory start address of the mapped
@@ -730,6 +1154,10 @@ void snorStop(SNORDriver *devp) {
  */
 void snorMemoryMap(SNORDriver *devp, uint8_t **addrp) {
 
+  osalDbgCheck(devp != NULL);
+  osalDbgAssert(devp->state == FLASH_READY, "invalid state");
+  osalDbgAssert(devp->mapaddr == NULL, "already mapped");
+
   /* Bus acquisition.*/
   bus_acquire(devp->config->busp, devp->config->buscfg);
 
@@ -739,7 +1167,10 @@ void snorMemoryMap(SNORDriver *devp, uint8_t **addrp) {
 #endif
 
   /* Starting WSPI memory mapped mode.*/
-  wspiMapFlash(devp->config->busp, &snor_memmap_read, addrp);
+  wspiMapFlash(devp->config->busp, &snor_memmap_read, &devp->mapaddr);
+  if (addrp != NULL) {
+    *addrp = devp->mapaddr;
+  }
 
   /* Bus release.*/
   bus_release(devp->config->busp);
@@ -754,15 +1185,25 @@ void snorMemoryMap(SNORDriver *devp, uint8_t **addrp) {
  */
 void snorMemoryUnmap(SNORDriver *devp) {
 
+  osalDbgCheck(devp != NULL);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+  osalDbgAssert(devp->mapaddr != NULL, "not mapped");
+
   /* Bus acquisition.*/
   bus_acquire(devp->config->busp, devp->config->buscfg);
 
-  /* Stopping WSPI memory mapped mode.*/
-  wspiUnmapFlash(devp->config->busp);
+  /* The mapping is already suspended during erase operations.*/
+  if (devp->state != FLASH_ERASE) {
+
+    /* Stopping WSPI memory mapped mode.*/
+    wspiUnmapFlash(devp->config->busp);
 
 #if SNOR_DEVICE_SUPPORTS_XIP == TRUE
-  snor_reset_xip(devp);
+    snor_reset_xip(devp);
 #endif
+  }
+  devp->mapaddr = NULL;
 
   /* Bus release.*/
   bus_release(devp->config->busp);
@@ -39,6 +39,28 @@
 #define SNOR_BUS_DRIVER_WSPI                1U
 /** @} */
 
+/**
+ * @name    SFDP fast read protocols
+ * @note    Protocols are numbered in increasing throughput order.
+ * @{
+ */
+#define SNOR_SFDP_READ_1_1_2                (1U << 0)
+#define SNOR_SFDP_READ_1_2_2                (1U << 1)
+#define SNOR_SFDP_READ_2_2_2                (1U << 2)
+#define SNOR_SFDP_READ_1_1_4                (1U << 3)
+#define SNOR_SFDP_READ_1_4_4                (1U << 4)
+#define SNOR_SFDP_READ_4_4_4                (1U << 5)
+#define SNOR_SFDP_READ_PROTOCOLS            6U
+/** @} */
+
+/**
+ * @name    Event flags
+ * @{
+ */
+#define SNOR_ERASE_COMPLETED                (eventflags_t)1
+#define SNOR_ERASE_FAILED                   (eventflags_t)2
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -65,6 +87,27 @@
 #if !defined(SNOR_SHARED_BUS) || defined(__DOXYGEN__)
 #define SNOR_SHARED_BUS                     TRUE
 #endif
+
+/**
+ * @brief   Erase suspend switch.
+ * @details If set to @p TRUE then a read outside the area being erased
+ *          suspends the erase operation, the read is served and the erase
+ *          is resumed. If set to @p FALSE then reads fail with
+ *          @p FLASH_BUSY_ERASING until the erase is over.
+ * @note    Requires a device supporting the erase suspend.
+ */
+#if !defined(SNOR_USE_ERASE_SUSPEND) || defined(__DOXYGEN__)
+#define SNOR_USE_ERASE_SUSPEND              TRUE
+#endif
+
+/**
+ * @brief   Events switch.
+ * @details If set to @p TRUE then the driver has an event source that is
+ *          broadcast when the end of an erase operation is detected.
+ */
+#if !defined(SNOR_USE_EVENTS) || defined(__DOXYGEN__)
+#define SNOR_USE_EVENTS                     FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -81,6 +124,18 @@
 #error "invalid SNOR_BUS_DRIVER setting"
 #endif
 
+/**
+ * @brief   Automatic status polling support.
+ * @details Status polling is performed by the bus hardware, the waiting
+ *          thread sleeps until the device reports ready.
+ */
+#if ((SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) &&                           \
+     (WSPI_SUPPORTS_POLLING == TRUE)) || defined(__DOXYGEN__)
+#define SNOR_BUS_SUPPORTS_POLLING           TRUE
+#else
+#define SNOR_BUS_SUPPORTS_POLLING           FALSE
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -93,6 +148,62 @@ typedef struct {
   const BUSConfig           *buscfg;
 } SNORConfig;
 
+/**
+ * @brief   Type of an SFDP fast read instruction descriptor.
+ */
+typedef struct {
+  /**
+   * @brief   Protocol, one of the @p SNOR_SFDP_READ_x values.
+   */
+  uint32_t                  protocol;
+  /**
+   * @brief   Instruction code.
+   */
+  uint8_t                   opcode;
+  /**
+   * @brief   Number of mode clocks.
+   */
+  uint8_t                   mode_clocks;
+  /**
+   * @brief   Number of dummy clocks.
+   */
+  uint8_t                   dummy_clocks;
+} snor_sfdp_read_t;
+
+/**
+ * @brief   Type of the JEDEC basic flash parameters retrieved from SFDP.
+ */
+typedef struct {
+  /**
+   * @brief   Basic flash parameters table revision, major in the MSB.
+   */
+  uint16_t                  revision;
+  /**
+   * @brief   Device size in bytes.
+   */
+  uint32_t                  size;
+  /**
+   * @brief   Page size in bytes.
+   */
+  uint32_t                  page_size;
+  /**
+   * @brief   Mask of the supported @p SNOR_SFDP_READ_x protocols.
+   */
+  uint32_t                  read_protocols;
+  /**
+   * @brief   Fast read instructions, indexed by protocol bit position.
+   */
+  snor_sfdp_read_t          reads[SNOR_SFDP_READ_PROTOCOLS];
+  /**
+   * @brief   Erase types sizes in bytes, zero if not present.
+   */
+  uint32_t                  erase_sizes[4];
+  /**
+   * @brief   Erase types instruction codes.
+   */
+  uint8_t                   erase_opcodes[4];
+} snor_sfdp_t;
+
 /**
  * @brief   @p SNORDriver specific methods.
  */
@@ -138,12 +249,67 @@ typedef struct {
    * @brief   Device ID and unique ID.
    */
   uint8_t                       device_id[20];
+#if ((SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) &&                           \
+     (WSPI_SUPPORTS_MEMMAP == TRUE)) || defined(__DOXYGEN__)
+  /**
+   * @brief   Memory mapped area address or @p NULL if not mapped.
+   * @note    The mapping is suspended during program and erase
+   *          operations.
+   */
+  uint8_t                       *mapaddr;
+#endif
+#if (SNOR_USE_ERASE_SUSPEND == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Offset of the area being erased.
+   */
+  flash_offset_t                erase_offset;
+  /**
+   * @brief   Size of the area being erased.
+   */
+  size_t                        erase_size;
+#endif
+#if (SNOR_USE_EVENTS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Erase events source.
+   */
+  event_source_t                event;
+#endif
 } SNORDriver;
 
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Reads raw data from the device SFDP area.
+ *
+ * @param[in] ip        pointer to a @p SNORDriver instance
+ * @param[in] offset    offset within the SFDP area
+ * @param[in] n         number of bytes to be read
+ * @param[out] rp       pointer to the data buffer
+ * @return              An error code.
+ *
+ * @api
+ */
+#define snorReadSFDP(ip, offset, n, rp)                                     \
+  (ip)->vmt->read_sfdp(ip, offset, n, rp)
+
+#if (SNOR_USE_EVENTS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the erase events source.
+ * @details The source is broadcast with @p SNOR_ERASE_COMPLETED or
+ *          @p SNOR_ERASE_FAILED when the end of an erase operation is
+ *          detected by @p flashQueryErase() or @p flashWaitErase(), threads
+ *          can wait for the erase without polling the device.
+ *
+ * @param[in] ip        pointer to a @p SNORDriver instance
+ * @return              A pointer to the @p event_source_t object.
+ *
+ * @api
+ */
+#define snorGetEventSource(ip) (&(ip)->event)
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -174,16 +340,35 @@ extern "C" {
                              uint32_t dummy,
                              size_t n,
                              uint8_t *p);
+#endif
   void bus_cmd_addr_dummy_receive(BUSDriver *busp,
                                   uint32_t cmd,
                                   flash_offset_t offset,
                                   uint32_t dummy,
                                   size_t n,
                                   uint8_t *p);
+#if (SNOR_BUS_SUPPORTS_POLLING == TRUE) || defined(__DOXYGEN__)
+  void bus_cmd_poll(BUSDriver *busp,
+                    uint32_t cmd,
+                    uint32_t mask,
+                    uint32_t match,
+                    size_t n,
+                    uint8_t *p);
+  void bus_cmd_addr_dummy_poll(BUSDriver *busp,
+                               uint32_t cmd,
+                               flash_offset_t offset,
+                               uint32_t dummy,
+                               uint32_t mask,
+                               uint32_t match,
+                               size_t n,
+                               uint8_t *p);
 #endif
   void snorObjectInit(SNORDriver *devp);
   void snorStart(SNORDriver *devp, const SNORConfig *config);
   void snorStop(SNORDriver *devp);
+  flash_error_t snorGetSFDPParameters(SNORDriver *devp, snor_sfdp_t *sfdpp);
+  const snor_sfdp_read_t *snorSFDPGetFastestRead(const snor_sfdp_t *sfdpp,
+                                                 uint32_t protocols);
 #if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) || defined(__DOXYGEN__)
 #if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
   void snorMemoryMap(SNORDriver *devp, uint8_t ** addrp);
@@ -0,0 +1,1066 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_usb_msd.c
+ * @brief   USB mass storage class module code.
+ * @details This module implements the USB Mass Storage Bulk-Only Transport
+ *          class exporting a @p BaseBlockDevice as a SCSI direct access
+ *          device. Multi-block transfers are pipelined over a ring of
+ *          buffers, the block device is accessed by the serving thread
+ *          while the previous buffers are exchanged with the host by the
+ *          endpoint callbacks.
+ *          The application serves the driver by calling @p msdServe() in
+ *          a loop from a dedicated thread, the USB events and requests
+ *          callbacks must invoke the driver hooks:
+ * @code
+ *          static THD_FUNCTION(msd_thread, arg) {
+ *
+ *            (void)arg;
+ *            while (true) {
+ *              (void)msdServe(&MSD1);
+ *            }
+ *          }
+ * @endcode
+ *
+ * @addtogroup HAL_USB_MSD
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "hal_usb_msd.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @name    Wrappers signatures
+ * @{
+ */
+#define MSD_CBW_SIGNATURE                   0x43425355U
+#define MSD_CSW_SIGNATURE                   0x53425355U
+/** @} */
+
+/**
+ * @name    Command status values
+ * @{
+ */
+#define MSD_STATUS_PASSED                   0x00U
+#define MSD_STATUS_FAILED                   0x01U
+#define MSD_STATUS_PHASE_ERROR              0x02U
+/** @} */
+
+/**
+ * @name    SCSI commands
+ * @{
+ */
+#define SCSI_TEST_UNIT_READY                0x00U
+#define SCSI_REQUEST_SENSE                  0x03U
+#define SCSI_INQUIRY                        0x12U
+#define SCSI_MODE_SENSE6                    0x1AU
+#define SCSI_START_STOP_UNIT                0x1BU
+#define SCSI_PREVENT_ALLOW_REMOVAL          0x1EU
+#define SCSI_READ_FORMAT_CAPACITIES         0x23U
+#define SCSI_READ_CAPACITY10                0x25U
+#define SCSI_READ10                         0x28U
+#define SCSI_WRITE10                        0x2AU
+#define SCSI_VERIFY10                       0x2FU
+#define SCSI_SYNCHRONIZE_CACHE10            0x35U
+/** @} */
+
+/**
+ * @name    SCSI sense keys
+ * @{
+ */
+#define SCSI_SENSE_NO_SENSE                 0x00U
+#define SCSI_SENSE_NOT_READY                0x02U
+#define SCSI_SENSE_MEDIUM_ERROR             0x03U
+#define SCSI_SENSE_ILLEGAL_REQUEST          0x05U
+#define SCSI_SENSE_DATA_PROTECT             0x07U
+/** @} */
+
+/**
+ * @name    SCSI additional sense codes
+ * @{
+ */
+#define SCSI_ASC_NONE                       0x00U
+#define SCSI_ASC_WRITE_ERROR                0x0CU
+#define SCSI_ASC_READ_ERROR                 0x11U
+#define SCSI_ASC_INVALID_COMMAND            0x20U
+#define SCSI_ASC_LBA_OUT_OF_RANGE           0x21U
+#define SCSI_ASC_INVALID_FIELD_IN_CDB       0x24U
+#define SCSI_ASC_WRITE_PROTECTED            0x27U
+#define SCSI_ASC_MEDIUM_NOT_PRESENT         0x3AU
+/** @} */
+
+/**
+ * @brief   Size of the INQUIRY response.
+ */
+#define MSD_INQUIRY_SIZE                    36U
+
+/**
+ * @brief   Size of the REQUEST SENSE response.
+ */
+#define MSD_SENSE_SIZE                      18U
+
+/**
+ * @brief   Returns the CBW of a driver as a bytes array.
+ */
+#define MSD_CBW(msdp)       ((uint8_t *)(msdp)->cbw)
+
+/**
+ * @brief   Returns the CDB of a driver.
+ */
+#define MSD_CDB(msdp)       (MSD_CBW(msdp) + 15U)
+
+/**
+ * @brief   Host expected data length of the current command.
+ */
+#define MSD_CBW_LENGTH(msdp) msd_get_le32(MSD_CBW(msdp) + 8U)
+
+/**
+ * @brief   Host expected data direction of the current command.
+ */
+#define MSD_CBW_IS_IN(msdp) ((MSD_CBW(msdp)[12] & 0x80U) != 0U)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Get Max LUN response, a single logical unit is exported.
+ */
+static const uint8_t msd_max_lun[1] = {0U};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Reads a little endian 32 bits field.
+ *
+ * @notapi
+ */
+static uint32_t msd_get_le32(const uint8_t *p) {
+
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+         ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief   Reads a big endian 32 bits field.
+ *
+ * @notapi
+ */
+static uint32_t msd_get_be32(const uint8_t *p) {
+
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+         ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/**
+ * @brief   Writes a little endian 32 bits field.
+ *
+ * @notapi
+ */
+static void msd_put_le32(uint8_t *p, uint32_t v) {
+
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+/**
+ * @brief   Writes a big endian 32 bits field.
+ *
+ * @notapi
+ */
+static void msd_put_be32(uint8_t *p, uint32_t v) {
+
+  p[0] = (uint8_t)(v >> 24);
+  p[1] = (uint8_t)(v >> 16);
+  p[2] = (uint8_t)(v >> 8);
+  p[3] = (uint8_t)v;
+}
+
+/**
+ * @brief   Copies a string in a space padded SCSI field.
+ *
+ * @param[out] p        pointer to the field
+ * @param[in] s         the string, it is truncated to the field size
+ * @param[in] n         the field size
+ *
+ * @notapi
+ */
+static void msd_put_string(uint8_t *p, const char *s, size_t n) {
+
+  while ((n > 0U) && (*s != '\0')) {
+    *p++ = (uint8_t)*s++;
+    n--;
+  }
+}
+
+/**
+ * @brief   Fails the current command.
+ *
+ * @param[in] msdp      pointer to a @p USBMassStorageDriver object
+ * @param[in] key       sense key
+ * @param[in] asc       additional sense code
+ *
+ * @notapi
+ */
+static void msd_fail(USBMassStorageDriver *msdp, uint8_t key, uint8_t asc) {
+
+  msdp->sense[0] = key;
+  msdp->sense[1] = asc;
+  msdp->sense[2] = 0U;
+  msdp->status   = MSD_STATUS_FAILED;
+}
+
+/**
+ * @brief   Waits for an endpoint event.
+ *
+ * @param[in] msdp      pointer to a @p USBMassStorageDriver object
+ * @return              The wait result.
+ * @retval MSG_OK       if an endpoint event occurred.
+ * @retval MSG_RESET    if the USB has been reset or unconfigured.
+ *
+ * @sclass
+ */
+static msg_t msd_wait_s(USBMassStorageDriver *msdp) {
+
+  if (msdp->state != MSD_ACTIVE) {
+    return MSG_RESET;
+  }
+  (void) osalThreadSuspendS(&msdp->thread);
+
+  return msdp->state == MSD_ACTIVE ? MSG_OK : MSG_RESET;
+}
+
+/**
+ * @brief   Transmits a buffer on the IN endpoint.
+ *
+ * @param[in] msdp      pointer to a @p USBMassStorageDriver object
+ * @param[in] buf       buffer to be transmitted
+ * @param[in] n         number of bytes to be transmitted
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static msg_t msd_transmit(USBMassStorageDriver *msdp,
+                          const uint8_t *buf, size_t n) {
+  USBDriver *usbp = msdp->config->usbp;
+  msg_t msg = MSG_OK;
+
+  osalSysLock();
+  if (msdp->state == MSD_ACTIVE) {
+    usbStartTransmitI(usbp, msdp->config->bulk_in, buf, n);
+  }
+  while ((msg == MSG_OK) && usbGetTransmitStatusI(usbp, msdp->config->bulk_in)) {
+    msg = msd_wait_s(msdp);
+  }
+  if (msdp->state != MSD_ACTIVE) {
+    msg = MSG_RESET;
+  }
+  osalSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Receives a buffer from the OUT endpoint.
+ *
+ * @param[in] msdp      pointer to a @p USBMassStorageDriver object
+ * @param[out] buf      buffer for the received data
+ * @param[in] n         maximum number of bytes
+ * @param[out] np       number of received bytes
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static msg_t msd_receive(USBMassStorageDriver *msdp,
+                         uint8_t *buf, size_t n, size_t *np) {
+  USBDriver *usbp = msdp->config->usbp;
+  msg_t msg = MSG_OK;
+
+  osalSysLock();
+  if (msdp->state == MSD_ACTIVE) {
+    usbStartReceiveI(usbp, msdp->config->bulk_out, buf, n);
+  }
+  while ((msg == MSG_OK) && usbGetReceiveStatusI(usbp, msdp->config->bulk_out)) {
+    msg = msd_wait_s(msdp);
+  }
+  if (msdp->state != MSD_ACTIVE) {
+    msg = MSG_RESET;
+  }
+  osalSysUnlock();
+
+  *np = usbGetReceiveTransactionSizeX(usbp, msdp->config->bulk_out);
+
+  return msg;
+}
+
+/**
+ * @brief   Stalls an endpoint and waits for the host to clear the halt.
+ *
+ * @param[in] msdp      pointer to a @p USBMassStorageDriver object
+ * @param[in] in        stalls the IN endpoint if @p true, else the OUT one
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static msg_t msd_stall(USBMassStorageDriver *msdp, bool in) {
+  USBDriver *usbp = msdp->config->usbp;
+  usbepstatus_t status;
+
+  osalSysLock();
+  if (in) {
+    (void) usbStallTransmitI(usbp, msdp->config->bulk_in);
+  }
+  else {
+    (void) usbStallReceiveI(usbp, msdp->config->bulk_out);
+  }
+  osalSysUnlock();
+
+  /* There is no notification of the ClearFeature(ENDPOINT_HALT) request,
+     the endpoint status is polled.*/
+  do {
+    if (msdp->state != MSD_ACTIVE) {
+      return MSG_RESET;
+    }
+    osalThreadSleepMilliseconds(USB_MSD_HALT_POLL_INTERVAL);
+    osalSysLock();
+    if (in) {
+      status = usb_lld_get_status_in(usbp, msdp->config->bulk_in);
+    }
+    else {
+      status = usb_lld_get_status_out(usbp, msdp->config->bulk_out);
+    }
+    osalSysUnlock();
+  } while (status == EP_STATUS_STALLED);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Queues the next OUT transaction of a multi-block transfer.
+ * @details A transaction is started if there is a free slot, the endpoint
+ *          is idle and there is still data to be received.
+ *
+ * @param[in] msdp      pointer to a @p USBMassStorageDriver object
+ *
+ * @iclass
+ */
+static void msd_start_receive_i(USBMassStorageDriver *msdp) {
+  USBDriver *usbp = msdp->config->usbp;
+  msd_slot_t *sp;
+  size_t n;
+
+  if ((msdp->pending == 0U) || (msdp->count >= USB_MSD_BUFFERS_NUMBER) ||
+      usbGetReceiveStatusI(usbp, msdp->config->bulk_out)) {
+    return;
+  }
+
+  n = msdp->pending < msdp->slot_size ? msdp->pending : msdp->slot_size;
+  msdp->pending -= n;
+  sp = &msdp->slots[msdp->head];
+  sp->n = n;
+  usbStartReceiveI(usbp, msdp->config->bulk_out, sp->buffer, n);
+}
+
+/**
+ * @brief   Checks the medium and refreshes the device information.
+ *
+ * @param[in] msdp      pointer to a @p USBMassStorageDriver object
+ * @return              The medium status.
+ * @retval true         if the medium is ready.
+ * @retval false        if the medium is not ready, the command is failed.
+ *
+ * @notapi
+ */
+static bool msd_medium_ready(USBMassStorageDriver *msdp) {
+  BaseBlockDevice *bbdp = msdp->config->bbdp;
+
+  if ((blkGetDriverState(bbdp) == BLK_ACTIVE) && blkIsInserted(bbdp)) {
+    (void) blkConnect(bbdp);
+  }
+
+  if ((blkGetDriverState(bbdp) == BLK_READY) &&
+      (blkGetInfo(bbdp, &msdp->bdi) == HAL_SUCCESS) &&
+      (msdp->bdi.blk_size > 0U) &&
+      (msdp->slot_size >= (size_t)msdp->bdi.blk_size)) {
+    return true;
+  }
+
+  msd_fail(msdp, SCSI_SENSE_NOT_READY, SCSI_ASC_MEDIUM_NOT_PRESENT);
+
+  return false;
+}
+
+/**
+ * @brief   Sends the response of a command with a data-in phase.
+ *
+ * @param[in] msdp      pointer to a @p USBMassStorageDriver object
+ * @param[in] buf       response data
+ * @param[in] n         size of the response data
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static msg_t msd_send(USBMassStorageDriver *msdp, const uint8_t *buf,
+                      size_t n) {
+  uint32_t length = MSD_CBW_LENGTH(msdp);
+
+  if (!MSD_CBW_IS_IN(msdp) || (length == 0U)) {
+    msdp->status = MSD_STATUS_PHASE_ERROR;
+    return MSG_OK;
+  }
+
+  if (n > (size_t)length) {
+    n = (size_t)length;
+  }
+  msdp->residue = length - (uint32_t)n;
+
+  return msd_transmit(msdp, buf, n);
+}
+
+/**
+ * @brief   Checks the block range of a READ or WRITE command.
+ *
+ * @param[in] msdp      pointer to a @p USBMassStorageDriver object
+ * @param[in] lba       first block
+ * @param[in] nblocks   number of blocks
+ * @param[in] in        expected data direction
+ * @return              The check result.
+ * @retval true         if the transfer can be performed.
+ * @retval false        if the command is failed.
+ *
+ * @notapi
+ */
+static bool msd_check_transfer(USBMassStorageDriver *msdp, uint32_t lba,
+                               uint32_t nblocks, bool in) {
+  uint32_t length = MSD_CBW_LENGTH(msdp);
+
+  if ((lba > msdp->bdi.blk_num) || (nblocks > (msdp->bdi.blk_num - lba))) {
+    msd_fail(msdp, SCSI_SENSE_ILLEGAL_REQUEST, SCSI_ASC_LBA_OUT_OF_RANGE);
+    return false;
+  }
+
+  /* The host must expect at least the data of the command and in the
+     same direction.*/
+  if (((nblocks > 0U) && (MSD_CBW_IS_IN(msdp) != in)) ||
+      ((uint64_t)length < ((uint64_t)nblocks * msdp->bdi.blk_size))) {
+    msdp->status = MSD_STATUS_PHASE_ERROR;
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * @brief   READ(10) command.
+ * @details Blocks are read in the free slots while the filled slots are
+ *          transmitted by the IN endpoint callback.
+ *
+ * @param[in] msdp      pointer to a @p USBMassStorageDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static msg_t msd_cmd_read(USBMassStorageDriver *msdp) {
+  const uint8_t *cdb = MSD_CDB(msdp);
+  USBDriver *usbp = msdp->config->usbp;
+  uint32_t bs = msdp->bdi.blk_size;
+  uint32_t slot_blocks = (uint32_t)msdp->slot_size / bs;
+  uint32_t lba, remaining;
+  msg_t msg = MSG_OK;
+
+  lba       = msd_get_be32(&cdb[2]);
+  remaining = ((uint32_t)cdb[7] << 8) | (uint32_t)cdb[8];
+  if (!msd_check_transfer(msdp, lba, remaining, true)) {
+    return MSG_OK;
+  }
+
+  msdp->head      = 0U;
+  msdp->tail      = 0U;
+  msdp->count     = 0U;
+  msdp->streaming = true;
+  while (remaining > 0U) {
+    uint32_t n = remaining < slot_blocks ? remaining : slot_blocks;
+    msd_slot_t *sp = &msdp->slots[msdp->head];
+
+    /* Waiting for a free slot.*/
+    osalSysLock();
+    while ((msg == MSG_OK) && (msdp->count >= USB_MSD_BUFFERS_NUMBER)) {
+      msg = msd_wait_s(msdp);
+    }
+    osalSysUnlock();
+    if (msg != MSG_OK) {
+      break;
+    }
+
+    /* The card is read while the previous slots are being transmitted.*/
+    if (blkRead(msdp->config->bbdp, lba, sp->buffer, n) != HAL_SUCCESS) {
+      msd_fail(msdp, SCSI_SENSE_MEDIUM_ERROR, SCSI_ASC_READ_ERROR);
+      break;
+    }
+
+    osalSysLock();
+    sp->n = (size_t)n * (size_t)bs;
+    msdp->head = (msdp->head + 1U) % USB_MSD_BUFFERS_NUMBER;
+    msdp->count++;
+    if ((msdp->count == 1U) && (msdp->state == MSD_ACTIVE)) {
+      /* The endpoint is idle, starting from this slot.*/
+      usbStartTransmitI(usbp, msdp->config->bulk_in,
+                        msdp->slots[msdp->tail].buffer,
+                        msdp->slots[msdp->tail].n);
+    }
+    osalSysUnlock();
+
+    msdp->residue -= n * bs;
+    lba           += n;
+    remaining     -= n;
+  }
+
+  /* Draining the slots still queued on the endpoint.*/
+  osalSysLock();
+  while ((msg == MSG_OK) && (msdp->count > 0U)) {
+    msg = msd_wait_s(msdp);
+  }
+  msdp->streaming = false;
+  osalSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   WRITE(10) command.
+ * @details Blocks are written from the filled slots while the free slots
+ *          are received by the OUT endpoint callback.
+ *
+ * @param[in] msdp      pointer to a @p USBMassStorageDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static msg_t msd_cmd_write(USBMassStorageDriver *msdp) {
+  const uint8_t *cdb = MSD_CDB(msdp);
+  USBDriver *usbp = msdp->config->usbp;
+  uint32_t bs = msdp->bdi.blk_size;
+  uint32_t lba, nblocks;
+  msg_t msg = MSG_OK;
+
+  lba     = msd_get_be32(&cdb[2]);
+  nblocks = ((uint32_t)cdb[7] << 8) | (uint32_t)cdb[8];
+  if (!msd_check_transfer(msdp, lba, nblocks, false)) {
+    return MSG_OK;
+  }
+  if (blkIsWriteProtected(msdp->config->bbdp)) {
+    msd_fail(msdp, SCSI_SENSE_DATA_PROTECT, SCSI_ASC_WRITE_PROTECTED);
+    return MSG_OK;
+  }
+
+  osalSysLock();
+  msdp->head      = 0U;
+  msdp->tail      = 0U;
+  msdp->count     = 0U;
+  msdp->pending   = (size_t)nblocks * (size_t)bs;
+  msdp->short_rx  = false;
+  msdp->streaming = true;
+  if (msdp->state == MSD_ACTIVE) {
+    msd_start_receive_i(msdp);
+  }
+  osalSysUnlock();
+
+  while (nblocks > 0U) {
+    msd_slot_t *sp = &msdp->slots[msdp->tail];
+    uint32_t n;
+
+    /* Waiting for a filled slot.*/
+    osalSysLock();
+    while ((msg == MSG_OK) && (msdp->count == 0U)) {
+      msg = msd_wait_s(msdp);
+    }
+    osalSysUnlock();
+    if (msg != MSG_OK) {
+      break;
+    }
+
+    /* The host terminated the data phase early.*/
+    if (msdp->short_rx && ((sp->n % bs) != 0U)) {
+      msdp->status = MSD_STATUS_PHASE_ERROR;
+      break;
+    }
+
+    /* The card is written while the next slots are being received.*/
+    n = (uint32_t)(sp->n / bs);
+    if (blkWrite(msdp->config->bbdp, lba, sp->buffer, n) != HAL_SUCCESS) {
+      msd_fail(msdp, SCSI_SENSE_MEDIUM_ERROR, SCSI_ASC_WRITE_ERROR);
+      break;
+    }
+
+    osalSysLock();
+    msdp->tail = (msdp->tail + 1U) % USB_MSD_BUFFERS_NUMBER;
+    msdp->count--;
+    if (msdp->state == MSD_ACTIVE) {
+      msd_start_receive_i(msdp);
+    }
+    osalSysUnlock();
+
+    msdp->residue -= n * bs;
+    lba           += n;
+    nblocks       -= n;
+    if (msdp->short_rx && (msdp->count == 0U) && (nblocks > 0U)) {
+      msdp->status = MSD_STATUS_PHASE_ERROR;
+      break;
+    }
+  }
+
+  /* No more transactions, waiting for the one in progress, if any.*/
+  osalSysLock();
+  msdp->pending = 0U;
+  while ((msg == MSG_OK) && usbGetReceiveStatusI(usbp, msdp->config->bulk_out)) {
+    msg = msd_wait_s(msdp);
+  }
+  msdp->streaming = false;
+  osalSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Executes the SCSI command of the current CBW.
+ *
+ * @param[in] msdp      pointer to a @p USBMassStorageDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static msg_t msd_execute(USBMassStorageDriver *msdp) {
+  const USBMassStorageConfig *config = msdp->config;
+  const uint8_t *cdb = MSD_CDB(msdp);
+  uint8_t *buf = msdp->slots[0].buffer;
+
+  switch (cdb[0]) {
+  case SCSI_TEST_UNIT_READY:
+    (void) msd_medium_ready(msdp);
+    return MSG_OK;
+
+  case SCSI_REQUEST_SENSE:
+    memset(buf, 0, MSD_SENSE_SIZE);
+    buf[0]  = 0x70U;
+    buf[2]  = msdp->sense[0];
+    buf[7]  = MSD_SENSE_SIZE - 8U;
+    buf[12] = msdp->sense[1];
+    buf[13] = msdp->sense[2];
+    msdp->sense[0] = SCSI_SENSE_NO_SENSE;
+    msdp->sense[1] = SCSI_ASC_NONE;
+    msdp->sense[2] = 0U;
+    return msd_send(msdp, buf, MSD_SENSE_SIZE);
+
+  case SCSI_INQUIRY:
+    if ((cdb[1] & 0x01U) != 0U) {
+      /* Vital product data pages are not supported.*/
+      msd_fail(msdp, SCSI_SENSE_ILLEGAL_REQUEST, SCSI_ASC_INVALID_FIELD_IN_CDB);
+      return MSG_OK;
+    }
+    memset(buf, ' ', MSD_INQUIRY_SIZE);
+    buf[0] = 0x00U;                     /* Direct access block device.      */
+    buf[1] = 0x80U;                     /* Removable medium.                */
+    buf[2] = 0x04U;                     /* SPC-2.                           */
+    buf[3] = 0x02U;                     /* Response data format.            */
+    buf[4] = MSD_INQUIRY_SIZE - 5U;
+    buf[5] = 0x00U;
+    buf[6] = 0x00U;
+    buf[7] = 0x00U;
+    msd_put_string(&buf[8], config->vendor, 8U);
+    msd_put_string(&buf[16], config->product, 16U);
+    msd_put_string(&buf[32], config->revision, 4U);
+    return msd_send(msdp, buf, MSD_INQUIRY_SIZE);
+
+  case SCSI_MODE_SENSE6:
+    if (!msd_medium_ready(msdp)) {
+      return MSG_OK;
+    }
+    buf[0] = 0x03U;
+    buf[1] = 0x00U;
+    buf[2] = blkIsWriteProtected(config->bbdp) ? 0x80U : 0x00U;
+    buf[3] = 0x00U;
+    return msd_send(msdp, buf, 4U);
+
+  case SCSI_READ_FORMAT_CAPACITIES:
+    if (!msd_medium_ready(msdp)) {
+      return MSG_OK;
+    }
+    memset(buf, 0, 12U);
+    buf[3] = 0x08U;
+    msd_put_be32(&buf[4], msdp->bdi.blk_num);
+    msd_put_be32(&buf[8], msdp->bdi.blk_size);
+    buf[8] = 0x02U;                     /* Formatted medium.                */
+    return msd_send(msdp, buf, 12U);
+
+  case SCSI_READ_CAPACITY10:
+    if (!msd_medium_ready(msdp)) {
+      return MSG_OK;
+    }
+    msd_put_be32(&buf[0], msdp->bdi.blk_num - 1U);
+    msd_put_be32(&buf[4], msdp->bdi.blk_size);
+    return msd_send(msdp, buf, 8U);
+
+  case SCSI_READ10:
+    if (!msd_medium_ready(msdp)) {
+      return MSG_OK;
+    }
+    return msd_cmd_read(msdp);
+
+  case SCSI_WRITE10:
+    if (!msd_medium_ready(msdp)) {
+      return MSG_OK;
+    }
+    return msd_cmd_write(msdp);
+
+  case SCSI_START_STOP_UNIT:
+  case SCSI_PREVENT_ALLOW_REMOVAL:
+  case SCSI_SYNCHRONIZE_CACHE10:
+    /* The host is about to release the medium, committing the pending
+       writes of cached devices.*/
+    if ((blkGetDriverState(config->bbdp) == BLK_READY) &&
+        (blkSync(config->bbdp) != HAL_SUCCESS)) {
+      msd_fail(msdp, SCSI_SENSE_MEDIUM_ERROR, SCSI_ASC_WRITE_ERROR);
+    }
+    return MSG_OK;
+
+  case SCSI_VERIFY10:
+    (void) msd_medium_ready(msdp);
+    return MSG_OK;
+
+  default:
+    msd_fail(msdp, SCSI_SENSE_ILLEGAL_REQUEST, SCSI_ASC_INVALID_COMMAND);
+    return MSG_OK;
+  }
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a USB mass storage driver object.
+ *
+ * @param[out] msdp     pointer to a @p USBMassStorageDriver structure
+ *
+ * @init
+ */
+void msdObjectInit(USBMassStorageDriver *msdp) {
+
+  msdp->state     = MSD_STOP;
+  msdp->config    = NULL;
+  msdp->thread    = NULL;
+  msdp->streaming = false;
+}
+
+/**
+ * @brief   Configures and starts the driver.
+ *
+ * @param[in] msdp      pointer to a @p USBMassStorageDriver object
+ * @param[in] config    the USB mass storage driver configuration
+ *
+ * @api
+ */
+void msdStart(USBMassStorageDriver *msdp,
+              const USBMassStorageConfig *config) {
+  USBDriver *usbp = config->usbp;
+  size_t slot_size;
+  unsigned i;
+
+  osalDbgCheck((msdp != NULL) && (config->bbdp != NULL) &&
+               (config->buffer != NULL));
+
+  /* Slots keep the word alignment of the buffer.*/
+  slot_size = (config->buffer_size / USB_MSD_BUFFERS_NUMBER) & ~(size_t)3U;
+  osalDbgCheck(slot_size > 0U);
+
+  osalSysLock();
+  osalDbgAssert((msdp->state == MSD_STOP) || (msdp->state == MSD_READY),
+                "invalid state");
+  usbp->in_params[config->bulk_in - 1U]   = msdp;
+  usbp->out_params[config->bulk_out - 1U] = msdp;
+  for (i = 0U; i < USB_MSD_BUFFERS_NUMBER; i++) {
+    msdp->slots[i].buffer = config->buffer + (i * slot_size);
+    msdp->slots[i].n      = 0U;
+  }
+  msdp->slot_size = slot_size;
+  msdp->sense[0]  = SCSI_SENSE_NO_SENSE;
+  msdp->sense[1]  = SCSI_ASC_NONE;
+  msdp->sense[2]  = 0U;
+  msdp->config    = config;
+  msdp->state     = MSD_READY;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Stops the driver.
+ * @details The thread serving the driver is awakened, @p msdServe()
+ *          returns @p MSG_RESET.
+ *
+ * @param[in] msdp      pointer to a @p USBMassStorageDriver object
+ *
+ * @api
+ */
+void msdStop(USBMassStorageDriver *msdp) {
+  USBDriver *usbp;
+
+  osalDbgCheck(msdp != NULL);
+
+  osalSysLock();
+  osalDbgAssert((msdp->state == MSD_STOP) || (msdp->state == MSD_READY) ||
+                (msdp->state == MSD_ACTIVE), "invalid state");
+  if (msdp->config != NULL) {
+    usbp = msdp->config->usbp;
+    usbp->in_params[msdp->config->bulk_in - 1U]   = NULL;
+    usbp->out_params[msdp->config->bulk_out - 1U] = NULL;
+  }
+  msdp->state     = MSD_STOP;
+  msdp->streaming = false;
+  osalThreadResumeS(&msdp->thread, MSG_RESET);
+  osalOsRescheduleS();
+  osalSysUnlock();
+}
+
+/**
+ * @brief   USB device configured handler.
+ * @details Must be invoked from the @p USB_EVENT_CONFIGURED event after the
+ *          bulk endpoints have been initialized.
+ *
+ * @param[in] msdp      pointer to a @p USBMassStorageDriver object
+ *
+ * @iclass
+ */
+void msdConfigureHookI(USBMassStorageDriver *msdp) {
+
+  if (msdp->state == MSD_READY) {
+    msdp->state = MSD_ACTIVE;
+    osalThreadResumeI(&msdp->thread, MSG_OK);
+  }
+}
+
+/**
+ * @brief   USB device reset handler.
+ * @details Must be invoked from the @p USB_EVENT_RESET,
+ *          @p USB_EVENT_UNCONFIGURED and @p USB_EVENT_SUSPEND events, the
+ *          command in progress is aborted.
+ *
+ * @param[in] msdp      pointer to a @p USBMassStorageDriver object
+ *
+ * @iclass
+ */
+void msdResetHookI(USBMassStorageDriver *msdp) {
+
+  if (msdp->state == MSD_ACTIVE) {
+    msdp->state     = MSD_READY;
+    msdp->streaming = false;
+    osalThreadResumeI(&msdp->thread, MSG_RESET);
+  }
+}
+
+/**
+ * @brief   Default requests hook.
+ * @details Applications wanting to use the USB mass storage driver can use
+ *          this function at the end of the application specific requests
+ *          hook. The class specific requests are handled here.
+ *
+ * @param[in] msdp      pointer to a @p USBMassStorageDriver object
+ * @return              The hook status.
+ * @retval true         Message handled internally.
+ * @retval false        Message not handled.
+ */
+bool msdRequestsHook(USBMassStorageDriver *msdp) {
+  USBDriver *usbp = msdp->config->usbp;
+
+  if (((usbp->setup[0] & USB_RTYPE_TYPE_MASK) == USB_RTYPE_TYPE_CLASS) &&
+      ((usbp->setup[0] & USB_RTYPE_RECIPIENT_MASK) ==
+       USB_RTYPE_RECIPIENT_INTERFACE)) {
+    switch (usbp->setup[1]) {
+    case MSD_REQ_RESET:
+      /* The host clears the endpoints halt after this request, the
+         waiting thread resumes serving from a new CBW.*/
+      usbSetupTransfer(usbp, NULL, 0, NULL);
+      return true;
+    case MSD_REQ_GET_MAX_LUN:
+      usbSetupTransfer(usbp, (uint8_t *)msd_max_lun, sizeof(msd_max_lun),
+                       NULL);
+      return true;
+    default:
+      return false;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief   Default data transmitted callback.
+ * @details The application must use this function as callback for the IN
+ *          data endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        IN endpoint number
+ */
+void msdDataTransmitted(USBDriver *usbp, usbep_t ep) {
+  USBMassStorageDriver *msdp = usbp->in_params[ep - 1U];
+
+  if (msdp == NULL) {
+    return;
+  }
+
+  osalSysLockFromISR();
+
+  if (msdp->streaming) {
+    /* Slot transmitted, it is released and the next filled slot, if any,
+       is transmitted without waiting for the serving thread.*/
+    msdp->tail = (msdp->tail + 1U) % USB_MSD_BUFFERS_NUMBER;
+    msdp->count--;
+    if (msdp->count > 0U) {
+      usbStartTransmitI(usbp, ep, msdp->slots[msdp->tail].buffer,
+                        msdp->slots[msdp->tail].n);
+    }
+  }
+  osalThreadResumeI(&msdp->thread, MSG_OK);
+
+  osalSysUnlockFromISR();
+}
+
+/**
+ * @brief   Default data received callback.
+ * @details The application must use this function as callback for the OUT
+ *          data endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        OUT endpoint number
+ */
+void msdDataReceived(USBDriver *usbp, usbep_t ep) {
+  USBMassStorageDriver *msdp = usbp->out_params[ep - 1U];
+
+  if (msdp == NULL) {
+    return;
+  }
+
+  osalSysLockFromISR();
+
+  if (msdp->streaming) {
+    msd_slot_t *sp = &msdp->slots[msdp->head];
+    size_t n = usbGetReceiveTransactionSizeX(usbp, ep);
+
+    /* Slot filled, the next free slot, if any, is received without waiting
+       for the serving thread.*/
+    if (n < sp->n) {
+      msdp->short_rx = true;
+      msdp->pending  = 0U;
+    }
+    sp->n = n;
+    msdp->head = (msdp->head + 1U) % USB_MSD_BUFFERS_NUMBER;
+    msdp->count++;
+    msd_start_receive_i(msdp);
+  }
+  osalThreadResumeI(&msdp->thread, MSG_OK);
+
+  osalSysUnlockFromISR();
+}
+
+/**
+ * @brief   Serves a command.
+ * @details Waits for the USB to be configured and for a Command Block
+ *          Wrapper, executes the command and sends the Command Status
+ *          Wrapper. The function must be invoked in a loop by a thread
+ *          dedicated to the driver.
+ *
+ * @param[in] msdp      pointer to a @p USBMassStorageDriver object
+ * @return              The operation status.
+ * @retval MSG_OK       if a command has been served.
+ * @retval MSG_RESET    if the USB has been reset or the driver stopped.
+ *
+ * @api
+ */
+msg_t msdServe(USBMassStorageDriver *msdp) {
+  uint8_t *cbw = MSD_CBW(msdp);
+  uint8_t *csw = (uint8_t *)msdp->csw;
+  size_t n;
+  msg_t msg;
+
+  osalDbgCheck(msdp != NULL);
+
+  /* Waiting for the USB configuration.*/
+  osalSysLock();
+  while (msdp->state == MSD_READY) {
+    (void) osalThreadSuspendS(&msdp->thread);
+  }
+  if (msdp->state != MSD_ACTIVE) {
+    osalSysUnlock();
+    return MSG_RESET;
+  }
+  osalSysUnlock();
+
+  msg = msd_receive(msdp, cbw, MSD_CBW_SIZE, &n);
+  if (msg != MSG_OK) {
+    return msg;
+  }
+
+  /* Invalid CBWs are not answered, both endpoints are stalled until the
+     host performs a reset recovery.*/
+  if ((n != MSD_CBW_SIZE) || (msd_get_le32(cbw) != MSD_CBW_SIGNATURE) ||
+      (cbw[13] != 0U) || (cbw[14] == 0U) || (cbw[14] > 16U)) {
+    msg = msd_stall(msdp, true);
+    if (msg == MSG_OK) {
+      msg = msd_stall(msdp, false);
+    }
+    return msg;
+  }
+
+  msdp->status  = MSD_STATUS_PASSED;
+  msdp->residue = MSD_CBW_LENGTH(msdp);
+  msg = msd_execute(msdp);
+  if (msg != MSG_OK) {
+    return msg;
+  }
+
+  /* Data not transferred, the data phase is terminated by stalling the
+     endpoint in the direction expected by the host.*/
+  if (msdp->residue > 0U) {
+    msg = msd_stall(msdp, MSD_CBW_IS_IN(msdp));
+    if (msg != MSG_OK) {
+      return msg;
+    }
+  }
+
+  msd_put_le32(&csw[0], MSD_CSW_SIGNATURE);
+  memcpy(&csw[4], &cbw[4], 4U);
+  msd_put_le32(&csw[8], msdp->residue);
+  csw[12] = msdp->status;
+
+  return msd_transmit(msdp, csw, MSD_CSW_SIZE);
+}
+
+/** @} */
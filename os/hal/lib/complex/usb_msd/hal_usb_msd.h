@@ -0,0 +1,275 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_usb_msd.h
+ * @brief   USB mass storage class module header.
+ *
+ * @addtogroup HAL_USB_MSD
+ * @{
+ */
+
+#ifndef HAL_USB_MSD_H
+#define HAL_USB_MSD_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Mass storage class requests
+ * @{
+ */
+#define MSD_REQ_RESET                       0xFFU
+#define MSD_REQ_GET_MAX_LUN                 0xFEU
+/** @} */
+
+/**
+ * @name    Bulk-Only Transport wrappers sizes
+ * @{
+ */
+#define MSD_CBW_SIZE                        31U
+#define MSD_CSW_SIZE                        13U
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Number of transfer buffers.
+ * @details The configured buffer is split in this number of slots, during
+ *          multi-block transfers a slot is exchanged with the block device
+ *          while the others are exchanged with the host.
+ */
+#if !defined(USB_MSD_BUFFERS_NUMBER) || defined(__DOXYGEN__)
+#define USB_MSD_BUFFERS_NUMBER              2
+#endif
+
+/**
+ * @brief   Polling interval in milliseconds while waiting for the host to
+ *          clear an endpoint halt condition.
+ */
+#if !defined(USB_MSD_HALT_POLL_INTERVAL) || defined(__DOXYGEN__)
+#define USB_MSD_HALT_POLL_INTERVAL          1
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if HAL_USE_USB == FALSE
+#error "USB Mass Storage requires HAL_USE_USB"
+#endif
+
+#if (USB_MSD_BUFFERS_NUMBER < 2) || (USB_MSD_BUFFERS_NUMBER > 8)
+#error "invalid USB_MSD_BUFFERS_NUMBER value"
+#endif
+
+#if USB_MSD_HALT_POLL_INTERVAL < 1
+#error "invalid USB_MSD_HALT_POLL_INTERVAL value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  MSD_UNINIT = 0,                   /**< Not initialized.                   */
+  MSD_STOP = 1,                     /**< Stopped.                           */
+  MSD_READY = 2,                    /**< Ready, USB not configured.         */
+  MSD_ACTIVE = 3                    /**< Ready, USB configured.             */
+} usbmsdstate_t;
+
+/**
+ * @brief   USB mass storage driver configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   USB driver to use.
+   */
+  USBDriver                 *usbp;
+  /**
+   * @brief   Bulk IN endpoint used for outgoing data transfer.
+   */
+  usbep_t                   bulk_in;
+  /**
+   * @brief   Bulk OUT endpoint used for incoming data transfer.
+   */
+  usbep_t                   bulk_out;
+  /**
+   * @brief   Exported block device.
+   * @note    The device must be connected by the application, the driver
+   *          only attempts a connection when the host polls an inserted
+   *          but not connected medium.
+   */
+  BaseBlockDevice           *bbdp;
+  /**
+   * @brief   Transfer buffer.
+   * @details It is split in @p USB_MSD_BUFFERS_NUMBER slots, each slot
+   *          holds an integral number of blocks.
+   * @note    The buffer must be word aligned, buffers aligned to the cache
+   *          line size are required on devices with data cache and DMA
+   *          based block devices.
+   */
+  uint8_t                   *buffer;
+  /**
+   * @brief   Transfer buffer size in bytes.
+   * @note    It must be enough for at least one block per slot, larger
+   *          slots allow for larger multi-block transfers.
+   */
+  size_t                    buffer_size;
+  /**
+   * @brief   SCSI vendor identification, up to 8 characters.
+   */
+  const char                *vendor;
+  /**
+   * @brief   SCSI product identification, up to 16 characters.
+   */
+  const char                *product;
+  /**
+   * @brief   SCSI product revision level, up to 4 characters.
+   */
+  const char                *revision;
+} USBMassStorageConfig;
+
+/**
+ * @brief   Type of a transfer slot descriptor.
+ */
+typedef struct {
+  /**
+   * @brief   Slot data.
+   */
+  uint8_t                   *buffer;
+  /**
+   * @brief   Size of the data in the slot.
+   */
+  size_t                    n;
+} msd_slot_t;
+
+/**
+ * @brief   Structure representing an USB mass storage driver.
+ */
+typedef struct {
+  /**
+   * @brief   Driver state.
+   */
+  usbmsdstate_t             state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const USBMassStorageConfig *config;
+  /**
+   * @brief   Thread serving the driver.
+   */
+  thread_reference_t        thread;
+  /**
+   * @brief   Command Block Wrapper buffer.
+   */
+  uint32_t                  cbw[(MSD_CBW_SIZE + 4U) / 4U];
+  /**
+   * @brief   Command Status Wrapper buffer.
+   */
+  uint32_t                  csw[(MSD_CSW_SIZE + 3U) / 4U];
+  /**
+   * @brief   Information about the exported block device.
+   */
+  BlockDeviceInfo           bdi;
+  /**
+   * @brief   Sense data of the last failed command.
+   */
+  uint8_t                   sense[3];
+  /**
+   * @brief   Status of the current command.
+   */
+  uint8_t                   status;
+  /**
+   * @brief   Residue of the current command.
+   */
+  uint32_t                  residue;
+  /**
+   * @brief   Transfer slots.
+   */
+  msd_slot_t                slots[USB_MSD_BUFFERS_NUMBER];
+  /**
+   * @brief   Size of a transfer slot in bytes.
+   */
+  size_t                    slot_size;
+  /**
+   * @brief   Index of the next slot to be filled.
+   */
+  unsigned                  head;
+  /**
+   * @brief   Index of the next slot to be emptied.
+   */
+  unsigned                  tail;
+  /**
+   * @brief   Number of filled slots.
+   */
+  unsigned                  count;
+  /**
+   * @brief   Bytes of the current data phase not yet queued on the USB.
+   */
+  size_t                    pending;
+  /**
+   * @brief   A multi-block data phase is in progress.
+   */
+  bool                      streaming;
+  /**
+   * @brief   A short packet terminated the current OUT data phase.
+   */
+  bool                      short_rx;
+} USBMassStorageDriver;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void msdObjectInit(USBMassStorageDriver *msdp);
+  void msdStart(USBMassStorageDriver *msdp,
+                const USBMassStorageConfig *config);
+  void msdStop(USBMassStorageDriver *msdp);
+  void msdConfigureHookI(USBMassStorageDriver *msdp);
+  void msdResetHookI(USBMassStorageDriver *msdp);
+  bool msdRequestsHook(USBMassStorageDriver *msdp);
+  void msdDataTransmitted(USBDriver *usbp, usbep_t ep);
+  void msdDataReceived(USBDriver *usbp, usbep_t ep);
+  msg_t msdServe(USBMassStorageDriver *msdp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USB_MSD_H */
+
+/** @} */
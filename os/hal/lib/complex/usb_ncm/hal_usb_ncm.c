@@ -0,0 +1,964 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_usb_ncm.c
+ * @brief   USB CDC-NCM class module code.
+ * @details This module implements the USB CDC Network Control Model class
+ *          using the 16 bits NTB format.
+ *          Received NTBs are parsed in place, the datagrams are lent to the
+ *          application and the NTB buffer is reused when all its datagrams
+ *          have been released.
+ *          Outgoing datagrams are aggregated in the NTB being filled, it is
+ *          transmitted as soon as the IN endpoint becomes idle, while the
+ *          endpoint is busy more datagrams are accumulated so that the
+ *          number of transfers adapts to the load.
+ *
+ * @addtogroup HAL_USB_NCM
+ * @{
+ */
+
+#include "hal.h"
+#include "hal_usb_ncm.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @name    NTB16 signatures
+ * @{
+ */
+#define NCM_NTH16_SIGNATURE                 0x484D434EU
+#define NCM_NDP16_SIGNATURE                 0x304D434EU
+/** @} */
+
+/**
+ * @brief   Output datagrams payload remainder.
+ * @details The host is asked to place the datagrams so that the IP header
+ *          following the Ethernet header is word aligned.
+ */
+#define NCM_OUT_PAYLOAD_REMAINDER           2U
+
+/**
+ * @brief   Little endian 32 bits descriptor field.
+ */
+#define NCM_DWORD(dw)                                                       \
+  (uint8_t)((dw) & 255U), (uint8_t)(((dw) >> 8) & 255U),                    \
+  (uint8_t)(((dw) >> 16) & 255U), (uint8_t)(((dw) >> 24) & 255U)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   NTB parameters structure.
+ */
+static const uint8_t ncm_ntb_parameters[28] = {
+  USB_DESC_WORD(28U),                   /* wLength.                         */
+  USB_DESC_WORD(0x0001U),               /* bmNtbFormatsSupported, NTB16.    */
+  NCM_DWORD(USB_NCM_NTB_IN_SIZE),       /* dwNtbInMaxSize.                  */
+  USB_DESC_WORD(4U),                    /* wNdpInDivisor.                   */
+  USB_DESC_WORD(0U),                    /* wNdpInPayloadRemainder.          */
+  USB_DESC_WORD(4U),                    /* wNdpInAlignment.                 */
+  USB_DESC_WORD(0U),                    /* wReserved.                       */
+  NCM_DWORD(USB_NCM_NTB_OUT_SIZE),      /* dwNtbOutMaxSize.                 */
+  USB_DESC_WORD(4U),                    /* wNdpOutDivisor.                  */
+  USB_DESC_WORD(NCM_OUT_PAYLOAD_REMAINDER), /* wNdpOutPayloadRemainder.     */
+  USB_DESC_WORD(4U),                    /* wNdpOutAlignment.                */
+  USB_DESC_WORD(0U)                     /* wNtbOutMaxDatagrams, no limit.   */
+};
+
+/**
+ * @brief   NTB format, only NTB16 is supported.
+ */
+static const uint8_t ncm_ntb_format[2] = {USB_DESC_WORD(0U)};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Reads a little endian 16 bits field.
+ *
+ * @notapi
+ */
+static size_t ncm_get16(const uint8_t *p) {
+
+  return (size_t)p[0] | ((size_t)p[1] << 8);
+}
+
+/**
+ * @brief   Reads a little endian 32 bits field.
+ *
+ * @notapi
+ */
+static uint32_t ncm_get32(const uint8_t *p) {
+
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+         ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief   Writes a little endian 16 bits field.
+ *
+ * @notapi
+ */
+static void ncm_put16(uint8_t *p, size_t v) {
+
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+/**
+ * @brief   Writes a little endian 32 bits field.
+ *
+ * @notapi
+ */
+static void ncm_put32(uint8_t *p, uint32_t v) {
+
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+/**
+ * @brief   Starts the reception of an NTB, if possible.
+ *
+ * @param[in] ncmp      pointer to a @p USBNCMDriver object
+ *
+ * @iclass
+ */
+static void ncm_start_receive_i(USBNCMDriver *ncmp) {
+  unsigned i;
+
+  if ((ncmp->state != NCM_ACTIVE) || (ncmp->rx_receiving != NULL) ||
+      usbGetReceiveStatusI(ncmp->config->usbp, ncmp->config->bulk_out)) {
+    return;
+  }
+
+  for (i = 0U; i < USB_NCM_RX_NTBS; i++) {
+    ncm_ntb_t *ntbp = &ncmp->rx_ntbs[i];
+
+    if (ntbp->state == NCM_NTB_FREE) {
+      ntbp->state = NCM_NTB_BUSY;
+      ncmp->rx_receiving = ntbp;
+      usbStartReceiveI(ncmp->config->usbp, ncmp->config->bulk_out,
+                       ntbp->buffer, USB_NCM_NTB_OUT_SIZE);
+      return;
+    }
+  }
+}
+
+/**
+ * @brief   Releases a reference to an incoming NTB.
+ *
+ * @param[in] ncmp      pointer to a @p USBNCMDriver object
+ * @param[in] ntbp      pointer to the NTB descriptor
+ *
+ * @iclass
+ */
+static void ncm_release_ntb_i(USBNCMDriver *ncmp, ncm_ntb_t *ntbp) {
+
+  osalDbgAssert(ntbp->n > 0U, "not referenced");
+
+  ntbp->n--;
+  if (ntbp->n == 0U) {
+    ntbp->state = NCM_NTB_FREE;
+    ncm_start_receive_i(ncmp);
+  }
+}
+
+/**
+ * @brief   Opens an NDP16 of the NTB being parsed.
+ *
+ * @param[in] ncmp      pointer to a @p USBNCMDriver object
+ * @param[in] offset    offset of the NDP16 inside the NTB
+ * @return              The NDP16 validity.
+ *
+ * @notapi
+ */
+static bool ncm_open_ndp(USBNCMDriver *ncmp, size_t offset) {
+  const uint8_t *ntb = ncmp->rx_current->buffer;
+  size_t len;
+
+  if ((offset < NCM_NTH16_SIZE) || ((offset % 4U) != 0U) ||
+      ((offset + 16U) > ncmp->rx_block) ||
+      (ncm_get32(&ntb[offset]) != NCM_NDP16_SIGNATURE)) {
+    return false;
+  }
+
+  len = ncm_get16(&ntb[offset + 4U]);
+  if ((len < 16U) || ((offset + len) > ncmp->rx_block)) {
+    return false;
+  }
+
+  ncmp->rx_ndp   = offset;
+  ncmp->rx_entry = offset + 8U;
+  ncmp->rx_end   = offset + len;
+
+  return true;
+}
+
+/**
+ * @brief   Opens a received NTB for parsing.
+ *
+ * @param[in] ncmp      pointer to a @p USBNCMDriver object
+ * @param[in] ntbp      pointer to the NTB descriptor
+ * @return              The NTB validity.
+ *
+ * @notapi
+ */
+static bool ncm_open_ntb(USBNCMDriver *ncmp, ncm_ntb_t *ntbp) {
+  const uint8_t *ntb = ntbp->buffer;
+
+  if ((ntbp->size < NCM_NTH16_SIZE) ||
+      (ncm_get32(&ntb[0]) != NCM_NTH16_SIGNATURE) ||
+      (ncm_get16(&ntb[4]) != NCM_NTH16_SIZE)) {
+    return false;
+  }
+
+  ncmp->rx_current = ntbp;
+  ncmp->rx_block   = ncm_get16(&ntb[8]);
+  if (ncmp->rx_block > ntbp->size) {
+    return false;
+  }
+
+  return ncm_open_ndp(ncmp, ncm_get16(&ntb[10]));
+}
+
+/**
+ * @brief   Gets the next datagram of the NTB being parsed.
+ * @details Invalid datagram pointers are skipped, chained NDP16s are
+ *          followed in ascending order.
+ *
+ * @param[in] ncmp      pointer to a @p USBNCMDriver object
+ * @param[out] dgp      pointer to the datagram descriptor
+ * @return              The operation status.
+ * @retval true         if a datagram has been found.
+ * @retval false        if the NTB has no more datagrams.
+ *
+ * @notapi
+ */
+static bool ncm_next_datagram(USBNCMDriver *ncmp, ncm_datagram_t *dgp) {
+  ncm_ntb_t *ntbp = ncmp->rx_current;
+  const uint8_t *ntb = ntbp->buffer;
+
+  while (true) {
+    while ((ncmp->rx_entry + 4U) <= ncmp->rx_end) {
+      size_t index = ncm_get16(&ntb[ncmp->rx_entry]);
+      size_t len   = ncm_get16(&ntb[ncmp->rx_entry + 2U]);
+
+      if ((index == 0U) || (len == 0U)) {
+        /* Terminator entry.*/
+        break;
+      }
+      ncmp->rx_entry += 4U;
+
+      if ((index >= NCM_NTH16_SIZE) && ((index + len) <= ncmp->rx_block)) {
+        dgp->buffer = ntbp->buffer + index;
+        dgp->size   = len;
+        dgp->ntb    = ntbp;
+        ntbp->n++;
+        return true;
+      }
+    }
+
+    /* Following the chain, if any.*/
+    {
+      size_t next = ncm_get16(&ntb[ncmp->rx_ndp + 6U]);
+
+      if ((next <= ncmp->rx_ndp) || !ncm_open_ndp(ncmp, next)) {
+        return false;
+      }
+    }
+  }
+}
+
+/**
+ * @brief   Completes the outgoing NTB being filled.
+ *
+ * @param[in] ncmp      pointer to a @p USBNCMDriver object
+ *
+ * @iclass
+ */
+static void ncm_close_ntb_i(USBNCMDriver *ncmp) {
+  usbep_t ep = ncmp->config->bulk_in;
+  ncm_ntb_t *ntbp;
+  uint8_t *ntb;
+  size_t size;
+
+  ntbp = &ncmp->tx_ntbs[(ncmp->tx_first + ncmp->tx_count - 1U) %
+                        USB_NCM_TX_NTBS];
+  ntb  = ntbp->buffer;
+
+  /* A transfer multiple of the packet size would require a zero length
+     packet, a padding byte is added instead.*/
+  size = ntbp->size;
+  if ((size % (size_t)ncmp->config->usbp->epc[ep]->in_maxsize) == 0U) {
+    ntb[size++] = 0U;
+  }
+  ntbp->size = size;
+
+  /* NTH16.*/
+  ncm_put32(&ntb[0], NCM_NTH16_SIGNATURE);
+  ncm_put16(&ntb[4], NCM_NTH16_SIZE);
+  ncm_put16(&ntb[6], ncmp->tx_sequence++);
+  ncm_put16(&ntb[8], size);
+  ncm_put16(&ntb[10], NCM_NTH16_SIZE);
+
+  /* NDP16, the datagram pointers have already been written, the table is
+     terminated by a null entry.*/
+  ncm_put32(&ntb[NCM_NTH16_SIZE], NCM_NDP16_SIGNATURE);
+  ncm_put16(&ntb[NCM_NTH16_SIZE + 4U], NCM_IN_NDP16_SIZE);
+  ncm_put16(&ntb[NCM_NTH16_SIZE + 6U], 0U);
+  ncm_put32(&ntb[NCM_NTH16_SIZE + 8U + (ntbp->n * 4U)], 0U);
+
+  ncmp->tx_filling = false;
+}
+
+/**
+ * @brief   Starts the transmission of the next outgoing NTB, if possible.
+ * @details If the endpoint is idle and no NTB is waiting then the NTB being
+ *          filled is completed and transmitted.
+ *
+ * @param[in] ncmp      pointer to a @p USBNCMDriver object
+ *
+ * @iclass
+ */
+static void ncm_start_transmit_i(USBNCMDriver *ncmp) {
+  USBDriver *usbp = ncmp->config->usbp;
+  ncm_ntb_t *ntbp;
+  unsigned waiting;
+
+  if ((ncmp->state != NCM_ACTIVE) ||
+      usbGetTransmitStatusI(usbp, ncmp->config->bulk_in)) {
+    return;
+  }
+
+  waiting = ncmp->tx_count - (ncmp->tx_filling ? 1U : 0U);
+  if (waiting == 0U) {
+    if (!ncmp->tx_filling || ncmp->tx_reserved ||
+        (ncmp->tx_ntbs[(ncmp->tx_first + ncmp->tx_count - 1U) %
+                       USB_NCM_TX_NTBS].n == 0U)) {
+      return;
+    }
+    ncm_close_ntb_i(ncmp);
+  }
+
+  ntbp = &ncmp->tx_ntbs[ncmp->tx_first];
+  ntbp->state = NCM_NTB_BUSY;
+  usbStartTransmitI(usbp, ncmp->config->bulk_in, ntbp->buffer, ntbp->size);
+}
+
+/**
+ * @brief   Resets the data paths.
+ * @details Queued NTBs are discarded, lent incoming NTBs are kept until
+ *          their datagrams are released.
+ *
+ * @param[in] ncmp      pointer to a @p USBNCMDriver object
+ *
+ * @iclass
+ */
+static void ncm_reset_i(USBNCMDriver *ncmp) {
+  unsigned i;
+
+  for (i = 0U; i < USB_NCM_RX_NTBS; i++) {
+    if (ncmp->rx_ntbs[i].state != NCM_NTB_LENT) {
+      ncmp->rx_ntbs[i].state = NCM_NTB_FREE;
+    }
+  }
+  ncmp->rx_first     = 0U;
+  ncmp->rx_count     = 0U;
+  ncmp->rx_receiving = NULL;
+  if (ncmp->rx_current != NULL) {
+    ncm_ntb_t *ntbp = ncmp->rx_current;
+
+    ncmp->rx_current = NULL;
+    ncm_release_ntb_i(ncmp, ntbp);
+  }
+
+  for (i = 0U; i < USB_NCM_TX_NTBS; i++) {
+    ncmp->tx_ntbs[i].state = NCM_NTB_FREE;
+  }
+  ncmp->tx_first    = 0U;
+  ncmp->tx_count    = 0U;
+  ncmp->tx_filling  = false;
+  ncmp->tx_reserved = false;
+  ncmp->tx_sequence = 0U;
+  ncmp->notify      = 0U;
+}
+
+/**
+ * @brief   Enables or disables the data interface.
+ *
+ * @param[in] ncmp      pointer to a @p USBNCMDriver object
+ * @param[in] alt       the data interface alternate setting
+ *
+ * @iclass
+ */
+static void ncm_set_interface_i(USBNCMDriver *ncmp, uint8_t alt) {
+  const USBNCMConfig *config = ncmp->config;
+  uint8_t *np = (uint8_t *)ncmp->notification;
+
+  ncmp->alt   = alt;
+  ncmp->state = NCM_READY;
+  ncm_reset_i(ncmp);
+  if (alt != 0U) {
+    ncmp->state = NCM_ACTIVE;
+    ncm_start_receive_i(ncmp);
+
+    /* The host is notified of the link speed, the connection notification
+       follows when this one has been transmitted.*/
+    if ((config->int_in > 0U) &&
+        !usbGetTransmitStatusI(config->usbp, config->int_in)) {
+      np[0] = 0xA1U;
+      np[1] = NCM_NOTIFY_SPEED_CHANGE;
+      ncm_put16(&np[2], 0U);
+      ncm_put16(&np[4], config->comm_interface);
+      ncm_put16(&np[6], 8U);
+      ncm_put32(&np[8], config->speed);
+      ncm_put32(&np[12], config->speed);
+      ncmp->notify = 1U;
+      usbStartTransmitI(config->usbp, config->int_in, np, 16U);
+    }
+  }
+
+  osalThreadResumeI(&ncmp->rx_thread, MSG_RESET);
+  osalThreadResumeI(&ncmp->tx_thread, MSG_RESET);
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a USB CDC-NCM driver object.
+ *
+ * @param[out] ncmp     pointer to a @p USBNCMDriver structure
+ *
+ * @init
+ */
+void ncmObjectInit(USBNCMDriver *ncmp) {
+  unsigned i;
+
+  ncmp->state     = NCM_STOP;
+  ncmp->config    = NULL;
+  ncmp->alt       = 0U;
+  ncmp->rx_thread = NULL;
+  ncmp->tx_thread = NULL;
+  ncmp->rx_current = NULL;
+  ncm_put32((uint8_t *)ncmp->input_size, USB_NCM_NTB_IN_SIZE);
+  for (i = 0U; i < USB_NCM_RX_NTBS; i++) {
+    ncmp->rx_ntbs[i].buffer = (uint8_t *)ncmp->rx_buffers[i];
+    ncmp->rx_ntbs[i].state  = NCM_NTB_FREE;
+    ncmp->rx_ntbs[i].n      = 0U;
+  }
+  for (i = 0U; i < USB_NCM_TX_NTBS; i++) {
+    ncmp->tx_ntbs[i].buffer = (uint8_t *)ncmp->tx_buffers[i];
+  }
+  ncm_reset_i(ncmp);
+}
+
+/**
+ * @brief   Configures and starts the driver.
+ *
+ * @param[in] ncmp      pointer to a @p USBNCMDriver object
+ * @param[in] config    the USB CDC-NCM driver configuration
+ *
+ * @api
+ */
+void ncmStart(USBNCMDriver *ncmp, const USBNCMConfig *config) {
+  USBDriver *usbp = config->usbp;
+
+  osalDbgCheck(ncmp != NULL);
+
+  osalSysLock();
+  osalDbgAssert((ncmp->state == NCM_STOP) || (ncmp->state == NCM_READY),
+                "invalid state");
+  usbp->in_params[config->bulk_in - 1U]   = ncmp;
+  usbp->out_params[config->bulk_out - 1U] = ncmp;
+  if (config->int_in > 0U) {
+    usbp->in_params[config->int_in - 1U]  = ncmp;
+  }
+  ncmp->config = config;
+  ncmp->alt    = 0U;
+  ncmp->state  = NCM_READY;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Stops the driver.
+ * @details Threads waiting on the driver are awakened with the message
+ *          @p MSG_RESET.
+ *
+ * @param[in] ncmp      pointer to a @p USBNCMDriver object
+ *
+ * @api
+ */
+void ncmStop(USBNCMDriver *ncmp) {
+  USBDriver *usbp = ncmp->config->usbp;
+
+  osalDbgCheck(ncmp != NULL);
+
+  osalSysLock();
+  osalDbgAssert((ncmp->state == NCM_READY) || (ncmp->state == NCM_ACTIVE),
+                "invalid state");
+  ncm_set_interface_i(ncmp, 0U);
+  usbp->in_params[ncmp->config->bulk_in - 1U]   = NULL;
+  usbp->out_params[ncmp->config->bulk_out - 1U] = NULL;
+  if (ncmp->config->int_in > 0U) {
+    usbp->in_params[ncmp->config->int_in - 1U]  = NULL;
+  }
+  ncmp->config = NULL;
+  ncmp->state  = NCM_STOP;
+  osalOsRescheduleS();
+  osalSysUnlock();
+}
+
+/**
+ * @brief   USB device configured handler.
+ * @details Must be invoked from the @p USB_EVENT_CONFIGURED event after the
+ *          endpoints have been initialized, the data interface is in its
+ *          alternate setting 0 until enabled by the host.
+ *
+ * @param[in] ncmp      pointer to a @p USBNCMDriver object
+ *
+ * @iclass
+ */
+void ncmConfigureHookI(USBNCMDriver *ncmp) {
+
+  if (ncmp->state != NCM_STOP) {
+    ncm_put32((uint8_t *)ncmp->input_size, USB_NCM_NTB_IN_SIZE);
+    ncm_set_interface_i(ncmp, 0U);
+  }
+}
+
+/**
+ * @brief   USB device reset handler.
+ * @details Must be invoked from the @p USB_EVENT_RESET,
+ *          @p USB_EVENT_UNCONFIGURED and @p USB_EVENT_SUSPEND events.
+ *
+ * @param[in] ncmp      pointer to a @p USBNCMDriver object
+ *
+ * @iclass
+ */
+void ncmResetHookI(USBNCMDriver *ncmp) {
+
+  if (ncmp->state == NCM_ACTIVE) {
+    ncm_set_interface_i(ncmp, 0U);
+  }
+}
+
+/**
+ * @brief   Default requests hook.
+ * @details Applications wanting to use the USB CDC-NCM driver can use this
+ *          function at the end of the application specific requests hook.
+ *          The class requests and the alternate setting of the data
+ *          interface are handled here.
+ *
+ * @param[in] ncmp      pointer to a @p USBNCMDriver object
+ * @return              The hook status.
+ * @retval true         Message handled internally.
+ * @retval false        Message not handled.
+ */
+bool ncmRequestsHook(USBNCMDriver *ncmp) {
+  USBDriver *usbp = ncmp->config->usbp;
+  uint8_t rtype = usbp->setup[0];
+
+  if ((rtype & USB_RTYPE_RECIPIENT_MASK) != USB_RTYPE_RECIPIENT_INTERFACE) {
+    return false;
+  }
+
+  /* Alternate settings of the data interface.*/
+  if (((rtype & USB_RTYPE_TYPE_MASK) == USB_RTYPE_TYPE_STD) &&
+      (usbp->setup[4] == ncmp->config->data_interface)) {
+    switch (usbp->setup[1]) {
+    case USB_REQ_SET_INTERFACE:
+      if (usbp->setup[2] > 1U) {
+        return false;
+      }
+      osalSysLockFromISR();
+      ncm_set_interface_i(ncmp, usbp->setup[2]);
+      osalSysUnlockFromISR();
+      usbSetupTransfer(usbp, NULL, 0, NULL);
+      return true;
+    case USB_REQ_GET_INTERFACE:
+      usbSetupTransfer(usbp, &ncmp->alt, 1, NULL);
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  if (((rtype & USB_RTYPE_TYPE_MASK) == USB_RTYPE_TYPE_CLASS) &&
+      (usbp->setup[4] == ncmp->config->comm_interface)) {
+    switch (usbp->setup[1]) {
+    case NCM_SET_ETHERNET_PACKET_FILTER:
+      /* All the frames are forwarded, filtering is left to the stack.*/
+      usbSetupTransfer(usbp, NULL, 0, NULL);
+      return true;
+    case NCM_GET_NTB_PARAMETERS:
+      usbSetupTransfer(usbp, (uint8_t *)ncm_ntb_parameters,
+                       sizeof(ncm_ntb_parameters), NULL);
+      return true;
+    case NCM_GET_NTB_FORMAT:
+      usbSetupTransfer(usbp, (uint8_t *)ncm_ntb_format,
+                       sizeof(ncm_ntb_format), NULL);
+      return true;
+    case NCM_SET_NTB_FORMAT:
+      if ((usbp->setup[2] != 0U) || (usbp->setup[3] != 0U)) {
+        return false;
+      }
+      usbSetupTransfer(usbp, NULL, 0, NULL);
+      return true;
+    case NCM_GET_NTB_INPUT_SIZE:
+      usbSetupTransfer(usbp, (uint8_t *)ncmp->input_size, 4U, NULL);
+      return true;
+    case NCM_SET_NTB_INPUT_SIZE:
+      /* The value is applied to the following NTBs, the optional maximum
+         datagrams field is ignored.*/
+      if ((ncm_get16(&usbp->setup[6]) != 4U) &&
+          (ncm_get16(&usbp->setup[6]) != 8U)) {
+        return false;
+      }
+      usbSetupTransfer(usbp, (uint8_t *)ncmp->input_size,
+                       ncm_get16(&usbp->setup[6]), NULL);
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @brief   Default data transmitted callback.
+ * @details The application must use this function as callback for the IN
+ *          data endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        IN endpoint number
+ */
+void ncmDataTransmitted(USBDriver *usbp, usbep_t ep) {
+  USBNCMDriver *ncmp = usbp->in_params[ep - 1U];
+
+  if (ncmp == NULL) {
+    return;
+  }
+
+  osalSysLockFromISR();
+
+  /* Completions of transfers started before a reset are ignored.*/
+  if ((ncmp->tx_count > 0U) &&
+      (ncmp->tx_ntbs[ncmp->tx_first].state == NCM_NTB_BUSY)) {
+    ncmp->tx_ntbs[ncmp->tx_first].state = NCM_NTB_FREE;
+    ncmp->tx_first = (ncmp->tx_first + 1U) % USB_NCM_TX_NTBS;
+    ncmp->tx_count--;
+    osalThreadResumeI(&ncmp->tx_thread, MSG_OK);
+  }
+
+  /* The next NTB is started, the datagrams accumulated meanwhile are sent
+     in a single transfer.*/
+  ncm_start_transmit_i(ncmp);
+
+  osalSysUnlockFromISR();
+}
+
+/**
+ * @brief   Default data received callback.
+ * @details The application must use this function as callback for the OUT
+ *          data endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        OUT endpoint number
+ */
+void ncmDataReceived(USBDriver *usbp, usbep_t ep) {
+  USBNCMDriver *ncmp = usbp->out_params[ep - 1U];
+  ncm_ntb_t *ntbp;
+
+  if (ncmp == NULL) {
+    return;
+  }
+
+  osalSysLockFromISR();
+
+  /* Completions of transfers started before a reset are ignored.*/
+  ntbp = ncmp->rx_receiving;
+  if (ntbp != NULL) {
+    ncmp->rx_receiving = NULL;
+    ntbp->size  = usbGetReceiveTransactionSizeX(usbp, ep);
+    ntbp->state = NCM_NTB_FULL;
+    ncmp->rx_fifo[(ncmp->rx_first + ncmp->rx_count) % USB_NCM_RX_NTBS] = ntbp;
+    ncmp->rx_count++;
+    osalThreadResumeI(&ncmp->rx_thread, MSG_OK);
+  }
+
+  /* The next NTB is received while this one is parsed.*/
+  ncm_start_receive_i(ncmp);
+
+  osalSysUnlockFromISR();
+}
+
+/**
+ * @brief   Default interrupt transmitted callback.
+ * @details The application must use this function as callback for the IN
+ *          interrupt endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ */
+void ncmInterruptTransmitted(USBDriver *usbp, usbep_t ep) {
+  USBNCMDriver *ncmp = usbp->in_params[ep - 1U];
+  uint8_t *np;
+
+  if (ncmp == NULL) {
+    return;
+  }
+
+  osalSysLockFromISR();
+
+  if ((ncmp->state == NCM_ACTIVE) && (ncmp->notify == 1U)) {
+    np = (uint8_t *)ncmp->notification;
+    np[0] = 0xA1U;
+    np[1] = NCM_NOTIFY_NETWORK_CONNECTION;
+    ncm_put16(&np[2], 1U);
+    ncm_put16(&np[4], ncmp->config->comm_interface);
+    ncm_put16(&np[6], 0U);
+    ncmp->notify = 2U;
+    usbStartTransmitI(usbp, ep, np, 8U);
+  }
+
+  osalSysUnlockFromISR();
+}
+
+/**
+ * @brief   Receives a datagram.
+ * @details The datagram is not copied, it is lent to the application
+ *          until released using @p ncmReleaseDatagram().
+ *
+ * @param[in] ncmp      pointer to a @p USBNCMDriver object
+ * @param[out] dgp      pointer to the datagram descriptor
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a datagram has been received.
+ * @retval MSG_TIMEOUT  if a timeout occurred.
+ * @retval MSG_RESET    if the data interface is not enabled.
+ *
+ * @api
+ */
+msg_t ncmReceiveDatagramTimeout(USBNCMDriver *ncmp, ncm_datagram_t *dgp,
+                                sysinterval_t timeout) {
+  msg_t msg;
+
+  osalDbgCheck((ncmp != NULL) && (dgp != NULL));
+
+  osalSysLock();
+
+  while (true) {
+    if (ncmp->state != NCM_ACTIVE) {
+      osalSysUnlock();
+      return MSG_RESET;
+    }
+
+    if (ncmp->rx_current != NULL) {
+      ncm_ntb_t *ntbp = ncmp->rx_current;
+
+      if (ncm_next_datagram(ncmp, dgp)) {
+        osalSysUnlock();
+        return MSG_OK;
+      }
+
+      /* NTB parsed, the parser reference is released.*/
+      ncmp->rx_current = NULL;
+      ncm_release_ntb_i(ncmp, ntbp);
+    }
+
+    if (ncmp->rx_count > 0U) {
+      ncm_ntb_t *ntbp = ncmp->rx_fifo[ncmp->rx_first];
+
+      ncmp->rx_first = (ncmp->rx_first + 1U) % USB_NCM_RX_NTBS;
+      ncmp->rx_count--;
+
+      /* The parser holds a reference while the NTB is open.*/
+      ntbp->state = NCM_NTB_LENT;
+      ntbp->n     = 1U;
+      if (!ncm_open_ntb(ncmp, ntbp)) {
+        ncmp->rx_current = NULL;
+        ncm_release_ntb_i(ncmp, ntbp);
+      }
+      continue;
+    }
+
+    msg = osalThreadSuspendTimeoutS(&ncmp->rx_thread, timeout);
+    if (msg == MSG_TIMEOUT) {
+      osalSysUnlock();
+      return MSG_TIMEOUT;
+    }
+  }
+}
+
+/**
+ * @brief   Releases a received datagram.
+ *
+ * @param[in] ncmp      pointer to a @p USBNCMDriver object
+ * @param[in] dgp       pointer to the datagram descriptor
+ *
+ * @api
+ */
+void ncmReleaseDatagram(USBNCMDriver *ncmp, const ncm_datagram_t *dgp) {
+
+  osalDbgCheck((ncmp != NULL) && (dgp != NULL));
+
+  osalSysLock();
+  ncm_release_ntb_i(ncmp, dgp->ntb);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Gets a transmit buffer.
+ * @details A buffer for a datagram is reserved in the NTB being filled, the
+ *          datagram must be written in the buffer and then posted using
+ *          @p ncmPostTransmitBuffer().
+ *
+ * @param[in] ncmp      pointer to a @p USBNCMDriver object
+ * @param[in] size      maximum size of the datagram
+ * @param[out] bufp     pointer to the reserved buffer
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a buffer has been reserved.
+ * @retval MSG_TIMEOUT  if a timeout occurred.
+ * @retval MSG_RESET    if the data interface is not enabled.
+ *
+ * @api
+ */
+msg_t ncmGetTransmitBufferTimeout(USBNCMDriver *ncmp, size_t size,
+                                  uint8_t **bufp, sysinterval_t timeout) {
+  ncm_ntb_t *ntbp;
+  size_t offset;
+  msg_t msg;
+
+  osalDbgCheck((ncmp != NULL) && (bufp != NULL) &&
+               (size > 0U) && (size <= NCM_MAX_FRAME_SIZE));
+
+  osalSysLock();
+
+  osalDbgAssert(!ncmp->tx_reserved, "already reserved");
+
+  while (true) {
+    if (ncmp->state != NCM_ACTIVE) {
+      osalSysUnlock();
+      return MSG_RESET;
+    }
+
+    if (ncmp->tx_filling) {
+      ntbp = &ncmp->tx_ntbs[(ncmp->tx_first + ncmp->tx_count - 1U) %
+                            USB_NCM_TX_NTBS];
+      offset = (ntbp->size + 3U) & ~(size_t)3U;
+
+      /* One byte is kept for the padding.*/
+      if ((ntbp->n < USB_NCM_IN_MAX_DATAGRAMS) &&
+          ((offset + size) < ncmp->tx_max)) {
+        ntbp->size = offset;
+        ncmp->tx_reserved = true;
+        *bufp = ntbp->buffer + offset;
+        osalSysUnlock();
+        return MSG_OK;
+      }
+
+      /* No space left, the NTB is queued for transmission.*/
+      ncm_close_ntb_i(ncmp);
+      ncm_start_transmit_i(ncmp);
+    }
+
+    if (ncmp->tx_count < USB_NCM_TX_NTBS) {
+      /* Starting a new NTB, its maximum size is the one last requested
+         by the host.*/
+      ncmp->tx_max = (size_t)ncm_get32((const uint8_t *)ncmp->input_size);
+      if ((ncmp->tx_max < 2048U) || (ncmp->tx_max > USB_NCM_NTB_IN_SIZE)) {
+        ncmp->tx_max = USB_NCM_NTB_IN_SIZE;
+      }
+      ntbp = &ncmp->tx_ntbs[(ncmp->tx_first + ncmp->tx_count) %
+                            USB_NCM_TX_NTBS];
+      ntbp->state = NCM_NTB_FULL;
+      ntbp->size  = NCM_IN_DATAGRAMS_OFFSET;
+      ntbp->n     = 0U;
+      ncmp->tx_count++;
+      ncmp->tx_filling = true;
+      continue;
+    }
+
+    msg = osalThreadSuspendTimeoutS(&ncmp->tx_thread, timeout);
+    if (msg == MSG_TIMEOUT) {
+      osalSysUnlock();
+      return MSG_TIMEOUT;
+    }
+  }
+}
+
+/**
+ * @brief   Posts a datagram written in a transmit buffer.
+ * @details The NTB is transmitted immediately if the IN endpoint is idle,
+ *          else the datagram is aggregated with the following ones.
+ *
+ * @param[in] ncmp      pointer to a @p USBNCMDriver object
+ * @param[in] size      size of the datagram, it cannot be larger than the
+ *                      size requested to @p ncmGetTransmitBufferTimeout()
+ *
+ * @api
+ */
+void ncmPostTransmitBuffer(USBNCMDriver *ncmp, size_t size) {
+  ncm_ntb_t *ntbp;
+  uint8_t *entry;
+
+  osalDbgCheck(ncmp != NULL);
+
+  osalSysLock();
+
+  /* The reservation is lost if the interface has been reset meanwhile.*/
+  if (ncmp->tx_reserved) {
+    ntbp = &ncmp->tx_ntbs[(ncmp->tx_first + ncmp->tx_count - 1U) %
+                          USB_NCM_TX_NTBS];
+    entry = &ntbp->buffer[NCM_NTH16_SIZE + 8U + (ntbp->n * 4U)];
+    ncm_put16(&entry[0], ntbp->size);
+    ncm_put16(&entry[2], size);
+    ntbp->size += size;
+    ntbp->n++;
+    ncmp->tx_reserved = false;
+    ncm_start_transmit_i(ncmp);
+  }
+
+  osalSysUnlock();
+}
+
+/** @} */
@@ -0,0 +1,414 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_usb_ncm.h
+ * @brief   USB CDC-NCM class module header.
+ *
+ * @addtogroup HAL_USB_NCM
+ * @{
+ */
+
+#ifndef HAL_USB_NCM_H
+#define HAL_USB_NCM_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    CDC-NCM class requests
+ * @{
+ */
+#define NCM_SET_ETHERNET_PACKET_FILTER      0x43U
+#define NCM_GET_NTB_PARAMETERS              0x80U
+#define NCM_GET_NTB_FORMAT                  0x83U
+#define NCM_SET_NTB_FORMAT                  0x84U
+#define NCM_GET_NTB_INPUT_SIZE              0x85U
+#define NCM_SET_NTB_INPUT_SIZE              0x86U
+/** @} */
+
+/**
+ * @name    CDC notifications
+ * @{
+ */
+#define NCM_NOTIFY_NETWORK_CONNECTION       0x00U
+#define NCM_NOTIFY_SPEED_CHANGE             0x2AU
+/** @} */
+
+/**
+ * @brief   Size of the NTB16 header.
+ */
+#define NCM_NTH16_SIZE                      12U
+
+/**
+ * @brief   Maximum size of an Ethernet frame without FCS.
+ */
+#define NCM_MAX_FRAME_SIZE                  1514U
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Maximum size of the NTBs received from the host.
+ * @note    Larger NTBs allow the host to aggregate more datagrams per
+ *          transfer, 16384 is a good value for high speed devices.
+ */
+#if !defined(USB_NCM_NTB_OUT_SIZE) || defined(__DOXYGEN__)
+#define USB_NCM_NTB_OUT_SIZE                2048
+#endif
+
+/**
+ * @brief   Maximum size of the NTBs transmitted to the host.
+ */
+#if !defined(USB_NCM_NTB_IN_SIZE) || defined(__DOXYGEN__)
+#define USB_NCM_NTB_IN_SIZE                 2048
+#endif
+
+/**
+ * @brief   Number of NTB buffers used for reception.
+ * @details Received datagrams are lent to the application, an NTB buffer
+ *          is reused for reception when all its datagrams have been
+ *          released.
+ */
+#if !defined(USB_NCM_RX_NTBS) || defined(__DOXYGEN__)
+#define USB_NCM_RX_NTBS                     2
+#endif
+
+/**
+ * @brief   Number of NTB buffers used for transmission.
+ * @details Datagrams are aggregated in an NTB while the previous one is
+ *          being transmitted.
+ */
+#if !defined(USB_NCM_TX_NTBS) || defined(__DOXYGEN__)
+#define USB_NCM_TX_NTBS                     2
+#endif
+
+/**
+ * @brief   Maximum number of datagrams aggregated in a transmitted NTB.
+ */
+#if !defined(USB_NCM_IN_MAX_DATAGRAMS) || defined(__DOXYGEN__)
+#define USB_NCM_IN_MAX_DATAGRAMS            8
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if HAL_USE_USB == FALSE
+#error "USB CDC-NCM requires HAL_USE_USB"
+#endif
+
+#if (USB_NCM_NTB_OUT_SIZE < 2048) || ((USB_NCM_NTB_OUT_SIZE % 64) != 0) ||  \
+    (USB_NCM_NTB_OUT_SIZE > 65535)
+#error "invalid USB_NCM_NTB_OUT_SIZE value"
+#endif
+
+#if (USB_NCM_NTB_IN_SIZE < 2048) || ((USB_NCM_NTB_IN_SIZE % 4) != 0) ||    \
+    (USB_NCM_NTB_IN_SIZE > 65535)
+#error "invalid USB_NCM_NTB_IN_SIZE value"
+#endif
+
+#if (USB_NCM_RX_NTBS < 1) || (USB_NCM_TX_NTBS < 1)
+#error "invalid USB_NCM_RX_NTBS or USB_NCM_TX_NTBS value"
+#endif
+
+#if (USB_NCM_IN_MAX_DATAGRAMS < 1) || (USB_NCM_IN_MAX_DATAGRAMS > 32)
+#error "invalid USB_NCM_IN_MAX_DATAGRAMS value"
+#endif
+
+/**
+ * @brief   Size of the NDP16 of the transmitted NTBs.
+ */
+#define NCM_IN_NDP16_SIZE       (8U + (4U * (USB_NCM_IN_MAX_DATAGRAMS + 1U)))
+
+/**
+ * @brief   Offset of the first datagram of the transmitted NTBs.
+ */
+#define NCM_IN_DATAGRAMS_OFFSET (NCM_NTH16_SIZE + NCM_IN_NDP16_SIZE)
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  NCM_UNINIT = 0,                   /**< Not initialized.                   */
+  NCM_STOP = 1,                     /**< Stopped.                           */
+  NCM_READY = 2,                    /**< Ready, data interface disabled.    */
+  NCM_ACTIVE = 3                    /**< Ready, data interface enabled.     */
+} usbncmstate_t;
+
+/**
+ * @brief   NTB buffer possible states.
+ */
+typedef enum {
+  NCM_NTB_FREE = 0,                 /**< Available.                         */
+  NCM_NTB_BUSY = 1,                 /**< Owned by the USB endpoint.         */
+  NCM_NTB_FULL = 2,                 /**< Received, waiting to be parsed.    */
+  NCM_NTB_LENT = 3                  /**< Datagrams lent to the application. */
+} ncmntbstate_t;
+
+/**
+ * @brief   Type of an NTB buffer descriptor.
+ */
+typedef struct {
+  /**
+   * @brief   NTB data.
+   */
+  uint8_t                   *buffer;
+  /**
+   * @brief   Buffer state.
+   */
+  ncmntbstate_t             state;
+  /**
+   * @brief   Size of the NTB.
+   * @details Received size for incoming NTBs, filled size for outgoing
+   *          NTBs.
+   */
+  size_t                    size;
+  /**
+   * @brief   Datagrams counter.
+   * @details Number of references for incoming NTBs, number of aggregated
+   *          datagrams for outgoing NTBs.
+   */
+  unsigned                  n;
+} ncm_ntb_t;
+
+/**
+ * @brief   Type of a received datagram descriptor.
+ */
+typedef struct {
+  /**
+   * @brief   Datagram data, it is an Ethernet frame without FCS.
+   */
+  uint8_t                   *buffer;
+  /**
+   * @brief   Datagram size.
+   */
+  size_t                    size;
+  /**
+   * @brief   NTB containing the datagram.
+   */
+  ncm_ntb_t                 *ntb;
+} ncm_datagram_t;
+
+/**
+ * @brief   USB CDC-NCM driver configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   USB driver to use.
+   */
+  USBDriver                 *usbp;
+  /**
+   * @brief   Bulk IN endpoint used for outgoing NTBs.
+   */
+  usbep_t                   bulk_in;
+  /**
+   * @brief   Bulk OUT endpoint used for incoming NTBs.
+   */
+  usbep_t                   bulk_out;
+  /**
+   * @brief   Interrupt IN endpoint used for notifications.
+   */
+  usbep_t                   int_in;
+  /**
+   * @brief   Communication interface number.
+   */
+  uint8_t                   comm_interface;
+  /**
+   * @brief   Data interface number.
+   * @details The alternate setting 1 of this interface enables the data
+   *          endpoints.
+   */
+  uint8_t                   data_interface;
+  /**
+   * @brief   Link speed notified to the host in bits per second.
+   */
+  uint32_t                  speed;
+} USBNCMConfig;
+
+/**
+ * @brief   Structure representing an USB CDC-NCM driver.
+ */
+typedef struct {
+  /**
+   * @brief   Driver state.
+   */
+  usbncmstate_t             state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const USBNCMConfig        *config;
+  /**
+   * @brief   Data interface alternate setting.
+   */
+  uint8_t                   alt;
+  /**
+   * @brief   Notifications state.
+   */
+  uint8_t                   notify;
+  /**
+   * @brief   Notifications buffer.
+   */
+  uint32_t                  notification[4];
+  /**
+   * @brief   NTB input size requested by the host.
+   * @details It is the data of the NTB input size class requests.
+   */
+  uint32_t                  input_size[2];
+  /**
+   * @brief   Thread waiting for a received datagram.
+   */
+  thread_reference_t        rx_thread;
+  /**
+   * @brief   Incoming NTBs data.
+   */
+  uint32_t                  rx_buffers[USB_NCM_RX_NTBS]
+                                      [USB_NCM_NTB_OUT_SIZE / 4];
+  /**
+   * @brief   Incoming NTBs descriptors.
+   */
+  ncm_ntb_t                 rx_ntbs[USB_NCM_RX_NTBS];
+  /**
+   * @brief   Received NTBs waiting to be parsed, in order of reception.
+   */
+  ncm_ntb_t                 *rx_fifo[USB_NCM_RX_NTBS];
+  /**
+   * @brief   Index of the first NTB in the received NTBs FIFO.
+   */
+  unsigned                  rx_first;
+  /**
+   * @brief   Number of NTBs in the received NTBs FIFO.
+   */
+  unsigned                  rx_count;
+  /**
+   * @brief   NTB being received or @p NULL.
+   */
+  ncm_ntb_t                 *rx_receiving;
+  /**
+   * @brief   NTB being parsed or @p NULL.
+   */
+  ncm_ntb_t                 *rx_current;
+  /**
+   * @brief   Block length of the NTB being parsed.
+   */
+  size_t                    rx_block;
+  /**
+   * @brief   Offset of the NDP16 being parsed.
+   */
+  size_t                    rx_ndp;
+  /**
+   * @brief   Offset of the next datagram pointer.
+   */
+  size_t                    rx_entry;
+  /**
+   * @brief   End offset of the datagram pointers.
+   */
+  size_t                    rx_end;
+  /**
+   * @brief   Thread waiting for a transmit buffer.
+   */
+  thread_reference_t        tx_thread;
+  /**
+   * @brief   Outgoing NTBs data.
+   */
+  uint32_t                  tx_buffers[USB_NCM_TX_NTBS]
+                                      [USB_NCM_NTB_IN_SIZE / 4];
+  /**
+   * @brief   Outgoing NTBs descriptors, used in circular order.
+   */
+  ncm_ntb_t                 tx_ntbs[USB_NCM_TX_NTBS];
+  /**
+   * @brief   Index of the oldest outgoing NTB in use.
+   */
+  unsigned                  tx_first;
+  /**
+   * @brief   Number of outgoing NTBs in use.
+   */
+  unsigned                  tx_count;
+  /**
+   * @brief   The last outgoing NTB in use is still aggregating datagrams.
+   */
+  bool                      tx_filling;
+  /**
+   * @brief   A datagram is being written in the aggregating NTB.
+   */
+  bool                      tx_reserved;
+  /**
+   * @brief   Maximum size of the outgoing NTB being filled.
+   */
+  size_t                    tx_max;
+  /**
+   * @brief   Outgoing NTBs sequence number.
+   */
+  uint16_t                  tx_sequence;
+} USBNCMDriver;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns @p true if the host enabled the data interface.
+ *
+ * @param[in] ncmp      pointer to a @p USBNCMDriver object
+ *
+ * @xclass
+ */
+#define ncmIsActiveX(ncmp) ((ncmp)->state == NCM_ACTIVE)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void ncmObjectInit(USBNCMDriver *ncmp);
+  void ncmStart(USBNCMDriver *ncmp, const USBNCMConfig *config);
+  void ncmStop(USBNCMDriver *ncmp);
+  void ncmConfigureHookI(USBNCMDriver *ncmp);
+  void ncmResetHookI(USBNCMDriver *ncmp);
+  bool ncmRequestsHook(USBNCMDriver *ncmp);
+  void ncmDataTransmitted(USBDriver *usbp, usbep_t ep);
+  void ncmDataReceived(USBDriver *usbp, usbep_t ep);
+  void ncmInterruptTransmitted(USBDriver *usbp, usbep_t ep);
+  msg_t ncmReceiveDatagramTimeout(USBNCMDriver *ncmp, ncm_datagram_t *dgp,
+                                  sysinterval_t timeout);
+  void ncmReleaseDatagram(USBNCMDriver *ncmp, const ncm_datagram_t *dgp);
+  msg_t ncmGetTransmitBufferTimeout(USBNCMDriver *ncmp, size_t size,
+                                    uint8_t **bufp, sysinterval_t timeout);
+  void ncmPostTransmitBuffer(USBNCMDriver *ncmp, size_t size);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USB_NCM_H */
+
+/** @} */
@@ -0,0 +1,716 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_usbh_msd.c
+ * @brief   USB host mass storage class driver code.
+ *
+ * @addtogroup HAL_USBH_MSD
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#include "hal_usbh_msd.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @name    SCSI commands
+ * @{
+ */
+#define MSD_SCSI_TEST_UNIT_READY            0x00U
+#define MSD_SCSI_REQUEST_SENSE              0x03U
+#define MSD_SCSI_INQUIRY                    0x12U
+#define MSD_SCSI_MODE_SENSE6                0x1AU
+#define MSD_SCSI_READ_CAPACITY10            0x25U
+#define MSD_SCSI_READ10                     0x28U
+#define MSD_SCSI_WRITE10                    0x2AU
+/** @} */
+
+/**
+ * @name    CSW status codes
+ * @{
+ */
+#define MSD_CSW_STATUS_PASSED               0x00U
+#define MSD_CSW_STATUS_PHASE_ERROR          0x02U
+/** @} */
+
+/**
+ * @brief   Maximum number of blocks of a READ(10) or WRITE(10) command.
+ */
+#define MSD_MAX_BLOCKS                      0xFFFFU
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+static bool msd_is_inserted(void *instance);
+static bool msd_is_protected(void *instance);
+
+/**
+ * @brief   Virtual methods table.
+ */
+static const struct USBHMassStorageDriverVMT msd_vmt = {
+  (size_t)0,
+  msd_is_inserted,
+  msd_is_protected,
+  (bool (*)(void *))usbhmsdConnect,
+  (bool (*)(void *))usbhmsdDisconnect,
+  (bool (*)(void *, uint32_t, uint8_t *, uint32_t))usbhmsdRead,
+  (bool (*)(void *, uint32_t, const uint8_t *, uint32_t))usbhmsdWrite,
+  (bool (*)(void *))usbhmsdSync,
+  (bool (*)(void *, BlockDeviceInfo *))usbhmsdGetInfo
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static bool msd_is_inserted(void *instance) {
+  USBHMassStorageDriver *msdp = (USBHMassStorageDriver *)instance;
+
+  return (msdp->config != NULL) && usbhIsConnectedX(msdp->config->usbhp);
+}
+
+static bool msd_is_protected(void *instance) {
+  USBHMassStorageDriver *msdp = (USBHMassStorageDriver *)instance;
+
+  return msdp->wp;
+}
+
+static void msd_put32le(uint8_t *p, uint32_t v) {
+
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t msd_get32le(const uint8_t *p) {
+
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+         ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t msd_get32be(const uint8_t *p) {
+
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+         ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/**
+ * @brief   Opens the bulk pipes of the mass storage interface.
+ * @details The configuration descriptor is scanned for the first SCSI
+ *          Bulk-Only Transport interface.
+ *
+ * @param[in] msdp      pointer to the @p USBHMassStorageDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static bool msd_open_pipes(USBHMassStorageDriver *msdp) {
+  USBHDriver *usbhp = msdp->config->usbhp;
+  const uint8_t *p = usbhGetConfigDescriptorX(usbhp);
+  const uint8_t *end = p + usbhGetConfigSizeX(usbhp);
+  uint8_t inaddr = 0U, outaddr = 0U;
+  uint16_t inmps = 0U, outmps = 0U, mps;
+  bool found = false;
+
+  while ((p + 2 <= end) && (p[0] >= 2U) && (p + p[0] <= end)) {
+    if ((p[1] == USBH_DT_INTERFACE) && (p[0] >= 9U)) {
+      if (found) {
+        /* End of the mass storage interface.*/
+        break;
+      }
+      found = (p[5] == USBH_MSD_CLASS) && (p[6] == USBH_MSD_SUBCLASS_SCSI) &&
+              (p[7] == USBH_MSD_PROTOCOL_BBB);
+      msdp->iface = p[2];
+    }
+    else if (found && (p[1] == USBH_DT_ENDPOINT) && (p[0] >= 7U) &&
+             ((p[3] & 3U) == USBH_EPTYPE_BULK)) {
+      mps = (uint16_t)(((uint16_t)p[4] | ((uint16_t)p[5] << 8)) & 0x7FFU);
+      if ((p[2] & USBH_EP_IN) != 0U) {
+        inaddr = p[2];
+        inmps  = mps;
+      }
+      else {
+        outaddr = p[2];
+        outmps  = mps;
+      }
+    }
+    p += p[0];
+  }
+
+  if ((inmps == 0U) || (outmps == 0U)) {
+    return HAL_FAILED;
+  }
+
+  usbhClosePipe(usbhp, &msdp->bulkin);
+  usbhClosePipe(usbhp, &msdp->bulkout);
+  if (usbhOpenPipe(usbhp, &msdp->bulkin, inaddr,
+                   USBH_EPTYPE_BULK, inmps) != HAL_SUCCESS) {
+    return HAL_FAILED;
+  }
+  if (usbhOpenPipe(usbhp, &msdp->bulkout, outaddr,
+                   USBH_EPTYPE_BULK, outmps) != HAL_SUCCESS) {
+    usbhClosePipe(usbhp, &msdp->bulkin);
+    return HAL_FAILED;
+  }
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Bulk-Only Transport reset recovery.
+ *
+ * @param[in] msdp      pointer to the @p USBHMassStorageDriver object
+ *
+ * @notapi
+ */
+static void msd_reset_recovery(USBHMassStorageDriver *msdp) {
+  USBHDriver *usbhp = msdp->config->usbhp;
+
+  if (usbhControlRequest(usbhp,
+                         USBH_RTYPE_HOST2DEV | USBH_RTYPE_CLASS |
+                         USBH_RTYPE_INTERFACE,
+                         USBH_MSD_REQ_RESET, 0U, (uint16_t)msdp->iface,
+                         0U, NULL) == MSG_OK) {
+    (void)usbhClearHalt(usbhp, &msdp->bulkin);
+    (void)usbhClearHalt(usbhp, &msdp->bulkout);
+  }
+}
+
+/**
+ * @brief   Reads the CSW after a stalled stage.
+ * @details A stalled CSW is retried once after clearing the halt.
+ *
+ * @param[in] msdp      pointer to the @p USBHMassStorageDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static bool msd_read_csw(USBHMassStorageDriver *msdp) {
+  USBHDriver *usbhp = msdp->config->usbhp;
+  USBHURB urb;
+  unsigned i;
+
+  for (i = 0U; i < 2U; i++) {
+    usbhURBObjectInit(&urb, &msdp->bulkin, USBH_PID_TOGGLE,
+                      (uint8_t *)msdp->csw, USBH_MSD_CSW_SIZE);
+    if (usbhTransfer(usbhp, &urb, OSAL_MS2I(USBH_MSD_TIMEOUT)) == MSG_OK) {
+      return HAL_SUCCESS;
+    }
+    if ((urb.status != USBH_URB_STALL) ||
+        (usbhClearHalt(usbhp, &msdp->bulkin) != MSG_OK)) {
+      break;
+    }
+  }
+
+  return HAL_FAILED;
+}
+
+/**
+ * @brief   Executes a SCSI command.
+ * @details The CBW, data and CSW stages are submitted as a single URBs
+ *          chain, the data stage is a single multi-packet transfer. The
+ *          error recovery of the Bulk-Only Transport is performed if a
+ *          stage fails.
+ *
+ * @param[in] msdp      pointer to the @p USBHMassStorageDriver object
+ * @param[in] cb        command block
+ * @param[in] cblen     command block length
+ * @param[in] in        data stage direction
+ * @param[in,out] data  data stage buffer, must be word aligned
+ * @param[in] n         data stage size, zero if no data stage
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the command passed and all the data has been
+ *                      transferred.
+ * @retval HAL_FAILED   if the command failed.
+ *
+ * @notapi
+ */
+static bool msd_command(USBHMassStorageDriver *msdp, const uint8_t *cb,
+                        uint8_t cblen, bool in, uint8_t *data, uint32_t n) {
+  USBHDriver *usbhp = msdp->config->usbhp;
+  uint8_t *cbw = (uint8_t *)msdp->cbw;
+  const uint8_t *csw = (const uint8_t *)msdp->csw;
+  USBHURB cbwurb, dataurb, cswurb;
+  msg_t msg;
+
+  /* Command Block Wrapper.*/
+  memset(cbw, 0, USBH_MSD_CBW_SIZE);
+  msdp->tag++;
+  msd_put32le(&cbw[0], USBH_MSD_CBW_SIGNATURE);
+  msd_put32le(&cbw[4], msdp->tag);
+  msd_put32le(&cbw[8], n);
+  cbw[12] = in ? 0x80U : 0x00U;
+  cbw[14] = cblen;
+  memcpy(&cbw[15], cb, cblen);
+
+  usbhURBObjectInit(&cbwurb, &msdp->bulkout, USBH_PID_TOGGLE,
+                    cbw, USBH_MSD_CBW_SIZE);
+  usbhURBObjectInit(&cswurb, &msdp->bulkin, USBH_PID_TOGGLE,
+                    (uint8_t *)msdp->csw, USBH_MSD_CSW_SIZE);
+  usbhURBObjectInit(&dataurb, in ? &msdp->bulkin : &msdp->bulkout,
+                    USBH_PID_TOGGLE, data, (size_t)n);
+  if (n > 0U) {
+    usbhURBLinkX(&cbwurb, &dataurb);
+    usbhURBLinkX(&dataurb, &cswurb);
+  }
+  else {
+    usbhURBLinkX(&cbwurb, &cswurb);
+  }
+
+  msg = usbhTransfer(usbhp, &cbwurb, OSAL_MS2I(USBH_MSD_TIMEOUT));
+  if (msg != MSG_OK) {
+    if ((msg == MSG_TIMEOUT) || !usbhIsConnectedX(usbhp) ||
+        (cbwurb.status != USBH_URB_OK)) {
+      msd_reset_recovery(msdp);
+      return HAL_FAILED;
+    }
+
+    /* A stalled data stage or CSW is recovered by clearing the halt and
+       reading the CSW again.*/
+    if (dataurb.status == USBH_URB_STALL) {
+      if ((usbhClearHalt(usbhp, dataurb.pipe) != MSG_OK) ||
+          (msd_read_csw(msdp) != HAL_SUCCESS)) {
+        msd_reset_recovery(msdp);
+        return HAL_FAILED;
+      }
+    }
+    else if (cswurb.status == USBH_URB_STALL) {
+      if ((usbhClearHalt(usbhp, &msdp->bulkin) != MSG_OK) ||
+          (msd_read_csw(msdp) != HAL_SUCCESS)) {
+        msd_reset_recovery(msdp);
+        return HAL_FAILED;
+      }
+    }
+    else {
+      msd_reset_recovery(msdp);
+      return HAL_FAILED;
+    }
+  }
+
+  /* Command Status Wrapper validation.*/
+  if ((msd_get32le(&csw[0]) != USBH_MSD_CSW_SIGNATURE) ||
+      (msd_get32le(&csw[4]) != msdp->tag) ||
+      (csw[12] == MSD_CSW_STATUS_PHASE_ERROR)) {
+    msd_reset_recovery(msdp);
+    return HAL_FAILED;
+  }
+  if ((csw[12] != MSD_CSW_STATUS_PASSED) || (dataurb.actual != (size_t)n)) {
+    return HAL_FAILED;
+  }
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Executes a command returning data in the bounce buffer.
+ *
+ * @param[in] msdp      pointer to the @p USBHMassStorageDriver object
+ * @param[in] op        SCSI operation code
+ * @param[in] arg       allocation length or page code argument
+ * @param[in] n         data stage size
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static bool msd_command6(USBHMassStorageDriver *msdp, uint8_t op,
+                         uint8_t arg, uint8_t n) {
+  uint8_t cb[6] = {op, 0U, arg, 0U, n, 0U};
+
+  return msd_command(msdp, cb, (uint8_t)sizeof cb, true,
+                     (uint8_t *)msdp->buf, (uint32_t)n);
+}
+
+/**
+ * @brief   Executes a READ(10) or WRITE(10) command.
+ *
+ * @param[in] msdp      pointer to the @p USBHMassStorageDriver object
+ * @param[in] op        SCSI operation code
+ * @param[in] startblk  first block
+ * @param[in,out] buf   data buffer, must be word aligned
+ * @param[in] n         number of blocks, up to @p MSD_MAX_BLOCKS
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static bool msd_rw10(USBHMassStorageDriver *msdp, uint8_t op,
+                     uint32_t startblk, uint8_t *buf, uint32_t n) {
+  uint8_t cb[10] = {op, 0U,
+                    (uint8_t)(startblk >> 24), (uint8_t)(startblk >> 16),
+                    (uint8_t)(startblk >> 8), (uint8_t)startblk,
+                    0U, (uint8_t)(n >> 8), (uint8_t)n, 0U};
+
+  return msd_command(msdp, cb, (uint8_t)sizeof cb, op == MSD_SCSI_READ10,
+                     buf, n * (uint32_t)USBH_MSD_BLOCK_SIZE);
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ *
+ * @param[out] msdp     pointer to the @p USBHMassStorageDriver object
+ *
+ * @init
+ */
+void usbhmsdObjectInit(USBHMassStorageDriver *msdp) {
+
+  osalDbgCheck(msdp != NULL);
+
+  msdp->vmt          = &msd_vmt;
+  msdp->state        = BLK_STOP;
+  msdp->config       = NULL;
+  msdp->bulkin.open  = false;
+  msdp->bulkout.open = false;
+  msdp->wp           = false;
+  msdp->tag          = 0U;
+  msdp->blk_num      = 0U;
+}
+
+/**
+ * @brief   Configures and activates the driver.
+ * @note    The USB host driver must be already started.
+ *
+ * @param[in] msdp      pointer to the @p USBHMassStorageDriver object
+ * @param[in] config    pointer to the configuration
+ *
+ * @api
+ */
+void usbhmsdStart(USBHMassStorageDriver *msdp,
+                  const USBHMassStorageConfig *config) {
+
+  osalDbgCheck((msdp != NULL) && (config != NULL) &&
+               (config->usbhp != NULL));
+  osalDbgAssert((msdp->state == BLK_STOP) || (msdp->state == BLK_ACTIVE),
+                "invalid state");
+
+  msdp->config = config;
+  msdp->state  = BLK_ACTIVE;
+}
+
+/**
+ * @brief   Deactivates the driver.
+ * @note    The driver must be disconnected before stopping it.
+ *
+ * @param[in] msdp      pointer to the @p USBHMassStorageDriver object
+ *
+ * @api
+ */
+void usbhmsdStop(USBHMassStorageDriver *msdp) {
+
+  osalDbgCheck(msdp != NULL);
+  osalDbgAssert((msdp->state == BLK_STOP) || (msdp->state == BLK_ACTIVE),
+                "invalid state");
+
+  msdp->state = BLK_STOP;
+}
+
+/**
+ * @brief   Connects to the mass storage device.
+ * @details The device must be already enumerated by @p usbhConnect(), the
+ *          bulk pipes are opened and the unit is queried until ready.
+ *
+ * @param[in] msdp      pointer to the @p USBHMassStorageDriver object
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool usbhmsdConnect(USBHMassStorageDriver *msdp) {
+  const uint8_t *buf = (const uint8_t *)msdp->buf;
+  uint8_t tur[6] = {MSD_SCSI_TEST_UNIT_READY, 0U, 0U, 0U, 0U, 0U};
+  uint8_t cb[10] = {MSD_SCSI_READ_CAPACITY10, 0U, 0U, 0U, 0U,
+                    0U, 0U, 0U, 0U, 0U};
+  unsigned i;
+
+  osalDbgCheck(msdp != NULL);
+  osalDbgAssert((msdp->state == BLK_ACTIVE) || (msdp->state == BLK_READY),
+                "invalid state");
+
+  /* Connection procedure in progress.*/
+  msdp->state = BLK_CONNECTING;
+
+  if ((usbhGetDriverStateI(msdp->config->usbhp) != USBH_ACTIVE) ||
+      (msd_open_pipes(msdp) != HAL_SUCCESS)) {
+    msdp->state = BLK_ACTIVE;
+    return HAL_FAILED;
+  }
+
+  /* Some devices do not answer commands before an INQUIRY, the medium is
+     then polled until ready.*/
+  if (msd_command6(msdp, MSD_SCSI_INQUIRY, 0U, 36U) != HAL_SUCCESS) {
+    goto failed;
+  }
+  for (i = 0U; i < (unsigned)USBH_MSD_READY_ATTEMPTS; i++) {
+    if (msd_command(msdp, tur, (uint8_t)sizeof tur, false,
+                    NULL, 0U) == HAL_SUCCESS) {
+      break;
+    }
+    /* The sense data clears the unit attention condition.*/
+    (void)msd_command6(msdp, MSD_SCSI_REQUEST_SENSE, 0U, 18U);
+    osalThreadSleepMilliseconds(100);
+  }
+  if (i >= (unsigned)USBH_MSD_READY_ATTEMPTS) {
+    goto failed;
+  }
+
+  /* Medium geometry.*/
+  if ((msd_command(msdp, cb, (uint8_t)sizeof cb, true,
+                   (uint8_t *)msdp->buf, 8U) != HAL_SUCCESS) ||
+      (msd_get32be(&buf[4]) != (uint32_t)USBH_MSD_BLOCK_SIZE) ||
+      (msd_get32be(&buf[0]) == 0xFFFFFFFFU)) {
+    goto failed;
+  }
+  msdp->blk_num = msd_get32be(&buf[0]) + 1U;
+
+  /* Write protection from the mode parameters header, devices not
+     implementing MODE SENSE are considered writable.*/
+  msdp->wp = false;
+  if (msd_command6(msdp, MSD_SCSI_MODE_SENSE6, 0x3FU, 4U) == HAL_SUCCESS) {
+    msdp->wp = (buf[2] & 0x80U) != 0U;
+  }
+
+  msdp->state = BLK_READY;
+  return HAL_SUCCESS;
+
+failed:
+  usbhClosePipe(msdp->config->usbhp, &msdp->bulkin);
+  usbhClosePipe(msdp->config->usbhp, &msdp->bulkout);
+  msdp->state = BLK_ACTIVE;
+  return HAL_FAILED;
+}
+
+/**
+ * @brief   Disconnects from the mass storage device.
+ *
+ * @param[in] msdp      pointer to the @p USBHMassStorageDriver object
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool usbhmsdDisconnect(USBHMassStorageDriver *msdp) {
+
+  osalDbgCheck(msdp != NULL);
+  osalDbgAssert((msdp->state == BLK_ACTIVE) || (msdp->state == BLK_READY),
+                "invalid state");
+
+  /* Checks if already disconnected.*/
+  if (msdp->state == BLK_ACTIVE) {
+    return HAL_SUCCESS;
+  }
+
+  usbhClosePipe(msdp->config->usbhp, &msdp->bulkin);
+  usbhClosePipe(msdp->config->usbhp, &msdp->bulkout);
+  msdp->state = BLK_ACTIVE;
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Reads one or more blocks.
+ * @details Word aligned buffers are transferred directly using commands
+ *          of up to 65535 blocks, unaligned buffers are transferred one
+ *          block at time through the bounce buffer.
+ * @note    On devices with data cache the buffer should be aligned to the
+ *          cache line size.
+ *
+ * @param[in] msdp      pointer to the @p USBHMassStorageDriver object
+ * @param[in] startblk  first block to read
+ * @param[out] buf      pointer to the read buffer
+ * @param[in] n         number of blocks to read
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool usbhmsdRead(USBHMassStorageDriver *msdp, uint32_t startblk,
+                 uint8_t *buf, uint32_t n) {
+  bool aligned = ((size_t)buf & 3U) == 0U;
+  uint32_t m;
+
+  osalDbgCheck((msdp != NULL) && (buf != NULL) && (n > 0U));
+  osalDbgAssert(msdp->state == BLK_READY, "invalid state");
+
+  /* Read operation in progress.*/
+  msdp->state = BLK_READING;
+
+  while (n > 0U) {
+    if (aligned) {
+      m = n > MSD_MAX_BLOCKS ? MSD_MAX_BLOCKS : n;
+      if (msd_rw10(msdp, MSD_SCSI_READ10, startblk, buf, m) != HAL_SUCCESS) {
+        break;
+      }
+    }
+    else {
+      m = 1U;
+      if (msd_rw10(msdp, MSD_SCSI_READ10, startblk,
+                   (uint8_t *)msdp->buf, 1U) != HAL_SUCCESS) {
+        break;
+      }
+      memcpy(buf, msdp->buf, USBH_MSD_BLOCK_SIZE);
+    }
+    buf      += m * (uint32_t)USBH_MSD_BLOCK_SIZE;
+    startblk += m;
+    n        -= m;
+  }
+
+  msdp->state = BLK_READY;
+  return n > 0U ? HAL_FAILED : HAL_SUCCESS;
+}
+
+/**
+ * @brief   Writes one or more blocks.
+ * @details Word aligned buffers are transferred directly using commands
+ *          of up to 65535 blocks, unaligned buffers are transferred one
+ *          block at time through the bounce buffer.
+ * @note    On devices with data cache the buffer should be aligned to the
+ *          cache line size.
+ *
+ * @param[in] msdp      pointer to the @p USBHMassStorageDriver object
+ * @param[in] startblk  first block to write
+ * @param[in] buf       pointer to the write buffer
+ * @param[in] n         number of blocks to write
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool usbhmsdWrite(USBHMassStorageDriver *msdp, uint32_t startblk,
+                  const uint8_t *buf, uint32_t n) {
+  bool aligned = ((size_t)buf & 3U) == 0U;
+  uint32_t m;
+
+  osalDbgCheck((msdp != NULL) && (buf != NULL) && (n > 0U));
+  osalDbgAssert(msdp->state == BLK_READY, "invalid state");
+
+  if (msdp->wp) {
+    return HAL_FAILED;
+  }
+
+  /* Write operation in progress.*/
+  msdp->state = BLK_WRITING;
+
+  while (n > 0U) {
+    if (aligned) {
+      m = n > MSD_MAX_BLOCKS ? MSD_MAX_BLOCKS : n;
+      if (msd_rw10(msdp, MSD_SCSI_WRITE10, startblk,
+                   (uint8_t *)buf, m) != HAL_SUCCESS) {
+        break;
+      }
+    }
+    else {
+      m = 1U;
+      memcpy(msdp->buf, buf, USBH_MSD_BLOCK_SIZE);
+      if (msd_rw10(msdp, MSD_SCSI_WRITE10, startblk,
+                   (uint8_t *)msdp->buf, 1U) != HAL_SUCCESS) {
+        break;
+      }
+    }
+    buf      += m * (uint32_t)USBH_MSD_BLOCK_SIZE;
+    startblk += m;
+    n        -= m;
+  }
+
+  msdp->state = BLK_READY;
+  return n > 0U ? HAL_FAILED : HAL_SUCCESS;
+}
+
+/**
+ * @brief   Waits for the completion of write operations.
+ * @details Writes are completed when their CSW is received, there is
+ *          nothing to wait for.
+ *
+ * @param[in] msdp      pointer to the @p USBHMassStorageDriver object
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool usbhmsdSync(USBHMassStorageDriver *msdp) {
+
+  osalDbgCheck(msdp != NULL);
+  osalDbgAssert(msdp->state == BLK_READY, "invalid state");
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Returns the medium information.
+ * @details The bus rate is the nominal signaling rate of the device.
+ *
+ * @param[in] msdp      pointer to the @p USBHMassStorageDriver object
+ * @param[out] bdip     pointer to a @p BlockDeviceInfo structure
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool usbhmsdGetInfo(USBHMassStorageDriver *msdp, BlockDeviceInfo *bdip) {
+
+  osalDbgCheck((msdp != NULL) && (bdip != NULL));
+
+  if (msdp->state != BLK_READY) {
+    return HAL_FAILED;
+  }
+
+  bdip->blk_size = (uint32_t)USBH_MSD_BLOCK_SIZE;
+  bdip->blk_num  = msdp->blk_num;
+  switch (usbhGetSpeedX(msdp->config->usbhp)) {
+  case USBH_SPEED_HIGH:
+    bdip->bus_rate = 60000000U;
+    break;
+  case USBH_SPEED_FULL:
+    bdip->bus_rate = 1500000U;
+    break;
+  default:
+    bdip->bus_rate = 187500U;
+    break;
+  }
+
+  return HAL_SUCCESS;
+}
+
+/** @} */
@@ -0,0 +1,225 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_usbh_msd.h
+ * @brief   USB host mass storage class driver header.
+ *
+ * @addtogroup HAL_USBH_MSD
+ * @{
+ */
+
+#ifndef HAL_USBH_MSD_H
+#define HAL_USBH_MSD_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Mass storage interface codes
+ * @{
+ */
+#define USBH_MSD_CLASS                      0x08U
+#define USBH_MSD_SUBCLASS_SCSI              0x06U
+#define USBH_MSD_PROTOCOL_BBB               0x50U
+/** @} */
+
+/**
+ * @name    Bulk-Only Transport definitions
+ * @{
+ */
+#define USBH_MSD_REQ_RESET                  0xFFU
+#define USBH_MSD_CBW_SIGNATURE              0x43425355U
+#define USBH_MSD_CSW_SIGNATURE              0x53425355U
+#define USBH_MSD_CBW_SIZE                   31U
+#define USBH_MSD_CSW_SIZE                   13U
+/** @} */
+
+/**
+ * @brief   Size of the CSW buffer.
+ * @details IN transfers are rounded to the packet size, the buffer covers
+ *          the high speed bulk packet size.
+ */
+#define USBH_MSD_CSW_BUFFER_SIZE            512U
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Supported block size.
+ * @details Devices with a different block size are refused, the size is
+ *          also the size of the bounce buffer used for unaligned buffers.
+ */
+#if !defined(USBH_MSD_BLOCK_SIZE) || defined(__DOXYGEN__)
+#define USBH_MSD_BLOCK_SIZE                 512
+#endif
+
+/**
+ * @brief   Timeout of a command in milliseconds.
+ */
+#if !defined(USBH_MSD_TIMEOUT) || defined(__DOXYGEN__)
+#define USBH_MSD_TIMEOUT                    5000
+#endif
+
+/**
+ * @brief   Number of attempts while waiting for the unit to become ready.
+ * @details Attempts are performed at 100ms intervals.
+ */
+#if !defined(USBH_MSD_READY_ATTEMPTS) || defined(__DOXYGEN__)
+#define USBH_MSD_READY_ATTEMPTS             20
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if HAL_USE_USBH == FALSE
+#error "USB host Mass Storage requires HAL_USE_USBH"
+#endif
+
+#if (USBH_MSD_BLOCK_SIZE < 512) || ((USBH_MSD_BLOCK_SIZE % 512) != 0)
+#error "invalid USBH_MSD_BLOCK_SIZE value"
+#endif
+
+#if USBH_MSD_READY_ATTEMPTS < 1
+#error "invalid USBH_MSD_READY_ATTEMPTS value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of an USB host mass storage driver configuration.
+ */
+typedef struct {
+  /**
+   * @brief   USB host driver to use.
+   */
+  USBHDriver                *usbhp;
+} USBHMassStorageConfig;
+
+/**
+ * @brief   @p USBHMassStorageDriver specific methods.
+ */
+#define _usbh_mass_storage_driver_methods                                   \
+  _base_block_device_methods
+
+/**
+ * @extends BaseBlockDeviceVMT
+ *
+ * @brief   @p USBHMassStorageDriver virtual methods table.
+ */
+struct USBHMassStorageDriverVMT {
+  _usbh_mass_storage_driver_methods
+};
+
+/**
+ * @extends BaseBlockDevice
+ *
+ * @brief   Type of an USB host mass storage driver.
+ * @details The driver exports the first LUN of a Bulk-Only Transport SCSI
+ *          device as a block device. Each command is executed as a single
+ *          chain of CBW, data and CSW transfers.
+ */
+typedef struct {
+  /**
+   * @brief   Virtual Methods Table.
+   */
+  const struct USBHMassStorageDriverVMT *vmt;
+  _base_block_device_data
+  /**
+   * @brief   Current configuration data.
+   */
+  const USBHMassStorageConfig *config;
+  /**
+   * @brief   Bulk IN pipe.
+   */
+  USBHPipe                  bulkin;
+  /**
+   * @brief   Bulk OUT pipe.
+   */
+  USBHPipe                  bulkout;
+  /**
+   * @brief   Mass storage interface number.
+   */
+  uint8_t                   iface;
+  /**
+   * @brief   Medium write protected.
+   */
+  bool                      wp;
+  /**
+   * @brief   Tag of the last command.
+   */
+  uint32_t                  tag;
+  /**
+   * @brief   Number of blocks of the medium.
+   */
+  uint32_t                  blk_num;
+  /**
+   * @brief   Command Block Wrapper buffer.
+   */
+  uint32_t                  cbw[(USBH_MSD_CBW_SIZE + 1U) / 4U];
+  /**
+   * @brief   Command Status Wrapper buffer.
+   */
+  uint32_t                  csw[USBH_MSD_CSW_BUFFER_SIZE / 4U];
+  /**
+   * @brief   Bounce buffer for unaligned transfers and short responses.
+   */
+  uint32_t                  buf[USBH_MSD_BLOCK_SIZE / 4U];
+} USBHMassStorageDriver;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void usbhmsdObjectInit(USBHMassStorageDriver *msdp);
+  void usbhmsdStart(USBHMassStorageDriver *msdp,
+                    const USBHMassStorageConfig *config);
+  void usbhmsdStop(USBHMassStorageDriver *msdp);
+  bool usbhmsdConnect(USBHMassStorageDriver *msdp);
+  bool usbhmsdDisconnect(USBHMassStorageDriver *msdp);
+  bool usbhmsdRead(USBHMassStorageDriver *msdp, uint32_t startblk,
+                   uint8_t *buf, uint32_t n);
+  bool usbhmsdWrite(USBHMassStorageDriver *msdp, uint32_t startblk,
+                    const uint8_t *buf, uint32_t n);
+  bool usbhmsdSync(USBHMassStorageDriver *msdp);
+  bool usbhmsdGetInfo(USBHMassStorageDriver *msdp, BlockDeviceInfo *bdip);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USBH_MSD_H */
+
+/** @} */
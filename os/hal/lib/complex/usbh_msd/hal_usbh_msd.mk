@@ -0,0 +1,9 @@
+# List of all the USB host mass storage class driver files.
+USBHMSDSRC := $(CHIBIOS)/os/hal/lib/complex/usbh_msd/hal_usbh_msd.c
+
+# Required include directories
+USBHMSDINC := $(CHIBIOS)/os/hal/lib/complex/usbh_msd
+
+# Shared variables
+ALLCSRC += $(USBHMSDSRC)
+ALLINC  += $(USBHMSDINC)
@@ -29,6 +29,20 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @name    Pixel formats
+ * @{
+ */
+#define DISPLAY_PIXFMT_ARGB8888             0U
+#define DISPLAY_PIXFMT_RGB888               1U
+#define DISPLAY_PIXFMT_RGB565               2U
+#define DISPLAY_PIXFMT_ARGB1555             3U
+#define DISPLAY_PIXFMT_ARGB4444             4U
+#define DISPLAY_PIXFMT_L8                   5U
+#define DISPLAY_PIXFMT_AL44                 6U
+#define DISPLAY_PIXFMT_AL88                 7U
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -41,11 +55,73 @@
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Type of a pixel format.
+ */
+typedef uint32_t display_pixfmt_t;
+
+/**
+ * @brief   Type of a color.
+ * @details Colors are always specified in ARGB8888 format, they are
+ *          converted to the display format by the implementation.
+ */
+typedef uint32_t display_color_t;
+
+/**
+ * @brief   Type of a display rectangle.
+ */
+typedef struct {
+  uint16_t                  x;
+  uint16_t                  y;
+  uint16_t                  width;
+  uint16_t                  height;
+} display_rect_t;
+
+/**
+ * @brief   Type of a drawing surface.
+ * @details Describes a pixels buffer, it is used for both the display
+ *          frame buffers and the source images.
+ */
+typedef struct {
+  /**
+   * @brief   Pointer to the first pixel.
+   */
+  void                      *buffer;
+  /**
+   * @brief   Pixel format.
+   */
+  display_pixfmt_t          format;
+  /**
+   * @brief   Width in pixels.
+   */
+  uint16_t                  width;
+  /**
+   * @brief   Height in pixels.
+   */
+  uint16_t                  height;
+  /**
+   * @brief   Distance between lines in pixels.
+   */
+  uint16_t                  stride;
+} display_surface_t;
+
 /**
  * @brief   @p BaseDisplay specific methods.
- * @note    No methods so far, just a common ancestor interface.
  */
-#define _base_display_methods_alone
+#define _base_display_methods_alone                                         \
+  /* Returns the surface being drawn.*/                                     \
+  void (*get_surface)(void *instance, display_surface_t *sp);               \
+  /* Fills a rectangle with a color.*/                                      \
+  msg_t (*fill)(void *instance, const display_rect_t *rp,                   \
+                display_color_t color);                                     \
+  /* Copies an image converting its pixel format.*/                         \
+  msg_t (*blit)(void *instance, uint16_t x, uint16_t y,                     \
+                const display_surface_t *srcp);                             \
+  /* Blends an image over the surface content.*/                            \
+  msg_t (*blend)(void *instance, uint16_t x, uint16_t y,                    \
+                 const display_surface_t *srcp, uint8_t alpha);             \
+  /* Shows the drawn surface.*/                                             \
+  msg_t (*swap)(void *instance);
 
 /**
  * @brief   @p BaseDisplay specific methods with inherited ones.
@@ -85,16 +161,92 @@ typedef struct {
  * @{
  */
 /**
- * @brief   Sensors get axes number.
+ * @brief   Returns the surface being drawn.
+ * @details With double buffering this is the hidden buffer, it becomes
+ *          visible on the next @p displaySwap().
+ *
+ * @param[in] ip        pointer to a @p BaseDisplay or derived class.
+ * @param[out] sp       pointer to a @p display_surface_t structure
+ *
+ * @api
+ */
+#define displayGetSurface(ip, sp) (ip)->vmt_basedisplay->get_surface(ip, sp)
+
+/**
+ * @brief   Fills a rectangle with a color.
  *
  * @param[in] ip        pointer to a @p BaseDisplay or derived class.
- * @return              The number of axes of the BaseDisplay
+ * @param[in] rp        pointer to the rectangle
+ * @param[in] color     the ARGB8888 color
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more errors occurred.
  *
  * @api
  */
-#define displayGetType(ip) (ip)->vmt_basedisplay->get_type(ip)
+#define displayFill(ip, rp, color)                                          \
+  (ip)->vmt_basedisplay->fill(ip, rp, color)
+
+/**
+ * @brief   Copies an image converting its pixel format.
+ *
+ * @param[in] ip        pointer to a @p BaseDisplay or derived class.
+ * @param[in] x         destination horizontal position
+ * @param[in] y         destination vertical position
+ * @param[in] srcp      pointer to the source surface
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more errors occurred.
+ *
+ * @api
+ */
+#define displayBlit(ip, x, y, srcp)                                         \
+  (ip)->vmt_basedisplay->blit(ip, x, y, srcp)
+
+/**
+ * @brief   Blends an image over the surface content.
+ * @details The image pixels alpha is multiplied by @p alpha.
+ *
+ * @param[in] ip        pointer to a @p BaseDisplay or derived class.
+ * @param[in] x         destination horizontal position
+ * @param[in] y         destination vertical position
+ * @param[in] srcp      pointer to the source surface
+ * @param[in] alpha     global alpha, 255 for opaque
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more errors occurred.
+ *
+ * @api
+ */
+#define displayBlend(ip, x, y, srcp, alpha)                                 \
+  (ip)->vmt_basedisplay->blend(ip, x, y, srcp, alpha)
+
+/**
+ * @brief   Shows the drawn surface.
+ * @details With double buffering the buffers are exchanged on the next
+ *          vertical blanking, the function returns after the exchange.
+ *
+ * @param[in] ip        pointer to a @p BaseDisplay or derived class.
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more errors occurred.
+ *
+ * @api
+ */
+#define displaySwap(ip) (ip)->vmt_basedisplay->swap(ip)
 /** @} */
 
+/**
+ * @brief   Size of a pixel in bytes.
+ *
+ * @param[in] fmt       the pixel format
+ * @return              The pixel size.
+ */
+#define DISPLAY_PIXFMT_SIZE(fmt)                                            \
+  ((fmt) == DISPLAY_PIXFMT_ARGB8888 ? 4U :                                  \
+   (fmt) == DISPLAY_PIXFMT_RGB888 ? 3U :                                    \
+   ((fmt) == DISPLAY_PIXFMT_L8) || ((fmt) == DISPLAY_PIXFMT_AL44) ? 1U : 2U)
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -218,6 +218,8 @@ typedef struct {
 
 /**
  * @brief   Read operation.
+ * @note    Drivers able to suspend erase operations can serve reads outside
+ *          the area being erased while an erase is in progress.
  *
  * @param[in] ip        pointer to a @p BaseFlash or derived class
  * @param[in] offset    flash offset
@@ -54,7 +54,10 @@
   /* Invoke the set sensitivity procedure.*/                                \
   msg_t (*set_sensitivity)(void *instance, float sensitivities[]);          \
   /* Restore sensitivity stored data to default.*/                          \
-  msg_t (*reset_sensitivity)(void *instance);
+  msg_t (*reset_sensitivity)(void *instance);                               \
+  /* Reads a batch of samples from the hardware FIFO, NULL if none.*/       \
+  msg_t (*read_fifo)(void *instance, int32_t axes[], size_t n,              \
+                     sensor_fifo_batch_t *bp);
 
 /**
  * @brief   BaseAccelerometer specific methods with inherited ones.
@@ -200,6 +203,40 @@ typedef struct {
  */
 #define accelerometerResetSensitivity(ip)                                   \
         (ip)->vmt->reset_sensitivity(ip)
+
+/**
+ * @brief   Checks if the BaseAccelerometer has a hardware FIFO.
+ *
+ * @param[in] ip        pointer to a @p BaseAccelerometer class.
+ * @return              The FIFO availability.
+ *
+ * @api
+ */
+#define accelerometerHasFIFO(ip)                                            \
+        ((ip)->vmt->read_fifo != NULL)
+
+/**
+ * @brief   BaseAccelerometer read FIFO.
+ * @details Reads all the samples accumulated in the hardware FIFO, up to
+ *          @p n samples, with a single bus transaction. Raw samples are
+ *          stored oldest first, each one made of as many elements as the
+ *          number of axes.
+ * @pre     The FIFO must be available, see @p accelerometerHasFIFO().
+ *
+ * @param[in] ip        pointer to a @p BaseAccelerometer class.
+ * @param[out] dp       pointer to a data array, it must be able to hold
+ *                      @p n samples
+ * @param[in] n         maximum number of samples
+ * @param[out] bp       pointer to the batch descriptor
+ *
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more errors occurred.
+ *
+ * @api
+ */
+#define accelerometerReadFIFO(ip, dp, n, bp)                                \
+        (ip)->vmt->read_fifo(ip, dp, n, bp)
 /** @} */
 
 /*===========================================================================*/
@@ -29,6 +29,14 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Fractional bits of the fixed point sensitivities and data.
+ * @details Fixed point values are Q16.16, a raw sample multiplied by a
+ *          Q16.16 sensitivity is already a Q16.16 value so the conversion
+ *          requires a single 32 bits multiply-subtract per axis.
+ */
+#define SENSOR_Q_SHIFT                      16
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -41,6 +49,31 @@
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Descriptor of a batch of samples read from a sensor FIFO.
+ * @details Samples are stored oldest first, the sample @p i has been taken
+ *          <tt>(samples - 1 - i) * period</tt> microseconds before
+ *          @p time.
+ */
+typedef struct {
+  /**
+   * @brief   Number of samples in the batch.
+   */
+  size_t                    samples;
+  /**
+   * @brief   System time of the most recent sample.
+   */
+  systime_t                 time;
+  /**
+   * @brief   Sampling period in microseconds.
+   */
+  uint32_t                  period;
+  /**
+   * @brief   Samples have been lost since the previous read.
+   */
+  bool                      overrun;
+} sensor_fifo_batch_t;
+
 /**
  * @brief   BaseSensor specific methods.
  */
@@ -134,6 +167,30 @@ typedef struct {
 #define sensorReadCooked(ip, dp) (ip)->vmt->read_cooked(ip, dp)
 /** @} */
 
+/**
+ * @name    Fixed point conversion macros
+ * @{
+ */
+/**
+ * @brief   Float to Q16.16 conversion.
+ *
+ * @param[in] f         the value to be converted
+ * @return              The Q16.16 value, rounded to nearest.
+ */
+#define SENSOR_FLOAT2Q(f)                                                   \
+  ((int32_t)(((f) * (float)(1 << SENSOR_Q_SHIFT)) +                         \
+             (((f) < 0.0f) ? -0.5f : 0.5f)))
+
+/**
+ * @brief   Q16.16 to float conversion.
+ *
+ * @param[in] q         the value to be converted
+ * @return              The float value.
+ */
+#define SENSOR_Q2FLOAT(q)                                                   \
+  ((float)(q) * (1.0f / (float)(1 << SENSOR_Q_SHIFT)))
+/** @} */
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -146,6 +203,93 @@ extern "C" {
 }
 #endif
 
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Converts a block of raw samples to cooked data.
+ * @details Each element is converted using the formula
+ *          cooked = (raw * sensitivity) - bias, sensitivities and biases
+ *          are indexed by axis.
+ *
+ * @param[in] raw       raw samples, @p samples groups of @p axes elements
+ * @param[out] cooked   cooked samples, same layout of @p raw
+ * @param[in] samples   number of samples
+ * @param[in] axes      number of axes of each sample
+ * @param[in] sensitivity per axis sensitivities
+ * @param[in] bias      per axis biases
+ *
+ * @api
+ */
+static inline void sensorCookBlock(const int32_t raw[], float cooked[],
+                                   size_t samples, size_t axes,
+                                   const float sensitivity[],
+                                   const float bias[]) {
+  size_t i, j;
+
+  for (i = 0U; i < samples; i++) {
+    for (j = 0U; j < axes; j++) {
+      cooked[j] = ((float)raw[j] * sensitivity[j]) - bias[j];
+    }
+    raw    += axes;
+    cooked += axes;
+  }
+}
+
+/**
+ * @brief   Converts a block of raw samples to Q16.16 cooked data.
+ * @details Same as @p sensorCookBlock() using integer arithmetic only,
+ *          suitable for cores without FPU or for the hot path of fusion
+ *          algorithms working in fixed point.
+ * @note    The cooked values must be within the Q16.16 range, the result
+ *          is not saturated.
+ *
+ * @param[in] raw       raw samples, @p samples groups of @p axes elements
+ * @param[out] cooked   Q16.16 cooked samples, same layout of @p raw, it
+ *                      can be the same buffer
+ * @param[in] samples   number of samples
+ * @param[in] axes      number of axes of each sample
+ * @param[in] sensitivity per axis Q16.16 sensitivities
+ * @param[in] bias      per axis Q16.16 biases
+ *
+ * @api
+ */
+static inline void sensorCookBlockQ(const int32_t raw[], int32_t cooked[],
+                                    size_t samples, size_t axes,
+                                    const int32_t sensitivity[],
+                                    const int32_t bias[]) {
+  size_t i, j;
+
+  for (i = 0U; i < samples; i++) {
+    for (j = 0U; j < axes; j++) {
+      cooked[j] = (raw[j] * sensitivity[j]) - bias[j];
+    }
+    raw    += axes;
+    cooked += axes;
+  }
+}
+
+/**
+ * @brief   Converts a float vector to Q16.16.
+ * @details Used to prepare the fixed point sensitivities and biases from
+ *          the driver float calibration data, it is meant to be invoked
+ *          after each calibration change, not per sample.
+ *
+ * @param[in] f         float values
+ * @param[out] q        Q16.16 values
+ * @param[in] n         number of elements
+ *
+ * @api
+ */
+static inline void sensorFloatToQ(const float f[], int32_t q[], size_t n) {
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    q[i] = SENSOR_FLOAT2Q(f[i]);
+  }
+}
+
 #endif /* HAL_SENSORS_H */
 
 /** @} */
@@ -0,0 +1,323 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    chainstreams.c
+ * @brief   Chained memory streams code.
+ *
+ * @addtogroup chain_streams
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "chainstreams.h"
+
+#if (CH_CFG_USE_MEMPOOLS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Data area of a segment.
+ */
+#define SEG_DATA(sp)        ((uint8_t *)(sp) + sizeof (cs_segment_t))
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns a segment with free space at the end of the chain.
+ *
+ * @param[in] csp       pointer to the @p ChainStream object
+ * @return              The pointer to the tail segment.
+ * @retval NULL         if the tail is full and the pool is empty.
+ */
+static cs_segment_t *get_tail(ChainStream *csp) {
+  size_t capacity = csp->mp->object_size - sizeof (cs_segment_t);
+  cs_segment_t *sp = csp->tail;
+
+  if ((sp != NULL) && (sp->n < capacity)) {
+    return sp;
+  }
+
+  sp = chPoolAlloc(csp->mp);
+  if (sp == NULL) {
+    return NULL;
+  }
+  sp->next = NULL;
+  sp->n    = (size_t)0;
+  if (csp->tail == NULL) {
+    csp->head  = sp;
+    csp->rdseg = sp;
+  }
+  else {
+    csp->tail->next = sp;
+  }
+  csp->tail = sp;
+
+  return sp;
+}
+
+static size_t _writes(void *ip, const uint8_t *bp, size_t n) {
+  ChainStream *csp = ip;
+  size_t capacity = csp->mp->object_size - sizeof (cs_segment_t);
+  size_t done = (size_t)0;
+
+  while (done < n) {
+    cs_segment_t *sp = get_tail(csp);
+    size_t chunk;
+
+    if (sp == NULL) {
+      break;
+    }
+    chunk = capacity - sp->n;
+    if (chunk > n - done) {
+      chunk = n - done;
+    }
+    memcpy(SEG_DATA(sp) + sp->n, bp + done, chunk);
+    sp->n    += chunk;
+    csp->eos += chunk;
+    done     += chunk;
+  }
+
+  return done;
+}
+
+static size_t _reads(void *ip, uint8_t *bp, size_t n) {
+  ChainStream *csp = ip;
+  size_t done = (size_t)0;
+
+  while ((done < n) && (csp->rdseg != NULL)) {
+    cs_segment_t *sp = csp->rdseg;
+    size_t chunk = sp->n - csp->rdoff;
+
+    if (chunk > n - done) {
+      chunk = n - done;
+    }
+    memcpy(bp + done, SEG_DATA(sp) + csp->rdoff, chunk);
+    csp->rdoff += chunk;
+    done       += chunk;
+
+    /* Moving to the next segment only if there is one, the tail segment
+       could be written again.*/
+    if ((csp->rdoff >= sp->n) && (sp->next != NULL)) {
+      csp->rdseg = sp->next;
+      csp->rdoff = (size_t)0;
+    }
+    else if (chunk == (size_t)0) {
+      break;
+    }
+  }
+
+  return done;
+}
+
+static msg_t _put(void *ip, uint8_t b) {
+
+  if (_writes(ip, &b, (size_t)1) == (size_t)0) {
+    return MSG_RESET;
+  }
+
+  return MSG_OK;
+}
+
+static msg_t _get(void *ip) {
+  uint8_t b;
+
+  if (_reads(ip, &b, (size_t)1) == (size_t)0) {
+    return MSG_RESET;
+  }
+
+  return b;
+}
+
+static const uint8_t *_getrbuf(void *ip, size_t *np) {
+  ChainStream *csp = ip;
+  cs_segment_t *sp = csp->rdseg;
+
+  /* Skipping a fully read segment if there is a next one.*/
+  if ((sp != NULL) && (csp->rdoff >= sp->n) && (sp->next != NULL)) {
+    sp = sp->next;
+    csp->rdseg = sp;
+    csp->rdoff = (size_t)0;
+  }
+
+  if ((sp == NULL) || (csp->rdoff >= sp->n)) {
+    *np = (size_t)0;
+    return NULL;
+  }
+
+  /* The unread part of the current segment is exposed in place.*/
+  *np = sp->n - csp->rdoff;
+  return SEG_DATA(sp) + csp->rdoff;
+}
+
+static void _relrbuf(void *ip, size_t n) {
+  ChainStream *csp = ip;
+  cs_segment_t *sp = csp->rdseg;
+
+  if (n == (size_t)0) {
+    return;
+  }
+
+  osalDbgAssert((sp != NULL) && (n <= sp->n - csp->rdoff), "out of bounds");
+
+  csp->rdoff += n;
+  if ((csp->rdoff >= sp->n) && (sp->next != NULL)) {
+    csp->rdseg = sp->next;
+    csp->rdoff = (size_t)0;
+  }
+}
+
+static const struct ChainStreamVMT vmt = {
+  (size_t)0, _writes, _reads, _put, _get,
+  streamDefaultWriteV, _getrbuf, _relrbuf
+};
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Chained memory stream object initialization.
+ * @details The stream data is stored in a list of segments allocated from a
+ *          memory pool as the stream grows, each pool object holds a
+ *          @p cs_segment_t header followed by the segment data.
+ * @pre     The pool objects must be larger than a @p cs_segment_t
+ *          structure.
+ *
+ * @param[out] csp      pointer to the @p ChainStream object to be initialized
+ * @param[in] mp        pointer to the segments pool
+ *
+ * @init
+ */
+void csObjectInit(ChainStream *csp, memory_pool_t *mp) {
+
+  osalDbgCheck((csp != NULL) && (mp != NULL) &&
+               (mp->object_size > sizeof (cs_segment_t)));
+
+  csp->vmt   = &vmt;
+  csp->mp    = mp;
+  csp->head  = NULL;
+  csp->tail  = NULL;
+  csp->eos   = (size_t)0;
+  csp->rdseg = NULL;
+  csp->rdoff = (size_t)0;
+}
+
+/**
+ * @brief   Empties the stream.
+ * @details All the segments are returned to the pool.
+ *
+ * @param[in] csp       pointer to the @p ChainStream object
+ *
+ * @api
+ */
+void csReset(ChainStream *csp) {
+  cs_segment_t *sp;
+
+  osalDbgCheck(csp != NULL);
+
+  sp = csp->head;
+  while (sp != NULL) {
+    cs_segment_t *next = sp->next;
+
+    chPoolFree(csp->mp, sp);
+    sp = next;
+  }
+  csp->head  = NULL;
+  csp->tail  = NULL;
+  csp->eos   = (size_t)0;
+  csp->rdseg = NULL;
+  csp->rdoff = (size_t)0;
+}
+
+/**
+ * @brief   Describes the stream data as an array of segments.
+ * @details The array can be passed to scatter-gather writers or used to
+ *          feed a driver segment by segment, the data is not copied.
+ * @note    The segments remain valid until @p csReset() is invoked.
+ *
+ * @param[in] csp       pointer to the @p ChainStream object
+ * @param[out] sgp      pointer to an array of @p n segments
+ * @param[in] n         the maximum number of segments
+ * @return              The number of segments filled in the array.
+ *
+ * @api
+ */
+size_t csGetSegments(ChainStream *csp, bqsegment_t *sgp, size_t n) {
+  cs_segment_t *sp;
+  size_t k = (size_t)0;
+
+  osalDbgCheck((csp != NULL) && (sgp != NULL));
+
+  sp = csp->head;
+  while ((sp != NULL) && (k < n)) {
+    if (sp->n > (size_t)0) {
+      sgp[k].buf  = SEG_DATA(sp);
+      sgp[k].size = sp->n;
+      k++;
+    }
+    sp = sp->next;
+  }
+
+  return k;
+}
+
+/**
+ * @brief   Writes the stream data on another stream.
+ * @details The data is written a segment at time directly from the
+ *          segments buffers, no intermediate copy is performed.
+ *
+ * @param[in] csp       pointer to the @p ChainStream object
+ * @param[in] chp       pointer to the destination @p BaseSequentialStream
+ * @return              The number of bytes written.
+ *
+ * @api
+ */
+size_t csWriteToStream(ChainStream *csp, BaseSequentialStream *chp) {
+  cs_segment_t *sp;
+  size_t total = (size_t)0;
+
+  osalDbgCheck((csp != NULL) && (chp != NULL));
+
+  for (sp = csp->head; sp != NULL; sp = sp->next) {
+    size_t n = streamWrite(chp, SEG_DATA(sp), sp->n);
+
+    total += n;
+    if (n < sp->n) {
+      break;
+    }
+  }
+
+  return total;
+}
+
+#endif /* CH_CFG_USE_MEMPOOLS == TRUE */
+
+/** @} */
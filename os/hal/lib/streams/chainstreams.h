@@ -0,0 +1,131 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    chainstreams.h
+ * @brief   Chained memory streams structures and macros.
+ *
+ * @addtogroup chain_streams
+ * @{
+ */
+
+#ifndef CHAINSTREAMS_H
+#define CHAINSTREAMS_H
+
+#if (CH_CFG_USE_MEMPOOLS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Header of a chained stream segment.
+ * @details The header is placed at the start of each pool object, the data
+ *          area follows.
+ */
+typedef struct cs_segment {
+  /**
+   * @brief   Next segment in the chain.
+   */
+  struct cs_segment     *next;
+  /**
+   * @brief   Used bytes in the segment data area.
+   */
+  size_t                n;
+} cs_segment_t;
+
+/**
+ * @brief   @p ChainStream specific data.
+ */
+#define _chain_stream_data                                                  \
+  _base_sequential_stream_data                                              \
+  /* Pool of the segments.*/                                                \
+  memory_pool_t         *mp;                                                \
+  /* First segment of the chain.*/                                          \
+  cs_segment_t          *head;                                              \
+  /* Last segment of the chain.*/                                           \
+  cs_segment_t          *tail;                                              \
+  /* Current end of stream.*/                                               \
+  size_t                eos;                                                \
+  /* Current read segment.*/                                                \
+  cs_segment_t          *rdseg;                                             \
+  /* Current read offset within the read segment.*/                         \
+  size_t                rdoff;
+
+/**
+ * @brief   @p ChainStream virtual methods table.
+ */
+struct ChainStreamVMT {
+  _base_sequential_stream_methods
+};
+
+/**
+ * @extends BaseSequentialStream
+ *
+ * @brief Chained memory stream object.
+ */
+typedef struct {
+  /** @brief Virtual Methods Table.*/
+  const struct ChainStreamVMT *vmt;
+  _chain_stream_data
+} ChainStream;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the number of bytes written in the stream.
+ *
+ * @param[in] csp       pointer to the @p ChainStream object
+ * @return              The stream size.
+ *
+ * @xclass
+ */
+#define csGetSizeX(csp) ((csp)->eos)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void csObjectInit(ChainStream *csp, memory_pool_t *mp);
+  void csReset(ChainStream *csp);
+  size_t csGetSegments(ChainStream *csp, bqsegment_t *sgp, size_t n);
+  size_t csWriteToStream(ChainStream *csp, BaseSequentialStream *chp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CH_CFG_USE_MEMPOOLS == TRUE */
+
+#endif /* CHAINSTREAMS_H */
+
+/** @} */
@@ -33,33 +33,140 @@
 
 #define MAX_FILLER 11
 #define FLOAT_PRECISION 9
+#define FIXED_Q15_PRECISION 5
+#define FIXED_Q31_PRECISION 9
 
-static char *long_to_string_with_divisor(char *p,
-                                         long num,
-                                         unsigned radix,
-                                         long divisor) {
+/**
+ * @brief   Output state of a formatted print operation.
+ */
+typedef struct {
+  /**
+   * @brief   Output stream.
+   */
+  BaseSequentialStream  *chp;
+#if (CHPRINTF_BUFFER_SIZE > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   Number of buffered bytes.
+   */
+  size_t                n;
+  /**
+   * @brief   Output buffer.
+   */
+  uint8_t               buf[CHPRINTF_BUFFER_SIZE];
+#endif
+} printf_out_t;
+
+static void out_flush(printf_out_t *op) {
+
+#if CHPRINTF_BUFFER_SIZE > 0
+  if (op->n > 0U) {
+    (void) streamWrite(op->chp, op->buf, op->n);
+    op->n = 0U;
+  }
+#else
+  (void)op;
+#endif
+}
+
+static void out_put(printf_out_t *op, uint8_t b) {
+
+#if CHPRINTF_BUFFER_SIZE > 0
+  op->buf[op->n++] = b;
+  if (op->n >= (size_t)CHPRINTF_BUFFER_SIZE) {
+    out_flush(op);
+  }
+#else
+  streamPut(op->chp, b);
+#endif
+}
+
+/* Decimal digit pairs, two characters are generated for each
+   multiplication by the reciprocal of 100.*/
+static const char digit_pairs[200] = {
+  '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+  '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+  '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+  '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+  '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+  '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+  '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+  '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+  '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+  '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
+};
+
+static const uint32_t pow10[FLOAT_PRECISION] = {
+    10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+/* Division by 100 as a multiplication by the reciprocal, exact for all the
+   32 bits values. Cores without an hardware divider (ARMv6-M) perform it
+   using a 32x32->64 multiply instead of a divide library call.*/
+static inline uint32_t div100(uint32_t n) {
+
+  return (uint32_t)(((uint64_t)n * 0x51EB851FU) >> 37);
+}
+
+/* Decimal conversion, at least mindigits digits are generated, the missing
+   ones are zeroes.*/
+static char *ch_utoa10(char *p, uint32_t num, unsigned mindigits) {
+  char *q;
+  int i;
+
+  q = p + MAX_FILLER;
+  while (num >= 100U) {
+    uint32_t d = div100(num);
+    const char *dp = &digit_pairs[(num - (d * 100U)) * 2U];
+
+    *--q = dp[1];
+    *--q = dp[0];
+    num = d;
+  }
+  if (num >= 10U) {
+    *--q = digit_pairs[(num * 2U) + 1U];
+    *--q = digit_pairs[num * 2U];
+  }
+  else
+    *--q = (char)('0' + num);
+
+  while ((p + MAX_FILLER - q) < (int)mindigits)
+    *--q = '0';
+
+  i = (int)(p + MAX_FILLER - q);
+  do
+    *p++ = *q++;
+  while (--i);
+
+  return p;
+}
+
+static char *ch_ltoa(char *p, unsigned long num, unsigned radix) {
+  unsigned shift;
   int i;
   char *q;
-  long l, ll;
 
-  l = num;
-  if (divisor == 0) {
-    ll = num;
-  } else {
-    ll = divisor;
+  if (radix == 10U) {
+    /* Parts with 64 bits longs divide down to 32 bits first.*/
+    if (((num >> 16) >> 16) != 0U) {
+      p = ch_ltoa(p, num / 1000000000UL, 10U);
+      return ch_utoa10(p, (uint32_t)(num % 1000000000UL), 9U);
+    }
+    return ch_utoa10(p, (uint32_t)num, 1U);
   }
 
-  q = p + MAX_FILLER;
+  /* Power of two radixes, digits are extracted by shifting.*/
+  shift = radix == 16U ? 4U : 3U;
+  q = p + 2 * MAX_FILLER;
   do {
-    i = (int)(l % radix);
+    i = (int)(num & (unsigned long)(radix - 1U));
     i += '0';
     if (i > '9')
       i += 'A' - '0' - 10;
     *--q = i;
-    l /= radix;
-  } while ((ll /= radix) != 0);
+    num >>= shift;
+  } while (num != 0U);
 
-  i = (int)(p + MAX_FILLER - q);
+  i = (int)(p + 2 * MAX_FILLER - q);
   do
     *p++ = *q++;
   while (--i);
@@ -67,28 +174,33 @@ static char *long_to_string_with_divisor(char *p,
   return p;
 }
 
-static char *ch_ltoa(char *p, long num, unsigned radix) {
+/* Fixed point conversion, the fraction digits are computed without
+   divisions by scaling the fractional bits.*/
+static char *qtoa(char *p, uint32_t num, unsigned fbits,
+                  unsigned long precision) {
+  uint32_t mask = ((uint32_t)1U << fbits) - 1U;
 
-  return long_to_string_with_divisor(p, num, radix, 0);
+  p = ch_utoa10(p, num >> fbits, 1U);
+  *p++ = '.';
+  return ch_utoa10(p, (uint32_t)(((uint64_t)(num & mask) *
+                                  pow10[precision - 1U]) >> fbits),
+                   (unsigned)precision);
 }
 
 #if CHPRINTF_USE_FLOAT
-static const long pow10[FLOAT_PRECISION] = {
-    10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
-};
-
-static char *ftoa(char *p, double num, unsigned long precision) {
-  long l;
+/* Single precision conversion, no double precision operations are
+   involved.*/
+static char *ftoa(char *p, float num, unsigned long precision) {
+  uint32_t l;
 
   if ((precision == 0) || (precision > FLOAT_PRECISION))
     precision = FLOAT_PRECISION;
-  precision = pow10[precision - 1];
 
-  l = (long)num;
-  p = long_to_string_with_divisor(p, l, 10, 0);
+  l = (uint32_t)num;
+  p = ch_utoa10(p, l, 1U);
   *p++ = '.';
-  l = (long)((num - l) * precision);
-  return long_to_string_with_divisor(p, l, 10, precision / 10);
+  l = (uint32_t)((num - (float)l) * (float)pow10[precision - 1]);
+  return ch_utoa10(p, l, (unsigned)precision);
 }
 #endif
 
@@ -106,6 +218,9 @@ static char *ftoa(char *p, double num, unsigned long precision) {
  *          - <b>D</b> decimal signed long.
  *          - <b>u</b> decimal unsigned integer.
  *          - <b>U</b> decimal unsigned long.
+ *          - <b>q</b> Q15 fixed point integer.
+ *          - <b>Q</b> Q31 fixed point long.
+ *          - <b>f</b> single precision float, if enabled.
  *          - <b>c</b> character.
  *          - <b>s</b> string.
  *          .
@@ -126,17 +241,23 @@ int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
   long l;
 #if CHPRINTF_USE_FLOAT
   float f;
+#endif
   char tmpbuf[2*MAX_FILLER + 1];
-#else
-  char tmpbuf[MAX_FILLER + 1];
+  printf_out_t out;
+
+  out.chp = chp;
+#if CHPRINTF_BUFFER_SIZE > 0
+  out.n   = 0U;
 #endif
 
   while (true) {
     c = *fmt++;
-    if (c == 0)
+    if (c == 0) {
+      out_flush(&out);
       return n;
+    }
     if (c != '%') {
-      streamPut(chp, (uint8_t)c);
+      out_put(&out, (uint8_t)c);
       n++;
       continue;
     }
@@ -211,9 +332,31 @@ int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
         l = va_arg(ap, int);
       if (l < 0) {
         *p++ = '-';
-        l = -l;
+        p = ch_ltoa(p, 0UL - (unsigned long)l, 10);
       }
-      p = ch_ltoa(p, l, 10);
+      else
+        p = ch_ltoa(p, (unsigned long)l, 10);
+      break;
+    case 'Q':
+    case 'q':
+      if (is_long) {
+        l = (long)(int32_t)va_arg(ap, long);
+        c = 31;
+        if ((precision == 0) || (precision > FLOAT_PRECISION))
+          precision = FIXED_Q31_PRECISION;
+      }
+      else {
+        l = va_arg(ap, int);
+        c = 15;
+        if ((precision == 0) || (precision > FLOAT_PRECISION))
+          precision = FIXED_Q15_PRECISION;
+      }
+      if (l < 0) {
+        *p++ = '-';
+        p = qtoa(p, 0U - (uint32_t)l, (unsigned)c, (unsigned long)precision);
+      }
+      else
+        p = qtoa(p, (uint32_t)l, (unsigned)c, (unsigned long)precision);
       break;
 #if CHPRINTF_USE_FLOAT
     case 'f':
@@ -254,22 +397,22 @@ unsigned_common:
       width = -width;
     if (width < 0) {
       if (*s == '-' && filler == '0') {
-        streamPut(chp, (uint8_t)*s++);
+        out_put(&out, (uint8_t)*s++);
         n++;
         i--;
       }
       do {
-        streamPut(chp, (uint8_t)filler);
+        out_put(&out, (uint8_t)filler);
         n++;
       } while (++width != 0);
     }
     while (--i >= 0) {
-      streamPut(chp, (uint8_t)*s++);
+      out_put(&out, (uint8_t)*s++);
       n++;
     }
 
     while (width) {
-      streamPut(chp, (uint8_t)filler);
+      out_put(&out, (uint8_t)filler);
       n++;
       width--;
     }
@@ -290,6 +433,9 @@ unsigned_common:
  *          - <b>D</b> decimal signed long.
  *          - <b>u</b> decimal unsigned integer.
  *          - <b>U</b> decimal unsigned long.
+ *          - <b>q</b> Q15 fixed point integer.
+ *          - <b>Q</b> Q31 fixed point long.
+ *          - <b>f</b> single precision float, if enabled.
  *          - <b>c</b> character.
  *          - <b>s</b> string.
  *          .
@@ -323,6 +469,9 @@ int chprintf(BaseSequentialStream *chp, const char *fmt, ...) {
  *          - <b>D</b> decimal signed long.
  *          - <b>u</b> decimal unsigned integer.
  *          - <b>U</b> decimal unsigned long.
+ *          - <b>q</b> Q15 fixed point integer.
+ *          - <b>Q</b> Q31 fixed point long.
+ *          - <b>f</b> single precision float, if enabled.
  *          - <b>c</b> character.
  *          - <b>s</b> string.
  *          .
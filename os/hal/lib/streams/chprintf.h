@@ -34,6 +34,17 @@
 #define CHPRINTF_USE_FLOAT          FALSE
 #endif
 
+/**
+ * @brief   Output buffer size.
+ * @details If greater than zero the formatted output is accumulated in a
+ *          buffer allocated on the stack and written to the stream in blocks
+ *          instead of one character at time.
+ * @note    The default is zero, no buffering.
+ */
+#if !defined(CHPRINTF_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define CHPRINTF_BUFFER_SIZE        0
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
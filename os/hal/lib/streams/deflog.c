@@ -0,0 +1,385 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    deflog.c
+ * @brief   Deferred logging code.
+ *
+ * @addtogroup deflog
+ * @{
+ */
+
+#include "hal.h"
+#include "chprintf.h"
+#include "deflog.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Buffer index mask.
+ */
+#define BUFFER_MASK                 ((size_t)DLOG_BUFFER_SIZE - 1U)
+
+/**
+ * @brief   Maximum size of an unencoded binary frame.
+ */
+#define FRAME_MAX_SIZE              ((DLOG_HEADER_SIZE + 1U +                 \
+                                      (size_t)DLOG_MAX_ARGS) *              \
+                                     ((sizeof (dlogarg_t) * 8U + 6U) / 7U))
+
+/**
+ * @brief   Maximum size of a single conversion specification.
+ */
+#define SPEC_MAX_SIZE               24U
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Deferred log state.
+ */
+static struct {
+  size_t                wridx;
+  size_t                rdidx;
+  uint32_t              seq;
+  uint32_t              lost;
+  dlogarg_t             buffer[DLOG_BUFFER_SIZE];
+} dlog;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static size_t put_varint(uint8_t *bp, size_t i, uintptr_t v) {
+
+  while (v >= 0x80U) {
+    bp[i++] = (uint8_t)(v | 0x80U);
+    v >>= 7;
+  }
+  bp[i++] = (uint8_t)v;
+
+  return i;
+}
+
+/**
+ * @brief   Appends an unsigned decimal number to a specification.
+ */
+static size_t put_decimal(char *sp, size_t i, unsigned v) {
+  char tmp[10];
+  size_t n = 0U;
+
+  do {
+    tmp[n++] = (char)('0' + (v % 10U));
+    v /= 10U;
+  } while ((v > 0U) && (n < sizeof tmp));
+
+  while ((n > 0U) && (i < (SPEC_MAX_SIZE - 2U))) {
+    sp[i++] = tmp[--n];
+  }
+
+  return i;
+}
+
+/**
+ * @brief   Returns the next argument of a record.
+ * @note    Missing arguments are replaced by zero.
+ */
+static dlogarg_t next_arg(const dlog_record_t *rp, unsigned *ip) {
+
+  if (*ip < rp->n) {
+    return rp->args[(*ip)++];
+  }
+
+  return (dlogarg_t)0;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Deferred log initialization.
+ * @note    Records written before initialization are lost.
+ *
+ * @init
+ */
+void dlogInit(void) {
+
+  dlog.wridx = 0U;
+  dlog.rdidx = 0U;
+  dlog.seq   = 0U;
+  dlog.lost  = 0U;
+}
+
+/**
+ * @brief   Writes a log record.
+ * @details The record is copied in the buffer within a short critical
+ *          zone, if there is not enough space then the record is dropped
+ *          and counted as lost.
+ * @note    Use the @p dlogPrintf() macro instead of invoking this function
+ *          directly.
+ *
+ * @param[in] fmt       format string
+ * @param[in] n         number of arguments
+ * @param[in] argv      pointer to the arguments array
+ *
+ * @xclass
+ */
+void dlogWriteX(const char *fmt, unsigned n, const dlogarg_t *argv) {
+  syssts_t sts;
+  systime_t now;
+  unsigned i;
+
+  osalDbgCheck((fmt != NULL) && (n <= (unsigned)DLOG_MAX_ARGS) &&
+               ((n == 0U) || (argv != NULL)));
+
+  now = osalOsGetSystemTimeX();
+
+  sts = osalSysGetStatusAndLockX();
+  if (((size_t)DLOG_BUFFER_SIZE - (dlog.wridx - dlog.rdidx)) <
+      ((size_t)DLOG_HEADER_SIZE + (size_t)n)) {
+    dlog.seq++;
+    dlog.lost++;
+  }
+  else {
+    size_t wr = dlog.wridx;
+
+    dlog.buffer[wr++ & BUFFER_MASK] = (dlogarg_t)fmt;
+    dlog.buffer[wr++ & BUFFER_MASK] = ((dlogarg_t)dlog.seq++ << 8) |
+                                      (dlogarg_t)n;
+    dlog.buffer[wr++ & BUFFER_MASK] = (dlogarg_t)now;
+    for (i = 0U; i < n; i++) {
+      dlog.buffer[wr++ & BUFFER_MASK] = argv[i];
+    }
+    dlog.wridx = wr;
+  }
+  osalSysRestoreStatusX(sts);
+}
+
+/**
+ * @brief   Fetches the next log record.
+ * @note    A single consumer is supported.
+ *
+ * @param[out] rp       pointer to the record to be filled
+ * @return              The operation status.
+ * @retval false        if the buffer is empty.
+ * @retval true         if a record has been fetched.
+ *
+ * @api
+ */
+bool dlogFetchNext(dlog_record_t *rp) {
+  size_t rd;
+  dlogarg_t hdr;
+  unsigned i;
+
+  osalDbgCheck(rp != NULL);
+
+  osalSysLock();
+  if (dlog.rdidx == dlog.wridx) {
+    osalSysUnlock();
+    return false;
+  }
+  rd       = dlog.rdidx;
+  rp->fmt  = (const char *)dlog.buffer[rd++ & BUFFER_MASK];
+  hdr      = dlog.buffer[rd++ & BUFFER_MASK];
+  rp->time = (systime_t)dlog.buffer[rd++ & BUFFER_MASK];
+  rp->seq  = (uint32_t)(hdr >> 8);
+  rp->n    = (unsigned)(hdr & 0xFFU);
+  for (i = 0U; i < rp->n; i++) {
+    rp->args[i] = dlog.buffer[rd++ & BUFFER_MASK];
+  }
+  dlog.rdidx = rd;
+  osalSysUnlock();
+
+  return true;
+}
+
+/**
+ * @brief   Formats the next log record on a stream.
+ * @details The record is formatted using @p chprintf(), one conversion
+ *          at time.
+ *
+ * @param[in] chp       pointer to a @p BaseSequentialStream object
+ * @return              The operation status.
+ * @retval false        if the buffer is empty.
+ * @retval true         if a record has been printed.
+ *
+ * @api
+ */
+bool dlogPrintNext(BaseSequentialStream *chp) {
+  dlog_record_t r;
+  const char *fmt;
+  unsigned ai = 0U;
+
+  osalDbgCheck(chp != NULL);
+
+  if (!dlogFetchNext(&r)) {
+    return false;
+  }
+
+  fmt = r.fmt;
+  while (*fmt != '\0') {
+    char spec[SPEC_MAX_SIZE];
+    size_t i;
+    char c;
+
+    if (*fmt != '%') {
+      streamPut(chp, (uint8_t)*fmt++);
+      continue;
+    }
+
+    /* Collecting flags, width, precision and modifier, the arguments
+       of "*" are expanded in the specification.*/
+    i = 0U;
+    spec[i++] = *fmt++;
+    while ((*fmt != '\0') && (i < (SPEC_MAX_SIZE - 2U)) &&
+           ((*fmt == '-') || (*fmt == '.') || (*fmt == 'l') ||
+            (*fmt == 'L') || (*fmt == '*') ||
+            ((*fmt >= '0') && (*fmt <= '9')))) {
+      if (*fmt == '*') {
+        i = put_decimal(spec, i, (unsigned)next_arg(&r, &ai));
+        fmt++;
+      }
+      else {
+        spec[i++] = *fmt++;
+      }
+    }
+    c = *fmt;
+    if (c == '\0') {
+      break;
+    }
+    fmt++;
+    spec[i++] = c;
+    spec[i]   = '\0';
+
+    switch (c) {
+    case 's':
+      (void) chprintf(chp, spec, (const char *)next_arg(&r, &ai));
+      break;
+    case 'c':
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'x':
+    case 'o':
+    case 'q':
+      if ((spec[i - 2U] != 'l') && (spec[i - 2U] != 'L')) {
+        (void) chprintf(chp, spec, (int)next_arg(&r, &ai));
+        break;
+      }
+      /* Falls through.*/
+    case 'D':
+    case 'I':
+    case 'U':
+    case 'X':
+    case 'O':
+    case 'Q':
+      (void) chprintf(chp, spec, (long)next_arg(&r, &ai));
+      break;
+    default:
+      /* Not a conversion, printed as is.*/
+      (void) chprintf(chp, spec);
+      break;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief   Sends the next log record on a stream in binary form.
+ * @details The record is sent as a COBS-encoded frame terminated by a
+ *          zero byte, the frame contains the sequence number, the format
+ *          string pointer, the system time, the number of arguments and
+ *          the arguments as variable length integers. Strings are
+ *          resolved on the host using the firmware ELF file.
+ *
+ * @param[in] chp       pointer to a @p BaseSequentialStream object
+ * @return              The operation status.
+ * @retval false        if the buffer is empty.
+ * @retval true         if a record has been sent.
+ *
+ * @api
+ */
+bool dlogSendNext(BaseSequentialStream *chp) {
+  dlog_record_t r;
+  uint8_t raw[FRAME_MAX_SIZE];
+  uint8_t enc[FRAME_MAX_SIZE + 2U];
+  size_t i, n, code_idx, wr;
+  uint8_t code;
+
+  osalDbgCheck(chp != NULL);
+
+  if (!dlogFetchNext(&r)) {
+    return false;
+  }
+
+  n = put_varint(raw, 0U, (uintptr_t)r.seq);
+  n = put_varint(raw, n, (uintptr_t)r.fmt);
+  n = put_varint(raw, n, (uintptr_t)r.time);
+  n = put_varint(raw, n, (uintptr_t)r.n);
+  for (i = 0U; i < r.n; i++) {
+    n = put_varint(raw, n, (uintptr_t)r.args[i]);
+  }
+
+  /* COBS encoding, frames are shorter than 254 bytes.*/
+  wr       = 0U;
+  code_idx = wr++;
+  code     = 1U;
+  for (i = 0U; i < n; i++) {
+    if (raw[i] == 0U) {
+      enc[code_idx] = code;
+      code_idx = wr++;
+      code     = 1U;
+    }
+    else {
+      enc[wr++] = raw[i];
+      code++;
+    }
+  }
+  enc[code_idx] = code;
+  enc[wr++] = 0U;
+
+  (void) streamWrite(chp, enc, wr);
+
+  return true;
+}
+
+/**
+ * @brief   Returns the number of records dropped because the buffer was
+ *          full.
+ *
+ * @return              The number of dropped records.
+ *
+ * @xclass
+ */
+uint32_t dlogGetLostX(void) {
+
+  return dlog.lost;
+}
+
+/** @} */
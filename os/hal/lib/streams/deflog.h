@@ -0,0 +1,188 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    deflog.h
+ * @brief   Deferred logging macros and structures.
+ *
+ * @addtogroup deflog
+ * @{
+ */
+
+#ifndef DEFLOG_H
+#define DEFLOG_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of words in a record header.
+ */
+#define DLOG_HEADER_SIZE            3U
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of the records buffer in words.
+ * @note    Must be a power of two.
+ */
+#if !defined(DLOG_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define DLOG_BUFFER_SIZE            256
+#endif
+
+/**
+ * @brief   Maximum number of arguments of a log record.
+ * @note    The @p dlogPrintf() macro supports up to 6 arguments.
+ */
+#if !defined(DLOG_MAX_ARGS) || defined(__DOXYGEN__)
+#define DLOG_MAX_ARGS               6
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (DLOG_BUFFER_SIZE & (DLOG_BUFFER_SIZE - 1)) != 0
+#error "DLOG_BUFFER_SIZE is not a power of two"
+#endif
+
+#if (DLOG_MAX_ARGS < 0) || (DLOG_MAX_ARGS > 6)
+#error "invalid DLOG_MAX_ARGS value"
+#endif
+
+#if DLOG_BUFFER_SIZE < (2 * (DLOG_HEADER_SIZE + DLOG_MAX_ARGS))
+#error "DLOG_BUFFER_SIZE too small"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a log record argument.
+ */
+typedef uintptr_t dlogarg_t;
+
+/**
+ * @brief   Type of a fetched log record.
+ */
+typedef struct {
+  /**
+   * @brief   Format string.
+   */
+  const char            *fmt;
+  /**
+   * @brief   Record sequence number.
+   * @note    Numbers are assigned also to dropped records, only the
+   *          lower 24 bits are kept.
+   */
+  uint32_t              seq;
+  /**
+   * @brief   System time of the record.
+   */
+  systime_t             time;
+  /**
+   * @brief   Number of arguments.
+   */
+  unsigned              n;
+  /**
+   * @brief   Arguments.
+   */
+  dlogarg_t             args[DLOG_MAX_ARGS];
+} dlog_record_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @cond INTERNAL
+ */
+#define _DLOG_A(x)                  ((dlogarg_t)(x))
+#define _DLOG_CAT(a, b)             _DLOG_CAT_(a, b)
+#define _DLOG_CAT_(a, b)            a##b
+#define _DLOG_NARGS(...)            _DLOG_NARGS_(__VA_ARGS__, 7, 6, 5, 4,   \
+                                                 3, 2, 1, 0)
+#define _DLOG_NARGS_(_1, _2, _3, _4, _5, _6, _7, n, ...) n
+#define _DLOG_CALL1(fmt)                                                    \
+  dlogWriteX(fmt, 0U, NULL)
+#define _DLOG_CALL2(fmt, a)                                                 \
+  dlogWriteX(fmt, 1U, (const dlogarg_t []){_DLOG_A(a)})
+#define _DLOG_CALL3(fmt, a, b)                                              \
+  dlogWriteX(fmt, 2U, (const dlogarg_t []){_DLOG_A(a), _DLOG_A(b)})
+#define _DLOG_CALL4(fmt, a, b, c)                                           \
+  dlogWriteX(fmt, 3U, (const dlogarg_t []){_DLOG_A(a), _DLOG_A(b),          \
+                                           _DLOG_A(c)})
+#define _DLOG_CALL5(fmt, a, b, c, d)                                        \
+  dlogWriteX(fmt, 4U, (const dlogarg_t []){_DLOG_A(a), _DLOG_A(b),          \
+                                           _DLOG_A(c), _DLOG_A(d)})
+#define _DLOG_CALL6(fmt, a, b, c, d, e)                                     \
+  dlogWriteX(fmt, 5U, (const dlogarg_t []){_DLOG_A(a), _DLOG_A(b),          \
+                                           _DLOG_A(c), _DLOG_A(d),          \
+                                           _DLOG_A(e)})
+#define _DLOG_CALL7(fmt, a, b, c, d, e, f)                                  \
+  dlogWriteX(fmt, 6U, (const dlogarg_t []){_DLOG_A(a), _DLOG_A(b),          \
+                                           _DLOG_A(c), _DLOG_A(d),          \
+                                           _DLOG_A(e), _DLOG_A(f)})
+/**
+ * @endcond
+ */
+
+/**
+ * @brief   Writes a deferred log record.
+ * @details The format string pointer and the arguments are stored in the
+ *          records buffer, formatting happens later in the context of the
+ *          thread invoking @p dlogPrintNext() or on the host.
+ * @note    The format is the one of @p chprintf(), floating point
+ *          arguments are not supported.
+ * @note    The format string and the strings passed as @p %s arguments
+ *          are accessed when the record is formatted, they must be
+ *          constant strings.
+ *
+ * @param[in] ...       format string followed by up to 6 arguments
+ *
+ * @xclass
+ */
+#define dlogPrintf(...)                                                     \
+  _DLOG_CAT(_DLOG_CALL, _DLOG_NARGS(__VA_ARGS__))(__VA_ARGS__)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void dlogInit(void);
+  void dlogWriteX(const char *fmt, unsigned n, const dlogarg_t *argv);
+  bool dlogFetchNext(dlog_record_t *rp);
+  bool dlogPrintNext(BaseSequentialStream *chp);
+  bool dlogSendNext(BaseSequentialStream *chp);
+  uint32_t dlogGetLostX(void);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* DEFLOG_H */
+
+/** @} */
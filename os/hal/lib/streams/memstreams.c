@@ -48,7 +48,7 @@ static size_t _writes(void *ip, const uint8_t *bp, size_t n) {
 
   if (msp->size - msp->eos < n)
     n = msp->size - msp->eos;
-  memcpy(msp->buffer + msp->eos, bp, n);
+  (void) MEMSTREAMS_MEMCPY(msp->buffer + msp->eos, bp, n);
   msp->eos += n;
   return n;
 }
@@ -58,7 +58,7 @@ static size_t _reads(void *ip, uint8_t *bp, size_t n) {
 
   if (msp->eos - msp->offset < n)
     n = msp->eos - msp->offset;
-  memcpy(bp, msp->buffer + msp->offset, n);
+  (void) MEMSTREAMS_MEMCPY(bp, msp->buffer + msp->offset, n);
   msp->offset += n;
   return n;
 }
@@ -84,7 +84,26 @@ static msg_t _get(void *ip) {
   return b;
 }
 
-static const struct MemStreamVMT vmt = {(size_t)0, _writes, _reads, _put, _get};
+static const uint8_t *_getrbuf(void *ip, size_t *np) {
+  MemoryStream *msp = ip;
+
+  *np = msp->eos - msp->offset;
+  if (*np == 0U)
+    return NULL;
+  return msp->buffer + msp->offset;
+}
+
+static void _relrbuf(void *ip, size_t n) {
+  MemoryStream *msp = ip;
+
+  osalDbgAssert(n <= msp->eos - msp->offset, "out of bounds");
+  msp->offset += n;
+}
+
+static const struct MemStreamVMT vmt = {
+  (size_t)0, _writes, _reads, _put, _get,
+  streamDefaultWriteV, _getrbuf, _relrbuf
+};
 
 /*===========================================================================*/
 /* Driver exported functions.                                                */
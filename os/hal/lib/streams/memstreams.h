@@ -33,6 +33,15 @@
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Memory copy function used by the streams.
+ * @details It can be redefined in order to use a copy engine, for example
+ *          @p dmaMemcpy() on STM32 devices.
+ */
+#if !defined(MEMSTREAMS_MEMCPY) || defined(__DOXYGEN__)
+#define MEMSTREAMS_MEMCPY(dst, src, n) memcpy(dst, src, n)
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -73,7 +73,11 @@ static msg_t get(void *ip) {
   return 4;
 }
 
-static const struct NullStreamVMT vmt = {(size_t)0, writes, reads, put, get};
+static const struct NullStreamVMT vmt = {
+  (size_t)0, writes, reads, put, get,
+  streamDefaultWriteV, streamDefaultGetReadBuffer,
+  streamDefaultReleaseReadBuffer
+};
 
 /*===========================================================================*/
 /* Driver exported functions.                                                */
@@ -1,7 +1,9 @@
 # RT Shell files.
 STREAMSSRC = $(CHIBIOS)/os/hal/lib/streams/chprintf.c \
              $(CHIBIOS)/os/hal/lib/streams/memstreams.c \
-             $(CHIBIOS)/os/hal/lib/streams/nullstreams.c
+             $(CHIBIOS)/os/hal/lib/streams/chainstreams.c \
+             $(CHIBIOS)/os/hal/lib/streams/nullstreams.c \
+             $(CHIBIOS)/os/hal/lib/streams/deflog.c
 
 STREAMSINC = $(CHIBIOS)/os/hal/lib/streams
 
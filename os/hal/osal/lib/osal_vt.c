@@ -32,6 +32,24 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+#if (OSAL_VT_USE_WHEEL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Slots index mask.
+ */
+#define WHEEL_MASK          ((systime_t)OSAL_VT_WHEEL_SLOTS - (systime_t)1)
+
+/**
+ * @brief   Number of wheel time bits below a level.
+ */
+#define WHEEL_SHIFT(k)      ((unsigned)(k) * OSAL_VT_WHEEL_BITS)
+
+/**
+ * @brief   Index of the current slot of a level.
+ */
+#define WHEEL_CURRENT(now, k)                                               \
+  ((unsigned)(((now) >> WHEEL_SHIFT(k)) & WHEEL_MASK))
+#endif /* OSAL_VT_USE_WHEEL == TRUE */
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -53,6 +71,115 @@ virtual_timers_list_t vtlist;
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (OSAL_VT_USE_WHEEL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Inserts a timer in the wheel according to its expiration time.
+ * @note    Timers farther than the wheel span are placed in the current
+ *          slot of the upper level, they are re-inserted when the slot is
+ *          processed after a full rotation.
+ *
+ * @param[in] vtp       the timer to be inserted
+ * @param[in] now       the current system time
+ */
+static void wheel_insert(virtual_timer_t *vtp, systime_t now) {
+  systime_t d = vtp->vt_expires - now;
+  unsigned k, idx;
+  vt_slot_t *sp;
+
+  k = 0U;
+  while ((k < ((unsigned)OSAL_VT_WHEEL_LEVELS - 1U)) &&
+         ((d >> WHEEL_SHIFT(k)) >= (systime_t)OSAL_VT_WHEEL_SLOTS)) {
+    k++;
+  }
+  if ((d >> WHEEL_SHIFT(k)) >= (systime_t)OSAL_VT_WHEEL_SLOTS) {
+    idx = WHEEL_CURRENT(now, k);
+  }
+  else {
+    idx = (unsigned)((vtp->vt_expires >> WHEEL_SHIFT(k)) & WHEEL_MASK);
+  }
+
+  /* Insertion at the end of the slot list.*/
+  sp = &vtlist.vt_slots[k][idx];
+  vtp->vt_next = (virtual_timer_t *)sp;
+  vtp->vt_prev = sp->vt_prev;
+  vtp->vt_prev->vt_next = vtp;
+  sp->vt_prev = vtp;
+  vtlist.vt_bitmap[k] |= (uint32_t)1U << idx;
+}
+
+/**
+ * @brief   Unlinks a timer from its wheel slot.
+ *
+ * @param[in] vtp       the timer to be removed
+ */
+static void wheel_remove(virtual_timer_t *vtp) {
+
+  if (vtp->vt_next == vtp->vt_prev) {
+    /* It is the only timer in the slot, the slot becomes empty, the
+       slot position is derived from the header address.*/
+    unsigned n = (unsigned)((vt_slot_t *)vtp->vt_next -
+                            &vtlist.vt_slots[0][0]);
+
+    vtlist.vt_bitmap[n / OSAL_VT_WHEEL_SLOTS] &=
+        ~((uint32_t)1U << (n % OSAL_VT_WHEEL_SLOTS));
+  }
+  vtp->vt_prev->vt_next = vtp->vt_next;
+  vtp->vt_next->vt_prev = vtp->vt_prev;
+}
+
+/**
+ * @brief   Processes the wheel at the current system time.
+ * @details Slots of upper levels reaching their processing time are
+ *          cascaded toward lower levels then all timers in the current
+ *          level zero slot are fired.
+ *
+ * @param[in] now       the current system time
+ */
+static void wheel_process(systime_t now) {
+  unsigned k;
+  vt_slot_t *sp;
+
+  /* Cascading upper levels.*/
+  for (k = (unsigned)OSAL_VT_WHEEL_LEVELS - 1U; k > 0U; k--) {
+    unsigned idx = WHEEL_CURRENT(now, k);
+
+    if (((now & ((((systime_t)1) << WHEEL_SHIFT(k)) - (systime_t)1)) ==
+         (systime_t)0) &&
+        ((vtlist.vt_bitmap[k] & ((uint32_t)1U << idx)) != 0U)) {
+      virtual_timer_t *vtp;
+
+      /* The slot is detached then its timers are re-inserted.*/
+      sp = &vtlist.vt_slots[k][idx];
+      vtp = sp->vt_next;
+      sp->vt_prev->vt_next = NULL;
+      sp->vt_next = (virtual_timer_t *)sp;
+      sp->vt_prev = (virtual_timer_t *)sp;
+      vtlist.vt_bitmap[k] &= ~((uint32_t)1U << idx);
+      while (vtp != NULL) {
+        virtual_timer_t *next = vtp->vt_next;
+
+        wheel_insert(vtp, now);
+        vtp = next;
+      }
+    }
+  }
+
+  /* Firing all timers in the current slot.*/
+  sp = &vtlist.vt_slots[0][WHEEL_CURRENT(now, 0U)];
+  while (sp->vt_next != (virtual_timer_t *)sp) {
+    virtual_timer_t *vtp = sp->vt_next;
+    vtfunc_t fn;
+
+    wheel_remove(vtp);
+    fn = vtp->vt_func;
+    vtp->vt_func = (vtfunc_t)NULL;
+    osalSysUnlockFromISR();
+    fn(vtp->vt_par);
+    osalSysLockFromISR();
+  }
+}
+#endif /* OSAL_VT_USE_WHEEL == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -63,10 +190,24 @@ virtual_timers_list_t vtlist;
  * @init
  */
 void vtInit(void) {
+#if OSAL_VT_USE_WHEEL == TRUE
+  unsigned k, i;
 
+  /* Timing wheel initialization.*/
+  for (k = 0U; k < (unsigned)OSAL_VT_WHEEL_LEVELS; k++) {
+    for (i = 0U; i < OSAL_VT_WHEEL_SLOTS; i++) {
+      vt_slot_t *sp = &vtlist.vt_slots[k][i];
+
+      sp->vt_next = (virtual_timer_t *)sp;
+      sp->vt_prev = (virtual_timer_t *)sp;
+    }
+    vtlist.vt_bitmap[k] = 0U;
+  }
+#else
   /* Virtual Timers initialization.*/
   vtlist.vt_next = vtlist.vt_prev = (void *)&vtlist;
   vtlist.vt_delta = (sysinterval_t)-1;
+#endif
   vtlist.vt_systime = 0;
 }
 
@@ -94,6 +235,9 @@ bool vtIsArmedI(virtual_timer_t *vtp) {
 void vtDoTickI(void) {
 
   vtlist.vt_systime++;
+#if OSAL_VT_USE_WHEEL == TRUE
+  wheel_process(vtlist.vt_systime);
+#else
   if (&vtlist != (virtual_timers_list_t *)vtlist.vt_next) {
     virtual_timer_t *vtp;
 
@@ -108,6 +252,7 @@ void vtDoTickI(void) {
       osalSysLockFromISR();
     }
   }
+#endif
 }
 
 /**
@@ -131,6 +276,14 @@ void vtDoTickI(void) {
  */
 void vtSetI(virtual_timer_t *vtp, sysinterval_t timeout,
             vtfunc_t vtfunc, void *par) {
+#if OSAL_VT_USE_WHEEL == TRUE
+  systime_t now = vtlist.vt_systime;
+
+  vtp->vt_par = par;
+  vtp->vt_func = vtfunc;
+  vtp->vt_expires = now + (systime_t)timeout;
+  wheel_insert(vtp, now);
+#else
   virtual_timer_t *p;
 
   vtp->vt_par = par;
@@ -146,6 +299,7 @@ void vtSetI(virtual_timer_t *vtp, sysinterval_t timeout,
   vtp->vt_delta = timeout;
   if (p != (void *)&vtlist)
     p->vt_delta -= timeout;
+#endif
 }
 
 /**
@@ -158,10 +312,14 @@ void vtSetI(virtual_timer_t *vtp, sysinterval_t timeout,
  */
 void vtResetI(virtual_timer_t *vtp) {
 
+#if OSAL_VT_USE_WHEEL == TRUE
+  wheel_remove(vtp);
+#else
   if (vtp->vt_next != (void *)&vtlist)
     vtp->vt_next->vt_delta += vtp->vt_delta;
   vtp->vt_prev->vt_next = vtp->vt_next;
   vtp->vt_next->vt_prev = vtp->vt_prev;
+#endif
   vtp->vt_func = (vtfunc_t)NULL;
 }
 
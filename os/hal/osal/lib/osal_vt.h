@@ -29,14 +29,49 @@
 /* Module constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Number of bits of time of each timing wheel level.
+ */
+#define OSAL_VT_WHEEL_BITS                  5U
+
+/**
+ * @brief   Number of slots of each timing wheel level.
+ */
+#define OSAL_VT_WHEEL_SLOTS                 32U
+
 /*===========================================================================*/
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Timing wheel virtual timers.
+ * @details If enabled the timers are organized in a hierarchical timing
+ *          wheel, arming, disarming and firing timers is done in constant
+ *          time regardless of the number of armed timers.
+ * @note    The default is @p FALSE, the delta list is used.
+ */
+#if !defined(OSAL_VT_USE_WHEEL) || defined(__DOXYGEN__)
+#define OSAL_VT_USE_WHEEL                   FALSE
+#endif
+
+/**
+ * @brief   Number of timing wheel levels.
+ * @details Each level covers 5 bits of time, timers farther than the wheel
+ *          span are re-inserted after a full wheel rotation.
+ */
+#if !defined(OSAL_VT_WHEEL_LEVELS) || defined(__DOXYGEN__)
+#define OSAL_VT_WHEEL_LEVELS                4
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (OSAL_VT_USE_WHEEL == TRUE) &&                                          \
+    ((OSAL_VT_WHEEL_LEVELS < 2) || ((OSAL_VT_WHEEL_LEVELS * 5) >= 32))
+#error "invalid OSAL_VT_WHEEL_LEVELS value"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -51,6 +86,19 @@ typedef void (*vtfunc_t)(void *);
  */
 typedef struct virtual_timer virtual_timer_t;
 
+#if (OSAL_VT_USE_WHEEL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Timing wheel slot header.
+ * @note    The slot is a circular double linked list of timers, the header
+ *          shares the layout of the first two fields of
+ *          @p virtual_timer_t.
+ */
+typedef struct {
+  virtual_timer_t       *vt_next;   /**< @brief First timer in the slot.    */
+  virtual_timer_t       *vt_prev;   /**< @brief Last timer in the slot.     */
+} vt_slot_t;
+#endif
+
 /**
  * @brief   Virtual timers list header.
  * @note    The content of this structure is not part of the API and should
@@ -59,13 +107,26 @@ typedef struct virtual_timer virtual_timer_t;
  * @note    The delta list is implemented as a double link bidirectional list
  *          in order to make the unlink time constant, the reset of a virtual
  *          timer is often used in the code.
+ * @note    If @p OSAL_VT_USE_WHEEL is enabled then the timers are organized
+ *          in a hierarchical timing wheel instead of a delta list, the
+ *          system time is also the wheel time.
  */
 typedef struct {
+#if (OSAL_VT_USE_WHEEL == FALSE) || defined(__DOXYGEN__)
   virtual_timer_t       *vt_next;   /**< @brief Next timer in the timers
                                                 list.                       */
   virtual_timer_t       *vt_prev;   /**< @brief Last timer in the timers
                                                 list.                       */
   sysinterval_t         vt_delta;   /**< @brief Must be initialized to -1.  */
+#endif
+#if (OSAL_VT_USE_WHEEL == TRUE) || defined(__DOXYGEN__)
+  vt_slot_t             vt_slots[OSAL_VT_WHEEL_LEVELS][OSAL_VT_WHEEL_SLOTS];
+                                    /**< @brief Wheel slots, one row for
+                                                each level.                 */
+  uint32_t              vt_bitmap[OSAL_VT_WHEEL_LEVELS];
+                                    /**< @brief Non-empty slots bitmap for
+                                                each level.                 */
+#endif
   volatile systime_t    vt_systime; /**< @brief System Time counter.        */
 } virtual_timers_list_t;
 
@@ -82,7 +143,12 @@ struct virtual_timer {
                                                 list.                       */
   virtual_timer_t       *vt_prev;   /**< @brief Previous timer in the timers
                                                 list.                       */
+#if (OSAL_VT_USE_WHEEL == FALSE) || defined(__DOXYGEN__)
   sysinterval_t         vt_delta;   /**< @brief Time delta before timeout.  */
+#endif
+#if (OSAL_VT_USE_WHEEL == TRUE) || defined(__DOXYGEN__)
+  systime_t             vt_expires; /**< @brief Expiration system time.     */
+#endif
   vtfunc_t              vt_func;    /**< @brief Timer callback function
                                                 pointer.                    */
   void                  *vt_par;    /**< @brief Timer callback function
@@ -44,8 +44,133 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (OSAL_USE_IRQ_THREADS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   IRQ bottom-half thread.
+ * @details The bottom-half function is executed once for each group of
+ *          requests, the object mutex is owned during the execution.
+ *
+ * @param[in] p         pointer to the @p osal_irq_thread_t object
+ */
+static THD_FUNCTION(osal_irq_thread, p) {
+  osal_irq_thread_t *itp = (osal_irq_thread_t *)p;
+
+  chSysLock();
+  while (!itp->stop) {
+    if (!itp->pending) {
+      (void) chThdSuspendS(&itp->wait);
+      continue;
+    }
+    itp->pending = false;
+    chSysUnlock();
+
+    chMtxLock(&itp->mtx);
+    itp->func(itp->param);
+    chMtxUnlock(&itp->mtx);
+
+    chSysLock();
+  }
+
+  /* The waiting thread is made ready but the stack is not released
+     before the exit context switch.*/
+  chThdResumeI(&itp->exit, MSG_OK);
+  chThdExitS(MSG_OK);
+}
+#endif /* OSAL_USE_IRQ_THREADS == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
 
+#if (OSAL_USE_IRQ_THREADS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes an @p osal_irq_thread_t object.
+ *
+ * @param[out] itp      pointer to the @p osal_irq_thread_t object
+ *
+ * @init
+ */
+void osalIrqThreadObjectInit(osal_irq_thread_t *itp) {
+
+  itp->thread  = NULL;
+  itp->func    = NULL;
+  itp->param   = NULL;
+  itp->pending = false;
+  itp->stop    = false;
+  itp->wait    = NULL;
+  itp->exit    = NULL;
+  chMtxObjectInit(&itp->mtx);
+}
+
+/**
+ * @brief   Starts the bottom-half thread of an IRQ thread object.
+ * @details After this call the top-half can request the bottom-half
+ *          execution using @p osalIrqThreadSignalI().
+ * @note    The bottom-half runs in thread context, it can use the same
+ *          I-class functions and @p osalSysLockFromISR() critical zones
+ *          used in ISR context.
+ * @note    This function is meant to be called from the drivers start
+ *          functions, it can reschedule.
+ *
+ * @param[in] itp       pointer to the @p osal_irq_thread_t object
+ * @param[out] wsp      pointer to a working area dedicated to the thread
+ * @param[in] size      size of the working area
+ * @param[in] prio      priority of the bottom-half thread, normally
+ *                      @p OSAL_IRQ_THREAD_PRIORITY
+ * @param[in] name      name of the bottom-half thread
+ * @param[in] func      the bottom-half function
+ * @param[in] param     parameter of the bottom-half function
+ *
+ * @sclass
+ */
+void osalIrqThreadStartS(osal_irq_thread_t *itp, void *wsp, size_t size,
+                         tprio_t prio, const char *name,
+                         irqfunc_t func, void *param) {
+  thread_descriptor_t td = {
+    name,
+    (stkalign_t *)wsp,
+    (stkalign_t *)((uint8_t *)wsp + size),
+    prio,
+    osal_irq_thread,
+    (void *)itp
+  };
+
+  osalDbgCheckClassS();
+  osalDbgCheck((itp != NULL) && (wsp != NULL) && (func != NULL));
+  osalDbgAssert(itp->thread == NULL, "already started");
+
+  itp->func    = func;
+  itp->param   = param;
+  itp->pending = false;
+  itp->stop    = false;
+  itp->thread  = chThdCreateI(&td);
+  chSchWakeupS(itp->thread, MSG_OK);
+}
+
+/**
+ * @brief   Stops the bottom-half thread of an IRQ thread object.
+ * @details The function waits for the completion of a running bottom-half,
+ *          pending requests are discarded.
+ * @pre     The top-half must no more request the bottom-half execution.
+ * @note    This function is meant to be called from the drivers stop
+ *          functions, it can reschedule.
+ *
+ * @param[in] itp       pointer to the @p osal_irq_thread_t object
+ *
+ * @sclass
+ */
+void osalIrqThreadStopS(osal_irq_thread_t *itp) {
+
+  osalDbgCheckClassS();
+  osalDbgCheck(itp != NULL);
+
+  if (itp->thread != NULL) {
+    itp->stop = true;
+    chThdResumeI(&itp->wait, MSG_OK);
+    (void) chThdSuspendS(&itp->exit);
+    itp->thread = NULL;
+  }
+}
+#endif /* OSAL_USE_IRQ_THREADS == TRUE */
+
 /** @} */
@@ -109,10 +109,48 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @name    IRQ threads settings
+ * @{
+ */
+/**
+ * @brief   Enables the IRQ threads support.
+ * @details If enabled then drivers can defer the processing of their
+ *          interrupts to a bottom-half thread, the ISR is reduced to a
+ *          top-half acknowledging the interrupt source.
+ * @note    The OSAL is included before @p halconf.h so this option must be
+ *          defined in @p chconf.h or in the makefile.
+ * @note    When enabled, @p osalSysLockFromISR() and
+ *          @p osalSysUnlockFromISR() can also be used from the bottom-half
+ *          threads, this makes the ISR critical zones a bit slower.
+ */
+#if !defined(OSAL_USE_IRQ_THREADS) || defined(__DOXYGEN__)
+#define OSAL_USE_IRQ_THREADS                FALSE
+#endif
+
+/**
+ * @brief   Default priority of the IRQ threads.
+ */
+#if !defined(OSAL_IRQ_THREAD_PRIORITY) || defined(__DOXYGEN__)
+#define OSAL_IRQ_THREAD_PRIORITY            HIGHPRIO
+#endif
+
+/**
+ * @brief   Stack size of the IRQ threads.
+ */
+#if !defined(OSAL_IRQ_THREAD_STACK_SIZE) || defined(__DOXYGEN__)
+#define OSAL_IRQ_THREAD_STACK_SIZE          256
+#endif
+/** @} */
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (OSAL_USE_IRQ_THREADS == TRUE) && (CH_CFG_USE_MUTEXES == FALSE)
+#error "OSAL_USE_IRQ_THREADS requires CH_CFG_USE_MUTEXES"
+#endif
+
 #if !(OSAL_ST_MODE == OSAL_ST_MODE_NONE) &&                                 \
     !(OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC) &&                             \
     !(OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING)
@@ -209,6 +247,53 @@ struct event_source {
 };
 #endif /* CH_CFG_USE_EVENTS == FALSE */
 
+#if (OSAL_USE_IRQ_THREADS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of an IRQ bottom-half function.
+ *
+ * @param[in] p         the function parameter
+ */
+typedef void (*irqfunc_t)(void *p);
+
+/**
+ * @brief   Type of an IRQ thread object.
+ */
+typedef struct {
+  /**
+   * @brief   Bottom-half thread or @p NULL if not started.
+   */
+  thread_t              *thread;
+  /**
+   * @brief   Bottom-half function.
+   */
+  irqfunc_t             func;
+  /**
+   * @brief   Bottom-half function parameter.
+   */
+  void                  *param;
+  /**
+   * @brief   Pending bottom-half request.
+   */
+  bool                  pending;
+  /**
+   * @brief   Termination request.
+   */
+  bool                  stop;
+  /**
+   * @brief   Reference to the bottom-half thread waiting for requests.
+   */
+  thread_reference_t    wait;
+  /**
+   * @brief   Reference to the thread waiting for the termination.
+   */
+  thread_reference_t    exit;
+  /**
+   * @brief   Mutex owned during the bottom-half execution.
+   */
+  mutex_t               mtx;
+} osal_irq_thread_t;
+#endif /* OSAL_USE_IRQ_THREADS == TRUE */
+
 /**
  * @brief   Type of a mutex.
  * @note    If the OS does not support mutexes or there is no OS then the
@@ -443,6 +528,16 @@ typedef struct {
 #define osalThreadSleepMicroseconds(usecs) osalThreadSleep(OSAL_US2I(usecs))
 /** @} */
 
+#if (OSAL_USE_IRQ_THREADS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Static working area allocation for an IRQ thread.
+ *
+ * @param[in] s         the name to be assigned to the stack array
+ */
+#define OSAL_IRQ_THREAD_WORKING_AREA(s)                                     \
+  THD_WORKING_AREA(s, OSAL_IRQ_THREAD_STACK_SIZE)
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -450,7 +545,13 @@ typedef struct {
 #ifdef __cplusplus
 extern "C" {
 #endif
-
+#if (OSAL_USE_IRQ_THREADS == TRUE) || defined(__DOXYGEN__)
+  void osalIrqThreadObjectInit(osal_irq_thread_t *itp);
+  void osalIrqThreadStartS(osal_irq_thread_t *itp, void *wsp, size_t size,
+                           tprio_t prio, const char *name,
+                           irqfunc_t func, void *param);
+  void osalIrqThreadStopS(osal_irq_thread_t *itp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -530,6 +631,13 @@ static inline void osalSysUnlock(void) {
  */
 static inline void osalSysLockFromISR(void) {
 
+#if OSAL_USE_IRQ_THREADS == TRUE
+  /* Bottom-half threads run the ISR code in thread context.*/
+  if (!port_is_isr_context()) {
+    chSysLock();
+    return;
+  }
+#endif
   chSysLockFromISR();
 }
 
@@ -541,6 +649,15 @@ static inline void osalSysLockFromISR(void) {
  */
 static inline void osalSysUnlockFromISR(void) {
 
+#if OSAL_USE_IRQ_THREADS == TRUE
+  /* Bottom-half threads run the ISR code in thread context, threads made
+     ready inside the critical zone can preempt.*/
+  if (!port_is_isr_context()) {
+    chSchRescheduleS();
+    chSysUnlock();
+    return;
+  }
+#endif
   chSysUnlockFromISR();
 }
 
@@ -636,6 +753,23 @@ static inline systime_t osalOsGetSystemTimeX(void) {
   return chVTGetSystemTimeX();
 }
 
+/**
+ * @brief   Returns the time interval until the next timer event.
+ *
+ * @param[out] timep    pointer to a variable that will contain the time
+ *                      interval until the next timer elapses, it can be
+ *                      @p NULL if the information is not required
+ * @return              The timers state.
+ * @retval false        if there are no armed timers.
+ * @retval true         if there is at least one armed timer.
+ *
+ * @iclass
+ */
+static inline bool osalOsGetTimersStateI(sysinterval_t *timep) {
+
+  return chVTGetTimersStateI(timep);
+}
+
 /**
  * @brief   Adds an interval to a system time returning a system time.
  *
@@ -1023,6 +1157,53 @@ static inline void osalMutexUnlock(mutex_t *mp) {
 #endif
 }
 
+#if (OSAL_USE_IRQ_THREADS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Requests the execution of an IRQ bottom-half.
+ * @details This function is meant to be called by the top-half, requests
+ *          performed while the bottom-half is already pending are merged
+ *          into a single execution.
+ *
+ * @param[in] itp       pointer to the @p osal_irq_thread_t object
+ *
+ * @iclass
+ */
+static inline void osalIrqThreadSignalI(osal_irq_thread_t *itp) {
+
+  chDbgCheckClassI();
+
+  itp->pending = true;
+  chThdResumeI(&itp->wait, MSG_OK);
+}
+
+/**
+ * @brief   Excludes the IRQ bottom-half.
+ * @details The bottom-half owns a mutex while running so the calling
+ *          thread waits for the bottom-half completion, the bottom-half
+ *          thread inherits the priority of the caller in the meantime.
+ *
+ * @param[in] itp       pointer to the @p osal_irq_thread_t object
+ *
+ * @api
+ */
+static inline void osalIrqThreadLock(osal_irq_thread_t *itp) {
+
+  osalMutexLock(&itp->mtx);
+}
+
+/**
+ * @brief   Allows again the IRQ bottom-half.
+ *
+ * @param[in] itp       pointer to the @p osal_irq_thread_t object
+ *
+ * @api
+ */
+static inline void osalIrqThreadUnlock(osal_irq_thread_t *itp) {
+
+  osalMutexUnlock(&itp->mtx);
+}
+#endif /* OSAL_USE_IRQ_THREADS == TRUE */
+
 #endif /* OSAL_H */
 
 /** @} */
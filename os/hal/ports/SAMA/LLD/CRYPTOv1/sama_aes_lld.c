@@ -239,12 +239,21 @@ cryerror_t sama_aes_lld_process_dma(CRYDriver *cryp,  aesparams *params,
 			AES->AES_MR &= ~AES_MR_CIPHER;
 
 		AES->AES_MR |= (((AES_MR_SMOD_Msk & (AES_MR_SMOD_IDATAR0_START)))
-				| AES_MR_CKEY_PASSWD);
+				| AES_MR_DUALBUFF_ACTIVE | AES_MR_CKEY_PASSWD);
 
 		//Enable aes interrupt
 		AES->AES_IER = AES_IER_DATRDY;
 
 	}
+	else {
+		osalMutexUnlock(&cryp->mutex);
+		return ret;
+	}
+
+	// ensure the input can be fetched directly from RAM and no dirty
+	// output line is written back over the transferred data
+	cacheCleanRegion((void *)in, indata_len);
+	cacheCleanRegion(out, indata_len);
 
 	osalSysLock();
 
@@ -255,6 +264,8 @@ cryerror_t sama_aes_lld_process_dma(CRYDriver *cryp,  aesparams *params,
 
 	osalSysUnlock();
 
+	cacheInvalidateRegion(out, indata_len);
+
 	osalMutexUnlock(&cryp->mutex);
 #endif //#if defined(SAMA_DMA_REQUIRED)
 	return CRY_NOERROR;
@@ -32,6 +32,59 @@ static void incr32(uint8_t* j0)
     j0[15] = counter & 0xFF;
 }
 
+static void sama_gcm_lld_process_aad_dma(CRYDriver *cryp,cgmcontext * cxt)
+{
+#if defined(SAMA_DMA_REQUIRED)
+	uint32_t len;
+
+	osalDbgAssert(cryp->thread == NULL, "already waiting");
+
+	// the AAD is processed in whole blocks
+	len = ((cxt->aadsize + cxt->params.block_size - 1) / cxt->params.block_size) *
+			cxt->params.block_size;
+
+	cryp->dmachunksize = DMA_CHUNK_SIZE_4;
+	cryp->dmawith = DMA_DATA_WIDTH_WORD;
+
+	cryp->txdmamode = XDMAC_CC_TYPE_PER_TRAN |
+			XDMAC_CC_PROT_SEC |
+			XDMAC_CC_MBSIZE_SINGLE |
+			XDMAC_CC_DSYNC_MEM2PER | XDMAC_CC_CSIZE(cryp->dmachunksize) |
+			XDMAC_CC_DWIDTH(cryp->dmawith) |
+			XDMAC_CC_SIF_AHB_IF0 |
+			XDMAC_CC_DIF_AHB_IF1 |
+			XDMAC_CC_SAM_INCREMENTED_AM |
+			XDMAC_CC_DAM_FIXED_AM |
+			XDMAC_CC_PERID(PERID_AES_TX);
+
+	// only the writing channel is used, its end wakes up the thread
+	cryp->rxdmamode = 0xFFFFFFFF;
+
+	dmaChannelSetMode(cryp->dmatx, cryp->txdmamode);
+
+	dmaChannelSetSource(cryp->dmatx, cxt->aad);
+	dmaChannelSetDestination(cryp->dmatx, AES->AES_IDATAR);
+	dmaChannelSetTransactionSize(cryp->dmatx, ( len / DMA_DATA_WIDTH_TO_BYTE(cryp->dmawith)));
+
+	AES->AES_MR |= (((AES_MR_SMOD_Msk & (AES_MR_SMOD_IDATAR0_START)))
+			| AES_MR_DUALBUFF_ACTIVE | AES_MR_CKEY_PASSWD);
+
+	// ensure the AAD can be fetched directly from RAM
+	cacheCleanRegion(cxt->aad, len);
+
+	osalSysLock();
+
+	dmaChannelEnable(cryp->dmatx);
+
+	osalThreadSuspendS(&cryp->thread);
+
+	osalSysUnlock();
+#else
+	(void)cryp;
+	(void)cxt;
+#endif //#if defined(SAMA_DMA_REQUIRED)
+}
+
 static cryerror_t sama_gcm_lld_process_dma(CRYDriver *cryp,cgmcontext * cxt)
 {
 #if defined(SAMA_DMA_REQUIRED)
@@ -90,11 +143,16 @@ static cryerror_t sama_gcm_lld_process_dma(CRYDriver *cryp,cgmcontext * cxt)
 	dmaChannelSetTransactionSize(cryp->dmarx,  ( cxt->c_size / DMA_DATA_WIDTH_TO_BYTE(cryp->dmawith)));
 
 	AES->AES_MR |= (((AES_MR_SMOD_Msk & (AES_MR_SMOD_IDATAR0_START)))
-			| AES_MR_CKEY_PASSWD);
+			| AES_MR_DUALBUFF_ACTIVE | AES_MR_CKEY_PASSWD);
 
 	//Enable aes interrupt
 	AES->AES_IER = AES_IER_DATRDY;
 
+	// ensure the input can be fetched directly from RAM and no dirty
+	// output line is written back over the transferred data
+	cacheCleanRegion(cxt->in, cxt->c_size);
+	cacheCleanRegion(cxt->out, cxt->c_size);
+
 	osalSysLock();
 
 	dmaChannelEnable(cryp->dmarx);
@@ -104,6 +162,8 @@ static cryerror_t sama_gcm_lld_process_dma(CRYDriver *cryp,cgmcontext * cxt)
 
 	osalSysUnlock();
 
+	cacheInvalidateRegion(cxt->out, cxt->c_size);
+
 
 #endif //#if defined(SAMA_DMA_REQUIRED)
 	return CRY_NOERROR;
@@ -114,7 +174,7 @@ cryerror_t sama_gcm_lld_process(CRYDriver *cryp,cgmcontext * cxt)
 {
 	cryerror_t ret;
 	uint32_t *ref32;
-	uint8_t i;
+	uint32_t i;
 	uint8_t J0[16] = { 0x00 };
 
 
@@ -168,14 +228,20 @@ cryerror_t sama_gcm_lld_process(CRYDriver *cryp,cgmcontext * cxt)
 		AES->AES_MR |= AES_MR_GTAGEN| AES_MR_CKEY_PASSWD;
 
 
-		for (i = 0; i < cxt->aadsize; i += cxt->params.block_size) {
+		if (cryp->config->transfer_mode == TRANSFER_POLLING) {
+			for (i = 0; i < cxt->aadsize; i += cxt->params.block_size) {
 
-			sama_aes_lld_set_input((uint32_t *) ((cxt->aad) + i));
+				sama_aes_lld_set_input((uint32_t *) ((cxt->aad) + i));
 
-			AES->AES_CR = AES_CR_START;
+				AES->AES_CR = AES_CR_START;
 
-			while ((AES->AES_ISR & AES_ISR_DATRDY) != AES_ISR_DATRDY);
+				while ((AES->AES_ISR & AES_ISR_DATRDY) != AES_ISR_DATRDY);
 
+			}
+		}
+		else if (cxt->aadsize > 0)
+		{
+			sama_gcm_lld_process_aad_dma(cryp,cxt);
 		}
 
 		if (cryp->config->transfer_mode == TRANSFER_POLLING) {
@@ -209,23 +209,10 @@ cryerror_t sama_sha_lld_init(CRYDriver *cryp, struct sha_data *sha)
 	} else {
 		algoregval |= SHA_MR_SMOD_IDATAR0_START;
 
-		cryp->dmawith = DMA_DATA_WIDTH_WORD;
-		cryp->dmachunksize = DMA_CHUNK_SIZE_16;
-
-		cryp->txdmamode = XDMAC_CC_TYPE_PER_TRAN |
-				XDMAC_CC_PROT_SEC |
-				XDMAC_CC_MBSIZE_SINGLE |
-				XDMAC_CC_DSYNC_MEM2PER | XDMAC_CC_CSIZE(cryp->dmachunksize) |
-				XDMAC_CC_DWIDTH(cryp->dmawith) |
-				XDMAC_CC_SIF_AHB_IF0 |
-				XDMAC_CC_DIF_AHB_IF1 |
-				XDMAC_CC_SAM_INCREMENTED_AM |
-				XDMAC_CC_DAM_FIXED_AM |
-				XDMAC_CC_PERID(PERID_SHA_TX);
-
-		cryp->rxdmamode = 0xFFFFFFFF;
-
-		dmaChannelSetMode(cryp->dmatx, cryp->txdmamode);
+		// the next block is loaded while the previous one is processed,
+		// the dual buffer is used with the 512 bits blocks only
+		if (sha->block_size == 64)
+			algoregval |= SHA_MR_DUALBUFF;
 	}
 
 	//configure
@@ -359,27 +346,48 @@ static uint32_t processBlockPolling(const uint8_t *data,uint32_t len, uint32_t b
 
 static uint32_t processBlockDMA(CRYDriver *cryp, const uint8_t *data,uint32_t len, uint32_t block_size)
 {
-	uint32_t processed = 0;
+	uint32_t processed = (len / block_size) * block_size;
 
-	while ((len - processed) >= block_size) {
+	if (processed == 0)
+		return 0;
 
-		// load data in the sha input registers
-		// Writing channel
-		dmaChannelSetSource(cryp->dmatx, &data[processed]);
-		dmaChannelSetDestination(cryp->dmatx, SHA->SHA_IDATAR);
-		dmaChannelSetTransactionSize(cryp->dmatx,
-				(block_size / DMA_DATA_WIDTH_TO_BYTE(cryp->dmawith)));
+	// the channels are shared with the AES, the mode is set on each transfer
+	cryp->dmawith = DMA_DATA_WIDTH_WORD;
+	cryp->dmachunksize = DMA_CHUNK_SIZE_16;
 
-		osalSysLock();
+	cryp->txdmamode = XDMAC_CC_TYPE_PER_TRAN |
+			XDMAC_CC_PROT_SEC |
+			XDMAC_CC_MBSIZE_SINGLE |
+			XDMAC_CC_DSYNC_MEM2PER | XDMAC_CC_CSIZE(cryp->dmachunksize) |
+			XDMAC_CC_DWIDTH(cryp->dmawith) |
+			XDMAC_CC_SIF_AHB_IF0 |
+			XDMAC_CC_DIF_AHB_IF1 |
+			XDMAC_CC_SAM_INCREMENTED_AM |
+			XDMAC_CC_DAM_FIXED_AM |
+			XDMAC_CC_PERID(PERID_SHA_TX);
 
-		dmaChannelEnable(cryp->dmatx);
+	// only the writing channel is used, its end wakes up the thread
+	cryp->rxdmamode = 0xFFFFFFFF;
 
-		osalThreadSuspendS(&cryp->thread);
+	dmaChannelSetMode(cryp->dmatx, cryp->txdmamode);
 
-		osalSysUnlock();
+	// all the blocks are loaded by a single transfer, the SHA requests
+	// the next block when the previous one has been taken
+	dmaChannelSetSource(cryp->dmatx, data);
+	dmaChannelSetDestination(cryp->dmatx, SHA->SHA_IDATAR);
+	dmaChannelSetTransactionSize(cryp->dmatx,
+			(processed / DMA_DATA_WIDTH_TO_BYTE(cryp->dmawith)));
 
-		processed += block_size;
-	}
+	// ensure the data can be fetched directly from RAM
+	cacheCleanRegion((void *)data, processed);
+
+	osalSysLock();
+
+	dmaChannelEnable(cryp->dmatx);
+
+	osalThreadSuspendS(&cryp->thread);
+
+	osalSysUnlock();
 
 	return processed;
 }
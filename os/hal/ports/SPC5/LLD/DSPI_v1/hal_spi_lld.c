@@ -1834,6 +1834,36 @@ void spi_lld_receive(SPIDriver *spip, size_t n, void *rxbuf) {
   spi_start_tx_ignore(spip, n);
 }
 
+#if (SPC5_SPI_DMA_MODE == SPC5_SPI_DMA_RX_AND_TX) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a DMA chain.
+ * @details The first TCD of each chain is loaded into the TX1 and RX
+ *          channels, the following segments are loaded by the eDMA.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] chp       pointer to an initialized @p SPIChain object
+ *
+ * @notapi
+ */
+void spi_lld_start_chain(SPIDriver *spip, const SPIChain *chp) {
+
+  /* Starting transfer.*/
+  spi_dspi_start(spip);
+
+  /* Note, the PUSHR words are complete so the TFFF DMA request is served
+     by TX1 alone, TX2 is not used and TX1 does not raise interrupts.*/
+  edmaChannelStop(spip->tx1_channel);
+  edmaChannelStop(spip->rx_channel);
+  edmaChannelLoadTCD(spip->rx_channel, chp->rxtcdp);
+  edmaChannelLoadTCD(spip->tx1_channel, chp->txtcdp);
+
+  /* Starting DMA channels, RX first in order to not lose frames.*/
+  edmaChannelStart(spip->rx_channel);
+  edmaChannelStart(spip->tx1_channel);
+}
+#endif /* SPC5_SPI_DMA_MODE == SPC5_SPI_DMA_RX_AND_TX */
+
 /**
  * @brief   Exchanges one frame using a polled wait.
  * @details This synchronous function exchanges one frame using a polled
@@ -1865,6 +1895,127 @@ uint16_t spi_lld_polled_exchange(SPIDriver *spip, uint16_t frame) {
   return (uint16_t)popr;
 }
 
+#if (SPC5_SPI_DMA_MODE == SPC5_SPI_DMA_RX_AND_TX) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a DMA chain.
+ * @details The segments are translated into two lists of scatter-gather
+ *          linked TCDs, one for the TX channel and one for the RX channel.
+ *          The chain can then be started any number of times without
+ *          rebuilding the TCDs.
+ * @pre     The driver must have been started, the TCDs refer to the DSPI
+ *          unit registers.
+ * @pre     The TCD arrays must be aligned to @p EDMA_TCD_ALIGNMENT and have
+ *          one element for each segment.
+ * @note    The segments, the PUSHR words and the receive buffers must stay
+ *          valid as long as the chain is used.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[out] chp      pointer to the @p SPIChain object to be initialized
+ * @param[in] segs      array of segments
+ * @param[in] n         number of segments
+ * @param[out] txtcds   array of TX TCDs
+ * @param[out] rxtcds   array of RX TCDs
+ *
+ * @init
+ */
+void spc5SPIChainObjectInit(SPIDriver *spip, SPIChain *chp,
+                            const SPIChainSegment *segs, size_t n,
+                            edma_tcd_t *txtcds, edma_tcd_t *rxtcds) {
+  static uint32_t datasink;
+  size_t i;
+
+  osalDbgCheck((spip != NULL) && (chp != NULL) && (segs != NULL) &&
+               (n > 0U) && (txtcds != NULL) && (rxtcds != NULL));
+  osalDbgCheck(((((uint32_t)txtcds) | ((uint32_t)rxtcds)) &
+                (EDMA_TCD_ALIGNMENT - 1U)) == 0U);
+
+  for (i = 0U; i < n; i++) {
+    uint32_t mode;
+
+    osalDbgCheck((segs[i].pushr != NULL) &&
+                 (segs[i].n > 0U) && (segs[i].n <= 32767U));
+
+    /* Only the last TCDs stop the DMA requests, the RX one also raises
+       the completion interrupt.*/
+    mode = (i == n - 1U) ? EDMA_TCD_MODE_DREQ : 0U;
+
+    /* TX TCD, the PUSHR words are sent as they are.*/
+    edmaTCDSetup(&txtcds[i],                    /* tcdp.                    */
+                 segs[i].pushr,                 /* src.                     */
+                 &spip->dspi->PUSHR.R,          /* dst.                     */
+                 4,                             /* soff, advance by four.   */
+                 0,                             /* doff, do not advance.    */
+                 2,                             /* ssize, 32 bits transfers.*/
+                 2,                             /* dsize, 32 bits transfers.*/
+                 4,                             /* nbytes, always four.     */
+                 segs[i].n,                     /* iter.                    */
+                 0,                             /* slast, no source adjust. */
+                 0,                             /* dlast, no dest.adjust.   */
+                 mode);                         /* mode.                    */
+
+    /* RX TCD, the received frames are discarded if there is no buffer.*/
+    if (segs[i].rxbuf != NULL) {
+      edmaTCDSetup(&rxtcds[i],                  /* tcdp.                    */
+                   DSPI_POPR16_ADDRESS(spip),   /* src.                     */
+                   segs[i].rxbuf,               /* dst.                     */
+                   0,                           /* soff, do not advance.    */
+                   2,                           /* doff, advance by two.    */
+                   1,                           /* ssize, 16 bits transfers.*/
+                   1,                           /* dsize, 16 bits transfers.*/
+                   2,                           /* nbytes, always two.      */
+                   segs[i].n,                   /* iter.                    */
+                   0,                           /* slast, no source adjust. */
+                   0,                           /* dlast.                   */
+                   mode | ((i == n - 1U) ? EDMA_TCD_MODE_INT_END : 0U));
+    }
+    else {
+      edmaTCDSetup(&rxtcds[i],                  /* tcdp.                    */
+                   DSPI_POPR16_ADDRESS(spip),   /* src.                     */
+                   &datasink,                   /* dst.                     */
+                   0,                           /* soff, do not advance.    */
+                   0,                           /* doff, do not advance.    */
+                   1,                           /* ssize, 16 bits transfers.*/
+                   1,                           /* dsize, 16 bits transfers.*/
+                   2,                           /* nbytes, always two.      */
+                   segs[i].n,                   /* iter.                    */
+                   0,                           /* slast, no source adjust. */
+                   0,                           /* dlast.                   */
+                   mode | ((i == n - 1U) ? EDMA_TCD_MODE_INT_END : 0U));
+    }
+
+    /* Linking to the previous segment.*/
+    if (i > 0U) {
+      edmaTCDSetNext(&txtcds[i - 1U], &txtcds[i]);
+      edmaTCDSetNext(&rxtcds[i - 1U], &rxtcds[i]);
+    }
+  }
+
+  chp->txtcdp = &txtcds[0];
+  chp->rxtcdp = &rxtcds[0];
+}
+
+/**
+ * @brief   Starts a DMA chain.
+ * @details This asynchronous function starts the transfer of all the
+ *          segments of a chain.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] chp       pointer to an initialized @p SPIChain object
+ *
+ * @api
+ */
+void spc5SPIStartChain(SPIDriver *spip, const SPIChain *chp) {
+
+  osalDbgCheck((spip != NULL) && (chp != NULL));
+
+  osalSysLock();
+  osalDbgAssert(spip->state == SPI_READY, "not ready");
+  spc5SPIStartChainI(spip, chp);
+  osalSysUnlock();
+}
+#endif /* SPC5_SPI_DMA_MODE == SPC5_SPI_DMA_RX_AND_TX */
+
 #endif /* HAL_USE_SPI */
 
 /** @} */
@@ -697,6 +697,50 @@ typedef struct {
   uint32_t              pushr;
 } SPIConfig;
 
+#if (SPC5_SPI_DMA_MODE == SPC5_SPI_DMA_RX_AND_TX) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a DMA chain segment.
+ * @details A segment is a sequence of frames described by pre-built PUSHR
+ *          words, each word carries its own chip selects, CTAR selection,
+ *          CONT bit and data, so frames toward different devices can be
+ *          mixed in a single segment.
+ */
+typedef struct {
+  /**
+   * @brief   Pointer to the PUSHR words to be sent.
+   * @note    The last word of the last segment should have the EOQ bit
+   *          set and the CONT bit cleared.
+   */
+  const uint32_t        *pushr;
+  /**
+   * @brief   Pointer to the receive buffer or @p NULL.
+   * @note    Received frames are discarded if @p NULL.
+   */
+  uint16_t              *rxbuf;
+  /**
+   * @brief   Number of frames in the segment.
+   */
+  size_t                n;
+} SPIChainSegment;
+
+/**
+ * @brief   Type of a DMA chain.
+ * @details A chain is a set of segments translated once into linked eDMA
+ *          TCDs, starting it only requires loading the first TCD of each
+ *          channel.
+ */
+typedef struct {
+  /**
+   * @brief   First TX TCD of the chain.
+   */
+  const edma_tcd_t      *txtcdp;
+  /**
+   * @brief   First RX TCD of the chain.
+   */
+  const edma_tcd_t      *rxtcdp;
+} SPIChain;
+#endif /* SPC5_SPI_DMA_MODE == SPC5_SPI_DMA_RX_AND_TX */
+
 /**
  * @brief   Structure representing an SPI driver.
  * @note    Implementations may extend this structure to contain more,
@@ -787,6 +831,27 @@ struct SPIDriver {
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Starts a DMA chain.
+ * @details This asynchronous function starts the transfer of all the
+ *          segments of a chain.
+ * @post    At the end of the operation the configured callback is invoked.
+ * @note    The chip selects are driven by the DSPI using the PCS bits of
+ *          the PUSHR words, the @p ssport/@p sspad line is not used.
+ * @note    This function can be invoked from the end callback in order to
+ *          restart the chain.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] chp       pointer to an initialized @p SPIChain object
+ *
+ * @iclass
+ */
+#define spc5SPIStartChainI(spip, chp) {                                     \
+  _spi_pm_lock(spip);                                                       \
+  (spip)->state = SPI_ACTIVE;                                               \
+  spi_lld_start_chain(spip, chp);                                           \
+}
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -837,6 +902,13 @@ extern "C" {
   void spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf);
   void spi_lld_receive(SPIDriver *spip, size_t n, void *rxbuf);
   uint16_t spi_lld_polled_exchange(SPIDriver *spip, uint16_t frame);
+#if SPC5_SPI_DMA_MODE == SPC5_SPI_DMA_RX_AND_TX
+  void spi_lld_start_chain(SPIDriver *spip, const SPIChain *chp);
+  void spc5SPIChainObjectInit(SPIDriver *spip, SPIChain *chp,
+                              const SPIChainSegment *segs, size_t n,
+                              edma_tcd_t *txtcds, edma_tcd_t *rxtcds);
+  void spc5SPIStartChain(SPIDriver *spip, const SPIChain *chp);
+#endif
 #ifdef __cplusplus
 }
 #endif
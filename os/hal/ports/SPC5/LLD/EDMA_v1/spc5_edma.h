@@ -36,6 +36,12 @@
  */
 #define EDMA_ERROR                  -1
 
+/**
+ * @brief   Required alignment of TCDs in memory.
+ * @note    Scatter-gather TCDs must be aligned to this boundary.
+ */
+#define EDMA_TCD_ALIGNMENT          32U
+
 /**
  * @name    EDMA CR register definitions
  * @{
@@ -984,6 +990,78 @@ typedef struct {
                                             EDMA_TCD_MODE_MLINKCH(linkch)); \
 }
 
+/**
+ * @brief   TCD setup in memory.
+ * @details The TCD is prepared for later loading into a channel, it can
+ *          be part of a scatter-gather chain.
+ *
+ * @param[out] tcdp     pointer to an @p edma_tcd_t structure
+ * @param[in] src       source address
+ * @param[in] dst       destination address
+ * @param[in] soff      source address offset
+ * @param[in] doff      destination address offset
+ * @param[in] ssize     source transfer size
+ * @param[in] dsize     destination transfer size
+ * @param[in] nbytes    minor loop count
+ * @param[in] iter      major loop count
+ * @param[in] dlast     last destination address adjustment
+ * @param[in] slast     last source address adjustment
+ * @param[in] mode      LSW of TCD register 7
+ *
+ * @api
+ */
+#define edmaTCDSetup(tcdp, src, dst, soff, doff, ssize, dsize,              \
+                     nbytes, iter, slast, dlast, mode) {                    \
+  edmaTCDSetWord0(tcdp, src);                                               \
+  edmaTCDSetWord1(tcdp, ssize, dsize, soff);                                \
+  edmaTCDSetWord2(tcdp, nbytes);                                            \
+  edmaTCDSetWord3(tcdp, slast);                                             \
+  edmaTCDSetWord4(tcdp, dst);                                               \
+  edmaTCDSetWord5(tcdp, iter, doff);                                        \
+  edmaTCDSetWord6(tcdp, dlast);                                             \
+  edmaTCDSetWord7(tcdp, iter, mode);                                        \
+}
+
+/**
+ * @brief   Links a TCD to the next TCD of a scatter-gather chain.
+ * @details At the end of the major loop the eDMA loads the next TCD into
+ *          the channel and continues without CPU intervention.
+ * @pre     The next TCD must be aligned to @p EDMA_TCD_ALIGNMENT.
+ * @note    The dlast field is replaced by the next TCD address, the
+ *          destination address is not adjusted at the end of the major
+ *          loop.
+ *
+ * @param[in,out] tcdp  pointer to an @p edma_tcd_t structure
+ * @param[in] nexttcdp  pointer to the next @p edma_tcd_t structure
+ *
+ * @api
+ */
+#define edmaTCDSetNext(tcdp, nexttcdp) {                                    \
+  (tcdp)->word[6]  = (uint32_t)(nexttcdp);                                  \
+  (tcdp)->word[7] |= EDMA_TCD_MODE_SG;                                      \
+}
+
+/**
+ * @brief   Loads a TCD from memory into an EDMA channel.
+ * @details The first TCD of a scatter-gather chain is loaded this way, the
+ *          following ones are loaded by the eDMA itself.
+ * @pre     The channel must be stopped.
+ * @note    The word 7 is written last because it contains the mode bits.
+ *
+ * @param[in] channel   eDMA channel number
+ * @param[in] tcdp      pointer to the @p edma_tcd_t structure to be loaded
+ *
+ * @api
+ */
+#define edmaChannelLoadTCD(channel, tcdp) {                                 \
+  edma_tcd_t *dtcdp = edmaGetTCD(channel);                                  \
+  const edma_tcd_t *stcdp = (tcdp);                                         \
+  unsigned i;                                                               \
+  for (i = 0U; i < 8U; i++) {                                               \
+    dtcdp->word[i] = stcdp->word[i];                                        \
+  }                                                                         \
+}
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -66,6 +66,31 @@ ADCDriver ADCD3;
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (CACHE_DMA_MAINTENANCE_ENABLED == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Makes the converted samples visible to the CPU.
+ * @details The buffer part is the same passed to the callback.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ * @param[in] half      @p true for the half transfer event
+ */
+static void adc_lld_cache_samples(ADCDriver *adcp, bool half) {
+  size_t row = (size_t)adcp->grpp->num_channels * sizeof (adcsample_t);
+  size_t first = ((size_t)adcp->depth / 2U) * row;
+
+  if (half) {
+    cacheDMAAfterRx(adcp->samples, first);
+  }
+  else if (adcp->grpp->circular && (adcp->depth > 1U)) {
+    cacheDMAAfterRx((uint8_t *)adcp->samples + first,
+                    ((size_t)adcp->depth * row) - first);
+  }
+  else {
+    cacheDMAAfterRx(adcp->samples, (size_t)adcp->depth * row);
+  }
+}
+#endif
+
 /**
  * @brief   ADC DMA ISR service routine.
  *
@@ -87,16 +112,68 @@ static void adc_lld_serve_rx_interrupt(ADCDriver *adcp, uint32_t flags) {
 
       if ((flags & STM32_DMA_ISR_TCIF) != 0) {
         /* Transfer complete processing.*/
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+        adc_lld_cache_samples(adcp, false);
+#endif
         _adc_isr_full_code(adcp);
       }
       else if ((flags & STM32_DMA_ISR_HTIF) != 0) {
         /* Half transfer processing.*/
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+        adc_lld_cache_samples(adcp, true);
+#endif
         _adc_isr_half_code(adcp);
       }
     }
   }
 }
 
+/**
+ * @brief   ADC injected conversions service routine.
+ * @details The injected data registers are read and passed to the
+ *          injected group callback.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ */
+static void adc_lld_serve_injected(ADCDriver *adcp) {
+  const ADCInjectedGroup *igrpp = adcp->igrpp;
+  volatile uint32_t *jdrp = &adcp->adc->JDR1;
+  adc_channels_num_t i;
+
+  for (i = 0U; i < igrpp->num_channels; i++) {
+    adcp->isamples[i] = (adcsample_t)jdrp[i];
+  }
+  igrpp->end_cb(adcp, adcp->isamples, (size_t)igrpp->num_channels);
+}
+
+/**
+ * @brief   Returns the CR1 bits required by the injected group.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ * @return              The CR1 bits.
+ */
+static uint32_t adc_lld_injected_cr1(ADCDriver *adcp) {
+
+  if (adcp->igrpp == NULL) {
+    return 0U;
+  }
+  return ADC_CR1_JEOCIE | ADC_CR1_SCAN;
+}
+
+/**
+ * @brief   Returns the CR2 bits required by the injected group.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ * @return              The CR2 bits.
+ */
+static uint32_t adc_lld_injected_cr2(ADCDriver *adcp) {
+
+  if (adcp->igrpp == NULL) {
+    return 0U;
+  }
+  return adcp->igrpp->cr2 & (ADC_CR2_JEXTEN_MASK | ADC_CR2_JEXTSEL_MASK);
+}
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -129,6 +206,9 @@ OSAL_IRQ_HANDLER(STM32_ADC_HANDLER) {
       _adc_isr_error_code(&ADCD1, ADC_ERR_WATCHDOG);
     }
   }
+  if ((sr & ADC_SR_JEOC) && (ADCD1.igrpp != NULL)) {
+    adc_lld_serve_injected(&ADCD1);
+  }
 #if defined(STM32_ADC_ADC1_IRQ_HOOK)
   STM32_ADC_ADC1_IRQ_HOOK
 #endif
@@ -150,6 +230,9 @@ OSAL_IRQ_HANDLER(STM32_ADC_HANDLER) {
       _adc_isr_error_code(&ADCD2, ADC_ERR_WATCHDOG);
     }
   }
+  if ((sr & ADC_SR_JEOC) && (ADCD2.igrpp != NULL)) {
+    adc_lld_serve_injected(&ADCD2);
+  }
 #if defined(STM32_ADC_ADC2_IRQ_HOOK)
   STM32_ADC_ADC2_IRQ_HOOK
 #endif
@@ -171,6 +254,9 @@ OSAL_IRQ_HANDLER(STM32_ADC_HANDLER) {
       _adc_isr_error_code(&ADCD3, ADC_ERR_WATCHDOG);
     }
   }
+  if ((sr & ADC_SR_JEOC) && (ADCD3.igrpp != NULL)) {
+    adc_lld_serve_injected(&ADCD3);
+  }
 #if defined(STM32_ADC_ADC3_IRQ_HOOK)
   STM32_ADC_ADC3_IRQ_HOOK
 #endif
@@ -195,6 +281,7 @@ void adc_lld_init(void) {
   /* Driver initialization.*/
   adcObjectInit(&ADCD1);
   ADCD1.adc = ADC1;
+  ADCD1.igrpp = NULL;
   ADCD1.dmastp  = STM32_DMA_STREAM(STM32_ADC_ADC1_DMA_STREAM);
   ADCD1.dmamode = STM32_DMA_CR_CHSEL(ADC1_DMA_CHANNEL) |
                   STM32_DMA_CR_PL(STM32_ADC_ADC1_DMA_PRIORITY) |
@@ -208,6 +295,7 @@ void adc_lld_init(void) {
   /* Driver initialization.*/
   adcObjectInit(&ADCD2);
   ADCD2.adc = ADC2;
+  ADCD2.igrpp = NULL;
   ADCD2.dmastp  = STM32_DMA_STREAM(STM32_ADC_ADC2_DMA_STREAM);
   ADCD2.dmamode = STM32_DMA_CR_CHSEL(ADC2_DMA_CHANNEL) |
                   STM32_DMA_CR_PL(STM32_ADC_ADC2_DMA_PRIORITY) |
@@ -221,6 +309,7 @@ void adc_lld_init(void) {
   /* Driver initialization.*/
   adcObjectInit(&ADCD3);
   ADCD3.adc = ADC3;
+  ADCD3.igrpp = NULL;
   ADCD3.dmastp  = STM32_DMA_STREAM(STM32_ADC_ADC3_DMA_STREAM);
   ADCD3.dmamode = STM32_DMA_CR_CHSEL(ADC3_DMA_CHANNEL) |
                   STM32_DMA_CR_PL(STM32_ADC_ADC3_DMA_PRIORITY) |
@@ -312,6 +401,7 @@ void adc_lld_stop(ADCDriver *adcp) {
     dmaStreamRelease(adcp->dmastp);
     adcp->adc->CR1 = 0;
     adcp->adc->CR2 = 0;
+    adcp->igrpp = NULL;
 
 #if STM32_ADC_USE_ADC1
     if (&ADCD1 == adcp)
@@ -352,6 +442,10 @@ void adc_lld_start_conversion(ADCDriver *adcp) {
       mode |= STM32_DMA_CR_HTIE;
     }
   }
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  cacheDMABeforeRx(adcp->samples, (size_t)grpp->num_channels *
+                                  (size_t)adcp->depth * sizeof (adcsample_t));
+#endif
   dmaStreamSetMemory0(adcp->dmastp, adcp->samples);
   dmaStreamSetTransactionSize(adcp->dmastp, (uint32_t)grpp->num_channels *
                                             (uint32_t)adcp->depth);
@@ -368,11 +462,13 @@ void adc_lld_start_conversion(ADCDriver *adcp) {
   adcp->adc->SQR2  = grpp->sqr2;
   adcp->adc->SQR3  = grpp->sqr3;
 
-  /* ADC configuration and start.*/
-  adcp->adc->CR1   = grpp->cr1 | ADC_CR1_OVRIE | ADC_CR1_SCAN;
+  /* ADC configuration and start, an active injected group is preserved.*/
+  adcp->adc->CR1   = grpp->cr1 | ADC_CR1_OVRIE | ADC_CR1_SCAN |
+                     adc_lld_injected_cr1(adcp);
 
   /* Enforcing the mandatory bits in CR2.*/
-  cr2 = grpp->cr2 | ADC_CR2_DMA | ADC_CR2_DDS | ADC_CR2_ADON;
+  cr2 = grpp->cr2 | ADC_CR2_DMA | ADC_CR2_DDS | ADC_CR2_ADON |
+        adc_lld_injected_cr2(adcp);
 
   /* The start method is different dependign if HW or SW triggered, the
      start is performed using the method specified in the CR2 configuration.*/
@@ -397,10 +493,77 @@ void adc_lld_start_conversion(ADCDriver *adcp) {
 void adc_lld_stop_conversion(ADCDriver *adcp) {
 
   dmaStreamDisable(adcp->dmastp);
-  adcp->adc->CR1 = 0;
+  adcp->adc->CR1 = adc_lld_injected_cr1(adcp);
   /* Because ticket #822, preserving injected conversions.*/
   adcp->adc->CR2 &= ~(ADC_CR2_SWSTART);
-  adcp->adc->CR2 = ADC_CR2_ADON;
+  adcp->adc->CR2 = ADC_CR2_ADON | adc_lld_injected_cr2(adcp);
+}
+
+/**
+ * @brief   Starts hardware triggered injected conversions.
+ * @details The injected group is converted on each trigger event, usually
+ *          the TRGO output or a compare channel of the timer generating
+ *          the PWM, the timer is configured using the @p cr2 field of
+ *          @p PWMConfig. The injected data registers are read in the ADC
+ *          interrupt handler and the callback is invoked with the samples
+ *          so the whole control loop is executed in a single interrupt
+ *          synchronized with the PWM period.
+ * @note    The callback is invoked at @p STM32_ADC_IRQ_PRIORITY, the
+ *          priority should be set high enough for the control loop.
+ * @note    Regular conversions can be started and stopped while injected
+ *          conversions are active, the injected group is preserved.
+ * @note    This is an STM32-only functionality.
+ * @note    This function is meant to be called after @p adcStart().
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ * @param[in] igrpp     pointer to the @p ADCInjectedGroup object
+ *
+ * @api
+ */
+void adcSTM32StartInjectedConversion(ADCDriver *adcp,
+                                     const ADCInjectedGroup *igrpp) {
+
+  osalDbgCheck((adcp != NULL) && (igrpp != NULL) &&
+               (igrpp->num_channels >= 1U) &&
+               (igrpp->num_channels <= 4U) &&
+               (igrpp->end_cb != NULL) &&
+               ((igrpp->cr2 & ADC_CR2_JEXTEN_MASK) != 0U));
+
+  osalSysLock();
+  osalDbgAssert((adcp->state != ADC_UNINIT) && (adcp->state != ADC_STOP),
+                "not started");
+  osalDbgAssert(adcp->igrpp == NULL, "injected conversion already active");
+  adcp->igrpp = igrpp;
+  adcp->adc->SMPR1 = igrpp->smpr1;
+  adcp->adc->SMPR2 = igrpp->smpr2;
+  adcp->adc->JSQR  = igrpp->jsqr | ADC_JSQR_NUM_CH(igrpp->num_channels);
+  adcp->adc->SR    = ~ADC_SR_JEOC;
+  adcp->adc->CR1  |= adc_lld_injected_cr1(adcp);
+  adcp->adc->CR2   = (adcp->adc->CR2 & ~(ADC_CR2_JEXTEN_MASK |
+                                         ADC_CR2_JEXTSEL_MASK |
+                                         ADC_CR2_SWSTART)) |
+                     adc_lld_injected_cr2(adcp);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Stops hardware triggered injected conversions.
+ * @note    This is an STM32-only functionality.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ *
+ * @api
+ */
+void adcSTM32StopInjectedConversion(ADCDriver *adcp) {
+
+  osalDbgCheck(adcp != NULL);
+
+  osalSysLock();
+  adcp->adc->CR2 &= ~(ADC_CR2_JEXTEN_MASK | ADC_CR2_JEXTSEL_MASK |
+                      ADC_CR2_SWSTART);
+  adcp->adc->CR1 &= ~ADC_CR1_JEOCIE;
+  adcp->igrpp = NULL;
+  osalSysUnlock();
 }
 
 /**
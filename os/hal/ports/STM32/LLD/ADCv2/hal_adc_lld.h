@@ -31,6 +31,11 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Streaming to buffers queue support flag.
+ */
+#define ADC_SUPPORTS_STREAMING          TRUE
+
 /**
  * @name    Absolute Maximum Ratings
  * @{
@@ -62,7 +67,62 @@
 
 #define ADC_CR2_EXTSEL_MASK     (15U << 24U)
 #define ADC_CR2_EXTSEL_SRC(n)   ((n) << 24U)
+
+#define ADC_CR2_JEXTEN_MASK     (3U << 20U)
+#define ADC_CR2_JEXTEN_DISABLED (0U << 20U)
+#define ADC_CR2_JEXTEN_RISING   (1U << 20U)
+#define ADC_CR2_JEXTEN_FALLING  (2U << 20U)
+#define ADC_CR2_JEXTEN_BOTH     (3U << 20U)
+
+#define ADC_CR2_JEXTSEL_MASK    (15U << 16U)
+#define ADC_CR2_JEXTSEL_SRC(n)  ((n) << 16U)
+/** @} */
+
+#if defined(STM32F4XX) || defined(__DOXYGEN__)
+/**
+ * @name    Regular group triggers
+ * @{
+ */
+#define ADC_CR2_EXTSEL_TIM1_CC1 ADC_CR2_EXTSEL_SRC(0U)
+#define ADC_CR2_EXTSEL_TIM1_CC2 ADC_CR2_EXTSEL_SRC(1U)
+#define ADC_CR2_EXTSEL_TIM1_CC3 ADC_CR2_EXTSEL_SRC(2U)
+#define ADC_CR2_EXTSEL_TIM2_CC2 ADC_CR2_EXTSEL_SRC(3U)
+#define ADC_CR2_EXTSEL_TIM2_CC3 ADC_CR2_EXTSEL_SRC(4U)
+#define ADC_CR2_EXTSEL_TIM2_CC4 ADC_CR2_EXTSEL_SRC(5U)
+#define ADC_CR2_EXTSEL_TIM2_TRGO ADC_CR2_EXTSEL_SRC(6U)
+#define ADC_CR2_EXTSEL_TIM3_CC1 ADC_CR2_EXTSEL_SRC(7U)
+#define ADC_CR2_EXTSEL_TIM3_TRGO ADC_CR2_EXTSEL_SRC(8U)
+#define ADC_CR2_EXTSEL_TIM4_CC4 ADC_CR2_EXTSEL_SRC(9U)
+#define ADC_CR2_EXTSEL_TIM5_CC1 ADC_CR2_EXTSEL_SRC(10U)
+#define ADC_CR2_EXTSEL_TIM5_CC2 ADC_CR2_EXTSEL_SRC(11U)
+#define ADC_CR2_EXTSEL_TIM5_CC3 ADC_CR2_EXTSEL_SRC(12U)
+#define ADC_CR2_EXTSEL_TIM8_CC1 ADC_CR2_EXTSEL_SRC(13U)
+#define ADC_CR2_EXTSEL_TIM8_TRGO ADC_CR2_EXTSEL_SRC(14U)
+#define ADC_CR2_EXTSEL_EXTI11   ADC_CR2_EXTSEL_SRC(15U)
+/** @} */
+
+/**
+ * @name    Injected group triggers
+ * @{
+ */
+#define ADC_CR2_JEXTSEL_TIM1_CC4 ADC_CR2_JEXTSEL_SRC(0U)
+#define ADC_CR2_JEXTSEL_TIM1_TRGO ADC_CR2_JEXTSEL_SRC(1U)
+#define ADC_CR2_JEXTSEL_TIM2_CC1 ADC_CR2_JEXTSEL_SRC(2U)
+#define ADC_CR2_JEXTSEL_TIM2_TRGO ADC_CR2_JEXTSEL_SRC(3U)
+#define ADC_CR2_JEXTSEL_TIM3_CC2 ADC_CR2_JEXTSEL_SRC(4U)
+#define ADC_CR2_JEXTSEL_TIM3_CC4 ADC_CR2_JEXTSEL_SRC(5U)
+#define ADC_CR2_JEXTSEL_TIM4_CC1 ADC_CR2_JEXTSEL_SRC(6U)
+#define ADC_CR2_JEXTSEL_TIM4_CC2 ADC_CR2_JEXTSEL_SRC(7U)
+#define ADC_CR2_JEXTSEL_TIM4_CC3 ADC_CR2_JEXTSEL_SRC(8U)
+#define ADC_CR2_JEXTSEL_TIM4_TRGO ADC_CR2_JEXTSEL_SRC(9U)
+#define ADC_CR2_JEXTSEL_TIM5_CC4 ADC_CR2_JEXTSEL_SRC(10U)
+#define ADC_CR2_JEXTSEL_TIM5_TRGO ADC_CR2_JEXTSEL_SRC(11U)
+#define ADC_CR2_JEXTSEL_TIM8_CC2 ADC_CR2_JEXTSEL_SRC(12U)
+#define ADC_CR2_JEXTSEL_TIM8_CC3 ADC_CR2_JEXTSEL_SRC(13U)
+#define ADC_CR2_JEXTSEL_TIM8_CC4 ADC_CR2_JEXTSEL_SRC(14U)
+#define ADC_CR2_JEXTSEL_EXTI15  ADC_CR2_JEXTSEL_SRC(15U)
 /** @} */
+#endif /* defined(STM32F4XX) */
 
 /**
  * @name    ADC clock divider settings
@@ -419,6 +479,67 @@ typedef struct {
   uint32_t                  sqr3;
 } ADCConversionGroup;
 
+/**
+ * @brief   Type of an ADC injected group end callback.
+ * @details The callback is invoked from the ADC interrupt handler with the
+ *          converted injected channels, it is meant to run the whole
+ *          computation of a control loop.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object triggering the
+ *                      callback
+ * @param[in] buffer    pointer to the injected samples, the buffer is
+ *                      only valid during the callback
+ * @param[in] n         number of injected channels
+ */
+typedef void (*adcinjcallback_t)(ADCDriver *adcp,
+                                 const adcsample_t *buffer,
+                                 size_t n);
+
+/**
+ * @brief   ADC injected conversion group.
+ * @details Injected conversions are hardware triggered, typically by the
+ *          TRGO or a compare channel of the timer driving the PWM. The
+ *          converted samples are read from the injected data registers
+ *          and passed to the callback without further interrupts.
+ * @note    Injected conversions run alongside regular conversion groups,
+ *          the sampling times registers are shared with the regular
+ *          groups.
+ * @note    This is an STM32-only functionality.
+ */
+typedef struct {
+  /**
+   * @brief   Number of the injected channels, from 1 to 4.
+   */
+  adc_channels_num_t        num_channels;
+  /**
+   * @brief   Callback function associated to the injected group.
+   */
+  adcinjcallback_t          end_cb;
+  /**
+   * @brief   ADC CR2 injected trigger bits.
+   * @note    Only the @p ADC_CR2_JEXTEN and @p ADC_CR2_JEXTSEL fields
+   *          are used, the trigger must be enabled.
+   */
+  uint32_t                  cr2;
+  /**
+   * @brief   ADC SMPR1 register initialization data.
+   * @note    Overwritten by regular conversion groups.
+   */
+  uint32_t                  smpr1;
+  /**
+   * @brief   ADC SMPR2 register initialization data.
+   * @note    Overwritten by regular conversion groups.
+   */
+  uint32_t                  smpr2;
+  /**
+   * @brief   ADC JSQR register initialization data.
+   * @note    The sequence length is set by the driver from
+   *          @p num_channels, the channels are in the last positions
+   *          of the register as for the hardware specification.
+   */
+  uint32_t                  jsqr;
+} ADCInjectedGroup;
+
 /**
  * @brief   Driver configuration structure.
  * @note    It could be empty on some architectures.
@@ -463,6 +584,16 @@ struct ADCDriver {
    */
   mutex_t                   mutex;
 #endif /* ADC_USE_MUTUAL_EXCLUSION */
+#if (ADC_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Streaming queue or @p NULL.
+   */
+  input_buffers_queue_t     *ibqp;
+  /**
+   * @brief   Number of half buffers lost while streaming.
+   */
+  uint32_t                  overruns;
+#endif /* ADC_USE_STREAMING */
 #if defined(ADC_DRIVER_EXT_FIELDS)
   ADC_DRIVER_EXT_FIELDS
 #endif
@@ -479,6 +610,14 @@ struct ADCDriver {
    * @brief DMA mode bit mask.
    */
   uint32_t                  dmamode;
+  /**
+   * @brief Current injected group pointer or @p NULL.
+   */
+  const ADCInjectedGroup    *igrpp;
+  /**
+   * @brief Injected samples buffer.
+   */
+  adcsample_t               isamples[4];
 };
 
 /*===========================================================================*/
@@ -514,6 +653,21 @@ struct ADCDriver {
 #define ADC_SQR1_SQ16_N(n)      ((n) << 15) /**< @brief 16th channel in seq.*/
 /** @} */
 
+/**
+ * @name    Injected sequences building helper macros
+ * @{
+ */
+/**
+ * @brief   Number of channels in an injected sequence.
+ */
+#define ADC_JSQR_NUM_CH(n)      (((n) - 1) << 20)
+
+#define ADC_JSQR_JSQ1_N(n)      ((n) << 0)  /**< @brief 1st position.       */
+#define ADC_JSQR_JSQ2_N(n)      ((n) << 5)  /**< @brief 2nd position.       */
+#define ADC_JSQR_JSQ3_N(n)      ((n) << 10) /**< @brief 3rd position.       */
+#define ADC_JSQR_JSQ4_N(n)      ((n) << 15) /**< @brief 4th position.       */
+/** @} */
+
 /**
  * @name    Sampling rate settings helper macros
  * @{
@@ -584,6 +738,9 @@ extern "C" {
   void adcSTM32DisableTSVREFE(void);
   void adcSTM32EnableVBATE(void);
   void adcSTM32DisableVBATE(void);
+  void adcSTM32StartInjectedConversion(ADCDriver *adcp,
+                                       const ADCInjectedGroup *igrpp);
+  void adcSTM32StopInjectedConversion(ADCDriver *adcp);
 #ifdef __cplusplus
 }
 #endif
@@ -889,6 +889,9 @@ void adc_lld_start_conversion(ADCDriver *adcp) {
   adcp->adcm->CFGR  = cfgr;
 #if (STM32_ADCV3_OVERSAMPLING == TRUE) || defined(__DOXYGEN__)
   adcp->adcm->CFGR2 = grpp->cfgr2;
+#if STM32_ADC_DUAL_MODE
+  adcp->adcs->CFGR2 = grpp->cfgr2;
+#endif
 #endif
 
   /* Starting conversion.*/
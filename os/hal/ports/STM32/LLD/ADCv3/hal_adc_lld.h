@@ -31,6 +31,11 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Streaming to buffers queue support flag.
+ */
+#define ADC_SUPPORTS_STREAMING          TRUE
+
 /**
  * @name    Available analog channels
  * @{
@@ -131,12 +136,35 @@
 #define ADC_CFGR_AWD1_SINGLE(n)         (((n) << 26) | (1 << 23) | (1 << 22))
 /** @} */
 
+/**
+ * @name    CFGR2 register configuration helpers
+ * @note    The oversampler enable bits are @p ADC_CFGR2_ROVSE,
+ *          @p ADC_CFGR2_JOVSE, @p ADC_CFGR2_TROVS and @p ADC_CFGR2_ROVSM
+ *          from the ST header.
+ * @{
+ */
+#define ADC_CFGR2_OVSR_MASK             (7 << 2)
+#define ADC_CFGR2_OVSR_2X               (0 << 2)
+#define ADC_CFGR2_OVSR_4X               (1 << 2)
+#define ADC_CFGR2_OVSR_8X               (2 << 2)
+#define ADC_CFGR2_OVSR_16X              (3 << 2)
+#define ADC_CFGR2_OVSR_32X              (4 << 2)
+#define ADC_CFGR2_OVSR_64X              (5 << 2)
+#define ADC_CFGR2_OVSR_128X             (6 << 2)
+#define ADC_CFGR2_OVSR_256X             (7 << 2)
+#define ADC_CFGR2_OVSS_MASK             (15 << 5)
+#define ADC_CFGR2_OVSS_FIELD(n)         ((n) << 5)
+/** @} */
+
 /**
  * @name    CCR register configuration helpers
  * @{
  */
 #define ADC_CCR_DUAL_MASK               (31 << 0)
 #define ADC_CCR_DUAL_FIELD(n)           ((n) << 0)
+#define ADC_CCR_DUAL_INDEPENDENT        ADC_CCR_DUAL_FIELD(0)
+#define ADC_CCR_DUAL_REG_SIMULT         ADC_CCR_DUAL_FIELD(6)
+#define ADC_CCR_DUAL_REG_INTERLEAVED    ADC_CCR_DUAL_FIELD(7)
 #define ADC_CCR_DELAY_MASK              (15 << 8)
 #define ADC_CCR_DELAY_FIELD(n)          ((n) << 8)
 #define ADC_CCR_DMACFG_MASK             (1 << 13)
@@ -721,11 +749,11 @@ typedef struct {
 #if (STM32_ADCV3_OVERSAMPLING == TRUE) || defined(__DOXYGEN__)
   /**
    * @brief   ADC CFGR2 register initialization data.
-   * @note    The bits DMAEN and DMACFG are enforced internally
-   *          to the driver, keep them to zero.
-   * @note    The bits @p ADC_CFGR_CONT or @p ADC_CFGR_DISCEN must be
-   *          specified in continuous mode or if the buffer depth is
-   *          greater than one.
+   * @details Configures the hardware oversampler, the accumulated result
+   *          is right shifted by the OVSS field.
+   * @note    The ratio and the shift must keep the results within the
+   *          sample size.
+   * @note    In dual mode the setting is applied to both the ADCs.
    */
   uint32_t                  cfgr2;
 #endif
@@ -736,7 +764,14 @@ typedef struct {
 #if STM32_ADC_DUAL_MODE || defined(__DOXYGEN__)
   /**
    * @brief   ADC CCR register initialization data.
-   * @note    Put this field to zero if not using oversampling.
+   * @details Selects the dual mode, for example
+   *          @p ADC_CCR_DUAL_REG_INTERLEAVED with the sampling phases
+   *          distance in the DELAY field. Master and slave results are
+   *          transferred as a single DMA item, the master result in the
+   *          lower half, so the samples alternate in the buffer.
+   * @note    The bits CKMODE and MDMA are enforced internally to the
+   *          driver, keep them to zero.
+   * @note    This field is only present in dual mode.
    */
   uint32_t                  ccr;
 #endif
@@ -808,6 +843,16 @@ struct ADCDriver {
    */
   mutex_t                   mutex;
 #endif /* ADC_USE_MUTUAL_EXCLUSION */
+#if (ADC_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Streaming queue or @p NULL.
+   */
+  input_buffers_queue_t     *ibqp;
+  /**
+   * @brief   Number of half buffers lost while streaming.
+   */
+  uint32_t                  overruns;
+#endif /* ADC_USE_STREAMING */
 #if defined(ADC_DRIVER_EXT_FIELDS)
   ADC_DRIVER_EXT_FIELDS
 #endif
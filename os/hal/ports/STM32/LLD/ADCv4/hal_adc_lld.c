@@ -177,6 +177,31 @@ static void adc_lld_stop_adc(ADCDriver *adcp) {
   }
 }
 
+#if (CACHE_DMA_MAINTENANCE_ENABLED == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Makes the converted samples visible to the CPU.
+ * @details The buffer part is the same passed to the callback.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ * @param[in] half      @p true for the half transfer event
+ */
+static void adc_lld_cache_samples(ADCDriver *adcp, bool half) {
+  size_t row = (size_t)adcp->grpp->num_channels * sizeof (adcsample_t);
+  size_t first = ((size_t)adcp->depth / 2U) * row;
+
+  if (half) {
+    cacheDMAAfterRx(adcp->samples, first);
+  }
+  else if (adcp->grpp->circular && (adcp->depth > 1U)) {
+    cacheDMAAfterRx((uint8_t *)adcp->samples + first,
+                    ((size_t)adcp->depth * row) - first);
+  }
+  else {
+    cacheDMAAfterRx(adcp->samples, (size_t)adcp->depth * row);
+  }
+}
+#endif
+
 /**
  * @brief   ADC DMA ISR service routine.
  *
@@ -197,10 +222,16 @@ static void adc_lld_serve_dma_interrupt(ADCDriver *adcp, uint32_t flags) {
     if (adcp->grpp != NULL) {
       if ((flags & STM32_DMA_ISR_TCIF) != 0) {
         /* Transfer complete processing.*/
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+        adc_lld_cache_samples(adcp, false);
+#endif
         _adc_isr_full_code(adcp);
       }
       else if ((flags & STM32_DMA_ISR_HTIF) != 0) {
         /* Half transfer processing.*/
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+        adc_lld_cache_samples(adcp, true);
+#endif
         _adc_isr_half_code(adcp);
       }
     }
@@ -489,7 +520,7 @@ void adc_lld_start_conversion(ADCDriver *adcp) {
   uint32_t dmamode, cfgr;
   const ADCConversionGroup *grpp = adcp->grpp;
 #if STM32_ADC_DUAL_MODE
-  uint32_t ccr = grpp->ccr & ~(ADC_CCR_CKMODE_MASK | ADC_CCR_MDMA_MASK);
+  uint32_t ccr = grpp->ccr & ~(ADC_CCR_CKMODE_MASK | ADC_CCR_DAMDF_MASK);
 #endif
 
   osalDbgAssert(!STM32_ADC_DUAL_MODE || ((grpp->num_channels & 1) == 0),
@@ -505,11 +536,16 @@ void adc_lld_start_conversion(ADCDriver *adcp) {
          is enabled in order to allow streaming processing.*/
       dmamode |= STM32_DMA_CR_HTIE;
     }
-    else {
-      cfgr = grpp->cfgr | ADC_CFGR_DMNGT_ONESHOT;
-    }
+  }
+  else {
+    cfgr = grpp->cfgr | ADC_CFGR_DMNGT_ONESHOT;
   }
 
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  cacheDMABeforeRx(adcp->samples, (size_t)grpp->num_channels *
+                                  (size_t)adcp->depth * sizeof (adcsample_t));
+#endif
+
   /* DMA setup.*/
   dmaStreamSetMemory0(adcp->data.dma, adcp->samples);
 #if STM32_ADC_DUAL_MODE
@@ -532,15 +568,15 @@ void adc_lld_start_conversion(ADCDriver *adcp) {
      in the conversion group configuration structure, static settings are
      preserved.*/
   adcp->adcc->CCR   = (adcp->adcc->CCR &
-                       (ADC_CCR_CKMODE_MASK | ADC_CCR_MDMA_MASK)) | ccr;
+                       (ADC_CCR_CKMODE_MASK | ADC_CCR_DAMDF_MASK)) | ccr;
 
   adcp->adcm->PCSEL = grpp->pcsel;
   adcp->adcm->LTR1  = grpp->ltr1;
   adcp->adcm->HTR1  = grpp->htr1;
-  adcp->adcm->LTR1  = grpp->ltr2;
-  adcp->adcm->HTR1  = grpp->htr2;
-  adcp->adcm->LTR1  = grpp->ltr3;
-  adcp->adcm->HTR1  = grpp->htr3;
+  adcp->adcm->LTR2  = grpp->ltr2;
+  adcp->adcm->HTR2  = grpp->htr2;
+  adcp->adcm->LTR3  = grpp->ltr3;
+  adcp->adcm->HTR3  = grpp->htr3;
   adcp->adcm->SMPR1 = grpp->smpr[0];
   adcp->adcm->SMPR2 = grpp->smpr[1];
   adcp->adcm->SQR1  = grpp->sqr[0] | ADC_SQR1_NUM_CH(grpp->num_channels / 2);
@@ -550,10 +586,10 @@ void adc_lld_start_conversion(ADCDriver *adcp) {
   adcp->adcs->PCSEL = grpp->spcsel;
   adcp->adcs->LTR1  = grpp->sltr1;
   adcp->adcs->HTR1  = grpp->shtr1;
-  adcp->adcs->LTR1  = grpp->sltr2;
-  adcp->adcs->HTR1  = grpp->shtr2;
-  adcp->adcs->LTR1  = grpp->sltr3;
-  adcp->adcs->HTR1  = grpp->shtr3;
+  adcp->adcs->LTR2  = grpp->sltr2;
+  adcp->adcs->HTR2  = grpp->shtr2;
+  adcp->adcs->LTR3  = grpp->sltr3;
+  adcp->adcs->HTR3  = grpp->shtr3;
   adcp->adcs->SMPR1 = grpp->ssmpr[0];
   adcp->adcs->SMPR2 = grpp->ssmpr[1];
   adcp->adcs->SQR1  = grpp->ssqr[0] | ADC_SQR1_NUM_CH(grpp->num_channels / 2);
@@ -561,14 +597,19 @@ void adc_lld_start_conversion(ADCDriver *adcp) {
   adcp->adcs->SQR3  = grpp->ssqr[2];
   adcp->adcs->SQR4  = grpp->ssqr[3];
 
+  /* The slave converts with the resolution and oversampling of the master,
+     the other CFGR settings are taken from the master.*/
+  adcp->adcs->CFGR  = grpp->cfgr & ADC_CFGR_RES_MASK;
+  adcp->adcs->CFGR2 = grpp->cfgr2;
+
 #else /* !STM32_ADC_DUAL_MODE */
   adcp->adcm->PCSEL = grpp->pcsel;
   adcp->adcm->LTR1  = grpp->ltr1;
   adcp->adcm->HTR1  = grpp->htr1;
-  adcp->adcm->LTR1  = grpp->ltr2;
-  adcp->adcm->HTR1  = grpp->htr2;
-  adcp->adcm->LTR1  = grpp->ltr3;
-  adcp->adcm->HTR1  = grpp->htr3;
+  adcp->adcm->LTR2  = grpp->ltr2;
+  adcp->adcm->HTR2  = grpp->htr2;
+  adcp->adcm->LTR3  = grpp->ltr3;
+  adcp->adcm->HTR3  = grpp->htr3;
   adcp->adcm->SMPR1 = grpp->smpr[0];
   adcp->adcm->SMPR2 = grpp->smpr[1];
   adcp->adcm->SQR1  = grpp->sqr[0] | ADC_SQR1_NUM_CH(grpp->num_channels);
@@ -579,6 +620,7 @@ void adc_lld_start_conversion(ADCDriver *adcp) {
 
   /* ADC configuration.*/
   adcp->adcm->CFGR  = cfgr;
+  adcp->adcm->CFGR2 = grpp->cfgr2;
 
   /* Starting conversion.*/
   adcp->adcm->CR   |= ADC_CR_ADSTART;
@@ -106,12 +106,30 @@
 #define ADC_CFGR_DISCNUM_VAL(n)         ((n) << 17U)
 /** @} */
 
+/**
+ * @name    CFGR2 register configuration helpers
+ * @note    The oversampler enable bits are @p ADC_CFGR2_ROVSE,
+ *          @p ADC_CFGR2_JOVSE, @p ADC_CFGR2_TROVS and @p ADC_CFGR2_ROVSM
+ *          from the ST header.
+ * @{
+ */
+#define ADC_CFGR2_OVSS_MASK             (15U << 5U)
+#define ADC_CFGR2_OVSS_FIELD(n)         ((n) << 5U)
+#define ADC_CFGR2_OSR_MASK              (1023U << 16U)
+#define ADC_CFGR2_OSR_RATIO(n)          (((n) - 1U) << 16U)
+#define ADC_CFGR2_LSHIFT_MASK           (15U << 28U)
+#define ADC_CFGR2_LSHIFT_FIELD(n)       ((n) << 28U)
+/** @} */
+
 /**
  * @name    CCR register configuration helpers
  * @{
  */
 #define ADC_CCR_DUAL_MASK               (31U << 0U)
 #define ADC_CCR_DUAL_FIELD(n)           ((n) << 0U)
+#define ADC_CCR_DUAL_INDEPENDENT        ADC_CCR_DUAL_FIELD(0U)
+#define ADC_CCR_DUAL_REG_SIMULT         ADC_CCR_DUAL_FIELD(6U)
+#define ADC_CCR_DUAL_REG_INTERLEAVED    ADC_CCR_DUAL_FIELD(7U)
 #define ADC_CCR_DELAY_MASK              (15U << 8U)
 #define ADC_CCR_DELAY_FIELD(n)          ((n) << 8U)
 #define ADC_CCR_DAMDF_MASK              (3U << 14U)
@@ -462,9 +480,23 @@ typedef struct {
    *          greater than one.
    */
   uint32_t                  cfgr;
+  /**
+   * @brief   ADC CFGR2 register initialization data.
+   * @details Configures the hardware oversampler, the accumulated result
+   *          is right shifted by the OVSS field.
+   * @note    Samples are transferred as 16 bits values, the ratio and
+   *          the shift must keep the results within 16 bits.
+   * @note    In dual mode the setting is applied to both the ADCs.
+   */
+  uint32_t                  cfgr2;
 #if STM32_ADC_DUAL_MODE || defined(__DOXYGEN__)
   /**
    * @brief   ADC CCR register initialization data.
+   * @details Selects the dual mode, for example
+   *          @p ADC_CCR_DUAL_REG_INTERLEAVED with the sampling phases
+   *          distance in the DELAY field. Master and slave results are
+   *          transferred as a single DMA item, the master result in the
+   *          lower half, so the samples alternate in the buffer.
    * @note    The bits CKMODE and DAMDF are enforced internally to the
    *          driver, keep them to zero.
    * @note    This field is only present in dual mode.
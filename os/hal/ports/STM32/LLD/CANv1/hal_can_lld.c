@@ -968,6 +968,117 @@ void can_lld_wakeup(CANDriver *canp) {
 }
 #endif /* CAN_USE_SLEEP_MODE */
 
+/**
+ * @brief   Programs the identifier filters.
+ * @details Each filter is mapped on a filter bank in 32 bits mask mode,
+ *          only the banks belonging to the specified driver are modified.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] fp        pointer to the filters array
+ * @param[in] n         number of filters in the array, if zero then a
+ *                      filter accepting all frames is programmed
+ *
+ * @notapi
+ */
+void can_lld_set_id_filters(CANDriver *canp,
+                            const CANIdFilter *fp,
+                            size_t n) {
+  CAN_TypeDef *fcan;
+  uint32_t i, first, last;
+  bool clock = false;
+
+  /* The filters of CAN2 are managed by CAN1, its clock must be enabled
+     temporarily if both drivers are stopped.*/
+#if STM32_CAN_USE_CAN3
+  if (canp == &CAND3) {
+    fcan  = CAN3;
+    first = 0U;
+    last  = STM32_CAN3_MAX_FILTERS;
+    rccEnableCAN3(true);
+  }
+  else
+#endif
+  {
+    fcan  = CAN1;
+#if STM32_CAN_USE_CAN1
+    clock = CAND1.state != CAN_STOP;
+#endif
+#if STM32_CAN_USE_CAN2
+    clock = clock || (CAND2.state != CAN_STOP);
+#endif
+    if (!clock) {
+      rccEnableCAN1(true);
+    }
+    first = 0U;
+    last  = STM32_CAN_MAX_FILTERS;
+#if STM32_HAS_CAN2
+    /* Banks starting from CAN2SB are assigned to CAN2.*/
+#if STM32_CAN_USE_CAN2
+    if (canp == &CAND2) {
+      first = (fcan->FMR >> 8) & 0x3FU;
+    }
+    else
+#endif
+    {
+      last = (fcan->FMR >> 8) & 0x3FU;
+    }
+#endif
+  }
+
+  osalDbgAssert(n <= (size_t)(last - first), "too many filters");
+
+  fcan->FMR |= CAN_FMR_FINIT;
+  for (i = first; i < last; i++) {
+    uint32_t fmask = 1U << i;
+
+    /* Bank disabled and set in 32 bits mask mode.*/
+    fcan->FA1R  &= ~fmask;
+    fcan->FM1R  &= ~fmask;
+    fcan->FFA1R &= ~fmask;
+    fcan->FS1R  |= fmask;
+
+    if ((i - first) < (uint32_t)n) {
+      const CANIdFilter *cfp = &fp[i - first];
+
+      if (cfp->ide == CAN_IDE_EXT) {
+        fcan->sFilterRegister[i].FR1 = (cfp->id << 3) | 4U;
+        fcan->sFilterRegister[i].FR2 = (cfp->mask << 3) | 4U;
+      }
+      else {
+        fcan->sFilterRegister[i].FR1 = cfp->id << 21;
+        fcan->sFilterRegister[i].FR2 = (cfp->mask << 21) | 4U;
+      }
+      if (cfp->mailbox == 2U) {
+        fcan->FFA1R |= fmask;
+      }
+      fcan->FA1R |= fmask;
+    }
+    else if ((i == first) && (n == 0U)) {
+      /* Default filter accepting everything in the first mailbox.*/
+      fcan->sFilterRegister[i].FR1 = 0U;
+      fcan->sFilterRegister[i].FR2 = 0U;
+      fcan->FA1R |= fmask;
+    }
+    else {
+      /* Bank not used.*/
+    }
+  }
+  fcan->FMR &= ~CAN_FMR_FINIT;
+
+  /* Clock disabled, it will be enabled again in can_lld_start().*/
+#if STM32_CAN_USE_CAN3
+  if (canp == &CAND3) {
+    rccDisableCAN3();
+  }
+  else
+#endif
+  {
+    if (!clock) {
+      rccDisableCAN1();
+    }
+  }
+}
+
 /**
  * @brief   Programs the filters.
  * @note    This is an STM32-specific API.
@@ -46,6 +46,11 @@
  */
 #define CAN_SUPPORTS_SLEEP          TRUE
 
+/**
+ * @brief   This implementation supports the portable identifier filters.
+ */
+#define CAN_SUPPORTS_ID_FILTERS     TRUE
+
 /**
  * @brief   This implementation supports three transmit mailboxes.
  */
@@ -456,6 +461,9 @@ extern "C" {
   void can_lld_sleep(CANDriver *canp);
   void can_lld_wakeup(CANDriver *canp);
 #endif /* CAN_USE_SLEEP_MODE */
+  void can_lld_set_id_filters(CANDriver *canp,
+                              const CANIdFilter *fp,
+                              size_t n);
   void canSTM32SetFilters(CANDriver *canp, uint32_t can2sb,
                           uint32_t num, const CANFilter *cfp);
 #ifdef __cplusplus
@@ -31,6 +31,11 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Streaming from buffers queue support flag.
+ */
+#define DAC_SUPPORTS_STREAMING          TRUE
+
 /**
  * @name    DAC trigger modes
  * @{
@@ -456,6 +461,16 @@ struct DACDriver {
    */
   mutex_t                   mutex;
 #endif /* DAC_USE_MUTUAL_EXCLUSION */
+#if (DAC_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Streaming queue or @p NULL.
+   */
+  output_buffers_queue_t    *obqp;
+  /**
+   * @brief   Number of half buffers not refilled while streaming.
+   */
+  uint32_t                  underruns;
+#endif /* DAC_USE_STREAMING */
 #if defined(DAC_DRIVER_EXT_FIELDS)
   DAC_DRIVER_EXT_FIELDS
 #endif
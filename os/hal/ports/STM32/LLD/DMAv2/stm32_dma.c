@@ -29,6 +29,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 
 /* The following macro is only defined if some driver requiring DMA services
@@ -101,10 +103,235 @@ static uint32_t dma_streams_mask;
  */
 static dma_isr_redir_t dma_isr_redir[STM32_DMA_STREAMS];
 
+/**
+ * @brief   Threads waiting for a stream to be freed.
+ */
+static threads_queue_t dma_waiting;
+
+#if (STM32_DMA_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Streams utilization statistics.
+ */
+static stm32_dma_stats_t dma_stats[STM32_DMA_STREAMS];
+#endif
+
+#if (STM32_DMA_USE_MEMCPY == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Memory copy operation type.
+ */
+typedef struct {
+  uint8_t               *dst;           /**< @brief Next destination.       */
+  const uint8_t         *src;           /**< @brief Next source.            */
+  size_t                n;              /**< @brief Bytes still to copy.    */
+  size_t                chunk;          /**< @brief Bytes being copied.     */
+  void                  *base;          /**< @brief Destination buffer.     */
+  size_t                size;           /**< @brief Destination size.       */
+  stm32_dmamemcpycb_t   cb;             /**< @brief End callback.           */
+  void                  *param;         /**< @brief Callback parameter.     */
+} dma_memcpy_t;
+
+/**
+ * @brief   Memory copy waiting thread type.
+ */
+typedef struct {
+  thread_reference_t    thread;         /**< @brief Waiting thread.         */
+  msg_t                 msg;            /**< @brief Copy result.            */
+  bool                  done;           /**< @brief Copy completed.         */
+} dma_memcpy_wait_t;
+
+/**
+ * @brief   Memory copy operations, one for each DMA2 stream.
+ */
+static dma_memcpy_t dma_memcpy[8];
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Marks a free stream as allocated and initializes it.
+ *
+ * @param[in] dmastp    pointer to a @p stm32_dma_stream_t structure
+ * @param[in] priority  IRQ priority for the DMA stream
+ * @param[in] func      handling function pointer, can be @p NULL
+ * @param[in] param     a parameter to be passed to the handling function
+ *
+ * @notapi
+ */
+static void dma_stream_take(const stm32_dma_stream_t *dmastp,
+                            uint32_t priority,
+                            stm32_dmaisr_t func,
+                            void *param) {
+
+  /* Marks the stream as allocated.*/
+  dma_isr_redir[dmastp->selfindex].dma_func  = func;
+  dma_isr_redir[dmastp->selfindex].dma_param = param;
+  dma_streams_mask |= (1U << dmastp->selfindex);
+
+  /* Enabling DMA clocks required by the current streams set.*/
+  if ((dma_streams_mask & STM32_DMA1_STREAMS_MASK) != 0U) {
+    rccEnableDMA1(true);
+  }
+  if ((dma_streams_mask & STM32_DMA2_STREAMS_MASK) != 0U) {
+    rccEnableDMA2(true);
+  }
+
+  /* Putting the stream in a safe state.*/
+  dmaStreamDisable(dmastp);
+  dmastp->stream->CR = STM32_DMA_CR_RESET_VALUE;
+  dmastp->stream->FCR = STM32_DMA_FCR_RESET_VALUE;
+
+  /* Enables the associated IRQ vector if a callback is defined.*/
+  if (func != NULL) {
+    nvicEnableVector(dmastp->vector, priority);
+  }
+
+#if STM32_DMA_USE_STATISTICS == TRUE
+  dma_stats[dmastp->selfindex].allocations++;
+  dma_stats[dmastp->selfindex].last = osalOsGetSystemTimeX();
+#endif
+}
+
+/**
+ * @brief   Marks an allocated stream as free.
+ *
+ * @param[in] dmastp    pointer to a @p stm32_dma_stream_t structure
+ *
+ * @notapi
+ */
+static void dma_stream_drop(const stm32_dma_stream_t *dmastp) {
+
+  /* Disables the associated IRQ vector.*/
+  nvicDisableVector(dmastp->vector);
+
+  /* Marks the stream as not allocated.*/
+  dma_streams_mask &= ~(1U << dmastp->selfindex);
+
+  /* Shutting down clocks that are no more required, if any.*/
+  if ((dma_streams_mask & STM32_DMA1_STREAMS_MASK) == 0U) {
+    rccDisableDMA1();
+  }
+  if ((dma_streams_mask & STM32_DMA2_STREAMS_MASK) == 0U) {
+    rccDisableDMA2();
+  }
+
+#if STM32_DMA_USE_STATISTICS == TRUE
+  dma_stats[dmastp->selfindex].busy +=
+      (uint32_t)osalTimeDiffX(dma_stats[dmastp->selfindex].last,
+                              osalOsGetSystemTimeX());
+#endif
+}
+
+#if (STM32_DMA_USE_MEMCPY == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the next chunk of a memory copy.
+ * @details Word transfers are used if both the addresses and the size are
+ *          aligned, chunks are limited by the 16 bits transfer counter.
+ *
+ * @param[in] dmastp    pointer to a @p stm32_dma_stream_t structure
+ *
+ * @notapi
+ */
+static void dma_memcpy_start(const stm32_dma_stream_t *dmastp) {
+  dma_memcpy_t *mcp = &dma_memcpy[dmastp->selfindex & 7U];
+  uint32_t mode = STM32_DMA_CR_PL(STM32_DMA_MEMCPY_DMA_PRIORITY) |
+                  STM32_DMA_CR_TCIE | STM32_DMA_CR_TEIE;
+  size_t n;
+
+  if ((((uint32_t)mcp->dst | (uint32_t)mcp->src | (uint32_t)mcp->n) &
+       3U) == 0U) {
+    n = mcp->n / 4U;
+    if (n > 65535U) {
+      n = 65535U;
+    }
+    mcp->chunk = n * 4U;
+    mode |= STM32_DMA_CR_PSIZE_WORD | STM32_DMA_CR_MSIZE_WORD;
+  }
+  else {
+    n = mcp->n;
+    if (n > 65535U) {
+      n = 65535U;
+    }
+    mcp->chunk = n;
+    mode |= STM32_DMA_CR_PSIZE_BYTE | STM32_DMA_CR_MSIZE_BYTE;
+  }
+
+  /* Memory-to-memory transfers require the FIFO.*/
+  dmaStreamSetFIFO(dmastp, STM32_DMA_FCR_DMDIS | STM32_DMA_FCR_FTH_FULL);
+  dmaStartMemCopy(dmastp, mode, mcp->src, mcp->dst, n);
+}
+
+/**
+ * @brief   Memory copy stream interrupt handler.
+ *
+ * @param[in] p         pointer to the @p stm32_dma_stream_t structure
+ * @param[in] flags     pre-shifted content of the ISR register
+ *
+ * @notapi
+ */
+static void dma_memcpy_serve_interrupt(void *p, uint32_t flags) {
+  const stm32_dma_stream_t *dmastp = (const stm32_dma_stream_t *)p;
+  dma_memcpy_t *mcp = &dma_memcpy[dmastp->selfindex & 7U];
+  stm32_dmamemcpycb_t cb;
+  void *param;
+  msg_t msg = MSG_OK;
+
+  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0U) {
+    msg = MSG_RESET;
+  }
+  else if ((flags & STM32_DMA_ISR_TCIF) != 0U) {
+    mcp->dst += mcp->chunk;
+    mcp->src += mcp->chunk;
+    mcp->n   -= mcp->chunk;
+
+    /* Next chunk, if any.*/
+    if (mcp->n > (size_t)0) {
+      dma_memcpy_start(dmastp);
+      return;
+    }
+  }
+  else {
+    return;
+  }
+
+  dmaStreamDisable(dmastp);
+
+  /* Lines fetched speculatively during the transfer are discarded.*/
+  cacheBufferInvalidateRange(mcp->base, mcp->size);
+
+  /* The stream is freed before invoking the callback, the operation
+     descriptor could be reused by a copy started from the callback.*/
+  cb    = mcp->cb;
+  param = mcp->param;
+  osalSysLockFromISR();
+  dmaStreamFreeI(dmastp);
+  osalSysUnlockFromISR();
+
+  if (cb != NULL) {
+    cb(param, msg);
+  }
+}
+
+/**
+ * @brief   Memory copy end callback of @p dmaMemcpy().
+ *
+ * @param[in] p         pointer to a @p dma_memcpy_wait_t structure
+ * @param[in] msg       the copy result
+ *
+ * @notapi
+ */
+static void dma_memcpy_wakeup(void *p, msg_t msg) {
+  dma_memcpy_wait_t *wp = (dma_memcpy_wait_t *)p;
+
+  osalSysLockFromISR();
+  wp->msg  = msg;
+  wp->done = true;
+  osalThreadResumeI(&wp->thread, msg);
+  osalSysUnlockFromISR();
+}
+#endif /* STM32_DMA_USE_MEMCPY == TRUE */
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -413,7 +640,12 @@ void dmaInit(void) {
   for (i = 0U; i < STM32_DMA_STREAMS; i++) {
     _stm32_dma_streams[i].stream->CR = 0U;
     dma_isr_redir[i].dma_func = NULL;
+#if STM32_DMA_USE_STATISTICS == TRUE
+    dma_stats[i].allocations = 0U;
+    dma_stats[i].busy        = 0U;
+#endif
   }
+  osalThreadQueueObjectInit(&dma_waiting);
   DMA1->LIFCR = 0xFFFFFFFFU;
   DMA1->HIFCR = 0xFFFFFFFFU;
   DMA2->LIFCR = 0xFFFFFFFFU;
@@ -455,28 +687,7 @@ bool dmaStreamAllocate(const stm32_dma_stream_t *dmastp,
   if ((dma_streams_mask & (1U << dmastp->selfindex)) != 0U)
     return true;
 
-  /* Marks the stream as allocated.*/
-  dma_isr_redir[dmastp->selfindex].dma_func  = func;
-  dma_isr_redir[dmastp->selfindex].dma_param = param;
-  dma_streams_mask |= (1U << dmastp->selfindex);
-
-  /* Enabling DMA clocks required by the current streams set.*/
-  if ((dma_streams_mask & STM32_DMA1_STREAMS_MASK) != 0U) {
-    rccEnableDMA1(true);
-  }
-  if ((dma_streams_mask & STM32_DMA2_STREAMS_MASK) != 0U) {
-    rccEnableDMA2(true);
-  }
-
-  /* Putting the stream in a safe state.*/
-  dmaStreamDisable(dmastp);
-  dmastp->stream->CR = STM32_DMA_CR_RESET_VALUE;
-  dmastp->stream->FCR = STM32_DMA_FCR_RESET_VALUE;
-
-  /* Enables the associated IRQ vector if a callback is defined.*/
-  if (func != NULL) {
-    nvicEnableVector(dmastp->vector, priority);
-  }
+  dma_stream_take(dmastp, priority, func, param);
 
   return false;
 }
@@ -502,20 +713,249 @@ void dmaStreamRelease(const stm32_dma_stream_t *dmastp) {
   osalDbgAssert((dma_streams_mask & (1U << dmastp->selfindex)) != 0U,
                 "not allocated");
 
-  /* Disables the associated IRQ vector.*/
-  nvicDisableVector(dmastp->vector);
+  dma_stream_drop(dmastp);
+}
 
-  /* Marks the stream as not allocated.*/
-  dma_streams_mask &= ~(1U << dmastp->selfindex);
+/**
+ * @brief   Allocates a free DMA stream among a set of compatible streams.
+ * @details The lowest numbered free stream in @p mask is allocated and
+ *          initialized as by @p dmaStreamAllocate().
+ * @note    The channel or request line is not known until the stream has
+ *          been selected, it must be programmed after allocation,
+ *          the channel of a stream can be obtained using
+ *          @p STM32_DMA_GETCHANNEL() with the stream @p selfindex field.
+ *
+ * @param[in] mask      mask of the compatible streams, for example
+ *                      @p STM32_DMA_STREAMS_MSK_ANY
+ * @param[in] priority  IRQ priority for the DMA stream
+ * @param[in] func      handling function pointer, can be @p NULL
+ * @param[in] param     a parameter to be passed to the handling function
+ * @return              Pointer to the allocated stream.
+ * @retval NULL         if all the compatible streams are taken.
+ *
+ * @iclass
+ */
+const stm32_dma_stream_t *dmaStreamAllocI(uint32_t mask,
+                                          uint32_t priority,
+                                          stm32_dmaisr_t func,
+                                          void *param) {
+  unsigned i;
 
-  /* Shutting down clocks that are no more required, if any.*/
-  if ((dma_streams_mask & STM32_DMA1_STREAMS_MASK) == 0U) {
-    rccDisableDMA1();
+  osalDbgCheckClassI();
+  osalDbgCheck((mask != 0U) && ((mask & ~STM32_DMA_STREAMS_MSK_ANY) == 0U));
+
+  for (i = 0U; i < STM32_DMA_STREAMS; i++) {
+    uint32_t bit = 1U << i;
+
+    if (((mask & bit) != 0U) && ((dma_streams_mask & bit) == 0U)) {
+      const stm32_dma_stream_t *dmastp = STM32_DMA_STREAM(i);
+
+      dma_stream_take(dmastp, priority, func, param);
+
+      return dmastp;
+    }
   }
-  if ((dma_streams_mask & STM32_DMA2_STREAMS_MASK) == 0U) {
-    rccDisableDMA2();
+
+  return NULL;
+}
+
+/**
+ * @brief   Allocates a free DMA stream among a set of compatible streams.
+ * @details If all the compatible streams are taken then the calling thread
+ *          waits until one is freed using @p dmaStreamFreeI() or
+ *          @p dmaStreamFree(), this allows infrequent users to time-share
+ *          streams by allocating them only for the duration of a transfer.
+ * @note    Streams released using @p dmaStreamRelease() do not wake up
+ *          waiting threads.
+ *
+ * @param[in] mask      mask of the compatible streams
+ * @param[in] priority  IRQ priority for the DMA stream
+ * @param[in] func      handling function pointer, can be @p NULL
+ * @param[in] param     a parameter to be passed to the handling function
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              Pointer to the allocated stream.
+ * @retval NULL         if a stream could not be allocated within the
+ *                      specified timeout.
+ *
+ * @api
+ */
+const stm32_dma_stream_t *dmaStreamAllocTimeout(uint32_t mask,
+                                                 uint32_t priority,
+                                                 stm32_dmaisr_t func,
+                                                 void *param,
+                                                 sysinterval_t timeout) {
+  const stm32_dma_stream_t *dmastp;
+
+  osalSysLock();
+  while (true) {
+    dmastp = dmaStreamAllocI(mask, priority, func, param);
+    if (dmastp != NULL) {
+      break;
+    }
+    if (osalThreadEnqueueTimeoutS(&dma_waiting, timeout) != MSG_OK) {
+      break;
+    }
+  }
+  osalSysUnlock();
+
+  return dmastp;
+}
+
+/**
+ * @brief   Frees a DMA stream.
+ * @details The stream is released as by @p dmaStreamRelease() and the
+ *          threads waiting in @p dmaStreamAllocTimeout() are woken up.
+ *
+ * @param[in] dmastp    pointer to a @p stm32_dma_stream_t structure
+ *
+ * @iclass
+ */
+void dmaStreamFreeI(const stm32_dma_stream_t *dmastp) {
+
+  osalDbgCheckClassI();
+
+  dmaStreamRelease(dmastp);
+  osalThreadDequeueAllI(&dma_waiting, MSG_OK);
+}
+
+/**
+ * @brief   Frees a DMA stream.
+ * @details The stream is released as by @p dmaStreamRelease() and the
+ *          threads waiting in @p dmaStreamAllocTimeout() are woken up.
+ *
+ * @param[in] dmastp    pointer to a @p stm32_dma_stream_t structure
+ *
+ * @api
+ */
+void dmaStreamFree(const stm32_dma_stream_t *dmastp) {
+
+  osalSysLock();
+  dmaStreamFreeI(dmastp);
+  osalOsRescheduleS();
+  osalSysUnlock();
+}
+
+#if (STM32_DMA_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the utilization statistics of a DMA stream.
+ * @details If the stream is currently allocated then the time elapsed since
+ *          its allocation is included in the returned busy time.
+ *
+ * @param[in] dmastp    pointer to a @p stm32_dma_stream_t structure
+ * @param[out] statsp   pointer to a @p stm32_dma_stats_t structure
+ *
+ * @iclass
+ */
+void dmaStreamGetStatsI(const stm32_dma_stream_t *dmastp,
+                        stm32_dma_stats_t *statsp) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((dmastp != NULL) && (statsp != NULL));
+
+  *statsp = dma_stats[dmastp->selfindex];
+  if ((dma_streams_mask & (1U << dmastp->selfindex)) != 0U) {
+    statsp->busy += (uint32_t)osalTimeDiffX(statsp->last,
+                                            osalOsGetSystemTimeX());
   }
 }
+#endif /* STM32_DMA_USE_STATISTICS == TRUE */
+
+#if (STM32_DMA_USE_MEMCPY == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts an asynchronous memory copy.
+ * @details A DMA2 stream is allocated for the duration of the copy, if
+ *          all the DMA2 streams are taken then the function waits for one
+ *          to be freed. The callback is invoked from ISR context when the
+ *          copy is complete and the stream has been freed.
+ * @note    The data cache lines of both buffers are maintained by the
+ *          function, the destination buffer should be aligned to a cache
+ *          line boundary and must not be accessed until the callback.
+ * @note    Both buffers must be accessible to the DMA2 controller, the CCM
+ *          and DTCM memories are not on all the devices.
+ *
+ * @param[out] dst      destination buffer
+ * @param[in] src       source buffer
+ * @param[in] n         number of bytes to be copied
+ * @param[in] cb        copy end callback, can be @p NULL
+ * @param[in] param     a parameter to be passed to the callback
+ *
+ * @api
+ */
+void dmaMemcpyAsync(void *dst, const void *src, size_t n,
+                    stm32_dmamemcpycb_t cb, void *param) {
+  const stm32_dma_stream_t *dmastp;
+  dma_memcpy_t *mcp;
+
+  osalDbgCheck((dst != NULL) && (src != NULL) && (n > (size_t)0));
+
+  /* Making sure the source is in RAM and the destination lines are not
+     written back during the transfer.*/
+  cacheBufferClean(src, n);
+  cacheBufferFlush(dst, n);
+
+  dmastp = dmaStreamAllocTimeout(STM32_DMA_STREAMS_MSK_DMA2,
+                                 STM32_DMA_MEMCPY_IRQ_PRIORITY,
+                                 dma_memcpy_serve_interrupt, NULL,
+                                 TIME_INFINITE);
+  osalDbgAssert(dmastp != NULL, "stream allocation failed");
+
+  mcp = &dma_memcpy[dmastp->selfindex & 7U];
+  mcp->dst   = (uint8_t *)dst;
+  mcp->src   = (const uint8_t *)src;
+  mcp->n     = n;
+  mcp->base  = dst;
+  mcp->size  = n;
+  mcp->cb    = cb;
+  mcp->param = param;
+
+  /* The handler locates the operation from its stream.*/
+  dma_isr_redir[dmastp->selfindex].dma_param = (void *)dmastp;
+
+  dma_memcpy_start(dmastp);
+}
+
+/**
+ * @brief   Performs a memory copy.
+ * @details Copies smaller than @p STM32_DMA_MEMCPY_THRESHOLD are performed
+ *          by the CPU, larger copies are offloaded to a DMA2 stream while
+ *          the calling thread sleeps.
+ * @note    The same buffer constraints of @p dmaMemcpyAsync() apply.
+ *
+ * @param[out] dst      destination buffer
+ * @param[in] src       source buffer
+ * @param[in] n         number of bytes to be copied
+ * @return              The operation status.
+ * @retval MSG_OK       if the copy has been performed.
+ * @retval MSG_RESET    if a DMA error occurred.
+ *
+ * @api
+ */
+msg_t dmaMemcpy(void *dst, const void *src, size_t n) {
+  dma_memcpy_wait_t w;
+
+  if (n < (size_t)STM32_DMA_MEMCPY_THRESHOLD) {
+    memcpy(dst, src, n);
+    return MSG_OK;
+  }
+
+  w.thread = NULL;
+  w.msg    = MSG_OK;
+  w.done   = false;
+  dmaMemcpyAsync(dst, src, n, dma_memcpy_wakeup, &w);
+
+  osalSysLock();
+  if (!w.done) {
+    (void) osalThreadSuspendS(&w.thread);
+  }
+  osalSysUnlock();
+
+  return w.msg;
+}
+#endif /* STM32_DMA_USE_MEMCPY == TRUE */
 
 #endif /* STM32_DMA_REQUIRED */
 
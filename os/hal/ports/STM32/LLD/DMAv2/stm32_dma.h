@@ -47,6 +47,26 @@
  */
 #define STM32_DMA_ISR_MASK          0x3DU
 
+/**
+ * @name    DMA streams masks
+ * @{
+ */
+/**
+ * @brief   Mask of all the DMA streams.
+ */
+#define STM32_DMA_STREAMS_MSK_ANY   0x0000FFFFU
+
+/**
+ * @brief   Mask of the DMA1 streams.
+ */
+#define STM32_DMA_STREAMS_MSK_DMA1  0x000000FFU
+
+/**
+ * @brief   Mask of the DMA2 streams.
+ */
+#define STM32_DMA_STREAMS_MSK_DMA2  0x0000FF00U
+/** @} */
+
 /**
  * @brief   Returns the channel associated to the specified stream.
  *
@@ -212,6 +232,43 @@
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Enables the DMA streams utilization statistics.
+ */
+#if !defined(STM32_DMA_USE_STATISTICS) || defined(__DOXYGEN__)
+#define STM32_DMA_USE_STATISTICS    FALSE
+#endif
+
+/**
+ * @brief   Enables the memory-to-memory copy service.
+ */
+#if !defined(STM32_DMA_USE_MEMCPY) || defined(__DOXYGEN__)
+#define STM32_DMA_USE_MEMCPY        FALSE
+#endif
+
+/**
+ * @brief   Memory copy size threshold.
+ * @details Copies smaller than this size are performed by the CPU in
+ *          @p dmaMemcpy().
+ */
+#if !defined(STM32_DMA_MEMCPY_THRESHOLD) || defined(__DOXYGEN__)
+#define STM32_DMA_MEMCPY_THRESHOLD  256U
+#endif
+
+/**
+ * @brief   Memory copy DMA priority (0..3|lowest..highest).
+ */
+#if !defined(STM32_DMA_MEMCPY_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_DMA_MEMCPY_DMA_PRIORITY 0
+#endif
+
+/**
+ * @brief   Memory copy DMA interrupt priority level setting.
+ */
+#if !defined(STM32_DMA_MEMCPY_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_DMA_MEMCPY_IRQ_PRIORITY 12
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -228,6 +285,25 @@
 #error "STM32_HAS_DMA2 missing in registry"
 #endif
 
+#if STM32_DMA_USE_MEMCPY == TRUE
+#if !STM32_HAS_DMA2
+#error "the memory copy service requires DMA2"
+#endif
+
+#if !STM32_DMA_IS_VALID_PRIORITY(STM32_DMA_MEMCPY_DMA_PRIORITY)
+#error "invalid DMA priority assigned to the memory copy service"
+#endif
+
+#if !OSAL_IRQ_IS_VALID_PRIORITY(STM32_DMA_MEMCPY_IRQ_PRIORITY)
+#error "invalid IRQ priority assigned to the memory copy service"
+#endif
+
+/* The DMA helper is required by the memory copy service.*/
+#if !defined(STM32_DMA_REQUIRED)
+#define STM32_DMA_REQUIRED
+#endif
+#endif /* STM32_DMA_USE_MEMCPY == TRUE */
+
 #if !defined(STM32_DMA1_CH0_HANDLER)
 #error "STM32_DMA1_CH0_HANDLER missing in registry"
 #endif
@@ -381,6 +457,30 @@ typedef struct {
  */
 typedef void (*stm32_dmaisr_t)(void *p, uint32_t flags);
 
+#if (STM32_DMA_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   STM32 DMA stream utilization statistics.
+ * @note    The allocated time is accumulated on release, intervals longer
+ *          than the system time range are not accounted correctly.
+ */
+typedef struct {
+  uint32_t              allocations;    /**< @brief Allocations counter.    */
+  uint32_t              busy;           /**< @brief Cumulative allocated
+                                             time in system ticks.          */
+  systime_t             last;           /**< @brief Time of the last
+                                             allocation.                    */
+} stm32_dma_stats_t;
+#endif
+
+/**
+ * @brief   STM32 DMA memory copy end callback type.
+ *
+ * @param[in] p         parameter for the registered function
+ * @param[in] msg       the copy result, @p MSG_OK or @p MSG_RESET if a DMA
+ *                      error occurred
+ */
+typedef void (*stm32_dmamemcpycb_t)(void *p, msg_t msg);
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -617,6 +717,26 @@ extern "C" {
                          stm32_dmaisr_t func,
                          void *param);
   void dmaStreamRelease(const stm32_dma_stream_t *dmastp);
+  const stm32_dma_stream_t *dmaStreamAllocI(uint32_t mask,
+                                           uint32_t priority,
+                                           stm32_dmaisr_t func,
+                                           void *param);
+  const stm32_dma_stream_t *dmaStreamAllocTimeout(uint32_t mask,
+                                                  uint32_t priority,
+                                                  stm32_dmaisr_t func,
+                                                  void *param,
+                                                  sysinterval_t timeout);
+  void dmaStreamFreeI(const stm32_dma_stream_t *dmastp);
+  void dmaStreamFree(const stm32_dma_stream_t *dmastp);
+#if STM32_DMA_USE_STATISTICS == TRUE
+  void dmaStreamGetStatsI(const stm32_dma_stream_t *dmastp,
+                          stm32_dma_stats_t *statsp);
+#endif
+#if STM32_DMA_USE_MEMCPY == TRUE
+  void dmaMemcpyAsync(void *dst, const void *src, size_t n,
+                      stm32_dmamemcpycb_t cb, void *param);
+  msg_t dmaMemcpy(void *dst, const void *src, size_t n);
+#endif
 #ifdef __cplusplus
 }
 #endif
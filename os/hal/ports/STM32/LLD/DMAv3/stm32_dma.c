@@ -103,12 +103,100 @@ static struct {
    * @brief   DMA IRQ redirectors.
    */
   dma_isr_redir_t       isr_redir[STM32_DMA_STREAMS];
+  /**
+   * @brief   Threads waiting for a stream to be freed.
+   */
+  threads_queue_t       waiting;
+#if (STM32_DMA_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Streams utilization statistics.
+   */
+  stm32_dma_stats_t     stats[STM32_DMA_STREAMS];
+#endif
 } dma;
 
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Marks a free stream as allocated and initializes it.
+ *
+ * @param[in] stp       pointer to a @p stm32_dma_stream_t structure
+ * @param[in] priority  IRQ priority for the DMA stream
+ * @param[in] func      handling function pointer, can be @p NULL
+ * @param[in] param     a parameter to be passed to the handling function
+ *
+ * @notapi
+ */
+static void dma_stream_take(const stm32_dma_stream_t *stp,
+                            uint32_t priority,
+                            stm32_dmaisr_t func,
+                            void *param) {
+
+  /* Marks the stream as allocated.*/
+  dma.isr_redir[stp->selfindex].func  = func;
+  dma.isr_redir[stp->selfindex].param = param;
+  dma.streams_mask |= (1U << stp->selfindex);
+
+  /* Enabling DMA clocks required by the current streams set.*/
+  if ((dma.streams_mask & STM32_DMA1_STREAMS_MASK) != 0U) {
+    rccEnableDMA1(true);
+  }
+  if ((dma.streams_mask & STM32_DMA2_STREAMS_MASK) != 0U) {
+    rccEnableDMA2(true);
+  }
+
+  /* Putting the stream in a safe state.*/
+  dmaStreamDisable(stp);
+  stp->stream->CR = STM32_DMA_CR_RESET_VALUE;
+  stp->stream->FCR = STM32_DMA_FCR_RESET_VALUE;
+
+  /* Enables the associated IRQ vector if a callback is defined.*/
+  if (func != NULL) {
+    nvicEnableVector(stp->vector, priority);
+  }
+
+#if STM32_DMA_USE_STATISTICS == TRUE
+  dma.stats[stp->selfindex].allocations++;
+  dma.stats[stp->selfindex].last = osalOsGetSystemTimeX();
+#endif
+}
+
+/**
+ * @brief   Marks an allocated stream as free.
+ *
+ * @param[in] stp       pointer to a @p stm32_dma_stream_t structure
+ *
+ * @notapi
+ */
+static void dma_stream_drop(const stm32_dma_stream_t *stp) {
+
+  /* Disables the associated IRQ vector.*/
+  nvicDisableVector(stp->vector);
+
+  /* Marks the stream as not allocated.*/
+  dma.streams_mask &= ~(1U << stp->selfindex);
+
+  /* Clearing associated handler and parameter.*/
+  dma.isr_redir[stp->selfindex].func  = NULL;
+  dma.isr_redir[stp->selfindex].param = NULL;
+
+  /* Shutting down clocks that are no more required, if any.*/
+  if ((dma.streams_mask & STM32_DMA1_STREAMS_MASK) == 0U) {
+    rccDisableDMA1();
+  }
+  if ((dma.streams_mask & STM32_DMA2_STREAMS_MASK) == 0U) {
+    rccDisableDMA2();
+  }
+
+#if STM32_DMA_USE_STATISTICS == TRUE
+  dma.stats[stp->selfindex].busy +=
+      (uint32_t)osalTimeDiffX(dma.stats[stp->selfindex].last,
+                              osalOsGetSystemTimeX());
+#endif
+}
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -418,7 +506,12 @@ void dmaInit(void) {
     _stm32_dma_streams[i].stream->CR = 0U;
     dma.isr_redir[i].func  = NULL;
     dma.isr_redir[i].param = NULL;
+#if STM32_DMA_USE_STATISTICS == TRUE
+    dma.stats[i].allocations = 0U;
+    dma.stats[i].busy        = 0U;
+#endif
   }
+  osalThreadQueueObjectInit(&dma.waiting);
   DMA1->LIFCR = 0xFFFFFFFFU;
   DMA1->HIFCR = 0xFFFFFFFFU;
   DMA2->LIFCR = 0xFFFFFFFFU;
@@ -460,28 +553,7 @@ bool dmaStreamAllocate(const stm32_dma_stream_t *stp,
   if ((dma.streams_mask & (1U << stp->selfindex)) != 0U)
     return true;
 
-  /* Marks the stream as allocated.*/
-  dma.isr_redir[stp->selfindex].func  = func;
-  dma.isr_redir[stp->selfindex].param = param;
-  dma.streams_mask |= (1U << stp->selfindex);
-
-  /* Enabling DMA clocks required by the current streams set.*/
-  if ((dma.streams_mask & STM32_DMA1_STREAMS_MASK) != 0U) {
-    rccEnableDMA1(true);
-  }
-  if ((dma.streams_mask & STM32_DMA2_STREAMS_MASK) != 0U) {
-    rccEnableDMA2(true);
-  }
-
-  /* Putting the stream in a safe state.*/
-  dmaStreamDisable(stp);
-  stp->stream->CR = STM32_DMA_CR_RESET_VALUE;
-  stp->stream->FCR = STM32_DMA_FCR_RESET_VALUE;
-
-  /* Enables the associated IRQ vector if a callback is defined.*/
-  if (func != NULL) {
-    nvicEnableVector(stp->vector, priority);
-  }
+  dma_stream_take(stp, priority, func, param);
 
   return false;
 }
@@ -523,24 +595,154 @@ void dmaStreamRelease(const stm32_dma_stream_t *stp) {
   osalDbgAssert((dma.streams_mask & (1U << stp->selfindex)) != 0U,
                 "not allocated");
 
-  /* Disables the associated IRQ vector.*/
-  nvicDisableVector(stp->vector);
+  dma_stream_drop(stp);
+}
 
-  /* Marks the stream as not allocated.*/
-  dma.streams_mask &= ~(1U << stp->selfindex);
+/**
+ * @brief   Allocates a free DMA stream among a set of compatible streams.
+ * @details The lowest numbered free stream in @p mask is allocated and
+ *          initialized as by @p dmaStreamAllocate().
+ * @note    The channel or request line is not known until the stream has
+ *          been selected, it must be programmed after allocation using @p dmaSetRequestSource().
+ *
+ * @param[in] mask      mask of the compatible streams, for example
+ *                      @p STM32_DMA_STREAMS_MSK_ANY
+ * @param[in] priority  IRQ priority for the DMA stream
+ * @param[in] func      handling function pointer, can be @p NULL
+ * @param[in] param     a parameter to be passed to the handling function
+ * @return              Pointer to the allocated stream.
+ * @retval NULL         if all the compatible streams are taken.
+ *
+ * @iclass
+ */
+const stm32_dma_stream_t *dmaStreamAllocI(uint32_t mask,
+                                          uint32_t priority,
+                                          stm32_dmaisr_t func,
+                                          void *param) {
+  unsigned i;
 
-  /* Clearing associated handler and parameter.*/
-  dma.isr_redir->func  = NULL;
-  dma.isr_redir->param = NULL;
+  osalDbgCheckClassI();
+  osalDbgCheck((mask != 0U) && ((mask & ~STM32_DMA_STREAMS_MSK_ANY) == 0U));
 
-  /* Shutting down clocks that are no more required, if any.*/
-  if ((dma.streams_mask & STM32_DMA1_STREAMS_MASK) == 0U) {
-    rccDisableDMA1();
+  for (i = 0U; i < STM32_DMA_STREAMS; i++) {
+    uint32_t bit = 1U << i;
+
+    if (((mask & bit) != 0U) && ((dma.streams_mask & bit) == 0U)) {
+      const stm32_dma_stream_t *stp = STM32_DMA_STREAM(i);
+
+      dma_stream_take(stp, priority, func, param);
+
+      return stp;
+    }
   }
-  if ((dma.streams_mask & STM32_DMA2_STREAMS_MASK) == 0U) {
-    rccDisableDMA2();
+
+  return NULL;
+}
+
+/**
+ * @brief   Allocates a free DMA stream among a set of compatible streams.
+ * @details If all the compatible streams are taken then the calling thread
+ *          waits until one is freed using @p dmaStreamFreeI() or
+ *          @p dmaStreamFree(), this allows infrequent users to time-share
+ *          streams by allocating them only for the duration of a transfer.
+ * @note    Streams released using @p dmaStreamRelease() do not wake up
+ *          waiting threads.
+ *
+ * @param[in] mask      mask of the compatible streams
+ * @param[in] priority  IRQ priority for the DMA stream
+ * @param[in] func      handling function pointer, can be @p NULL
+ * @param[in] param     a parameter to be passed to the handling function
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              Pointer to the allocated stream.
+ * @retval NULL         if a stream could not be allocated within the
+ *                      specified timeout.
+ *
+ * @api
+ */
+const stm32_dma_stream_t *dmaStreamAllocTimeout(uint32_t mask,
+                                                 uint32_t priority,
+                                                 stm32_dmaisr_t func,
+                                                 void *param,
+                                                 sysinterval_t timeout) {
+  const stm32_dma_stream_t *stp;
+
+  osalSysLock();
+  while (true) {
+    stp = dmaStreamAllocI(mask, priority, func, param);
+    if (stp != NULL) {
+      break;
+    }
+    if (osalThreadEnqueueTimeoutS(&dma.waiting, timeout) != MSG_OK) {
+      break;
+    }
+  }
+  osalSysUnlock();
+
+  return stp;
+}
+
+/**
+ * @brief   Frees a DMA stream.
+ * @details The stream is released as by @p dmaStreamRelease() and the
+ *          threads waiting in @p dmaStreamAllocTimeout() are woken up.
+ *
+ * @param[in] stp       pointer to a @p stm32_dma_stream_t structure
+ *
+ * @iclass
+ */
+void dmaStreamFreeI(const stm32_dma_stream_t *stp) {
+
+  osalDbgCheckClassI();
+
+  dmaStreamRelease(stp);
+  osalThreadDequeueAllI(&dma.waiting, MSG_OK);
+}
+
+/**
+ * @brief   Frees a DMA stream.
+ * @details The stream is released as by @p dmaStreamRelease() and the
+ *          threads waiting in @p dmaStreamAllocTimeout() are woken up.
+ *
+ * @param[in] stp       pointer to a @p stm32_dma_stream_t structure
+ *
+ * @api
+ */
+void dmaStreamFree(const stm32_dma_stream_t *stp) {
+
+  osalSysLock();
+  dmaStreamFreeI(stp);
+  osalOsRescheduleS();
+  osalSysUnlock();
+}
+
+#if (STM32_DMA_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the utilization statistics of a DMA stream.
+ * @details If the stream is currently allocated then the time elapsed since
+ *          its allocation is included in the returned busy time.
+ *
+ * @param[in] stp       pointer to a @p stm32_dma_stream_t structure
+ * @param[out] statsp   pointer to a @p stm32_dma_stats_t structure
+ *
+ * @iclass
+ */
+void dmaStreamGetStatsI(const stm32_dma_stream_t *stp,
+                        stm32_dma_stats_t *statsp) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((stp != NULL) && (statsp != NULL));
+
+  *statsp = dma.stats[stp->selfindex];
+  if ((dma.streams_mask & (1U << stp->selfindex)) != 0U) {
+    statsp->busy += (uint32_t)osalTimeDiffX(statsp->last,
+                                            osalOsGetSystemTimeX());
   }
 }
+#endif /* STM32_DMA_USE_STATISTICS == TRUE */
 
 #endif /* STM32_DMA_REQUIRED */
 
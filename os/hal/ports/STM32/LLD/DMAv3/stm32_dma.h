@@ -49,6 +49,26 @@
  */
 #define STM32_DMA_ISR_MASK          0x3DU
 
+/**
+ * @name    DMA streams masks
+ * @{
+ */
+/**
+ * @brief   Mask of all the DMA streams.
+ */
+#define STM32_DMA_STREAMS_MSK_ANY   0x0000FFFFU
+
+/**
+ * @brief   Mask of the DMA1 streams.
+ */
+#define STM32_DMA_STREAMS_MSK_DMA1  0x000000FFU
+
+/**
+ * @brief   Mask of the DMA2 streams.
+ */
+#define STM32_DMA_STREAMS_MSK_DMA2  0x0000FF00U
+/** @} */
+
 /**
  * @brief   Checks if a DMA priority is within the valid range.
  *
@@ -174,6 +194,13 @@
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Enables the DMA streams utilization statistics.
+ */
+#if !defined(STM32_DMA_USE_STATISTICS) || defined(__DOXYGEN__)
+#define STM32_DMA_USE_STATISTICS    FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -344,6 +371,21 @@ typedef struct {
  */
 typedef void (*stm32_dmaisr_t)(void *p, uint32_t flags);
 
+#if (STM32_DMA_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   STM32 DMA stream utilization statistics.
+ * @note    The allocated time is accumulated on release, intervals longer
+ *          than the system time range are not accounted correctly.
+ */
+typedef struct {
+  uint32_t              allocations;    /**< @brief Allocations counter.    */
+  uint32_t              busy;           /**< @brief Cumulative allocated
+                                             time in system ticks.          */
+  systime_t             last;           /**< @brief Time of the last
+                                             allocation.                    */
+} stm32_dma_stats_t;
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -581,6 +623,21 @@ extern "C" {
                          void *param);
   void dmaSetRequestSource(const stm32_dma_stream_t *stp, uint32_t per);
   void dmaStreamRelease(const stm32_dma_stream_t *stp);
+  const stm32_dma_stream_t *dmaStreamAllocI(uint32_t mask,
+                                           uint32_t priority,
+                                           stm32_dmaisr_t func,
+                                           void *param);
+  const stm32_dma_stream_t *dmaStreamAllocTimeout(uint32_t mask,
+                                                  uint32_t priority,
+                                                  stm32_dmaisr_t func,
+                                                  void *param,
+                                                  sysinterval_t timeout);
+  void dmaStreamFreeI(const stm32_dma_stream_t *stp);
+  void dmaStreamFree(const stm32_dma_stream_t *stp);
+#if STM32_DMA_USE_STATISTICS == TRUE
+  void dmaStreamGetStatsI(const stm32_dma_stream_t *stp,
+                          stm32_dma_stats_t *statsp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,679 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    FDCANv1/hal_can_lld.c
+ * @brief   STM32 FDCAN subsystem low level driver source.
+ *
+ * @addtogroup CAN
+ * @{
+ */
+
+#include "hal.h"
+
+#if HAL_USE_CAN || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @name    Message RAM layout of an instance, in words
+ * @{
+ */
+#define FDCAN_SIDF_OFFSET           0U
+#define FDCAN_XIDF_OFFSET           (FDCAN_SIDF_OFFSET +                    \
+                                     (uint32_t)STM32_CAN_STD_FILTERS)
+#define FDCAN_RXF0_OFFSET           (FDCAN_XIDF_OFFSET +                    \
+                                     (2U * (uint32_t)STM32_CAN_EXT_FILTERS))
+#define FDCAN_RXF1_OFFSET           (FDCAN_RXF0_OFFSET +                    \
+                                     (STM32_CAN_ELEMENT_WORDS *             \
+                                      (uint32_t)STM32_CAN_RX_FIFO0_SIZE))
+#define FDCAN_TXB_OFFSET            (FDCAN_RXF1_OFFSET +                    \
+                                     (STM32_CAN_ELEMENT_WORDS *             \
+                                      (uint32_t)STM32_CAN_RX_FIFO1_SIZE))
+/** @} */
+
+/**
+ * @name    Message RAM elements fields
+ * @{
+ */
+#define FDCAN_R0_ESI                (1U << 31)
+#define FDCAN_R0_XTD                (1U << 30)
+#define FDCAN_R0_RTR                (1U << 29)
+#define FDCAN_R1_FIDX_POS           24U
+#define FDCAN_R1_FDF                (1U << 21)
+#define FDCAN_R1_BRS                (1U << 20)
+#define FDCAN_R1_DLC_POS            16U
+
+#define FDCAN_SF_CLASSIC            (2U << 30)
+#define FDCAN_SF_EC_POS             27U
+#define FDCAN_EF_CLASSIC            (2U << 30)
+#define FDCAN_EF_EC_POS             29U
+#define FDCAN_FEC_FIFO0             1U
+#define FDCAN_FEC_FIFO1             2U
+/** @} */
+
+/**
+ * @brief   Element data size code for 64 bytes payloads.
+ */
+#define FDCAN_DS_64                 7U
+
+/**
+ * @brief   Receive interrupt sources of the RX FIFO 0.
+ */
+#if (STM32_CAN_RX_FIFO0_WATERMARK > 0) || defined(__DOXYGEN__)
+#define FDCAN_IE_RF0                (FDCAN_IE_RF0WE | FDCAN_IE_TOOE)
+#else
+#define FDCAN_IE_RF0                FDCAN_IE_RF0NE
+#endif
+
+/**
+ * @brief   Error interrupt sources.
+ */
+#if STM32_CAN_REPORT_ALL_ERRORS || defined(__DOXYGEN__)
+#define FDCAN_IE_ERRORS             (FDCAN_IE_EWE | FDCAN_IE_EPE |          \
+                                     FDCAN_IE_BOE | FDCAN_IE_RF0LE |        \
+                                     FDCAN_IE_RF1LE | FDCAN_IE_PEAE |       \
+                                     FDCAN_IE_PEDE)
+#else
+#define FDCAN_IE_ERRORS             (FDCAN_IE_EWE | FDCAN_IE_EPE |          \
+                                     FDCAN_IE_BOE | FDCAN_IE_RF0LE |        \
+                                     FDCAN_IE_RF1LE)
+#endif
+
+/**
+ * @brief   CCCR bits taken from the configuration.
+ */
+#define FDCAN_CCCR_CONFIG_MASK      (FDCAN_CCCR_FDOE | FDCAN_CCCR_BRSE |    \
+                                     FDCAN_CCCR_TXP | FDCAN_CCCR_NISO |     \
+                                     FDCAN_CCCR_PXHD | FDCAN_CCCR_DAR |     \
+                                     FDCAN_CCCR_MON | FDCAN_CCCR_ASM |      \
+                                     FDCAN_CCCR_TEST)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief CAN1 driver identifier.*/
+#if STM32_CAN_USE_FDCAN1 || defined(__DOXYGEN__)
+CANDriver CAND1;
+#endif
+
+/** @brief CAN2 driver identifier.*/
+#if STM32_CAN_USE_FDCAN2 || defined(__DOXYGEN__)
+CANDriver CAND2;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the message RAM offset of a word as used by the
+ *          FDCAN configuration registers.
+ *
+ * @param[in] p         pointer to the word in the message RAM
+ * @return              The byte offset from the message RAM base.
+ *
+ * @notapi
+ */
+static uint32_t can_lld_ram_offset(const uint32_t *p) {
+
+  return ((uint32_t)p - (uint32_t)SRAMCAN_BASE) & 0xFFFCU;
+}
+
+/**
+ * @brief   Tells if any FDCAN instance is clocked.
+ *
+ * @return              The clock status.
+ *
+ * @notapi
+ */
+static bool can_lld_is_clocked(void) {
+  bool clock = false;
+
+#if STM32_CAN_USE_FDCAN1
+  clock = CAND1.state != CAN_STOP;
+#endif
+#if STM32_CAN_USE_FDCAN2
+  clock = clock || (CAND2.state != CAN_STOP);
+#endif
+
+  return clock;
+}
+
+/**
+ * @brief   Common ISR handler.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ *
+ * @notapi
+ */
+static void can_lld_serve_interrupt(CANDriver *canp) {
+  uint32_t ir;
+  eventflags_t flags;
+
+  /* Clearing the enabled IRQ sources, the others are left pending.*/
+  ir = canp->fdcan->IR & canp->fdcan->IE;
+  canp->fdcan->IR = ir;
+
+  /* RX FIFO 0, in watermark mode the sources are left enabled, the
+     watermark is reached again only after the FIFO has been drained.*/
+#if STM32_CAN_RX_FIFO0_WATERMARK > 0
+  if ((ir & (FDCAN_IR_RF0W | FDCAN_IR_TOO)) != 0U) {
+    _can_rx_full_isr(canp, CAN_MAILBOX_TO_MASK(1U));
+  }
+#else
+  if ((ir & FDCAN_IR_RF0N) != 0U) {
+    /* No more receive events until the FIFO 0 has been emptied.*/
+    canp->fdcan->IE &= ~FDCAN_IE_RF0NE;
+    _can_rx_full_isr(canp, CAN_MAILBOX_TO_MASK(1U));
+  }
+#endif
+
+  /* RX FIFO 1.*/
+  if ((ir & FDCAN_IR_RF1N) != 0U) {
+    /* No more receive events until the FIFO 1 has been emptied.*/
+    canp->fdcan->IE &= ~FDCAN_IE_RF1NE;
+    _can_rx_full_isr(canp, CAN_MAILBOX_TO_MASK(2U));
+  }
+
+  /* TX FIFO, the completion source is only enabled while the FIFO is
+     full, the empty source is always enabled.*/
+  if ((ir & (FDCAN_IR_TC | FDCAN_IR_TFE)) != 0U) {
+    canp->fdcan->IE &= ~FDCAN_IE_TCE;
+    _can_tx_empty_isr(canp, CAN_MAILBOX_TO_MASK(1U));
+  }
+
+  /* Error events.*/
+  flags = 0U;
+  if ((ir & (FDCAN_IR_RF0L | FDCAN_IR_RF1L)) != 0U) {
+    flags |= CAN_OVERFLOW_ERROR;
+  }
+  if ((ir & (FDCAN_IR_EW | FDCAN_IR_EP | FDCAN_IR_BO |
+             FDCAN_IR_PEA | FDCAN_IR_PED)) != 0U) {
+    uint32_t psr = canp->fdcan->PSR;
+
+    if ((psr & FDCAN_PSR_EW) != 0U) {
+      flags |= CAN_LIMIT_WARNING;
+    }
+    if ((psr & FDCAN_PSR_EP) != 0U) {
+      flags |= CAN_LIMIT_ERROR;
+    }
+    if ((ir & FDCAN_IR_BO) != 0U) {
+      /* The bus-off state stops the controller, the recovery sequence
+         starts when the initialization mode is left.*/
+      if ((psr & FDCAN_PSR_BO) != 0U) {
+        canp->fdcan->CCCR &= ~FDCAN_CCCR_INIT;
+      }
+      flags |= CAN_BUS_OFF_ERROR;
+    }
+    if ((ir & (FDCAN_IR_PEA | FDCAN_IR_PED)) != 0U) {
+      flags |= CAN_FRAMING_ERROR;
+    }
+
+    /* The content of the PSR register is copied unchanged in the upper
+       half word of the listener flags mask.*/
+    flags |= (eventflags_t)(psr << 16U);
+  }
+  if (flags != 0U) {
+    _can_error_isr(canp, flags);
+  }
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+#if STM32_CAN_USE_FDCAN1 || defined(__DOXYGEN__)
+/**
+ * @brief   FDCAN1 interrupt line 0 handler.
+ *
+ * @isr
+ */
+OSAL_IRQ_HANDLER(STM32_FDCAN1_IT0_HANDLER) {
+
+  OSAL_IRQ_PROLOGUE();
+
+  can_lld_serve_interrupt(&CAND1);
+
+  OSAL_IRQ_EPILOGUE();
+}
+#endif /* STM32_CAN_USE_FDCAN1 */
+
+#if STM32_CAN_USE_FDCAN2 || defined(__DOXYGEN__)
+/**
+ * @brief   FDCAN2 interrupt line 0 handler.
+ *
+ * @isr
+ */
+OSAL_IRQ_HANDLER(STM32_FDCAN2_IT0_HANDLER) {
+
+  OSAL_IRQ_PROLOGUE();
+
+  can_lld_serve_interrupt(&CAND2);
+
+  OSAL_IRQ_EPILOGUE();
+}
+#endif /* STM32_CAN_USE_FDCAN2 */
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level CAN driver initialization.
+ *
+ * @notapi
+ */
+void can_lld_init(void) {
+
+#if STM32_CAN_USE_FDCAN1
+  /* Driver initialization.*/
+  canObjectInit(&CAND1);
+  CAND1.fdcan       = FDCAN1;
+  CAND1.ram         = (uint32_t *)SRAMCAN_BASE;
+  CAND1.std_filters = 0U;
+  CAND1.ext_filters = 0U;
+  nvicEnableVector(STM32_FDCAN1_IT0_NUMBER, STM32_CAN_FDCAN1_IRQ_PRIORITY);
+#endif
+
+#if STM32_CAN_USE_FDCAN2
+  /* Driver initialization.*/
+  canObjectInit(&CAND2);
+  CAND2.fdcan       = FDCAN2;
+  CAND2.ram         = (uint32_t *)SRAMCAN_BASE + STM32_CAN_MSGRAM_WORDS;
+  CAND2.std_filters = 0U;
+  CAND2.ext_filters = 0U;
+  nvicEnableVector(STM32_FDCAN2_IT0_NUMBER, STM32_CAN_FDCAN2_IRQ_PRIORITY);
+#endif
+}
+
+/**
+ * @brief   Configures and activates the CAN peripheral.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ *
+ * @notapi
+ */
+void can_lld_start(CANDriver *canp) {
+  FDCAN_GlobalTypeDef *fdcan = canp->fdcan;
+
+  /* Clock activation, the clock is shared among the instances.*/
+  rccEnableFDCAN(true);
+
+  /* Entering the configuration mode.*/
+  fdcan->CCCR |= FDCAN_CCCR_INIT;
+  while ((fdcan->CCCR & FDCAN_CCCR_INIT) == 0U)
+    osalThreadSleepS(1);
+  fdcan->CCCR |= FDCAN_CCCR_CCE;
+  fdcan->CCCR  = (canp->config->cccr & FDCAN_CCCR_CONFIG_MASK) |
+                 FDCAN_CCCR_CCE | FDCAN_CCCR_INIT;
+  fdcan->NBTP  = canp->config->nbtp;
+  fdcan->DBTP  = canp->config->dbtp;
+  fdcan->TDCR  = canp->config->tdcr;
+
+  /* Timestamps and timeout counted in nominal bit times.*/
+  fdcan->TSCC  = 1U << FDCAN_TSCC_TSS_Pos;
+#if STM32_CAN_RX_FIFO0_WATERMARK > 0
+  fdcan->TOCC  = ((uint32_t)STM32_CAN_RX_FIFO0_TIMEOUT << FDCAN_TOCC_TOP_Pos) |
+                 (2U << FDCAN_TOCC_TOS_Pos) | FDCAN_TOCC_ETOC;
+#else
+  fdcan->TOCC  = 0U;
+#endif
+
+  /* Message RAM layout, all elements are sized for 64 bytes payloads.*/
+  fdcan->SIDFC = (canp->std_filters << FDCAN_SIDFC_LSS_Pos) |
+                 can_lld_ram_offset(&canp->ram[FDCAN_SIDF_OFFSET]);
+  fdcan->XIDFC = (canp->ext_filters << FDCAN_XIDFC_LSE_Pos) |
+                 can_lld_ram_offset(&canp->ram[FDCAN_XIDF_OFFSET]);
+  fdcan->RXF0C = ((uint32_t)STM32_CAN_RX_FIFO0_WATERMARK << FDCAN_RXF0C_F0WM_Pos) |
+                 ((uint32_t)STM32_CAN_RX_FIFO0_SIZE << FDCAN_RXF0C_F0S_Pos) |
+                 can_lld_ram_offset(&canp->ram[FDCAN_RXF0_OFFSET]);
+  fdcan->RXF1C = ((uint32_t)STM32_CAN_RX_FIFO1_SIZE << FDCAN_RXF1C_F1S_Pos) |
+                 can_lld_ram_offset(&canp->ram[FDCAN_RXF1_OFFSET]);
+  fdcan->RXESC = (FDCAN_DS_64 << FDCAN_RXESC_F0DS_Pos) |
+                 (FDCAN_DS_64 << FDCAN_RXESC_F1DS_Pos) |
+                 (FDCAN_DS_64 << FDCAN_RXESC_RBDS_Pos);
+  fdcan->TXBC  = ((uint32_t)STM32_CAN_TX_FIFO_SIZE << FDCAN_TXBC_TFQS_Pos) |
+                 can_lld_ram_offset(&canp->ram[FDCAN_TXB_OFFSET]);
+  fdcan->TXESC = FDCAN_DS_64 << FDCAN_TXESC_TBDS_Pos;
+  fdcan->TXEFC = 0U;
+
+  /* If no filters have been programmed then all frames are accepted in
+     the FIFO 0, else the non-matching frames are rejected.*/
+  if ((canp->std_filters == 0U) && (canp->ext_filters == 0U)) {
+    fdcan->GFC = 0U;
+  }
+  else {
+    fdcan->GFC = (2U << FDCAN_GFC_ANFS_Pos) | (2U << FDCAN_GFC_ANFE_Pos);
+  }
+
+  /* Interrupt sources initialization, all on line 0.*/
+  fdcan->IR     = 0xFFFFFFFFU;
+  fdcan->ILS    = 0U;
+  fdcan->ILE    = FDCAN_ILE_EINT0;
+  fdcan->TXBTIE = 0xFFFFFFFFU >> (32U - (uint32_t)STM32_CAN_TX_FIFO_SIZE);
+  fdcan->IE     = FDCAN_IE_RF0 | FDCAN_IE_RF1NE | FDCAN_IE_TFEE |
+                  FDCAN_IE_ERRORS;
+
+  /* Leaving the configuration mode, CCE is cleared by hardware.*/
+  fdcan->CCCR &= ~FDCAN_CCCR_INIT;
+}
+
+/**
+ * @brief   Deactivates the CAN peripheral.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ *
+ * @notapi
+ */
+void can_lld_stop(CANDriver *canp) {
+
+  /* If in ready state then disables the CAN peripheral.*/
+  if (canp->state == CAN_READY) {
+    canp->fdcan->CCCR |= FDCAN_CCCR_INIT;
+    canp->fdcan->IE    = 0U;                /* All sources disabled.    */
+    canp->fdcan->ILE   = 0U;
+
+    /* The clock is stopped when the last instance is stopped, the
+       state of this instance is not yet updated.*/
+    canp->state = CAN_STOP;
+    if (!can_lld_is_clocked()) {
+      rccDisableFDCAN();
+    }
+  }
+}
+
+/**
+ * @brief   Determines whether a frame can be transmitted.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] mailbox   mailbox number, @p CAN_ANY_MAILBOX for any mailbox
+ *
+ * @return              The queue space availability.
+ * @retval false        no space in the transmit queue.
+ * @retval true         transmit slot available.
+ *
+ * @notapi
+ */
+bool can_lld_is_tx_empty(CANDriver *canp, canmbx_t mailbox) {
+
+  switch (mailbox) {
+  case CAN_ANY_MAILBOX:
+  case 1:
+    return (canp->fdcan->TXFQS & FDCAN_TXFQS_TFQF) == 0U;
+  default:
+    return false;
+  }
+}
+
+/**
+ * @brief   Inserts a frame into the transmit queue.
+ * @details The frame is written directly in the TX FIFO element of the
+ *          message RAM, only the words covered by the payload are copied.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] ctfp      pointer to the CAN frame to be transmitted
+ * @param[in] mailbox   mailbox number,  @p CAN_ANY_MAILBOX for any mailbox
+ *
+ * @notapi
+ */
+void can_lld_transmit(CANDriver *canp,
+                      canmbx_t mailbox,
+                      const CANTxFrame *ctfp) {
+  uint32_t pi, i, n;
+  volatile uint32_t *tep;
+
+  if (mailbox > 1U) {
+    return;
+  }
+
+  /* Pointer to the element at the FIFO put index.*/
+  pi  = (canp->fdcan->TXFQS & FDCAN_TXFQS_TFQPI) >> FDCAN_TXFQS_TFQPI_Pos;
+  tep = &canp->ram[FDCAN_TXB_OFFSET + (pi * STM32_CAN_ELEMENT_WORDS)];
+
+  /* Preparing the message.*/
+  if (ctfp->IDE)
+    tep[0] = (uint32_t)ctfp->EID | FDCAN_R0_XTD |
+             ((uint32_t)ctfp->RTR << 29);
+  else
+    tep[0] = ((uint32_t)ctfp->SID << 18) | ((uint32_t)ctfp->RTR << 29);
+  tep[1] = ((uint32_t)ctfp->DLC << FDCAN_R1_DLC_POS) |
+           ((uint32_t)ctfp->FDF << 21) | ((uint32_t)ctfp->BRS << 20);
+  n = (CAN_FD_DLC_TO_SIZE((uint32_t)ctfp->DLC) + 3U) / 4U;
+  for (i = 0U; i < n; i++) {
+    tep[i + 2U] = ctfp->data32[i];
+  }
+  canp->fdcan->TXBAR = 1U << pi;
+
+  /* If the FIFO is now full then the completion event is enabled in order
+     to wake up the writers as soon as an element is released.*/
+  canp->fdcan->IR = FDCAN_IR_TC;
+  if ((canp->fdcan->TXFQS & FDCAN_TXFQS_TFQF) != 0U) {
+    canp->fdcan->IE |= FDCAN_IE_TCE;
+  }
+}
+
+/**
+ * @brief   Determines whether a frame has been received.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] mailbox   mailbox number, @p CAN_ANY_MAILBOX for any mailbox
+ *
+ * @return              The queue space availability.
+ * @retval false        no space in the transmit queue.
+ * @retval true         transmit slot available.
+ *
+ * @notapi
+ */
+bool can_lld_is_rx_nonempty(CANDriver *canp, canmbx_t mailbox) {
+
+  switch (mailbox) {
+  case CAN_ANY_MAILBOX:
+    return ((canp->fdcan->RXF0S & FDCAN_RXF0S_F0FL) != 0U) ||
+           ((canp->fdcan->RXF1S & FDCAN_RXF1S_F1FL) != 0U);
+  case 1:
+    return (canp->fdcan->RXF0S & FDCAN_RXF0S_F0FL) != 0U;
+  case 2:
+    return (canp->fdcan->RXF1S & FDCAN_RXF1S_F1FL) != 0U;
+  default:
+    return false;
+  }
+}
+
+/**
+ * @brief   Receives a frame from the input queue.
+ * @details The frame is read directly from the RX FIFO element of the
+ *          message RAM, only the words covered by the payload are copied.
+ *          Consecutive invocations drain the FIFO without any interrupt
+ *          being served.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] mailbox   mailbox number, @p CAN_ANY_MAILBOX for any mailbox
+ * @param[out] crfp     pointer to the buffer where the CAN frame is copied
+ *
+ * @notapi
+ */
+void can_lld_receive(CANDriver *canp,
+                     canmbx_t mailbox,
+                     CANRxFrame *crfp) {
+  uint32_t gi, r0, r1, i, n;
+  const volatile uint32_t *rep;
+
+  if (mailbox == CAN_ANY_MAILBOX) {
+    if ((canp->fdcan->RXF0S & FDCAN_RXF0S_F0FL) != 0U)
+      mailbox = 1;
+    else if ((canp->fdcan->RXF1S & FDCAN_RXF1S_F1FL) != 0U)
+      mailbox = 2;
+    else {
+      /* Should not happen, do nothing.*/
+      return;
+    }
+  }
+  switch (mailbox) {
+  case 1:
+    gi  = (canp->fdcan->RXF0S & FDCAN_RXF0S_F0GI) >> FDCAN_RXF0S_F0GI_Pos;
+    rep = &canp->ram[FDCAN_RXF0_OFFSET + (gi * STM32_CAN_ELEMENT_WORDS)];
+    break;
+  case 2:
+    gi  = (canp->fdcan->RXF1S & FDCAN_RXF1S_F1GI) >> FDCAN_RXF1S_F1GI_Pos;
+    rep = &canp->ram[FDCAN_RXF1_OFFSET + (gi * STM32_CAN_ELEMENT_WORDS)];
+    break;
+  default:
+    /* Should not happen, do nothing.*/
+    return;
+  }
+
+  /* Fetches the message.*/
+  r0 = rep[0];
+  r1 = rep[1];
+  n  = (CAN_FD_DLC_TO_SIZE((r1 >> FDCAN_R1_DLC_POS) & 15U) + 3U) / 4U;
+  for (i = 0U; i < n; i++) {
+    crfp->data32[i] = rep[i + 2U];
+  }
+
+  /* Releases the element, if the FIFO is empty re-enables the interrupt
+     in order to generate events again. The pending flag is cleared before
+     checking so that a frame arriving meanwhile is not missed.*/
+  if (mailbox == 1U) {
+    canp->fdcan->RXF0A = gi;
+#if STM32_CAN_RX_FIFO0_WATERMARK == 0
+    canp->fdcan->IR = FDCAN_IR_RF0N;
+    if ((canp->fdcan->RXF0S & FDCAN_RXF0S_F0FL) == 0U)
+      canp->fdcan->IE |= FDCAN_IE_RF0NE;
+#endif
+  }
+  else {
+    canp->fdcan->RXF1A = gi;
+    canp->fdcan->IR = FDCAN_IR_RF1N;
+    if ((canp->fdcan->RXF1S & FDCAN_RXF1S_F1FL) == 0U)
+      canp->fdcan->IE |= FDCAN_IE_RF1NE;
+  }
+
+  /* Decodes the various fields in the RX frame.*/
+  crfp->RTR = (r0 & FDCAN_R0_RTR) != 0U;
+  crfp->IDE = (r0 & FDCAN_R0_XTD) != 0U;
+  crfp->ESI = (r0 & FDCAN_R0_ESI) != 0U;
+  if (crfp->IDE)
+    crfp->EID = r0 & 0x1FFFFFFFU;
+  else
+    crfp->SID = (r0 >> 18) & 0x7FFU;
+  crfp->DLC  = (r1 >> FDCAN_R1_DLC_POS) & 15U;
+  crfp->FDF  = (r1 & FDCAN_R1_FDF) != 0U;
+  crfp->BRS  = (r1 & FDCAN_R1_BRS) != 0U;
+  crfp->FMI  = (uint8_t)((r1 >> FDCAN_R1_FIDX_POS) & 0x7FU);
+  crfp->TIME = (uint16_t)r1;
+}
+
+#if CAN_USE_SLEEP_MODE || defined(__DOXYGEN__)
+/**
+ * @brief   Enters the sleep mode.
+ * @details The controller enters the power down mode after completing the
+ *          pending transfers.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ *
+ * @notapi
+ */
+void can_lld_sleep(CANDriver *canp) {
+
+  canp->fdcan->CCCR |= FDCAN_CCCR_CSR;
+}
+
+/**
+ * @brief   Enforces leaving the sleep mode.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ *
+ * @notapi
+ */
+void can_lld_wakeup(CANDriver *canp) {
+
+  canp->fdcan->CCCR &= ~FDCAN_CCCR_CSR;
+  while ((canp->fdcan->CCCR & FDCAN_CCCR_CSA) != 0U) {
+  }
+  canp->fdcan->CCCR &= ~FDCAN_CCCR_INIT;
+}
+#endif /* CAN_USE_SLEEP_MODE */
+
+/**
+ * @brief   Programs the identifier filters.
+ * @details Standard and extended identifier filters are stored in the
+ *          respective filter lists of the message RAM, the lists sizes are
+ *          @p STM32_CAN_STD_FILTERS and @p STM32_CAN_EXT_FILTERS.
+ * @pre     The driver must be in the @p CAN_STOP state.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] fp        pointer to an array of @p CANIdFilter structures
+ * @param[in] n         number of elements in the array
+ *
+ * @notapi
+ */
+void can_lld_set_id_filters(CANDriver *canp,
+                            const CANIdFilter *fp,
+                            size_t n) {
+  volatile uint32_t *sfp, *efp;
+  uint32_t ec;
+  bool clock;
+  size_t i;
+
+  /* The message RAM is clocked with the FDCAN instances, its clock must be
+     enabled temporarily if all the drivers are stopped.*/
+  clock = can_lld_is_clocked();
+  if (!clock) {
+    rccEnableFDCAN(true);
+  }
+
+  sfp = &canp->ram[FDCAN_SIDF_OFFSET];
+  efp = &canp->ram[FDCAN_XIDF_OFFSET];
+  canp->std_filters = 0U;
+  canp->ext_filters = 0U;
+  for (i = 0U; i < n; i++) {
+    ec = fp[i].mailbox == 2U ? FDCAN_FEC_FIFO1 : FDCAN_FEC_FIFO0;
+    if (fp[i].ide == CAN_IDE_EXT) {
+      osalDbgAssert(canp->ext_filters < (uint32_t)STM32_CAN_EXT_FILTERS,
+                    "too many filters");
+
+      efp[0] = (ec << FDCAN_EF_EC_POS) | (fp[i].id & 0x1FFFFFFFU);
+      efp[1] = FDCAN_EF_CLASSIC | (fp[i].mask & 0x1FFFFFFFU);
+      efp += 2;
+      canp->ext_filters++;
+    }
+    else {
+      osalDbgAssert(canp->std_filters < (uint32_t)STM32_CAN_STD_FILTERS,
+                    "too many filters");
+
+      *sfp++ = FDCAN_SF_CLASSIC | (ec << FDCAN_SF_EC_POS) |
+               ((fp[i].id & 0x7FFU) << 16) | (fp[i].mask & 0x7FFU);
+      canp->std_filters++;
+    }
+  }
+
+  /* Clock disabled, it will be enabled again in can_lld_start().*/
+  if (!clock) {
+    rccDisableFDCAN();
+  }
+}
+
+#endif /* HAL_USE_CAN */
+
+/** @} */
@@ -0,0 +1,549 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    FDCANv1/hal_can_lld.h
+ * @brief   STM32 FDCAN subsystem low level driver header.
+ *
+ * @addtogroup CAN
+ * @{
+ */
+
+#ifndef HAL_CAN_LLD_H
+#define HAL_CAN_LLD_H
+
+#if HAL_USE_CAN || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   This switch defines whether the driver implementation supports
+ *          a low power switch mode with automatic an wakeup feature.
+ */
+#define CAN_SUPPORTS_SLEEP          TRUE
+
+/**
+ * @brief   This implementation supports the portable identifier filters.
+ */
+#define CAN_SUPPORTS_ID_FILTERS     TRUE
+
+/**
+ * @brief   This implementation supports CAN FD frames.
+ */
+#define CAN_SUPPORTS_FD             TRUE
+
+/**
+ * @brief   This implementation supports one transmit mailbox.
+ * @note    The mailbox is the TX FIFO in the message RAM.
+ */
+#define CAN_TX_MAILBOXES            1
+
+/**
+ * @brief   This implementation supports two receive mailboxes.
+ * @note    The mailboxes are the RX FIFOs 0 and 1 in the message RAM.
+ */
+#define CAN_RX_MAILBOXES            2
+
+/**
+ * @name    CAN registers helper macros
+ * @{
+ */
+#define CAN_NBTP_NBRP(n)            ((n) << 16) /**< @brief NBRP field macro.*/
+#define CAN_NBTP_NTSEG1(n)          ((n) << 8)  /**< @brief NTSEG1 field.   */
+#define CAN_NBTP_NTSEG2(n)          (n)         /**< @brief NTSEG2 field.   */
+#define CAN_NBTP_NSJW(n)            ((n) << 25) /**< @brief NSJW field macro.*/
+
+#define CAN_DBTP_DBRP(n)            ((n) << 16) /**< @brief DBRP field macro.*/
+#define CAN_DBTP_DTSEG1(n)          ((n) << 8)  /**< @brief DTSEG1 field.   */
+#define CAN_DBTP_DTSEG2(n)          ((n) << 4)  /**< @brief DTSEG2 field.   */
+#define CAN_DBTP_DSJW(n)            (n)         /**< @brief DSJW field macro.*/
+#define CAN_DBTP_TDC                (1U << 23)  /**< @brief Delay compens.  */
+
+#define CAN_TDCR_TDCF(n)            (n)         /**< @brief TDCF field macro.*/
+#define CAN_TDCR_TDCO(n)            ((n) << 8)  /**< @brief TDCO field macro.*/
+
+#define CAN_IDE_STD                 0           /**< @brief Standard id.    */
+#define CAN_IDE_EXT                 1           /**< @brief Extended id.    */
+
+#define CAN_RTR_DATA                0           /**< @brief Data frame.     */
+#define CAN_RTR_REMOTE              1           /**< @brief Remote frame.   */
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   CAN pedantic errors report.
+ * @details Use of this option is IRQ-intensive.
+ */
+#if !defined(STM32_CAN_REPORT_ALL_ERRORS) || defined(__DOXYGEN__)
+#define STM32_CAN_REPORT_ALL_ERRORS         FALSE
+#endif
+
+/**
+ * @brief   FDCAN1 driver enable switch.
+ * @details If set to @p TRUE the support for FDCAN1 is included.
+ */
+#if !defined(STM32_CAN_USE_FDCAN1) || defined(__DOXYGEN__)
+#define STM32_CAN_USE_FDCAN1                FALSE
+#endif
+
+/**
+ * @brief   FDCAN2 driver enable switch.
+ * @details If set to @p TRUE the support for FDCAN2 is included.
+ */
+#if !defined(STM32_CAN_USE_FDCAN2) || defined(__DOXYGEN__)
+#define STM32_CAN_USE_FDCAN2                FALSE
+#endif
+
+/**
+ * @brief   FDCAN1 interrupt priority level setting.
+ */
+#if !defined(STM32_CAN_FDCAN1_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_CAN_FDCAN1_IRQ_PRIORITY       11
+#endif
+
+/**
+ * @brief   FDCAN2 interrupt priority level setting.
+ */
+#if !defined(STM32_CAN_FDCAN2_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_CAN_FDCAN2_IRQ_PRIORITY       11
+#endif
+
+/**
+ * @brief   Number of standard identifier filter elements.
+ */
+#if !defined(STM32_CAN_STD_FILTERS) || defined(__DOXYGEN__)
+#define STM32_CAN_STD_FILTERS               16
+#endif
+
+/**
+ * @brief   Number of extended identifier filter elements.
+ */
+#if !defined(STM32_CAN_EXT_FILTERS) || defined(__DOXYGEN__)
+#define STM32_CAN_EXT_FILTERS               8
+#endif
+
+/**
+ * @brief   Number of elements in the RX FIFO 0.
+ */
+#if !defined(STM32_CAN_RX_FIFO0_SIZE) || defined(__DOXYGEN__)
+#define STM32_CAN_RX_FIFO0_SIZE             16
+#endif
+
+/**
+ * @brief   Number of elements in the RX FIFO 1.
+ */
+#if !defined(STM32_CAN_RX_FIFO1_SIZE) || defined(__DOXYGEN__)
+#define STM32_CAN_RX_FIFO1_SIZE             8
+#endif
+
+/**
+ * @brief   Number of elements in the TX FIFO.
+ */
+#if !defined(STM32_CAN_TX_FIFO_SIZE) || defined(__DOXYGEN__)
+#define STM32_CAN_TX_FIFO_SIZE              8
+#endif
+
+/**
+ * @brief   RX FIFO 0 watermark.
+ * @details If non-zero then the receive event of the mailbox 1 is
+ *          signaled when this number of frames is queued in the RX FIFO 0
+ *          or when @p STM32_CAN_RX_FIFO0_TIMEOUT bit times elapsed since
+ *          the first frame has been queued, whatever comes first. If zero
+ *          then the event is signaled on the first received frame.
+ */
+#if !defined(STM32_CAN_RX_FIFO0_WATERMARK) || defined(__DOXYGEN__)
+#define STM32_CAN_RX_FIFO0_WATERMARK        0
+#endif
+
+/**
+ * @brief   RX FIFO 0 timeout in nominal bit times.
+ * @note    Only used if @p STM32_CAN_RX_FIFO0_WATERMARK is non-zero.
+ */
+#if !defined(STM32_CAN_RX_FIFO0_TIMEOUT) || defined(__DOXYGEN__)
+#define STM32_CAN_RX_FIFO0_TIMEOUT          1000
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !defined(STM32_HAS_FDCAN1)
+#error "STM32_HAS_FDCAN1 not defined in registry"
+#endif
+
+#if !defined(STM32_HAS_FDCAN2)
+#error "STM32_HAS_FDCAN2 not defined in registry"
+#endif
+
+#if !defined(STM32_FDCAN_MSGRAM_WORDS)
+#error "STM32_FDCAN_MSGRAM_WORDS not defined in registry"
+#endif
+
+#if STM32_CAN_USE_FDCAN1 && !STM32_HAS_FDCAN1
+#error "FDCAN1 not present in the selected device"
+#endif
+
+#if STM32_CAN_USE_FDCAN2 && !STM32_HAS_FDCAN2
+#error "FDCAN2 not present in the selected device"
+#endif
+
+#if !STM32_CAN_USE_FDCAN1 && !STM32_CAN_USE_FDCAN2
+#error "CAN driver activated but no CAN peripheral assigned"
+#endif
+
+#if STM32_CAN_USE_FDCAN1 &&                                                 \
+    !OSAL_IRQ_IS_VALID_PRIORITY(STM32_CAN_FDCAN1_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to FDCAN1"
+#endif
+
+#if STM32_CAN_USE_FDCAN2 &&                                                 \
+    !OSAL_IRQ_IS_VALID_PRIORITY(STM32_CAN_FDCAN2_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to FDCAN2"
+#endif
+
+#if (STM32_CAN_STD_FILTERS < 0) || (STM32_CAN_STD_FILTERS > 128)
+#error "STM32_CAN_STD_FILTERS out of range"
+#endif
+
+#if (STM32_CAN_EXT_FILTERS < 0) || (STM32_CAN_EXT_FILTERS > 64)
+#error "STM32_CAN_EXT_FILTERS out of range"
+#endif
+
+#if (STM32_CAN_RX_FIFO0_SIZE < 1) || (STM32_CAN_RX_FIFO0_SIZE > 64)
+#error "STM32_CAN_RX_FIFO0_SIZE out of range"
+#endif
+
+#if (STM32_CAN_RX_FIFO1_SIZE < 1) || (STM32_CAN_RX_FIFO1_SIZE > 64)
+#error "STM32_CAN_RX_FIFO1_SIZE out of range"
+#endif
+
+#if (STM32_CAN_TX_FIFO_SIZE < 1) || (STM32_CAN_TX_FIFO_SIZE > 32)
+#error "STM32_CAN_TX_FIFO_SIZE out of range"
+#endif
+
+#if (STM32_CAN_RX_FIFO0_WATERMARK < 0) ||                                   \
+    (STM32_CAN_RX_FIFO0_WATERMARK >= STM32_CAN_RX_FIFO0_SIZE)
+#error "STM32_CAN_RX_FIFO0_WATERMARK out of range"
+#endif
+
+#if (STM32_CAN_RX_FIFO0_WATERMARK > 0) &&                                   \
+    ((STM32_CAN_RX_FIFO0_TIMEOUT < 1) || (STM32_CAN_RX_FIFO0_TIMEOUT > 65535))
+#error "STM32_CAN_RX_FIFO0_TIMEOUT out of range"
+#endif
+
+#if CAN_USE_SLEEP_MODE && !CAN_SUPPORTS_SLEEP
+#error "CAN sleep mode not supported in this architecture"
+#endif
+
+/**
+ * @brief   Size in words of a message RAM RX or TX element.
+ * @details Elements are always sized for 64 bytes payloads.
+ */
+#define STM32_CAN_ELEMENT_WORDS     18U
+
+/**
+ * @brief   Message RAM words used by each FDCAN instance.
+ */
+#define STM32_CAN_MSGRAM_WORDS                                              \
+  (STM32_CAN_STD_FILTERS + (2U * STM32_CAN_EXT_FILTERS) +                  \
+   (STM32_CAN_ELEMENT_WORDS * (STM32_CAN_RX_FIFO0_SIZE +                    \
+                               STM32_CAN_RX_FIFO1_SIZE +                    \
+                               STM32_CAN_TX_FIFO_SIZE)))
+
+#if (STM32_CAN_MSGRAM_WORDS * 2U) > STM32_FDCAN_MSGRAM_WORDS
+#error "message RAM layout exceeds the available space"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a structure representing an CAN driver.
+ */
+typedef struct CANDriver CANDriver;
+
+/**
+ * @brief   Type of a transmission mailbox index.
+ */
+typedef uint32_t canmbx_t;
+
+#if (CAN_ENFORCE_USE_CALLBACKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a CAN notification callback.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object triggering the
+ *                      callback
+ * @param[in] flags     flags associated to the mailbox callback
+ */
+typedef void (*can_callback_t)(CANDriver *canp, uint32_t flags);
+#endif
+
+/**
+ * @brief   CAN transmission frame.
+ * @note    Accessing the frame data as word16 or word32 is not portable because
+ *          machine data endianness, it can be still useful for a quick filling.
+ * @note    The @p DLC field is a data length code, use
+ *          @p CAN_FD_SIZE_TO_DLC() for payloads larger than 8 bytes.
+ */
+typedef struct {
+  struct {
+    uint8_t                 DLC:4;          /**< @brief Data length code.   */
+    uint8_t                 RTR:1;          /**< @brief Frame type.         */
+    uint8_t                 IDE:1;          /**< @brief Identifier type.    */
+    uint8_t                 FDF:1;          /**< @brief FD frame format.    */
+    uint8_t                 BRS:1;          /**< @brief Bit rate switch.    */
+  };
+  union {
+    struct {
+      uint32_t              SID:11;         /**< @brief Standard identifier.*/
+    };
+    struct {
+      uint32_t              EID:29;         /**< @brief Extended identifier.*/
+    };
+  };
+  union {
+    uint8_t                 data8[64];      /**< @brief Frame data.         */
+    uint16_t                data16[32];     /**< @brief Frame data.         */
+    uint32_t                data32[16];     /**< @brief Frame data.         */
+    uint64_t                data64[8];      /**< @brief Frame data.         */
+  };
+} CANTxFrame;
+
+/**
+ * @brief   CAN received frame.
+ * @note    Accessing the frame data as word16 or word32 is not portable because
+ *          machine data endianness, it can be still useful for a quick filling.
+ * @note    Only the bytes covered by the @p DLC field are written.
+ */
+typedef struct {
+  struct {
+    uint8_t                 FMI;            /**< @brief Filter id.          */
+    uint16_t                TIME;           /**< @brief Time stamp.         */
+  };
+  struct {
+    uint8_t                 DLC:4;          /**< @brief Data length code.   */
+    uint8_t                 RTR:1;          /**< @brief Frame type.         */
+    uint8_t                 IDE:1;          /**< @brief Identifier type.    */
+    uint8_t                 FDF:1;          /**< @brief FD frame format.    */
+    uint8_t                 BRS:1;          /**< @brief Bit rate switch.    */
+    uint8_t                 ESI:1;          /**< @brief Error passive.      */
+  };
+  union {
+    struct {
+      uint32_t              SID:11;         /**< @brief Standard identifier.*/
+    };
+    struct {
+      uint32_t              EID:29;         /**< @brief Extended identifier.*/
+    };
+  };
+  union {
+    uint8_t                 data8[64];      /**< @brief Frame data.         */
+    uint16_t                data16[32];     /**< @brief Frame data.         */
+    uint32_t                data32[16];     /**< @brief Frame data.         */
+    uint64_t                data64[8];      /**< @brief Frame data.         */
+  };
+} CANRxFrame;
+
+/**
+ * @brief   Driver configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   FDCAN CCCR register initialization data.
+   * @note    Only the @p FDOE, @p BRSE, @p TXP, @p NISO, @p PXHD, @p DAR,
+   *          @p MON, @p ASM and @p TEST bits are used, the others are
+   *          enforced by the driver.
+   */
+  uint32_t                  cccr;
+  /**
+   * @brief   FDCAN NBTP register initialization data.
+   */
+  uint32_t                  nbtp;
+  /**
+   * @brief   FDCAN DBTP register initialization data.
+   * @note    Transmitter delay compensation should be enabled for data
+   *          phase bit rates above 1Mbps.
+   */
+  uint32_t                  dbtp;
+  /**
+   * @brief   FDCAN TDCR register initialization data.
+   */
+  uint32_t                  tdcr;
+} CANConfig;
+
+/**
+ * @brief   Structure representing an CAN driver.
+ */
+struct CANDriver {
+  /**
+   * @brief   Driver state.
+   */
+  canstate_t                state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const CANConfig           *config;
+  /**
+   * @brief   Transmission threads queue.
+   */
+  threads_queue_t           txqueue;
+  /**
+   * @brief   Receive threads queue.
+   */
+  threads_queue_t           rxqueue;
+#if (CAN_ENFORCE_USE_CALLBACKS == FALSE) || defined(__DOXYGEN__)
+  /**
+   * @brief   One or more frames become available.
+   * @note    After broadcasting this event it will not be broadcasted again
+   *          until the received frames queue has been completely emptied. It
+   *          is <b>not</b> broadcasted for each received frame. It is
+   *          responsibility of the application to empty the queue by
+   *          repeatedly invoking @p canReceive() when listening to this event.
+   *          This behavior minimizes the interrupt served by the system
+   *          because CAN traffic.
+   * @note    The flags associated to the listeners will indicate which
+   *          receive mailboxes become non-empty.
+   */
+  event_source_t            rxfull_event;
+  /**
+   * @brief   One or more transmission mailbox become available.
+   * @note    The flags associated to the listeners will indicate which
+   *          transmit mailboxes become empty.
+   */
+  event_source_t            txempty_event;
+  /**
+   * @brief   A CAN bus error happened.
+   * @note    The flags associated to the listeners will indicate that
+   *          receive error(s) have occurred.
+   * @note    In this implementation the upper 16 bits are filled with the
+   *          unprocessed content of the PSR register.
+   */
+  event_source_t            error_event;
+#if CAN_USE_SLEEP_MODE || defined (__DOXYGEN__)
+  /**
+   * @brief   Entering sleep state event.
+   */
+  event_source_t            sleep_event;
+  /**
+   * @brief   Exiting sleep state event.
+   */
+  event_source_t            wakeup_event;
+#endif /* CAN_USE_SLEEP_MODE */
+#else /* CAN_ENFORCE_USE_CALLBACKS == TRUE */
+  /**
+   * @brief   One or more frames become available.
+   * @note    After calling this function it will not be called again
+   *          until the received frames queue has been completely emptied. It
+   *          is <b>not</b> called for each received frame. It is
+   *          responsibility of the application to empty the queue by
+   *          repeatedly invoking @p chTryReceiveI().
+   *          This behavior minimizes the interrupt served by the system
+   *          because CAN traffic.
+   */
+  can_callback_t            rxfull_cb;
+  /**
+   * @brief   One or more transmission mailbox become available.
+   * @note    The flags associated to the callback will indicate which
+   *          transmit mailboxes become empty.
+   */
+  can_callback_t            txempty_cb;
+  /**
+   * @brief   A CAN bus error happened.
+   */
+  can_callback_t            error_cb;
+#if (CAN_USE_SLEEP_MODE == TRUE) || defined (__DOXYGEN__)
+  /**
+   * @brief   Exiting sleep state.
+   */
+  can_callback_t            wakeup_cb;
+#endif
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Pointer to the FDCAN registers.
+   */
+  FDCAN_GlobalTypeDef       *fdcan;
+  /**
+   * @brief   Pointer to the message RAM area of this instance.
+   */
+  uint32_t                  *ram;
+  /**
+   * @brief   Number of programmed standard identifier filters.
+   */
+  uint32_t                  std_filters;
+  /**
+   * @brief   Number of programmed extended identifier filters.
+   */
+  uint32_t                  ext_filters;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if STM32_CAN_USE_FDCAN1 && !defined(__DOXYGEN__)
+extern CANDriver CAND1;
+#endif
+
+#if STM32_CAN_USE_FDCAN2 && !defined(__DOXYGEN__)
+extern CANDriver CAND2;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void can_lld_init(void);
+  void can_lld_start(CANDriver *canp);
+  void can_lld_stop(CANDriver *canp);
+  bool can_lld_is_tx_empty(CANDriver *canp, canmbx_t mailbox);
+  void can_lld_transmit(CANDriver *canp,
+                        canmbx_t mailbox,
+                        const CANTxFrame *crfp);
+  bool can_lld_is_rx_nonempty(CANDriver *canp, canmbx_t mailbox);
+  void can_lld_receive(CANDriver *canp,
+                       canmbx_t mailbox,
+                       CANRxFrame *ctfp);
+#if CAN_USE_SLEEP_MODE
+  void can_lld_sleep(CANDriver *canp);
+  void can_lld_wakeup(CANDriver *canp);
+#endif /* CAN_USE_SLEEP_MODE */
+  void can_lld_set_id_filters(CANDriver *canp,
+                              const CANIdFilter *fp,
+                              size_t n);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_CAN */
+
+#endif /* HAL_CAN_LLD_H */
+
+/** @} */
@@ -0,0 +1,2 @@
+PLATFORMSRC += $(CHIBIOS)/os/hal/ports/STM32/LLD/FMCv1/stm32_fmc.c
+PLATFORMINC += $(CHIBIOS)/os/hal/ports/STM32/LLD/FMCv1
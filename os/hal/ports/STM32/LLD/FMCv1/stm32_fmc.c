@@ -0,0 +1,243 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    FMCv1/stm32_fmc.c
+ * @brief   FMC SDRAM helper driver code.
+ *
+ * @addtogroup STM32_FMC
+ * @details FMC SDRAM helper driver. The driver programs an SDRAM bank
+ *          using timings expressed in nanoseconds, the SDCLK cycles are
+ *          calculated from the FMC clock settings. The JEDEC initialization
+ *          sequence is performed and, optionally, an MPU region is set
+ *          over the bank in order to make it cacheable.<br>
+ *          Once started the SDRAM can be registered as a region of the
+ *          core memory manager:
+ *          @code
+ *          fmcSdramStart(1U, &sdram_cfg);
+ *          chCoreRegionInit(0U, fmcSdramGetBase(1U),
+ *                           fmcSdramGetSize(&sdram_cfg),
+ *                           CH_MEM_ATTR_DMA | CH_MEM_ATTR_LARGE);
+ *          @endcode
+ * @note    The GPIOs must be configured by the board files before starting
+ *          the SDRAM.
+ * @{
+ */
+
+#include "hal.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @name    SDRAM commands
+ * @{
+ */
+#define FMC_CMD_CLK_ENABLE          1U
+#define FMC_CMD_PALL                2U
+#define FMC_CMD_AUTOREFRESH         3U
+#define FMC_CMD_LOAD_MODE           4U
+/** @} */
+
+/**
+ * @brief   SDCR bits only implemented in the bank 1 register.
+ */
+#define FMC_SDCR_SHARED_MASK        (FMC_SDCR1_SDCLK_Msk |                  \
+                                     FMC_SDCR1_RBURST_Msk |                 \
+                                     FMC_SDCR1_RPIPE_Msk)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Converts nanoseconds in SDCLK cycles.
+ * @note    The result is rounded upward and clamped to the 1..16 range of
+ *          the SDTR fields.
+ *
+ * @param[in] khz       SDCLK frequency in kHz
+ * @param[in] ns        interval in nanoseconds
+ * @return              The SDTR field value, cycles minus one.
+ *
+ * @notapi
+ */
+static uint32_t fmc_ns2field(uint32_t khz, uint32_t ns) {
+  uint32_t cycles;
+
+  cycles = ((ns * khz) + 999999U) / 1000000U;
+  if (cycles < 1U) {
+    cycles = 1U;
+  }
+  else if (cycles > 16U) {
+    cycles = 16U;
+  }
+
+  return cycles - 1U;
+}
+
+/**
+ * @brief   Sends a command to an SDRAM bank.
+ *
+ * @param[in] ctb       command target bits
+ * @param[in] mode      command mode
+ * @param[in] nrfs      number of auto-refresh commands
+ * @param[in] mrd       mode register value
+ *
+ * @notapi
+ */
+static void fmc_command(uint32_t ctb, uint32_t mode,
+                        uint32_t nrfs, uint32_t mrd) {
+
+  FMC_Bank5_6->SDCMR = ctb | (mode << FMC_SDCMR_MODE_Pos) |
+                       ((nrfs - 1U) << FMC_SDCMR_NRFS_Pos) |
+                       (mrd << FMC_SDCMR_MRD_Pos);
+#if defined(FMC_SDSR_BUSY)
+  while ((FMC_Bank5_6->SDSR & FMC_SDSR_BUSY) != 0U) {
+  }
+#endif
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the size of an SDRAM device.
+ *
+ * @param[in] cfg       pointer to the SDRAM configuration
+ * @return              The device size in bytes.
+ *
+ * @xclass
+ */
+size_t fmcSdramGetSize(const stm32_fmc_sdram_config_t *cfg) {
+  uint32_t log2size;
+
+  log2size = 8U + ((cfg->sdcr & FMC_SDCR1_NC_Msk) >> FMC_SDCR1_NC_Pos) +
+             11U + ((cfg->sdcr & FMC_SDCR1_NR_Msk) >> FMC_SDCR1_NR_Pos) +
+             ((cfg->sdcr & FMC_SDCR1_MWID_Msk) >> FMC_SDCR1_MWID_Pos) +
+             ((cfg->sdcr & FMC_SDCR1_NB) != 0U ? 2U : 1U);
+
+  return (size_t)1U << log2size;
+}
+
+/**
+ * @brief   Starts an SDRAM bank.
+ * @details The FMC is enabled, the bank is programmed and the device
+ *          initialization sequence is performed. On return the memory is
+ *          accessible.
+ * @note    The SDCLK, read burst and read pipe settings are shared by the
+ *          two banks, the last started bank determines them.
+ *
+ * @param[in] bank      the SDRAM bank, 1 or 2
+ * @param[in] cfg       pointer to the SDRAM configuration
+ *
+ * @init
+ */
+void fmcSdramStart(uint32_t bank, const stm32_fmc_sdram_config_t *cfg) {
+  uint32_t khz, sdcr, sdtr, ctb, count;
+
+  osalDbgCheck(((bank == 1U) || (bank == 2U)) && (cfg != NULL) &&
+               ((cfg->sdclk_div == 2U) || (cfg->sdclk_div == 3U)) &&
+               (cfg->rpipe <= 2U) && (cfg->tmrd >= 1U) && (cfg->tmrd <= 16U) &&
+               (cfg->autorefresh_n >= 1U) && (cfg->autorefresh_n <= 16U));
+
+  rccEnableFSMC(true);
+
+  khz  = (uint32_t)STM32_FMC_CLK / cfg->sdclk_div / 1000U;
+  ctb  = bank == 1U ? FMC_SDCMR_CTB1 : FMC_SDCMR_CTB2;
+
+  /* Control register, the shared fields are always in SDCR1.*/
+  sdcr = (cfg->sdclk_div << FMC_SDCR1_SDCLK_Pos) |
+         (cfg->rpipe << FMC_SDCR1_RPIPE_Pos) |
+         (cfg->read_burst ? FMC_SDCR1_RBURST : 0U);
+  FMC_Bank5_6->SDCR[0] = (FMC_Bank5_6->SDCR[0] & ~FMC_SDCR_SHARED_MASK) |
+                         sdcr;
+  FMC_Bank5_6->SDCR[bank - 1U] = (FMC_Bank5_6->SDCR[bank - 1U] &
+                                  FMC_SDCR_SHARED_MASK) |
+                                 (cfg->sdcr & ~FMC_SDCR_SHARED_MASK);
+
+  /* Timing register, TRC and TRP are only implemented in SDTR1.*/
+  sdtr = ((cfg->tmrd - 1U) << FMC_SDTR1_TMRD_Pos) |
+         (fmc_ns2field(khz, cfg->txsr_ns) << FMC_SDTR1_TXSR_Pos) |
+         (fmc_ns2field(khz, cfg->tras_ns) << FMC_SDTR1_TRAS_Pos) |
+         (fmc_ns2field(khz, cfg->twr_ns)  << FMC_SDTR1_TWR_Pos) |
+         (fmc_ns2field(khz, cfg->trcd_ns) << FMC_SDTR1_TRCD_Pos);
+  FMC_Bank5_6->SDTR[0] = (FMC_Bank5_6->SDTR[0] &
+                          ~(FMC_SDTR1_TRC_Msk | FMC_SDTR1_TRP_Msk)) |
+                         (fmc_ns2field(khz, cfg->trc_ns) << FMC_SDTR1_TRC_Pos) |
+                         (fmc_ns2field(khz, cfg->trp_ns) << FMC_SDTR1_TRP_Pos);
+  FMC_Bank5_6->SDTR[bank - 1U] = (FMC_Bank5_6->SDTR[bank - 1U] &
+                                  (FMC_SDTR1_TRC_Msk | FMC_SDTR1_TRP_Msk)) |
+                                 sdtr;
+
+  /* Write FIFO setting, shared with the NOR/SRAM banks.*/
+  if (cfg->write_fifo) {
+    FMC_Bank1->BTCR[0] &= ~FMC_BCR1_WFDIS;
+  }
+  else {
+    FMC_Bank1->BTCR[0] |= FMC_BCR1_WFDIS;
+  }
+
+#if defined(FMC_BCR1_FMCEN)
+  /* The controller is enabled after the configuration.*/
+  FMC_Bank1->BTCR[0] |= FMC_BCR1_FMCEN;
+#endif
+
+  /* JEDEC initialization sequence, the clock is enabled then at least
+     100uS are required before the precharge.*/
+  fmc_command(ctb, FMC_CMD_CLK_ENABLE, 1U, 0U);
+  osalSysPolledDelayX(OSAL_US2RTC(STM32_FMC_DELAY_CLK, 100U));
+  fmc_command(ctb, FMC_CMD_PALL, 1U, 0U);
+  fmc_command(ctb, FMC_CMD_AUTOREFRESH, cfg->autorefresh_n, 0U);
+  fmc_command(ctb, FMC_CMD_LOAD_MODE, 1U, cfg->mode);
+
+  /* Refresh timer, the margin of 20 cycles is required by the reference
+     manual, the result is rounded downward.*/
+  count = ((cfg->refresh_ns * khz) / 1000000U) - 20U;
+  FMC_Bank5_6->SDRTR = (count << FMC_SDRTR_COUNT_Pos) & FMC_SDRTR_COUNT_Msk;
+
+  /* Optional MPU region covering the whole bank.*/
+  if (cfg->mpu_attrs != 0U) {
+    uint32_t size = (uint32_t)fmcSdramGetSize(cfg);
+    uint32_t log2size = 31U - (uint32_t)__CLZ(size);
+
+    mpuConfigureRegion(cfg->mpu_region,
+                       fmcSdramGetBase(bank),
+                       MPU_RASR_ATTR_AP_RW_RW |
+                       cfg->mpu_attrs |
+                       MPU_RASR_SIZE(log2size - 1U) |
+                       MPU_RASR_ENABLE);
+    mpuEnable(MPU_CTRL_PRIVDEFENA);
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT != 0)
+    SCB_CleanInvalidateDCache();
+#endif
+  }
+}
+
+/** @} */
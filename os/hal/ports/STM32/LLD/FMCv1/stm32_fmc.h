@@ -0,0 +1,224 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    FMCv1/stm32_fmc.h
+ * @brief   FMC SDRAM helper driver header.
+ *
+ * @addtogroup STM32_FMC
+ * @{
+ */
+
+#ifndef STM32_FMC_H
+#define STM32_FMC_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    SDRAM banks base addresses
+ * @{
+ */
+#define STM32_FMC_SDRAM1_BASE       0xC0000000U
+#define STM32_FMC_SDRAM2_BASE       0xD0000000U
+/** @} */
+
+/**
+ * @name    SDCR register constants
+ * @{
+ */
+#define STM32_FMC_SDCR_NC_8         (0U << FMC_SDCR1_NC_Pos)
+#define STM32_FMC_SDCR_NC_9         (1U << FMC_SDCR1_NC_Pos)
+#define STM32_FMC_SDCR_NC_10        (2U << FMC_SDCR1_NC_Pos)
+#define STM32_FMC_SDCR_NC_11        (3U << FMC_SDCR1_NC_Pos)
+#define STM32_FMC_SDCR_NR_11        (0U << FMC_SDCR1_NR_Pos)
+#define STM32_FMC_SDCR_NR_12        (1U << FMC_SDCR1_NR_Pos)
+#define STM32_FMC_SDCR_NR_13        (2U << FMC_SDCR1_NR_Pos)
+#define STM32_FMC_SDCR_MWID_8       (0U << FMC_SDCR1_MWID_Pos)
+#define STM32_FMC_SDCR_MWID_16      (1U << FMC_SDCR1_MWID_Pos)
+#define STM32_FMC_SDCR_MWID_32      (2U << FMC_SDCR1_MWID_Pos)
+#define STM32_FMC_SDCR_NB_2         0U
+#define STM32_FMC_SDCR_NB_4         FMC_SDCR1_NB
+#define STM32_FMC_SDCR_CAS(n)       ((n) << FMC_SDCR1_CAS_Pos)
+#define STM32_FMC_SDCR_WP           FMC_SDCR1_WP
+/** @} */
+
+/**
+ * @name    SDRAM mode register constants
+ * @{
+ */
+#define STM32_FMC_SDMR_BURST_1      0x0000U
+#define STM32_FMC_SDMR_BURST_2      0x0001U
+#define STM32_FMC_SDMR_BURST_4      0x0002U
+#define STM32_FMC_SDMR_BURST_8      0x0003U
+#define STM32_FMC_SDMR_INTERLEAVED  0x0008U
+#define STM32_FMC_SDMR_CAS(n)       ((n) << 4U)
+#define STM32_FMC_SDMR_WBURST_SINGLE 0x0200U
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+#if !defined(STM32_FSMC_IS_FMC)
+#error "STM32_FSMC_IS_FMC missing in registry"
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/**
+ * @brief   FMC kernel clock.
+ */
+#if defined(STM32_FMCCLK) || defined(__DOXYGEN__)
+#define STM32_FMC_CLK               STM32_FMCCLK
+#else
+#define STM32_FMC_CLK               STM32_HCLK
+#endif
+
+/**
+ * @brief   Clock of the polled delays.
+ */
+#if defined(STM32_CORE_CK) || defined(__DOXYGEN__)
+#define STM32_FMC_DELAY_CLK         STM32_CORE_CK
+#else
+#define STM32_FMC_DELAY_CLK         STM32_SYSCLK
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of an SDRAM configuration.
+ * @note    Timings are specified in nanoseconds as found in the device
+ *          datasheet, they are converted in SDCLK cycles by the driver
+ *          using the FMC clock tree settings.
+ */
+typedef struct {
+  /**
+   * @brief   SDCR register bits for columns, rows, width, banks, CAS
+   *          latency and write protection.
+   */
+  uint32_t                  sdcr;
+  /**
+   * @brief   SDCLK divider, 2 or 3.
+   */
+  uint32_t                  sdclk_div;
+  /**
+   * @brief   Read pipe delay in FMC clock cycles, 0..2.
+   */
+  uint32_t                  rpipe;
+  /**
+   * @brief   Read burst enable.
+   * @details Consecutive single reads within a row are served as a burst
+   *          and kept in the read FIFO.
+   */
+  bool                      read_burst;
+  /**
+   * @brief   Write FIFO enable.
+   * @note    This setting is shared with the other FMC banks.
+   */
+  bool                      write_fifo;
+  /**
+   * @brief   Load mode register to active delay in SDCLK cycles.
+   */
+  uint32_t                  tmrd;
+  /**
+   * @brief   Exit self-refresh delay in nanoseconds.
+   */
+  uint32_t                  txsr_ns;
+  /**
+   * @brief   Self refresh time in nanoseconds.
+   */
+  uint32_t                  tras_ns;
+  /**
+   * @brief   Row cycle delay in nanoseconds.
+   */
+  uint32_t                  trc_ns;
+  /**
+   * @brief   Recovery delay in nanoseconds.
+   */
+  uint32_t                  twr_ns;
+  /**
+   * @brief   Row precharge delay in nanoseconds.
+   */
+  uint32_t                  trp_ns;
+  /**
+   * @brief   Row to column delay in nanoseconds.
+   */
+  uint32_t                  trcd_ns;
+  /**
+   * @brief   Interval between row refreshes in nanoseconds.
+   * @details It is the refresh period divided by the number of rows, for
+   *          example 64ms / 8192 rows.
+   */
+  uint32_t                  refresh_ns;
+  /**
+   * @brief   Number of auto-refresh commands in the initialization
+   *          sequence, 1..16.
+   */
+  uint32_t                  autorefresh_n;
+  /**
+   * @brief   SDRAM mode register value.
+   */
+  uint32_t                  mode;
+  /**
+   * @brief   MPU region number used for the SDRAM bank.
+   */
+  uint32_t                  mpu_region;
+  /**
+   * @brief   MPU region memory attributes.
+   * @details The whole bank is covered using these attributes, for example
+   *          @p MPU_RASR_ATTR_CACHEABLE_WB_WA or
+   *          @p MPU_RASR_ATTR_NON_CACHEABLE. If zero then the MPU is not
+   *          programmed and the default memory map applies, the SDRAM banks
+   *          are then device memory, not cacheable and not executable.
+   */
+  uint32_t                  mpu_attrs;
+} stm32_fmc_sdram_config_t;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the base address of an SDRAM bank.
+ *
+ * @param[in] bank      the SDRAM bank, 1 or 2
+ * @return              The bank base address.
+ */
+#define fmcSdramGetBase(bank)                                               \
+  ((void *)((bank) == 1U ? STM32_FMC_SDRAM1_BASE : STM32_FMC_SDRAM2_BASE))
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void fmcSdramStart(uint32_t bank, const stm32_fmc_sdram_config_t *cfg);
+  size_t fmcSdramGetSize(const stm32_fmc_sdram_config_t *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_FMC_H */
+
+/** @} */
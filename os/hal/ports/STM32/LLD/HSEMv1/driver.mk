@@ -0,0 +1,3 @@
+PLATFORMSRC += $(CHIBIOS)/os/hal/ports/STM32/LLD/HSEMv1/stm32_hsem.c \
+               $(CHIBIOS)/os/hal/ports/STM32/LLD/HSEMv1/stm32_icmb.c
+PLATFORMINC += $(CHIBIOS)/os/hal/ports/STM32/LLD/HSEMv1
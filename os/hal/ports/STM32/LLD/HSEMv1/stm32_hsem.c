@@ -0,0 +1,139 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    HSEMv1/stm32_hsem.c
+ * @brief   HSEM helper driver code.
+ *
+ * @addtogroup STM32_HSEM
+ * @details HSEM helper driver. The hardware semaphores are shared among the
+ *          cores of a multi-core device, the release of a semaphore can
+ *          interrupt the other cores, this driver dispatches the release
+ *          events to the registered callbacks.
+ * @{
+ */
+
+#include "hal.h"
+
+#if (STM32_HSEM_ENABLED == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   HSEM callback redirector type.
+ */
+typedef struct {
+  stm32_hsemcb_t        func;           /**< @brief Callback function.      */
+  void                  *param;         /**< @brief Callback parameter.     */
+} hsem_cb_redir_t;
+
+/**
+ * @brief   HSEM callbacks.
+ */
+static hsem_cb_redir_t hsem_redir[STM32_HSEM_NUM];
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   HSEM shared ISR.
+ *
+ * @isr
+ */
+OSAL_IRQ_HANDLER(STM32_HSEM_HANDLER) {
+  uint32_t misr, id;
+
+  OSAL_IRQ_PROLOGUE();
+
+  misr = HSEM->MISR;
+  HSEM->ICR = misr;
+  for (id = 0U; misr != 0U; id++, misr >>= 1) {
+    if (((misr & 1U) != 0U) && (hsem_redir[id].func != NULL)) {
+      hsem_redir[id].func(hsem_redir[id].param);
+    }
+  }
+
+  OSAL_IRQ_EPILOGUE();
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   HSEM helper initialization.
+ *
+ * @init
+ */
+void hsemInit(void) {
+  unsigned i;
+
+  for (i = 0U; i < STM32_HSEM_NUM; i++) {
+    hsem_redir[i].func  = NULL;
+    hsem_redir[i].param = NULL;
+  }
+
+  rccEnableAHB4(RCC_AHB4ENR_HSEMEN, true);
+  HSEM->IER = 0U;
+  nvicEnableVector(STM32_HSEM_NUMBER, STM32_IRQ_HSEM_PRIORITY);
+}
+
+/**
+ * @brief   Registers a release notification callback on a semaphore.
+ * @details The callback is invoked from ISR context each time the
+ *          semaphore is released by any master.
+ *
+ * @param[in] id        semaphore identifier
+ * @param[in] func      callback function or @p NULL for disabling the
+ *                      notification
+ * @param[in] param     parameter to be passed to the callback
+ *
+ * @iclass
+ */
+void hsemSetCallbackI(uint32_t id, stm32_hsemcb_t func, void *param) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck(id < STM32_HSEM_NUM);
+
+  hsem_redir[id].func  = func;
+  hsem_redir[id].param = param;
+  if (func != NULL) {
+    HSEM->ICR  = 1U << id;
+    HSEM->IER |= 1U << id;
+  }
+  else {
+    HSEM->IER &= ~(1U << id);
+  }
+}
+
+#endif /* STM32_HSEM_ENABLED == TRUE */
+
+/** @} */
@@ -0,0 +1,172 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    HSEMv1/stm32_hsem.h
+ * @brief   HSEM helper driver header.
+ *
+ * @addtogroup STM32_HSEM
+ * @{
+ */
+
+#ifndef STM32_HSEM_H
+#define STM32_HSEM_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of hardware semaphores.
+ */
+#define STM32_HSEM_NUM              32U
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Enables the HSEM helper driver.
+ */
+#if !defined(STM32_HSEM_ENABLED) || defined(__DOXYGEN__)
+#define STM32_HSEM_ENABLED          FALSE
+#endif
+
+/**
+ * @brief   Bus master identifier of the core running this image.
+ * @note    The Cortex-M7 core is identified as 3, on dual core devices the
+ *          Cortex-M4 core is identified as 1.
+ */
+#if !defined(STM32_HSEM_MASTERID) || defined(__DOXYGEN__)
+#define STM32_HSEM_MASTERID         3U
+#endif
+
+/**
+ * @brief   HSEM interrupt priority level setting.
+ */
+#if !defined(STM32_IRQ_HSEM_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_IRQ_HSEM_PRIORITY     10
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (STM32_HSEM_ENABLED == TRUE) && !STM32_HAS_HSEM
+#error "HSEM not present in the selected device"
+#endif
+
+#if (STM32_HSEM_ENABLED == TRUE) &&                                         \
+    !OSAL_IRQ_IS_VALID_PRIORITY(STM32_IRQ_HSEM_PRIORITY)
+#error "Invalid IRQ priority assigned to HSEM"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   HSEM release notification callback type.
+ *
+ * @param[in] p         parameter for the registered function
+ */
+typedef void (*stm32_hsemcb_t)(void *p);
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if (STM32_HSEM_ENABLED == TRUE) || defined(__DOXYGEN__)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void hsemInit(void);
+  void hsemSetCallbackI(uint32_t id, stm32_hsemcb_t func, void *param);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Driver inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Tries to take a semaphore.
+ * @details The one-step lock procedure is used, the semaphore is taken
+ *          with process identifier zero.
+ *
+ * @param[in] id        semaphore identifier
+ * @return              The operation result.
+ * @retval false        if the semaphore is taken by another master.
+ * @retval true         if the semaphore has been taken.
+ *
+ * @xclass
+ */
+static inline bool hsemTryTakeX(uint32_t id) {
+
+  return HSEM->RLR[id] == (HSEM_RLR_LOCK |
+                           (STM32_HSEM_MASTERID << HSEM_RLR_MASTERID_Pos));
+}
+
+/**
+ * @brief   Releases a semaphore.
+ * @note    The masters having the semaphore interrupt enabled are notified
+ *          of the release.
+ *
+ * @param[in] id        semaphore identifier
+ *
+ * @xclass
+ */
+static inline void hsemReleaseX(uint32_t id) {
+
+  HSEM->R[id] = STM32_HSEM_MASTERID << HSEM_R_MASTERID_Pos;
+}
+
+/**
+ * @brief   Notifies the other cores using a semaphore.
+ * @details The semaphore is taken and immediately released, the cores
+ *          having registered a callback on the semaphore are interrupted.
+ *
+ * @param[in] id        semaphore identifier
+ *
+ * @xclass
+ */
+static inline void hsemNotifyX(uint32_t id) {
+
+  /* Ensures that the data written before the notification is visible to
+     the other bus masters.*/
+  __DSB();
+
+  while (!hsemTryTakeX(id)) {
+  }
+  hsemReleaseX(id);
+}
+
+#endif /* STM32_HSEM_ENABLED == TRUE */
+
+#endif /* STM32_HSEM_H */
+
+/** @} */
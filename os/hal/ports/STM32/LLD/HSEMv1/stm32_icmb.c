@@ -0,0 +1,315 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    HSEMv1/stm32_icmb.c
+ * @brief   Inter-core mailbox code.
+ *
+ * @addtogroup STM32_ICMB
+ * @details Single producer, single consumer mailbox between two cores
+ *          each running its own OS instance. The messages ring is in shared
+ *          memory with explicit cache maintenance, the cores notify each
+ *          other using the HSEM release interrupts. Posting pointers to
+ *          objects in shared memory allows zero-copy handoff, a second
+ *          mailbox in the opposite direction can return the objects to
+ *          the producer making an inter-core objects FIFO.
+ * @{
+ */
+
+#include "hal.h"
+
+#if (STM32_HSEM_ENABLED == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Notification from the other core.
+ *
+ * @param[in] p         pointer to the @p stm32_icmb_t object
+ */
+static void icmb_notify(void *p) {
+  stm32_icmb_t *mbp = (stm32_icmb_t *)p;
+
+  osalSysLockFromISR();
+  osalThreadDequeueAllI(&mbp->waiting, MSG_OK);
+  osalSysUnlockFromISR();
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a mailbox local object.
+ *
+ * @param[out] mbp      pointer to the @p stm32_icmb_t object
+ *
+ * @init
+ */
+void icmbObjectInit(stm32_icmb_t *mbp) {
+
+  mbp->config   = NULL;
+  mbp->producer = false;
+  osalThreadQueueObjectInit(&mbp->waiting);
+}
+
+/**
+ * @brief   Resets the shared state of a mailbox.
+ * @note    Only one of the cores must invoke this function before both
+ *          cores start the mailbox.
+ *
+ * @param[in] config    pointer to the mailbox configuration
+ *
+ * @api
+ */
+void icmbReset(const stm32_icmbconfig_t *config) {
+
+  osalDbgCheck((config != NULL) && (config->size > 0U) &&
+               (((uint32_t)config->shared & (CACHE_LINE_SIZE - 1U)) == 0U));
+
+  config->shared->wridx = 0U;
+  config->shared->rdidx = 0U;
+  cacheBufferFlush(config->shared, sizeof (stm32_icmb_shared_t));
+}
+
+/**
+ * @brief   Starts a mailbox side.
+ * @details The notification callback is registered on the semaphore
+ *          released by the other side.
+ *
+ * @param[in] mbp       pointer to the @p stm32_icmb_t object
+ * @param[in] config    pointer to the mailbox configuration
+ * @param[in] producer  @p true for the posting side, @p false for the
+ *                      fetching side
+ *
+ * @api
+ */
+void icmbStart(stm32_icmb_t *mbp, const stm32_icmbconfig_t *config,
+               bool producer) {
+
+  osalDbgCheck((mbp != NULL) && (config != NULL) && (config->size > 0U) &&
+               (config->postsem < STM32_HSEM_NUM) &&
+               (config->fetchsem < STM32_HSEM_NUM) &&
+               (config->postsem != config->fetchsem));
+
+  osalSysLock();
+  osalDbgAssert(mbp->config == NULL, "already started");
+  mbp->config   = config;
+  mbp->producer = producer;
+  hsemSetCallbackI(producer ? config->fetchsem : config->postsem,
+                   icmb_notify, (void *)mbp);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Stops a mailbox side.
+ * @details The local waiting threads are released with @p MSG_RESET.
+ *
+ * @param[in] mbp       pointer to the @p stm32_icmb_t object
+ *
+ * @api
+ */
+void icmbStop(stm32_icmb_t *mbp) {
+
+  osalDbgCheck(mbp != NULL);
+
+  osalSysLock();
+  osalDbgAssert(mbp->config != NULL, "not started");
+  hsemSetCallbackI(mbp->producer ? mbp->config->fetchsem :
+                                   mbp->config->postsem,
+                   NULL, NULL);
+  mbp->config = NULL;
+  osalThreadDequeueAllI(&mbp->waiting, MSG_RESET);
+  osalOsRescheduleS();
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Posts a message.
+ *
+ * @param[in] mbp       pointer to the @p stm32_icmb_t object
+ * @param[in] msg       message to be posted
+ * @return              The operation status.
+ * @retval MSG_OK       if the message has been posted.
+ * @retval MSG_TIMEOUT  if the mailbox is full.
+ *
+ * @iclass
+ */
+msg_t icmbPostI(stm32_icmb_t *mbp, msg_t msg) {
+  const stm32_icmbconfig_t *config = mbp->config;
+  stm32_icmb_shared_t *shp;
+  msg_t *slotp;
+  uint32_t wr;
+
+  osalDbgCheckClassI();
+  osalDbgAssert((config != NULL) && mbp->producer, "not a producer");
+
+  shp = config->shared;
+  wr  = shp->wridx;
+
+  /* The read index is written by the other core.*/
+  cacheBufferInvalidate(&shp->rdidx, sizeof (uint32_t));
+  if ((size_t)(wr - shp->rdidx) >= config->size) {
+    return MSG_TIMEOUT;
+  }
+
+  /* The message is made visible before the index.*/
+  slotp  = &config->buffer[wr % config->size];
+  *slotp = msg;
+  cacheBufferClean(slotp, sizeof (msg_t));
+  shp->wridx = wr + 1U;
+  cacheBufferClean(&shp->wridx, sizeof (uint32_t));
+
+  hsemNotifyX(config->postsem);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Posts a message.
+ * @details If the mailbox is full the calling thread waits for a message
+ *          to be fetched by the other core.
+ *
+ * @param[in] mbp       pointer to the @p stm32_icmb_t object
+ * @param[in] msg       message to be posted
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the message has been posted.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ * @retval MSG_RESET    if the mailbox has been stopped.
+ *
+ * @api
+ */
+msg_t icmbPostTimeout(stm32_icmb_t *mbp, msg_t msg, sysinterval_t timeout) {
+  msg_t rdymsg;
+
+  osalDbgCheck(mbp != NULL);
+
+  osalSysLock();
+  do {
+    rdymsg = icmbPostI(mbp, msg);
+    if (rdymsg == MSG_OK) {
+      break;
+    }
+    rdymsg = osalThreadEnqueueTimeoutS(&mbp->waiting, timeout);
+  } while (rdymsg == MSG_OK);
+  osalSysUnlock();
+
+  return rdymsg;
+}
+
+/**
+ * @brief   Fetches a message.
+ *
+ * @param[in] mbp       pointer to the @p stm32_icmb_t object
+ * @param[out] msgp     pointer to a message variable for the received
+ *                      message
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been fetched.
+ * @retval MSG_TIMEOUT  if the mailbox is empty.
+ *
+ * @iclass
+ */
+msg_t icmbFetchI(stm32_icmb_t *mbp, msg_t *msgp) {
+  const stm32_icmbconfig_t *config = mbp->config;
+  stm32_icmb_shared_t *shp;
+  msg_t *slotp;
+  uint32_t rd;
+
+  osalDbgCheckClassI();
+  osalDbgAssert((config != NULL) && !mbp->producer, "not a consumer");
+
+  shp = config->shared;
+  rd  = shp->rdidx;
+
+  /* The write index is written by the other core.*/
+  cacheBufferInvalidate(&shp->wridx, sizeof (uint32_t));
+  if (shp->wridx == rd) {
+    return MSG_TIMEOUT;
+  }
+
+  /* The slot is read after the index.*/
+  slotp = &config->buffer[rd % config->size];
+  cacheBufferInvalidate(slotp, sizeof (msg_t));
+  *msgp = *slotp;
+  shp->rdidx = rd + 1U;
+  cacheBufferClean(&shp->rdidx, sizeof (uint32_t));
+
+  hsemNotifyX(config->fetchsem);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Fetches a message.
+ * @details If the mailbox is empty the calling thread waits for a message
+ *          to be posted by the other core.
+ *
+ * @param[in] mbp       pointer to the @p stm32_icmb_t object
+ * @param[out] msgp     pointer to a message variable for the received
+ *                      message
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been fetched.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ * @retval MSG_RESET    if the mailbox has been stopped.
+ *
+ * @api
+ */
+msg_t icmbFetchTimeout(stm32_icmb_t *mbp, msg_t *msgp,
+                       sysinterval_t timeout) {
+  msg_t rdymsg;
+
+  osalDbgCheck((mbp != NULL) && (msgp != NULL));
+
+  osalSysLock();
+  do {
+    rdymsg = icmbFetchI(mbp, msgp);
+    if (rdymsg == MSG_OK) {
+      break;
+    }
+    rdymsg = osalThreadEnqueueTimeoutS(&mbp->waiting, timeout);
+  } while (rdymsg == MSG_OK);
+  osalSysUnlock();
+
+  return rdymsg;
+}
+
+#endif /* STM32_HSEM_ENABLED == TRUE */
+
+/** @} */
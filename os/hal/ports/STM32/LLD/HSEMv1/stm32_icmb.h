@@ -0,0 +1,168 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    HSEMv1/stm32_icmb.h
+ * @brief   Inter-core mailbox header.
+ *
+ * @addtogroup STM32_ICMB
+ * @{
+ */
+
+#ifndef STM32_ICMB_H
+#define STM32_ICMB_H
+
+#if (STM32_HSEM_ENABLED == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Mailbox state shared among the cores.
+ * @details Each index is written by a single core and lies in its own
+ *          cache line.
+ * @note    Objects of this type must be allocated in memory accessible by
+ *          both cores and aligned to @p CACHE_LINE_SIZE.
+ */
+typedef struct {
+  /**
+   * @brief   Write index, written by the producer core.
+   */
+  volatile uint32_t         wridx;
+  uint8_t                   wrpad[CACHE_LINE_SIZE - sizeof (uint32_t)];
+  /**
+   * @brief   Read index, written by the consumer core.
+   */
+  volatile uint32_t         rdidx;
+  uint8_t                   rdpad[CACHE_LINE_SIZE - sizeof (uint32_t)];
+} stm32_icmb_shared_t;
+
+/**
+ * @brief   Mailbox configuration.
+ * @note    Both cores must use the same configuration.
+ */
+typedef struct {
+  /**
+   * @brief   Pointer to the shared state.
+   */
+  stm32_icmb_shared_t       *shared;
+  /**
+   * @brief   Pointer to the shared messages buffer.
+   * @note    The buffer must be allocated in memory accessible by both
+   *          cores, it is meant to be declared using
+   *          @p CACHE_ALIGNED_BUFFER().
+   */
+  msg_t                     *buffer;
+  /**
+   * @brief   Number of messages in the buffer.
+   */
+  size_t                    size;
+  /**
+   * @brief   Semaphore released by the producer after posting.
+   */
+  uint32_t                  postsem;
+  /**
+   * @brief   Semaphore released by the consumer after fetching.
+   */
+  uint32_t                  fetchsem;
+} stm32_icmbconfig_t;
+
+/**
+ * @brief   Mailbox local object.
+ */
+typedef struct {
+  /**
+   * @brief   Current configuration or @p NULL if stopped.
+   */
+  const stm32_icmbconfig_t  *config;
+  /**
+   * @brief   @p true if this side posts messages.
+   */
+  bool                      producer;
+  /**
+   * @brief   Queue of the local threads waiting on the mailbox.
+   */
+  threads_queue_t           waiting;
+} stm32_icmb_t;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @name    Zero-copy objects handoff
+ * @{
+ */
+/**
+ * @brief   Makes an object visible to the other core.
+ * @details The producer invokes this macro before posting a pointer to an
+ *          object allocated in shared memory.
+ *
+ * @param[in] objp      pointer to the object
+ * @param[in] size      size of the object
+ */
+#define icmbPublishObject(objp, size) cacheBufferClean(objp, size)
+
+/**
+ * @brief   Makes an object written by the other core visible.
+ * @details The consumer invokes this macro after fetching a pointer to an
+ *          object allocated in shared memory.
+ *
+ * @param[in] objp      pointer to the object
+ * @param[in] size      size of the object
+ */
+#define icmbAcquireObject(objp, size) cacheBufferInvalidateRange(objp, size)
+/** @} */
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void icmbObjectInit(stm32_icmb_t *mbp);
+  void icmbReset(const stm32_icmbconfig_t *config);
+  void icmbStart(stm32_icmb_t *mbp, const stm32_icmbconfig_t *config,
+                 bool producer);
+  void icmbStop(stm32_icmb_t *mbp);
+  msg_t icmbPostI(stm32_icmb_t *mbp, msg_t msg);
+  msg_t icmbPostTimeout(stm32_icmb_t *mbp, msg_t msg, sysinterval_t timeout);
+  msg_t icmbFetchI(stm32_icmb_t *mbp, msg_t *msgp);
+  msg_t icmbFetchTimeout(stm32_icmb_t *mbp, msg_t *msgp,
+                         sysinterval_t timeout);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_HSEM_ENABLED == TRUE */
+
+#endif /* STM32_ICMB_H */
+
+/** @} */
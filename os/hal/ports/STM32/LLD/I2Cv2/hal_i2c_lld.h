@@ -51,6 +51,11 @@
 #define STM32_TIMINGR_SCLL(n)           ((n) << 0)
 /** @} */
 
+/**
+ * @brief   Support for asynchronous transactions.
+ */
+#define I2C_SUPPORTS_TRANSACTIONS       TRUE
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -395,6 +400,16 @@ struct I2CDriver {
 #if I2C_USE_MUTUAL_EXCLUSION || defined(__DOXYGEN__)
   mutex_t                   mutex;
 #endif /* I2C_USE_MUTUAL_EXCLUSION */
+#if (I2C_USE_TRANSACTIONS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Current transaction or @p NULL if no sequence is running.
+   */
+  const I2CTransaction      *tcurr;
+  /**
+   * @brief   Transactions left in the current sequence.
+   */
+  size_t                    tleft;
+#endif
 #if defined(I2C_DRIVER_EXT_FIELDS)
   I2C_DRIVER_EXT_FIELDS
 #endif
@@ -493,6 +508,10 @@ extern "C" {
   msg_t i2c_lld_master_receive_timeout(I2CDriver *i2cp, i2caddr_t addr,
                                        uint8_t *rxbuf, size_t rxbytes,
                                        sysinterval_t timeout);
+#if I2C_USE_TRANSACTIONS == TRUE
+  void i2c_lld_start_transaction(I2CDriver *i2cp);
+  void i2c_lld_abort_transaction(I2CDriver *i2cp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -1265,6 +1265,115 @@ msg_t i2c_lld_master_transmit_timeout(I2CDriver *i2cp, i2caddr_t addr,
   return msg;
 }
 
+#if (I2C_USE_TRANSACTIONS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the current transaction.
+ * @details The bus busy condition is not polled, the START condition is
+ *          generated by the peripheral as soon as the bus is free, this
+ *          allows to start a transaction while the STOP of the previous
+ *          one is still being sent.
+ * @note    This function can be invoked from ISR context.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+void i2c_lld_start_transaction(I2CDriver *i2cp) {
+  const I2CTransaction *tp = i2cp->tcurr;
+  I2C_TypeDef *dp = i2cp->i2c;
+
+  /* Sizes of transfer phases.*/
+  i2cp->txbytes = tp->txbytes;
+  i2cp->rxbytes = tp->rxbytes;
+
+#if STM32_I2C_USE_DMA == TRUE
+  /* TX and RX DMA setup, note, sizes can be zero but we write the values
+     anyway.*/
+#if defined(STM32_I2C_DMA_REQUIRED) && defined(STM32_I2C_BDMA_REQUIRED)
+  if(i2cp->is_bdma)
+#endif
+#if defined(STM32_I2C_BDMA_REQUIRED)
+  {
+    bdmaStreamSetMode(i2cp->tx.bdma, i2cp->txdmamode);
+    bdmaStreamSetMemory(i2cp->tx.bdma, tp->txbuf);
+    bdmaStreamSetTransactionSize(i2cp->tx.bdma, tp->txbytes);
+
+    bdmaStreamSetMode(i2cp->rx.bdma, i2cp->rxdmamode);
+    bdmaStreamSetMemory(i2cp->rx.bdma, tp->rxbuf);
+    bdmaStreamSetTransactionSize(i2cp->rx.bdma, tp->rxbytes);
+  }
+#endif
+#if defined(STM32_I2C_DMA_REQUIRED) && defined(STM32_I2C_BDMA_REQUIRED)
+  else
+#endif
+#if defined(STM32_I2C_DMA_REQUIRED)
+  {
+    dmaStreamSetMode(i2cp->tx.dma, i2cp->txdmamode);
+    dmaStreamSetMemory0(i2cp->tx.dma, tp->txbuf);
+    dmaStreamSetTransactionSize(i2cp->tx.dma, tp->txbytes);
+
+    dmaStreamSetMode(i2cp->rx.dma, i2cp->rxdmamode);
+    dmaStreamSetMemory0(i2cp->rx.dma, tp->rxbuf);
+    dmaStreamSetTransactionSize(i2cp->rx.dma, tp->rxbytes);
+  }
+#endif
+#else
+  i2cp->txptr = tp->txbuf;
+  i2cp->rxptr = tp->rxbuf;
+#endif
+
+  /* Setting up the slave address.*/
+  i2c_lld_set_address(i2cp, tp->addr);
+
+  if (tp->txbytes > 0U) {
+    /* Transmit phase first, the receive phase is chained by the ISR.*/
+    i2cp->state = I2C_ACTIVE_TX;
+    i2c_lld_setup_tx_transfer(i2cp);
+
+#if STM32_I2C_USE_DMA == TRUE
+    i2c_lld_start_tx_dma(i2cp);
+    dp->CR1 |= I2C_CR1_TCIE;
+#else
+    dp->CR1 |= I2C_CR1_TCIE | I2C_CR1_TXIE;
+#endif
+  }
+  else {
+    /* Receive only transaction.*/
+    i2cp->state = I2C_ACTIVE_RX;
+    i2c_lld_setup_rx_transfer(i2cp);
+
+#if STM32_I2C_USE_DMA == TRUE
+    i2c_lld_start_rx_dma(i2cp);
+    dp->CR1 |= I2C_CR1_TCIE;
+#else
+    dp->CR1 |= I2C_CR1_TCIE | I2C_CR1_RXIE;
+#endif
+  }
+
+  /* Starts the operation.*/
+  dp->CR2 |= I2C_CR2_START;
+}
+
+/**
+ * @brief   Aborts the current transaction.
+ * @details A STOP is sent as an extreme attempt to release the bus.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+void i2c_lld_abort_transaction(I2CDriver *i2cp) {
+  I2C_TypeDef *dp = i2cp->i2c;
+
+  dp->CR1 &= ~(I2C_CR1_TCIE | I2C_CR1_TXIE | I2C_CR1_RXIE);
+#if STM32_I2C_USE_DMA == TRUE
+  i2c_lld_stop_tx_dma(i2cp);
+  i2c_lld_stop_rx_dma(i2cp);
+#endif
+  dp->CR2 |= I2C_CR2_STOP;
+}
+#endif /* I2C_USE_TRANSACTIONS == TRUE */
+
 #endif /* HAL_USE_I2C */
 
 /** @} */
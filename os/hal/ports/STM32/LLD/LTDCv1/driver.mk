@@ -0,0 +1,4 @@
+PLATFORMSRC += $(CHIBIOS)/os/hal/ports/STM32/LLD/LTDCv1/stm32_dma2d.c \
+               $(CHIBIOS)/os/hal/ports/STM32/LLD/LTDCv1/stm32_ltdc.c
+PLATFORMINC += $(CHIBIOS)/os/hal/ports/STM32/LLD/LTDCv1 \
+               $(CHIBIOS)/os/hal/lib/peripherals/displays
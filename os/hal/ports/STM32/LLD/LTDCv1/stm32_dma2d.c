@@ -0,0 +1,294 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    LTDCv1/stm32_dma2d.c
+ * @brief   DMA2D helper driver code.
+ *
+ * @addtogroup STM32_DMA2D
+ * @details DMA2D helper driver. Fills, copies with pixel format conversion
+ *          and alpha blending are executed by the DMA2D engine, operations
+ *          can be started asynchronously with a completion callback or
+ *          executed synchronously, the invoking thread is suspended until
+ *          completion.
+ * @{
+ */
+
+#include "hal.h"
+#include "stm32_dma2d.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Interrupt enable bits.
+ */
+#define DMA2D_CR_IRQ_MASK           (DMA2D_CR_TCIE | DMA2D_CR_TEIE |        \
+                                     DMA2D_CR_CEIE)
+
+/**
+ * @brief   Error flags.
+ */
+#define DMA2D_ISR_ERROR_MASK        (DMA2D_ISR_TEIF | DMA2D_ISR_CEIF)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Pixel sizes in bits indexed by color mode.
+ */
+static const uint8_t dma2d_bits[11] = {32, 24, 16, 16, 16, 8, 8, 16, 4, 8, 4};
+
+/**
+ * @brief   Driver state.
+ */
+static struct {
+  /**
+   * @brief   Completion callback of the current operation.
+   */
+  stm32_dma2dcb_t           func;
+  /**
+   * @brief   Callback parameter.
+   */
+  void                      *param;
+  /**
+   * @brief   Thread waiting for a synchronous operation.
+   */
+  thread_reference_t        thread;
+  /**
+   * @brief   Synchronous operations mutex.
+   */
+  mutex_t                   mutex;
+} dma2d;
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Converts an ARGB8888 color in the output format.
+ *
+ * @param[in] color     the ARGB8888 color
+ * @param[in] fmt       the output color mode
+ * @return              The OCOLR register value.
+ *
+ * @notapi
+ */
+static uint32_t dma2d_color(uint32_t color, uint32_t fmt) {
+  uint32_t a = (color >> 24U) & 0xFFU;
+  uint32_t r = (color >> 16U) & 0xFFU;
+  uint32_t g = (color >> 8U) & 0xFFU;
+  uint32_t b = color & 0xFFU;
+
+  switch (fmt) {
+  case 1U:
+    return color & 0x00FFFFFFU;
+  case 2U:
+    return ((r >> 3U) << 11U) | ((g >> 2U) << 5U) | (b >> 3U);
+  case 3U:
+    return ((a >> 7U) << 15U) | ((r >> 3U) << 10U) |
+           ((g >> 3U) << 5U) | (b >> 3U);
+  case 4U:
+    return ((a >> 4U) << 12U) | ((r >> 4U) << 8U) |
+           ((g >> 4U) << 4U) | (b >> 4U);
+  default:
+    return color;
+  }
+}
+
+/**
+ * @brief   Size of the memory spanned by an area.
+ *
+ * @param[in] width     width of the area in pixels
+ * @param[in] height    height of the area in lines
+ * @param[in] offset    pixels between lines
+ * @param[in] fmt       color mode
+ * @return              The spanned size in bytes.
+ *
+ * @notapi
+ */
+static size_t dma2d_span(uint32_t width, uint32_t height,
+                         uint32_t offset, uint32_t fmt) {
+  uint32_t pixels;
+
+  pixels = ((height - 1U) * (width + offset)) + width;
+
+  return (size_t)(((pixels * (uint32_t)dma2d_bits[fmt]) + 7U) / 8U);
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   DMA2D interrupt handler.
+ *
+ * @isr
+ */
+OSAL_IRQ_HANDLER(STM32_DMA2D_HANDLER) {
+  uint32_t isr;
+
+  OSAL_IRQ_PROLOGUE();
+
+  isr = DMA2D->ISR;
+  DMA2D->IFCR = isr;
+  DMA2D->CR &= ~DMA2D_CR_IRQ_MASK;
+
+  if (dma2d.func != NULL) {
+    dma2d.func(dma2d.param, isr);
+  }
+
+  osalSysLockFromISR();
+  osalThreadResumeI(&dma2d.thread,
+                    (isr & DMA2D_ISR_ERROR_MASK) != 0U ? MSG_RESET : MSG_OK);
+  osalSysUnlockFromISR();
+
+  OSAL_IRQ_EPILOGUE();
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Enables the DMA2D.
+ *
+ * @init
+ */
+void dma2dStart(void) {
+
+  osalMutexObjectInit(&dma2d.mutex);
+  dma2d.thread = NULL;
+
+  rccEnableDMA2D(true);
+  rccResetDMA2D();
+  nvicEnableVector(STM32_DMA2D_NUMBER, STM32_DMA2D_IRQ_PRIORITY);
+}
+
+/**
+ * @brief   Disables the DMA2D.
+ * @pre     There must be no operations in progress.
+ *
+ * @api
+ */
+void dma2dStop(void) {
+
+  osalDbgAssert((DMA2D->CR & DMA2D_CR_START) == 0U, "busy");
+
+  nvicDisableVector(STM32_DMA2D_NUMBER);
+  rccDisableDMA2D();
+}
+
+/**
+ * @brief   Starts a DMA2D operation.
+ * @note    The data cache is not handled by this function, the source
+ *          areas must be cleaned and the output area must be flushed
+ *          before starting the operation.
+ * @pre     There must be no operations in progress.
+ *
+ * @param[in] op        pointer to the operation descriptor
+ * @param[in] func      completion callback or @p NULL
+ * @param[in] param     callback parameter
+ *
+ * @iclass
+ */
+void dma2dStartOperationI(const stm32_dma2d_op_t *op,
+                          stm32_dma2dcb_t func, void *param) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((op != NULL) && (op->width > 0U) && (op->height > 0U));
+  osalDbgAssert((DMA2D->CR & DMA2D_CR_START) == 0U, "busy");
+
+  dma2d.func  = func;
+  dma2d.param = param;
+
+  DMA2D->NLR    = ((uint32_t)op->width << DMA2D_NLR_PL_Pos) |
+                  (uint32_t)op->height;
+  DMA2D->OMAR   = (uint32_t)op->out;
+  DMA2D->OOR    = op->outoffset;
+  DMA2D->OPFCCR = op->outfmt;
+  if (op->mode == STM32_DMA2D_MODE_R2M) {
+    DMA2D->OCOLR = dma2d_color(op->color, op->outfmt);
+  }
+  else {
+    DMA2D->FGMAR   = (uint32_t)op->fg.buffer;
+    DMA2D->FGOR    = op->fg.offset;
+    DMA2D->FGPFCCR = op->fg.pfccr;
+    if (op->mode == STM32_DMA2D_MODE_M2M_BLEND) {
+      DMA2D->BGMAR   = (uint32_t)op->bg.buffer;
+      DMA2D->BGOR    = op->bg.offset;
+      DMA2D->BGPFCCR = op->bg.pfccr;
+    }
+  }
+  DMA2D->CR = op->mode | DMA2D_CR_IRQ_MASK | DMA2D_CR_START;
+}
+
+/**
+ * @brief   Executes a DMA2D operation.
+ * @details The invoking thread is suspended until completion, the data
+ *          cache is handled for all the involved areas. Concurrent
+ *          invocations are serialized.
+ *
+ * @param[in] op        pointer to the operation descriptor
+ * @return              The operation status.
+ * @retval MSG_OK       if the operation succeeded.
+ * @retval MSG_RESET    if a transfer or configuration error occurred.
+ *
+ * @api
+ */
+msg_t dma2dExecuteOperation(const stm32_dma2d_op_t *op) {
+  size_t outsize;
+  msg_t msg;
+
+  osalDbgCheck(op != NULL);
+
+  osalMutexLock(&dma2d.mutex);
+
+  /* Source areas are written back to memory, the output area is also
+     invalidated so that no dirty lines are evicted over the result.*/
+  if (op->mode != STM32_DMA2D_MODE_R2M) {
+    uint32_t cm = (op->fg.pfccr & DMA2D_FGPFCCR_CM_Msk) >> DMA2D_FGPFCCR_CM_Pos;
+
+    cacheBufferClean(op->fg.buffer,
+                     dma2d_span(op->width, op->height, op->fg.offset, cm));
+    if (op->mode == STM32_DMA2D_MODE_M2M_BLEND) {
+      cm = (op->bg.pfccr & DMA2D_BGPFCCR_CM_Msk) >> DMA2D_BGPFCCR_CM_Pos;
+      cacheBufferClean(op->bg.buffer,
+                       dma2d_span(op->width, op->height, op->bg.offset, cm));
+    }
+  }
+  outsize = dma2d_span(op->width, op->height, op->outoffset, op->outfmt);
+  cacheBufferFlush(op->out, outsize);
+
+  osalSysLock();
+  dma2dStartOperationI(op, NULL, NULL);
+  msg = osalThreadSuspendS(&dma2d.thread);
+  osalSysUnlock();
+
+  cacheBufferInvalidate(op->out, outsize);
+
+  osalMutexUnlock(&dma2d.mutex);
+
+  return msg;
+}
+
+/** @} */
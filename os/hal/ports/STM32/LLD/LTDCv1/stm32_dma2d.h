@@ -0,0 +1,199 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    LTDCv1/stm32_dma2d.h
+ * @brief   DMA2D helper driver header.
+ *
+ * @addtogroup STM32_DMA2D
+ * @{
+ */
+
+#ifndef STM32_DMA2D_H
+#define STM32_DMA2D_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Transfer modes
+ * @{
+ */
+#define STM32_DMA2D_MODE_M2M        (0U << DMA2D_CR_MODE_Pos)
+#define STM32_DMA2D_MODE_M2M_PFC    (1U << DMA2D_CR_MODE_Pos)
+#define STM32_DMA2D_MODE_M2M_BLEND  (2U << DMA2D_CR_MODE_Pos)
+#define STM32_DMA2D_MODE_R2M        (3U << DMA2D_CR_MODE_Pos)
+/** @} */
+
+/**
+ * @name    PFCCR register constants
+ * @note    The color mode values are the same of the
+ *          @p DISPLAY_PIXFMT_xxx constants.
+ * @{
+ */
+#define STM32_DMA2D_PFCCR_CM(fmt)   ((fmt) << DMA2D_FGPFCCR_CM_Pos)
+#define STM32_DMA2D_PFCCR_AM_NONE   (0U << DMA2D_FGPFCCR_AM_Pos)
+#define STM32_DMA2D_PFCCR_AM_REPLACE (1U << DMA2D_FGPFCCR_AM_Pos)
+#define STM32_DMA2D_PFCCR_AM_MULTIPLY (2U << DMA2D_FGPFCCR_AM_Pos)
+#define STM32_DMA2D_PFCCR_ALPHA(a)  ((uint32_t)(a) << DMA2D_FGPFCCR_ALPHA_Pos)
+/** @} */
+
+/**
+ * @name    Status flags passed to the callbacks
+ * @{
+ */
+#define STM32_DMA2D_ISR_TEIF        DMA2D_ISR_TEIF
+#define STM32_DMA2D_ISR_TCIF        DMA2D_ISR_TCIF
+#define STM32_DMA2D_ISR_CEIF        DMA2D_ISR_CEIF
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   DMA2D interrupt priority level setting.
+ */
+#if !defined(STM32_DMA2D_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_DMA2D_IRQ_PRIORITY            11
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !defined(STM32_HAS_DMA2D)
+#error "STM32_HAS_DMA2D missing in registry"
+#endif
+
+#if STM32_HAS_DMA2D == FALSE
+#error "DMA2D not present in the selected device"
+#endif
+
+#if !defined(STM32_DMA2D_HANDLER)
+#error "STM32_DMA2D_HANDLER missing in registry"
+#endif
+
+#if !defined(STM32_DMA2D_NUMBER)
+#error "STM32_DMA2D_NUMBER missing in registry"
+#endif
+
+#if !OSAL_IRQ_IS_VALID_PRIORITY(STM32_DMA2D_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to DMA2D"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   DMA2D completion callback type.
+ *
+ * @param[in] p         parameter for the registered function
+ * @param[in] flags     content of the ISR register at completion
+ */
+typedef void (*stm32_dma2dcb_t)(void *p, uint32_t flags);
+
+/**
+ * @brief   Layer of a DMA2D operation.
+ */
+typedef struct {
+  /**
+   * @brief   Address of the first pixel.
+   */
+  const void                *buffer;
+  /**
+   * @brief   Pixels between the end of a line and the start of the next.
+   */
+  uint32_t                  offset;
+  /**
+   * @brief   PFCCR register value.
+   */
+  uint32_t                  pfccr;
+} stm32_dma2d_layer_t;
+
+/**
+ * @brief   Type of a DMA2D operation.
+ */
+typedef struct {
+  /**
+   * @brief   Transfer mode.
+   */
+  uint32_t                  mode;
+  /**
+   * @brief   Width of the area in pixels.
+   */
+  uint16_t                  width;
+  /**
+   * @brief   Height of the area in lines.
+   */
+  uint16_t                  height;
+  /**
+   * @brief   Foreground layer, unused in R2M mode.
+   */
+  stm32_dma2d_layer_t       fg;
+  /**
+   * @brief   Background layer, only used in blending mode.
+   */
+  stm32_dma2d_layer_t       bg;
+  /**
+   * @brief   Output address.
+   */
+  void                      *out;
+  /**
+   * @brief   Pixels between the end of an output line and the start of
+   *          the next.
+   */
+  uint32_t                  outoffset;
+  /**
+   * @brief   Output pixel format.
+   */
+  uint32_t                  outfmt;
+  /**
+   * @brief   Fill color in ARGB8888 format, only used in R2M mode.
+   */
+  uint32_t                  color;
+} stm32_dma2d_op_t;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void dma2dStart(void);
+  void dma2dStop(void);
+  void dma2dStartOperationI(const stm32_dma2d_op_t *op,
+                            stm32_dma2dcb_t func, void *param);
+  msg_t dma2dExecuteOperation(const stm32_dma2d_op_t *op);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_DMA2D_H */
+
+/** @} */
@@ -0,0 +1,406 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    LTDCv1/stm32_ltdc.c
+ * @brief   LTDC display driver code.
+ *
+ * @addtogroup STM32_LTDC
+ * @details LTDC display driver implementing the @p BaseDisplay interface.
+ *          The LTDC layer 1 scans the visible frame buffer while drawing
+ *          happens on the hidden one, buffers are exchanged on the
+ *          vertical blanking so that no tearing is visible. All the drawing
+ *          operations are executed by the DMA2D, the invoking thread is
+ *          suspended meanwhile and the CPU is available to other threads.
+ * @note    The GPIOs and the pixel clock must be configured by the board
+ *          files and the application before starting the driver.
+ * @{
+ */
+
+#include "hal.h"
+#include "stm32_ltdc.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   LTDC display driver identifier.
+ */
+LTDCDisplay LTDCD1;
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+static void ltdc_get_surface(void *ip, display_surface_t *sp);
+static msg_t ltdc_fill(void *ip, const display_rect_t *rp,
+                       display_color_t color);
+static msg_t ltdc_blit(void *ip, uint16_t x, uint16_t y,
+                       const display_surface_t *srcp);
+static msg_t ltdc_blend(void *ip, uint16_t x, uint16_t y,
+                        const display_surface_t *srcp, uint8_t alpha);
+static msg_t ltdc_swap(void *ip);
+
+/**
+ * @brief   Virtual methods table.
+ */
+static const struct BaseDisplayVMT vmt = {
+  ltdc_get_surface, ltdc_fill, ltdc_blit, ltdc_blend, ltdc_swap
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Address of a pixel in the buffer being drawn.
+ *
+ * @param[in] ldp       pointer to the @p LTDCDisplay object
+ * @param[in] x         horizontal position
+ * @param[in] y         vertical position
+ * @return              The pixel address.
+ *
+ * @notapi
+ */
+static uint8_t *ltdc_pixel(LTDCDisplay *ldp, uint16_t x, uint16_t y) {
+  const LTDCConfig *cfg = ldp->config;
+
+  return (uint8_t *)cfg->fb[ldp->back] +
+         ((((size_t)y * (size_t)cfg->width) + (size_t)x) *
+          (size_t)DISPLAY_PIXFMT_SIZE(cfg->format));
+}
+
+static void ltdc_get_surface(void *ip, display_surface_t *sp) {
+  LTDCDisplay *ldp = (LTDCDisplay *)ip;
+
+  osalDbgCheck(sp != NULL);
+  osalDbgAssert(ldp->state == LTDC_READY, "not ready");
+
+  sp->buffer = ldp->config->fb[ldp->back];
+  sp->format = ldp->config->format;
+  sp->width  = ldp->config->width;
+  sp->height = ldp->config->height;
+  sp->stride = ldp->config->width;
+}
+
+static msg_t ltdc_fill(void *ip, const display_rect_t *rp,
+                       display_color_t color) {
+  LTDCDisplay *ldp = (LTDCDisplay *)ip;
+  stm32_dma2d_op_t op;
+
+  osalDbgCheck((rp != NULL) &&
+               ((rp->x + rp->width) <= ldp->config->width) &&
+               ((rp->y + rp->height) <= ldp->config->height));
+  osalDbgAssert(ldp->state == LTDC_READY, "not ready");
+
+  if ((rp->width == 0U) || (rp->height == 0U)) {
+    return MSG_OK;
+  }
+
+  op.mode      = STM32_DMA2D_MODE_R2M;
+  op.width     = rp->width;
+  op.height    = rp->height;
+  op.out       = ltdc_pixel(ldp, rp->x, rp->y);
+  op.outoffset = (uint32_t)ldp->config->width - (uint32_t)rp->width;
+  op.outfmt    = ldp->config->format;
+  op.color     = color;
+
+  return dma2dExecuteOperation(&op);
+}
+
+static msg_t ltdc_blit(void *ip, uint16_t x, uint16_t y,
+                       const display_surface_t *srcp) {
+  LTDCDisplay *ldp = (LTDCDisplay *)ip;
+  stm32_dma2d_op_t op;
+
+  osalDbgCheck((srcp != NULL) && (srcp->stride >= srcp->width) &&
+               ((x + srcp->width) <= ldp->config->width) &&
+               ((y + srcp->height) <= ldp->config->height));
+  osalDbgAssert(ldp->state == LTDC_READY, "not ready");
+
+  if ((srcp->width == 0U) || (srcp->height == 0U)) {
+    return MSG_OK;
+  }
+
+  /* The pixel format converter is only used when required.*/
+  op.mode      = srcp->format == ldp->config->format ?
+                 STM32_DMA2D_MODE_M2M : STM32_DMA2D_MODE_M2M_PFC;
+  op.width     = srcp->width;
+  op.height    = srcp->height;
+  op.fg.buffer = srcp->buffer;
+  op.fg.offset = (uint32_t)srcp->stride - (uint32_t)srcp->width;
+  op.fg.pfccr  = STM32_DMA2D_PFCCR_CM(srcp->format);
+  op.out       = ltdc_pixel(ldp, x, y);
+  op.outoffset = (uint32_t)ldp->config->width - (uint32_t)srcp->width;
+  op.outfmt    = ldp->config->format;
+
+  return dma2dExecuteOperation(&op);
+}
+
+static msg_t ltdc_blend(void *ip, uint16_t x, uint16_t y,
+                        const display_surface_t *srcp, uint8_t alpha) {
+  LTDCDisplay *ldp = (LTDCDisplay *)ip;
+  stm32_dma2d_op_t op;
+
+  osalDbgCheck((srcp != NULL) && (srcp->stride >= srcp->width) &&
+               ((x + srcp->width) <= ldp->config->width) &&
+               ((y + srcp->height) <= ldp->config->height));
+  osalDbgAssert(ldp->state == LTDC_READY, "not ready");
+
+  if ((srcp->width == 0U) || (srcp->height == 0U)) {
+    return MSG_OK;
+  }
+
+  /* The surface content is the background layer and also the output.*/
+  op.mode      = STM32_DMA2D_MODE_M2M_BLEND;
+  op.width     = srcp->width;
+  op.height    = srcp->height;
+  op.fg.buffer = srcp->buffer;
+  op.fg.offset = (uint32_t)srcp->stride - (uint32_t)srcp->width;
+  op.fg.pfccr  = STM32_DMA2D_PFCCR_CM(srcp->format) |
+                 STM32_DMA2D_PFCCR_AM_MULTIPLY |
+                 STM32_DMA2D_PFCCR_ALPHA(alpha);
+  op.out       = ltdc_pixel(ldp, x, y);
+  op.outoffset = (uint32_t)ldp->config->width - (uint32_t)srcp->width;
+  op.outfmt    = ldp->config->format;
+  op.bg.buffer = op.out;
+  op.bg.offset = op.outoffset;
+  op.bg.pfccr  = STM32_DMA2D_PFCCR_CM(ldp->config->format);
+
+  return dma2dExecuteOperation(&op);
+}
+
+static msg_t ltdc_swap(void *ip) {
+
+  return ltdcSwap((LTDCDisplay *)ip);
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   LTDC event interrupt handler.
+ *
+ * @isr
+ */
+OSAL_IRQ_HANDLER(STM32_LTDC_EV_HANDLER) {
+  LTDCDisplay *ldp = &LTDCD1;
+
+  OSAL_IRQ_PROLOGUE();
+
+  if ((LTDC->ISR & LTDC_ISR_RRIF) != 0U) {
+    LTDC->ICR  = LTDC_ICR_CRRIF;
+    LTDC->IER &= ~LTDC_IER_RRIE;
+
+    /* The previously visible buffer is now hidden.*/
+    if (ldp->config->fb[1] != NULL) {
+      ldp->back ^= 1U;
+    }
+    ldp->state = LTDC_READY;
+
+    if (ldp->config->swap_cb != NULL) {
+      ldp->config->swap_cb(ldp);
+    }
+
+    osalSysLockFromISR();
+    osalThreadResumeI(&ldp->thread, MSG_OK);
+    osalSysUnlockFromISR();
+  }
+
+  OSAL_IRQ_EPILOGUE();
+}
+
+/**
+ * @brief   LTDC error interrupt handler.
+ *
+ * @isr
+ */
+OSAL_IRQ_HANDLER(STM32_LTDC_ER_HANDLER) {
+  LTDCDisplay *ldp = &LTDCD1;
+
+  OSAL_IRQ_PROLOGUE();
+
+  LTDC->ICR = LTDC_ICR_CFUIF | LTDC_ICR_CTERRIF;
+
+  if (ldp->config->error_cb != NULL) {
+    ldp->config->error_cb(ldp);
+  }
+
+  OSAL_IRQ_EPILOGUE();
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an LTDC display object.
+ *
+ * @param[out] ldp      pointer to the @p LTDCDisplay object
+ *
+ * @init
+ */
+void ltdcObjectInit(LTDCDisplay *ldp) {
+
+  ldp->vmt_basedisplay = &vmt;
+  ldp->state           = LTDC_STOP;
+  ldp->config          = NULL;
+  ldp->back            = 0U;
+  ldp->thread          = NULL;
+}
+
+/**
+ * @brief   Configures and activates the LTDC display.
+ * @details The first buffer is made visible, drawing happens on the
+ *          second one if present.
+ *
+ * @param[in] ldp       pointer to the @p LTDCDisplay object
+ * @param[in] config    pointer to the @p LTDCConfig object
+ *
+ * @api
+ */
+void ltdcStart(LTDCDisplay *ldp, const LTDCConfig *config) {
+  uint32_t hbp, vbp, hact, vact, pitch;
+
+  osalDbgCheck((ldp == &LTDCD1) && (config != NULL) &&
+               (config->fb[0] != NULL) && (config->width > 0U) &&
+               (config->height > 0U) && (config->hsync > 0U) &&
+               (config->vsync > 0U) &&
+               (config->format <= DISPLAY_PIXFMT_ARGB4444));
+  osalDbgAssert(ldp->state == LTDC_STOP, "invalid state");
+
+  ldp->config = config;
+  ldp->back   = config->fb[1] != NULL ? 1U : 0U;
+
+  rccEnableLTDC(true);
+  rccResetLTDC();
+
+  /* Accumulated timings, all the register fields are minus one.*/
+  hbp  = (uint32_t)config->hsync + (uint32_t)config->hbp;
+  vbp  = (uint32_t)config->vsync + (uint32_t)config->vbp;
+  hact = hbp + (uint32_t)config->width;
+  vact = vbp + (uint32_t)config->height;
+  LTDC->SSCR = (((uint32_t)config->hsync - 1U) << 16U) |
+               ((uint32_t)config->vsync - 1U);
+  LTDC->BPCR = ((hbp - 1U) << 16U) | (vbp - 1U);
+  LTDC->AWCR = ((hact - 1U) << 16U) | (vact - 1U);
+  LTDC->TWCR = ((hact + (uint32_t)config->hfp - 1U) << 16U) |
+               (vact + (uint32_t)config->vfp - 1U);
+  LTDC->GCR  = config->polarity;
+  LTDC->BCCR = config->background & 0x00FFFFFFU;
+
+  /* Layer 1 covering the whole active area.*/
+  pitch = (uint32_t)config->width * DISPLAY_PIXFMT_SIZE(config->format);
+  LTDC_Layer1->WHPCR  = ((hact - 1U) << 16U) | hbp;
+  LTDC_Layer1->WVPCR  = ((vact - 1U) << 16U) | vbp;
+  LTDC_Layer1->PFCR   = config->format;
+  LTDC_Layer1->CACR   = 255U;
+  LTDC_Layer1->DCCR   = 0U;
+  LTDC_Layer1->BFCR   = (4U << 8U) | 5U;
+  LTDC_Layer1->CFBAR  = (uint32_t)config->fb[0];
+  LTDC_Layer1->CFBLR  = (pitch << 16U) | (pitch + 3U);
+  LTDC_Layer1->CFBLNR = (uint32_t)config->height;
+  LTDC_Layer1->CR     = LTDC_LxCR_LEN;
+  LTDC->SRCR = LTDC_SRCR_IMR;
+
+  LTDC->IER = LTDC_IER_FUIE | LTDC_IER_TERRIE;
+  nvicEnableVector(STM32_LTDC_EV_NUMBER, STM32_LTDC_IRQ_PRIORITY);
+  nvicEnableVector(STM32_LTDC_ER_NUMBER, STM32_LTDC_IRQ_PRIORITY);
+  LTDC->GCR |= LTDC_GCR_LTDCEN;
+
+  dma2dStart();
+
+  ldp->state = LTDC_READY;
+}
+
+/**
+ * @brief   Deactivates the LTDC display.
+ *
+ * @param[in] ldp       pointer to the @p LTDCDisplay object
+ *
+ * @api
+ */
+void ltdcStop(LTDCDisplay *ldp) {
+
+  osalDbgCheck(ldp == &LTDCD1);
+  osalDbgAssert(ldp->state == LTDC_READY, "invalid state");
+
+  dma2dStop();
+
+  LTDC->IER = 0U;
+  LTDC->GCR &= ~LTDC_GCR_LTDCEN;
+  nvicDisableVector(STM32_LTDC_EV_NUMBER);
+  nvicDisableVector(STM32_LTDC_ER_NUMBER);
+  rccDisableLTDC();
+
+  ldp->config = NULL;
+  ldp->state  = LTDC_STOP;
+}
+
+/**
+ * @brief   Requests a buffers exchange.
+ * @details The drawn buffer becomes visible on the next vertical blanking,
+ *          the @p swap_cb callback is invoked meanwhile. With a single
+ *          buffer the function just synchronizes with the vertical
+ *          blanking.
+ * @note    Drawing must not be resumed until the exchange took effect.
+ *
+ * @param[in] ldp       pointer to the @p LTDCDisplay object
+ *
+ * @iclass
+ */
+void ltdcSwapI(LTDCDisplay *ldp) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck(ldp == &LTDCD1);
+  osalDbgAssert(ldp->state == LTDC_READY, "invalid state");
+
+  ldp->state = LTDC_SWAPPING;
+  LTDC_Layer1->CFBAR = (uint32_t)ldp->config->fb[ldp->back];
+  LTDC->ICR   = LTDC_ICR_CRRIF;
+  LTDC->IER  |= LTDC_IER_RRIE;
+  LTDC->SRCR  = LTDC_SRCR_VBR;
+}
+
+/**
+ * @brief   Exchanges the buffers.
+ * @details The drawn buffer becomes visible on the next vertical blanking,
+ *          the function returns when the exchange took effect.
+ *
+ * @param[in] ldp       pointer to the @p LTDCDisplay object
+ * @return              The operation status.
+ * @retval MSG_OK       if the buffers have been exchanged.
+ *
+ * @api
+ */
+msg_t ltdcSwap(LTDCDisplay *ldp) {
+  msg_t msg;
+
+  osalSysLock();
+  ltdcSwapI(ldp);
+  msg = osalThreadSuspendS(&ldp->thread);
+  osalSysUnlock();
+
+  return msg;
+}
+
+/** @} */
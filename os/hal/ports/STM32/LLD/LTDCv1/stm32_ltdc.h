@@ -0,0 +1,233 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    LTDCv1/stm32_ltdc.h
+ * @brief   LTDC display driver header.
+ *
+ * @addtogroup STM32_LTDC
+ * @{
+ */
+
+#ifndef STM32_LTDC_H
+#define STM32_LTDC_H
+
+#include "hal_displays.h"
+#include "stm32_dma2d.h"
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Signals polarity
+ * @{
+ */
+#define STM32_LTDC_HSYNC_ACTIVE_HIGH        LTDC_GCR_HSPOL
+#define STM32_LTDC_VSYNC_ACTIVE_HIGH        LTDC_GCR_VSPOL
+#define STM32_LTDC_DE_ACTIVE_HIGH           LTDC_GCR_DEPOL
+#define STM32_LTDC_PCLK_INVERTED            LTDC_GCR_PCPOL
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   LTDC interrupt priority level setting.
+ */
+#if !defined(STM32_LTDC_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_LTDC_IRQ_PRIORITY             11
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !defined(STM32_HAS_LTDC)
+#error "STM32_HAS_LTDC missing in registry"
+#endif
+
+#if STM32_HAS_LTDC == FALSE
+#error "LTDC not present in the selected device"
+#endif
+
+#if !defined(STM32_LTDC_EV_HANDLER) || !defined(STM32_LTDC_ER_HANDLER)
+#error "STM32_LTDC_EV_HANDLER or STM32_LTDC_ER_HANDLER missing in registry"
+#endif
+
+#if !defined(STM32_LTDC_EV_NUMBER) || !defined(STM32_LTDC_ER_NUMBER)
+#error "STM32_LTDC_EV_NUMBER or STM32_LTDC_ER_NUMBER missing in registry"
+#endif
+
+#if !OSAL_IRQ_IS_VALID_PRIORITY(STM32_LTDC_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to LTDC"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  LTDC_UNINIT = 0,                  /**< Not initialized.                   */
+  LTDC_STOP = 1,                    /**< Stopped.                           */
+  LTDC_READY = 2,                   /**< Ready.                             */
+  LTDC_SWAPPING = 3                 /**< Buffers exchange pending.          */
+} ltdcstate_t;
+
+/**
+ * @brief   Type of a structure representing an LTDC display.
+ */
+typedef struct LTDCDisplay LTDCDisplay;
+
+/**
+ * @brief   LTDC notification callback type.
+ *
+ * @param[in] ldp       pointer to the @p LTDCDisplay object
+ */
+typedef void (*ltdccallback_t)(LTDCDisplay *ldp);
+
+/**
+ * @brief   LTDC display configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Active width in pixels.
+   */
+  uint16_t                  width;
+  /**
+   * @brief   Active height in lines.
+   */
+  uint16_t                  height;
+  /**
+   * @brief   Horizontal sync width in pixel clocks.
+   */
+  uint16_t                  hsync;
+  /**
+   * @brief   Horizontal back porch in pixel clocks.
+   */
+  uint16_t                  hbp;
+  /**
+   * @brief   Horizontal front porch in pixel clocks.
+   */
+  uint16_t                  hfp;
+  /**
+   * @brief   Vertical sync width in lines.
+   */
+  uint16_t                  vsync;
+  /**
+   * @brief   Vertical back porch in lines.
+   */
+  uint16_t                  vbp;
+  /**
+   * @brief   Vertical front porch in lines.
+   */
+  uint16_t                  vfp;
+  /**
+   * @brief   Signals polarity, see @p STM32_LTDC_xxx constants.
+   */
+  uint32_t                  polarity;
+  /**
+   * @brief   Frame buffers pixel format.
+   * @note    Only the formats supported as DMA2D output are allowed,
+   *          from @p DISPLAY_PIXFMT_ARGB8888 to @p DISPLAY_PIXFMT_ARGB4444.
+   */
+  display_pixfmt_t          format;
+  /**
+   * @brief   Frame buffers.
+   * @details If the second buffer is @p NULL then drawing happens on the
+   *          visible buffer.
+   * @note    Buffers should be aligned to the cache line size.
+   */
+  void                      *fb[2];
+  /**
+   * @brief   Background color in ARGB8888 format, alpha is ignored.
+   */
+  display_color_t           background;
+  /**
+   * @brief   Buffers exchange callback or @p NULL.
+   * @details Invoked from ISR context on the vertical blanking where a
+   *          requested exchange took effect.
+   */
+  ltdccallback_t            swap_cb;
+  /**
+   * @brief   Error callback or @p NULL.
+   * @details Invoked from ISR context on FIFO underruns and transfer
+   *          errors.
+   */
+  ltdccallback_t            error_cb;
+} LTDCConfig;
+
+/**
+ * @brief   Structure representing an LTDC display.
+ */
+struct LTDCDisplay {
+  /** @brief Virtual Methods Table.*/
+  const struct BaseDisplayVMT *vmt_basedisplay;
+  _base_display_data
+  /**
+   * @brief   Driver state.
+   */
+  ltdcstate_t               state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const LTDCConfig          *config;
+  /**
+   * @brief   Index of the buffer being drawn.
+   */
+  unsigned                  back;
+  /**
+   * @brief   Thread waiting for a buffers exchange.
+   */
+  thread_reference_t        thread;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if !defined(__DOXYGEN__)
+extern LTDCDisplay LTDCD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void ltdcObjectInit(LTDCDisplay *ldp);
+  void ltdcStart(LTDCDisplay *ldp, const LTDCConfig *config);
+  void ltdcStop(LTDCDisplay *ldp);
+  void ltdcSwapI(LTDCDisplay *ldp);
+  msg_t ltdcSwap(LTDCDisplay *ldp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_LTDC_H */
+
+/** @} */
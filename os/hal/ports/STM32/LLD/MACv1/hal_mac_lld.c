@@ -36,6 +36,11 @@
 
 #define BUFFER_SIZE ((((STM32_MAC_BUFFERS_SIZE - 1) | 3) + 1) / 4)
 
+#if MAC_USE_ZERO_COPY
+/* Marker of the transmit descriptors of a lent frame except the last one.*/
+#define TX_FRAME_CONTINUES ((void *)__eth_tf)
+#endif
+
 /* Fixing inconsistencies in ST headers.*/
 #if !defined(ETH_MACMIIAR_CR_Div102) && defined(ETH_MACMIIAR_CR_DIV102)
 #define ETH_MACMIIAR_CR_Div102 ETH_MACMIIAR_CR_DIV102
@@ -90,6 +95,23 @@ static stm32_eth_tx_descriptor_t __eth_td[STM32_MAC_TRANSMIT_BUFFERS];
 static uint32_t __eth_rb[STM32_MAC_RECEIVE_BUFFERS][BUFFER_SIZE];
 static uint32_t __eth_tb[STM32_MAC_TRANSMIT_BUFFERS][BUFFER_SIZE];
 
+#if MAC_USE_ZERO_COPY
+/* Spare receive buffers and list of the free ones, the link to the next
+   free buffer is stored in the first word of each buffer.*/
+static uint32_t __eth_sb[STM32_MAC_RECEIVE_SPARE_BUFFERS][BUFFER_SIZE];
+static uint32_t *__eth_spare;
+
+/* Frames lent for transmission, one entry for each transmit descriptor.*/
+static void *__eth_tf[STM32_MAC_TRANSMIT_BUFFERS];
+#endif
+
+#if STM32_MAC_ETH1_USE_IRQ_THREAD
+/* IRQ thread and DMA events waiting to be served by it.*/
+static osal_irq_thread_t eth_irq_thread;
+static OSAL_IRQ_THREAD_WORKING_AREA(eth_irq_wa);
+static uint32_t eth_irq_status;
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -168,8 +190,8 @@ static void mii_find_phy(MACDriver *macp) {
  */
 static void mac_lld_set_address(const uint8_t *p) {
 
-  /* MAC address configuration, only a single address comparator is used,
-     hash table not used.*/
+  /* MAC address configuration, the additional address comparators and
+     the hash table are cleared.*/
   ETH->MACA0HR   = ((uint32_t)p[5] << 8) |
                    ((uint32_t)p[4] << 0);
   ETH->MACA0LR   = ((uint32_t)p[3] << 24) |
@@ -186,17 +208,119 @@ static void mac_lld_set_address(const uint8_t *p) {
   ETH->MACHTLR   = 0;
 }
 
-/*===========================================================================*/
-/* Driver interrupt handlers.                                                */
-/*===========================================================================*/
+/**
+ * @brief   Returns the high register of an exact match filter.
+ * @note    The low register follows the high register.
+ *
+ * @param[in] i         filter index
+ * @return              Pointer to the filter high register.
+ *
+ * @notapi
+ */
+static volatile uint32_t *mac_lld_perfect_filter(unsigned i) {
 
-OSAL_IRQ_HANDLER(STM32_ETH_HANDLER) {
-  uint32_t dmasr;
+  return &ETH->MACA1HR + (i * 2U);
+}
 
-  OSAL_IRQ_PROLOGUE();
+/**
+ * @brief   Hash filter bin of an address.
+ * @details The bin is the bit-reversed upper six bits of the complemented
+ *          Ethernet CRC of the address.
+ *
+ * @param[in] addr      pointer to a six bytes buffer containing the MAC
+ *                      address
+ * @return              The hash bin, from 0 to 63.
+ *
+ * @notapi
+ */
+static unsigned mac_lld_hash(const uint8_t *addr) {
+  uint32_t crc = 0xFFFFFFFFU;
+  unsigned i, j, hash;
+
+  for (i = 0U; i < 6U; i++) {
+    crc ^= (uint32_t)addr[i];
+    for (j = 0U; j < 8U; j++) {
+      crc = (crc >> 1) ^ (((crc & 1U) != 0U) ? 0xEDB88320U : 0U);
+    }
+  }
 
-  dmasr = ETH->DMASR;
-  ETH->DMASR = dmasr; /* Clear status bits.*/
+  crc  = ~crc;
+  hash = 0U;
+  for (i = 0U; i < 6U; i++) {
+    hash |= ((crc >> i) & 1U) << (5U - i);
+  }
+  return hash;
+}
+
+/**
+ * @brief   Sets or clears a hash filter bin.
+ *
+ * @param[in] hash      the hash bin
+ * @param[in] set       @p true if the bin must be set
+ *
+ * @notapi
+ */
+static void mac_lld_set_hash(unsigned hash, bool set) {
+  volatile uint32_t *htp = (hash >= 32U) ? &ETH->MACHTHR : &ETH->MACHTLR;
+  uint32_t mask = 1U << (hash & 31U);
+
+  if (set) {
+    *htp |= mask;
+  }
+  else {
+    *htp &= ~mask;
+  }
+}
+
+#if STM32_MAC_USE_PTP || defined(__DOXYGEN__)
+/**
+ * @brief   Latches the pending transmit time stamp.
+ * @details The time stamp is copied from the descriptor once the DMA has
+ *          returned it, before the descriptor can be reused.
+ * @note    Must be invoked from within a critical zone.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @notapi
+ */
+static void mac_lld_latch_timestamp(MACDriver *macp) {
+  stm32_eth_tx_descriptor_t *tdes = macp->tsptr;
+
+  if ((tdes != NULL) && !(tdes->tdes0 & STM32_TDES0_OWN)) {
+    if (tdes->tdes0 & STM32_TDES0_TTSS) {
+      macp->txts.nsec = tdes->tdes6;
+      macp->txts.sec  = tdes->tdes7;
+      macp->txtsmsg   = MSG_OK;
+    }
+    else {
+      macp->txtsmsg   = MSG_RESET;
+    }
+    macp->tsptr = NULL;
+  }
+}
+
+/**
+ * @brief   Waits for a PTP command bit to be cleared by the hardware.
+ *
+ * @param[in] mask      command bits mask
+ *
+ * @notapi
+ */
+static void mac_lld_ptp_wait(uint32_t mask) {
+
+  while ((ETH->PTPTSCR & mask) != 0U)
+    ;
+}
+#endif
+
+/**
+ * @brief   Serves the DMA events.
+ *
+ * @param[in] dmasr     DMA status bits to be served
+ *
+ * @notapi
+ */
+static void mac_lld_serve_events(uint32_t dmasr) {
 
   if (dmasr & ETH_DMASR_RS) {
     /* Data Received.*/
@@ -211,9 +335,62 @@ OSAL_IRQ_HANDLER(STM32_ETH_HANDLER) {
   if (dmasr & ETH_DMASR_TS) {
     /* Data Transmitted.*/
     osalSysLockFromISR();
+#if STM32_MAC_USE_PTP
+    mac_lld_latch_timestamp(&ETHD1);
+#endif
     osalThreadDequeueAllI(&ETHD1.tdqueue, MSG_RESET);
     osalSysUnlockFromISR();
   }
+}
+
+#if STM32_MAC_ETH1_USE_IRQ_THREAD || defined(__DOXYGEN__)
+/**
+ * @brief   DMA events bottom-half.
+ *
+ * @param[in] p         not used
+ *
+ * @notapi
+ */
+static void mac_lld_serve_bh(void *p) {
+  uint32_t dmasr;
+
+  (void)p;
+
+  osalSysLock();
+  dmasr = eth_irq_status;
+  eth_irq_status = 0U;
+  osalSysUnlock();
+
+  mac_lld_serve_events(dmasr);
+}
+#endif
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+OSAL_IRQ_HANDLER(STM32_ETH_HANDLER) {
+  uint32_t dmasr;
+
+  OSAL_IRQ_PROLOGUE();
+
+  dmasr = ETH->DMASR;
+
+  /* A reception is left pending while its interrupt is disabled, it is
+     served when the interrupt is enabled again.*/
+  if ((ETH->DMAIER & ETH_DMAIER_RIE) == 0U)
+    dmasr &= ~ETH_DMASR_RS;
+  ETH->DMASR = dmasr; /* Clear status bits.*/
+
+#if STM32_MAC_ETH1_USE_IRQ_THREAD
+  /* The events are accumulated and served by the IRQ thread.*/
+  osalSysLockFromISR();
+  eth_irq_status |= dmasr;
+  osalIrqThreadSignalI(&eth_irq_thread);
+  osalSysUnlockFromISR();
+#else
+  mac_lld_serve_events(dmasr);
+#endif
 
   OSAL_IRQ_EPILOGUE();
 }
@@ -232,6 +409,10 @@ void mac_lld_init(void) {
 
   macObjectInit(&ETHD1);
   ETHD1.link_up = false;
+#if STM32_MAC_ETH1_USE_IRQ_THREAD
+  osalIrqThreadObjectInit(&eth_irq_thread);
+  eth_irq_status = 0U;
+#endif
 
   /* Descriptor tables are initialized in chained mode, note that the first
      word is not initialized here but in mac_lld_start().*/
@@ -245,6 +426,13 @@ void mac_lld_init(void) {
     __eth_td[i].tdes2 = (uint32_t)__eth_tb[i];
     __eth_td[i].tdes3 = (uint32_t)&__eth_td[(i + 1) % STM32_MAC_TRANSMIT_BUFFERS];
   }
+#if MAC_USE_ZERO_COPY
+  __eth_spare = NULL;
+  for (i = 0; i < STM32_MAC_RECEIVE_SPARE_BUFFERS; i++) {
+    __eth_sb[i][0] = (uint32_t)__eth_spare;
+    __eth_spare = __eth_sb[i];
+  }
+#endif
 
   /* Selection of the RMII or MII mode based on info exported by board.h.*/
 #if defined(STM32F10X_CL)
@@ -315,6 +503,10 @@ void mac_lld_start(MACDriver *macp) {
   for (i = 0; i < STM32_MAC_TRANSMIT_BUFFERS; i++)
     __eth_td[i].tdes0 = STM32_TDES0_TCH;
   macp->txptr = (stm32_eth_tx_descriptor_t *)__eth_td;
+#if STM32_MAC_USE_PTP
+  macp->tsptr   = NULL;
+  macp->txtsmsg = MSG_RESET;
+#endif
 
   /* MAC clocks activation and commanded reset procedure.*/
   rccEnableETH(true);
@@ -324,6 +516,33 @@ void mac_lld_start(MACDriver *macp) {
     ;
 #endif
 
+#if STM32_MAC_USE_PTP
+  /* PTP clock activation and time stamp unit initialization, the time
+     stamp trigger interrupt is not used. The digital rollover mode is
+     used so the sub-seconds are nanoseconds, the fine correction method
+     is used so the clock frequency can be disciplined.*/
+  rccEnableAHB1(RCC_AHB1ENR_ETHMACPTPEN, true);
+  ETH->MACIMR  |= ETH_MACIMR_TSTIM;
+  ETH->PTPTSCR  = ETH_PTPTSSR_TSSARFE | ETH_PTPTSSR_TSSSR | ETH_PTPTSCR_TSE;
+  ETH->PTPSSIR  = STM32_MAC_PTP_INCREMENT;
+  ETH->PTPTSAR  = STM32_MAC_PTP_ADDEND;
+  ETH->PTPTSCR |= ETH_PTPTSCR_TSARU;
+  mac_lld_ptp_wait(ETH_PTPTSCR_TSARU);
+  ETH->PTPTSCR |= ETH_PTPTSCR_TSFCU;
+  ETH->PTPTSHUR = 0U;
+  ETH->PTPTSLUR = 0U;
+  ETH->PTPTSCR |= ETH_PTPTSCR_TSSTI;
+  mac_lld_ptp_wait(ETH_PTPTSCR_TSSTI);
+#endif
+
+#if STM32_MAC_ETH1_USE_IRQ_THREAD
+  /* IRQ thread started before the ISR vector.*/
+  eth_irq_status = 0U;
+  osalIrqThreadStartS(&eth_irq_thread, eth_irq_wa, sizeof eth_irq_wa,
+                      OSAL_IRQ_THREAD_PRIORITY, "eth_irq",
+                      mac_lld_serve_bh, NULL);
+#endif
+
   /* ISR vector enabled.*/
   nvicEnableVector(STM32_ETH_NUMBER, STM32_MAC_ETH1_IRQ_PRIORITY);
 
@@ -332,8 +551,15 @@ void mac_lld_start(MACDriver *macp) {
   mii_write(macp, MII_BMCR, mii_read(macp, MII_BMCR) & ~BMCR_PDOWN);
 #endif
 
-  /* MAC configuration.*/
-  ETH->MACFFR    = 0;
+#if defined(BOARD_PHY_IRQ_MASK_REG)
+  /* PHY link change interrupt enabled, a pending interrupt is cleared.*/
+  (void)mii_read(macp, BOARD_PHY_IRQ_STATUS_REG);
+  mii_write(macp, BOARD_PHY_IRQ_MASK_REG, BOARD_PHY_IRQ_MASK);
+#endif
+
+  /* MAC configuration, multicast frames are accepted by the exact match
+     and hash filters.*/
+  ETH->MACFFR    = ETH_MACFFR_HPF | ETH_MACFFR_HM;
   ETH->MACFCR    = 0;
   ETH->MACVLANTR = 0;
 
@@ -342,6 +568,8 @@ void mac_lld_start(MACDriver *macp) {
     mac_lld_set_address(default_mac_address);
   else
     mac_lld_set_address(macp->config->mac_address);
+  memset(macp->pfrefs, 0, sizeof macp->pfrefs);
+  memset(macp->hashrefs, 0, sizeof macp->hashrefs);
 
   /* Transmitter and receiver enabled.
      Note that the complete setup of the MAC is performed when the link
@@ -361,8 +589,14 @@ void mac_lld_start(MACDriver *macp) {
   ETH->DMASR    = ETH->DMASR;
   ETH->DMAIER   = ETH_DMAIER_NISE | ETH_DMAIER_RIE | ETH_DMAIER_TIE;
 
-  /* DMA general settings.*/
+  /* DMA general settings, the enhanced descriptors are required by the
+     time stamps.*/
+#if STM32_MAC_USE_PTP
+  ETH->DMABMR   = ETH_DMABMR_AAB | ETH_DMABMR_RDP_1Beat | ETH_DMABMR_PBL_1Beat |
+                  ETH_DMABMR_EDE;
+#else
   ETH->DMABMR   = ETH_DMABMR_AAB | ETH_DMABMR_RDP_1Beat | ETH_DMABMR_PBL_1Beat;
+#endif
 
   /* Check because errata on some devices. There should be no need to
      disable flushing because the TXFIFO should be empty on macStart().*/
@@ -388,6 +622,11 @@ void mac_lld_start(MACDriver *macp) {
 void mac_lld_stop(MACDriver *macp) {
 
   if (macp->state != MAC_STOP) {
+#if defined(BOARD_PHY_IRQ_MASK_REG)
+    /* PHY interrupt disabled.*/
+    mii_write(macp, BOARD_PHY_IRQ_MASK_REG, 0);
+#endif
+
 #if STM32_MAC_ETH1_CHANGE_PHY_STATE
     /* PHY in power down mode until the driver will be restarted.*/
     mii_write(macp, MII_BMCR, mii_read(macp, MII_BMCR) | BMCR_PDOWN);
@@ -401,9 +640,16 @@ void mac_lld_stop(MACDriver *macp) {
 
     /* MAC clocks stopped.*/
     rccDisableETH();
+#if STM32_MAC_USE_PTP
+    rccDisableAHB1(RCC_AHB1ENR_ETHMACPTPEN);
+#endif
 
     /* ISR vector disabled.*/
     nvicDisableVector(STM32_ETH_NUMBER);
+
+#if STM32_MAC_ETH1_USE_IRQ_THREAD
+    osalIrqThreadStopS(&eth_irq_thread);
+#endif
   }
 }
 
@@ -427,8 +673,18 @@ msg_t mac_lld_get_transmit_descriptor(MACDriver *macp,
   if (!macp->link_up)
     return MSG_TIMEOUT;
 
+#if MAC_USE_ZERO_COPY
+  /* Descriptors of lent frames become available after release.*/
+  mac_lld_release_transmitted_frames(macp);
+#endif
+
   osalSysLock();
 
+#if STM32_MAC_USE_PTP
+  /* The pending time stamp is latched before the descriptor is reused.*/
+  mac_lld_latch_timestamp(macp);
+#endif
+
   /* Get Current TX descriptor.*/
   tdes = macp->txptr;
 
@@ -439,6 +695,18 @@ msg_t mac_lld_get_transmit_descriptor(MACDriver *macp,
     return MSG_TIMEOUT;
   }
 
+#if MAC_USE_ZERO_COPY
+  /* The descriptor could still be assigned to a lent frame.*/
+  if (__eth_tf[tdes - __eth_td] != NULL) {
+    osalSysUnlock();
+    return MSG_TIMEOUT;
+  }
+
+  /* Restoring the descriptor own buffer, it could have been pointing to
+     a lent frame buffer.*/
+  tdes->tdes2 = (uint32_t)__eth_tb[tdes - __eth_td];
+#endif
+
   /* Marks the current descriptor as locked using a reserved bit.*/
   tdes->tdes0 |= STM32_TDES0_LOCKED;
 
@@ -451,6 +719,10 @@ msg_t mac_lld_get_transmit_descriptor(MACDriver *macp,
   tdp->offset   = 0;
   tdp->size     = STM32_MAC_BUFFERS_SIZE;
   tdp->physdesc = tdes;
+  tdp->cic      = STM32_TDES0_CIC(STM32_MAC_IP_CHECKSUM_OFFLOAD);
+#if STM32_MAC_USE_PTP
+  tdp->ttse     = 0U;
+#endif
 
   return MSG_OK;
 }
@@ -470,11 +742,26 @@ void mac_lld_release_transmit_descriptor(MACTransmitDescriptor *tdp) {
 
   osalSysLock();
 
+#if STM32_MAC_USE_PTP
+  /* The frame becomes the one waiting for a transmit time stamp, a
+     previous request is superseded.*/
+  if (tdp->ttse != 0U) {
+    ETHD1.tsptr   = tdp->physdesc;
+    ETHD1.txtsmsg = MSG_TIMEOUT;
+  }
+#endif
+
   /* Unlocks the descriptor and returns it to the DMA engine.*/
   tdp->physdesc->tdes1 = tdp->offset;
-  tdp->physdesc->tdes0 = STM32_TDES0_CIC(STM32_MAC_IP_CHECKSUM_OFFLOAD) |
+#if STM32_MAC_USE_PTP
+  tdp->physdesc->tdes0 = tdp->cic | tdp->ttse |
+                         STM32_TDES0_IC | STM32_TDES0_LS | STM32_TDES0_FS |
+                         STM32_TDES0_TCH | STM32_TDES0_OWN;
+#else
+  tdp->physdesc->tdes0 = tdp->cic |
                          STM32_TDES0_IC | STM32_TDES0_LS | STM32_TDES0_FS |
                          STM32_TDES0_TCH | STM32_TDES0_OWN;
+#endif
 
   /* Wait for the write to tdes0 to go through before resuming the DMA.*/
   __DSB();
@@ -514,7 +801,14 @@ msg_t mac_lld_get_receive_descriptor(MACDriver *macp,
     if (!(rdes->rdes0 & (STM32_RDES0_AFM | STM32_RDES0_ES))
 #if STM32_MAC_IP_CHECKSUM_OFFLOAD
         && (rdes->rdes0 & STM32_RDES0_FT)
+#if STM32_MAC_USE_PTP
+        /* In the enhanced format the checksum errors are reported in the
+           extended status.*/
+        && !((rdes->rdes0 & STM32_RDES0_ESA) &&
+             (rdes->rdes4 & (STM32_RDES4_IPHE | STM32_RDES4_IPPE)))
+#else
         && !(rdes->rdes0 & (STM32_RDES0_IPHCE | STM32_RDES0_PCE))
+#endif
 #endif
         && (rdes->rdes0 & STM32_RDES0_FS) && (rdes->rdes0 & STM32_RDES0_LS)) {
       /* Found a valid one.*/
@@ -584,6 +878,12 @@ bool mac_lld_poll_link_status(MACDriver *macp) {
 
   maccr = ETH->MACCR;
 
+#if defined(BOARD_PHY_IRQ_STATUS_REG)
+  /* PHY interrupt acknowledged before reading the status, a change
+     happening after this point raises a new interrupt.*/
+  (void)mii_read(macp, BOARD_PHY_IRQ_STATUS_REG);
+#endif
+
   /* PHY CR and SR registers read.*/
   (void)mii_read(macp, MII_BMSR);
   bmsr = mii_read(macp, MII_BMSR);
@@ -663,7 +963,12 @@ size_t mac_lld_write_transmit_descriptor(MACTransmitDescriptor *tdp,
     size = tdp->size - tdp->offset;
 
   if (size > 0) {
+#if STM32_MAC_USE_DMA_MEMCPY == TRUE
+    (void) dmaMemcpy((uint8_t *)(tdp->physdesc->tdes2) + tdp->offset,
+                     buf, size);
+#else
     memcpy((uint8_t *)(tdp->physdesc->tdes2) + tdp->offset, buf, size);
+#endif
     tdp->offset += size;
   }
   return size;
@@ -693,12 +998,384 @@ size_t mac_lld_read_receive_descriptor(MACReceiveDescriptor *rdp,
     size = rdp->size - rdp->offset;
 
   if (size > 0) {
+#if STM32_MAC_USE_DMA_MEMCPY == TRUE
+    (void) dmaMemcpy(buf, (uint8_t *)(rdp->physdesc->rdes2) + rdp->offset,
+                     size);
+#else
     memcpy(buf, (uint8_t *)(rdp->physdesc->rdes2) + rdp->offset, size);
+#endif
     rdp->offset += size;
   }
   return size;
 }
 
+/**
+ * @brief   Selects the checksums inserted by the MAC in a transmit frame.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ * @param[in] flags     checksum offload flags
+ *
+ * @notapi
+ */
+void mac_lld_set_transmit_checksum_offload(MACTransmitDescriptor *tdp,
+                                           uint32_t flags) {
+
+  flags &= MAC_CHECKSUM_TX_OFFLOAD;
+  if ((flags & ~MAC_CHECKSUM_IP) != 0U)
+    tdp->cic = STM32_TDES0_CIC(3U);
+  else if ((flags & MAC_CHECKSUM_IP) != 0U)
+    tdp->cic = STM32_TDES0_CIC(1U);
+  else
+    tdp->cic = STM32_TDES0_CIC(0U);
+}
+
+/**
+ * @brief   Enables the frame received interrupt.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @notapi
+ */
+void mac_lld_enable_receive_interrupt(MACDriver *macp) {
+
+  (void)macp;
+
+  ETH->DMAIER |= ETH_DMAIER_RIE;
+}
+
+/**
+ * @brief   Disables the frame received interrupt.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @notapi
+ */
+void mac_lld_disable_receive_interrupt(MACDriver *macp) {
+
+  (void)macp;
+
+  ETH->DMAIER &= ~ETH_DMAIER_RIE;
+}
+
+/**
+ * @brief   Sets the frame filter mode.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] mode      mode flags
+ *
+ * @notapi
+ */
+void mac_lld_set_filter_mode(MACDriver *macp, uint32_t mode) {
+  uint32_t ffr = ETH_MACFFR_HPF | ETH_MACFFR_HM;
+
+  (void)macp;
+
+  if ((mode & MAC_FILTER_PROMISCUOUS) != 0U) {
+    ffr |= ETH_MACFFR_PM;
+  }
+  if ((mode & MAC_FILTER_ALL_MULTICAST) != 0U) {
+    ffr |= ETH_MACFFR_PAM;
+  }
+  if ((mode & MAC_FILTER_NO_BROADCAST) != 0U) {
+    ffr |= ETH_MACFFR_BFD;
+  }
+  ETH->MACFFR = ffr;
+}
+
+/**
+ * @brief   Adds an address to the receive filter.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] addr      pointer to a six bytes buffer containing the MAC
+ *                      address
+ * @return              The operation status.
+ * @retval MSG_OK       if the address has been added.
+ * @retval MSG_RESET    if there are no filters available for the address.
+ *
+ * @notapi
+ */
+msg_t mac_lld_add_filter_address(MACDriver *macp, const uint8_t *addr) {
+  uint32_t hr = ETH_MACA1HR_AE | ((uint32_t)addr[5] << 8) | (uint32_t)addr[4];
+  uint32_t lr = ((uint32_t)addr[3] << 24) | ((uint32_t)addr[2] << 16) |
+                ((uint32_t)addr[1] << 8)  | (uint32_t)addr[0];
+  unsigned i, hash, free = STM32_MAC_PERFECT_FILTERS;
+  volatile uint32_t *afp;
+
+  /* An address already in an exact match filter is just referenced
+     again.*/
+  for (i = 0U; i < STM32_MAC_PERFECT_FILTERS; i++) {
+    afp = mac_lld_perfect_filter(i);
+    if (macp->pfrefs[i] == 0U) {
+      if (free == STM32_MAC_PERFECT_FILTERS) {
+        free = i;
+      }
+    }
+    else if ((afp[0] == hr) && (afp[1] == lr)) {
+      if (macp->pfrefs[i] == 255U) {
+        return MSG_RESET;
+      }
+      macp->pfrefs[i]++;
+      return MSG_OK;
+    }
+  }
+
+  /* Using a free exact match filter, the address is enabled last.*/
+  if (free < STM32_MAC_PERFECT_FILTERS) {
+    afp = mac_lld_perfect_filter(free);
+    afp[1] = lr;
+    afp[0] = hr;
+    macp->pfrefs[free] = 1U;
+    return MSG_OK;
+  }
+
+  /* Multicast addresses fall back to the hash filter.*/
+  if ((addr[0] & 1U) != 0U) {
+    hash = mac_lld_hash(addr);
+    if (macp->hashrefs[hash] == 255U) {
+      return MSG_RESET;
+    }
+    if (macp->hashrefs[hash]++ == 0U) {
+      mac_lld_set_hash(hash, true);
+    }
+    return MSG_OK;
+  }
+
+  return MSG_RESET;
+}
+
+/**
+ * @brief   Removes an address from the receive filter.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] addr      pointer to a six bytes buffer containing the MAC
+ *                      address
+ * @return              The operation status.
+ * @retval MSG_OK       if the address has been removed.
+ * @retval MSG_RESET    if the address was not in the filter.
+ *
+ * @notapi
+ */
+msg_t mac_lld_remove_filter_address(MACDriver *macp, const uint8_t *addr) {
+  uint32_t hr = ETH_MACA1HR_AE | ((uint32_t)addr[5] << 8) | (uint32_t)addr[4];
+  uint32_t lr = ((uint32_t)addr[3] << 24) | ((uint32_t)addr[2] << 16) |
+                ((uint32_t)addr[1] << 8)  | (uint32_t)addr[0];
+  unsigned i, hash;
+  volatile uint32_t *afp;
+
+  for (i = 0U; i < STM32_MAC_PERFECT_FILTERS; i++) {
+    afp = mac_lld_perfect_filter(i);
+    if ((macp->pfrefs[i] > 0U) && (afp[0] == hr) && (afp[1] == lr)) {
+      if (--macp->pfrefs[i] == 0U) {
+        afp[0] = 0x0000FFFF;
+        afp[1] = 0xFFFFFFFF;
+      }
+      return MSG_OK;
+    }
+  }
+
+  if ((addr[0] & 1U) != 0U) {
+    hash = mac_lld_hash(addr);
+    if (macp->hashrefs[hash] > 0U) {
+      if (--macp->hashrefs[hash] == 0U) {
+        mac_lld_set_hash(hash, false);
+      }
+      return MSG_OK;
+    }
+  }
+
+  return MSG_RESET;
+}
+
+/**
+ * @brief   Sets the VLAN filter.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] vid       VLAN identifier, zero disables the filter
+ *
+ * @notapi
+ */
+void mac_lld_set_vlan_filter(MACDriver *macp, uint16_t vid) {
+
+  (void)macp;
+
+  if (vid == 0U) {
+    ETH->MACVLANTR = 0U;
+  }
+  else {
+    ETH->MACVLANTR = ETH_MACVLANTR_VLANTC | (uint32_t)vid;
+  }
+}
+
+#if STM32_MAC_USE_PTP || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the time stamp of a received frame.
+ *
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @param[out] tsp      pointer to a @p mac_timestamp_t structure
+ * @return              The time stamp availability.
+ * @retval true         if the time stamp has been returned.
+ * @retval false        if the frame has not been time stamped.
+ *
+ * @notapi
+ */
+bool mac_lld_get_receive_timestamp(MACReceiveDescriptor *rdp,
+                                   mac_timestamp_t *tsp) {
+
+  if (!(rdp->physdesc->rdes0 & STM32_RDES0_TSV))
+    return false;
+
+  tsp->nsec = rdp->physdesc->rdes6;
+  tsp->sec  = rdp->physdesc->rdes7;
+  return true;
+}
+
+/**
+ * @brief   Requests the time stamp of a transmit frame.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ *
+ * @notapi
+ */
+void mac_lld_request_transmit_timestamp(MACTransmitDescriptor *tdp) {
+
+  tdp->ttse = STM32_TDES0_TTSE;
+}
+
+/**
+ * @brief   Returns the time stamp of the last transmitted frame.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] tsp      pointer to a @p mac_timestamp_t structure
+ * @return              The operation status.
+ * @retval MSG_OK       the time stamp has been returned.
+ * @retval MSG_TIMEOUT  the frame has not been transmitted yet.
+ * @retval MSG_RESET    no time stamp has been requested or the frame has
+ *                      not been time stamped.
+ *
+ * @notapi
+ */
+msg_t mac_lld_get_transmit_timestamp(MACDriver *macp, mac_timestamp_t *tsp) {
+  msg_t msg;
+
+  osalSysLock();
+  mac_lld_latch_timestamp(macp);
+  msg = macp->txtsmsg;
+  if (msg == MSG_OK) {
+    *tsp = macp->txts;
+    macp->txtsmsg = MSG_RESET;
+  }
+  osalSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Returns the current PTP clock time.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] tsp      pointer to a @p mac_timestamp_t structure
+ *
+ * @notapi
+ */
+void mac_lld_ptp_get_time(MACDriver *macp, mac_timestamp_t *tsp) {
+  uint32_t sec;
+
+  (void)macp;
+
+  /* Reading again if the seconds changed while reading the sub-seconds.*/
+  do {
+    sec       = ETH->PTPTSHR;
+    tsp->nsec = ETH->PTPTSLR & ETH_PTPTSLR_STSS;
+    tsp->sec  = ETH->PTPTSHR;
+  } while (sec != tsp->sec);
+}
+
+/**
+ * @brief   Sets the PTP clock time.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] tsp       pointer to a @p mac_timestamp_t structure
+ *
+ * @notapi
+ */
+void mac_lld_ptp_set_time(MACDriver *macp, const mac_timestamp_t *tsp) {
+
+  (void)macp;
+
+  osalDbgCheck(tsp->nsec < 1000000000U);
+
+  mac_lld_ptp_wait(ETH_PTPTSCR_TSSTI | ETH_PTPTSCR_TSSTU);
+  ETH->PTPTSHUR = tsp->sec;
+  ETH->PTPTSLUR = tsp->nsec;
+  ETH->PTPTSCR |= ETH_PTPTSCR_TSSTI;
+  mac_lld_ptp_wait(ETH_PTPTSCR_TSSTI);
+}
+
+/**
+ * @brief   Adds an offset to the PTP clock time.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] offset    offset in nanoseconds, can be negative
+ *
+ * @notapi
+ */
+void mac_lld_ptp_adjust_time(MACDriver *macp, int64_t offset) {
+  uint32_t sec, nsec, sign;
+
+  (void)macp;
+
+  sign = 0U;
+  if (offset < 0) {
+    sign   = ETH_PTPTSLUR_TSUPNS;
+    offset = -offset;
+  }
+  sec  = (uint32_t)(offset / 1000000000);
+  nsec = (uint32_t)(offset % 1000000000);
+
+  /* In digital rollover mode a subtracted sub-seconds value is programmed
+     as its complement to one second.*/
+  if ((sign != 0U) && (nsec != 0U)) {
+    nsec = 1000000000U - nsec;
+  }
+
+  mac_lld_ptp_wait(ETH_PTPTSCR_TSSTI | ETH_PTPTSCR_TSSTU);
+  ETH->PTPTSHUR = sec;
+  ETH->PTPTSLUR = sign | nsec;
+  ETH->PTPTSCR |= ETH_PTPTSCR_TSSTU;
+  mac_lld_ptp_wait(ETH_PTPTSCR_TSSTU);
+}
+
+/**
+ * @brief   Adjusts the PTP clock frequency.
+ * @details The addend register is scaled from its nominal value, the
+ *          correction is applied without steps in the clock time.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] ppb       frequency correction in parts per billion, can be
+ *                      negative
+ *
+ * @notapi
+ */
+void mac_lld_ptp_adjust_frequency(MACDriver *macp, int32_t ppb) {
+  int64_t addend;
+
+  (void)macp;
+
+  addend = (int64_t)STM32_MAC_PTP_ADDEND +
+           (((int64_t)STM32_MAC_PTP_ADDEND * (int64_t)ppb) / 1000000000);
+  if (addend > (int64_t)0xFFFFFFFFU) {
+    addend = (int64_t)0xFFFFFFFFU;
+  }
+  else if (addend < 0) {
+    addend = 0;
+  }
+
+  mac_lld_ptp_wait(ETH_PTPTSCR_TSARU);
+  ETH->PTPTSAR  = (uint32_t)addend;
+  ETH->PTPTSCR |= ETH_PTPTSCR_TSARU;
+}
+#endif /* STM32_MAC_USE_PTP */
+
 #if MAC_USE_ZERO_COPY || defined(__DOXYGEN__)
 /**
  * @brief   Returns a pointer to the next transmit buffer in the descriptor
@@ -760,6 +1437,198 @@ const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
   *sizep = 0;
   return NULL;
 }
+
+/**
+ * @brief   Lends the buffer of a received frame.
+ * @details The buffer containing the frame is detached from the descriptor
+ *          and replaced with a spare one, the descriptor can be released
+ *          immediately while the frame buffer is retained by the caller.
+ *
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @return              Pointer to the frame buffer.
+ * @retval NULL         if no spare buffers are available.
+ *
+ * @notapi
+ */
+uint8_t *mac_lld_lend_receive_buffer(MACReceiveDescriptor *rdp) {
+  uint8_t *buf;
+
+  osalDbgAssert(!(rdp->physdesc->rdes0 & STM32_RDES0_OWN),
+              "attempt to lend descriptor already owned by DMA");
+
+  osalSysLock();
+
+  if (__eth_spare == NULL) {
+    osalSysUnlock();
+    return NULL;
+  }
+
+  /* Swapping the frame buffer with a spare one.*/
+  buf = (uint8_t *)rdp->physdesc->rdes2;
+  rdp->physdesc->rdes2 = (uint32_t)__eth_spare;
+  __eth_spare = (uint32_t *)__eth_spare[0];
+
+  osalSysUnlock();
+
+  /* Nothing left to be read from the descriptor.*/
+  rdp->offset = rdp->size;
+
+  return buf;
+}
+
+/**
+ * @brief   Gives back a buffer lent by @p mac_lld_lend_receive_buffer().
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] buf       pointer to the buffer
+ *
+ * @notapi
+ */
+void mac_lld_return_receive_buffer(MACDriver *macp, uint8_t *buf) {
+  uint32_t *bp = (uint32_t *)(void *)buf;
+
+  (void)macp;
+
+  osalSysLock();
+  bp[0] = (uint32_t)__eth_spare;
+  __eth_spare = bp;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Transmits a frame directly from the caller buffers.
+ * @details Each buffer takes a descriptor, the descriptors chain is given to
+ *          the DMA starting from the last one so that the transmission
+ *          cannot start on an incomplete chain.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] tbp       pointer to an array of @p MACTransmitBuffer structures
+ * @param[in] n         number of buffers in the array
+ * @param[in] frame     frame identifier passed to the release callback
+ * @return              The operation status.
+ * @retval MSG_OK       the frame has been queued for transmission.
+ * @retval MSG_TIMEOUT  descriptors not available.
+ *
+ * @notapi
+ */
+msg_t mac_lld_transmit_buffers(MACDriver *macp,
+                               const MACTransmitBuffer *tbp, size_t n,
+                               void *frame) {
+  stm32_eth_tx_descriptor_t *first, *tdes;
+  size_t i;
+
+  if (!macp->link_up)
+    return MSG_TIMEOUT;
+
+  /* Descriptors of lent frames become available after release.*/
+  mac_lld_release_transmitted_frames(macp);
+
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  /* The caller buffers can be located in cacheable memory, unlike the
+     driver buffers which are placed in the ETH_RAM region.*/
+  for (i = 0; i < n; i++) {
+    cacheDMABeforeTx(tbp[i].buf, tbp[i].size);
+  }
+#endif
+
+  osalSysLock();
+
+#if STM32_MAC_USE_PTP
+  /* The pending time stamp is latched before the descriptors are reused.*/
+  mac_lld_latch_timestamp(macp);
+#endif
+
+  /* All the required descriptors must be available.*/
+  first = macp->txptr;
+  tdes  = first;
+  for (i = 0; i < n; i++) {
+    if ((tdes->tdes0 & (STM32_TDES0_OWN | STM32_TDES0_LOCKED)) ||
+        (__eth_tf[tdes - __eth_td] != NULL)) {
+      osalSysUnlock();
+      return MSG_TIMEOUT;
+    }
+    tdes = (stm32_eth_tx_descriptor_t *)tdes->tdes3;
+  }
+
+  /* Filling the descriptors, all except the first one are given to the DMA
+     immediately.*/
+  tdes = first;
+  for (i = 0; i < n; i++) {
+    uint32_t tdes0 = STM32_TDES0_CIC(STM32_MAC_IP_CHECKSUM_OFFLOAD) |
+                     STM32_TDES0_TCH;
+
+    osalDbgAssert(tbp[i].size <= STM32_TDES1_TBS1_MASK, "buffer too large");
+
+    tdes->tdes1 = tbp[i].size;
+    tdes->tdes2 = (uint32_t)tbp[i].buf;
+    if (i == 0U) {
+      tdes0 |= STM32_TDES0_FS;
+    }
+    else {
+      tdes0 |= STM32_TDES0_OWN;
+    }
+    if (i == n - 1U) {
+      tdes0 |= STM32_TDES0_IC | STM32_TDES0_LS;
+      __eth_tf[tdes - __eth_td] = frame;
+    }
+    else {
+      __eth_tf[tdes - __eth_td] = TX_FRAME_CONTINUES;
+    }
+    tdes->tdes0 = tdes0;
+    tdes = (stm32_eth_tx_descriptor_t *)tdes->tdes3;
+  }
+  macp->txptr = tdes;
+
+  /* Wait for the writes to the chain to go through before giving the
+     first descriptor to the DMA.*/
+  __DSB();
+  first->tdes0 |= STM32_TDES0_OWN;
+  __DSB();
+
+  /* If the DMA engine is stalled then a restart request is issued.*/
+  if ((ETH->DMASR & ETH_DMASR_TPS) == ETH_DMASR_TPS_Suspended) {
+    ETH->DMASR   = ETH_DMASR_TBUS;
+    ETH->DMATPDR = ETH_DMASR_TBUS; /* Any value is OK.*/
+  }
+
+  osalSysUnlock();
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Releases the frames already transmitted.
+ * @details The release callback is invoked for each frame queued using
+ *          @p mac_lld_transmit_buffers() and whose descriptors have all
+ *          been returned by the DMA.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @notapi
+ */
+void mac_lld_release_transmitted_frames(MACDriver *macp) {
+  unsigned i;
+
+  for (i = 0; i < STM32_MAC_TRANSMIT_BUFFERS; i++) {
+    void *frame;
+
+    osalSysLock();
+    frame = __eth_tf[i];
+    if ((frame == NULL) || (__eth_td[i].tdes0 & STM32_TDES0_OWN)) {
+      osalSysUnlock();
+      continue;
+    }
+    __eth_tf[i] = NULL;
+    osalSysUnlock();
+
+    /* The frame is complete when its last descriptor is returned, the
+       previous ones have been returned before.*/
+    if ((frame != TX_FRAME_CONTINUES) && (macp->config != NULL) &&
+        (macp->config->tx_release_cb != NULL)) {
+      macp->config->tx_release_cb(macp, frame);
+    }
+  }
+}
 #endif /* MAC_USE_ZERO_COPY */
 
 #endif /* HAL_USE_MAC */
@@ -36,6 +36,45 @@
  */
 #define MAC_SUPPORTS_ZERO_COPY      TRUE
 
+/**
+ * @brief   This implementation supports buffers lending in zero-copy mode.
+ */
+#define MAC_SUPPORTS_BUFFERS_LENDING TRUE
+
+/**
+ * @brief   Maximum number of buffers composing a frame transmitted using
+ *          @p macWaitTransmitBuffers().
+ */
+#define MAC_MAX_TRANSMIT_BUFFERS    STM32_MAC_TRANSMIT_BUFFERS
+
+/**
+ * @brief   This implementation supports the receive interrupt masking.
+ */
+#define MAC_SUPPORTS_RECEIVE_POLLING TRUE
+
+/**
+ * @brief   This implementation supports link change events.
+ * @details The PHY interrupt is enabled on start if the board header file
+ *          defines @p BOARD_PHY_IRQ_MASK_REG, @p BOARD_PHY_IRQ_MASK and
+ *          @p BOARD_PHY_IRQ_STATUS_REG, the status register is read by
+ *          @p macPollLinkStatus() in order to acknowledge the interrupt.
+ *          The PHY interrupt line is handled by the application which is
+ *          expected to invoke @p macLinkChangedI() from its callback.
+ */
+#define MAC_SUPPORTS_LINK_EVENTS    TRUE
+
+/**
+ * @brief   This implementation supports the frame filters.
+ * @details Three exact match filters are available besides the station
+ *          address, multicast addresses exceeding them are hash filtered.
+ */
+#define MAC_SUPPORTS_FILTERS        TRUE
+
+/**
+ * @brief   Number of exact match filters.
+ */
+#define STM32_MAC_PERFECT_FILTERS   3U
+
 /**
  * @name    RDES0 constants
  * @{
@@ -59,6 +98,8 @@
 #define STM32_RDES0_DE              0x00000004
 #define STM32_RDES0_CE              0x00000002
 #define STM32_RDES0_PCE             0x00000001
+#define STM32_RDES0_TSV             0x00000080 /* NOTE: Enhanced format.    */
+#define STM32_RDES0_ESA             0x00000001 /* NOTE: Enhanced format.    */
 /** @} */
 
 /**
@@ -72,6 +113,14 @@
 #define STM32_RDES1_RBS1_MASK       0x00001FFF
 /** @} */
 
+/**
+ * @name    RDES4 constants
+ * @{
+ */
+#define STM32_RDES4_IPPE            0x00000010
+#define STM32_RDES4_IPHE            0x00000008
+/** @} */
+
 /**
  * @name    TDES0 constants
  * @{
@@ -135,6 +184,17 @@
 #define STM32_MAC_RECEIVE_BUFFERS           4
 #endif
 
+/**
+ * @brief   Number of spare receive buffers.
+ * @details Spare buffers replace the receive buffers lent by
+ *          @p macLendReceiveBuffer(), this is the maximum number of
+ *          received frames that can be lent at the same time.
+ * @note    Only used if @p MAC_USE_ZERO_COPY is enabled.
+ */
+#if !defined(STM32_MAC_RECEIVE_SPARE_BUFFERS) || defined(__DOXYGEN__)
+#define STM32_MAC_RECEIVE_SPARE_BUFFERS     4
+#endif
+
 /**
  * @brief   Maximum supported frame size.
  */
@@ -168,6 +228,16 @@
 #define STM32_MAC_ETH1_IRQ_PRIORITY         13
 #endif
 
+/**
+ * @brief   ETHD1 IRQ thread enable switch.
+ * @details If set to @p TRUE the ISR only acknowledges the DMA events, the
+ *          waiting threads are released by an IRQ bottom-half thread.
+ * @note    Requires @p OSAL_USE_IRQ_THREADS.
+ */
+#if !defined(STM32_MAC_ETH1_USE_IRQ_THREAD) || defined(__DOXYGEN__)
+#define STM32_MAC_ETH1_USE_IRQ_THREAD       FALSE
+#endif
+
 /**
  * @brief   IP checksum offload.
  * @details The following modes are available:
@@ -184,12 +254,115 @@
 #if !defined(STM32_MAC_IP_CHECKSUM_OFFLOAD) || defined(__DOXYGEN__)
 #define STM32_MAC_IP_CHECKSUM_OFFLOAD       0
 #endif
+
+/**
+ * @brief   IEEE 1588 time stamps.
+ * @details If enabled the PTP time stamp unit is started with the driver,
+ *          all the received frames and the transmitted frames requesting
+ *          it are time stamped. The enhanced descriptors format is used,
+ *          time stamps are read from the descriptors without register
+ *          accesses.
+ */
+#if !defined(STM32_MAC_USE_PTP) || defined(__DOXYGEN__)
+#define STM32_MAC_USE_PTP                   FALSE
+#endif
+
+/**
+ * @brief   PTP clock sub-second increment in nanoseconds.
+ * @details The PTP clock is updated at 1000000000 / increment Hz using
+ *          the fine correction method, the update frequency must be lower
+ *          than HCLK, the margin is the frequency correction range.
+ */
+#if !defined(STM32_MAC_PTP_INCREMENT) || defined(__DOXYGEN__)
+#define STM32_MAC_PTP_INCREMENT             20
+#endif
+
+/**
+ * @brief   Descriptors copies offload.
+ * @details If enabled the copies to and from the descriptors buffers are
+ *          performed using @p dmaMemcpy(), the frames smaller than
+ *          @p STM32_DMA_MEMCPY_THRESHOLD are still copied by the CPU.
+ */
+#if !defined(STM32_MAC_USE_DMA_MEMCPY) || defined(__DOXYGEN__)
+#define STM32_MAC_USE_DMA_MEMCPY            FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (STM32_MAC_IP_CHECKSUM_OFFLOAD < 0) || (STM32_MAC_IP_CHECKSUM_OFFLOAD > 3)
+#error "invalid STM32_MAC_IP_CHECKSUM_OFFLOAD value"
+#endif
+
+#if (STM32_MAC_USE_DMA_MEMCPY == TRUE) && (STM32_DMA_USE_MEMCPY == FALSE)
+#error "STM32_MAC_USE_DMA_MEMCPY requires STM32_DMA_USE_MEMCPY"
+#endif
+
+#if (STM32_MAC_ETH1_USE_IRQ_THREAD == TRUE) && (OSAL_USE_IRQ_THREADS != TRUE)
+#error "STM32_MAC_ETH1_USE_IRQ_THREAD requires OSAL_USE_IRQ_THREADS"
+#endif
+
+#if STM32_MAC_USE_PTP
+#if !defined(ETH_DMABMR_EDE)
+#error "STM32_MAC_USE_PTP not supported on this device"
+#endif
+
+#if (STM32_MAC_PTP_INCREMENT < 1) || (STM32_MAC_PTP_INCREMENT > 255)
+#error "invalid STM32_MAC_PTP_INCREMENT value"
+#endif
+
+#if (1000000000 / STM32_MAC_PTP_INCREMENT) >= STM32_HCLK
+#error "STM32_MAC_PTP_INCREMENT too small for the current HCLK"
+#endif
+#endif
+
+#if defined(BOARD_PHY_IRQ_MASK_REG) &&                                      \
+    (!defined(BOARD_PHY_IRQ_MASK) || !defined(BOARD_PHY_IRQ_STATUS_REG))
+#error "BOARD_PHY_IRQ_MASK_REG requires BOARD_PHY_IRQ_MASK and BOARD_PHY_IRQ_STATUS_REG"
+#endif
+
+/**
+ * @brief   Checksums inserted by the MAC in transmitted frames.
+ * @note    In mode 2 the payload checksum requires a pseudo-header checksum
+ *          precomputed in software so only the IP header one is offloaded.
+ */
+#if (STM32_MAC_IP_CHECKSUM_OFFLOAD == 3) || defined(__DOXYGEN__)
+#define MAC_CHECKSUM_TX_OFFLOAD     MAC_CHECKSUM_ALL
+#elif STM32_MAC_IP_CHECKSUM_OFFLOAD > 0
+#define MAC_CHECKSUM_TX_OFFLOAD     MAC_CHECKSUM_IP
+#else
+#define MAC_CHECKSUM_TX_OFFLOAD     0U
+#endif
+
+/**
+ * @brief   Checksums verified by the MAC in received frames.
+ * @note    Frames failing the verification are discarded by the driver.
+ */
+#if (STM32_MAC_IP_CHECKSUM_OFFLOAD > 0) || defined(__DOXYGEN__)
+#define MAC_CHECKSUM_RX_OFFLOAD     MAC_CHECKSUM_ALL
+#else
+#define MAC_CHECKSUM_RX_OFFLOAD     0U
+#endif
+
+/**
+ * @brief   This implementation supports IEEE 1588 time stamps.
+ */
+#if (STM32_MAC_USE_PTP == TRUE) || defined(__DOXYGEN__)
+#define MAC_SUPPORTS_TIMESTAMPS     TRUE
+#endif
+
+/**
+ * @brief   Nominal PTP addend value.
+ * @details The time stamp counter is incremented when the 32 bits
+ *          accumulator, incremented by the addend each HCLK cycle,
+ *          overflows.
+ */
+#define STM32_MAC_PTP_ADDEND                                                \
+  ((uint32_t)((((uint64_t)1000000000U / (uint64_t)STM32_MAC_PTP_INCREMENT)  \
+               << 32) / (uint64_t)STM32_HCLK))
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -202,6 +375,12 @@ typedef struct {
   volatile uint32_t     rdes1;
   volatile uint32_t     rdes2;
   volatile uint32_t     rdes3;
+#if STM32_MAC_USE_PTP || defined(__DOXYGEN__)
+  volatile uint32_t     rdes4;
+  volatile uint32_t     rdes5;
+  volatile uint32_t     rdes6;
+  volatile uint32_t     rdes7;
+#endif
 } stm32_eth_rx_descriptor_t;
 
 /**
@@ -212,6 +391,12 @@ typedef struct {
   volatile uint32_t     tdes1;
   volatile uint32_t     tdes2;
   volatile uint32_t     tdes3;
+#if STM32_MAC_USE_PTP || defined(__DOXYGEN__)
+  volatile uint32_t     tdes4;
+  volatile uint32_t     tdes5;
+  volatile uint32_t     tdes6;
+  volatile uint32_t     tdes7;
+#endif
 } stm32_eth_tx_descriptor_t;
 
 /**
@@ -223,6 +408,14 @@ typedef struct {
    */
   uint8_t               *mac_address;
   /* End of the mandatory fields.*/
+#if (MAC_USE_ZERO_COPY == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief Release callback for frames queued using
+   *        @p macWaitTransmitBuffers().
+   * @note  It is invoked from thread context, can be @p NULL.
+   */
+  macframecb_t          tx_release_cb;
+#endif
 } MACConfig;
 
 /**
@@ -252,6 +445,12 @@ struct MACDriver {
   event_source_t        rdevent;
 #endif
   /* End of the mandatory fields.*/
+#if MAC_USE_EVENTS || defined(__DOXYGEN__)
+  /**
+   * @brief Link change event.
+   */
+  event_source_t        lsevent;
+#endif
   /**
    * @brief Link status flag.
    */
@@ -268,6 +467,28 @@ struct MACDriver {
    * @brief Transmit next frame pointer.
    */
   stm32_eth_tx_descriptor_t *txptr;
+#if STM32_MAC_USE_PTP || defined(__DOXYGEN__)
+  /**
+   * @brief Descriptor of the frame waiting for a transmit time stamp.
+   */
+  stm32_eth_tx_descriptor_t *tsptr;
+  /**
+   * @brief Last transmit time stamp.
+   */
+  mac_timestamp_t       txts;
+  /**
+   * @brief Last transmit time stamp status.
+   */
+  msg_t                 txtsmsg;
+#endif
+  /**
+   * @brief Exact match filters reference counters.
+   */
+  uint8_t               pfrefs[STM32_MAC_PERFECT_FILTERS];
+  /**
+   * @brief Hash filter bins reference counters.
+   */
+  uint8_t               hashrefs[64];
 };
 
 /**
@@ -287,6 +508,16 @@ typedef struct {
    * @brief Pointer to the physical descriptor.
    */
   stm32_eth_tx_descriptor_t *physdesc;
+  /**
+   * @brief Checksum insertion control bits.
+   */
+  uint32_t                  cic;
+#if STM32_MAC_USE_PTP || defined(__DOXYGEN__)
+  /**
+   * @brief Time stamp enable bit.
+   */
+  uint32_t                  ttse;
+#endif
 } MACTransmitDescriptor;
 
 /**
@@ -341,12 +572,36 @@ extern "C" {
   size_t mac_lld_read_receive_descriptor(MACReceiveDescriptor *rdp,
                                          uint8_t *buf,
                                          size_t size);
+  void mac_lld_set_transmit_checksum_offload(MACTransmitDescriptor *tdp,
+                                             uint32_t flags);
+  void mac_lld_enable_receive_interrupt(MACDriver *macp);
+  void mac_lld_disable_receive_interrupt(MACDriver *macp);
+  void mac_lld_set_filter_mode(MACDriver *macp, uint32_t mode);
+  msg_t mac_lld_add_filter_address(MACDriver *macp, const uint8_t *addr);
+  msg_t mac_lld_remove_filter_address(MACDriver *macp, const uint8_t *addr);
+  void mac_lld_set_vlan_filter(MACDriver *macp, uint16_t vid);
+#if STM32_MAC_USE_PTP
+  bool mac_lld_get_receive_timestamp(MACReceiveDescriptor *rdp,
+                                     mac_timestamp_t *tsp);
+  void mac_lld_request_transmit_timestamp(MACTransmitDescriptor *tdp);
+  msg_t mac_lld_get_transmit_timestamp(MACDriver *macp, mac_timestamp_t *tsp);
+  void mac_lld_ptp_get_time(MACDriver *macp, mac_timestamp_t *tsp);
+  void mac_lld_ptp_set_time(MACDriver *macp, const mac_timestamp_t *tsp);
+  void mac_lld_ptp_adjust_time(MACDriver *macp, int64_t offset);
+  void mac_lld_ptp_adjust_frequency(MACDriver *macp, int32_t ppb);
+#endif
 #if MAC_USE_ZERO_COPY
   uint8_t *mac_lld_get_next_transmit_buffer(MACTransmitDescriptor *tdp,
                                             size_t size,
                                             size_t *sizep);
   const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
                                                  size_t *sizep);
+  uint8_t *mac_lld_lend_receive_buffer(MACReceiveDescriptor *rdp);
+  void mac_lld_return_receive_buffer(MACDriver *macp, uint8_t *buf);
+  msg_t mac_lld_transmit_buffers(MACDriver *macp,
+                                 const MACTransmitBuffer *tbp, size_t n,
+                                 void *frame);
+  void mac_lld_release_transmitted_frames(MACDriver *macp);
 #endif /* MAC_USE_ZERO_COPY */
 #ifdef __cplusplus
 }
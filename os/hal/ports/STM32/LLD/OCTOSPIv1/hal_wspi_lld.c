@@ -92,6 +92,25 @@ static void wspi_lld_serve_dma_interrupt(WSPIDriver *wspip, uint32_t flags) {
  */
 static void wspi_lld_serve_interrupt(WSPIDriver *wspip) {
 
+  /* End of an automatic polling operation, the DMA is not involved and
+     the matched data is in the data register.*/
+  if ((wspip->ospi->CR & OCTOSPI_CR_SMIE) != 0U) {
+    uint32_t dr = wspip->ospi->DR;
+
+    wspip->ospi->CR &= ~(OCTOSPI_CR_SMIE | OCTOSPI_CR_APMS);
+    wspip->ospi->CR |= OCTOSPI_CR_DMAEN;
+    if (wspip->pollbuf != NULL) {
+      size_t i;
+
+      for (i = 0U; i < wspip->pollsize; i++) {
+        wspip->pollbuf[i] = (uint8_t)(dr >> (i * 8U));
+      }
+    }
+
+    _wspi_isr_code(wspip);
+    return;
+  }
+
   /* Portable WSPI ISR code defined in the high level driver, note, it is
      a macro.*/
   _wspi_isr_code(wspip);
@@ -397,6 +416,50 @@ void wspi_lld_receive(WSPIDriver *wspip, const wspi_command_t *cmdp,
   dmaStreamEnable(wspip->dma);
 }
 
+/**
+ * @brief   Sends a command then polls data until a match.
+ * @details The OCTOSPI automatic polling mode is used, the peripheral
+ *          stops on match and raises an interrupt.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[in] n         number of bytes to receive, from 1 to 4
+ * @param[in] mask      mask of the compared bits
+ * @param[in] match     expected value of the compared bits
+ * @param[out] rxbuf    the pointer to the buffer receiving the matched
+ *                      data or @p NULL
+ *
+ * @notapi
+ */
+void wspi_lld_poll(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                   size_t n, uint32_t mask, uint32_t match,
+                   uint8_t *rxbuf) {
+
+  wspip->pollbuf  = rxbuf;
+  wspip->pollsize = n;
+
+  /* Waiting for the previous operation to complete, if any.*/
+  wspi_lld_sync(wspip);
+
+  /* Disabling the DMA request while polling, stop on match.*/
+  wspip->ospi->CR    = (wspip->ospi->CR & ~(OCTOSPI_CR_FMODE |
+                                            OCTOSPI_CR_DMAEN)) |
+                       OCTOSPI_CR_FMODE_1 | OCTOSPI_CR_APMS |
+                       OCTOSPI_CR_SMIE;
+  wspip->ospi->PSMKR = mask;
+  wspip->ospi->PSMAR = match;
+  wspip->ospi->PIR   = STM32_WSPI_POLLING_INTERVAL;
+  wspip->ospi->DLR   = n - 1U;
+  wspip->ospi->TCR   = cmdp->dummy;
+  wspip->ospi->CCR   = cmdp->cfg;
+  wspip->ospi->ABR   = cmdp->alt;
+  wspip->ospi->IR    = cmdp->cmd;
+  if ((cmdp->cfg & WSPI_CFG_ADDR_MODE_MASK) != WSPI_CFG_ADDR_MODE_NONE) {
+    wspip->ospi->AR  = cmdp->addr;
+  }
+}
+
 #if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Maps in memory space a WSPI flash device.
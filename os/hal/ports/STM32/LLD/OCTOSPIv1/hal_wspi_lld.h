@@ -36,6 +36,7 @@
  * @{
  */
 #define WSPI_SUPPORTS_MEMMAP                TRUE
+#define WSPI_SUPPORTS_POLLING               TRUE
 #define WSPI_DEFAULT_CFG_MASKS              TRUE
 /** @} */
 
@@ -167,6 +168,15 @@
 #define STM32_WSPI_OCTOSPI2_DMA_IRQ_PRIORITY 10
 #endif
 
+/**
+ * @brief   Automatic polling interval.
+ * @details Number of clock cycles between two status reads performed
+ *          by @p wspiPoll().
+ */
+#if !defined(STM32_WSPI_POLLING_INTERVAL) || defined(__DOXYGEN__)
+#define STM32_WSPI_POLLING_INTERVAL         256
+#endif
+
 /**
  * @brief   OCTOSPI DMA error hook.
  */
@@ -199,6 +209,11 @@
 #error "WSPI driver activated but no OCTOSPI peripheral assigned"
 #endif
 
+#if (STM32_WSPI_POLLING_INTERVAL < 1) ||                                    \
+    (STM32_WSPI_POLLING_INTERVAL > 65535)
+#error "STM32_WSPI_POLLING_INTERVAL out of range"
+#endif
+
 /* Check on OCTOSPI prescaler setting.*/
 #if (STM32_WSPI_OCTOSPI1_PRESCALER_VALUE < 1) ||                            \
     (STM32_WSPI_OCTOSPI1_PRESCALER_VALUE > 256)
@@ -334,6 +349,14 @@ struct hal_wspi_driver {
    * @brief   OCTOSPI DMA mode bit mask.
    */
   uint32_t                  dmamode;
+  /**
+   * @brief   Buffer receiving the matched data of a polling operation.
+   */
+  uint8_t                   *pollbuf;
+  /**
+   * @brief   Size of the polled data.
+   */
+  size_t                    pollsize;
 };
 
 /*===========================================================================*/
@@ -363,6 +386,9 @@ extern "C" {
                      size_t n, const uint8_t *txbuf);
   void wspi_lld_receive(WSPIDriver *wspip, const wspi_command_t *cmdp,
                         size_t n, uint8_t *rxbuf);
+  void wspi_lld_poll(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                     size_t n, uint32_t mask, uint32_t match,
+                     uint8_t *rxbuf);
 #if WSPI_SUPPORTS_MEMMAP == TRUE
   void wspi_lld_map_flash(WSPIDriver *wspip,
                           const wspi_command_t *cmdp,
@@ -90,6 +90,22 @@ static union {
   USBOutEndpointState out;
 } ep0_state;
 
+#if STM32_USB_OTG1_USE_IRQ_THREAD || defined(__DOXYGEN__)
+/**
+ * @brief   OTG1 IRQ thread.
+ */
+static osal_irq_thread_t otg1_irq_thread;
+static OSAL_IRQ_THREAD_WORKING_AREA(otg1_irq_wa);
+#endif
+
+#if STM32_USB_OTG2_USE_IRQ_THREAD || defined(__DOXYGEN__)
+/**
+ * @brief   OTG2 IRQ thread.
+ */
+static osal_irq_thread_t otg2_irq_thread;
+static OSAL_IRQ_THREAD_WORKING_AREA(otg2_irq_wa);
+#endif
+
 /**
  * @brief   Buffer for the EP0 setup packets.
  */
@@ -696,6 +712,27 @@ static void usb_lld_serve_interrupt(USBDriver *usbp) {
   }
 }
 
+#if STM32_USB_OTG1_USE_IRQ_THREAD || STM32_USB_OTG2_USE_IRQ_THREAD ||      \
+    defined(__DOXYGEN__)
+/**
+ * @brief   OTG shared interrupt bottom-half.
+ *
+ * @param[in] p         pointer to the @p USBDriver object
+ *
+ * @notapi
+ */
+static void usb_lld_serve_bh(void *p) {
+  USBDriver *usbp = (USBDriver *)p;
+
+  usb_lld_serve_interrupt(usbp);
+
+  /* OTG interrupts enabled again.*/
+  osalSysLock();
+  usbp->otg->GAHBCFG |= GAHBCFG_GINTMSK;
+  osalSysUnlock();
+}
+#endif
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -710,7 +747,15 @@ OSAL_IRQ_HANDLER(STM32_OTG1_HANDLER) {
 
   OSAL_IRQ_PROLOGUE();
 
+#if STM32_USB_OTG1_USE_IRQ_THREAD
+  /* The OTG interrupts are masked until served by the IRQ thread.*/
+  USBD1.otg->GAHBCFG &= ~GAHBCFG_GINTMSK;
+  osalSysLockFromISR();
+  osalIrqThreadSignalI(&otg1_irq_thread);
+  osalSysUnlockFromISR();
+#else
   usb_lld_serve_interrupt(&USBD1);
+#endif
 
   OSAL_IRQ_EPILOGUE();
 }
@@ -726,7 +771,15 @@ OSAL_IRQ_HANDLER(STM32_OTG2_HANDLER) {
 
   OSAL_IRQ_PROLOGUE();
 
+#if STM32_USB_OTG2_USE_IRQ_THREAD
+  /* The OTG interrupts are masked until served by the IRQ thread.*/
+  USBD2.otg->GAHBCFG &= ~GAHBCFG_GINTMSK;
+  osalSysLockFromISR();
+  osalIrqThreadSignalI(&otg2_irq_thread);
+  osalSysUnlockFromISR();
+#else
   usb_lld_serve_interrupt(&USBD2);
+#endif
 
   OSAL_IRQ_EPILOGUE();
 }
@@ -751,6 +804,9 @@ void usb_lld_init(void) {
 #endif
   USBD1.otg       = OTG_FS;
   USBD1.otgparams = &fsparams;
+#if STM32_USB_OTG1_USE_IRQ_THREAD
+  osalIrqThreadObjectInit(&otg1_irq_thread);
+#endif
 
 #if 0
 #if defined(_CHIBIOS_RT_)
@@ -776,6 +832,9 @@ void usb_lld_init(void) {
 #endif
   USBD2.otg       = OTG_HS;
   USBD2.otgparams = &hsparams;
+#if STM32_USB_OTG2_USE_IRQ_THREAD
+  osalIrqThreadObjectInit(&otg2_irq_thread);
+#endif
 
 #if 0
 #if defined(_CHIBIOS_RT_)
@@ -817,6 +876,12 @@ void usb_lld_start(USBDriver *usbp) {
       rccEnableOTG_FS(true);
       rccResetOTG_FS();
 
+#if STM32_USB_OTG1_USE_IRQ_THREAD
+      osalIrqThreadStartS(&otg1_irq_thread, otg1_irq_wa, sizeof otg1_irq_wa,
+                          OSAL_IRQ_THREAD_PRIORITY, "otg1_irq",
+                          usb_lld_serve_bh, (void *)usbp);
+#endif
+
       /* Enables IRQ vector.*/
       nvicEnableVector(STM32_OTG1_NUMBER, STM32_USB_OTG1_IRQ_PRIORITY);
 
@@ -847,6 +912,12 @@ void usb_lld_start(USBDriver *usbp) {
       rccDisableOTG_HSULPI();
 #endif
 
+#if STM32_USB_OTG2_USE_IRQ_THREAD
+      osalIrqThreadStartS(&otg2_irq_thread, otg2_irq_wa, sizeof otg2_irq_wa,
+                          OSAL_IRQ_THREAD_PRIORITY, "otg2_irq",
+                          usb_lld_serve_bh, (void *)usbp);
+#endif
+
       /* Enables IRQ vector.*/
       nvicEnableVector(STM32_OTG2_NUMBER, STM32_USB_OTG2_IRQ_PRIORITY);
 
@@ -965,6 +1036,20 @@ void usb_lld_stop(USBDriver *usbp) {
   /* If in ready state then disables the USB clock.*/
   if (usbp->state != USB_STOP) {
 
+#if STM32_USB_OTG1_USE_IRQ_THREAD
+    if (&USBD1 == usbp) {
+      /* Waits for a running bottom-half.*/
+      osalIrqThreadStopS(&otg1_irq_thread);
+    }
+#endif
+
+#if STM32_USB_OTG2_USE_IRQ_THREAD
+    if (&USBD2 == usbp) {
+      /* Waits for a running bottom-half.*/
+      osalIrqThreadStopS(&otg2_irq_thread);
+    }
+#endif
+
     /* Disabling all endpoints in case the driver has been stopped while
        active.*/
     otg_disable_ep(usbp);
@@ -1279,8 +1364,15 @@ void usb_lld_start_in(USBDriver *usbp, usbep_t ep) {
     /* Normal case.*/
     uint32_t pcnt = (isp->txsize + usbp->epc[ep]->in_maxsize - 1) /
                     usbp->epc[ep]->in_maxsize;
-    /* TODO: Support more than one packet per frame for isochronous transfers.*/
-    usbp->otg->ie[ep].DIEPTSIZ = DIEPTSIZ_MCNT(1) | DIEPTSIZ_PKTCNT(pcnt) |
+    uint32_t mcnt = 1U;
+
+    /* High bandwidth isochronous endpoints send up to three packets per
+       (micro)frame, the whole transfer is sent in a single frame.*/
+    if ((usbp->epc[ep]->ep_mode & USB_EP_MODE_TYPE) == USB_EP_MODE_TYPE_ISOC) {
+      osalDbgAssert(pcnt <= 3U, "too many packets per frame");
+      mcnt = pcnt;
+    }
+    usbp->otg->ie[ep].DIEPTSIZ = DIEPTSIZ_MCNT(mcnt) | DIEPTSIZ_PKTCNT(pcnt) |
                                  DIEPTSIZ_XFRSIZ(isp->txsize);
   }
 
@@ -84,6 +84,28 @@
 #define STM32_USB_OTG2_IRQ_PRIORITY         14
 #endif
 
+/**
+ * @brief   OTG1 IRQ thread enable switch.
+ * @details If set to @p TRUE the ISR only masks the OTG interrupts, the
+ *          interrupts are served by an IRQ bottom-half thread and the
+ *          driver callbacks are invoked from the thread.
+ * @note    Requires @p OSAL_USE_IRQ_THREADS.
+ */
+#if !defined(STM32_USB_OTG1_USE_IRQ_THREAD) || defined(__DOXYGEN__)
+#define STM32_USB_OTG1_USE_IRQ_THREAD       FALSE
+#endif
+
+/**
+ * @brief   OTG2 IRQ thread enable switch.
+ * @details If set to @p TRUE the ISR only masks the OTG interrupts, the
+ *          interrupts are served by an IRQ bottom-half thread and the
+ *          driver callbacks are invoked from the thread.
+ * @note    Requires @p OSAL_USE_IRQ_THREADS.
+ */
+#if !defined(STM32_USB_OTG2_USE_IRQ_THREAD) || defined(__DOXYGEN__)
+#define STM32_USB_OTG2_USE_IRQ_THREAD       FALSE
+#endif
+
 /**
  * @brief   OTG1 RX shared FIFO size.
  * @note    Must be a multiple of 4.
@@ -227,6 +249,11 @@
 #error "Invalid IRQ priority assigned to OTG2"
 #endif
 
+#if (STM32_USB_OTG1_USE_IRQ_THREAD || STM32_USB_OTG2_USE_IRQ_THREAD) &&      \
+    (OSAL_USE_IRQ_THREADS != TRUE)
+#error "STM32_USB_OTGx_USE_IRQ_THREAD requires OSAL_USE_IRQ_THREADS"
+#endif
+
 #if (STM32_USB_OTG1_RX_FIFO_SIZE & 3) != 0
 #error "OTG1 RX FIFO size must be a multiple of 4"
 #endif
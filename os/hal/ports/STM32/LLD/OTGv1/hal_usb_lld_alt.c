@@ -1277,8 +1277,15 @@ void usb_lld_start_in(USBDriver *usbp, usbep_t ep) {
     /* Normal case.*/
     uint32_t pcnt = (isp->txsize + usbp->epc[ep]->in_maxsize - 1) /
                     usbp->epc[ep]->in_maxsize;
-    /* TODO: Support more than one packet per frame for isochronous transfers.*/
-    usbp->otg->ie[ep].DIEPTSIZ = DIEPTSIZ_MCNT(1) | DIEPTSIZ_PKTCNT(pcnt) |
+    uint32_t mcnt = 1U;
+
+    /* High bandwidth isochronous endpoints send up to three packets per
+       (micro)frame, the whole transfer is sent in a single frame.*/
+    if ((usbp->epc[ep]->ep_mode & USB_EP_MODE_TYPE) == USB_EP_MODE_TYPE_ISOC) {
+      osalDbgAssert(pcnt <= 3U, "too many packets per frame");
+      mcnt = pcnt;
+    }
+    usbp->otg->ie[ep].DIEPTSIZ = DIEPTSIZ_MCNT(mcnt) | DIEPTSIZ_PKTCNT(pcnt) |
                                  DIEPTSIZ_XFRSIZ(isp->txsize);
   }
 
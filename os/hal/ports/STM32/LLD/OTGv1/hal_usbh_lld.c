@@ -0,0 +1,626 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    OTGv1/hal_usbh_lld.c
+ * @brief   STM32 USB Host subsystem low level driver source.
+ * @details The driver uses OTG_HS in host mode with the internal DMA,
+ *          each pipe has a dedicated host channel. Transfers larger than
+ *          a packet are executed as multi-packet DMA transfers and the
+ *          URBs of a chain are started from the channel halt interrupt of
+ *          the previous URB.
+ * @note    OTG_FS is not supported because it has no DMA.
+ * @note    Low speed devices are not supported.
+ *
+ * @addtogroup USBH
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_USBH == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Port reset duration in milliseconds.
+ */
+#define OTG_PORT_RESET_TIME     50U
+
+/**
+ * @brief   Maximum wait for the port enable after reset in milliseconds.
+ */
+#define OTG_PORT_ENABLE_TIME    100U
+
+/**
+ * @brief   HPRT bits cleared or disabling the port when written as one.
+ */
+#define HPRT_W1C_MASK           (HPRT_PENA | HPRT_PCDET | HPRT_PENCHNG |    \
+                                 HPRT_POCCHNG)
+
+#if STM32_OTG_STEPPING == 1
+#define GCCFG_INIT_VALUE        (GCCFG_NOVBUSSENS | GCCFG_PWRDWN)
+#elif STM32_OTG_STEPPING == 2
+#define GCCFG_INIT_VALUE        GCCFG_PWRDWN
+#endif
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief OTG_HS host driver identifier.*/
+#if STM32_USBH_USE_OTG2 || defined(__DOXYGEN__)
+USBHDriver USBHD2;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static void otg_core_reset(USBHDriver *usbhp) {
+  stm32_otg_t *otgp = usbhp->otg;
+
+  osalSysPolledDelayX(32);
+
+  /* Core reset and delay of at least 3 PHY cycles.*/
+  otgp->GRSTCTL = GRSTCTL_CSRST;
+  while ((otgp->GRSTCTL & GRSTCTL_CSRST) != 0)
+    ;
+
+  osalSysPolledDelayX(18);
+
+  /* Wait AHB idle condition.*/
+  while ((otgp->GRSTCTL & GRSTCTL_AHBIDL) == 0)
+    ;
+}
+
+static void otg_fifo_flush(USBHDriver *usbhp) {
+  stm32_otg_t *otgp = usbhp->otg;
+
+  otgp->GRSTCTL = GRSTCTL_TXFNUM(0x10) | GRSTCTL_TXFFLSH;
+  while ((otgp->GRSTCTL & GRSTCTL_TXFFLSH) != 0)
+    ;
+  otgp->GRSTCTL = GRSTCTL_RXFFLSH;
+  while ((otgp->GRSTCTL & GRSTCTL_RXFFLSH) != 0)
+    ;
+  /* Wait for 3 PHY Clocks.*/
+  osalSysPolledDelayX(18);
+}
+
+/**
+ * @brief   Starts an URB or its next chunk on the pipe channel.
+ * @details The channel is programmed for a multi-packet DMA transfer of
+ *          up to @p STM32_USBH_MAX_PACKETS packets, larger URBs are
+ *          transferred in chunks.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] urbp      pointer to the @p USBHURB object
+ *
+ * @notapi
+ */
+static void otg_hc_start(USBHDriver *usbhp, USBHURB *urbp) {
+  USBHPipe *pipe = urbp->pipe;
+  stm32_otg_t *otgp = usbhp->otg;
+  stm32_otg_host_chn_t *hcp = &otgp->hc[pipe->channel];
+  bool in = (pipe->epaddr & USBH_EP_IN) != 0U;
+  uint32_t mps = (uint32_t)pipe->mps;
+  uint32_t n, pcnt, hctsiz, hcchar;
+  uint8_t *buf;
+
+  n = (uint32_t)(urbp->size - urbp->actual);
+  if (n > STM32_USBH_MAX_PACKETS * mps) {
+    n = STM32_USBH_MAX_PACKETS * mps;
+  }
+  pcnt = (n + mps - 1U) / mps;
+  if (pcnt == 0U) {
+    /* Zero length packet.*/
+    pcnt = 1U;
+  }
+
+  /* The forced PID only applies to the first chunk.*/
+  if ((urbp->actual > 0U) || (urbp->pid == USBH_PID_TOGGLE)) {
+    hctsiz = pipe->toggle != 0U ? HCTSIZ_DPID_DATA1 : HCTSIZ_DPID_DATA0;
+  }
+  else if (urbp->pid == USBH_PID_SETUP) {
+    hctsiz = HCTSIZ_DPID_SETUP;
+  }
+  else if (urbp->pid == USBH_PID_DATA1) {
+    hctsiz = HCTSIZ_DPID_DATA1;
+  }
+  else {
+    hctsiz = HCTSIZ_DPID_DATA0;
+  }
+
+  /* Zero length packets still need a valid DMA address.*/
+  if (urbp->buf != NULL) {
+    buf = urbp->buf + urbp->actual;
+  }
+  else {
+    buf = (uint8_t *)usbhp->devbuf;
+  }
+
+  /* IN transfer sizes must be multiple of the packet size.*/
+  if (in) {
+    usbhp->xfrsize = (size_t)(pcnt * mps);
+    cacheDMABeforeRx(buf, n);
+  }
+  else {
+    usbhp->xfrsize = (size_t)n;
+    cacheDMABeforeTx(buf, n);
+  }
+
+  hcchar = HCCHAR_DAD((uint32_t)pipe->devaddr) |
+           HCCHAR_EPTYP((uint32_t)pipe->type) |
+           HCCHAR_EPNUM((uint32_t)pipe->epaddr & 15U) |
+           HCCHAR_MCNT(1U) | HCCHAR_MPS(mps);
+  if (in) {
+    hcchar |= HCCHAR_EPDIR;
+  }
+  if ((pipe->type == USBH_EPTYPE_INTR) && ((otgp->HFNUM & 1U) == 0U)) {
+    hcchar |= HCCHAR_ODDFRM;
+  }
+
+  hcp->HCDMA  = (uint32_t)buf;
+  hcp->HCTSIZ = hctsiz | HCTSIZ_PKTCNT(pcnt) |
+                HCTSIZ_XFRSIZ((uint32_t)usbhp->xfrsize);
+  hcp->HCCHAR = hcchar | HCCHAR_CHENA;
+}
+
+/**
+ * @brief   Requests the halt of all the enabled channels.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @notapi
+ */
+static void otg_hc_halt_all(USBHDriver *usbhp) {
+  stm32_otg_t *otgp = usbhp->otg;
+  unsigned i;
+
+  for (i = 0U; i < STM32_USBH_OTG2_CHANNELS; i++) {
+    if ((otgp->hc[i].HCCHAR & HCCHAR_CHENA) != 0U) {
+      otgp->hc[i].HCCHAR |= HCCHAR_CHDIS;
+    }
+  }
+}
+
+/**
+ * @brief   Channel interrupt handler.
+ * @details In DMA mode only the channel halt interrupt is enabled, the
+ *          halt reason is decoded from the other status bits.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] chn       channel number
+ *
+ * @notapi
+ */
+static void otg_hc_serve(USBHDriver *usbhp, uint32_t chn) {
+  stm32_otg_host_chn_t *hcp = &usbhp->otg->hc[chn];
+  uint32_t hcint = hcp->HCINT;
+  USBHURB *urbp = usbhp->urbp;
+  USBHPipe *pipe;
+  size_t n;
+  msg_t msg;
+
+  hcp->HCINT = hcint;
+
+  /* Halts of aborted transfers are ignored.*/
+  if (((hcint & HCINT_CHH) == 0U) || (urbp == NULL) ||
+      ((uint32_t)urbp->pipe->channel != chn)) {
+    return;
+  }
+
+  pipe = urbp->pipe;
+  if ((hcint & HCINT_XFRC) != 0U) {
+    /* Data toggle of the next transaction as left by the core.*/
+    pipe->toggle = (hcp->HCTSIZ & HCTSIZ_DPID_MASK) == HCTSIZ_DPID_DATA1 ?
+                   1U : 0U;
+
+    if ((pipe->epaddr & USBH_EP_IN) != 0U) {
+      n = usbhp->xfrsize - (size_t)(hcp->HCTSIZ & HCTSIZ_XFRSIZ_MASK);
+      if (urbp->buf != NULL) {
+        cacheDMAAfterRx(urbp->buf + urbp->actual, n);
+      }
+    }
+    else {
+      n = usbhp->xfrsize;
+    }
+    urbp->actual += n;
+
+    /* Next chunk of the same URB unless a short packet ended it.*/
+    if ((n == usbhp->xfrsize) && (urbp->actual < urbp->size)) {
+      otg_hc_start(usbhp, urbp);
+      return;
+    }
+    urbp->status = USBH_URB_OK;
+
+    /* Next URB of the chain, the bus stays busy without returning to the
+       waiting thread.*/
+    if (urbp->next != NULL) {
+      usbhp->urbp = urbp->next;
+      otg_hc_start(usbhp, usbhp->urbp);
+      return;
+    }
+    msg = MSG_OK;
+  }
+  else {
+    urbp->status = (hcint & HCINT_STALL) != 0U ? USBH_URB_STALL :
+                                                 USBH_URB_ERROR;
+    msg = MSG_RESET;
+  }
+
+  osalSysLockFromISR();
+  _usbh_complete_i(usbhp, msg);
+  osalSysUnlockFromISR();
+}
+
+/**
+ * @brief   OTG shared ISR.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @notapi
+ */
+static void usbh_lld_serve_interrupt(USBHDriver *usbhp) {
+  stm32_otg_t *otgp = usbhp->otg;
+  uint32_t sts, hprt, haint;
+  uint32_t i;
+
+  sts = otgp->GINTSTS & otgp->GINTMSK;
+  otgp->GINTSTS = sts;
+
+  /* Device detached, the transfer in progress is aborted.*/
+  if ((sts & GINTSTS_DISCINT) != 0U) {
+    otg_hc_halt_all(usbhp);
+    osalSysLockFromISR();
+    _usbh_disconnected_i(usbhp);
+    osalSysUnlockFromISR();
+  }
+
+  /* Port changes acknowledged without disabling the port.*/
+  if ((sts & GINTSTS_HPRTINT) != 0U) {
+    hprt = otgp->HPRT;
+    otgp->HPRT = (hprt & ~HPRT_W1C_MASK) |
+                 (hprt & (HPRT_PCDET | HPRT_PENCHNG | HPRT_POCCHNG));
+    if ((hprt & HPRT_PCDET) != 0U) {
+      osalSysLockFromISR();
+      _usbh_connected_i(usbhp);
+      osalSysUnlockFromISR();
+    }
+  }
+
+  /* Channels.*/
+  if ((sts & GINTSTS_HCINT) != 0U) {
+    haint = otgp->HAINT & otgp->HAINTMSK;
+    for (i = 0U; i < STM32_USBH_OTG2_CHANNELS; i++) {
+      if ((haint & (1U << i)) != 0U) {
+        otg_hc_serve(usbhp, i);
+      }
+    }
+  }
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+#if STM32_USBH_USE_OTG2 || defined(__DOXYGEN__)
+/**
+ * @brief   OTG2 interrupt handler.
+ *
+ * @isr
+ */
+OSAL_IRQ_HANDLER(STM32_OTG2_HANDLER) {
+
+  OSAL_IRQ_PROLOGUE();
+
+  usbh_lld_serve_interrupt(&USBHD2);
+
+  OSAL_IRQ_EPILOGUE();
+}
+#endif
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level USB host driver initialization.
+ *
+ * @notapi
+ */
+void usbh_lld_init(void) {
+
+#if STM32_USBH_USE_OTG2
+  usbhObjectInit(&USBHD2);
+  USBHD2.otg      = OTG_HS;
+  USBHD2.channels = 0U;
+  USBHD2.xfrsize  = 0U;
+#endif
+}
+
+/**
+ * @brief   Configures and activates the USB host peripheral.
+ * @note    Called without the kernel locked, the function sleeps during
+ *          the mode change.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @notapi
+ */
+void usbh_lld_start(USBHDriver *usbhp) {
+  stm32_otg_t *otgp = usbhp->otg;
+  uint32_t i;
+
+  if (usbhp->state == USBH_STOP) {
+#if STM32_USBH_USE_OTG2
+    if (&USBHD2 == usbhp) {
+      /* OTG HS clock enable and reset.*/
+      rccEnableOTG_HS(true);
+      rccResetOTG_HS();
+
+      /* ULPI clock is managed depending on the presence of an external
+         PHY.*/
+#if defined(BOARD_OTG2_USES_ULPI)
+      rccEnableOTG_HSULPI(true);
+#else
+      rccDisableOTG_HSULPI();
+#endif
+    }
+#endif
+
+    /* PHY enabled.*/
+    otgp->PCGCCTL = 0;
+
+#if defined(BOARD_OTG2_USES_ULPI)
+    /* High speed ULPI PHY.*/
+    otgp->GUSBCFG = 0;
+    otgp->GCCFG   = 0;
+#else
+    /* Internal Full Speed 1.1 PHY.*/
+    otgp->GUSBCFG = GUSBCFG_PHYSEL;
+    otgp->GCCFG   = GCCFG_INIT_VALUE;
+#endif
+
+    /* Soft core reset.*/
+    otg_core_reset(usbhp);
+
+    /* Forced host mode, the mode change takes effect after 25ms.*/
+    otgp->GUSBCFG |= GUSBCFG_FHMOD;
+    osalThreadSleepMilliseconds(25);
+
+#if defined(BOARD_OTG2_USES_ULPI)
+#if STM32_USE_USBH_OTG2_HS
+    otgp->HCFG = 0;
+#else
+    otgp->HCFG = HCFG_FSLSS;
+#endif
+#else
+    /* 48MHz 1.1 PHY.*/
+    otgp->HCFG = HCFG_FSLSS | HCFG_FSLSPCS_48;
+#endif
+
+    /* FIFOs allocation, RX then non-periodic then periodic TX.*/
+    otgp->GRXFSIZ  = GRXFSIZ_RXFD(STM32_USBH_OTG2_RX_FIFO_SIZE / 4);
+    otgp->DIEPTXF0 = ((STM32_USBH_OTG2_NPTX_FIFO_SIZE / 4) << 16) |
+                     (STM32_USBH_OTG2_RX_FIFO_SIZE / 4);
+    otgp->HPTXFSIZ = HPTXFSIZ_PTXFD(STM32_USBH_OTG2_PTX_FIFO_SIZE / 4) |
+                     HPTXFSIZ_PTXSA((STM32_USBH_OTG2_RX_FIFO_SIZE +
+                                     STM32_USBH_OTG2_NPTX_FIFO_SIZE) / 4);
+    otg_fifo_flush(usbhp);
+
+    /* All channels disabled.*/
+    for (i = 0U; i < STM32_USBH_OTG2_CHANNELS; i++) {
+      otgp->hc[i].HCINTMSK = 0U;
+      otgp->hc[i].HCINT    = 0xFFFFFFFFU;
+    }
+    otgp->HAINTMSK  = 0U;
+    usbhp->channels = 0U;
+
+    /* Port power, the board VBUS switch is driven by the callback.*/
+    otgp->HPRT = (otgp->HPRT & ~HPRT_W1C_MASK) | HPRT_PPWR;
+    if (usbhp->config->vbus_cb != NULL) {
+      usbhp->config->vbus_cb(true);
+    }
+
+    /* Clears all pending IRQs, if any, then enables the host interrupts
+       and the DMA with INCR4 bursts.*/
+    otgp->GINTSTS = 0xFFFFFFFFU;
+    otgp->GINTMSK = GINTMSK_DISCM | GINTMSK_HPRTM | GINTMSK_HCM;
+    otgp->GAHBCFG = GAHBCFG_DMAEN | GAHBCFG_HBSTLEN(3U) | GAHBCFG_GINTMSK;
+
+#if STM32_USBH_USE_OTG2
+    if (&USBHD2 == usbhp) {
+      nvicEnableVector(STM32_OTG2_NUMBER, STM32_USBH_OTG2_IRQ_PRIORITY);
+    }
+#endif
+  }
+}
+
+/**
+ * @brief   Deactivates the USB host peripheral.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @notapi
+ */
+void usbh_lld_stop(USBHDriver *usbhp) {
+  stm32_otg_t *otgp = usbhp->otg;
+
+  if (usbhp->state != USBH_STOP) {
+    if (usbhp->config->vbus_cb != NULL) {
+      usbhp->config->vbus_cb(false);
+    }
+
+    /* Port power off and interrupts disabled.*/
+    otgp->HPRT    = 0U;
+    otgp->GAHBCFG = 0U;
+    otgp->GINTMSK = 0U;
+    otgp->GCCFG   = 0U;
+    usbhp->channels = 0U;
+
+#if STM32_USBH_USE_OTG2
+    if (&USBHD2 == usbhp) {
+      nvicDisableVector(STM32_OTG2_NUMBER);
+      rccDisableOTG_HS();
+#if defined(BOARD_OTG2_USES_ULPI)
+      rccDisableOTG_HSULPI();
+#endif
+    }
+#endif
+  }
+}
+
+/**
+ * @brief   Resets the port and detects the device speed.
+ * @note    Called without the kernel locked, the function can sleep.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the port has been enabled.
+ * @retval HAL_FAILED   if the port is not enabled after the reset or a low
+ *                      speed device has been attached.
+ *
+ * @notapi
+ */
+bool usbh_lld_reset_port(USBHDriver *usbhp) {
+  stm32_otg_t *otgp = usbhp->otg;
+  uint32_t i;
+
+  otgp->HPRT = (otgp->HPRT & ~HPRT_W1C_MASK) | HPRT_PRST;
+  osalThreadSleepMilliseconds(OTG_PORT_RESET_TIME);
+  otgp->HPRT = otgp->HPRT & ~(HPRT_W1C_MASK | HPRT_PRST);
+
+  /* Waiting for the port enable at the end of the reset signaling.*/
+  for (i = 0U; i < OTG_PORT_ENABLE_TIME; i++) {
+    if ((otgp->HPRT & HPRT_PENA) != 0U) {
+      break;
+    }
+    osalThreadSleepMilliseconds(1);
+  }
+  if ((otgp->HPRT & HPRT_PENA) == 0U) {
+    return HAL_FAILED;
+  }
+
+  switch (otgp->HPRT & HPRT_PSPD_MASK) {
+  case 0U:
+    usbhp->speed = USBH_SPEED_HIGH;
+    break;
+  case HPRT_PSPD_FS:
+    usbhp->speed = USBH_SPEED_FULL;
+#if !defined(BOARD_OTG2_USES_ULPI)
+    /* Full speed frame interval with the 48MHz PHY clock.*/
+    otgp->HFIR = HFIR_FRIVL(48000U);
+#endif
+    break;
+  default:
+    usbhp->speed = USBH_SPEED_LOW;
+    return HAL_FAILED;
+  }
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Assigns a channel to a pipe.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] pipe      pointer to the @p USBHPipe object
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if a channel has been assigned.
+ * @retval HAL_FAILED   if there are no free channels.
+ *
+ * @notapi
+ */
+bool usbh_lld_open_pipe(USBHDriver *usbhp, USBHPipe *pipe) {
+  stm32_otg_t *otgp = usbhp->otg;
+  uint32_t chn;
+
+  for (chn = 0U; chn < STM32_USBH_OTG2_CHANNELS; chn++) {
+    if ((usbhp->channels & (1U << chn)) == 0U) {
+      usbhp->channels |= 1U << chn;
+      pipe->channel = (uint8_t)chn;
+      otgp->hc[chn].HCINT    = 0xFFFFFFFFU;
+      otgp->hc[chn].HCINTMSK = HCINTMSK_CHHM;
+      otgp->HAINTMSK        |= 1U << chn;
+      return HAL_SUCCESS;
+    }
+  }
+
+  return HAL_FAILED;
+}
+
+/**
+ * @brief   Releases the channel of a pipe.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] pipe      pointer to the @p USBHPipe object
+ *
+ * @notapi
+ */
+void usbh_lld_close_pipe(USBHDriver *usbhp, USBHPipe *pipe) {
+  stm32_otg_t *otgp = usbhp->otg;
+  uint32_t chn = (uint32_t)pipe->channel;
+
+  otgp->HAINTMSK        &= ~(1U << chn);
+  otgp->hc[chn].HCINTMSK = 0U;
+  usbhp->channels       &= ~(1U << chn);
+}
+
+/**
+ * @brief   Starts the URBs chain pointed by @p urbp.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @notapi
+ */
+void usbh_lld_start_transfer(USBHDriver *usbhp) {
+
+  otg_hc_start(usbhp, usbhp->urbp);
+}
+
+/**
+ * @brief   Stops the URB in progress.
+ * @details The channel halts at the end of the current transaction, the
+ *          function waits for the halt.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @notapi
+ */
+void usbh_lld_abort_transfer(USBHDriver *usbhp) {
+  stm32_otg_host_chn_t *hcp;
+
+  if (usbhp->urbp != NULL) {
+    hcp = &usbhp->otg->hc[usbhp->urbp->pipe->channel];
+    if ((hcp->HCCHAR & HCCHAR_CHENA) != 0U) {
+      hcp->HCCHAR |= HCCHAR_CHDIS;
+      while ((hcp->HCCHAR & HCCHAR_CHENA) != 0U)
+        ;
+    }
+    hcp->HCINT = 0xFFFFFFFFU;
+  }
+}
+
+#endif /* HAL_USE_USBH == TRUE */
+
+/** @} */
@@ -0,0 +1,315 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    OTGv1/hal_usbh_lld.h
+ * @brief   STM32 USB Host subsystem low level driver header.
+ *
+ * @addtogroup USBH
+ * @{
+ */
+
+#ifndef HAL_USBH_LLD_H
+#define HAL_USBH_LLD_H
+
+#if (HAL_USE_USBH == TRUE) || defined(__DOXYGEN__)
+
+#include "stm32_otg.h"
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of host channels of OTG_HS.
+ */
+#define STM32_USBH_OTG2_CHANNELS            12U
+
+/**
+ * @brief   Maximum number of packets of a single channel transfer.
+ */
+#define STM32_USBH_MAX_PACKETS              1023U
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   OTG2 host driver enable switch.
+ * @details If set to @p TRUE the support for OTG_HS in host mode is
+ *          included.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_USBH_USE_OTG2) || defined(__DOXYGEN__)
+#define STM32_USBH_USE_OTG2                 FALSE
+#endif
+
+/**
+ * @brief   OTG2 interrupt priority level setting.
+ */
+#if !defined(STM32_USBH_OTG2_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_USBH_OTG2_IRQ_PRIORITY        14
+#endif
+
+/**
+ * @brief   OTG2 RX FIFO size in bytes.
+ * @note    Must be a multiple of 4.
+ */
+#if !defined(STM32_USBH_OTG2_RX_FIFO_SIZE) || defined(__DOXYGEN__)
+#define STM32_USBH_OTG2_RX_FIFO_SIZE        2048
+#endif
+
+/**
+ * @brief   OTG2 non-periodic TX FIFO size in bytes.
+ * @note    Must be a multiple of 4.
+ */
+#if !defined(STM32_USBH_OTG2_NPTX_FIFO_SIZE) || defined(__DOXYGEN__)
+#define STM32_USBH_OTG2_NPTX_FIFO_SIZE      1024
+#endif
+
+/**
+ * @brief   OTG2 periodic TX FIFO size in bytes.
+ * @note    Must be a multiple of 4.
+ */
+#if !defined(STM32_USBH_OTG2_PTX_FIFO_SIZE) || defined(__DOXYGEN__)
+#define STM32_USBH_OTG2_PTX_FIFO_SIZE       1024
+#endif
+
+/**
+ * @brief   Enables HS mode on OTG2 else FS mode.
+ * @note    Has effect only if @p BOARD_OTG2_USES_ULPI is defined.
+ */
+#if !defined(STM32_USE_USBH_OTG2_HS) || defined(__DOXYGEN__)
+#define STM32_USE_USBH_OTG2_HS              TRUE
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !defined(STM32F2XX) && !defined(STM32F4XX) && !defined(STM32F7XX)
+#error "unsupported STM32 platform for the USB host driver"
+#endif
+
+#if !defined(STM32_OTG_STEPPING)
+#error "STM32_OTG_STEPPING not defined in registry"
+#endif
+
+#if STM32_USBH_USE_OTG2 && !STM32_HAS_OTG2
+#error "OTG2 not present in the selected device"
+#endif
+
+#if !STM32_USBH_USE_OTG2
+#error "USBH driver activated but no USB peripheral assigned"
+#endif
+
+#if (HAL_USE_USB == TRUE) && STM32_USB_USE_OTG2
+#error "OTG2 is assigned to both the USB and the USBH drivers"
+#endif
+
+#if !defined(STM32_OTG2_HANDLER) || !defined(STM32_OTG2_NUMBER)
+#error "STM32_OTG2_HANDLER/STM32_OTG2_NUMBER not defined in registry"
+#endif
+
+#if !OSAL_IRQ_IS_VALID_PRIORITY(STM32_USBH_OTG2_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to OTG2"
+#endif
+
+#if ((STM32_USBH_OTG2_RX_FIFO_SIZE & 3) != 0) ||                            \
+    ((STM32_USBH_OTG2_NPTX_FIFO_SIZE & 3) != 0) ||                          \
+    ((STM32_USBH_OTG2_PTX_FIFO_SIZE & 3) != 0)
+#error "OTG2 FIFO sizes must be multiple of 4"
+#endif
+
+#if (STM32_USBH_OTG2_RX_FIFO_SIZE + STM32_USBH_OTG2_NPTX_FIFO_SIZE +        \
+     STM32_USBH_OTG2_PTX_FIFO_SIZE) > (STM32_OTG2_FIFO_MEM_SIZE * 4)
+#error "OTG2 FIFO sizes exceed the FIFO memory"
+#endif
+
+#if STM32_PLL48CLK != 48000000
+#error "the USB host driver requires a 48MHz clock"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Structure representing a pipe to a device endpoint.
+ */
+struct USBHPipe {
+  /**
+   * @brief   Driver owning the pipe.
+   */
+  USBHDriver                *usbhp;
+  /**
+   * @brief   Device address.
+   */
+  uint8_t                   devaddr;
+  /**
+   * @brief   Endpoint address including the direction bit.
+   */
+  uint8_t                   epaddr;
+  /**
+   * @brief   Endpoint type.
+   */
+  uint8_t                   type;
+  /**
+   * @brief   Data toggle of the next transaction.
+   */
+  uint8_t                   toggle;
+  /**
+   * @brief   Endpoint maximum packet size.
+   */
+  uint16_t                  mps;
+  /**
+   * @brief   Pipe open.
+   */
+  bool                      open;
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Assigned host channel.
+   */
+  uint8_t                   channel;
+};
+
+/**
+ * @brief   Driver configuration structure.
+ */
+typedef struct {
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Port power switch callback or @p NULL.
+   * @details Invoked on start and stop for boards with a VBUS switch.
+   */
+  void                      (*vbus_cb)(bool on);
+} USBHConfig;
+
+/**
+ * @brief   Structure representing an USB host driver.
+ */
+struct USBHDriver {
+  /**
+   * @brief   Driver state.
+   */
+  usbhstate_t               state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const USBHConfig          *config;
+  /**
+   * @brief   Attached device speed.
+   */
+  usbhspeed_t               speed;
+  /**
+   * @brief   URB in progress or @p NULL.
+   */
+  USBHURB                   *urbp;
+  /**
+   * @brief   Thread waiting for a transfer or a device attach.
+   */
+  thread_reference_t        thread;
+  /**
+   * @brief   Transfers mutual exclusion.
+   */
+  mutex_t                   mutex;
+  /**
+   * @brief   Attach and detach events source.
+   */
+  event_source_t            event;
+  /**
+   * @brief   Endpoint zero OUT pipe.
+   */
+  USBHPipe                  ep0out;
+  /**
+   * @brief   Endpoint zero IN pipe.
+   */
+  USBHPipe                  ep0in;
+  /**
+   * @brief   Setup packet buffer.
+   */
+  uint32_t                  setupbuf[2];
+  /**
+   * @brief   Device descriptor buffer.
+   */
+  uint32_t                  devbuf[USBH_DEVICE_BUFFER_SIZE / 4U];
+  /**
+   * @brief   Configuration descriptor buffer.
+   */
+  uint32_t                  cfgbuf[USBH_CONFIG_BUFFER_SIZE / 4U];
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Pointer to the OTG peripheral associated to this driver.
+   */
+  stm32_otg_t               *otg;
+  /**
+   * @brief   Allocated channels mask.
+   */
+  uint32_t                  channels;
+  /**
+   * @brief   Size of the transfer programmed on the channel.
+   */
+  size_t                    xfrsize;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Determines if a device is attached to the port.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @return              The attach status.
+ *
+ * @notapi
+ */
+#define usbh_lld_is_connected(usbhp)                                        \
+  (((usbhp)->otg->HPRT & HPRT_PCSTS) != 0U)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if STM32_USBH_USE_OTG2 && !defined(__DOXYGEN__)
+extern USBHDriver USBHD2;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void usbh_lld_init(void);
+  void usbh_lld_start(USBHDriver *usbhp);
+  void usbh_lld_stop(USBHDriver *usbhp);
+  bool usbh_lld_reset_port(USBHDriver *usbhp);
+  bool usbh_lld_open_pipe(USBHDriver *usbhp, USBHPipe *pipe);
+  void usbh_lld_close_pipe(USBHDriver *usbhp, USBHPipe *pipe);
+  void usbh_lld_start_transfer(USBHDriver *usbhp);
+  void usbh_lld_abort_transfer(USBHDriver *usbhp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_USBH == TRUE */
+
+#endif /* HAL_USBH_LLD_H */
+
+/** @} */
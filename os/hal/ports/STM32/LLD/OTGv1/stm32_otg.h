@@ -47,7 +47,8 @@ typedef struct {
                                             register.                       */
   volatile uint32_t HCTSIZ;     /**< @brief Host channel transfer size
                                             register.                       */
-  volatile uint32_t resvd14;
+  volatile uint32_t HCDMA;      /**< @brief Host channel DMA address
+                                            register (HS only).             */
   volatile uint32_t resvd18;
   volatile uint32_t resvd1c;
 } stm32_otg_host_chn_t;
@@ -574,6 +575,8 @@ typedef struct {
 #define HCINT_FRMOR             (1U<<9)     /**< Frame overrun.             */
 #define HCINT_BBERR             (1U<<8)     /**< Babble error.              */
 #define HCINT_TRERR             (1U<<7)     /**< Transaction Error.         */
+#define HCINT_NYET              (1U<<6)     /**< NYET response received
+                                                 interrupt.                 */
 #define HCINT_ACK               (1U<<5)     /**< ACK response
                                                  received/transmitted
                                                  interrupt.                 */
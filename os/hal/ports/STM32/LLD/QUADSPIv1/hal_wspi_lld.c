@@ -77,6 +77,25 @@ static void wspi_lld_serve_dma_interrupt(WSPIDriver *wspip, uint32_t flags) {
  */
 static void wspi_lld_serve_interrupt(WSPIDriver *wspip) {
 
+  /* End of an automatic polling operation, the DMA is not involved and
+     the matched data is in the data register.*/
+  if ((wspip->qspi->CR & QUADSPI_CR_SMIE) != 0U) {
+    uint32_t dr = wspip->qspi->DR;
+
+    wspip->qspi->CR &= ~(QUADSPI_CR_SMIE | QUADSPI_CR_APMS);
+    wspip->qspi->CR |= QUADSPI_CR_DMAEN;
+    if (wspip->pollbuf != NULL) {
+      size_t i;
+
+      for (i = 0U; i < wspip->pollsize; i++) {
+        wspip->pollbuf[i] = (uint8_t)(dr >> (i * 8U));
+      }
+    }
+
+    _wspi_isr_code(wspip);
+    return;
+  }
+
   /* Portable WSPI ISR code defined in the high level driver, note, it is
      a macro.*/
   _wspi_isr_code(wspip);
@@ -292,6 +311,45 @@ void wspi_lld_receive(WSPIDriver *wspip, const wspi_command_t *cmdp,
   dmaStreamEnable(wspip->dma);
 }
 
+/**
+ * @brief   Sends a command then polls data until a match.
+ * @details The QUADSPI automatic polling mode is used, the peripheral
+ *          stops on match and raises an interrupt.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[in] n         number of bytes to receive, from 1 to 4
+ * @param[in] mask      mask of the compared bits
+ * @param[in] match     expected value of the compared bits
+ * @param[out] rxbuf    the pointer to the buffer receiving the matched
+ *                      data or @p NULL
+ *
+ * @notapi
+ */
+void wspi_lld_poll(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                   size_t n, uint32_t mask, uint32_t match,
+                   uint8_t *rxbuf) {
+
+  wspip->pollbuf  = rxbuf;
+  wspip->pollsize = n;
+
+  /* Disabling the DMA request while polling, stop on match.*/
+  wspip->qspi->CR    = (wspip->qspi->CR & ~QUADSPI_CR_DMAEN) |
+                       QUADSPI_CR_APMS | QUADSPI_CR_SMIE;
+  wspip->qspi->PSMKR = mask;
+  wspip->qspi->PSMAR = match;
+  wspip->qspi->PIR   = STM32_WSPI_POLLING_INTERVAL;
+  wspip->qspi->DLR   = n - 1U;
+  wspip->qspi->ABR   = cmdp->alt;
+  wspip->qspi->CCR   = cmdp->cmd | cmdp->cfg |
+                       QUADSPI_CCR_DUMMY_CYCLES(cmdp->dummy) |
+                       QUADSPI_CCR_FMODE_1;
+  if ((cmdp->cfg & WSPI_CFG_ADDR_MODE_MASK) != WSPI_CFG_ADDR_MODE_NONE) {
+    wspip->qspi->AR  = cmdp->addr;
+  }
+}
+
 #if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Maps in memory space a WSPI flash device.
@@ -36,6 +36,7 @@
  * @{
  */
 #define WSPI_SUPPORTS_MEMMAP                TRUE
+#define WSPI_SUPPORTS_POLLING               TRUE
 #define WSPI_DEFAULT_CFG_MASKS              FALSE
 /** @} */
 
@@ -170,6 +171,15 @@
 #define STM32_WSPI_QUADSPI1_DMA_IRQ_PRIORITY 10
 #endif
 
+/**
+ * @brief   Automatic polling interval.
+ * @details Number of clock cycles between two status reads performed
+ *          by @p wspiPoll().
+ */
+#if !defined(STM32_WSPI_POLLING_INTERVAL) || defined(__DOXYGEN__)
+#define STM32_WSPI_POLLING_INTERVAL         256
+#endif
+
 /**
  * @brief   QUADSPI DMA error hook.
  */
@@ -205,6 +215,11 @@
 #error "WSPI driver activated but no QUADSPI peripheral assigned"
 #endif
 
+#if (STM32_WSPI_POLLING_INTERVAL < 1) ||                                    \
+    (STM32_WSPI_POLLING_INTERVAL > 65535)
+#error "STM32_WSPI_POLLING_INTERVAL out of range"
+#endif
+
 #if STM32_WSPI_USE_QUADSPI1 &&                                              \
     !OSAL_IRQ_IS_VALID_PRIORITY(STM32_WSPI_QUADSPI1_IRQ_PRIORITY)
 #error "Invalid IRQ priority assigned to QUADSPI1"
@@ -299,6 +314,14 @@ struct hal_wspi_driver {
    * @brief   QUADSPI DMA mode bit mask.
    */
   uint32_t                  dmamode;
+  /**
+   * @brief   Buffer receiving the matched data of a polling operation.
+   */
+  uint8_t                   *pollbuf;
+  /**
+   * @brief   Size of the polled data.
+   */
+  size_t                    pollsize;
 };
 
 /*===========================================================================*/
@@ -324,6 +347,9 @@ extern "C" {
                      size_t n, const uint8_t *txbuf);
   void wspi_lld_receive(WSPIDriver *wspip, const wspi_command_t *cmdp,
                         size_t n, uint8_t *rxbuf);
+  void wspi_lld_poll(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                     size_t n, uint32_t mask, uint32_t match,
+                     uint8_t *rxbuf);
 #if WSPI_SUPPORTS_MEMMAP == TRUE
   void wspi_lld_map_flash(WSPIDriver *wspip,
                           const wspi_command_t *cmdp,
@@ -51,10 +51,69 @@ static const TRNGConfig default_cfg = {0};
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (STM32_TRNG_USE_POOL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Shared RNG service routine.
+ *
+ * @param[in] trngp      pointer to the @p TRNGDriver object
+ *
+ * @notapi
+ */
+static void trng_lld_serve_interrupt(TRNGDriver *trngp) {
+  uint32_t sr = trngp->rng->SR;
+
+  osalSysLockFromISR();
+
+  if ((sr & (RNG_SR_SEIS | RNG_SR_CEIS)) != 0U) {
+    /* Clearing the error, on a seed error the generator is restarted. The
+       waiting thread, if any, is notified of the failure.*/
+    trngp->rng->SR = 0U;
+    if ((sr & RNG_SR_SEIS) != 0U) {
+      trngp->rng->CR &= ~RNG_CR_RNGEN;
+      trngp->rng->CR |= RNG_CR_RNGEN;
+    }
+    osalThreadResumeI(&trngp->thread, MSG_RESET);
+  }
+  else if ((sr & RNG_SR_DRDY) != 0U) {
+    uint32_t r = trngp->rng->DR;
+
+    /* Data read while a seed error is pending is discarded.*/
+    if (((sr & RNG_SR_SECS) == 0U) &&
+        (trngp->pool_cnt < (size_t)(STM32_TRNG_POOL_SIZE / 4))) {
+      trngp->pool[trngp->pool_cnt++] = r;
+    }
+
+    /* The refill stops when the pool is full.*/
+    if (trngp->pool_cnt >= (size_t)(STM32_TRNG_POOL_SIZE / 4)) {
+      trngp->rng->CR &= ~RNG_CR_IE;
+      osalThreadResumeI(&trngp->thread, MSG_OK);
+    }
+  }
+
+  osalSysUnlockFromISR();
+}
+#endif
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
 
+#if (STM32_TRNG_USE_POOL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   RNG1 interrupt handler.
+ *
+ * @isr
+ */
+OSAL_IRQ_HANDLER(STM32_RNG1_HANDLER) {
+
+  OSAL_IRQ_PROLOGUE();
+
+  trng_lld_serve_interrupt(&TRNGD1);
+
+  OSAL_IRQ_EPILOGUE();
+}
+#endif
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -70,6 +129,10 @@ void trng_lld_init(void) {
   /* Driver initialization.*/
   trngObjectInit(&TRNGD1);
   TRNGD1.rng = RNG;
+#if STM32_TRNG_USE_POOL == TRUE
+  TRNGD1.pool_cnt = 0U;
+  TRNGD1.thread   = NULL;
+#endif
 #endif
 }
 
@@ -92,11 +155,19 @@ void trng_lld_start(TRNGDriver *trngp) {
 #if STM32_TRNG_USE_RNG1 == TRUE
     if (&TRNGD1 == trngp) {
       rccEnableRNG(false);
+#if STM32_TRNG_USE_POOL == TRUE
+      nvicEnableVector(STM32_RNG1_NUMBER, STM32_TRNG_RNG1_IRQ_PRIORITY);
+#endif
     }
 #endif
   }
-  /* Configures the peripheral.*/
+  /* Configures the peripheral, in pool mode the interrupt starts filling
+     the pool immediately.*/
+#if STM32_TRNG_USE_POOL == TRUE
+  trngp->rng->CR |= RNG_CR_RNGEN | RNG_CR_IE;
+#else
   trngp->rng->CR |= RNG_CR_RNGEN;
+#endif
 }
 
 /**
@@ -110,14 +181,24 @@ void trng_lld_stop(TRNGDriver *trngp) {
 
   if (trngp->state == TRNG_READY) {
     /* Resets the peripheral.*/
-    trngp->rng->CR &= ~RNG_CR_RNGEN;
+    trngp->rng->CR &= ~(RNG_CR_RNGEN | RNG_CR_IE);
 
     /* Disables the peripheral.*/
 #if STM32_TRNG_USE_RNG1 == TRUE
     if (&TRNGD1 == trngp) {
+#if STM32_TRNG_USE_POOL == TRUE
+      nvicDisableVector(STM32_RNG1_NUMBER);
+#endif
       rccDisableRNG();
     }
 #endif
+
+#if STM32_TRNG_USE_POOL == TRUE
+    /* The pooled entropy does not survive a restart.*/
+    while (trngp->pool_cnt > 0U) {
+      trngp->pool[--trngp->pool_cnt] = 0U;
+    }
+#endif
   }
 }
 
@@ -125,6 +206,9 @@ void trng_lld_stop(TRNGDriver *trngp) {
  * @brief   True random numbers generator.
  * @note    The function is blocking and likely performs polled waiting
  *          inside the low level implementation.
+ * @note    If @p STM32_TRNG_USE_POOL is enabled then the data is taken
+ *          from the pool and the function waits only for the missing
+ *          data, consumed words are cleared and refilled in background.
  *
  * @param[in] trngp             pointer to the @p TRNGDriver object
  * @param[in] size              size of output buffer
@@ -137,6 +221,40 @@ void trng_lld_stop(TRNGDriver *trngp) {
  */
 bool trng_lld_generate(TRNGDriver *trngp, size_t size, uint8_t *out) {
 
+#if STM32_TRNG_USE_POOL == TRUE
+  osalSysLock();
+  while (size > 0U) {
+    uint32_t r;
+    size_t i;
+
+    if (trngp->pool_cnt == 0U) {
+      /* Pool exhausted, waiting for the interrupt to refill it.*/
+      trngp->rng->CR |= RNG_CR_IE;
+      if (osalThreadSuspendS(&trngp->thread) != MSG_OK) {
+        osalSysUnlock();
+        return true;
+      }
+      continue;
+    }
+
+    trngp->pool_cnt--;
+    r = trngp->pool[trngp->pool_cnt];
+    trngp->pool[trngp->pool_cnt] = 0U;
+
+    /* Writing in the output buffer.*/
+    for (i = 0U; (i < 4U) && (size > 0U); i++) {
+      *out++ = (uint8_t)r;
+      r = r >> 8;
+      size--;
+    }
+  }
+
+  /* Refilling the consumed words.*/
+  trngp->rng->CR |= RNG_CR_IE;
+  osalSysUnlock();
+
+  return false;
+#else
   while (true) {
     uint32_t r, tmo;
     size_t i;
@@ -172,6 +290,7 @@ bool trng_lld_generate(TRNGDriver *trngp, size_t size, uint8_t *out) {
       }
     }
   }
+#endif
 }
 
 #endif /* HAL_USE_TRNG == TRUE */
@@ -63,6 +63,34 @@
 #if !defined(STM32_DATA_FETCH_ATTEMPTS) || defined(__DOXYGEN__)
 #define STM32_DATA_FETCH_ATTEMPTS           1000
 #endif
+
+/**
+ * @brief   TRNGD1 entropy pool enable switch.
+ * @details If set to @p TRUE the RNG interrupt keeps a pool of random words
+ *          filled in background, requests are served from the pool and
+ *          the caller waits only if the pool is exhausted.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_TRNG_USE_POOL) || defined(__DOXYGEN__)
+#define STM32_TRNG_USE_POOL                 FALSE
+#endif
+
+/**
+ * @brief   TRNGD1 entropy pool size in bytes.
+ * @note    Must be a multiple of 4.
+ */
+#if !defined(STM32_TRNG_POOL_SIZE) || defined(__DOXYGEN__)
+#define STM32_TRNG_POOL_SIZE                64
+#endif
+
+/**
+ * @brief   TRNGD1 interrupt priority level setting.
+ * @note    The refill is a background activity, a low priority is
+ *          recommended.
+ */
+#if !defined(STM32_TRNG_RNG1_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_TRNG_RNG1_IRQ_PRIORITY        14
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -89,6 +117,20 @@
 #error "STM32_RNGCLK is not exactly 48000000"
 #endif
 
+#if STM32_TRNG_USE_POOL == TRUE
+#if (STM32_TRNG_POOL_SIZE < 4) || ((STM32_TRNG_POOL_SIZE % 4) != 0)
+#error "STM32_TRNG_POOL_SIZE must be a non-zero multiple of 4"
+#endif
+
+#if !defined(STM32_RNG1_HANDLER) || !defined(STM32_RNG1_NUMBER)
+#error "RNG1 interrupt not defined in this HAL"
+#endif
+
+#if !OSAL_IRQ_IS_VALID_PRIORITY(STM32_TRNG_RNG1_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to RNG1"
+#endif
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -105,27 +147,28 @@ typedef struct {
   uint32_t                   dummy;
 } TRNGConfig;
 
+#if (STM32_TRNG_USE_POOL == TRUE) || defined(__DOXYGEN__)
 /**
- * @brief   Structure representing a TRNG driver.
+ * @brief   Entropy pool @p TRNGDriver fields.
  */
-struct TRNGDriver {
-  /**
-   * @brief Driver state.
-   */
-  trngstate_t                state;
-  /**
-   * @brief Current configuration data.
-   */
-  const TRNGConfig           *config;
-#if defined(TRNG_DRIVER_EXT_FIELDS)
-  TRNG_DRIVER_EXT_FIELDS
+#define _trng_lld_pool_fields                                               \
+  /* Entropy pool.*/                                                        \
+  uint32_t                   pool[STM32_TRNG_POOL_SIZE / 4];                \
+  /* Number of random words in the pool.*/                                  \
+  volatile size_t            pool_cnt;                                      \
+  /* Waiting thread.*/                                                      \
+  thread_reference_t         thread;
+#else
+#define _trng_lld_pool_fields
 #endif
-  /* End of the mandatory fields.*/
-  /**
-    * @brief Pointer to the RNG registers block.
-    */
-  RNG_TypeDef                *rng;
-};
+
+/**
+ * @brief   Implementation-specific @p TRNGDriver fields.
+ */
+#define _trng_lld_driver_fields                                             \
+  /* Pointer to the RNG registers block.*/                                  \
+  RNG_TypeDef                *rng;                                          \
+  _trng_lld_pool_fields
 
 /*===========================================================================*/
 /* Driver macros.                                                            */
@@ -302,6 +302,49 @@ static void sdc_lld_error_cleanup(SDCDriver *sdcp,
     sdc_lld_send_cmd_short_crc(sdcp, MMCSD_CMD_STOP_TRANSMISSION, 0, resp);
 }
 
+#if (SDC_USE_ASYNC_TRANSFERS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Asynchronous transfer end handling.
+ * @details The transfer is finalized and the HAL is notified, errors are
+ *          collected and the transfer stopped if required.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ *
+ * @notapi
+ */
+static void sdc_lld_serve_transfer_interrupt(SDCDriver *sdcp) {
+  uint32_t resp[1];
+  bool result = HAL_SUCCESS;
+
+  sdcp->rqactive = false;
+  if ((sdcp->sdio->STA & SDIO_STA_DATAEND) == 0) {
+    /* The pre-defined length transfer has been interrupted, the card
+       must be explicitly stopped.*/
+    sdc_lld_error_cleanup(sdcp, 2, resp);
+    result = HAL_FAILED;
+  }
+  else {
+#if (defined(STM32F4XX) || defined(STM32F2XX))
+    /* Wait until DMA channel enabled to be sure that all data transferred.*/
+    while (sdcp->dma->stream->CR & STM32_DMA_CR_EN)
+      ;
+
+    /* DMA event flags must be manually cleared.*/
+    dmaStreamClearInterrupt(sdcp->dma);
+#else
+    /* Waits for transfer completion at DMA level, then the stream is
+       disabled and cleared.*/
+    dmaWaitCompletion(sdcp->dma);
+#endif
+
+    sdcp->sdio->ICR = STM32_SDIO_ICR_ALL_FLAGS;
+    sdcp->sdio->DCTRL = 0;
+  }
+
+  _sdc_isr_transfer_code(sdcp, result);
+}
+#endif /* SDC_USE_ASYNC_TRANSFERS == TRUE */
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -326,9 +369,20 @@ OSAL_IRQ_HANDLER(STM32_SDIO_HANDLER) {
      read/write functions needs to check them.*/
   SDIO->MASK = 0;
 
-  osalThreadResumeI(&SDCD1.thread, MSG_OK);
+#if SDC_USE_ASYNC_TRANSFERS == TRUE
+  if (SDCD1.rqactive) {
+    osalSysUnlockFromISR();
 
-  osalSysUnlockFromISR();
+    /* Asynchronous transfers are finalized directly in the ISR.*/
+    sdc_lld_serve_transfer_interrupt(&SDCD1);
+  }
+  else
+#endif
+  {
+    osalThreadResumeI(&SDCD1.thread, MSG_OK);
+
+    osalSysUnlockFromISR();
+  }
 
   OSAL_IRQ_EPILOGUE();
 }
@@ -346,6 +400,9 @@ void sdc_lld_init(void) {
 
   sdcObjectInit(&SDCD1);
   SDCD1.thread = NULL;
+#if SDC_USE_ASYNC_TRANSFERS == TRUE
+  SDCD1.rqactive = false;
+#endif
   SDCD1.dma    = STM32_DMA_STREAM(STM32_SDC_SDIO_DMA_STREAM);
   SDCD1.sdio   = SDIO;
 }
@@ -659,6 +716,150 @@ error:
   return HAL_FAILED;
 }
 
+#if (SDC_USE_ASYNC_TRANSFERS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Reads special registers using data bus after an APP_CMD.
+ * @details Needs only during card detection procedure.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[out] buf      pointer to the read buffer
+ * @param[in] bytes     number of bytes to read
+ * @param[in] cmd       card application command
+ * @param[in] arg       argument for command
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @notapi
+ */
+bool sdc_lld_read_special_app(SDCDriver *sdcp, uint8_t *buf, size_t bytes,
+                              uint8_t cmd, uint32_t arg) {
+  uint32_t resp[1];
+
+  if (sdc_lld_prepare_read_bytes(sdcp, buf, bytes))
+    goto error;
+
+  /* The APP_CMD prefix must immediately precede the command, it is sent
+     after the card state check performed while preparing the transfer.*/
+  if (sdc_lld_send_cmd_short_crc(sdcp, MMCSD_CMD_APP_CMD, sdcp->rca, resp)
+                                 || MMCSD_R1_ERROR(resp[0]))
+    goto error;
+
+  if (sdc_lld_send_cmd_short_crc(sdcp, cmd, arg, resp)
+                                 || MMCSD_R1_ERROR(resp[0]))
+    goto error;
+
+  if (sdc_lld_wait_transaction_end(sdcp, 1, resp))
+    goto error;
+
+  return HAL_SUCCESS;
+
+error:
+  sdc_lld_error_cleanup(sdcp, 1, resp);
+  return HAL_FAILED;
+}
+
+/**
+ * @brief   Starts an asynchronous pre-defined length transfer.
+ * @details The blocks count is set using SET_BLOCK_COUNT so that the
+ *          transfer does not require a STOP_TRANSMISSION command, the
+ *          end is notified by calling @p _sdc_isr_transfer_code() from
+ *          the ISR.
+ * @note    The card must be in transfer state.
+ * @note    This function can be invoked from ISR context.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] rqp       pointer to the transfer request
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation started.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @notapi
+ */
+bool sdc_lld_start_transfer(SDCDriver *sdcp, const SDCRequest *rqp) {
+  uint32_t resp[1];
+  uint32_t startblk = rqp->startblk;
+
+  osalDbgCheck(rqp->n < 0x1000000 / MMCSD_BLOCK_SIZE);
+  osalDbgAssert((((unsigned)rqp->buf & 3) == 0), "unaligned buffer");
+
+  /* Driver handles data in 512 bytes blocks (just like HC cards). But if we
+     have not HC card than we must convert address from blocks to bytes.*/
+  if (!(sdcp->cardmode & SDC_MODE_HIGH_CAPACITY))
+    startblk *= MMCSD_BLOCK_SIZE;
+
+  /* Pre-defined number of blocks.*/
+  if (sdc_lld_send_cmd_short_crc(sdcp, MMCSD_CMD_SET_BLOCK_COUNT,
+                                 rqp->n, resp) || MMCSD_R1_ERROR(resp[0]))
+    goto error;
+
+  /* Prepares the DMA channel.*/
+  dmaStreamSetMemory0(sdcp->dma, rqp->buf);
+  dmaStreamSetTransactionSize(sdcp->dma,
+                              (rqp->n * MMCSD_BLOCK_SIZE) / sizeof (uint32_t));
+  if (rqp->write) {
+    sdcp->sdio->DTIMER = STM32_SDC_WRITE_TIMEOUT;
+    dmaStreamSetMode(sdcp->dma, sdcp->dmamode | STM32_DMA_CR_DIR_M2P);
+  }
+  else {
+    sdcp->sdio->DTIMER = STM32_SDC_READ_TIMEOUT;
+    dmaStreamSetMode(sdcp->dma, sdcp->dmamode | STM32_DMA_CR_DIR_P2M);
+  }
+  dmaStreamEnable(sdcp->dma);
+
+  /* Setting up data transfer, the ISR is informed that the transfer
+     is asynchronous.*/
+  sdcp->rqactive     = true;
+  sdcp->sdio->ICR   = STM32_SDIO_ICR_ALL_FLAGS;
+  sdcp->sdio->DLEN  = rqp->n * MMCSD_BLOCK_SIZE;
+  if (rqp->write) {
+    sdcp->sdio->MASK  = SDIO_MASK_DCRCFAILIE |
+                        SDIO_MASK_DTIMEOUTIE |
+                        SDIO_MASK_STBITERRIE |
+                        SDIO_MASK_TXUNDERRIE |
+                        SDIO_MASK_DATAENDIE;
+
+    /* Talk to card what we want from it.*/
+    if (sdc_lld_send_cmd_short_crc(sdcp, MMCSD_CMD_WRITE_MULTIPLE_BLOCK,
+                                   startblk, resp) || MMCSD_R1_ERROR(resp[0]))
+      goto error;
+
+    /* Transaction starts just after DTEN bit setting.*/
+    sdcp->sdio->DCTRL = SDIO_DCTRL_DBLOCKSIZE_3 |
+                        SDIO_DCTRL_DBLOCKSIZE_0 |
+                        SDIO_DCTRL_DMAEN |
+                        SDIO_DCTRL_DTEN;
+  }
+  else {
+    sdcp->sdio->MASK  = SDIO_MASK_DCRCFAILIE |
+                        SDIO_MASK_DTIMEOUTIE |
+                        SDIO_MASK_STBITERRIE |
+                        SDIO_MASK_RXOVERRIE |
+                        SDIO_MASK_DATAENDIE;
+
+    /* Transaction starts just after DTEN bit setting.*/
+    sdcp->sdio->DCTRL = SDIO_DCTRL_DTDIR |
+                        SDIO_DCTRL_DBLOCKSIZE_3 |
+                        SDIO_DCTRL_DBLOCKSIZE_0 |
+                        SDIO_DCTRL_DMAEN |
+                        SDIO_DCTRL_DTEN;
+
+    if (sdc_lld_send_cmd_short_crc(sdcp, MMCSD_CMD_READ_MULTIPLE_BLOCK,
+                                   startblk, resp) || MMCSD_R1_ERROR(resp[0]))
+      goto error;
+  }
+
+  return HAL_SUCCESS;
+
+error:
+  sdcp->rqactive = false;
+  sdc_lld_error_cleanup(sdcp, 1, resp);
+  return HAL_FAILED;
+}
+#endif /* SDC_USE_ASYNC_TRANSFERS == TRUE */
+
 /**
  * @brief   Reads one or more blocks.
  *
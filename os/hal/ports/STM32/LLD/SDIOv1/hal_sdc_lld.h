@@ -31,6 +31,11 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   This implementation supports the asynchronous transfers.
+ */
+#define SDC_SUPPORTS_ASYNC_TRANSFERS        TRUE
+
 /*
  * The following definitions are missing from some implementations, fixing
  * as zeroed masks.
@@ -281,11 +286,39 @@ struct SDCDriver {
    * @brief Card RCA.
    */
   uint32_t                  rca;
+#if (SDC_USE_ASYNC_TRANSFERS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief Transfer in progress.
+   */
+  SDCRequest                rqcurr;
+  /**
+   * @brief Queued transfer.
+   */
+  SDCRequest                rqnext;
+  /**
+   * @brief A transfer is queued.
+   */
+  bool                      rqqueued;
+  /**
+   * @brief One or more transfers failed.
+   */
+  bool                      rqfailed;
+  /**
+   * @brief Thread waiting for the transfers end.
+   */
+  thread_reference_t        rqthread;
+#endif
   /* End of the mandatory fields.*/
   /**
    * @brief Thread waiting for I/O completion IRQ.
    */
   thread_reference_t        thread;
+#if (SDC_USE_ASYNC_TRANSFERS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief An asynchronous transfer is active.
+   */
+  bool                      rqactive;
+#endif
   /**
    * @brief     DMA mode bit mask.
    */
@@ -337,6 +370,11 @@ extern "C" {
   bool sdc_lld_write(SDCDriver *sdcp, uint32_t startblk,
                      const uint8_t *buf, uint32_t blocks);
   bool sdc_lld_sync(SDCDriver *sdcp);
+#if SDC_USE_ASYNC_TRANSFERS == TRUE
+  bool sdc_lld_read_special_app(SDCDriver *sdcp, uint8_t *buf, size_t bytes,
+                                uint8_t cmd, uint32_t argument);
+  bool sdc_lld_start_transfer(SDCDriver *sdcp, const SDCRequest *rqp);
+#endif
   bool sdc_lld_is_card_inserted(SDCDriver *sdcp);
   bool sdc_lld_is_write_protected(SDCDriver *sdcp);
 #ifdef __cplusplus
@@ -92,12 +92,32 @@ SDCDriver SDCD2;
 /**
  * @brief   Buffer for temporary storage during unaligned transfers.
  */
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+static ALIGNED_VAR(CACHE_LINE_SIZE) union {
+#else
 static union {
+#endif
   uint32_t  alignment;
   uint8_t   buf[MMCSD_BLOCK_SIZE];
 } u;
 #endif /* STM32_SDC_SDMMC_UNALIGNED_SUPPORT */
 
+#if STM32_SDC_SDMMC1_USE_IRQ_THREAD || defined(__DOXYGEN__)
+/**
+ * @brief   SDMMC1 IRQ thread.
+ */
+static osal_irq_thread_t sdc1_irq_thread;
+static OSAL_IRQ_THREAD_WORKING_AREA(sdc1_irq_wa);
+#endif
+
+#if STM32_SDC_SDMMC2_USE_IRQ_THREAD || defined(__DOXYGEN__)
+/**
+ * @brief   SDMMC2 IRQ thread.
+ */
+static osal_irq_thread_t sdc2_irq_thread;
+static OSAL_IRQ_THREAD_WORKING_AREA(sdc2_irq_wa);
+#endif
+
 /**
  * @brief   SDIO default configuration.
  */
@@ -134,6 +154,10 @@ static bool sdc_lld_prepare_read_bytes(SDCDriver *sdcp,
   if (_sdc_wait_for_transfer_state(sdcp))
     return HAL_FAILED;
 
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  cacheDMABeforeRx(buf, bytes);
+#endif
+
   /* Prepares the DMA channel for writing.*/
   dmaStreamSetMemory0(sdcp->dma, buf);
   dmaStreamSetTransactionSize(sdcp->dma, bytes / sizeof (uint32_t));
@@ -325,6 +349,62 @@ static void sdc_lld_error_cleanup(SDCDriver *sdcp,
     sdc_lld_send_cmd_short_crc(sdcp, MMCSD_CMD_STOP_TRANSMISSION, 0, resp);
 }
 
+#if (SDC_USE_ASYNC_TRANSFERS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Asynchronous transfer end handling.
+ * @details The transfer is finalized and the HAL is notified, errors are
+ *          collected and the transfer stopped if required.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ *
+ * @notapi
+ */
+static void sdc_lld_serve_transfer_interrupt(SDCDriver *sdcp) {
+  uint32_t resp[1];
+  bool result = HAL_SUCCESS;
+
+  sdcp->rqactive = false;
+  if ((sdcp->sdmmc->STA & SDMMC_STA_DATAEND) == 0) {
+    /* The pre-defined length transfer has been interrupted, the card
+       must be explicitly stopped.*/
+    sdc_lld_error_cleanup(sdcp, 2, resp);
+    result = HAL_FAILED;
+  }
+  else {
+    /* Waits for transfer completion at DMA level, then the stream is
+       disabled and cleared.*/
+    dmaWaitCompletion(sdcp->dma);
+
+    sdcp->sdmmc->ICR = SDMMC_ICR_ALL_FLAGS;
+    sdcp->sdmmc->DCTRL = 0;
+
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+    /* Making the received data visible.*/
+    if (!sdcp->rqcurr.write) {
+      cacheDMAAfterRx(sdcp->rqcurr.buf, sdcp->rqcurr.n * MMCSD_BLOCK_SIZE);
+    }
+#endif
+  }
+
+  _sdc_isr_transfer_code(sdcp, result);
+}
+
+#if STM32_SDC_SDMMC1_USE_IRQ_THREAD || STM32_SDC_SDMMC2_USE_IRQ_THREAD ||    \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Transfer interrupt bottom-half.
+ *
+ * @param[in] p         pointer to the @p SDCDriver object
+ *
+ * @notapi
+ */
+static void sdc_lld_serve_transfer_bh(void *p) {
+
+  sdc_lld_serve_transfer_interrupt((SDCDriver *)p);
+}
+#endif
+#endif /* SDC_USE_ASYNC_TRANSFERS == TRUE */
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -347,9 +427,27 @@ OSAL_IRQ_HANDLER(STM32_SDMMC1_HANDLER) {
      read/write functions needs to check them.*/
   SDMMC1->MASK = 0;
 
-  osalThreadResumeI(&SDCD1.thread, MSG_OK);
+#if SDC_USE_ASYNC_TRANSFERS == TRUE
+  if (SDCD1.rqactive) {
+#if STM32_SDC_SDMMC1_USE_IRQ_THREAD
+    /* Asynchronous transfers are finalized by the IRQ thread.*/
+    osalIrqThreadSignalI(&sdc1_irq_thread);
 
-  osalSysUnlockFromISR();
+    osalSysUnlockFromISR();
+#else
+    osalSysUnlockFromISR();
+
+    /* Asynchronous transfers are finalized directly in the ISR.*/
+    sdc_lld_serve_transfer_interrupt(&SDCD1);
+#endif
+  }
+  else
+#endif
+  {
+    osalThreadResumeI(&SDCD1.thread, MSG_OK);
+
+    osalSysUnlockFromISR();
+  }
 
   OSAL_IRQ_EPILOGUE();
 }
@@ -373,9 +471,27 @@ OSAL_IRQ_HANDLER(STM32_SDMMC2_HANDLER) {
      read/write functions needs to check them.*/
   SDMMC2->MASK = 0;
 
-  osalThreadResumeI(&SDCD2.thread, MSG_OK);
+#if SDC_USE_ASYNC_TRANSFERS == TRUE
+  if (SDCD2.rqactive) {
+#if STM32_SDC_SDMMC2_USE_IRQ_THREAD
+    /* Asynchronous transfers are finalized by the IRQ thread.*/
+    osalIrqThreadSignalI(&sdc2_irq_thread);
+
+    osalSysUnlockFromISR();
+#else
+    osalSysUnlockFromISR();
 
-  osalSysUnlockFromISR();
+    /* Asynchronous transfers are finalized directly in the ISR.*/
+    sdc_lld_serve_transfer_interrupt(&SDCD2);
+#endif
+  }
+  else
+#endif
+  {
+    osalThreadResumeI(&SDCD2.thread, MSG_OK);
+
+    osalSysUnlockFromISR();
+  }
 
   OSAL_IRQ_EPILOGUE();
 }
@@ -395,20 +511,32 @@ void sdc_lld_init(void) {
 #if STM32_SDC_USE_SDMMC1
   sdcObjectInit(&SDCD1);
   SDCD1.thread = NULL;
+#if SDC_USE_ASYNC_TRANSFERS == TRUE
+  SDCD1.rqactive = false;
+#endif
   SDCD1.rtmo   = SDMMC1_READ_TIMEOUT;
   SDCD1.wtmo   = SDMMC1_WRITE_TIMEOUT;
   SDCD1.dma    = STM32_DMA_STREAM(STM32_SDC_SDMMC1_DMA_STREAM);
   SDCD1.sdmmc  = SDMMC1;
+#if STM32_SDC_SDMMC1_USE_IRQ_THREAD
+  osalIrqThreadObjectInit(&sdc1_irq_thread);
+#endif
   nvicEnableVector(STM32_SDMMC1_NUMBER, STM32_SDC_SDMMC1_IRQ_PRIORITY);
 #endif
 
 #if STM32_SDC_USE_SDMMC2
   sdcObjectInit(&SDCD2);
   SDCD2.thread = NULL;
+#if SDC_USE_ASYNC_TRANSFERS == TRUE
+  SDCD2.rqactive = false;
+#endif
   SDCD2.rtmo   = SDMMC2_READ_TIMEOUT;
   SDCD2.wtmo   = SDMMC2_WRITE_TIMEOUT;
   SDCD2.dma    = STM32_DMA_STREAM(STM32_SDC_SDMMC2_DMA_STREAM);
   SDCD2.sdmmc  = SDMMC2;
+#if STM32_SDC_SDMMC2_USE_IRQ_THREAD
+  osalIrqThreadObjectInit(&sdc2_irq_thread);
+#endif
   nvicEnableVector(STM32_SDMMC2_NUMBER, STM32_SDC_SDMMC2_IRQ_PRIORITY);
 #endif
 }
@@ -454,6 +582,11 @@ void sdc_lld_start(SDCDriver *sdcp) {
                                   STM32_DMA_FCR_FTH_FULL);
 #endif
       rccEnableSDMMC1(true);
+#if STM32_SDC_SDMMC1_USE_IRQ_THREAD
+      osalIrqThreadStartS(&sdc1_irq_thread, sdc1_irq_wa, sizeof sdc1_irq_wa,
+                          OSAL_IRQ_THREAD_PRIORITY, "sdc1_irq",
+                          sdc_lld_serve_transfer_bh, (void *)sdcp);
+#endif
     }
 #endif /* STM32_SDC_USE_SDMMC1 */
 
@@ -472,6 +605,11 @@ void sdc_lld_start(SDCDriver *sdcp) {
                                   STM32_DMA_FCR_FTH_FULL);
 #endif
       rccEnableSDMMC2(true);
+#if STM32_SDC_SDMMC2_USE_IRQ_THREAD
+      osalIrqThreadStartS(&sdc2_irq_thread, sdc2_irq_wa, sizeof sdc2_irq_wa,
+                          OSAL_IRQ_THREAD_PRIORITY, "sdc2_irq",
+                          sdc_lld_serve_transfer_bh, (void *)sdcp);
+#endif
     }
 #endif /* STM32_SDC_USE_SDMMC2 */
   }
@@ -506,12 +644,18 @@ void sdc_lld_stop(SDCDriver *sdcp) {
     /* Clock deactivation.*/
 #if STM32_SDC_USE_SDMMC1
     if (&SDCD1 == sdcp) {
+#if STM32_SDC_SDMMC1_USE_IRQ_THREAD
+      osalIrqThreadStopS(&sdc1_irq_thread);
+#endif
       rccDisableSDMMC1();
     }
 #endif
 
 #if STM32_SDC_USE_SDMMC2
     if (&SDCD2 == sdcp) {
+#if STM32_SDC_SDMMC2_USE_IRQ_THREAD
+      osalIrqThreadStopS(&sdc2_irq_thread);
+#endif
       rccDisableSDMMC2();
     }
 #endif
@@ -545,34 +689,29 @@ void sdc_lld_start_clk(SDCDriver *sdcp) {
  * @notapi
  */
 void sdc_lld_set_data_clk(SDCDriver *sdcp, sdcbusclk_t clk) {
+  uint32_t clkcr = SDMMC_CLKDIV_HS;
+
 #if STM32_SDC_SDMMC_50MHZ && defined(STM32F7XX)
   if (SDC_CLK_50MHz == clk) {
-    sdcp->sdmmc->CLKCR = (sdcp->sdmmc->CLKCR & 0xFFFFFF00U) |
-#if STM32_SDC_SDMMC_PWRSAV
-                         SDMMC_CLKDIV_HS | SDMMC_CLKCR_BYPASS |
-                         SDMMC_CLKCR_PWRSAV;
-#else
-                         SDMMC_CLKDIV_HS | SDMMC_CLKCR_BYPASS;
-#endif
-  }
-  else {
-#if STM32_SDC_SDMMC_PWRSAV
-    sdcp->sdmmc->CLKCR = (sdcp->sdmmc->CLKCR & 0xFFFFFF00U) | SDMMC_CLKDIV_HS |
-                         SDMMC_CLKCR_PWRSAV;
-#else
-    sdcp->sdmmc->CLKCR = (sdcp->sdmmc->CLKCR & 0xFFFFFF00U) | SDMMC_CLKDIV_HS;
-#endif
+    clkcr |= SDMMC_CLKCR_BYPASS;
   }
 #else
   (void)clk;
+#endif
 
 #if STM32_SDC_SDMMC_PWRSAV
-  sdcp->sdmmc->CLKCR = (sdcp->sdmmc->CLKCR & 0xFFFFFF00U) | SDMMC_CLKDIV_HS |
-                       SDMMC_CLKCR_PWRSAV;
-#else
-  sdcp->sdmmc->CLKCR = (sdcp->sdmmc->CLKCR & 0xFFFFFF00U) | SDMMC_CLKDIV_HS;
+  clkcr |= SDMMC_CLKCR_PWRSAV;
 #endif
+
+#if STM32_SDC_SDMMC_HWFC
+  clkcr |= SDMMC_CLKCR_HWFC_EN;
 #endif
+
+  /* Only the clock related fields are replaced.*/
+  sdcp->sdmmc->CLKCR = (sdcp->sdmmc->CLKCR & ~(0x000000FFU |
+                                               SDMMC_CLKCR_BYPASS |
+                                               SDMMC_CLKCR_PWRSAV |
+                                               SDMMC_CLKCR_HWFC_EN)) | clkcr;
 }
 
 /**
@@ -766,6 +905,10 @@ bool sdc_lld_read_special(SDCDriver *sdcp, uint8_t *buf, size_t bytes,
   if (sdc_lld_wait_transaction_end(sdcp, 1, resp))
     goto error;
 
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  cacheDMAAfterRx(buf, bytes);
+#endif
+
   return HAL_SUCCESS;
 
 error:
@@ -773,6 +916,161 @@ error:
   return HAL_FAILED;
 }
 
+#if (SDC_USE_ASYNC_TRANSFERS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Reads special registers using data bus after an APP_CMD.
+ * @details Needs only during card detection procedure.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[out] buf      pointer to the read buffer
+ * @param[in] bytes     number of bytes to read
+ * @param[in] cmd       card application command
+ * @param[in] arg       argument for command
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @notapi
+ */
+bool sdc_lld_read_special_app(SDCDriver *sdcp, uint8_t *buf, size_t bytes,
+                              uint8_t cmd, uint32_t arg) {
+  uint32_t resp[1];
+
+  if (sdc_lld_prepare_read_bytes(sdcp, buf, bytes))
+    goto error;
+
+  /* The APP_CMD prefix must immediately precede the command, it is sent
+     after the card state check performed while preparing the transfer.*/
+  if (sdc_lld_send_cmd_short_crc(sdcp, MMCSD_CMD_APP_CMD, sdcp->rca, resp)
+                                 || MMCSD_R1_ERROR(resp[0]))
+    goto error;
+
+  if (sdc_lld_send_cmd_short_crc(sdcp, cmd, arg, resp)
+                                 || MMCSD_R1_ERROR(resp[0]))
+    goto error;
+
+  if (sdc_lld_wait_transaction_end(sdcp, 1, resp))
+    goto error;
+
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  cacheDMAAfterRx(buf, bytes);
+#endif
+
+  return HAL_SUCCESS;
+
+error:
+  sdc_lld_error_cleanup(sdcp, 1, resp);
+  return HAL_FAILED;
+}
+
+/**
+ * @brief   Starts an asynchronous pre-defined length transfer.
+ * @details The blocks count is set using SET_BLOCK_COUNT so that the
+ *          transfer does not require a STOP_TRANSMISSION command, the
+ *          end is notified by calling @p _sdc_isr_transfer_code() from
+ *          the ISR.
+ * @note    The card must be in transfer state.
+ * @note    This function can be invoked from ISR context.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] rqp       pointer to the transfer request
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation started.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @notapi
+ */
+bool sdc_lld_start_transfer(SDCDriver *sdcp, const SDCRequest *rqp) {
+  uint32_t resp[1];
+  uint32_t startblk = rqp->startblk;
+
+  osalDbgCheck(rqp->n < 0x1000000 / MMCSD_BLOCK_SIZE);
+  osalDbgAssert((((unsigned)rqp->buf & 3) == 0), "unaligned buffer");
+
+  /* Driver handles data in 512 bytes blocks (just like HC cards). But if we
+     have not HC card than we must convert address from blocks to bytes.*/
+  if (!(sdcp->cardmode & SDC_MODE_HIGH_CAPACITY))
+    startblk *= MMCSD_BLOCK_SIZE;
+
+  /* Pre-defined number of blocks.*/
+  if (sdc_lld_send_cmd_short_crc(sdcp, MMCSD_CMD_SET_BLOCK_COUNT,
+                                 rqp->n, resp) || MMCSD_R1_ERROR(resp[0]))
+    goto error;
+
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  if (rqp->write) {
+    cacheDMABeforeTx(rqp->buf, rqp->n * MMCSD_BLOCK_SIZE);
+  }
+  else {
+    cacheDMABeforeRx(rqp->buf, rqp->n * MMCSD_BLOCK_SIZE);
+  }
+#endif
+
+  /* Prepares the DMA channel.*/
+  dmaStreamSetMemory0(sdcp->dma, rqp->buf);
+  dmaStreamSetTransactionSize(sdcp->dma,
+                              (rqp->n * MMCSD_BLOCK_SIZE) / sizeof (uint32_t));
+  if (rqp->write) {
+    sdcp->sdmmc->DTIMER = sdcp->wtmo;
+    dmaStreamSetMode(sdcp->dma, sdcp->dmamode | STM32_DMA_CR_DIR_M2P);
+  }
+  else {
+    sdcp->sdmmc->DTIMER = sdcp->rtmo;
+    dmaStreamSetMode(sdcp->dma, sdcp->dmamode | STM32_DMA_CR_DIR_P2M);
+  }
+  dmaStreamEnable(sdcp->dma);
+
+  /* Setting up data transfer, the ISR is informed that the transfer
+     is asynchronous.*/
+  sdcp->rqactive     = true;
+  sdcp->sdmmc->ICR   = SDMMC_ICR_ALL_FLAGS;
+  sdcp->sdmmc->DLEN  = rqp->n * MMCSD_BLOCK_SIZE;
+  if (rqp->write) {
+    sdcp->sdmmc->MASK  = SDMMC_MASK_DCRCFAILIE |
+                         SDMMC_MASK_DTIMEOUTIE |
+                         SDMMC_MASK_TXUNDERRIE |
+                         SDMMC_MASK_DATAENDIE;
+
+    /* Talk to card what we want from it.*/
+    if (sdc_lld_send_cmd_short_crc(sdcp, MMCSD_CMD_WRITE_MULTIPLE_BLOCK,
+                                   startblk, resp) || MMCSD_R1_ERROR(resp[0]))
+      goto error;
+
+    /* Transaction starts just after DTEN bit setting.*/
+    sdcp->sdmmc->DCTRL = SDMMC_DCTRL_DBLOCKSIZE_3 |
+                         SDMMC_DCTRL_DBLOCKSIZE_0 |
+                         SDMMC_DCTRL_DMAEN |
+                         SDMMC_DCTRL_DTEN;
+  }
+  else {
+    sdcp->sdmmc->MASK  = SDMMC_MASK_DCRCFAILIE |
+                         SDMMC_MASK_DTIMEOUTIE |
+                         SDMMC_MASK_RXOVERRIE |
+                         SDMMC_MASK_DATAENDIE;
+
+    /* Transaction starts just after DTEN bit setting.*/
+    sdcp->sdmmc->DCTRL = SDMMC_DCTRL_DTDIR |
+                         SDMMC_DCTRL_DBLOCKSIZE_3 |
+                         SDMMC_DCTRL_DBLOCKSIZE_0 |
+                         SDMMC_DCTRL_DMAEN |
+                         SDMMC_DCTRL_DTEN;
+
+    if (sdc_lld_send_cmd_short_crc(sdcp, MMCSD_CMD_READ_MULTIPLE_BLOCK,
+                                   startblk, resp) || MMCSD_R1_ERROR(resp[0]))
+      goto error;
+  }
+
+  return HAL_SUCCESS;
+
+error:
+  sdcp->rqactive = false;
+  sdc_lld_error_cleanup(sdcp, 1, resp);
+  return HAL_FAILED;
+}
+#endif /* SDC_USE_ASYNC_TRANSFERS == TRUE */
+
 /**
  * @brief   Reads one or more blocks.
  *
@@ -799,6 +1097,10 @@ bool sdc_lld_read_aligned(SDCDriver *sdcp, uint32_t startblk,
   if (_sdc_wait_for_transfer_state(sdcp))
     return HAL_FAILED;
 
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  cacheDMABeforeRx(buf, blocks * MMCSD_BLOCK_SIZE);
+#endif
+
   /* Prepares the DMA channel for writing.*/
   dmaStreamSetMemory0(sdcp->dma, buf);
   dmaStreamSetTransactionSize(sdcp->dma,
@@ -827,6 +1129,10 @@ bool sdc_lld_read_aligned(SDCDriver *sdcp, uint32_t startblk,
   if (sdc_lld_wait_transaction_end(sdcp, blocks, resp) == true)
     goto error;
 
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  cacheDMAAfterRx(buf, blocks * MMCSD_BLOCK_SIZE);
+#endif
+
   return HAL_SUCCESS;
 
 error:
@@ -860,6 +1166,10 @@ bool sdc_lld_write_aligned(SDCDriver *sdcp, uint32_t startblk,
   if (_sdc_wait_for_transfer_state(sdcp))
     return HAL_FAILED;
 
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  cacheDMABeforeTx(buf, blocks * MMCSD_BLOCK_SIZE);
+#endif
+
   /* Prepares the DMA channel for writing.*/
   dmaStreamSetMemory0(sdcp->dma, buf);
   dmaStreamSetTransactionSize(sdcp->dma,
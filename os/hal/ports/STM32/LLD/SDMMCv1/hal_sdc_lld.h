@@ -31,6 +31,11 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   This implementation supports the asynchronous transfers.
+ */
+#define SDC_SUPPORTS_ASYNC_TRANSFERS        TRUE
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -101,6 +106,17 @@
 #define STM32_SDC_SDMMC_PWRSAV              TRUE
 #endif
 
+/**
+ * @brief   Hardware flow control enable.
+ * @details The card clock is stopped when the FIFO is about to overflow
+ *          or underflow, this prevents overrun and underrun errors when
+ *          the DMA is slowed by other bus masters at high bus clocks.
+ * @note    Check the device errata before enabling it.
+ */
+#if !defined(STM32_SDC_SDMMC_HWFC) || defined(__DOXYGEN__)
+#define STM32_SDC_SDMMC_HWFC                FALSE
+#endif
+
 /**
  * @brief   SDMMC1 DMA priority (0..3|lowest..highest).
  */
@@ -128,6 +144,28 @@
 #if !defined(STM32_SDC_SDMMC2_IRQ_PRIORITY) || defined(__DOXYGEN__)
 #define STM32_SDC_SDMMC2_IRQ_PRIORITY       9
 #endif
+
+/**
+ * @brief   SDMMC1 IRQ thread enable switch.
+ * @details If set to @p TRUE the asynchronous transfers are finalized by
+ *          an IRQ bottom-half thread instead of the ISR, the transfer
+ *          callbacks are invoked from the thread.
+ * @note    Requires @p OSAL_USE_IRQ_THREADS and @p SDC_USE_ASYNC_TRANSFERS.
+ */
+#if !defined(STM32_SDC_SDMMC1_USE_IRQ_THREAD) || defined(__DOXYGEN__)
+#define STM32_SDC_SDMMC1_USE_IRQ_THREAD     FALSE
+#endif
+
+/**
+ * @brief   SDMMC2 IRQ thread enable switch.
+ * @details If set to @p TRUE the asynchronous transfers are finalized by
+ *          an IRQ bottom-half thread instead of the ISR, the transfer
+ *          callbacks are invoked from the thread.
+ * @note    Requires @p OSAL_USE_IRQ_THREADS and @p SDC_USE_ASYNC_TRANSFERS.
+ */
+#if !defined(STM32_SDC_SDMMC2_USE_IRQ_THREAD) || defined(__DOXYGEN__)
+#define STM32_SDC_SDMMC2_USE_IRQ_THREAD     FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -220,6 +258,16 @@
 #error "Invalid DMA priority assigned to SDMMC2"
 #endif
 
+/* IRQ threads checks.*/
+#if STM32_SDC_SDMMC1_USE_IRQ_THREAD || STM32_SDC_SDMMC2_USE_IRQ_THREAD
+#if OSAL_USE_IRQ_THREADS != TRUE
+#error "STM32_SDC_SDMMCx_USE_IRQ_THREAD requires OSAL_USE_IRQ_THREADS"
+#endif
+#if SDC_USE_ASYNC_TRANSFERS != TRUE
+#error "STM32_SDC_SDMMCx_USE_IRQ_THREAD requires SDC_USE_ASYNC_TRANSFERS"
+#endif
+#endif
+
 /* Check on the presence of the DMA streams settings in mcuconf.h.*/
 #if STM32_SDC_USE_SDMMC1 && !defined(STM32_SDC_SDMMC1_DMA_STREAM)
 #error "SDMMC1 DMA streams not defined"
@@ -324,11 +372,39 @@ struct SDCDriver {
    * @brief Card RCA.
    */
   uint32_t                  rca;
+#if (SDC_USE_ASYNC_TRANSFERS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief Transfer in progress.
+   */
+  SDCRequest                rqcurr;
+  /**
+   * @brief Queued transfer.
+   */
+  SDCRequest                rqnext;
+  /**
+   * @brief A transfer is queued.
+   */
+  bool                      rqqueued;
+  /**
+   * @brief One or more transfers failed.
+   */
+  bool                      rqfailed;
+  /**
+   * @brief Thread waiting for the transfers end.
+   */
+  thread_reference_t        rqthread;
+#endif
   /* End of the mandatory fields.*/
   /**
    * @brief Thread waiting for I/O completion IRQ.
    */
   thread_reference_t        thread;
+#if (SDC_USE_ASYNC_TRANSFERS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief An asynchronous transfer is active.
+   */
+  bool                      rqactive;
+#endif
   /**
    * @brief     DTIMER register value for read operations.
    */
@@ -392,6 +468,11 @@ extern "C" {
   bool sdc_lld_write(SDCDriver *sdcp, uint32_t startblk,
                      const uint8_t *buf, uint32_t blocks);
   bool sdc_lld_sync(SDCDriver *sdcp);
+#if SDC_USE_ASYNC_TRANSFERS == TRUE
+  bool sdc_lld_read_special_app(SDCDriver *sdcp, uint8_t *buf, size_t bytes,
+                                uint8_t cmd, uint32_t argument);
+  bool sdc_lld_start_transfer(SDCDriver *sdcp, const SDCRequest *rqp);
+#endif
   bool sdc_lld_is_card_inserted(SDCDriver *sdcp);
   bool sdc_lld_is_write_protected(SDCDriver *sdcp);
 #ifdef __cplusplus
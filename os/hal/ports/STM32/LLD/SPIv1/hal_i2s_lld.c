@@ -38,37 +38,52 @@
   STM32_DMA_GETCHANNEL(STM32_I2S_SPI1_TX_DMA_STREAM,                        \
                        STM32_SPI1_TX_DMA_CHN)
 
+#if STM32_I2S_TX_ENABLED(STM32_I2S_SPI2_MODE)
+#define I2S2_RX_DMA_CHANNEL                                                 \
+  STM32_DMA_GETCHANNEL(STM32_I2S_SPI2_RX_DMA_STREAM,                        \
+                       STM32_SPI2_I2SEXT_RX_DMA_CHN)
+#else
 #define I2S2_RX_DMA_CHANNEL                                                 \
   STM32_DMA_GETCHANNEL(STM32_I2S_SPI2_RX_DMA_STREAM,                        \
                        STM32_SPI2_RX_DMA_CHN)
+#endif
 
 #define I2S2_TX_DMA_CHANNEL                                                 \
   STM32_DMA_GETCHANNEL(STM32_I2S_SPI2_TX_DMA_STREAM,                        \
                        STM32_SPI2_TX_DMA_CHN)
 
+#if STM32_I2S_TX_ENABLED(STM32_I2S_SPI3_MODE)
+#define I2S3_RX_DMA_CHANNEL                                                 \
+  STM32_DMA_GETCHANNEL(STM32_I2S_SPI3_RX_DMA_STREAM,                        \
+                       STM32_SPI3_I2SEXT_RX_DMA_CHN)
+#else
 #define I2S3_RX_DMA_CHANNEL                                                 \
   STM32_DMA_GETCHANNEL(STM32_I2S_SPI3_RX_DMA_STREAM,                        \
                        STM32_SPI3_RX_DMA_CHN)
+#endif
 
 #define I2S3_TX_DMA_CHANNEL                                                 \
   STM32_DMA_GETCHANNEL(STM32_I2S_SPI3_TX_DMA_STREAM,                        \
                        STM32_SPI3_TX_DMA_CHN)
 
+/* In full duplex mode the SPI is the transmitter and the I2Sxext block,
+   always slave, is the receiver.*/
+#define I2S_RX_PORT(i2sp)                                                   \
+  ((i2sp)->ext != NULL ? (i2sp)->ext : (i2sp)->spi)
+
 /*
  * Static I2S settings for I2S1.
  */
 #if !STM32_I2S_IS_MASTER(STM32_I2S_SPI1_MODE)
 #if STM32_I2S_TX_ENABLED(STM32_I2S_SPI1_MODE)
 #define STM32_I2S1_CFGR_CFG                 0
-#endif
-#if STM32_I2S_RX_ENABLED(STM32_I2S_SPI1_MODE)
+#elif STM32_I2S_RX_ENABLED(STM32_I2S_SPI1_MODE)
 #define STM32_I2S1_CFGR_CFG                 SPI_I2SCFGR_I2SCFG_0
 #endif
 #else /* !STM32_I2S_IS_MASTER(STM32_I2S_SPI1_MODE) */
 #if STM32_I2S_TX_ENABLED(STM32_I2S_SPI1_MODE)
 #define STM32_I2S1_CFGR_CFG                 SPI_I2SCFGR_I2SCFG_1
-#endif
-#if STM32_I2S_RX_ENABLED(STM32_I2S_SPI1_MODE)
+#elif STM32_I2S_RX_ENABLED(STM32_I2S_SPI1_MODE)
 #define STM32_I2S1_CFGR_CFG                 (SPI_I2SCFGR_I2SCFG_1 |         \
                                              SPI_I2SCFGR_I2SCFG_0)
 #endif
@@ -80,15 +95,13 @@
 #if !STM32_I2S_IS_MASTER(STM32_I2S_SPI2_MODE)
 #if STM32_I2S_TX_ENABLED(STM32_I2S_SPI2_MODE)
 #define STM32_I2S2_CFGR_CFG                 0
-#endif
-#if STM32_I2S_RX_ENABLED(STM32_I2S_SPI2_MODE)
+#elif STM32_I2S_RX_ENABLED(STM32_I2S_SPI2_MODE)
 #define STM32_I2S2_CFGR_CFG                 SPI_I2SCFGR_I2SCFG_0
 #endif
 #else /* !STM32_I2S_IS_MASTER(STM32_I2S_SPI2_MODE) */
 #if STM32_I2S_TX_ENABLED(STM32_I2S_SPI2_MODE)
 #define STM32_I2S2_CFGR_CFG                 SPI_I2SCFGR_I2SCFG_1
-#endif
-#if STM32_I2S_RX_ENABLED(STM32_I2S_SPI2_MODE)
+#elif STM32_I2S_RX_ENABLED(STM32_I2S_SPI2_MODE)
 #define STM32_I2S2_CFGR_CFG                 (SPI_I2SCFGR_I2SCFG_1 |         \
                                              SPI_I2SCFGR_I2SCFG_0)
 #endif
@@ -100,15 +113,13 @@
 #if !STM32_I2S_IS_MASTER(STM32_I2S_SPI3_MODE)
 #if STM32_I2S_TX_ENABLED(STM32_I2S_SPI3_MODE)
 #define STM32_I2S3_CFGR_CFG                 0
-#endif
-#if STM32_I2S_RX_ENABLED(STM32_I2S_SPI3_MODE)
+#elif STM32_I2S_RX_ENABLED(STM32_I2S_SPI3_MODE)
 #define STM32_I2S3_CFGR_CFG                 SPI_I2SCFGR_I2SCFG_0
 #endif
 #else /* !STM32_I2S_IS_MASTER(STM32_I2S_SPI3_MODE) */
 #if STM32_I2S_TX_ENABLED(STM32_I2S_SPI3_MODE)
 #define STM32_I2S3_CFGR_CFG                 SPI_I2SCFGR_I2SCFG_1
-#endif
-#if STM32_I2S_RX_ENABLED(STM32_I2S_SPI3_MODE)
+#elif STM32_I2S_RX_ENABLED(STM32_I2S_SPI3_MODE)
 #define STM32_I2S3_CFGR_CFG                 (SPI_I2SCFGR_I2SCFG_1 |         \
                                              SPI_I2SCFGR_I2SCFG_0)
 #endif
@@ -161,6 +172,30 @@ static void i2s_lld_serve_rx_interrupt(I2SDriver *i2sp, uint32_t flags) {
   }
 #endif
 
+#if I2S_USE_STREAMING == TRUE
+  /* Streaming on buffers queues, the DMA is in double buffer mode and
+     already switched memory, the idle one is programmed with the next
+     buffer.*/
+  if ((i2sp->dmarx->stream->CR & STM32_DMA_CR_DBM) != 0U) {
+    if ((flags & STM32_DMA_ISR_TCIF) != 0U) {
+      uint32_t ct = dmaStreamGetCurrentTarget(i2sp->dmarx);
+      uint8_t *bp;
+
+      osalSysLockFromISR();
+      bp = _i2s_rx_block(i2sp, i2sp->rxbuf[ct ^ 1U], i2sp->rxbuf[ct]);
+      osalSysUnlockFromISR();
+      i2sp->rxbuf[ct ^ 1U] = bp;
+      if (ct == 0U) {
+        dmaStreamSetMemory1(i2sp->dmarx, bp);
+      }
+      else {
+        dmaStreamSetMemory0(i2sp->dmarx, bp);
+      }
+    }
+    return;
+  }
+#endif
+
   /* Callbacks handling, note it is portable code defined in the high
      level driver.*/
   if ((flags & STM32_DMA_ISR_TCIF) != 0) {
@@ -194,6 +229,30 @@ static void i2s_lld_serve_tx_interrupt(I2SDriver *i2sp, uint32_t flags) {
   }
 #endif
 
+#if I2S_USE_STREAMING == TRUE
+  /* Streaming on buffers queues, the DMA is in double buffer mode and
+     already switched memory, the idle one is programmed with the next
+     buffer.*/
+  if ((i2sp->dmatx->stream->CR & STM32_DMA_CR_DBM) != 0U) {
+    if ((flags & STM32_DMA_ISR_TCIF) != 0U) {
+      uint32_t ct = dmaStreamGetCurrentTarget(i2sp->dmatx);
+      const uint8_t *bp;
+
+      osalSysLockFromISR();
+      bp = _i2s_tx_block(i2sp, i2sp->txbuf[ct ^ 1U], i2sp->txbuf[ct]);
+      osalSysUnlockFromISR();
+      i2sp->txbuf[ct ^ 1U] = bp;
+      if (ct == 0U) {
+        dmaStreamSetMemory1(i2sp->dmatx, bp);
+      }
+      else {
+        dmaStreamSetMemory0(i2sp->dmatx, bp);
+      }
+    }
+    return;
+  }
+#endif
+
   /* Callbacks handling, note it is portable code defined in the high
      level driver.*/
   if ((flags & STM32_DMA_ISR_TCIF) != 0) {
@@ -225,6 +284,7 @@ void i2s_lld_init(void) {
 #if STM32_I2S_USE_SPI1
   i2sObjectInit(&I2SD1);
   I2SD1.spi       = SPI1;
+  I2SD1.ext       = NULL;
   I2SD1.cfg       = STM32_I2S1_CFGR_CFG;
 #if STM32_I2S_RX_ENABLED(STM32_I2S_SPI1_MODE)
   I2SD1.dmarx     = STM32_DMA_STREAM(STM32_I2S_SPI1_RX_DMA_STREAM);
@@ -265,6 +325,12 @@ void i2s_lld_init(void) {
 #if STM32_I2S_USE_SPI2
   i2sObjectInit(&I2SD2);
   I2SD2.spi       = SPI2;
+#if STM32_I2S_RX_ENABLED(STM32_I2S_SPI2_MODE) &&                            \
+    STM32_I2S_TX_ENABLED(STM32_I2S_SPI2_MODE)
+  I2SD2.ext       = I2S2ext;
+#else
+  I2SD2.ext       = NULL;
+#endif
   I2SD2.cfg       = STM32_I2S2_CFGR_CFG;
 #if STM32_I2S_RX_ENABLED(STM32_I2S_SPI2_MODE)
   I2SD2.dmarx     = STM32_DMA_STREAM(STM32_I2S_SPI2_RX_DMA_STREAM);
@@ -305,6 +371,12 @@ void i2s_lld_init(void) {
 #if STM32_I2S_USE_SPI3
   i2sObjectInit(&I2SD3);
   I2SD3.spi       = SPI3;
+#if STM32_I2S_RX_ENABLED(STM32_I2S_SPI3_MODE) &&                            \
+    STM32_I2S_TX_ENABLED(STM32_I2S_SPI3_MODE)
+  I2SD3.ext       = I2S3ext;
+#else
+  I2SD3.ext       = NULL;
+#endif
   I2SD3.cfg       = STM32_I2S3_CFGR_CFG;
 #if STM32_I2S_RX_ENABLED(STM32_I2S_SPI3_MODE)
   I2SD3.dmarx     = STM32_DMA_STREAM(STM32_I2S_SPI3_RX_DMA_STREAM);
@@ -405,8 +477,8 @@ void i2s_lld_start(I2SDriver *i2sp) {
 
       /* CRs settings are done here because those never changes until
          the driver is stopped.*/
-      i2sp->spi->CR1 = 0;
-      i2sp->spi->CR2 = SPI_CR2_RXDMAEN;
+      I2S_RX_PORT(i2sp)->CR1 = 0;
+      I2S_RX_PORT(i2sp)->CR2 = SPI_CR2_RXDMAEN;
 #endif
 #if STM32_I2S_TX_ENABLED(STM32_I2S_SPI2_MODE)
       b = dmaStreamAllocate(i2sp->dmatx,
@@ -439,8 +511,8 @@ void i2s_lld_start(I2SDriver *i2sp) {
 
       /* CRs settings are done here because those never changes until
          the driver is stopped.*/
-      i2sp->spi->CR1 = 0;
-      i2sp->spi->CR2 = SPI_CR2_RXDMAEN;
+      I2S_RX_PORT(i2sp)->CR1 = 0;
+      I2S_RX_PORT(i2sp)->CR2 = SPI_CR2_RXDMAEN;
 #endif
 #if STM32_I2S_TX_ENABLED(STM32_I2S_SPI3_MODE)
       b = dmaStreamAllocate(i2sp->dmatx,
@@ -461,6 +533,10 @@ void i2s_lld_start(I2SDriver *i2sp) {
   /* I2S (re)configuration.*/
   i2sp->spi->I2SPR   = i2sp->config->i2spr;
   i2sp->spi->I2SCFGR = i2sp->config->i2scfgr | i2sp->cfg | SPI_I2SCFGR_I2SMOD;
+  if (NULL != i2sp->ext) {
+    i2sp->ext->I2SCFGR = i2sp->config->i2scfgr | SPI_I2SCFGR_I2SCFG_0 |
+                         SPI_I2SCFGR_I2SMOD;
+  }
 }
 
 /**
@@ -477,6 +553,8 @@ void i2s_lld_stop(I2SDriver *i2sp) {
 
     /* SPI disable.*/
     i2sp->spi->CR2 = 0;
+    if (NULL != i2sp->ext)
+      i2sp->ext->CR2 = 0;
     if (NULL != i2sp->dmarx)
       dmaStreamRelease(i2sp->dmarx);
     if (NULL != i2sp->dmatx)
@@ -524,7 +602,7 @@ void i2s_lld_start_exchange(I2SDriver *i2sp) {
   /* RX DMA setup.*/
   if (NULL != i2sp->dmarx) {
     dmaStreamSetMode(i2sp->dmarx, i2sp->rxdmamode);
-    dmaStreamSetPeripheral(i2sp->dmarx, &i2sp->spi->DR);
+    dmaStreamSetPeripheral(i2sp->dmarx, &I2S_RX_PORT(i2sp)->DR);
     dmaStreamSetMemory0(i2sp->dmarx, i2sp->config->rx_buffer);
     dmaStreamSetTransactionSize(i2sp->dmarx, size);
     dmaStreamEnable(i2sp->dmarx);
@@ -539,9 +617,70 @@ void i2s_lld_start_exchange(I2SDriver *i2sp) {
     dmaStreamEnable(i2sp->dmatx);
   }
 
-  /* Starting transfer.*/
+  /* Starting transfer, the I2Sxext slave is enabled first.*/
+  if (NULL != i2sp->ext)
+    i2sp->ext->I2SCFGR |= SPI_I2SCFGR_I2SE;
+  i2sp->spi->I2SCFGR |= SPI_I2SCFGR_I2SE;
+}
+
+#if (I2S_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a I2S streaming on buffers queues.
+ *
+ * @param[in] i2sp      pointer to the @p I2SDriver object
+ *
+ * @notapi
+ */
+void i2s_lld_start_streaming(I2SDriver *i2sp) {
+
+  /* RX DMA setup, double buffer mode on two blocks, the DMA always
+     performs 16 bits accesses.*/
+  if (NULL != i2sp->ibqp) {
+    size_t n = (i2sp->ibqp->bsize - sizeof (size_t)) / 2U;
+
+    osalDbgAssert(NULL != i2sp->dmarx, "RX not enabled");
+    osalDbgAssert((n > 0U) && (n <= 65535U), "invalid block size");
+
+    i2sp->rxbuf[0] = _i2s_rx_block(i2sp, NULL,
+                                   (uint8_t *)i2sp->config->rx_buffer);
+    i2sp->rxbuf[1] = _i2s_rx_block(i2sp, NULL, i2sp->rxbuf[0]);
+    dmaStreamSetMode(i2sp->dmarx,
+                     (i2sp->rxdmamode & ~STM32_DMA_CR_HTIE) |
+                     STM32_DMA_CR_DBM);
+    dmaStreamSetPeripheral(i2sp->dmarx, &I2S_RX_PORT(i2sp)->DR);
+    dmaStreamSetMemory0(i2sp->dmarx, i2sp->rxbuf[0]);
+    dmaStreamSetMemory1(i2sp->dmarx, i2sp->rxbuf[1]);
+    dmaStreamSetTransactionSize(i2sp->dmarx, n);
+    dmaStreamEnable(i2sp->dmarx);
+  }
+
+  /* TX DMA setup.*/
+  if (NULL != i2sp->obqp) {
+    size_t n = (i2sp->obqp->bsize - sizeof (size_t)) / 2U;
+
+    osalDbgAssert(NULL != i2sp->dmatx, "TX not enabled");
+    osalDbgAssert((n > 0U) && (n <= 65535U), "invalid block size");
+
+    i2sp->txbuf[0] = _i2s_tx_block(i2sp, NULL,
+                                   (const uint8_t *)i2sp->config->tx_buffer);
+    i2sp->txbuf[1] = _i2s_tx_block(i2sp, NULL, i2sp->txbuf[0]);
+    dmaStreamSetMode(i2sp->dmatx,
+                     (i2sp->txdmamode & ~STM32_DMA_CR_HTIE) |
+                     STM32_DMA_CR_DBM);
+    dmaStreamSetPeripheral(i2sp->dmatx, &i2sp->spi->DR);
+    dmaStreamSetMemory0(i2sp->dmatx, i2sp->txbuf[0]);
+    dmaStreamSetMemory1(i2sp->dmatx, i2sp->txbuf[1]);
+    dmaStreamSetTransactionSize(i2sp->dmatx, n);
+    dmaStreamEnable(i2sp->dmatx);
+  }
+
+  /* Starting transfer, the I2Sxext slave is enabled first so that both
+     directions start on the same frame.*/
+  if (NULL != i2sp->ext)
+    i2sp->ext->I2SCFGR |= SPI_I2SCFGR_I2SE;
   i2sp->spi->I2SCFGR |= SPI_I2SCFGR_I2SE;
 }
+#endif /* I2S_USE_STREAMING == TRUE */
 
 /**
  * @brief   Stops the ongoing data exchange.
@@ -566,6 +705,8 @@ void i2s_lld_stop_exchange(I2SDriver *i2sp) {
 
   /* Stop SPI/I2S peripheral.*/
   i2sp->spi->I2SCFGR &= ~SPI_I2SCFGR_I2SE;
+  if (NULL != i2sp->ext)
+    i2sp->ext->I2SCFGR &= ~SPI_I2SCFGR_I2SE;
 
   /* Stop RX DMA, if enabled.*/
   if (NULL != i2sp->dmarx)
@@ -52,6 +52,14 @@
 #define STM32_I2S_TX_ENABLED(mode)          ((mode) & STM32_I2S_MODE_TX)
 /** @} */
 
+/**
+ * @brief   Streaming on buffers queues support.
+ * @note    Streaming requires the DMA double buffer mode.
+ */
+#if defined(STM32_DMA_CR_DBM) || defined(__DOXYGEN__)
+#define I2S_SUPPORTS_STREAMING              TRUE
+#endif
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -183,13 +191,29 @@
 #endif
 
 #if STM32_I2S_RX_ENABLED(STM32_I2S_SPI2_MODE) &&                            \
-    STM32_I2S_TX_ENABLED(STM32_I2S_SPI2_MODE)
-#error "I2S2 RX and TX mode not supported in this driver implementation"
+    STM32_I2S_TX_ENABLED(STM32_I2S_SPI2_MODE) &&                            \
+    !STM32_SPI2_I2S_FULLDUPLEX
+#error "I2S2 RX and TX mode not supported in the selected device"
 #endif
 
 #if STM32_I2S_RX_ENABLED(STM32_I2S_SPI3_MODE) &&                            \
-    STM32_I2S_TX_ENABLED(STM32_I2S_SPI3_MODE)
-#error "I2S3 RX and TX mode not supported in this driver implementation"
+    STM32_I2S_TX_ENABLED(STM32_I2S_SPI3_MODE) &&                            \
+    !STM32_SPI3_I2S_FULLDUPLEX
+#error "I2S3 RX and TX mode not supported in the selected device"
+#endif
+
+#if STM32_I2S_USE_SPI2 &&                                                   \
+    STM32_I2S_RX_ENABLED(STM32_I2S_SPI2_MODE) &&                            \
+    STM32_I2S_TX_ENABLED(STM32_I2S_SPI2_MODE) &&                            \
+    !defined(STM32_SPI2_I2SEXT_RX_DMA_CHN)
+#error "STM32_SPI2_I2SEXT_RX_DMA_CHN not defined in registry"
+#endif
+
+#if STM32_I2S_USE_SPI3 &&                                                   \
+    STM32_I2S_RX_ENABLED(STM32_I2S_SPI3_MODE) &&                            \
+    STM32_I2S_TX_ENABLED(STM32_I2S_SPI3_MODE) &&                            \
+    !defined(STM32_SPI3_I2SEXT_RX_DMA_CHN)
+#error "STM32_SPI3_I2SEXT_RX_DMA_CHN not defined in registry"
 #endif
 
 #if STM32_I2S_USE_SPI1 && !STM32_HAS_SPI1
@@ -366,11 +390,34 @@ struct I2SDriver {
    * @brief   Current configuration data.
    */
   const I2SConfig           *config;
+#if (I2S_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Input buffers queue or @p NULL.
+   */
+  input_buffers_queue_t     *ibqp;
+  /**
+   * @brief   Output buffers queue or @p NULL.
+   */
+  output_buffers_queue_t    *obqp;
+  /**
+   * @brief   Dropped received blocks counter.
+   */
+  volatile size_t           overruns;
+  /**
+   * @brief   Transmitted silence blocks counter.
+   */
+  volatile size_t           underruns;
+#endif
   /* End of the mandatory fields.*/
   /**
    * @brief   Pointer to the SPIx registers block.
    */
   SPI_TypeDef               *spi;
+  /**
+   * @brief   Pointer to the I2Sxext registers block or @p NULL.
+   * @details In full duplex mode the extension block is the receiver.
+   */
+  SPI_TypeDef               *ext;
   /**
    * @brief   Calculated part of the I2SCFGR register.
    */
@@ -391,6 +438,16 @@ struct I2SDriver {
    * @brief   TX DMA mode bit mask.
    */
   uint32_t                  txdmamode;
+#if (I2S_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Buffers in the RX DMA memory registers while streaming.
+   */
+  uint8_t                   *rxbuf[2];
+  /**
+   * @brief   Buffers in the TX DMA memory registers while streaming.
+   */
+  const uint8_t             *txbuf[2];
+#endif
 };
 
 /*===========================================================================*/
@@ -421,6 +478,9 @@ extern "C" {
   void i2s_lld_stop(I2SDriver *i2sp);
   void i2s_lld_start_exchange(I2SDriver *i2sp);
   void i2s_lld_stop_exchange(I2SDriver *i2sp);
+#if I2S_USE_STREAMING == TRUE
+  void i2s_lld_start_streaming(I2SDriver *i2sp);
+#endif
 #ifdef __cplusplus
 }
 #endif
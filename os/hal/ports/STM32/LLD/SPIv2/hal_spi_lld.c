@@ -123,6 +123,37 @@ static uint16_t dummyrx;
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (CACHE_DMA_MAINTENANCE_ENABLED == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Prepares the cache for a DMA operation.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of frames
+ * @param[in] txbuf     the pointer to the transmit buffer or @p NULL
+ * @param[in] rxbuf     the pointer to the receive buffer or @p NULL
+ */
+static void spi_lld_cache_prepare(SPIDriver *spip, size_t n,
+                                  const void *txbuf, void *rxbuf) {
+  size_t size;
+
+  if ((spip->rxdmamode & STM32_DMA_CR_MSIZE_MASK) == STM32_DMA_CR_MSIZE_BYTE) {
+    size = n;
+  }
+  else {
+    size = n * 2U;
+  }
+
+  if (txbuf != NULL) {
+    cacheDMABeforeTx(txbuf, size);
+  }
+  if (rxbuf != NULL) {
+    cacheDMABeforeRx(rxbuf, size);
+  }
+  spip->rxbuf  = (uint8_t *)rxbuf;
+  spip->rxsize = rxbuf != NULL ? size : 0U;
+}
+#endif
+
 /**
  * @brief   Shared end-of-rx service routine.
  *
@@ -143,10 +174,17 @@ static void spi_lld_serve_rx_interrupt(SPIDriver *spip, uint32_t flags) {
   if (spip->config->circular) {
     if ((flags & STM32_DMA_ISR_HTIF) != 0U) {
       /* Half buffer interrupt.*/
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+      cacheDMAAfterRx(spip->rxbuf, spip->rxsize / 2U);
+#endif
       _spi_isr_code_half1(spip);
     }
     else {
       /* End buffer interrupt.*/
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+      cacheDMAAfterRx(spip->rxbuf + (spip->rxsize / 2U),
+                      spip->rxsize - (spip->rxsize / 2U));
+#endif
       _spi_isr_code_half2(spip);
     }
   }
@@ -155,6 +193,11 @@ static void spi_lld_serve_rx_interrupt(SPIDriver *spip, uint32_t flags) {
     dmaStreamDisable(spip->dmatx);
     dmaStreamDisable(spip->dmarx);
 
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+    /* Making the received data visible.*/
+    cacheDMAAfterRx(spip->rxbuf, spip->rxsize);
+#endif
+
     /* Portable SPI ISR code defined in the high level driver, note, it is
        a macro.*/
     _spi_isr_code(spip);
@@ -595,6 +638,10 @@ void spi_lld_ignore(SPIDriver *spip, size_t n) {
 
   osalDbgAssert(n < 65536, "unsupported DMA transfer size");
 
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  spi_lld_cache_prepare(spip, n, NULL, NULL);
+#endif
+
   dmaStreamSetMemory0(spip->dmarx, &dummyrx);
   dmaStreamSetTransactionSize(spip->dmarx, n);
   dmaStreamSetMode(spip->dmarx, spip->rxdmamode);
@@ -627,6 +674,10 @@ void spi_lld_exchange(SPIDriver *spip, size_t n,
 
   osalDbgAssert(n < 65536, "unsupported DMA transfer size");
 
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  spi_lld_cache_prepare(spip, n, txbuf, rxbuf);
+#endif
+
   dmaStreamSetMemory0(spip->dmarx, rxbuf);
   dmaStreamSetTransactionSize(spip->dmarx, n);
   dmaStreamSetMode(spip->dmarx, spip->rxdmamode | STM32_DMA_CR_MINC);
@@ -656,6 +707,10 @@ void spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf) {
 
   osalDbgAssert(n < 65536, "unsupported DMA transfer size");
 
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  spi_lld_cache_prepare(spip, n, txbuf, NULL);
+#endif
+
   dmaStreamSetMemory0(spip->dmarx, &dummyrx);
   dmaStreamSetTransactionSize(spip->dmarx, n);
   dmaStreamSetMode(spip->dmarx, spip->rxdmamode);
@@ -685,6 +740,10 @@ void spi_lld_receive(SPIDriver *spip, size_t n, void *rxbuf) {
 
   osalDbgAssert(n < 65536, "unsupported DMA transfer size");
 
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  spi_lld_cache_prepare(spip, n, NULL, rxbuf);
+#endif
+
   dmaStreamSetMemory0(spip->dmarx, rxbuf);
   dmaStreamSetTransactionSize(spip->dmarx, n);
   dmaStreamSetMode(spip->dmarx, spip->rxdmamode | STM32_DMA_CR_MINC);
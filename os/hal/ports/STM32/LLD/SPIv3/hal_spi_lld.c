@@ -75,6 +75,41 @@ static uint32_t dummyrx;
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (CACHE_DMA_MAINTENANCE_ENABLED == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Prepares the cache for a DMA operation.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of frames
+ * @param[in] txbuf     the pointer to the transmit buffer or @p NULL
+ * @param[in] rxbuf     the pointer to the receive buffer or @p NULL
+ */
+static void spi_lld_cache_prepare(SPIDriver *spip, size_t n,
+                                  const void *txbuf, void *rxbuf) {
+  uint32_t dsize = (spip->config->cfg1 & SPI_CFG1_DSIZE_Msk) + 1U;
+  size_t size;
+
+  if (dsize <= 8U) {
+    size = n;
+  }
+  else if (dsize <= 16U) {
+    size = n * 2U;
+  }
+  else {
+    size = n * 4U;
+  }
+
+  if (txbuf != NULL) {
+    cacheDMABeforeTx(txbuf, size);
+  }
+  if (rxbuf != NULL) {
+    cacheDMABeforeRx(rxbuf, size);
+  }
+  spip->rxbuf  = (uint8_t *)rxbuf;
+  spip->rxsize = rxbuf != NULL ? size : 0U;
+}
+#endif
+
 #if defined(STM32_SPI_BDMA_REQUIRED)
 /**
  * @brief   Shared DMA end-of-rx service routine.
@@ -96,10 +131,17 @@ static void spi_lld_serve_bdma_rx_interrupt(SPIDriver *spip, uint32_t flags) {
   if (spip->config->circular) {
     if ((flags & STM32_BDMA_ISR_HTIF) != 0U) {
       /* Half buffer interrupt.*/
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+      cacheDMAAfterRx(spip->rxbuf, spip->rxsize / 2U);
+#endif
       _spi_isr_code_half1(spip);
     }
     else {
       /* End buffer interrupt.*/
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+      cacheDMAAfterRx(spip->rxbuf + (spip->rxsize / 2U),
+                      spip->rxsize - (spip->rxsize / 2U));
+#endif
       _spi_isr_code_half2(spip);
     }
   }
@@ -111,6 +153,11 @@ static void spi_lld_serve_bdma_rx_interrupt(SPIDriver *spip, uint32_t flags) {
     bdmaStreamDisable(spip->tx.bdma);
     bdmaStreamDisable(spip->rx.bdma);
 
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+    /* Making the received data visible.*/
+    cacheDMAAfterRx(spip->rxbuf, spip->rxsize);
+#endif
+
     /* Portable SPI ISR code defined in the high level driver, note, it is
        a macro.*/
     _spi_isr_code(spip);
@@ -159,10 +206,17 @@ static void spi_lld_serve_dma_rx_interrupt(SPIDriver *spip, uint32_t flags) {
   if (spip->config->circular) {
     if ((flags & STM32_DMA_ISR_HTIF) != 0U) {
       /* Half buffer interrupt.*/
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+      cacheDMAAfterRx(spip->rxbuf, spip->rxsize / 2U);
+#endif
       _spi_isr_code_half1(spip);
     }
     else {
       /* End buffer interrupt.*/
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+      cacheDMAAfterRx(spip->rxbuf + (spip->rxsize / 2U),
+                      spip->rxsize - (spip->rxsize / 2U));
+#endif
       _spi_isr_code_half2(spip);
     }
   }
@@ -174,6 +228,11 @@ static void spi_lld_serve_dma_rx_interrupt(SPIDriver *spip, uint32_t flags) {
     dmaStreamDisable(spip->tx.dma);
     dmaStreamDisable(spip->rx.dma);
 
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+    /* Making the received data visible.*/
+    cacheDMAAfterRx(spip->rxbuf, spip->rxsize);
+#endif
+
     /* Portable SPI ISR code defined in the high level driver, note, it is
        a macro.*/
     _spi_isr_code(spip);
@@ -826,6 +885,10 @@ void spi_lld_ignore(SPIDriver *spip, size_t n) {
 
   osalDbgAssert(n < 65536, "unsupported DMA transfer size");
 
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  spi_lld_cache_prepare(spip, n, NULL, NULL);
+#endif
+
 #if defined(STM32_SPI_DMA_REQUIRED) && defined(STM32_SPI_BDMA_REQUIRED)
   if(spip->is_bdma)
 #endif
@@ -884,6 +947,10 @@ void spi_lld_exchange(SPIDriver *spip, size_t n,
 
   osalDbgAssert(n < 65536, "unsupported DMA transfer size");
 
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  spi_lld_cache_prepare(spip, n, txbuf, rxbuf);
+#endif
+
 #if defined(STM32_SPI_DMA_REQUIRED) && defined(STM32_SPI_BDMA_REQUIRED)
   if(spip->is_bdma)
 #endif
@@ -939,6 +1006,10 @@ void spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf) {
 
   osalDbgAssert(n < 65536, "unsupported DMA transfer size");
 
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  spi_lld_cache_prepare(spip, n, txbuf, NULL);
+#endif
+
 #if defined(STM32_SPI_DMA_REQUIRED) && defined(STM32_SPI_BDMA_REQUIRED)
   if(spip->is_bdma)
 #endif
@@ -994,6 +1065,10 @@ void spi_lld_receive(SPIDriver *spip, size_t n, void *rxbuf) {
 
   osalDbgAssert(n < 65536, "unsupported DMA transfer size");
 
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  spi_lld_cache_prepare(spip, n, NULL, rxbuf);
+#endif
+
 #if defined(STM32_SPI_DMA_REQUIRED) && defined(STM32_SPI_BDMA_REQUIRED)
   if(spip->is_bdma)
 #endif
@@ -36,6 +36,11 @@
  */
 #define SPI_SUPPORTS_CIRCULAR           TRUE
 
+/**
+ * @brief   Transactions queue support flag.
+ */
+#define SPI_SUPPORTS_TRANSACTIONS       TRUE
+
 /**
  * @name    Register helpers not found in ST headers
  * @{
@@ -592,6 +597,20 @@ struct SPIDriver {
    */
   mutex_t                   mutex;
 #endif /* SPI_USE_MUTUAL_EXCLUSION */
+#if (SPI_USE_TRANSACTIONS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Transaction in progress or @p NULL.
+   */
+  const SPITransaction      *tcurr;
+  /**
+   * @brief   Number of transactions left, the current one included.
+   */
+  size_t                    tleft;
+  /**
+   * @brief   Configuration restored after the last transaction.
+   */
+  const SPIConfig           *tconfig;
+#endif /* SPI_USE_TRANSACTIONS */
 #if defined(SPI_DRIVER_EXT_FIELDS)
   SPI_DRIVER_EXT_FIELDS
 #endif
@@ -648,6 +667,16 @@ struct SPIDriver {
    * @brief   TX DMA mode bit mask.
    */
   uint32_t                  txdmamode;
+#if (CACHE_DMA_MAINTENANCE_ENABLED == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Receive buffer of the current operation.
+   */
+  uint8_t                   *rxbuf;
+  /**
+   * @brief   Size in bytes of the receive buffer of the current operation.
+   */
+  size_t                    rxsize;
+#endif
 };
 
 /*===========================================================================*/
@@ -138,6 +138,60 @@ static bool icu_lld_wait_edge(ICUDriver *icup) {
   return result;
 }
 
+#if STM32_ICU_USE_DMA_FIFO || defined(__DOXYGEN__)
+/**
+ * @brief   Stops the capture FIFO if active.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ *
+ * @notapi
+ */
+static void icu_lld_stop_fifo(ICUDriver *icup) {
+
+  if (icup->fifo != NULL) {
+    icup->tim->DIER &= ~(STM32_TIM_DIER_CC1DE | STM32_TIM_DIER_CC2DE);
+    icup->tim->DCR   = 0;
+    dmaStreamDisable(icup->dmastp);
+    icup->fifo = NULL;
+    osalThreadResumeI(&icup->fifo_thread, MSG_RESET);
+  }
+}
+
+/**
+ * @brief   Capture FIFO DMA ISR service routine.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ * @param[in] flags     pre-shifted content of the ISR register
+ *
+ * @notapi
+ */
+static void icu_lld_serve_dma_interrupt(ICUDriver *icup, uint32_t flags) {
+  uint32_t n;
+
+  /* DMA errors handling.*/
+  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0) {
+    STM32_ICU_DMA_ERROR_HOOK(icup);
+  }
+
+  /* Both flags are found set if the ISR has been delayed by more than a
+     FIFO half, both halves are counted in that case.*/
+  n = 0U;
+  if ((flags & STM32_DMA_ISR_HTIF) != 0) {
+    n++;
+  }
+  if ((flags & STM32_DMA_ISR_TCIF) != 0) {
+    n++;
+  }
+
+  if (n > 0U) {
+    osalSysLockFromISR();
+    icup->fifo_wr += n;
+    osalThreadResumeI(&icup->fifo_thread, MSG_OK);
+    osalSysUnlockFromISR();
+  }
+}
+#endif /* STM32_ICU_USE_DMA_FIFO */
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -338,42 +392,100 @@ void icu_lld_init(void) {
   /* Driver initialization.*/
   icuObjectInit(&ICUD1);
   ICUD1.tim = STM32_TIM1;
+#if STM32_ICU_USE_DMA_FIFO
+#if defined(STM32_ICU_TIM1_DMA_STREAM)
+  ICUD1.dmastp = STM32_DMA_STREAM(STM32_ICU_TIM1_DMA_STREAM);
+  ICUD1.dmachn = STM32_ICU_TIM1_DMA_CHN;
+#else
+  ICUD1.dmastp = NULL;
+#endif
+  ICUD1.fifo   = NULL;
+#endif
 #endif
 
 #if STM32_ICU_USE_TIM2
   /* Driver initialization.*/
   icuObjectInit(&ICUD2);
   ICUD2.tim = STM32_TIM2;
+#if STM32_ICU_USE_DMA_FIFO
+#if defined(STM32_ICU_TIM2_DMA_STREAM)
+  ICUD2.dmastp = STM32_DMA_STREAM(STM32_ICU_TIM2_DMA_STREAM);
+  ICUD2.dmachn = STM32_ICU_TIM2_DMA_CHN;
+#else
+  ICUD2.dmastp = NULL;
+#endif
+  ICUD2.fifo   = NULL;
+#endif
 #endif
 
 #if STM32_ICU_USE_TIM3
   /* Driver initialization.*/
   icuObjectInit(&ICUD3);
   ICUD3.tim = STM32_TIM3;
+#if STM32_ICU_USE_DMA_FIFO
+#if defined(STM32_ICU_TIM3_DMA_STREAM)
+  ICUD3.dmastp = STM32_DMA_STREAM(STM32_ICU_TIM3_DMA_STREAM);
+  ICUD3.dmachn = STM32_ICU_TIM3_DMA_CHN;
+#else
+  ICUD3.dmastp = NULL;
+#endif
+  ICUD3.fifo   = NULL;
+#endif
 #endif
 
 #if STM32_ICU_USE_TIM4
   /* Driver initialization.*/
   icuObjectInit(&ICUD4);
   ICUD4.tim = STM32_TIM4;
+#if STM32_ICU_USE_DMA_FIFO
+#if defined(STM32_ICU_TIM4_DMA_STREAM)
+  ICUD4.dmastp = STM32_DMA_STREAM(STM32_ICU_TIM4_DMA_STREAM);
+  ICUD4.dmachn = STM32_ICU_TIM4_DMA_CHN;
+#else
+  ICUD4.dmastp = NULL;
+#endif
+  ICUD4.fifo   = NULL;
+#endif
 #endif
 
 #if STM32_ICU_USE_TIM5
   /* Driver initialization.*/
   icuObjectInit(&ICUD5);
   ICUD5.tim = STM32_TIM5;
+#if STM32_ICU_USE_DMA_FIFO
+#if defined(STM32_ICU_TIM5_DMA_STREAM)
+  ICUD5.dmastp = STM32_DMA_STREAM(STM32_ICU_TIM5_DMA_STREAM);
+  ICUD5.dmachn = STM32_ICU_TIM5_DMA_CHN;
+#else
+  ICUD5.dmastp = NULL;
+#endif
+  ICUD5.fifo   = NULL;
+#endif
 #endif
 
 #if STM32_ICU_USE_TIM8
   /* Driver initialization.*/
   icuObjectInit(&ICUD8);
   ICUD8.tim = STM32_TIM8;
+#if STM32_ICU_USE_DMA_FIFO
+#if defined(STM32_ICU_TIM8_DMA_STREAM)
+  ICUD8.dmastp = STM32_DMA_STREAM(STM32_ICU_TIM8_DMA_STREAM);
+  ICUD8.dmachn = STM32_ICU_TIM8_DMA_CHN;
+#else
+  ICUD8.dmastp = NULL;
+#endif
+  ICUD8.fifo   = NULL;
+#endif
 #endif
 
 #if STM32_ICU_USE_TIM9
   /* Driver initialization.*/
   icuObjectInit(&ICUD9);
   ICUD9.tim = STM32_TIM9;
+#if STM32_ICU_USE_DMA_FIFO
+  ICUD9.dmastp = NULL;
+  ICUD9.fifo   = NULL;
+#endif
 #endif
 }
 
@@ -401,6 +513,16 @@ void icu_lld_start(ICUDriver *icup) {
       nvicEnableVector(STM32_TIM1_UP_NUMBER, STM32_ICU_TIM1_IRQ_PRIORITY);
       nvicEnableVector(STM32_TIM1_CC_NUMBER, STM32_ICU_TIM1_IRQ_PRIORITY);
 #endif
+#if STM32_ICU_USE_DMA_FIFO && defined(STM32_ICU_TIM1_DMA_STREAM)
+      {
+        bool b;
+        b = dmaStreamAllocate(icup->dmastp,
+                              STM32_ICU_TIM1_IRQ_PRIORITY,
+                              (stm32_dmaisr_t)icu_lld_serve_dma_interrupt,
+                              (void *)icup);
+        osalDbgAssert(!b, "stream already allocated");
+      }
+#endif
 #if defined(STM32_TIM1CLK)
       icup->clock = STM32_TIM1CLK;
 #else
@@ -416,6 +538,16 @@ void icu_lld_start(ICUDriver *icup) {
 #if !defined(STM32_TIM2_SUPPRESS_ISR)
       nvicEnableVector(STM32_TIM2_NUMBER, STM32_ICU_TIM2_IRQ_PRIORITY);
 #endif
+#if STM32_ICU_USE_DMA_FIFO && defined(STM32_ICU_TIM2_DMA_STREAM)
+      {
+        bool b;
+        b = dmaStreamAllocate(icup->dmastp,
+                              STM32_ICU_TIM2_IRQ_PRIORITY,
+                              (stm32_dmaisr_t)icu_lld_serve_dma_interrupt,
+                              (void *)icup);
+        osalDbgAssert(!b, "stream already allocated");
+      }
+#endif
 #if defined(STM32_TIM2CLK)
       icup->clock = STM32_TIM2CLK;
 #else
@@ -431,6 +563,16 @@ void icu_lld_start(ICUDriver *icup) {
 #if !defined(STM32_TIM3_SUPPRESS_ISR)
       nvicEnableVector(STM32_TIM3_NUMBER, STM32_ICU_TIM3_IRQ_PRIORITY);
 #endif
+#if STM32_ICU_USE_DMA_FIFO && defined(STM32_ICU_TIM3_DMA_STREAM)
+      {
+        bool b;
+        b = dmaStreamAllocate(icup->dmastp,
+                              STM32_ICU_TIM3_IRQ_PRIORITY,
+                              (stm32_dmaisr_t)icu_lld_serve_dma_interrupt,
+                              (void *)icup);
+        osalDbgAssert(!b, "stream already allocated");
+      }
+#endif
 #if defined(STM32_TIM3CLK)
       icup->clock = STM32_TIM3CLK;
 #else
@@ -446,6 +588,16 @@ void icu_lld_start(ICUDriver *icup) {
 #if !defined(STM32_TIM4_SUPPRESS_ISR)
       nvicEnableVector(STM32_TIM4_NUMBER, STM32_ICU_TIM4_IRQ_PRIORITY);
 #endif
+#if STM32_ICU_USE_DMA_FIFO && defined(STM32_ICU_TIM4_DMA_STREAM)
+      {
+        bool b;
+        b = dmaStreamAllocate(icup->dmastp,
+                              STM32_ICU_TIM4_IRQ_PRIORITY,
+                              (stm32_dmaisr_t)icu_lld_serve_dma_interrupt,
+                              (void *)icup);
+        osalDbgAssert(!b, "stream already allocated");
+      }
+#endif
 #if defined(STM32_TIM4CLK)
       icup->clock = STM32_TIM4CLK;
 #else
@@ -461,6 +613,16 @@ void icu_lld_start(ICUDriver *icup) {
 #if !defined(STM32_TIM5_SUPPRESS_ISR)
       nvicEnableVector(STM32_TIM5_NUMBER, STM32_ICU_TIM5_IRQ_PRIORITY);
 #endif
+#if STM32_ICU_USE_DMA_FIFO && defined(STM32_ICU_TIM5_DMA_STREAM)
+      {
+        bool b;
+        b = dmaStreamAllocate(icup->dmastp,
+                              STM32_ICU_TIM5_IRQ_PRIORITY,
+                              (stm32_dmaisr_t)icu_lld_serve_dma_interrupt,
+                              (void *)icup);
+        osalDbgAssert(!b, "stream already allocated");
+      }
+#endif
 #if defined(STM32_TIM5CLK)
       icup->clock = STM32_TIM5CLK;
 #else
@@ -477,6 +639,16 @@ void icu_lld_start(ICUDriver *icup) {
       nvicEnableVector(STM32_TIM8_UP_NUMBER, STM32_ICU_TIM8_IRQ_PRIORITY);
       nvicEnableVector(STM32_TIM8_CC_NUMBER, STM32_ICU_TIM8_IRQ_PRIORITY);
 #endif
+#if STM32_ICU_USE_DMA_FIFO && defined(STM32_ICU_TIM8_DMA_STREAM)
+      {
+        bool b;
+        b = dmaStreamAllocate(icup->dmastp,
+                              STM32_ICU_TIM8_IRQ_PRIORITY,
+                              (stm32_dmaisr_t)icu_lld_serve_dma_interrupt,
+                              (void *)icup);
+        osalDbgAssert(!b, "stream already allocated");
+      }
+#endif
 #if defined(STM32_TIM8CLK)
       icup->clock = STM32_TIM8CLK;
 #else
@@ -586,6 +758,13 @@ void icu_lld_stop(ICUDriver *icup) {
     icup->tim->DIER = 0;                    /* All IRQs disabled.           */
     icup->tim->SR   = 0;                    /* Clear eventual pending IRQs. */
 
+#if STM32_ICU_USE_DMA_FIFO
+    if (icup->dmastp != NULL) {
+      icu_lld_stop_fifo(icup);
+      dmaStreamRelease(icup->dmastp);
+    }
+#endif
+
 #if STM32_ICU_USE_TIM1
     if (&ICUD1 == icup) {
 #if !defined(STM32_TIM1_SUPPRESS_ISR)
@@ -802,6 +981,148 @@ void icu_lld_serve_interrupt(ICUDriver *icup) {
     _icu_isr_invoke_overflow_cb(icup);
 }
 
+#if STM32_ICU_USE_DMA_FIFO || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the capture FIFO.
+ * @details The capture registers are transferred by DMA into a circular
+ *          buffer on each period capture, the application consumes the
+ *          capture pairs in batches of half buffer using
+ *          @p icuSTM32WaitCaptureFIFOTimeout().
+ * @pre     The ICU unit must have been activated using @p icuStart() and
+ *          the unit must have a DMA stream assigned.
+ * @note    The FIFO must be started before @p icuStartCapture().
+ * @note    Notifications can still be enabled but are not required.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ * @param[in] buf       pointer to the buffer, two @p icucnt_t per capture
+ * @param[in] n         buffer size in capture pairs, must be even
+ *
+ * @api
+ */
+void icuSTM32StartCaptureFIFO(ICUDriver *icup, icucnt_t *buf, size_t n) {
+  uint32_t mode;
+
+  osalDbgCheck((icup != NULL) && (buf != NULL) &&
+               (n >= 2U) && ((n & 1U) == 0U));
+
+  osalSysLock();
+  osalDbgAssert(icup->state == ICU_READY, "invalid state");
+  osalDbgAssert(icup->dmastp != NULL, "no DMA stream");
+  osalDbgAssert(icup->fifo == NULL, "FIFO already active");
+
+  icup->fifo          = buf;
+  icup->fifo_n        = n;
+  icup->fifo_wr       = 0U;
+  icup->fifo_rd       = 0U;
+  icup->fifo_overruns = 0U;
+  icup->fifo_thread   = NULL;
+
+  /* CCR1 and CCR2 are read by a single DMA burst of two transfers on
+     the period channel request, the width capture position depends on
+     the selected input.*/
+  icup->fifo_widx = (icup->config->channel == ICU_CHANNEL_1) ? 1U : 0U;
+  icup->tim->DCR  = STM32_TIM_DCR_DBL(1) | STM32_TIM_DCR_DBA(13);
+
+  mode = STM32_DMA_CR_PL(STM32_ICU_DMA_PRIORITY) | STM32_DMA_CR_DIR_P2M |
+         STM32_DMA_CR_PSIZE_WORD | STM32_DMA_CR_MSIZE_WORD |
+         STM32_DMA_CR_MINC | STM32_DMA_CR_CIRC | STM32_DMA_CR_HTIE |
+         STM32_DMA_CR_TCIE | STM32_DMA_CR_TEIE | STM32_DMA_CR_DMEIE;
+#if defined(STM32_DMA_SUPPORTS_DMAMUX) && STM32_DMA_SUPPORTS_DMAMUX
+  dmaSetRequestSource(icup->dmastp, icup->dmachn);
+#else
+  mode |= STM32_DMA_CR_CHSEL(icup->dmachn);
+#endif
+  dmaStreamSetPeripheral(icup->dmastp, &icup->tim->DMAR);
+  dmaStreamSetMemory0(icup->dmastp, buf);
+  dmaStreamSetTransactionSize(icup->dmastp, n * 2U);
+  dmaStreamSetMode(icup->dmastp, mode);
+  dmaStreamEnable(icup->dmastp);
+
+  if (icup->config->channel == ICU_CHANNEL_1)
+    icup->tim->DIER |= STM32_TIM_DIER_CC1DE;
+  else
+    icup->tim->DIER |= STM32_TIM_DIER_CC2DE;
+
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Stops the capture FIFO.
+ * @details A thread waiting on the FIFO is released with @p MSG_RESET.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ *
+ * @api
+ */
+void icuSTM32StopCaptureFIFO(ICUDriver *icup) {
+
+  osalDbgCheck(icup != NULL);
+
+  osalSysLock();
+  icu_lld_stop_fifo(icup);
+  osalOsRescheduleS();
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Waits for a batch of captures.
+ * @details The function returns a pointer to the oldest FIFO half not yet
+ *          returned, if the application fell behind by more than a half
+ *          then the older halves are skipped and counted in the
+ *          @p fifo_overruns field.
+ * @note    The batch is overwritten by the DMA after another half of the
+ *          FIFO has been filled, it must be processed within that time.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ * @param[out] bpp      pointer to the returned batch pointer, the batch
+ *                      contains @p icuSTM32GetFIFOBatchSizeX() pairs
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a batch is available.
+ * @retval MSG_TIMEOUT  if a timeout occurred.
+ * @retval MSG_RESET    if the FIFO is not active or has been stopped.
+ *
+ * @api
+ */
+msg_t icuSTM32WaitCaptureFIFOTimeout(ICUDriver *icup,
+                                     const icucnt_t **bpp,
+                                     sysinterval_t timeout) {
+  msg_t msg;
+
+  osalDbgCheck((icup != NULL) && (bpp != NULL));
+
+  osalSysLock();
+  if (icup->fifo == NULL) {
+    osalSysUnlock();
+    return MSG_RESET;
+  }
+
+  if (icup->fifo_wr == icup->fifo_rd) {
+    msg = osalThreadSuspendTimeoutS(&icup->fifo_thread, timeout);
+    if (msg != MSG_OK) {
+      osalSysUnlock();
+      return msg;
+    }
+  }
+
+  /* Skipping the halves overwritten by the DMA.*/
+  if ((icup->fifo_wr - icup->fifo_rd) > 1U) {
+    icup->fifo_overruns += icup->fifo_wr - icup->fifo_rd - 1U;
+    icup->fifo_rd = icup->fifo_wr - 1U;
+  }
+
+  *bpp = &icup->fifo[(icup->fifo_rd & 1U) * icup->fifo_n];
+  icup->fifo_rd++;
+  osalSysUnlock();
+
+  return MSG_OK;
+}
+#endif /* STM32_ICU_USE_DMA_FIFO */
+
 #endif /* HAL_USE_ICU */
 
 /** @} */
@@ -152,6 +152,33 @@
 #if !defined(STM32_ICU_TIM9_IRQ_PRIORITY) || defined(__DOXYGEN__)
 #define STM32_ICU_TIM9_IRQ_PRIORITY         7
 #endif
+
+/**
+ * @brief   Enables the DMA capture FIFO.
+ * @details When enabled, the units having a @p STM32_ICU_TIMx_DMA_STREAM
+ *          setting can store the capture results into a circular buffer
+ *          without per-edge interrupts, see @p icuSTM32StartCaptureFIFO().
+ * @note    The stream must be the one serving the TIMx_CHn DMA request of
+ *          the period capture channel, @p STM32_ICU_TIMx_DMA_CHN is the
+ *          related channel or DMAMUX request number.
+ */
+#if !defined(STM32_ICU_USE_DMA_FIFO) || defined(__DOXYGEN__)
+#define STM32_ICU_USE_DMA_FIFO              FALSE
+#endif
+
+/**
+ * @brief   Capture FIFO DMA priority (0..3|lowest..highest).
+ */
+#if !defined(STM32_ICU_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_ICU_DMA_PRIORITY              2
+#endif
+
+/**
+ * @brief   Capture FIFO DMA error hook.
+ */
+#if !defined(STM32_ICU_DMA_ERROR_HOOK) || defined(__DOXYGEN__)
+#define STM32_ICU_DMA_ERROR_HOOK(icup)      osalSysHalt("DMA failure")
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -314,6 +341,45 @@
 #error "Invalid IRQ priority assigned to TIM9"
 #endif
 
+/* Capture FIFO checks.*/
+#if STM32_ICU_USE_DMA_FIFO
+#if !STM32_DMA_IS_VALID_PRIORITY(STM32_ICU_DMA_PRIORITY)
+#error "Invalid DMA priority assigned to ICU"
+#endif
+
+#if defined(STM32_ICU_TIM9_DMA_STREAM)
+#error "TIM9 has no DMA requests"
+#endif
+
+#if !defined(STM32_ICU_TIM1_DMA_CHN)
+#define STM32_ICU_TIM1_DMA_CHN             0
+#endif
+
+#if !defined(STM32_ICU_TIM2_DMA_CHN)
+#define STM32_ICU_TIM2_DMA_CHN             0
+#endif
+
+#if !defined(STM32_ICU_TIM3_DMA_CHN)
+#define STM32_ICU_TIM3_DMA_CHN             0
+#endif
+
+#if !defined(STM32_ICU_TIM4_DMA_CHN)
+#define STM32_ICU_TIM4_DMA_CHN             0
+#endif
+
+#if !defined(STM32_ICU_TIM5_DMA_CHN)
+#define STM32_ICU_TIM5_DMA_CHN             0
+#endif
+
+#if !defined(STM32_ICU_TIM8_DMA_CHN)
+#define STM32_ICU_TIM8_DMA_CHN             0
+#endif
+
+#if !defined(STM32_DMA_REQUIRED)
+#define STM32_DMA_REQUIRED
+#endif
+#endif /* STM32_ICU_USE_DMA_FIFO */
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -417,6 +483,44 @@ struct ICUDriver {
    * @brief CCR register used for period capture.
    */
   volatile uint32_t         *pccrp;
+#if STM32_ICU_USE_DMA_FIFO || defined(__DOXYGEN__)
+  /**
+   * @brief Capture FIFO DMA stream or @p NULL if not available.
+   */
+  const stm32_dma_stream_t  *dmastp;
+  /**
+   * @brief Capture FIFO DMA channel or request.
+   */
+  uint32_t                  dmachn;
+  /**
+   * @brief Capture FIFO buffer or @p NULL if the FIFO is not active.
+   */
+  icucnt_t                  *fifo;
+  /**
+   * @brief Capture FIFO size in capture pairs.
+   */
+  size_t                    fifo_n;
+  /**
+   * @brief Index of the width capture within a pair.
+   */
+  uint32_t                  fifo_widx;
+  /**
+   * @brief Number of FIFO halves filled by the DMA.
+   */
+  volatile uint32_t         fifo_wr;
+  /**
+   * @brief Number of FIFO halves returned to the application.
+   */
+  uint32_t                  fifo_rd;
+  /**
+   * @brief Number of FIFO halves lost because not read in time.
+   */
+  uint32_t                  fifo_overruns;
+  /**
+   * @brief Thread waiting for the FIFO.
+   */
+  thread_reference_t        fifo_thread;
+#endif
 };
 
 /*===========================================================================*/
@@ -460,6 +564,44 @@ struct ICUDriver {
 #define icu_lld_are_notifications_enabled(icup)                             \
   (bool)(((icup)->tim->DIER & STM32_TIM_DIER_IRQ_MASK) != 0)
 
+#if STM32_ICU_USE_DMA_FIFO || defined(__DOXYGEN__)
+/**
+ * @brief   Number of capture pairs in a FIFO batch.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ * @return              The number of capture pairs.
+ *
+ * @xclass
+ */
+#define icuSTM32GetFIFOBatchSizeX(icup) ((icup)->fifo_n / 2U)
+
+/**
+ * @brief   Returns a pulse width from a FIFO batch.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ * @param[in] bp        pointer to the batch
+ * @param[in] i         index of the capture pair within the batch
+ * @return              The number of ticks.
+ *
+ * @xclass
+ */
+#define icuSTM32GetFIFOWidthX(icup, bp, i)                                  \
+  ((bp)[((i) * 2U) + (icup)->fifo_widx] + 1U)
+
+/**
+ * @brief   Returns a cycle period from a FIFO batch.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ * @param[in] bp        pointer to the batch
+ * @param[in] i         index of the capture pair within the batch
+ * @return              The number of ticks.
+ *
+ * @xclass
+ */
+#define icuSTM32GetFIFOPeriodX(icup, bp, i)                                 \
+  ((bp)[((i) * 2U) + 1U - (icup)->fifo_widx] + 1U)
+#endif /* STM32_ICU_USE_DMA_FIFO */
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -504,6 +646,13 @@ extern "C" {
   void icu_lld_enable_notifications(ICUDriver *icup);
   void icu_lld_disable_notifications(ICUDriver *icup);
   void icu_lld_serve_interrupt(ICUDriver *icup);
+#if STM32_ICU_USE_DMA_FIFO
+  void icuSTM32StartCaptureFIFO(ICUDriver *icup, icucnt_t *buf, size_t n);
+  void icuSTM32StopCaptureFIFO(ICUDriver *icup);
+  msg_t icuSTM32WaitCaptureFIFOTimeout(ICUDriver *icup,
+                                       const icucnt_t **bpp,
+                                       sysinterval_t timeout);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -98,6 +98,45 @@ PWMDriver PWMD9;
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if STM32_PWM_USE_DMA_STREAMING || defined(__DOXYGEN__)
+/**
+ * @brief   Streaming DMA ISR service routine.
+ *
+ * @param[in] pwmp      pointer to a @p PWMDriver object
+ * @param[in] flags     pre-shifted content of the ISR register
+ *
+ * @notapi
+ */
+static void pwm_lld_serve_dma_interrupt(PWMDriver *pwmp, uint32_t flags) {
+  size_t half;
+
+  /* DMA errors handling.*/
+  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0) {
+    STM32_PWM_DMA_ERROR_HOOK(pwmp);
+  }
+
+  /* The callback could stop the streaming, the state is checked before
+     each refill.*/
+  half = (pwmp->stream_n / 2U) * (size_t)pwmp->stream_nch;
+  if (((flags & STM32_DMA_ISR_HTIF) != 0) && (pwmp->stream != NULL)) {
+    pwmp->stream_cb(pwmp, pwmp->stream, pwmp->stream_n / 2U);
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+    if (pwmp->stream != NULL) {
+      cacheDMABeforeTx(pwmp->stream, half * sizeof (pwmcnt_t));
+    }
+#endif
+  }
+  if (((flags & STM32_DMA_ISR_TCIF) != 0) && (pwmp->stream != NULL)) {
+    pwmp->stream_cb(pwmp, pwmp->stream + half, pwmp->stream_n / 2U);
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+    if (pwmp->stream != NULL) {
+      cacheDMABeforeTx(pwmp->stream + half, half * sizeof (pwmcnt_t));
+    }
+#endif
+  }
+}
+#endif /* STM32_PWM_USE_DMA_STREAMING */
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -311,6 +350,15 @@ void pwm_lld_init(void) {
   pwmObjectInit(&PWMD1);
   PWMD1.channels = STM32_TIM1_CHANNELS;
   PWMD1.tim = STM32_TIM1;
+#if STM32_PWM_USE_DMA_STREAMING
+#if defined(STM32_PWM_TIM1_DMA_STREAM)
+  PWMD1.dmastp = STM32_DMA_STREAM(STM32_PWM_TIM1_DMA_STREAM);
+  PWMD1.dmachn = STM32_PWM_TIM1_DMA_CHN;
+#else
+  PWMD1.dmastp = NULL;
+#endif
+  PWMD1.stream = NULL;
+#endif
 #endif
 
 #if STM32_PWM_USE_TIM2
@@ -318,6 +366,15 @@ void pwm_lld_init(void) {
   pwmObjectInit(&PWMD2);
   PWMD2.channels = STM32_TIM2_CHANNELS;
   PWMD2.tim = STM32_TIM2;
+#if STM32_PWM_USE_DMA_STREAMING
+#if defined(STM32_PWM_TIM2_DMA_STREAM)
+  PWMD2.dmastp = STM32_DMA_STREAM(STM32_PWM_TIM2_DMA_STREAM);
+  PWMD2.dmachn = STM32_PWM_TIM2_DMA_CHN;
+#else
+  PWMD2.dmastp = NULL;
+#endif
+  PWMD2.stream = NULL;
+#endif
 #endif
 
 #if STM32_PWM_USE_TIM3
@@ -325,6 +382,15 @@ void pwm_lld_init(void) {
   pwmObjectInit(&PWMD3);
   PWMD3.channels = STM32_TIM3_CHANNELS;
   PWMD3.tim = STM32_TIM3;
+#if STM32_PWM_USE_DMA_STREAMING
+#if defined(STM32_PWM_TIM3_DMA_STREAM)
+  PWMD3.dmastp = STM32_DMA_STREAM(STM32_PWM_TIM3_DMA_STREAM);
+  PWMD3.dmachn = STM32_PWM_TIM3_DMA_CHN;
+#else
+  PWMD3.dmastp = NULL;
+#endif
+  PWMD3.stream = NULL;
+#endif
 #endif
 
 #if STM32_PWM_USE_TIM4
@@ -332,6 +398,15 @@ void pwm_lld_init(void) {
   pwmObjectInit(&PWMD4);
   PWMD4.channels = STM32_TIM4_CHANNELS;
   PWMD4.tim = STM32_TIM4;
+#if STM32_PWM_USE_DMA_STREAMING
+#if defined(STM32_PWM_TIM4_DMA_STREAM)
+  PWMD4.dmastp = STM32_DMA_STREAM(STM32_PWM_TIM4_DMA_STREAM);
+  PWMD4.dmachn = STM32_PWM_TIM4_DMA_CHN;
+#else
+  PWMD4.dmastp = NULL;
+#endif
+  PWMD4.stream = NULL;
+#endif
 #endif
 
 #if STM32_PWM_USE_TIM5
@@ -339,6 +414,15 @@ void pwm_lld_init(void) {
   pwmObjectInit(&PWMD5);
   PWMD5.channels = STM32_TIM5_CHANNELS;
   PWMD5.tim = STM32_TIM5;
+#if STM32_PWM_USE_DMA_STREAMING
+#if defined(STM32_PWM_TIM5_DMA_STREAM)
+  PWMD5.dmastp = STM32_DMA_STREAM(STM32_PWM_TIM5_DMA_STREAM);
+  PWMD5.dmachn = STM32_PWM_TIM5_DMA_CHN;
+#else
+  PWMD5.dmastp = NULL;
+#endif
+  PWMD5.stream = NULL;
+#endif
 #endif
 
 #if STM32_PWM_USE_TIM8
@@ -346,6 +430,15 @@ void pwm_lld_init(void) {
   pwmObjectInit(&PWMD8);
   PWMD8.channels = STM32_TIM8_CHANNELS;
   PWMD8.tim = STM32_TIM8;
+#if STM32_PWM_USE_DMA_STREAMING
+#if defined(STM32_PWM_TIM8_DMA_STREAM)
+  PWMD8.dmastp = STM32_DMA_STREAM(STM32_PWM_TIM8_DMA_STREAM);
+  PWMD8.dmachn = STM32_PWM_TIM8_DMA_CHN;
+#else
+  PWMD8.dmastp = NULL;
+#endif
+  PWMD8.stream = NULL;
+#endif
 #endif
 
 #if STM32_PWM_USE_TIM9
@@ -353,6 +446,10 @@ void pwm_lld_init(void) {
   pwmObjectInit(&PWMD9);
   PWMD9.channels = STM32_TIM9_CHANNELS;
   PWMD9.tim = STM32_TIM9;
+#if STM32_PWM_USE_DMA_STREAMING
+  PWMD9.dmastp = NULL;
+  PWMD9.stream = NULL;
+#endif
 #endif
 }
 
@@ -379,6 +476,16 @@ void pwm_lld_start(PWMDriver *pwmp) {
       nvicEnableVector(STM32_TIM1_UP_NUMBER, STM32_PWM_TIM1_IRQ_PRIORITY);
       nvicEnableVector(STM32_TIM1_CC_NUMBER, STM32_PWM_TIM1_IRQ_PRIORITY);
 #endif
+#if STM32_PWM_USE_DMA_STREAMING && defined(STM32_PWM_TIM1_DMA_STREAM)
+      {
+        bool b;
+        b = dmaStreamAllocate(pwmp->dmastp,
+                              STM32_PWM_TIM1_IRQ_PRIORITY,
+                              (stm32_dmaisr_t)pwm_lld_serve_dma_interrupt,
+                              (void *)pwmp);
+        osalDbgAssert(!b, "stream already allocated");
+      }
+#endif
 #if defined(STM32_TIM1CLK)
       pwmp->clock = STM32_TIM1CLK;
 #else
@@ -394,6 +501,16 @@ void pwm_lld_start(PWMDriver *pwmp) {
 #if !defined(STM32_TIM2_SUPPRESS_ISR)
       nvicEnableVector(STM32_TIM2_NUMBER, STM32_PWM_TIM2_IRQ_PRIORITY);
 #endif
+#if STM32_PWM_USE_DMA_STREAMING && defined(STM32_PWM_TIM2_DMA_STREAM)
+      {
+        bool b;
+        b = dmaStreamAllocate(pwmp->dmastp,
+                              STM32_PWM_TIM2_IRQ_PRIORITY,
+                              (stm32_dmaisr_t)pwm_lld_serve_dma_interrupt,
+                              (void *)pwmp);
+        osalDbgAssert(!b, "stream already allocated");
+      }
+#endif
 #if defined(STM32_TIM2CLK)
       pwmp->clock = STM32_TIM2CLK;
 #else
@@ -409,6 +526,16 @@ void pwm_lld_start(PWMDriver *pwmp) {
 #if !defined(STM32_TIM3_SUPPRESS_ISR)
       nvicEnableVector(STM32_TIM3_NUMBER, STM32_PWM_TIM3_IRQ_PRIORITY);
 #endif
+#if STM32_PWM_USE_DMA_STREAMING && defined(STM32_PWM_TIM3_DMA_STREAM)
+      {
+        bool b;
+        b = dmaStreamAllocate(pwmp->dmastp,
+                              STM32_PWM_TIM3_IRQ_PRIORITY,
+                              (stm32_dmaisr_t)pwm_lld_serve_dma_interrupt,
+                              (void *)pwmp);
+        osalDbgAssert(!b, "stream already allocated");
+      }
+#endif
 #if defined(STM32_TIM3CLK)
       pwmp->clock = STM32_TIM3CLK;
 #else
@@ -424,6 +551,16 @@ void pwm_lld_start(PWMDriver *pwmp) {
 #if !defined(STM32_TIM4_SUPPRESS_ISR)
       nvicEnableVector(STM32_TIM4_NUMBER, STM32_PWM_TIM4_IRQ_PRIORITY);
 #endif
+#if STM32_PWM_USE_DMA_STREAMING && defined(STM32_PWM_TIM4_DMA_STREAM)
+      {
+        bool b;
+        b = dmaStreamAllocate(pwmp->dmastp,
+                              STM32_PWM_TIM4_IRQ_PRIORITY,
+                              (stm32_dmaisr_t)pwm_lld_serve_dma_interrupt,
+                              (void *)pwmp);
+        osalDbgAssert(!b, "stream already allocated");
+      }
+#endif
 #if defined(STM32_TIM4CLK)
       pwmp->clock = STM32_TIM4CLK;
 #else
@@ -439,6 +576,16 @@ void pwm_lld_start(PWMDriver *pwmp) {
 #if !defined(STM32_TIM5_SUPPRESS_ISR)
       nvicEnableVector(STM32_TIM5_NUMBER, STM32_PWM_TIM5_IRQ_PRIORITY);
 #endif
+#if STM32_PWM_USE_DMA_STREAMING && defined(STM32_PWM_TIM5_DMA_STREAM)
+      {
+        bool b;
+        b = dmaStreamAllocate(pwmp->dmastp,
+                              STM32_PWM_TIM5_IRQ_PRIORITY,
+                              (stm32_dmaisr_t)pwm_lld_serve_dma_interrupt,
+                              (void *)pwmp);
+        osalDbgAssert(!b, "stream already allocated");
+      }
+#endif
 #if defined(STM32_TIM5CLK)
       pwmp->clock = STM32_TIM5CLK;
 #else
@@ -455,6 +602,16 @@ void pwm_lld_start(PWMDriver *pwmp) {
       nvicEnableVector(STM32_TIM8_UP_NUMBER, STM32_PWM_TIM8_IRQ_PRIORITY);
       nvicEnableVector(STM32_TIM8_CC_NUMBER, STM32_PWM_TIM8_IRQ_PRIORITY);
 #endif
+#if STM32_PWM_USE_DMA_STREAMING && defined(STM32_PWM_TIM8_DMA_STREAM)
+      {
+        bool b;
+        b = dmaStreamAllocate(pwmp->dmastp,
+                              STM32_PWM_TIM8_IRQ_PRIORITY,
+                              (stm32_dmaisr_t)pwm_lld_serve_dma_interrupt,
+                              (void *)pwmp);
+        osalDbgAssert(!b, "stream already allocated");
+      }
+#endif
 #if defined(STM32_TIM8CLK)
       pwmp->clock = STM32_TIM8CLK;
 #else
@@ -634,6 +791,13 @@ void pwm_lld_stop(PWMDriver *pwmp) {
     pwmp->tim->BDTR  = 0;
 #endif
 
+#if STM32_PWM_USE_DMA_STREAMING
+    if (pwmp->dmastp != NULL) {
+      pwmSTM32StopStreamingI(pwmp);
+      dmaStreamRelease(pwmp->dmastp);
+    }
+#endif
+
 #if STM32_PWM_USE_TIM1
     if (&PWMD1 == pwmp) {
 #if !defined(STM32_TIM1_SUPPRESS_ISR)
@@ -867,6 +1031,118 @@ void pwm_lld_serve_interrupt(PWMDriver *pwmp) {
     pwmp->config->callback(pwmp);
 }
 
+#if STM32_PWM_USE_DMA_STREAMING || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the DMA streaming.
+ * @details On each update event the timer DMA burst writes a frame of
+ *          @p nch words from the buffer into the CCR1...CCRn registers,
+ *          the buffer is circular and the refill callback is invoked
+ *          each time a half has been transferred. Without a callback the
+ *          buffer content is repeated, this is suitable for waveforms.
+ * @pre     The PWM unit must have been activated using @p pwmStart() and
+ *          the unit must have a DMA stream assigned.
+ * @note    Because of the registers preload, each frame is output during
+ *          the period following its transfer.
+ * @note    The outputs are driven according to the channels configuration,
+ *          the channels do not need to be enabled.
+ *
+ * @param[in] pwmp      pointer to a @p PWMDriver object
+ * @param[in] nch       number of channels in a frame, starting from the
+ *                      first channel, up to 4
+ * @param[in] buf       pointer to the buffer, @p nch widths per frame
+ * @param[in] n         buffer size in frames, must be even
+ * @param[in] cb        refill callback or @p NULL
+ *
+ * @api
+ */
+void pwmSTM32StartStreaming(PWMDriver *pwmp, pwmchannel_t nch,
+                            pwmcnt_t *buf, size_t n, pwmstreamcb_t cb) {
+  uint32_t mode;
+
+  osalDbgCheck((pwmp != NULL) && (nch > 0U) && (nch <= 4U) &&
+               (buf != NULL) && (n >= 2U) && ((n & 1U) == 0U));
+
+  osalSysLock();
+  osalDbgAssert(pwmp->state == PWM_READY, "invalid state");
+  osalDbgAssert(pwmp->dmastp != NULL, "no DMA stream");
+  osalDbgAssert(pwmp->stream == NULL, "streaming already active");
+  osalDbgAssert(nch <= pwmp->channels, "invalid channels number");
+
+  pwmp->stream     = buf;
+  pwmp->stream_n   = n;
+  pwmp->stream_nch = nch;
+  pwmp->stream_cb  = cb;
+
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  cacheDMABeforeTx(buf, n * (size_t)nch * sizeof (pwmcnt_t));
+#endif
+
+  /* A burst of nch transfers starting from CCR1 on each update event.*/
+  pwmp->tim->DCR = STM32_TIM_DCR_DBL((uint32_t)nch - 1U) |
+                   STM32_TIM_DCR_DBA(13);
+
+  mode = STM32_DMA_CR_PL(STM32_PWM_DMA_PRIORITY) | STM32_DMA_CR_DIR_M2P |
+         STM32_DMA_CR_PSIZE_WORD | STM32_DMA_CR_MSIZE_WORD |
+         STM32_DMA_CR_MINC | STM32_DMA_CR_CIRC |
+         STM32_DMA_CR_TEIE | STM32_DMA_CR_DMEIE;
+  if (cb != NULL) {
+    mode |= STM32_DMA_CR_HTIE | STM32_DMA_CR_TCIE;
+  }
+#if defined(STM32_DMA_SUPPORTS_DMAMUX) && STM32_DMA_SUPPORTS_DMAMUX
+  dmaSetRequestSource(pwmp->dmastp, pwmp->dmachn);
+#else
+  mode |= STM32_DMA_CR_CHSEL(pwmp->dmachn);
+#endif
+  dmaStreamSetPeripheral(pwmp->dmastp, &pwmp->tim->DMAR);
+  dmaStreamSetMemory0(pwmp->dmastp, buf);
+  dmaStreamSetTransactionSize(pwmp->dmastp, n * (size_t)nch);
+  dmaStreamSetMode(pwmp->dmastp, mode);
+  dmaStreamEnable(pwmp->dmastp);
+
+  pwmp->tim->DIER |= STM32_TIM_DIER_UDE;
+
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Stops the DMA streaming.
+ * @details The compare registers keep the last transferred values.
+ * @note    The refill callback can invoke this function from within an
+ *          @p osalSysLockFromISR() zone.
+ *
+ * @param[in] pwmp      pointer to a @p PWMDriver object
+ *
+ * @iclass
+ */
+void pwmSTM32StopStreamingI(PWMDriver *pwmp) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck(pwmp != NULL);
+
+  if (pwmp->stream != NULL) {
+    pwmp->tim->DIER &= ~STM32_TIM_DIER_UDE;
+    pwmp->tim->DCR   = 0;
+    dmaStreamDisable(pwmp->dmastp);
+    pwmp->stream = NULL;
+  }
+}
+
+/**
+ * @brief   Stops the DMA streaming.
+ * @details The compare registers keep the last transferred values.
+ *
+ * @param[in] pwmp      pointer to a @p PWMDriver object
+ *
+ * @api
+ */
+void pwmSTM32StopStreaming(PWMDriver *pwmp) {
+
+  osalSysLock();
+  pwmSTM32StopStreamingI(pwmp);
+  osalSysUnlock();
+}
+#endif /* STM32_PWM_USE_DMA_STREAMING */
+
 #endif /* HAL_USE_PWM */
 
 /** @} */
@@ -202,6 +202,34 @@
 #if !defined(STM32_PWM_TIM9_IRQ_PRIORITY) || defined(__DOXYGEN__)
 #define STM32_PWM_TIM9_IRQ_PRIORITY         7
 #endif
+
+/**
+ * @brief   Enables the DMA streaming mode.
+ * @details When enabled, the units having a @p STM32_PWM_TIMx_DMA_STREAM
+ *          setting can update the compare registers from a buffer on each
+ *          period using the timer DMA burst, see
+ *          @p pwmSTM32StartStreaming().
+ * @note    The stream must be the one serving the TIMx_UP DMA request,
+ *          @p STM32_PWM_TIMx_DMA_CHN is the related channel or DMAMUX
+ *          request number.
+ */
+#if !defined(STM32_PWM_USE_DMA_STREAMING) || defined(__DOXYGEN__)
+#define STM32_PWM_USE_DMA_STREAMING         FALSE
+#endif
+
+/**
+ * @brief   Streaming DMA priority (0..3|lowest..highest).
+ */
+#if !defined(STM32_PWM_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_PWM_DMA_PRIORITY              2
+#endif
+
+/**
+ * @brief   Streaming DMA error hook.
+ */
+#if !defined(STM32_PWM_DMA_ERROR_HOOK) || defined(__DOXYGEN__)
+#define STM32_PWM_DMA_ERROR_HOOK(pwmp)      osalSysHalt("DMA failure")
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -368,6 +396,45 @@
 #error "Invalid IRQ priority assigned to TIM9"
 #endif
 
+/* Streaming checks.*/
+#if STM32_PWM_USE_DMA_STREAMING
+#if !STM32_DMA_IS_VALID_PRIORITY(STM32_PWM_DMA_PRIORITY)
+#error "Invalid DMA priority assigned to PWM"
+#endif
+
+#if defined(STM32_PWM_TIM9_DMA_STREAM)
+#error "TIM9 has no DMA requests"
+#endif
+
+#if !defined(STM32_PWM_TIM1_DMA_CHN)
+#define STM32_PWM_TIM1_DMA_CHN             0
+#endif
+
+#if !defined(STM32_PWM_TIM2_DMA_CHN)
+#define STM32_PWM_TIM2_DMA_CHN             0
+#endif
+
+#if !defined(STM32_PWM_TIM3_DMA_CHN)
+#define STM32_PWM_TIM3_DMA_CHN             0
+#endif
+
+#if !defined(STM32_PWM_TIM4_DMA_CHN)
+#define STM32_PWM_TIM4_DMA_CHN             0
+#endif
+
+#if !defined(STM32_PWM_TIM5_DMA_CHN)
+#define STM32_PWM_TIM5_DMA_CHN             0
+#endif
+
+#if !defined(STM32_PWM_TIM8_DMA_CHN)
+#define STM32_PWM_TIM8_DMA_CHN             0
+#endif
+
+#if !defined(STM32_DMA_REQUIRED)
+#define STM32_DMA_REQUIRED
+#endif
+#endif /* STM32_PWM_USE_DMA_STREAMING */
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -392,6 +459,20 @@ typedef uint32_t pwmchnmsk_t;
  */
 typedef uint32_t pwmcnt_t;
 
+#if STM32_PWM_USE_DMA_STREAMING || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a streaming refill callback.
+ * @details The callback is invoked from the DMA ISR when a half of the
+ *          streaming buffer has been transferred, that half can then be
+ *          refilled with the next frames.
+ *
+ * @param[in] pwmp      pointer to a @p PWMDriver object
+ * @param[in] bp        pointer to the buffer half to be refilled
+ * @param[in] n         number of frames in the buffer half
+ */
+typedef void (*pwmstreamcb_t)(PWMDriver *pwmp, pwmcnt_t *bp, size_t n);
+#endif
+
 /**
  * @brief   Type of a PWM driver channel configuration structure.
  */
@@ -492,6 +573,32 @@ struct PWMDriver {
    * @brief Pointer to the TIMx registers block.
    */
   stm32_tim_t               *tim;
+#if STM32_PWM_USE_DMA_STREAMING || defined(__DOXYGEN__)
+  /**
+   * @brief Streaming DMA stream or @p NULL if not available.
+   */
+  const stm32_dma_stream_t  *dmastp;
+  /**
+   * @brief Streaming DMA channel or request.
+   */
+  uint32_t                  dmachn;
+  /**
+   * @brief Streaming buffer or @p NULL if streaming is not active.
+   */
+  pwmcnt_t                  *stream;
+  /**
+   * @brief Streaming buffer size in frames.
+   */
+  size_t                    stream_n;
+  /**
+   * @brief Number of channels in a frame.
+   */
+  pwmchannel_t              stream_nch;
+  /**
+   * @brief Streaming refill callback or @p NULL.
+   */
+  pwmstreamcb_t             stream_cb;
+#endif
 };
 
 /*===========================================================================*/
@@ -566,6 +673,12 @@ extern "C" {
   void pwm_lld_disable_channel_notification(PWMDriver *pwmp,
                                             pwmchannel_t channel);
   void pwm_lld_serve_interrupt(PWMDriver *pwmp);
+#if STM32_PWM_USE_DMA_STREAMING
+  void pwmSTM32StartStreaming(PWMDriver *pwmp, pwmchannel_t nch,
+                              pwmcnt_t *buf, size_t n, pwmstreamcb_t cb);
+  void pwmSTM32StopStreamingI(PWMDriver *pwmp);
+  void pwmSTM32StopStreaming(PWMDriver *pwmp);
+#endif
 #ifdef __cplusplus
 }
 #endif
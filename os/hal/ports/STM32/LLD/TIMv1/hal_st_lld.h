@@ -229,6 +229,27 @@ static inline bool st_lld_is_alarm_active(void) {
   return (bool)((STM32_ST_TIM->DIER & STM32_TIM_DIER_CC1IE) != 0);
 }
 
+/**
+ * @brief   Advances the time counter.
+ * @details This function is meant to compensate the time spent with the
+ *          timer clock stopped, if the advance crosses the alarm time then
+ *          the alarm is triggered immediately.
+ *
+ * @param[in] n         number of ticks to be added to the counter
+ *
+ * @notapi
+ */
+static inline void st_lld_advance_counter(systime_t n) {
+  systime_t cnt = (systime_t)STM32_ST_TIM->CNT;
+  systime_t remaining = (systime_t)((systime_t)STM32_ST_TIM->CCR[0] - cnt);
+
+  STM32_ST_TIM->CNT = (uint32_t)(systime_t)(cnt + n);
+  if (((STM32_ST_TIM->DIER & STM32_TIM_DIER_CC1IE) != 0U) &&
+      (remaining <= n)) {
+    STM32_ST_TIM->EGR = STM32_TIM_EGR_CC1G;
+  }
+}
+
 #endif /* HAL_ST_LLD_H */
 
 /** @} */
@@ -70,6 +70,40 @@
 #define USART_CR1_M_1                       (1 << 28)
 #endif
 
+#if STM32_SERIAL_USE_DMA_RX || defined(__DOXYGEN__)
+#define USART1_RX_DMA_CHANNEL                                               \
+  STM32_DMA_GETCHANNEL(STM32_SERIAL_USART1_RX_DMA_STREAM,                   \
+                       STM32_USART1_RX_DMA_CHN)
+
+#define USART2_RX_DMA_CHANNEL                                               \
+  STM32_DMA_GETCHANNEL(STM32_SERIAL_USART2_RX_DMA_STREAM,                   \
+                       STM32_USART2_RX_DMA_CHN)
+
+#define USART3_RX_DMA_CHANNEL                                               \
+  STM32_DMA_GETCHANNEL(STM32_SERIAL_USART3_RX_DMA_STREAM,                   \
+                       STM32_USART3_RX_DMA_CHN)
+
+#define UART4_RX_DMA_CHANNEL                                                \
+  STM32_DMA_GETCHANNEL(STM32_SERIAL_UART4_RX_DMA_STREAM,                    \
+                       STM32_UART4_RX_DMA_CHN)
+
+#define UART5_RX_DMA_CHANNEL                                                \
+  STM32_DMA_GETCHANNEL(STM32_SERIAL_UART5_RX_DMA_STREAM,                    \
+                       STM32_UART5_RX_DMA_CHN)
+
+#define USART6_RX_DMA_CHANNEL                                               \
+  STM32_DMA_GETCHANNEL(STM32_SERIAL_USART6_RX_DMA_STREAM,                   \
+                       STM32_USART6_RX_DMA_CHN)
+
+#define UART7_RX_DMA_CHANNEL                                                \
+  STM32_DMA_GETCHANNEL(STM32_SERIAL_UART7_RX_DMA_STREAM,                    \
+                       STM32_UART7_RX_DMA_CHN)
+
+#define UART8_RX_DMA_CHANNEL                                                \
+  STM32_DMA_GETCHANNEL(STM32_SERIAL_UART8_RX_DMA_STREAM,                    \
+                       STM32_UART8_RX_DMA_CHN)
+#endif
+
 /* Workarounds for those devices where UARTs are USARTs.*/
 #if defined(USART4)
 #define UART4 USART4
@@ -143,6 +177,7 @@ static const SerialConfig default_config =
   SERIAL_DEFAULT_BITRATE,
   0,
   USART_CR2_STOP1_BITS,
+  0,
   0
 };
 
@@ -152,6 +187,11 @@ static uint8_t sd_in_buf1[STM32_SERIAL_USART1_IN_BUF_SIZE];
 
 /** @brief Output buffer for SD1.*/
 static uint8_t sd_out_buf1[STM32_SERIAL_USART1_OUT_BUF_SIZE];
+
+#if STM32_SERIAL_USE_DMA_RX || defined(__DOXYGEN__)
+/** @brief RX DMA buffer for SD1.*/
+static uint8_t sd_rxdma_buf1[STM32_SERIAL_DMA_RX_BUF_SIZE];
+#endif
 #endif
 
 #if STM32_SERIAL_USE_USART2 || defined(__DOXYGEN__)
@@ -160,6 +200,11 @@ static uint8_t sd_in_buf2[STM32_SERIAL_USART2_IN_BUF_SIZE];
 
 /** @brief Output buffer for SD2.*/
 static uint8_t sd_out_buf2[STM32_SERIAL_USART2_OUT_BUF_SIZE];
+
+#if STM32_SERIAL_USE_DMA_RX || defined(__DOXYGEN__)
+/** @brief RX DMA buffer for SD2.*/
+static uint8_t sd_rxdma_buf2[STM32_SERIAL_DMA_RX_BUF_SIZE];
+#endif
 #endif
 
 #if STM32_SERIAL_USE_USART3 || defined(__DOXYGEN__)
@@ -168,6 +213,11 @@ static uint8_t sd_in_buf3[STM32_SERIAL_USART3_IN_BUF_SIZE];
 
 /** @brief Output buffer for SD3.*/
 static uint8_t sd_out_buf3[STM32_SERIAL_USART3_OUT_BUF_SIZE];
+
+#if STM32_SERIAL_USE_DMA_RX || defined(__DOXYGEN__)
+/** @brief RX DMA buffer for SD3.*/
+static uint8_t sd_rxdma_buf3[STM32_SERIAL_DMA_RX_BUF_SIZE];
+#endif
 #endif
 
 #if STM32_SERIAL_USE_UART4 || defined(__DOXYGEN__)
@@ -176,6 +226,11 @@ static uint8_t sd_in_buf4[STM32_SERIAL_UART4_IN_BUF_SIZE];
 
 /** @brief Output buffer for SD4.*/
 static uint8_t sd_out_buf4[STM32_SERIAL_UART4_OUT_BUF_SIZE];
+
+#if STM32_SERIAL_USE_DMA_RX || defined(__DOXYGEN__)
+/** @brief RX DMA buffer for SD4.*/
+static uint8_t sd_rxdma_buf4[STM32_SERIAL_DMA_RX_BUF_SIZE];
+#endif
 #endif
 
 #if STM32_SERIAL_USE_UART5 || defined(__DOXYGEN__)
@@ -184,6 +239,11 @@ static uint8_t sd_in_buf5[STM32_SERIAL_UART5_IN_BUF_SIZE];
 
 /** @brief Output buffer for SD5.*/
 static uint8_t sd_out_buf5[STM32_SERIAL_UART5_OUT_BUF_SIZE];
+
+#if STM32_SERIAL_USE_DMA_RX || defined(__DOXYGEN__)
+/** @brief RX DMA buffer for SD5.*/
+static uint8_t sd_rxdma_buf5[STM32_SERIAL_DMA_RX_BUF_SIZE];
+#endif
 #endif
 
 #if STM32_SERIAL_USE_USART6 || defined(__DOXYGEN__)
@@ -192,6 +252,11 @@ static uint8_t sd_in_buf6[STM32_SERIAL_USART6_IN_BUF_SIZE];
 
 /** @brief Output buffer for SD6.*/
 static uint8_t sd_out_buf6[STM32_SERIAL_USART6_OUT_BUF_SIZE];
+
+#if STM32_SERIAL_USE_DMA_RX || defined(__DOXYGEN__)
+/** @brief RX DMA buffer for SD6.*/
+static uint8_t sd_rxdma_buf6[STM32_SERIAL_DMA_RX_BUF_SIZE];
+#endif
 #endif
 
 #if STM32_SERIAL_USE_UART7 || defined(__DOXYGEN__)
@@ -200,6 +265,11 @@ static uint8_t sd_in_buf7[STM32_SERIAL_UART7_IN_BUF_SIZE];
 
 /** @brief Output buffer for SD7.*/
 static uint8_t sd_out_buf7[STM32_SERIAL_UART7_OUT_BUF_SIZE];
+
+#if STM32_SERIAL_USE_DMA_RX || defined(__DOXYGEN__)
+/** @brief RX DMA buffer for SD7.*/
+static uint8_t sd_rxdma_buf7[STM32_SERIAL_DMA_RX_BUF_SIZE];
+#endif
 #endif
 
 #if STM32_SERIAL_USE_UART8 || defined(__DOXYGEN__)
@@ -208,6 +278,11 @@ static uint8_t sd_in_buf8[STM32_SERIAL_UART8_IN_BUF_SIZE];
 
 /** @brief Output buffer for SD8.*/
 static uint8_t sd_out_buf8[STM32_SERIAL_UART8_OUT_BUF_SIZE];
+
+#if STM32_SERIAL_USE_DMA_RX || defined(__DOXYGEN__)
+/** @brief RX DMA buffer for SD8.*/
+static uint8_t sd_rxdma_buf8[STM32_SERIAL_DMA_RX_BUF_SIZE];
+#endif
 #endif
 
 #if STM32_SERIAL_USE_LPUART1 || defined(__DOXYGEN__)
@@ -231,8 +306,13 @@ static uint8_t sd_out_buflp1[STM32_SERIAL_LPUART1_OUT_BUF_SIZE];
  */
 static void usart_init(SerialDriver *sdp, const SerialConfig *config) {
   uint32_t fck;
+  uint32_t cr1, cr2;
   USART_TypeDef *u = sdp->usart;
 
+  /* The USART is disabled while being programmed, some fields like DEM,
+     DEAT and DEDT are only writable when UE is cleared.*/
+  u->CR1 = 0U;
+
   /* Baud rate setting.*/
 #if STM32_SERIAL_USE_LPUART1
   if ( sdp == &LPSD1 ) {
@@ -251,12 +331,41 @@ static void usart_init(SerialDriver *sdp, const SerialConfig *config) {
     fck = ((fck & ~7) * 2) | (fck & 7);
   u->BRR = fck;
 
+  /* Receiver timeout setting, it is checked because not all the USARTs
+     implement it.*/
+  cr1 = config->cr1 | USART_CR1_UE | USART_CR1_PEIE | USART_CR1_TE |
+                      USART_CR1_RE;
+  cr2 = config->cr2 | USART_CR2_LBDIE;
+  if (config->timeout > 0U) {
+    osalDbgAssert(config->timeout <= USART_RTOR_RTO, "timeout overflow");
+    u->RTOR = config->timeout;
+    osalDbgAssert(config->timeout == u->RTOR, "timeout unsupported");
+    cr1 |= USART_CR1_RTOIE;
+    cr2 |= USART_CR2_RTOEN;
+  }
+
   /* Note that some bits are enforced.*/
-  u->CR2 = config->cr2 | USART_CR2_LBDIE;
-  u->CR3 = config->cr3 | USART_CR3_EIE;
-  u->CR1 = config->cr1 | USART_CR1_UE | USART_CR1_PEIE |
-                         USART_CR1_RXNEIE | USART_CR1_TE |
-                         USART_CR1_RE;
+  u->CR2 = cr2;
+#if STM32_SERIAL_USE_DMA_RX
+  if (sdp->dmarx != NULL) {
+    /* The circular RX DMA buffer is armed before enabling the receiver,
+       the idle line interrupt replaces the RX not empty interrupt.*/
+    dmaStreamDisable(sdp->dmarx);
+    sdp->rxdmapos = 0U;
+    dmaStreamSetPeripheral(sdp->dmarx, &u->RDR);
+    dmaStreamSetMemory0(sdp->dmarx, sdp->rxdmabuf);
+    dmaStreamSetTransactionSize(sdp->dmarx, STM32_SERIAL_DMA_RX_BUF_SIZE);
+    dmaStreamSetMode(sdp->dmarx, sdp->rxdmamode);
+    dmaStreamEnable(sdp->dmarx);
+    u->CR3 = config->cr3 | USART_CR3_EIE | USART_CR3_DMAR;
+    u->CR1 = cr1 | USART_CR1_IDLEIE;
+  }
+  else
+#endif
+  {
+    u->CR3 = config->cr3 | USART_CR3_EIE;
+    u->CR1 = cr1 | USART_CR1_RXNEIE;
+  }
   u->ICR = 0xFFFFFFFFU;
 
   /* Deciding mask to be applied on the data register on receive, this is
@@ -291,6 +400,82 @@ static void usart_deinit(USART_TypeDef *u) {
   u->CR3 = 0;
 }
 
+#if STM32_SERIAL_USE_DMA_RX || defined(__DOXYGEN__)
+/**
+ * @brief   Moves a block of data from the RX DMA buffer to the input queue.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] start     index of the first byte in the RX DMA buffer
+ * @param[in] end       index after the last byte in the RX DMA buffer
+ */
+static void rx_dma_push(SerialDriver *sdp, size_t start, size_t end) {
+
+  /* Parity bits are not masked out by the DMA.*/
+  if (sdp->rxmask != 0xFFU) {
+    size_t i;
+
+    for (i = start; i < end; i++) {
+      sdp->rxdmabuf[i] &= sdp->rxmask;
+    }
+  }
+
+  sdIncomingDataBlockI(sdp, &sdp->rxdmabuf[start], end - start);
+}
+
+/**
+ * @brief   Moves the data received by the DMA to the input queue.
+ * @note    This function must be invoked from within a critical zone.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ */
+static void rx_dma_drain(SerialDriver *sdp) {
+  size_t pos;
+
+  /* Current DMA write position, the counter is reloaded in circular
+     mode so the end of buffer position is equivalent to zero.*/
+  pos = (size_t)STM32_SERIAL_DMA_RX_BUF_SIZE -
+        dmaStreamGetTransactionSize(sdp->dmarx);
+  if (pos >= (size_t)STM32_SERIAL_DMA_RX_BUF_SIZE) {
+    pos = 0U;
+  }
+
+  /* Data wrapped around the buffer end.*/
+  if (pos < sdp->rxdmapos) {
+    rx_dma_push(sdp, sdp->rxdmapos, STM32_SERIAL_DMA_RX_BUF_SIZE);
+    sdp->rxdmapos = 0U;
+  }
+
+  /* Data up to the current position.*/
+  if (pos > sdp->rxdmapos) {
+    rx_dma_push(sdp, sdp->rxdmapos, pos);
+    sdp->rxdmapos = pos;
+  }
+}
+
+/**
+ * @brief   RX DMA common service routine.
+ * @details Invoked on the half and full transfer interrupts.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] flags     pre-shifted content of the ISR register
+ */
+static void serve_rx_dma_interrupt(SerialDriver *sdp, uint32_t flags) {
+
+  /* DMA errors handling.*/
+#if defined(STM32_SERIAL_DMA_ERROR_HOOK)
+  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0) {
+    STM32_SERIAL_DMA_ERROR_HOOK(sdp);
+  }
+#else
+  (void)flags;
+#endif
+
+  osalSysLockFromISR();
+  rx_dma_drain(sdp);
+  osalSysUnlockFromISR();
+}
+#endif /* STM32_SERIAL_USE_DMA_RX */
+
 /**
  * @brief   Error handling routine.
  *
@@ -338,17 +523,45 @@ static void serve_interrupt(SerialDriver *sdp) {
     osalSysUnlockFromISR();
   }
 
-  /* Data available, note it is a while in order to handle two situations:
-     1) Another byte arrived after removing the previous one, this would cause
-        an extra interrupt to serve.
-     2) FIFO mode is enabled on devices that support it, we need to empty
-        the FIFO.*/
-  while (isr & USART_ISR_RXNE) {
+#if STM32_SERIAL_USE_DMA_RX
+  if (sdp->dmarx != NULL) {
+    /* Idle line, the data received so far is moved to the input queue
+       without waiting for the DMA half or full transfer interrupts.*/
+    if ((cr1 & USART_CR1_IDLEIE) && (isr & USART_ISR_IDLE)) {
+      osalSysLockFromISR();
+      rx_dma_drain(sdp);
+      osalSysUnlockFromISR();
+    }
+  }
+  else
+#endif
+  {
+    /* Data available, note it is a while in order to handle two situations:
+       1) Another byte arrived after removing the previous one, this would
+          cause an extra interrupt to serve.
+       2) FIFO mode is enabled on devices that support it, we need to empty
+          the FIFO.*/
+    while (isr & USART_ISR_RXNE) {
+      osalSysLockFromISR();
+      sdIncomingDataI(sdp, (uint8_t)u->RDR & sdp->rxmask);
+      osalSysUnlockFromISR();
+
+      isr = u->ISR;
+    }
+  }
+
+  /* Receiver timeout, end of frame. The received data is already in the
+     input queue at this point.*/
+  if ((cr1 & USART_CR1_RTOIE) && (isr & USART_ISR_RTOF)) {
+    u->ICR = USART_ICR_RTOCF;
     osalSysLockFromISR();
-    sdIncomingDataI(sdp, (uint8_t)u->RDR & sdp->rxmask);
+#if STM32_SERIAL_USE_DMA_RX
+    if (sdp->dmarx != NULL) {
+      rx_dma_drain(sdp);
+    }
+#endif
+    chnAddFlagsI(sdp, SD_FRAME_END);
     osalSysUnlockFromISR();
-
-    isr = u->ISR;
   }
 
   /* Transmission buffer empty, note it is a while in order to handle two
@@ -691,6 +904,14 @@ void sd_lld_init(void) {
   oqObjectInit(&SD1.oqueue, sd_out_buf1, sizeof sd_out_buf1, notify1, &SD1);
   SD1.usart = USART1;
   SD1.clock = STM32_USART1CLK;
+#if STM32_SERIAL_USE_DMA_RX
+#if STM32_DMA_SUPPORTS_DMAMUX
+  SD1.dmarx = STM32_DMA_STREAM(STM32_SERIAL_USART1_RX_DMA_CHANNEL);
+#else
+  SD1.dmarx = STM32_DMA_STREAM(STM32_SERIAL_USART1_RX_DMA_STREAM);
+#endif
+  SD1.rxdmabuf = sd_rxdma_buf1;
+#endif
 #if defined(STM32_USART1_NUMBER)
   nvicEnableVector(STM32_USART1_NUMBER, STM32_SERIAL_USART1_PRIORITY);
 #endif
@@ -702,6 +923,14 @@ void sd_lld_init(void) {
   oqObjectInit(&SD2.oqueue, sd_out_buf2, sizeof sd_out_buf2, notify2, &SD2);
   SD2.usart = USART2;
   SD2.clock = STM32_USART2CLK;
+#if STM32_SERIAL_USE_DMA_RX
+#if STM32_DMA_SUPPORTS_DMAMUX
+  SD2.dmarx = STM32_DMA_STREAM(STM32_SERIAL_USART2_RX_DMA_CHANNEL);
+#else
+  SD2.dmarx = STM32_DMA_STREAM(STM32_SERIAL_USART2_RX_DMA_STREAM);
+#endif
+  SD2.rxdmabuf = sd_rxdma_buf2;
+#endif
 #if defined(STM32_USART2_NUMBER)
   nvicEnableVector(STM32_USART2_NUMBER, STM32_SERIAL_USART2_PRIORITY);
 #endif
@@ -713,6 +942,14 @@ void sd_lld_init(void) {
   oqObjectInit(&SD3.oqueue, sd_out_buf3, sizeof sd_out_buf3, notify3, &SD3);
   SD3.usart = USART3;
   SD3.clock = STM32_USART3CLK;
+#if STM32_SERIAL_USE_DMA_RX
+#if STM32_DMA_SUPPORTS_DMAMUX
+  SD3.dmarx = STM32_DMA_STREAM(STM32_SERIAL_USART3_RX_DMA_CHANNEL);
+#else
+  SD3.dmarx = STM32_DMA_STREAM(STM32_SERIAL_USART3_RX_DMA_STREAM);
+#endif
+  SD3.rxdmabuf = sd_rxdma_buf3;
+#endif
 #if defined(STM32_USART3_NUMBER)
   nvicEnableVector(STM32_USART3_NUMBER, STM32_SERIAL_USART3_PRIORITY);
 #endif
@@ -724,6 +961,14 @@ void sd_lld_init(void) {
   oqObjectInit(&SD4.oqueue, sd_out_buf4, sizeof sd_out_buf4, notify4, &SD4);
   SD4.usart = UART4;
   SD4.clock = STM32_UART4CLK;
+#if STM32_SERIAL_USE_DMA_RX
+#if STM32_DMA_SUPPORTS_DMAMUX
+  SD4.dmarx = STM32_DMA_STREAM(STM32_SERIAL_UART4_RX_DMA_CHANNEL);
+#else
+  SD4.dmarx = STM32_DMA_STREAM(STM32_SERIAL_UART4_RX_DMA_STREAM);
+#endif
+  SD4.rxdmabuf = sd_rxdma_buf4;
+#endif
 #if defined(STM32_UART4_NUMBER)
   nvicEnableVector(STM32_UART4_NUMBER, STM32_SERIAL_UART4_PRIORITY);
 #endif
@@ -735,6 +980,14 @@ void sd_lld_init(void) {
   oqObjectInit(&SD5.oqueue, sd_out_buf5, sizeof sd_out_buf5, notify5, &SD5);
   SD5.usart = UART5;
   SD5.clock = STM32_UART5CLK;
+#if STM32_SERIAL_USE_DMA_RX
+#if STM32_DMA_SUPPORTS_DMAMUX
+  SD5.dmarx = STM32_DMA_STREAM(STM32_SERIAL_UART5_RX_DMA_CHANNEL);
+#else
+  SD5.dmarx = STM32_DMA_STREAM(STM32_SERIAL_UART5_RX_DMA_STREAM);
+#endif
+  SD5.rxdmabuf = sd_rxdma_buf5;
+#endif
 #if defined(STM32_UART5_NUMBER)
   nvicEnableVector(STM32_UART5_NUMBER, STM32_SERIAL_UART5_PRIORITY);
 #endif
@@ -746,6 +999,14 @@ void sd_lld_init(void) {
   oqObjectInit(&SD6.oqueue, sd_out_buf6, sizeof sd_out_buf6, notify6, &SD6);
   SD6.usart = USART6;
   SD6.clock = STM32_USART6CLK;
+#if STM32_SERIAL_USE_DMA_RX
+#if STM32_DMA_SUPPORTS_DMAMUX
+  SD6.dmarx = STM32_DMA_STREAM(STM32_SERIAL_USART6_RX_DMA_CHANNEL);
+#else
+  SD6.dmarx = STM32_DMA_STREAM(STM32_SERIAL_USART6_RX_DMA_STREAM);
+#endif
+  SD6.rxdmabuf = sd_rxdma_buf6;
+#endif
 #if defined(STM32_USART6_NUMBER)
   nvicEnableVector(STM32_USART6_NUMBER, STM32_SERIAL_USART6_PRIORITY);
 #endif
@@ -757,6 +1018,14 @@ void sd_lld_init(void) {
   oqObjectInit(&SD7.oqueue, sd_out_buf7, sizeof sd_out_buf7, notify7, &SD7);
   SD7.usart = UART7;
   SD7.clock = STM32_UART7CLK;
+#if STM32_SERIAL_USE_DMA_RX
+#if STM32_DMA_SUPPORTS_DMAMUX
+  SD7.dmarx = STM32_DMA_STREAM(STM32_SERIAL_UART7_RX_DMA_CHANNEL);
+#else
+  SD7.dmarx = STM32_DMA_STREAM(STM32_SERIAL_UART7_RX_DMA_STREAM);
+#endif
+  SD7.rxdmabuf = sd_rxdma_buf7;
+#endif
 #if defined(STM32_UART7_NUMBER)
   nvicEnableVector(STM32_UART7_NUMBER, STM32_SERIAL_UART7_PRIORITY);
 #endif
@@ -768,6 +1037,14 @@ void sd_lld_init(void) {
   oqObjectInit(&SD8.oqueue, sd_out_buf8, sizeof sd_out_buf8, notify8, &SD8);
   SD8.usart = UART8;
   SD8.clock = STM32_UART8CLK;
+#if STM32_SERIAL_USE_DMA_RX
+#if STM32_DMA_SUPPORTS_DMAMUX
+  SD8.dmarx = STM32_DMA_STREAM(STM32_SERIAL_UART8_RX_DMA_CHANNEL);
+#else
+  SD8.dmarx = STM32_DMA_STREAM(STM32_SERIAL_UART8_RX_DMA_STREAM);
+#endif
+  SD8.rxdmabuf = sd_rxdma_buf8;
+#endif
 #if defined(STM32_UART8_NUMBER)
   nvicEnableVector(STM32_UART8_NUMBER, STM32_SERIAL_UART8_PRIORITY);
 #endif
@@ -779,6 +1056,9 @@ void sd_lld_init(void) {
   oqObjectInit(&LPSD1.oqueue, sd_out_buflp1, sizeof sd_out_buflp1, notifylp1, &LPSD1);
   LPSD1.usart = LPUART1;
   LPSD1.clock = STM32_LPUART1CLK;
+#if STM32_SERIAL_USE_DMA_RX
+  LPSD1.dmarx = NULL;
+#endif
 #if defined(STM32_LPUART1_NUMBER)
   nvicEnableVector(STM32_LPUART1_NUMBER, STM32_SERIAL_LPUART1_PRIORITY);
 #endif
@@ -812,41 +1092,169 @@ void sd_lld_start(SerialDriver *sdp, const SerialConfig *config) {
 #if STM32_SERIAL_USE_USART1
     if (&SD1 == sdp) {
       rccEnableUSART1(true);
+#if STM32_SERIAL_USE_DMA_RX
+      bool b = dmaStreamAllocate(sdp->dmarx,
+                                 STM32_SERIAL_USART1_PRIORITY,
+                                 (stm32_dmaisr_t)serve_rx_dma_interrupt,
+                                 (void *)sdp);
+      osalDbgAssert(!b, "stream already allocated");
+      sdp->rxdmamode = STM32_DMA_CR_CHSEL(USART1_RX_DMA_CHANNEL) |
+                       STM32_DMA_CR_PL(STM32_SERIAL_USART1_DMA_PRIORITY) |
+                       STM32_DMA_CR_DIR_P2M | STM32_DMA_CR_MINC |
+                       STM32_DMA_CR_CIRC | STM32_DMA_CR_HTIE |
+                       STM32_DMA_CR_TCIE | STM32_DMA_CR_DMEIE |
+                       STM32_DMA_CR_TEIE;
+#if STM32_DMA_SUPPORTS_DMAMUX
+      dmaSetRequestSource(sdp->dmarx, STM32_DMAMUX1_USART1_RX);
+#endif
+#endif
     }
 #endif
 #if STM32_SERIAL_USE_USART2
     if (&SD2 == sdp) {
       rccEnableUSART2(true);
+#if STM32_SERIAL_USE_DMA_RX
+      bool b = dmaStreamAllocate(sdp->dmarx,
+                                 STM32_SERIAL_USART2_PRIORITY,
+                                 (stm32_dmaisr_t)serve_rx_dma_interrupt,
+                                 (void *)sdp);
+      osalDbgAssert(!b, "stream already allocated");
+      sdp->rxdmamode = STM32_DMA_CR_CHSEL(USART2_RX_DMA_CHANNEL) |
+                       STM32_DMA_CR_PL(STM32_SERIAL_USART2_DMA_PRIORITY) |
+                       STM32_DMA_CR_DIR_P2M | STM32_DMA_CR_MINC |
+                       STM32_DMA_CR_CIRC | STM32_DMA_CR_HTIE |
+                       STM32_DMA_CR_TCIE | STM32_DMA_CR_DMEIE |
+                       STM32_DMA_CR_TEIE;
+#if STM32_DMA_SUPPORTS_DMAMUX
+      dmaSetRequestSource(sdp->dmarx, STM32_DMAMUX1_USART2_RX);
+#endif
+#endif
     }
 #endif
 #if STM32_SERIAL_USE_USART3
     if (&SD3 == sdp) {
       rccEnableUSART3(true);
+#if STM32_SERIAL_USE_DMA_RX
+      bool b = dmaStreamAllocate(sdp->dmarx,
+                                 STM32_SERIAL_USART3_PRIORITY,
+                                 (stm32_dmaisr_t)serve_rx_dma_interrupt,
+                                 (void *)sdp);
+      osalDbgAssert(!b, "stream already allocated");
+      sdp->rxdmamode = STM32_DMA_CR_CHSEL(USART3_RX_DMA_CHANNEL) |
+                       STM32_DMA_CR_PL(STM32_SERIAL_USART3_DMA_PRIORITY) |
+                       STM32_DMA_CR_DIR_P2M | STM32_DMA_CR_MINC |
+                       STM32_DMA_CR_CIRC | STM32_DMA_CR_HTIE |
+                       STM32_DMA_CR_TCIE | STM32_DMA_CR_DMEIE |
+                       STM32_DMA_CR_TEIE;
+#if STM32_DMA_SUPPORTS_DMAMUX
+      dmaSetRequestSource(sdp->dmarx, STM32_DMAMUX1_USART3_RX);
+#endif
+#endif
     }
 #endif
 #if STM32_SERIAL_USE_UART4
     if (&SD4 == sdp) {
       rccEnableUART4(true);
+#if STM32_SERIAL_USE_DMA_RX
+      bool b = dmaStreamAllocate(sdp->dmarx,
+                                 STM32_SERIAL_UART4_PRIORITY,
+                                 (stm32_dmaisr_t)serve_rx_dma_interrupt,
+                                 (void *)sdp);
+      osalDbgAssert(!b, "stream already allocated");
+      sdp->rxdmamode = STM32_DMA_CR_CHSEL(UART4_RX_DMA_CHANNEL) |
+                       STM32_DMA_CR_PL(STM32_SERIAL_UART4_DMA_PRIORITY) |
+                       STM32_DMA_CR_DIR_P2M | STM32_DMA_CR_MINC |
+                       STM32_DMA_CR_CIRC | STM32_DMA_CR_HTIE |
+                       STM32_DMA_CR_TCIE | STM32_DMA_CR_DMEIE |
+                       STM32_DMA_CR_TEIE;
+#if STM32_DMA_SUPPORTS_DMAMUX
+      dmaSetRequestSource(sdp->dmarx, STM32_DMAMUX1_UART4_RX);
+#endif
+#endif
     }
 #endif
 #if STM32_SERIAL_USE_UART5
     if (&SD5 == sdp) {
       rccEnableUART5(true);
+#if STM32_SERIAL_USE_DMA_RX
+      bool b = dmaStreamAllocate(sdp->dmarx,
+                                 STM32_SERIAL_UART5_PRIORITY,
+                                 (stm32_dmaisr_t)serve_rx_dma_interrupt,
+                                 (void *)sdp);
+      osalDbgAssert(!b, "stream already allocated");
+      sdp->rxdmamode = STM32_DMA_CR_CHSEL(UART5_RX_DMA_CHANNEL) |
+                       STM32_DMA_CR_PL(STM32_SERIAL_UART5_DMA_PRIORITY) |
+                       STM32_DMA_CR_DIR_P2M | STM32_DMA_CR_MINC |
+                       STM32_DMA_CR_CIRC | STM32_DMA_CR_HTIE |
+                       STM32_DMA_CR_TCIE | STM32_DMA_CR_DMEIE |
+                       STM32_DMA_CR_TEIE;
+#if STM32_DMA_SUPPORTS_DMAMUX
+      dmaSetRequestSource(sdp->dmarx, STM32_DMAMUX1_UART5_RX);
+#endif
+#endif
     }
 #endif
 #if STM32_SERIAL_USE_USART6
     if (&SD6 == sdp) {
       rccEnableUSART6(true);
+#if STM32_SERIAL_USE_DMA_RX
+      bool b = dmaStreamAllocate(sdp->dmarx,
+                                 STM32_SERIAL_USART6_PRIORITY,
+                                 (stm32_dmaisr_t)serve_rx_dma_interrupt,
+                                 (void *)sdp);
+      osalDbgAssert(!b, "stream already allocated");
+      sdp->rxdmamode = STM32_DMA_CR_CHSEL(USART6_RX_DMA_CHANNEL) |
+                       STM32_DMA_CR_PL(STM32_SERIAL_USART6_DMA_PRIORITY) |
+                       STM32_DMA_CR_DIR_P2M | STM32_DMA_CR_MINC |
+                       STM32_DMA_CR_CIRC | STM32_DMA_CR_HTIE |
+                       STM32_DMA_CR_TCIE | STM32_DMA_CR_DMEIE |
+                       STM32_DMA_CR_TEIE;
+#if STM32_DMA_SUPPORTS_DMAMUX
+      dmaSetRequestSource(sdp->dmarx, STM32_DMAMUX1_USART6_RX);
+#endif
+#endif
     }
 #endif
 #if STM32_SERIAL_USE_UART7
     if (&SD7 == sdp) {
       rccEnableUART7(true);
+#if STM32_SERIAL_USE_DMA_RX
+      bool b = dmaStreamAllocate(sdp->dmarx,
+                                 STM32_SERIAL_UART7_PRIORITY,
+                                 (stm32_dmaisr_t)serve_rx_dma_interrupt,
+                                 (void *)sdp);
+      osalDbgAssert(!b, "stream already allocated");
+      sdp->rxdmamode = STM32_DMA_CR_CHSEL(UART7_RX_DMA_CHANNEL) |
+                       STM32_DMA_CR_PL(STM32_SERIAL_UART7_DMA_PRIORITY) |
+                       STM32_DMA_CR_DIR_P2M | STM32_DMA_CR_MINC |
+                       STM32_DMA_CR_CIRC | STM32_DMA_CR_HTIE |
+                       STM32_DMA_CR_TCIE | STM32_DMA_CR_DMEIE |
+                       STM32_DMA_CR_TEIE;
+#if STM32_DMA_SUPPORTS_DMAMUX
+      dmaSetRequestSource(sdp->dmarx, STM32_DMAMUX1_UART7_RX);
+#endif
+#endif
     }
 #endif
 #if STM32_SERIAL_USE_UART8
     if (&SD8 == sdp) {
       rccEnableUART8(true);
+#if STM32_SERIAL_USE_DMA_RX
+      bool b = dmaStreamAllocate(sdp->dmarx,
+                                 STM32_SERIAL_UART8_PRIORITY,
+                                 (stm32_dmaisr_t)serve_rx_dma_interrupt,
+                                 (void *)sdp);
+      osalDbgAssert(!b, "stream already allocated");
+      sdp->rxdmamode = STM32_DMA_CR_CHSEL(UART8_RX_DMA_CHANNEL) |
+                       STM32_DMA_CR_PL(STM32_SERIAL_UART8_DMA_PRIORITY) |
+                       STM32_DMA_CR_DIR_P2M | STM32_DMA_CR_MINC |
+                       STM32_DMA_CR_CIRC | STM32_DMA_CR_HTIE |
+                       STM32_DMA_CR_TCIE | STM32_DMA_CR_DMEIE |
+                       STM32_DMA_CR_TEIE;
+#if STM32_DMA_SUPPORTS_DMAMUX
+      dmaSetRequestSource(sdp->dmarx, STM32_DMAMUX1_UART8_RX);
+#endif
+#endif
     }
 #endif
 #if STM32_SERIAL_USE_LPUART1
@@ -873,6 +1281,14 @@ void sd_lld_stop(SerialDriver *sdp) {
     /* UART is de-initialized then clocks are disabled.*/
     usart_deinit(sdp->usart);
 
+#if STM32_SERIAL_USE_DMA_RX
+    /* The RX DMA stream, if any, is released.*/
+    if (sdp->dmarx != NULL) {
+      dmaStreamDisable(sdp->dmarx);
+      dmaStreamRelease(sdp->dmarx);
+    }
+#endif
+
 #if STM32_SERIAL_USE_USART1
     if (&SD1 == sdp) {
       rccDisableUSART1();
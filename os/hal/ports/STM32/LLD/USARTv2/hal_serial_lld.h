@@ -325,6 +325,92 @@
 #if !defined(STM32_SERIAL_LPUART1_OUT_BUF_SIZE) || defined(__DOXYGEN__)
 #define STM32_SERIAL_LPUART1_OUT_BUF_SIZE   SERIAL_BUFFERS_SIZE
 #endif
+
+/**
+ * @brief   RX DMA mode switch.
+ * @details If set to @p TRUE the USART/UART drivers receive data using a
+ *          circular DMA buffer, the data is moved to the input queue in
+ *          blocks on the DMA half and full transfer interrupts and on the
+ *          USART idle line interrupt. LPUART1 is not affected.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_SERIAL_USE_DMA_RX) || defined(__DOXYGEN__)
+#define STM32_SERIAL_USE_DMA_RX             FALSE
+#endif
+
+/**
+ * @brief   Size of the RX DMA circular buffers.
+ * @note    The size must be even, data is moved to the input queue in
+ *          blocks of at most half this size.
+ */
+#if !defined(STM32_SERIAL_DMA_RX_BUF_SIZE) || defined(__DOXYGEN__)
+#define STM32_SERIAL_DMA_RX_BUF_SIZE        64
+#endif
+
+/**
+ * @brief   USART1 RX DMA priority (0..3|lowest..highest).
+ */
+#if !defined(STM32_SERIAL_USART1_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_SERIAL_USART1_DMA_PRIORITY    0
+#endif
+
+/**
+ * @brief   USART2 RX DMA priority (0..3|lowest..highest).
+ */
+#if !defined(STM32_SERIAL_USART2_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_SERIAL_USART2_DMA_PRIORITY    0
+#endif
+
+/**
+ * @brief   USART3 RX DMA priority (0..3|lowest..highest).
+ */
+#if !defined(STM32_SERIAL_USART3_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_SERIAL_USART3_DMA_PRIORITY    0
+#endif
+
+/**
+ * @brief   UART4 RX DMA priority (0..3|lowest..highest).
+ */
+#if !defined(STM32_SERIAL_UART4_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_SERIAL_UART4_DMA_PRIORITY     0
+#endif
+
+/**
+ * @brief   UART5 RX DMA priority (0..3|lowest..highest).
+ */
+#if !defined(STM32_SERIAL_UART5_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_SERIAL_UART5_DMA_PRIORITY     0
+#endif
+
+/**
+ * @brief   USART6 RX DMA priority (0..3|lowest..highest).
+ */
+#if !defined(STM32_SERIAL_USART6_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_SERIAL_USART6_DMA_PRIORITY    0
+#endif
+
+/**
+ * @brief   UART7 RX DMA priority (0..3|lowest..highest).
+ */
+#if !defined(STM32_SERIAL_UART7_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_SERIAL_UART7_DMA_PRIORITY     0
+#endif
+
+/**
+ * @brief   UART8 RX DMA priority (0..3|lowest..highest).
+ */
+#if !defined(STM32_SERIAL_UART8_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_SERIAL_UART8_DMA_PRIORITY     0
+#endif
+
+/**
+ * @brief   Serial RX DMA error hook.
+ * @note    The default action for DMA errors is a system halt because DMA
+ *          error can only happen because programming errors.
+ */
+#if !defined(STM32_SERIAL_DMA_ERROR_HOOK) || defined(__DOXYGEN__)
+#define STM32_SERIAL_DMA_ERROR_HOOK(sdp)    osalSysHalt("DMA failure")
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -433,6 +519,222 @@
 #error "Invalid IRQ priority assigned to LPUART1"
 #endif
 
+#if STM32_SERIAL_USE_DMA_RX || defined(__DOXYGEN__)
+
+#if (STM32_SERIAL_DMA_RX_BUF_SIZE < 2) ||                                   \
+    ((STM32_SERIAL_DMA_RX_BUF_SIZE & 1) != 0)
+#error "invalid STM32_SERIAL_DMA_RX_BUF_SIZE value"
+#endif
+
+#if STM32_SERIAL_USE_USART1 &&                                              \
+    !STM32_DMA_IS_VALID_PRIORITY(STM32_SERIAL_USART1_DMA_PRIORITY)
+#error "Invalid DMA priority assigned to USART1"
+#endif
+
+#if STM32_SERIAL_USE_USART2 &&                                              \
+    !STM32_DMA_IS_VALID_PRIORITY(STM32_SERIAL_USART2_DMA_PRIORITY)
+#error "Invalid DMA priority assigned to USART2"
+#endif
+
+#if STM32_SERIAL_USE_USART3 &&                                              \
+    !STM32_DMA_IS_VALID_PRIORITY(STM32_SERIAL_USART3_DMA_PRIORITY)
+#error "Invalid DMA priority assigned to USART3"
+#endif
+
+#if STM32_SERIAL_USE_UART4 &&                                               \
+    !STM32_DMA_IS_VALID_PRIORITY(STM32_SERIAL_UART4_DMA_PRIORITY)
+#error "Invalid DMA priority assigned to UART4"
+#endif
+
+#if STM32_SERIAL_USE_UART5 &&                                               \
+    !STM32_DMA_IS_VALID_PRIORITY(STM32_SERIAL_UART5_DMA_PRIORITY)
+#error "Invalid DMA priority assigned to UART5"
+#endif
+
+#if STM32_SERIAL_USE_USART6 &&                                              \
+    !STM32_DMA_IS_VALID_PRIORITY(STM32_SERIAL_USART6_DMA_PRIORITY)
+#error "Invalid DMA priority assigned to USART6"
+#endif
+
+#if STM32_SERIAL_USE_UART7 &&                                               \
+    !STM32_DMA_IS_VALID_PRIORITY(STM32_SERIAL_UART7_DMA_PRIORITY)
+#error "Invalid DMA priority assigned to UART7"
+#endif
+
+#if STM32_SERIAL_USE_UART8 &&                                               \
+    !STM32_DMA_IS_VALID_PRIORITY(STM32_SERIAL_UART8_DMA_PRIORITY)
+#error "Invalid DMA priority assigned to UART8"
+#endif
+
+/* Devices with DMAMUX require a different kind of check.*/
+#if STM32_DMA_SUPPORTS_DMAMUX
+
+/* Check on the presence of the DMA channel settings in mcuconf.h.*/
+#if STM32_SERIAL_USE_USART1 && !defined(STM32_SERIAL_USART1_RX_DMA_CHANNEL)
+#error "USART1 RX DMA channel not defined"
+#endif
+
+#if STM32_SERIAL_USE_USART2 && !defined(STM32_SERIAL_USART2_RX_DMA_CHANNEL)
+#error "USART2 RX DMA channel not defined"
+#endif
+
+#if STM32_SERIAL_USE_USART3 && !defined(STM32_SERIAL_USART3_RX_DMA_CHANNEL)
+#error "USART3 RX DMA channel not defined"
+#endif
+
+#if STM32_SERIAL_USE_UART4 && !defined(STM32_SERIAL_UART4_RX_DMA_CHANNEL)
+#error "UART4 RX DMA channel not defined"
+#endif
+
+#if STM32_SERIAL_USE_UART5 && !defined(STM32_SERIAL_UART5_RX_DMA_CHANNEL)
+#error "UART5 RX DMA channel not defined"
+#endif
+
+#if STM32_SERIAL_USE_USART6 && !defined(STM32_SERIAL_USART6_RX_DMA_CHANNEL)
+#error "USART6 RX DMA channel not defined"
+#endif
+
+#if STM32_SERIAL_USE_UART7 && !defined(STM32_SERIAL_UART7_RX_DMA_CHANNEL)
+#error "UART7 RX DMA channel not defined"
+#endif
+
+#if STM32_SERIAL_USE_UART8 && !defined(STM32_SERIAL_UART8_RX_DMA_CHANNEL)
+#error "UART8 RX DMA channel not defined"
+#endif
+
+/* Check on the validity of the assigned DMA channels.*/
+#if STM32_SERIAL_USE_USART1 &&                                              \
+    !STM32_DMA_IS_VALID_CHANNEL(STM32_SERIAL_USART1_RX_DMA_CHANNEL)
+#error "Invalid DMA channel assigned to USART1 RX"
+#endif
+
+#if STM32_SERIAL_USE_USART2 &&                                              \
+    !STM32_DMA_IS_VALID_CHANNEL(STM32_SERIAL_USART2_RX_DMA_CHANNEL)
+#error "Invalid DMA channel assigned to USART2 RX"
+#endif
+
+#if STM32_SERIAL_USE_USART3 &&                                              \
+    !STM32_DMA_IS_VALID_CHANNEL(STM32_SERIAL_USART3_RX_DMA_CHANNEL)
+#error "Invalid DMA channel assigned to USART3 RX"
+#endif
+
+#if STM32_SERIAL_USE_UART4 &&                                               \
+    !STM32_DMA_IS_VALID_CHANNEL(STM32_SERIAL_UART4_RX_DMA_CHANNEL)
+#error "Invalid DMA channel assigned to UART4 RX"
+#endif
+
+#if STM32_SERIAL_USE_UART5 &&                                               \
+    !STM32_DMA_IS_VALID_CHANNEL(STM32_SERIAL_UART5_RX_DMA_CHANNEL)
+#error "Invalid DMA channel assigned to UART5 RX"
+#endif
+
+#if STM32_SERIAL_USE_USART6 &&                                              \
+    !STM32_DMA_IS_VALID_CHANNEL(STM32_SERIAL_USART6_RX_DMA_CHANNEL)
+#error "Invalid DMA channel assigned to USART6 RX"
+#endif
+
+#if STM32_SERIAL_USE_UART7 &&                                               \
+    !STM32_DMA_IS_VALID_CHANNEL(STM32_SERIAL_UART7_RX_DMA_CHANNEL)
+#error "Invalid DMA channel assigned to UART7 RX"
+#endif
+
+#if STM32_SERIAL_USE_UART8 &&                                               \
+    !STM32_DMA_IS_VALID_CHANNEL(STM32_SERIAL_UART8_RX_DMA_CHANNEL)
+#error "Invalid DMA channel assigned to UART8 RX"
+#endif
+
+#else /* !STM32_DMA_SUPPORTS_DMAMUX */
+
+/* Check on the presence of the DMA streams settings in mcuconf.h.*/
+#if STM32_SERIAL_USE_USART1 && !defined(STM32_SERIAL_USART1_RX_DMA_STREAM)
+#error "USART1 RX DMA stream not defined"
+#endif
+
+#if STM32_SERIAL_USE_USART2 && !defined(STM32_SERIAL_USART2_RX_DMA_STREAM)
+#error "USART2 RX DMA stream not defined"
+#endif
+
+#if STM32_SERIAL_USE_USART3 && !defined(STM32_SERIAL_USART3_RX_DMA_STREAM)
+#error "USART3 RX DMA stream not defined"
+#endif
+
+#if STM32_SERIAL_USE_UART4 && !defined(STM32_SERIAL_UART4_RX_DMA_STREAM)
+#error "UART4 RX DMA stream not defined"
+#endif
+
+#if STM32_SERIAL_USE_UART5 && !defined(STM32_SERIAL_UART5_RX_DMA_STREAM)
+#error "UART5 RX DMA stream not defined"
+#endif
+
+#if STM32_SERIAL_USE_USART6 && !defined(STM32_SERIAL_USART6_RX_DMA_STREAM)
+#error "USART6 RX DMA stream not defined"
+#endif
+
+#if STM32_SERIAL_USE_UART7 && !defined(STM32_SERIAL_UART7_RX_DMA_STREAM)
+#error "UART7 RX DMA stream not defined"
+#endif
+
+#if STM32_SERIAL_USE_UART8 && !defined(STM32_SERIAL_UART8_RX_DMA_STREAM)
+#error "UART8 RX DMA stream not defined"
+#endif
+
+/* Check on the validity of the assigned DMA streams.*/
+#if STM32_SERIAL_USE_USART1 &&                                              \
+    !STM32_DMA_IS_VALID_ID(STM32_SERIAL_USART1_RX_DMA_STREAM,               \
+                           STM32_USART1_RX_DMA_MSK)
+#error "invalid DMA stream associated to USART1 RX"
+#endif
+
+#if STM32_SERIAL_USE_USART2 &&                                              \
+    !STM32_DMA_IS_VALID_ID(STM32_SERIAL_USART2_RX_DMA_STREAM,               \
+                           STM32_USART2_RX_DMA_MSK)
+#error "invalid DMA stream associated to USART2 RX"
+#endif
+
+#if STM32_SERIAL_USE_USART3 &&                                              \
+    !STM32_DMA_IS_VALID_ID(STM32_SERIAL_USART3_RX_DMA_STREAM,               \
+                           STM32_USART3_RX_DMA_MSK)
+#error "invalid DMA stream associated to USART3 RX"
+#endif
+
+#if STM32_SERIAL_USE_UART4 &&                                               \
+    !STM32_DMA_IS_VALID_ID(STM32_SERIAL_UART4_RX_DMA_STREAM,                \
+                           STM32_UART4_RX_DMA_MSK)
+#error "invalid DMA stream associated to UART4 RX"
+#endif
+
+#if STM32_SERIAL_USE_UART5 &&                                               \
+    !STM32_DMA_IS_VALID_ID(STM32_SERIAL_UART5_RX_DMA_STREAM,                \
+                           STM32_UART5_RX_DMA_MSK)
+#error "invalid DMA stream associated to UART5 RX"
+#endif
+
+#if STM32_SERIAL_USE_USART6 &&                                              \
+    !STM32_DMA_IS_VALID_ID(STM32_SERIAL_USART6_RX_DMA_STREAM,               \
+                           STM32_USART6_RX_DMA_MSK)
+#error "invalid DMA stream associated to USART6 RX"
+#endif
+
+#if STM32_SERIAL_USE_UART7 &&                                               \
+    !STM32_DMA_IS_VALID_ID(STM32_SERIAL_UART7_RX_DMA_STREAM,                \
+                           STM32_UART7_RX_DMA_MSK)
+#error "invalid DMA stream associated to UART7 RX"
+#endif
+
+#if STM32_SERIAL_USE_UART8 &&                                               \
+    !STM32_DMA_IS_VALID_ID(STM32_SERIAL_UART8_RX_DMA_STREAM,                \
+                           STM32_UART8_RX_DMA_MSK)
+#error "invalid DMA stream associated to UART8 RX"
+#endif
+
+#endif /* !STM32_DMA_SUPPORTS_DMAMUX */
+
+#if !defined(STM32_DMA_REQUIRED)
+#define STM32_DMA_REQUIRED
+#endif
+
+#endif /* STM32_SERIAL_USE_DMA_RX */
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -461,10 +763,38 @@ typedef struct {
   uint32_t                  cr2;
   /**
    * @brief Initialization value for the CR3 register.
+   * @note  The RS-485 hardware driver enable is activated by setting
+   *        @p USART_CR3_DEM, the assertion and deassertion times are
+   *        specified in the @p DEAT and @p DEDT fields of @p cr1.
    */
   uint32_t                  cr3;
+  /**
+   * @brief Receiver timeout in bit times, zero disables it.
+   * @details The end of a received frame is notified by @p SD_FRAME_END
+   *          after the line has been idle for the specified time, the
+   *          received data is already in the input queue.
+   * @note  Not all the USARTs support the receiver timeout.
+   */
+  uint32_t                  timeout;
 } SerialConfig;
 
+#if STM32_SERIAL_USE_DMA_RX || defined(__DOXYGEN__)
+/**
+ * @brief   @p SerialDriver RX DMA specific data.
+ */
+#define _serial_driver_rx_dma_data                                          \
+  /* RX DMA stream or @p NULL if the interrupt mode is used.*/              \
+  const stm32_dma_stream_t  *dmarx;                                         \
+  /* RX DMA mode bit mask.*/                                                \
+  uint32_t                  rxdmamode;                                      \
+  /* RX DMA circular buffer.*/                                              \
+  uint8_t                   *rxdmabuf;                                      \
+  /* Position of the next byte to be moved from the RX DMA buffer.*/        \
+  size_t                    rxdmapos;
+#else
+#define _serial_driver_rx_dma_data
+#endif
+
 /**
  * @brief   @p SerialDriver specific data.
  */
@@ -482,7 +812,8 @@ typedef struct {
   /* Clock frequency for the associated USART/UART.*/                       \
   uint32_t                  clock;                                          \
   /* Mask to be applied on received frames.*/                               \
-  uint8_t                   rxmask;
+  uint8_t                   rxmask;                                         \
+  _serial_driver_rx_dma_data
 
 /*===========================================================================*/
 /* Driver macros.                                                            */
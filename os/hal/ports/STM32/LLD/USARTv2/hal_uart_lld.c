@@ -22,6 +22,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 
 #if HAL_USE_UART || defined(__DOXYGEN__)
@@ -207,6 +209,75 @@ static uartflags_t translate_errors(uint32_t isr) {
   return sts;
 }
 
+#if (CACHE_DMA_MAINTENANCE_ENABLED == TRUE) ||                              \
+    (UART_USE_RX_CIRCULAR == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Size in bytes of a DMA transfer.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] n         number of data frames
+ * @return              The transfer size in bytes.
+ */
+static size_t uart_lld_dma_size(UARTDriver *uartp, size_t n) {
+
+  if ((uartp->dmamode & STM32_DMA_CR_MSIZE_MASK) == STM32_DMA_CR_MSIZE_HWORD) {
+    return n * 2U;
+  }
+  return n;
+}
+#endif
+
+#if (UART_USE_RX_CIRCULAR == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Index of the next frame to be written by the circular receiver.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @return              The write index.
+ */
+static size_t uart_lld_circular_wrptr(UARTDriver *uartp) {
+  size_t wrptr;
+
+  wrptr = uartp->rxcsize - dmaStreamGetTransactionSize(uartp->dmarx);
+
+  /* The counter could be observed at zero before being reloaded.*/
+  if (wrptr >= uartp->rxcsize) {
+    wrptr = 0U;
+  }
+
+  return wrptr;
+}
+
+/**
+ * @brief   Delivers the frames received in circular mode.
+ * @details The frames received since the previous event are passed to the
+ *          data callback, if defined, then the waiting thread is woken up.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ */
+static void uart_serve_rx_circular(UARTDriver *uartp) {
+  uartdcb_t cb = uartp->config->rxdata_cb;
+
+  if (cb != NULL) {
+    size_t wrptr = uart_lld_circular_wrptr(uartp);
+
+    while (uartp->rxcrdptr != wrptr) {
+      size_t rdptr = uartp->rxcrdptr;
+      size_t n = (wrptr > rdptr ? wrptr : uartp->rxcsize) - rdptr;
+      uint8_t *bp = uartp->rxcbuf + uart_lld_dma_size(uartp, rdptr);
+
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+      cacheDMAAfterRx(bp, uart_lld_dma_size(uartp, n));
+#endif
+      cb(uartp, bp, n);
+      rdptr += n;
+      uartp->rxcrdptr = rdptr >= uartp->rxcsize ? 0U : rdptr;
+    }
+  }
+
+  _uart_wakeup_rx_complete_isr(uartp);
+}
+#endif /* UART_USE_RX_CIRCULAR == TRUE */
+
 /**
  * @brief   Puts the receiver in the UART_RX_IDLE state.
  *
@@ -221,6 +292,10 @@ static void uart_enter_rx_idle_loop(UARTDriver *uartp) {
     mode = STM32_DMA_CR_DIR_P2M | STM32_DMA_CR_CIRC;
   else
     mode = STM32_DMA_CR_DIR_P2M | STM32_DMA_CR_CIRC | STM32_DMA_CR_TCIE;
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  /* The idle buffer has its own cache line.*/
+  cacheDMABeforeRx(&uartp->rxbuf, CACHE_LINE_SIZE);
+#endif
   dmaStreamSetMemory0(uartp->dmarx, &uartp->rxbuf);
   dmaStreamSetTransactionSize(uartp->dmarx, 1);
   dmaStreamSetMode(uartp->dmarx, uartp->dmamode | mode);
@@ -253,7 +328,7 @@ static void usart_stop(UARTDriver *uartp) {
  */
 static void usart_start(UARTDriver *uartp) {
   uint32_t fck;
-  uint32_t cr1;
+  uint32_t cr1, cr2;
   const uint32_t tmo = uartp->config->timeout;
   USART_TypeDef *u = uartp->usart;
 
@@ -273,24 +348,28 @@ static void usart_start(UARTDriver *uartp) {
   /* Resetting eventual pending status flags.*/
   u->ICR = 0xFFFFFFFFU;
 
+  /* Set receive timeout and checks if it is really applied, the timeout
+     and its interrupt are enabled together.*/
+  cr1 = USART_CR1_UE | USART_CR1_PEIE | USART_CR1_TE | USART_CR1_RE;
+  cr2 = USART_CR2_LBDIE;
+  if (tmo > 0) {
+    osalDbgAssert(tmo <= USART_RTOR_RTO, "Timeout overflow");
+    u->RTOR = tmo;
+    osalDbgAssert(tmo == u->RTOR, "Timeout feature unsupported in this UART");
+    cr1 |= USART_CR1_RTOIE;
+    cr2 |= USART_CR2_RTOEN;
+  }
+
   /* Note that some bits are enforced because required for correct driver
      operations.*/
-  u->CR2 = uartp->config->cr2 | USART_CR2_LBDIE;
+  u->CR2 = uartp->config->cr2 | cr2;
   u->CR3 = uartp->config->cr3 | USART_CR3_DMAT | USART_CR3_DMAR |
                                 USART_CR3_EIE;
 
   /* Mustn't ever set TCIE here - if done, it causes an immediate
      interrupt.*/
-  cr1 = USART_CR1_UE | USART_CR1_PEIE | USART_CR1_TE | USART_CR1_RE;
   u->CR1 = uartp->config->cr1 | cr1;
 
-  /* Set receive timeout and checks if it is really applied.*/
-  if (tmo > 0) {
-    osalDbgAssert(tmo <= USART_RTOR_RTO, "Timeout overflow");
-    u->RTOR = tmo;
-    osalDbgAssert(tmo == u->RTOR, "Timeout feature unsupported in this UART");
-  }
-
   /* Starting the receiver idle loop.*/
   uart_enter_rx_idle_loop(uartp);
 }
@@ -312,15 +391,29 @@ static void uart_lld_serve_rx_end_irq(UARTDriver *uartp, uint32_t flags) {
   (void)flags;
 #endif
 
+#if UART_USE_RX_CIRCULAR == TRUE
+  if (uartp->rxstate == UART_RX_CIRCULAR) {
+    /* Circular receiver, half or full buffer event.*/
+    uart_serve_rx_circular(uartp);
+    return;
+  }
+#endif
+
   if (uartp->rxstate == UART_RX_IDLE) {
     /* Receiver in idle state, a callback is generated, if enabled, for each
        received character and then the driver stays in the same state.*/
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+    cacheDMAAfterRx(&uartp->rxbuf, CACHE_LINE_SIZE);
+#endif
     _uart_rx_idle_code(uartp);
   }
   else {
     /* Receiver in active state, a callback is generated, if enabled, after
        a completed transfer.*/
     dmaStreamDisable(uartp->dmarx);
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+    cacheDMAAfterRx(uartp->rxdmabuf, uartp->rxdmasize);
+#endif
     _uart_rx_complete_isr_code(uartp);
   }
 }
@@ -378,8 +471,21 @@ static void serve_usart_irq(UARTDriver *uartp) {
   /* Timeout interrupt sources are only checked if enabled in CR1.*/
   if (((cr1 & USART_CR1_IDLEIE) && (isr & USART_ISR_IDLE)) ||
       ((cr1 & USART_CR1_RTOIE) && (isr & USART_ISR_RTOF))) {
+#if UART_USE_RX_CIRCULAR == TRUE
+    if (uartp->rxstate == UART_RX_CIRCULAR) {
+      uart_serve_rx_circular(uartp);
+    }
+#endif
     _uart_timeout_isr_code(uartp);
   }
+
+#if UART_USE_RX_CIRCULAR == TRUE
+  /* Character match is only handled in circular mode.*/
+  if ((cr1 & USART_CR1_CMIE) && (isr & USART_ISR_CMF) &&
+      (uartp->rxstate == UART_RX_CIRCULAR)) {
+    uart_serve_rx_circular(uartp);
+  }
+#endif
 }
 
 /*===========================================================================*/
@@ -1027,6 +1133,10 @@ void uart_lld_stop(UARTDriver *uartp) {
  */
 void uart_lld_start_send(UARTDriver *uartp, size_t n, const void *txbuf) {
 
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  cacheDMABeforeTx(txbuf, uart_lld_dma_size(uartp, n));
+#endif
+
   /* TX DMA channel preparation.*/
   dmaStreamSetMemory0(uartp->dmatx, txbuf);
   dmaStreamSetTransactionSize(uartp->dmatx, n);
@@ -1083,6 +1193,12 @@ void uart_lld_start_receive(UARTDriver *uartp, size_t n, void *rxbuf) {
   /* Stopping previous activity (idle state).*/
   dmaStreamDisable(uartp->dmarx);
 
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  uartp->rxdmabuf  = (uint8_t *)rxbuf;
+  uartp->rxdmasize = uart_lld_dma_size(uartp, n);
+  cacheDMABeforeRx(rxbuf, uartp->rxdmasize);
+#endif
+
   /* RX DMA channel preparation.*/
   dmaStreamSetMemory0(uartp->dmarx, rxbuf);
   dmaStreamSetTransactionSize(uartp->dmarx, n);
@@ -1109,11 +1225,107 @@ size_t uart_lld_stop_receive(UARTDriver *uartp) {
 
   dmaStreamDisable(uartp->dmarx);
   n = dmaStreamGetTransactionSize(uartp->dmarx);
+#if UART_USE_RX_CIRCULAR == TRUE
+  if (uartp->rxstate == UART_RX_CIRCULAR) {
+    /* Restoring the configured idle interrupt setting.*/
+    uartp->usart->CR1 = (uartp->usart->CR1 & ~USART_CR1_IDLEIE) |
+                        (uartp->config->cr1 & USART_CR1_IDLEIE);
+    uart_enter_rx_idle_loop(uartp);
+
+    return n;
+  }
+#endif
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  /* The data received so far is made visible.*/
+  cacheDMAAfterRx(uartp->rxdmabuf, uartp->rxdmasize);
+#endif
   uart_enter_rx_idle_loop(uartp);
 
   return n;
 }
 
+#if (UART_USE_RX_CIRCULAR == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a circular receive operation on the UART peripheral.
+ * @details The RX DMA stream is put in circular mode with half and full
+ *          transfer interrupts, the USART idle interrupt is enabled for
+ *          the duration of the operation.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] n         size of the circular buffer in data frames
+ * @param[out] rxbuf    the pointer to the circular buffer
+ *
+ * @notapi
+ */
+void uart_lld_start_receive_circular(UARTDriver *uartp,
+                                     size_t n, void *rxbuf) {
+
+  /* Stopping previous activity (idle state).*/
+  dmaStreamDisable(uartp->dmarx);
+
+  uartp->rxcbuf   = (uint8_t *)rxbuf;
+  uartp->rxcsize  = n;
+  uartp->rxcrdptr = 0U;
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+  uartp->rxdmabuf  = (uint8_t *)rxbuf;
+  uartp->rxdmasize = uart_lld_dma_size(uartp, n);
+  cacheDMABeforeRx(rxbuf, uartp->rxdmasize);
+#endif
+
+  /* RX DMA channel preparation.*/
+  dmaStreamSetMemory0(uartp->dmarx, rxbuf);
+  dmaStreamSetTransactionSize(uartp->dmarx, n);
+  dmaStreamSetMode(uartp->dmarx, uartp->dmamode    | STM32_DMA_CR_DIR_P2M |
+                                 STM32_DMA_CR_MINC | STM32_DMA_CR_CIRC    |
+                                 STM32_DMA_CR_HTIE | STM32_DMA_CR_TCIE);
+
+  /* Line idle detection.*/
+  uartp->usart->ICR = USART_ICR_IDLECF;
+  uartp->usart->CR1 |= USART_CR1_IDLEIE;
+
+  /* Starting transfer.*/
+  dmaStreamEnable(uartp->dmarx);
+}
+
+/**
+ * @brief   Reads the frames received in circular mode.
+ * @note    The buffers are organized as uint8_t arrays for data sizes below
+ *          or equal to 8 bits else it is organized as uint16_t arrays.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[out] rxbuf    the pointer to the receive buffer
+ * @param[in] n         maximum number of data frames to read
+ * @return              The number of data frames read.
+ *
+ * @notapi
+ */
+size_t uart_lld_read_circular(UARTDriver *uartp, void *rxbuf, size_t n) {
+  size_t wrptr = uart_lld_circular_wrptr(uartp);
+  uint8_t *dp = (uint8_t *)rxbuf;
+  size_t done = 0U;
+
+  while ((done < n) && (uartp->rxcrdptr != wrptr)) {
+    size_t rdptr = uartp->rxcrdptr;
+    size_t chunk = (wrptr > rdptr ? wrptr : uartp->rxcsize) - rdptr;
+    uint8_t *bp = uartp->rxcbuf + uart_lld_dma_size(uartp, rdptr);
+
+    if (chunk > n - done) {
+      chunk = n - done;
+    }
+#if CACHE_DMA_MAINTENANCE_ENABLED == TRUE
+    cacheDMAAfterRx(bp, uart_lld_dma_size(uartp, chunk));
+#endif
+    memcpy(dp, bp, uart_lld_dma_size(uartp, chunk));
+    dp   += uart_lld_dma_size(uartp, chunk);
+    done += chunk;
+    rdptr += chunk;
+    uartp->rxcrdptr = rdptr >= uartp->rxcsize ? 0U : rdptr;
+  }
+
+  return done;
+}
+#endif /* UART_USE_RX_CIRCULAR == TRUE */
+
 #endif /* HAL_USE_UART */
 
 /** @} */
@@ -31,6 +31,11 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   This driver supports the circular receive mode.
+ */
+#define UART_LLD_SUPPORTS_RX_CIRCULAR       TRUE
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -705,6 +710,16 @@ typedef void (*uartccb_t)(UARTDriver *uartp, uint16_t c);
  */
 typedef void (*uartecb_t)(UARTDriver *uartp, uartflags_t e);
 
+/**
+ * @brief   Circular receive data UART notification callback type.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] buf       pointer to the received frames, inside the circular
+ *                      buffer
+ * @param[in] n         number of received frames
+ */
+typedef void (*uartdcb_t)(UARTDriver *uartp, const void *buf, size_t n);
+
 /**
  * @brief   Driver configuration structure.
  * @note    It could be empty on some architectures.
@@ -740,7 +755,9 @@ typedef struct {
   /**
    * @brief   Receiver timeout value in terms of number of bit duration.
    * @details Set it to 0 when you want to handle idle interrupt instead of
-   *          hardware timeout.
+   *          hardware timeout. A non-zero value enables the receiver timeout
+   *          and its interrupt, a waiting receive operation is terminated
+   *          with @p MSG_TIMEOUT at the end of a frame.
    */
   uint32_t                  timeout;
   /**
@@ -757,8 +774,21 @@ typedef struct {
   uint32_t                  cr2;
   /**
    * @brief   Initialization value for the CR3 register.
+   * @note    The RS-485 hardware driver enable is activated by setting
+   *          @p USART_CR3_DEM, the assertion and deassertion times are
+   *          specified in the @p DEAT and @p DEDT fields of @p cr1.
    */
   uint32_t                  cr3;
+#if (UART_USE_RX_CIRCULAR == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Circular receive data callback.
+   * @details Invoked with the received frames on line idle, on buffer half
+   *          and full and, if @p USART_CR1_CMIE is set in @p cr1, on match
+   *          of the character specified in the @p ADD field of @p cr2.
+   *          A wrapped block is delivered in two calls.
+   */
+  uartdcb_t                 rxdata_cb;
+#endif
 } UARTConfig;
 
 /**
@@ -825,10 +855,42 @@ struct UARTDriver {
    * @brief   Transmit DMA channel.
    */
   const stm32_dma_stream_t  *dmatx;
+#if (UART_USE_RX_CIRCULAR == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Circular receive buffer.
+   */
+  uint8_t                   *rxcbuf;
+  /**
+   * @brief   Size of the circular receive buffer in data frames.
+   */
+  size_t                    rxcsize;
+  /**
+   * @brief   Index of the first frame not yet consumed.
+   */
+  size_t                    rxcrdptr;
+#endif
+#if (CACHE_DMA_MAINTENANCE_ENABLED == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Receive buffer of the current receive operation.
+   */
+  uint8_t                   *rxdmabuf;
+  /**
+   * @brief   Size in bytes of the current receive operation.
+   */
+  size_t                    rxdmasize;
   /**
    * @brief   Default receive buffer while into @p UART_RX_IDLE state.
+   * @note    It is the last field and it is aligned to a cache line, this
+   *          makes it the only data in its line.
    */
+  ALIGNED_VAR(CACHE_LINE_SIZE)
   volatile uint16_t         rxbuf;
+#else
+  /**
+   * @brief   Default receive buffer while into @p UART_RX_IDLE state.
+   */
+  volatile uint16_t         rxbuf;
+#endif
 };
 
 /*===========================================================================*/
@@ -881,6 +943,11 @@ extern "C" {
   size_t uart_lld_stop_send(UARTDriver *uartp);
   void uart_lld_start_receive(UARTDriver *uartp, size_t n, void *rxbuf);
   size_t uart_lld_stop_receive(UARTDriver *uartp);
+#if UART_USE_RX_CIRCULAR == TRUE
+  void uart_lld_start_receive_circular(UARTDriver *uartp,
+                                       size_t n, void *rxbuf);
+  size_t uart_lld_read_circular(UARTDriver *uartp, void *rxbuf, size_t n);
+#endif
 #ifdef __cplusplus
 }
 #endif
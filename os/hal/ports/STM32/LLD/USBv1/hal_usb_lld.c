@@ -134,6 +134,12 @@ static size_t usb_packet_read_to_buffer(usbep_t ep, uint8_t *buf) {
 #if STM32_USB_USE_ISOCHRONOUS
   uint32_t epr = STM32_USB->EPR[ep];
 
+#if STM32_USB_ISO_SEPARATE_BUFFERS
+  /* The packet is read from the buffer matching the counter below.*/
+  if (EPR_EP_TYPE_IS_ISO(epr) && !(epr & EPR_DTOG_RX))
+    pmap = USB_ADDR2PTR(udp->RXADDR1);
+#endif
+
   /* Double buffering is always enabled for isochronous endpoints, and
      although we overlap the two buffers for simplicity, we still need
      to read from the right counter. The DTOG_RX bit indicates the buffer
@@ -220,6 +226,12 @@ static void usb_packet_write_from_buffer(usbep_t ep,
 #if STM32_USB_USE_ISOCHRONOUS
   uint32_t epr = STM32_USB->EPR[ep];
 
+#if STM32_USB_ISO_SEPARATE_BUFFERS
+  /* The packet is written in the buffer matching the counter below.*/
+  if (EPR_EP_TYPE_IS_ISO(epr) && (epr & EPR_DTOG_TX))
+    pmap = USB_ADDR2PTR(udp->TXADDR1);
+#endif
+
   /* Double buffering is always enabled for isochronous endpoints, and
      although we overlap the two buffers for simplicity, we still need
      to write to the right counter. The DTOG_TX bit indicates the buffer
@@ -610,7 +622,11 @@ void usb_lld_init_endpoint(USBDriver *usbp, usbep_t ep) {
     if (epr == EPR_EP_TYPE_ISO) {
       epr |= EPR_STAT_TX_VALID;
       dp->TXCOUNT1 = dp->TXCOUNT0;
+#if STM32_USB_ISO_SEPARATE_BUFFERS
+      dp->TXADDR1  = usb_pm_alloc(usbp, epcp->in_maxsize);
+#else
       dp->TXADDR1  = dp->TXADDR0;   /* Both buffers overlapped.*/
+#endif
     }
     else {
       epr |= EPR_STAT_TX_NAK;
@@ -637,7 +653,11 @@ void usb_lld_init_endpoint(USBDriver *usbp, usbep_t ep) {
     if (epr == EPR_EP_TYPE_ISO) {
       epr |= EPR_STAT_RX_VALID;
       dp->RXCOUNT1 = dp->RXCOUNT0;
+#if STM32_USB_ISO_SEPARATE_BUFFERS
+      dp->RXADDR1  = usb_pm_alloc(usbp, epcp->out_maxsize);
+#else
       dp->RXADDR1  = dp->RXADDR0;   /* Both buffers overlapped.*/
+#endif
     }
     else {
       epr |= EPR_STAT_RX_NAK;
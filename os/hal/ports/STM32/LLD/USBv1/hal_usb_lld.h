@@ -97,6 +97,17 @@
 #define STM32_USB_USE_ISOCHRONOUS           FALSE
 #endif
 
+/**
+ * @brief   Separate packet buffers for isochronous endpoints.
+ * @details If enabled the two hardware buffers of isochronous endpoints
+ *          are allocated separately in the packet memory, a received
+ *          packet can be read while the next one is being received.
+ * @note    Isochronous endpoints use twice the packet memory.
+ */
+#if !defined(STM32_USB_ISO_SEPARATE_BUFFERS) || defined(__DOXYGEN__)
+#define STM32_USB_ISO_SEPARATE_BUFFERS      FALSE
+#endif
+
 /**
  * @brief   Use faster copy for packets.
  * @note    Makes the driver larger.
@@ -135,6 +146,10 @@
 #error "Invalid IRQ priority assigned to USB LP"
 #endif
 
+#if STM32_USB_ISO_SEPARATE_BUFFERS && !STM32_USB_USE_ISOCHRONOUS
+#error "STM32_USB_ISO_SEPARATE_BUFFERS requires STM32_USB_USE_ISOCHRONOUS"
+#endif
+
 #if STM32_USBCLK != 48000000
 #error "the USB driver requires a 48MHz clock"
 #endif
@@ -198,6 +198,17 @@
 #define STM32_IRQ_EXTI10_15_PRIORITY        6
 #endif
 
+/**
+ * @brief   Serves all the GPIO EXTI lines from any EXTI vector.
+ * @details When enabled, each of the GPIO EXTI handlers serves all the
+ *          pending lines and clears the other vectors, a burst of edges
+ *          on many lines is then served in a single interrupt.
+ * @note    All the GPIO EXTI vectors should be assigned the same priority.
+ */
+#if !defined(STM32_EXTI_SHARED_SERVICE) || defined(__DOXYGEN__)
+#define STM32_EXTI_SHARED_SERVICE           FALSE
+#endif
+
 /**
  * @brief   EXTI16 interrupt priority level setting.
  */
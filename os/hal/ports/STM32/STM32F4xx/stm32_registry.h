@@ -277,6 +277,7 @@
 #define STM32_SPI2_RX_DMA_CHN               0x00000000
 #define STM32_SPI2_TX_DMA_MSK               STM32_DMA_STREAM_ID_MSK(1, 4)
 #define STM32_SPI2_TX_DMA_CHN               0x00000000
+#define STM32_SPI2_I2SEXT_RX_DMA_CHN        0x00003000
 
 #define STM32_HAS_SPI3                      TRUE
 #define STM32_SPI3_SUPPORTS_I2S             TRUE
@@ -287,6 +288,7 @@
 #define STM32_SPI3_TX_DMA_MSK               (STM32_DMA_STREAM_ID_MSK(1, 5) |\
                                              STM32_DMA_STREAM_ID_MSK(1, 7))
 #define STM32_SPI3_TX_DMA_CHN               0x00000000
+#define STM32_SPI3_I2SEXT_RX_DMA_CHN        0x00000203
 
 #define STM32_HAS_SPI4                      TRUE
 #define STM32_SPI4_SUPPORTS_I2S             FALSE
@@ -657,6 +659,7 @@
 #define STM32_SPI2_RX_DMA_CHN               0x00000000
 #define STM32_SPI2_TX_DMA_MSK               STM32_DMA_STREAM_ID_MSK(1, 4)
 #define STM32_SPI2_TX_DMA_CHN               0x00000000
+#define STM32_SPI2_I2SEXT_RX_DMA_CHN        0x00003000
 
 #define STM32_HAS_SPI3                      TRUE
 #define STM32_SPI3_SUPPORTS_I2S             TRUE
@@ -667,6 +670,7 @@
 #define STM32_SPI3_TX_DMA_MSK               (STM32_DMA_STREAM_ID_MSK(1, 5) |\
                                              STM32_DMA_STREAM_ID_MSK(1, 7))
 #define STM32_SPI3_TX_DMA_CHN               0x00000000
+#define STM32_SPI3_I2SEXT_RX_DMA_CHN        0x00000203
 
 #define STM32_HAS_SPI4                      TRUE
 #define STM32_SPI4_SUPPORTS_I2S             FALSE
@@ -1015,6 +1019,7 @@
 #define STM32_SPI2_RX_DMA_CHN               0x00000000
 #define STM32_SPI2_TX_DMA_MSK               STM32_DMA_STREAM_ID_MSK(1, 4)
 #define STM32_SPI2_TX_DMA_CHN               0x00000000
+#define STM32_SPI2_I2SEXT_RX_DMA_CHN        0x00003000
 
 #define STM32_HAS_SPI3                      TRUE
 #define STM32_SPI3_SUPPORTS_I2S             TRUE
@@ -1025,6 +1030,7 @@
 #define STM32_SPI3_TX_DMA_MSK               (STM32_DMA_STREAM_ID_MSK(1, 5) |\
                                              STM32_DMA_STREAM_ID_MSK(1, 7))
 #define STM32_SPI3_TX_DMA_CHN               0x00000000
+#define STM32_SPI3_I2SEXT_RX_DMA_CHN        0x00000203
 
 #define STM32_HAS_SPI4                      TRUE
 #define STM32_SPI4_SUPPORTS_I2S             FALSE
@@ -1397,6 +1403,7 @@
 #define STM32_SPI2_RX_DMA_CHN               0x00000000
 #define STM32_SPI2_TX_DMA_MSK               STM32_DMA_STREAM_ID_MSK(1, 4)
 #define STM32_SPI2_TX_DMA_CHN               0x00000000
+#define STM32_SPI2_I2SEXT_RX_DMA_CHN        0x00003000
 
 #define STM32_HAS_SPI3                      TRUE
 #define STM32_SPI3_SUPPORTS_I2S             TRUE
@@ -1407,6 +1414,7 @@
 #define STM32_SPI3_TX_DMA_MSK               (STM32_DMA_STREAM_ID_MSK(1, 5) |\
                                              STM32_DMA_STREAM_ID_MSK(1, 7))
 #define STM32_SPI3_TX_DMA_CHN               0x00000000
+#define STM32_SPI3_I2SEXT_RX_DMA_CHN        0x00000203
 
 #define STM32_HAS_SPI4                      TRUE
 #define STM32_SPI4_SUPPORTS_I2S             TRUE
@@ -1772,6 +1780,7 @@
 #define STM32_SPI2_RX_DMA_CHN               0x00000000
 #define STM32_SPI2_TX_DMA_MSK               STM32_DMA_STREAM_ID_MSK(1, 4)
 #define STM32_SPI2_TX_DMA_CHN               0x00000000
+#define STM32_SPI2_I2SEXT_RX_DMA_CHN        0x00003000
 
 #define STM32_HAS_SPI3                      TRUE
 #define STM32_SPI3_SUPPORTS_I2S             TRUE
@@ -1782,6 +1791,7 @@
 #define STM32_SPI3_TX_DMA_MSK               (STM32_DMA_STREAM_ID_MSK(1, 5) |\
                                              STM32_DMA_STREAM_ID_MSK(1, 7))
 #define STM32_SPI3_TX_DMA_CHN               0x00000000
+#define STM32_SPI3_I2SEXT_RX_DMA_CHN        0x00000203
 
 #define STM32_HAS_SPI4                      TRUE
 #define STM32_SPI4_SUPPORTS_I2S             FALSE
@@ -2104,6 +2114,7 @@
 #define STM32_SPI2_RX_DMA_CHN               0x00000000
 #define STM32_SPI2_TX_DMA_MSK               STM32_DMA_STREAM_ID_MSK(1, 4)
 #define STM32_SPI2_TX_DMA_CHN               0x00000000
+#define STM32_SPI2_I2SEXT_RX_DMA_CHN        0x00003000
 
 #define STM32_HAS_SPI3                      TRUE
 #define STM32_SPI3_SUPPORTS_I2S             TRUE
@@ -2114,6 +2125,7 @@
 #define STM32_SPI3_TX_DMA_MSK               (STM32_DMA_STREAM_ID_MSK(1, 5) |\
                                              STM32_DMA_STREAM_ID_MSK(1, 7))
 #define STM32_SPI3_TX_DMA_CHN               0x00000000
+#define STM32_SPI3_I2SEXT_RX_DMA_CHN        0x00000203
 
 #define STM32_HAS_SPI4                      TRUE
 #define STM32_SPI4_SUPPORTS_I2S             FALSE
@@ -2413,6 +2425,7 @@
 #define STM32_SPI2_RX_DMA_CHN               0x00000000
 #define STM32_SPI2_TX_DMA_MSK               STM32_DMA_STREAM_ID_MSK(1, 4)
 #define STM32_SPI2_TX_DMA_CHN               0x00000000
+#define STM32_SPI2_I2SEXT_RX_DMA_CHN        0x00003000
 
 #define STM32_HAS_SPI5                      TRUE
 #define STM32_SPI5_SUPPORTS_I2S             TRUE
@@ -2724,6 +2737,7 @@
 #define STM32_SPI2_RX_DMA_CHN               0x00000000
 #define STM32_SPI2_TX_DMA_MSK               STM32_DMA_STREAM_ID_MSK(1, 4)
 #define STM32_SPI2_TX_DMA_CHN               0x00000000
+#define STM32_SPI2_I2SEXT_RX_DMA_CHN        0x00003000
 
 #define STM32_HAS_SPI3                      TRUE
 #define STM32_SPI3_SUPPORTS_I2S             TRUE
@@ -2734,6 +2748,7 @@
 #define STM32_SPI3_TX_DMA_MSK               (STM32_DMA_STREAM_ID_MSK(1, 5) |\
                                              STM32_DMA_STREAM_ID_MSK(1, 7))
 #define STM32_SPI3_TX_DMA_CHN               0x00000000
+#define STM32_SPI3_I2SEXT_RX_DMA_CHN        0x00000203
 
 #define STM32_HAS_SPI4                      FALSE
 #define STM32_HAS_SPI5                      FALSE
@@ -3058,6 +3073,7 @@
 #define STM32_SPI2_RX_DMA_CHN               0x00000000
 #define STM32_SPI2_TX_DMA_MSK               STM32_DMA_STREAM_ID_MSK(1, 4)
 #define STM32_SPI2_TX_DMA_CHN               0x00000000
+#define STM32_SPI2_I2SEXT_RX_DMA_CHN        0x00003000
 
 #define STM32_HAS_SPI3                      TRUE
 #define STM32_SPI3_SUPPORTS_I2S             TRUE
@@ -3068,6 +3084,7 @@
 #define STM32_SPI3_TX_DMA_MSK               (STM32_DMA_STREAM_ID_MSK(1, 5) |\
                                              STM32_DMA_STREAM_ID_MSK(1, 7))
 #define STM32_SPI3_TX_DMA_CHN               0x00000000
+#define STM32_SPI3_I2SEXT_RX_DMA_CHN        0x00000203
 
 #define STM32_HAS_SPI4                      TRUE
 #define STM32_SPI4_SUPPORTS_I2S             FALSE
@@ -149,6 +149,11 @@ void hal_lld_init(void) {
   SCB_CleanInvalidateDCache();
 #endif
 
+#if CACHE_NOCACHE_POOL_SIZE > 0
+  /* Non-cacheable pool for DMA buffers.*/
+  cacheNocacheInit();
+#endif
+
   /* Programmable voltage detector enable.*/
 #if STM32_PVD_ENABLE
   PWR->CR1 |= PWR_CR1_PVDE | (STM32_PLS & STM32_PLS_MASK);
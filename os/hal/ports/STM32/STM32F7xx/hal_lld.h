@@ -2131,6 +2131,7 @@
 #include "mpu_v7m.h"
 #include "stm32_isr.h"
 #include "stm32_dma.h"
+#include "stm32_fmc.h"
 #include "stm32_rcc.h"
 
 #ifdef __cplusplus
@@ -0,0 +1,242 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    STM32F7xx/hal_pm_lld.c
+ * @brief   STM32F7xx PM subsystem low level driver source.
+ *
+ * @addtogroup PM
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_PM == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Wakeup timer clock frequency, RTCCLK/16 is used.
+ */
+#define PM_WUT_CLOCK                        (STM32_RTCCLK / 16U)
+
+/**
+ * @brief   Milliseconds in a day.
+ */
+#define PM_MS_PER_DAY                       86400000U
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Restores the clock tree after exiting the Stop mode.
+ * @details On exit from Stop the HSI is selected as system clock and the
+ *          HSE, the PLLs and the over-drive are switched off, the clock
+ *          settings are retained so only the sources need to be restarted.
+ */
+static void pm_restore_clocks(void) {
+
+#if STM32_HSE_ENABLED
+  RCC->CR |= RCC_CR_HSEON;
+  while ((RCC->CR & RCC_CR_HSERDY) == 0)
+    ;                           /* Waits until HSE is stable.               */
+#endif
+
+#if STM32_ACTIVATE_PLL
+  RCC->CR |= RCC_CR_PLLON;
+
+  /* Synchronization with voltage regulator stabilization.*/
+  while ((PWR->CSR1 & PWR_CSR1_VOSRDY) == 0)
+    ;                           /* Waits until power regulator is stable.   */
+
+#if STM32_OVERDRIVE_REQUIRED
+  PWR->CR1 |= PWR_CR1_ODEN;
+  while (!(PWR->CSR1 & PWR_CSR1_ODRDY))
+      ;
+  PWR->CR1 |= PWR_CR1_ODSWEN;
+  while (!(PWR->CSR1 & PWR_CSR1_ODSWRDY))
+      ;
+#endif /* STM32_OVERDRIVE_REQUIRED */
+
+  /* Waiting for PLL lock.*/
+  while (!(RCC->CR & RCC_CR_PLLRDY))
+    ;
+#endif /* STM32_ACTIVATE_PLL */
+
+#if STM32_ACTIVATE_PLLI2S
+  RCC->CR |= RCC_CR_PLLI2SON;
+  while (!(RCC->CR & RCC_CR_PLLI2SRDY))
+    ;
+#endif
+
+#if STM32_ACTIVATE_PLLSAI
+  RCC->CR |= RCC_CR_PLLSAION;
+  while (!(RCC->CR & RCC_CR_PLLSAIRDY))
+    ;
+#endif
+
+  /* Switching back to the configured clock source if it is different
+     from HSI.*/
+#if (STM32_SW != STM32_SW_HSI)
+  RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_SW) | STM32_SW;
+  while ((RCC->CFGR & RCC_CFGR_SWS) != (STM32_SW << 2))
+    ;
+#endif
+}
+
+/**
+ * @brief   Enters the Stop mode.
+ * @note    Invoked with the kernel locked and the interrupts disabled.
+ *
+ * @param[in] interval  time interval before the next timer event
+ */
+static void pm_enter_stop(sysinterval_t interval) {
+  RTCDateTime t0, t1;
+  uint32_t ms;
+
+  /* The wakeup timer is programmed to expire, minus the exit latency,
+     before the next timer event. Without armed timers only an external
+     event can wake up the system.*/
+  if (interval != TIME_INFINITE) {
+    RTCWakeup wakeup;
+    time_conv_t us, cnt;
+
+    us  = (time_conv_t)TIME_I2US(interval) -
+          (time_conv_t)STM32_PM_STOP_LATENCY;
+    cnt = (us * (time_conv_t)PM_WUT_CLOCK) / (time_conv_t)1000000;
+    if (cnt < (time_conv_t)1) {
+      cnt = (time_conv_t)1;
+    }
+    else if (cnt > (time_conv_t)65536) {
+      cnt = (time_conv_t)65536;
+    }
+    wakeup.wutr = (uint32_t)cnt - 1U;
+    rtcSTM32SetPeriodicWakeup(&RTCD1, &wakeup);
+  }
+
+  rtcGetTime(&RTCD1, &t0);
+
+  /* Stop mode selection.*/
+#if STM32_PM_STOP_LPDS == TRUE
+  PWR->CR1 = (PWR->CR1 & ~PWR_CR1_PDDS) | PWR_CR1_LPDS;
+#else
+  PWR->CR1 &= ~(PWR_CR1_PDDS | PWR_CR1_LPDS);
+#endif
+  SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+
+  /* The kernel lock has to be released or the wakeup interrupts would
+     not be able to exit the WFI state, interrupts are still globally
+     disabled so the handlers are served only after the clock restore.*/
+  osalSysUnlock();
+  __DSB();
+  __WFI();
+  osalSysLock();
+
+  SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+  pm_restore_clocks();
+
+  /* Waiting for the calendar shadow registers to be resynchronized
+     after the Stop mode.*/
+  RTCD1.rtc->ISR &= ~RTC_ISR_RSF;
+  rtcGetTime(&RTCD1, &t1);
+  rtcSTM32SetPeriodicWakeup(&RTCD1, NULL);
+
+  /* The system timer was stopped, the elapsed time is added to the
+     counter using the RTC as reference.*/
+  ms = ((t1.millisecond + PM_MS_PER_DAY) - t0.millisecond) % PM_MS_PER_DAY;
+  if (ms > 0U) {
+    st_lld_advance_counter((systime_t)TIME_MS2I(ms));
+  }
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   RTC wakeup timer interrupt handler.
+ *
+ * @isr
+ */
+OSAL_IRQ_HANDLER(Vector4C) {
+
+  OSAL_IRQ_PROLOGUE();
+
+  RTCD1.rtc->ISR &= ~RTC_ISR_WUTF;
+  EXTI->PR = EXTI_PR_PR22;
+
+  OSAL_IRQ_EPILOGUE();
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level PM driver initialization.
+ *
+ * @notapi
+ */
+void pm_lld_init(void) {
+
+  /* The RTC wakeup timer event is routed on EXTI line 22.*/
+  EXTI->IMR  |= EXTI_IMR_MR22;
+  EXTI->RTSR |= EXTI_RTSR_TR22;
+  nvicEnableVector(RTC_WKUP_IRQn, STM32_IRQ_EXTI22_PRIORITY);
+}
+
+/**
+ * @brief   Enters a sleep depth.
+ * @note    Invoked with the kernel locked, the function returns when the
+ *          system has been woken up, the pending interrupts are served
+ *          after the kernel is unlocked.
+ *
+ * @param[in] depth     the sleep depth
+ * @param[in] interval  time interval before the next timer event
+ *
+ * @notapi
+ */
+void pm_lld_enter(pmdepth_t depth, sysinterval_t interval) {
+
+  __disable_irq();
+
+  if (depth == PM_DEPTH_STOP) {
+    pm_enter_stop(interval);
+  }
+  else {
+    osalSysUnlock();
+    __DSB();
+    __WFI();
+    osalSysLock();
+  }
+
+  __enable_irq();
+}
+
+#endif /* HAL_USE_PM == TRUE */
+
+/** @} */
@@ -0,0 +1,119 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    STM32F7xx/hal_pm_lld.h
+ * @brief   STM32F7xx PM subsystem low level driver header.
+ *
+ * @addtogroup PM
+ * @{
+ */
+
+#ifndef HAL_PM_LLD_H
+#define HAL_PM_LLD_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of supported sleep depths.
+ * @note    The Standby mode is not supported because it resets the device.
+ */
+#define PM_LLD_DEPTHS_NUM                   2U
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Stop mode entry and exit latency in microseconds.
+ * @details This value includes the regulator wakeup time and the time
+ *          required for restoring the clock tree.
+ */
+#if !defined(STM32_PM_STOP_LATENCY) || defined(__DOXYGEN__)
+#define STM32_PM_STOP_LATENCY               500
+#endif
+
+/**
+ * @brief   Low-power regulator usage in Stop mode.
+ * @details If set to @p TRUE the voltage regulator is put in low-power mode
+ *          while in Stop mode, this increases the wakeup time.
+ */
+#if !defined(STM32_PM_STOP_LPDS) || defined(__DOXYGEN__)
+#define STM32_PM_STOP_LPDS                  TRUE
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if HAL_USE_RTC != TRUE
+#error "PM driver requires HAL_USE_RTC"
+#endif
+
+#if !STM32_RTC_HAS_PERIODIC_WAKEUPS
+#error "PM driver requires the RTC periodic wakeup"
+#endif
+
+#if STM32_RTCCLK == 0
+#error "PM driver requires a RTC clock source"
+#endif
+
+#if STM32_NO_INIT
+#error "PM driver is not compatible with STM32_NO_INIT"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the entry and exit latency of a sleep depth.
+ *
+ * @param[in] depth     the sleep depth
+ * @return              The latency in microseconds.
+ *
+ * @notapi
+ */
+#define pm_lld_get_latency(depth)                                           \
+  ((depth) == PM_DEPTH_SLEEP ? 0U : (unsigned)STM32_PM_STOP_LATENCY)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void pm_lld_init(void);
+  void pm_lld_enter(pmdepth_t depth, sysinterval_t interval);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_PM_LLD_H */
+
+/** @} */
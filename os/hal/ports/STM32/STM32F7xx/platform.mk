@@ -1,5 +1,6 @@
 # Required platform files.
 PLATFORMSRC := $(CHIBIOS)/os/hal/ports/common/ARMCMx/nvic.c \
+               $(CHIBIOS)/os/hal/ports/common/ARMCMx/cache.c \
                $(CHIBIOS)/os/hal/ports/STM32/STM32F7xx/stm32_isr.c \
                $(CHIBIOS)/os/hal/ports/STM32/STM32F7xx/hal_lld.c
 
@@ -17,7 +18,11 @@ endif
 
 HALCONF := $(strip $(shell cat $(CONFDIR)/halconf.h | egrep -e "\#define"))
 
+ifneq ($(findstring HAL_USE_PM TRUE,$(HALCONF)),)
+PLATFORMSRC += $(CHIBIOS)/os/hal/ports/STM32/STM32F7xx/hal_pm_lld.c
+endif
 else
+PLATFORMSRC += $(CHIBIOS)/os/hal/ports/STM32/STM32F7xx/hal_pm_lld.c
 endif
 
 # Drivers compatible with the platform.
@@ -26,6 +31,7 @@ include $(CHIBIOS)/os/hal/ports/STM32/LLD/CANv1/driver.mk
 include $(CHIBIOS)/os/hal/ports/STM32/LLD/CRYPv1/driver.mk
 include $(CHIBIOS)/os/hal/ports/STM32/LLD/DACv1/driver.mk
 include $(CHIBIOS)/os/hal/ports/STM32/LLD/DMAv2/driver.mk
+include $(CHIBIOS)/os/hal/ports/STM32/LLD/FMCv1/driver.mk
 include $(CHIBIOS)/os/hal/ports/STM32/LLD/GPIOv2/driver.mk
 include $(CHIBIOS)/os/hal/ports/STM32/LLD/I2Cv2/driver.mk
 include $(CHIBIOS)/os/hal/ports/STM32/LLD/MACv1/driver.mk
@@ -151,6 +151,11 @@ void hal_lld_init(void) {
   /* IRQ subsystem initialization.*/
   irqInit();
 
+  /* Inter-core semaphores initialization.*/
+#if STM32_HSEM_ENABLED == TRUE
+  hsemInit();
+#endif
+
   /* MPU initialization.*/
 #if (STM32_NOCACHE_SRAM1_SRAM2 == TRUE) || (STM32_NOCACHE_SRAM3 == TRUE)
   {
@@ -184,6 +189,11 @@ void hal_lld_init(void) {
     SCB_CleanInvalidateDCache();
   }
 #endif
+
+#if CACHE_NOCACHE_POOL_SIZE > 0
+  /* Non-cacheable pool for DMA buffers.*/
+  cacheNocacheInit();
+#endif
 }
 
 /**
@@ -2905,6 +2905,9 @@
 #include "stm32_isr.h"
 #include "stm32_dma.h"
 #include "stm32_bdma.h"
+#include "stm32_fmc.h"
+#include "stm32_hsem.h"
+#include "stm32_icmb.h"
 #include "stm32_rcc.h"
 
 #ifdef __cplusplus
@@ -1,5 +1,6 @@
 # Required platform files.
 PLATFORMSRC := $(CHIBIOS)/os/hal/ports/common/ARMCMx/nvic.c \
+               $(CHIBIOS)/os/hal/ports/common/ARMCMx/cache.c \
                $(CHIBIOS)/os/hal/ports/STM32/STM32H7xx/stm32_isr.c \
                $(CHIBIOS)/os/hal/ports/STM32/STM32H7xx/hal_lld.c
 
@@ -25,7 +26,10 @@ include $(CHIBIOS)/os/hal/ports/STM32/LLD/ADCv4/driver.mk
 include $(CHIBIOS)/os/hal/ports/STM32/LLD/BDMAv1/driver.mk
 include $(CHIBIOS)/os/hal/ports/STM32/LLD/CRYPv1/driver.mk
 include $(CHIBIOS)/os/hal/ports/STM32/LLD/DMAv3/driver.mk
+include $(CHIBIOS)/os/hal/ports/STM32/LLD/FDCANv1/driver.mk
+include $(CHIBIOS)/os/hal/ports/STM32/LLD/FMCv1/driver.mk
 include $(CHIBIOS)/os/hal/ports/STM32/LLD/GPIOv2/driver.mk
+include $(CHIBIOS)/os/hal/ports/STM32/LLD/HSEMv1/driver.mk
 include $(CHIBIOS)/os/hal/ports/STM32/LLD/I2Cv3/driver.mk
 include $(CHIBIOS)/os/hal/ports/STM32/LLD/OTGv1/driver.mk
 include $(CHIBIOS)/os/hal/ports/STM32/LLD/SPIv3/driver.mk
@@ -692,6 +692,36 @@
 #define rccResetETH() rccResetAHB1(RCC_AHB1RSTR_ETHMACRST)
 /** @} */
 
+/**
+ * @name    FDCAN peripherals specific RCC operations
+ * @{
+ */
+/**
+ * @brief   Enables the FDCAN peripherals clock.
+ * @note    The clock is shared by all the FDCAN instances and the message
+ *          RAM.
+ *
+ * @param[in] lp        low power enable flag
+ *
+ * @api
+ */
+#define rccEnableFDCAN(lp) rccEnableAPB1H(RCC_APB1HENR_FDCANEN, lp)
+
+/**
+ * @brief   Disables the FDCAN peripherals clock.
+ *
+ * @api
+ */
+#define rccDisableFDCAN() rccDisableAPB1H(RCC_APB1HENR_FDCANEN)
+
+/**
+ * @brief   Resets the FDCAN peripherals.
+ *
+ * @api
+ */
+#define rccResetFDCAN() rccResetAPB1H(RCC_APB1HRSTR_FDCANRST)
+/** @} */
+
 /**
  * @name    I2C peripherals specific RCC operations
  * @{
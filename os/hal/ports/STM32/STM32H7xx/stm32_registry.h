@@ -62,6 +62,19 @@
 #define STM32_HAS_CAN2                      FALSE
 #define STM32_HAS_CAN3                      FALSE
 
+/* FDCAN attributes.*/
+#define STM32_HAS_FDCAN1                    TRUE
+#define STM32_HAS_FDCAN2                    TRUE
+#define STM32_FDCAN_MSGRAM_WORDS            2560U
+#define STM32_FDCAN1_IT0_HANDLER            Vector8C
+#define STM32_FDCAN1_IT1_HANDLER            Vector94
+#define STM32_FDCAN1_IT0_NUMBER             19
+#define STM32_FDCAN1_IT1_NUMBER             21
+#define STM32_FDCAN2_IT0_HANDLER            Vector90
+#define STM32_FDCAN2_IT1_HANDLER            Vector98
+#define STM32_FDCAN2_IT0_NUMBER             20
+#define STM32_FDCAN2_IT1_NUMBER             22
+
 /* DAC attributes.*/
 #define STM32_HAS_DAC1_CH1                  FALSE
 #define STM32_HAS_DAC1_CH2                  FALSE
@@ -159,6 +172,11 @@
                                              RCC_AHB4ENR_GPIOJEN |          \
                                              RCC_AHB4ENR_GPIOKEN)
 
+/* HSEM attributes.*/
+#define STM32_HAS_HSEM                      TRUE
+#define STM32_HSEM_HANDLER                  Vector234
+#define STM32_HSEM_NUMBER                   125
+
 /* I2C attributes.*/
 #define STM32_HAS_I2C1                      TRUE
 #define STM32_I2C1_EVENT_HANDLER            VectorBC
@@ -69,6 +69,7 @@ OSAL_IRQ_HANDLER(Vector54) {
 
   exti_serve_irq(pr, 0);
   exti_serve_irq(pr, 1);
+  _pal_isr_group_code(pr);
 
   OSAL_IRQ_EPILOGUE();
 }
@@ -91,6 +92,7 @@ OSAL_IRQ_HANDLER(Vector58) {
 
   exti_serve_irq(pr, 2);
   exti_serve_irq(pr, 3);
+  _pal_isr_group_code(pr);
 
   OSAL_IRQ_EPILOGUE();
 }
@@ -125,6 +127,7 @@ OSAL_IRQ_HANDLER(Vector5C) {
   exti_serve_irq(pr, 13);
   exti_serve_irq(pr, 14);
   exti_serve_irq(pr, 15);
+  _pal_isr_group_code(pr);
 
   OSAL_IRQ_EPILOGUE();
 }
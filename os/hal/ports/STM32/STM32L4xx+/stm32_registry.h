@@ -200,6 +200,8 @@
 
 /* RNG attributes.*/
 #define STM32_HAS_RNG1                      TRUE
+#define STM32_RNG1_HANDLER                  Vector180
+#define STM32_RNG1_NUMBER                   80
 
 /* RTC attributes.*/
 #define STM32_HAS_RTC                       TRUE
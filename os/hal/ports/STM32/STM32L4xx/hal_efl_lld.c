@@ -0,0 +1,597 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    STM32L4xx/hal_efl_lld.c
+ * @brief   STM32L4xx Embedded Flash subsystem low level driver source.
+ * @details On dual bank devices the flash interface can read a bank while
+ *          the other bank is being erased or programmed, reads outside
+ *          the bank being erased are served while an erase is in
+ *          progress. Placing the storage in the second bank, starting from
+ *          @p efl_lld_get_bank2_sector(), lets the code execute from the
+ *          first bank without stalls during the storage operations.
+ *          Erase operations are started and then completed by the flash
+ *          interrupt, programming is performed by double words.
+ *
+ * @addtogroup EFL
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#if (HAL_USE_EFL == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define STM32_FLASH_KEY1                    0x45670123U
+#define STM32_FLASH_KEY2                    0xCDEF89ABU
+
+#define STM32_FLASH_SR_ERRORS               (FLASH_SR_OPERR   |             \
+                                             FLASH_SR_PROGERR |             \
+                                             FLASH_SR_WRPERR  |             \
+                                             FLASH_SR_PGAERR  |             \
+                                             FLASH_SR_SIZERR  |             \
+                                             FLASH_SR_PGSERR  |             \
+                                             FLASH_SR_MISERR  |             \
+                                             FLASH_SR_FASTERR |             \
+                                             FLASH_SR_RDERR   |             \
+                                             FLASH_SR_OPTVERR)
+
+#if defined(FLASH_CR_MER2) || defined(__DOXYGEN__)
+#define STM32_FLASH_CR_MER                  (FLASH_CR_MER1 | FLASH_CR_MER2)
+#else
+#define STM32_FLASH_CR_MER                  FLASH_CR_MER1
+#endif
+
+#define STM32_FLASH_CR_ERASE                (FLASH_CR_PER | FLASH_CR_PNB |  \
+                                             FLASH_CR_BKER |                \
+                                             STM32_FLASH_CR_MER |           \
+                                             FLASH_CR_EOPIE | FLASH_CR_ERRIE)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   EFLD1 driver identifier.
+ */
+EFlashDriver EFLD1;
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the size of the device.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ * @return              The device size in bytes.
+ *
+ * @notapi
+ */
+static size_t efl_get_size(EFlashDriver *eflp) {
+
+  return (size_t)eflp->descriptor.sectors_count *
+         (size_t)STM32_FLASH_SECTOR_SIZE;
+}
+
+/**
+ * @brief   Checks if an area is in the bank being erased.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ * @param[in] offset    area start offset
+ * @param[in] n         area size
+ * @return              The overlap status.
+ * @retval false        if the area can be accessed.
+ * @retval true         if the area is in the bank being erased.
+ *
+ * @notapi
+ */
+static bool efl_is_erasing(EFlashDriver *eflp, flash_offset_t offset,
+                           size_t n) {
+  size_t bank_size, start;
+
+  if (eflp->erasing >= eflp->descriptor.sectors_count) {
+    return true;
+  }
+
+  bank_size = (size_t)eflp->bank_sectors * (size_t)STM32_FLASH_SECTOR_SIZE;
+  start = ((size_t)eflp->erasing / (size_t)eflp->bank_sectors) * bank_size;
+
+  return ((size_t)offset < start + bank_size) &&
+         ((size_t)offset + n > start);
+}
+
+/**
+ * @brief   Resets the flash interface caches after a memory change.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ *
+ * @notapi
+ */
+static void efl_reset_caches(EFlashDriver *eflp) {
+  uint32_t acr = eflp->flash->ACR;
+
+  eflp->flash->ACR = acr & ~(FLASH_ACR_ICEN | FLASH_ACR_DCEN);
+  eflp->flash->ACR = (acr & ~(FLASH_ACR_ICEN | FLASH_ACR_DCEN)) |
+                     FLASH_ACR_ICRST | FLASH_ACR_DCRST;
+  eflp->flash->ACR = acr & ~(FLASH_ACR_ICRST | FLASH_ACR_DCRST);
+}
+
+/**
+ * @brief   Waits for the end of a program operation.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ * @return              An error code.
+ * @retval FLASH_NO_ERROR if the operation succeeded.
+ * @retval FLASH_ERROR_PROGRAM if the program operation failed.
+ *
+ * @notapi
+ */
+static flash_error_t efl_wait_program(EFlashDriver *eflp) {
+  uint32_t sr;
+
+  do {
+    sr = eflp->flash->SR;
+  } while ((sr & FLASH_SR_BSY) != 0U);
+
+  if ((sr & STM32_FLASH_SR_ERRORS) != 0U) {
+    eflp->flash->SR = sr & STM32_FLASH_SR_ERRORS;
+    return FLASH_ERROR_PROGRAM;
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Starts an erase operation.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ * @param[in] sector    sector to be erased or @p sectors_count for
+ *                      the whole device
+ * @param[in] cr        erase bits to be set in the CR register
+ *
+ * @notapi
+ */
+static void efl_start_erase(EFlashDriver *eflp, flash_sector_t sector,
+                            uint32_t cr) {
+
+  /* The state is changed before starting because the operation end is
+     handled by the interrupt.*/
+  eflp->state       = FLASH_ERASE;
+  eflp->erasing     = sector;
+  eflp->erase_error = FLASH_NO_ERROR;
+
+  eflp->flash->SR = STM32_FLASH_SR_ERRORS | FLASH_SR_EOP;
+  eflp->flash->CR = (eflp->flash->CR & ~STM32_FLASH_CR_ERASE) | cr |
+                    FLASH_CR_EOPIE | FLASH_CR_ERRIE;
+  eflp->flash->CR |= FLASH_CR_STRT;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   FLASH interrupt handler.
+ * @details It completes the erase operations.
+ *
+ * @isr
+ */
+OSAL_IRQ_HANDLER(STM32_FLASH_HANDLER) {
+  uint32_t sr;
+
+  OSAL_IRQ_PROLOGUE();
+
+  sr = EFLD1.flash->SR;
+  EFLD1.flash->SR = sr & (STM32_FLASH_SR_ERRORS | FLASH_SR_EOP);
+
+  if (EFLD1.state == FLASH_ERASE) {
+    EFLD1.flash->CR &= ~STM32_FLASH_CR_ERASE;
+    efl_reset_caches(&EFLD1);
+    if ((sr & STM32_FLASH_SR_ERRORS) != 0U) {
+      EFLD1.erase_error = FLASH_ERROR_ERASE;
+    }
+    EFLD1.state = FLASH_READY;
+  }
+
+  OSAL_IRQ_EPILOGUE();
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level Embedded Flash driver initialization.
+ *
+ * @notapi
+ */
+void efl_lld_init(void) {
+
+  /* Driver initialization.*/
+  eflObjectInit(&EFLD1);
+  EFLD1.flash       = FLASH;
+  EFLD1.erasing     = 0U;
+  EFLD1.erase_error = FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Configures and activates the Embedded Flash peripheral.
+ * @details The device geometry is read from the flash size register and
+ *          from the option bytes.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ *
+ * @notapi
+ */
+void efl_lld_start(EFlashDriver *eflp) {
+  flash_descriptor_t *dp = &eflp->descriptor;
+  uint32_t size;
+
+  size = (uint32_t)*(const volatile uint16_t *)FLASHSIZE_BASE * 1024U;
+
+  dp->attributes    = FLASH_ATTR_ERASED_IS_ONE |
+                      FLASH_ATTR_MEMORY_MAPPED |
+                      FLASH_ATTR_READ_ECC_CAPABLE;
+  dp->page_size     = STM32_FLASH_LINE_SIZE;
+  dp->sectors_count = size / STM32_FLASH_SECTOR_SIZE;
+  dp->sectors       = NULL;
+  dp->sectors_size  = STM32_FLASH_SECTOR_SIZE;
+  dp->address       = FLASH_BASE;
+
+  /* Devices with 1MB are always dual bank, smaller devices depend on the
+     DUALBANK option bit.*/
+  eflp->bank_sectors = dp->sectors_count;
+#if STM32_FLASH_NUMBER_OF_BANKS > 1
+  if ((size >= 1024U * 1024U) ||
+      ((eflp->flash->OPTR & FLASH_OPTR_DUALBANK) != 0U)) {
+    eflp->bank_sectors = dp->sectors_count / 2U;
+  }
+#endif
+
+  /* Unlocking the control register.*/
+  if ((eflp->flash->CR & FLASH_CR_LOCK) != 0U) {
+    eflp->flash->KEYR = STM32_FLASH_KEY1;
+    eflp->flash->KEYR = STM32_FLASH_KEY2;
+  }
+
+  nvicEnableVector(STM32_FLASH_NUMBER, STM32_EFL_IRQ_PRIORITY);
+}
+
+/**
+ * @brief   Deactivates the Embedded Flash peripheral.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ *
+ * @notapi
+ */
+void efl_lld_stop(EFlashDriver *eflp) {
+
+  nvicDisableVector(STM32_FLASH_NUMBER);
+  eflp->flash->CR |= FLASH_CR_LOCK;
+}
+
+/**
+ * @brief   Gets the flash descriptor structure.
+ *
+ * @param[in] instance  pointer to a @p EFlashDriver instance
+ * @return              A flash device descriptor.
+ *
+ * @notapi
+ */
+const flash_descriptor_t *efl_lld_get_descriptor(void *instance) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+
+  return &devp->descriptor;
+}
+
+/**
+ * @brief   Read operation.
+ * @note    Reads outside the bank being erased are allowed during an
+ *          erase operation.
+ *
+ * @param[in] instance  pointer to a @p EFlashDriver instance
+ * @param[in] offset    flash offset
+ * @param[in] n         number of bytes to be read
+ * @param[out] rp       pointer to the data buffer
+ * @return              An error code.
+ * @retval FLASH_NO_ERROR if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING if there is an erase operation in progress.
+ * @retval FLASH_ERROR_READ if the read operation failed.
+ * @retval FLASH_ERROR_HW_FAILURE if access to the memory failed.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_read(void *instance, flash_offset_t offset,
+                           size_t n, uint8_t *rp) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+  flash_error_t err = FLASH_NO_ERROR;
+  flash_state_t state;
+
+  osalDbgCheck((instance != NULL) && (rp != NULL) && (n > 0U));
+  osalDbgCheck((size_t)offset + n <= efl_get_size(devp));
+  osalDbgAssert((devp->state == FLASH_READY) ||
+                (devp->state == FLASH_ERASE), "invalid state");
+
+  /* The state is left unchanged while reading during an erase.*/
+  state = devp->state;
+  if (state == FLASH_ERASE) {
+    if (efl_is_erasing(devp, offset, n)) {
+      return FLASH_BUSY_ERASING;
+    }
+  }
+  else {
+    devp->state = FLASH_READ;
+  }
+
+  memcpy((void *)rp, (const void *)(devp->descriptor.address + offset), n);
+
+  /* Double ECC errors are reported, single errors are corrected.*/
+  if ((devp->flash->ECCR & FLASH_ECCR_ECCD) != 0U) {
+    devp->flash->ECCR |= FLASH_ECCR_ECCD;
+    err = FLASH_ERROR_READ;
+  }
+
+  if (state != FLASH_ERASE) {
+    devp->state = FLASH_READY;
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Program operation.
+ * @note    Partially written double words are merged with the current
+ *          memory content, the double word must still be erased.
+ *
+ * @param[in] instance  pointer to a @p EFlashDriver instance
+ * @param[in] offset    flash offset
+ * @param[in] n         number of bytes to be programmed
+ * @param[in] pp        pointer to the data buffer
+ * @return              An error code.
+ * @retval FLASH_NO_ERROR if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING if there is an erase operation in progress.
+ * @retval FLASH_ERROR_PROGRAM if the program operation failed.
+ * @retval FLASH_ERROR_HW_FAILURE if access to the memory failed.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_program(void *instance, flash_offset_t offset,
+                              size_t n, const uint8_t *pp) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+  flash_error_t err = FLASH_NO_ERROR;
+
+  osalDbgCheck((instance != NULL) && (pp != NULL) && (n > 0U));
+  osalDbgCheck((size_t)offset + n <= efl_get_size(devp));
+  osalDbgAssert((devp->state == FLASH_READY) ||
+                (devp->state == FLASH_ERASE), "invalid state");
+
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  devp->state = FLASH_PGM;
+
+  devp->flash->SR = STM32_FLASH_SR_ERRORS | FLASH_SR_EOP;
+  devp->flash->CR |= FLASH_CR_PG;
+
+  while (n > 0U) {
+    union {
+      uint32_t  w[STM32_FLASH_LINE_SIZE / 4U];
+      uint8_t   b[STM32_FLASH_LINE_SIZE];
+    } line;
+    volatile uint32_t *p;
+    flash_offset_t base;
+    size_t chunk;
+    unsigned i;
+
+    base  = offset & ~(flash_offset_t)(STM32_FLASH_LINE_SIZE - 1U);
+    p     = (volatile uint32_t *)(devp->descriptor.address + base);
+    chunk = STM32_FLASH_LINE_SIZE - (size_t)(offset - base);
+    if (chunk > n) {
+      chunk = n;
+    }
+
+    /* Building the whole line, words are written in sequence.*/
+    memcpy((void *)line.b, (const void *)p, STM32_FLASH_LINE_SIZE);
+    memcpy((void *)&line.b[offset - base], (const void *)pp, chunk);
+    for (i = 0U; i < STM32_FLASH_LINE_SIZE / 4U; i++) {
+      p[i] = line.w[i];
+    }
+
+    err = efl_wait_program(devp);
+    if (err != FLASH_NO_ERROR) {
+      break;
+    }
+
+    offset += (flash_offset_t)chunk;
+    pp     += chunk;
+    n      -= chunk;
+  }
+
+  devp->flash->CR &= ~FLASH_CR_PG;
+  efl_reset_caches(devp);
+
+  devp->state = FLASH_READY;
+
+  return err;
+}
+
+/**
+ * @brief   Starts a whole-device erase operation.
+ * @note    The code must not execute from the flash during this
+ *          operation.
+ *
+ * @param[in] instance  pointer to a @p EFlashDriver instance
+ * @return              An error code.
+ * @retval FLASH_NO_ERROR if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING if there is an erase operation in progress.
+ * @retval FLASH_ERROR_HW_FAILURE if access to the memory failed.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_start_erase_all(void *instance) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+
+  osalDbgCheck(instance != NULL);
+  osalDbgAssert((devp->state == FLASH_READY) ||
+                (devp->state == FLASH_ERASE), "invalid state");
+
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  efl_start_erase(devp, devp->descriptor.sectors_count, STM32_FLASH_CR_MER);
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Starts an sector erase operation.
+ * @note    The operation is completed by the flash interrupt.
+ *
+ * @param[in] instance  pointer to a @p EFlashDriver instance
+ * @param[in] sector    sector to be erased
+ * @return              An error code.
+ * @retval FLASH_NO_ERROR if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING if there is an erase operation in progress.
+ * @retval FLASH_ERROR_HW_FAILURE if access to the memory failed.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_start_erase_sector(void *instance,
+                                         flash_sector_t sector) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+  uint32_t bank, page;
+
+  osalDbgCheck(instance != NULL);
+  osalDbgCheck(sector < devp->descriptor.sectors_count);
+  osalDbgAssert((devp->state == FLASH_READY) ||
+                (devp->state == FLASH_ERASE), "invalid state");
+
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* Sectors are numbered in memory order, the physical bank depends on
+     the banks swapping.*/
+  bank = sector / devp->bank_sectors;
+  page = sector % devp->bank_sectors;
+#if defined(SYSCFG_MEMRMP_FB_MODE)
+  if ((devp->bank_sectors < devp->descriptor.sectors_count) &&
+      ((SYSCFG->MEMRMP & SYSCFG_MEMRMP_FB_MODE) != 0U)) {
+    bank ^= 1U;
+  }
+#endif
+
+  efl_start_erase(devp, sector,
+                  FLASH_CR_PER | (page << FLASH_CR_PNB_Pos) |
+                  (bank != 0U ? FLASH_CR_BKER : 0U));
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Queries the driver for erase operation progress.
+ * @details The operation end is detected by the flash interrupt, this
+ *          function does not access the flash interface.
+ *
+ * @param[in] instance  pointer to a @p EFlashDriver instance
+ * @param[out] msec     recommended time, in milliseconds, that
+ *                      should be spent before calling this
+ *                      function again, can be @p NULL
+ * @return              An error code.
+ * @retval FLASH_NO_ERROR if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING if there is an erase operation in progress.
+ * @retval FLASH_ERROR_ERASE if the erase operation failed.
+ * @retval FLASH_ERROR_HW_FAILURE if access to the memory failed.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_query_erase(void *instance, uint32_t *msec) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+  flash_error_t err;
+
+  osalDbgCheck(instance != NULL);
+  osalDbgAssert((devp->state == FLASH_READY) ||
+                (devp->state == FLASH_ERASE), "invalid state");
+
+  if (devp->state == FLASH_ERASE) {
+    if (msec != NULL) {
+      *msec = (uint32_t)STM32_EFL_ERASE_WAIT_TIME;
+    }
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* The error is reported once.*/
+  err = devp->erase_error;
+  devp->erase_error = FLASH_NO_ERROR;
+
+  return err;
+}
+
+/**
+ * @brief   Returns the erase state of a sector.
+ *
+ * @param[in] instance  pointer to a @p EFlashDriver instance
+ * @param[in] sector    sector to be verified
+ * @return              An error code.
+ * @retval FLASH_NO_ERROR if the sector is erased.
+ * @retval FLASH_BUSY_ERASING if there is an erase operation in progress.
+ * @retval FLASH_ERROR_VERIFY if the verify operation failed.
+ * @retval FLASH_ERROR_HW_FAILURE if access to the memory failed.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_verify_erase(void *instance, flash_sector_t sector) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+  const volatile uint32_t *p;
+  flash_offset_t offset;
+  unsigned i;
+
+  osalDbgCheck(instance != NULL);
+  osalDbgCheck(sector < devp->descriptor.sectors_count);
+  osalDbgAssert((devp->state == FLASH_READY) ||
+                (devp->state == FLASH_ERASE), "invalid state");
+
+  offset = (flash_offset_t)(sector * STM32_FLASH_SECTOR_SIZE);
+  if ((devp->state == FLASH_ERASE) &&
+      efl_is_erasing(devp, offset, STM32_FLASH_SECTOR_SIZE)) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  p = (const volatile uint32_t *)(devp->descriptor.address + offset);
+  for (i = 0U; i < STM32_FLASH_SECTOR_SIZE / 4U; i++) {
+    if (p[i] != 0xFFFFFFFFU) {
+      return FLASH_ERROR_VERIFY;
+    }
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+#endif /* HAL_USE_EFL == TRUE */
+
+/** @} */
@@ -0,0 +1,196 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    STM32L4xx/hal_efl_lld.h
+ * @brief   STM32L4xx Embedded Flash subsystem low level driver header.
+ *
+ * @addtogroup EFL
+ * @{
+ */
+
+#ifndef HAL_EFL_LLD_H
+#define HAL_EFL_LLD_H
+
+#if (HAL_USE_EFL == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Programming line size.
+ * @details The flash is programmed by double words, this is the widest
+ *          programming unit of the STM32L4xx flash interface.
+ */
+#define STM32_FLASH_LINE_SIZE               8U
+
+/**
+ * @brief   Flash sector (page) size.
+ */
+#define STM32_FLASH_SECTOR_SIZE             2048U
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    STM32L4xx configuration options
+ * @{
+ */
+/**
+ * @brief   Flash end of operation interrupt priority level setting.
+ */
+#if !defined(STM32_EFL_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_EFL_IRQ_PRIORITY              14
+#endif
+
+/**
+ * @brief   Recommended erase polling interval in milliseconds.
+ * @details This is the value returned by @p flashQueryErase() while an
+ *          erase operation is in progress, the operation end is detected
+ *          by the flash interrupt.
+ */
+#if !defined(STM32_EFL_ERASE_WAIT_TIME) || defined(__DOXYGEN__)
+#define STM32_EFL_ERASE_WAIT_TIME           5
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !defined(STM32_FLASH_NUMBER_OF_BANKS)
+#error "STM32_FLASH_NUMBER_OF_BANKS not defined in registry"
+#endif
+
+#if !defined(STM32_FLASH_HANDLER) || !defined(STM32_FLASH_NUMBER)
+#error "FLASH interrupt not defined in registry"
+#endif
+
+#if !OSAL_IRQ_IS_VALID_PRIORITY(STM32_EFL_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to EFL"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver configuration structure.
+ * @note    It could be empty on some architectures.
+ */
+typedef struct {
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Dummy configuration, it is not needed.
+   */
+  uint32_t                  dummy;
+} EFlashConfig;
+
+/**
+ * @extends BaseFlash
+ *
+ * @brief   Structure representing an embedded flash driver.
+ */
+struct EFlashDriver {
+  /**
+   * @brief   Virtual Methods Table.
+   */
+  const struct EFlashDriverVMT  *vmt;
+  _base_flash_data
+  /**
+   * @brief   Current configuration data.
+   */
+  const EFlashConfig            *config;
+#if defined(EFL_DRIVER_EXT_FIELDS)
+  EFL_DRIVER_EXT_FIELDS
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Pointer to the FLASH registers block.
+   */
+  FLASH_TypeDef                 *flash;
+  /**
+   * @brief   Device descriptor, it depends on the device size.
+   */
+  flash_descriptor_t            descriptor;
+  /**
+   * @brief   Number of sectors in each bank.
+   * @note    It is equal to the sectors count on single bank devices.
+   */
+  flash_sector_t                bank_sectors;
+  /**
+   * @brief   Sector being erased or @p sectors_count for a whole
+   *          device erase.
+   */
+  flash_sector_t                erasing;
+  /**
+   * @brief   Outcome of the last erase operation.
+   */
+  flash_error_t                 erase_error;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the first sector of the second bank.
+ * @details Sectors from this one are in the bank not containing the
+ *          reset vector, MFS banks placed there can be erased and
+ *          programmed while the code keeps executing from the first bank.
+ * @note    Valid after @p eflStart(), on single bank devices it is equal
+ *          to the sectors count.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ * @return              The first sector of the second bank.
+ */
+#define efl_lld_get_bank2_sector(eflp) ((eflp)->bank_sectors)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if !defined(__DOXYGEN__)
+extern EFlashDriver EFLD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void efl_lld_init(void);
+  void efl_lld_start(EFlashDriver *eflp);
+  void efl_lld_stop(EFlashDriver *eflp);
+  const flash_descriptor_t *efl_lld_get_descriptor(void *instance);
+  flash_error_t efl_lld_read(void *instance, flash_offset_t offset,
+                             size_t n, uint8_t *rp);
+  flash_error_t efl_lld_program(void *instance, flash_offset_t offset,
+                                size_t n, const uint8_t *pp);
+  flash_error_t efl_lld_start_erase_all(void *instance);
+  flash_error_t efl_lld_start_erase_sector(void *instance,
+                                           flash_sector_t sector);
+  flash_error_t efl_lld_query_erase(void *instance, uint32_t *msec);
+  flash_error_t efl_lld_verify_erase(void *instance, flash_sector_t sector);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_EFL == TRUE */
+
+#endif /* HAL_EFL_LLD_H */
+
+/** @} */
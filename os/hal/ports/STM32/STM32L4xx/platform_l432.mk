@@ -17,7 +17,11 @@ endif
 
 HALCONF := $(strip $(shell cat $(CONFDIR)/halconf.h | egrep -e "\#define"))
 
+ifneq ($(findstring HAL_USE_EFL TRUE,$(HALCONF)),)
+PLATFORMSRC += $(CHIBIOS)/os/hal/ports/STM32/STM32L4xx/hal_efl_lld.c
+endif
 else
+PLATFORMSRC += $(CHIBIOS)/os/hal/ports/STM32/STM32L4xx/hal_efl_lld.c
 endif
 
 # Drivers compatible with the platform.
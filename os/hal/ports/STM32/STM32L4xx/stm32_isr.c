@@ -28,6 +28,17 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+#if (STM32_EXTI_SHARED_SERVICE == TRUE) &&                                  \
+    (defined(STM32_DISABLE_EXTI0_HANDLER) ||                                \
+     defined(STM32_DISABLE_EXTI1_HANDLER) ||                                \
+     defined(STM32_DISABLE_EXTI2_HANDLER) ||                                \
+     defined(STM32_DISABLE_EXTI3_HANDLER) ||                                \
+     defined(STM32_DISABLE_EXTI4_HANDLER) ||                                \
+     defined(STM32_DISABLE_EXTI5_9_HANDLER) ||                              \
+     defined(STM32_DISABLE_EXTI10_15_HANDLER))
+#error "STM32_EXTI_SHARED_SERVICE requires all the EXTI GPIO handlers"
+#endif
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -47,6 +58,54 @@
   }                                                                         \
 }
 
+#if (HAL_USE_PAL && (PAL_USE_WAIT || PAL_USE_CALLBACKS) &&                 \
+     (STM32_EXTI_SHARED_SERVICE == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @brief   Serves all the pending GPIO EXTI lines.
+ * @details The pending requests on the other EXTI vectors are cleared
+ *          because the lines are served here, a line triggering again
+ *          while this code runs pends its vector again.
+ *
+ * @return              The mask of the served lines.
+ *
+ * @notapi
+ */
+static uint32_t exti_serve_shared(void) {
+  uint32_t pr;
+
+  pr = EXTI->PR1;
+  pr &= EXTI->IMR1 & 0x0000FFFFU;
+  EXTI->PR1 = pr;
+
+  nvicClearPending(EXTI0_IRQn);
+  nvicClearPending(EXTI1_IRQn);
+  nvicClearPending(EXTI2_IRQn);
+  nvicClearPending(EXTI3_IRQn);
+  nvicClearPending(EXTI4_IRQn);
+  nvicClearPending(EXTI9_5_IRQn);
+  nvicClearPending(EXTI15_10_IRQn);
+
+  exti_serve_irq(pr, 0);
+  exti_serve_irq(pr, 1);
+  exti_serve_irq(pr, 2);
+  exti_serve_irq(pr, 3);
+  exti_serve_irq(pr, 4);
+  exti_serve_irq(pr, 5);
+  exti_serve_irq(pr, 6);
+  exti_serve_irq(pr, 7);
+  exti_serve_irq(pr, 8);
+  exti_serve_irq(pr, 9);
+  exti_serve_irq(pr, 10);
+  exti_serve_irq(pr, 11);
+  exti_serve_irq(pr, 12);
+  exti_serve_irq(pr, 13);
+  exti_serve_irq(pr, 14);
+  exti_serve_irq(pr, 15);
+
+  return pr;
+}
+#endif
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -63,11 +122,16 @@ OSAL_IRQ_HANDLER(Vector58) {
 
   OSAL_IRQ_PROLOGUE();
 
+#if STM32_EXTI_SHARED_SERVICE == TRUE
+  pr = exti_serve_shared();
+#else
   pr = EXTI->PR1;
   pr &= EXTI->IMR1 & (1U << 0);
   EXTI->PR1 = pr;
 
   exti_serve_irq(pr, 0);
+#endif
+  _pal_isr_group_code(pr);
 
   OSAL_IRQ_EPILOGUE();
 }
@@ -84,11 +148,16 @@ OSAL_IRQ_HANDLER(Vector5C) {
 
   OSAL_IRQ_PROLOGUE();
 
+#if STM32_EXTI_SHARED_SERVICE == TRUE
+  pr = exti_serve_shared();
+#else
   pr = EXTI->PR1;
   pr &= EXTI->IMR1 & (1U << 1);
   EXTI->PR1 = pr;
 
   exti_serve_irq(pr, 1);
+#endif
+  _pal_isr_group_code(pr);
 
   OSAL_IRQ_EPILOGUE();
 }
@@ -105,11 +174,16 @@ OSAL_IRQ_HANDLER(Vector60) {
 
   OSAL_IRQ_PROLOGUE();
 
+#if STM32_EXTI_SHARED_SERVICE == TRUE
+  pr = exti_serve_shared();
+#else
   pr = EXTI->PR1;
   pr &= EXTI->IMR1 & (1U << 2);
   EXTI->PR1 = pr;
 
   exti_serve_irq(pr, 2);
+#endif
+  _pal_isr_group_code(pr);
 
   OSAL_IRQ_EPILOGUE();
 }
@@ -126,11 +200,16 @@ OSAL_IRQ_HANDLER(Vector64) {
 
   OSAL_IRQ_PROLOGUE();
 
+#if STM32_EXTI_SHARED_SERVICE == TRUE
+  pr = exti_serve_shared();
+#else
   pr = EXTI->PR1;
   pr &= EXTI->IMR1 & (1U << 3);
   EXTI->PR1 = pr;
 
   exti_serve_irq(pr, 3);
+#endif
+  _pal_isr_group_code(pr);
 
   OSAL_IRQ_EPILOGUE();
 }
@@ -147,11 +226,16 @@ OSAL_IRQ_HANDLER(Vector68) {
 
   OSAL_IRQ_PROLOGUE();
 
+#if STM32_EXTI_SHARED_SERVICE == TRUE
+  pr = exti_serve_shared();
+#else
   pr = EXTI->PR1;
   pr &= EXTI->IMR1 & (1U << 4);
   EXTI->PR1 = pr;
 
   exti_serve_irq(pr, 4);
+#endif
+  _pal_isr_group_code(pr);
 
   OSAL_IRQ_EPILOGUE();
 }
@@ -168,6 +252,9 @@ OSAL_IRQ_HANDLER(Vector9C) {
 
   OSAL_IRQ_PROLOGUE();
 
+#if STM32_EXTI_SHARED_SERVICE == TRUE
+  pr = exti_serve_shared();
+#else
   pr = EXTI->PR1;
   pr &= EXTI->IMR1 & ((1U << 5) | (1U << 6) | (1U << 7) | (1U << 8) |
                       (1U << 9));
@@ -178,6 +265,8 @@ OSAL_IRQ_HANDLER(Vector9C) {
   exti_serve_irq(pr, 7);
   exti_serve_irq(pr, 8);
   exti_serve_irq(pr, 9);
+#endif
+  _pal_isr_group_code(pr);
 
   OSAL_IRQ_EPILOGUE();
 }
@@ -194,6 +283,9 @@ OSAL_IRQ_HANDLER(VectorE0) {
 
   OSAL_IRQ_PROLOGUE();
 
+#if STM32_EXTI_SHARED_SERVICE == TRUE
+  pr = exti_serve_shared();
+#else
   pr = EXTI->PR1;
   pr &= EXTI->IMR1 & ((1U << 10) | (1U << 11) | (1U << 12) | (1U << 13) |
                       (1U << 14) | (1U << 15));
@@ -205,6 +297,8 @@ OSAL_IRQ_HANDLER(VectorE0) {
   exti_serve_irq(pr, 13);
   exti_serve_irq(pr, 14);
   exti_serve_irq(pr, 15);
+#endif
+  _pal_isr_group_code(pr);
 
   OSAL_IRQ_EPILOGUE();
 }
@@ -155,6 +155,11 @@
 #define STM32_EXTI_LINE20_NUMBER            3
 #define STM32_EXTI_LINE2122_NUMBER          64
 
+/* Flash attributes.*/
+#define STM32_FLASH_NUMBER_OF_BANKS         1
+#define STM32_FLASH_HANDLER                 Vector50
+#define STM32_FLASH_NUMBER                  4
+
 /* GPIO attributes.*/
 #define STM32_HAS_GPIOA                     TRUE
 #define STM32_HAS_GPIOB                     TRUE
@@ -207,6 +212,8 @@
 
 /* RNG attributes.*/
 #define STM32_HAS_RNG1                      TRUE
+#define STM32_RNG1_HANDLER                  Vector180
+#define STM32_RNG1_NUMBER                   80
 
 /* RTC attributes.*/
 #define STM32_HAS_RTC                       TRUE
@@ -496,6 +503,11 @@
 #define STM32_EXTI_LINE20_NUMBER            3
 #define STM32_EXTI_LINE2122_NUMBER          64
 
+/* Flash attributes.*/
+#define STM32_FLASH_NUMBER_OF_BANKS         1
+#define STM32_FLASH_HANDLER                 Vector50
+#define STM32_FLASH_NUMBER                  4
+
 /* GPIO attributes.*/
 #define STM32_HAS_GPIOA                     TRUE
 #define STM32_HAS_GPIOB                     TRUE
@@ -558,6 +570,8 @@
 
 /* RNG attributes.*/
 #define STM32_HAS_RNG1                      TRUE
+#define STM32_RNG1_HANDLER                  Vector180
+#define STM32_RNG1_NUMBER                   80
 
 /* RTC attributes.*/
 #define STM32_HAS_RTC                       TRUE
@@ -858,6 +872,11 @@
 #define STM32_EXTI_LINE20_NUMBER            3
 #define STM32_EXTI_LINE2122_NUMBER          64
 
+/* Flash attributes.*/
+#define STM32_FLASH_NUMBER_OF_BANKS         2
+#define STM32_FLASH_HANDLER                 Vector50
+#define STM32_FLASH_NUMBER                  4
+
 /* GPIO attributes.*/
 #define STM32_HAS_GPIOA                     TRUE
 #define STM32_HAS_GPIOB                     TRUE
@@ -924,6 +943,8 @@
 
 /* RNG attributes.*/
 #define STM32_HAS_RNG1                      TRUE
+#define STM32_RNG1_HANDLER                  Vector180
+#define STM32_RNG1_NUMBER                   80
 
 /* RTC attributes.*/
 #define STM32_HAS_RTC                       TRUE
@@ -1279,6 +1300,11 @@
 #define STM32_EXTI_LINE20_NUMBER            3
 #define STM32_EXTI_LINE2122_NUMBER          64
 
+/* Flash attributes.*/
+#define STM32_FLASH_NUMBER_OF_BANKS         2
+#define STM32_FLASH_HANDLER                 Vector50
+#define STM32_FLASH_NUMBER                  4
+
 /* GPIO attributes.*/
 #define STM32_HAS_GPIOA                     TRUE
 #define STM32_HAS_GPIOB                     TRUE
@@ -1353,6 +1379,8 @@
 
 /* RNG attributes.*/
 #define STM32_HAS_RNG1                      TRUE
+#define STM32_RNG1_HANDLER                  Vector180
+#define STM32_RNG1_NUMBER                   80
 
 /* RTC attributes.*/
 #define STM32_HAS_RTC                       TRUE
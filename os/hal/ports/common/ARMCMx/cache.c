@@ -0,0 +1,126 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    common/ARMCMx/cache.c
+ * @brief   Cortex-Mx cache support code.
+ *
+ * @addtogroup COMMON_ARMCMx_CACHE
+ * @{
+ */
+
+#include "hal.h"
+
+#if (CACHE_NOCACHE_POOL_SIZE > 0) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Non-cacheable memory pool.
+ * @note    The MPU requires the region to be aligned to its size.
+ */
+ALIGNED_VAR(CACHE_NOCACHE_POOL_SIZE)
+static uint8_t nocache_pool[CACHE_NOCACHE_POOL_SIZE];
+
+/**
+ * @brief   Next free position in the pool.
+ */
+static uint8_t *nocache_next;
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Non-cacheable memory pool initialization.
+ * @note    This function is invoked by the platform initialization code,
+ *          it must not be invoked explicitly.
+ *
+ * @init
+ */
+void cacheNocacheInit(void) {
+
+  /* Removing any line of the pool area from the cache before making it
+     non-cacheable.*/
+  cacheBufferFlush(nocache_pool, CACHE_NOCACHE_POOL_SIZE);
+
+  /* The RASR size field encodes the region size as 2^(SIZE+1).*/
+  mpuConfigureRegion(CACHE_NOCACHE_POOL_REGION,
+                     nocache_pool,
+                     MPU_RASR_ATTR_AP_RW_RW |
+                     MPU_RASR_ATTR_NON_CACHEABLE |
+                     MPU_RASR_SIZE(30U - __CLZ(CACHE_NOCACHE_POOL_SIZE)) |
+                     MPU_RASR_ENABLE);
+  mpuEnable(MPU_CTRL_PRIVDEFENA);
+  __DSB();
+  __ISB();
+
+  nocache_next = nocache_pool;
+}
+
+/**
+ * @brief   Allocates a buffer from the non-cacheable memory pool.
+ * @details The buffer is aligned to a cache line and its size is rounded
+ *          up to a multiple of the cache line size. The allocated buffers
+ *          cannot be freed, this is meant for DMA buffers allocated at
+ *          initialization time.
+ *
+ * @param[in] size      size of the buffer in bytes
+ * @return              A pointer to the allocated buffer.
+ * @retval NULL         if the pool is exhausted.
+ *
+ * @api
+ */
+void *cacheNocacheAlloc(size_t size) {
+  uint8_t *end = &nocache_pool[CACHE_NOCACHE_POOL_SIZE];
+  void *p;
+
+  size = CACHE_SIZE_ALIGN(size);
+
+  osalSysLock();
+  if (size <= (size_t)(end - nocache_next)) {
+    p = (void *)nocache_next;
+    nocache_next += size;
+  }
+  else {
+    p = NULL;
+  }
+  osalSysUnlock();
+
+  return p;
+}
+
+#endif /* CACHE_NOCACHE_POOL_SIZE > 0 */
+
+/** @} */
@@ -29,14 +29,71 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Data cache line size.
+ */
+#define CACHE_LINE_SIZE                     32U
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   DMA buffers cache maintenance in drivers.
+ * @details If enabled, the DMA-based drivers clean the cache lines of the
+ *          buffers before a DMA operation and invalidate the lines of the
+ *          receive buffers after it, only the buffer ranges are affected.
+ * @note    It can be disabled if all DMA buffers are allocated in
+ *          non-cacheable memory.
+ * @note    It has no effect on devices without data cache.
+ */
+#if !defined(CACHE_DMA_MAINTENANCE) || defined(__DOXYGEN__)
+#define CACHE_DMA_MAINTENANCE               TRUE
+#endif
+
+/**
+ * @brief   Size of the non-cacheable memory pool.
+ * @details The pool is allocated statically and made non-cacheable using
+ *          an MPU region, buffers are allocated from the pool using
+ *          @p cacheNocacheAlloc().
+ * @note    Zero disables the pool, else it must be a power of two greater
+ *          than or equal to 32.
+ */
+#if !defined(CACHE_NOCACHE_POOL_SIZE) || defined(__DOXYGEN__)
+#define CACHE_NOCACHE_POOL_SIZE             0
+#endif
+
+/**
+ * @brief   MPU region used by the non-cacheable memory pool.
+ */
+#if !defined(CACHE_NOCACHE_POOL_REGION) || defined(__DOXYGEN__)
+#define CACHE_NOCACHE_POOL_REGION           MPU_REGION_6
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (CACHE_NOCACHE_POOL_SIZE != 0) &&                                       \
+    ((CACHE_NOCACHE_POOL_SIZE < 32) ||                                      \
+     ((CACHE_NOCACHE_POOL_SIZE & (CACHE_NOCACHE_POOL_SIZE - 1)) != 0))
+#error "CACHE_NOCACHE_POOL_SIZE must be a power of two >= 32"
+#endif
+
+/**
+ * @brief   DMA buffers maintenance required.
+ */
+#if ((CACHE_DMA_MAINTENANCE == TRUE) && defined(__DCACHE_PRESENT)) ||       \
+    defined(__DOXYGEN__)
+#if (__DCACHE_PRESENT != 0) || defined(__DOXYGEN__)
+#define CACHE_DMA_MAINTENANCE_ENABLED       TRUE
+#else
+#define CACHE_DMA_MAINTENANCE_ENABLED       FALSE
+#endif
+#else
+#define CACHE_DMA_MAINTENANCE_ENABLED       FALSE
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -45,6 +102,30 @@
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Rounds a size up to a multiple of the cache line size.
+ *
+ * @param[in] n         size in bytes
+ * @return              The rounded size.
+ */
+#define CACHE_SIZE_ALIGN(n)                                                 \
+  ((((size_t)(n)) + ((size_t)CACHE_LINE_SIZE - 1U)) &                       \
+   ~((size_t)CACHE_LINE_SIZE - 1U))
+
+/**
+ * @brief   Declares a buffer occupying whole cache lines.
+ * @details The buffer is aligned to a cache line and its size is rounded
+ *          up to a multiple of the cache line size, DMA buffers declared
+ *          this way do not share cache lines with other data.
+ *
+ * @param[in] t         type of the buffer elements
+ * @param[in] name      name of the buffer
+ * @param[in] n         number of elements
+ */
+#define CACHE_ALIGNED_BUFFER(t, name, n)                                    \
+  ALIGNED_VAR(CACHE_LINE_SIZE)                                              \
+  t name[CACHE_SIZE_ALIGN((size_t)(n) * sizeof (t)) / sizeof (t)]
+
 #if defined(__DCACHE_PRESENT) || defined(__DOXYGEN__)
 #if (__DCACHE_PRESENT != 0) || defined(__DOXYGEN__)
 /**
@@ -64,10 +145,11 @@
 #define cacheBufferInvalidate(saddr, n) {                                   \
   uint8_t *start = (uint8_t *)(saddr);                                      \
   uint8_t *end = start + (size_t)(n);                                       \
+  start = (uint8_t *)((uint32_t)start & ~(CACHE_LINE_SIZE - 1U));           \
   __DSB();                                                                  \
   while (start < end) {                                                     \
     SCB->DCIMVAC = (uint32_t)start;                                         \
-    start += 32U;                                                           \
+    start += CACHE_LINE_SIZE;                                               \
   }                                                                         \
   __DSB();                                                                  \
   __ISB();                                                                  \
@@ -90,10 +172,67 @@
 #define cacheBufferFlush(saddr, n) {                                        \
   uint8_t *start = (uint8_t *)(saddr);                                      \
   uint8_t *end = start + (size_t)(n);                                       \
+  start = (uint8_t *)((uint32_t)start & ~(CACHE_LINE_SIZE - 1U));           \
   __DSB();                                                                  \
   while (start < end) {                                                     \
     SCB->DCCIMVAC = (uint32_t)start;                                        \
-    start += 32U;                                                           \
+    start += CACHE_LINE_SIZE;                                               \
+  }                                                                         \
+  __DSB();                                                                  \
+  __ISB();                                                                  \
+}
+
+/**
+ * @brief   Cleans the data cache lines overlapping a DMA buffer.
+ * @details This function is meant to make sure that data written in
+ *          data cache is written to RAM, the lines stay valid in cache.
+ * @note    On devices without data cache this function does nothing.
+ *
+ * @param[in] saddr     start address of the DMA buffer
+ * @param[in] n         size of the DMA buffer in bytes
+ *
+ * @api
+ */
+#define cacheBufferClean(saddr, n) {                                        \
+  uint8_t *start = (uint8_t *)(saddr);                                      \
+  uint8_t *end = start + (size_t)(n);                                       \
+  start = (uint8_t *)((uint32_t)start & ~(CACHE_LINE_SIZE - 1U));           \
+  __DSB();                                                                  \
+  while (start < end) {                                                     \
+    SCB->DCCMVAC = (uint32_t)start;                                         \
+    start += CACHE_LINE_SIZE;                                               \
+  }                                                                         \
+  __DSB();                                                                  \
+  __ISB();                                                                  \
+}
+
+/**
+ * @brief   Invalidates the data cache lines of a received DMA buffer.
+ * @details Unlike @p cacheBufferInvalidate() the partially overlapped
+ *          lines at the buffer boundaries are flushed instead of being
+ *          invalidated, adjacent data is never lost.
+ * @note    On devices without data cache this function does nothing.
+ *
+ * @param[in] saddr     start address of the DMA buffer
+ * @param[in] n         size of the DMA buffer in bytes
+ *
+ * @api
+ */
+#define cacheBufferInvalidateRange(saddr, n) {                              \
+  uint32_t start = (uint32_t)(saddr);                                       \
+  uint32_t end = start + (uint32_t)(n);                                     \
+  __DSB();                                                                  \
+  if ((start & (CACHE_LINE_SIZE - 1U)) != 0U) {                             \
+    SCB->DCCIMVAC = start;                                                  \
+    start = (start | (CACHE_LINE_SIZE - 1U)) + 1U;                          \
+  }                                                                         \
+  if (((end & (CACHE_LINE_SIZE - 1U)) != 0U) && (end > start)) {            \
+    SCB->DCCIMVAC = end;                                                    \
+    end &= ~(CACHE_LINE_SIZE - 1U);                                         \
+  }                                                                         \
+  while (start < end) {                                                     \
+    SCB->DCIMVAC = start;                                                   \
+    start += CACHE_LINE_SIZE;                                               \
   }                                                                         \
   __DSB();                                                                  \
   __ISB();                                                                  \
@@ -108,6 +247,14 @@
   (void)(addr);                                                             \
   (void)(size);                                                             \
 }
+#define cacheBufferClean(addr, size) {                                      \
+  (void)(addr);                                                             \
+  (void)(size);                                                             \
+}
+#define cacheBufferInvalidateRange(addr, size) {                            \
+  (void)(addr);                                                             \
+  (void)(size);                                                             \
+}
 #endif
 
 #else /* !defined(__DCACHE_PRESENT) */
@@ -119,8 +266,66 @@
   (void)(addr);                                                             \
   (void)(size);                                                             \
 }
+#define cacheBufferClean(addr, size) {                                      \
+  (void)(addr);                                                             \
+  (void)(size);                                                             \
+}
+#define cacheBufferInvalidateRange(addr, size) {                            \
+  (void)(addr);                                                             \
+  (void)(size);                                                             \
+}
 #endif
 
+/**
+ * @name    DMA buffers maintenance
+ * @brief   Macros used by drivers around DMA operations, they do nothing
+ *          if @p CACHE_DMA_MAINTENANCE_ENABLED is @p FALSE.
+ * @{
+ */
+#if (CACHE_DMA_MAINTENANCE_ENABLED == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Prepares a buffer to be read by a DMA.
+ *
+ * @param[in] saddr     start address of the DMA buffer
+ * @param[in] n         size of the DMA buffer in bytes
+ */
+#define cacheDMABeforeTx(saddr, n) cacheBufferClean(saddr, n)
+
+/**
+ * @brief   Prepares a buffer to be written by a DMA.
+ * @details Dirty lines are written back so that they cannot be evicted
+ *          over the received data.
+ *
+ * @param[in] saddr     start address of the DMA buffer
+ * @param[in] n         size of the DMA buffer in bytes
+ */
+#define cacheDMABeforeRx(saddr, n) cacheBufferFlush(saddr, n)
+
+/**
+ * @brief   Makes the data written by a DMA visible to the CPU.
+ * @note    Lines can be speculatively loaded during the DMA operation,
+ *          this must be invoked after the operation completed.
+ *
+ * @param[in] saddr     start address of the DMA buffer
+ * @param[in] n         size of the DMA buffer in bytes
+ */
+#define cacheDMAAfterRx(saddr, n) cacheBufferInvalidateRange(saddr, n)
+#else
+#define cacheDMABeforeTx(saddr, n) {                                        \
+  (void)(saddr);                                                            \
+  (void)(n);                                                                \
+}
+#define cacheDMABeforeRx(saddr, n) {                                        \
+  (void)(saddr);                                                            \
+  (void)(n);                                                                \
+}
+#define cacheDMAAfterRx(saddr, n) {                                         \
+  (void)(saddr);                                                            \
+  (void)(n);                                                                \
+}
+#endif
+/** @} */
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -128,7 +333,10 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
-
+#if CACHE_NOCACHE_POOL_SIZE > 0
+  void cacheNocacheInit(void);
+  void *cacheNocacheAlloc(size_t size);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -39,10 +39,32 @@
 static struct timeval nextcnt;
 static struct timeval tick = {0UL, 1000000UL / OSAL_ST_FREQUENCY};
 
+#if (SIM_USE_VIRTUAL_TIME == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Offset of the simulated time from the host time.
+ */
+static struct timeval skew;
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Returns the simulated time.
+ *
+ * @param[out] tvp      pointer to the time
+ *
+ * @notapi
+ */
+static void sim_get_time(struct timeval *tvp) {
+
+  gettimeofday(tvp, NULL);
+#if SIM_USE_VIRTUAL_TIME == TRUE
+  timeradd(tvp, &skew, tvp);
+#endif
+}
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -61,7 +83,7 @@ void hal_lld_init(void) {
 #else
   puts("ChibiOS/RT simulator (Linux)\n");
 #endif
-  gettimeofday(&nextcnt, NULL);
+  sim_get_time(&nextcnt);
   timeradd(&nextcnt, &tick, &nextcnt);
 }
 
@@ -78,7 +100,28 @@ void _sim_check_for_interrupts(void) {
   }
 #endif
 
-  gettimeofday(&tv, NULL);
+#if HAL_USE_MAC && SIM_MAC_USE_MAC1
+  if (mac_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+  sim_get_time(&tv);
+
+#if SIM_USE_VIRTUAL_TIME == TRUE
+  /* If there is no I/O activity and the idle thread is running then
+     nothing can happen before the next tick, the time is moved forward
+     to it.*/
+  if (!int_occurred && (chThdGetSelfX() == chSysGetIdleThreadX()) &&
+      timercmp(&tv, &nextcnt, <)) {
+    struct timeval delta;
+
+    timersub(&nextcnt, &tv, &delta);
+    timeradd(&skew, &delta, &skew);
+    tv = nextcnt;
+  }
+#endif
+
   if (timercmp(&tv, &nextcnt, >=)) {
     int_occurred = true;
     timeradd(&nextcnt, &tick, &nextcnt);
@@ -53,10 +53,33 @@
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Virtual time switch.
+ * @details If set to @p TRUE the simulated time is advanced immediately
+ *          to the next system tick each time the idle thread has nothing
+ *          to do, time spent running threads still flows at the host
+ *          rate. Test suites mostly waiting on timeouts complete much
+ *          faster than in real time.
+ * @note    The realtime counter is not affected, it still measures the
+ *          host time.
+ */
+#if !defined(SIM_USE_VIRTUAL_TIME) || defined(__DOXYGEN__)
+#define SIM_USE_VIRTUAL_TIME                FALSE
+#endif
+/** @} */
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (SIM_USE_VIRTUAL_TIME == TRUE) && (CH_CFG_NO_IDLE_THREAD == TRUE)
+#error "SIM_USE_VIRTUAL_TIME requires the idle thread"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -0,0 +1,508 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_mac_lld.c
+ * @brief   Posix simulator low level MAC driver code.
+ * @details Frames are exchanged with the host through a Linux TAP
+ *          interface. The interface is polled by the interrupts
+ *          simulation, all the frames available in either direction are
+ *          transferred on each poll and the waiting threads are notified
+ *          once per batch.
+ *
+ * @addtogroup POSIX_MAC
+ * @{
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "hal.h"
+
+#if (HAL_USE_MAC == TRUE) || defined(__DOXYGEN__)
+
+#if (SIM_MAC_USE_MAC1 == TRUE) || defined(__DOXYGEN__)
+#include <sys/ioctl.h>
+#include <net/if.h>
+#include <linux/if_tun.h>
+#endif
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @name    Buffer states
+ * @{
+ */
+#define SIM_MAC_BUF_FREE                    0U  /**< Available.             */
+#define SIM_MAC_BUF_BUSY                    1U  /**< Owned by the driver
+                                                     user.                  */
+#define SIM_MAC_BUF_READY                   2U  /**< Contains a frame.      */
+/** @} */
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   MAC1 driver identifier.
+ */
+#if (SIM_MAC_USE_MAC1 == TRUE) || defined(__DOXYGEN__)
+MACDriver ETHD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+#if (SIM_MAC_USE_MAC1 == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Sends the frames released by the driver user.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              @p true if at least one buffer has been freed.
+ *
+ * @notapi
+ */
+static bool mac_lld_serve_tx(MACDriver *macp) {
+  bool b = false;
+
+  while (macp->tb[macp->txsend].state == SIM_MAC_BUF_READY) {
+    sim_mac_buffer_t *bp = &macp->tb[macp->txsend];
+
+    if (write(macp->tap, bp->data, bp->size) < 0) {
+      /* The frame is retried on the next poll if the host queue is
+         full, on other errors the frame is dropped.*/
+      if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+        break;
+      }
+    }
+    bp->state = SIM_MAC_BUF_FREE;
+    if (++macp->txsend >= SIM_MAC_TRANSMIT_BUFFERS) {
+      macp->txsend = 0U;
+    }
+    b = true;
+  }
+
+  return b;
+}
+
+/**
+ * @brief   Fills the free receive buffers with the frames received by host.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              @p true if at least one frame has been received.
+ *
+ * @notapi
+ */
+static bool mac_lld_serve_rx(MACDriver *macp) {
+  bool b = false;
+
+  while (macp->rb[macp->rxfill].state == SIM_MAC_BUF_FREE) {
+    sim_mac_buffer_t *bp = &macp->rb[macp->rxfill];
+    ssize_t n;
+
+    n = read(macp->tap, bp->data, sizeof(bp->data));
+    if (n <= 0) {
+      break;
+    }
+    bp->size  = (size_t)n;
+    bp->state = SIM_MAC_BUF_READY;
+    if (++macp->rxfill >= SIM_MAC_RECEIVE_BUFFERS) {
+      macp->rxfill = 0U;
+    }
+    b = true;
+  }
+
+  return b;
+}
+#endif /* SIM_MAC_USE_MAC1 == TRUE */
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level MAC initialization.
+ *
+ * @notapi
+ */
+void mac_lld_init(void) {
+
+#if SIM_MAC_USE_MAC1 == TRUE
+  macObjectInit(&ETHD1);
+  ETHD1.tap = -1;
+#endif
+}
+
+/**
+ * @brief   Configures and activates the MAC peripheral.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @notapi
+ */
+void mac_lld_start(MACDriver *macp) {
+  unsigned i;
+
+#if SIM_MAC_USE_MAC1 == TRUE
+  if (&ETHD1 == macp) {
+    struct ifreq ifr;
+
+    macp->tap = open("/dev/net/tun", O_RDWR | O_NONBLOCK);
+    if (macp->tap == -1) {
+      printf("ETHD1: Error opening /dev/net/tun\n");
+      exit(1);
+    }
+
+    memset(&ifr, 0, sizeof(ifr));
+    ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+    strncpy(ifr.ifr_name, SIM_MAC_TAP_NAME, IFNAMSIZ - 1);
+    if (ioctl(macp->tap, TUNSETIFF, &ifr) != 0) {
+      printf("ETHD1: Error attaching to %s\n", SIM_MAC_TAP_NAME);
+      close(macp->tap);
+      exit(1);
+    }
+    printf("Ethernet ETHD1 attached to %s\n", SIM_MAC_TAP_NAME);
+  }
+#endif
+
+  for (i = 0U; i < SIM_MAC_TRANSMIT_BUFFERS; i++) {
+    macp->tb[i].state = SIM_MAC_BUF_FREE;
+  }
+  for (i = 0U; i < SIM_MAC_RECEIVE_BUFFERS; i++) {
+    macp->rb[i].state = SIM_MAC_BUF_FREE;
+  }
+  macp->txget  = 0U;
+  macp->txsend = 0U;
+  macp->rxfill = 0U;
+  macp->rxget  = 0U;
+}
+
+/**
+ * @brief   Deactivates the MAC peripheral.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @notapi
+ */
+void mac_lld_stop(MACDriver *macp) {
+
+  if (macp->state != MAC_STOP) {
+    close(macp->tap);
+    macp->tap = -1;
+  }
+}
+
+/**
+ * @brief   Returns a transmission descriptor.
+ * @details One of the available transmission descriptors is locked and
+ *          returned.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] tdp      pointer to a @p MACTransmitDescriptor structure
+ * @return              The operation status.
+ * @retval MSG_OK       the descriptor has been obtained.
+ * @retval MSG_TIMEOUT  descriptor not available.
+ *
+ * @notapi
+ */
+msg_t mac_lld_get_transmit_descriptor(MACDriver *macp,
+                                      MACTransmitDescriptor *tdp) {
+  sim_mac_buffer_t *bp;
+
+  osalSysLock();
+
+  bp = &macp->tb[macp->txget];
+  if (bp->state != SIM_MAC_BUF_FREE) {
+    osalSysUnlock();
+    return MSG_TIMEOUT;
+  }
+  bp->state = SIM_MAC_BUF_BUSY;
+  if (++macp->txget >= SIM_MAC_TRANSMIT_BUFFERS) {
+    macp->txget = 0U;
+  }
+
+  osalSysUnlock();
+
+  tdp->offset = 0;
+  tdp->size   = SIM_MAC_BUFFERS_SIZE;
+  tdp->bp     = bp;
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Releases a transmit descriptor and starts the transmission of the
+ *          enqueued data as a single frame.
+ * @note    Frames are sent to the host on the next interrupts poll.
+ *
+ * @param[in] tdp       the pointer to the @p MACTransmitDescriptor structure
+ *
+ * @notapi
+ */
+void mac_lld_release_transmit_descriptor(MACTransmitDescriptor *tdp) {
+
+  osalDbgAssert(tdp->bp->state == SIM_MAC_BUF_BUSY,
+                "attempt to release descriptor not owned");
+
+  osalSysLock();
+  tdp->bp->size  = tdp->offset;
+  tdp->bp->state = SIM_MAC_BUF_READY;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Returns a receive descriptor.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] rdp      pointer to a @p MACReceiveDescriptor structure
+ * @return              The operation status.
+ * @retval MSG_OK       the descriptor has been obtained.
+ * @retval MSG_TIMEOUT  descriptor not available.
+ *
+ * @notapi
+ */
+msg_t mac_lld_get_receive_descriptor(MACDriver *macp,
+                                     MACReceiveDescriptor *rdp) {
+  sim_mac_buffer_t *bp;
+
+  osalSysLock();
+
+  bp = &macp->rb[macp->rxget];
+  if (bp->state != SIM_MAC_BUF_READY) {
+    osalSysUnlock();
+    return MSG_TIMEOUT;
+  }
+  bp->state = SIM_MAC_BUF_BUSY;
+  if (++macp->rxget >= SIM_MAC_RECEIVE_BUFFERS) {
+    macp->rxget = 0U;
+  }
+
+  osalSysUnlock();
+
+  rdp->offset = 0;
+  rdp->size   = bp->size;
+  rdp->bp     = bp;
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Releases a receive descriptor.
+ * @details The descriptor and its buffer are made available for more incoming
+ *          frames.
+ *
+ * @param[in] rdp       the pointer to the @p MACReceiveDescriptor structure
+ *
+ * @notapi
+ */
+void mac_lld_release_receive_descriptor(MACReceiveDescriptor *rdp) {
+
+  osalDbgAssert(rdp->bp->state == SIM_MAC_BUF_BUSY,
+                "attempt to release descriptor not owned");
+
+  osalSysLock();
+  rdp->bp->state = SIM_MAC_BUF_FREE;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Updates and returns the link status.
+ * @note    The link is considered up while the TAP interface is attached.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The link status.
+ * @retval true         if the link is active.
+ * @retval false        if the link is down.
+ *
+ * @notapi
+ */
+bool mac_lld_poll_link_status(MACDriver *macp) {
+
+  return macp->tap != -1;
+}
+
+/**
+ * @brief   Writes to a transmit descriptor's stream.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ * @param[in] buf       pointer to the buffer containing the data to be
+ *                      written
+ * @param[in] size      number of bytes to be written
+ * @return              The number of bytes written into the descriptor's
+ *                      stream, this value can be less than the amount
+ *                      specified in the parameter @p size if the maximum
+ *                      frame size is reached.
+ *
+ * @notapi
+ */
+size_t mac_lld_write_transmit_descriptor(MACTransmitDescriptor *tdp,
+                                         uint8_t *buf,
+                                         size_t size) {
+
+  if (size > tdp->size - tdp->offset) {
+    size = tdp->size - tdp->offset;
+  }
+
+  if (size > 0) {
+    memcpy(&tdp->bp->data[tdp->offset], buf, size);
+    tdp->offset += size;
+  }
+  return size;
+}
+
+/**
+ * @brief   Reads from a receive descriptor's stream.
+ *
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @param[in] buf       pointer to the buffer that will receive the read data
+ * @param[in] size      number of bytes to be read
+ * @return              The number of bytes read from the descriptor's
+ *                      stream, this value can be less than the amount
+ *                      specified in the parameter @p size if there are
+ *                      no more bytes to read.
+ *
+ * @notapi
+ */
+size_t mac_lld_read_receive_descriptor(MACReceiveDescriptor *rdp,
+                                       uint8_t *buf,
+                                       size_t size) {
+
+  if (size > rdp->size - rdp->offset) {
+    size = rdp->size - rdp->offset;
+  }
+
+  if (size > 0) {
+    memcpy(buf, &rdp->bp->data[rdp->offset], size);
+    rdp->offset += size;
+  }
+  return size;
+}
+
+#if (MAC_USE_ZERO_COPY == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns a pointer to the next transmit buffer in the descriptor
+ *          chain.
+ * @note    The API guarantees that enough buffers can be requested to fill
+ *          a whole frame.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ * @param[in] size      size of the requested buffer. Specify the frame size
+ *                      on the first call then scale the value down subtracting
+ *                      the amount of data already copied into the previous
+ *                      buffers.
+ * @param[out] sizep    pointer to variable receiving the buffer size, it is
+ *                      zero when the last buffer has already been returned.
+ *                      Note that a returned size lower than the amount
+ *                      requested means that more buffers must be requested
+ *                      in order to fill the frame data entirely.
+ * @return              Pointer to the returned buffer.
+ * @retval NULL         if the buffer chain has been entirely scanned.
+ *
+ * @notapi
+ */
+uint8_t *mac_lld_get_next_transmit_buffer(MACTransmitDescriptor *tdp,
+                                          size_t size,
+                                          size_t *sizep) {
+
+  if (tdp->offset == 0) {
+    *sizep      = tdp->size;
+    tdp->offset = size;
+    return tdp->bp->data;
+  }
+  *sizep = 0;
+  return NULL;
+}
+
+/**
+ * @brief   Returns a pointer to the next receive buffer in the descriptor
+ *          chain.
+ * @note    The API guarantees that the descriptor chain contains a whole
+ *          frame.
+ *
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @param[out] sizep    pointer to variable receiving the buffer size, it is
+ *                      zero when the last buffer has already been returned.
+ * @return              Pointer to the returned buffer.
+ * @retval NULL         if the buffer chain has been entirely scanned.
+ *
+ * @notapi
+ */
+const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
+                                               size_t *sizep) {
+
+  if (rdp->size > 0) {
+    *sizep      = rdp->size;
+    rdp->offset = rdp->size;
+    rdp->size   = 0;
+    return rdp->bp->data;
+  }
+  *sizep = 0;
+  return NULL;
+}
+#endif /* MAC_USE_ZERO_COPY == TRUE */
+
+/**
+ * @brief   Serves the pending frames in both directions.
+ * @details Invoked by the interrupts simulation, the waiting threads are
+ *          notified once for all the frames transferred by the poll.
+ *
+ * @return              @p true if there has been activity.
+ *
+ * @notapi
+ */
+bool mac_lld_interrupt_pending(void) {
+  bool tx = false, rx = false;
+
+  OSAL_IRQ_PROLOGUE();
+
+#if SIM_MAC_USE_MAC1 == TRUE
+  if (ETHD1.tap != -1) {
+    osalSysLockFromISR();
+    tx = mac_lld_serve_tx(&ETHD1);
+    rx = mac_lld_serve_rx(&ETHD1);
+    if (tx) {
+      osalThreadDequeueAllI(&ETHD1.tdqueue, MSG_RESET);
+    }
+    if (rx) {
+      osalThreadDequeueAllI(&ETHD1.rdqueue, MSG_RESET);
+#if MAC_USE_EVENTS == TRUE
+      osalEventBroadcastFlagsI(&ETHD1.rdevent, 0);
+#endif
+    }
+    osalSysUnlockFromISR();
+  }
+#endif
+
+  OSAL_IRQ_EPILOGUE();
+
+  return tx || rx;
+}
+
+#endif /* HAL_USE_MAC == TRUE */
+
+/** @} */
@@ -0,0 +1,280 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_mac_lld.h
+ * @brief   Posix simulator low level MAC driver header.
+ *
+ * @addtogroup POSIX_MAC
+ * @{
+ */
+
+#ifndef HAL_MAC_LLD_H
+#define HAL_MAC_LLD_H
+
+#if (HAL_USE_MAC == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   This implementation supports the zero-copy mode API.
+ */
+#define MAC_SUPPORTS_ZERO_COPY              TRUE
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   MAC driver enable switch.
+ * @details If set to @p TRUE the support for ETHD1 is included, frames
+ *          are exchanged with the host through a TAP interface.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(SIM_MAC_USE_MAC1) || defined(__DOXYGEN__)
+#define SIM_MAC_USE_MAC1                    FALSE
+#endif
+
+/**
+ * @brief   Name of the host TAP interface.
+ * @note    The interface must exist and be accessible to the simulator
+ *          process, it can be created using
+ *          <tt>ip tuntap add dev tap0 mode tap user $USER</tt>.
+ */
+#if !defined(SIM_MAC_TAP_NAME) || defined(__DOXYGEN__)
+#define SIM_MAC_TAP_NAME                    "tap0"
+#endif
+
+/**
+ * @brief   Number of available transmit buffers.
+ */
+#if !defined(SIM_MAC_TRANSMIT_BUFFERS) || defined(__DOXYGEN__)
+#define SIM_MAC_TRANSMIT_BUFFERS            4
+#endif
+
+/**
+ * @brief   Number of available receive buffers.
+ */
+#if !defined(SIM_MAC_RECEIVE_BUFFERS) || defined(__DOXYGEN__)
+#define SIM_MAC_RECEIVE_BUFFERS             8
+#endif
+
+/**
+ * @brief   Maximum supported frame size.
+ */
+#if !defined(SIM_MAC_BUFFERS_SIZE) || defined(__DOXYGEN__)
+#define SIM_MAC_BUFFERS_SIZE                1522
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (SIM_MAC_USE_MAC1 == TRUE) && !defined(__linux__)
+#error "TAP interfaces are only supported on Linux hosts"
+#endif
+
+#if SIM_MAC_TRANSMIT_BUFFERS < 1
+#error "invalid SIM_MAC_TRANSMIT_BUFFERS value"
+#endif
+
+#if SIM_MAC_RECEIVE_BUFFERS < 1
+#error "invalid SIM_MAC_RECEIVE_BUFFERS value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a frame buffer.
+ */
+typedef struct {
+  /**
+   * @brief   Buffer state.
+   */
+  volatile uint32_t     state;
+  /**
+   * @brief   Frame size.
+   */
+  size_t                size;
+  /**
+   * @brief   Frame data.
+   */
+  uint8_t               data[SIM_MAC_BUFFERS_SIZE];
+} sim_mac_buffer_t;
+
+/**
+ * @brief   Driver configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief MAC address.
+   */
+  uint8_t               *mac_address;
+  /* End of the mandatory fields.*/
+} MACConfig;
+
+/**
+ * @brief   Structure representing a MAC driver.
+ */
+struct MACDriver {
+  /**
+   * @brief Driver state.
+   */
+  macstate_t            state;
+  /**
+   * @brief Current configuration data.
+   */
+  const MACConfig       *config;
+  /**
+   * @brief Transmit semaphore.
+   */
+  threads_queue_t       tdqueue;
+  /**
+   * @brief Receive semaphore.
+   */
+  threads_queue_t       rdqueue;
+#if (MAC_USE_EVENTS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief Receive event.
+   */
+  event_source_t        rdevent;
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief TAP file descriptor.
+   */
+  int                   tap;
+  /**
+   * @brief Transmit buffers.
+   */
+  sim_mac_buffer_t      tb[SIM_MAC_TRANSMIT_BUFFERS];
+  /**
+   * @brief Receive buffers.
+   */
+  sim_mac_buffer_t      rb[SIM_MAC_RECEIVE_BUFFERS];
+  /**
+   * @brief Next transmit buffer to be taken by the application.
+   */
+  unsigned              txget;
+  /**
+   * @brief Next transmit buffer to be sent.
+   */
+  unsigned              txsend;
+  /**
+   * @brief Next receive buffer to be filled.
+   */
+  unsigned              rxfill;
+  /**
+   * @brief Next receive buffer to be taken by the application.
+   */
+  unsigned              rxget;
+};
+
+/**
+ * @brief   Structure representing a transmit descriptor.
+ */
+typedef struct {
+  /**
+   * @brief Current write offset.
+   */
+  size_t                offset;
+  /**
+   * @brief Available space size.
+   */
+  size_t                size;
+  /* End of the mandatory fields.*/
+  /**
+   * @brief Pointer to the frame buffer.
+   */
+  sim_mac_buffer_t      *bp;
+} MACTransmitDescriptor;
+
+/**
+ * @brief   Structure representing a receive descriptor.
+ */
+typedef struct {
+  /**
+   * @brief Current read offset.
+   */
+  size_t                offset;
+  /**
+   * @brief Available data size.
+   */
+  size_t                size;
+  /* End of the mandatory fields.*/
+  /**
+   * @brief Pointer to the frame buffer.
+   */
+  sim_mac_buffer_t      *bp;
+} MACReceiveDescriptor;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if (SIM_MAC_USE_MAC1 == TRUE) && !defined(__DOXYGEN__)
+extern MACDriver ETHD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void mac_lld_init(void);
+  void mac_lld_start(MACDriver *macp);
+  void mac_lld_stop(MACDriver *macp);
+  msg_t mac_lld_get_transmit_descriptor(MACDriver *macp,
+                                        MACTransmitDescriptor *tdp);
+  void mac_lld_release_transmit_descriptor(MACTransmitDescriptor *tdp);
+  msg_t mac_lld_get_receive_descriptor(MACDriver *macp,
+                                       MACReceiveDescriptor *rdp);
+  void mac_lld_release_receive_descriptor(MACReceiveDescriptor *rdp);
+  bool mac_lld_poll_link_status(MACDriver *macp);
+  size_t mac_lld_write_transmit_descriptor(MACTransmitDescriptor *tdp,
+                                           uint8_t *buf,
+                                           size_t size);
+  size_t mac_lld_read_receive_descriptor(MACReceiveDescriptor *rdp,
+                                         uint8_t *buf,
+                                         size_t size);
+#if MAC_USE_ZERO_COPY == TRUE
+  uint8_t *mac_lld_get_next_transmit_buffer(MACTransmitDescriptor *tdp,
+                                            size_t size,
+                                            size_t *sizep);
+  const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
+                                                 size_t *sizep);
+#endif
+  bool mac_lld_interrupt_pending(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_MAC == TRUE */
+
+#endif /* HAL_MAC_LLD_H */
+
+/** @} */
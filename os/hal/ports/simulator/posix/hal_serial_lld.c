@@ -56,6 +56,14 @@ static const SerialConfig default_config = {
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+static void disconnect(SerialDriver *sdp) {
+
+  close(sdp->com_data);
+  sdp->com_data = -1;
+  sdp->com_txn  = 0;
+  sdp->com_txi  = 0;
+}
+
 static void init(SerialDriver *sdp, uint16_t port) {
   struct sockaddr_in sad;
   struct protoent *prtp;
@@ -148,16 +156,16 @@ static bool inint(SerialDriver *sdp) {
 
   if (sdp->com_data != -1) {
     int i;
-    uint8_t data[32];
+    uint8_t data[SIM_SERIAL_IO_BATCH];
 
     /*
-     * Input.
+     * Input, all the received bytes are inserted within a single
+     * critical zone.
      */
     int n = recv(sdp->com_data, data, sizeof(data), 0);
     switch (n) {
     case 0:
-      close(sdp->com_data);
-      sdp->com_data = -1;
+      disconnect(sdp);
       osalSysLockFromISR();
       chnAddFlagsI(sdp, CHN_DISCONNECTED);
       osalSysUnlockFromISR();
@@ -165,15 +173,14 @@ static bool inint(SerialDriver *sdp) {
     case -1:
       if (errno == EWOULDBLOCK)
         return false;
-      close(sdp->com_data);
-      sdp->com_data = -1;
+      disconnect(sdp);
       return false;
     }
+    osalSysLockFromISR();
     for (i = 0; i < n; i++) {
-      osalSysLockFromISR();
       sdIncomingDataI(sdp, data[i]);
-      osalSysUnlockFromISR();
     }
+    osalSysUnlockFromISR();
     return true;
   }
   return false;
@@ -183,22 +190,30 @@ static bool outint(SerialDriver *sdp) {
 
   if (sdp->com_data != -1) {
     int n;
-    uint8_t data[1];
 
     /*
-     * Input.
+     * Output, a new batch is taken from the output queue only after the
+     * previous one has been completely sent.
      */
-    osalSysLockFromISR();
-    n = sdRequestDataI(sdp);
-    osalSysUnlockFromISR();
-    if (n < 0)
-      return false;
-    data[0] = (uint8_t)n;
-    n = send(sdp->com_data, data, sizeof(data), 0);
+    if (sdp->com_txi >= sdp->com_txn) {
+      sdp->com_txn = 0;
+      sdp->com_txi = 0;
+      osalSysLockFromISR();
+      while (sdp->com_txn < sizeof(sdp->com_txbuf)) {
+        msg_t b = sdRequestDataI(sdp);
+        if (b < MSG_OK)
+          break;
+        sdp->com_txbuf[sdp->com_txn++] = (uint8_t)b;
+      }
+      osalSysUnlockFromISR();
+      if (sdp->com_txn == 0)
+        return false;
+    }
+    n = send(sdp->com_data, &sdp->com_txbuf[sdp->com_txi],
+             sdp->com_txn - sdp->com_txi, 0);
     switch (n) {
     case 0:
-      close(sdp->com_data);
-      sdp->com_data = -1;
+      disconnect(sdp);
       osalSysLockFromISR();
       chnAddFlagsI(sdp, CHN_DISCONNECTED);
       osalSysUnlockFromISR();
@@ -206,15 +221,25 @@ static bool outint(SerialDriver *sdp) {
     case -1:
       if (errno == EWOULDBLOCK)
         return false;
-      close(sdp->com_data);
-      sdp->com_data = -1;
+      disconnect(sdp);
       return false;
     }
+    sdp->com_txi += (size_t)n;
     return true;
   }
   return false;
 }
 
+static bool serve(SerialDriver *sdp) {
+  bool b;
+
+  b = connint(sdp);
+  b = inint(sdp) || b;
+  b = outint(sdp) || b;
+
+  return b;
+}
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -233,6 +258,8 @@ void sd_lld_init(void) {
   SD1.com_listen = -1;
   SD1.com_data = -1;
   SD1.com_name = "SD1";
+  SD1.com_txn = 0;
+  SD1.com_txi = 0;
 #endif
 
 #if USE_SIM_SERIAL2
@@ -240,6 +267,8 @@ void sd_lld_init(void) {
   SD2.com_listen = -1;
   SD2.com_data = -1;
   SD2.com_name = "SD2";
+  SD2.com_txn = 0;
+  SD2.com_txi = 0;
 #endif
 }
 
@@ -279,14 +308,25 @@ void sd_lld_stop(SerialDriver *sdp) {
   (void)sdp;
 }
 
+/**
+ * @brief   Serves the pending I/O of all the ports.
+ * @details All the ports are served on each invocation, a single
+ *          invocation can transfer up to @p SIM_SERIAL_IO_BATCH bytes
+ *          in each direction for each port.
+ *
+ * @return              @p true if there has been activity.
+ */
 bool sd_lld_interrupt_pending(void) {
-  bool b;
+  bool b = false;
 
   OSAL_IRQ_PROLOGUE();
 
-  b =  connint(&SD1) || connint(&SD2) ||
-       inint(&SD1)   || inint(&SD2)   ||
-       outint(&SD1)  || outint(&SD2);
+#if USE_SIM_SERIAL1
+  b = serve(&SD1) || b;
+#endif
+#if USE_SIM_SERIAL2
+  b = serve(&SD2) || b;
+#endif
 
   OSAL_IRQ_EPILOGUE();
 
@@ -72,6 +72,23 @@
 #define SIM_SD2_PORT                        29002
 #endif
 
+/**
+ * @brief   Maximum bytes transferred by a single socket operation.
+ * @details Larger values reduce the number of host system calls and
+ *          critical zones per transferred byte.
+ */
+#if !defined(SIM_SERIAL_IO_BATCH) || defined(__DOXYGEN__)
+#define SIM_SERIAL_IO_BATCH                 256
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if SIM_SERIAL_IO_BATCH < 1
+#error "invalid SIM_SERIAL_IO_BATCH value"
+#endif
+
 /*===========================================================================*/
 /* Unsupported event flags and custom events.                                */
 /*===========================================================================*/
@@ -112,7 +129,13 @@ typedef struct {
   /* Data socket for simulated serial port.*/                               \
   int                       com_data;                                       \
   /* Port readable name.*/                                                  \
-  const char                *com_name;
+  const char                *com_name;                                      \
+  /* Bytes taken from the output queue and not yet sent.*/                  \
+  uint8_t                   com_txbuf[SIM_SERIAL_IO_BATCH];                 \
+  /* Number of valid bytes in the transmit buffer.*/                        \
+  size_t                    com_txn;                                        \
+  /* Index of the next byte to be sent.*/                                   \
+  size_t                    com_txi;
 
 /*===========================================================================*/
 /* External declarations.                                                    */
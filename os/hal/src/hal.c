@@ -80,6 +80,9 @@ void halInit(void) {
 #if (HAL_USE_DAC == TRUE) || defined(__DOXYGEN__)
   dacInit();
 #endif
+#if (HAL_USE_EFL == TRUE) || defined(__DOXYGEN__)
+  eflInit();
+#endif
 #if (HAL_USE_EXT == TRUE) || defined(__DOXYGEN__)
   extInit();
 #endif
@@ -119,6 +122,9 @@ void halInit(void) {
 #if (HAL_USE_USB == TRUE) || defined(__DOXYGEN__)
   usbInit();
 #endif
+#if (HAL_USE_USBH == TRUE) || defined(__DOXYGEN__)
+  usbhInit();
+#endif
 #if (HAL_USE_MMC_SPI == TRUE) || defined(__DOXYGEN__)
   mmcInit();
 #endif
@@ -134,6 +140,9 @@ void halInit(void) {
 #if (HAL_USE_WSPI == TRUE) || defined(__DOXYGEN__)
   wspiInit();
 #endif
+#if (HAL_USE_PM == TRUE) || defined(__DOXYGEN__)
+  pmInit();
+#endif
 
   /* Community driver overlay initialization.*/
 #if defined(HAL_USE_COMMUNITY) || defined(__DOXYGEN__)
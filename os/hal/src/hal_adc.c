@@ -22,6 +22,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 
 #if (HAL_USE_ADC == TRUE) || defined(__DOXYGEN__)
@@ -78,6 +80,10 @@ void adcObjectInit(ADCDriver *adcp) {
 #if ADC_USE_MUTUAL_EXCLUSION == TRUE
   osalMutexObjectInit(&adcp->mutex);
 #endif
+#if ADC_USE_STREAMING == TRUE
+  adcp->ibqp     = NULL;
+  adcp->overruns = 0U;
+#endif
 #if defined(ADC_DRIVER_EXT_INIT_HOOK)
   ADC_DRIVER_EXT_INIT_HOOK(adcp);
 #endif
@@ -189,6 +195,10 @@ void adcStartConversionI(ADCDriver *adcp,
   adcp->depth    = depth;
   adcp->grpp     = grpp;
   adcp->state    = ADC_ACTIVE;
+#if ADC_USE_STREAMING == TRUE
+  adcp->ibqp     = NULL;
+#endif
+  _adc_pm_lock(adcp);
   adc_lld_start_conversion(adcp);
 }
 
@@ -211,6 +221,7 @@ void adcStopConversion(ADCDriver *adcp) {
                 "invalid state");
   if (adcp->state != ADC_READY) {
     adc_lld_stop_conversion(adcp);
+    _adc_pm_unlock_i(adcp);
     adcp->grpp  = NULL;
     adcp->state = ADC_READY;
     _adc_reset_s(adcp);
@@ -239,6 +250,9 @@ void adcStopConversionI(ADCDriver *adcp) {
 
   if (adcp->state != ADC_READY) {
     adc_lld_stop_conversion(adcp);
+    if (adcp->state == ADC_ACTIVE) {
+      _adc_pm_unlock_i(adcp);
+    }
     adcp->grpp  = NULL;
     adcp->state = ADC_READY;
     _adc_reset_i(adcp);
@@ -320,6 +334,107 @@ void adcReleaseBus(ADCDriver *adcp) {
 }
 #endif /* ADC_USE_MUTUAL_EXCLUSION == TRUE */
 
+#if (ADC_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a circular conversion streamed into a buffers queue.
+ * @details Each completed half of the samples buffer is copied in an empty
+ *          buffer of the queue and posted as a full buffer, consumer
+ *          threads can fetch the samples using the buffers queue API.
+ *          If no empty buffer is available the half buffer is discarded
+ *          and the overruns counter incremented.
+ * @note    The conversion group must be circular, the group callback is
+ *          still invoked if specified.
+ * @note    The queue buffers must be able to contain half of the samples
+ *          buffer.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ * @param[in] grpp      pointer to a @p ADCConversionGroup object
+ * @param[out] samples  pointer to the samples buffer
+ * @param[in] depth     buffer depth (matrix rows number), it must be an
+ *                      even number
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ *
+ * @iclass
+ */
+void adcStartStreamI(ADCDriver *adcp,
+                     const ADCConversionGroup *grpp,
+                     adcsample_t *samples,
+                     size_t depth,
+                     input_buffers_queue_t *ibqp) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((grpp != NULL) && (ibqp != NULL) &&
+               (depth >= 2U) && ((depth & 1U) == 0U));
+  osalDbgAssert(grpp->circular, "not circular");
+  osalDbgAssert((ibqp->bsize - sizeof (size_t)) >=
+                ((depth / 2U) * grpp->num_channels * sizeof (adcsample_t)),
+                "queue buffers too small");
+
+  adcStartConversionI(adcp, grpp, samples, depth);
+  adcp->ibqp     = ibqp;
+  adcp->overruns = 0U;
+}
+
+/**
+ * @brief   Starts a circular conversion streamed into a buffers queue.
+ * @details Each completed half of the samples buffer is copied in an empty
+ *          buffer of the queue and posted as a full buffer, consumer
+ *          threads can fetch the samples using the buffers queue API.
+ *          If no empty buffer is available the half buffer is discarded
+ *          and the overruns counter incremented.
+ * @note    The conversion group must be circular, the group callback is
+ *          still invoked if specified.
+ * @note    The queue buffers must be able to contain half of the samples
+ *          buffer.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ * @param[in] grpp      pointer to a @p ADCConversionGroup object
+ * @param[out] samples  pointer to the samples buffer
+ * @param[in] depth     buffer depth (matrix rows number), it must be an
+ *                      even number
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ *
+ * @api
+ */
+void adcStartStream(ADCDriver *adcp,
+                    const ADCConversionGroup *grpp,
+                    adcsample_t *samples,
+                    size_t depth,
+                    input_buffers_queue_t *ibqp) {
+
+  osalSysLock();
+  adcStartStreamI(adcp, grpp, samples, depth, ibqp);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Posts an half buffer in the streaming queue.
+ * @note    This function is meant to be used in the low level drivers
+ *          implementation only, it is invoked by the ISR helper macros.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ * @param[in] buf       pointer to the completed half buffer
+ *
+ * @notapi
+ */
+void _adc_stream_post(ADCDriver *adcp, const adcsample_t *buf) {
+  size_t n = (adcp->depth / 2U) * adcp->grpp->num_channels *
+             sizeof (adcsample_t);
+  uint8_t *bp;
+
+  osalSysLockFromISR();
+  bp = ibqGetEmptyBufferI(adcp->ibqp);
+  if (bp != NULL) {
+    memcpy(bp, buf, n);
+    ibqPostFullBufferI(adcp->ibqp, n);
+  }
+  else {
+    adcp->overruns++;
+  }
+  osalSysUnlockFromISR();
+}
+#endif /* ADC_USE_STREAMING == TRUE */
+
 #endif /* HAL_USE_ADC == TRUE */
 
 /** @} */
@@ -137,6 +137,36 @@ uint8_t *ibqGetEmptyBufferI(input_buffers_queue_t *ibqp) {
   return ibqp->bwrptr + sizeof (size_t);
 }
 
+/**
+ * @brief   Gets the empty buffer following the next one.
+ * @details Returns the buffer that @p ibqGetEmptyBufferI() would return
+ *          after posting the current one, this allows a double buffered
+ *          DMA to have two buffers in flight.
+ * @note    The function always returns the same buffer if called repeatedly.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ * @return              A pointer to the second buffer to be filled.
+ * @retval NULL         if the queue has less than two empty buffers.
+ *
+ * @iclass
+ */
+uint8_t *ibqGetNextEmptyBufferI(input_buffers_queue_t *ibqp) {
+  uint8_t *bp;
+
+  osalDbgCheckClassI();
+
+  if ((ibqp->bn - ibqp->bcounter) < 2U) {
+    return NULL;
+  }
+
+  bp = ibqp->bwrptr + ibqp->bsize;
+  if (bp >= ibqp->btop) {
+    bp = ibqp->buffers;
+  }
+
+  return bp + sizeof (size_t);
+}
+
 /**
  * @brief   Posts a new filled buffer to the queue.
  *
@@ -287,6 +317,159 @@ void ibqReleaseEmptyBuffer(input_buffers_queue_t *ibqp) {
   }
 }
 
+/**
+ * @brief   Gets a series of filled buffers from the queue.
+ * @details The function waits for at least one filled buffer then describes
+ *          up to @p n consecutive filled buffers using an array of segments,
+ *          the data can be consumed in place with a single scatter-gather
+ *          operation.
+ * @note    If a buffer is being read sequentially then the first segment
+ *          only describes its unread part.
+ * @note    The buffers are not removed from the queue, use
+ *          @p ibqReleaseEmptyBuffers() after consuming the data.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ * @param[out] sgp      pointer to an array of @p n segments
+ * @param[in] n         the maximum number of buffers to be acquired, the
+ *                      value 0 is reserved
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of segments filled in the array.
+ * @retval 0            if a timeout occurred or the queue has been reset or
+ *                      has been put in suspended state.
+ *
+ * @api
+ */
+size_t ibqGetFullBuffersTimeout(input_buffers_queue_t *ibqp,
+                                bqsegment_t *sgp, size_t n,
+                                sysinterval_t timeout) {
+  size_t k;
+
+  osalSysLock();
+  k = ibqGetFullBuffersTimeoutS(ibqp, sgp, n, timeout);
+  osalSysUnlock();
+
+  return k;
+}
+
+/**
+ * @brief   Gets a series of filled buffers from the queue.
+ * @details The function waits for at least one filled buffer then describes
+ *          up to @p n consecutive filled buffers using an array of segments,
+ *          the data can be consumed in place with a single scatter-gather
+ *          operation.
+ * @note    If a buffer is being read sequentially then the first segment
+ *          only describes its unread part.
+ * @note    The buffers are not removed from the queue, use
+ *          @p ibqReleaseEmptyBuffersS() after consuming the data.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ * @param[out] sgp      pointer to an array of @p n segments
+ * @param[in] n         the maximum number of buffers to be acquired, the
+ *                      value 0 is reserved
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of segments filled in the array.
+ * @retval 0            if a timeout occurred or the queue has been reset or
+ *                      has been put in suspended state.
+ *
+ * @sclass
+ */
+size_t ibqGetFullBuffersTimeoutS(input_buffers_queue_t *ibqp,
+                                 bqsegment_t *sgp, size_t n,
+                                 sysinterval_t timeout) {
+  uint8_t *bp;
+  size_t i, k;
+
+  osalDbgCheckClassS();
+  osalDbgCheck((sgp != NULL) && (n > 0U));
+
+  /* The first buffer could be already acquired for sequential access.*/
+  if (ibqp->ptr == NULL) {
+    if (ibqGetFullBufferTimeoutS(ibqp, timeout) != MSG_OK) {
+      return (size_t)0;
+    }
+  }
+
+  /* First segment, the buffer could be partially read.*/
+  sgp[0].buf  = ibqp->ptr;
+  sgp[0].size = (size_t)ibqp->top - (size_t)ibqp->ptr;
+
+  /* Following filled buffers, if any.*/
+  k = bqSpaceI(ibqp) < n ? bqSpaceI(ibqp) : n;
+  bp = ibqp->brdptr;
+  for (i = 1U; i < k; i++) {
+    bp += ibqp->bsize;
+    if (bp >= ibqp->btop) {
+      bp = ibqp->buffers;
+    }
+    sgp[i].buf  = bp + sizeof (size_t);
+    sgp[i].size = *((size_t *)bp);
+  }
+
+  return k;
+}
+
+/**
+ * @brief   Releases a series of buffers back in the queue.
+ * @note    The object callback is called once after releasing all the
+ *          buffers.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ * @param[in] n         number of buffers to be released, the value 0 is
+ *                      reserved
+ *
+ * @api
+ */
+void ibqReleaseEmptyBuffers(input_buffers_queue_t *ibqp, size_t n) {
+
+  osalSysLock();
+  ibqReleaseEmptyBuffersS(ibqp, n);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Releases a series of buffers back in the queue.
+ * @note    The object callback is called once after releasing all the
+ *          buffers.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ * @param[in] n         number of buffers to be released, the value 0 is
+ *                      reserved
+ *
+ * @sclass
+ */
+void ibqReleaseEmptyBuffersS(input_buffers_queue_t *ibqp, size_t n) {
+
+  osalDbgCheckClassS();
+  osalDbgCheck((n > 0U) && (n <= ibqp->bn));
+  osalDbgAssert(n <= bqSpaceI(ibqp), "not enough filled buffers");
+
+  /* Freeing the buffer slots in the queue.*/
+  ibqp->bcounter -= n;
+  while (n > 0U) {
+    ibqp->brdptr += ibqp->bsize;
+    if (ibqp->brdptr >= ibqp->btop) {
+      ibqp->brdptr = ibqp->buffers;
+    }
+    n--;
+  }
+
+  /* No "current" buffer.*/
+  ibqp->ptr = NULL;
+
+  /* Notifying the buffers release.*/
+  if (ibqp->notify != NULL) {
+    ibqp->notify(ibqp);
+  }
+}
+
 /**
  * @brief   Input queue read with timeout.
  * @details This function reads a byte value from an input queue. If
@@ -498,6 +681,41 @@ uint8_t *obqGetFullBufferI(output_buffers_queue_t *obqp,
   return obqp->brdptr + sizeof (size_t);
 }
 
+/**
+ * @brief   Gets the filled buffer following the next one.
+ * @details Returns the buffer that @p obqGetFullBufferI() would return
+ *          after releasing the current one, this allows a double buffered
+ *          DMA to have two buffers in flight.
+ * @note    The function always returns the same buffer if called repeatedly.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[out] sizep    pointer to the filled buffer size
+ * @return              A pointer to the second filled buffer.
+ * @retval NULL         if the queue has less than two filled buffers.
+ *
+ * @iclass
+ */
+uint8_t *obqGetNextFullBufferI(output_buffers_queue_t *obqp,
+                               size_t *sizep) {
+  uint8_t *bp;
+
+  osalDbgCheckClassI();
+
+  if ((obqp->bn - obqp->bcounter) < 2U) {
+    return NULL;
+  }
+
+  bp = obqp->brdptr + obqp->bsize;
+  if (bp >= obqp->btop) {
+    bp = obqp->buffers;
+  }
+
+  /* Buffer size.*/
+  *sizep = *((size_t *)bp);
+
+  return bp + sizeof (size_t);
+}
+
 /**
  * @brief   Releases the next filled buffer back in the queue.
  *
@@ -648,6 +866,182 @@ void obqPostFullBufferS(output_buffers_queue_t *obqp, size_t size) {
   }
 }
 
+/**
+ * @brief   Gets a series of empty buffers from the queue.
+ * @details The function waits for at least one empty buffer then describes
+ *          up to @p n consecutive empty buffers using an array of segments,
+ *          the buffers can be filled in place with a single scatter-gather
+ *          operation.
+ * @note    If a buffer is being written sequentially then the first segment
+ *          only describes its unwritten part.
+ * @note    The buffers are not inserted in the queue, use
+ *          @p obqPostFullBuffers() after filling them.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[out] sgp      pointer to an array of @p n segments
+ * @param[in] n         the maximum number of buffers to be acquired, the
+ *                      value 0 is reserved
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of segments filled in the array.
+ * @retval 0            if a timeout occurred or the queue has been reset or
+ *                      has been put in suspended state.
+ *
+ * @api
+ */
+size_t obqGetEmptyBuffersTimeout(output_buffers_queue_t *obqp,
+                                 bqsegment_t *sgp, size_t n,
+                                 sysinterval_t timeout) {
+  size_t k;
+
+  osalSysLock();
+  k = obqGetEmptyBuffersTimeoutS(obqp, sgp, n, timeout);
+  osalSysUnlock();
+
+  return k;
+}
+
+/**
+ * @brief   Gets a series of empty buffers from the queue.
+ * @details The function waits for at least one empty buffer then describes
+ *          up to @p n consecutive empty buffers using an array of segments,
+ *          the buffers can be filled in place with a single scatter-gather
+ *          operation.
+ * @note    If a buffer is being written sequentially then the first segment
+ *          only describes its unwritten part.
+ * @note    The buffers are not inserted in the queue, use
+ *          @p obqPostFullBuffersS() after filling them.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[out] sgp      pointer to an array of @p n segments
+ * @param[in] n         the maximum number of buffers to be acquired, the
+ *                      value 0 is reserved
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of segments filled in the array.
+ * @retval 0            if a timeout occurred or the queue has been reset or
+ *                      has been put in suspended state.
+ *
+ * @sclass
+ */
+size_t obqGetEmptyBuffersTimeoutS(output_buffers_queue_t *obqp,
+                                  bqsegment_t *sgp, size_t n,
+                                  sysinterval_t timeout) {
+  uint8_t *bp;
+  size_t i, k;
+
+  osalDbgCheckClassS();
+  osalDbgCheck((sgp != NULL) && (n > 0U));
+
+  /* The first buffer could be already acquired for sequential access.*/
+  if (obqp->ptr == NULL) {
+    if (obqGetEmptyBufferTimeoutS(obqp, timeout) != MSG_OK) {
+      return (size_t)0;
+    }
+  }
+
+  /* First segment, the buffer could be partially written.*/
+  sgp[0].buf  = obqp->ptr;
+  sgp[0].size = (size_t)obqp->top - (size_t)obqp->ptr;
+
+  /* Following empty buffers, if any.*/
+  k = bqSpaceI(obqp) < n ? bqSpaceI(obqp) : n;
+  bp = obqp->bwrptr;
+  for (i = 1U; i < k; i++) {
+    bp += obqp->bsize;
+    if (bp >= obqp->btop) {
+      bp = obqp->buffers;
+    }
+    sgp[i].buf  = bp + sizeof (size_t);
+    sgp[i].size = obqp->bsize - sizeof (size_t);
+  }
+
+  return k;
+}
+
+/**
+ * @brief   Posts a series of filled buffers to the queue.
+ * @details The segments are those returned by @p obqGetEmptyBuffersTimeout()
+ *          with the @p size fields updated to the amount of data written
+ *          in each segment.
+ * @note    The object callback is called once after posting all the
+ *          buffers.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[in] sgp       pointer to an array of @p n segments, the size of
+ *                      each segment cannot be zero
+ * @param[in] n         number of buffers to be posted, the value 0 is
+ *                      reserved
+ *
+ * @api
+ */
+void obqPostFullBuffers(output_buffers_queue_t *obqp,
+                        const bqsegment_t *sgp, size_t n) {
+
+  osalSysLock();
+  obqPostFullBuffersS(obqp, sgp, n);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Posts a series of filled buffers to the queue.
+ * @details The segments are those returned by @p obqGetEmptyBuffersTimeoutS()
+ *          with the @p size fields updated to the amount of data written
+ *          in each segment.
+ * @note    The object callback is called once after posting all the
+ *          buffers.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[in] sgp       pointer to an array of @p n segments, the size of
+ *                      each segment cannot be zero
+ * @param[in] n         number of buffers to be posted, the value 0 is
+ *                      reserved
+ *
+ * @sclass
+ */
+void obqPostFullBuffersS(output_buffers_queue_t *obqp,
+                         const bqsegment_t *sgp, size_t n) {
+  size_t i;
+
+  osalDbgCheckClassS();
+  osalDbgCheck((sgp != NULL) && (n > 0U) && (n <= obqp->bn));
+  osalDbgAssert(n <= bqSpaceI(obqp), "not enough empty buffers");
+
+  for (i = 0U; i < n; i++) {
+    /* Used size of the buffer, the segment could start after the buffer
+       beginning if the buffer was partially written.*/
+    size_t size = ((size_t)sgp[i].buf + sgp[i].size) -
+                  ((size_t)obqp->bwrptr + sizeof (size_t));
+
+    osalDbgCheck((sgp[i].size > 0U) &&
+                 (size <= (obqp->bsize - sizeof (size_t))));
+
+    /* Writing size field in the buffer.*/
+    *((size_t *)obqp->bwrptr) = size;
+
+    /* Posting the buffer in the queue.*/
+    obqp->bcounter--;
+    obqp->bwrptr += obqp->bsize;
+    if (obqp->bwrptr >= obqp->btop) {
+      obqp->bwrptr = obqp->buffers;
+    }
+  }
+
+  /* No "current" buffer.*/
+  obqp->ptr = NULL;
+
+  /* Notifying the buffers insertion.*/
+  if (obqp->notify != NULL) {
+    obqp->notify(obqp);
+  }
+}
+
 /**
  * @brief   Output queue write with timeout.
  * @details This function writes a byte value to an output queue. If
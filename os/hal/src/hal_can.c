@@ -313,6 +313,93 @@ msg_t canReceiveTimeout(CANDriver *canp,
   return MSG_OK;
 }
 
+/**
+ * @brief   Can frames batch receive.
+ * @details The function waits until at least a frame is received then
+ *          fetches all the frames available, up to @p n, without waiting
+ *          further.
+ * @note    Trying to receive while in sleep mode simply enqueues the thread.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] mailbox   mailbox number, @p CAN_ANY_MAILBOX for any mailbox
+ * @param[out] crfp     pointer to the array where the CAN frames are copied
+ * @param[in] n         maximum number of frames to be received
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout (useful in an
+ *                        event driven scenario where a thread never blocks
+ *                        for I/O).
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of frames received, zero in case of
+ *                      timeout or if the driver has been stopped while
+ *                      waiting.
+ *
+ * @api
+ */
+size_t canReceiveBatchTimeout(CANDriver *canp,
+                              canmbx_t mailbox,
+                              CANRxFrame *crfp,
+                              size_t n,
+                              sysinterval_t timeout) {
+  size_t i;
+
+  osalDbgCheck((canp != NULL) && (crfp != NULL) && (n > 0U) &&
+               (mailbox <= (canmbx_t)CAN_RX_MAILBOXES));
+
+  osalSysLock();
+  osalDbgAssert((canp->state == CAN_READY) || (canp->state == CAN_SLEEP),
+                "invalid state");
+
+  /*lint -save -e9007 [13.5] Right side is supposed to be pure.*/
+  while ((canp->state == CAN_SLEEP) || !can_lld_is_rx_nonempty(canp, mailbox)) {
+  /*lint -restore*/
+    msg_t msg = osalThreadEnqueueTimeoutS(&canp->rxqueue, timeout);
+    if (msg != MSG_OK) {
+      osalSysUnlock();
+      return (size_t)0;
+    }
+  }
+
+  /* Draining the mailboxes within the same critical zone.*/
+  i = (size_t)0;
+  do {
+    can_lld_receive(canp, mailbox, &crfp[i]);
+    i++;
+  } while ((i < n) && can_lld_is_rx_nonempty(canp, mailbox));
+  osalSysUnlock();
+
+  return i;
+}
+
+#if (CAN_SUPPORTS_ID_FILTERS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Programs the identifier filters of a CAN driver.
+ * @details The filters are mapped on the hardware acceptance filters, frames
+ *          not matching any filter are discarded by the hardware. If no
+ *          filters are specified then all frames are accepted in the first
+ *          receive mailbox.
+ * @pre     The driver must be in the @p CAN_STOP state, the filters are
+ *          retained when the driver is started.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] fp        pointer to an array of @p CANIdFilter structures, can
+ *                      be @p NULL if @p n is zero
+ * @param[in] n         number of filters in the array
+ *
+ * @api
+ */
+void canSetIdFilters(CANDriver *canp, const CANIdFilter *fp, size_t n) {
+
+  osalDbgCheck((canp != NULL) && ((n == 0U) || (fp != NULL)));
+
+  osalSysLock();
+  osalDbgAssert(canp->state == CAN_STOP, "invalid state");
+  can_lld_set_id_filters(canp, fp, n);
+  osalSysUnlock();
+}
+#endif /* CAN_SUPPORTS_ID_FILTERS == TRUE */
+
 #if (CAN_USE_SLEEP_MODE == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Enters the sleep mode.
@@ -22,6 +22,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 
 #if (HAL_USE_CRY == TRUE) || defined(__DOXYGEN__)
@@ -42,6 +44,27 @@
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Advances the 32 bits counter of an AES-CTR counter block.
+ *
+ * @param[in,out] iv            counter block, the counter is stored big
+ *                              endian in the last four bytes
+ * @param[in] n                 number of blocks
+ *
+ * @notapi
+ */
+static void cry_ctr_advance(uint8_t *iv, size_t n) {
+  uint32_t ctr;
+
+  ctr = ((uint32_t)iv[12] << 24) | ((uint32_t)iv[13] << 16) |
+        ((uint32_t)iv[14] << 8)  | (uint32_t)iv[15];
+  ctr += (uint32_t)n;
+  iv[12] = (uint8_t)(ctr >> 24);
+  iv[13] = (uint8_t)(ctr >> 16);
+  iv[14] = (uint8_t)(ctr >> 8);
+  iv[15] = (uint8_t)ctr;
+}
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -1465,6 +1488,212 @@ cryerror_t crySHA512Final(CRYDriver *cryp, SHA512Context *sha512ctxp,
 #endif
 }
 
+/**
+ * @brief   Initializes an AES-CTR streaming context.
+ * @note    The context uses @p cryEncryptAES_CTR() for whole blocks so
+ *          drivers transferring data using DMA process each update in a
+ *          single operation.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] ctrctxp          pointer to an AES-CTR context to be
+ *                              initialized
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key, other values are keys stored
+ *                              in an unspecified way
+ * @param[in] iv                128 bits input vector + counter, it contains
+ *                              a 96 bits IV and a 32 bits counter
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @api
+ */
+cryerror_t cryAESCTRInit(CRYDriver *cryp,
+                         AESCTRContext *ctrctxp,
+                         crykey_t key_id,
+                         const uint8_t *iv) {
+
+  osalDbgCheck((cryp != NULL) && (ctrctxp != NULL) && (iv != NULL));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+  ctrctxp->key_id = key_id;
+  memcpy(ctrctxp->iv, iv, sizeof ctrctxp->iv);
+  ctrctxp->used   = sizeof ctrctxp->stream;
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   AES-CTR streaming encryption or decryption.
+ * @details Data of any size can be processed, the keystream of a trailing
+ *          partial block is kept in the context for the next call.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] ctrctxp       pointer to an AES-CTR context
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input text
+ * @param[out] out              buffer for the output text
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ *
+ * @api
+ */
+cryerror_t cryAESCTRUpdate(CRYDriver *cryp,
+                           AESCTRContext *ctrctxp,
+                           size_t size,
+                           const uint8_t *in,
+                           uint8_t *out) {
+  static const uint8_t zero[16] = {0};
+  cryerror_t err;
+  size_t n;
+
+  osalDbgCheck((cryp != NULL) && (ctrctxp != NULL) &&
+               (in != NULL) && (out != NULL));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+  /* Using the keystream left by the previous call.*/
+  while ((size > 0U) && (ctrctxp->used < sizeof ctrctxp->stream)) {
+    *out++ = *in++ ^ ctrctxp->stream[ctrctxp->used++];
+    size--;
+  }
+
+  /* Whole blocks are processed by the driver in a single operation.*/
+  n = size & ~(size_t)15;
+  if (n > 0U) {
+    err = cryEncryptAES_CTR(cryp, ctrctxp->key_id, n, in, out, ctrctxp->iv);
+    if (err != CRY_NOERROR) {
+      return err;
+    }
+    cry_ctr_advance(ctrctxp->iv, n / 16U);
+    in   += n;
+    out  += n;
+    size -= n;
+  }
+
+  /* A trailing partial block requires the keystream of a whole block,
+     the unused part is kept for the next call.*/
+  if (size > 0U) {
+    err = cryEncryptAES_CTR(cryp, ctrctxp->key_id, sizeof zero, zero,
+                            ctrctxp->stream, ctrctxp->iv);
+    if (err != CRY_NOERROR) {
+      return err;
+    }
+    cry_ctr_advance(ctrctxp->iv, 1U);
+    ctrctxp->used = 0U;
+    while (size > 0U) {
+      *out++ = *in++ ^ ctrctxp->stream[ctrctxp->used++];
+      size--;
+    }
+  }
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Terminates an AES-CTR stream.
+ * @details The keystream and the counter are cleared from the context.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] ctrctxp       pointer to an AES-CTR context
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @api
+ */
+cryerror_t cryAESCTRFinal(CRYDriver *cryp, AESCTRContext *ctrctxp) {
+
+  osalDbgCheck((cryp != NULL) && (ctrctxp != NULL));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+  memset(ctrctxp, 0, sizeof (AESCTRContext));
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   AES-CTR streaming operation combined with SHA256 hashing.
+ * @details The data is processed in chunks of
+ *          @p HAL_CRY_PIPELINE_CHUNK_SIZE bytes, each chunk is encrypted or
+ *          decrypted and hashed before moving to the next one. The hash is
+ *          always computed on the cyphertext, the output when encrypting
+ *          and the input when decrypting.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] ctrctxp       pointer to an AES-CTR context
+ * @param[in,out] sha256ctxp    pointer to a SHA256 context
+ * @param[in] encrypt           @p true for encryption, @p false for
+ *                              decryption
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input text
+ * @param[out] out              buffer for the output text
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if one of the operations is unsupported on
+ *                              this device instance.
+ * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ *
+ * @api
+ */
+cryerror_t cryAESCTRSHA256Update(CRYDriver *cryp,
+                                 AESCTRContext *ctrctxp,
+                                 SHA256Context *sha256ctxp,
+                                 bool encrypt,
+                                 size_t size,
+                                 const uint8_t *in,
+                                 uint8_t *out) {
+  cryerror_t err;
+
+  osalDbgCheck((cryp != NULL) && (ctrctxp != NULL) && (sha256ctxp != NULL) &&
+               (in != NULL) && (out != NULL));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+  while (size > 0U) {
+    size_t n = size < (size_t)HAL_CRY_PIPELINE_CHUNK_SIZE ?
+               size : (size_t)HAL_CRY_PIPELINE_CHUNK_SIZE;
+
+    /* When decrypting the input is hashed first, the buffers could be
+       the same.*/
+    if (!encrypt) {
+      err = crySHA256Update(cryp, sha256ctxp, n, in);
+      if (err != CRY_NOERROR) {
+        return err;
+      }
+    }
+
+    err = cryAESCTRUpdate(cryp, ctrctxp, n, in, out);
+    if (err != CRY_NOERROR) {
+      return err;
+    }
+
+    if (encrypt) {
+      err = crySHA256Update(cryp, sha256ctxp, n, out);
+      if (err != CRY_NOERROR) {
+        return err;
+      }
+    }
+
+    in   += n;
+    out  += n;
+    size -= n;
+  }
+
+  return CRY_NOERROR;
+}
+
 /**
  * @brief   Hash initialization using HMAC_SHA256.
  * @note    Use of this algorithm is not recommended because proven weak.
@@ -22,6 +22,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 
 #if (HAL_USE_DAC == TRUE) || defined(__DOXYGEN__)
@@ -42,6 +44,60 @@
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (DAC_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Refills half of the samples buffer from the streaming queue.
+ * @details Samples missing because the queue is empty or because the
+ *          buffer is shorter than half of the samples buffer are replaced
+ *          by holding the last output frame.
+ *
+ * @param[in] dacp      pointer to the @p DACDriver object
+ * @param[in] buf       pointer to the half buffer to be refilled
+ *
+ * @notapi
+ */
+static void dac_stream_refill(DACDriver *dacp, dacsample_t *buf) {
+  size_t nch = (size_t)dacp->grpp->num_channels;
+  size_t half = ((size_t)dacp->depth / 2U) * nch;
+  const dacsample_t *last;
+  uint8_t *bp;
+  size_t i, n;
+
+  bp = obqGetFullBufferI(dacp->obqp, &n);
+  if (bp != NULL) {
+    i = n / sizeof (dacsample_t);
+    if (i > half) {
+      i = half;
+    }
+    memcpy((void *)buf, (const void *)bp, i * sizeof (dacsample_t));
+    obqReleaseEmptyBufferI(dacp->obqp);
+    i -= i % nch;
+  }
+  else {
+    dacp->underruns++;
+    i = 0U;
+  }
+
+  if (i < half) {
+    /* Previous frame, in circular order.*/
+    if (i > 0U) {
+      last = buf + i - nch;
+    }
+    else if (buf == dacp->samples) {
+      last = dacp->samples + (half * 2U) - nch;
+    }
+    else {
+      last = buf - nch;
+    }
+
+    while (i < half) {
+      buf[i] = last[i % nch];
+      i++;
+    }
+  }
+}
+#endif /* DAC_USE_STREAMING == TRUE */
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -75,6 +131,10 @@ void dacObjectInit(DACDriver *dacp) {
 #if DAC_USE_MUTUAL_EXCLUSION
   osalMutexObjectInit(&dacp->mutex);
 #endif
+#if DAC_USE_STREAMING == TRUE
+  dacp->obqp = NULL;
+  dacp->underruns = 0U;
+#endif
 #if defined(DAC_DRIVER_EXT_INIT_HOOK)
   DAC_DRIVER_EXT_INIT_HOOK(dacp);
 #endif
@@ -209,6 +269,9 @@ void dacStartConversionI(DACDriver *dacp,
   dacp->depth    = depth;
   dacp->grpp     = grpp;
   dacp->state    = DAC_ACTIVE;
+#if DAC_USE_STREAMING == TRUE
+  dacp->obqp     = NULL;
+#endif
   dac_lld_start_conversion(dacp);
 }
 
@@ -345,6 +408,96 @@ void dacReleaseBus(DACDriver *dacp) {
 }
 #endif /* DAC_USE_MUTUAL_EXCLUSION == TRUE */
 
+#if (DAC_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a circular conversion fed from a buffers queue.
+ * @details Each half of the samples buffer is refilled, after it has been
+ *          output, with the content of the next full buffer in the queue.
+ *          If no full buffer is available the last output frame is held
+ *          and the underruns counter incremented.
+ * @note    The samples buffer is primed with the queue content, if any,
+ *          before starting the conversion.
+ * @note    The group callback is still invoked if specified.
+ *
+ * @param[in] dacp      pointer to the @p DACDriver object
+ * @param[in] grpp      pointer to a @p DACConversionGroup object
+ * @param[out] samples  pointer to the samples buffer
+ * @param[in] depth     buffer depth (matrix rows number), it must be an
+ *                      even number
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ *
+ * @iclass
+ */
+void dacStartStreamI(DACDriver *dacp, const DACConversionGroup *grpp,
+                     dacsample_t *samples, size_t depth,
+                     output_buffers_queue_t *obqp) {
+  size_t half;
+
+  osalDbgCheckClassI();
+  osalDbgCheck((dacp != NULL) && (grpp != NULL) && (samples != NULL) &&
+               (obqp != NULL) && (depth >= 2U) && ((depth & 1U) == 0U));
+
+  /* Priming both halves of the buffer.*/
+  half = (depth / 2U) * (size_t)grpp->num_channels;
+  memset((void *)samples, 0, half * 2U * sizeof (dacsample_t));
+  dacp->samples = samples;
+  dacp->depth   = depth;
+  dacp->grpp    = grpp;
+  dacp->obqp    = obqp;
+  dac_stream_refill(dacp, samples);
+  dac_stream_refill(dacp, samples + half);
+
+  dacStartConversionI(dacp, grpp, samples, depth);
+  dacp->obqp      = obqp;
+  dacp->underruns = 0U;
+}
+
+/**
+ * @brief   Starts a circular conversion fed from a buffers queue.
+ * @details Each half of the samples buffer is refilled, after it has been
+ *          output, with the content of the next full buffer in the queue.
+ *          If no full buffer is available the last output frame is held
+ *          and the underruns counter incremented.
+ * @note    The samples buffer is primed with the queue content, if any,
+ *          before starting the conversion.
+ * @note    The group callback is still invoked if specified.
+ *
+ * @param[in] dacp      pointer to the @p DACDriver object
+ * @param[in] grpp      pointer to a @p DACConversionGroup object
+ * @param[out] samples  pointer to the samples buffer
+ * @param[in] depth     buffer depth (matrix rows number), it must be an
+ *                      even number
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ *
+ * @api
+ */
+void dacStartStream(DACDriver *dacp, const DACConversionGroup *grpp,
+                    dacsample_t *samples, size_t depth,
+                    output_buffers_queue_t *obqp) {
+
+  osalSysLock();
+  dacStartStreamI(dacp, grpp, samples, depth, obqp);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Refills an half buffer from the streaming queue.
+ * @note    This function is meant to be used in the low level drivers
+ *          implementation only, it is invoked by the ISR helper macros.
+ *
+ * @param[in] dacp      pointer to the @p DACDriver object
+ * @param[in] buf       pointer to the half buffer to be refilled
+ *
+ * @notapi
+ */
+void _dac_stream_fetch(DACDriver *dacp, dacsample_t *buf) {
+
+  osalSysLockFromISR();
+  dac_stream_refill(dacp, buf);
+  osalSysUnlockFromISR();
+}
+#endif /* DAC_USE_STREAMING == TRUE */
+
 #endif /* HAL_USE_DAC == TRUE */
 
 /** @} */
@@ -77,6 +77,11 @@ void i2cObjectInit(I2CDriver *i2cp) {
   osalMutexObjectInit(&i2cp->mutex);
 #endif
 
+#if I2C_USE_TRANSACTIONS == TRUE
+  i2cp->tcurr = NULL;
+  i2cp->tleft = (size_t)0;
+#endif
+
 #if defined(I2C_DRIVER_EXT_INIT_HOOK)
   I2C_DRIVER_EXT_INIT_HOOK(i2cp);
 #endif
@@ -282,6 +287,146 @@ void i2cReleaseBus(I2CDriver *i2cp) {
 }
 #endif /* I2C_USE_MUTUAL_EXCLUSION == TRUE */
 
+#if (I2C_USE_TRANSACTIONS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a sequence of transactions.
+ * @details The transactions are executed back to back, each one is started
+ *          from the completion interrupt of the previous one as soon as
+ *          the bus is free again.
+ * @post    At the end of each transaction its callback is invoked, the
+ *          driver returns to the ready state after the last one or after
+ *          the first failed one.
+ * @note    The transactions array must remain valid until the sequence
+ *          is complete.
+ * @note    There is no timeout on asynchronous transactions, use
+ *          @p i2cTransactionsTimeout() if the bus could be stuck.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] tp        pointer to an array of @p I2CTransaction structures
+ * @param[in] n         number of transactions in the array
+ *
+ * @iclass
+ */
+void i2cStartTransactionsI(I2CDriver *i2cp,
+                           const I2CTransaction *tp, size_t n) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((i2cp != NULL) && (tp != NULL) && (n > 0U));
+  osalDbgAssert(i2cp->state == I2C_READY, "not ready");
+
+  i2cp->errors = I2C_NO_ERROR;
+  i2cp->tcurr  = tp;
+  i2cp->tleft  = n;
+  i2c_lld_start_transaction(i2cp);
+}
+
+/**
+ * @brief   Starts a sequence of transactions.
+ * @details The transactions are executed back to back, each one is started
+ *          from the completion interrupt of the previous one as soon as
+ *          the bus is free again.
+ * @post    At the end of each transaction its callback is invoked, the
+ *          driver returns to the ready state after the last one or after
+ *          the first failed one.
+ * @note    The transactions array must remain valid until the sequence
+ *          is complete.
+ * @note    There is no timeout on asynchronous transactions, use
+ *          @p i2cTransactionsTimeout() if the bus could be stuck.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] tp        pointer to an array of @p I2CTransaction structures
+ * @param[in] n         number of transactions in the array
+ *
+ * @api
+ */
+void i2cStartTransactions(I2CDriver *i2cp,
+                          const I2CTransaction *tp, size_t n) {
+
+  osalSysLock();
+  i2cStartTransactionsI(i2cp, tp, n);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Performs a sequence of transactions.
+ * @details This synchronous function executes the transactions back to
+ *          back, the invoking thread is woken up once after the last one
+ *          or after the first failed one.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] tp        pointer to an array of @p I2CTransaction structures
+ * @param[in] n         number of transactions in the array
+ * @param[in] timeout   the number of ticks before the whole sequence
+ *                      timeouts, the following special values are allowed:
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ *
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred, the errors can
+ *                      be retrieved using @p i2cGetErrors().
+ * @retval MSG_TIMEOUT  if a timeout occurred before operation end.
+ *
+ * @api
+ */
+msg_t i2cTransactionsTimeout(I2CDriver *i2cp,
+                             const I2CTransaction *tp, size_t n,
+                             sysinterval_t timeout) {
+  msg_t rdymsg;
+
+  osalDbgCheck(timeout != TIME_IMMEDIATE);
+
+  osalSysLock();
+  i2cStartTransactionsI(i2cp, tp, n);
+  rdymsg = osalThreadSuspendTimeoutS(&i2cp->thread, timeout);
+  if (rdymsg == MSG_TIMEOUT) {
+    /* The sequence is abandoned, a late completion interrupt must not
+       start the next transaction.*/
+    i2cp->tcurr = NULL;
+    i2c_lld_abort_transaction(i2cp);
+    i2cp->state = I2C_LOCKED;
+  }
+  osalSysUnlock();
+  return rdymsg;
+}
+
+/**
+ * @brief   Common ISR code for transactions.
+ * @details The transaction callback is invoked then the next transaction
+ *          is started. After the last one, or on errors, the driver goes
+ *          back to the ready state and the waiting thread, if any, is
+ *          woken up.
+ * @note    This function is meant to be used in the low level drivers
+ *          implementation only, it is invoked by @p _i2c_wakeup_isr()
+ *          and @p _i2c_wakeup_error_isr().
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] msg       completion message of the current transaction
+ *
+ * @notapi
+ */
+void _i2c_isr_transactions_code(I2CDriver *i2cp, msg_t msg) {
+  const I2CTransaction *tp = i2cp->tcurr;
+
+  if (tp->end_cb != NULL) {
+    tp->end_cb(i2cp);
+  }
+
+  i2cp->tleft--;
+  if ((msg == MSG_OK) && (i2cp->tleft > (size_t)0)) {
+    i2cp->tcurr = tp + 1;
+    i2c_lld_start_transaction(i2cp);
+    return;
+  }
+
+  /* Sequence complete or aborted.*/
+  i2cp->tcurr = NULL;
+  i2cp->tleft = (size_t)0;
+  i2cp->state = I2C_READY;
+  _i2c_wakeup_msg_isr(i2cp, msg);
+}
+#endif /* I2C_USE_TRANSACTIONS == TRUE */
+
 #endif /* HAL_USE_I2C == TRUE */
 
 /** @} */
@@ -69,6 +69,12 @@ void i2sObjectInit(I2SDriver *i2sp) {
 
   i2sp->state  = I2S_STOP;
   i2sp->config = NULL;
+#if I2S_USE_STREAMING == TRUE
+  i2sp->ibqp      = NULL;
+  i2sp->obqp      = NULL;
+  i2sp->overruns  = 0U;
+  i2sp->underruns = 0U;
+#endif
 }
 
 /**
@@ -154,6 +160,129 @@ void i2sStopExchange(I2SDriver *i2sp) {
   osalSysUnlock();
 }
 
+#if (I2S_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a I2S streaming on buffers queues.
+ * @details Blocks are received directly into the input queue buffers and
+ *          transmitted directly from the output queue buffers, the block
+ *          size is the queues buffer size. In full duplex mode both queues
+ *          must have the same buffer size and blocks are exchanged in
+ *          lockstep.
+ * @note    The configuration buffers are used as one block sinks: the
+ *          receive buffer takes the blocks dropped on overrun, the
+ *          transmit buffer is the silence sent on underrun.
+ * @note    Underruns are counted since the start, the output queue should
+ *          be filled with two blocks before starting.
+ * @note    The data exchange is stopped using @p i2sStopExchange().
+ *
+ * @param[in] i2sp      pointer to the @p I2SDriver object
+ * @param[in] ibqp      pointer to the input buffers queue or @p NULL
+ * @param[in] obqp      pointer to the output buffers queue or @p NULL
+ *
+ * @api
+ */
+void i2sStartStreaming(I2SDriver *i2sp,
+                       input_buffers_queue_t *ibqp,
+                       output_buffers_queue_t *obqp) {
+
+  osalDbgCheck((i2sp != NULL) && ((ibqp != NULL) || (obqp != NULL)));
+  osalDbgCheck((ibqp == NULL) || (obqp == NULL) ||
+               (ibqp->bsize == obqp->bsize));
+
+  osalSysLock();
+  osalDbgAssert(i2sp->state == I2S_READY, "not ready");
+  osalDbgAssert((ibqp == NULL) || (i2sp->config->rx_buffer != NULL),
+                "no overrun sink");
+  osalDbgAssert((obqp == NULL) || (i2sp->config->tx_buffer != NULL),
+                "no underrun silence");
+  i2sStartStreamingI(i2sp, ibqp, obqp);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Common ISR code, received block in streaming mode.
+ * @details The received block is posted in the input queue, or counted
+ *          as an overrun if it was received in the sink.
+ * @note    This function is meant to be used in the low level drivers
+ *          implementation only, also for fetching the initial buffers
+ *          with @p done set to @p NULL.
+ *
+ * @param[in] i2sp      pointer to the @p I2SDriver object
+ * @param[in] done      block just received or @p NULL
+ * @param[in] next      block being received
+ * @return              The buffer for the block after @p next.
+ *
+ * @notapi
+ */
+uint8_t *_i2s_rx_block(I2SDriver *i2sp, uint8_t *done, uint8_t *next) {
+  input_buffers_queue_t *ibqp = i2sp->ibqp;
+  uint8_t *sink = (uint8_t *)i2sp->config->rx_buffer;
+  uint8_t *bp;
+
+  osalDbgCheckClassI();
+
+  if (done == sink) {
+    i2sp->overruns++;
+  }
+  else if (done != NULL) {
+    ibqPostFullBufferI(ibqp, ibqp->bsize - sizeof (size_t));
+  }
+
+  /* The queue buffer being received, if any, is the next empty one.*/
+  if (next == sink) {
+    bp = ibqGetEmptyBufferI(ibqp);
+  }
+  else {
+    bp = ibqGetNextEmptyBufferI(ibqp);
+  }
+
+  return bp != NULL ? bp : sink;
+}
+
+/**
+ * @brief   Common ISR code, transmitted block in streaming mode.
+ * @details The transmitted block is released in the output queue, or
+ *          counted as an underrun if it was the silence.
+ * @note    This function is meant to be used in the low level drivers
+ *          implementation only, also for fetching the initial buffers
+ *          with @p done set to @p NULL.
+ * @note    Output buffers are always sent as whole blocks.
+ *
+ * @param[in] i2sp      pointer to the @p I2SDriver object
+ * @param[in] done      block just transmitted or @p NULL
+ * @param[in] next      block being transmitted
+ * @return              The buffer for the block after @p next.
+ *
+ * @notapi
+ */
+const uint8_t *_i2s_tx_block(I2SDriver *i2sp, const uint8_t *done,
+                             const uint8_t *next) {
+  output_buffers_queue_t *obqp = i2sp->obqp;
+  const uint8_t *silence = (const uint8_t *)i2sp->config->tx_buffer;
+  const uint8_t *bp;
+  size_t n;
+
+  osalDbgCheckClassI();
+
+  if (done == silence) {
+    i2sp->underruns++;
+  }
+  else if (done != NULL) {
+    obqReleaseEmptyBufferI(obqp);
+  }
+
+  /* The queue buffer being transmitted, if any, is the next full one.*/
+  if (next == silence) {
+    bp = obqGetFullBufferI(obqp, &n);
+  }
+  else {
+    bp = obqGetNextFullBufferI(obqp, &n);
+  }
+
+  return bp != NULL ? bp : silence;
+}
+#endif /* I2S_USE_STREAMING == TRUE */
+
 #endif /* HAL_USE_I2S == TRUE */
 
 /** @} */
@@ -82,6 +82,9 @@ void macObjectInit(MACDriver *macp) {
 #if MAC_USE_EVENTS == TRUE
   osalEventObjectInit(&macp->rdevent);
 #endif
+#if (MAC_USE_EVENTS == TRUE) && (MAC_SUPPORTS_LINK_EVENTS == TRUE)
+  osalEventObjectInit(&macp->lsevent);
+#endif
 }
 
 /**
@@ -256,6 +259,207 @@ bool macPollLinkStatus(MACDriver *macp) {
   return mac_lld_poll_link_status(macp);
 }
 
+#if ((MAC_USE_ZERO_COPY == TRUE) && (MAC_SUPPORTS_BUFFERS_LENDING == TRUE)) ||\
+    defined(__DOXYGEN__)
+/**
+ * @brief   Transmits a frame directly from the caller buffers.
+ * @details The frame is composed by the specified buffers, each one takes a
+ *          transmit descriptor. If not enough descriptors are currently
+ *          available then the invoking thread is queued until they are
+ *          freed.
+ * @post    The buffers must remain valid until the release callback is
+ *          invoked for the frame, this happens when the application invokes
+ *          this function again or @p macReleaseTransmittedFrames().
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] tbp       pointer to an array of @p MACTransmitBuffer structures
+ * @param[in] n         number of buffers in the array, it cannot exceed
+ *                      @p MAC_MAX_TRANSMIT_BUFFERS
+ * @param[in] frame     frame identifier passed to the release callback
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       the frame has been queued for transmission.
+ * @retval MSG_TIMEOUT  the operation timed out, the frame has not been
+ *                      queued.
+ *
+ * @api
+ */
+msg_t macWaitTransmitBuffers(MACDriver *macp,
+                             const MACTransmitBuffer *tbp, size_t n,
+                             void *frame, sysinterval_t timeout) {
+  msg_t msg;
+
+  osalDbgCheck((macp != NULL) && (tbp != NULL) &&
+               (n > 0U) && (n <= MAC_MAX_TRANSMIT_BUFFERS));
+  osalDbgAssert(macp->state == MAC_ACTIVE, "not active");
+
+  while (((msg = mac_lld_transmit_buffers(macp, tbp, n, frame)) != MSG_OK) &&
+         (timeout > (sysinterval_t)0)) {
+    osalSysLock();
+    msg = osalThreadEnqueueTimeoutS(&macp->tdqueue, timeout);
+    if (msg == MSG_TIMEOUT) {
+      osalSysUnlock();
+      break;
+    }
+    osalSysUnlock();
+  }
+  return msg;
+}
+#endif /* (MAC_USE_ZERO_COPY == TRUE) && (MAC_SUPPORTS_BUFFERS_LENDING == TRUE) */
+
+#if (MAC_SUPPORTS_TIMESTAMPS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Waits for the time stamp of a transmitted frame.
+ * @details Returns the time stamp requested using
+ *          @p macRequestTransmitTimestamp() for the last frame, if the
+ *          frame has not been sent yet then the invoking thread is queued
+ *          until a transmission is completed.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] tsp      pointer to a @p mac_timestamp_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       the time stamp has been returned.
+ * @retval MSG_TIMEOUT  the operation timed out.
+ * @retval MSG_RESET    no time stamp has been requested or the frame has
+ *                      not been time stamped.
+ *
+ * @api
+ */
+msg_t macWaitTransmitTimestamp(MACDriver *macp, mac_timestamp_t *tsp,
+                               sysinterval_t timeout) {
+  msg_t msg;
+
+  osalDbgCheck((macp != NULL) && (tsp != NULL));
+  osalDbgAssert(macp->state == MAC_ACTIVE, "not active");
+
+  msg = mac_lld_get_transmit_timestamp(macp, tsp);
+  while ((msg == MSG_TIMEOUT) && (timeout > (sysinterval_t)0)) {
+    osalSysLock();
+    msg = osalThreadEnqueueTimeoutS(&macp->tdqueue, timeout);
+    osalSysUnlock();
+    if (msg == MSG_TIMEOUT) {
+      break;
+    }
+    msg = mac_lld_get_transmit_timestamp(macp, tsp);
+  }
+  return msg;
+}
+#endif /* MAC_SUPPORTS_TIMESTAMPS == TRUE */
+
+#if (MAC_SUPPORTS_FILTERS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Sets the frame filter mode.
+ * @details The station address, the filter addresses and broadcast frames
+ *          are received by default, the mode flags extend or restrict the
+ *          set of received frames.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] mode      mode flags, a combination of:
+ *                      - @a MAC_FILTER_PROMISCUOUS all frames are received.
+ *                      - @a MAC_FILTER_ALL_MULTICAST all multicast frames
+ *                        are received.
+ *                      - @a MAC_FILTER_NO_BROADCAST broadcast frames are
+ *                        discarded.
+ *                      .
+ *
+ * @api
+ */
+void macSetFilterMode(MACDriver *macp, uint32_t mode) {
+
+  osalDbgCheck(macp != NULL);
+
+  osalSysLock();
+  osalDbgAssert(macp->state == MAC_ACTIVE, "not active");
+  mac_lld_set_filter_mode(macp, mode);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Adds an address to the receive filter.
+ * @details Unicast addresses require an exact match filter, multicast
+ *          addresses fall back to the hash filter when the exact match
+ *          filters are exhausted. Addresses are reference counted, an
+ *          address added several times must be removed the same number
+ *          of times.
+ * @note    Hash filtered multicast addresses are imperfect, frames for
+ *          other addresses sharing the same hash are also received.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] addr      pointer to a six bytes buffer containing the MAC
+ *                      address
+ * @return              The operation status.
+ * @retval MSG_OK       if the address has been added.
+ * @retval MSG_RESET    if there are no filters available for the address.
+ *
+ * @api
+ */
+msg_t macAddFilterAddress(MACDriver *macp, const uint8_t *addr) {
+  msg_t msg;
+
+  osalDbgCheck((macp != NULL) && (addr != NULL));
+
+  osalSysLock();
+  osalDbgAssert(macp->state == MAC_ACTIVE, "not active");
+  msg = mac_lld_add_filter_address(macp, addr);
+  osalSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Removes an address from the receive filter.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] addr      pointer to a six bytes buffer containing the MAC
+ *                      address
+ * @return              The operation status.
+ * @retval MSG_OK       if the address has been removed.
+ * @retval MSG_RESET    if the address was not in the filter.
+ *
+ * @api
+ */
+msg_t macRemoveFilterAddress(MACDriver *macp, const uint8_t *addr) {
+  msg_t msg;
+
+  osalDbgCheck((macp != NULL) && (addr != NULL));
+
+  osalSysLock();
+  osalDbgAssert(macp->state == MAC_ACTIVE, "not active");
+  msg = mac_lld_remove_filter_address(macp, addr);
+  osalSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Sets the VLAN filter.
+ * @details Tagged frames with a different VLAN identifier are discarded.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] vid       VLAN identifier, zero disables the filter
+ *
+ * @api
+ */
+void macSetVLANFilter(MACDriver *macp, uint16_t vid) {
+
+  osalDbgCheck((macp != NULL) && (vid <= 4095U));
+
+  osalSysLock();
+  osalDbgAssert(macp->state == MAC_ACTIVE, "not active");
+  mac_lld_set_vlan_filter(macp, vid);
+  osalSysUnlock();
+}
+#endif /* MAC_SUPPORTS_FILTERS == TRUE */
+
 #endif /* HAL_USE_MAC == TRUE */
 
 /** @} */
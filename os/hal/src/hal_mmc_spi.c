@@ -163,19 +163,21 @@ static uint8_t crc7(uint8_t crc, const uint8_t *buffer, size_t len) {
  * @notapi
  */
 static void wait(MMCDriver *mmcp) {
-  int i;
-  uint8_t buf[4];
+  unsigned i;
+  uint8_t buf[MMC_SCAN_SIZE];
 
-  for (i = 0; i < 16; i++) {
-    spiReceive(mmcp->config->spip, 1, buf);
-    if (buf[0] == 0xFFU) {
+  /* The bus is sampled in chunks, the card keeps the line high once the
+     busy condition is released so only the last byte is checked.*/
+  for (i = 0U; i < MMC_WAIT_BUSY; i++) {
+    spiReceive(mmcp->config->spip, MMC_SCAN_SIZE, buf);
+    if (buf[MMC_SCAN_SIZE - 1U] == 0xFFU) {
       return;
     }
   }
   /* Looks like it is a long wait.*/
   while (true) {
-    spiReceive(mmcp->config->spip, 1, buf);
-    if (buf[0] == 0xFFU) {
+    spiReceive(mmcp->config->spip, MMC_SCAN_SIZE, buf);
+    if (buf[MMC_SCAN_SIZE - 1U] == 0xFFU) {
       break;
     }
 #if MMC_NICE_WAITING == TRUE
@@ -185,6 +187,42 @@ static void wait(MMCDriver *mmcp) {
   }
 }
 
+/**
+ * @brief   Receives a data block.
+ * @details The bus is scanned in chunks for the start token, the bytes
+ *          following the token in the last chunk are the beginning of the
+ *          block, the remaining part is received directly into the buffer.
+ *
+ * @param[in] mmcp      pointer to the @p MMCDriver object
+ * @param[out] buffer   pointer to the block buffer
+ * @param[in] n         size of the block, it must be greater than
+ *                      @p MMC_SCAN_SIZE
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  the operation succeeded.
+ * @retval HAL_FAILED   the start token has not been received.
+ *
+ * @notapi
+ */
+static bool recv_block(MMCDriver *mmcp, uint8_t *buffer, size_t n) {
+  unsigned i, j;
+
+  for (i = 0U; i < MMC_WAIT_DATA / MMC_SCAN_SIZE; i++) {
+    spiReceive(mmcp->config->spip, MMC_SCAN_SIZE, buffer);
+    for (j = 0U; j < MMC_SCAN_SIZE; j++) {
+      if (buffer[j] == 0xFEU) {
+        size_t m = MMC_SCAN_SIZE - 1U - j;
+
+        memmove(buffer, &buffer[j + 1U], m);
+        spiReceive(mmcp->config->spip, n - m, &buffer[m]);
+        /* CRC ignored. */
+        spiIgnore(mmcp->config->spip, 2);
+        return HAL_SUCCESS;
+      }
+    }
+  }
+  return HAL_FAILED;
+}
+
 /**
  * @brief   Sends a command header.
  *
@@ -311,7 +349,6 @@ static uint8_t send_command_R3(MMCDriver *mmcp, uint8_t cmd, uint32_t arg,
  * @notapi
  */
 static bool read_CxD(MMCDriver *mmcp, uint8_t cmd, uint32_t cxd[4]) {
-  unsigned i;
   uint8_t *bp, buf[16];
 
   spiSelect(mmcp->config->spip);
@@ -322,25 +359,20 @@ static bool read_CxD(MMCDriver *mmcp, uint8_t cmd, uint32_t cxd[4]) {
   }
 
   /* Wait for data availability.*/
-  for (i = 0U; i < MMC_WAIT_DATA; i++) {
-    spiReceive(mmcp->config->spip, 1, buf);
-    if (buf[0] == 0xFEU) {
-      uint32_t *wp;
-
-      spiReceive(mmcp->config->spip, 16, buf);
-      bp = buf;
-      for (wp = &cxd[3]; wp >= cxd; wp--) {
-        *wp = ((uint32_t)bp[0] << 24U) | ((uint32_t)bp[1] << 16U) |
-              ((uint32_t)bp[2] << 8U)  | (uint32_t)bp[3];
-        bp += 4;
-      }
+  if (recv_block(mmcp, buf, sizeof buf) == HAL_SUCCESS) {
+    uint32_t *wp;
+
+    bp = buf;
+    for (wp = &cxd[3]; wp >= cxd; wp--) {
+      *wp = ((uint32_t)bp[0] << 24U) | ((uint32_t)bp[1] << 16U) |
+            ((uint32_t)bp[2] << 8U)  | (uint32_t)bp[3];
+      bp += 4;
+    }
 
-      /* CRC ignored then end of transaction. */
-      spiIgnore(mmcp->config->spip, 2);
-      spiUnselect(mmcp->config->spip);
+    /* End of transaction. */
+    spiUnselect(mmcp->config->spip);
 
-      return HAL_SUCCESS;
-    }
+    return HAL_SUCCESS;
   }
   return HAL_FAILED;
 }
@@ -353,19 +385,9 @@ static bool read_CxD(MMCDriver *mmcp, uint8_t cmd, uint32_t cxd[4]) {
  * @notapi
  */
 static void sync(MMCDriver *mmcp) {
-  uint8_t buf[1];
 
   spiSelect(mmcp->config->spip);
-  while (true) {
-    spiReceive(mmcp->config->spip, 1, buf);
-    if (buf[0] == 0xFFU) {
-      break;
-    }
-#if MMC_NICE_WAITING == TRUE
-    /* Trying to be nice with the other threads.*/
-    osalThreadSleepMilliseconds(1);
-#endif
-  }
+  wait(mmcp);
   spiUnselect(mmcp->config->spip);
 }
 
@@ -650,7 +672,6 @@ bool mmcStartSequentialRead(MMCDriver *mmcp, uint32_t startblk) {
  * @api
  */
 bool mmcSequentialRead(MMCDriver *mmcp, uint8_t *buffer) {
-  unsigned i;
 
   osalDbgCheck((mmcp != NULL) && (buffer != NULL));
 
@@ -658,14 +679,8 @@ bool mmcSequentialRead(MMCDriver *mmcp, uint8_t *buffer) {
     return HAL_FAILED;
   }
 
-  for (i = 0; i < MMC_WAIT_DATA; i++) {
-    spiReceive(mmcp->config->spip, 1, buffer);
-    if (buffer[0] == 0xFEU) {
-      spiReceive(mmcp->config->spip, MMCSD_BLOCK_SIZE, buffer);
-      /* CRC ignored. */
-      spiIgnore(mmcp->config->spip, 2);
-      return HAL_SUCCESS;
-    }
+  if (recv_block(mmcp, buffer, MMCSD_BLOCK_SIZE) == HAL_SUCCESS) {
+    return HAL_SUCCESS;
   }
   /* Timeout.*/
   spiUnselect(mmcp->config->spip);
@@ -767,12 +782,14 @@ bool mmcSequentialWrite(MMCDriver *mmcp, const uint8_t *buffer) {
     return HAL_FAILED;
   }
 
+  /* The programming of the previous block is awaited here, the caller
+     can prepare the next block while the card is busy.*/
+  wait(mmcp);
   spiSend(mmcp->config->spip, sizeof(start), start);    /* Data prologue.   */
   spiSend(mmcp->config->spip, MMCSD_BLOCK_SIZE, buffer);/* Data.            */
   spiIgnore(mmcp->config->spip, 2);                     /* CRC ignored.     */
   spiReceive(mmcp->config->spip, 1, b);
   if ((b[0] & 0x1FU) == 0x05U) {
-    wait(mmcp);
     return HAL_SUCCESS;
   }
 
@@ -803,6 +820,7 @@ bool mmcStopSequentialWrite(MMCDriver *mmcp) {
     return HAL_FAILED;
   }
 
+  wait(mmcp);
   spiSend(mmcp->config->spip, sizeof(stop), stop);
   spiUnselect(mmcp->config->spip);
 
@@ -863,6 +881,7 @@ bool mmcGetInfo(MMCDriver *mmcp, BlockDeviceInfo *bdip) {
 
   bdip->blk_num  = mmcp->capacity;
   bdip->blk_size = MMCSD_BLOCK_SIZE;
+  bdip->bus_rate = 0U;
 
   return HAL_SUCCESS;
 }
@@ -38,6 +38,13 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
+#if (PAL_USE_EVENT_GROUPS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   List of the attached events groups.
+ */
+static paleventgroup_t *pal_event_groups;
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -252,6 +259,186 @@ msg_t palWaitLineTimeout(ioline_t line, sysinterval_t timeout) {
 }
 #endif /* PAL_USE_WAIT == TRUE */
 
+#if (PAL_USE_EVENT_GROUPS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes an events group object.
+ * @note    The events on the single lines must still be enabled using
+ *          @p palEnablePadEvent() or @p palEnableLineEvent().
+ *
+ * @param[out] gp       pointer to the @p paleventgroup_t object
+ * @param[in] mask      mask of the events channels belonging to the group
+ * @param[in] cb        group callback or @p NULL
+ * @param[in] arg       callback argument
+ *
+ * @init
+ */
+void palEventGroupObjectInit(paleventgroup_t *gp, ioportmask_t mask,
+                             palgroupcallback_t cb, void *arg) {
+
+  osalDbgCheck((gp != NULL) && (mask != 0U));
+
+  gp->next      = NULL;
+  gp->mask      = mask;
+  gp->events    = 0U;
+  gp->timestamp = (systime_t)0;
+  gp->cb        = cb;
+  gp->arg       = arg;
+#if PAL_USE_WAIT == TRUE
+  osalThreadQueueObjectInit(&gp->threads);
+#endif
+}
+
+/**
+ * @brief   Attaches an events group.
+ * @details After attaching, the group is notified once per interrupt with
+ *          the mask of its lines that triggered.
+ *
+ * @param[in] gp        pointer to the @p paleventgroup_t object
+ *
+ * @iclass
+ */
+void palAttachEventGroupI(paleventgroup_t *gp) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck(gp != NULL);
+
+  gp->events = 0U;
+  gp->next = pal_event_groups;
+  pal_event_groups = gp;
+}
+
+/**
+ * @brief   Detaches an events group.
+ * @details Threads waiting on the group are released with @p MSG_RESET.
+ *
+ * @param[in] gp        pointer to the @p paleventgroup_t object
+ *
+ * @iclass
+ */
+void palDetachEventGroupI(paleventgroup_t *gp) {
+  paleventgroup_t **gpp;
+
+  osalDbgCheckClassI();
+  osalDbgCheck(gp != NULL);
+
+  for (gpp = &pal_event_groups; *gpp != NULL; gpp = &(*gpp)->next) {
+    if (*gpp == gp) {
+      *gpp = gp->next;
+      break;
+    }
+  }
+  gp->next = NULL;
+#if PAL_USE_WAIT == TRUE
+  osalThreadDequeueAllI(&gp->threads, MSG_RESET);
+#endif
+}
+
+#if (PAL_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Waits for events on a group.
+ * @details If events have been accumulated since the previous call then the
+ *          function returns immediately, else it waits for the next
+ *          interrupt involving the group lines.
+ *
+ * @param[in] gp        pointer to the @p paleventgroup_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The mask of the lines that triggered, the mask is
+ *                      cleared on return. The time of the last triggering
+ *                      interrupt is available in the @p timestamp field.
+ * @retval 0            if a timeout occurred or the group has been detached.
+ *
+ * @sclass
+ */
+ioportmask_t palWaitEventGroupTimeoutS(paleventgroup_t *gp,
+                                       sysinterval_t timeout) {
+  ioportmask_t events;
+
+  osalDbgCheckClassS();
+  osalDbgCheck(gp != NULL);
+
+  if (gp->events == 0U) {
+    if (osalThreadEnqueueTimeoutS(&gp->threads, timeout) != MSG_OK) {
+      return 0U;
+    }
+  }
+
+  events = gp->events;
+  gp->events = 0U;
+
+  return events;
+}
+
+/**
+ * @brief   Waits for events on a group.
+ *
+ * @param[in] gp        pointer to the @p paleventgroup_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The mask of the lines that triggered.
+ * @retval 0            if a timeout occurred or the group has been detached.
+ *
+ * @api
+ */
+ioportmask_t palWaitEventGroupTimeout(paleventgroup_t *gp,
+                                      sysinterval_t timeout) {
+  ioportmask_t events;
+
+  osalSysLock();
+  events = palWaitEventGroupTimeoutS(gp, timeout);
+  osalSysUnlock();
+
+  return events;
+}
+#endif /* PAL_USE_WAIT == TRUE */
+
+/**
+ * @brief   Notifies the events groups.
+ * @note    This function is meant to be invoked from the port events ISRs
+ *          through the @p _pal_isr_group_code() macro.
+ *
+ * @param[in] events    mask of the triggered events channels
+ *
+ * @notapi
+ */
+void _pal_serve_event_groups(ioportmask_t events) {
+  paleventgroup_t *gp;
+  systime_t now;
+
+  osalSysLockFromISR();
+  now = osalOsGetSystemTimeX();
+  gp = pal_event_groups;
+  while (gp != NULL) {
+    ioportmask_t ev = events & gp->mask;
+    paleventgroup_t *next = gp->next;
+
+    if (ev != 0U) {
+      gp->events |= ev;
+      gp->timestamp = now;
+#if PAL_USE_WAIT == TRUE
+      osalThreadDequeueAllI(&gp->threads, MSG_OK);
+#endif
+      if (gp->cb != NULL) {
+        palgroupcallback_t cb = gp->cb;
+        void *arg = gp->arg;
+
+        osalSysUnlockFromISR();
+        cb(arg, ev, now);
+        osalSysLockFromISR();
+      }
+    }
+    gp = next;
+  }
+  osalSysUnlockFromISR();
+}
+#endif /* PAL_USE_EVENT_GROUPS == TRUE */
+
 #endif /* HAL_USE_PAL == TRUE */
 
 /** @} */
@@ -0,0 +1,197 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_pm.c
+ * @brief   PM Driver code.
+ *
+ * @addtogroup PM
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_PM == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   PM driver identifier.
+ */
+PMDriver PMD1;
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   PM Driver initialization.
+ * @note    This function is implicitly invoked by @p halInit(), there is
+ *          no need to explicitly initialize the driver.
+ *
+ * @init
+ */
+void pmInit(void) {
+  unsigned i;
+
+  for (i = 0U; i < PM_LLD_DEPTHS_NUM; i++) {
+    PMD1.locks[i]   = 0U;
+    PMD1.entries[i] = 0U;
+  }
+
+  pm_lld_init();
+}
+
+/**
+ * @brief   Forbids the sleep depths deeper than the specified one.
+ * @details Drivers invoke this function while an operation requiring
+ *          clocks is in progress, DMA transfers for example. Locks are
+ *          counted and must be balanced by @p pmUnlockDepthI().
+ *
+ * @param[in] depth     the deepest allowed sleep depth
+ *
+ * @iclass
+ */
+void pmLockDepthI(pmdepth_t depth) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck(depth < PM_LLD_DEPTHS_NUM);
+
+  PMD1.locks[depth]++;
+}
+
+/**
+ * @brief   Forbids the sleep depths deeper than the specified one.
+ *
+ * @param[in] depth     the deepest allowed sleep depth
+ *
+ * @api
+ */
+void pmLockDepth(pmdepth_t depth) {
+
+  osalSysLock();
+  pmLockDepthI(depth);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Releases a lock taken using @p pmLockDepthI().
+ *
+ * @param[in] depth     the depth specified when taking the lock
+ *
+ * @iclass
+ */
+void pmUnlockDepthI(pmdepth_t depth) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck(depth < PM_LLD_DEPTHS_NUM);
+  osalDbgAssert(PMD1.locks[depth] > 0U, "not locked");
+
+  PMD1.locks[depth]--;
+}
+
+/**
+ * @brief   Releases a lock taken using @p pmLockDepth().
+ *
+ * @param[in] depth     the depth specified when taking the lock
+ *
+ * @api
+ */
+void pmUnlockDepth(pmdepth_t depth) {
+
+  osalSysLock();
+  pmUnlockDepthI(depth);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Returns the deepest sleep depth currently allowed.
+ *
+ * @return              The sleep depth.
+ *
+ * @iclass
+ */
+pmdepth_t pmGetMaxDepthI(void) {
+  pmdepth_t depth;
+
+  osalDbgCheckClassI();
+
+  for (depth = 0U; depth < PM_LLD_DEPTHS_NUM - 1U; depth++) {
+    if (PMD1.locks[depth] > 0U) {
+      break;
+    }
+  }
+
+  return depth;
+}
+
+/**
+ * @brief   Enters the deepest sleep depth compatible with the next timer
+ *          event and the current locks.
+ * @details A depth is selected only if its entry and exit latency, plus
+ *          @p PM_SLEEP_MARGIN_US, is shorter than the interval before the
+ *          next timer event. The system time is compensated by the low
+ *          level driver for the time spent with the system timer stopped.
+ * @note    This function is meant to be invoked from the idle thread using
+ *          @p CH_CFG_IDLE_LOOP_HOOK(), @p CORTEX_ENABLE_WFI_IDLE should be
+ *          disabled.
+ *
+ * @api
+ */
+void pmIdle(void) {
+  sysinterval_t interval;
+  pmdepth_t depth;
+
+  osalSysLock();
+
+  if (!osalOsGetTimersStateI(&interval)) {
+    interval = TIME_INFINITE;
+  }
+
+  depth = pmGetMaxDepthI();
+  while ((depth > PM_DEPTH_SLEEP) && (interval != TIME_INFINITE)) {
+    time_conv_t us = (time_conv_t)pm_lld_get_latency(depth) +
+                     (time_conv_t)PM_SLEEP_MARGIN_US;
+
+    if (us < (time_conv_t)TIME_I2US(interval)) {
+      break;
+    }
+    depth--;
+  }
+
+  PMD1.entries[depth]++;
+  pm_lld_enter(depth, interval);
+
+  osalSysUnlock();
+}
+
+#endif /* HAL_USE_PM == TRUE */
+
+/** @} */
@@ -43,6 +43,68 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+/**
+ * @brief   Minimum size for the word copy path.
+ */
+#define Q_WORD_COPY_THRESHOLD   16U
+
+/**
+ * @brief   Queue data copy.
+ * @details Blocks not smaller than @p Q_WORD_COPY_THRESHOLD and having
+ *          source and destination with the same word alignment are copied
+ *          one word at time with an unrolled loop, other blocks are copied
+ *          using @p memcpy().
+ *
+ * @param[out] dp       pointer to the destination
+ * @param[in] sp        pointer to the source
+ * @param[in] n         number of bytes to be copied
+ *
+ * @notapi
+ */
+static void q_copy(uint8_t *dp, const uint8_t *sp, size_t n) {
+  const size_t wmask = sizeof (uint32_t) - 1U;
+
+  if ((n < Q_WORD_COPY_THRESHOLD) ||
+      ((((size_t)dp ^ (size_t)sp) & wmask) != 0U)) {
+    memcpy((void *)dp, (const void *)sp, n);
+    return;
+  }
+
+  /* Leading bytes up to the word boundary.*/
+  while (((size_t)dp & wmask) != 0U) {
+    *dp++ = *sp++;
+    n--;
+  }
+
+  /* Unrolled words copy.*/
+  /*lint -save -e9087 -e927 [11.3] Alignment checked above.*/
+  while (n >= (4U * sizeof (uint32_t))) {
+    uint32_t *wdp = (uint32_t *)(void *)dp;
+    const uint32_t *wsp = (const uint32_t *)(const void *)sp;
+
+    wdp[0] = wsp[0];
+    wdp[1] = wsp[1];
+    wdp[2] = wsp[2];
+    wdp[3] = wsp[3];
+    dp += 4U * sizeof (uint32_t);
+    sp += 4U * sizeof (uint32_t);
+    n  -= 4U * sizeof (uint32_t);
+  }
+  while (n >= sizeof (uint32_t)) {
+    *(uint32_t *)(void *)dp = *(const uint32_t *)(const void *)sp;
+    dp += sizeof (uint32_t);
+    sp += sizeof (uint32_t);
+    n  -= sizeof (uint32_t);
+  }
+  /*lint -restore*/
+
+  /* Trailing bytes.*/
+  while (n > 0U) {
+    *dp++ = *sp++;
+    n--;
+  }
+}
+
 /**
  * @brief   Non-blocking input queue read.
  * @details The function reads data from an input queue into a buffer. The
@@ -72,18 +134,18 @@ static size_t iq_read(input_queue_t *iqp, uint8_t *bp, size_t n) {
   s1 = (size_t)(iqp->q_top - iqp->q_rdptr);
   /*lint -restore*/
   if (n < s1) {
-    memcpy((void *)bp, (void *)iqp->q_rdptr, n);
+    q_copy(bp, iqp->q_rdptr, n);
     iqp->q_rdptr += n;
   }
   else if (n > s1) {
-    memcpy((void *)bp, (void *)iqp->q_rdptr, s1);
+    q_copy(bp, iqp->q_rdptr, s1);
     bp += s1;
     s2 = n - s1;
-    memcpy((void *)bp, (void *)iqp->q_buffer, s2);
+    q_copy(bp, iqp->q_buffer, s2);
     iqp->q_rdptr = iqp->q_buffer + s2;
   }
   else { /* n == s1 */
-    memcpy((void *)bp, (void *)iqp->q_rdptr, n);
+    q_copy(bp, iqp->q_rdptr, n);
     iqp->q_rdptr = iqp->q_buffer;
   }
 
@@ -120,18 +182,18 @@ static size_t oq_write(output_queue_t *oqp, const uint8_t *bp, size_t n) {
   s1 = (size_t)(oqp->q_top - oqp->q_wrptr);
   /*lint -restore*/
   if (n < s1) {
-    memcpy((void *)oqp->q_wrptr, (const void *)bp, n);
+    q_copy(oqp->q_wrptr, bp, n);
     oqp->q_wrptr += n;
   }
   else if (n > s1) {
-    memcpy((void *)oqp->q_wrptr, (const void *)bp, s1);
+    q_copy(oqp->q_wrptr, bp, s1);
     bp += s1;
     s2 = n - s1;
-    memcpy((void *)oqp->q_buffer, (const void *)bp, s2);
+    q_copy(oqp->q_buffer, bp, s2);
     oqp->q_wrptr = oqp->q_buffer + s2;
   }
   else { /* n == s1 */
-    memcpy((void *)oqp->q_wrptr, (const void *)bp, n);
+    q_copy(oqp->q_wrptr, bp, n);
     oqp->q_wrptr = oqp->q_buffer;
   }
 
@@ -241,6 +303,57 @@ msg_t iqPutI(input_queue_t *iqp, uint8_t b) {
   return MSG_TIMEOUT;
 }
 
+/**
+ * @brief   Input queue block write.
+ * @details A block of data is written into the low end of an input queue.
+ *          The operation completes immediately, the data exceeding the
+ *          queue free space is discarded.
+ * @note    All the threads waiting on the queue are woken up, this function
+ *          is meant to be used by drivers receiving data in blocks, for
+ *          example using DMA.
+ *
+ * @param[in] iqp       pointer to an @p input_queue_t structure
+ * @param[in] bp        pointer to the data block
+ * @param[in] n         size of the data block, the value 0 is reserved
+ * @return              The number of bytes effectively written in the queue.
+ *
+ * @iclass
+ */
+size_t iqWriteBlockI(input_queue_t *iqp, const uint8_t *bp, size_t n) {
+  size_t s1;
+
+  osalDbgCheckClassI();
+  osalDbgCheck(n > 0U);
+
+  /* Number of bytes that can be written in a single atomic operation.*/
+  if (n > iqGetEmptyI(iqp)) {
+    n = iqGetEmptyI(iqp);
+    if (n == (size_t)0) {
+      return (size_t)0;
+    }
+  }
+
+  /* Number of bytes before buffer limit.*/
+  /*lint -save -e9033 [10.8] Checked to be safe.*/
+  s1 = (size_t)(iqp->q_top - iqp->q_wrptr);
+  /*lint -restore*/
+  if (n < s1) {
+    q_copy(iqp->q_wrptr, bp, n);
+    iqp->q_wrptr += n;
+  }
+  else {
+    q_copy(iqp->q_wrptr, bp, s1);
+    q_copy(iqp->q_buffer, bp + s1, n - s1);
+    iqp->q_wrptr = iqp->q_buffer + (n - s1);
+  }
+
+  iqp->q_counter += n;
+
+  osalThreadDequeueAllI(&iqp->q_waiting, MSG_OK);
+
+  return n;
+}
+
 /**
  * @brief   Input queue non-blocking read.
  * @details This function reads a byte value from an input queue. The
@@ -428,6 +541,103 @@ size_t iqReadTimeout(input_queue_t *iqp, uint8_t *bp,
   return max - n;
 }
 
+/**
+ * @brief   Input queue get read buffer with timeout.
+ * @details The function returns a pointer to the data in the queue buffer
+ *          without copying it, the returned area is the contiguous part of
+ *          the filled slots up to the buffer end. The data must be consumed
+ *          using @p iqReleaseReadBuffer().
+ * @note    The lower side only writes into empty slots so the returned
+ *          area is stable until released, the queue must not be reset
+ *          meanwhile.
+ *
+ * @param[in] iqp       pointer to an @p input_queue_t structure
+ * @param[out] np       pointer to a variable receiving the number of
+ *                      contiguous bytes available
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              A pointer to the available data.
+ * @retval NULL         if the specified time expired or the queue has been
+ *                      reset.
+ *
+ * @api
+ */
+const uint8_t *iqGetReadBufferTimeout(input_queue_t *iqp, size_t *np,
+                                      sysinterval_t timeout) {
+  const uint8_t *bp;
+  size_t n;
+
+  osalDbgCheck(np != NULL);
+
+  osalSysLock();
+
+  while (iqIsEmptyI(iqp)) {
+    msg_t msg = osalThreadEnqueueTimeoutS(&iqp->q_waiting, timeout);
+
+    /* Anything except MSG_OK causes the operation to stop.*/
+    if (msg != MSG_OK) {
+      osalSysUnlock();
+      *np = (size_t)0;
+      return NULL;
+    }
+  }
+
+  /* Filled slots before buffer limit.*/
+  /*lint -save -e9033 [10.8] Checked to be safe.*/
+  n = (size_t)(iqp->q_top - iqp->q_rdptr);
+  /*lint -restore*/
+  if (n > iqGetFullI(iqp)) {
+    n = iqGetFullI(iqp);
+  }
+  bp = iqp->q_rdptr;
+
+  osalSysUnlock();
+
+  *np = n;
+  return bp;
+}
+
+/**
+ * @brief   Input queue release read buffer.
+ * @details The function removes from the queue the data previously
+ *          obtained using @p iqGetReadBufferTimeout().
+ *
+ * @param[in] iqp       pointer to an @p input_queue_t structure
+ * @param[in] n         number of bytes consumed, it must not exceed the
+ *                      size returned by @p iqGetReadBufferTimeout()
+ *
+ * @api
+ */
+void iqReleaseReadBuffer(input_queue_t *iqp, size_t n) {
+
+  if (n == (size_t)0) {
+    return;
+  }
+
+  osalSysLock();
+
+  osalDbgAssert((n <= iqGetFullI(iqp)) &&
+                (n <= (size_t)(iqp->q_top - iqp->q_rdptr)),
+                "out of bounds");
+
+  iqp->q_rdptr += n;
+  if (iqp->q_rdptr >= iqp->q_top) {
+    iqp->q_rdptr = iqp->q_buffer;
+  }
+  iqp->q_counter -= n;
+
+  /* Inform the low side that the queue has at least one empty slot
+     available.*/
+  if (iqp->q_notify != NULL) {
+    iqp->q_notify(iqp);
+  }
+
+  osalSysUnlock();
+}
+
 /**
  * @brief   Initializes an output queue.
  * @details A Semaphore is internally initialized and works as a counter of
@@ -358,8 +358,49 @@ static bool sdc_detect_bus_clk(SDCDriver *sdcp, sdcbusclk_t *clk) {
   return HAL_SUCCESS;
 }
 
+/**
+ * @brief   Writes a byte of the MMC EXT_CSD.
+ * @details The function waits for the end of the busy phase then checks
+ *          the outcome of the switch operation.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] idx       EXT_CSD byte offset
+ * @param[in] value     value to be written
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @notapi
+ */
+static bool mmc_switch(SDCDriver *sdcp, uint32_t idx, uint32_t value) {
+  uint32_t resp[1];
+  uint32_t cmdarg = mmc_cmd6_construct(MMC_SWITCH_WRITE_BYTE, idx, value, 0);
+
+  if (sdc_lld_send_cmd_short_crc(sdcp, MMCSD_CMD_SWITCH, cmdarg, resp) ||
+      MMCSD_R1_ERROR(resp[0])) {
+    return HAL_FAILED;
+  }
+
+  /* The card signals busy until the operation is complete.*/
+  if (_sdc_wait_for_transfer_state(sdcp)) {
+    return HAL_FAILED;
+  }
+
+  /* Rejected switch operations are reported in the status.*/
+  if (sdc_lld_send_cmd_short_crc(sdcp, MMCSD_CMD_SEND_STATUS,
+                                 sdcp->rca, resp) ||
+      MMCSD_R1_ERROR(resp[0]) || ((resp[0] & MMCSD_R1_SWITCH_ERROR) != 0U)) {
+    return HAL_FAILED;
+  }
+
+  return HAL_SUCCESS;
+}
+
 /**
  * @brief   Reads supported bus clock and switch MMC to appropriate mode.
+ * @note    The HS200 timing requires 1.8V signaling and sampling point
+ *          tuning, the card is used with the high speed timing.
  *
  * @param[in] sdcp      pointer to the @p SDCDriver object
  * @param[out] clk      pointer to clock enum
@@ -371,8 +412,6 @@ static bool sdc_detect_bus_clk(SDCDriver *sdcp, sdcbusclk_t *clk) {
  * @notapi
  */
 static bool mmc_detect_bus_clk(SDCDriver *sdcp, sdcbusclk_t *clk) {
-  uint32_t cmdarg;
-  uint32_t resp[1];
   uint8_t *scratchpad = sdcp->config->scratchpad;
 
   /* Safe default.*/
@@ -383,9 +422,20 @@ static bool mmc_detect_bus_clk(SDCDriver *sdcp, sdcbusclk_t *clk) {
     return HAL_SUCCESS;
   }
 
-  cmdarg = mmc_cmd6_construct(MMC_SWITCH_WRITE_BYTE, 185, 1, 0);
-  if (!(sdc_lld_send_cmd_short_crc(sdcp, MMCSD_CMD_SWITCH, cmdarg, resp) ||
-                                   MMCSD_R1_ERROR(resp[0]))) {
+  /* The EXT_CSD exists starting from the specification version 4.*/
+  if (_mmcsd_get_slice(sdcp->csd, MMCSD_CSD_MMC_SPEC_VERS_SLICE) < 4U) {
+    return HAL_SUCCESS;
+  }
+
+  if (sdc_lld_read_special(sdcp, scratchpad, 512,
+                           MMCSD_CMD_SEND_EXT_CSD, 0)) {
+    return HAL_FAILED;
+  }
+
+  /* Switching to the high speed timing if supported by the card.*/
+  if (((scratchpad[MMCSD_EXT_CSD_CARD_TYPE] &
+        MMCSD_EXT_CSD_CARD_TYPE_HS_52) != 0U) &&
+      (mmc_switch(sdcp, MMCSD_EXT_CSD_HS_TIMING, 1U) == HAL_SUCCESS)) {
     *clk = SDC_CLK_50MHz;
   }
 
@@ -462,18 +512,17 @@ static bool sdc_set_bus_width(SDCDriver *sdcp) {
  * @notapi
  */
 static bool mmc_set_bus_width(SDCDriver *sdcp) {
-  uint32_t resp[1];
-  uint32_t cmdarg = mmc_cmd6_construct(MMC_SWITCH_WRITE_BYTE, 183, 0, 0);
+  uint32_t width = 0U;
 
   switch (sdcp->config->bus_width) {
   case SDC_MODE_1BIT:
     /* Nothing to do. Bus is already in 1bit mode.*/
     return HAL_SUCCESS;
   case SDC_MODE_4BIT:
-    cmdarg = mmc_cmd6_construct(MMC_SWITCH_WRITE_BYTE, 183, 1, 0);
+    width = 1U;
     break;
   case SDC_MODE_8BIT:
-    cmdarg = mmc_cmd6_construct(MMC_SWITCH_WRITE_BYTE, 183, 2, 0);
+    width = 2U;
     break;
   default:
     osalDbgAssert(false, "unexpected case");
@@ -481,13 +530,100 @@ static bool mmc_set_bus_width(SDCDriver *sdcp) {
   }
 
   sdc_lld_set_bus_mode(sdcp, sdcp->config->bus_width);
-  if (sdc_lld_send_cmd_short_crc(sdcp, MMCSD_CMD_SWITCH, cmdarg, resp) ||
-      MMCSD_R1_ERROR(resp[0])) {
+  return mmc_switch(sdcp, MMCSD_EXT_CSD_BUS_WIDTH, width);
+}
+
+#if (SDC_USE_ASYNC_TRANSFERS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Detects the support of pre-defined length transfers.
+ * @details The @p SDC_MODE_BLOCK_COUNT flag is set if the SCR register
+ *          reports the support of the SET_BLOCK_COUNT command.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ *
+ * @notapi
+ */
+static void sdc_detect_block_count(SDCDriver *sdcp) {
+  uint32_t scr[2];
+
+  if (sdc_lld_read_special_app(sdcp, (uint8_t *)scr, sizeof (scr),
+                               MMCSD_CMD_APP_SEND_SCR, 0) == HAL_SUCCESS) {
+    /* The SCR is big endian, CMD_SUPPORT is in bits 35..32 and bit 33
+       signals the CMD23 support.*/
+    if ((((uint8_t *)scr)[3] & 0x02U) != 0U) {
+      sdcp->cardmode |= SDC_MODE_BLOCK_COUNT;
+    }
+  }
+}
+
+/**
+ * @brief   Starts or queues an asynchronous transfer.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] rqp       pointer to the transfer request
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation started or queued.
+ * @retval HAL_FAILED   operation failed or queue full.
+ *
+ * @notapi
+ */
+static bool sdc_start_transfer(SDCDriver *sdcp, const SDCRequest *rqp) {
+
+  osalDbgCheck((rqp->buf != NULL) && (rqp->n > 0U));
+
+  if ((rqp->startblk + rqp->n - 1U) > sdcp->capacity) {
+    sdcp->errors |= SDC_OVERFLOW_ERROR;
+    return HAL_FAILED;
+  }
+
+  /* Without pre-defined length transfers the operation is performed
+     synchronously.*/
+  if ((sdcp->cardmode & SDC_MODE_BLOCK_COUNT) == 0U) {
+    bool result;
+
+    if (rqp->write) {
+      result = sdcWrite(sdcp, rqp->startblk, rqp->buf, rqp->n);
+    }
+    else {
+      result = sdcRead(sdcp, rqp->startblk, rqp->buf, rqp->n);
+    }
+    if (rqp->end_cb != NULL) {
+      rqp->end_cb(sdcp, result);
+    }
+    return result;
+  }
+
+  osalSysLock();
+  if (sdcp->state != BLK_READY) {
+    osalDbgAssert((sdcp->state == BLK_READING) ||
+                  (sdcp->state == BLK_WRITING), "invalid state");
+
+    /* A transfer is in progress, the request is queued.*/
+    if (sdcp->rqqueued) {
+      osalSysUnlock();
+      return HAL_FAILED;
+    }
+    sdcp->rqnext   = *rqp;
+    sdcp->rqqueued = true;
+    osalSysUnlock();
+    return HAL_SUCCESS;
+  }
+  sdcp->rqcurr   = *rqp;
+  sdcp->rqfailed = false;
+  sdcp->state    = rqp->write ? BLK_WRITING : BLK_READING;
+  osalSysUnlock();
+
+  /* The card could be still busy with a previous operation.*/
+  if (_sdc_wait_for_transfer_state(sdcp) ||
+      sdc_lld_start_transfer(sdcp, &sdcp->rqcurr)) {
+    sdcp->state = BLK_READY;
     return HAL_FAILED;
   }
 
   return HAL_SUCCESS;
 }
+#endif /* SDC_USE_ASYNC_TRANSFERS == TRUE */
 
 /**
  * @brief   Wait for the card to complete pending operations.
@@ -558,6 +694,11 @@ void sdcObjectInit(SDCDriver *sdcp) {
   sdcp->errors   = SDC_NO_ERROR;
   sdcp->config   = NULL;
   sdcp->capacity = 0;
+#if SDC_USE_ASYNC_TRANSFERS == TRUE
+  sdcp->rqqueued = false;
+  sdcp->rqfailed = false;
+  sdcp->rqthread = NULL;
+#endif
 }
 
 /**
@@ -682,6 +823,9 @@ bool sdcConnect(SDCDriver *sdcp) {
     goto failed;
   }
   sdc_lld_set_data_clk(sdcp, clk);
+  if (SDC_CLK_50MHz == clk) {
+    sdcp->cardmode |= SDC_MODE_HIGH_SPEED;
+  }
 
   /* Reads extended CSD if needed and possible.*/
   if (SDC_MODE_CARDTYPE_MMC == (sdcp->cardmode & SDC_MODE_CARDTYPE_MASK)) {
@@ -701,6 +845,21 @@ bool sdcConnect(SDCDriver *sdcp) {
 
       /* Capacity from the EXT_CSD.*/
       sdcp->capacity = _mmcsd_get_capacity_ext(ext_csd);
+
+#if SDC_MMC_USE_CACHE == TRUE
+      /* The volatile cache is enabled if present, it exists starting from
+         the EXT_CSD revision 6.*/
+      if ((ext_csd[MMCSD_EXT_CSD_REV] >= 6U) &&
+          ((ext_csd[MMCSD_EXT_CSD_CACHE_SIZE]      |
+            ext_csd[MMCSD_EXT_CSD_CACHE_SIZE + 1U] |
+            ext_csd[MMCSD_EXT_CSD_CACHE_SIZE + 2U] |
+            ext_csd[MMCSD_EXT_CSD_CACHE_SIZE + 3U]) != 0U)) {
+        if (HAL_FAILED == mmc_switch(sdcp, MMCSD_EXT_CSD_CACHE_CTRL, 1U)) {
+          goto failed;
+        }
+        sdcp->cardmode |= SDC_MODE_CACHE;
+      }
+#endif
     }
     else {
       /* Capacity from the normal CSD.*/
@@ -737,6 +896,18 @@ bool sdcConnect(SDCDriver *sdcp) {
     goto failed;
   }
 
+#if SDC_USE_ASYNC_TRANSFERS == TRUE
+  /* Checks if the card supports the transfers required by the
+     asynchronous API.*/
+  if ((sdcp->cardmode & SDC_MODE_CARDTYPE_MASK) != SDC_MODE_CARDTYPE_MMC) {
+    sdc_detect_block_count(sdcp);
+  }
+  else if (_mmcsd_get_slice(sdcp->csd, MMCSD_CSD_MMC_SPEC_VERS_SLICE) >= 3U) {
+    /* SET_BLOCK_COUNT is mandatory starting from MMC version 3.1.*/
+    sdcp->cardmode |= SDC_MODE_BLOCK_COUNT;
+  }
+#endif
+
   /* Initialization complete.*/
   sdcp->state = BLK_READY;
   return HAL_SUCCESS;
@@ -780,6 +951,16 @@ bool sdcDisconnect(SDCDriver *sdcp) {
     return HAL_FAILED;
   }
 
+#if SDC_MMC_USE_CACHE == TRUE
+  /* Cached data written back before the removal.*/
+  if (((sdcp->cardmode & SDC_MODE_CACHE) != 0U) &&
+      mmc_switch(sdcp, MMCSD_EXT_CSD_FLUSH_CACHE, 1U)) {
+    sdc_lld_stop_clk(sdcp);
+    sdcp->state = BLK_ACTIVE;
+    return HAL_FAILED;
+  }
+#endif
+
   /* Card clock stopped.*/
   sdc_lld_stop_clk(sdcp);
   sdcp->state = BLK_ACTIVE;
@@ -861,6 +1042,160 @@ bool sdcWrite(SDCDriver *sdcp, uint32_t startblk,
   return status;
 }
 
+#if (SDC_USE_ASYNC_TRANSFERS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts an asynchronous read of one or more blocks.
+ * @details If a transfer is in progress the read is queued and started
+ *          from the ISR when the current one ends.
+ * @note    Cards not supporting pre-defined length transfers are accessed
+ *          synchronously, in this case the callback is invoked before
+ *          the function returns.
+ * @note    The buffer must be word aligned and must not be accessed until
+ *          the callback is invoked.
+ * @note    This function cannot be invoked from the callback.
+ * @pre     The driver must be in the @p BLK_READY state or a transfer
+ *          started by this API must be in progress.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] startblk  first block to read
+ * @param[out] buf      pointer to the read buffer
+ * @param[in] n         number of blocks to read
+ * @param[in] end_cb    callback invoked at the transfer end, can be @p NULL
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation started or queued.
+ * @retval HAL_FAILED   operation failed or a transfer is already queued.
+ *
+ * @api
+ */
+bool sdcStartRead(SDCDriver *sdcp, uint32_t startblk,
+                  uint8_t *buf, uint32_t n, sdccallback_t end_cb) {
+  SDCRequest rq;
+
+  osalDbgCheck(sdcp != NULL);
+
+  rq.startblk = startblk;
+  rq.buf      = buf;
+  rq.n        = n;
+  rq.write    = false;
+  rq.end_cb   = end_cb;
+  return sdc_start_transfer(sdcp, &rq);
+}
+
+/**
+ * @brief   Starts an asynchronous write of one or more blocks.
+ * @details If a transfer is in progress the write is queued and started
+ *          from the ISR when the current one ends.
+ * @note    Cards not supporting pre-defined length transfers are accessed
+ *          synchronously, in this case the callback is invoked before
+ *          the function returns.
+ * @note    The buffer must be word aligned and must not be modified until
+ *          the callback is invoked.
+ * @note    This function cannot be invoked from the callback.
+ * @pre     The driver must be in the @p BLK_READY state or a transfer
+ *          started by this API must be in progress.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] startblk  first block to write
+ * @param[in] buf       pointer to the write buffer
+ * @param[in] n         number of blocks to write
+ * @param[in] end_cb    callback invoked at the transfer end, can be @p NULL
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation started or queued.
+ * @retval HAL_FAILED   operation failed or a transfer is already queued.
+ *
+ * @api
+ */
+bool sdcStartWrite(SDCDriver *sdcp, uint32_t startblk,
+                   const uint8_t *buf, uint32_t n, sdccallback_t end_cb) {
+  SDCRequest rq;
+
+  osalDbgCheck(sdcp != NULL);
+
+  rq.startblk = startblk;
+  rq.buf      = (uint8_t *)buf;
+  rq.n        = n;
+  rq.write    = true;
+  rq.end_cb   = end_cb;
+  return sdc_start_transfer(sdcp, &rq);
+}
+
+/**
+ * @brief   Waits for the end of the asynchronous transfers.
+ * @details The driver is in the @p BLK_READY state on exit.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  all the transfers succeeded.
+ * @retval HAL_FAILED   one or more transfers failed, the errors mask can
+ *                      be retrieved using @p sdcGetAndClearErrors().
+ *
+ * @api
+ */
+bool sdcWaitTransfers(SDCDriver *sdcp) {
+  bool result;
+
+  osalDbgCheck(sdcp != NULL);
+
+  osalSysLock();
+  if (sdcp->state != BLK_READY) {
+    (void) osalThreadSuspendS(&sdcp->rqthread);
+  }
+  result = sdcp->rqfailed;
+  sdcp->rqfailed = false;
+  osalSysUnlock();
+
+  return result;
+}
+
+/**
+ * @brief   Asynchronous transfer end code.
+ * @details The callback is invoked then the queued transfer, if any, is
+ *          started, else the waiting thread is resumed.
+ * @note    This function is meant to be invoked by the LLD ISR, outside
+ *          the critical zone.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] result    the transfer status
+ *
+ * @notapi
+ */
+void _sdc_isr_transfer_code(SDCDriver *sdcp, bool result) {
+
+  while (true) {
+    if (sdcp->rqcurr.end_cb != NULL) {
+      sdcp->rqcurr.end_cb(sdcp, result);
+    }
+
+    osalSysLockFromISR();
+    if (result == HAL_FAILED) {
+      sdcp->rqfailed = true;
+    }
+    if (!sdcp->rqqueued) {
+      sdcp->state = BLK_READY;
+      osalThreadResumeI(&sdcp->rqthread, MSG_OK);
+      osalSysUnlockFromISR();
+      return;
+    }
+    sdcp->rqcurr   = sdcp->rqnext;
+    sdcp->rqqueued = false;
+    sdcp->state    = sdcp->rqcurr.write ? BLK_WRITING : BLK_READING;
+    osalSysUnlockFromISR();
+
+    /* The card is back in transfer state at the end of a pre-defined
+       length transfer, the queued one can be started immediately. After
+       a failure it is failed without starting it.*/
+    if ((result == HAL_SUCCESS) &&
+        (sdc_lld_start_transfer(sdcp, &sdcp->rqcurr) == HAL_SUCCESS)) {
+      return;
+    }
+    result = HAL_FAILED;
+  }
+}
+#endif /* SDC_USE_ASYNC_TRANSFERS == TRUE */
+
 /**
  * @brief   Returns the errors mask associated to the previous operation.
  *
@@ -907,6 +1242,14 @@ bool sdcSync(SDCDriver *sdcp) {
 
   result = sdc_lld_sync(sdcp);
 
+#if SDC_MMC_USE_CACHE == TRUE
+  /* Cached data written back, the card could still be programming.*/
+  if ((result == HAL_SUCCESS) && ((sdcp->cardmode & SDC_MODE_CACHE) != 0U)) {
+    result = _sdc_wait_for_transfer_state(sdcp) ||
+             mmc_switch(sdcp, MMCSD_EXT_CSD_FLUSH_CACHE, 1U);
+  }
+#endif
+
   /* Synchronization operation finished.*/
   sdcp->state = BLK_READY;
   return result;
@@ -935,6 +1278,16 @@ bool sdcGetInfo(SDCDriver *sdcp, BlockDeviceInfo *bdip) {
   bdip->blk_num = sdcp->capacity;
   bdip->blk_size = MMCSD_BLOCK_SIZE;
 
+  /* Nominal rate of the negotiated bus mode.*/
+  bdip->bus_rate = (sdcp->cardmode & SDC_MODE_HIGH_SPEED) != 0U ?
+                   50000000U / 8U : 25000000U / 8U;
+  if (SDC_MODE_4BIT == sdcp->config->bus_width) {
+    bdip->bus_rate *= 4U;
+  }
+  else if (SDC_MODE_8BIT == sdcp->config->bus_width) {
+    bdip->bus_rate *= 8U;
+  }
+
   return HAL_SUCCESS;
 }
 
@@ -69,6 +69,17 @@ static msg_t _get(void *ip) {
   return iqGetTimeout(&((SerialDriver *)ip)->iqueue, TIME_INFINITE);
 }
 
+static const uint8_t *_getrbuf(void *ip, size_t *np) {
+
+  return iqGetReadBufferTimeout(&((SerialDriver *)ip)->iqueue, np,
+                                TIME_INFINITE);
+}
+
+static void _relrbuf(void *ip, size_t n) {
+
+  iqReleaseReadBuffer(&((SerialDriver *)ip)->iqueue, n);
+}
+
 static msg_t _putt(void *ip, uint8_t b, sysinterval_t timeout) {
 
   return oqPutTimeout(&((SerialDriver *)ip)->oqueue, b, timeout);
@@ -117,6 +128,7 @@ static msg_t _ctl(void *ip, unsigned int operation, void *arg) {
 static const struct SerialDriverVMT vmt = {
   (size_t)0,
   _write, _read, _put, _get,
+  streamDefaultWriteV, _getrbuf, _relrbuf,
   _putt, _gett, _writet, _readt,
   _ctl
 };
@@ -248,6 +260,32 @@ void sdIncomingDataI(SerialDriver *sdp, uint8_t b) {
     chnAddFlagsI(sdp, SD_QUEUE_FULL_ERROR);
 }
 
+/**
+ * @brief   Handles a block of incoming data.
+ * @details This function must be called from the input interrupt service
+ *          routine of drivers receiving data in blocks, for example using
+ *          DMA, in order to enqueue incoming data and generate the related
+ *          events.
+ * @note    The incoming data event is only generated when the input queue
+ *          becomes non-empty.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver structure
+ * @param[in] bp        pointer to the data block
+ * @param[in] n         size of the data block, the value 0 is reserved
+ *
+ * @iclass
+ */
+void sdIncomingDataBlockI(SerialDriver *sdp, const uint8_t *bp, size_t n) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((sdp != NULL) && (bp != NULL) && (n > 0U));
+
+  if (iqIsEmptyI(&sdp->iqueue))
+    chnAddFlagsI(sdp, CHN_INPUT_AVAILABLE);
+  if (iqWriteBlockI(&sdp->iqueue, bp, n) < n)
+    chnAddFlagsI(sdp, SD_QUEUE_FULL_ERROR);
+}
+
 /**
  * @brief   Handles outgoing data.
  * @details Must be called from the output interrupt service routine in order
@@ -61,7 +61,7 @@ static bool sdu_start_receive(SerialUSBDriver *sdup) {
   }
 
   /* Checking if there is already a transaction ongoing on the endpoint.*/
-  if (usbGetReceiveStatusI(sdup->config->usbp, sdup->config->bulk_in)) {
+  if (usbGetReceiveStatusI(sdup->config->usbp, sdup->config->bulk_out)) {
     return true;
   }
 
@@ -78,6 +78,53 @@ static bool sdu_start_receive(SerialUSBDriver *sdup) {
   return false;
 }
 
+/**
+ * @brief   Starts a transaction on the IN endpoint.
+ * @details The next full buffer is transmitted. A buffer multiple of the
+ *          endpoint packet size is sent by the LLD as a multi-packet
+ *          transfer. If the queue is empty and the previous transfer ended
+ *          with a full size packet then a zero length packet is sent in
+ *          order to terminate the transfer on the host side.
+ * @note    The endpoint must not be busy when this function is invoked.
+ *
+ * @param[in] sdup      pointer to a @p SerialUSBDriver object
+ * @param[in] zlp       enables the transmission of a zero length packet
+ * @return              The operation status.
+ * @retval false        if a transaction has been started.
+ * @retval true         if there was nothing to transmit.
+ *
+ * @notapi
+ */
+static bool sdu_start_transmit(SerialUSBDriver *sdup, bool zlp) {
+  USBDriver *usbp = sdup->config->usbp;
+  usbep_t ep = sdup->config->bulk_in;
+  uint8_t *buf;
+  size_t n;
+
+  /* Checking if there is a buffer ready for transmission.*/
+  buf = obqGetFullBufferI(&sdup->obqueue, &n);
+  if (buf != NULL) {
+    usbStartTransmitI(usbp, ep, buf, n);
+    return false;
+  }
+
+  if (zlp) {
+    size_t txsize = usbp->epc[ep]->in_state->txsize;
+
+    /* Transmit zero sized packet in case the last one has maximum allowed
+       size. Otherwise the recipient may expect more data coming soon and
+       not return buffered data to app. See section 5.8.3 Bulk Transfer
+       Packet Size Constraints of the USB Specification document.*/
+    if ((txsize > 0U) &&
+        ((txsize % (size_t)usbp->epc[ep]->in_maxsize) == 0U)) {
+      usbStartTransmitI(usbp, ep, usbp->setup, 0);
+      return false;
+    }
+  }
+
+  return true;
+}
+
 /*
  * Interface implementation.
  */
@@ -104,6 +151,76 @@ static msg_t _get(void *ip) {
   return ibqGetTimeout(&((SerialUSBDriver *)ip)->ibqueue, TIME_INFINITE);
 }
 
+static size_t _writev(void *ip, const stream_iovec_t *iov, size_t n) {
+  output_buffers_queue_t *obqp = &((SerialUSBDriver *)ip)->obqueue;
+  size_t total = (size_t)0;
+
+  /* The buffers are accumulated in the output queue, the data is sent
+     in full buffers when available, not one transaction per element.*/
+  while (n > (size_t)0) {
+    size_t done = (size_t)0;
+
+    if (iov->n > (size_t)0) {
+      done = obqWriteTimeout(obqp, iov->bp, iov->n, TIME_INFINITE);
+      total += done;
+    }
+    if (done < iov->n) {
+      break;
+    }
+    iov++;
+    n--;
+  }
+
+  return total;
+}
+
+static const uint8_t *_getrbuf(void *ip, size_t *np) {
+  input_buffers_queue_t *ibqp = &((SerialUSBDriver *)ip)->ibqueue;
+  const uint8_t *bp;
+
+  osalSysLock();
+
+  /* This condition indicates that a new buffer must be acquired.*/
+  if (ibqp->ptr == NULL) {
+    if (ibqGetFullBufferTimeoutS(ibqp, TIME_INFINITE) != MSG_OK) {
+      osalSysUnlock();
+      *np = (size_t)0;
+      return NULL;
+    }
+  }
+
+  /* The unread part of the current buffer is exposed in place.*/
+  bp  = ibqp->ptr;
+  *np = (size_t)(ibqp->top - ibqp->ptr);
+
+  osalSysUnlock();
+
+  return bp;
+}
+
+static void _relrbuf(void *ip, size_t n) {
+  input_buffers_queue_t *ibqp = &((SerialUSBDriver *)ip)->ibqueue;
+
+  if (n == (size_t)0) {
+    return;
+  }
+
+  osalSysLock();
+
+  osalDbgAssert((ibqp->ptr != NULL) &&
+                (n <= (size_t)(ibqp->top - ibqp->ptr)),
+                "out of bounds");
+
+  /* If the current buffer has been fully read then it is returned as
+     empty in the queue.*/
+  ibqp->ptr += n;
+  if (ibqp->ptr >= ibqp->top) {
+    ibqReleaseEmptyBufferS(ibqp);
+  }
+
+  osalSysUnlock();
+}
+
 static msg_t _putt(void *ip, uint8_t b, sysinterval_t timeout) {
 
   return obqPutTimeout(&((SerialUSBDriver *)ip)->obqueue, b, timeout);
@@ -156,6 +273,7 @@ static msg_t _ctl(void *ip, unsigned int operation, void *arg) {
 static const struct SerialUSBDriverVMT vmt = {
   (size_t)0,
   _write, _read, _put, _get,
+  _writev, _getrbuf, _relrbuf,
   _putt, _gett, _writet, _readt,
   _ctl
 };
@@ -176,7 +294,6 @@ static void ibnotify(io_buffers_queue_t *bqp) {
  * @param[in] bqp       the buffers queue pointer.
  */
 static void obnotify(io_buffers_queue_t *bqp) {
-  size_t n;
   SerialUSBDriver *sdup = bqGetLinkX(bqp);
 
   /* If the USB driver is not in the appropriate state then transactions
@@ -188,12 +305,8 @@ static void obnotify(io_buffers_queue_t *bqp) {
 
   /* Checking if there is already a transaction ongoing on the endpoint.*/
   if (!usbGetTransmitStatusI(sdup->config->usbp, sdup->config->bulk_in)) {
-    /* Trying to get a full buffer.*/
-    uint8_t *buf = obqGetFullBufferI(&sdup->obqueue, &n);
-    if (buf != NULL) {
-      /* Buffer found, starting a new transaction.*/
-      usbStartTransmitI(sdup->config->usbp, sdup->config->bulk_in, buf, n);
-    }
+    /* Trying to get a full buffer and starting a new transaction.*/
+    (void) sdu_start_transmit(sdup, false);
   }
 }
 
@@ -343,6 +456,12 @@ void sduWakeupHookI(SerialUSBDriver *sdup) {
  */
 void sduConfigureHookI(SerialUSBDriver *sdup) {
 
+  /* Buffers not multiple of the packet size would split transfers in
+     short packets and break the zero length packet logic.*/
+  osalDbgAssert((SERIAL_USB_BUFFERS_SIZE %
+                 sdup->config->usbp->epc[sdup->config->bulk_in]->in_maxsize) == 0U,
+                "buffers size not multiple of the IN packet size");
+
   ibqResetI(&sdup->ibqueue);
   bqResumeX(&sdup->ibqueue);
   obqResetI(&sdup->obqueue);
@@ -414,12 +533,10 @@ void sduSOFHookI(SerialUSBDriver *sdup) {
   /* Checking if there only a buffer partially filled, if so then it is
      enforced in the queue and transmitted.*/
   if (obqTryFlushI(&sdup->obqueue)) {
-    size_t n;
-    uint8_t *buf = obqGetFullBufferI(&sdup->obqueue, &n);
-
-    osalDbgAssert(buf != NULL, "queue is empty");
+    bool empty = sdu_start_transmit(sdup, false);
 
-    usbStartTransmitI(sdup->config->usbp, sdup->config->bulk_in, buf, n);
+    osalDbgAssert(!empty, "queue is empty");
+    (void)empty;
   }
 }
 
@@ -432,8 +549,6 @@ void sduSOFHookI(SerialUSBDriver *sdup) {
  * @param[in] ep        IN endpoint number
  */
 void sduDataTransmitted(USBDriver *usbp, usbep_t ep) {
-  uint8_t *buf;
-  size_t n;
   SerialUSBDriver *sdup = usbp->in_params[ep - 1U];
 
   if (sdup == NULL) {
@@ -442,35 +557,19 @@ void sduDataTransmitted(USBDriver *usbp, usbep_t ep) {
 
   osalSysLockFromISR();
 
-  /* Signaling that space is available in the output queue.*/
-  chnAddFlagsI(sdup, CHN_OUTPUT_EMPTY);
-
   /* Freeing the buffer just transmitted, if it was not a zero size packet.*/
   if (usbp->epc[ep]->in_state->txsize > 0U) {
     obqReleaseEmptyBufferI(&sdup->obqueue);
   }
 
-  /* Checking if there is a buffer ready for transmission.*/
-  buf = obqGetFullBufferI(&sdup->obqueue, &n);
-
-  if (buf != NULL) {
-    /* The endpoint cannot be busy, we are in the context of the callback,
-       so it is safe to transmit without a check.*/
-    usbStartTransmitI(usbp, ep, buf, n);
-  }
-  else if ((usbp->epc[ep]->in_state->txsize > 0U) &&
-           ((usbp->epc[ep]->in_state->txsize &
-            ((size_t)usbp->epc[ep]->in_maxsize - 1U)) == 0U)) {
-    /* Transmit zero sized packet in case the last one has maximum allowed
-       size. Otherwise the recipient may expect more data coming soon and
-       not return buffered data to app. See section 5.8.3 Bulk Transfer
-       Packet Size Constraints of the USB Specification document.*/
-    usbStartTransmitI(usbp, ep, usbp->setup, 0);
+  /* The endpoint cannot be busy, we are in the context of the callback,
+     so it is safe to transmit without a check. The next transaction is
+     started before signaling the application in order to minimize the
+     idle time on the bus.*/
+  (void) sdu_start_transmit(sdup, true);
 
-  }
-  else {
-    /* Nothing to transmit.*/
-  }
+  /* Signaling that space is available in the output queue.*/
+  chnAddFlagsI(sdup, CHN_OUTPUT_EMPTY);
 
   osalSysUnlockFromISR();
 }
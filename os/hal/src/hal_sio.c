@@ -69,6 +69,10 @@ void sioObjectInit(SIODriver *siop) {
 
   siop->state      = SIO_STOP;
   siop->config     = NULL;
+#if SIO_USE_SYNCHRONIZATION == TRUE
+  siop->sync_rx    = NULL;
+  siop->sync_tx    = NULL;
+#endif
 
   /* Optional, user-defined initializer.*/
 #if defined(SIO_DRIVER_EXT_INIT_HOOK)
@@ -118,8 +122,98 @@ void sioStop(SIODriver *siop) {
   siop->config  = NULL;
   siop->state   = SIO_STOP;
 
+#if SIO_USE_SYNCHRONIZATION == TRUE
+  /* Waiting threads are released.*/
+  osalThreadResumeI(&siop->sync_rx, MSG_RESET);
+  osalThreadResumeI(&siop->sync_tx, MSG_RESET);
+  osalOsRescheduleS();
+#endif
+
+  osalSysUnlock();
+}
+
+#if (SIO_USE_SYNCHRONIZATION == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Synchronous read.
+ * @details The function reads the frames already in the RX FIFO, if there
+ *          are none then the calling thread sleeps until the low level
+ *          driver signals new data. With hardware FIFOs the thread is only
+ *          woken up on FIFO threshold or line idle.
+ * @note    The function returns as soon as some data has been read, it
+ *          does not wait for @p n frames.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @param[out] buffer   buffer for the received data
+ * @param[in] n         maximum number of frames to read
+ * @param[in] timeout   synchronization timeout
+ * @return              The number of received frames.
+ * @retval 0            if the operation timed out, a receive error occurred
+ *                      or the driver has been stopped.
+ *
+ * @api
+ */
+size_t sioSynchronousRead(SIODriver *siop, void *buffer, size_t n,
+                          sysinterval_t timeout) {
+  size_t r;
+
+  osalDbgCheck((siop != NULL) && (buffer != NULL) && (n > 0U));
+
+  osalSysLock();
+  osalDbgAssert(siop->state == SIO_READY, "not ready");
+
+  r = sioReadX(siop, buffer, n);
+  if (r == 0U) {
+    if (osalThreadSuspendTimeoutS(&siop->sync_rx, timeout) == MSG_OK) {
+      r = sioReadX(siop, buffer, n);
+    }
+  }
   osalSysUnlock();
+
+  return r;
+}
+
+/**
+ * @brief   Synchronous write.
+ * @details The function fills the TX FIFO, when it is full the calling
+ *          thread sleeps until the low level driver signals space again.
+ * @note    The buffer is organized as an uint8_t array, frames larger than
+ *          8 bits are not supported by this function.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @param[in] buffer    buffer containing the data to be transmitted
+ * @param[in] n         number of frames to write
+ * @param[in] timeout   synchronization timeout, applied to each wait
+ * @return              The number of transmitted frames, less than @p n
+ *                      if the operation timed out or the driver has been
+ *                      stopped.
+ *
+ * @api
+ */
+size_t sioSynchronousWrite(SIODriver *siop, const void *buffer, size_t n,
+                           sysinterval_t timeout) {
+  const uint8_t *bp = (const uint8_t *)buffer;
+  size_t w = 0U;
+
+  osalDbgCheck((siop != NULL) && (buffer != NULL) && (n > 0U));
+
+  osalSysLock();
+  osalDbgAssert(siop->state == SIO_READY, "not ready");
+
+  while (w < n) {
+    size_t done = sioWriteX(siop, bp + w, n - w);
+
+    w += done;
+    if ((w < n) && (done == 0U)) {
+      if (osalThreadSuspendTimeoutS(&siop->sync_tx, timeout) != MSG_OK) {
+        break;
+      }
+    }
+  }
+  osalSysUnlock();
+
+  return w;
 }
+#endif /* SIO_USE_SYNCHRONIZATION == TRUE */
 
 #endif /* HAL_USE_SIO == TRUE */
 
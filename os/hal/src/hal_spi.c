@@ -42,6 +42,51 @@
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (SPI_USE_TRANSACTIONS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the current transaction.
+ * @details The bus is reconfigured if the transaction configuration differs
+ *          from the current one, then the slave is selected and the
+ *          operation started.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+static void spi_transaction_start(SPIDriver *spip) {
+  const SPITransaction *tp = spip->tcurr;
+
+#if SPI_SUPPORTS_CIRCULAR == TRUE
+  osalDbgAssert(tp->config->circular == false, "circular mode not allowed");
+#endif
+
+  /* Reconfiguration is only required when switching to another slave
+     configuration.*/
+  if (tp->config != spip->config) {
+    spip->config = tp->config;
+    spi_lld_start(spip);
+  }
+
+  spiSelectI(spip);
+  if (tp->txbuf != NULL) {
+    if (tp->rxbuf != NULL) {
+      spi_lld_exchange(spip, tp->n, tp->txbuf, tp->rxbuf);
+    }
+    else {
+      spi_lld_send(spip, tp->n, tp->txbuf);
+    }
+  }
+  else {
+    if (tp->rxbuf != NULL) {
+      spi_lld_receive(spip, tp->n, tp->rxbuf);
+    }
+    else {
+      spi_lld_ignore(spip, tp->n);
+    }
+  }
+}
+#endif /* SPI_USE_TRANSACTIONS == TRUE */
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -75,6 +120,11 @@ void spiObjectInit(SPIDriver *spip) {
 #if SPI_USE_MUTUAL_EXCLUSION == TRUE
   osalMutexObjectInit(&spip->mutex);
 #endif
+#if SPI_USE_TRANSACTIONS == TRUE
+  spip->tcurr   = NULL;
+  spip->tleft   = (size_t)0;
+  spip->tconfig = NULL;
+#endif
 #if defined(SPI_DRIVER_EXT_INIT_HOOK)
   SPI_DRIVER_EXT_INIT_HOOK(spip);
 #endif
@@ -278,6 +328,13 @@ void spiAbortI(SPIDriver *spip) {
                 "invalid state");
 
   spi_lld_abort(spip);
+#if HAL_USE_PM == TRUE
+  /* In the completion callback of a single operation the lock has already
+     been released.*/
+  if (spip->state == SPI_ACTIVE) {
+    pmUnlockDepthI(PM_DEPTH_SLEEP);
+  }
+#endif
   spip->state = SPI_READY;
 #if SPI_USE_WAIT == TRUE
   osalThreadResumeI(&spip->thread, MSG_OK);
@@ -464,6 +521,127 @@ void spiReleaseBus(SPIDriver *spip) {
 }
 #endif /* SPI_USE_MUTUAL_EXCLUSION == TRUE */
 
+#if (SPI_USE_TRANSACTIONS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a sequence of transactions.
+ * @details The transactions are executed back to back, each one is started
+ *          from the completion interrupt of the previous one. The chip
+ *          select is handled automatically using the settings of each
+ *          transaction configuration.
+ * @post    At the end of each transaction its callback is invoked, the
+ *          driver returns to the ready state after the last one.
+ * @note    The transactions array must remain valid until the sequence
+ *          is complete.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] tp        pointer to an array of @p SPITransaction structures
+ * @param[in] n         number of transactions in the array
+ *
+ * @iclass
+ */
+void spiStartTransactionsI(SPIDriver *spip,
+                           const SPITransaction *tp, size_t n) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((spip != NULL) && (tp != NULL) && (n > 0U));
+  osalDbgAssert(spip->state == SPI_READY, "not ready");
+
+  _spi_pm_lock(spip);
+  spip->state   = SPI_ACTIVE;
+  spip->tconfig = spip->config;
+  spip->tcurr   = tp;
+  spip->tleft   = n;
+  spi_transaction_start(spip);
+}
+
+/**
+ * @brief   Starts a sequence of transactions.
+ * @details The transactions are executed back to back, each one is started
+ *          from the completion interrupt of the previous one. The chip
+ *          select is handled automatically using the settings of each
+ *          transaction configuration.
+ * @post    At the end of each transaction its callback is invoked, the
+ *          driver returns to the ready state after the last one.
+ * @note    The transactions array must remain valid until the sequence
+ *          is complete.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] tp        pointer to an array of @p SPITransaction structures
+ * @param[in] n         number of transactions in the array
+ *
+ * @api
+ */
+void spiStartTransactions(SPIDriver *spip,
+                          const SPITransaction *tp, size_t n) {
+
+  osalSysLock();
+  spiStartTransactionsI(spip, tp, n);
+  osalSysUnlock();
+}
+
+#if (SPI_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Performs a sequence of transactions.
+ * @details This synchronous function executes the transactions back to
+ *          back and returns after the last one.
+ * @pre     In order to use this function the option @p SPI_USE_WAIT must be
+ *          enabled.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] tp        pointer to an array of @p SPITransaction structures
+ * @param[in] n         number of transactions in the array
+ *
+ * @api
+ */
+void spiTransactions(SPIDriver *spip, const SPITransaction *tp, size_t n) {
+
+  osalSysLock();
+  spiStartTransactionsI(spip, tp, n);
+  (void) osalThreadSuspendS(&spip->thread);
+  osalSysUnlock();
+}
+#endif /* SPI_USE_WAIT == TRUE */
+
+/**
+ * @brief   Common ISR code for transactions.
+ * @details The slave is deselected and the transaction callback invoked,
+ *          then the next transaction is started. After the last one the
+ *          original configuration is restored and the waiting thread, if
+ *          any, is woken up.
+ * @note    This function is meant to be used in the low level drivers
+ *          implementation only, it is invoked by @p _spi_isr_code().
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void _spi_isr_transactions_code(SPIDriver *spip) {
+  const SPITransaction *tp = spip->tcurr;
+
+  spiUnselectI(spip);
+  if (tp->end_cb != NULL) {
+    tp->end_cb(spip);
+  }
+
+  spip->tleft--;
+  if (spip->tleft > (size_t)0) {
+    spip->tcurr = tp + 1;
+    spi_transaction_start(spip);
+    return;
+  }
+
+  /* Sequence complete.*/
+  spip->tcurr = NULL;
+  if (spip->config != spip->tconfig) {
+    spip->config = spip->tconfig;
+    spi_lld_start(spip);
+  }
+  _spi_pm_unlock_isr(spip);
+  spip->state = SPI_READY;
+  _spi_wakeup_isr(spip);
+}
+#endif /* SPI_USE_TRANSACTIONS == TRUE */
+
 #endif /* HAL_USE_SPI == TRUE */
 
 /** @} */
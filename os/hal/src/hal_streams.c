@@ -0,0 +1,120 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_streams.c
+ * @brief   Data streams default methods code.
+ *
+ * @addtogroup HAL_STREAMS
+ * @{
+ */
+
+#include "hal.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Default vectored write method.
+ * @details The buffers are written in sequence using the @p write method,
+ *          the operation stops on the first partial write.
+ *
+ * @param[in] ip        pointer to a @p BaseSequentialStream or derived class
+ * @param[in] iov       pointer to an array of @p stream_iovec_t elements
+ * @param[in] n         number of elements in the array
+ * @return              The number of bytes transferred.
+ *
+ * @api
+ */
+size_t streamDefaultWriteV(void *ip, const stream_iovec_t *iov, size_t n) {
+  BaseSequentialStream *bssp = (BaseSequentialStream *)ip;
+  size_t total = (size_t)0;
+
+  osalDbgCheck((bssp != NULL) && ((iov != NULL) || (n == (size_t)0)));
+
+  while (n > (size_t)0) {
+    size_t done = (size_t)0;
+
+    if (iov->n > (size_t)0) {
+      done = streamWrite(bssp, iov->bp, iov->n);
+      total += done;
+    }
+    if (done < iov->n) {
+      break;
+    }
+    iov++;
+    n--;
+  }
+
+  return total;
+}
+
+/**
+ * @brief   Default get read buffer method.
+ * @details Streams without internal buffers cannot expose data without
+ *          copying it, the function always fails.
+ *
+ * @param[in] ip        pointer to a @p BaseSequentialStream or derived class
+ * @param[out] np       pointer to a variable receiving zero
+ * @return              Always @p NULL.
+ *
+ * @api
+ */
+const uint8_t *streamDefaultGetReadBuffer(void *ip, size_t *np) {
+
+  (void)ip;
+
+  osalDbgCheck(np != NULL);
+
+  *np = (size_t)0;
+
+  return NULL;
+}
+
+/**
+ * @brief   Default release read buffer method.
+ *
+ * @param[in] ip        pointer to a @p BaseSequentialStream or derived class
+ * @param[in] n         number of bytes consumed, must be zero
+ *
+ * @api
+ */
+void streamDefaultReleaseReadBuffer(void *ip, size_t n) {
+
+  (void)ip;
+  (void)n;
+
+  osalDbgCheck(n == (size_t)0);
+}
+
+/** @} */
@@ -22,6 +22,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 
 #if (HAL_USE_TRNG == TRUE) || defined(__DOXYGEN__)
@@ -30,6 +32,15 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+#define ROTL32(v, n) (((v) << (n)) | ((v) >> (32U - (n))))
+
+#define QR(a, b, c, d) {                                                    \
+  a += b; d ^= a; d = ROTL32(d, 16U);                                       \
+  c += d; b ^= c; b = ROTL32(b, 12U);                                       \
+  a += b; d ^= a; d = ROTL32(d, 8U);                                        \
+  c += d; b ^= c; b = ROTL32(b, 7U);                                        \
+}
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -42,6 +53,121 @@
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (TRNG_USE_DRBG == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   ChaCha20 block function with zero counter and nonce.
+ *
+ * @param[in] key       256 bits key
+ * @param[out] out      512 bits output block
+ */
+static void trng_chacha20_block(const uint32_t *key, uint32_t *out) {
+  static const uint32_t sigma[4] = {
+    0x61707865U, 0x3320646EU, 0x79622D32U, 0x6B206574U
+  };
+  uint32_t x[16];
+  unsigned i;
+
+  for (i = 0U; i < 4U; i++) {
+    x[i]      = sigma[i];
+    x[12U + i] = 0U;
+  }
+  for (i = 0U; i < 8U; i++) {
+    x[4U + i] = key[i];
+  }
+  memcpy(out, x, sizeof (x));
+
+  for (i = 0U; i < 10U; i++) {
+    QR(x[0], x[4], x[8],  x[12]);
+    QR(x[1], x[5], x[9],  x[13]);
+    QR(x[2], x[6], x[10], x[14]);
+    QR(x[3], x[7], x[11], x[15]);
+    QR(x[0], x[5], x[10], x[15]);
+    QR(x[1], x[6], x[11], x[12]);
+    QR(x[2], x[7], x[8],  x[13]);
+    QR(x[3], x[4], x[9],  x[14]);
+  }
+
+  for (i = 0U; i < 16U; i++) {
+    out[i] += x[i];
+  }
+}
+
+/**
+ * @brief   Generates a new DRBG output block.
+ * @details Half of the ChaCha20 block replaces the key, so a compromise of
+ *          the state does not reveal past outputs, the other half is the
+ *          output. The key is mixed with hardware entropy on the first use
+ *          and every @p TRNG_DRBG_RESEED_INTERVAL bytes.
+ *
+ * @param[in] trngp     pointer to the @p TRNGDriver object
+ * @return              The operation status.
+ * @retval false        if the block has been generated.
+ * @retval true         if an HW error occurred while reseeding.
+ */
+static bool trng_drbg_refill(TRNGDriver *trngp) {
+  trngdrbg_t *dp = &trngp->drbg;
+  uint32_t blk[16];
+  unsigned i;
+
+  if (!dp->seeded || (dp->count >= (size_t)TRNG_DRBG_RESEED_INTERVAL)) {
+    uint32_t seed[8];
+
+    if (trng_lld_generate(trngp, sizeof (seed), (uint8_t *)seed)) {
+      return true;
+    }
+    for (i = 0U; i < 8U; i++) {
+      dp->key[i] ^= seed[i];
+    }
+    memset(seed, 0, sizeof (seed));
+    dp->seeded = true;
+    dp->count  = 0U;
+  }
+
+  trng_chacha20_block(dp->key, blk);
+  memcpy(dp->key, &blk[0], sizeof (dp->key));
+  memcpy(dp->buf, &blk[8], sizeof (dp->buf));
+  memset(blk, 0, sizeof (blk));
+  dp->avail = sizeof (dp->buf);
+
+  return false;
+}
+
+/**
+ * @brief   Random data generation through the DRBG.
+ *
+ * @param[in] trngp     pointer to the @p TRNGDriver object
+ * @param[in] size      size of output buffer
+ * @param[out] out      output buffer
+ * @return              The operation status.
+ * @retval false        if a random number has been generated.
+ * @retval true         if an HW error occurred.
+ */
+static bool trng_drbg_generate(TRNGDriver *trngp, size_t size, uint8_t *out) {
+  trngdrbg_t *dp = &trngp->drbg;
+
+  while (size > 0U) {
+    size_t n, offset;
+
+    if (dp->avail == 0U) {
+      if (trng_drbg_refill(trngp)) {
+        return true;
+      }
+    }
+
+    n = size < dp->avail ? size : dp->avail;
+    offset = sizeof (dp->buf) - dp->avail;
+    memcpy(out, &dp->buf[offset], n);
+    memset(&dp->buf[offset], 0, n);
+    dp->avail -= n;
+    dp->count += n;
+    out       += n;
+    size      -= n;
+  }
+
+  return false;
+}
+#endif /* TRNG_USE_DRBG == TRUE */
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -89,6 +215,11 @@ void trngStart(TRNGDriver *trngp, const TRNGConfig *config) {
               "invalid state");
   trngp->config = config;
   trng_lld_start(trngp);
+#if TRNG_USE_DRBG == TRUE
+  if (trngp->state == TRNG_STOP) {
+    memset(&trngp->drbg, 0, sizeof (trngdrbg_t));
+  }
+#endif
   trngp->state = TRNG_READY;
   osalSysUnlock();
 }
@@ -110,6 +241,9 @@ void trngStop(TRNGDriver *trngp) {
                 "invalid state");
 
   trng_lld_stop(trngp);
+#if TRNG_USE_DRBG == TRUE
+  memset(&trngp->drbg, 0, sizeof (trngdrbg_t));
+#endif
   trngp->config = NULL;
   trngp->state  = TRNG_STOP;
 
@@ -120,6 +254,8 @@ void trngStop(TRNGDriver *trngp) {
  * @brief   True random numbers generator.
  * @note    The function is blocking and likely performs polled waiting
  *          inside the low level implementation.
+ * @note    If @p TRNG_USE_DRBG is enabled then the data is produced by
+ *          the DRBG, the hardware is accessed only for reseeding.
  *
  * @param[in] trngp             pointer to the @p TRNGDriver object
  * @param[in] size              size of output buffer
@@ -139,7 +275,11 @@ bool trngGenerate(TRNGDriver *trngp, size_t size, uint8_t *out) {
 
   trngp->state = TRNG_RUNNING;
 
+#if TRNG_USE_DRBG == TRUE
+  err = trng_drbg_generate(trngp, size, out);
+#else
   err = trng_lld_generate(trngp, size, out);
+#endif
 
   trngp->state = TRNG_READY;
 
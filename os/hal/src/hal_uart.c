@@ -256,7 +256,8 @@ void uartStartReceive(UARTDriver *uartp, size_t n, void *rxbuf) {
 
   osalSysLock();
   osalDbgAssert(uartp->state == UART_READY, "is active");
-  osalDbgAssert(uartp->rxstate != UART_RX_ACTIVE, "rx active");
+  osalDbgAssert((uartp->rxstate != UART_RX_ACTIVE) &&
+                (uartp->rxstate != UART_RX_CIRCULAR), "rx active");
 
   uart_lld_start_receive(uartp, n, rxbuf);
   uartp->rxstate = UART_RX_ACTIVE;
@@ -280,7 +281,8 @@ void uartStartReceiveI(UARTDriver *uartp, size_t n, void *rxbuf) {
   osalDbgCheckClassI();
   osalDbgCheck((uartp != NULL) && (n > 0U) && (rxbuf != NULL));
   osalDbgAssert(uartp->state == UART_READY, "is active");
-  osalDbgAssert(uartp->rxstate != UART_RX_ACTIVE, "rx active");
+  osalDbgAssert((uartp->rxstate != UART_RX_ACTIVE) &&
+                (uartp->rxstate != UART_RX_CIRCULAR), "rx active");
 
   uart_lld_start_receive(uartp, n, rxbuf);
   uartp->rxstate = UART_RX_ACTIVE;
@@ -306,7 +308,8 @@ size_t uartStopReceive(UARTDriver *uartp) {
   osalSysLock();
   osalDbgAssert(uartp->state == UART_READY, "not active");
 
-  if (uartp->rxstate == UART_RX_ACTIVE) {
+  if ((uartp->rxstate == UART_RX_ACTIVE) ||
+      (uartp->rxstate == UART_RX_CIRCULAR)) {
     n = uart_lld_stop_receive(uartp);
     uartp->rxstate = UART_RX_IDLE;
   }
@@ -337,7 +340,8 @@ size_t uartStopReceiveI(UARTDriver *uartp) {
   osalDbgCheck(uartp != NULL);
   osalDbgAssert(uartp->state == UART_READY, "not active");
 
-  if (uartp->rxstate == UART_RX_ACTIVE) {
+  if ((uartp->rxstate == UART_RX_ACTIVE) ||
+      (uartp->rxstate == UART_RX_CIRCULAR)) {
     size_t n = uart_lld_stop_receive(uartp);
     uartp->rxstate = UART_RX_IDLE;
     return n;
@@ -345,6 +349,59 @@ size_t uartStopReceiveI(UARTDriver *uartp) {
   return UART_ERR_NOT_ACTIVE;
 }
 
+#if (UART_USE_RX_CIRCULAR == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a circular receive operation on the UART peripheral.
+ * @details The receiver continuously fills @p rxbuf wrapping around its
+ *          end. The frames received since the previous event are passed
+ *          to the @p rxdata_cb callback and waiting threads are woken up
+ *          on line idle, on buffer half and full and on character match.
+ *          The operation continues until stopped using
+ *          @p uartStopReceive().
+ * @note    The buffers are organized as uint8_t arrays for data sizes below
+ *          or equal to 8 bits else it is organized as uint16_t arrays.
+ * @note    Data not consumed before being overwritten by the receiver is
+ *          lost, the buffer must be large enough to absorb the latency of
+ *          the consumer.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] n         size of the circular buffer in data frames
+ * @param[out] rxbuf    the pointer to the circular buffer
+ *
+ * @api
+ */
+void uartStartReceiveCircular(UARTDriver *uartp, size_t n, void *rxbuf) {
+
+  osalSysLock();
+  uartStartReceiveCircularI(uartp, n, rxbuf);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Starts a circular receive operation on the UART peripheral.
+ * @note    The buffers are organized as uint8_t arrays for data sizes below
+ *          or equal to 8 bits else it is organized as uint16_t arrays.
+ * @note    This function has to be invoked from a lock zone.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] n         size of the circular buffer in data frames
+ * @param[out] rxbuf    the pointer to the circular buffer
+ *
+ * @iclass
+ */
+void uartStartReceiveCircularI(UARTDriver *uartp, size_t n, void *rxbuf) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((uartp != NULL) && (n > 1U) && (rxbuf != NULL));
+  osalDbgAssert(uartp->state == UART_READY, "is active");
+  osalDbgAssert((uartp->rxstate != UART_RX_ACTIVE) &&
+                (uartp->rxstate != UART_RX_CIRCULAR), "rx active");
+
+  uart_lld_start_receive_circular(uartp, n, rxbuf);
+  uartp->rxstate = UART_RX_CIRCULAR;
+}
+#endif /* UART_USE_RX_CIRCULAR == TRUE */
+
 #if (UART_USE_WAIT == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Performs a transmission on the UART peripheral.
@@ -466,7 +523,8 @@ msg_t uartReceiveTimeout(UARTDriver *uartp, size_t *np,
 
   osalSysLock();
   osalDbgAssert(uartp->state == UART_READY, "is active");
-  osalDbgAssert(uartp->rxstate != UART_RX_ACTIVE, "rx active");
+  osalDbgAssert((uartp->rxstate != UART_RX_ACTIVE) &&
+                (uartp->rxstate != UART_RX_CIRCULAR), "rx active");
 
   /* Receive start.*/
   uart_lld_start_receive(uartp, *np, rxbuf);
@@ -483,6 +541,59 @@ msg_t uartReceiveTimeout(UARTDriver *uartp, size_t *np,
 }
 #endif
 
+#if ((UART_USE_WAIT == TRUE) && (UART_USE_RX_CIRCULAR == TRUE)) ||        \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Reads the data received in circular mode.
+ * @details The function copies the frames already received and not yet
+ *          consumed, if there are none then it waits for the next receive
+ *          event.
+ * @pre     A circular receive operation must have been started using
+ *          @p uartStartReceiveCircular().
+ * @note    The frames delivered to the @p rxdata_cb callback are consumed
+ *          and are not returned by this function, the callback should not
+ *          be used in conjunction with this function.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in,out] np    maximum number of data frames to read, on exit the
+ *                      number of frames actually read
+ * @param[out] rxbuf    the pointer to the receive buffer
+ * @param[in] timeout   operation timeout
+ *
+ * @return              The operation status.
+ * @retval MSG_OK       if some data has been read.
+ * @retval MSG_TIMEOUT  if the operation timed out.
+ * @retval MSG_RESET    in case of a receive error.
+ *
+ * @api
+ */
+msg_t uartReceiveCircularTimeout(UARTDriver *uartp, size_t *np,
+                                 void *rxbuf, sysinterval_t timeout) {
+  msg_t msg = MSG_OK;
+  size_t n;
+
+  osalDbgCheck((uartp != NULL) && (*np > 0U) && (rxbuf != NULL));
+
+  osalSysLock();
+  osalDbgAssert(uartp->state == UART_READY, "is active");
+  osalDbgAssert(uartp->rxstate == UART_RX_CIRCULAR, "not circular");
+
+  /* Waiting for data, the thread could be woken up by an event after the
+     data has already been consumed.*/
+  while ((n = uart_lld_read_circular(uartp, rxbuf, *np)) == 0U) {
+    msg = osalThreadSuspendTimeoutS(&uartp->threadrx, timeout);
+    if (msg != MSG_OK) {
+      break;
+    }
+  }
+  osalSysUnlock();
+
+  *np = n;
+
+  return msg;
+}
+#endif
+
 #if (UART_USE_MUTUAL_EXCLUSION == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Gains exclusive access to the UART bus.
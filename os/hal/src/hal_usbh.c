@@ -0,0 +1,605 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_usbh.c
+ * @brief   USB Host Driver code.
+ *
+ * @addtogroup USBH
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_USBH == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Attach debounce interval in milliseconds.
+ */
+#define USBH_ATTACH_DEBOUNCE                100U
+
+/**
+ * @brief   Recovery interval after a port reset in milliseconds.
+ */
+#define USBH_RESET_RECOVERY                 10U
+
+/**
+ * @brief   Recovery interval after @p SET_ADDRESS in milliseconds.
+ */
+#define USBH_SET_ADDRESS_RECOVERY           2U
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Sets the parameters of an endpoint zero pipe.
+ *
+ * @param[in] pipe      pointer to the @p USBHPipe object
+ * @param[in] devaddr   device address
+ * @param[in] mps       maximum packet size
+ *
+ * @notapi
+ */
+static void usbh_ep0_setup(USBHPipe *pipe, uint8_t devaddr, uint16_t mps) {
+
+  pipe->devaddr = devaddr;
+  pipe->mps     = mps;
+  pipe->toggle  = 0U;
+}
+
+/**
+ * @brief   Reads a descriptor from the attached device.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] type      descriptor type
+ * @param[in] length    number of bytes to be read
+ * @param[out] buf      pointer to the descriptor buffer
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static msg_t usbh_get_descriptor(USBHDriver *usbhp, uint8_t type,
+                                 uint16_t length, uint8_t *buf) {
+
+  return usbhControlRequest(usbhp,
+                            USBH_RTYPE_DEV2HOST | USBH_RTYPE_STANDARD |
+                            USBH_RTYPE_DEVICE,
+                            USBH_REQ_GET_DESCRIPTOR,
+                            (uint16_t)((uint16_t)type << 8), 0U,
+                            length, buf);
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   USB Host Driver initialization.
+ * @note    This function is implicitly invoked by @p halInit(), there is
+ *          no need to explicitly initialize the driver.
+ *
+ * @init
+ */
+void usbhInit(void) {
+
+  usbh_lld_init();
+}
+
+/**
+ * @brief   Initializes the standard part of a @p USBHDriver structure.
+ *
+ * @param[out] usbhp    pointer to the @p USBHDriver object
+ *
+ * @init
+ */
+void usbhObjectInit(USBHDriver *usbhp) {
+
+  usbhp->state  = USBH_STOP;
+  usbhp->config = NULL;
+  usbhp->speed  = USBH_SPEED_FULL;
+  usbhp->urbp   = NULL;
+  usbhp->thread = NULL;
+  usbhp->ep0out.open = false;
+  usbhp->ep0in.open  = false;
+  osalMutexObjectInit(&usbhp->mutex);
+  osalEventObjectInit(&usbhp->event);
+}
+
+/**
+ * @brief   Configures and activates the USB host peripheral.
+ * @note    The low level driver can sleep during the peripheral setup,
+ *          the kernel is not locked during this operation.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] config    pointer to the @p USBHConfig object
+ *
+ * @api
+ */
+void usbhStart(USBHDriver *usbhp, const USBHConfig *config) {
+  bool result;
+
+  osalDbgCheck((usbhp != NULL) && (config != NULL));
+
+  osalDbgAssert((usbhp->state == USBH_STOP) || (usbhp->state == USBH_READY),
+                "invalid state");
+
+  if (usbhp->state == USBH_STOP) {
+    usbhp->config = config;
+    usbh_lld_start(usbhp);
+
+    /* Endpoint zero pipes, parameters are set on each connection.*/
+    result  = usbhOpenPipe(usbhp, &usbhp->ep0out, 0U, USBH_EPTYPE_CTRL, 8U);
+    result |= usbhOpenPipe(usbhp, &usbhp->ep0in, USBH_EP_IN,
+                           USBH_EPTYPE_CTRL, 8U);
+    osalDbgAssert(result == HAL_SUCCESS, "no channels for endpoint zero");
+    (void)result;
+  }
+
+  osalSysLock();
+  usbhp->config = config;
+  usbhp->state  = USBH_READY;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Deactivates the USB host peripheral.
+ * @note    A transfer in progress is terminated with @p MSG_RESET.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @api
+ */
+void usbhStop(USBHDriver *usbhp) {
+
+  osalDbgCheck(usbhp != NULL);
+
+  osalSysLock();
+
+  osalDbgAssert((usbhp->state == USBH_STOP) ||
+                (usbhp->state == USBH_READY) ||
+                (usbhp->state == USBH_ACTIVE), "invalid state");
+
+  if (usbhp->urbp != NULL) {
+    usbh_lld_abort_transfer(usbhp);
+    _usbh_complete_i(usbhp, MSG_RESET);
+  }
+  usbh_lld_stop(usbhp);
+  usbhp->ep0out.open = false;
+  usbhp->ep0in.open  = false;
+  usbhp->config = NULL;
+  usbhp->state  = USBH_STOP;
+
+  osalOsRescheduleS();
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Enumerates the attached device.
+ * @details The function waits for a device to be attached, resets the
+ *          port, assigns the device address, reads the device and
+ *          configuration descriptors and selects the first configuration.
+ *          The driver enters the @p USBH_ACTIVE state on success.
+ * @note    Hubs are not supported, the attached device is the only device
+ *          on the bus.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] timeout   timeout for the device attach
+ * @return              The operation status.
+ * @retval MSG_OK       if the device has been configured.
+ * @retval MSG_TIMEOUT  if a device has not been attached in time.
+ * @retval MSG_RESET    if the enumeration failed.
+ *
+ * @api
+ */
+msg_t usbhConnect(USBHDriver *usbhp, sysinterval_t timeout) {
+  uint8_t *devbuf = (uint8_t *)usbhp->devbuf;
+  uint8_t *cfgbuf = (uint8_t *)usbhp->cfgbuf;
+  uint16_t mps0;
+  size_t n;
+  msg_t msg;
+
+  osalDbgCheck(usbhp != NULL);
+
+  /* Waiting for a device to be attached.*/
+  osalSysLock();
+  osalDbgAssert(usbhp->state == USBH_READY, "invalid state");
+  msg = MSG_OK;
+  if (!usbh_lld_is_connected(usbhp)) {
+    msg = osalThreadSuspendTimeoutS(&usbhp->thread, timeout);
+  }
+  osalSysUnlock();
+  if (msg != MSG_OK) {
+    return msg;
+  }
+
+  osalThreadSleepMilliseconds(USBH_ATTACH_DEBOUNCE);
+  if (usbh_lld_reset_port(usbhp) != HAL_SUCCESS) {
+    return MSG_RESET;
+  }
+  osalThreadSleepMilliseconds(USBH_RESET_RECOVERY);
+
+  /* The first 8 bytes of the device descriptor give the endpoint zero
+     packet size.*/
+  usbh_ep0_setup(&usbhp->ep0out, 0U, 8U);
+  usbh_ep0_setup(&usbhp->ep0in, 0U, 8U);
+  msg = usbh_get_descriptor(usbhp, USBH_DT_DEVICE, 8U, devbuf);
+  if (msg != MSG_OK) {
+    return msg;
+  }
+  mps0 = (uint16_t)devbuf[7];
+  if ((mps0 != 8U) && (mps0 != 16U) && (mps0 != 32U) && (mps0 != 64U)) {
+    return MSG_RESET;
+  }
+  usbh_ep0_setup(&usbhp->ep0out, 0U, mps0);
+  usbh_ep0_setup(&usbhp->ep0in, 0U, mps0);
+
+  /* Address assignment.*/
+  msg = usbhControlRequest(usbhp,
+                           USBH_RTYPE_HOST2DEV | USBH_RTYPE_STANDARD |
+                           USBH_RTYPE_DEVICE,
+                           USBH_REQ_SET_ADDRESS, USBH_DEVICE_ADDRESS, 0U,
+                           0U, NULL);
+  if (msg != MSG_OK) {
+    return msg;
+  }
+  osalThreadSleepMilliseconds(USBH_SET_ADDRESS_RECOVERY);
+  usbh_ep0_setup(&usbhp->ep0out, USBH_DEVICE_ADDRESS, mps0);
+  usbh_ep0_setup(&usbhp->ep0in, USBH_DEVICE_ADDRESS, mps0);
+
+  /* Full device descriptor.*/
+  msg = usbh_get_descriptor(usbhp, USBH_DT_DEVICE, 18U, devbuf);
+  if (msg != MSG_OK) {
+    return msg;
+  }
+
+  /* Configuration descriptor header then the whole descriptor.*/
+  msg = usbh_get_descriptor(usbhp, USBH_DT_CONFIGURATION, 9U, cfgbuf);
+  if (msg != MSG_OK) {
+    return msg;
+  }
+  n = usbhGetConfigSizeX(usbhp);
+  if ((n < 9U) || (n > (size_t)USBH_CONFIG_BUFFER_SIZE)) {
+    return MSG_RESET;
+  }
+  msg = usbh_get_descriptor(usbhp, USBH_DT_CONFIGURATION, (uint16_t)n,
+                            cfgbuf);
+  if (msg != MSG_OK) {
+    return msg;
+  }
+
+  /* Selecting the configuration.*/
+  msg = usbhControlRequest(usbhp,
+                           USBH_RTYPE_HOST2DEV | USBH_RTYPE_STANDARD |
+                           USBH_RTYPE_DEVICE,
+                           USBH_REQ_SET_CONFIGURATION, (uint16_t)cfgbuf[5],
+                           0U, 0U, NULL);
+  if (msg != MSG_OK) {
+    return msg;
+  }
+
+  osalSysLock();
+  if (usbh_lld_is_connected(usbhp)) {
+    usbhp->state = USBH_ACTIVE;
+  }
+  else {
+    msg = MSG_RESET;
+  }
+  osalSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Opens a pipe to an endpoint of the attached device.
+ * @details A low level channel is permanently assigned to the pipe until
+ *          it is closed.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[out] pipe     pointer to the @p USBHPipe object
+ * @param[in] epaddr    endpoint address including the direction bit
+ * @param[in] type      endpoint type
+ * @param[in] mps       endpoint maximum packet size
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the pipe has been opened.
+ * @retval HAL_FAILED   if there are no free channels.
+ *
+ * @api
+ */
+bool usbhOpenPipe(USBHDriver *usbhp, USBHPipe *pipe, uint8_t epaddr,
+                  uint8_t type, uint16_t mps) {
+  bool result;
+
+  osalDbgCheck((usbhp != NULL) && (pipe != NULL) && (mps > 0U));
+
+  osalSysLock();
+  osalDbgAssert(usbhp->state != USBH_UNINIT, "invalid state");
+  osalDbgAssert(!pipe->open, "already open");
+  pipe->usbhp   = usbhp;
+  pipe->devaddr = (uint8_t)USBH_DEVICE_ADDRESS;
+  pipe->epaddr  = epaddr;
+  pipe->type    = type;
+  pipe->mps     = mps;
+  pipe->toggle  = 0U;
+  result = usbh_lld_open_pipe(usbhp, pipe);
+  pipe->open    = result == HAL_SUCCESS;
+  osalSysUnlock();
+
+  return result;
+}
+
+/**
+ * @brief   Closes a pipe.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] pipe      pointer to the @p USBHPipe object
+ *
+ * @api
+ */
+void usbhClosePipe(USBHDriver *usbhp, USBHPipe *pipe) {
+
+  osalDbgCheck((usbhp != NULL) && (pipe != NULL));
+
+  osalSysLock();
+  osalDbgAssert((usbhp->urbp == NULL) || (usbhp->urbp->pipe != pipe),
+                "pipe in use");
+  if (pipe->open) {
+    usbh_lld_close_pipe(usbhp, pipe);
+    pipe->open = false;
+  }
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Initializes an @p USBHURB structure.
+ *
+ * @param[out] urbp     pointer to the @p USBHURB object
+ * @param[in] pipe      pointer to the @p USBHPipe object
+ * @param[in] pid       data PID
+ * @param[in] buf       data buffer, must be word aligned
+ * @param[in] size      transfer size
+ *
+ * @init
+ */
+void usbhURBObjectInit(USBHURB *urbp, USBHPipe *pipe, usbhpid_t pid,
+                       uint8_t *buf, size_t size) {
+
+  urbp->next   = NULL;
+  urbp->pipe   = pipe;
+  urbp->pid    = pid;
+  urbp->buf    = buf;
+  urbp->size   = size;
+  urbp->actual = 0U;
+  urbp->status = USBH_URB_IDLE;
+}
+
+/**
+ * @brief   Executes a chain of URBs.
+ * @details The URBs are executed in order by the low level driver, each
+ *          URB is started from the completion interrupt of the previous
+ *          one so the bus is kept busy without thread wakeups. The chain
+ *          is terminated on the first failed URB, the following URBs are
+ *          marked as @p USBH_URB_ABORTED.
+ * @note    A short packet terminates an IN URB successfully, the @p actual
+ *          field reports the received bytes.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] urbp      pointer to the first @p USBHURB of the chain
+ * @param[in] timeout   timeout for the whole chain
+ * @return              The operation status.
+ * @retval MSG_OK       if all the URBs have been completed.
+ * @retval MSG_TIMEOUT  if the chain has been aborted on timeout.
+ * @retval MSG_RESET    if an URB failed or the device has been detached.
+ *
+ * @api
+ */
+msg_t usbhTransfer(USBHDriver *usbhp, USBHURB *urbp, sysinterval_t timeout) {
+  USBHURB *p;
+  msg_t msg;
+
+  osalDbgCheck((usbhp != NULL) && (urbp != NULL));
+
+  osalMutexLock(&usbhp->mutex);
+  osalSysLock();
+
+  osalDbgAssert((usbhp->state == USBH_READY) || (usbhp->state == USBH_ACTIVE),
+                "invalid state");
+
+  if (!usbh_lld_is_connected(usbhp)) {
+    msg = MSG_RESET;
+  }
+  else {
+    for (p = urbp; p != NULL; p = p->next) {
+      osalDbgAssert(p->pipe->open, "pipe not open");
+      osalDbgAssert(((size_t)p->buf & 3U) == 0U, "unaligned buffer");
+      p->actual = 0U;
+      p->status = USBH_URB_PENDING;
+    }
+    usbhp->urbp = urbp;
+    usbh_lld_start_transfer(usbhp);
+    msg = osalThreadSuspendTimeoutS(&usbhp->thread, timeout);
+    if (msg == MSG_TIMEOUT) {
+      usbh_lld_abort_transfer(usbhp);
+      _usbh_complete_i(usbhp, MSG_TIMEOUT);
+    }
+  }
+
+  osalSysUnlock();
+  osalMutexUnlock(&usbhp->mutex);
+
+  return msg;
+}
+
+/**
+ * @brief   Executes a control request on endpoint zero.
+ * @details The setup, data and status stages are executed as a single
+ *          URBs chain.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] rtype     request type
+ * @param[in] req       request code
+ * @param[in] value     request value
+ * @param[in] index     request index
+ * @param[in] length    data stage size, zero if no data stage
+ * @param[in,out] buf   data stage buffer, must be word aligned, IN buffers
+ *                      must be rounded to the endpoint zero packet size
+ * @return              The operation status.
+ * @retval MSG_OK       if the request has been completed.
+ * @retval MSG_TIMEOUT  if the request timed out.
+ * @retval MSG_RESET    if the request failed or has been stalled.
+ *
+ * @api
+ */
+msg_t usbhControlRequest(USBHDriver *usbhp, uint8_t rtype, uint8_t req,
+                         uint16_t value, uint16_t index, uint16_t length,
+                         uint8_t *buf) {
+  uint8_t *setup = (uint8_t *)usbhp->setupbuf;
+  USBHURB stp, data, sts;
+  bool in = (rtype & USBH_RTYPE_DEV2HOST) != 0U;
+
+  osalDbgCheck((length == 0U) || (buf != NULL));
+
+  setup[0] = rtype;
+  setup[1] = req;
+  setup[2] = (uint8_t)value;
+  setup[3] = (uint8_t)(value >> 8);
+  setup[4] = (uint8_t)index;
+  setup[5] = (uint8_t)(index >> 8);
+  setup[6] = (uint8_t)length;
+  setup[7] = (uint8_t)(length >> 8);
+
+  /* The status stage is always in the opposite direction of the data
+     stage, IN if there is no data stage.*/
+  usbhURBObjectInit(&stp, &usbhp->ep0out, USBH_PID_SETUP, setup, 8U);
+  usbhURBObjectInit(&sts, (in && (length > 0U)) ? &usbhp->ep0out :
+                                                  &usbhp->ep0in,
+                    USBH_PID_DATA1, NULL, 0U);
+  if (length > 0U) {
+    usbhURBObjectInit(&data, in ? &usbhp->ep0in : &usbhp->ep0out,
+                      USBH_PID_DATA1, buf, (size_t)length);
+    usbhURBLinkX(&stp, &data);
+    usbhURBLinkX(&data, &sts);
+  }
+  else {
+    usbhURBLinkX(&stp, &sts);
+  }
+
+  return usbhTransfer(usbhp, &stp, OSAL_MS2I(USBH_CONTROL_TIMEOUT));
+}
+
+/**
+ * @brief   Clears the halt condition of an endpoint.
+ * @details The pipe data toggle is reset on success.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] pipe      pointer to the stalled @p USBHPipe object
+ * @return              The operation status.
+ *
+ * @api
+ */
+msg_t usbhClearHalt(USBHDriver *usbhp, USBHPipe *pipe) {
+  msg_t msg;
+
+  osalDbgCheck(pipe != NULL);
+
+  msg = usbhControlRequest(usbhp,
+                           USBH_RTYPE_HOST2DEV | USBH_RTYPE_STANDARD |
+                           USBH_RTYPE_ENDPOINT,
+                           USBH_REQ_CLEAR_FEATURE, USBH_FEATURE_ENDPOINT_HALT,
+                           (uint16_t)pipe->epaddr, 0U, NULL);
+  if (msg == MSG_OK) {
+    pipe->toggle = 0U;
+  }
+
+  return msg;
+}
+
+/**
+ * @brief   Device attach notification.
+ * @note    Invoked by the low level driver from its interrupt handler.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @notapi
+ */
+void _usbh_connected_i(USBHDriver *usbhp) {
+
+  /* Waking up a thread waiting in usbhConnect(), if any.*/
+  if (usbhp->urbp == NULL) {
+    osalThreadResumeI(&usbhp->thread, MSG_OK);
+  }
+  osalEventBroadcastFlagsI(&usbhp->event, USBH_EVENT_CONNECTED);
+}
+
+/**
+ * @brief   Device detach notification.
+ * @details A transfer in progress is terminated with @p MSG_RESET and the
+ *          driver returns to the @p USBH_READY state.
+ * @note    Invoked by the low level driver from its interrupt handler
+ *          after halting the channels.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @notapi
+ */
+void _usbh_disconnected_i(USBHDriver *usbhp) {
+
+  if (usbhp->urbp != NULL) {
+    _usbh_complete_i(usbhp, MSG_RESET);
+  }
+  if (usbhp->state == USBH_ACTIVE) {
+    usbhp->state = USBH_READY;
+  }
+  osalEventBroadcastFlagsI(&usbhp->event, USBH_EVENT_DISCONNECTED);
+}
+
+/**
+ * @brief   URBs chain completion.
+ * @details The URBs not yet executed are marked as aborted and the
+ *          waiting thread, if any, is resumed.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] msg       message for the waiting thread
+ *
+ * @notapi
+ */
+void _usbh_complete_i(USBHDriver *usbhp, msg_t msg) {
+  USBHURB *urbp;
+
+  for (urbp = usbhp->urbp; urbp != NULL; urbp = urbp->next) {
+    if (urbp->status == USBH_URB_PENDING) {
+      urbp->status = USBH_URB_ABORTED;
+    }
+  }
+  usbhp->urbp = NULL;
+  osalThreadResumeI(&usbhp->thread, msg);
+}
+
+#endif /* HAL_USE_USBH == TRUE */
+
+/** @} */
@@ -203,6 +203,40 @@ void wspiStartReceive(WSPIDriver *wspip, const wspi_command_t *cmdp,
   osalSysUnlock();
 }
 
+#if (WSPI_SUPPORTS_POLLING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Polls data from the WSPI bus until a match.
+ * @details The command is repeated by the hardware until the received
+ *          data masked by @p mask is equal to @p match.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[in] n         number of bytes to receive, from 1 to 4
+ * @param[in] mask      mask of the compared bits
+ * @param[in] match     expected value of the compared bits
+ * @param[out] rxbuf    the pointer to the buffer receiving the matched
+ *                      data or @p NULL
+ *
+ * @api
+ */
+void wspiStartPoll(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                   size_t n, uint32_t mask, uint32_t match,
+                   uint8_t *rxbuf) {
+
+  osalDbgCheck((wspip != NULL) && (cmdp != NULL));
+  osalDbgCheck((n > 0U) && (n <= 4U));
+
+  osalSysLock();
+
+  osalDbgAssert(wspip->state == WSPI_READY, "not ready");
+
+  wspiStartPollI(wspip, cmdp, n, mask, match, rxbuf);
+
+  osalSysUnlock();
+}
+#endif /* WSPI_SUPPORTS_POLLING == TRUE */
+
 #if (WSPI_USE_WAIT == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Sends a command without data phase.
@@ -295,6 +329,46 @@ void wspiReceive(WSPIDriver *wspip, const wspi_command_t *cmdp,
 
   osalSysUnlock();
 }
+
+#if (WSPI_SUPPORTS_POLLING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Polls data from the WSPI bus until a match.
+ * @details The command is repeated by the hardware until the received
+ *          data masked by @p mask is equal to @p match, the thread sleeps
+ *          meanwhile.
+ * @pre     In order to use this function the option @p WSPI_USE_WAIT must be
+ *          enabled.
+ * @pre     In order to use this function the driver must have been configured
+ *          without callbacks (@p end_cb = @p NULL).
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[in] n         number of bytes to receive, from 1 to 4
+ * @param[in] mask      mask of the compared bits
+ * @param[in] match     expected value of the compared bits
+ * @param[out] rxbuf    the pointer to the buffer receiving the matched
+ *                      data or @p NULL
+ *
+ * @api
+ */
+void wspiPoll(WSPIDriver *wspip, const wspi_command_t *cmdp,
+              size_t n, uint32_t mask, uint32_t match, uint8_t *rxbuf) {
+
+  osalDbgCheck((wspip != NULL) && (cmdp != NULL));
+  osalDbgCheck((n > 0U) && (n <= 4U));
+  osalDbgCheck((cmdp->cfg & WSPI_CFG_DATA_MODE_MASK) != WSPI_CFG_DATA_MODE_NONE);
+
+  osalSysLock();
+
+  osalDbgAssert(wspip->state == WSPI_READY, "not ready");
+  osalDbgAssert(wspip->config->end_cb == NULL, "has callback");
+
+  wspiStartPollI(wspip, cmdp, n, mask, match, rxbuf);
+  (void) osalThreadSuspendS(&wspip->thread);
+
+  osalSysUnlock();
+}
+#endif /* WSPI_SUPPORTS_POLLING == TRUE */
 #endif /* WSPI_USE_WAIT == TRUE */
 
 #if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
@@ -118,6 +118,20 @@ void i2s_lld_start_exchange(I2SDriver *i2sp) {
   (void)i2sp;
 }
 
+#if (I2S_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a I2S streaming on buffers queues.
+ *
+ * @param[in] i2sp      pointer to the @p I2SDriver object
+ *
+ * @notapi
+ */
+void i2s_lld_start_streaming(I2SDriver *i2sp) {
+
+  (void)i2sp;
+}
+#endif /* I2S_USE_STREAMING == TRUE */
+
 /**
  * @brief   Stops the ongoing data exchange.
  * @details The ongoing data exchange, if any, is stopped, if the driver
@@ -31,6 +31,11 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Streaming on buffers queues support.
+ */
+#define I2S_SUPPORTS_STREAMING              TRUE
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -109,6 +114,24 @@ struct I2SDriver {
    * @brief   Current configuration data.
    */
   const I2SConfig           *config;
+#if (I2S_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Input buffers queue or @p NULL.
+   */
+  input_buffers_queue_t     *ibqp;
+  /**
+   * @brief   Output buffers queue or @p NULL.
+   */
+  output_buffers_queue_t    *obqp;
+  /**
+   * @brief   Dropped received blocks counter.
+   */
+  volatile size_t           overruns;
+  /**
+   * @brief   Transmitted silence blocks counter.
+   */
+  volatile size_t           underruns;
+#endif
   /* End of the mandatory fields.*/
 };
 
@@ -132,6 +155,9 @@ extern "C" {
   void i2s_lld_stop(I2SDriver *i2sp);
   void i2s_lld_start_exchange(I2SDriver *i2sp);
   void i2s_lld_stop_exchange(I2SDriver *i2sp);
+#if I2S_USE_STREAMING == TRUE
+  void i2s_lld_start_streaming(I2SDriver *i2sp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -121,6 +121,16 @@ struct hal_sio_driver {
    * @brief Current configuration data.
    */
   const SIOConfig          *config;
+#if (SIO_USE_SYNCHRONIZATION == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief Thread waiting for RX data.
+   */
+  thread_reference_t       sync_rx;
+  /**
+   * @brief Thread waiting for TX space.
+   */
+  thread_reference_t       sync_tx;
+#endif
 #if defined(SIO_DRIVER_EXT_FIELDS)
   SIO_DRIVER_EXT_FIELDS
 #endif
@@ -70,22 +70,10 @@ typedef struct {
 } TRNGConfig;
 
 /**
- * @brief   Structure representing a TRNG driver.
+ * @brief   Implementation-specific @p TRNGDriver fields.
  */
-struct TRNGDriver {
-  /**
-   * @brief Driver state.
-   */
-  trngstate_t                state;
-  /**
-   * @brief Current configuration data.
-   */
-  const TRNGConfig           *config;
-#if defined(TRNG_DRIVER_EXT_FIELDS)
-  TRNG_DRIVER_EXT_FIELDS
-#endif
-  /* End of the mandatory fields.*/
-};
+#define _trng_lld_driver_fields                                             \
+  uint32_t                   dummy;
 
 /*===========================================================================*/
 /* Driver macros.                                                            */
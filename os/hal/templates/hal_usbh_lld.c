@@ -0,0 +1,197 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_usbh_lld.c
+ * @brief   PLATFORM USB Host subsystem low level driver source template.
+ *
+ * @addtogroup USBH
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_USBH == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   USBH1 driver identifier.
+ */
+#if (PLATFORM_USBH_USE_USBH1 == TRUE) || defined(__DOXYGEN__)
+USBHDriver USBHD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level USB host driver initialization.
+ *
+ * @notapi
+ */
+void usbh_lld_init(void) {
+
+#if PLATFORM_USBH_USE_USBH1 == TRUE
+  /* Driver initialization.*/
+  usbhObjectInit(&USBHD1);
+#endif
+}
+
+/**
+ * @brief   Configures and activates the USB host peripheral.
+ * @note    Called without the kernel locked, the function can sleep.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @notapi
+ */
+void usbh_lld_start(USBHDriver *usbhp) {
+
+  if (usbhp->state == USBH_STOP) {
+    /* Enables the peripheral.*/
+#if PLATFORM_USBH_USE_USBH1 == TRUE
+    if (&USBHD1 == usbhp) {
+
+    }
+#endif
+  }
+  /* Configures the peripheral.*/
+
+}
+
+/**
+ * @brief   Deactivates the USB host peripheral.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @notapi
+ */
+void usbh_lld_stop(USBHDriver *usbhp) {
+
+  if (usbhp->state != USBH_STOP) {
+    /* Resets the peripheral.*/
+
+    /* Disables the peripheral.*/
+#if PLATFORM_USBH_USE_USBH1 == TRUE
+    if (&USBHD1 == usbhp) {
+
+    }
+#endif
+  }
+}
+
+/**
+ * @brief   Resets the port and detects the device speed.
+ * @note    Called without the kernel locked, the function can sleep.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the port has been enabled.
+ * @retval HAL_FAILED   if the port is not enabled after the reset.
+ *
+ * @notapi
+ */
+bool usbh_lld_reset_port(USBHDriver *usbhp) {
+
+  usbhp->speed = USBH_SPEED_FULL;
+
+  return HAL_FAILED;
+}
+
+/**
+ * @brief   Assigns a channel to a pipe.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] pipe      pointer to the @p USBHPipe object
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if a channel has been assigned.
+ * @retval HAL_FAILED   if there are no free channels.
+ *
+ * @notapi
+ */
+bool usbh_lld_open_pipe(USBHDriver *usbhp, USBHPipe *pipe) {
+
+  (void)usbhp;
+  (void)pipe;
+
+  return HAL_FAILED;
+}
+
+/**
+ * @brief   Releases the channel of a pipe.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] pipe      pointer to the @p USBHPipe object
+ *
+ * @notapi
+ */
+void usbh_lld_close_pipe(USBHDriver *usbhp, USBHPipe *pipe) {
+
+  (void)usbhp;
+  (void)pipe;
+}
+
+/**
+ * @brief   Starts the URBs chain pointed by @p urbp.
+ * @details The driver must invoke @p _usbh_complete_i() when the chain is
+ *          completed or an URB fails.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @notapi
+ */
+void usbh_lld_start_transfer(USBHDriver *usbhp) {
+
+  (void)usbhp;
+}
+
+/**
+ * @brief   Stops the URB in progress.
+ * @note    On exit the channel must be halted, the chain is then completed
+ *          by the caller.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @notapi
+ */
+void usbh_lld_abort_transfer(USBHDriver *usbhp) {
+
+  (void)usbhp;
+}
+
+#endif /* HAL_USE_USBH == TRUE */
+
+/** @} */
@@ -0,0 +1,200 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_usbh_lld.h
+ * @brief   PLATFORM USB Host subsystem low level driver header template.
+ *
+ * @addtogroup USBH
+ * @{
+ */
+
+#ifndef HAL_USBH_LLD_H
+#define HAL_USBH_LLD_H
+
+#if (HAL_USE_USBH == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    PLATFORM configuration options
+ * @{
+ */
+/**
+ * @brief   USBH driver enable switch.
+ * @details If set to @p TRUE the support for USBH1 is included.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(PLATFORM_USBH_USE_USBH1) || defined(__DOXYGEN__)
+#define PLATFORM_USBH_USE_USBH1             FALSE
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Structure representing a pipe to a device endpoint.
+ */
+struct USBHPipe {
+  /**
+   * @brief   Driver owning the pipe.
+   */
+  USBHDriver                *usbhp;
+  /**
+   * @brief   Device address.
+   */
+  uint8_t                   devaddr;
+  /**
+   * @brief   Endpoint address including the direction bit.
+   */
+  uint8_t                   epaddr;
+  /**
+   * @brief   Endpoint type.
+   */
+  uint8_t                   type;
+  /**
+   * @brief   Data toggle of the next transaction.
+   */
+  uint8_t                   toggle;
+  /**
+   * @brief   Endpoint maximum packet size.
+   */
+  uint16_t                  mps;
+  /**
+   * @brief   Pipe open.
+   */
+  bool                      open;
+  /* End of the mandatory fields.*/
+};
+
+/**
+ * @brief   Driver configuration structure.
+ * @note    It could be empty on some architectures.
+ */
+typedef struct {
+  /* End of the mandatory fields.*/
+  uint32_t                  dummy;
+} USBHConfig;
+
+/**
+ * @brief   Structure representing an USB host driver.
+ */
+struct USBHDriver {
+  /**
+   * @brief   Driver state.
+   */
+  usbhstate_t               state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const USBHConfig          *config;
+  /**
+   * @brief   Attached device speed.
+   */
+  usbhspeed_t               speed;
+  /**
+   * @brief   URB in progress or @p NULL.
+   */
+  USBHURB                   *urbp;
+  /**
+   * @brief   Thread waiting for a transfer or a device attach.
+   */
+  thread_reference_t        thread;
+  /**
+   * @brief   Transfers mutual exclusion.
+   */
+  mutex_t                   mutex;
+  /**
+   * @brief   Attach and detach events source.
+   */
+  event_source_t            event;
+  /**
+   * @brief   Endpoint zero OUT pipe.
+   */
+  USBHPipe                  ep0out;
+  /**
+   * @brief   Endpoint zero IN pipe.
+   */
+  USBHPipe                  ep0in;
+  /**
+   * @brief   Setup packet buffer.
+   */
+  uint32_t                  setupbuf[2];
+  /**
+   * @brief   Device descriptor buffer.
+   */
+  uint32_t                  devbuf[USBH_DEVICE_BUFFER_SIZE / 4U];
+  /**
+   * @brief   Configuration descriptor buffer.
+   */
+  uint32_t                  cfgbuf[USBH_CONFIG_BUFFER_SIZE / 4U];
+  /* End of the mandatory fields.*/
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Determines if a device is attached to the port.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @return              The attach status.
+ *
+ * @notapi
+ */
+#define usbh_lld_is_connected(usbhp) false
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if (PLATFORM_USBH_USE_USBH1 == TRUE) && !defined(__DOXYGEN__)
+extern USBHDriver USBHD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void usbh_lld_init(void);
+  void usbh_lld_start(USBHDriver *usbhp);
+  void usbh_lld_stop(USBHDriver *usbhp);
+  bool usbh_lld_reset_port(USBHDriver *usbhp);
+  bool usbh_lld_open_pipe(USBHDriver *usbhp, USBHPipe *pipe);
+  void usbh_lld_close_pipe(USBHDriver *usbhp, USBHPipe *pipe);
+  void usbh_lld_start_transfer(USBHDriver *usbhp);
+  void usbh_lld_abort_transfer(USBHDriver *usbhp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_USBH == TRUE */
+
+#endif /* HAL_USBH_LLD_H */
+
+/** @} */
@@ -166,6 +166,34 @@ void wspi_lld_receive(WSPIDriver *wspip, const wspi_command_t *cmdp,
   (void)rxbuf;
 }
 
+#if (WSPI_SUPPORTS_POLLING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Sends a command then polls data until a match.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[in] n         number of bytes to receive, from 1 to 4
+ * @param[in] mask      mask of the compared bits
+ * @param[in] match     expected value of the compared bits
+ * @param[out] rxbuf    the pointer to the buffer receiving the matched
+ *                      data or @p NULL
+ *
+ * @notapi
+ */
+void wspi_lld_poll(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                   size_t n, uint32_t mask, uint32_t match,
+                   uint8_t *rxbuf) {
+
+  (void)wspip;
+  (void)cmdp;
+  (void)n;
+  (void)mask;
+  (void)match;
+  (void)rxbuf;
+}
+#endif /* WSPI_SUPPORTS_POLLING == TRUE */
+
 #if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Maps in memory space a WSPI flash device.
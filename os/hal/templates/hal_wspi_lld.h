@@ -36,6 +36,7 @@
  * @{
  */
 #define WSPI_SUPPORTS_MEMMAP                TRUE
+#define WSPI_SUPPORTS_POLLING               TRUE
 #define WSPI_DEFAULT_CFG_MASKS              TRUE
 /** @} */
 
@@ -129,6 +130,11 @@ extern "C" {
                      size_t n, const uint8_t *txbuf);
   void wspi_lld_receive(WSPIDriver *wspip, const wspi_command_t *cmdp,
                         size_t n, uint8_t *rxbuf);
+#if WSPI_SUPPORTS_POLLING == TRUE
+  void wspi_lld_poll(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                     size_t n, uint32_t mask, uint32_t match,
+                     uint8_t *rxbuf);
+#endif
 #if WSPI_SUPPORTS_MEMMAP == TRUE
   void wspi_lld_map_flash(WSPIDriver *wspip,
                           const wspi_command_t *cmdp,
@@ -68,6 +68,13 @@
 #define HAL_USE_DAC                         TRUE
 #endif
 
+/**
+ * @brief   Enables the EFlash subsystem.
+ */
+#if !defined(HAL_USE_EFL) || defined(__DOXYGEN__)
+#define HAL_USE_EFL                         TRUE
+#endif
+
 /**
  * @brief   Enables the EXT subsystem.
  */
@@ -117,6 +124,13 @@
 #define HAL_USE_MMC_SPI                     TRUE
 #endif
 
+/**
+ * @brief   Enables the PM subsystem.
+ */
+#if !defined(HAL_USE_PM) || defined(__DOXYGEN__)
+#define HAL_USE_PM                          FALSE
+#endif
+
 /**
  * @brief   Enables the PWM subsystem.
  */
@@ -187,6 +201,13 @@
 #define HAL_USE_USB                         TRUE
 #endif
 
+/**
+ * @brief   Enables the USBH subsystem.
+ */
+#if !defined(HAL_USE_USBH) || defined(__DOXYGEN__)
+#define HAL_USE_USBH                        FALSE
+#endif
+
 /**
  * @brief   Enables the WDG subsystem.
  */
@@ -221,6 +242,14 @@
 #define PAL_USE_WAIT                        FALSE
 #endif
 
+/**
+ * @brief   Enables the grouped events APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(PAL_USE_EVENT_GROUPS) || defined(__DOXYGEN__)
+#define PAL_USE_EVENT_GROUPS                FALSE
+#endif
+
 /*===========================================================================*/
 /* ADC driver related settings.                                              */
 /*===========================================================================*/
@@ -241,6 +270,14 @@
 #define ADC_USE_MUTUAL_EXCLUSION            TRUE
 #endif
 
+/**
+ * @brief   Enables the streaming to buffers queue APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(ADC_USE_STREAMING) || defined(__DOXYGEN__)
+#define ADC_USE_STREAMING                   FALSE
+#endif
+
 /*===========================================================================*/
 /* CAN driver related settings.                                              */
 /*===========================================================================*/
@@ -301,6 +338,14 @@
 #define DAC_USE_MUTUAL_EXCLUSION            TRUE
 #endif
 
+/**
+ * @brief   Enables the streaming from buffers queue APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(DAC_USE_STREAMING) || defined(__DOXYGEN__)
+#define DAC_USE_STREAMING                   FALSE
+#endif
+
 /*===========================================================================*/
 /* I2C driver related settings.                                              */
 /*===========================================================================*/
@@ -312,6 +357,26 @@
 #define I2C_USE_MUTUAL_EXCLUSION            TRUE
 #endif
 
+/**
+ * @brief   Enables the asynchronous transactions APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(I2C_USE_TRANSACTIONS) || defined(__DOXYGEN__)
+#define I2C_USE_TRANSACTIONS                FALSE
+#endif
+
+/*===========================================================================*/
+/* I2S driver related settings.                                              */
+/*===========================================================================*/
+
+/**
+ * @brief   Enables the streaming on buffers queues API.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(I2S_USE_STREAMING) || defined(__DOXYGEN__)
+#define I2S_USE_STREAMING                   FALSE
+#endif
+
 /*===========================================================================*/
 /* MAC driver related settings.                                              */
 /*===========================================================================*/
@@ -391,6 +456,20 @@
 #define SDC_INIT_OCR                        0x80100000U
 #endif
 
+/**
+ * @brief   Enables the asynchronous transfers API.
+ */
+#if !defined(SDC_USE_ASYNC_TRANSFERS) || defined(__DOXYGEN__)
+#define SDC_USE_ASYNC_TRANSFERS             FALSE
+#endif
+
+/**
+ * @brief   Enables the eMMC volatile cache.
+ */
+#if !defined(SDC_MMC_USE_CACHE) || defined(__DOXYGEN__)
+#define SDC_MMC_USE_CACHE                   FALSE
+#endif
+
 /*===========================================================================*/
 /* SERIAL driver related settings.                                           */
 /*===========================================================================*/
@@ -438,6 +517,18 @@
 #define SERIAL_USB_BUFFERS_NUMBER           2
 #endif
 
+/*===========================================================================*/
+/* SIO driver related settings.                                              */
+/*===========================================================================*/
+
+/**
+ * @brief   Enables synchronous APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(SIO_USE_SYNCHRONIZATION) || defined(__DOXYGEN__)
+#define SIO_USE_SYNCHRONIZATION             TRUE
+#endif
+
 /*===========================================================================*/
 /* SPI driver related settings.                                              */
 /*===========================================================================*/
@@ -458,6 +549,14 @@
 #define SPI_USE_CIRCULAR                    FALSE
 #endif
 
+/**
+ * @brief   Enables the transactions queue APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(SPI_USE_TRANSACTIONS) || defined(__DOXYGEN__)
+#define SPI_USE_TRANSACTIONS                FALSE
+#endif
+
 
 /**
  * @brief   Enables the @p spiAcquireBus() and @p spiReleaseBus() APIs.
@@ -475,6 +574,24 @@
 #define SPI_SELECT_MODE                     SPI_SELECT_MODE_PAD
 #endif
 
+/*===========================================================================*/
+/* TRNG driver related settings.                                             */
+/*===========================================================================*/
+
+/**
+ * @brief   Enables the DRBG stretching layer.
+ */
+#if !defined(TRNG_USE_DRBG) || defined(__DOXYGEN__)
+#define TRNG_USE_DRBG                       FALSE
+#endif
+
+/**
+ * @brief   DRBG reseed interval in bytes.
+ */
+#if !defined(TRNG_DRBG_RESEED_INTERVAL) || defined(__DOXYGEN__)
+#define TRNG_DRBG_RESEED_INTERVAL           1024
+#endif
+
 /*===========================================================================*/
 /* UART driver related settings.                                             */
 /*===========================================================================*/
@@ -495,6 +612,14 @@
 #define UART_USE_MUTUAL_EXCLUSION           TRUE
 #endif
 
+/**
+ * @brief   Enables the circular receive APIs.
+ * @note    The feature must be supported by the low level driver.
+ */
+#if !defined(UART_USE_RX_CIRCULAR) || defined(__DOXYGEN__)
+#define UART_USE_RX_CIRCULAR                FALSE
+#endif
+
 /*===========================================================================*/
 /* USB driver related settings.                                              */
 /*===========================================================================*/
@@ -507,6 +632,25 @@
 #define USB_USE_WAIT                        TRUE
 #endif
 
+/*===========================================================================*/
+/* USBH driver related settings.                                             */
+/*===========================================================================*/
+
+/**
+ * @brief   Configuration descriptor buffer size.
+ * @note    Must be a multiple of 64.
+ */
+#if !defined(USBH_CONFIG_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define USBH_CONFIG_BUFFER_SIZE             256
+#endif
+
+/**
+ * @brief   Timeout of control requests in milliseconds.
+ */
+#if !defined(USBH_CONTROL_TIMEOUT) || defined(__DOXYGEN__)
+#define USBH_CONTROL_TIMEOUT                500
+#endif
+
 /*===========================================================================*/
 /* WSPI driver related settings.                                             */
 /*===========================================================================*/
@@ -47,6 +47,17 @@
 #define CH_CFG_FACTORY_MAX_NAMES_LENGTH     8
 #endif
 
+/**
+ * @brief   Number of hash buckets of each objects list.
+ * @details If greater than zero then each list is indexed by an hash of
+ *          the object names and lookups do not scan the whole list, each
+ *          list costs one pointer per bucket.
+ * @note    The value must be zero or a power of two.
+ */
+#if !defined(CH_CFG_FACTORY_HASH_BUCKETS) || defined(__DOXYGEN__)
+#define CH_CFG_FACTORY_HASH_BUCKETS         0
+#endif
+
 /**
  * @brief   Enables the registry of generic objects.
  */
@@ -143,6 +154,11 @@
 #error "invalid CH_CFG_FACTORY_MAX_NAMES_LENGTH value"
 #endif
 
+#if (CH_CFG_FACTORY_HASH_BUCKETS < 0) ||                                    \
+    ((CH_CFG_FACTORY_HASH_BUCKETS & (CH_CFG_FACTORY_HASH_BUCKETS - 1)) != 0)
+#error "CH_CFG_FACTORY_HASH_BUCKETS must be zero or a power of two"
+#endif
+
 #if (CH_CFG_USE_MUTEXES == FALSE) && (CH_CFG_USE_SEMAPHORES == FALSE)
 #error "CH_CFG_USE_FACTORY requires CH_CFG_USE_MUTEXES and/or CH_CFG_USE_SEMAPHORES"
 #endif
@@ -186,7 +202,14 @@ typedef struct ch_dyn_element {
  * @brief   Type of a dynamic object list.
  */
 typedef struct ch_dyn_list {
+#if (CH_CFG_FACTORY_HASH_BUCKETS > 0) || defined(__DOXYGEN__)
+    /**
+     * @brief   Hash buckets, each one is a @p NULL terminated list.
+     */
+    dyn_element_t       *buckets[CH_CFG_FACTORY_HASH_BUCKETS];
+#else
     dyn_element_t       *next;
+#endif
 } dyn_list_t;
 
 #if (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) || defined(__DOXYGEN__)
@@ -0,0 +1,389 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chfsem.h
+ * @brief   Fast semaphores structures and macros.
+ * @details Fast semaphores related APIs and services.
+ *          <h2>Operation mode</h2>
+ *          Fast semaphores are counting semaphores whose counter is kept
+ *          outside the kernel, an uncontended wait or signal operation is
+ *          a single atomic decrement or increment of the counter and does
+ *          not enter a critical zone. The kernel is entered, using the
+ *          existing counting semaphores primitives, only when a thread
+ *          has to be queued or a queued thread has to be resumed.<br>
+ *          The atomic fast path requires exclusive load/store instructions
+ *          and is enabled on ARMv7-M and ARMv7E-M ports, on other
+ *          architectures fast semaphores fall back to regular semaphores
+ *          operations.
+ * @note    The fast path is only used from thread context, interrupt
+ *          handlers can use the I-class functions.
+ * @note    In order to use the fast semaphores APIs the
+ *          @p CH_CFG_USE_SEMAPHORES option must be enabled in @p chconf.h.
+ *
+ * @addtogroup oslib_fast_semaphores
+ * @{
+ */
+
+#ifndef CHFSEM_H
+#define CHFSEM_H
+
+#if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/**
+ * @brief   Atomic fast path availability.
+ */
+#if defined(PORT_ARCHITECTURE_ARM_v7M) ||                                   \
+    defined(PORT_ARCHITECTURE_ARM_v7ME) || defined(__DOXYGEN__)
+#define CH_FSEM_FAST_PATH                   TRUE
+#else
+#define CH_FSEM_FAST_PATH                   FALSE
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Fast semaphore type.
+ */
+typedef struct ch_fast_semaphore {
+  /**
+   * @brief   Fast semaphore counter.
+   * @note    A negative value represents the number of threads queued,
+   *          or being queued, on the semaphore.
+   */
+  volatile cnt_t        cnt;
+  /**
+   * @brief   Semaphore used for queuing the threads.
+   */
+  semaphore_t           sem;
+} fast_semaphore_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Data part of a static fast semaphore initializer.
+ * @details This macro should be used when statically initializing a fast
+ *          semaphore that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the fast semaphore variable
+ * @param[in] n         the counter initial value, this value must be
+ *                      non-negative
+ */
+#define _FSEMAPHORE_DATA(name, n)                                           \
+  {(cnt_t)(n), _SEMAPHORE_DATA(name.sem, 0)}
+
+/**
+ * @brief   Static fast semaphore initializer.
+ * @details Statically initialized fast semaphores require no explicit
+ *          initialization using @p chFSemObjectInit().
+ *
+ * @param[in] name      the name of the fast semaphore variable
+ * @param[in] n         the counter initial value, this value must be
+ *                      non-negative
+ */
+#define FSEMAPHORE_DECL(name, n)                                            \
+    fast_semaphore_t name = _FSEMAPHORE_DATA(name, n)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Atomic decrement of a positive counter.
+ *
+ * @param[in] fsp       pointer to a @p fast_semaphore_t structure
+ * @return              The operation status.
+ * @retval true         if the counter has been decremented.
+ * @retval false        if the counter is not positive, the slow path
+ *                      must be taken.
+ *
+ * @notapi
+ */
+static inline bool fsem_fast_wait(fast_semaphore_t *fsp) {
+#if CH_FSEM_FAST_PATH == TRUE
+  cnt_t cnt;
+
+  do {
+    cnt = (cnt_t)__LDREXW((volatile uint32_t *)&fsp->cnt);
+    if (cnt <= (cnt_t)0) {
+      __CLREX();
+      return false;
+    }
+  } while (__STREXW((uint32_t)(cnt - (cnt_t)1),
+                    (volatile uint32_t *)&fsp->cnt) != 0U);
+
+  return true;
+#else
+  (void)fsp;
+
+  return false;
+#endif
+}
+
+/**
+ * @brief   Atomic increment of a non-negative counter.
+ *
+ * @param[in] fsp       pointer to a @p fast_semaphore_t structure
+ * @return              The operation status.
+ * @retval true         if the counter has been incremented.
+ * @retval false        if there are queued threads, the slow path must
+ *                      be taken.
+ *
+ * @notapi
+ */
+static inline bool fsem_fast_signal(fast_semaphore_t *fsp) {
+#if CH_FSEM_FAST_PATH == TRUE
+  cnt_t cnt;
+
+  do {
+    cnt = (cnt_t)__LDREXW((volatile uint32_t *)&fsp->cnt);
+    if (cnt < (cnt_t)0) {
+      __CLREX();
+      return false;
+    }
+  } while (__STREXW((uint32_t)(cnt + (cnt_t)1),
+                    (volatile uint32_t *)&fsp->cnt) != 0U);
+
+  return true;
+#else
+  (void)fsp;
+
+  return false;
+#endif
+}
+
+/**
+ * @brief   Initializes a fast semaphore with the specified counter value.
+ *
+ * @param[out] fsp      pointer to a @p fast_semaphore_t structure
+ * @param[in] n         initial value of the semaphore counter. Must be
+ *                      non-negative.
+ *
+ * @init
+ */
+static inline void chFSemObjectInit(fast_semaphore_t *fsp, cnt_t n) {
+
+  chDbgCheck((fsp != NULL) && (n >= (cnt_t)0));
+
+  fsp->cnt = n;
+  chSemObjectInit(&fsp->sem, (cnt_t)0);
+}
+
+/**
+ * @brief   Performs a wait operation on a fast semaphore.
+ * @note    The counter is decremented in a critical zone, concurrent fast
+ *          path operations are retried because the exclusive monitor is
+ *          cleared by the context switch.
+ *
+ * @param[in] fsp       pointer to a @p fast_semaphore_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              A message specifying how the invoking thread has been
+ *                      released from the semaphore.
+ * @retval MSG_OK       if the thread has not stopped on the semaphore or the
+ *                      semaphore has been signaled.
+ * @retval MSG_TIMEOUT  if the semaphore has not been signaled within the
+ *                      specified timeout.
+ *
+ * @sclass
+ */
+static inline msg_t chFSemWaitTimeoutS(fast_semaphore_t *fsp,
+                                       sysinterval_t timeout) {
+  cnt_t cnt;
+  msg_t msg;
+
+  chDbgCheckClassS();
+
+  /* The thread is accounted as waiting, this disables the fast signal path
+     until a signal operation resumes it.*/
+  cnt = fsp->cnt;
+  fsp->cnt = cnt - (cnt_t)1;
+  if (cnt > (cnt_t)0) {
+    return MSG_OK;
+  }
+
+  if (TIME_IMMEDIATE == timeout) {
+    fsp->cnt++;
+    return MSG_TIMEOUT;
+  }
+
+  msg = chSemWaitTimeoutS(&fsp->sem, timeout);
+  if (msg == MSG_TIMEOUT) {
+    /* A signal operation could have arrived after the timeout but before
+       this thread was able to remove itself from the counter, in that case
+       the signal is consumed.*/
+    if (chSemGetCounterI(&fsp->sem) > (cnt_t)0) {
+      chSemFastWaitI(&fsp->sem);
+      msg = MSG_OK;
+    }
+    else {
+      fsp->cnt++;
+    }
+  }
+
+  return msg;
+}
+
+/**
+ * @brief   Performs a wait operation on a fast semaphore.
+ *
+ * @param[in] fsp       pointer to a @p fast_semaphore_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              A message specifying how the invoking thread has been
+ *                      released from the semaphore.
+ * @retval MSG_OK       if the thread has not stopped on the semaphore or the
+ *                      semaphore has been signaled.
+ * @retval MSG_TIMEOUT  if the semaphore has not been signaled within the
+ *                      specified timeout.
+ *
+ * @api
+ */
+static inline msg_t chFSemWaitTimeout(fast_semaphore_t *fsp,
+                                      sysinterval_t timeout) {
+  msg_t msg;
+
+  if (fsem_fast_wait(fsp)) {
+    return MSG_OK;
+  }
+
+  chSysLock();
+  msg = chFSemWaitTimeoutS(fsp, timeout);
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Performs a wait operation on a fast semaphore.
+ *
+ * @param[in] fsp       pointer to a @p fast_semaphore_t structure
+ * @return              A message specifying how the invoking thread has been
+ *                      released from the semaphore.
+ * @retval MSG_OK       if the thread has not stopped on the semaphore or the
+ *                      semaphore has been signaled.
+ *
+ * @sclass
+ */
+static inline msg_t chFSemWaitS(fast_semaphore_t *fsp) {
+
+  return chFSemWaitTimeoutS(fsp, TIME_INFINITE);
+}
+
+/**
+ * @brief   Performs a wait operation on a fast semaphore.
+ *
+ * @param[in] fsp       pointer to a @p fast_semaphore_t structure
+ * @return              A message specifying how the invoking thread has been
+ *                      released from the semaphore.
+ * @retval MSG_OK       if the thread has not stopped on the semaphore or the
+ *                      semaphore has been signaled.
+ *
+ * @api
+ */
+static inline msg_t chFSemWait(fast_semaphore_t *fsp) {
+
+  return chFSemWaitTimeout(fsp, TIME_INFINITE);
+}
+
+/**
+ * @brief   Performs a signal operation on a fast semaphore.
+ * @note    This function does not reschedule.
+ *
+ * @param[in] fsp       pointer to a @p fast_semaphore_t structure
+ *
+ * @iclass
+ */
+static inline void chFSemSignalI(fast_semaphore_t *fsp) {
+  cnt_t cnt;
+
+  chDbgCheckClassI();
+
+  cnt = fsp->cnt;
+  fsp->cnt = cnt + (cnt_t)1;
+  if (cnt < (cnt_t)0) {
+    chSemSignalI(&fsp->sem);
+  }
+}
+
+/**
+ * @brief   Performs a signal operation on a fast semaphore.
+ *
+ * @param[in] fsp       pointer to a @p fast_semaphore_t structure
+ *
+ * @api
+ */
+static inline void chFSemSignal(fast_semaphore_t *fsp) {
+
+  if (fsem_fast_signal(fsp)) {
+    return;
+  }
+
+  chSysLock();
+  chFSemSignalI(fsp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Returns the fast semaphore counter current value.
+ *
+ * @param[in] fsp       pointer to a @p fast_semaphore_t structure
+ * @return              The semaphore counter value.
+ *
+ * @iclass
+ */
+static inline cnt_t chFSemGetCounterI(const fast_semaphore_t *fsp) {
+
+  chDbgCheckClassI();
+
+  return fsp->cnt;
+}
+
+#endif /* CH_CFG_USE_SEMAPHORES == TRUE */
+
+#endif /* CHFSEM_H */
+
+/** @} */
@@ -74,6 +74,41 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Ring buffers APIs.
+ * @note    Configurations not defining this option have ring buffers
+ *          disabled.
+ */
+#if !defined(CH_CFG_USE_RING_BUFFERS) || defined(__DOXYGEN__)
+#define CH_CFG_USE_RING_BUFFERS             FALSE
+#endif
+
+/**
+ * @brief   Priority objects FIFOs APIs.
+ * @note    Configurations not defining this option have priority objects
+ *          FIFOs disabled.
+ */
+#if !defined(CH_CFG_USE_OBJ_PFIFOS) || defined(__DOXYGEN__)
+#define CH_CFG_USE_OBJ_PFIFOS               FALSE
+#endif
+
+/**
+ * @brief   Topics bus APIs.
+ * @note    Configurations not defining this option have topics disabled.
+ */
+#if !defined(CH_CFG_USE_TOPICS) || defined(__DOXYGEN__)
+#define CH_CFG_USE_TOPICS                   FALSE
+#endif
+
+/**
+ * @brief   Watchdog monitor APIs.
+ * @note    Configurations not defining this option have the watchdog
+ *          monitor disabled.
+ */
+#if !defined(CH_CFG_USE_WATCHDOG) || defined(__DOXYGEN__)
+#define CH_CFG_USE_WATCHDOG                 FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -176,12 +211,20 @@
 #undef CH_CFG_USE_MEMPOOLS
 #undef CH_CFG_USE_OBJ_FIFOS
 #undef CH_CFG_USE_PIPES
+#undef CH_CFG_USE_RING_BUFFERS
+#undef CH_CFG_USE_OBJ_PFIFOS
+#undef CH_CFG_USE_TOPICS
+#undef CH_CFG_USE_WATCHDOG
 
 #define CH_CFG_USE_MEMCORE                  FALSE
 #define CH_CFG_USE_HEAP                     FALSE
 #define CH_CFG_USE_MEMPOOLS                 FALSE
 #define CH_CFG_USE_OBJ_FIFOS                FALSE
 #define CH_CFG_USE_PIPES                    FALSE
+#define CH_CFG_USE_RING_BUFFERS             FALSE
+#define CH_CFG_USE_OBJ_PFIFOS               FALSE
+#define CH_CFG_USE_TOPICS                   FALSE
+#define CH_CFG_USE_WATCHDOG                 FALSE
 
 #endif /* (CH_CUSTOMER_LIC_OSLIB == FALSE) ||
           (CH_LICENSE_FEATURES == CH_FEATURES_BASIC) */
@@ -204,12 +247,17 @@
 
 /* OS Library headers.*/
 #include "chbsem.h"
+#include "chfsem.h"
 #include "chmboxes.h"
 #include "chmemcore.h"
 #include "chmemheaps.h"
 #include "chmempools.h"
 #include "chobjfifos.h"
+#include "chobjpfifos.h"
 #include "chpipes.h"
+#include "chringbuffers.h"
+#include "chtopics.h"
+#include "chwatchdog.h"
 #include "chfactory.h"
 
 #endif /* CHLIB_H */
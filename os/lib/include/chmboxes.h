@@ -38,6 +38,11 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/* Multiple objects wait is not available under NIL.*/
+#if !defined(CH_CFG_USE_WAIT_MULTIPLE)
+#define CH_CFG_USE_WAIT_MULTIPLE            FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -60,6 +65,11 @@ typedef struct {
   bool                  reset;          /**< @brief True in reset state.    */
   threads_queue_t       qw;             /**< @brief Queued writers.         */
   threads_queue_t       qr;             /**< @brief Queued readers.         */
+#if (CH_CFG_USE_WAIT_MULTIPLE == TRUE) || defined(__DOXYGEN__)
+  wait_list_t           waiters;        /**< @brief Wait objects of the
+                                                    threads waiting on
+                                                    multiple objects.       */
+#endif
 } mailbox_t;
 
 /*===========================================================================*/
@@ -75,6 +85,19 @@ typedef struct {
  * @param[in] buffer    pointer to the mailbox buffer array of @p msg_t
  * @param[in] size      number of @p msg_t elements in the buffer array
  */
+#if (CH_CFG_USE_WAIT_MULTIPLE == TRUE) || defined(__DOXYGEN__)
+#define _MAILBOX_DATA(name, buffer, size) {                                 \
+  (msg_t *)(buffer),                                                        \
+  (msg_t *)(buffer) + size,                                                 \
+  (msg_t *)(buffer),                                                        \
+  (msg_t *)(buffer),                                                        \
+  (size_t)0,                                                                \
+  false,                                                                    \
+  _THREADS_QUEUE_DATA(name.qw),                                             \
+  _THREADS_QUEUE_DATA(name.qr),                                             \
+  _WAIT_LIST_DATA(name.waiters)                                             \
+}
+#else
 #define _MAILBOX_DATA(name, buffer, size) {                                 \
   (msg_t *)(buffer),                                                        \
   (msg_t *)(buffer) + size,                                                 \
@@ -85,6 +108,7 @@ typedef struct {
   _THREADS_QUEUE_DATA(name.qw),                                             \
   _THREADS_QUEUE_DATA(name.qr),                                             \
 }
+#endif
 
 /**
  * @brief   Static mailbox initializer.
@@ -117,6 +141,16 @@ extern "C" {
   msg_t chMBFetchTimeout(mailbox_t *mbp, msg_t *msgp, sysinterval_t timeout);
   msg_t chMBFetchTimeoutS(mailbox_t *mbp, msg_t *msgp, sysinterval_t timeout);
   msg_t chMBFetchI(mailbox_t *mbp, msg_t *msgp);
+  size_t chMBPostArrayTimeout(mailbox_t *mbp, const msg_t *msgp,
+                              size_t n, sysinterval_t timeout);
+  size_t chMBPostArrayTimeoutS(mailbox_t *mbp, const msg_t *msgp,
+                               size_t n, sysinterval_t timeout);
+  size_t chMBPostArrayI(mailbox_t *mbp, const msg_t *msgp, size_t n);
+  size_t chMBFetchArrayTimeout(mailbox_t *mbp, msg_t *msgp,
+                               size_t n, sysinterval_t timeout);
+  size_t chMBFetchArrayTimeoutS(mailbox_t *mbp, msg_t *msgp,
+                                size_t n, sysinterval_t timeout);
+  size_t chMBFetchArrayI(mailbox_t *mbp, msg_t *msgp, size_t n);
 #ifdef __cplusplus
 }
 #endif
@@ -34,6 +34,32 @@
 /* Module constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @name    Memory region attributes
+ * @{
+ */
+/**
+ * @brief   No specific requirement.
+ */
+#define CH_MEM_ATTR_NONE                    0U
+/**
+ * @brief   Fast memory, zero wait states or tightly coupled.
+ */
+#define CH_MEM_ATTR_FAST                    1U
+/**
+ * @brief   Memory accessible by the DMA controllers.
+ */
+#define CH_MEM_ATTR_DMA                     2U
+/**
+ * @brief   Memory not cached by the data cache.
+ */
+#define CH_MEM_ATTR_NOCACHE                 4U
+/**
+ * @brief   Large memory, meant for big buffers.
+ */
+#define CH_MEM_ATTR_LARGE                   8U
+/** @} */
+
 /*===========================================================================*/
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -53,6 +79,33 @@
 #define CH_CFG_MEMCORE_SIZE                 0
 #endif
 
+/**
+ * @brief   Number of additional memory regions.
+ * @details Regions are further core allocators over memory areas with
+ *          specific attributes, for example tightly coupled RAM, DMA
+ *          capable SRAM or external SDRAM. Regions are initialized by the
+ *          application using @p chCoreRegionInit().
+ *
+ * @note    The default is zero, only the main core memory is managed.
+ * @note    Requires @p CH_CFG_USE_MEMCORE.
+ */
+#if !defined(CH_CFG_MEMCORE_REGIONS) || defined(__DOXYGEN__)
+#define CH_CFG_MEMCORE_REGIONS              0
+#endif
+
+/**
+ * @brief   Attributes of the main core memory.
+ * @details The main core memory is used as last resort by
+ *          @p chCoreAllocFromRegions() when it satisfies all the requested
+ *          attributes.
+ *
+ * @note    The default is @p CH_MEM_ATTR_NONE.
+ * @note    Requires @p CH_CFG_USE_MEMCORE.
+ */
+#if !defined(CH_CFG_MEMCORE_ATTRS) || defined(__DOXYGEN__)
+#define CH_CFG_MEMCORE_ATTRS                CH_MEM_ATTR_NONE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -61,6 +114,10 @@
 #error "invalid CH_CFG_MEMCORE_SIZE value specified"
 #endif
 
+#if (CH_CFG_MEMCORE_REGIONS < 0) || (CH_CFG_MEMCORE_REGIONS > 16)
+#error "invalid CH_CFG_MEMCORE_REGIONS value specified"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -89,6 +146,53 @@ typedef struct {
   uint8_t *endmem;
 } memcore_t;
 
+/**
+ * @brief   Type of memory attributes mask.
+ */
+typedef uint32_t memattr_t;
+
+/**
+ * @brief   Type of a memory region object.
+ */
+typedef struct {
+  /**
+   * @brief   Region allocator.
+   */
+  memcore_t core;
+  /**
+   * @brief   Region attributes.
+   */
+  memattr_t attrs;
+} memregion_t;
+
+/**
+ * @brief   Type of a memory arena object.
+ * @details An arena is a bump allocator over a memory region, blocks are
+ *          not freed one by one, the whole arena or the blocks allocated
+ *          after a mark are released at once.
+ * @note    Arenas are not protected by any lock, an arena is meant to be
+ *          used by a single thread.
+ */
+typedef struct {
+  /**
+   * @brief   Base address.
+   */
+  uint8_t *basemem;
+  /**
+   * @brief   Next free address.
+   */
+  uint8_t *nextmem;
+  /**
+   * @brief   Final address.
+   */
+  uint8_t *endmem;
+} memory_arena_t;
+
+/**
+ * @brief   Type of an arena mark.
+ */
+typedef uint8_t *arena_mark_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -99,6 +203,9 @@ typedef struct {
 
 #if !defined(__DOXYGEN__)
 extern memcore_t ch_memcore;
+#if CH_CFG_MEMCORE_REGIONS > 0
+extern memregion_t ch_memregions[CH_CFG_MEMCORE_REGIONS];
+#endif
 #endif
 
 #ifdef __cplusplus
@@ -112,6 +219,19 @@ extern "C" {
                                      unsigned align,
                                      size_t offset);
   size_t chCoreGetStatusX(void);
+#if (CH_CFG_MEMCORE_REGIONS > 0) || defined(__DOXYGEN__)
+  void chCoreRegionInit(unsigned n, void *base, size_t size, memattr_t attrs);
+  size_t chCoreRegionGetStatusX(unsigned n);
+#endif
+  void *chCoreAllocFromRegionsI(size_t size, unsigned align, memattr_t attrs);
+  void *chCoreAllocFromRegions(size_t size, unsigned align, memattr_t attrs);
+  void chArenaObjectInit(memory_arena_t *map, void *buf, size_t size);
+  bool chArenaObjectInitFromCore(memory_arena_t *map, size_t size);
+  bool chArenaObjectInitFromArena(memory_arena_t *map,
+                                  memory_arena_t *parentp,
+                                  size_t size);
+  void *chArenaAllocAlignedX(memory_arena_t *map, size_t size,
+                             unsigned align);
 #ifdef __cplusplus
 }
 #endif
@@ -191,6 +311,78 @@ static inline void *chCoreAlloc(size_t size) {
   return chCoreAllocAlignedWithOffset(size, PORT_NATURAL_ALIGN, 0U);
 }
 
+/**
+ * @brief   Allocates a memory block from an arena.
+ * @details The allocated block is guaranteed to be properly aligned for a
+ *          pointer data type.
+ *
+ * @param[in] map       pointer to a @p memory_arena_t structure
+ * @param[in] size      the size of the block to be allocated.
+ * @return              A pointer to the allocated memory block.
+ * @retval NULL         allocation failed, arena exhausted.
+ *
+ * @xclass
+ */
+static inline void *chArenaAllocX(memory_arena_t *map, size_t size) {
+
+  return chArenaAllocAlignedX(map, size, PORT_NATURAL_ALIGN);
+}
+
+/**
+ * @brief   Returns a mark of the current arena allocation point.
+ *
+ * @param[in] map       pointer to a @p memory_arena_t structure
+ * @return              The arena mark.
+ *
+ * @xclass
+ */
+static inline arena_mark_t chArenaGetMarkX(const memory_arena_t *map) {
+
+  return map->nextmem;
+}
+
+/**
+ * @brief   Releases all the blocks allocated after a mark.
+ *
+ * @param[in] map       pointer to a @p memory_arena_t structure
+ * @param[in] mark      mark previously returned by @p chArenaGetMarkX()
+ *
+ * @xclass
+ */
+static inline void chArenaRewindX(memory_arena_t *map, arena_mark_t mark) {
+
+  chDbgCheck((mark >= map->basemem) && (mark <= map->nextmem));
+
+  map->nextmem = mark;
+}
+
+/**
+ * @brief   Releases all the blocks allocated from an arena.
+ *
+ * @param[in] map       pointer to a @p memory_arena_t structure
+ *
+ * @xclass
+ */
+static inline void chArenaResetX(memory_arena_t *map) {
+
+  map->nextmem = map->basemem;
+}
+
+/**
+ * @brief   Arena status.
+ *
+ * @param[in] map       pointer to a @p memory_arena_t structure
+ * @return              The size, in bytes, of the free arena memory.
+ *
+ * @xclass
+ */
+static inline size_t chArenaGetStatusX(const memory_arena_t *map) {
+
+  /*lint -save -e9033 [10.8] The cast is safe.*/
+  return (size_t)(map->endmem - map->nextmem);
+  /*lint -restore*/
+}
+
 #endif /* CH_CFG_USE_MEMCORE == TRUE */
 
 #endif /* CHMEMCORE_H */
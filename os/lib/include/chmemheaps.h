@@ -38,7 +38,9 @@
  * @brief   Minimum alignment used for heap.
  * @note    Cannot use the sizeof operator in this macro.
  */
-#if (SIZEOF_PTR == 4) || defined(__DOXYGEN__)
+#if (SIZEOF_PTR == 8)
+#define CH_HEAP_ALIGNMENT   16U
+#elif (SIZEOF_PTR == 4) || defined(__DOXYGEN__)
 #define CH_HEAP_ALIGNMENT   8U
 #elif (SIZEOF_PTR == 2)
 #define CH_HEAP_ALIGNMENT   4U
@@ -50,6 +52,73 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   TLSF heap allocator.
+ * @details If enabled the heap uses a Two-Level Segregated Fit allocator
+ *          with constant time allocation and release, else the classic
+ *          first-fit allocator is used.
+ * @note    The TLSF block header is four pointer-sized words instead of
+ *          two, each allocation takes 16 bytes of overhead on 32 bits
+ *          architectures and 32 bytes on 64 bits architectures. The
+ *          smallest block is an header plus @p CH_HEAP_ALIGNMENT bytes.
+ */
+#if !defined(CH_CFG_HEAP_ALGORITHM_TLSF) || defined(__DOXYGEN__)
+#define CH_CFG_HEAP_ALGORITHM_TLSF          FALSE
+#endif
+
+/**
+ * @brief   Number of TLSF second level lists as a power of two.
+ * @details Each first level class is split in this number of sub-classes,
+ *          higher values reduce the internal fragmentation at the cost of
+ *          a larger heap descriptor.
+ */
+#if !defined(CH_CFG_HEAP_TLSF_SL_LOG2) || defined(__DOXYGEN__)
+#define CH_CFG_HEAP_TLSF_SL_LOG2            3
+#endif
+
+/**
+ * @brief   Number of TLSF first level classes.
+ * @details Free blocks up to 2^(@p CH_CFG_HEAP_TLSF_FL_COUNT +
+ *          @p CH_CFG_HEAP_TLSF_SL_LOG2 - 1) allocation units are indexed
+ *          exactly, larger blocks are all kept in the last list.
+ */
+#if !defined(CH_CFG_HEAP_TLSF_FL_COUNT) || defined(__DOXYGEN__)
+#define CH_CFG_HEAP_TLSF_FL_COUNT           16
+#endif
+
+/**
+ * @brief   Slab front-end for the default heap.
+ * @details If enabled small allocations from the default heap with the
+ *          default alignment are served by per-size-class memory pools,
+ *          the pools are refilled from the heap one page at time.
+ */
+#if !defined(CH_CFG_HEAP_SLAB) || defined(__DOXYGEN__)
+#define CH_CFG_HEAP_SLAB                    FALSE
+#endif
+
+/**
+ * @brief   Size of the smallest slab class.
+ * @note    Must be a power of two not smaller than @p CH_HEAP_ALIGNMENT.
+ */
+#if !defined(CH_CFG_HEAP_SLAB_MIN_SIZE) || defined(__DOXYGEN__)
+#define CH_CFG_HEAP_SLAB_MIN_SIZE           32
+#endif
+
+/**
+ * @brief   Number of slab classes.
+ * @details Each class doubles the size of the previous one.
+ */
+#if !defined(CH_CFG_HEAP_SLAB_CLASSES) || defined(__DOXYGEN__)
+#define CH_CFG_HEAP_SLAB_CLASSES            4
+#endif
+
+/**
+ * @brief   Size of the pages used to refill the slab classes.
+ */
+#if !defined(CH_CFG_HEAP_SLAB_PAGE_SIZE) || defined(__DOXYGEN__)
+#define CH_CFG_HEAP_SLAB_PAGE_SIZE          1024
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -62,6 +131,60 @@
 #error "CH_CFG_USE_HEAP requires CH_CFG_USE_MUTEXES and/or CH_CFG_USE_SEMAPHORES"
 #endif
 
+#if (CH_CFG_HEAP_ALGORITHM_TLSF == TRUE) || defined(__DOXYGEN__)
+#if (CH_CFG_HEAP_TLSF_SL_LOG2 < 1) || (CH_CFG_HEAP_TLSF_SL_LOG2 > 5)
+#error "invalid CH_CFG_HEAP_TLSF_SL_LOG2 value specified"
+#endif
+
+#if (CH_CFG_HEAP_TLSF_FL_COUNT < 2) ||                                      \
+    ((CH_CFG_HEAP_TLSF_FL_COUNT + CH_CFG_HEAP_TLSF_SL_LOG2) > 32)
+#error "invalid CH_CFG_HEAP_TLSF_FL_COUNT value specified"
+#endif
+
+/**
+ * @brief   Number of TLSF second level lists.
+ */
+#define CH_HEAP_TLSF_SL_COUNT   (1U << CH_CFG_HEAP_TLSF_SL_LOG2)
+#endif /* CH_CFG_HEAP_ALGORITHM_TLSF == TRUE */
+
+/**
+ * @brief   Mask of the size field of the blocks headers.
+ * @details The first-fit allocator keeps its boundary tag flags in the two
+ *          upper bits of the size field, allocations are limited to a
+ *          quarter of the address space.
+ */
+#if (CH_CFG_HEAP_ALGORITHM_TLSF == FALSE) || defined(__DOXYGEN__)
+#define CH_HEAP_SIZE_MASK       (~(size_t)0 >> 2)
+#else
+#define CH_HEAP_SIZE_MASK       (~(size_t)0)
+#endif
+
+#if (CH_CFG_HEAP_SLAB == TRUE) || defined(__DOXYGEN__)
+#if CH_CFG_USE_MEMPOOLS == FALSE
+#error "CH_CFG_HEAP_SLAB requires CH_CFG_USE_MEMPOOLS"
+#endif
+
+#if (CH_CFG_HEAP_SLAB_MIN_SIZE < CH_HEAP_ALIGNMENT) ||                      \
+    ((CH_CFG_HEAP_SLAB_MIN_SIZE & (CH_CFG_HEAP_SLAB_MIN_SIZE - 1)) != 0)
+#error "invalid CH_CFG_HEAP_SLAB_MIN_SIZE value specified"
+#endif
+
+#if (CH_CFG_HEAP_SLAB_CLASSES < 1) || (CH_CFG_HEAP_SLAB_CLASSES > 8)
+#error "invalid CH_CFG_HEAP_SLAB_CLASSES value specified"
+#endif
+
+/**
+ * @brief   Size of the largest slab class.
+ */
+#define CH_HEAP_SLAB_MAX_SIZE                                               \
+  ((size_t)CH_CFG_HEAP_SLAB_MIN_SIZE << (CH_CFG_HEAP_SLAB_CLASSES - 1))
+
+#if CH_CFG_HEAP_SLAB_PAGE_SIZE < ((CH_CFG_HEAP_SLAB_MIN_SIZE <<             \
+                                   (CH_CFG_HEAP_SLAB_CLASSES - 1)) * 2)
+#error "CH_CFG_HEAP_SLAB_PAGE_SIZE too small for the largest slab class"
+#endif
+#endif /* CH_CFG_HEAP_SLAB == TRUE */
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -76,19 +199,51 @@ typedef struct memory_heap memory_heap_t;
  */
 typedef union heap_header heap_header_t;
 
+#if (CH_CFG_HEAP_ALGORITHM_TLSF == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Memory heap block header.
+ * @note    The free blocks also have a footer, the last word of their area
+ *          is a copy of the @p pages field and the first word of the area
+ *          links the previous block in the free list.
+ */
+union heap_header {
+  struct {
+    heap_header_t       *next;      /**< @brief Next block in free list.    */
+    size_t              pages;      /**< @brief Size of the area in pages,
+                                                upper bit is the free
+                                                flag.                       */
+  } free;
+  struct {
+    memory_heap_t       *heap;      /**< @brief Block owner heap.           */
+    size_t              size;       /**< @brief Size of the area in bytes,
+                                                the bit below the upper one
+                                                flags a free previous
+                                                block.                      */
+  } used;
+};
+#else /* CH_CFG_HEAP_ALGORITHM_TLSF == TRUE */
 /**
  * @brief   Memory heap block header.
+ * @note    The first two fields are common to free and used blocks.
  */
 union heap_header {
   struct {
+    heap_header_t       *phys;      /**< @brief Physically previous block.  */
+    size_t              bsize;      /**< @brief Size of the area in bytes,
+                                                bit zero is the free flag.  */
     heap_header_t       *next;      /**< @brief Next block in free list.    */
-    size_t              pages;      /**< @brief Size of the area in pages.  */
+    heap_header_t       *prev;      /**< @brief Previous block in free
+                                                list.                       */
   } free;
   struct {
+    heap_header_t       *phys;      /**< @brief Physically previous block.  */
+    size_t              bsize;      /**< @brief Size of the area in bytes,
+                                                bit zero is the free flag.  */
     memory_heap_t       *heap;      /**< @brief Block owner heap.           */
-    size_t              size;       /**< @brief Size of the area in bytes.  */
+    size_t              size;       /**< @brief Requested size in bytes.    */
   } used;
 };
+#endif /* CH_CFG_HEAP_ALGORITHM_TLSF == TRUE */
 
 /**
  * @brief   Structure describing a memory heap.
@@ -96,7 +251,18 @@ union heap_header {
 struct memory_heap {
   memgetfunc2_t         provider;   /**< @brief Memory blocks provider for
                                                 this heap.                  */
+#if (CH_CFG_HEAP_ALGORITHM_TLSF == FALSE) || defined(__DOXYGEN__)
   heap_header_t         header;     /**< @brief Free blocks list header.    */
+#else
+  uint32_t              fl_bitmap;  /**< @brief Non-empty first level
+                                                classes.                    */
+  uint32_t              sl_bitmap[CH_CFG_HEAP_TLSF_FL_COUNT];
+                                    /**< @brief Non-empty second level
+                                                lists of each class.        */
+  heap_header_t         *lists[CH_CFG_HEAP_TLSF_FL_COUNT]
+                              [CH_HEAP_TLSF_SL_COUNT];
+                                    /**< @brief Free blocks lists.          */
+#endif
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   mutex_t               mtx;        /**< @brief Heap access mutex.          */
 #else
@@ -126,7 +292,11 @@ extern "C" {
   void chHeapObjectInit(memory_heap_t *heapp, void *buf, size_t size);
   void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align);
   void chHeapFree(void *p);
+  void *chHeapRealloc(void *p, size_t size);
   size_t chHeapStatus(memory_heap_t *heapp, size_t *totalp, size_t *largestp);
+#if CH_CFG_HEAP_SLAB == TRUE
+  size_t chHeapSlabStatus(unsigned n, ucnt_t *hitsp, ucnt_t *missesp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -168,7 +338,7 @@ static inline void *chHeapAlloc(memory_heap_t *heapp, size_t size) {
  */
 static inline size_t chHeapGetSize(const void *p) {
 
-  return ((heap_header_t *)p - 1U)->used.size;
+  return ((heap_header_t *)p - 1U)->used.size & CH_HEAP_SIZE_MASK;
 }
 
 #endif /* CH_CFG_USE_HEAP == TRUE */
@@ -38,6 +38,17 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Lock-free memory pools.
+ * @details If enabled the pools free list is handled using exclusive
+ *          load/store instructions, objects allocation and release never
+ *          enter a critical zone except when the pool provider is invoked.
+ * @note    Requires an ARMv7-M or ARMv7E-M port.
+ */
+#if !defined(CH_CFG_POOL_LOCKFREE) || defined(__DOXYGEN__)
+#define CH_CFG_POOL_LOCKFREE                FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -46,6 +57,11 @@
 #error "CH_CFG_USE_MEMPOOLS requires CH_CFG_USE_MEMCORE"
 #endif
 
+#if (CH_CFG_POOL_LOCKFREE == TRUE) &&                                       \
+    !defined(PORT_ARCHITECTURE_ARM_v7M) && !defined(PORT_ARCHITECTURE_ARM_v7ME)
+#error "CH_CFG_POOL_LOCKFREE requires an ARMv7-M or ARMv7E-M port"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -79,6 +95,21 @@ typedef struct {
                                                     the memory pool.        */
   memory_pool_t         pool;           /**< @brief The memory pool itself. */
 } guarded_memory_pool_t;
+
+/**
+ * @brief   Guarded memory pool magazine descriptor.
+ * @details A magazine is a cache of free objects owned by a single thread,
+ *          objects are moved from and to the guarded memory pool in groups
+ *          of half the magazine capacity.
+ * @note    Magazines are not protected by any lock, each magazine must be
+ *          used by a single thread.
+ */
+typedef struct {
+  guarded_memory_pool_t *gmp;           /**< @brief Backing guarded pool.   */
+  struct pool_header    *next;          /**< @brief Cached objects list.    */
+  size_t                cnt;            /**< @brief Cached objects.         */
+  size_t                size;           /**< @brief Magazine capacity.      */
+} pool_magazine_t;
 #endif /* CH_CFG_USE_SEMAPHORES == TRUE */
 
 /*===========================================================================*/
@@ -164,6 +195,12 @@ extern "C" {
   void *chGuardedPoolAllocTimeout(guarded_memory_pool_t *gmp,
                                   sysinterval_t timeout);
   void chGuardedPoolFree(guarded_memory_pool_t *gmp, void *objp);
+  void chMagazineObjectInit(pool_magazine_t *mgp,
+                            guarded_memory_pool_t *gmp,
+                            size_t size);
+  void *chMagazineAllocTimeout(pool_magazine_t *mgp, sysinterval_t timeout);
+  void chMagazineFree(pool_magazine_t *mgp, void *objp);
+  void chMagazineFlush(pool_magazine_t *mgp);
 #endif
 #ifdef __cplusplus
 }
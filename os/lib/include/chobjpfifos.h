@@ -0,0 +1,262 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chobjpfifos.h
+ * @brief   Priority objects FIFO structures and macros.
+ * @details This module implements a FIFO queue of objects ordered by key
+ *          by coupling a Guarded Memory Pool (for objects storage) and
+ *          a binary heap of object references.<br>
+ *          Operations are the same defined for objects FIFOs except that
+ *          each sent object is tagged by a key, the receiver always gets
+ *          the object with the lowest key, objects with the same key are
+ *          received in the order they have been sent.
+ *
+ * @addtogroup oslib_prio_objects_fifos
+ * @{
+ */
+
+#ifndef CHOBJPFIFOS_H
+#define CHOBJPFIFOS_H
+
+#if (CH_CFG_USE_OBJ_PFIFOS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CH_CFG_USE_MEMPOOLS == FALSE
+#error "CH_CFG_USE_OBJ_PFIFOS requires CH_CFG_USE_MEMPOOLS"
+#endif
+
+#if CH_CFG_USE_SEMAPHORES == FALSE
+#error "CH_CFG_USE_OBJ_PFIFOS requires CH_CFG_USE_SEMAPHORES"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of an object key.
+ * @details Lower keys are more urgent. Keys are compared using serial
+ *          numbers arithmetic so absolute deadlines on a 32 bits free
+ *          running time base are handled across the wrap, all the keys
+ *          in the FIFO must lie within half of the keys range.
+ */
+typedef uint32_t pfifokey_t;
+
+/**
+ * @brief   Type of a heap slot.
+ */
+typedef struct {
+  void                      *objp;      /**< @brief Sent object.            */
+  pfifokey_t                key;        /**< @brief Object key.             */
+  uint32_t                  seq;        /**< @brief Send order.             */
+} pfifo_slot_t;
+
+/**
+ * @brief   Type of a priority objects FIFO.
+ */
+typedef struct ch_prio_objects_fifo {
+  /**
+   * @brief   Pool of the free objects.
+   */
+  guarded_memory_pool_t     free;
+  /**
+   * @brief   Heap of the sent objects.
+   */
+  pfifo_slot_t              *heap;
+  /**
+   * @brief   Number of heap slots.
+   */
+  size_t                    size;
+  /**
+   * @brief   Number of objects in the heap.
+   */
+  size_t                    cnt;
+  /**
+   * @brief   Send order counter.
+   */
+  uint32_t                  seq;
+  /**
+   * @brief   Queued receivers.
+   */
+  threads_queue_t           qr;
+} prio_objects_fifo_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chPFifoObjectInit(prio_objects_fifo_t *pfp, size_t objsize,
+                         size_t objn, unsigned objalign,
+                         void *objbuf, pfifo_slot_t *slotbuf);
+  void chPFifoSendObjectI(prio_objects_fifo_t *pfp,
+                          void *objp, pfifokey_t key);
+  void chPFifoSendObjectS(prio_objects_fifo_t *pfp,
+                          void *objp, pfifokey_t key);
+  void chPFifoSendObject(prio_objects_fifo_t *pfp,
+                         void *objp, pfifokey_t key);
+  msg_t chPFifoReceiveObjectI(prio_objects_fifo_t *pfp, void **objpp);
+  msg_t chPFifoReceiveObjectTimeoutS(prio_objects_fifo_t *pfp,
+                                     void **objpp, sysinterval_t timeout);
+  msg_t chPFifoReceiveObjectTimeout(prio_objects_fifo_t *pfp,
+                                    void **objpp, sysinterval_t timeout);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the number of objects waiting to be received.
+ *
+ * @param[in] pfp       pointer to a @p prio_objects_fifo_t structure
+ * @return              The number of sent objects.
+ *
+ * @iclass
+ */
+static inline size_t chPFifoGetUsedCountI(const prio_objects_fifo_t *pfp) {
+
+  chDbgCheckClassI();
+
+  return pfp->cnt;
+}
+
+/**
+ * @brief   Allocates a free object.
+ *
+ * @param[in] pfp       pointer to a @p prio_objects_fifo_t structure
+ * @return              The pointer to the allocated object.
+ * @retval NULL         if an object is not immediately available.
+ *
+ * @iclass
+ */
+static inline void *chPFifoTakeObjectI(prio_objects_fifo_t *pfp) {
+
+  return chGuardedPoolAllocI(&pfp->free);
+}
+
+/**
+ * @brief   Allocates a free object.
+ *
+ * @param[in] pfp       pointer to a @p prio_objects_fifo_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The pointer to the allocated object.
+ * @retval NULL         if an object is not available within the specified
+ *                      timeout.
+ *
+ * @sclass
+ */
+static inline void *chPFifoTakeObjectTimeoutS(prio_objects_fifo_t *pfp,
+                                              sysinterval_t timeout) {
+
+  return chGuardedPoolAllocTimeoutS(&pfp->free, timeout);
+}
+
+/**
+ * @brief   Allocates a free object.
+ *
+ * @param[in] pfp       pointer to a @p prio_objects_fifo_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The pointer to the allocated object.
+ * @retval NULL         if an object is not available within the specified
+ *                      timeout.
+ *
+ * @api
+ */
+static inline void *chPFifoTakeObjectTimeout(prio_objects_fifo_t *pfp,
+                                             sysinterval_t timeout) {
+
+  return chGuardedPoolAllocTimeout(&pfp->free, timeout);
+}
+
+/**
+ * @brief   Releases a fetched object.
+ *
+ * @param[in] pfp       pointer to a @p prio_objects_fifo_t structure
+ * @param[in] objp      pointer to the object to be released
+ *
+ * @iclass
+ */
+static inline void chPFifoReturnObjectI(prio_objects_fifo_t *pfp,
+                                        void *objp) {
+
+  chGuardedPoolFreeI(&pfp->free, objp);
+}
+
+/**
+ * @brief   Releases a fetched object.
+ *
+ * @param[in] pfp       pointer to a @p prio_objects_fifo_t structure
+ * @param[in] objp      pointer to the object to be released
+ *
+ * @sclass
+ */
+static inline void chPFifoReturnObjectS(prio_objects_fifo_t *pfp,
+                                        void *objp) {
+
+  chGuardedPoolFreeS(&pfp->free, objp);
+}
+
+/**
+ * @brief   Releases a fetched object.
+ *
+ * @param[in] pfp       pointer to a @p prio_objects_fifo_t structure
+ * @param[in] objp      pointer to the object to be released
+ *
+ * @api
+ */
+static inline void chPFifoReturnObject(prio_objects_fifo_t *pfp,
+                                       void *objp) {
+
+  chGuardedPoolFree(&pfp->free, objp);
+}
+
+#endif /* CH_CFG_USE_OBJ_PFIFOS == TRUE */
+
+#endif /* CHOBJPFIFOS_H */
+
+/** @} */
@@ -139,6 +139,12 @@ extern "C" {
                             size_t n, sysinterval_t timeout);
   size_t chPipeReadTimeout(pipe_t *pp, uint8_t *bp,
                            size_t n, sysinterval_t timeout);
+  size_t chPipeWriteReserve(pipe_t *pp, uint8_t **bpp,
+                            size_t n, sysinterval_t timeout);
+  void chPipeWriteCommit(pipe_t *pp, size_t n);
+  size_t chPipeReadPeek(pipe_t *pp, const uint8_t **bpp,
+                        size_t n, sysinterval_t timeout);
+  void chPipeReadRelease(pipe_t *pp, size_t n);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,317 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chringbuffers.h
+ * @brief   Ring buffers macros and structures.
+ *
+ * @addtogroup oslib_ring_buffers
+ * @{
+ */
+
+#ifndef CHRINGBUFFERS_H
+#define CHRINGBUFFERS_H
+
+#if (CH_CFG_USE_RING_BUFFERS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Memory barrier between buffer accesses and indexes updates.
+ * @note    The default uses the GCC builtin which generates a full memory
+ *          barrier instruction, on single core systems a compiler barrier
+ *          is sufficient and this macro can be redefined in @p chconf.h.
+ * @note    On multi-core systems it must be a full barrier, it also orders
+ *          the counter store and the following counter load in
+ *          @p chRBCommitX() and @p chRBReleaseX().
+ */
+#if !defined(CH_RB_BARRIER) || defined(__DOXYGEN__)
+#if defined(__GNUC__) || defined(__DOXYGEN__)
+#define CH_RB_BARRIER()                     __sync_synchronize()
+#else
+#error "CH_RB_BARRIER() must be defined for this compiler"
+#endif
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Structure representing a ring buffer object.
+ * @note    The write counter is only modified by the producer and the read
+ *          counter only by the consumer, both are free running and are
+ *          masked in order to obtain the buffer indexes.
+ */
+typedef struct {
+  uint8_t               *buffer;        /**< @brief Pointer to the ring
+                                                    buffer.                 */
+  size_t                size;           /**< @brief Buffer size, power of
+                                                    two.                    */
+  volatile size_t       wrcnt;          /**< @brief Write counter.          */
+  volatile size_t       rdcnt;          /**< @brief Read counter.           */
+  thread_reference_t    rtr;            /**< @brief Waiting reader.         */
+} ring_buffer_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Data part of a static ring buffer initializer.
+ * @details This macro should be used when statically initializing a
+ *          ring buffer that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the ring buffer variable
+ * @param[in] buffer    pointer to the ring buffer array of @p uint8_t
+ * @param[in] size      number of @p uint8_t elements in the buffer array,
+ *                      it must be a power of two
+ */
+#define _RING_BUFFER_DATA(name, buffer, size) {                             \
+  (uint8_t *)(buffer),                                                      \
+  (size_t)(size),                                                           \
+  (size_t)0,                                                                \
+  (size_t)0,                                                                \
+  NULL                                                                      \
+}
+
+/**
+ * @brief   Static ring buffer initializer.
+ * @details Statically initialized ring buffers require no explicit
+ *          initialization using @p chRBObjectInit().
+ *
+ * @param[in] name      the name of the ring buffer variable
+ * @param[in] buffer    pointer to the ring buffer array of @p uint8_t
+ * @param[in] size      number of @p uint8_t elements in the buffer array,
+ *                      it must be a power of two
+ */
+#define RING_BUFFER_DECL(name, buffer, size)                                \
+  ring_buffer_t name = _RING_BUFFER_DATA(name, buffer, size)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chRBObjectInit(ring_buffer_t *rbp, uint8_t *buf, size_t n);
+  void chRBWakeupI(ring_buffer_t *rbp);
+  msg_t chRBWaitTimeoutS(ring_buffer_t *rbp, sysinterval_t timeout);
+  msg_t chRBWaitTimeout(ring_buffer_t *rbp, sysinterval_t timeout);
+  size_t chRBReadTimeout(ring_buffer_t *rbp, uint8_t *bp,
+                         size_t n, sysinterval_t timeout);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the ring buffer size as number of bytes.
+ *
+ * @param[in] rbp       the pointer to an initialized @p ring_buffer_t object
+ * @return              The size of the ring buffer.
+ *
+ * @xclass
+ */
+static inline size_t chRBGetSizeX(const ring_buffer_t *rbp) {
+
+  return rbp->size;
+}
+
+/**
+ * @brief   Returns the number of used byte slots into a ring buffer.
+ * @note    The value is a snapshot, it can be increased by the producer or
+ *          decreased by the consumer at any time.
+ *
+ * @param[in] rbp       the pointer to an initialized @p ring_buffer_t object
+ * @return              The number of queued bytes.
+ *
+ * @xclass
+ */
+static inline size_t chRBGetUsedCountX(const ring_buffer_t *rbp) {
+
+  return rbp->wrcnt - rbp->rdcnt;
+}
+
+/**
+ * @brief   Returns the number of free byte slots into a ring buffer.
+ * @note    The value is a snapshot, it can be increased by the consumer or
+ *          decreased by the producer at any time.
+ *
+ * @param[in] rbp       the pointer to an initialized @p ring_buffer_t object
+ * @return              The number of empty byte slots.
+ *
+ * @xclass
+ */
+static inline size_t chRBGetFreeCountX(const ring_buffer_t *rbp) {
+
+  return chRBGetSizeX(rbp) - chRBGetUsedCountX(rbp);
+}
+
+/**
+ * @brief   Reserves free space in a ring buffer.
+ * @details Returns a pointer to the contiguous free space following the
+ *          last written byte, the producer fills it in place then makes it
+ *          visible to the consumer using @p chRBCommitX().
+ * @note    Lock-free, can be invoked by the producer only, from thread
+ *          or interrupt context.
+ *
+ * @param[in] rbp       the pointer to an initialized @p ring_buffer_t object
+ * @param[out] np       pointer to a variable receiving the number of bytes
+ *                      available at the returned location, it is zero if
+ *                      the ring buffer is full
+ * @return              Pointer to the reserved space.
+ *
+ * @xclass
+ */
+static inline uint8_t *chRBReserveX(ring_buffer_t *rbp, size_t *np) {
+  size_t wr = rbp->wrcnt;
+  size_t idx = wr & (rbp->size - (size_t)1);
+  size_t n = rbp->size - (wr - rbp->rdcnt);
+
+  /* The released space must not be overwritten before the read counter
+     has been observed.*/
+  CH_RB_BARRIER();
+
+  /* Limiting to the contiguous space before the buffer end.*/
+  if (n > (rbp->size - idx)) {
+    n = rbp->size - idx;
+  }
+  *np = n;
+
+  return &rbp->buffer[idx];
+}
+
+/**
+ * @brief   Commits data written into reserved space.
+ * @details The specified number of bytes, previously reserved using
+ *          @p chRBReserveX(), become visible to the consumer.
+ * @note    Lock-free, can be invoked by the producer only, from thread
+ *          or interrupt context.
+ * @note    If the function returns @p true then a consumer could be
+ *          waiting for data, it must be awakened using @p chRBWakeupI().
+ *          No lock is required as long as the ring buffer was not empty.
+ *
+ * @param[in] rbp       the pointer to an initialized @p ring_buffer_t object
+ * @param[in] n         number of bytes to be committed
+ * @return              The empty to non-empty transition state.
+ * @retval false        if the ring buffer already contained data.
+ * @retval true         if the ring buffer was empty before the commit.
+ *
+ * @xclass
+ */
+static inline bool chRBCommitX(ring_buffer_t *rbp, size_t n) {
+  size_t wr = rbp->wrcnt;
+
+  chDbgCheck(n <= chRBGetFreeCountX(rbp));
+
+  if (n == (size_t)0) {
+    return false;
+  }
+
+  /* Data must be visible before the write counter is updated.*/
+  CH_RB_BARRIER();
+  rbp->wrcnt = wr + n;
+
+  /* The write counter store must be visible before the read counter is
+     loaded, else a consumer releasing the last data on another core could
+     miss the commit and wait without being awakened.*/
+  CH_RB_BARRIER();
+
+  return (bool)(rbp->rdcnt == wr);
+}
+
+/**
+ * @brief   Accesses the data in a ring buffer.
+ * @details Returns a pointer to the contiguous data following the last
+ *          read byte, the consumer processes it in place then frees the
+ *          space using @p chRBReleaseX().
+ * @note    Lock-free, can be invoked by the consumer only, from thread
+ *          or interrupt context.
+ *
+ * @param[in] rbp       the pointer to an initialized @p ring_buffer_t object
+ * @param[out] np       pointer to a variable receiving the number of bytes
+ *                      available at the returned location, it is zero if
+ *                      the ring buffer is empty
+ * @return              Pointer to the data.
+ *
+ * @xclass
+ */
+static inline const uint8_t *chRBPeekX(ring_buffer_t *rbp, size_t *np) {
+  size_t rd = rbp->rdcnt;
+  size_t idx = rd & (rbp->size - (size_t)1);
+  size_t n = rbp->wrcnt - rd;
+
+  /* Data must not be read before the write counter has been observed.*/
+  CH_RB_BARRIER();
+
+  /* Limiting to the contiguous data before the buffer end.*/
+  if (n > (rbp->size - idx)) {
+    n = rbp->size - idx;
+  }
+  *np = n;
+
+  return &rbp->buffer[idx];
+}
+
+/**
+ * @brief   Releases consumed data.
+ * @details The specified number of bytes, previously accessed using
+ *          @p chRBPeekX(), are removed from the ring buffer and the space
+ *          is returned to the producer.
+ * @note    Lock-free, can be invoked by the consumer only, from thread
+ *          or interrupt context.
+ *
+ * @param[in] rbp       the pointer to an initialized @p ring_buffer_t object
+ * @param[in] n         number of bytes to be released
+ *
+ * @xclass
+ */
+static inline void chRBReleaseX(ring_buffer_t *rbp, size_t n) {
+
+  chDbgCheck(n <= chRBGetUsedCountX(rbp));
+
+  /* Data accesses must be completed before the space is released.*/
+  CH_RB_BARRIER();
+  rbp->rdcnt = rbp->rdcnt + n;
+
+  /* The read counter store must be visible before the write counter is
+     loaded again by the consumer, see chRBCommitX().*/
+  CH_RB_BARRIER();
+}
+
+#endif /* CH_CFG_USE_RING_BUFFERS == TRUE */
+
+#endif /* CHRINGBUFFERS_H */
+
+/** @} */
@@ -0,0 +1,298 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+ * @file    chtopics.h
+ * @brief   Topics bus structures and macros.
+ * @details This module implements a publish/subscribe bus of zero-copy
+ *          messages. Messages are allocated from a Memory Pool and
+ *          published on a topic, each subscriber of the topic receives
+ *          the same message pointer in its own queue.<br>
+ *          Messages are reference counted, the message is returned to
+ *          its pool when the last subscriber releases it.
+ *
+ * @addtogroup oslib_topics
+ * @{
+ */
+
+#ifndef CHTOPICS_H
+#define CHTOPICS_H
+
+#if (CH_CFG_USE_TOPICS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CH_CFG_USE_MEMPOOLS == FALSE
+#error "CH_CFG_USE_TOPICS requires CH_CFG_USE_MEMPOOLS"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Subscriber queue full policy.
+ */
+typedef enum {
+  TOPIC_DROP_NEWEST = 0,            /**< The published message is dropped. */
+  TOPIC_DROP_OLDEST = 1             /**< The oldest queued message is
+                                         dropped.                           */
+} topic_policy_t;
+
+/**
+ * @brief   Type of a topic message header.
+ * @details Messages structures must start with this header, the pool
+ *          objects size is the size of the whole message.
+ */
+typedef struct ch_topic_message {
+  /**
+   * @brief   Pool where the message is returned.
+   */
+  memory_pool_t             *pool;
+  /**
+   * @brief   References to the message.
+   */
+  ucnt_t                    refs;
+} topic_message_t;
+
+/**
+ * @brief   Type of a topic subscriber.
+ */
+typedef struct ch_topic_subscriber {
+  /**
+   * @brief   Next subscriber of the same topic.
+   */
+  struct ch_topic_subscriber *next;
+  /**
+   * @brief   Circular queue of the received messages.
+   */
+  topic_message_t           **buffer;
+  /**
+   * @brief   Queue depth.
+   */
+  size_t                    size;
+  /**
+   * @brief   Number of queued messages.
+   */
+  size_t                    cnt;
+  /**
+   * @brief   Index of the oldest queued message.
+   */
+  size_t                    rdidx;
+  /**
+   * @brief   Queue full policy.
+   */
+  topic_policy_t            policy;
+  /**
+   * @brief   Number of dropped messages.
+   */
+  ucnt_t                    drops;
+  /**
+   * @brief   Queued receivers.
+   */
+  threads_queue_t           qr;
+} topic_subscriber_t;
+
+/**
+ * @brief   Type of a topic.
+ */
+typedef struct ch_topic {
+  /**
+   * @brief   List of the subscribers.
+   */
+  topic_subscriber_t        *subscribers;
+} topic_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Data part of a topic.
+ * @details This macro should be used when statically initializing a
+ *          topic that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the topic variable
+ */
+#define _TOPIC_DATA(name) {NULL}
+
+/**
+ * @brief   Static topic initializer.
+ * @details Statically initialized topics require no explicit
+ *          initialization using @p chTopicObjectInit().
+ *
+ * @param[in] name      the name of the topic variable
+ */
+#define TOPIC_DECL(name) topic_t name = _TOPIC_DATA(name)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chTopicSubscriberObjectInit(topic_subscriber_t *sp,
+                                   topic_message_t **buf, size_t n,
+                                   topic_policy_t policy);
+  void chTopicSubscribeI(topic_t *tp, topic_subscriber_t *sp);
+  void chTopicSubscribe(topic_t *tp, topic_subscriber_t *sp);
+  void chTopicUnsubscribeI(topic_t *tp, topic_subscriber_t *sp);
+  void chTopicUnsubscribe(topic_t *tp, topic_subscriber_t *sp);
+  void chTopicPublishI(topic_t *tp, topic_message_t *msgp);
+  void chTopicPublishS(topic_t *tp, topic_message_t *msgp);
+  void chTopicPublish(topic_t *tp, topic_message_t *msgp);
+  msg_t chTopicReceiveI(topic_subscriber_t *sp, topic_message_t **msgpp);
+  msg_t chTopicReceiveTimeoutS(topic_subscriber_t *sp,
+                               topic_message_t **msgpp,
+                               sysinterval_t timeout);
+  msg_t chTopicReceiveTimeout(topic_subscriber_t *sp,
+                              topic_message_t **msgpp,
+                              sysinterval_t timeout);
+  void chTopicReleaseI(topic_message_t *msgp);
+  void chTopicRelease(topic_message_t *msgp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a topic object.
+ *
+ * @param[out] tp       pointer to a @p topic_t structure
+ *
+ * @init
+ */
+static inline void chTopicObjectInit(topic_t *tp) {
+
+  tp->subscribers = NULL;
+}
+
+/**
+ * @brief   Allocates a message.
+ * @details The message is allocated from the specified pool, the caller
+ *          owns the only reference to the message until it is published.
+ *
+ * @param[in] mp        pointer to a @p memory_pool_t structure, the pool
+ *                      objects must be topic messages
+ * @return              The pointer to the allocated message.
+ * @retval NULL         if a message is not immediately available.
+ *
+ * @iclass
+ */
+static inline topic_message_t *chTopicAllocMessageI(memory_pool_t *mp) {
+  topic_message_t *msgp;
+
+  chDbgCheckClassI();
+
+  msgp = (topic_message_t *)chPoolAllocI(mp);
+  if (msgp != NULL) {
+    msgp->pool = mp;
+    msgp->refs = (ucnt_t)1;
+  }
+
+  return msgp;
+}
+
+/**
+ * @brief   Allocates a message.
+ * @details The message is allocated from the specified pool, the caller
+ *          owns the only reference to the message until it is published.
+ *
+ * @param[in] mp        pointer to a @p memory_pool_t structure, the pool
+ *                      objects must be topic messages
+ * @return              The pointer to the allocated message.
+ * @retval NULL         if a message is not immediately available.
+ *
+ * @api
+ */
+static inline topic_message_t *chTopicAllocMessage(memory_pool_t *mp) {
+  topic_message_t *msgp;
+
+  chSysLock();
+  msgp = chTopicAllocMessageI(mp);
+  chSysUnlock();
+
+  return msgp;
+}
+
+/**
+ * @brief   Adds a reference to a message.
+ * @details A subscriber can keep a message after releasing its own
+ *          reference or forward it to another topic.
+ *
+ * @param[in] msgp      pointer to the message
+ *
+ * @iclass
+ */
+static inline void chTopicAddRefI(topic_message_t *msgp) {
+
+  chDbgCheckClassI();
+  chDbgAssert(msgp->refs > (ucnt_t)0, "not referenced");
+
+  msgp->refs++;
+}
+
+/**
+ * @brief   Returns the number of messages queued on a subscriber.
+ *
+ * @param[in] sp        pointer to a @p topic_subscriber_t structure
+ * @return              The number of queued messages.
+ *
+ * @iclass
+ */
+static inline size_t chTopicGetPendingI(const topic_subscriber_t *sp) {
+
+  chDbgCheckClassI();
+
+  return sp->cnt;
+}
+
+/**
+ * @brief   Returns the number of messages dropped by a subscriber.
+ *
+ * @param[in] sp        pointer to a @p topic_subscriber_t structure
+ * @return              The number of dropped messages.
+ *
+ * @xclass
+ */
+static inline ucnt_t chTopicGetDropsX(const topic_subscriber_t *sp) {
+
+  return sp->drops;
+}
+
+#endif /* CH_CFG_USE_TOPICS == TRUE */
+
+#endif /* CHTOPICS_H */
+
+/** @} */
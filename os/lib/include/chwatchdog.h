@@ -0,0 +1,190 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+ * @file    chwatchdog.h
+ * @brief   Watchdog monitor structures and macros.
+ * @details This module implements a software watchdog supervising a set of
+ *          threads. Each thread registers a slot with its own deadline and
+ *          periodically marks the slot alive, a single virtual timer scans
+ *          all the slots and feeds the hardware watchdog only if all the
+ *          threads are alive.
+ *
+ * @addtogroup oslib_watchdog
+ * @{
+ */
+
+#ifndef CHWATCHDOG_H
+#define CHWATCHDOG_H
+
+#if (CH_CFG_USE_WATCHDOG == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !defined(_CHIBIOS_RT_)
+#error "CH_CFG_USE_WATCHDOG requires RT"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a watchdog monitor.
+ */
+typedef struct ch_watchdog_monitor watchdog_monitor_t;
+
+/**
+ * @brief   Type of a watchdog slot.
+ */
+typedef struct ch_watchdog_slot watchdog_slot_t;
+
+/**
+ * @brief   Watchdog feed callback type.
+ * @note    The callback is invoked from the virtual timer callback, within
+ *          a critical zone.
+ */
+typedef void (*watchdog_feed_t)(watchdog_monitor_t *wmp);
+
+/**
+ * @brief   Watchdog failure callback type.
+ * @note    The callback is invoked from the virtual timer callback, within
+ *          a critical zone.
+ */
+typedef void (*watchdog_fail_t)(watchdog_monitor_t *wmp,
+                                watchdog_slot_t *wsp);
+
+/**
+ * @brief   Structure representing a watchdog slot.
+ */
+struct ch_watchdog_slot {
+  /**
+   * @brief   Next slot in the monitor list.
+   */
+  watchdog_slot_t           *next;
+  /**
+   * @brief   Thread owning the slot.
+   */
+  thread_t                  *thread;
+  /**
+   * @brief   Maximum interval between heartbeats.
+   */
+  sysinterval_t             deadline;
+  /**
+   * @brief   Time of the last heartbeat.
+   */
+  volatile systime_t        last;
+};
+
+/**
+ * @brief   Structure representing a watchdog monitor.
+ */
+struct ch_watchdog_monitor {
+  /**
+   * @brief   Scan virtual timer.
+   */
+  virtual_timer_t           vt;
+  /**
+   * @brief   Scan period.
+   */
+  sysinterval_t             period;
+  /**
+   * @brief   Registered slots list.
+   */
+  watchdog_slot_t           *slots;
+  /**
+   * @brief   First slot found late or @p NULL.
+   */
+  watchdog_slot_t           *failed;
+  /**
+   * @brief   Feed callback.
+   */
+  watchdog_feed_t           feed;
+  /**
+   * @brief   Failure callback or @p NULL.
+   */
+  watchdog_fail_t           fail;
+};
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the slot that caused the monitor failure.
+ *
+ * @param[in] wmp       pointer to a @p watchdog_monitor_t object
+ * @return              The late slot or @p NULL if all threads are alive.
+ *
+ * @xclass
+ */
+#define chWdgGetFailedX(wmp) ((wmp)->failed)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chWdgObjectInit(watchdog_monitor_t *wmp, sysinterval_t period,
+                       watchdog_feed_t feed, watchdog_fail_t fail);
+  void chWdgStart(watchdog_monitor_t *wmp);
+  void chWdgStop(watchdog_monitor_t *wmp);
+  void chWdgRegister(watchdog_monitor_t *wmp, watchdog_slot_t *wsp,
+                     sysinterval_t deadline);
+  void chWdgUnregister(watchdog_monitor_t *wmp, watchdog_slot_t *wsp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Marks a slot alive.
+ * @details The heartbeat is a single store in the slot, it does not require
+ *          a critical zone.
+ *
+ * @param[in] wsp       pointer to a registered @p watchdog_slot_t object
+ *
+ * @xclass
+ */
+static inline void chWdgHeartbeat(watchdog_slot_t *wsp) {
+
+  wsp->last = chVTGetSystemTimeX();
+}
+
+#endif /* CH_CFG_USE_WATCHDOG == TRUE */
+
+#endif /* CHWATCHDOG_H */
+
+/** @} */
@@ -25,6 +25,18 @@ endif
 ifneq ($(findstring CH_CFG_USE_PIPES TRUE,$(CHLIBCONF)),)
 LIBSRC += $(CHIBIOS)/os/lib/src/chpipes.c
 endif
+ifneq ($(findstring CH_CFG_USE_RING_BUFFERS TRUE,$(CHLIBCONF)),)
+LIBSRC += $(CHIBIOS)/os/lib/src/chringbuffers.c
+endif
+ifneq ($(findstring CH_CFG_USE_OBJ_PFIFOS TRUE,$(CHLIBCONF)),)
+LIBSRC += $(CHIBIOS)/os/lib/src/chobjpfifos.c
+endif
+ifneq ($(findstring CH_CFG_USE_TOPICS TRUE,$(CHLIBCONF)),)
+LIBSRC += $(CHIBIOS)/os/lib/src/chtopics.c
+endif
+ifneq ($(findstring CH_CFG_USE_WATCHDOG TRUE,$(CHLIBCONF)),)
+LIBSRC += $(CHIBIOS)/os/lib/src/chwatchdog.c
+endif
 ifneq ($(findstring CH_CFG_USE_FACTORY TRUE,$(CHLIBCONF)),)
 LIBSRC += $(CHIBIOS)/os/lib/src/chfactory.c
 endif
@@ -33,7 +45,11 @@ LIBSRC := $(CHIBIOS)/os/lib/src/chmboxes.c \
           $(CHIBIOS)/os/lib/src/chmemcore.c \
           $(CHIBIOS)/os/lib/src/chmemheaps.c \
           $(CHIBIOS)/os/lib/src/chmempools.c \
-          $(CHIBIOS)/os/lib/src/chmpipes.c \
+          $(CHIBIOS)/os/lib/src/chobjpfifos.c \
+          $(CHIBIOS)/os/lib/src/chpipes.c \
+          $(CHIBIOS)/os/lib/src/chringbuffers.c \
+          $(CHIBIOS)/os/lib/src/chtopics.c \
+          $(CHIBIOS)/os/lib/src/chwatchdog.c \
           $(CHIBIOS)/os/lib/src/chfactory.c
 endif
 
@@ -83,11 +83,90 @@ objects_factory_t ch_factory;
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_FACTORY_HASH_BUCKETS > 0) || defined(__DOXYGEN__)
+/* FNV-1a hash of an object name.*/
+static uint32_t dyn_hash(const char *name) {
+  uint32_t h = 2166136261U;
+  size_t i;
+
+  for (i = 0U; name[i] != '\0'; i++) {
+#if CH_CFG_FACTORY_MAX_NAMES_LENGTH > 0
+    if (i >= (size_t)CH_CFG_FACTORY_MAX_NAMES_LENGTH) {
+      break;
+    }
+#endif
+    h = (h ^ (uint32_t)(uint8_t)name[i]) * 16777619U;
+  }
+
+  return h;
+}
+
+/* Each bucket is a NULL terminated list.*/
+static inline dyn_element_t **dyn_list_head(dyn_list_t *dlp,
+                                            const char *name) {
+
+  return &dlp->buckets[dyn_hash(name) &
+                       ((uint32_t)CH_CFG_FACTORY_HASH_BUCKETS - 1U)];
+}
+
+static inline void dyn_list_init(dyn_list_t *dlp) {
+  unsigned i;
+
+  for (i = 0U; i < (unsigned)CH_CFG_FACTORY_HASH_BUCKETS; i++) {
+    dlp->buckets[i] = NULL;
+  }
+}
+
+static inline void dyn_list_link(dyn_element_t *element, dyn_list_t *dlp) {
+  dyn_element_t **headp = dyn_list_head(dlp, element->name);
+
+  element->next = *headp;
+  *headp = element;
+}
+
+static dyn_element_t *dyn_list_find(const char *name, dyn_list_t *dlp) {
+  dyn_element_t *p = *dyn_list_head(dlp, name);
+
+  while (p != NULL) {
+    if (strncmp(p->name, name, CH_CFG_FACTORY_MAX_NAMES_LENGTH) == 0) {
+      return p;
+    }
+    p = p->next;
+  }
+
+  return NULL;
+}
+
+static dyn_element_t *dyn_list_unlink(dyn_element_t *element,
+                                      dyn_list_t *dlp) {
+  dyn_element_t **prevp = dyn_list_head(dlp, element->name);
+
+  /* Scanning the bucket.*/
+  while (*prevp != NULL) {
+    if (*prevp == element) {
+      /* Found.*/
+      *prevp = element->next;
+      return element;
+    }
+
+    /* Next element in the bucket.*/
+    prevp = &(*prevp)->next;
+  }
+
+  return NULL;
+}
+#else /* CH_CFG_FACTORY_HASH_BUCKETS == 0 */
 static inline void dyn_list_init(dyn_list_t *dlp) {
 
   dlp->next = (dyn_element_t *)dlp;
 }
 
+static inline void dyn_list_link(dyn_element_t *element, dyn_list_t *dlp) {
+
+  element->next = dlp->next;
+  dlp->next = element;
+}
+
 static dyn_element_t *dyn_list_find(const char *name, dyn_list_t *dlp) {
   dyn_element_t *p = dlp->next;
 
@@ -119,6 +198,7 @@ static dyn_element_t *dyn_list_unlink(dyn_element_t *element,
 
   return NULL;
 }
+#endif /* CH_CFG_FACTORY_HASH_BUCKETS == 0 */
 
 #if CH_FACTORY_REQUIRES_HEAP || defined(__DOXYGEN__)
 static dyn_element_t *dyn_create_object_heap(const char *name,
@@ -146,10 +226,9 @@ static dyn_element_t *dyn_create_object_heap(const char *name,
   strncpy(dep->name, name, CH_CFG_FACTORY_MAX_NAMES_LENGTH);
   /*lint -restore*/
   dep->refs = (ucnt_t)1;
-  dep->next = dlp->next;
 
   /* Updating factory list.*/
-  dlp->next = dep;
+  dyn_list_link(dep, dlp);
 
   return dep;
 }
@@ -195,10 +274,9 @@ static dyn_element_t *dyn_create_object_pool(const char *name,
   strncpy(dep->name, name, CH_CFG_FACTORY_MAX_NAMES_LENGTH);
   /*lint -restore*/
   dep->refs = (ucnt_t)1;
-  dep->next = dlp->next;
 
   /* Updating factory list.*/
-  dlp->next = (dyn_element_t *)dep;
+  dyn_list_link(dep, dlp);
 
   return dep;
 }
@@ -349,6 +427,28 @@ registered_object_t *chFactoryFindObject(const char *name) {
  * @api
  */
 registered_object_t *chFactoryFindObjectByPointer(void *objp) {
+#if CH_CFG_FACTORY_HASH_BUCKETS > 0
+  unsigned i;
+
+  F_LOCK();
+
+  /* There is no index by pointer, all the buckets are scanned.*/
+  for (i = 0U; i < (unsigned)CH_CFG_FACTORY_HASH_BUCKETS; i++) {
+    registered_object_t *rop =
+        (registered_object_t *)ch_factory.obj_list.buckets[i];
+
+    while (rop != NULL) {
+      if (rop->objp == objp) {
+        rop->element.refs++;
+
+        F_UNLOCK();
+
+        return rop;
+      }
+      rop = (registered_object_t *)rop->element.next;
+    }
+  }
+#else
   registered_object_t *rop = (registered_object_t *)ch_factory.obj_list.next;
 
   F_LOCK();
@@ -363,6 +463,7 @@ registered_object_t *chFactoryFindObjectByPointer(void *objp) {
     }
     rop = (registered_object_t *)rop->element.next;
   }
+#endif
 
   F_UNLOCK();
 
@@ -416,7 +517,7 @@ dyn_buffer_t *chFactoryCreateBuffer(const char *name, size_t size) {
 
   dbp = (dyn_buffer_t *)dyn_create_object_heap(name,
                                                &ch_factory.buf_list,
-                                               size);
+                                               sizeof (dyn_buffer_t) + size);
   if (dbp != NULL) {
     /* Initializing buffer object data.*/
     memset((void *)dbp->buffer, 0, size);
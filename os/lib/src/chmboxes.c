@@ -70,6 +70,106 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Wakes up to @p n threads from a threads queue.
+ *
+ * @param[in] tqp       pointer to the threads queue object
+ * @param[in] n         maximum number of threads to be woken up
+ *
+ * @notapi
+ */
+static void mb_wakeup_n(threads_queue_t *tqp, size_t n) {
+
+  while ((n > (size_t)0) && !chThdQueueIsEmptyI(tqp)) {
+    chThdDequeueNextI(tqp, MSG_OK);
+    n--;
+  }
+}
+
+/**
+ * @brief   Wakes up a reader after a message has been posted.
+ * @details Threads waiting on multiple objects including the mailbox are
+ *          also notified.
+ *
+ * @param[in] mbp       the pointer to an initialized @p mailbox_t object
+ *
+ * @notapi
+ */
+static void mb_wakeup_reader(mailbox_t *mbp) {
+
+  chThdDequeueNextI(&mbp->qr, MSG_OK);
+#if CH_CFG_USE_WAIT_MULTIPLE == TRUE
+  chWaitNotifyI(&mbp->waiters);
+#endif
+}
+
+/**
+ * @brief   Posts up to @p n messages into the free slots of a mailbox.
+ *
+ * @param[in] mbp       the pointer to an initialized @p mailbox_t object
+ * @param[in] msgp      pointer to the array of messages to be posted
+ * @param[in] n         maximum number of messages to be posted
+ * @return              The number of messages effectively posted.
+ *
+ * @notapi
+ */
+static size_t mb_post_array(mailbox_t *mbp, const msg_t *msgp, size_t n) {
+  size_t i;
+
+  if (n > chMBGetFreeCountI(mbp)) {
+    n = chMBGetFreeCountI(mbp);
+  }
+
+  for (i = (size_t)0; i < n; i++) {
+    *mbp->wrptr++ = msgp[i];
+    if (mbp->wrptr >= mbp->top) {
+      mbp->wrptr = mbp->buffer;
+    }
+  }
+  mbp->cnt += n;
+
+  /* Readers waiting are made ready, no more than the posted messages.*/
+  mb_wakeup_n(&mbp->qr, n);
+#if CH_CFG_USE_WAIT_MULTIPLE == TRUE
+  if (n > (size_t)0) {
+    chWaitNotifyI(&mbp->waiters);
+  }
+#endif
+
+  return n;
+}
+
+/**
+ * @brief   Fetches up to @p n messages from a mailbox.
+ *
+ * @param[in] mbp       the pointer to an initialized @p mailbox_t object
+ * @param[out] msgp     pointer to the array receiving the messages
+ * @param[in] n         maximum number of messages to be fetched
+ * @return              The number of messages effectively fetched.
+ *
+ * @notapi
+ */
+static size_t mb_fetch_array(mailbox_t *mbp, msg_t *msgp, size_t n) {
+  size_t i;
+
+  if (n > chMBGetUsedCountI(mbp)) {
+    n = chMBGetUsedCountI(mbp);
+  }
+
+  for (i = (size_t)0; i < n; i++) {
+    msgp[i] = *mbp->rdptr++;
+    if (mbp->rdptr >= mbp->top) {
+      mbp->rdptr = mbp->buffer;
+    }
+  }
+  mbp->cnt -= n;
+
+  /* Writers waiting are made ready, no more than the freed slots.*/
+  mb_wakeup_n(&mbp->qw, n);
+
+  return n;
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -96,6 +196,9 @@ void chMBObjectInit(mailbox_t *mbp, msg_t *buf, size_t n) {
   mbp->reset  = false;
   chThdQueueObjectInit(&mbp->qw);
   chThdQueueObjectInit(&mbp->qr);
+#if CH_CFG_USE_WAIT_MULTIPLE == TRUE
+  wait_list_init(&mbp->waiters);
+#endif
 }
 
 /**
@@ -141,6 +244,9 @@ void chMBResetI(mailbox_t *mbp) {
   mbp->reset = true;
   chThdDequeueAllI(&mbp->qw, MSG_RESET);
   chThdDequeueAllI(&mbp->qr, MSG_RESET);
+#if CH_CFG_USE_WAIT_MULTIPLE == TRUE
+  chWaitNotifyI(&mbp->waiters);
+#endif
 }
 
 /**
@@ -212,7 +318,7 @@ msg_t chMBPostTimeoutS(mailbox_t *mbp, msg_t msg, sysinterval_t timeout) {
       mbp->cnt++;
 
       /* If there is a reader waiting then makes it ready.*/
-      chThdDequeueNextI(&mbp->qr, MSG_OK);
+      mb_wakeup_reader(mbp);
       chSchRescheduleS();
 
       return MSG_OK;
@@ -259,7 +365,7 @@ msg_t chMBPostI(mailbox_t *mbp, msg_t msg) {
     mbp->cnt++;
 
     /* If there is a reader waiting then makes it ready.*/
-    chThdDequeueNextI(&mbp->qr, MSG_OK);
+    mb_wakeup_reader(mbp);
 
     return MSG_OK;
   }
@@ -337,7 +443,7 @@ msg_t chMBPostAheadTimeoutS(mailbox_t *mbp, msg_t msg, sysinterval_t timeout) {
       mbp->cnt++;
 
       /* If there is a reader waiting then makes it ready.*/
-      chThdDequeueNextI(&mbp->qr, MSG_OK);
+      mb_wakeup_reader(mbp);
       chSchRescheduleS();
 
       return MSG_OK;
@@ -384,7 +490,7 @@ msg_t chMBPostAheadI(mailbox_t *mbp, msg_t msg) {
     mbp->cnt++;
 
     /* If there is a reader waiting then makes it ready.*/
-    chThdDequeueNextI(&mbp->qr, MSG_OK);
+    mb_wakeup_reader(mbp);
 
     return MSG_OK;
   }
@@ -517,6 +623,220 @@ msg_t chMBFetchI(mailbox_t *mbp, msg_t *msgp) {
   /* No message, immediate timeout.*/
   return MSG_TIMEOUT;
 }
+
+/**
+ * @brief   Posts an array of messages into a mailbox.
+ * @details The invoking thread waits until at least an empty slot in the
+ *          mailbox becomes available or the specified time runs out, then
+ *          up to @p n messages are posted under a single critical zone.
+ * @note    The messages are posted as a single group, waiting readers are
+ *          made ready and the scheduler is invoked only once.
+ *
+ * @param[in] mbp       the pointer to an initialized @p mailbox_t object
+ * @param[in] msgp      pointer to the array of messages to be posted
+ * @param[in] n         number of messages in the array, must be non-zero
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of messages effectively posted, zero if
+ *                      the mailbox has been reset or the operation has
+ *                      timed out.
+ *
+ * @api
+ */
+size_t chMBPostArrayTimeout(mailbox_t *mbp, const msg_t *msgp,
+                            size_t n, sysinterval_t timeout) {
+  size_t posted;
+
+  chSysLock();
+  posted = chMBPostArrayTimeoutS(mbp, msgp, n, timeout);
+  chSysUnlock();
+
+  return posted;
+}
+
+/**
+ * @brief   Posts an array of messages into a mailbox.
+ * @details The invoking thread waits until at least an empty slot in the
+ *          mailbox becomes available or the specified time runs out, then
+ *          up to @p n messages are posted.
+ *
+ * @param[in] mbp       the pointer to an initialized @p mailbox_t object
+ * @param[in] msgp      pointer to the array of messages to be posted
+ * @param[in] n         number of messages in the array, must be non-zero
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of messages effectively posted, zero if
+ *                      the mailbox has been reset or the operation has
+ *                      timed out.
+ *
+ * @sclass
+ */
+size_t chMBPostArrayTimeoutS(mailbox_t *mbp, const msg_t *msgp,
+                             size_t n, sysinterval_t timeout) {
+  msg_t rdymsg;
+
+  chDbgCheckClassS();
+  chDbgCheck((mbp != NULL) && (msgp != NULL) && (n > (size_t)0));
+
+  do {
+    /* If the mailbox is in reset state then returns immediately.*/
+    if (mbp->reset) {
+      return (size_t)0;
+    }
+
+    /* Is there a free message slot in queue? if so then post.*/
+    if (chMBGetFreeCountI(mbp) > (size_t)0) {
+      n = mb_post_array(mbp, msgp, n);
+      chSchRescheduleS();
+
+      return n;
+    }
+
+    /* No space in the queue, waiting for a slot to become available.*/
+    rdymsg = chThdEnqueueTimeoutS(&mbp->qw, timeout);
+  } while (rdymsg == MSG_OK);
+
+  return (size_t)0;
+}
+
+/**
+ * @brief   Posts an array of messages into a mailbox.
+ * @details This variant is non-blocking, the messages not fitting in the
+ *          free slots are not posted.
+ *
+ * @param[in] mbp       the pointer to an initialized @p mailbox_t object
+ * @param[in] msgp      pointer to the array of messages to be posted
+ * @param[in] n         number of messages in the array, must be non-zero
+ * @return              The number of messages effectively posted, zero if
+ *                      the mailbox has been reset or is full.
+ *
+ * @iclass
+ */
+size_t chMBPostArrayI(mailbox_t *mbp, const msg_t *msgp, size_t n) {
+
+  chDbgCheckClassI();
+  chDbgCheck((mbp != NULL) && (msgp != NULL) && (n > (size_t)0));
+
+  /* If the mailbox is in reset state then returns immediately.*/
+  if (mbp->reset) {
+    return (size_t)0;
+  }
+
+  return mb_post_array(mbp, msgp, n);
+}
+
+/**
+ * @brief   Retrieves an array of messages from a mailbox.
+ * @details The invoking thread waits until at least a message is posted in
+ *          the mailbox or the specified time runs out, then up to @p n
+ *          messages are fetched under a single critical zone.
+ * @note    The messages are fetched as a single group, waiting writers are
+ *          made ready and the scheduler is invoked only once.
+ *
+ * @param[in] mbp       the pointer to an initialized @p mailbox_t object
+ * @param[out] msgp     pointer to the array receiving the messages
+ * @param[in] n         size of the array, must be non-zero
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of messages effectively fetched, zero if
+ *                      the mailbox has been reset or the operation has
+ *                      timed out.
+ *
+ * @api
+ */
+size_t chMBFetchArrayTimeout(mailbox_t *mbp, msg_t *msgp,
+                             size_t n, sysinterval_t timeout) {
+  size_t fetched;
+
+  chSysLock();
+  fetched = chMBFetchArrayTimeoutS(mbp, msgp, n, timeout);
+  chSysUnlock();
+
+  return fetched;
+}
+
+/**
+ * @brief   Retrieves an array of messages from a mailbox.
+ * @details The invoking thread waits until at least a message is posted in
+ *          the mailbox or the specified time runs out, then up to @p n
+ *          messages are fetched.
+ *
+ * @param[in] mbp       the pointer to an initialized @p mailbox_t object
+ * @param[out] msgp     pointer to the array receiving the messages
+ * @param[in] n         size of the array, must be non-zero
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of messages effectively fetched, zero if
+ *                      the mailbox has been reset or the operation has
+ *                      timed out.
+ *
+ * @sclass
+ */
+size_t chMBFetchArrayTimeoutS(mailbox_t *mbp, msg_t *msgp,
+                              size_t n, sysinterval_t timeout) {
+  msg_t rdymsg;
+
+  chDbgCheckClassS();
+  chDbgCheck((mbp != NULL) && (msgp != NULL) && (n > (size_t)0));
+
+  do {
+    /* If the mailbox is in reset state then returns immediately.*/
+    if (mbp->reset) {
+      return (size_t)0;
+    }
+
+    /* Is there a message in queue? if so then fetch.*/
+    if (chMBGetUsedCountI(mbp) > (size_t)0) {
+      n = mb_fetch_array(mbp, msgp, n);
+      chSchRescheduleS();
+
+      return n;
+    }
+
+    /* No message in the queue, waiting for a message to become available.*/
+    rdymsg = chThdEnqueueTimeoutS(&mbp->qr, timeout);
+  } while (rdymsg == MSG_OK);
+
+  return (size_t)0;
+}
+
+/**
+ * @brief   Retrieves an array of messages from a mailbox.
+ * @details This variant is non-blocking, only the messages already in the
+ *          mailbox are fetched.
+ *
+ * @param[in] mbp       the pointer to an initialized @p mailbox_t object
+ * @param[out] msgp     pointer to the array receiving the messages
+ * @param[in] n         size of the array, must be non-zero
+ * @return              The number of messages effectively fetched, zero if
+ *                      the mailbox has been reset or is empty.
+ *
+ * @iclass
+ */
+size_t chMBFetchArrayI(mailbox_t *mbp, msg_t *msgp, size_t n) {
+
+  chDbgCheckClassI();
+  chDbgCheck((mbp != NULL) && (msgp != NULL) && (n > (size_t)0));
+
+  /* If the mailbox is in reset state then returns immediately.*/
+  if (mbp->reset) {
+    return (size_t)0;
+  }
+
+  return mb_fetch_array(mbp, msgp, n);
+}
 #endif /* CH_CFG_USE_MAILBOXES == TRUE */
 
 /** @} */
@@ -37,7 +37,12 @@
  *          can coexist and share the main memory.<br>
  *          This allocator, alone, is also useful for very simple
  *          applications that just require a simple way to get memory
- *          blocks.
+ *          blocks.<br>
+ *          Optionally, further memory regions with their own attributes
+ *          (fast, DMA capable, non-cacheable, large) can be registered,
+ *          allocations can then be requested by attributes and are served
+ *          by the first suitable region. Heaps can be placed in a specific
+ *          region by initializing them over a block allocated from it.
  * @pre     In order to use the core memory manager APIs the @p CH_CFG_USE_MEMCORE
  *          option must be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
@@ -57,6 +62,13 @@
  */
 memcore_t ch_memcore;
 
+#if (CH_CFG_MEMCORE_REGIONS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Memory regions descriptors.
+ */
+memregion_t ch_memregions[CH_CFG_MEMCORE_REGIONS];
+#endif
+
 /*===========================================================================*/
 /* Module local types.                                                       */
 /*===========================================================================*/
@@ -69,6 +81,36 @@ memcore_t ch_memcore;
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Allocates a memory block from a core allocator.
+ *
+ * @param[in] mcp       pointer to the @p memcore_t object
+ * @param[in] size      the size of the block to be allocated.
+ * @param[in] align     desired memory alignment
+ * @param[in] offset    aligned pointer offset
+ * @return              A pointer to the allocated memory block.
+ * @retval NULL         allocation failed, core memory exhausted.
+ *
+ * @notapi
+ */
+static void *core_alloc(memcore_t *mcp, size_t size,
+                        unsigned align, size_t offset) {
+  uint8_t *p, *next;
+
+  size = MEM_ALIGN_NEXT(size, align);
+  p = (uint8_t *)MEM_ALIGN_NEXT(mcp->nextmem + offset, align);
+  next = p + size;
+
+  /* Considering also the case where there is numeric overflow.*/
+  if ((next > mcp->endmem) || (next < mcp->nextmem)) {
+    return NULL;
+  }
+
+  mcp->nextmem = next;
+
+  return p;
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -93,6 +135,18 @@ void _core_init(void) {
   ch_memcore.nextmem = &static_heap[0];
   ch_memcore.endmem  = &static_heap[CH_CFG_MEMCORE_SIZE];
 #endif
+#if CH_CFG_MEMCORE_REGIONS > 0
+  {
+    unsigned i;
+
+    /* Regions are empty until registered by the application.*/
+    for (i = 0U; i < (unsigned)CH_CFG_MEMCORE_REGIONS; i++) {
+      ch_memregions[i].core.nextmem = NULL;
+      ch_memregions[i].core.endmem  = NULL;
+      ch_memregions[i].attrs        = CH_MEM_ATTR_NONE;
+    }
+  }
+#endif
 }
 
 /**
@@ -112,23 +166,11 @@ void _core_init(void) {
 void *chCoreAllocAlignedWithOffsetI(size_t size,
                                     unsigned align,
                                     size_t offset) {
-  uint8_t *p, *next;
 
   chDbgCheckClassI();
   chDbgCheck(MEM_IS_VALID_ALIGNMENT(align));
 
-  size = MEM_ALIGN_NEXT(size, align);
-  p = (uint8_t *)MEM_ALIGN_NEXT(ch_memcore.nextmem + offset, align);
-  next = p + size;
-
-  /* Considering also the case where there is numeric overflow.*/
-  if ((next > ch_memcore.endmem) || (next < ch_memcore.nextmem)) {
-    return NULL;
-  }
-
-  ch_memcore.nextmem = next;
-
-  return p;
+  return core_alloc(&ch_memcore, size, align, offset);
 }
 
 /**
@@ -170,6 +212,224 @@ size_t chCoreGetStatusX(void) {
   return (size_t)(ch_memcore.endmem - ch_memcore.nextmem);
   /*lint -restore*/
 }
+
+#if (CH_CFG_MEMCORE_REGIONS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Registers a memory region.
+ * @details The memory area is typically delimited by linker script
+ *          symbols, the region becomes available to
+ *          @p chCoreAllocFromRegions().
+ * @note    Regions are searched in index order, faster regions should
+ *          have lower indexes.
+ *
+ * @param[in] n         the region index
+ * @param[in] base      base address of the region
+ * @param[in] size      size of the region
+ * @param[in] attrs     attributes of the region
+ *
+ * @init
+ */
+void chCoreRegionInit(unsigned n, void *base, size_t size, memattr_t attrs) {
+
+  chDbgCheck((n < (unsigned)CH_CFG_MEMCORE_REGIONS) && (base != NULL));
+
+  ch_memregions[n].core.nextmem = (uint8_t *)base;
+  ch_memregions[n].core.endmem  = (uint8_t *)base + size;
+  ch_memregions[n].attrs        = attrs;
+}
+
+/**
+ * @brief   Memory region status.
+ *
+ * @param[in] n         the region index
+ * @return              The size, in bytes, of the free region memory.
+ *
+ * @xclass
+ */
+size_t chCoreRegionGetStatusX(unsigned n) {
+
+  chDbgCheck(n < (unsigned)CH_CFG_MEMCORE_REGIONS);
+
+  /*lint -save -e9033 [10.8] The cast is safe.*/
+  return (size_t)(ch_memregions[n].core.endmem -
+                  ch_memregions[n].core.nextmem);
+  /*lint -restore*/
+}
+#endif /* CH_CFG_MEMCORE_REGIONS > 0 */
+
+/**
+ * @brief   Allocates a memory block with the specified attributes.
+ * @details The block is allocated from the first region having all the
+ *          requested attributes and enough free space, the main core
+ *          memory is used last if its attributes, specified by
+ *          @p CH_CFG_MEMCORE_ATTRS, are suitable.
+ *
+ * @param[in] size      the size of the block to be allocated.
+ * @param[in] align     desired memory alignment
+ * @param[in] attrs     required attributes mask
+ * @return              A pointer to the allocated memory block.
+ * @retval NULL         allocation failed, no suitable memory.
+ *
+ * @iclass
+ */
+void *chCoreAllocFromRegionsI(size_t size, unsigned align, memattr_t attrs) {
+  void *p;
+#if CH_CFG_MEMCORE_REGIONS > 0
+  unsigned i;
+#endif
+
+  chDbgCheckClassI();
+  chDbgCheck(MEM_IS_VALID_ALIGNMENT(align));
+
+#if CH_CFG_MEMCORE_REGIONS > 0
+  for (i = 0U; i < (unsigned)CH_CFG_MEMCORE_REGIONS; i++) {
+    if ((ch_memregions[i].attrs & attrs) == attrs) {
+      p = core_alloc(&ch_memregions[i].core, size, align, 0U);
+      if (p != NULL) {
+        return p;
+      }
+    }
+  }
+#endif
+
+  p = NULL;
+  if (((memattr_t)CH_CFG_MEMCORE_ATTRS & attrs) == attrs) {
+    p = core_alloc(&ch_memcore, size, align, 0U);
+  }
+
+  return p;
+}
+
+/**
+ * @brief   Allocates a memory block with the specified attributes.
+ * @details The block is allocated from the first region having all the
+ *          requested attributes and enough free space, the main core
+ *          memory is used last if its attributes, specified by
+ *          @p CH_CFG_MEMCORE_ATTRS, are suitable.
+ *
+ * @param[in] size      the size of the block to be allocated.
+ * @param[in] align     desired memory alignment
+ * @param[in] attrs     required attributes mask
+ * @return              A pointer to the allocated memory block.
+ * @retval NULL         allocation failed, no suitable memory.
+ *
+ * @api
+ */
+void *chCoreAllocFromRegions(size_t size, unsigned align, memattr_t attrs) {
+  void *p;
+
+  chSysLock();
+  p = chCoreAllocFromRegionsI(size, align, attrs);
+  chSysUnlock();
+
+  return p;
+}
+
+/**
+ * @brief   Initializes a memory arena over a memory buffer.
+ *
+ * @param[out] map      pointer to a @p memory_arena_t structure
+ * @param[in] buf       pointer to the arena buffer
+ * @param[in] size      size of the arena buffer
+ *
+ * @init
+ */
+void chArenaObjectInit(memory_arena_t *map, void *buf, size_t size) {
+
+  chDbgCheck((map != NULL) && (buf != NULL));
+
+  map->basemem = (uint8_t *)buf;
+  map->nextmem = (uint8_t *)buf;
+  map->endmem  = (uint8_t *)buf + size;
+}
+
+/**
+ * @brief   Initializes a memory arena allocating it from core memory.
+ * @note    The arena memory is never returned to the core allocator.
+ *
+ * @param[out] map      pointer to a @p memory_arena_t structure
+ * @param[in] size      size of the arena
+ * @return              The operation status.
+ * @retval false        if the arena has been initialized.
+ * @retval true         if the core memory is exhausted.
+ *
+ * @api
+ */
+bool chArenaObjectInitFromCore(memory_arena_t *map, size_t size) {
+  void *p;
+
+  p = chCoreAllocAligned(size, PORT_NATURAL_ALIGN);
+  if (p == NULL) {
+    return true;
+  }
+
+  chArenaObjectInit(map, p, size);
+
+  return false;
+}
+
+/**
+ * @brief   Initializes a memory arena allocating it from another arena.
+ * @note    The child arena is released with the parent arena blocks, it
+ *          must not be used after the parent is reset or rewound before
+ *          its allocation.
+ *
+ * @param[out] map      pointer to a @p memory_arena_t structure
+ * @param[in] parentp   pointer to the parent @p memory_arena_t structure
+ * @param[in] size      size of the arena
+ * @return              The operation status.
+ * @retval false        if the arena has been initialized.
+ * @retval true         if the parent arena is exhausted.
+ *
+ * @xclass
+ */
+bool chArenaObjectInitFromArena(memory_arena_t *map,
+                                memory_arena_t *parentp,
+                                size_t size) {
+  void *p;
+
+  p = chArenaAllocAlignedX(parentp, size, PORT_NATURAL_ALIGN);
+  if (p == NULL) {
+    return true;
+  }
+
+  chArenaObjectInit(map, p, size);
+
+  return false;
+}
+
+/**
+ * @brief   Allocates a memory block from an arena.
+ * @details The allocated block is guaranteed to be properly aligned to the
+ *          specified alignment.
+ *
+ * @param[in] map       pointer to a @p memory_arena_t structure
+ * @param[in] size      the size of the block to be allocated.
+ * @param[in] align     desired memory alignment
+ * @return              A pointer to the allocated memory block.
+ * @retval NULL         allocation failed, arena exhausted.
+ *
+ * @xclass
+ */
+void *chArenaAllocAlignedX(memory_arena_t *map, size_t size,
+                           unsigned align) {
+  uint8_t *p, *next;
+
+  chDbgCheck((map != NULL) && MEM_IS_VALID_ALIGNMENT(align));
+
+  size = MEM_ALIGN_NEXT(size, align);
+  p = (uint8_t *)MEM_ALIGN_NEXT(map->nextmem, align);
+  next = p + size;
+
+  /* Considering also the case where there is numeric overflow.*/
+  if ((next > map->endmem) || (next < map->nextmem)) {
+    return NULL;
+  }
+
+  map->nextmem = next;
+
+  return p;
+}
 #endif /* CH_CFG_USE_MEMCORE == TRUE */
 
 /** @} */
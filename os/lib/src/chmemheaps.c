@@ -29,12 +29,27 @@
  *          library functions. The main difference is that the OS heap APIs
  *          are guaranteed to be thread safe and there is the ability to
  *          return memory blocks aligned to arbitrary powers of two.<br>
+ *          Free blocks carry boundary tags, a free flag in the header and
+ *          a copy of the size in a footer, so a released block is merged
+ *          with its physical neighbours in constant time.<br>
+ *          If @p CH_CFG_HEAP_ALGORITHM_TLSF is enabled then a Two-Level
+ *          Segregated Fit strategy is used instead, free blocks are kept
+ *          in size-segregated lists indexed by two levels of bitmaps and
+ *          both allocation and release are performed in constant time
+ *          using a good-fit policy, physically adjacent free blocks are
+ *          always merged on release.<br>
+ *          If @p CH_CFG_HEAP_SLAB is enabled then small allocations from
+ *          the default heap are served by per-size-class memory pools
+ *          refilled from the heap in pages, the pools memory is never
+ *          returned to the heap.<br>
  * @pre     In order to use the heap APIs the @p CH_CFG_USE_HEAP option must
  *          be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
  * @{
  */
 
+#include <string.h>
+
 #include "ch.h"
 
 #if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
@@ -56,16 +71,103 @@
 
 #define H_BLOCK(hp)     ((hp) + 1U)
 
-#define H_LIMIT(hp)     (H_BLOCK(hp) + H_PAGES(hp))
-
 #define H_NEXT(hp)      ((hp)->free.next)
 
-#define H_PAGES(hp)     ((hp)->free.pages)
-
 #define H_HEAP(hp)      ((hp)->used.heap)
 
 #define H_SIZE(hp)      ((hp)->used.size)
 
+#if (CH_CFG_HEAP_ALGORITHM_TLSF == FALSE) || defined(__DOXYGEN__)
+#define H_LIMIT(hp)     (H_BLOCK(hp) + H_PAGES(hp))
+
+#define H_TAG(hp)       ((hp)->free.pages)
+
+#define H_PAGES(hp)     (H_TAG(hp) & CH_HEAP_SIZE_MASK)
+
+/*
+ * Boundary tag flags, kept in the two upper bits of the second header
+ * word. The free flag marks free blocks, the previous free flag marks
+ * used blocks whose physically previous block is free.
+ */
+#define H_PFREE_FLAG    (CH_HEAP_SIZE_MASK + 1U)
+
+#define H_FREE_FLAG     (H_PFREE_FLAG << 1)
+
+#define H_IS_FREE(hp)   ((H_TAG(hp) & H_FREE_FLAG) != 0U)
+
+#define H_IS_PFREE(hp)  ((H_TAG(hp) & H_PFREE_FLAG) != 0U)
+
+/*
+ * Setting the requested size of an used block, the previous free flag
+ * is preserved.
+ */
+#define H_SET_SIZE(hp, n) (H_TAG(hp) = (H_TAG(hp) & H_PFREE_FLAG) | (n))
+
+/*
+ * Size of an used block area in pages, the requested size rounded up to
+ * the next allocation unit.
+ */
+#define H_USED_PAGES(hp)                                                    \
+  (MEM_ALIGN_NEXT(H_TAG(hp) & CH_HEAP_SIZE_MASK, CH_HEAP_ALIGNMENT) /       \
+   CH_HEAP_ALIGNMENT)
+
+/*
+ * Link to the previous free block, it is stored at the start of the
+ * free block area, blocks without pages are not linked.
+ */
+#define H_PREV(hp)      (*(heap_header_t **)(void *)H_BLOCK(hp))
+
+/*
+ * Footer of a free block, it is the last word of the block area and it
+ * holds a copy of the tag word. The footer of a block without pages is
+ * its own tag word.
+ */
+#define H_FOOTER(hp)    (*((size_t *)(void *)H_LIMIT(hp) - 1U))
+#else /* CH_CFG_HEAP_ALGORITHM_TLSF == TRUE */
+#define H_LIMIT(hp)     ((heap_header_t *)((uint8_t *)H_BLOCK(hp) +         \
+                                           H_BSIZE(hp)))
+
+#define H_PREV(hp)      ((hp)->free.prev)
+
+#define H_PHYS(hp)      ((hp)->free.phys)
+
+#define H_BSIZE(hp)     ((hp)->free.bsize & ~(size_t)1)
+
+#define H_IS_FREE(hp)   (((hp)->free.bsize & (size_t)1) != 0U)
+
+#define H_SET_USED(hp, n) ((hp)->free.bsize = (n))
+
+#define H_SET_FREE(hp, n) ((hp)->free.bsize = (n) | (size_t)1)
+
+/*
+ * Smallest free block that can be split from a larger one, an header
+ * plus one allocation unit.
+ */
+#define H_MIN_SPLIT     (sizeof (heap_header_t) + CH_HEAP_ALIGNMENT)
+
+/*
+ * Blocks of this number of allocation units or greater are all kept in
+ * the last list.
+ */
+#define H_TLSF_MAX_PAGES                                                    \
+  ((size_t)1 << (CH_CFG_HEAP_TLSF_FL_COUNT + CH_CFG_HEAP_TLSF_SL_LOG2 - 1))
+
+/*
+ * Count of leading and trailing zeros of a non-zero 32 bits word.
+ */
+#if defined(port_clz)
+#define heap_clz(x)     port_clz(x)
+#elif defined(__GNUC__)
+#define heap_clz(x)     ((unsigned)__builtin_clz(x))
+#endif
+
+#if defined(port_ctz)
+#define heap_ctz(x)     port_ctz(x)
+#elif defined(__GNUC__)
+#define heap_ctz(x)     ((unsigned)__builtin_ctz(x))
+#endif
+#endif /* CH_CFG_HEAP_ALGORITHM_TLSF == TRUE */
+
 /*
  * Number of pages between two pointers in a MISRA-compatible way.
  */
@@ -74,6 +176,16 @@
   ((size_t)((p1) - (p2)))                                                   \
   /*lint -restore*/
 
+#if (CH_CFG_HEAP_SLAB == TRUE) || defined(__DOXYGEN__)
+/*
+ * Slab blocks are recognized by their owner pointer falling inside the
+ * slab classes array.
+ */
+#define H_IS_SLAB(heapp)                                                    \
+  (((void *)(heapp) >= (void *)&default_slabs[0]) &&                        \
+   ((void *)(heapp) < (void *)&default_slabs[CH_CFG_HEAP_SLAB_CLASSES]))
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -82,6 +194,21 @@
 /* Module local types.                                                       */
 /*===========================================================================*/
 
+#if (CH_CFG_HEAP_SLAB == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a slab class.
+ */
+typedef struct {
+  memory_pool_t         pool;       /**< @brief Pool of the class blocks,
+                                                header included.            */
+  size_t                size;       /**< @brief Size of the class blocks.   */
+  ucnt_t                hits;       /**< @brief Allocations served by the
+                                                pool.                       */
+  ucnt_t                misses;     /**< @brief Allocations that required
+                                                a refill.                   */
+} heap_slab_t;
+#endif
+
 /*===========================================================================*/
 /* Module local variables.                                                   */
 /*===========================================================================*/
@@ -91,10 +218,424 @@
  */
 static memory_heap_t default_heap;
 
+#if (CH_CFG_HEAP_SLAB == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Default heap slab classes.
+ */
+static heap_slab_t default_slabs[CH_CFG_HEAP_SLAB_CLASSES];
+#endif
+
 /*===========================================================================*/
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_HEAP_ALGORITHM_TLSF == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Makes a block free and links it in the free blocks list.
+ * @details The header and the footer of the block are written and the
+ *          physically next block is marked as having a free predecessor.
+ *          Blocks without pages cannot hold the list links, they are not
+ *          linked and are only recovered when a neighbour is released.
+ *
+ * @param[in] heapp     pointer to the memory heap descriptor
+ * @param[in] hp        pointer to the block header
+ * @param[in] pages     size of the block area in pages
+ *
+ * @notapi
+ */
+static void ff_insert(memory_heap_t *heapp, heap_header_t *hp, size_t pages) {
+
+  H_TAG(hp) = pages | H_FREE_FLAG;
+  H_FOOTER(hp) = pages | H_FREE_FLAG;
+  H_TAG(H_LIMIT(hp)) |= H_PFREE_FLAG;
+  if (pages > 0U) {
+    H_NEXT(hp) = H_NEXT(&heapp->header);
+    H_PREV(hp) = &heapp->header;
+    if (H_NEXT(hp) != NULL) {
+      H_PREV(H_NEXT(hp)) = hp;
+    }
+    H_NEXT(&heapp->header) = hp;
+  }
+}
+
+/**
+ * @brief   Unlinks a free block from the free blocks list.
+ * @note    The flags of the physically next block are not modified.
+ *
+ * @param[in] hp        pointer to the block header
+ *
+ * @notapi
+ */
+static void ff_remove(heap_header_t *hp) {
+
+  if (H_PAGES(hp) > 0U) {
+    H_NEXT(H_PREV(hp)) = H_NEXT(hp);
+    if (H_NEXT(hp) != NULL) {
+      H_PREV(H_NEXT(hp)) = H_PREV(hp);
+    }
+  }
+}
+
+/**
+ * @brief   Releases a block merging it with its free physical neighbours.
+ * @details The neighbours are found through the next block header and
+ *          the previous block footer, no list scan is required.
+ *
+ * @param[in] heapp     pointer to the memory heap descriptor
+ * @param[in] hp        pointer to the block header
+ * @param[in] pages     size of the block area in pages
+ *
+ * @notapi
+ */
+static void ff_release(memory_heap_t *heapp, heap_header_t *hp,
+                       size_t pages) {
+  heap_header_t *np = H_BLOCK(hp) + pages;
+
+  if (H_IS_FREE(np)) {
+    /* Merge with the next block.*/
+    ff_remove(np);
+    pages += H_PAGES(np) + 1U;
+  }
+  if (H_IS_PFREE(hp)) {
+    /* Merge with the previous block, its size is in its footer.*/
+    size_t ppages = *((size_t *)(void *)hp - 1U);
+
+    chDbgAssert((ppages & H_FREE_FLAG) != 0U, "corrupted footer");
+
+    ppages &= CH_HEAP_SIZE_MASK;
+    hp -= ppages + 1U;
+    ff_remove(hp);
+    pages += ppages + 1U;
+  }
+  ff_insert(heapp, hp, pages);
+}
+#endif /* CH_CFG_HEAP_ALGORITHM_TLSF == FALSE */
+
+#if (CH_CFG_HEAP_ALGORITHM_TLSF == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes the TLSF lists of a heap.
+ *
+ * @param[out] heapp    pointer to the memory heap descriptor
+ *
+ * @notapi
+ */
+static void tlsf_init(memory_heap_t *heapp) {
+  unsigned i, j;
+
+  heapp->fl_bitmap = 0U;
+  for (i = 0U; i < (unsigned)CH_CFG_HEAP_TLSF_FL_COUNT; i++) {
+    heapp->sl_bitmap[i] = 0U;
+    for (j = 0U; j < CH_HEAP_TLSF_SL_COUNT; j++) {
+      heapp->lists[i][j] = NULL;
+    }
+  }
+}
+
+/**
+ * @brief   Calculates the TLSF list indexes of a size in allocation units.
+ *
+ * @param[in] pages     size in allocation units
+ * @param[out] flp      pointer to the first level index
+ * @param[out] slp      pointer to the second level index
+ *
+ * @notapi
+ */
+static void tlsf_mapping(size_t pages, unsigned *flp, unsigned *slp) {
+
+  if (pages < (size_t)CH_HEAP_TLSF_SL_COUNT) {
+    /* Small blocks, linear mapping in the first class.*/
+    *flp = 0U;
+    *slp = (unsigned)pages;
+  }
+  else if (pages >= H_TLSF_MAX_PAGES) {
+    /* Blocks too large for exact indexing.*/
+    *flp = (unsigned)CH_CFG_HEAP_TLSF_FL_COUNT - 1U;
+    *slp = CH_HEAP_TLSF_SL_COUNT - 1U;
+  }
+  else {
+    unsigned msb = 31U - heap_clz((uint32_t)pages);
+
+    *flp = (msb - (unsigned)CH_CFG_HEAP_TLSF_SL_LOG2) + 1U;
+    *slp = (unsigned)(pages >> (msb - (unsigned)CH_CFG_HEAP_TLSF_SL_LOG2)) -
+           CH_HEAP_TLSF_SL_COUNT;
+  }
+}
+
+/**
+ * @brief   Inserts a block in the TLSF lists and marks it as free.
+ *
+ * @param[in] heapp     pointer to the memory heap descriptor
+ * @param[in] hp        pointer to the block header
+ * @param[in] bsize     size of the block area in bytes
+ *
+ * @notapi
+ */
+static void tlsf_insert(memory_heap_t *heapp, heap_header_t *hp,
+                        size_t bsize) {
+  unsigned fl, sl;
+
+  H_SET_FREE(hp, bsize);
+  tlsf_mapping(bsize / CH_HEAP_ALIGNMENT, &fl, &sl);
+  H_PREV(hp) = NULL;
+  H_NEXT(hp) = heapp->lists[fl][sl];
+  if (H_NEXT(hp) != NULL) {
+    H_PREV(H_NEXT(hp)) = hp;
+  }
+  heapp->lists[fl][sl] = hp;
+  heapp->fl_bitmap    |= 1U << fl;
+  heapp->sl_bitmap[fl] |= 1U << sl;
+}
+
+/**
+ * @brief   Removes a free block from the TLSF lists.
+ *
+ * @param[in] heapp     pointer to the memory heap descriptor
+ * @param[in] hp        pointer to the block header
+ *
+ * @notapi
+ */
+static void tlsf_remove(memory_heap_t *heapp, heap_header_t *hp) {
+  unsigned fl, sl;
+
+  tlsf_mapping(H_BSIZE(hp) / CH_HEAP_ALIGNMENT, &fl, &sl);
+  if (H_NEXT(hp) != NULL) {
+    H_PREV(H_NEXT(hp)) = H_PREV(hp);
+  }
+  if (H_PREV(hp) != NULL) {
+    H_NEXT(H_PREV(hp)) = H_NEXT(hp);
+  }
+  else {
+    heapp->lists[fl][sl] = H_NEXT(hp);
+    if (H_NEXT(hp) == NULL) {
+      heapp->sl_bitmap[fl] &= ~(1U << sl);
+      if (heapp->sl_bitmap[fl] == 0U) {
+        heapp->fl_bitmap &= ~(1U << fl);
+      }
+    }
+  }
+}
+
+/**
+ * @brief   Locates an aligned area inside a free block.
+ *
+ * @param[in] hp        pointer to the free block header
+ * @param[in] size      size of the area in bytes, multiple of
+ *                      @p CH_HEAP_ALIGNMENT
+ * @param[in] align     desired memory alignment
+ * @return              The header of the aligned area, the gap before it,
+ *                      if any, is large enough to be a free block.
+ * @retval NULL         if the area does not fit the block.
+ *
+ * @notapi
+ */
+static heap_header_t *tlsf_fit(heap_header_t *hp, size_t size,
+                               unsigned align) {
+  heap_header_t *ahp;
+  uint8_t *limit = (uint8_t *)H_LIMIT(hp);
+
+  ahp = (heap_header_t *)MEM_ALIGN_NEXT(H_BLOCK(hp), align) - 1U;
+  if (ahp != hp) {
+    /*lint -save -e9033 [10.8] Required cast operations.*/
+    while ((size_t)((uint8_t *)ahp - (uint8_t *)hp) < H_MIN_SPLIT) {
+      ahp = (heap_header_t *)((uint8_t *)ahp + align);
+    }
+    /*lint -restore*/
+  }
+
+  /*lint -save -e9033 [10.8] Required cast operations.*/
+  if (((uint8_t *)H_BLOCK(ahp) > limit) ||
+      ((size_t)(limit - (uint8_t *)H_BLOCK(ahp)) < size)) {
+    return NULL;
+  }
+  /*lint -restore*/
+
+  return ahp;
+}
+
+/**
+ * @brief   Finds and removes a free block able to contain an area.
+ * @details The search is performed in constant time by rounding up the
+ *          size to the next list boundary, any block found there is large
+ *          enough. If there is no such block then the list corresponding
+ *          to the exact size is scanned because it can still contain a
+ *          suitable block.
+ *
+ * @param[in] heapp     pointer to the memory heap descriptor
+ * @param[in] size      size of the area in bytes, multiple of
+ *                      @p CH_HEAP_ALIGNMENT
+ * @param[in] align     desired memory alignment
+ * @param[out] hpp      pointer to a variable that will receive the header
+ *                      of the removed block
+ * @return              The header of the aligned area inside the removed
+ *                      block.
+ * @retval NULL         if there is no suitable free block.
+ *
+ * @notapi
+ */
+static heap_header_t *tlsf_search(memory_heap_t *heapp, size_t size,
+                                  unsigned align, heap_header_t **hpp) {
+  heap_header_t *hp;
+  size_t pages, rpages;
+  unsigned fl, sl;
+
+  /* Worst case size accounting for the alignment gap.*/
+  pages = size / CH_HEAP_ALIGNMENT;
+  if (align > CH_HEAP_ALIGNMENT) {
+    pages += (align + H_MIN_SPLIT) / CH_HEAP_ALIGNMENT;
+  }
+
+  /* Rounding up to the next list boundary.*/
+  rpages = pages;
+  if ((rpages >= (size_t)CH_HEAP_TLSF_SL_COUNT) &&
+      (rpages < H_TLSF_MAX_PAGES)) {
+    unsigned msb = 31U - heap_clz((uint32_t)rpages);
+
+    rpages += ((size_t)1 << (msb - (unsigned)CH_CFG_HEAP_TLSF_SL_LOG2)) - 1U;
+  }
+
+  if (rpages < H_TLSF_MAX_PAGES) {
+    uint32_t slmap;
+
+    tlsf_mapping(rpages, &fl, &sl);
+    slmap = heapp->sl_bitmap[fl] & (0xFFFFFFFFU << sl);
+    if (slmap == 0U) {
+      uint32_t flmap = 0U;
+
+      /* No suitable list in this class, looking for larger classes.*/
+      if ((fl + 1U) < 32U) {
+        flmap = heapp->fl_bitmap & (0xFFFFFFFFU << (fl + 1U));
+      }
+      if (flmap != 0U) {
+        fl = heap_ctz(flmap);
+        slmap = heapp->sl_bitmap[fl];
+      }
+    }
+    if (slmap != 0U) {
+      heap_header_t *ahp;
+
+      hp = heapp->lists[fl][heap_ctz(slmap)];
+      ahp = tlsf_fit(hp, size, align);
+
+      chDbgAssert(ahp != NULL, "block too small");
+
+      tlsf_remove(heapp, hp);
+      *hpp = hp;
+
+      return ahp;
+    }
+  }
+
+  /* Scanning the list of the exact size.*/
+  tlsf_mapping(size / CH_HEAP_ALIGNMENT, &fl, &sl);
+  hp = heapp->lists[fl][sl];
+  while (hp != NULL) {
+    heap_header_t *ahp = tlsf_fit(hp, size, align);
+
+    if (ahp != NULL) {
+      tlsf_remove(heapp, hp);
+      *hpp = hp;
+
+      return ahp;
+    }
+    hp = H_NEXT(hp);
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Returns a block to the TLSF lists.
+ * @details The block is merged with its physical neighbours if they are
+ *          free.
+ * @note    Must be invoked with the heap locked.
+ *
+ * @param[in] heapp     pointer to the memory heap descriptor
+ * @param[in] hp        pointer to the block header
+ *
+ * @notapi
+ */
+static void tlsf_release(memory_heap_t *heapp, heap_header_t *hp) {
+
+  if (H_IS_FREE(H_LIMIT(hp))) {
+    /* Merge with the next block.*/
+    heap_header_t *np = H_LIMIT(hp);
+
+    tlsf_remove(heapp, np);
+    H_SET_USED(hp, H_BSIZE(hp) + sizeof (heap_header_t) + H_BSIZE(np));
+    H_PHYS(H_LIMIT(hp)) = hp;
+  }
+  if ((H_PHYS(hp) != NULL) && H_IS_FREE(H_PHYS(hp))) {
+    /* Merge with the previous block.*/
+    heap_header_t *pp = H_PHYS(hp);
+
+    tlsf_remove(heapp, pp);
+    H_SET_USED(pp, H_BSIZE(pp) + sizeof (heap_header_t) + H_BSIZE(hp));
+    H_PHYS(H_LIMIT(pp)) = pp;
+    hp = pp;
+  }
+  tlsf_insert(heapp, hp, H_BSIZE(hp));
+}
+#endif /* CH_CFG_HEAP_ALGORITHM_TLSF == TRUE */
+
+#if (CH_CFG_HEAP_SLAB == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Allocates a block from the smallest suitable slab class.
+ * @details If the class pool is empty then it is refilled with a page
+ *          allocated from the default heap.
+ *
+ * @param[in] size      the size of the block to be allocated, it must not
+ *                      exceed @p CH_HEAP_SLAB_MAX_SIZE
+ * @return              A pointer to the allocated block.
+ * @retval NULL         if the class cannot be refilled.
+ *
+ * @notapi
+ */
+static void *slab_alloc(size_t size) {
+  heap_slab_t *sp = &default_slabs[0];
+  heap_header_t *hp;
+
+  while (size > sp->size) {
+    sp++;
+  }
+
+  chSysLock();
+  hp = (heap_header_t *)chPoolAllocI(&sp->pool);
+  if (hp != NULL) {
+    sp->hits++;
+  }
+  else {
+    sp->misses++;
+  }
+  chSysUnlock();
+
+  if (hp == NULL) {
+    void *page;
+
+    /* Refilling the class with a new page taken from the heap.*/
+    page = chHeapAllocAligned(&default_heap, CH_CFG_HEAP_SLAB_PAGE_SIZE,
+                              CH_HEAP_ALIGNMENT);
+    if (page == NULL) {
+      return NULL;
+    }
+    chPoolLoadArray(&sp->pool, page,
+                    (size_t)CH_CFG_HEAP_SLAB_PAGE_SIZE / sp->pool.object_size);
+    hp = (heap_header_t *)chPoolAlloc(&sp->pool);
+    if (hp == NULL) {
+      return NULL;
+    }
+  }
+
+  /* The owner is the slab class, the size is still available to
+     chHeapGetSize().*/
+  /*lint -save -e9087 [11.3] Safe cast.*/
+  H_HEAP(hp) = (memory_heap_t *)(void *)sp;
+  H_SIZE(hp) = size;
+
+  return (void *)H_BLOCK(hp);
+  /*lint -restore*/
+}
+#endif /* CH_CFG_HEAP_SLAB == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -107,13 +648,31 @@ static memory_heap_t default_heap;
 void _heap_init(void) {
 
   default_heap.provider = chCoreAllocAlignedWithOffset;
+#if CH_CFG_HEAP_ALGORITHM_TLSF == FALSE
   H_NEXT(&default_heap.header) = NULL;
-  H_PAGES(&default_heap.header) = 0;
+  H_TAG(&default_heap.header) = 0U;
+#else
+  tlsf_init(&default_heap);
+#endif
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   chMtxObjectInit(&default_heap.mtx);
 #else
   chSemObjectInit(&default_heap.sem, (cnt_t)1);
 #endif
+#if CH_CFG_HEAP_SLAB == TRUE
+  {
+    unsigned i;
+
+    for (i = 0U; i < (unsigned)CH_CFG_HEAP_SLAB_CLASSES; i++) {
+      default_slabs[i].size   = (size_t)CH_CFG_HEAP_SLAB_MIN_SIZE << i;
+      default_slabs[i].hits   = (ucnt_t)0;
+      default_slabs[i].misses = (ucnt_t)0;
+      chPoolObjectInitAligned(&default_slabs[i].pool,
+                              sizeof (heap_header_t) + default_slabs[i].size,
+                              CH_HEAP_ALIGNMENT, NULL);
+    }
+  }
+#endif
 }
 
 /**
@@ -141,10 +700,29 @@ void chHeapObjectInit(memory_heap_t *heapp, void *buf, size_t size) {
 
   /* Initializing the heap header.*/
   heapp->provider = NULL;
-  H_NEXT(&heapp->header) = hp;
-  H_PAGES(&heapp->header) = 0;
-  H_NEXT(hp) = NULL;
-  H_PAGES(hp) = (size - sizeof (heap_header_t)) / CH_HEAP_ALIGNMENT;
+#if CH_CFG_HEAP_ALGORITHM_TLSF == FALSE
+  chDbgAssert(size >= sizeof (heap_header_t) * 2U, "heap too small");
+
+  /* A single free block followed by an used zero-sized block marking the
+     end of the area.*/
+  H_NEXT(&heapp->header) = NULL;
+  H_TAG(&heapp->header) = 0U;
+  H_HEAP(H_BLOCK(hp) + ((size / CH_HEAP_ALIGNMENT) - 2U)) = heapp;
+  H_TAG(H_BLOCK(hp) + ((size / CH_HEAP_ALIGNMENT) - 2U)) = 0U;
+  ff_insert(heapp, hp, (size / CH_HEAP_ALIGNMENT) - 2U);
+#else
+  chDbgAssert(size >= (sizeof (heap_header_t) * 2U) + CH_HEAP_ALIGNMENT,
+              "heap too small");
+
+  /* A single free block followed by an used zero-sized block marking the
+     end of the area.*/
+  tlsf_init(heapp);
+  H_PHYS(hp) = NULL;
+  tlsf_insert(heapp, hp, MEM_ALIGN_PREV(size - (sizeof (heap_header_t) * 2U),
+                                        CH_HEAP_ALIGNMENT));
+  H_PHYS(H_LIMIT(hp)) = hp;
+  H_SET_USED(H_LIMIT(hp), 0U);
+#endif
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   chMtxObjectInit(&heapp->mtx);
 #else
@@ -157,6 +735,8 @@ void chHeapObjectInit(memory_heap_t *heapp, void *buf, size_t size) {
  *          algorithm.
  * @details The allocated block is guaranteed to be properly aligned to the
  *          specified alignment.
+ * @note    If @p CH_CFG_HEAP_ALGORITHM_TLSF is enabled then a good-fit
+ *          block is taken from the size-segregated lists instead.
  *
  * @param[in] heapp     pointer to a heap descriptor or @p NULL in order to
  *                      access the default heap.
@@ -170,7 +750,7 @@ void chHeapObjectInit(memory_heap_t *heapp, void *buf, size_t size) {
  * @api
  */
 void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align) {
-  heap_header_t *qp, *hp, *ahp;
+  heap_header_t *hp, *ahp;
   size_t pages;
 
   chDbgCheck((size > 0U) && MEM_IS_VALID_ALIGNMENT(align));
@@ -185,18 +765,36 @@ void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align) {
     align = CH_HEAP_ALIGNMENT;
   }
 
+#if CH_CFG_HEAP_SLAB == TRUE
+  /* Small blocks from the default heap are served by the slab classes if
+     possible.*/
+  if ((heapp == &default_heap) && (size <= CH_HEAP_SLAB_MAX_SIZE) &&
+      (align == CH_HEAP_ALIGNMENT)) {
+    void *p = slab_alloc(size);
+
+    if (p != NULL) {
+      return p;
+    }
+  }
+#endif
+
+#if CH_CFG_HEAP_ALGORITHM_TLSF == FALSE
+  /* The upper bits of the size field are used by the boundary tags.*/
+  if (size > CH_HEAP_SIZE_MASK) {
+    return NULL;
+  }
+#endif
+
   /* Size is converted in number of elementary allocation units.*/
   pages = MEM_ALIGN_NEXT(size, CH_HEAP_ALIGNMENT) / CH_HEAP_ALIGNMENT;
 
+#if CH_CFG_HEAP_ALGORITHM_TLSF == FALSE
   /* Taking heap mutex/semaphore.*/
   H_LOCK(heapp);
 
   /* Start of the free blocks list.*/
-  qp = &heapp->header;
-  while (H_NEXT(qp) != NULL) {
-
-    /* Next free block.*/
-    hp = H_NEXT(qp);
+  hp = H_NEXT(&heapp->header);
+  while (hp != NULL) {
 
     /* Pointer aligned to the requested alignment.*/
     ahp = (heap_header_t *)MEM_ALIGN_NEXT(H_BLOCK(hp), align) - 1U;
@@ -204,75 +802,136 @@ void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align) {
     if ((ahp < H_LIMIT(hp)) && (pages <= NPAGES(H_LIMIT(hp), ahp + 1U))) {
       /* The block is large enough to contain a correctly aligned area
          of sufficient size.*/
+      heap_header_t *lp = H_LIMIT(hp);
+      size_t bpages = NPAGES(lp, H_BLOCK(ahp));
+
+      ff_remove(hp);
+
+      /* Setting in the block owner heap and size.*/
+      H_HEAP(ahp) = heapp;
+      H_TAG(ahp) = size;
 
       if (ahp > hp) {
-        /* The block is not properly aligned, must split it.*/
-        size_t bpages;
-
-        bpages = NPAGES(H_LIMIT(hp), H_BLOCK(ahp));
-        H_PAGES(hp) = NPAGES(ahp, H_BLOCK(hp));
-        if (bpages > pages) {
-          /* The block is bigger than required, must split the excess.*/
-          heap_header_t *fp;
-
-          /* Creating the excess block.*/
-          fp = H_BLOCK(ahp) + pages;
-          H_PAGES(fp) = (bpages - pages) - 1U;
-
-          /* Linking the excess block.*/
-          H_NEXT(fp) = H_NEXT(hp);
-          H_NEXT(hp) = fp;
-        }
+        /* The block is not properly aligned, the leading part is
+           returned to the free list as a separate block.*/
+        ff_insert(heapp, hp, NPAGES(ahp, H_BLOCK(hp)));
+      }
 
-        hp = ahp;
+      if (bpages > pages) {
+        /* The block is bigger than required, must split the excess.*/
+        ff_insert(heapp, H_BLOCK(ahp) + pages, (bpages - pages) - 1U);
       }
       else {
-        /* The block is already properly aligned.*/
-
-        if (H_PAGES(hp) == pages) {
-          /* Exact size, getting the whole block.*/
-          H_NEXT(qp) = H_NEXT(hp);
-        }
-        else {
-          /* The block is bigger than required, must split the excess.*/
-          heap_header_t *fp;
-
-          fp = H_BLOCK(hp) + pages;
-          H_NEXT(fp) = H_NEXT(hp);
-          H_PAGES(fp) = NPAGES(H_LIMIT(hp), H_BLOCK(fp));
-          H_NEXT(qp) = fp;
-        }
+        /* Exact size, the next block is no more preceded by a free
+           block.*/
+        H_TAG(lp) &= ~H_PFREE_FLAG;
       }
 
-      /* Setting in the block owner heap and size.*/
-      H_SIZE(hp) = size;
-      H_HEAP(hp) = heapp;
-
       /* Releasing heap mutex/semaphore.*/
       H_UNLOCK(heapp);
 
       /*lint -save -e9087 [11.3] Safe cast.*/
-      return (void *)H_BLOCK(hp);
+      return (void *)H_BLOCK(ahp);
       /*lint -restore*/
     }
 
     /* Next in the free blocks list.*/
-    qp = hp;
+    hp = H_NEXT(hp);
   }
 
   /* Releasing heap mutex/semaphore.*/
   H_UNLOCK(heapp);
 
   /* More memory is required, tries to get it from the associated provider
-     else fails.*/
+     else fails. The area is followed by a zero-sized used block marking
+     its end.*/
   if (heapp->provider != NULL) {
-    ahp = heapp->provider(pages * CH_HEAP_ALIGNMENT,
+    ahp = heapp->provider((pages * CH_HEAP_ALIGNMENT) + sizeof (heap_header_t),
                           align,
                           sizeof (heap_header_t));
     if (ahp != NULL) {
       hp = ahp - 1U;
       H_HEAP(hp) = heapp;
+      H_TAG(hp) = size;
+      H_HEAP(H_BLOCK(hp) + pages) = heapp;
+      H_TAG(H_BLOCK(hp) + pages) = 0U;
+
+      /*lint -save -e9087 [11.3] Safe cast.*/
+      return (void *)ahp;
+      /*lint -restore*/
+    }
+  }
+
+  return NULL;
+#else /* CH_CFG_HEAP_ALGORITHM_TLSF == TRUE */
+  /* Taking heap mutex/semaphore.*/
+  H_LOCK(heapp);
+
+  ahp = tlsf_search(heapp, pages * CH_HEAP_ALIGNMENT, align, &hp);
+  if (ahp != NULL) {
+    size_t bsize;
+
+    /*lint -save -e9033 [10.8] Required cast operations.*/
+    if (ahp != hp) {
+      /* The area does not start at the block start, the leading gap is
+         returned to the free lists as a separate block.*/
+      bsize = (size_t)((uint8_t *)H_LIMIT(hp) - (uint8_t *)H_BLOCK(ahp));
+      tlsf_insert(heapp, hp,
+                  (size_t)((uint8_t *)ahp - (uint8_t *)H_BLOCK(hp)));
+      H_PHYS(ahp) = hp;
+      H_SET_USED(ahp, bsize);
+      H_PHYS(H_LIMIT(ahp)) = ahp;
+      hp = ahp;
+    }
+    else {
+      bsize = H_BSIZE(hp);
+    }
+    /*lint -restore*/
+
+    if ((bsize - (pages * CH_HEAP_ALIGNMENT)) >= H_MIN_SPLIT) {
+      /* The block is bigger than required, must split the excess.*/
+      heap_header_t *fp;
+
+      fp = (heap_header_t *)((uint8_t *)H_BLOCK(hp) +
+                             (pages * CH_HEAP_ALIGNMENT));
+      H_PHYS(fp) = hp;
+      tlsf_insert(heapp, fp, (bsize - (pages * CH_HEAP_ALIGNMENT)) -
+                             sizeof (heap_header_t));
+      H_PHYS(H_LIMIT(fp)) = fp;
+      bsize = pages * CH_HEAP_ALIGNMENT;
+    }
+
+    /* Setting in the block owner heap and size.*/
+    H_SET_USED(hp, bsize);
+    H_SIZE(hp) = size;
+    H_HEAP(hp) = heapp;
+
+    /* Releasing heap mutex/semaphore.*/
+    H_UNLOCK(heapp);
+
+    /*lint -save -e9087 [11.3] Safe cast.*/
+    return (void *)H_BLOCK(hp);
+    /*lint -restore*/
+  }
+
+  /* Releasing heap mutex/semaphore.*/
+  H_UNLOCK(heapp);
+
+  /* More memory is required, tries to get it from the associated provider
+     else fails. The area is followed by a zero-sized used block marking
+     its end.*/
+  if (heapp->provider != NULL) {
+    ahp = heapp->provider((pages * CH_HEAP_ALIGNMENT) + sizeof (heap_header_t),
+                          align,
+                          sizeof (heap_header_t));
+    if (ahp != NULL) {
+      hp = ahp - 1U;
+      H_PHYS(hp) = NULL;
+      H_SET_USED(hp, pages * CH_HEAP_ALIGNMENT);
+      H_HEAP(hp) = heapp;
       H_SIZE(hp) = size;
+      H_PHYS(H_LIMIT(hp)) = hp;
+      H_SET_USED(H_LIMIT(hp), 0U);
 
       /*lint -save -e9087 [11.3] Safe cast.*/
       return (void *)ahp;
@@ -281,17 +940,21 @@ void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align) {
   }
 
   return NULL;
+#endif /* CH_CFG_HEAP_ALGORITHM_TLSF == TRUE */
 }
 
 /**
  * @brief   Frees a previously allocated memory block.
+ * @note    The physical neighbours are reached through the boundary tags
+ *          of the block and the release is performed in constant time
+ *          with both allocators.
  *
  * @param[in] p         pointer to the memory block to be freed
  *
  * @api
  */
 void chHeapFree(void *p) {
-  heap_header_t *qp, *hp;
+  heap_header_t *hp;
   memory_heap_t *heapp;
 
   chDbgCheck((p != NULL) && MEM_IS_ALIGNED(p, CH_HEAP_ALIGNMENT));
@@ -300,43 +963,211 @@ void chHeapFree(void *p) {
   hp = (heap_header_t *)p - 1U;
   /*lint -restore*/
   heapp = H_HEAP(hp);
-  qp = &heapp->header;
 
-  /* Size is converted in number of elementary allocation units.*/
-  H_PAGES(hp) = MEM_ALIGN_NEXT(H_SIZE(hp),
-                               CH_HEAP_ALIGNMENT) / CH_HEAP_ALIGNMENT;
+#if CH_CFG_HEAP_SLAB == TRUE
+  if (H_IS_SLAB(heapp)) {
+    /* The block belongs to a slab class, returning it to the pool.*/
+    /*lint -save -e9087 [11.3] Safe cast.*/
+    chPoolFree(&((heap_slab_t *)(void *)heapp)->pool, (void *)hp);
+    /*lint -restore*/
+
+    return;
+  }
+#endif
+
+#if CH_CFG_HEAP_ALGORITHM_TLSF == TRUE
+  chDbgAssert(!H_IS_FREE(hp), "already free");
+
+  /* Taking heap mutex/semaphore.*/
+  H_LOCK(heapp);
+
+  tlsf_release(heapp, hp);
+
+  /* Releasing heap mutex/semaphore.*/
+  H_UNLOCK(heapp);
+#else /* CH_CFG_HEAP_ALGORITHM_TLSF == FALSE */
+  chDbgAssert(!H_IS_FREE(hp), "already free");
 
   /* Taking heap mutex/semaphore.*/
   H_LOCK(heapp);
 
-  while (true) {
-    chDbgAssert((hp < qp) || (hp >= H_LIMIT(qp)), "within free block");
-
-    if (((qp == &heapp->header) || (hp > qp)) &&
-        ((H_NEXT(qp) == NULL) || (hp < H_NEXT(qp)))) {
-      /* Insertion after qp.*/
-      H_NEXT(hp) = H_NEXT(qp);
-      H_NEXT(qp) = hp;
-      /* Verifies if the newly inserted block should be merged.*/
-      if (H_LIMIT(hp) == H_NEXT(hp)) {
-        /* Merge with the next block.*/
-        H_PAGES(hp) += H_PAGES(H_NEXT(hp)) + 1U;
-        H_NEXT(hp) = H_NEXT(H_NEXT(hp));
+  ff_release(heapp, hp, H_USED_PAGES(hp));
+
+  /* Releasing heap mutex/semaphore.*/
+  H_UNLOCK(heapp);
+#endif /* CH_CFG_HEAP_ALGORITHM_TLSF == FALSE */
+
+  return;
+}
+
+/**
+ * @brief   Changes the size of a previously allocated memory block.
+ * @details The block is resized in place when possible: when shrinking the
+ *          excess is returned to the heap, when growing the block is
+ *          extended into the physically following block if it is free and
+ *          large enough. Otherwise a new block is allocated from the same
+ *          heap, the content is copied and the old block is freed.
+ * @note    A moved block is aligned to @p CH_HEAP_ALIGNMENT, a larger
+ *          alignment used for the original allocation is not preserved.
+ * @note    If the block cannot be resized then it is left untouched.
+ *
+ * @param[in] p         pointer to the memory block to be resized or @p NULL,
+ *                      in that case the block is allocated from the default
+ *                      heap
+ * @param[in] size      the new size of the block
+ * @return              A pointer to the resized block.
+ * @retval NULL         if the block cannot be resized.
+ *
+ * @api
+ */
+void *chHeapRealloc(void *p, size_t size) {
+  heap_header_t *hp;
+  memory_heap_t *heapp;
+  size_t pages;
+  void *np;
+
+  chDbgCheck(size > 0U);
+
+  if (p == NULL) {
+    return chHeapAlloc(NULL, size);
+  }
+
+  chDbgCheck(MEM_IS_ALIGNED(p, CH_HEAP_ALIGNMENT));
+
+  /*lint -save -e9087 [11.3] Safe cast.*/
+  hp = (heap_header_t *)p - 1U;
+  /*lint -restore*/
+  heapp = H_HEAP(hp);
+
+  /* Size is converted in number of elementary allocation units.*/
+  pages = MEM_ALIGN_NEXT(size, CH_HEAP_ALIGNMENT) / CH_HEAP_ALIGNMENT;
+
+#if CH_CFG_HEAP_SLAB == TRUE
+  if (H_IS_SLAB(heapp)) {
+    /* Slab blocks can only be resized within their class.*/
+    /*lint -save -e9087 [11.3] Safe cast.*/
+    if (size <= ((heap_slab_t *)(void *)heapp)->size) {
+      H_SIZE(hp) = size;
+
+      return p;
+    }
+    /*lint -restore*/
+    heapp = &default_heap;
+  }
+  else
+#endif
+  {
+#if CH_CFG_HEAP_ALGORITHM_TLSF == TRUE
+    size_t bsize, nsize = pages * CH_HEAP_ALIGNMENT;
+    bool done = true;
+
+    chDbgAssert(!H_IS_FREE(hp), "not allocated");
+
+    /* Taking heap mutex/semaphore.*/
+    H_LOCK(heapp);
+
+    bsize = H_BSIZE(hp);
+    if (nsize > bsize) {
+      heap_header_t *nhp = H_LIMIT(hp);
+
+      /* Growing into the next block if it is free and large enough.*/
+      if (H_IS_FREE(nhp) &&
+          ((bsize + sizeof (heap_header_t) + H_BSIZE(nhp)) >= nsize)) {
+        tlsf_remove(heapp, nhp);
+        bsize += sizeof (heap_header_t) + H_BSIZE(nhp);
+        H_SET_USED(hp, bsize);
+        H_PHYS(H_LIMIT(hp)) = hp;
       }
-      if ((H_LIMIT(qp) == hp)) {
-        /* Merge with the previous block.*/
-        H_PAGES(qp) += H_PAGES(hp) + 1U;
-        H_NEXT(qp) = H_NEXT(hp);
+      else {
+        done = false;
       }
-      break;
     }
-    qp = H_NEXT(qp);
+    if (done) {
+      if ((bsize - nsize) >= H_MIN_SPLIT) {
+        /* The block is bigger than required, the excess is released.*/
+        heap_header_t *fp;
+
+        /*lint -save -e9087 [11.3] Safe cast.*/
+        fp = (heap_header_t *)((uint8_t *)H_BLOCK(hp) + nsize);
+        /*lint -restore*/
+        H_PHYS(fp) = hp;
+        H_SET_USED(fp, (bsize - nsize) - sizeof (heap_header_t));
+        H_PHYS(H_LIMIT(fp)) = fp;
+        H_SET_USED(hp, nsize);
+        tlsf_release(heapp, fp);
+      }
+      H_SIZE(hp) = size;
+    }
+
+    /* Releasing heap mutex/semaphore.*/
+    H_UNLOCK(heapp);
+
+    if (done) {
+      return p;
+    }
+#else /* CH_CFG_HEAP_ALGORITHM_TLSF == FALSE */
+    size_t opages = H_USED_PAGES(hp);
+    bool done = true;
+
+    chDbgAssert(!H_IS_FREE(hp), "not allocated");
+
+    /* The upper bits of the size field are used by the boundary tags.*/
+    if (size > CH_HEAP_SIZE_MASK) {
+      return NULL;
+    }
+
+    /* Taking heap mutex/semaphore.*/
+    H_LOCK(heapp);
+
+    if (pages < opages) {
+      /* The excess becomes a separate block and it is released, it is
+         merged with the next block if free.*/
+      H_SET_SIZE(hp, size);
+      H_TAG(H_BLOCK(hp) + pages) = 0U;
+      ff_release(heapp, H_BLOCK(hp) + pages, (opages - pages) - 1U);
+    }
+    else if (pages > opages) {
+      heap_header_t *lp = H_BLOCK(hp) + opages;
+
+      /* Growing into the next block if it is free and large enough, the
+         remaining part, if any, stays in the free list.*/
+      if (H_IS_FREE(lp) && ((opages + H_PAGES(lp) + 1U) >= pages)) {
+        size_t epages = (opages + H_PAGES(lp) + 1U) - pages;
+
+        ff_remove(lp);
+        if (epages > 0U) {
+          ff_insert(heapp, H_BLOCK(hp) + pages, epages - 1U);
+        }
+        else {
+          H_TAG(H_LIMIT(lp)) &= ~H_PFREE_FLAG;
+        }
+        H_SET_SIZE(hp, size);
+      }
+      else {
+        done = false;
+      }
+    }
+    else {
+      H_SET_SIZE(hp, size);
+    }
+
+    /* Releasing heap mutex/semaphore.*/
+    H_UNLOCK(heapp);
+
+    if (done) {
+      return p;
+    }
+#endif /* CH_CFG_HEAP_ALGORITHM_TLSF == FALSE */
   }
 
-  /* Releasing heap mutex/semaphore.*/
-  H_UNLOCK(heapp);
+  /* The block cannot be resized in place, moving it.*/
+  np = chHeapAllocAligned(heapp, size, CH_HEAP_ALIGNMENT);
+  if (np != NULL) {
+    memcpy(np, p, chHeapGetSize(p));
+    chHeapFree(p);
+  }
 
-  return;
+  return np;
 }
 
 /**
@@ -366,6 +1197,37 @@ size_t chHeapStatus(memory_heap_t *heapp, size_t *totalp, size_t *largestp) {
   tpages = 0U;
   lpages = 0U;
   n = 0U;
+#if CH_CFG_HEAP_ALGORITHM_TLSF == TRUE
+  {
+    uint32_t flmap = heapp->fl_bitmap;
+
+    /* Scanning the non-empty lists only.*/
+    while (flmap != 0U) {
+      unsigned fl = heap_ctz(flmap);
+      uint32_t slmap = heapp->sl_bitmap[fl];
+
+      while (slmap != 0U) {
+        unsigned sl = heap_ctz(slmap);
+
+        qp = heapp->lists[fl][sl];
+        while (qp != NULL) {
+          size_t pages = H_BSIZE(qp) / CH_HEAP_ALIGNMENT;
+
+          /* Updating counters.*/
+          n++;
+          tpages += pages;
+          if (pages > lpages) {
+            lpages = pages;
+          }
+
+          qp = H_NEXT(qp);
+        }
+        slmap &= ~(1U << sl);
+      }
+      flmap &= ~(1U << fl);
+    }
+  }
+#else
   qp = &heapp->header;
   while (H_NEXT(qp) != NULL) {
     size_t pages = H_PAGES(H_NEXT(qp));
@@ -379,6 +1241,7 @@ size_t chHeapStatus(memory_heap_t *heapp, size_t *totalp, size_t *largestp) {
 
     qp = H_NEXT(qp);
   }
+#endif
 
   /* Writing out fragmented free memory.*/
   if (totalp != NULL) {
@@ -394,6 +1257,38 @@ size_t chHeapStatus(memory_heap_t *heapp, size_t *totalp, size_t *largestp) {
   return n;
 }
 
+#if (CH_CFG_HEAP_SLAB == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Reports the statistics of a slab class.
+ * @note    The counters allow to tune the slab classes, a high number of
+ *          misses means that the class is refilled often.
+ *
+ * @param[in] n         index of the slab class, zero is the smallest one
+ * @param[out] hitsp    pointer to a variable that will receive the number
+ *                      of allocations served by the class pool or @p NULL
+ * @param[out] missesp  pointer to a variable that will receive the number
+ *                      of allocations that required a refill or @p NULL
+ * @return              The size of the class blocks.
+ *
+ * @api
+ */
+size_t chHeapSlabStatus(unsigned n, ucnt_t *hitsp, ucnt_t *missesp) {
+
+  chDbgCheck(n < (unsigned)CH_CFG_HEAP_SLAB_CLASSES);
+
+  chSysLock();
+  if (hitsp != NULL) {
+    *hitsp = default_slabs[n].hits;
+  }
+  if (missesp != NULL) {
+    *missesp = default_slabs[n].misses;
+  }
+  chSysUnlock();
+
+  return default_slabs[n].size;
+}
+#endif /* CH_CFG_HEAP_SLAB == TRUE */
+
 #endif /* CH_CFG_USE_HEAP == TRUE */
 
 /** @} */
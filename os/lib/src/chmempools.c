@@ -29,7 +29,12 @@
  *          problems.<br>
  *          Memory Pools do not enforce any alignment constraint on the
  *          contained object however the objects must be properly aligned
- *          to contain a pointer to void.
+ *          to contain a pointer to void.<br>
+ *          If @p CH_CFG_POOL_LOCKFREE is enabled then the free list is
+ *          handled using exclusive load/store instructions, the
+ *          reservation is cleared on exceptions entry and return so a
+ *          preempted operation is simply retried and the ABA problem
+ *          cannot happen without tagging the list head.
  * @pre     In order to use the memory pools APIs the @p CH_CFG_USE_MEMPOOLS option
  *          must be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
@@ -56,6 +61,51 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_POOL_LOCKFREE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Removes the first object from the pool free list.
+ *
+ * @param[in] mp        pointer to a @p memory_pool_t structure
+ * @return              The pointer to the removed object.
+ * @retval NULL         if the free list is empty.
+ *
+ * @notapi
+ */
+static void *pool_pop(memory_pool_t *mp) {
+  struct pool_header *php;
+
+  /*lint -save -e9087 -e923 [11.3, 11.4] Required casts.*/
+  do {
+    php = (struct pool_header *)__LDREXW((volatile uint32_t *)&mp->next);
+    if (php == NULL) {
+      __CLREX();
+      break;
+    }
+  } while (__STREXW((uint32_t)php->next,
+                    (volatile uint32_t *)&mp->next) != 0U);
+  /*lint -restore*/
+
+  return (void *)php;
+}
+
+/**
+ * @brief   Inserts an object in the pool free list.
+ *
+ * @param[in] mp        pointer to a @p memory_pool_t structure
+ * @param[in] php       pointer to the object header
+ *
+ * @notapi
+ */
+static void pool_push(memory_pool_t *mp, struct pool_header *php) {
+
+  /*lint -save -e9087 -e923 [11.3, 11.4] Required casts.*/
+  do {
+    php->next = (struct pool_header *)__LDREXW((volatile uint32_t *)&mp->next);
+  } while (__STREXW((uint32_t)php, (volatile uint32_t *)&mp->next) != 0U);
+  /*lint -restore*/
+}
+#endif /* CH_CFG_POOL_LOCKFREE == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -129,6 +179,12 @@ void *chPoolAllocI(memory_pool_t *mp) {
   chDbgCheckClassI();
   chDbgCheck(mp != NULL);
 
+#if CH_CFG_POOL_LOCKFREE == TRUE
+  objp = pool_pop(mp);
+  if ((objp == NULL) && (mp->provider != NULL)) {
+    objp = mp->provider(mp->object_size, mp->align);
+  }
+#else
   objp = mp->next;
   /*lint -save -e9013 [15.7] There is no else because it is not needed.*/
   if (objp != NULL) {
@@ -138,6 +194,7 @@ void *chPoolAllocI(memory_pool_t *mp) {
     objp = mp->provider(mp->object_size, mp->align);
   }
   /*lint -restore*/
+#endif
 
   return objp;
 }
@@ -155,9 +212,21 @@ void *chPoolAllocI(memory_pool_t *mp) {
 void *chPoolAlloc(memory_pool_t *mp) {
   void *objp;
 
+#if CH_CFG_POOL_LOCKFREE == TRUE
+  chDbgCheck(mp != NULL);
+
+  /* The critical zone is only required by the provider.*/
+  objp = pool_pop(mp);
+  if ((objp == NULL) && (mp->provider != NULL)) {
+    chSysLock();
+    objp = mp->provider(mp->object_size, mp->align);
+    chSysUnlock();
+  }
+#else
   chSysLock();
   objp = chPoolAllocI(mp);
   chSysUnlock();
+#endif
 
   return objp;
 }
@@ -183,8 +252,12 @@ void chPoolFreeI(memory_pool_t *mp, void *objp) {
   chDbgAssert(((size_t)objp & MEM_ALIGN_MASK(mp->align)) == 0U,
               "unaligned object");
 
+#if CH_CFG_POOL_LOCKFREE == TRUE
+  pool_push(mp, php);
+#else
   php->next = mp->next;
   mp->next = php;
+#endif
 }
 
 /**
@@ -201,9 +274,18 @@ void chPoolFreeI(memory_pool_t *mp, void *objp) {
  */
 void chPoolFree(memory_pool_t *mp, void *objp) {
 
+#if CH_CFG_POOL_LOCKFREE == TRUE
+  chDbgCheck((mp != NULL) && (objp != NULL));
+
+  chDbgAssert(((size_t)objp & MEM_ALIGN_MASK(mp->align)) == 0U,
+              "unaligned object");
+
+  pool_push(mp, (struct pool_header *)objp);
+#else
   chSysLock();
   chPoolFreeI(mp, objp);
   chSysUnlock();
+#endif
 }
 
 #if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
@@ -324,6 +406,144 @@ void chGuardedPoolFree(guarded_memory_pool_t *gmp, void *objp) {
   chSchRescheduleS();
   chSysUnlock();
 }
+
+/**
+ * @brief   Initializes an empty magazine over a guarded memory pool.
+ *
+ * @param[out] mgp      pointer to a @p pool_magazine_t structure
+ * @param[in] gmp       pointer to the backing @p guarded_memory_pool_t
+ * @param[in] size      maximum number of cached objects, must be at least
+ *                      two
+ *
+ * @init
+ */
+void chMagazineObjectInit(pool_magazine_t *mgp,
+                          guarded_memory_pool_t *gmp,
+                          size_t size) {
+
+  chDbgCheck((mgp != NULL) && (gmp != NULL) && (size >= (size_t)2));
+
+  mgp->gmp  = gmp;
+  mgp->next = NULL;
+  mgp->cnt  = (size_t)0;
+  mgp->size = size;
+}
+
+/**
+ * @brief   Allocates an object using a magazine.
+ * @details The object is taken from the magazine, if the magazine is empty
+ *          then it is refilled with up to half of its capacity taking the
+ *          system lock once, the caller waits for the first object only.
+ *
+ * @param[in] mgp       pointer to a @p pool_magazine_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The pointer to the allocated object.
+ * @retval NULL         if the operation timed out.
+ *
+ * @api
+ */
+void *chMagazineAllocTimeout(pool_magazine_t *mgp, sysinterval_t timeout) {
+  struct pool_header *php;
+
+  chDbgCheck(mgp != NULL);
+
+  if (mgp->cnt == (size_t)0) {
+    void *objp;
+
+    chSysLock();
+    objp = chGuardedPoolAllocTimeoutS(mgp->gmp, timeout);
+    if (objp == NULL) {
+      chSysUnlock();
+
+      return NULL;
+    }
+
+    /* Refilling, the other objects are only taken if immediately
+       available.*/
+    while (mgp->cnt < ((mgp->size / (size_t)2) - (size_t)1)) {
+      php = (struct pool_header *)chGuardedPoolAllocI(mgp->gmp);
+      if (php == NULL) {
+        break;
+      }
+      php->next = mgp->next;
+      mgp->next = php;
+      mgp->cnt++;
+    }
+    chSysUnlock();
+
+    return objp;
+  }
+
+  php = mgp->next;
+  mgp->next = php->next;
+  mgp->cnt--;
+
+  return (void *)php;
+}
+
+/**
+ * @brief   Releases an object using a magazine.
+ * @details The object is cached in the magazine, if the magazine is full
+ *          then half of its objects are returned to the guarded memory
+ *          pool taking the system lock once.
+ * @pre     The freed object must belong to the backing guarded memory pool.
+ *
+ * @param[in] mgp       pointer to a @p pool_magazine_t structure
+ * @param[in] objp      the pointer to the object to be released
+ *
+ * @api
+ */
+void chMagazineFree(pool_magazine_t *mgp, void *objp) {
+  struct pool_header *php = (struct pool_header *)objp;
+
+  chDbgCheck((mgp != NULL) && (objp != NULL));
+
+  if (mgp->cnt >= mgp->size) {
+    chSysLock();
+    while (mgp->cnt > (mgp->size / (size_t)2)) {
+      struct pool_header *p = mgp->next;
+
+      mgp->next = p->next;
+      mgp->cnt--;
+      chGuardedPoolFreeI(mgp->gmp, (void *)p);
+    }
+    chSchRescheduleS();
+    chSysUnlock();
+  }
+
+  php->next = mgp->next;
+  mgp->next = php;
+  mgp->cnt++;
+}
+
+/**
+ * @brief   Returns all the cached objects to the guarded memory pool.
+ * @note    Threads waiting on the guarded memory pool are not aware of the
+ *          objects cached in magazines, idle owners should flush.
+ *
+ * @param[in] mgp       pointer to a @p pool_magazine_t structure
+ *
+ * @api
+ */
+void chMagazineFlush(pool_magazine_t *mgp) {
+
+  chDbgCheck(mgp != NULL);
+
+  chSysLock();
+  while (mgp->next != NULL) {
+    struct pool_header *p = mgp->next;
+
+    mgp->next = p->next;
+    chGuardedPoolFreeI(mgp->gmp, (void *)p);
+  }
+  mgp->cnt = (size_t)0;
+  chSchRescheduleS();
+  chSysUnlock();
+}
 #endif
 
 #endif /* CH_CFG_USE_MEMPOOLS == TRUE */
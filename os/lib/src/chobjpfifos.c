@@ -0,0 +1,316 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chobjpfifos.c
+ * @brief   Priority objects FIFOs code.
+ * @details Objects FIFOs ordered by key.
+ *          <h2>Operation mode</h2>
+ *          Sent objects are kept in a binary heap sized for all the
+ *          objects of the pool, sending is guaranteed not to block and
+ *          is an O(log N) operation, receiving the most urgent object is
+ *          also O(log N). Receivers waiting on an empty FIFO are woken up
+ *          one at time on each send.
+ * @pre     In order to use the priority objects FIFOs APIs the
+ *          @p CH_CFG_USE_OBJ_PFIFOS option must be enabled in
+ *          @p chconf.h.
+ * @note    Compatible with RT and NIL.
+ *
+ * @addtogroup oslib_prio_objects_fifos
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_OBJ_PFIFOS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Slots order, lower key first then lower send order.
+ */
+static inline bool pf_precedes(const pfifo_slot_t *a, const pfifo_slot_t *b) {
+
+  if (a->key != b->key) {
+    return (int32_t)(a->key - b->key) < (int32_t)0;
+  }
+
+  return (int32_t)(a->seq - b->seq) < (int32_t)0;
+}
+
+/**
+ * @brief   Inserts a slot in the heap.
+ */
+static void pf_heap_push(prio_objects_fifo_t *pfp, const pfifo_slot_t *sp) {
+  size_t i = pfp->cnt++;
+
+  /* Moving the parents down until the slot position is found.*/
+  while (i > (size_t)0) {
+    size_t parent = (i - (size_t)1) / (size_t)2;
+
+    if (!pf_precedes(sp, &pfp->heap[parent])) {
+      break;
+    }
+    pfp->heap[i] = pfp->heap[parent];
+    i = parent;
+  }
+  pfp->heap[i] = *sp;
+}
+
+/**
+ * @brief   Removes the heap root.
+ */
+static void *pf_heap_pop(prio_objects_fifo_t *pfp) {
+  void *objp = pfp->heap[0].objp;
+  pfifo_slot_t *last;
+  size_t i = (size_t)0;
+
+  pfp->cnt--;
+  last = &pfp->heap[pfp->cnt];
+
+  /* Moving the children up until the last slot position is found.*/
+  while (true) {
+    size_t child = (i * (size_t)2) + (size_t)1;
+
+    if (child >= pfp->cnt) {
+      break;
+    }
+    if (((child + (size_t)1) < pfp->cnt) &&
+        pf_precedes(&pfp->heap[child + (size_t)1], &pfp->heap[child])) {
+      child++;
+    }
+    if (!pf_precedes(&pfp->heap[child], last)) {
+      break;
+    }
+    pfp->heap[i] = pfp->heap[child];
+    i = child;
+  }
+  pfp->heap[i] = *last;
+
+  return objp;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a priority FIFO object.
+ * @pre     The messages size must be a multiple of the alignment
+ *          requirement.
+ *
+ * @param[out] pfp      pointer to a @p prio_objects_fifo_t structure
+ * @param[in] objsize   size of objects
+ * @param[in] objn      number of objects available
+ * @param[in] objalign  required objects alignment
+ * @param[in] objbuf    pointer to the buffer of objects, it must be able
+ *                      to hold @p objn objects of @p objsize size with
+ *                      @p objealign alignment
+ * @param[in] slotbuf   pointer to the buffer of heap slots, it must be able
+ *                      to hold @p objn slots
+ *
+ * @init
+ */
+void chPFifoObjectInit(prio_objects_fifo_t *pfp, size_t objsize,
+                       size_t objn, unsigned objalign,
+                       void *objbuf, pfifo_slot_t *slotbuf) {
+
+  chDbgCheck((pfp != NULL) && (objn > (size_t)0) && (slotbuf != NULL));
+
+  chGuardedPoolObjectInitAligned(&pfp->free, objsize, objalign);
+  chGuardedPoolLoadArray(&pfp->free, objbuf, objn);
+  pfp->heap = slotbuf;
+  pfp->size = objn;
+  pfp->cnt  = (size_t)0;
+  pfp->seq  = 0U;
+  chThdQueueObjectInit(&pfp->qr);
+}
+
+/**
+ * @brief   Posts an object.
+ * @note    By design the object can be always immediately posted.
+ *
+ * @param[in] pfp       pointer to a @p prio_objects_fifo_t structure
+ * @param[in] objp      pointer to the object to be posted
+ * @param[in] key       the object key, lower keys are received first
+ *
+ * @iclass
+ */
+void chPFifoSendObjectI(prio_objects_fifo_t *pfp,
+                        void *objp, pfifokey_t key) {
+  pfifo_slot_t slot;
+
+  chDbgCheckClassI();
+  chDbgCheck((pfp != NULL) && (objp != NULL));
+
+  chDbgAssert(pfp->cnt < pfp->size, "heap overflow");
+
+  slot.objp = objp;
+  slot.key  = key;
+  slot.seq  = pfp->seq++;
+  pf_heap_push(pfp, &slot);
+
+  /* If there is a receiver waiting then makes it ready.*/
+  chThdDequeueNextI(&pfp->qr, MSG_OK);
+}
+
+/**
+ * @brief   Posts an object.
+ * @note    By design the object can be always immediately posted.
+ *
+ * @param[in] pfp       pointer to a @p prio_objects_fifo_t structure
+ * @param[in] objp      pointer to the object to be posted
+ * @param[in] key       the object key, lower keys are received first
+ *
+ * @sclass
+ */
+void chPFifoSendObjectS(prio_objects_fifo_t *pfp,
+                        void *objp, pfifokey_t key) {
+
+  chPFifoSendObjectI(pfp, objp, key);
+  chSchRescheduleS();
+}
+
+/**
+ * @brief   Posts an object.
+ * @note    By design the object can be always immediately posted.
+ *
+ * @param[in] pfp       pointer to a @p prio_objects_fifo_t structure
+ * @param[in] objp      pointer to the object to be posted
+ * @param[in] key       the object key, lower keys are received first
+ *
+ * @api
+ */
+void chPFifoSendObject(prio_objects_fifo_t *pfp,
+                       void *objp, pfifokey_t key) {
+
+  chSysLock();
+  chPFifoSendObjectS(pfp, objp, key);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Fetches the most urgent object.
+ *
+ * @param[in] pfp       pointer to a @p prio_objects_fifo_t structure
+ * @param[out] objpp    pointer to the fetched object reference
+ * @return              The operation status.
+ * @retval MSG_OK       if an object has been correctly fetched.
+ * @retval MSG_TIMEOUT  if the FIFO is empty and a message cannot be fetched.
+ *
+ * @iclass
+ */
+msg_t chPFifoReceiveObjectI(prio_objects_fifo_t *pfp, void **objpp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((pfp != NULL) && (objpp != NULL));
+
+  if (pfp->cnt == (size_t)0) {
+    return MSG_TIMEOUT;
+  }
+
+  *objpp = pf_heap_pop(pfp);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Fetches the most urgent object.
+ *
+ * @param[in] pfp       pointer to a @p prio_objects_fifo_t structure
+ * @param[out] objpp    pointer to the fetched object reference
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if an object has been correctly fetched.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @sclass
+ */
+msg_t chPFifoReceiveObjectTimeoutS(prio_objects_fifo_t *pfp,
+                                   void **objpp, sysinterval_t timeout) {
+
+  chDbgCheckClassS();
+  chDbgCheck((pfp != NULL) && (objpp != NULL));
+
+  /* An object sent while waiting could be taken by another receiver
+     before this thread runs, the condition is checked again.*/
+  while (pfp->cnt == (size_t)0) {
+    msg_t msg = chThdEnqueueTimeoutS(&pfp->qr, timeout);
+    if (msg != MSG_OK) {
+      return msg;
+    }
+  }
+
+  *objpp = pf_heap_pop(pfp);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Fetches the most urgent object.
+ *
+ * @param[in] pfp       pointer to a @p prio_objects_fifo_t structure
+ * @param[out] objpp    pointer to the fetched object reference
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if an object has been correctly fetched.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @api
+ */
+msg_t chPFifoReceiveObjectTimeout(prio_objects_fifo_t *pfp,
+                                  void **objpp, sysinterval_t timeout) {
+  msg_t msg;
+
+  chSysLock();
+  msg = chPFifoReceiveObjectTimeoutS(pfp, objpp, timeout);
+  chSysUnlock();
+
+  return msg;
+}
+
+#endif /* CH_CFG_USE_OBJ_PFIFOS == TRUE */
+
+/** @} */
@@ -28,6 +28,10 @@
  *          - <b>Read</b>: A buffer of data is read from the read and removed.
  *          - <b>Reset</b>: The pipe is emptied and all the stored data
  *            is lost.
+ *          - <b>Reserve/Commit</b>: A contiguous region of the pipe buffer
+ *            is written in place then made available to readers.
+ *          - <b>Peek/Release</b>: A contiguous region of the pipe buffer
+ *            is read in place then removed from the pipe.
  *          .
  * @pre     In order to use the pipes APIs the @p CH_CFG_USE_PIPES
  *          option must be enabled in @p chconf.h.
@@ -190,6 +194,80 @@ static size_t pipe_read(pipe_t *pp, uint8_t *bp, size_t n) {
   return n;
 }
 
+/**
+ * @brief   Non-blocking pipe space reservation.
+ * @details The function returns the contiguous free space following the
+ *          write pointer, the space is limited by the buffer end.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[out] bpp      pointer to a variable receiving the pointer to the
+ *                      free space
+ * @param[in] n         the maximum amount of space to be reserved, the
+ *                      value 0 is reserved
+ * @return              The number of contiguous free bytes.
+ *
+ * @notapi
+ */
+static size_t pipe_reserve(pipe_t *pp, uint8_t **bpp, size_t n) {
+  size_t s1;
+
+  PC_LOCK(pp);
+
+  if (n > chPipeGetFreeCount(pp)) {
+    n = chPipeGetFreeCount(pp);
+  }
+
+  /* Number of bytes before buffer limit.*/
+  /*lint -save -e9033 [10.8] Checked to be safe.*/
+  s1 = (size_t)(pp->top - pp->wrptr);
+  /*lint -restore*/
+  if (n > s1) {
+    n = s1;
+  }
+  *bpp = pp->wrptr;
+
+  PC_UNLOCK(pp);
+
+  return n;
+}
+
+/**
+ * @brief   Non-blocking pipe data access.
+ * @details The function returns the contiguous data following the read
+ *          pointer, the data is limited by the buffer end.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[out] bpp      pointer to a variable receiving the pointer to the
+ *                      data
+ * @param[in] n         the maximum amount of data to be accessed, the
+ *                      value 0 is reserved
+ * @return              The number of contiguous data bytes.
+ *
+ * @notapi
+ */
+static size_t pipe_peek(pipe_t *pp, const uint8_t **bpp, size_t n) {
+  size_t s1;
+
+  PC_LOCK(pp);
+
+  if (n > chPipeGetUsedCount(pp)) {
+    n = chPipeGetUsedCount(pp);
+  }
+
+  /* Number of bytes before buffer limit.*/
+  /*lint -save -e9033 [10.8] Checked to be safe.*/
+  s1 = (size_t)(pp->top - pp->rdptr);
+  /*lint -restore*/
+  if (n > s1) {
+    n = s1;
+  }
+  *bpp = pp->rdptr;
+
+  PC_UNLOCK(pp);
+
+  return n;
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -318,6 +396,113 @@ size_t chPipeWriteTimeout(pipe_t *pp, const uint8_t *bp,
   return max - n;
 }
 
+/**
+ * @brief   Reserves space for in-place writing into a pipe.
+ * @details The function returns a pointer to a contiguous region of the
+ *          pipe buffer where the caller can write data in place, the
+ *          region is limited by the free space and by the buffer end so it
+ *          can be smaller than requested. If the pipe is full then the
+ *          function waits for free space for the specified timeout.
+ * @post    If the returned size is not zero then the writer side of the
+ *          pipe is owned by the invoking thread and other writers are
+ *          excluded until @p chPipeWriteCommit() is invoked by the same
+ *          thread.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[out] bpp      pointer to a variable receiving the pointer to the
+ *                      reserved region
+ * @param[in] n         the maximum number of bytes to be reserved, the
+ *                      value 0 is reserved
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The size of the reserved region. Zero means that a
+ *                      timeout occurred or the pipe went in reset state.
+ *
+ * @api
+ */
+size_t chPipeWriteReserve(pipe_t *pp, uint8_t **bpp,
+                          size_t n, sysinterval_t timeout) {
+
+  chDbgCheck((bpp != NULL) && (n > 0U));
+
+  /* If the pipe is in reset state then returns immediately.*/
+  if (pp->reset) {
+    return (size_t)0;
+  }
+
+  PW_LOCK(pp);
+
+  while (true) {
+    size_t done;
+    msg_t msg;
+
+    done = pipe_reserve(pp, bpp, n);
+    if (done > (size_t)0) {
+      /* The writer lock is kept until the commit.*/
+      return done;
+    }
+
+    chSysLock();
+    msg = chThdSuspendTimeoutS(&pp->wtr, timeout);
+    chSysUnlock();
+
+    /* Anything except MSG_OK causes the operation to stop.*/
+    if (msg != MSG_OK) {
+      break;
+    }
+  }
+
+  PW_UNLOCK(pp);
+
+  return (size_t)0;
+}
+
+/**
+ * @brief   Commits data written in place into a pipe.
+ * @details The specified number of bytes, written into the region returned
+ *          by @p chPipeWriteReserve(), are made available to readers and
+ *          the writer side of the pipe is released.
+ * @pre     A non-zero reservation must have been obtained by the invoking
+ *          thread using @p chPipeWriteReserve().
+ * @note    If the pipe has been reset after the reservation then the data
+ *          is discarded.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] n         the number of bytes to be committed, it can be
+ *                      lower than the reserved size, zero cancels the
+ *                      reservation
+ *
+ * @api
+ */
+void chPipeWriteCommit(pipe_t *pp, size_t n) {
+
+  chDbgCheck(pp != NULL);
+
+  if (n > (size_t)0) {
+    PC_LOCK(pp);
+
+    chDbgAssert(n <= chPipeGetFreeCount(pp), "commit exceeds reservation");
+
+    if (!pp->reset) {
+      pp->wrptr += n;
+      if (pp->wrptr >= pp->top) {
+        pp->wrptr = pp->buffer;
+      }
+      pp->cnt += n;
+    }
+
+    PC_UNLOCK(pp);
+
+    /* Resuming the reader, if present.*/
+    chThdResume(&pp->rtr, MSG_OK);
+  }
+
+  PW_UNLOCK(pp);
+}
+
 /**
  * @brief   Pipe read with timeout.
  * @details The function reads data from a pipe into a buffer. The
@@ -383,6 +568,113 @@ size_t chPipeReadTimeout(pipe_t *pp, uint8_t *bp,
   return max - n;
 }
 
+/**
+ * @brief   Accesses pipe data in place.
+ * @details The function returns a pointer to a contiguous region of the
+ *          pipe buffer containing data, the caller can process it in
+ *          place. The region is limited by the available data and by the
+ *          buffer end so it can be smaller than requested. If the pipe is
+ *          empty then the function waits for data for the specified
+ *          timeout.
+ * @post    If the returned size is not zero then the reader side of the
+ *          pipe is owned by the invoking thread and other readers are
+ *          excluded until @p chPipeReadRelease() is invoked by the same
+ *          thread.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[out] bpp      pointer to a variable receiving the pointer to the
+ *                      data region
+ * @param[in] n         the maximum number of bytes to be accessed, the
+ *                      value 0 is reserved
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The size of the data region. Zero means that a
+ *                      timeout occurred or the pipe went in reset state.
+ *
+ * @api
+ */
+size_t chPipeReadPeek(pipe_t *pp, const uint8_t **bpp,
+                      size_t n, sysinterval_t timeout) {
+
+  chDbgCheck((bpp != NULL) && (n > 0U));
+
+  /* If the pipe is in reset state then returns immediately.*/
+  if (pp->reset) {
+    return (size_t)0;
+  }
+
+  PR_LOCK(pp);
+
+  while (true) {
+    size_t done;
+    msg_t msg;
+
+    done = pipe_peek(pp, bpp, n);
+    if (done > (size_t)0) {
+      /* The reader lock is kept until the release.*/
+      return done;
+    }
+
+    chSysLock();
+    msg = chThdSuspendTimeoutS(&pp->rtr, timeout);
+    chSysUnlock();
+
+    /* Anything except MSG_OK causes the operation to stop.*/
+    if (msg != MSG_OK) {
+      break;
+    }
+  }
+
+  PR_UNLOCK(pp);
+
+  return (size_t)0;
+}
+
+/**
+ * @brief   Releases pipe data processed in place.
+ * @details The specified number of bytes, accessed using
+ *          @p chPipeReadPeek(), are removed from the pipe, the space is
+ *          made available to writers and the reader side of the pipe is
+ *          released.
+ * @pre     A non-zero data region must have been obtained by the invoking
+ *          thread using @p chPipeReadPeek().
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] n         the number of bytes to be released, it can be lower
+ *                      than the accessed size, zero leaves the data in the
+ *                      pipe
+ *
+ * @api
+ */
+void chPipeReadRelease(pipe_t *pp, size_t n) {
+
+  chDbgCheck(pp != NULL);
+
+  if (n > (size_t)0) {
+    PC_LOCK(pp);
+
+    chDbgAssert(n <= chPipeGetUsedCount(pp), "release exceeds data");
+
+    if (!pp->reset) {
+      pp->rdptr += n;
+      if (pp->rdptr >= pp->top) {
+        pp->rdptr = pp->buffer;
+      }
+      pp->cnt -= n;
+    }
+
+    PC_UNLOCK(pp);
+
+    /* Resuming the writer, if present.*/
+    chThdResume(&pp->wtr, MSG_OK);
+  }
+
+  PR_UNLOCK(pp);
+}
+
 #endif /* CH_CFG_USE_MAILBOXES == TRUE */
 
 /** @} */
@@ -0,0 +1,238 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chringbuffers.c
+ * @brief   Ring buffers code.
+ * @details Single producer, single consumer byte ring buffers.
+ *          <h2>Operation mode</h2>
+ *          A ring buffer is a lock-free communication mechanism between
+ *          exactly one producer and one consumer, each side can be a
+ *          thread or an ISR.<br>
+ *          Operations defined for ring buffers:
+ *          - <b>Reserve</b>: The producer obtains contiguous free space
+ *            and fills it in place.
+ *          - <b>Commit</b>: The written data becomes visible to the
+ *            consumer.
+ *          - <b>Peek</b>: The consumer obtains contiguous data and
+ *            processes it in place.
+ *          - <b>Release</b>: The processed data is removed and the space
+ *            is returned to the producer.
+ *          .
+ *          The data path does not require any lock, the kernel is only
+ *          involved when a consumer thread needs to wait for data, the
+ *          producer awakens it on the empty to non-empty transition.
+ * @pre     In order to use the ring buffers APIs the
+ *          @p CH_CFG_USE_RING_BUFFERS option must be enabled in
+ *          @p chconf.h.
+ * @note    Compatible with RT and NIL.
+ *
+ * @addtogroup oslib_ring_buffers
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+
+#if (CH_CFG_USE_RING_BUFFERS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a @p ring_buffer_t object.
+ *
+ * @param[out] rbp      the pointer to the @p ring_buffer_t structure to be
+ *                      initialized
+ * @param[in] buf       pointer to the ring buffer array of @p uint8_t
+ * @param[in] n         number of @p uint8_t elements in the buffer array,
+ *                      it must be a power of two
+ *
+ * @init
+ */
+void chRBObjectInit(ring_buffer_t *rbp, uint8_t *buf, size_t n) {
+
+  chDbgCheck((rbp != NULL) && (buf != NULL) &&
+             (n > (size_t)0) && ((n & (n - (size_t)1)) == (size_t)0));
+
+  rbp->buffer = buf;
+  rbp->size   = n;
+  rbp->wrcnt  = (size_t)0;
+  rbp->rdcnt  = (size_t)0;
+  rbp->rtr    = NULL;
+}
+
+/**
+ * @brief   Awakens the consumer thread waiting for data, if any.
+ * @note    It is meant to be invoked by the producer when
+ *          @p chRBCommitX() reports an empty to non-empty transition.
+ *
+ * @param[in] rbp       the pointer to an initialized @p ring_buffer_t object
+ *
+ * @iclass
+ */
+void chRBWakeupI(ring_buffer_t *rbp) {
+
+  chDbgCheckClassI();
+  chDbgCheck(rbp != NULL);
+
+  chThdResumeI(&rbp->rtr, MSG_OK);
+}
+
+/**
+ * @brief   Waits for data in a ring buffer.
+ * @details If the ring buffer is empty then the invoking thread waits
+ *          until the producer commits some data.
+ * @note    Only the consumer thread can invoke this function.
+ *
+ * @param[in] rbp       the pointer to an initialized @p ring_buffer_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the ring buffer contains data.
+ * @retval MSG_TIMEOUT  if the ring buffer is still empty after the
+ *                      specified timeout.
+ *
+ * @sclass
+ */
+msg_t chRBWaitTimeoutS(ring_buffer_t *rbp, sysinterval_t timeout) {
+  msg_t msg = MSG_OK;
+
+  chDbgCheckClassS();
+  chDbgCheck(rbp != NULL);
+
+  /* The check is performed within the critical zone so that the producer
+     commit cannot be missed.*/
+  if (chRBGetUsedCountX(rbp) == (size_t)0) {
+    msg = chThdSuspendTimeoutS(&rbp->rtr, timeout);
+  }
+
+  return msg;
+}
+
+/**
+ * @brief   Waits for data in a ring buffer.
+ * @details If the ring buffer is empty then the invoking thread waits
+ *          until the producer commits some data.
+ * @note    Only the consumer thread can invoke this function.
+ *
+ * @param[in] rbp       the pointer to an initialized @p ring_buffer_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the ring buffer contains data.
+ * @retval MSG_TIMEOUT  if the ring buffer is still empty after the
+ *                      specified timeout.
+ *
+ * @api
+ */
+msg_t chRBWaitTimeout(ring_buffer_t *rbp, sysinterval_t timeout) {
+  msg_t msg;
+
+  chSysLock();
+  msg = chRBWaitTimeoutS(rbp, timeout);
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Ring buffer read with timeout.
+ * @details The function copies data from a ring buffer into a buffer. The
+ *          operation completes when the specified amount of data has been
+ *          transferred or after the specified timeout.
+ * @note    Only the consumer thread can invoke this function.
+ *
+ * @param[in] rbp       the pointer to an initialized @p ring_buffer_t object
+ * @param[out] bp       pointer to the data buffer
+ * @param[in] n         the number of bytes to be read, the value 0 is
+ *                      reserved
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes effectively transferred. A number
+ *                      lower than @p n means that a timeout occurred.
+ *
+ * @api
+ */
+size_t chRBReadTimeout(ring_buffer_t *rbp, uint8_t *bp,
+                       size_t n, sysinterval_t timeout) {
+  size_t max = n;
+
+  chDbgCheck(n > 0U);
+
+  while (n > 0U) {
+    const uint8_t *p;
+    size_t done;
+
+    p = chRBPeekX(rbp, &done);
+    if (done == (size_t)0) {
+
+      /* Anything except MSG_OK causes the operation to stop.*/
+      if (chRBWaitTimeout(rbp, timeout) != MSG_OK) {
+        break;
+      }
+    }
+    else {
+      if (done > n) {
+        done = n;
+      }
+      memcpy((void *)bp, (const void *)p, done);
+      chRBReleaseX(rbp, done);
+      n  -= done;
+      bp += done;
+    }
+  }
+
+  return max - n;
+}
+
+#endif /* CH_CFG_USE_RING_BUFFERS == TRUE */
+
+/** @} */
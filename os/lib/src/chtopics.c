@@ -0,0 +1,431 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+ * @file    chtopics.c
+ * @brief   Topics bus code.
+ * @details Publish/subscribe bus of zero-copy messages.
+ *          <h2>Operation mode</h2>
+ *          A publisher allocates a message from a Memory Pool, fills it
+ *          and publishes it on a topic. The message pointer is queued on
+ *          each subscriber of the topic and a reference is added for
+ *          each queued copy, the publisher reference is then released.
+ *          Subscribers release the message after processing, the message
+ *          is returned to its pool when the last reference is released.
+ *          <br>
+ *          Publishing never blocks, when a subscriber queue is full the
+ *          subscriber policy decides if the published message or the
+ *          oldest queued one is dropped.
+ * @pre     In order to use the topics APIs the @p CH_CFG_USE_TOPICS
+ *          option must be enabled in @p chconf.h.
+ * @note    Compatible with RT and NIL.
+ *
+ * @addtogroup oslib_topics
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_TOPICS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Removes the oldest message from a subscriber queue.
+ */
+static topic_message_t *topic_queue_get(topic_subscriber_t *sp) {
+  topic_message_t *msgp = sp->buffer[sp->rdidx];
+
+  sp->rdidx++;
+  if (sp->rdidx >= sp->size) {
+    sp->rdidx = (size_t)0;
+  }
+  sp->cnt--;
+
+  return msgp;
+}
+
+/**
+ * @brief   Inserts a message in a subscriber queue.
+ */
+static void topic_queue_put(topic_subscriber_t *sp, topic_message_t *msgp) {
+  size_t wridx = sp->rdidx + sp->cnt;
+
+  if (wridx >= sp->size) {
+    wridx -= sp->size;
+  }
+  sp->buffer[wridx] = msgp;
+  sp->cnt++;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a topic subscriber object.
+ *
+ * @param[out] sp       pointer to a @p topic_subscriber_t structure
+ * @param[in] buf       pointer to the messages queue buffer, it must be
+ *                      able to hold @p n message pointers
+ * @param[in] n         queue depth
+ * @param[in] policy    queue full policy
+ *
+ * @init
+ */
+void chTopicSubscriberObjectInit(topic_subscriber_t *sp,
+                                 topic_message_t **buf, size_t n,
+                                 topic_policy_t policy) {
+
+  chDbgCheck((sp != NULL) && (buf != NULL) && (n > (size_t)0));
+
+  sp->next   = NULL;
+  sp->buffer = buf;
+  sp->size   = n;
+  sp->cnt    = (size_t)0;
+  sp->rdidx  = (size_t)0;
+  sp->policy = policy;
+  sp->drops  = (ucnt_t)0;
+  chThdQueueObjectInit(&sp->qr);
+}
+
+/**
+ * @brief   Subscribes to a topic.
+ * @details The subscriber receives the messages published after this
+ *          call.
+ *
+ * @param[in] tp        pointer to a @p topic_t structure
+ * @param[in] sp        pointer to a @p topic_subscriber_t structure
+ *
+ * @iclass
+ */
+void chTopicSubscribeI(topic_t *tp, topic_subscriber_t *sp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((tp != NULL) && (sp != NULL));
+
+  sp->next = tp->subscribers;
+  tp->subscribers = sp;
+}
+
+/**
+ * @brief   Subscribes to a topic.
+ * @details The subscriber receives the messages published after this
+ *          call.
+ *
+ * @param[in] tp        pointer to a @p topic_t structure
+ * @param[in] sp        pointer to a @p topic_subscriber_t structure
+ *
+ * @api
+ */
+void chTopicSubscribe(topic_t *tp, topic_subscriber_t *sp) {
+
+  chSysLock();
+  chTopicSubscribeI(tp, sp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Unsubscribes from a topic.
+ * @details The messages still queued on the subscriber are released,
+ *          threads waiting on the subscriber are resumed with a
+ *          @p MSG_RESET message.
+ *
+ * @param[in] tp        pointer to a @p topic_t structure
+ * @param[in] sp        pointer to a @p topic_subscriber_t structure
+ *
+ * @iclass
+ */
+void chTopicUnsubscribeI(topic_t *tp, topic_subscriber_t *sp) {
+  topic_subscriber_t **spp;
+
+  chDbgCheckClassI();
+  chDbgCheck((tp != NULL) && (sp != NULL));
+
+  for (spp = &tp->subscribers; *spp != NULL; spp = &(*spp)->next) {
+    if (*spp == sp) {
+      *spp = sp->next;
+      break;
+    }
+  }
+  sp->next = NULL;
+
+  while (sp->cnt > (size_t)0) {
+    chTopicReleaseI(topic_queue_get(sp));
+  }
+  chThdDequeueAllI(&sp->qr, MSG_RESET);
+}
+
+/**
+ * @brief   Unsubscribes from a topic.
+ * @details The messages still queued on the subscriber are released,
+ *          threads waiting on the subscriber are resumed with a
+ *          @p MSG_RESET message.
+ *
+ * @param[in] tp        pointer to a @p topic_t structure
+ * @param[in] sp        pointer to a @p topic_subscriber_t structure
+ *
+ * @api
+ */
+void chTopicUnsubscribe(topic_t *tp, topic_subscriber_t *sp) {
+
+  chSysLock();
+  chTopicUnsubscribeI(tp, sp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Publishes a message.
+ * @details The message is queued on all the subscribers of the topic,
+ *          the caller reference to the message is consumed.
+ * @note    By design publishing never blocks, subscribers with a full
+ *          queue drop a message according to their policy.
+ *
+ * @param[in] tp        pointer to a @p topic_t structure
+ * @param[in] msgp      pointer to the message to be published
+ *
+ * @iclass
+ */
+void chTopicPublishI(topic_t *tp, topic_message_t *msgp) {
+  topic_subscriber_t *sp;
+
+  chDbgCheckClassI();
+  chDbgCheck((tp != NULL) && (msgp != NULL));
+
+  chDbgAssert(msgp->refs > (ucnt_t)0, "not referenced");
+
+  for (sp = tp->subscribers; sp != NULL; sp = sp->next) {
+    if (sp->cnt >= sp->size) {
+      sp->drops++;
+      if (sp->policy == TOPIC_DROP_NEWEST) {
+        continue;
+      }
+
+      /* Making space by dropping the oldest message.*/
+      chTopicReleaseI(topic_queue_get(sp));
+    }
+
+    msgp->refs++;
+    topic_queue_put(sp, msgp);
+
+    /* If there is a receiver waiting then makes it ready.*/
+    chThdDequeueNextI(&sp->qr, MSG_OK);
+  }
+
+  /* Releasing the publisher reference, the message is freed immediately
+     if there are no subscribers.*/
+  chTopicReleaseI(msgp);
+}
+
+/**
+ * @brief   Publishes a message.
+ * @details The message is queued on all the subscribers of the topic,
+ *          the caller reference to the message is consumed.
+ * @note    By design publishing never blocks, subscribers with a full
+ *          queue drop a message according to their policy.
+ *
+ * @param[in] tp        pointer to a @p topic_t structure
+ * @param[in] msgp      pointer to the message to be published
+ *
+ * @sclass
+ */
+void chTopicPublishS(topic_t *tp, topic_message_t *msgp) {
+
+  chTopicPublishI(tp, msgp);
+  chSchRescheduleS();
+}
+
+/**
+ * @brief   Publishes a message.
+ * @details The message is queued on all the subscribers of the topic,
+ *          the caller reference to the message is consumed.
+ * @note    By design publishing never blocks, subscribers with a full
+ *          queue drop a message according to their policy.
+ *
+ * @param[in] tp        pointer to a @p topic_t structure
+ * @param[in] msgp      pointer to the message to be published
+ *
+ * @api
+ */
+void chTopicPublish(topic_t *tp, topic_message_t *msgp) {
+
+  chSysLock();
+  chTopicPublishS(tp, msgp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Receives the oldest queued message.
+ * @details The caller owns a reference to the received message and must
+ *          release it using @p chTopicRelease().
+ *
+ * @param[in] sp        pointer to a @p topic_subscriber_t structure
+ * @param[out] msgpp    pointer to the received message reference
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly received.
+ * @retval MSG_TIMEOUT  if the queue is empty.
+ *
+ * @iclass
+ */
+msg_t chTopicReceiveI(topic_subscriber_t *sp, topic_message_t **msgpp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((sp != NULL) && (msgpp != NULL));
+
+  if (sp->cnt == (size_t)0) {
+    return MSG_TIMEOUT;
+  }
+
+  *msgpp = topic_queue_get(sp);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Receives the oldest queued message.
+ * @details The caller owns a reference to the received message and must
+ *          release it using @p chTopicRelease().
+ *
+ * @param[in] sp        pointer to a @p topic_subscriber_t structure
+ * @param[out] msgpp    pointer to the received message reference
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly received.
+ * @retval MSG_RESET    if the subscriber has been unsubscribed.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @sclass
+ */
+msg_t chTopicReceiveTimeoutS(topic_subscriber_t *sp,
+                             topic_message_t **msgpp,
+                             sysinterval_t timeout) {
+
+  chDbgCheckClassS();
+  chDbgCheck((sp != NULL) && (msgpp != NULL));
+
+  /* A message queued while waiting could be taken by another receiver
+     before this thread runs, the condition is checked again.*/
+  while (sp->cnt == (size_t)0) {
+    msg_t msg = chThdEnqueueTimeoutS(&sp->qr, timeout);
+    if (msg != MSG_OK) {
+      return msg;
+    }
+  }
+
+  *msgpp = topic_queue_get(sp);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Receives the oldest queued message.
+ * @details The caller owns a reference to the received message and must
+ *          release it using @p chTopicRelease().
+ *
+ * @param[in] sp        pointer to a @p topic_subscriber_t structure
+ * @param[out] msgpp    pointer to the received message reference
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly received.
+ * @retval MSG_RESET    if the subscriber has been unsubscribed.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @api
+ */
+msg_t chTopicReceiveTimeout(topic_subscriber_t *sp,
+                            topic_message_t **msgpp,
+                            sysinterval_t timeout) {
+  msg_t msg;
+
+  chSysLock();
+  msg = chTopicReceiveTimeoutS(sp, msgpp, timeout);
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Releases a reference to a message.
+ * @details The message is returned to its pool when the last reference
+ *          is released.
+ *
+ * @param[in] msgp      pointer to the message
+ *
+ * @iclass
+ */
+void chTopicReleaseI(topic_message_t *msgp) {
+
+  chDbgCheckClassI();
+  chDbgCheck(msgp != NULL);
+
+  chDbgAssert(msgp->refs > (ucnt_t)0, "not referenced");
+
+  msgp->refs--;
+  if (msgp->refs == (ucnt_t)0) {
+    chPoolFreeI(msgp->pool, (void *)msgp);
+  }
+}
+
+/**
+ * @brief   Releases a reference to a message.
+ * @details The message is returned to its pool when the last reference
+ *          is released.
+ *
+ * @param[in] msgp      pointer to the message
+ *
+ * @api
+ */
+void chTopicRelease(topic_message_t *msgp) {
+
+  chSysLock();
+  chTopicReleaseI(msgp);
+  chSysUnlock();
+}
+
+#endif /* CH_CFG_USE_TOPICS == TRUE */
+
+/** @} */
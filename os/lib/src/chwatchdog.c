@@ -0,0 +1,223 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+ * @file    chwatchdog.c
+ * @brief   Watchdog monitor code.
+ * @details Software watchdog supervising a set of threads.
+ *          <h2>Operation mode</h2>
+ *          Supervised threads register a slot specifying the maximum
+ *          interval between heartbeats, then invoke @p chWdgHeartbeat()
+ *          on the slot at least once per interval.<br>
+ *          The monitor virtual timer scans all the slots each period,
+ *          if all the slots are alive the feed callback is invoked,
+ *          usually resetting the hardware watchdog. When a slot is found
+ *          late the failure callback is invoked and the monitor stops
+ *          feeding, the hardware watchdog is then expected to reset the
+ *          system.
+ * @pre     In order to use the watchdog monitor APIs the
+ *          @p CH_CFG_USE_WATCHDOG option must be enabled in @p chconf.h.
+ * @note    Compatible with RT only.
+ *
+ * @addtogroup oslib_watchdog
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_WATCHDOG == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Slots scan callback.
+ *
+ * @param[in] p         pointer to the @p watchdog_monitor_t object
+ */
+static void wdg_scan(void *p) {
+  watchdog_monitor_t *wmp = (watchdog_monitor_t *)p;
+  watchdog_slot_t *wsp;
+  systime_t now;
+
+  chSysLockFromISR();
+
+  now = chVTGetSystemTimeX();
+  for (wsp = wmp->slots; wsp != NULL; wsp = wsp->next) {
+    if (chTimeDiffX(wsp->last, now) > wsp->deadline) {
+      break;
+    }
+  }
+
+  if (wsp == NULL) {
+    /* All alive, scanning again after a period.*/
+    wmp->feed(wmp);
+    chVTDoSetI(&wmp->vt, wmp->period, wdg_scan, wmp);
+  }
+  else {
+    /* Failure, the monitor stops feeding.*/
+    wmp->failed = wsp;
+    if (wmp->fail != NULL) {
+      wmp->fail(wmp, wsp);
+    }
+  }
+
+  chSysUnlockFromISR();
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a @p watchdog_monitor_t object.
+ * @note    The scan period must be shorter than the hardware watchdog
+ *          timeout.
+ *
+ * @param[out] wmp      pointer to a @p watchdog_monitor_t object
+ * @param[in] period    scan period
+ * @param[in] feed      feed callback
+ * @param[in] fail      failure callback or @p NULL
+ *
+ * @init
+ */
+void chWdgObjectInit(watchdog_monitor_t *wmp, sysinterval_t period,
+                     watchdog_feed_t feed, watchdog_fail_t fail) {
+
+  chDbgCheck((wmp != NULL) && (period > (sysinterval_t)0) && (feed != NULL));
+
+  chVTObjectInit(&wmp->vt);
+  wmp->period = period;
+  wmp->slots  = NULL;
+  wmp->failed = NULL;
+  wmp->feed   = feed;
+  wmp->fail   = fail;
+}
+
+/**
+ * @brief   Starts the monitor.
+ * @details The feed callback is invoked immediately, then the slots are
+ *          scanned each period.
+ *
+ * @param[in] wmp       pointer to a @p watchdog_monitor_t object
+ *
+ * @api
+ */
+void chWdgStart(watchdog_monitor_t *wmp) {
+
+  chDbgCheck(wmp != NULL);
+
+  chSysLock();
+  chDbgAssert(!chVTIsArmedI(&wmp->vt), "already started");
+  wmp->failed = NULL;
+  wmp->feed(wmp);
+  chVTDoSetI(&wmp->vt, wmp->period, wdg_scan, wmp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Stops the monitor.
+ * @note    The hardware watchdog is no more fed after this call.
+ *
+ * @param[in] wmp       pointer to a @p watchdog_monitor_t object
+ *
+ * @api
+ */
+void chWdgStop(watchdog_monitor_t *wmp) {
+
+  chDbgCheck(wmp != NULL);
+
+  chVTReset(&wmp->vt);
+}
+
+/**
+ * @brief   Registers a slot for the current thread.
+ * @details The slot is marked alive on registration, then
+ *          @p chWdgHeartbeat() must be invoked on the slot at intervals
+ *          not longer than @p deadline.
+ * @note    The failure is detected at the first scan after the deadline,
+ *          the detection latency is up to a scan period.
+ *
+ * @param[in] wmp       pointer to a @p watchdog_monitor_t object
+ * @param[out] wsp      pointer to a @p watchdog_slot_t object
+ * @param[in] deadline  maximum interval between heartbeats
+ *
+ * @api
+ */
+void chWdgRegister(watchdog_monitor_t *wmp, watchdog_slot_t *wsp,
+                   sysinterval_t deadline) {
+
+  chDbgCheck((wmp != NULL) && (wsp != NULL) &&
+             (deadline > (sysinterval_t)0));
+
+  chSysLock();
+  wsp->thread   = chThdGetSelfX();
+  wsp->deadline = deadline;
+  wsp->last     = chVTGetSystemTimeX();
+  wsp->next     = wmp->slots;
+  wmp->slots    = wsp;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Unregisters a slot.
+ * @details The slot is no more supervised, a thread must unregister its
+ *          slot before terminating.
+ *
+ * @param[in] wmp       pointer to a @p watchdog_monitor_t object
+ * @param[in] wsp       pointer to a registered @p watchdog_slot_t object
+ *
+ * @api
+ */
+void chWdgUnregister(watchdog_monitor_t *wmp, watchdog_slot_t *wsp) {
+  watchdog_slot_t **pp;
+
+  chDbgCheck((wmp != NULL) && (wsp != NULL));
+
+  chSysLock();
+  pp = &wmp->slots;
+  while (*pp != wsp) {
+    chDbgAssert(*pp != NULL, "not registered");
+    pp = &(*pp)->next;
+  }
+  *pp = wsp->next;
+  chSysUnlock();
+}
+
+#endif /* CH_CFG_USE_WATCHDOG == TRUE */
+
+/** @} */
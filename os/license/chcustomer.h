@@ -66,6 +66,8 @@
 #define CH_CUSTOMER_LIC_PORT_CM3            TRUE
 #define CH_CUSTOMER_LIC_PORT_CM4            TRUE
 #define CH_CUSTOMER_LIC_PORT_CM7            TRUE
+#define CH_CUSTOMER_LIC_PORT_CM33           TRUE
+#define CH_CUSTOMER_LIC_PORT_CM55           TRUE
 #define CH_CUSTOMER_LIC_PORT_ARM79          TRUE
 #define CH_CUSTOMER_LIC_PORT_E200Z0         TRUE
 #define CH_CUSTOMER_LIC_PORT_E200Z2         TRUE
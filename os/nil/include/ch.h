@@ -178,6 +178,16 @@
 #define CH_CFG_NUM_THREADS                  2
 #endif
 
+/*-*
+ * @brief   Number of run-to-completion tasks in the application.
+ * @details Tasks are executed to completion, in priority order, by the
+ *          @p chTaskDispatcher() thread on its own stack. Zero disables
+ *          the tasks support.
+ */
+#if !defined(CH_CFG_NUM_TASKS) || defined(__DOXYGEN__)
+#define CH_CFG_NUM_TASKS                    0
+#endif
+
 /*-*
  * @brief   System time counter resolution.
  * @note    Allowed values are 16 or 32 bits.
@@ -487,9 +497,12 @@
 #error "at least one thread must be defined"
 #endif
 
-#if CH_CFG_NUM_THREADS > 16
-#error "ChibiOS/NIL is not recommended for thread-intensive applications,"  \
-       "consider ChibiOS/RT instead"
+#if CH_CFG_NUM_THREADS > 32
+#error "ChibiOS/NIL supports up to 32 threads, consider ChibiOS/RT instead"
+#endif
+
+#if (CH_CFG_NUM_TASKS < 0) || (CH_CFG_NUM_TASKS > 32)
+#error "invalid CH_CFG_NUM_TASKS specified, must be between 0 and 32"
 #endif
 
 #if (CH_CFG_ST_RESOLUTION != 16) && (CH_CFG_ST_RESOLUTION != 32)
@@ -591,6 +604,23 @@ typedef struct nil_threads_queue threads_queue_t;
 typedef threads_queue_t semaphore_t;
 #endif /* CH_CFG_USE_SEMAPHORES == TRUE */
 
+#if (CH_CFG_USE_EVENTS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of an event listener.
+ * @details A listener links an object to a set of event flags of a thread,
+ *          the producers of the object signal the listener after
+ *          signaling it. A thread can wait on several objects using
+ *          @p chEvtWaitAnyTimeout() on the union of the registered masks.
+ * @note    Semaphores and queues do not reference listeners, the producer
+ *          must call @p chEvtListenerSignalI() explicitly after signaling
+ *          the object. This keeps the objects size unchanged.
+ */
+typedef struct nil_event_listener {
+  thread_t          *tp;        /**< @brief Listening thread or @p NULL.    */
+  eventmask_t       events;     /**< @brief Events to be signaled.          */
+} event_listener_t;
+#endif /* CH_CFG_USE_EVENTS == TRUE */
+
 /**
  * @brief Thread function.
  */
@@ -649,6 +679,44 @@ struct nil_thread {
   CH_CFG_THREAD_EXT_FIELDS
 };
 
+#if (CH_CFG_NUM_TASKS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Task function.
+ * @details The function receives the pending events cleared by the
+ *          dispatcher, it must return without waiting.
+ */
+typedef void (*taskfunc_t)(void *arg, eventmask_t events);
+
+/**
+ * @brief   Type of a structure representing a task static configuration.
+ */
+typedef struct nil_task_cfg task_config_t;
+
+/**
+ * @brief   Structure representing a task static configuration.
+ */
+struct nil_task_cfg {
+  const char        *namep;     /**< @brief Task name, for debugging.       */
+  taskfunc_t        funcp;      /**< @brief Task function.                  */
+  void              *arg;       /**< @brief Task function argument.         */
+};
+
+/**
+ * @brief   Type of a structure representing a task.
+ */
+typedef struct nil_task task_t;
+
+/**
+ * @brief   Structure representing a task.
+ * @note    Tasks have no stack, they are executed on the stack of the
+ *          dispatcher thread.
+ */
+struct nil_task {
+  eventmask_t       epmask;     /**< @brief Pending events mask.            */
+  cnt_t             cnt;        /**< @brief Pending posts counter.          */
+};
+#endif /* CH_CFG_NUM_TASKS > 0 */
+
 /**
  * @brief   Type of a structure representing the system.
  */
@@ -670,6 +738,12 @@ struct nil_system {
    *          or to an higher priority thread if a switch is required.
    */
   thread_t              *next;
+  /**
+   * @brief   Ready threads mask.
+   * @details Bit @p n is set if the thread @p n is ready, the idle thread
+   *          is not included because it is always ready.
+   */
+  uint32_t              rdymask;
 #if (CH_CFG_ST_TIMEDELTA == 0) || defined(__DOXYGEN__)
   /**
    * @brief   System time.
@@ -710,6 +784,29 @@ struct nil_system {
    * @brief   Thread structures for all the defined threads.
    */
   thread_t              threads[CH_CFG_NUM_THREADS + 1];
+#if (CH_CFG_NUM_TASKS > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   Ready tasks mask.
+   * @details Bit @p n is set if the task @p n has pending events or posts.
+   */
+  uint32_t              tskrdymask;
+  /**
+   * @brief   Dispatcher thread.
+   */
+  thread_t              *tskthread;
+  /**
+   * @brief   Reference to the dispatcher waiting for ready tasks.
+   */
+  thread_reference_t    tskwait;
+  /**
+   * @brief   Pointer to the running task or @p NULL.
+   */
+  task_t                *tskcurrent;
+  /**
+   * @brief   Task structures for all the defined tasks.
+   */
+  task_t                tasks[CH_CFG_NUM_TASKS];
+#endif
 };
 
 /*===========================================================================*/
@@ -751,6 +848,31 @@ struct nil_system {
 };
 /** @} */
 
+/**
+ * @name    Tasks tables definition macros
+ * @{
+ */
+/**
+ * @brief   Start of user tasks table.
+ * @note    Tasks are listed in decreasing priority order, the number of
+ *          entries must match @p CH_CFG_NUM_TASKS.
+ */
+#define TASK_TABLE_BEGIN                                                    \
+  const task_config_t nil_task_configs[CH_CFG_NUM_TASKS] = {
+
+/**
+ * @brief   Entry of user tasks table.
+ */
+#define TASK_TABLE_ENTRY(name, funcp, arg)                                  \
+  {name, funcp, arg},
+
+/**
+ * @brief   End of user tasks table.
+ */
+#define TASK_TABLE_END                                                      \
+};
+/** @} */
+
 /**
  * @name    Memory alignment support macros
  */
@@ -832,6 +954,12 @@ struct nil_system {
  *          the port layer could define optimizations for thread functions.
  */
 #define THD_FUNCTION(tname, arg) PORT_THD_FUNCTION(tname, arg)
+
+/**
+ * @brief   Task declaration macro.
+ */
+#define TASK_FUNCTION(tname, arg, events)                                   \
+  void tname(void *arg, eventmask_t events)
 /** @} */
 
 /**
@@ -1363,6 +1491,39 @@ struct nil_system {
 #define chSemGetCounterI(sp) ((sp)->cnt)
 #endif /* CH_CFG_USE_SEMAPHORES == TRUE */
 
+#if (CH_CFG_USE_EVENTS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes an event listener object.
+ *
+ * @param[out] elp      pointer to the @p event_listener_t object
+ *
+ * @init
+ */
+#define chEvtListenerObjectInit(elp) ((elp)->tp = NULL)
+
+/**
+ * @brief   Verifies if a thread is registered on the listener.
+ *
+ * @param[in] elp       pointer to the @p event_listener_t object
+ * @return              The listener state.
+ * @retval false        if no thread is registered.
+ * @retval true         if a thread is registered.
+ *
+ * @iclass
+ */
+#define chEvtListenerIsRegisteredI(elp) ((bool)((elp)->tp != NULL))
+#endif /* CH_CFG_USE_EVENTS == TRUE */
+
+#if (CH_CFG_NUM_TASKS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns a pointer to the running @p task_t.
+ * @note    The value is meaningful only when invoked from a task.
+ *
+ * @xclass
+ */
+#define chTaskGetSelfX() nil.tskcurrent
+#endif /* CH_CFG_NUM_TASKS > 0 */
+
 /**
  * @brief   Current system time.
  * @details Returns the number of system ticks since the @p chSysInit()
@@ -1510,6 +1671,9 @@ extern stkalign_t __main_thread_stack_base__, __main_thread_stack_end__;
 #endif
 extern nil_system_t nil;
 extern const thread_config_t nil_thd_configs[CH_CFG_NUM_THREADS + 1];
+#if CH_CFG_NUM_TASKS > 0
+extern const task_config_t nil_task_configs[CH_CFG_NUM_TASKS];
+#endif
 #endif
 
 #ifdef __cplusplus
@@ -1550,6 +1714,17 @@ extern "C" {
   void chEvtSignal(thread_t *tp, eventmask_t mask);
   void chEvtSignalI(thread_t *tp, eventmask_t mask);
   eventmask_t chEvtWaitAnyTimeout(eventmask_t mask, sysinterval_t timeout);
+  void chEvtListenerRegister(event_listener_t *elp, eventmask_t events);
+  void chEvtListenerUnregister(event_listener_t *elp);
+  void chEvtListenerSignalI(event_listener_t *elp);
+  void chEvtListenerSignal(event_listener_t *elp);
+#endif
+#if CH_CFG_NUM_TASKS > 0
+  THD_FUNCTION(chTaskDispatcher, arg);
+  void chTaskSignal(task_t *tkp, eventmask_t mask);
+  void chTaskSignalI(task_t *tkp, eventmask_t mask);
+  void chTaskPost(task_t *tkp);
+  void chTaskPostI(task_t *tkp);
 #endif
 #if CH_DBG_SYSTEM_STATE_CHECK == TRUE
   void _dbg_check_disable(void);
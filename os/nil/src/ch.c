@@ -31,6 +31,46 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+/**
+ * @brief   Mask of all the user threads in the ready mask.
+ */
+#if (CH_CFG_NUM_THREADS == 32) || defined(__DOXYGEN__)
+#define NIL_ALL_THREADS_MASK        0xFFFFFFFFU
+#else
+#define NIL_ALL_THREADS_MASK        ((1U << CH_CFG_NUM_THREADS) - 1U)
+#endif
+
+/**
+ * @brief   Bit of a user thread in the ready mask.
+ */
+#define NIL_THD_MASK(tp)            (1U << (uint32_t)((tp) - nil.threads))
+
+/**
+ * @brief   Bit of a task in the ready tasks mask.
+ */
+#define NIL_TASK_MASK(tkp)          (1U << (uint32_t)((tkp) - nil.tasks))
+
+/**
+ * @brief   Count of trailing zeros of a non-zero 32 bits word.
+ * @note    The port layer can provide an optimized @p port_ctz() macro.
+ */
+#if defined(port_ctz) || defined(__DOXYGEN__)
+#define nil_ctz(x)                  port_ctz(x)
+#elif defined(__GNUC__)
+#define nil_ctz(x)                  ((unsigned)__builtin_ctz(x))
+#else
+static inline unsigned nil_ctz(uint32_t x) {
+  unsigned n = 0U;
+
+  while ((x & 1U) == 0U) {
+    x >>= 1;
+    n++;
+  }
+
+  return n;
+}
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -57,17 +97,22 @@ nil_system_t nil;
  * @param[in] p         object pointer
  */
 static thread_t *nil_find_thread(tstate_t state, void * p) {
-  thread_t *tp = nil.threads;
+  uint32_t mask = ~nil.rdymask & NIL_ALL_THREADS_MASK;
 
+  /* Only the threads not in the ready mask are scanned, in priority
+     order. Sleeping threads with a higher priority than the waiter are
+     still visited before it is found.*/
   while (true) {
+    thread_t *tp;
+
+    chDbgAssert(mask != 0U, "thread not found");
+
     /* Is this thread matching?*/
+    tp = &nil.threads[nil_ctz(mask)];
     if ((tp->state == state) && (tp->u1.p == p)) {
       return tp;
     }
-    tp++;
-
-    chDbgAssert(tp < &nil.threads[CH_CFG_NUM_THREADS],
-                "pointer out of range");
+    mask &= mask - 1U;
   }
 }
 
@@ -83,24 +128,42 @@ static thread_t *nil_find_thread(tstate_t state, void * p) {
  * @iclass
  */
 static cnt_t nil_ready_all(void * p, cnt_t cnt, msg_t msg) {
-  thread_t *tp = nil.threads;;
+  uint32_t mask = ~nil.rdymask & NIL_ALL_THREADS_MASK;
 
+  /* The mask is a snapshot, threads readied in the loop are not
+     scanned again.*/
   while (cnt < (cnt_t)0) {
+    thread_t *tp;
 
-    chDbgAssert(tp < &nil.threads[CH_CFG_NUM_THREADS],
-                "pointer out of range");
+    chDbgAssert(mask != 0U, "thread not found");
 
     /* Is this thread waiting on this queue?*/
+    tp = &nil.threads[nil_ctz(mask)];
     if ((tp->state == NIL_STATE_WTQUEUE) && (tp->u1.p == p)) {
       cnt++;
       (void) chSchReadyI(tp, msg);
     }
-    tp++;
+    mask &= mask - 1U;
   }
 
   return cnt;
 }
 
+#if (CH_CFG_NUM_TASKS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Makes a task ready and wakes up the dispatcher.
+ *
+ * @param[in] tkp       pointer to the @p task_t object
+ *
+ * @iclass
+ */
+static void nil_task_ready(task_t *tkp) {
+
+  nil.tskrdymask |= NIL_TASK_MASK(tkp);
+  chThdResumeI(&nil.tskwait, MSG_OK);
+}
+#endif
+
 /*===========================================================================*/
 /* Module interrupt handlers.                                                */
 /*===========================================================================*/
@@ -334,6 +397,7 @@ void chSysInit(void) {
 
   /* Runs the highest priority thread, the current one becomes the idle
      thread.*/
+  nil.rdymask = NIL_ALL_THREADS_MASK;
   nil.current = nil.next = nil.threads;
   port_switch(nil.current, tp);
   chSysUnlock();
@@ -608,6 +672,7 @@ thread_t *chSchReadyI(thread_t *tp, msg_t msg) {
   tp->u1.msg = msg;
   tp->state = NIL_STATE_READY;
   tp->timeout = (sysinterval_t)0;
+  nil.rdymask |= NIL_THD_MASK(tp);
   if (tp < nil.next) {
     nil.next = tp;
   }
@@ -687,9 +752,14 @@ msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout) {
 
   chDbgAssert(otp != &nil.threads[CH_CFG_NUM_THREADS],
                "idle cannot sleep");
+#if CH_CFG_NUM_TASKS > 0
+  chDbgAssert((otp != nil.tskthread) || (nil.tskcurrent == NULL),
+              "task cannot sleep");
+#endif
 
   /* Storing the wait object for the current thread.*/
   otp->state = newstate;
+  nil.rdymask &= ~NIL_THD_MASK(otp);
 
 #if CH_CFG_ST_TIMEDELTA > 0
   if (timeout != TIME_INFINITE) {
@@ -727,24 +797,22 @@ msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout) {
   otp->timeout = timeout;
 #endif
 
-  /* Scanning the whole threads array.*/
-  ntp = nil.threads;
-  while (true) {
-    /* Is this thread ready to execute?*/
-    if (NIL_THD_IS_READY(ntp)) {
-      nil.current = nil.next = ntp;
-      if (ntp == &nil.threads[CH_CFG_NUM_THREADS]) {
-        CH_CFG_IDLE_ENTER_HOOK();
-      }
-      port_switch(ntp, otp);
-      return nil.current->u1.msg;
-    }
+  /* The highest priority ready thread is the lowest bit set in the ready
+     mask, the idle thread if the mask is empty.*/
+  if (nil.rdymask != 0U) {
+    ntp = &nil.threads[nil_ctz(nil.rdymask)];
+  }
+  else {
+    ntp = &nil.threads[CH_CFG_NUM_THREADS];
+  }
+  chDbgAssert(NIL_THD_IS_READY(ntp), "not ready");
 
-    /* Points to the next thread in lowering priority order.*/
-    ntp++;
-    chDbgAssert(ntp <= &nil.threads[CH_CFG_NUM_THREADS],
-                "pointer out of range");
+  nil.current = nil.next = ntp;
+  if (ntp == &nil.threads[CH_CFG_NUM_THREADS]) {
+    CH_CFG_IDLE_ENTER_HOOK();
   }
+  port_switch(ntp, otp);
+  return nil.current->u1.msg;
 }
 
 /**
@@ -1178,6 +1246,217 @@ eventmask_t chEvtWaitAnyTimeout(eventmask_t mask, sysinterval_t timeout) {
 
   return m;
 }
+
+/**
+ * @brief   Registers the current thread on an event listener.
+ * @details The specified event flags are signaled to the current thread
+ *          each time the listener is signaled, a previous registration is
+ *          replaced.
+ *
+ * @param[in] elp       pointer to the @p event_listener_t object
+ * @param[in] events    the event flags set to be signaled
+ *
+ * @api
+ */
+void chEvtListenerRegister(event_listener_t *elp, eventmask_t events) {
+
+  chDbgCheck(elp != NULL);
+
+  chSysLock();
+  elp->tp     = nil.current;
+  elp->events = events;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Unregisters the thread from an event listener.
+ *
+ * @param[in] elp       pointer to the @p event_listener_t object
+ *
+ * @api
+ */
+void chEvtListenerUnregister(event_listener_t *elp) {
+
+  chDbgCheck(elp != NULL);
+
+  chSysLock();
+  elp->tp = NULL;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Signals the thread registered on an event listener.
+ * @details Nothing happens if there is no registered thread.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel. Note that
+ *          interrupt handlers always reschedule on exit so an explicit
+ *          reschedule must not be performed in ISRs.
+ *
+ * @param[in] elp       pointer to the @p event_listener_t object
+ *
+ * @iclass
+ */
+void chEvtListenerSignalI(event_listener_t *elp) {
+
+  chDbgCheckClassI();
+  chDbgCheck(elp != NULL);
+
+  if (elp->tp != NULL) {
+    chEvtSignalI(elp->tp, elp->events);
+  }
+}
+
+/**
+ * @brief   Signals the thread registered on an event listener.
+ * @details Nothing happens if there is no registered thread.
+ *
+ * @param[in] elp       pointer to the @p event_listener_t object
+ *
+ * @api
+ */
+void chEvtListenerSignal(event_listener_t *elp) {
+
+  chSysLock();
+  chEvtListenerSignalI(elp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
 #endif /* CH_CFG_USE_EVENTS == TRUE */
 
+#if (CH_CFG_NUM_TASKS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Tasks dispatcher thread.
+ * @details The ready tasks are executed to completion, in priority order,
+ *          on the stack of this thread. The dispatcher must be listed in
+ *          the threads table, its priority is the priority of all the
+ *          tasks relative to the threads and its working area must fit
+ *          the deepest task.
+ * @note    A task activated while another one is running is executed
+ *          after the running one returns.
+ *
+ * @param[in] arg       ignored
+ *
+ * @special
+ */
+THD_FUNCTION(chTaskDispatcher, arg) {
+
+  (void)arg;
+
+  chSysLock();
+
+  chDbgAssert(nil.tskthread == NULL, "multiple dispatchers");
+
+  nil.tskthread = nil.current;
+  while (true) {
+    if (nil.tskrdymask == 0U) {
+      (void) chThdSuspendTimeoutS(&nil.tskwait, TIME_INFINITE);
+    }
+    else {
+      /* The highest priority ready task is the lowest bit set in the
+         ready tasks mask, pending events are consumed all together while
+         posts are consumed one per execution.*/
+      unsigned n = nil_ctz(nil.tskrdymask);
+      task_t *tkp = &nil.tasks[n];
+      eventmask_t events = tkp->epmask;
+
+      tkp->epmask = (eventmask_t)0;
+      if (tkp->cnt > (cnt_t)0) {
+        tkp->cnt--;
+      }
+      if (tkp->cnt == (cnt_t)0) {
+        nil.tskrdymask &= ~NIL_TASK_MASK(tkp);
+      }
+
+      nil.tskcurrent = tkp;
+      chSysUnlock();
+      nil_task_configs[n].funcp(nil_task_configs[n].arg, events);
+      chSysLock();
+      nil.tskcurrent = NULL;
+    }
+  }
+}
+
+/**
+ * @brief   Adds a set of event flags to the specified task.
+ * @details The task is made ready, all the events pending when it is
+ *          executed are passed to the task function.
+ *
+ * @param[in] tkp       the task to be signaled
+ * @param[in] mask      the event flags set to be ORed
+ *
+ * @api
+ */
+void chTaskSignal(task_t *tkp, eventmask_t mask) {
+
+  chSysLock();
+  chTaskSignalI(tkp, mask);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Adds a set of event flags to the specified task.
+ * @details The task is made ready, all the events pending when it is
+ *          executed are passed to the task function.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel. Note that
+ *          interrupt handlers always reschedule on exit so an explicit
+ *          reschedule must not be performed in ISRs.
+ *
+ * @param[in] tkp       the task to be signaled
+ * @param[in] mask      the event flags set to be ORed
+ *
+ * @iclass
+ */
+void chTaskSignalI(task_t *tkp, eventmask_t mask) {
+
+  chDbgCheckClassI();
+  chDbgCheck((tkp >= nil.tasks) && (tkp < &nil.tasks[CH_CFG_NUM_TASKS]));
+
+  if (mask != (eventmask_t)0) {
+    tkp->epmask |= mask;
+    nil_task_ready(tkp);
+  }
+}
+
+/**
+ * @brief   Posts an activation to the specified task.
+ * @details Posts are counted like semaphore signals, the task is executed
+ *          once for each post.
+ *
+ * @param[in] tkp       the task to be activated
+ *
+ * @api
+ */
+void chTaskPost(task_t *tkp) {
+
+  chSysLock();
+  chTaskPostI(tkp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Posts an activation to the specified task.
+ * @details Posts are counted like semaphore signals, the task is executed
+ *          once for each post.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel. Note that
+ *          interrupt handlers always reschedule on exit so an explicit
+ *          reschedule must not be performed in ISRs.
+ *
+ * @param[in] tkp       the task to be activated
+ *
+ * @iclass
+ */
+void chTaskPostI(task_t *tkp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((tkp >= nil.tasks) && (tkp < &nil.tasks[CH_CFG_NUM_TASKS]));
+
+  tkp->cnt++;
+  nil_task_ready(tkp);
+}
+#endif /* CH_CFG_NUM_TASKS > 0 */
+
 /** @} */
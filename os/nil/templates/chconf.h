@@ -45,6 +45,13 @@
  */
 #define CH_CFG_NUM_THREADS                  3
 
+/**
+ * @brief   Number of run-to-completion tasks in the application.
+ * @note    Tasks are executed by the @p chTaskDispatcher() thread, zero
+ *          disables the tasks support.
+ */
+#define CH_CFG_NUM_TASKS                    0
+
 /** @} */
 
 /*===========================================================================*/
@@ -140,6 +147,29 @@
  */
 #define CH_CFG_USE_HEAP                     TRUE
 
+/**
+ * @brief   TLSF heap allocator.
+ * @details If enabled then the heap uses a Two-Level Segregated Fit
+ *          allocator with constant time allocation and release instead
+ *          of the first-fit allocator.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_HEAP.
+ * @note    The block header takes 16 bytes on 32 bits architectures and
+ *          32 bytes on 64 bits architectures, twice the first-fit one.
+ */
+#define CH_CFG_HEAP_ALGORITHM_TLSF          FALSE
+
+/**
+ * @brief   Slab front-end for the default heap.
+ * @details If enabled then small allocations from the default heap are
+ *          served by per-size-class memory pools refilled from the heap.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_HEAP and @p CH_CFG_USE_MEMPOOLS.
+ */
+#define CH_CFG_HEAP_SLAB                    FALSE
+
 /**
  * @brief   Memory Pools Allocator APIs.
  * @details If enabled then the memory pools allocator APIs are included
@@ -149,6 +179,17 @@
  */
 #define CH_CFG_USE_MEMPOOLS                 TRUE
 
+/**
+ * @brief   Lock-free memory pools.
+ * @details If enabled then memory pools objects are allocated and released
+ *          using exclusive load/store instructions without entering
+ *          critical zones.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires an ARMv7-M or ARMv7E-M port.
+ */
+#define CH_CFG_POOL_LOCKFREE                FALSE
+
 /**
  * @brief  Objects FIFOs APIs.
  * @details If enabled then the objects FIFOs APIs are included
@@ -167,6 +208,35 @@
  */
 #define CH_CFG_USE_PIPES                    TRUE
 
+/**
+ * @brief   Ring buffers APIs.
+ * @details If enabled then the lock-free single producer single consumer
+ *          ring buffers APIs are included in the kernel.
+ *
+ * @note    The default is @p TRUE.
+ */
+#define CH_CFG_USE_RING_BUFFERS             TRUE
+
+/**
+ * @brief   Priority objects FIFOs APIs.
+ * @details If enabled then the objects FIFOs ordered by key are included
+ *          in the kernel.
+ *
+ * @note    The default is @p TRUE.
+ * @note    Requires @p CH_CFG_USE_MEMPOOLS and @p CH_CFG_USE_SEMAPHORES.
+ */
+#define CH_CFG_USE_OBJ_PFIFOS               TRUE
+
+/**
+ * @brief   Topics bus APIs.
+ * @details If enabled then the publish/subscribe topics are included in
+ *          the kernel.
+ *
+ * @note    The default is @p TRUE.
+ * @note    Requires @p CH_CFG_USE_MEMPOOLS.
+ */
+#define CH_CFG_USE_TOPICS                   TRUE
+
 /**
  * @brief   Managed RAM size.
  * @details Size of the RAM area to be managed by the OS. If set to zero
@@ -180,6 +250,23 @@
  */
 #define CH_CFG_MEMCORE_SIZE                 0
 
+/**
+ * @brief   Number of additional memory regions.
+ * @details Regions are further core allocators over memory areas with
+ *          specific attributes, they are registered by the application
+ *          using @p chCoreRegionInit().
+ *
+ * @note    Requires @p CH_CFG_USE_MEMCORE.
+ */
+#define CH_CFG_MEMCORE_REGIONS              0
+
+/**
+ * @brief   Attributes of the main core memory.
+ *
+ * @note    Requires @p CH_CFG_USE_MEMCORE.
+ */
+#define CH_CFG_MEMCORE_ATTRS                CH_MEM_ATTR_NONE
+
 /** @} */
 
 /*===========================================================================*/
@@ -205,6 +292,12 @@
  */
 #define CH_CFG_FACTORY_MAX_NAMES_LENGTH     8
 
+/**
+ * @brief   Number of hash buckets of each objects list.
+ * @note    Zero disables the hashed lookup, else a power of two.
+ */
+#define CH_CFG_FACTORY_HASH_BUCKETS         0
+
 /**
  * @brief   Enables the registry of generic objects.
  */
@@ -111,6 +111,7 @@ extern "C" {
 #include "chtrace.h"
 #include "chtm.h"
 #include "chstats.h"
+#include "chwprof.h"
 #include "chschd.h"
 #include "chsys.h"
 #include "chvt.h"
@@ -121,14 +122,17 @@ extern "C" {
 #include "chsem.h"
 #include "chmtx.h"
 #include "chcond.h"
+#include "chrwlock.h"
 #include "chevents.h"
 #include "chmsg.h"
+#include "chworkq.h"
 
 /* OSLIB.*/
 #include "chlib.h"
 
 /* Headers dependent on the OSLIB.*/
 #include "chdynamic.h"
+#include "chwaitm.h"
 
 #endif /* CH_H */
 
@@ -41,6 +41,20 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Condition variables wait morphing.
+ * @details If enabled then the threads released by a signal or a broadcast
+ *          are moved directly on the queue of the mutex they waited with,
+ *          the threads are made ready only once they own the mutex.
+ * @note    All the threads waiting on a condition variable must use the
+ *          same mutex.
+ * @note    A thread released from a condition variable is no more subject
+ *          to the timeout while waiting for the mutex.
+ */
+#if !defined(CH_CFG_CONDVARS_WAIT_MORPHING) || defined(__DOXYGEN__)
+#define CH_CFG_CONDVARS_WAIT_MORPHING       FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -59,6 +73,10 @@
 typedef struct condition_variable {
   threads_queue_t       queue;              /**< @brief Condition variable
                                                  threads queue.             */
+#if (CH_CFG_CONDVARS_WAIT_MORPHING == TRUE) || defined(__DOXYGEN__)
+  mutex_t               *mtxp;              /**< @brief Mutex used by the
+                                                 waiting threads.           */
+#endif
 } condition_variable_t;
 
 /*===========================================================================*/
@@ -72,7 +90,11 @@ typedef struct condition_variable {
  *
  * @param[in] name      the name of the condition variable
  */
+#if (CH_CFG_CONDVARS_WAIT_MORPHING == TRUE) || defined(__DOXYGEN__)
+#define _CONDVAR_DATA(name) {_THREADS_QUEUE_DATA(name.queue), NULL}
+#else
 #define _CONDVAR_DATA(name) {_THREADS_QUEUE_DATA(name.queue)}
+#endif
 
 /**
  * @brief Static condition variable initializer.
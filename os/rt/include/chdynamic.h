@@ -57,10 +57,46 @@
 #error "CH_CFG_USE_DYNAMIC requires CH_CFG_USE_HEAP and/or CH_CFG_USE_MEMPOOLS"
 #endif
 
+#if (CH_CFG_USE_THREAD_CACHE == TRUE) && (CH_CFG_USE_HEAP == FALSE)
+#error "CH_CFG_USE_THREAD_CACHE requires CH_CFG_USE_HEAP"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_THREAD_CACHE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a threads cache.
+ * @details Working areas of terminated threads are kept in the cache
+ *          instead of being returned to the heap, spawning a thread from
+ *          the cache does not involve the heap allocator.
+ */
+typedef struct ch_thread_cache {
+  /**
+   * @brief   Heap used when the cache is empty or full.
+   */
+  memory_heap_t             *heapp;
+  /**
+   * @brief   Size of the cached working areas.
+   */
+  size_t                    size;
+  /**
+   * @brief   List of the cached threads.
+   * @note    Terminated threads are linked using their queue field.
+   */
+  thread_t                  *free;
+  /**
+   * @brief   Number of cached working areas.
+   */
+  ucnt_t                    cnt;
+  /**
+   * @brief   Maximum number of cached working areas.
+   */
+  ucnt_t                    max;
+} thread_cache_t;
+#endif
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -84,6 +120,14 @@ extern "C" {
   thread_t *chThdCreateFromMemoryPool(memory_pool_t *mp, const char *name,
                                       tprio_t prio, tfunc_t pf, void *arg);
 #endif
+#if CH_CFG_USE_THREAD_CACHE == TRUE
+  void chThdCacheObjectInit(thread_cache_t *tcp, memory_heap_t *heapp,
+                            size_t size, ucnt_t max);
+  thread_t *chThdSpawnFromCache(thread_cache_t *tcp, const char *name,
+                                tprio_t prio, tfunc_t pf, void *arg);
+  void chThdCacheFlush(thread_cache_t *tcp);
+  void _thread_cache_free(thread_t *tp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -41,6 +41,18 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Event listeners ordered by priority.
+ * @details If enabled then the listeners are inserted in the event source
+ *          list in order of priority of the registering thread, the higher
+ *          priority listeners are signaled first on broadcast.
+ * @note    The order is established on registration, later changes of
+ *          the threads priority are not considered.
+ */
+#if !defined(CH_CFG_EVENTS_PRIORITY_ORDER) || defined(__DOXYGEN__)
+#define CH_CFG_EVENTS_PRIORITY_ORDER        FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -46,6 +46,23 @@
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Type of a message payload descriptor.
+ * @details A payload is a buffer owned by the sender, the server accesses
+ *          it in place because the sender is suspended until the message
+ *          is released.
+ */
+typedef struct {
+  /**
+   * @brief   Pointer to the payload buffer.
+   */
+  const void                *buf;
+  /**
+   * @brief   Size of the payload buffer.
+   */
+  size_t                    size;
+} msg_payload_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -58,7 +75,11 @@
 extern "C" {
 #endif
   msg_t chMsgSend(thread_t *tp, msg_t msg);
+  msg_t chMsgSendTimeout(thread_t *tp, msg_t msg, sysinterval_t timeout);
+  msg_t chMsgSendPayloadTimeout(thread_t *tp, const void *buf, size_t size,
+                                sysinterval_t timeout);
   thread_t * chMsgWait(void);
+  thread_t * chMsgWaitTimeout(sysinterval_t timeout);
   void chMsgRelease(thread_t *tp, msg_t msg);
 #ifdef __cplusplus
 }
@@ -100,6 +121,25 @@ static inline msg_t chMsgGet(thread_t *tp) {
   return tp->u.sentmsg;
 }
 
+/**
+ * @brief   Returns the payload descriptor carried by the specified thread.
+ * @pre     This function must be invoked immediately after exiting a call
+ *          to @p chMsgWait() or @p chMsgWaitTimeout() and only if the
+ *          message has been sent using @p chMsgSendPayloadTimeout().
+ * @note    The payload is stable until @p chMsgRelease() is invoked.
+ *
+ * @param[in] tp        pointer to the thread
+ * @return              The payload descriptor carried by the sender.
+ *
+ * @api
+ */
+static inline const msg_payload_t *chMsgGetPayload(thread_t *tp) {
+
+  chDbgAssert(tp->state == CH_STATE_SNDMSG, "invalid state");
+
+  return (const msg_payload_t *)tp->u.sentmsg;
+}
+
 /**
  * @brief   Releases the thread waiting on top of the messages queue.
  * @pre     Invoke this function only after a message has been received
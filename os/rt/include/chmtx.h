@@ -38,10 +38,34 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Priority ceiling protocol on mutexes.
+ * @details If enabled then each mutex can be given a ceiling priority,
+ *          mutexes with a non-zero ceiling use the immediate priority
+ *          ceiling protocol instead of priority inheritance.
+ */
+#if !defined(CH_CFG_USE_MUTEXES_CEILING) || defined(__DOXYGEN__)
+#define CH_CFG_USE_MUTEXES_CEILING          FALSE
+#endif
+
+/**
+ * @brief   Adaptive mutexes spin count.
+ * @details Number of times a thread yields before going to sleep on a
+ *          mutex owned by a ready thread at the same priority.
+ * @note    Zero disables the adaptive behavior.
+ */
+#if !defined(CH_CFG_MUTEXES_SPIN_COUNT) || defined(__DOXYGEN__)
+#define CH_CFG_MUTEXES_SPIN_COUNT           0
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if CH_CFG_MUTEXES_SPIN_COUNT < 0
+#error "invalid CH_CFG_MUTEXES_SPIN_COUNT value"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -64,12 +88,46 @@ struct ch_mutex {
 #if (CH_CFG_USE_MUTEXES_RECURSIVE == TRUE) || defined(__DOXYGEN__)
   cnt_t                 cnt;        /**< @brief Mutex recursion counter.    */
 #endif
+#if (CH_CFG_USE_MUTEXES_CEILING == TRUE) || defined(__DOXYGEN__)
+  tprio_t               ceiling;    /**< @brief Ceiling priority or zero for
+                                                priority inheritance.       */
+#endif
+#if (CH_DBG_STATISTICS == TRUE) || defined(__DOXYGEN__)
+  ucnt_t                n_contended;/**< @brief Number of lock attempts on
+                                                the mutex owned by another
+                                                thread.                     */
+  ucnt_t                n_spinacq;  /**< @brief Number of contended locks
+                                                acquired by spinning.       */
+#endif
 };
 
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @name    Optional mutex fields initializers
+ * @{
+ */
+#if (CH_CFG_USE_MUTEXES_RECURSIVE == TRUE) || defined(__DOXYGEN__)
+#define _MUTEX_CNT_DATA                     , (cnt_t)0
+#else
+#define _MUTEX_CNT_DATA
+#endif
+
+#if (CH_CFG_USE_MUTEXES_CEILING == TRUE) || defined(__DOXYGEN__)
+#define _MUTEX_PRIO_DATA(prio)              , (tprio_t)(prio)
+#else
+#define _MUTEX_PRIO_DATA(prio)
+#endif
+
+#if (CH_DBG_STATISTICS == TRUE) || defined(__DOXYGEN__)
+#define _MUTEX_STATS_DATA                   , (ucnt_t)0, (ucnt_t)0
+#else
+#define _MUTEX_STATS_DATA
+#endif
+/** @} */
+
 /**
  * @brief   Data part of a static mutex initializer.
  * @details This macro should be used when statically initializing a mutex
@@ -77,10 +135,22 @@ struct ch_mutex {
  *
  * @param[in] name      the name of the mutex variable
  */
-#if (CH_CFG_USE_MUTEXES_RECURSIVE == TRUE) || defined(__DOXYGEN__)
-#define _MUTEX_DATA(name) {_THREADS_QUEUE_DATA(name.queue), NULL, NULL, 0}
-#else
-#define _MUTEX_DATA(name) {_THREADS_QUEUE_DATA(name.queue), NULL, NULL}
+#define _MUTEX_DATA(name)                                                   \
+  {_THREADS_QUEUE_DATA(name.queue), NULL, NULL                              \
+   _MUTEX_CNT_DATA _MUTEX_PRIO_DATA(0) _MUTEX_STATS_DATA}
+
+#if (CH_CFG_USE_MUTEXES_CEILING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Data part of a static priority ceiling mutex initializer.
+ * @details This macro should be used when statically initializing a
+ *          priority ceiling mutex that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the mutex variable
+ * @param[in] prio      the ceiling priority
+ */
+#define _MUTEX_CEILING_DATA(name, prio)                                     \
+  {_THREADS_QUEUE_DATA(name.queue), NULL, NULL                              \
+   _MUTEX_CNT_DATA _MUTEX_PRIO_DATA(prio) _MUTEX_STATS_DATA}
 #endif
 
 /**
@@ -92,6 +162,19 @@ struct ch_mutex {
  */
 #define MUTEX_DECL(name) mutex_t name = _MUTEX_DATA(name)
 
+#if (CH_CFG_USE_MUTEXES_CEILING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Static priority ceiling mutex initializer.
+ * @details Statically initialized mutexes require no explicit initialization
+ *          using @p chMtxObjectInitCeiling().
+ *
+ * @param[in] name      the name of the mutex variable
+ * @param[in] prio      the ceiling priority
+ */
+#define MUTEX_CEILING_DECL(name, prio)                                      \
+  mutex_t name = _MUTEX_CEILING_DATA(name, prio)
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -100,10 +183,14 @@ struct ch_mutex {
 extern "C" {
 #endif
   void chMtxObjectInit(mutex_t *mp);
+#if CH_CFG_USE_MUTEXES_CEILING == TRUE
+  void chMtxObjectInitCeiling(mutex_t *mp, tprio_t prio);
+#endif
   void chMtxLock(mutex_t *mp);
   void chMtxLockS(mutex_t *mp);
   bool chMtxTryLock(mutex_t *mp);
   bool chMtxTryLockS(mutex_t *mp);
+  bool chMtxLockForI(mutex_t *mp, thread_t *tp);
   void chMtxUnlock(mutex_t *mp);
   void chMtxUnlockS(mutex_t *mp);
   void chMtxUnlockAll(void);
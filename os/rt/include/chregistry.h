@@ -70,6 +70,57 @@ typedef struct {
   uint8_t   off_time;               /**< @brief Offset of @p time field.    */
 } chdebug_t;
 
+/**
+ * @brief   Thread snapshot record.
+ * @details Compact copy of the thread state taken by @p chRegSnapshot().
+ */
+typedef struct {
+  /**
+   * @brief   Thread pointer.
+   * @note    It identifies the thread, no reference is taken so it must
+   *          not be dereferenced unless the thread is known to exist.
+   */
+  thread_t              *tp;
+  /**
+   * @brief   Thread name.
+   */
+  const char            *name;
+  /**
+   * @brief   Thread priority.
+   */
+  tprio_t               prio;
+  /**
+   * @brief   Thread state.
+   */
+  tstate_t              state;
+#if (CH_DBG_THREADS_PROFILING == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Thread consumed time in ticks.
+   */
+  systime_t             time;
+#endif
+#if (CH_DBG_STATISTICS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Cumulative run time in realtime counter cycles.
+   */
+  rttime_t              runtime;
+  /**
+   * @brief   Thread load over the last load window, in percent.
+   */
+  uint8_t               load;
+#endif
+#if ((CH_DBG_FILL_THREADS == TRUE) &&                                       \
+     ((CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE))) || \
+    defined(__DOXYGEN__)
+  /**
+   * @brief   Never used stack space in bytes.
+   * @note    It is zero if the thread left the registry while its stack
+   *          was being scanned.
+   */
+  size_t                stkfree;
+#endif
+} thread_snapshot_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -80,10 +131,20 @@ typedef struct {
  *
  * @param[in] tp        thread to remove from the registry
  */
+#if (CH_CFG_REGISTRY_INDEX_SIZE > 0) || defined(__DOXYGEN__)
 #define REG_REMOVE(tp) {                                                    \
   (tp)->older->newer = (tp)->newer;                                         \
   (tp)->newer->older = (tp)->older;                                         \
+  _reg_index_remove(tp);                                                    \
+  ch.rlist.regseq++;                                                        \
 }
+#else
+#define REG_REMOVE(tp) {                                                    \
+  (tp)->older->newer = (tp)->newer;                                         \
+  (tp)->newer->older = (tp)->older;                                         \
+  ch.rlist.regseq++;                                                        \
+}
+#endif
 
 /**
  * @brief   Adds a thread to the registry list.
@@ -91,12 +152,24 @@ typedef struct {
  *
  * @param[in] tp        thread to add to the registry
  */
+#if (CH_CFG_REGISTRY_INDEX_SIZE > 0) || defined(__DOXYGEN__)
 #define REG_INSERT(tp) {                                                    \
   (tp)->newer = (thread_t *)&ch.rlist;                                      \
   (tp)->older = ch.rlist.older;                                           \
   (tp)->older->newer = (tp);                                                \
   ch.rlist.older = (tp);                                                  \
+  _reg_index_insert(tp, _reg_hash_name((tp)->name));                        \
+  ch.rlist.regseq++;                                                        \
 }
+#else
+#define REG_INSERT(tp) {                                                    \
+  (tp)->newer = (thread_t *)&ch.rlist;                                      \
+  (tp)->older = ch.rlist.older;                                           \
+  (tp)->older->newer = (tp);                                                \
+  ch.rlist.older = (tp);                                                  \
+  ch.rlist.regseq++;                                                        \
+}
+#endif
 
 /*===========================================================================*/
 /* External declarations.                                                    */
@@ -111,6 +184,16 @@ extern "C" {
   thread_t *chRegFindThreadByName(const char *name);
   thread_t *chRegFindThreadByPointer(thread_t *tp);
   thread_t *chRegFindThreadByWorkingArea(stkalign_t *wa);
+  size_t chRegSnapshot(thread_snapshot_t *buf, size_t n);
+#if CH_DBG_STATISTICS == TRUE
+  void chRegUpdateLoad(void);
+#endif
+#if CH_CFG_REGISTRY_INDEX_SIZE > 0
+  uint32_t _reg_hash_name(const char *name);
+  void _reg_index_insert(thread_t *tp, uint32_t hash);
+  void _reg_index_remove(thread_t *tp);
+  void _reg_index_rename(thread_t *tp, const char *name, uint32_t hash);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -132,7 +215,13 @@ extern "C" {
  */
 static inline void chRegSetThreadName(const char *name) {
 
-#if CH_CFG_USE_REGISTRY == TRUE
+#if CH_CFG_REGISTRY_INDEX_SIZE > 0
+  uint32_t hash = _reg_hash_name(name);
+
+  chSysLock();
+  _reg_index_rename(ch.rlist.current, name, hash);
+  chSysUnlock();
+#elif CH_CFG_USE_REGISTRY == TRUE
   ch.rlist.current->name = name;
 #else
   (void)name;
@@ -172,7 +261,14 @@ static inline const char *chRegGetThreadNameX(thread_t *tp) {
  */
 static inline void chRegSetThreadNameX(thread_t *tp, const char *name) {
 
-#if CH_CFG_USE_REGISTRY == TRUE
+#if CH_CFG_REGISTRY_INDEX_SIZE > 0
+  uint32_t hash = _reg_hash_name(name);
+  syssts_t sts;
+
+  sts = chSysGetStatusAndLockX();
+  _reg_index_rename(tp, name, hash);
+  chSysRestoreStatusX(sts);
+#elif CH_CFG_USE_REGISTRY == TRUE
   tp->name = name;
 #else
   (void)tp;
@@ -180,6 +276,25 @@ static inline void chRegSetThreadNameX(thread_t *tp, const char *name) {
 #endif
 }
 
+#if ((CH_CFG_USE_REGISTRY == TRUE) && (CH_DBG_STATISTICS == TRUE)) ||      \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Returns the load of the specified thread.
+ * @pre     The load is calculated by @p chRegUpdateLoad(), it is zero until
+ *          the first load window is closed.
+ *
+ * @param[in] tp        pointer to the thread
+ * @return              The thread CPU usage over the last load window, in
+ *                      percent.
+ *
+ * @xclass
+ */
+static inline unsigned chRegGetThreadLoadX(thread_t *tp) {
+
+  return (unsigned)tp->load;
+}
+#endif
+
 #endif /* CHREGISTRY_H */
 
 /** @} */
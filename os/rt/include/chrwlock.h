@@ -0,0 +1,170 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chrwlock.h
+ * @brief   Reader-writer locks macros and structures.
+ *
+ * @addtogroup rwlocks
+ * @{
+ */
+
+#ifndef CHRWLOCK_H
+#define CHRWLOCK_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Reader-writer locks APIs.
+ * @details If enabled then the reader-writer locks APIs are included in
+ *          the kernel.
+ */
+#if !defined(CH_CFG_USE_RWLOCKS) || defined(__DOXYGEN__)
+#define CH_CFG_USE_RWLOCKS                  FALSE
+#endif
+
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a reader-writer lock structure.
+ */
+typedef struct ch_rwlock rwlock_t;
+
+/**
+ * @brief   Reader-writer lock structure.
+ */
+struct ch_rwlock {
+  threads_queue_t       rqueue;     /**< @brief Queue of the readers waiting
+                                                on this lock.               */
+  threads_queue_t       wqueue;     /**< @brief Queue of the writers waiting
+                                                on this lock.               */
+  thread_t              *writer;    /**< @brief Writer @p thread_t pointer
+                                                or @p NULL.                 */
+  cnt_t                 readers;    /**< @brief Number of readers owning
+                                                the lock.                   */
+  tprio_t               wprio;      /**< @brief Priority of the writer
+                                                before any boost.           */
+};
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Data part of a static reader-writer lock initializer.
+ * @details This macro should be used when statically initializing a
+ *          reader-writer lock that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the reader-writer lock variable
+ */
+#define _RWLOCK_DATA(name) {                                                \
+  _THREADS_QUEUE_DATA(name.rqueue),                                         \
+  _THREADS_QUEUE_DATA(name.wqueue),                                         \
+  NULL,                                                                     \
+  (cnt_t)0,                                                                 \
+  (tprio_t)0                                                                \
+}
+
+/**
+ * @brief   Static reader-writer lock initializer.
+ * @details Statically initialized reader-writer locks require no explicit
+ *          initialization using @p chRWLockObjectInit().
+ *
+ * @param[in] name      the name of the reader-writer lock variable
+ */
+#define RWLOCK_DECL(name) rwlock_t name = _RWLOCK_DATA(name)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chRWLockObjectInit(rwlock_t *rwp);
+  void chRWLockReadLock(rwlock_t *rwp);
+  void chRWLockReadLockS(rwlock_t *rwp);
+  msg_t chRWLockReadLockTimeout(rwlock_t *rwp, sysinterval_t timeout);
+  msg_t chRWLockReadLockTimeoutS(rwlock_t *rwp, sysinterval_t timeout);
+  void chRWLockReadUnlock(rwlock_t *rwp);
+  void chRWLockReadUnlockS(rwlock_t *rwp);
+  void chRWLockWriteLock(rwlock_t *rwp);
+  void chRWLockWriteLockS(rwlock_t *rwp);
+  msg_t chRWLockWriteLockTimeout(rwlock_t *rwp, sysinterval_t timeout);
+  msg_t chRWLockWriteLockTimeoutS(rwlock_t *rwp, sysinterval_t timeout);
+  void chRWLockWriteUnlock(rwlock_t *rwp);
+  void chRWLockWriteUnlockS(rwlock_t *rwp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the number of readers owning the lock.
+ *
+ * @param[in] rwp       pointer to a @p rwlock_t structure
+ * @return              The number of readers.
+ *
+ * @iclass
+ */
+static inline cnt_t chRWLockGetReadersI(rwlock_t *rwp) {
+
+  chDbgCheckClassI();
+
+  return rwp->readers;
+}
+
+/**
+ * @brief   Returns the writer owning the lock.
+ *
+ * @param[in] rwp       pointer to a @p rwlock_t structure
+ * @return              A pointer to the writer thread.
+ * @retval NULL         if the lock is not owned by a writer.
+ *
+ * @iclass
+ */
+static inline thread_t *chRWLockGetWriterI(rwlock_t *rwp) {
+
+  chDbgCheckClassI();
+
+  return rwp->writer;
+}
+
+#endif /* CH_CFG_USE_RWLOCKS == TRUE */
+
+#endif /* CHRWLOCK_H */
+
+/** @} */
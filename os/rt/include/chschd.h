@@ -79,6 +79,7 @@
 #define CH_STATE_WTMSG      (tstate_t)14     /**< @brief Waiting for a
                                                   message.                  */
 #define CH_STATE_FINAL      (tstate_t)15     /**< @brief Thread terminated. */
+#define CH_STATE_WTMULTI    (tstate_t)16     /**< @brief Several objects.   */
 
 /**
  * @brief   Thread states as array of strings.
@@ -88,7 +89,22 @@
 #define CH_STATE_NAMES                                                     \
   "READY", "CURRENT", "WTSTART", "SUSPENDED", "QUEUED", "WTSEM", "WTMTX",  \
   "WTCOND", "SLEEPING", "WTEXIT", "WTOREVT", "WTANDEVT", "SNDMSGQ",        \
-  "SNDMSG", "WTMSG", "FINAL"
+  "SNDMSG", "WTMSG", "FINAL", "WTMULTI"
+/** @} */
+
+/**
+ * @name    Priority bucket positions
+ * @{
+ */
+#define CH_QBUCKET_NONE     (uint8_t)0      /**< @brief Not in a threads
+                                                 queue.                     */
+#define CH_QBUCKET_SINGLE   (uint8_t)1      /**< @brief Only thread of its
+                                                 bucket.                    */
+#define CH_QBUCKET_FIRST    (uint8_t)2      /**< @brief First thread of its
+                                                 bucket.                    */
+#define CH_QBUCKET_LAST     (uint8_t)3      /**< @brief Last thread of its
+                                                 bucket.                    */
+#define CH_QBUCKET_MIDDLE   (uint8_t)4      /**< @brief Inside its bucket.  */
 /** @} */
 
 /**
@@ -102,18 +118,274 @@
                                                  from a Memory Heap.        */
 #define CH_FLAG_MODE_MPOOL  (tmode_t)2U     /**< @brief Thread allocated
                                                  from a Memory Pool.        */
+#define CH_FLAG_MODE_CACHE  (tmode_t)3U     /**< @brief Thread allocated
+                                                 from a Threads Cache.      */
 #define CH_FLAG_TERMINATE   (tmode_t)4U     /**< @brief Termination requested
                                                  flag.                      */
+#define CH_FLAG_CONDRESET   (tmode_t)8U     /**< @brief Released by a
+                                                 condition variable
+                                                 broadcast.                 */
 /** @} */
 
 /*===========================================================================*/
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Bitmap-indexed ready list.
+ * @details If enabled the ready list keeps a per-priority index of its
+ *          threads and a bitmap of the non-empty priority levels, insertion
+ *          and removal become constant time regardless of the number of
+ *          ready threads.
+ * @note    The index requires one pointer for each priority level, it is
+ *          a RAM versus determinism trade-off.
+ */
+#if !defined(CH_CFG_READY_LIST_BITMAP) || defined(__DOXYGEN__)
+#define CH_CFG_READY_LIST_BITMAP            FALSE
+#endif
+
+/**
+ * @brief   Priority buckets in threads queues.
+ * @details If enabled the threads in a queue are grouped in buckets of
+ *          equal priority, the first and last threads of each bucket are
+ *          linked together. A priority ordered insertion skips whole
+ *          buckets so its cost depends on the number of distinct waiting
+ *          priorities instead of the number of waiting threads.
+ * @note    The ready list is not affected.
+ */
+#if !defined(CH_CFG_QUEUE_BUCKETS) || defined(__DOXYGEN__)
+#define CH_CFG_QUEUE_BUCKETS                FALSE
+#endif
+
+/**
+ * @brief   Multiple objects wait APIs.
+ * @details If enabled then a thread can wait on several semaphores,
+ *          mailboxes and its own events using @p chWaitMultipleTimeout().
+ * @note    The objects lists are declared here because they are part of
+ *          the semaphore and mailbox structures.
+ */
+#if !defined(CH_CFG_USE_WAIT_MULTIPLE) || defined(__DOXYGEN__)
+#define CH_CFG_USE_WAIT_MULTIPLE            FALSE
+#endif
+
+/**
+ * @brief   Timing wheel virtual timers.
+ * @details If enabled the virtual timers are organized in a hierarchical
+ *          timing wheel instead of a delta list, arming and disarming a
+ *          timer have a bounded cost regardless of the number of armed
+ *          timers.
+ * @note    The timers data structures are declared here because they are
+ *          part of the @p ch_system_t structure.
+ */
+#if !defined(CH_CFG_VT_WHEEL) || defined(__DOXYGEN__)
+#define CH_CFG_VT_WHEEL                     FALSE
+#endif
+
+/**
+ * @brief   Number of levels of the timing wheel.
+ * @details Each level has 32 slots, the wheel covers a time span of
+ *          2^(5 * levels) ticks, longer delays are handled by re-inserting
+ *          the timer when the span is elapsed.
+ * @note    The minimum is two levels.
+ */
+#if !defined(CH_CFG_VT_WHEEL_LEVELS) || defined(__DOXYGEN__)
+#define CH_CFG_VT_WHEEL_LEVELS              4
+#endif
+
+/**
+ * @brief   64 bits monotonic time stamps.
+ * @details If enabled the system time is extended to a 64 bits time stamp
+ *          that never wraps, the extension is kept current by a virtual
+ *          timer triggered each half system time range.
+ * @note    The default is declared here because the last stamp is part
+ *          of the @p ch_system_t structure.
+ */
+#if !defined(CH_CFG_USE_TIMESTAMP) || defined(__DOXYGEN__)
+#define CH_CFG_USE_TIMESTAMP                FALSE
+#endif
+
+/**
+ * @brief   Scheduler batches.
+ * @details If enabled a thread can open a batch scope using
+ *          @p chSchBatchBegin(), the reschedule points reached by the
+ *          thread inside the scope are deferred to @p chSchBatchEnd().
+ */
+#if !defined(CH_CFG_USE_SCHED_BATCH) || defined(__DOXYGEN__)
+#define CH_CFG_USE_SCHED_BATCH              FALSE
+#endif
+
+/**
+ * @brief   Threads execution budgets.
+ * @details If enabled a thread can be given an execution budget over a
+ *          replenishment period using @p chThdSetBudget(), the thread is
+ *          demoted to a background priority when the budget is used up
+ *          and restored when the budget is replenished.
+ */
+#if !defined(CH_CFG_USE_BUDGET) || defined(__DOXYGEN__)
+#define CH_CFG_USE_BUDGET                   FALSE
+#endif
+
+/**
+ * @brief   Periodic threads.
+ * @details If enabled periodic threads can be created using
+ *          @p chPeriodicThreadCreate(), the release schedule is kept by
+ *          the kernel and the missed releases are accounted.
+ */
+#if !defined(CH_CFG_USE_PERIODIC) || defined(__DOXYGEN__)
+#define CH_CFG_USE_PERIODIC                 FALSE
+#endif
+
+/**
+ * @brief   Dynamic threads cache.
+ * @details If enabled the working areas of terminated dynamic threads can
+ *          be kept in a cache and reused by @p chThdSpawnFromCache().
+ * @note    Requires @p CH_CFG_USE_DYNAMIC and @p CH_CFG_USE_HEAP.
+ */
+#if !defined(CH_CFG_USE_THREAD_CACHE) || defined(__DOXYGEN__)
+#define CH_CFG_USE_THREAD_CACHE             FALSE
+#endif
+
+/**
+ * @brief   Earliest deadline first priority band.
+ * @details Threads at this priority level are ordered by absolute deadline
+ *          instead of arrival, the thread with the earliest deadline runs
+ *          first. Threads at other levels are not affected.
+ * @note    Round robin does not apply to the threads in the band.
+ * @note    Zero disables the feature.
+ */
+#if !defined(CH_CFG_EDF_PRIO) || defined(__DOXYGEN__)
+#define CH_CFG_EDF_PRIO                     0
+#endif
+
+/**
+ * @brief   Number of thread specific data keys.
+ * @details Each thread has a slot for each key, the slots are accessed
+ *          using @p chThdGetSpecificX() and @p chThdSetSpecificX().
+ * @note    Zero disables the feature.
+ */
+#if !defined(CH_CFG_THREAD_SPECIFIC_KEYS) || defined(__DOXYGEN__)
+#define CH_CFG_THREAD_SPECIFIC_KEYS         0
+#endif
+
+/**
+ * @brief   Number of buckets of the registry index.
+ * @details If non-zero the registry threads are also linked in two hash
+ *          tables, by name and by pointer, and the functions
+ *          @p chRegFindThreadByName() and @p chRegFindThreadByPointer()
+ *          only scan a single bucket instead of the whole registry.
+ * @note    It must be a power of two, zero disables the feature.
+ */
+#if !defined(CH_CFG_REGISTRY_INDEX_SIZE) || defined(__DOXYGEN__)
+#define CH_CFG_REGISTRY_INDEX_SIZE          0
+#endif
+
+/**
+ * @brief   Kernel hot paths in ITCM.
+ * @details If enabled the functions marked with @p CH_HOTPATH are placed in
+ *          the port hot path section and the data marked with
+ *          @p CH_FASTDATA in the port fast data section, on Cortex-M7
+ *          devices these are the ITCM and DTCM RAMs.
+ * @note    The linker script must define the @p .itcm and @p .dtcm output
+ *          sections, the @p .dtcm section is not initialized.
+ */
+#if !defined(CH_CFG_HOTPATH_IN_ITCM) || defined(__DOXYGEN__)
+#define CH_CFG_HOTPATH_IN_ITCM              FALSE
+#endif
+
+/**
+ * @brief   Cache lines aware data layout.
+ * @details If enabled the fields used by the scheduler are grouped at the
+ *          start of the @p thread_t structure, the ready list, the virtual
+ *          timers list and the cold system fields are placed in separate
+ *          cache lines and the threads structures are cache line aligned.
+ * @note    The working areas are aligned and sized as multiples of
+ *          @p PORT_CACHE_LINE_SIZE.
+ */
+#if !defined(CH_CFG_CACHE_LAYOUT) || defined(__DOXYGEN__)
+#define CH_CFG_CACHE_LAYOUT                 FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (CH_CFG_READY_LIST_BITMAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Number of priority levels indexed by the ready list bitmap.
+ * @note    It must be equal to @p HIGHPRIO plus one.
+ */
+#define CH_SCH_PRIO_LEVELS      256U
+
+/**
+ * @brief   Number of 32 bits words in the ready list bitmap.
+ */
+#define CH_SCH_BITMAP_WORDS     (CH_SCH_PRIO_LEVELS / 32U)
+#endif /* CH_CFG_READY_LIST_BITMAP == TRUE */
+
+#if (CH_CFG_VT_WHEEL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Number of bits of wheel time decoded by each wheel level.
+ */
+#define CH_VT_WHEEL_BITS        5U
+
+/**
+ * @brief   Number of slots in each wheel level.
+ */
+#define CH_VT_WHEEL_SLOTS       32U
+
+#if (CH_CFG_VT_WHEEL_LEVELS < 2) ||                                         \
+    ((CH_CFG_VT_WHEEL_LEVELS * 5) >= CH_CFG_INTERVALS_SIZE)
+#error "invalid CH_CFG_VT_WHEEL_LEVELS value"
+#endif
+#endif /* CH_CFG_VT_WHEEL == TRUE */
+
+#if (CH_CFG_EDF_PRIO != 0) &&                                               \
+    ((CH_CFG_EDF_PRIO < 2) || (CH_CFG_EDF_PRIO > 255))
+#error "invalid CH_CFG_EDF_PRIO value"
+#endif
+
+#if CH_CFG_REGISTRY_INDEX_SIZE > 0
+#if CH_CFG_USE_REGISTRY == FALSE
+#error "CH_CFG_REGISTRY_INDEX_SIZE requires CH_CFG_USE_REGISTRY"
+#endif
+#if (CH_CFG_REGISTRY_INDEX_SIZE & (CH_CFG_REGISTRY_INDEX_SIZE - 1)) != 0
+#error "CH_CFG_REGISTRY_INDEX_SIZE must be a power of two"
+#endif
+#endif
+
+#if (CH_CFG_HOTPATH_IN_ITCM == TRUE) || defined(__DOXYGEN__)
+#if !defined(PORT_HOTPATH) || !defined(PORT_FASTDATA)
+#error "CH_CFG_HOTPATH_IN_ITCM not supported by this port"
+#endif
+
+/**
+ * @brief   Marks a kernel hot path function.
+ */
+#define CH_HOTPATH              PORT_HOTPATH
+
+/**
+ * @brief   Marks a variable to be placed in fast RAM.
+ * @note    The variable is not initialized.
+ */
+#define CH_FASTDATA             PORT_FASTDATA
+#else
+#define CH_HOTPATH
+#define CH_FASTDATA
+#endif
+
+#if (CH_CFG_CACHE_LAYOUT == TRUE) || defined(__DOXYGEN__)
+#if !defined(PORT_CACHE_ALIGNED) || !defined(PORT_CACHE_LINE_SIZE)
+#error "CH_CFG_CACHE_LAYOUT not supported by this port"
+#endif
+
+/**
+ * @brief   Marks a structure field to be placed at a cache line start.
+ */
+#define CH_CACHE_ALIGNED        PORT_CACHE_ALIGNED
+#else
+#define CH_CACHE_ALIGNED
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -133,6 +405,16 @@ struct ch_threads_queue {
   thread_t              *prev;      /**< @brief Previous in the queue.      */
 };
 
+#if (CH_CFG_USE_WAIT_MULTIPLE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Multiple wait objects bidirectional linked list header.
+ */
+struct ch_wait_list {
+  wait_object_t         *next;      /**< @brief First wait object.          */
+  wait_object_t         *prev;      /**< @brief Last wait object.           */
+};
+#endif
+
 /**
  * @brief   Structure representing a thread.
  * @note    Not all the listed fields are always needed, by switching off some
@@ -140,6 +422,7 @@ struct ch_threads_queue {
  *          by shrinking this structure.
  */
 struct ch_thread {
+  CH_CACHE_ALIGNED
   threads_queue_t       queue;      /**< @brief Threads queue header.       */
   tprio_t               prio;       /**< @brief Thread priority.            */
   struct port_context   ctx;        /**< @brief Processor context.          */
@@ -148,14 +431,15 @@ struct ch_thread {
   thread_t              *older;     /**< @brief Older registry element.     */
 #endif
   /* End of the fields shared with the ReadyList structure. */
-#if (CH_CFG_USE_REGISTRY == TRUE) || defined(__DOXYGEN__)
+#if ((CH_CFG_USE_REGISTRY == TRUE) && (CH_CFG_CACHE_LAYOUT == FALSE)) ||    \
+    defined(__DOXYGEN__)
   /**
    * @brief   Thread name or @p NULL.
    */
   const char            *name;
 #endif
-#if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE) ||  \
-    defined(__DOXYGEN__)
+#if (((CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE)) && \
+     (CH_CFG_CACHE_LAYOUT == FALSE)) || defined(__DOXYGEN__)
   /**
    * @brief   Working area base address.
    * @note    This pointer is used for stack overflow checks and for
@@ -171,17 +455,60 @@ struct ch_thread {
    * @brief   Various thread flags.
    */
   tmode_t               flags;
-#if (CH_CFG_USE_REGISTRY == TRUE) || defined(__DOXYGEN__)
+#if (CH_CFG_READY_LIST_BITMAP == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Priority level the thread has been indexed with while in the
+   *          ready list.
+   * @note    The thread priority can be modified while the thread is in
+   *          the ready list so the original level is remembered here.
+   */
+  tprio_t               rdyprio;
+#endif
+#if (CH_CFG_QUEUE_BUCKETS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Other end of the priority bucket.
+   * @note    Only valid for the first and last threads of a bucket, a
+   *          single thread points to itself.
+   */
+  thread_t              *qbucket;
+  /**
+   * @brief   Position of the thread in its priority bucket.
+   */
+  uint8_t               qbpos;
+#endif
+#if ((CH_CFG_USE_REGISTRY == TRUE) && (CH_CFG_CACHE_LAYOUT == FALSE)) ||    \
+    defined(__DOXYGEN__)
   /**
    * @brief   References to this thread.
    */
   trefs_t               refs;
 #endif
+#if (CH_CFG_USE_SCHED_BATCH == TRUE) || defined(__DOXYGEN__)
   /**
-   * @brief   Number of ticks remaining to this thread.
+   * @brief   Scheduler batch nesting counter.
+   * @note    Reschedule points reached by the thread are deferred while
+   *          this counter is not zero.
    */
+  uint8_t               batch;
+#endif
 #if (CH_CFG_TIME_QUANTUM > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   Number of ticks remaining to this thread.
+   */
   tslices_t             ticks;
+  /**
+   * @brief   Time quantum of this thread.
+   * @note    It is reloaded into @p ticks when the thread renounces to or
+   *          uses up its time slice.
+   */
+  tslices_t             quantum;
+#endif
+#if (CH_CFG_EDF_PRIO > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   Absolute deadline of this thread.
+   * @note    It orders the ready threads in the EDF priority band.
+   */
+  systime_t             deadline;
 #endif
 #if (CH_DBG_THREADS_PROFILING == TRUE) || defined(__DOXYGEN__)
   /**
@@ -257,6 +584,18 @@ struct ch_thread {
     eventmask_t         ewmask;
 #endif
   }                     u;
+#if CH_CFG_CACHE_LAYOUT == TRUE
+  /* Fields not used by the scheduler, moved after the hot ones.*/
+#if CH_CFG_USE_REGISTRY == TRUE
+  const char            *name;      /**< @brief Thread name or @p NULL.     */
+#endif
+#if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE)
+  stkalign_t            *wabase;    /**< @brief Working area base address.  */
+#endif
+#if CH_CFG_USE_REGISTRY == TRUE
+  trefs_t               refs;       /**< @brief References to this thread.  */
+#endif
+#endif /* CH_CFG_CACHE_LAYOUT == TRUE */
 #if (CH_CFG_USE_WAITEXIT == TRUE) || defined(__DOXYGEN__)
   /**
    * @brief   Termination waiting list.
@@ -293,11 +632,77 @@ struct ch_thread {
    */
   void                  *mpool;
 #endif
+#if ((CH_CFG_USE_DYNAMIC == TRUE) && (CH_CFG_USE_THREAD_CACHE == TRUE)) ||  \
+    defined(__DOXYGEN__)
+  /**
+   * @brief   Threads cache where the thread workspace is returned.
+   */
+  struct ch_thread_cache *cache;
+#endif
 #if (CH_DBG_STATISTICS == TRUE) || defined(__DOXYGEN__)
   /**
    * @brief   Thread statistics.
    */
   time_measurement_t    stats;
+  /**
+   * @brief   Cumulative run time in realtime counter cycles.
+   * @note    The time spent in ISRs is not accounted to threads.
+   */
+  rttime_t              runtime;
+  /**
+   * @brief   Run time at the start of the current load window.
+   */
+  rttime_t              loadmark;
+  /**
+   * @brief   Thread load over the last load window, in percent.
+   */
+  uint8_t               load;
+#endif
+#if (CH_DBG_WAIT_PROFILE == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Current wait start time.
+   */
+  rtcnt_t               wpstart;
+  /**
+   * @brief   Current wait object or @p NULL.
+   */
+  void                  *wpobjp;
+  /**
+   * @brief   Current wait state, @p CH_STATE_READY if not waiting.
+   */
+  tstate_t              wpstate;
+#endif
+#if (CH_CFG_THREAD_SPECIFIC_KEYS > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   Thread specific data slots.
+   */
+  void                  *specific[CH_CFG_THREAD_SPECIFIC_KEYS];
+#endif
+#if (CH_CFG_REGISTRY_INDEX_SIZE > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   Next thread in the same names index bucket.
+   */
+  thread_t              *nnext;
+  /**
+   * @brief   Next thread in the same pointers index bucket.
+   */
+  thread_t              *pnext;
+  /**
+   * @brief   Hash of the thread name.
+   */
+  uint32_t              nhash;
+#endif
+#if (CH_CFG_USE_BUDGET == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Execution budget of this thread or @p NULL.
+   */
+  thread_budget_t       *budgetp;
+#endif
+#if (CH_CFG_USE_PERIODIC == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Release schedule of this thread or @p NULL.
+   */
+  periodic_thread_t     *periodicp;
 #endif
 #if defined(CH_CFG_THREAD_EXTRA_FIELDS)
   /* Extra fields defined in chconf.h.*/
@@ -313,25 +718,67 @@ struct ch_thread {
 struct ch_virtual_timer {
   virtual_timer_t       *next;      /**< @brief Next timer in the list.     */
   virtual_timer_t       *prev;      /**< @brief Previous timer in the list. */
+#if (CH_CFG_VT_WHEEL == FALSE) || defined(__DOXYGEN__)
   sysinterval_t         delta;      /**< @brief Time delta before timeout.  */
+#endif
+#if (CH_CFG_VT_WHEEL == TRUE) || defined(__DOXYGEN__)
+  sysinterval_t         expires;    /**< @brief Expiration wheel time.      */
+#endif
   vtfunc_t              func;       /**< @brief Timer callback function
                                                 pointer.                    */
   void                  *par;       /**< @brief Timer callback function
                                                 parameter.                  */
 };
 
+#if (CH_CFG_VT_WHEEL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Timing wheel slot header.
+ * @note    The slot is a circular double linked list of timers, the header
+ *          shares the layout of the first two fields of
+ *          @p virtual_timer_t.
+ */
+typedef struct {
+  virtual_timer_t       *next;      /**< @brief First timer in the slot.    */
+  virtual_timer_t       *prev;      /**< @brief Last timer in the slot.     */
+} vt_slot_t;
+#endif
+
 /**
  * @brief   Virtual timers list header.
  * @note    The timers list is implemented as a double link bidirectional list
  *          in order to make the unlink time constant, the reset of a virtual
  *          timer is often used in the code.
+ * @note    If @p CH_CFG_VT_WHEEL is enabled then the timers are organized
+ *          in a hierarchical timing wheel instead of a delta list.
  */
 struct ch_virtual_timers_list {
+#if (CH_CFG_VT_WHEEL == FALSE) || defined(__DOXYGEN__)
   virtual_timer_t       *next;      /**< @brief Next timer in the delta
                                                 list.                       */
   virtual_timer_t       *prev;      /**< @brief Last timer in the delta
                                                 list.                       */
   sysinterval_t         delta;      /**< @brief Must be initialized to -1.  */
+#endif
+#if (CH_CFG_VT_WHEEL == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Wheel slots, one row for each level.
+   */
+  vt_slot_t             slots[CH_CFG_VT_WHEEL_LEVELS][CH_VT_WHEEL_SLOTS];
+  /**
+   * @brief   Non-empty slots bitmap for each level.
+   */
+  uint32_t              bitmap[CH_CFG_VT_WHEEL_LEVELS];
+  /**
+   * @brief   Wheel time, it is the time of the last processed tick.
+   */
+  sysinterval_t         wtime;
+#if (CH_CFG_ST_TIMEDELTA > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   Wheel time of the currently programmed alarm.
+   */
+  sysinterval_t         alarm;
+#endif
+#endif
 #if (CH_CFG_ST_TIMEDELTA == 0) || defined(__DOXYGEN__)
   volatile systime_t    systime;    /**< @brief System Time counter.        */
 #endif
@@ -342,12 +789,19 @@ struct ch_virtual_timers_list {
   systime_t             lasttime;   /**< @brief System time of the last
                                                 tick event.                 */
 #endif
+#if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Last generated time stamp.
+   */
+  systimestamp_t        laststamp;
+#endif
 };
 
 /**
  * @extends threads_queue_t
  */
 struct ch_ready_list {
+  CH_CACHE_ALIGNED
   threads_queue_t       queue;      /**< @brief Threads queue.              */
   tprio_t               prio;       /**< @brief This field must be
                                                 initialized to zero.        */
@@ -360,6 +814,32 @@ struct ch_ready_list {
   /* End of the fields shared with the thread_t structure.*/
   thread_t              *current;   /**< @brief The currently running
                                                 thread.                     */
+#if (CH_CFG_USE_REGISTRY == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Registry generation counter.
+   * @details It is incremented on each registry insertion or removal.
+   */
+  ucnt_t                regseq;
+#endif
+#if (CH_CFG_READY_LIST_BITMAP == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Summary of the non-empty words in @p bitmap.
+   */
+  uint32_t              summary;
+  /**
+   * @brief   Bitmap of the non-empty priority levels.
+   * @note    Priority levels are mapped starting from the MSB of each word
+   *          so that the next non-empty level is found using a CLZ
+   *          operation.
+   */
+  uint32_t              bitmap[CH_SCH_BITMAP_WORDS];
+  /**
+   * @brief   Last thread in the ready list for each priority level.
+   * @note    An element is only valid if the corresponding bit is set in
+   *          @p bitmap.
+   */
+  thread_t              *tails[CH_SCH_PRIO_LEVELS];
+#endif
 };
 
 /**
@@ -405,10 +885,13 @@ struct ch_system {
   /**
    * @brief   Virtual timers delta list header.
    */
+  CH_CACHE_ALIGNED
   virtual_timers_list_t vtlist;
+  /* Cold fields, not used by the scheduler and the timers.*/
   /**
    * @brief   System debug.
    */
+  CH_CACHE_ALIGNED
   system_debug_t        dbg;
   /**
    * @brief   Main thread descriptor.
@@ -425,6 +908,22 @@ struct ch_system {
    * @brief   Global kernel statistics.
    */
   kernel_stats_t        kernel_stats;
+#endif
+#if (CH_DBG_WAIT_PROFILE == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Wait profiler table.
+   */
+  wait_profile_t        wait_profile;
+#endif
+#if (CH_CFG_REGISTRY_INDEX_SIZE > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   Registry names index buckets.
+   */
+  thread_t              *regnames[CH_CFG_REGISTRY_INDEX_SIZE];
+  /**
+   * @brief   Registry pointers index buckets.
+   */
+  thread_t              *regptrs[CH_CFG_REGISTRY_INDEX_SIZE];
 #endif
   CH_CFG_SYSTEM_EXTRA_FIELDS
 };
@@ -464,14 +963,24 @@ extern "C" {
   void _scheduler_init(void);
   thread_t *chSchReadyI(thread_t *tp);
   thread_t *chSchReadyAheadI(thread_t *tp);
+#if CH_CFG_READY_LIST_BITMAP == TRUE
+  thread_t *chSchDequeueReadyI(thread_t *tp);
+#endif
+  thread_t *chSchRequeueReadyI(thread_t *tp);
   void chSchGoSleepS(tstate_t newstate);
   msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout);
+  msg_t chSchGoSleepWithSlackS(tstate_t newstate, sysinterval_t timeout,
+                               sysinterval_t slack);
   void chSchWakeupS(thread_t *ntp, msg_t msg);
   void chSchRescheduleS(void);
   bool chSchIsPreemptionRequired(void);
   void chSchDoRescheduleBehind(void);
   void chSchDoRescheduleAhead(void);
   void chSchDoReschedule(void);
+#if CH_CFG_USE_SCHED_BATCH == TRUE
+  void chSchBatchBegin(void);
+  void chSchBatchEnd(void);
+#endif
 #if CH_CFG_OPTIMIZE_SPEED == FALSE
   void queue_prio_insert(thread_t *tp, threads_queue_t *tqp);
   void queue_insert(thread_t *tp, threads_queue_t *tqp);
@@ -566,6 +1075,104 @@ static inline bool queue_notempty(const threads_queue_t *tqp) {
   return (bool)(tqp->next != (const thread_t *)tqp);
 }
 
+#if (CH_CFG_USE_WAIT_MULTIPLE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Multiple wait objects list initialization.
+ *
+ * @param[in] wlp       pointer to the wait objects list
+ *
+ * @notapi
+ */
+static inline void wait_list_init(wait_list_t *wlp) {
+
+  wlp->next = (wait_object_t *)wlp;
+  wlp->prev = (wait_object_t *)wlp;
+}
+#endif
+
+#if (CH_CFG_QUEUE_BUCKETS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Adds a just linked thread to the priority buckets.
+ * @details The thread joins the bucket of the preceding thread if it has
+ *          the same priority else it forms a new bucket.
+ *
+ * @param[in] tp        the pointer to the linked thread
+ * @param[in] cp        the pointer to the preceding thread, it is the last
+ *                      of its bucket
+ * @param[in] tqp       the pointer to the threads list header
+ *
+ * @notapi
+ */
+static inline void queue_bucket_link(thread_t *tp, thread_t *cp,
+                                     threads_queue_t *tqp) {
+
+  if ((cp != (thread_t *)tqp) && (cp->prio == tp->prio)) {
+    thread_t *fp;
+
+    if (cp->qbpos == CH_QBUCKET_SINGLE) {
+      fp = cp;
+      cp->qbpos = CH_QBUCKET_FIRST;
+    }
+    else {
+      fp = cp->qbucket;
+      cp->qbpos = CH_QBUCKET_MIDDLE;
+    }
+    fp->qbucket = tp;
+    tp->qbucket = fp;
+    tp->qbpos   = CH_QBUCKET_LAST;
+  }
+  else {
+    tp->qbucket = tp;
+    tp->qbpos   = CH_QBUCKET_SINGLE;
+  }
+}
+
+/**
+ * @brief   Removes a thread from the priority buckets.
+ * @details The adjacent thread becomes the new end of the bucket, the
+ *          function must be invoked before unlinking the thread.
+ * @note    The buckets are kept by position so a priority changed while
+ *          in a queue does not break the structure.
+ *
+ * @param[in] tp        the pointer to the thread to be removed
+ *
+ * @notapi
+ */
+static inline void queue_bucket_unlink(thread_t *tp) {
+  thread_t *ep = tp->qbucket;
+  thread_t *np;
+
+  if (tp->qbpos == CH_QBUCKET_FIRST) {
+    np = tp->queue.next;
+    if (np == ep) {
+      ep->qbucket = ep;
+      ep->qbpos   = CH_QBUCKET_SINGLE;
+    }
+    else {
+      np->qbucket = ep;
+      np->qbpos   = CH_QBUCKET_FIRST;
+      ep->qbucket = np;
+    }
+  }
+  else if (tp->qbpos == CH_QBUCKET_LAST) {
+    np = tp->queue.prev;
+    if (np == ep) {
+      ep->qbucket = ep;
+      ep->qbpos   = CH_QBUCKET_SINGLE;
+    }
+    else {
+      np->qbucket = ep;
+      np->qbpos   = CH_QBUCKET_LAST;
+      ep->qbucket = np;
+    }
+  }
+  else {
+    /* Single, middle or not bucketed, no other thread is affected.*/
+  }
+  tp->qbpos = CH_QBUCKET_NONE;
+}
+#endif /* CH_CFG_QUEUE_BUCKETS == TRUE */
+
 /* If the performance code path has been chosen then all the following
    functions are inlined into the various kernel modules.*/
 #if CH_CFG_OPTIMIZE_SPEED == TRUE
@@ -585,6 +1192,18 @@ static inline thread_t *list_remove(threads_list_t *tlp) {
 
 static inline void queue_prio_insert(thread_t *tp, threads_queue_t *tqp) {
 
+#if CH_CFG_QUEUE_BUCKETS == TRUE
+  /* Scanning backward one bucket at time.*/
+  thread_t *cp = tqp->prev;
+  while ((cp != (thread_t *)tqp) && (cp->prio < tp->prio)) {
+    cp = cp->qbucket->queue.prev;
+  }
+  tp->queue.prev             = cp;
+  tp->queue.next             = cp->queue.next;
+  tp->queue.next->queue.prev = tp;
+  cp->queue.next             = tp;
+  queue_bucket_link(tp, cp, tqp);
+#else
   thread_t *cp = (thread_t *)tqp;
   do {
     cp = cp->queue.next;
@@ -593,10 +1212,14 @@ static inline void queue_prio_insert(thread_t *tp, threads_queue_t *tqp) {
   tp->queue.prev             = cp->queue.prev;
   tp->queue.prev->queue.next = tp;
   cp->queue.prev             = tp;
+#endif
 }
 
 static inline void queue_insert(thread_t *tp, threads_queue_t *tqp) {
 
+#if CH_CFG_QUEUE_BUCKETS == TRUE
+  queue_bucket_link(tp, tqp->prev, tqp);
+#endif
   tp->queue.next             = (thread_t *)tqp;
   tp->queue.prev             = tqp->prev;
   tp->queue.prev->queue.next = tp;
@@ -606,6 +1229,9 @@ static inline void queue_insert(thread_t *tp, threads_queue_t *tqp) {
 static inline thread_t *queue_fifo_remove(threads_queue_t *tqp) {
   thread_t *tp = tqp->next;
 
+#if CH_CFG_QUEUE_BUCKETS == TRUE
+  queue_bucket_unlink(tp);
+#endif
   tqp->next             = tp->queue.next;
   tqp->next->queue.prev = (thread_t *)tqp;
 
@@ -615,6 +1241,9 @@ static inline thread_t *queue_fifo_remove(threads_queue_t *tqp) {
 static inline thread_t *queue_lifo_remove(threads_queue_t *tqp) {
   thread_t *tp = tqp->prev;
 
+#if CH_CFG_QUEUE_BUCKETS == TRUE
+  queue_bucket_unlink(tp);
+#endif
   tqp->prev             = tp->queue.prev;
   tqp->prev->queue.next = (thread_t *)tqp;
 
@@ -623,6 +1252,9 @@ static inline thread_t *queue_lifo_remove(threads_queue_t *tqp) {
 
 static inline thread_t *queue_dequeue(thread_t *tp) {
 
+#if CH_CFG_QUEUE_BUCKETS == TRUE
+  queue_bucket_unlink(tp);
+#endif
   tp->queue.prev->queue.next = tp->queue.next;
   tp->queue.next->queue.prev = tp->queue.prev;
 
@@ -630,6 +1262,76 @@ static inline thread_t *queue_dequeue(thread_t *tp) {
 }
 #endif /* CH_CFG_OPTIMIZE_SPEED == TRUE */
 
+#if (CH_CFG_READY_LIST_BITMAP == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Removes a thread from the ready list.
+ * @details The thread is removed from the ready list regardless of its
+ *          relative position, this is required when a ready thread changes
+ *          priority and must be re-enqueued.
+ * @pre     The thread must be in @p CH_STATE_READY state.
+ *
+ * @param[in] tp        the pointer to the thread to be removed
+ * @return              The removed thread pointer.
+ *
+ * @iclass
+ */
+static inline thread_t *chSchDequeueReadyI(thread_t *tp) {
+
+  chDbgCheckClassI();
+
+  return queue_dequeue(tp);
+}
+#endif /* CH_CFG_READY_LIST_BITMAP == FALSE */
+
+#if (CH_CFG_EDF_PRIO > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Compares two absolute deadlines.
+ * @note    The deadlines must lie within half of the system time range
+ *          from each other.
+ *
+ * @param[in] d1        the first deadline
+ * @param[in] d2        the second deadline
+ * @return              The comparison result.
+ * @retval true         if @p d1 is earlier than @p d2.
+ * @retval false        if @p d1 is equal or later than @p d2.
+ *
+ * @xclass
+ */
+static inline bool chSchIsEarlierX(systime_t d1, systime_t d2) {
+  sysinterval_t diff = chTimeDiffX(d1, d2);
+
+  return (diff > (sysinterval_t)0) &&
+         (diff <= (sysinterval_t)((systime_t)~(systime_t)0 >> 1));
+}
+#endif
+
+/**
+ * @brief   Determines if a thread has precedence over another thread.
+ * @details A thread has precedence if it has higher priority or, inside
+ *          the EDF priority band, an earlier deadline.
+ *
+ * @param[in] ntp       the thread to be evaluated, it can also be the ready
+ *                      list header
+ * @param[in] otp       the thread to be compared with
+ * @return              The precedence situation.
+ * @retval true         if @p ntp must run before @p otp.
+ * @retval false        if @p ntp must not preempt @p otp.
+ *
+ * @xclass
+ */
+static inline bool chSchHasPrecedenceX(const thread_t *ntp,
+                                       const thread_t *otp) {
+
+#if CH_CFG_EDF_PRIO > 0
+  if ((ntp->prio == (tprio_t)CH_CFG_EDF_PRIO) &&
+      (otp->prio == (tprio_t)CH_CFG_EDF_PRIO)) {
+    return chSchIsEarlierX(ntp->deadline, otp->deadline);
+  }
+#endif
+
+  return ntp->prio > otp->prio;
+}
+
 /**
  * @brief   Determines if the current thread must reschedule.
  * @details This function returns @p true if there is a ready thread with
@@ -645,7 +1347,7 @@ static inline bool chSchIsRescRequiredI(void) {
 
   chDbgCheckClassI();
 
-  return firstprio(&ch.rlist.queue) > currp->prio;
+  return chSchHasPrecedenceX(ch.rlist.queue.next, currp);
 }
 
 /**
@@ -690,22 +1392,26 @@ static inline void chSchDoYieldS(void) {
  * @special
  */
 static inline void chSchPreemption(void) {
-  tprio_t p1 = firstprio(&ch.rlist.queue);
-  tprio_t p2 = currp->prio;
+  thread_t *ntp = ch.rlist.queue.next;
 
 #if CH_CFG_TIME_QUANTUM > 0
+#if CH_CFG_EDF_PRIO > 0
+  if ((currp->ticks > (tslices_t)0) ||
+      (currp->prio == (tprio_t)CH_CFG_EDF_PRIO)) {
+#else
   if (currp->ticks > (tslices_t)0) {
-    if (p1 > p2) {
+#endif
+    if (chSchHasPrecedenceX(ntp, currp)) {
       chSchDoRescheduleAhead();
     }
   }
   else {
-    if (p1 >= p2) {
+    if (ntp->prio >= currp->prio) {
       chSchDoRescheduleBehind();
     }
   }
 #else /* CH_CFG_TIME_QUANTUM == 0 */
-  if (p1 > p2) {
+  if (chSchHasPrecedenceX(ntp, currp)) {
     chSchDoRescheduleAhead();
   }
 #endif /* CH_CFG_TIME_QUANTUM == 0 */
@@ -53,6 +53,11 @@ typedef struct ch_semaphore {
   threads_queue_t       queue;      /**< @brief Queue of the threads sleeping
                                                 on this semaphore.          */
   cnt_t                 cnt;        /**< @brief The semaphore counter.      */
+#if (CH_CFG_USE_WAIT_MULTIPLE == TRUE) || defined(__DOXYGEN__)
+  wait_list_t           waiters;    /**< @brief Wait objects of the threads
+                                                waiting on multiple objects
+                                                including this semaphore.   */
+#endif
 } semaphore_t;
 
 /*===========================================================================*/
@@ -68,7 +73,12 @@ typedef struct ch_semaphore {
  * @param[in] n         the counter initial value, this value must be
  *                      non-negative
  */
+#if (CH_CFG_USE_WAIT_MULTIPLE == TRUE) || defined(__DOXYGEN__)
+#define _SEMAPHORE_DATA(name, n) {_THREADS_QUEUE_DATA(name.queue), n,       \
+                                  _WAIT_LIST_DATA(name.waiters)}
+#else
 #define _SEMAPHORE_DATA(name, n) {_THREADS_QUEUE_DATA(name.queue), n}
+#endif
 
 /**
  * @brief   Static semaphore initializer.
@@ -96,6 +106,7 @@ extern "C" {
   msg_t chSemWaitTimeout(semaphore_t *sp, sysinterval_t timeout);
   msg_t chSemWaitTimeoutS(semaphore_t *sp, sysinterval_t timeout);
   void chSemSignal(semaphore_t *sp);
+  void chSemSignalN(semaphore_t *sp, cnt_t n);
   void chSemSignalI(semaphore_t *sp);
   void chSemAddCounterI(semaphore_t *sp, cnt_t n);
   msg_t chSemSignalWait(semaphore_t *sps, semaphore_t *spw);
@@ -107,6 +118,25 @@ extern "C" {
 /* Module inline functions.                                                  */
 /*===========================================================================*/
 
+/**
+ * @brief   Performs multiple signal operations on a semaphore.
+ * @details This function is equivalent to @p n calls to @p chSemSignalI()
+ *          but the semaphore counter is updated once.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel. Note that
+ *          interrupt handlers always reschedule on exit so an explicit
+ *          reschedule must not be performed in ISRs.
+ *
+ * @param[in] sp        pointer to a @p semaphore_t structure
+ * @param[in] n         number of signal operations, it must be positive
+ *
+ * @iclass
+ */
+static inline void chSemSignalNI(semaphore_t *sp, cnt_t n) {
+
+  chSemAddCounterI(sp, n);
+}
+
 /**
  * @brief   Decreases the semaphore counter.
  * @details This macro can be used when the counter is known to be positive.
@@ -126,6 +156,7 @@ static inline void chSemFastWaitI(semaphore_t *sp) {
  * @brief   Increases the semaphore counter.
  * @details This macro can be used when the counter is known to be not
  *          negative.
+ * @note    Threads waiting on multiple objects are not notified.
  *
  * @param[in] sp        pointer to a @p semaphore_t structure
  *
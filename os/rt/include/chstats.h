@@ -56,10 +56,30 @@
 typedef struct {
   ucnt_t                n_irq;      /**< @brief Number of IRQs.             */
   ucnt_t                n_ctxswc;   /**< @brief Number of context switches. */
+  ucnt_t                n_vtsaved;  /**< @brief Number of timer alarms
+                                                saved by coalescing.        */
   time_measurement_t    m_crit_thd; /**< @brief Measurement of threads
                                                 critical zones duration.    */
   time_measurement_t    m_crit_isr; /**< @brief Measurement of ISRs critical
                                                 zones duration.             */
+#if (CH_CFG_USE_TM_HISTOGRAM == TRUE) || defined(__DOXYGEN__)
+  tm_histogram_t        h_crit_thd; /**< @brief Histogram of threads
+                                                critical zones duration.    */
+  tm_histogram_t        h_crit_isr; /**< @brief Histogram of ISRs critical
+                                                zones duration.             */
+#endif
+  rttime_t              isr_cumulative; /**< @brief Cumulative ISRs
+                                                execution time.             */
+  rttime_t              isr_loadmark; /**< @brief ISRs time at the start of
+                                                the current load window.    */
+  uint8_t               isr_load;   /**< @brief ISRs load over the last
+                                                load window, in percent.    */
+  cnt_t                 isr_nesting; /**< @brief ISRs nesting level.        */
+  rtcnt_t               isr_start;  /**< @brief Outermost ISR start time.   */
+  rtcnt_t               isr_pending; /**< @brief ISRs time not yet
+                                                subtracted from the current
+                                                thread.                     */
+  rtcnt_t               lastswc;    /**< @brief Last context switch time.   */
 } kernel_stats_t;
 
 /*===========================================================================*/
@@ -75,6 +95,10 @@ extern "C" {
 #endif
   void _stats_init(void);
   void _stats_increase_irq(void);
+  void _stats_start_measure_isr(void);
+  void _stats_stop_measure_isr(void);
+  void _stats_update_runtime(void);
+  void _stats_increase_vtsaved(void);
   void _stats_ctxswc(thread_t *ntp, thread_t *otp);
   void _stats_start_measure_crit_thd(void);
   void _stats_stop_measure_crit_thd(void);
@@ -92,6 +116,10 @@ extern "C" {
 
 /* Stub functions for when the statistics module is disabled. */
 #define _stats_increase_irq()
+#define _stats_start_measure_isr()
+#define _stats_stop_measure_isr()
+#define _stats_update_runtime()
+#define _stats_increase_vtsaved()
 #define _stats_ctxswc(old, new)
 #define _stats_start_measure_crit_thd()
 #define _stats_stop_measure_crit_thd()
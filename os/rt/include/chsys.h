@@ -56,6 +56,43 @@
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Type of an incremental integrity check state.
+ * @details The state is owned by the caller, each check is resumed from
+ *          the element last verified by the previous step.
+ */
+typedef struct ch_integrity_check {
+  /**
+   * @brief   Mask of the checks to be performed.
+   */
+  unsigned              testmask;
+  /**
+   * @brief   Check currently in progress.
+   */
+  unsigned              current;
+  /**
+   * @brief   Last verified element or @p NULL if the check is starting
+   *          from the list header.
+   */
+  void                  *cursor;
+#if (CH_CFG_VT_WHEEL == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Wheel slot being checked.
+   */
+  unsigned              slot;
+#endif
+#if (CH_CFG_USE_REGISTRY == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Registry generation when the cursor has been taken.
+   */
+  ucnt_t                regseq;
+#endif
+  /**
+   * @brief   Number of completed passes over all the enabled checks.
+   */
+  ucnt_t                passes;
+} integrity_check_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -110,6 +147,7 @@
   PORT_IRQ_PROLOGUE();                                                      \
   CH_CFG_IRQ_PROLOGUE_HOOK();                                               \
   _stats_increase_irq();                                                    \
+  _stats_start_measure_isr();                                               \
   _trace_isr_enter(__func__);                                               \
   _dbg_check_enter_isr()
 
@@ -124,6 +162,7 @@
 #define CH_IRQ_EPILOGUE()                                                   \
   _dbg_check_leave_isr();                                                   \
   _trace_isr_leave(__func__);                                               \
+  _stats_stop_measure_isr();                                                \
   CH_CFG_IRQ_EPILOGUE_HOOK();                                               \
   PORT_IRQ_EPILOGUE()
 
@@ -284,6 +323,8 @@ extern "C" {
 #endif
   void chSysInit(void);
   bool chSysIntegrityCheckI(unsigned testmask);
+  void chSysIntegrityObjectInit(integrity_check_t *icp, unsigned testmask);
+  bool chSysIntegrityStepI(integrity_check_t *icp, unsigned n);
   void chSysTimerHandlerI(void);
   syssts_t chSysGetStatusAndLockX(void);
   void chSysRestoreStatusX(syssts_t sts);
@@ -370,10 +411,18 @@ static inline void chSysUnlock(void) {
   /* The following condition can be triggered by the use of i-class functions
      in a critical section not followed by a chSchResceduleS(), this means
      that the current thread has a lower priority than the next thread in
-     the ready list.*/
+     the ready list. Inside a scheduler batch the reschedule is deferred
+     on purpose to the end of the batch.*/
+#if CH_CFG_USE_SCHED_BATCH == TRUE
+  chDbgAssert((ch.rlist.current->batch > (uint8_t)0) ||
+              (ch.rlist.queue.next == (thread_t *)&ch.rlist.queue) ||
+              (ch.rlist.current->prio >= ch.rlist.queue.next->prio),
+              "priority order violation");
+#else
   chDbgAssert((ch.rlist.queue.next == (thread_t *)&ch.rlist.queue) ||
               (ch.rlist.current->prio >= ch.rlist.queue.next->prio),
               "priority order violation");
+#endif
 
   port_unlock();
 }
@@ -75,6 +75,16 @@ typedef struct ch_threads_queue threads_queue_t;
  */
 typedef struct ch_ready_list ready_list_t;
 
+/**
+ * @brief   Type of a multiple wait object.
+ */
+typedef struct ch_wait_object wait_object_t;
+
+/**
+ * @brief   Type of a multiple wait objects list header.
+ */
+typedef struct ch_wait_list wait_list_t;
+
 /**
  * @brief   Type of a Virtual Timer callback function.
  */
@@ -90,6 +100,16 @@ typedef struct ch_virtual_timer virtual_timer_t;
  */
 typedef struct ch_virtual_timers_list  virtual_timers_list_t;
 
+/**
+ * @brief   Type of a thread execution budget.
+ */
+typedef struct ch_thread_budget thread_budget_t;
+
+/**
+ * @brief   Type of a periodic thread release schedule.
+ */
+typedef struct ch_periodic_thread periodic_thread_t;
+
 /**
  * @brief   Type of a system debug structure.
  */
@@ -38,10 +38,35 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Static threads table.
+ * @details If enabled then the threads described in the constant
+ *          @p ch_threads_table array are created by @p chSysInit() in a
+ *          single pass, the table is defined using the
+ *          @p THD_TABLE_BEGIN, @p THD_TABLE_ENTRY and @p THD_TABLE_END
+ *          macros.
+ * @note    If @p CH_DBG_FILL_THREADS is enabled then the stacks of the
+ *          table threads are filled later by the idle thread.
+ */
+#if !defined(CH_CFG_USE_THREADS_TABLE) || defined(__DOXYGEN__)
+#define CH_CFG_USE_THREADS_TABLE            FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+/**
+ * @brief   Alignment of the working areas end.
+ * @note    The thread structure is placed at the end of the working area,
+ *          with the cache lines aware layout it is cache line aligned.
+ */
+#if (CH_CFG_CACHE_LAYOUT == TRUE) || defined(__DOXYGEN__)
+#define THD_WORKING_AREA_END_ALIGN          PORT_CACHE_LINE_SIZE
+#else
+#define THD_WORKING_AREA_END_ALIGN          PORT_STACK_ALIGN
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -51,6 +76,13 @@
  */
 typedef void (*tfunc_t)(void *p);
 
+#if (CH_CFG_THREAD_SPECIFIC_KEYS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a thread specific data key.
+ */
+typedef unsigned thdkey_t;
+#endif
+
 /**
  * @brief   Type of a thread descriptor.
  */
@@ -81,6 +113,92 @@ typedef struct {
   void              *arg;
 } thread_descriptor_t;
 
+#if (CH_CFG_USE_BUDGET == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Structure representing a thread execution budget.
+ */
+struct ch_thread_budget {
+  /**
+   * @brief   Replenishment timer.
+   */
+  virtual_timer_t   vt;
+  /**
+   * @brief   Budgeted thread.
+   */
+  thread_t          *tp;
+  /**
+   * @brief   Execution budget in ticks for each period.
+   */
+  sysinterval_t     budget;
+  /**
+   * @brief   Replenishment period.
+   */
+  sysinterval_t     period;
+  /**
+   * @brief   Ticks remaining in the current period.
+   */
+  sysinterval_t     remaining;
+  /**
+   * @brief   Thread priority while the budget is not used up.
+   */
+  tprio_t           prio;
+  /**
+   * @brief   Thread priority after the budget is used up.
+   */
+  tprio_t           lowprio;
+};
+#endif
+
+#if (CH_CFG_USE_PERIODIC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Structure representing a periodic thread release schedule.
+ */
+struct ch_periodic_thread {
+  /**
+   * @brief   Release timer.
+   */
+  virtual_timer_t   vt;
+  /**
+   * @brief   Periodic thread.
+   */
+  thread_t          *tp;
+  /**
+   * @brief   Reference to the thread waiting for the next release.
+   */
+  thread_reference_t trp;
+  /**
+   * @brief   Absolute time of the next release.
+   */
+  systime_t         next;
+#if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Time stamp of the next release.
+   */
+  systimestamp_t    stamp;
+#endif
+  /**
+   * @brief   Release period.
+   */
+  sysinterval_t     period;
+  /**
+   * @brief   Number of releases missed since the thread creation.
+   */
+  ucnt_t            overruns;
+  /**
+   * @brief   A release has been missed since the last wait.
+   */
+  bool              missed;
+#if (CH_CFG_USE_TM == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Release jitter measurement.
+   * @details Time from each release to the return of
+   *          @p chThdWaitNextPeriod().
+   */
+  time_measurement_t jitter;
+#endif
+};
+#endif
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -120,7 +238,8 @@ typedef struct {
  * @api
  */
 #define THD_WORKING_AREA_SIZE(n)                                            \
-  MEM_ALIGN_NEXT(sizeof(thread_t) + PORT_WA_SIZE(n), PORT_STACK_ALIGN)
+  MEM_ALIGN_NEXT(sizeof(thread_t) + PORT_WA_SIZE(n),                        \
+                 THD_WORKING_AREA_END_ALIGN)
 
 /**
  * @brief   Static working area allocation.
@@ -132,7 +251,12 @@ typedef struct {
  *
  * @api
  */
+#if (CH_CFG_CACHE_LAYOUT == FALSE) || defined(__DOXYGEN__)
 #define THD_WORKING_AREA(s, n) PORT_WORKING_AREA(s, n)
+#else
+#define THD_WORKING_AREA(s, n)                                              \
+  ALIGNED_VAR(PORT_CACHE_LINE_SIZE) PORT_WORKING_AREA(s, n)
+#endif
 
 /**
  * @brief   Base of a working area casted to the correct type.
@@ -161,6 +285,33 @@ typedef struct {
 #define THD_FUNCTION(tname, arg) PORT_THD_FUNCTION(tname, arg)
 /** @} */
 
+#if (CH_CFG_USE_THREADS_TABLE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @name    Threads tables definition macros
+ * @{
+ */
+/**
+ * @brief   Start of user threads table.
+ */
+#define THD_TABLE_BEGIN                                                     \
+  const thread_descriptor_t ch_threads_table[] = {
+
+/**
+ * @brief   Entry of user threads table.
+ */
+#define THD_TABLE_ENTRY(wa, name, prio, funcp, arg)                         \
+  {name, THD_WORKING_AREA_BASE(wa), THD_WORKING_AREA_END(wa),              \
+   prio, funcp, arg},
+
+/**
+ * @brief   End of user threads table.
+ */
+#define THD_TABLE_END                                                       \
+  {NULL, NULL, NULL, (tprio_t)0, NULL, NULL}                                \
+};
+/** @} */
+#endif /* CH_CFG_USE_THREADS_TABLE == TRUE */
+
 /**
  * @name    Macro Functions
  * @{
@@ -217,12 +368,25 @@ typedef struct {
 /* External declarations.                                                    */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_THREADS_TABLE == TRUE) && !defined(__DOXYGEN__)
+extern const thread_descriptor_t ch_threads_table[];
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
    thread_t *_thread_init(thread_t *tp, const char *name, tprio_t prio);
 #if CH_DBG_FILL_THREADS == TRUE
   void _thread_memfill(uint8_t *startp, uint8_t *endp, uint8_t v);
+#endif
+#if CH_CFG_USE_THREADS_TABLE == TRUE
+  void _thread_table_create(void);
+#if CH_DBG_FILL_THREADS == TRUE
+  void _thread_table_fill(void);
+#endif
+#endif
+#if CH_CFG_USE_BUDGET == TRUE
+  void _thread_budget_tick(thread_t *tp);
 #endif
   thread_t *chThdCreateSuspendedI(const thread_descriptor_t *tdp);
   thread_t *chThdCreateSuspended(const thread_descriptor_t *tdp);
@@ -241,6 +405,20 @@ extern "C" {
   msg_t chThdWait(thread_t *tp);
 #endif
   tprio_t chThdSetPriority(tprio_t newprio);
+#if CH_CFG_TIME_QUANTUM > 0
+  tslices_t chThdSetQuantum(tslices_t quantum);
+#endif
+#if CH_CFG_USE_PERIODIC == TRUE
+  thread_t *chPeriodicThreadCreate(periodic_thread_t *ptp,
+                                   const thread_descriptor_t *tdp,
+                                   sysinterval_t period);
+  msg_t chThdWaitNextPeriod(void);
+#endif
+#if CH_CFG_USE_BUDGET == TRUE
+  void chThdSetBudget(thread_budget_t *bp, sysinterval_t budget,
+                      sysinterval_t period, tprio_t lowprio);
+  void chThdClearBudget(void);
+#endif
   void chThdTerminate(thread_t *tp);
   msg_t chThdSuspendS(thread_reference_t *trp);
   msg_t chThdSuspendTimeoutS(thread_reference_t *trp, sysinterval_t timeout);
@@ -251,9 +429,25 @@ extern "C" {
   void chThdDequeueNextI(threads_queue_t *tqp, msg_t msg);
   void chThdDequeueAllI(threads_queue_t *tqp, msg_t msg);
   void chThdSleep(sysinterval_t time);
+  void chThdSleepWithSlack(sysinterval_t time, sysinterval_t slack);
   void chThdSleepUntil(systime_t time);
+#if CH_CFG_USE_TIMESTAMP == TRUE
+  void chThdSleepUntilTimeStamp(systimestamp_t stamp);
+#endif
   systime_t chThdSleepUntilWindowed(systime_t prev, systime_t next);
+#if CH_CFG_EDF_PRIO > 0
+  void chThdSetDeadline(systime_t deadline);
+  systime_t chThdSleepUntilRelease(systime_t prev, systime_t next,
+                                   systime_t deadline);
+#endif
   void chThdYield(void);
+#if (CH_DBG_FILL_THREADS == TRUE) &&                                        \
+    ((CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE))
+  size_t chThdGetStackFreeX(thread_t *tp);
+#endif
+#if CH_CFG_THREAD_SPECIFIC_KEYS > 0
+  thdkey_t chThdCreateKey(void);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -347,6 +541,39 @@ static inline bool chThdShouldTerminateX(void) {
   return (bool)((chThdGetSelfX()->flags & CH_FLAG_TERMINATE) != (tmode_t)0);
 }
 
+#if (CH_CFG_THREAD_SPECIFIC_KEYS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the specific data of the current thread.
+ *
+ * @param[in] key       a key returned by @p chThdCreateKey()
+ * @return              The value associated to the key.
+ * @retval NULL         if a value has not been set for the key.
+ *
+ * @xclass
+ */
+static inline void *chThdGetSpecificX(thdkey_t key) {
+
+  chDbgCheck(key < (thdkey_t)CH_CFG_THREAD_SPECIFIC_KEYS);
+
+  return chThdGetSelfX()->specific[key];
+}
+
+/**
+ * @brief   Sets the specific data of the current thread.
+ *
+ * @param[in] key       a key returned by @p chThdCreateKey()
+ * @param[in] p         the value to be associated to the key
+ *
+ * @xclass
+ */
+static inline void chThdSetSpecificX(thdkey_t key, void *p) {
+
+  chDbgCheck(key < (thdkey_t)CH_CFG_THREAD_SPECIFIC_KEYS);
+
+  chThdGetSelfX()->specific[key] = p;
+}
+#endif /* CH_CFG_THREAD_SPECIFIC_KEYS > 0 */
+
 /**
  * @brief   Resumes a thread created with @p chThdCreateI().
  *
@@ -382,6 +609,30 @@ static inline void chThdSleepS(sysinterval_t ticks) {
   (void) chSchGoSleepTimeoutS(CH_STATE_SLEEPING, ticks);
 }
 
+/**
+ * @brief   Suspends the invoking thread for a tolerant number of ticks.
+ * @details The thread is awakened after a time between @p ticks and
+ *          @p ticks + @p slack, the wakeup can share the deadline of other
+ *          timers in order to save alarm interrupts in tick-less mode.
+ *
+ * @param[in] ticks     the minimum delay in system ticks, the special values
+ *                      are handled as follow:
+ *                      - @a TIME_INFINITE the thread enters an infinite sleep
+ *                        state.
+ *                      - @a TIME_IMMEDIATE this value is not allowed.
+ *                      .
+ * @param[in] slack     the number of ticks the wakeup can be postponed
+ *
+ * @sclass
+ */
+static inline void chThdSleepWithSlackS(sysinterval_t ticks,
+                                        sysinterval_t slack) {
+
+  chDbgCheck(ticks != TIME_IMMEDIATE);
+
+  (void) chSchGoSleepWithSlackS(CH_STATE_SLEEPING, ticks, slack);
+}
+
 /**
  * @brief   Initializes a threads queue object.
  *
@@ -435,6 +686,36 @@ static inline void chThdDoDequeueNextI(threads_queue_t *tqp, msg_t msg) {
   (void) chSchReadyI(tp);
 }
 
+#if (CH_CFG_USE_PERIODIC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the number of releases missed by a periodic thread.
+ *
+ * @param[in] ptp       pointer to the @p periodic_thread_t object
+ * @return              The number of missed releases.
+ *
+ * @xclass
+ */
+static inline ucnt_t chPeriodicGetOverrunsX(periodic_thread_t *ptp) {
+
+  return ptp->overruns;
+}
+
+#if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the time stamp of the next release of a periodic thread.
+ *
+ * @param[in] ptp       pointer to the @p periodic_thread_t object
+ * @return              The time stamp of the next release.
+ *
+ * @xclass
+ */
+static inline systimestamp_t chPeriodicGetNextStampX(periodic_thread_t *ptp) {
+
+  return ptp->stamp;
+}
+#endif
+#endif
+
 #endif /* CHTHREADS_H */
 
 /** @} */
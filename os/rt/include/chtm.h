@@ -38,6 +38,16 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Time measurement histograms.
+ * @details If enabled then a log2-bucketed histogram can be attached to
+ *          time measurement objects, the kernel statistics use it for the
+ *          critical zones measurements.
+ */
+#if !defined(CH_CFG_USE_TM_HISTOGRAM) || defined(__DOXYGEN__)
+#define CH_CFG_USE_TM_HISTOGRAM             FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -46,6 +56,13 @@
 #error "CH_CFG_USE_TM requires PORT_SUPPORTS_RT"
 #endif
 
+/**
+ * @brief   Number of histogram buckets.
+ * @details Bucket zero counts null measurements, bucket @p k counts the
+ *          measurements in the range [2^(k-1), 2^k).
+ */
+#define CH_TM_HISTOGRAM_BUCKETS             ((sizeof (rtcnt_t) * 8U) + 1U)
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -60,6 +77,18 @@ typedef struct {
   rtcnt_t               offset;
 } tm_calibration_t;
 
+#if (CH_CFG_USE_TM_HISTOGRAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a time measurement histogram.
+ */
+typedef struct {
+  /**
+   * @brief   Measurements counters, one for each power of two.
+   */
+  ucnt_t                buckets[CH_TM_HISTOGRAM_BUCKETS];
+} tm_histogram_t;
+#endif
+
 /**
  * @brief   Type of a Time Measurement object.
  * @note    The maximum measurable time period depends on the implementation
@@ -75,6 +104,10 @@ typedef struct {
   rtcnt_t               last;           /**< @brief Last measurement.       */
   ucnt_t                n;              /**< @brief Number of measurements. */
   rttime_t              cumulative;     /**< @brief Cumulative measurement. */
+#if (CH_CFG_USE_TM_HISTOGRAM == TRUE) || defined(__DOXYGEN__)
+  tm_histogram_t        *histogram;     /**< @brief Attached histogram or
+                                                    @p NULL.                */
+#endif
 } time_measurement_t;
 
 /*===========================================================================*/
@@ -94,6 +127,10 @@ extern "C" {
   NOINLINE void chTMStopMeasurementX(time_measurement_t *tmp);
   NOINLINE void chTMChainMeasurementToX(time_measurement_t *tmp1,
                                         time_measurement_t *tmp2);
+#if CH_CFG_USE_TM_HISTOGRAM == TRUE
+  void chTMObjectInitHistogram(time_measurement_t *tmp, tm_histogram_t *hp);
+  rtcnt_t chTMGetPercentileX(const time_measurement_t *tmp, unsigned permille);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -86,12 +86,27 @@
 #if !defined(CH_DBG_TRACE_BUFFER_SIZE) || defined(__DOXYGEN__)
 #define CH_DBG_TRACE_BUFFER_SIZE            128
 #endif
+
+/**
+ * @brief   User trace events enabled at compile time.
+ * @details Each bit enables the user trace event with the same identifier,
+ *          calls to @p chDbgWriteTraceUserI() and @p chDbgWriteTraceUser()
+ *          with a constant disabled identifier generate no code.
+ */
+#if !defined(CH_DBG_TRACE_USER_MASK) || defined(__DOXYGEN__)
+#define CH_DBG_TRACE_USER_MASK              0xFFFFFFFFU
+#endif
 /** @} */
 
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+/**
+ * @brief   Maximum user trace event identifier.
+ */
+#define CH_TRACE_USER_MAX_ID                31U
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -108,6 +123,7 @@ typedef struct {
   uint32_t              type:3;
   /**
    * @brief   Switched out thread state.
+   * @note    For user records this field is the event identifier.
    */
   uint32_t              state:5;
   /**
@@ -189,6 +205,12 @@ typedef struct {
    * @brief   Ring buffer.
    */
   ch_trace_event_t      buffer[CH_DBG_TRACE_BUFFER_SIZE];
+  /**
+   * @brief   Enabled user trace events mask.
+   * @note    Placed after the buffer in order to not alter the layout
+   *          expected by debuggers.
+   */
+  uint32_t              user_enabled;
 } ch_trace_buffer_t;
 #endif /* CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED */
 
@@ -196,6 +218,57 @@ typedef struct {
 /* Module macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Verifies if an user trace event is enabled at compile time.
+ *
+ * @param[in] id        user event identifier
+ * @return              The enable status.
+ */
+#define CH_DBG_TRACE_USER_IS_ENABLED(id)                                    \
+  ((CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED) &&                     \
+   ((CH_DBG_TRACE_MASK & CH_DBG_TRACE_MASK_USER) != 0U) &&                  \
+   (((uint32_t)CH_DBG_TRACE_USER_MASK & (1UL << (id))) != 0U))
+
+#if (CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED) || defined(__DOXYGEN__)
+/**
+ * @brief   Adds an user trace record with an event identifier.
+ * @note    The call generates no code if the event is disabled at compile
+ *          time using @p CH_DBG_TRACE_USER_MASK.
+ *
+ * @param[in] id        user event identifier, from zero to
+ *                      @p CH_TRACE_USER_MAX_ID
+ * @param[in] up1       user parameter 1
+ * @param[in] up2       user parameter 2
+ *
+ * @iclass
+ */
+#define chDbgWriteTraceUserI(id, up1, up2) do {                             \
+  if (CH_DBG_TRACE_USER_IS_ENABLED(id)) {                                   \
+    _trace_user((uint8_t)(id), (void *)(up1), (void *)(up2));               \
+  }                                                                         \
+} while (false)
+
+/**
+ * @brief   Adds an user trace record with an event identifier.
+ * @note    The call generates no code if the event is disabled at compile
+ *          time using @p CH_DBG_TRACE_USER_MASK.
+ *
+ * @param[in] id        user event identifier, from zero to
+ *                      @p CH_TRACE_USER_MAX_ID
+ * @param[in] up1       user parameter 1
+ * @param[in] up2       user parameter 2
+ *
+ * @api
+ */
+#define chDbgWriteTraceUser(id, up1, up2) do {                              \
+  if (CH_DBG_TRACE_USER_IS_ENABLED(id)) {                                   \
+    chSysLock();                                                            \
+    _trace_user((uint8_t)(id), (void *)(up1), (void *)(up2));               \
+    chSysUnlock();                                                          \
+  }                                                                         \
+} while (false)
+#endif /* CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED */
+
 /* When a trace feature is disabled the associated functions are replaced by
    an empty macro. Note that the macros can be externally redefined in
    order to interface 3rd parties tracing tools.*/
@@ -221,6 +294,12 @@ typedef struct {
 #if !defined(chDbgWriteTrace)
 #define chDbgWriteTrace(up1, up2)
 #endif
+#if !defined(chDbgWriteTraceUserI)
+#define chDbgWriteTraceUserI(id, up1, up2)
+#endif
+#if !defined(chDbgWriteTraceUser)
+#define chDbgWriteTraceUser(id, up1, up2)
+#endif
 #endif /* CH_DBG_TRACE_MASK == CH_DBG_TRACE_MASK_DISABLED */
 
 /*===========================================================================*/
@@ -236,12 +315,17 @@ extern "C" {
   void _trace_isr_enter(const char *isr);
   void _trace_isr_leave(const char *isr);
   void _trace_halt(const char *reason);
+  void _trace_user(uint8_t id, void *up1, void *up2);
   void chDbgWriteTraceI(void *up1, void *up2);
   void chDbgWriteTrace(void *up1, void *up2);
   void chDbgSuspendTraceI(uint16_t mask);
   void chDbgSuspendTrace(uint16_t mask);
   void chDbgResumeTraceI(uint16_t mask);
   void chDbgResumeTrace(uint16_t mask);
+  void chDbgSetTraceMaskI(uint16_t mask);
+  void chDbgSetTraceMask(uint16_t mask);
+  void chDbgSetTraceUserMaskI(uint32_t mask);
+  void chDbgSetTraceUserMask(uint32_t mask);
 #endif /* CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED */
 #ifdef __cplusplus
 }
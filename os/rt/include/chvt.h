@@ -72,9 +72,18 @@
 extern "C" {
 #endif
   void _vt_init(void);
+#if CH_CFG_USE_TIMESTAMP == TRUE
+  void _vt_stamp_init(void);
+#endif
   void chVTDoSetI(virtual_timer_t *vtp, sysinterval_t delay,
                   vtfunc_t vtfunc, void *par);
   void chVTDoResetI(virtual_timer_t *vtp);
+  void chVTDoSetWindowI(virtual_timer_t *vtp, sysinterval_t delay,
+                        sysinterval_t slack, vtfunc_t vtfunc, void *par);
+#if CH_CFG_VT_WHEEL == TRUE
+  bool chVTGetTimersStateI(sysinterval_t *timep);
+  void chVTDoTickI(void);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -141,6 +150,61 @@ static inline systime_t chVTGetSystemTime(void) {
   return systime;
 }
 
+#if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Current time stamp.
+ * @details Returns the system time extended to 64 bits, unlike the system
+ *          time the time stamp never wraps so time stamps can be compared
+ *          and subtracted directly.
+ * @note    The extension is correct as long as the function is invoked
+ *          at least once each system time range, this is guaranteed by
+ *          an internal virtual timer.
+ *
+ * @return              The time stamp in ticks.
+ *
+ * @iclass
+ */
+static inline systimestamp_t chVTGetTimeStampI(void) {
+#if CH_CFG_ST_RESOLUTION == 64
+
+  chDbgCheckClassI();
+
+  return (systimestamp_t)chVTGetSystemTimeX();
+#else
+  systimestamp_t last = ch.vtlist.laststamp;
+  systime_t now = chVTGetSystemTimeX();
+
+  chDbgCheckClassI();
+
+  /* The difference is computed modulo the system time range, the full
+     wrapped amount is carried in the upper bits of the stamp.*/
+  last += (systimestamp_t)chTimeDiffX((systime_t)last, now);
+  ch.vtlist.laststamp = last;
+
+  return last;
+#endif
+}
+
+/**
+ * @brief   Current time stamp.
+ * @details Returns the system time extended to 64 bits.
+ * @see     chVTGetTimeStampI()
+ *
+ * @return              The time stamp in ticks.
+ *
+ * @api
+ */
+static inline systimestamp_t chVTGetTimeStamp(void) {
+  systimestamp_t stamp;
+
+  chSysLock();
+  stamp = chVTGetTimeStampI();
+  chSysUnlock();
+
+  return stamp;
+}
+#endif /* CH_CFG_USE_TIMESTAMP == TRUE */
+
 /**
  * @brief   Returns the elapsed time since the specified start time.
  *
@@ -206,6 +270,7 @@ static inline bool chVTIsSystemTimeWithin(systime_t start, systime_t end) {
  *
  * @iclass
  */
+#if (CH_CFG_VT_WHEEL == FALSE) || defined(__DOXYGEN__)
 static inline bool chVTGetTimersStateI(sysinterval_t *timep) {
 
   chDbgCheckClassI();
@@ -227,6 +292,7 @@ static inline bool chVTGetTimersStateI(sysinterval_t *timep) {
 
   return true;
 }
+#endif /* CH_CFG_VT_WHEEL == FALSE */
 
 /**
  * @brief   Returns @p true if the specified timer is armed.
@@ -358,6 +424,39 @@ static inline void chVTSet(virtual_timer_t *vtp, sysinterval_t delay,
   chSysUnlock();
 }
 
+/**
+ * @brief   Enables a virtual timer with an expiration window.
+ * @details If the virtual timer was already enabled then it is re-enabled
+ *          using the new parameters.
+ * @pre     The timer must have been initialized using @p chVTObjectInit()
+ *          or @p chVTDoSetI().
+ * @note    See @p chVTDoSetWindowI() for the coalescing rules.
+ *
+ * @param[in] vtp       the @p virtual_timer_t structure pointer
+ * @param[in] delay     the minimum number of ticks before the operation
+ *                      timeouts, the special values are handled as follow:
+ *                      - @a TIME_INFINITE is allowed but interpreted as a
+ *                        normal time specification.
+ *                      - @a TIME_IMMEDIATE this value is not allowed.
+ *                      .
+ * @param[in] slack     the number of ticks the expiration can be postponed
+ *                      beyond @p delay
+ * @param[in] vtfunc    the timer callback function. After invoking the
+ *                      callback the timer is disabled and the structure can
+ *                      be disposed or reused.
+ * @param[in] par       a parameter that will be passed to the callback
+ *                      function
+ *
+ * @iclass
+ */
+static inline void chVTSetWindowI(virtual_timer_t *vtp, sysinterval_t delay,
+                                  sysinterval_t slack, vtfunc_t vtfunc,
+                                  void *par) {
+
+  chVTResetI(vtp);
+  chVTDoSetWindowI(vtp, delay, slack, vtfunc, par);
+}
+
 /**
  * @brief   Virtual timers ticker.
  * @note    The system lock is released before entering the callback and
@@ -367,6 +466,7 @@ static inline void chVTSet(virtual_timer_t *vtp, sysinterval_t delay,
  *
  * @iclass
  */
+#if (CH_CFG_VT_WHEEL == FALSE) || defined(__DOXYGEN__)
 static inline void chVTDoTickI(void) {
 
   chDbgCheckClassI();
@@ -467,6 +567,7 @@ static inline void chVTDoTickI(void) {
               "exceeding delta");
 #endif /* CH_CFG_ST_TIMEDELTA > 0 */
 }
+#endif /* CH_CFG_VT_WHEEL == FALSE */
 
 #endif /* CHVT_H */
 
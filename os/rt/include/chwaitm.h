@@ -0,0 +1,208 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chwaitm.h
+ * @brief   Multiple objects wait macros and structures.
+ *
+ * @addtogroup waitmultiple
+ * @{
+ */
+
+#ifndef CHWAITM_H
+#define CHWAITM_H
+
+#if (CH_CFG_USE_WAIT_MULTIPLE == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Wait modes
+ * @{
+ */
+#define CH_WAIT_ANY         (waitmode_t)0   /**< @brief Wakes on the first
+                                                 ready object.              */
+#define CH_WAIT_ALL         (waitmode_t)1   /**< @brief Wakes when all the
+                                                 objects are ready.         */
+/** @} */
+
+/**
+ * @name    Wait object types
+ * @{
+ */
+#define CH_WAIT_SEMAPHORE   (uint8_t)1      /**< @brief Semaphore with a
+                                                 positive counter.          */
+#define CH_WAIT_MAILBOX     (uint8_t)2      /**< @brief Mailbox with pending
+                                                 messages or reset.         */
+#define CH_WAIT_EVENTS      (uint8_t)3      /**< @brief Pending events of
+                                                 the waiting thread.        */
+/** @} */
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a wait mode.
+ */
+typedef uint8_t waitmode_t;
+
+/**
+ * @brief   Structure representing a multiple wait object.
+ * @details An array of wait objects is passed to @p chWaitMultipleTimeout(),
+ *          while the thread is waiting each object is linked in the list
+ *          of its kernel object.
+ */
+struct ch_wait_object {
+  wait_object_t         *next;      /**< @brief Next in the list.           */
+  wait_object_t         *prev;      /**< @brief Previous in the list.       */
+  thread_t              *thread;    /**< @brief Waiting thread.             */
+  void                  *object;    /**< @brief Semaphore or mailbox
+                                                pointer.                    */
+#if (CH_CFG_USE_EVENTS == TRUE) || defined(__DOXYGEN__)
+  eventmask_t           events;     /**< @brief Events mask for
+                                                @p CH_WAIT_EVENTS.          */
+#endif
+  uint8_t               type;       /**< @brief Object type.                */
+  bool                  ready;      /**< @brief Object ready on return from
+                                                the wait.                   */
+};
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Data part of a static wait objects list initializer.
+ * @details This macro should be used when statically initializing a
+ *          kernel object that can be waited together with other objects.
+ *
+ * @param[in] name      the name of the wait objects list variable
+ */
+#define _WAIT_LIST_DATA(name) {(wait_object_t *)&name, (wait_object_t *)&name}
+
+/**
+ * @brief   Returns the ready state of a wait object.
+ * @note    The state is updated on return from @p chWaitMultipleTimeout().
+ *
+ * @param[in] wop       pointer to a @p wait_object_t structure
+ * @return              The object state.
+ *
+ * @xclass
+ */
+#define chWaitObjectIsReadyX(wop) ((wop)->ready)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  msg_t chWaitMultipleTimeout(wait_object_t *objects, unsigned n,
+                              waitmode_t mode, sysinterval_t timeout);
+  msg_t chWaitMultipleTimeoutS(wait_object_t *objects, unsigned n,
+                               waitmode_t mode, sysinterval_t timeout);
+  void chWaitNotifyI(wait_list_t *wlp);
+  void chWaitNotifyThreadI(thread_t *tp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a wait object on a semaphore.
+ * @details The object is ready when the semaphore counter is positive,
+ *          a following @p chSemWaitTimeout() with @p TIME_IMMEDIATE does
+ *          not fail unless another thread takes the semaphore first.
+ *
+ * @param[out] wop      pointer to a @p wait_object_t structure
+ * @param[in] sp        pointer to a @p semaphore_t structure
+ *
+ * @init
+ */
+static inline void chWaitObjectInitSem(wait_object_t *wop,
+                                       semaphore_t *sp) {
+
+  wop->object = (void *)sp;
+  wop->type   = CH_WAIT_SEMAPHORE;
+  wop->ready  = false;
+}
+#endif
+
+#if (CH_CFG_USE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a wait object on a mailbox.
+ * @details The object is ready when the mailbox contains messages or it
+ *          is in reset state.
+ *
+ * @param[out] wop      pointer to a @p wait_object_t structure
+ * @param[in] mbp       pointer to a @p mailbox_t structure
+ *
+ * @init
+ */
+static inline void chWaitObjectInitMB(wait_object_t *wop,
+                                      mailbox_t *mbp) {
+
+  wop->object = (void *)mbp;
+  wop->type   = CH_WAIT_MAILBOX;
+  wop->ready  = false;
+}
+#endif
+
+#if (CH_CFG_USE_EVENTS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a wait object on the thread events.
+ * @details The object is ready when any of the specified events is
+ *          pending for the waiting thread, events are not cleared.
+ *
+ * @param[out] wop      pointer to a @p wait_object_t structure
+ * @param[in] events    events to be waited for
+ *
+ * @init
+ */
+static inline void chWaitObjectInitEvt(wait_object_t *wop,
+                                       eventmask_t events) {
+
+  wop->object = NULL;
+  wop->events = events;
+  wop->type   = CH_WAIT_EVENTS;
+  wop->ready  = false;
+}
+#endif
+
+#endif /* CH_CFG_USE_WAIT_MULTIPLE == TRUE */
+
+#endif /* CHWAITM_H */
+
+/** @} */
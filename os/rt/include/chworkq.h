@@ -0,0 +1,209 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chworkq.h
+ * @brief   Work queues macros and structures.
+ *
+ * @addtogroup workqueues
+ * @{
+ */
+
+#ifndef CHWORKQ_H
+#define CHWORKQ_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Work queues APIs.
+ * @details If enabled then the work queues APIs are included in the kernel.
+ */
+#if !defined(CH_CFG_USE_WORKQUEUES) || defined(__DOXYGEN__)
+#define CH_CFG_USE_WORKQUEUES               FALSE
+#endif
+
+#if (CH_CFG_USE_WORKQUEUES == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a work function.
+ */
+typedef void (*workfunc_t)(void *p);
+
+/**
+ * @brief   Type of a work queue structure.
+ */
+typedef struct ch_work_queue work_queue_t;
+
+/**
+ * @brief   Type of a work structure.
+ */
+typedef struct ch_work work_t;
+
+/**
+ * @brief   Work structure.
+ * @note    Works are linked into the queue, submitting a work does not
+ *          require any memory allocation or copy.
+ */
+struct ch_work {
+  work_t                *next;      /**< @brief Next work in the queue.     */
+  work_queue_t          *wqp;       /**< @brief Queue the work is pending
+                                                into or @p NULL.            */
+  workfunc_t            func;       /**< @brief Work function.              */
+  void                  *arg;       /**< @brief Work function argument.     */
+};
+
+/**
+ * @brief   Delayed work structure.
+ */
+typedef struct {
+  work_t                work;       /**< @brief Work submitted on timer
+                                                expiration.                 */
+  virtual_timer_t       vt;         /**< @brief Delay timer.                */
+  work_queue_t          *target;    /**< @brief Target queue.               */
+} delayed_work_t;
+
+/**
+ * @brief   Work queue structure.
+ */
+struct ch_work_queue {
+  work_t                *head;      /**< @brief First pending work.         */
+  work_t                *tail;      /**< @brief Last pending work.          */
+  threads_queue_t       workers;    /**< @brief Idle worker threads.        */
+};
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Data part of a static work queue initializer.
+ * @details This macro should be used when statically initializing a work
+ *          queue that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the work queue variable
+ */
+#define _WORK_QUEUE_DATA(name) {NULL, NULL, _THREADS_QUEUE_DATA(name.workers)}
+
+/**
+ * @brief   Static work queue initializer.
+ * @details Statically initialized work queues require no explicit
+ *          initialization using @p chWorkQueueObjectInit().
+ *
+ * @param[in] name      the name of the work queue variable
+ */
+#define WORK_QUEUE_DECL(name) work_queue_t name = _WORK_QUEUE_DATA(name)
+
+/**
+ * @brief   Data part of a static work initializer.
+ * @details This macro should be used when statically initializing a work
+ *          that is part of a bigger structure.
+ *
+ * @param[in] func      the work function
+ * @param[in] arg       the work function argument
+ */
+#define _WORK_DATA(func, arg) {NULL, NULL, (func), (arg)}
+
+/**
+ * @brief   Static work initializer.
+ * @details Statically initialized works require no explicit
+ *          initialization using @p chWorkObjectInit().
+ *
+ * @param[in] name      the name of the work variable
+ * @param[in] func      the work function
+ * @param[in] arg       the work function argument
+ */
+#define WORK_DECL(name, func, arg) work_t name = _WORK_DATA(func, arg)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chWorkQueueObjectInit(work_queue_t *wqp);
+  thread_t *chWorkQueueAddWorker(work_queue_t *wqp, void *wsp, size_t size,
+                                 tprio_t prio, const char *name);
+  void chWorkObjectInit(work_t *wp, workfunc_t func, void *arg);
+  bool chWorkSubmitI(work_queue_t *wqp, work_t *wp);
+  bool chWorkSubmit(work_queue_t *wqp, work_t *wp);
+  bool chWorkCancelI(work_t *wp);
+  void chDelayedWorkObjectInit(delayed_work_t *dwp, workfunc_t func, void *arg);
+  void chWorkSubmitDelayedI(work_queue_t *wqp, delayed_work_t *dwp,
+                            sysinterval_t delay);
+  void chWorkSubmitDelayed(work_queue_t *wqp, delayed_work_t *dwp,
+                           sysinterval_t delay);
+  bool chWorkCancelDelayedI(delayed_work_t *dwp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns @p true if the work is pending in a queue.
+ *
+ * @param[in] wp        pointer to a @p work_t structure
+ * @return              The work status.
+ *
+ * @iclass
+ */
+static inline bool chWorkIsPendingI(work_t *wp) {
+
+  chDbgCheckClassI();
+
+  return (bool)(wp->wqp != NULL);
+}
+
+/**
+ * @brief   Returns @p true if the delayed work is armed or pending.
+ *
+ * @param[in] dwp       pointer to a @p delayed_work_t structure
+ * @return              The delayed work status.
+ *
+ * @iclass
+ */
+static inline bool chDelayedWorkIsPendingI(delayed_work_t *dwp) {
+
+  chDbgCheckClassI();
+
+  return (bool)(chVTIsArmedI(&dwp->vt) || (dwp->work.wqp != NULL));
+}
+
+#endif /* CH_CFG_USE_WORKQUEUES == TRUE */
+
+#endif /* CHWORKQ_H */
+
+/** @} */
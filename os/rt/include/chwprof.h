@@ -0,0 +1,141 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chwprof.h
+ * @brief   Wait profiler module macros and structures.
+ *
+ * @addtogroup wait_profiler
+ * @{
+ */
+
+#ifndef CHWPROF_H
+#define CHWPROF_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Debug option, wait profiler.
+ * @details If enabled the time spent by threads in each wait state is
+ *          recorded and aggregated by thread, wait object and state.
+ */
+#if !defined(CH_DBG_WAIT_PROFILE) || defined(__DOXYGEN__)
+#define CH_DBG_WAIT_PROFILE                 FALSE
+#endif
+
+/**
+ * @brief   Number of entries in the wait profiler table.
+ * @note    It must be a power of two.
+ */
+#if !defined(CH_DBG_WAIT_PROFILE_ENTRIES) || defined(__DOXYGEN__)
+#define CH_DBG_WAIT_PROFILE_ENTRIES         32
+#endif
+
+#if (CH_DBG_WAIT_PROFILE == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (CH_DBG_WAIT_PROFILE_ENTRIES < 2) ||                                    \
+    ((CH_DBG_WAIT_PROFILE_ENTRIES & (CH_DBG_WAIT_PROFILE_ENTRIES - 1)) != 0)
+#error "CH_DBG_WAIT_PROFILE_ENTRIES must be a power of two greater than one"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a wait profiler entry.
+ * @details An entry accumulates the waits of a thread on an object in a
+ *          specific state. The object is the one the thread is queued on
+ *          for the @p CH_STATE_SUSPENDED, @p CH_STATE_QUEUED,
+ *          @p CH_STATE_WTSEM, @p CH_STATE_WTMTX and @p CH_STATE_WTCOND
+ *          states, it is @p NULL for the other states.
+ */
+typedef struct {
+  thread_t              *tp;        /**< @brief Waiting thread or @p NULL
+                                                for a free entry.           */
+#if (CH_CFG_USE_REGISTRY == TRUE) || defined(__DOXYGEN__)
+  const char            *name;      /**< @brief Waiting thread name.        */
+#endif
+  void                  *objp;      /**< @brief Wait object or @p NULL.     */
+  tstate_t              state;      /**< @brief Wait state.                 */
+  thread_t              *waker;     /**< @brief Thread performing the last
+                                                wakeup, @p NULL if it was
+                                                an ISR or a timeout.        */
+  ucnt_t                n;          /**< @brief Number of waits.            */
+  ucnt_t                n_timeout;  /**< @brief Number of timeouts.         */
+  rtcnt_t               worst;      /**< @brief Longest wait in cycles.     */
+  rttime_t              cumulative; /**< @brief Cumulative wait time in
+                                                cycles.                     */
+} wait_profile_entry_t;
+
+/**
+ * @brief   Type of the wait profiler table.
+ */
+typedef struct {
+  wait_profile_entry_t  entries[CH_DBG_WAIT_PROFILE_ENTRIES];
+  ucnt_t                n_dropped;  /**< @brief Waits not recorded because
+                                                the table is full.          */
+} wait_profile_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void _wprof_init(void);
+  void _wprof_sleep(thread_t *tp);
+  void _wprof_wakeup(thread_t *tp, bool timeout);
+  void chWaitProfileReset(void);
+  bool chWaitProfileGetEntry(unsigned i, wait_profile_entry_t *wpep);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#else /* CH_DBG_WAIT_PROFILE == FALSE */
+
+/* Stub functions for when the wait profiler is disabled. */
+#define _wprof_init()
+#define _wprof_sleep(tp)
+#define _wprof_wakeup(tp, timeout)
+
+#endif /* CH_DBG_WAIT_PROFILE == FALSE */
+
+#endif /* CHWPROF_H */
+
+/** @} */
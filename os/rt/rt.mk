@@ -21,6 +21,9 @@ endif
 ifneq ($(findstring CH_DBG_STATISTICS TRUE,$(CHCONF)),)
 KERNSRC += $(CHIBIOS)/os/rt/src/chstats.c
 endif
+ifneq ($(findstring CH_DBG_WAIT_PROFILE TRUE,$(CHCONF)),)
+KERNSRC += $(CHIBIOS)/os/rt/src/chwprof.c
+endif
 ifneq ($(findstring CH_CFG_USE_REGISTRY TRUE,$(CHCONF)),)
 KERNSRC += $(CHIBIOS)/os/rt/src/chregistry.c
 endif
@@ -33,15 +36,24 @@ endif
 ifneq ($(findstring CH_CFG_USE_CONDVARS TRUE,$(CHCONF)),)
 KERNSRC += $(CHIBIOS)/os/rt/src/chcond.c
 endif
+ifneq ($(findstring CH_CFG_USE_RWLOCKS TRUE,$(CHCONF)),)
+KERNSRC += $(CHIBIOS)/os/rt/src/chrwlock.c
+endif
 ifneq ($(findstring CH_CFG_USE_EVENTS TRUE,$(CHCONF)),)
 KERNSRC += $(CHIBIOS)/os/rt/src/chevents.c
 endif
 ifneq ($(findstring CH_CFG_USE_MESSAGES TRUE,$(CHCONF)),)
 KERNSRC += $(CHIBIOS)/os/rt/src/chmsg.c
 endif
+ifneq ($(findstring CH_CFG_USE_WORKQUEUES TRUE,$(CHCONF)),)
+KERNSRC += $(CHIBIOS)/os/rt/src/chworkq.c
+endif
 ifneq ($(findstring CH_CFG_USE_DYNAMIC TRUE,$(CHCONF)),)
 KERNSRC += $(CHIBIOS)/os/rt/src/chdynamic.c
 endif
+ifneq ($(findstring CH_CFG_USE_WAIT_MULTIPLE TRUE,$(CHCONF)),)
+KERNSRC += $(CHIBIOS)/os/rt/src/chwaitm.c
+endif
 else
 KERNSRC := $(CHIBIOS)/os/rt/src/chsys.c \
            $(CHIBIOS)/os/rt/src/chdebug.c \
@@ -51,13 +63,17 @@ KERNSRC := $(CHIBIOS)/os/rt/src/chsys.c \
            $(CHIBIOS)/os/rt/src/chthreads.c \
            $(CHIBIOS)/os/rt/src/chtm.c \
            $(CHIBIOS)/os/rt/src/chstats.c \
+           $(CHIBIOS)/os/rt/src/chwprof.c \
            $(CHIBIOS)/os/rt/src/chregistry.c \
            $(CHIBIOS)/os/rt/src/chsem.c \
            $(CHIBIOS)/os/rt/src/chmtx.c \
            $(CHIBIOS)/os/rt/src/chcond.c \
+           $(CHIBIOS)/os/rt/src/chrwlock.c \
            $(CHIBIOS)/os/rt/src/chevents.c \
            $(CHIBIOS)/os/rt/src/chmsg.c \
-           $(CHIBIOS)/os/rt/src/chdynamic.c
+           $(CHIBIOS)/os/rt/src/chworkq.c \
+           $(CHIBIOS)/os/rt/src/chdynamic.c \
+           $(CHIBIOS)/os/rt/src/chwaitm.c
 endif
 
 # Required include directories
@@ -61,6 +61,47 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_CONDVARS_WAIT_MORPHING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Moves the first waiting thread on the mutex queue.
+ * @details The thread is made ready only if the mutex is not owned, else
+ *          it is woken up later by the mutex unlock.
+ *
+ * @param[in] cp        pointer to the @p condition_variable_t structure
+ * @param[in] msg       the release message
+ *
+ * @notapi
+ */
+static void cond_morph(condition_variable_t *cp, msg_t msg) {
+  thread_t *tp = queue_fifo_remove(&cp->queue);
+
+  /* While waiting on the mutex the thread cannot carry the message, a
+     broadcast is recorded in the thread flags.*/
+  if (msg == MSG_RESET) {
+    tp->flags |= CH_FLAG_CONDRESET;
+  }
+  (void) chMtxLockForI(cp->mtxp, tp);
+}
+
+/**
+ * @brief   Returns the release message of a morphed thread.
+ *
+ * @param[in] tp        pointer to the released thread
+ * @return              The release message.
+ *
+ * @notapi
+ */
+static msg_t cond_morph_msg(thread_t *tp) {
+
+  if ((tp->flags & CH_FLAG_CONDRESET) != (tmode_t)0) {
+    tp->flags &= (tmode_t)~CH_FLAG_CONDRESET;
+    return MSG_RESET;
+  }
+
+  return MSG_OK;
+}
+#endif /* CH_CFG_CONDVARS_WAIT_MORPHING == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -77,6 +118,9 @@ void chCondObjectInit(condition_variable_t *cp) {
   chDbgCheck(cp != NULL);
 
   queue_init(&cp->queue);
+#if CH_CFG_CONDVARS_WAIT_MORPHING == TRUE
+  cp->mtxp = NULL;
+#endif
 }
 
 /**
@@ -92,7 +136,12 @@ void chCondSignal(condition_variable_t *cp) {
 
   chSysLock();
   if (queue_notempty(&cp->queue)) {
+#if CH_CFG_CONDVARS_WAIT_MORPHING == TRUE
+    cond_morph(cp, MSG_OK);
+    chSchRescheduleS();
+#else
     chSchWakeupS(queue_fifo_remove(&cp->queue), MSG_OK);
+#endif
   }
   chSysUnlock();
 }
@@ -114,9 +163,13 @@ void chCondSignalI(condition_variable_t *cp) {
   chDbgCheck(cp != NULL);
 
   if (queue_notempty(&cp->queue)) {
+#if CH_CFG_CONDVARS_WAIT_MORPHING == TRUE
+    cond_morph(cp, MSG_OK);
+#else
     thread_t *tp = queue_fifo_remove(&cp->queue);
     tp->u.rdymsg = MSG_OK;
     (void) chSchReadyI(tp);
+#endif
   }
 }
 
@@ -151,12 +204,21 @@ void chCondBroadcastI(condition_variable_t *cp) {
   chDbgCheckClassI();
   chDbgCheck(cp != NULL);
 
+#if CH_CFG_CONDVARS_WAIT_MORPHING == TRUE
+  /* Empties the condition variable queue and moves all the threads on the
+     mutex queue, at most one thread is made ready if the mutex is not
+     owned.*/
+  while (queue_notempty(&cp->queue)) {
+    cond_morph(cp, MSG_RESET);
+  }
+#else
   /* Empties the condition variable queue and inserts all the threads into the
      ready list in FIFO order. The wakeup message is set to @p MSG_RESET in
      order to make a chCondBroadcast() detectable from a chCondSignal().*/
   while (queue_notempty(&cp->queue)) {
     chSchReadyI(queue_fifo_remove(&cp->queue))->u.rdymsg = MSG_RESET;
   }
+#endif
 }
 
 /**
@@ -214,13 +276,25 @@ msg_t chCondWaitS(condition_variable_t *cp) {
   /* Releasing "current" mutex.*/
   chMtxUnlockS(mp);
 
+#if CH_CFG_CONDVARS_WAIT_MORPHING == TRUE
+  chDbgAssert(queue_isempty(&cp->queue) || (cp->mtxp == mp),
+              "different mutex");
+  cp->mtxp = mp;
+#endif
+
   /* Start waiting on the condition variable, on exit the mutex is taken
      again.*/
   ctp->u.wtobjp = cp;
   queue_prio_insert(ctp, &cp->queue);
   chSchGoSleepS(CH_STATE_WTCOND);
+#if CH_CFG_CONDVARS_WAIT_MORPHING == TRUE
+  /* The mutex has already been assigned to this thread on release.*/
+  chDbgAssert(mp->owner == ctp, "not owner");
+  msg = cond_morph_msg(ctp);
+#else
   msg = ctp->u.rdymsg;
   chMtxLockS(mp);
+#endif
 
   return msg;
 }
@@ -303,14 +377,28 @@ msg_t chCondWaitTimeoutS(condition_variable_t *cp, sysinterval_t timeout) {
   /* Releasing "current" mutex.*/
   chMtxUnlockS(mp);
 
+#if CH_CFG_CONDVARS_WAIT_MORPHING == TRUE
+  chDbgAssert(queue_isempty(&cp->queue) || (cp->mtxp == mp),
+              "different mutex");
+  cp->mtxp = mp;
+#endif
+
   /* Start waiting on the condition variable, on exit the mutex is taken
      again.*/
   currp->u.wtobjp = cp;
   queue_prio_insert(currp, &cp->queue);
   msg = chSchGoSleepTimeoutS(CH_STATE_WTCOND, timeout);
+#if CH_CFG_CONDVARS_WAIT_MORPHING == TRUE
+  /* If released then the mutex has already been assigned to this thread,
+     the released threads are no more subject to the timeout.*/
+  if (mp->owner == currp) {
+    msg = cond_morph_msg(currp);
+  }
+#else
   if (msg != MSG_TIMEOUT) {
     chMtxLockS(mp);
   }
+#endif
 
   return msg;
 }
@@ -180,6 +180,160 @@ thread_t *chThdCreateFromMemoryPool(memory_pool_t *mp, const char *name,
 }
 #endif /* CH_CFG_USE_MEMPOOLS == TRUE */
 
+#if (CH_CFG_USE_THREAD_CACHE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a threads cache object.
+ *
+ * @param[out] tcp      pointer to a @p thread_cache_t structure
+ * @param[in] heapp     heap from which allocate the memory or @p NULL for the
+ *                      default heap
+ * @param[in] size      size of the working areas
+ * @param[in] max       maximum number of working areas kept in the cache
+ *
+ * @init
+ */
+void chThdCacheObjectInit(thread_cache_t *tcp, memory_heap_t *heapp,
+                          size_t size, ucnt_t max) {
+
+  chDbgCheck((tcp != NULL) &&
+             (size >= THD_WORKING_AREA_SIZE(0)) &&
+             MEM_IS_ALIGNED(size, PORT_WORKING_AREA_ALIGN));
+
+  tcp->heapp = heapp;
+  tcp->size  = size;
+  tcp->free  = NULL;
+  tcp->cnt   = (ucnt_t)0;
+  tcp->max   = max;
+}
+
+/**
+ * @brief   Creates a new thread using a working area from a threads cache.
+ * @details The working area of a terminated thread is reused if available
+ *          else it is allocated from the cache heap.
+ * @pre     The configuration option @p CH_CFG_USE_THREAD_CACHE must be
+ *          enabled in order to use this function.
+ * @note    Reused working areas are not filled again when
+ *          @p CH_DBG_FILL_THREADS is enabled, the stack usage reported for
+ *          a thread includes the usage of the previous threads that used
+ *          the same working area.
+ * @note    The working area is returned to the cache when the last
+ *          reference to the thread is released.
+ *
+ * @param[in] tcp       pointer to a @p thread_cache_t structure
+ * @param[in] name      thread name
+ * @param[in] prio      the priority level for the new thread
+ * @param[in] pf        the thread function
+ * @param[in] arg       an argument passed to the thread function. It can be
+ *                      @p NULL.
+ * @return              The pointer to the @p thread_t structure allocated for
+ *                      the thread into the working space area.
+ * @retval NULL         if the cache is empty and the memory cannot be
+ *                      allocated.
+ *
+ * @api
+ */
+thread_t *chThdSpawnFromCache(thread_cache_t *tcp, const char *name,
+                              tprio_t prio, tfunc_t pf, void *arg) {
+  thread_t *tp;
+  void *wsp;
+
+  chDbgCheck(tcp != NULL);
+
+  chSysLock();
+  tp = tcp->free;
+  if (tp != NULL) {
+    tcp->free = tp->queue.next;
+    tcp->cnt--;
+    chSysUnlock();
+    wsp = (void *)chThdGetWorkingAreaX(tp);
+  }
+  else {
+    chSysUnlock();
+    wsp = chHeapAllocAligned(tcp->heapp, tcp->size, PORT_WORKING_AREA_ALIGN);
+    if (wsp == NULL) {
+      return NULL;
+    }
+
+#if CH_DBG_FILL_THREADS == TRUE
+    _thread_memfill((uint8_t *)wsp,
+                    (uint8_t *)wsp + tcp->size,
+                    CH_DBG_STACK_FILL_VALUE);
+#endif
+  }
+
+  thread_descriptor_t td = {
+    name,
+    wsp,
+    (stkalign_t *)((uint8_t *)wsp + tcp->size),
+    prio,
+    pf,
+    arg
+  };
+
+  chSysLock();
+  tp = chThdCreateSuspendedI(&td);
+  tp->flags = CH_FLAG_MODE_CACHE;
+  tp->cache = tcp;
+  chSchWakeupS(tp, MSG_OK);
+  chSysUnlock();
+
+  return tp;
+}
+
+/**
+ * @brief   Returns all the cached working areas to the heap.
+ *
+ * @param[in] tcp       pointer to a @p thread_cache_t structure
+ *
+ * @api
+ */
+void chThdCacheFlush(thread_cache_t *tcp) {
+
+  chDbgCheck(tcp != NULL);
+
+  while (true) {
+    thread_t *tp;
+
+    chSysLock();
+    tp = tcp->free;
+    if (tp == NULL) {
+      chSysUnlock();
+      return;
+    }
+    tcp->free = tp->queue.next;
+    tcp->cnt--;
+    chSysUnlock();
+
+    chHeapFree(chThdGetWorkingAreaX(tp));
+  }
+}
+
+/**
+ * @brief   Returns the working area of a released thread to its cache.
+ * @details If the cache is full then the working area is returned to the
+ *          heap.
+ *
+ * @param[in] tp        pointer to the released thread
+ *
+ * @notapi
+ */
+void _thread_cache_free(thread_t *tp) {
+  thread_cache_t *tcp = tp->cache;
+
+  chSysLock();
+  if (tcp->cnt < tcp->max) {
+    tp->queue.next = tcp->free;
+    tcp->free = tp;
+    tcp->cnt++;
+    chSysUnlock();
+    return;
+  }
+  chSysUnlock();
+
+  chHeapFree(chThdGetWorkingAreaX(tp));
+}
+#endif /* CH_CFG_USE_THREAD_CACHE == TRUE */
+
 #endif /* CH_CFG_USE_DYNAMIC == TRUE */
 
 /** @} */
@@ -65,6 +65,27 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+/**
+ * @brief   Identifier of the lowest event in a non-empty events mask.
+ * @note    The port layer can provide an optimized @p port_ctz() macro.
+ */
+#if defined(port_ctz) || defined(__DOXYGEN__)
+#define evt_lowest_id(m)            ((eventid_t)port_ctz(m))
+#elif defined(__GNUC__)
+#define evt_lowest_id(m)            ((eventid_t)__builtin_ctz((unsigned)(m)))
+#else
+static inline eventid_t evt_lowest_id(eventmask_t m) {
+  eventid_t eid = (eventid_t)0;
+
+  while ((m & (eventmask_t)1) == (eventmask_t)0) {
+    m >>= 1;
+    eid++;
+  }
+
+  return eid;
+}
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -108,8 +129,24 @@ void chEvtRegisterMaskWithFlags(event_source_t *esp,
   chDbgCheck((esp != NULL) && (elp != NULL));
 
   chSysLock();
+#if CH_CFG_EVENTS_PRIORITY_ORDER == TRUE
+  {
+    /*lint -save -e9087 -e740 [11.3, 1.3] Cast required by list handling.*/
+    event_listener_t *p = (event_listener_t *)esp;
+
+    /* Inserted after the listeners with the same or higher priority.*/
+    while ((p->next != (event_listener_t *)esp) &&
+           (p->next->listener->prio >= currp->prio)) {
+      p = p->next;
+    }
+    /*lint -restore*/
+    elp->next = p->next;
+    p->next   = elp;
+  }
+#else
   elp->next     = esp->next;
   esp->next     = elp;
+#endif
   elp->listener = currp;
   elp->events   = events;
   elp->flags    = (eventflags_t)0;
@@ -309,6 +346,11 @@ void chEvtSignalI(thread_t *tp, eventmask_t events) {
     tp->u.rdymsg = MSG_OK;
     (void) chSchReadyI(tp);
   }
+#if CH_CFG_USE_WAIT_MULTIPLE == TRUE
+  else if (tp->state == CH_STATE_WTMULTI) {
+    chWaitNotifyThreadI(tp);
+  }
+#endif
 }
 
 /**
@@ -366,14 +408,12 @@ void chEvtDispatch(const evhandler_t *handlers, eventmask_t events) {
 
   chDbgCheck(handlers != NULL);
 
-  eid = (eventid_t)0;
+  /* Only the set bits are visited, lowest identifiers first.*/
   while (events != (eventmask_t)0) {
-    if ((events & EVENT_MASK(eid)) != (eventmask_t)0) {
-      chDbgAssert(handlers[eid] != NULL, "null handler");
-      events &= ~EVENT_MASK(eid);
-      handlers[eid](eid);
-    }
-    eid++;
+    eid = evt_lowest_id(events);
+    chDbgAssert(handlers[eid] != NULL, "null handler");
+    events &= events - (eventmask_t)1;
+    handlers[eid](eid);
   }
 }
 
@@ -102,6 +102,83 @@ msg_t chMsgSend(thread_t *tp, msg_t msg) {
   return msg;
 }
 
+/**
+ * @brief   Sends a message to the specified thread with timeout.
+ * @details The sender is stopped until the receiver executes a
+ *          @p chMsgRelease() after receiving the message.
+ * @note    The timeout only applies while the message is queued, once the
+ *          receiver has taken the message the sender waits for the release
+ *          regardless of the timeout.
+ *
+ * @param[in] tp        the pointer to the thread
+ * @param[in] msg       the message
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The answer message from @p chMsgRelease().
+ * @retval MSG_TIMEOUT  if the message has not been taken by the receiver
+ *                      within the specified timeout.
+ *
+ * @api
+ */
+msg_t chMsgSendTimeout(thread_t *tp, msg_t msg, sysinterval_t timeout) {
+  thread_t *ctp = currp;
+
+  chDbgCheck(tp != NULL);
+
+  /* The receiver cannot take the message before this thread sleeps.*/
+  if (timeout == TIME_IMMEDIATE) {
+    return MSG_TIMEOUT;
+  }
+
+  chSysLock();
+  ctp->u.sentmsg = msg;
+  msg_insert(ctp, &tp->msgqueue);
+  if (tp->state == CH_STATE_WTMSG) {
+    (void) chSchReadyI(tp);
+  }
+  msg = chSchGoSleepTimeoutS(CH_STATE_SNDMSGQ, timeout);
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Sends a payload to the specified thread with timeout.
+ * @details The payload is not copied, the receiver accesses the sender
+ *          buffer in place using @p chMsgGetPayload(), the buffer is
+ *          stable until the message is released.
+ *
+ * @param[in] tp        the pointer to the thread
+ * @param[in] buf       pointer to the payload buffer
+ * @param[in] size      size of the payload buffer
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The answer message from @p chMsgRelease().
+ * @retval MSG_TIMEOUT  if the message has not been taken by the receiver
+ *                      within the specified timeout.
+ *
+ * @api
+ */
+msg_t chMsgSendPayloadTimeout(thread_t *tp, const void *buf, size_t size,
+                              sysinterval_t timeout) {
+  msg_payload_t payload;
+
+  chDbgCheck((buf != NULL) || (size == (size_t)0));
+
+  /* The descriptor is on the stack of the sender, it is valid until the
+     message is released.*/
+  payload.buf  = buf;
+  payload.size = size;
+
+  return chMsgSendTimeout(tp, (msg_t)&payload, timeout);
+}
+
 /**
  * @brief   Suspends the thread and waits for an incoming message.
  * @post    After receiving a message the function @p chMsgGet() must be
@@ -132,6 +209,50 @@ thread_t *chMsgWait(void) {
   return tp;
 }
 
+/**
+ * @brief   Suspends the thread and waits for an incoming message with
+ *          timeout.
+ * @post    After receiving a message the function @p chMsgGet() must be
+ *          called in order to retrieve the message and then @p chMsgRelease()
+ *          must be invoked in order to acknowledge the reception and send
+ *          the answer.
+ * @note    The reference counter of the sender thread is not increased, the
+ *          returned pointer is a temporary reference.
+ *
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              A pointer to the thread carrying the message.
+ * @retval NULL         if a message has not been received within the
+ *                      specified timeout.
+ *
+ * @api
+ */
+thread_t *chMsgWaitTimeout(sysinterval_t timeout) {
+  thread_t *tp;
+
+  chSysLock();
+  if (!chMsgIsPendingI(currp)) {
+    if (timeout != TIME_IMMEDIATE) {
+      (void) chSchGoSleepTimeoutS(CH_STATE_WTMSG, timeout);
+    }
+
+    /* The queue is checked again because a sender could have been queued
+       after the timeout.*/
+    if (!chMsgIsPendingI(currp)) {
+      chSysUnlock();
+      return NULL;
+    }
+  }
+  tp = queue_fifo_remove(&currp->msgqueue);
+  tp->state = CH_STATE_SNDMSG;
+  chSysUnlock();
+
+  return tp;
+}
+
 /**
  * @brief   Releases a sender thread specifying a response message.
  * @pre     Invoke this function only after a message has been received
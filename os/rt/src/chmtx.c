@@ -89,6 +89,151 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Assigns a mutex to a thread.
+ * @details The mutex is inserted in the per-thread stack of owned mutexes,
+ *          if the mutex has a ceiling priority then the thread priority is
+ *          raised immediately to the ceiling.
+ *
+ * @param[in] mp        pointer to the @p mutex_t structure
+ * @param[in] tp        pointer to the new owner thread
+ *
+ * @notapi
+ */
+static void mtx_assign(mutex_t *mp, thread_t *tp) {
+
+  mp->owner = tp;
+  mp->next = tp->mtxlist;
+  tp->mtxlist = mp;
+#if CH_CFG_USE_MUTEXES_CEILING == TRUE
+  if (mp->ceiling > tp->prio) {
+    tp->prio = mp->ceiling;
+  }
+#endif
+}
+
+/**
+ * @brief   Calculates the priority of a thread owning mutexes.
+ * @details The priority is the highest among the thread base priority, the
+ *          priority of the threads waiting on the owned mutexes and the
+ *          ceiling priority of the owned mutexes.
+ *
+ * @param[in] tp        pointer to the owner thread
+ * @return              The calculated priority.
+ *
+ * @notapi
+ */
+static tprio_t mtx_owner_prio(thread_t *tp) {
+  tprio_t newprio = tp->realprio;
+  mutex_t *lmp = tp->mtxlist;
+
+  while (lmp != NULL) {
+    /* If the highest priority thread waiting in the mutexes list has a
+       greater priority than the current thread base priority then the
+       final priority will have at least that priority.*/
+    if (chMtxQueueNotEmptyS(lmp) &&
+        (lmp->queue.next->prio > newprio)) {
+      newprio = lmp->queue.next->prio;
+    }
+#if CH_CFG_USE_MUTEXES_CEILING == TRUE
+    if (lmp->ceiling > newprio) {
+      newprio = lmp->ceiling;
+    }
+#endif
+    lmp = lmp->next;
+  }
+
+  return newprio;
+}
+
+/**
+ * @brief   Priority inheritance protocol.
+ * @details Explores the thread-mutex dependencies boosting the priority of
+ *          all the affected threads to equal the priority of the thread
+ *          requesting the mutex.
+ *
+ * @param[in] tp        pointer to the mutex owner thread
+ * @param[in] prio      priority of the thread requesting the mutex
+ *
+ * @notapi
+ */
+static void mtx_inherit(thread_t *tp, tprio_t prio) {
+
+  /* Does the requesting thread have higher priority than the mutex
+     owning thread? */
+  while (tp->prio < prio) {
+    /* Make priority of thread tp match the requesting thread's priority.*/
+    tp->prio = prio;
+
+    /* The following states need priority queues reordering.*/
+    switch (tp->state) {
+    case CH_STATE_WTMTX:
+      /* Re-enqueues the mutex owner with its new priority.*/
+      queue_prio_insert(queue_dequeue(tp), &tp->u.wtmtxp->queue);
+      tp = tp->u.wtmtxp->owner;
+      /*lint -e{9042} [16.1] Continues the while.*/
+      continue;
+#if (CH_CFG_USE_CONDVARS == TRUE) ||                                        \
+    ((CH_CFG_USE_SEMAPHORES == TRUE) &&                                     \
+     (CH_CFG_USE_SEMAPHORES_PRIORITY == TRUE)) ||                           \
+    ((CH_CFG_USE_MESSAGES == TRUE) &&                                       \
+     (CH_CFG_USE_MESSAGES_PRIORITY == TRUE))
+#if CH_CFG_USE_CONDVARS == TRUE
+    case CH_STATE_WTCOND:
+#endif
+#if (CH_CFG_USE_SEMAPHORES == TRUE) &&                                      \
+    (CH_CFG_USE_SEMAPHORES_PRIORITY == TRUE)
+    case CH_STATE_WTSEM:
+#endif
+#if (CH_CFG_USE_MESSAGES == TRUE) && (CH_CFG_USE_MESSAGES_PRIORITY == TRUE)
+    case CH_STATE_SNDMSGQ:
+#endif
+      /* Re-enqueues tp with its new priority on the queue.*/
+      queue_prio_insert(queue_dequeue(tp), &tp->u.wtmtxp->queue);
+      break;
+#endif
+    case CH_STATE_READY:
+      /* Re-enqueues tp with its new priority on the ready list.*/
+      (void) chSchRequeueReadyI(tp);
+      break;
+    default:
+      /* Nothing to do for other states.*/
+      break;
+    }
+    break;
+  }
+}
+
+#if (CH_CFG_MUTEXES_SPIN_COUNT > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Adaptive wait on a mutex.
+ * @details The invoking thread yields while the mutex owner is a ready
+ *          thread at its same priority, up to @p CH_CFG_MUTEXES_SPIN_COUNT
+ *          times, the owner is given the chance to release the mutex
+ *          without the cost of a sleep and a wakeup.
+ *
+ * @param[in] mp        pointer to the @p mutex_t structure
+ * @param[in] ctp       pointer to the invoking thread
+ * @return              The mutex status after spinning.
+ * @retval true         if the mutex has been released.
+ * @retval false        if the mutex is still owned.
+ *
+ * @notapi
+ */
+static bool mtx_spin(mutex_t *mp, thread_t *ctp) {
+  cnt_t n = (cnt_t)CH_CFG_MUTEXES_SPIN_COUNT;
+
+  while ((n > (cnt_t)0) && (mp->owner != NULL) &&
+         (mp->owner->state == CH_STATE_READY) &&
+         (mp->owner->prio == ctp->prio)) {
+    chSchDoYieldS();
+    n--;
+  }
+
+  return (bool)(mp->owner == NULL);
+}
+#endif /* CH_CFG_MUTEXES_SPIN_COUNT > 0 */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -109,7 +254,37 @@ void chMtxObjectInit(mutex_t *mp) {
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
   mp->cnt = (cnt_t)0;
 #endif
+#if CH_CFG_USE_MUTEXES_CEILING == TRUE
+  mp->ceiling = (tprio_t)0;
+#endif
+#if CH_DBG_STATISTICS == TRUE
+  mp->n_contended = (ucnt_t)0;
+  mp->n_spinacq = (ucnt_t)0;
+#endif
+}
+
+#if (CH_CFG_USE_MUTEXES_CEILING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes s @p mutex_t structure with a ceiling priority.
+ * @details The mutex uses the immediate priority ceiling protocol, the
+ *          owner priority is raised to the ceiling as soon as the mutex
+ *          is acquired so the priority inheritance is not required.
+ * @note    The ceiling must be greater or equal than the priority of all
+ *          the threads locking the mutex.
+ *
+ * @param[out] mp       pointer to a @p mutex_t structure
+ * @param[in] prio      the ceiling priority
+ *
+ * @init
+ */
+void chMtxObjectInitCeiling(mutex_t *mp, tprio_t prio) {
+
+  chDbgCheck(prio <= HIGHPRIO);
+
+  chMtxObjectInit(mp);
+  mp->ceiling = prio;
 }
+#endif /* CH_CFG_USE_MUTEXES_CEILING == TRUE */
 
 /**
  * @brief   Locks the specified mutex.
@@ -141,6 +316,10 @@ void chMtxLockS(mutex_t *mp) {
 
   chDbgCheckClassS();
   chDbgCheck(mp != NULL);
+#if CH_CFG_USE_MUTEXES_CEILING == TRUE
+  chDbgAssert((mp->ceiling == (tprio_t)0) || (ctp->realprio <= mp->ceiling),
+              "ceiling violation");
+#endif
 
   /* Is the mutex already locked? */
   if (mp->owner != NULL) {
@@ -155,58 +334,27 @@ void chMtxLockS(mutex_t *mp) {
     }
     else {
 #endif
-      /* Priority inheritance protocol; explores the thread-mutex dependencies
-         boosting the priority of all the affected threads to equal the
-         priority of the running thread requesting the mutex.*/
-      thread_t *tp = mp->owner;
-
-      /* Does the running thread have higher priority than the mutex
-         owning thread? */
-      while (tp->prio < ctp->prio) {
-        /* Make priority of thread tp match the running thread's priority.*/
-        tp->prio = ctp->prio;
-
-        /* The following states need priority queues reordering.*/
-        switch (tp->state) {
-        case CH_STATE_WTMTX:
-          /* Re-enqueues the mutex owner with its new priority.*/
-          queue_prio_insert(queue_dequeue(tp), &tp->u.wtmtxp->queue);
-          tp = tp->u.wtmtxp->owner;
-          /*lint -e{9042} [16.1] Continues the while.*/
-          continue;
-#if (CH_CFG_USE_CONDVARS == TRUE) ||                                        \
-    ((CH_CFG_USE_SEMAPHORES == TRUE) &&                                     \
-     (CH_CFG_USE_SEMAPHORES_PRIORITY == TRUE)) ||                           \
-    ((CH_CFG_USE_MESSAGES == TRUE) &&                                       \
-     (CH_CFG_USE_MESSAGES_PRIORITY == TRUE))
-#if CH_CFG_USE_CONDVARS == TRUE
-        case CH_STATE_WTCOND:
+#if CH_DBG_STATISTICS == TRUE
+      mp->n_contended++;
 #endif
-#if (CH_CFG_USE_SEMAPHORES == TRUE) &&                                      \
-    (CH_CFG_USE_SEMAPHORES_PRIORITY == TRUE)
-        case CH_STATE_WTSEM:
+#if CH_CFG_MUTEXES_SPIN_COUNT > 0
+      /* Adaptive behavior, yielding to the owner before sleeping.*/
+      if (mtx_spin(mp, ctp)) {
+#if CH_DBG_STATISTICS == TRUE
+        mp->n_spinacq++;
 #endif
-#if (CH_CFG_USE_MESSAGES == TRUE) && (CH_CFG_USE_MESSAGES_PRIORITY == TRUE)
-        case CH_STATE_SNDMSGQ:
-#endif
-          /* Re-enqueues tp with its new priority on the queue.*/
-          queue_prio_insert(queue_dequeue(tp), &tp->u.wtmtxp->queue);
-          break;
-#endif
-        case CH_STATE_READY:
-#if CH_DBG_ENABLE_ASSERTS == TRUE
-          /* Prevents an assertion in chSchReadyI().*/
-          tp->state = CH_STATE_CURRENT;
-#endif
-          /* Re-enqueues tp with its new priority on the ready list.*/
-          (void) chSchReadyI(queue_dequeue(tp));
-          break;
-        default:
-          /* Nothing to do for other states.*/
-          break;
-        }
-        break;
+#if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
+        chDbgAssert(mp->cnt == (cnt_t)0, "counter is not zero");
+
+        mp->cnt++;
+#endif
+        mtx_assign(mp, ctp);
+        return;
       }
+#endif
+      /* Priority inheritance protocol, the owner and the threads it
+         depends on are boosted to the priority of the running thread.*/
+      mtx_inherit(mp->owner, ctp->prio);
 
       /* Sleep on the mutex.*/
       queue_prio_insert(ctp, &mp->queue);
@@ -229,9 +377,7 @@ void chMtxLockS(mutex_t *mp) {
     mp->cnt++;
 #endif
     /* It was not owned, inserted in the owned mutexes list.*/
-    mp->owner = ctp;
-    mp->next = ctp->mtxlist;
-    ctp->mtxlist = mp;
+    mtx_assign(mp, ctp);
   }
 }
 
@@ -283,6 +429,10 @@ bool chMtxTryLockS(mutex_t *mp) {
 
   chDbgCheckClassS();
   chDbgCheck(mp != NULL);
+#if CH_CFG_USE_MUTEXES_CEILING == TRUE
+  chDbgAssert((mp->ceiling == (tprio_t)0) || (currp->realprio <= mp->ceiling),
+              "ceiling violation");
+#endif
 
   if (mp->owner != NULL) {
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
@@ -294,6 +444,58 @@ bool chMtxTryLockS(mutex_t *mp) {
       return true;
     }
 #endif
+#if CH_DBG_STATISTICS == TRUE
+    mp->n_contended++;
+#endif
+    return false;
+  }
+#if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
+
+  chDbgAssert(mp->cnt == (cnt_t)0, "counter is not zero");
+
+  mp->cnt++;
+#endif
+  mtx_assign(mp, currp);
+  return true;
+}
+
+/**
+ * @brief   Locks the specified mutex on behalf of a sleeping thread.
+ * @details If the mutex is not owned then it is assigned to the thread and
+ *          the thread is made ready, else the thread is enqueued on the
+ *          mutex as if it invoked @p chMtxLockS(), the priority inheritance
+ *          protocol is applied to the owner.
+ * @pre     The thread must be sleeping and not be part of any queue.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel.
+ * @note    This function is used by condition variables in order to move
+ *          the released threads directly on the mutex queue.
+ *
+ * @param[in] mp        pointer to the @p mutex_t structure
+ * @param[in] tp        pointer to the sleeping thread
+ * @return              The operation status.
+ * @retval true         if the mutex has been assigned and the thread made
+ *                      ready.
+ * @retval false        if the thread has been enqueued on the mutex.
+ *
+ * @iclass
+ */
+bool chMtxLockForI(mutex_t *mp, thread_t *tp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((mp != NULL) && (tp != NULL));
+  chDbgAssert(mp->owner != tp, "already owned");
+
+  if (mp->owner != NULL) {
+#if CH_DBG_STATISTICS == TRUE
+    mp->n_contended++;
+#endif
+    mtx_inherit(mp->owner, tp->prio);
+
+    tp->state = CH_STATE_WTMTX;
+    tp->u.wtmtxp = mp;
+    queue_prio_insert(tp, &mp->queue);
+
     return false;
   }
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
@@ -302,9 +504,9 @@ bool chMtxTryLockS(mutex_t *mp) {
 
   mp->cnt++;
 #endif
-  mp->owner = currp;
-  mp->next = currp->mtxlist;
-  currp->mtxlist = mp;
+  mtx_assign(mp, tp);
+  (void) chSchReadyI(tp);
+
   return true;
 }
 
@@ -322,7 +524,6 @@ bool chMtxTryLockS(mutex_t *mp) {
  */
 void chMtxUnlock(mutex_t *mp) {
   thread_t *ctp = currp;
-  mutex_t *lmp;
 
   chDbgCheck(mp != NULL);
 
@@ -347,24 +548,9 @@ void chMtxUnlock(mutex_t *mp) {
     if (chMtxQueueNotEmptyS(mp)) {
       thread_t *tp;
 
-      /* Recalculates the optimal thread priority by scanning the owned
-         mutexes list.*/
-      tprio_t newprio = ctp->realprio;
-      lmp = ctp->mtxlist;
-      while (lmp != NULL) {
-        /* If the highest priority thread waiting in the mutexes list has a
-           greater priority than the current thread base priority then the
-           final priority will have at least that priority.*/
-        if (chMtxQueueNotEmptyS(lmp) &&
-            (lmp->queue.next->prio > newprio)) {
-          newprio = lmp->queue.next->prio;
-        }
-        lmp = lmp->next;
-      }
-
       /* Assigns to the current thread the highest priority among all the
-         waiting threads.*/
-      ctp->prio = newprio;
+         waiting threads by scanning the owned mutexes list.*/
+      ctp->prio = mtx_owner_prio(ctp);
 
       /* Awakens the highest priority thread waiting for the unlocked mutex and
          assigns the mutex to it.*/
@@ -372,9 +558,7 @@ void chMtxUnlock(mutex_t *mp) {
       mp->cnt = (cnt_t)1;
 #endif
       tp = queue_fifo_remove(&mp->queue);
-      mp->owner = tp;
-      mp->next = tp->mtxlist;
-      tp->mtxlist = mp;
+      mtx_assign(mp, tp);
 
       /* Note, not using chSchWakeupS() becuase that function expects the
          current thread to have the higher or equal priority than the ones
@@ -385,6 +569,13 @@ void chMtxUnlock(mutex_t *mp) {
     }
     else {
       mp->owner = NULL;
+#if CH_CFG_USE_MUTEXES_CEILING == TRUE
+      /* Leaving the ceiling priority.*/
+      if (mp->ceiling > (tprio_t)0) {
+        ctp->prio = mtx_owner_prio(ctp);
+        chSchRescheduleS();
+      }
+#endif
     }
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
   }
@@ -409,7 +600,6 @@ void chMtxUnlock(mutex_t *mp) {
  */
 void chMtxUnlockS(mutex_t *mp) {
   thread_t *ctp = currp;
-  mutex_t *lmp;
 
   chDbgCheckClassS();
   chDbgCheck(mp != NULL);
@@ -433,24 +623,9 @@ void chMtxUnlockS(mutex_t *mp) {
     if (chMtxQueueNotEmptyS(mp)) {
       thread_t *tp;
 
-      /* Recalculates the optimal thread priority by scanning the owned
-         mutexes list.*/
-      tprio_t newprio = ctp->realprio;
-      lmp = ctp->mtxlist;
-      while (lmp != NULL) {
-        /* If the highest priority thread waiting in the mutexes list has a
-           greater priority than the current thread base priority then the
-           final priority will have at least that priority.*/
-        if (chMtxQueueNotEmptyS(lmp) &&
-            (lmp->queue.next->prio > newprio)) {
-          newprio = lmp->queue.next->prio;
-        }
-        lmp = lmp->next;
-      }
-
       /* Assigns to the current thread the highest priority among all the
-         waiting threads.*/
-      ctp->prio = newprio;
+         waiting threads by scanning the owned mutexes list.*/
+      ctp->prio = mtx_owner_prio(ctp);
 
       /* Awakens the highest priority thread waiting for the unlocked mutex and
          assigns the mutex to it.*/
@@ -458,13 +633,17 @@ void chMtxUnlockS(mutex_t *mp) {
       mp->cnt = (cnt_t)1;
 #endif
       tp = queue_fifo_remove(&mp->queue);
-      mp->owner = tp;
-      mp->next = tp->mtxlist;
-      tp->mtxlist = mp;
+      mtx_assign(mp, tp);
       (void) chSchReadyI(tp);
     }
     else {
       mp->owner = NULL;
+#if CH_CFG_USE_MUTEXES_CEILING == TRUE
+      /* Leaving the ceiling priority.*/
+      if (mp->ceiling > (tprio_t)0) {
+        ctp->prio = mtx_owner_prio(ctp);
+      }
+#endif
     }
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
   }
@@ -495,9 +674,7 @@ void chMtxUnlockAllS(void) {
       mp->cnt = (cnt_t)1;
 #endif
       thread_t *tp = queue_fifo_remove(&mp->queue);
-      mp->owner = tp;
-      mp->next = tp->mtxlist;
-      tp->mtxlist = mp;
+      mtx_assign(mp, tp);
       (void) chSchReadyI(tp);
     }
     else {
@@ -534,9 +711,7 @@ void chMtxUnlockAll(void) {
         mp->cnt = (cnt_t)1;
 #endif
         thread_t *tp = queue_fifo_remove(&mp->queue);
-        mp->owner = tp;
-        mp->next = tp->mtxlist;
-        tp->mtxlist = mp;
+        mtx_assign(mp, tp);
         (void) chSchReadyI(tp);
       }
       else {
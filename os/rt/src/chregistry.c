@@ -51,6 +51,29 @@
 
 #if (CH_CFG_USE_REGISTRY == TRUE) || defined(__DOXYGEN__)
 
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of stack words scanned within a single critical zone.
+ */
+#define REG_STACK_SCAN_CHUNK                32U
+
+#if (CH_CFG_REGISTRY_INDEX_SIZE > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Registry index bucket of a hash.
+ */
+#define REG_BUCKET(hash)                                                    \
+  ((hash) & ((uint32_t)CH_CFG_REGISTRY_INDEX_SIZE - 1U))
+
+/**
+ * @brief   Hash of a thread pointer.
+ */
+#define REG_PTR_HASH(tp)                                                    \
+  ((uint32_t)(((uint32_t)(uintptr_t)(tp) >> 3) * 0x9E3779B1U) >> 16)
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -73,6 +96,119 @@
   ((size_t)((char *)&((st *)0)->m - (char *)0))                             \
   /*lint -restore*/
 
+#if (CH_DBG_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Percentage of a window.
+ *
+ * @param[in] t         the accounted time
+ * @param[in] window    the window length
+ * @return              The percentage of @p t over @p window.
+ */
+static uint8_t reg_load_percent(rttime_t t, rttime_t window) {
+
+  if (window == (rttime_t)0) {
+    return (uint8_t)0;
+  }
+
+  return (uint8_t)((t * (rttime_t)100) / window);
+}
+#endif /* CH_DBG_STATISTICS == TRUE */
+
+#if ((CH_DBG_FILL_THREADS == TRUE) &&                                       \
+     ((CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE))) || \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Returns the never used stack space of a snapshot thread.
+ * @details Same scan of @p chThdGetStackFreeX() split in critical zones
+ *          of @p REG_STACK_SCAN_CHUNK words. The registry generation is
+ *          checked in each zone, while it is unchanged the thread is still
+ *          in the registry and its working area cannot have been released.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] seq       registry generation of the snapshot
+ * @return              The number of never used bytes.
+ * @retval 0            if the registry changed during the scan.
+ */
+static size_t reg_stack_free(thread_t *tp, ucnt_t seq) {
+  const size_t pattern = ((size_t)-1 / (size_t)0xFFU) *
+                         (size_t)CH_DBG_STACK_FILL_VALUE;
+  const uint8_t *basep, *bp, *endp;
+  bool done = false;
+  size_t n;
+
+  chSysLock();
+  if ((ch.rlist.regseq != seq) || (tp->wabase == NULL)) {
+    chSysUnlock();
+    return (size_t)0;
+  }
+  basep = (const uint8_t *)tp->wabase;
+  endp  = (const uint8_t *)tp;
+  if (endp <= basep) {
+    endp = NULL;
+  }
+  chSysUnlock();
+
+  bp = basep;
+  while (!done) {
+    chSysLock();
+    if (ch.rlist.regseq != seq) {
+      chSysUnlock();
+      return (size_t)0;
+    }
+    for (n = (size_t)0; n < (size_t)REG_STACK_SCAN_CHUNK; n++) {
+      if (((endp != NULL) && ((bp + sizeof (size_t)) > endp)) ||
+          (*(const size_t *)bp != pattern)) {
+        /* Byte scan of the partially used word.*/
+        while (((endp == NULL) || (bp < endp)) &&
+               (*bp == (uint8_t)CH_DBG_STACK_FILL_VALUE)) {
+          bp++;
+        }
+        done = true;
+        break;
+      }
+      bp += sizeof (size_t);
+    }
+    chSysUnlock();
+  }
+
+  return (size_t)(bp - basep);
+}
+#endif /* CH_DBG_FILL_THREADS == TRUE */
+
+#if (CH_CFG_REGISTRY_INDEX_SIZE > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Adds a thread at the end of a names index bucket.
+ * @note    Threads are appended so that, as for a full registry scan, the
+ *          oldest thread is found first among threads with the same name.
+ *
+ * @param[in] tp        pointer to the thread
+ */
+static void reg_names_insert(thread_t *tp) {
+  thread_t **tpp = &ch.regnames[REG_BUCKET(tp->nhash)];
+
+  while (*tpp != NULL) {
+    tpp = &(*tpp)->nnext;
+  }
+  tp->nnext = NULL;
+  *tpp = tp;
+}
+
+/**
+ * @brief   Removes a thread from its names index bucket.
+ *
+ * @param[in] tp        pointer to the thread
+ */
+static void reg_names_remove(thread_t *tp) {
+  thread_t **tpp = &ch.regnames[REG_BUCKET(tp->nhash)];
+
+  while (*tpp != tp) {
+    chDbgAssert(*tpp != NULL, "not in index");
+    tpp = &(*tpp)->nnext;
+  }
+  *tpp = tp->nnext;
+}
+#endif /* CH_CFG_REGISTRY_INDEX_SIZE > 0 */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -184,6 +320,9 @@ thread_t *chRegNextThread(thread_t *tp) {
  * @note    The reference counter of the found thread is increased by one so
  *          it cannot be disposed incidentally after the pointer has been
  *          returned.
+ * @note    If @p CH_CFG_REGISTRY_INDEX_SIZE is non-zero then the name is
+ *          hashed outside the critical zone and only the threads in the
+ *          same index bucket are compared.
  *
  * @param[in] name      the thread name
  * @return              A pointer to the found thread.
@@ -193,6 +332,26 @@ thread_t *chRegNextThread(thread_t *tp) {
  */
 thread_t *chRegFindThreadByName(const char *name) {
   thread_t *ctp;
+#if CH_CFG_REGISTRY_INDEX_SIZE > 0
+  uint32_t hash = _reg_hash_name(name);
+
+  chSysLock();
+  ctp = ch.regnames[REG_BUCKET(hash)];
+  while (ctp != NULL) {
+    if ((ctp->nhash == hash) && (ctp->name != NULL) &&
+        (strcmp(ctp->name, name) == 0)) {
+#if CH_CFG_USE_DYNAMIC == TRUE
+      chDbgAssert(ctp->refs < (trefs_t)255, "too many references");
+      ctp->refs++;
+#endif
+      break;
+    }
+    ctp = ctp->nnext;
+  }
+  chSysUnlock();
+
+  return ctp;
+#else
 
   /* Scanning registry.*/
   ctp = chRegFirstThread();
@@ -204,6 +363,7 @@ thread_t *chRegFindThreadByName(const char *name) {
   } while (ctp != NULL);
 
   return NULL;
+#endif
 }
 
 /**
@@ -220,6 +380,26 @@ thread_t *chRegFindThreadByName(const char *name) {
  */
 thread_t *chRegFindThreadByPointer(thread_t *tp) {
   thread_t *ctp;
+#if CH_CFG_REGISTRY_INDEX_SIZE > 0
+
+  /* The pointer is only compared, it is not dereferenced until it is
+     found in the index.*/
+  chSysLock();
+  ctp = ch.regptrs[REG_BUCKET(REG_PTR_HASH(tp))];
+  while (ctp != NULL) {
+    if (ctp == tp) {
+#if CH_CFG_USE_DYNAMIC == TRUE
+      chDbgAssert(ctp->refs < (trefs_t)255, "too many references");
+      ctp->refs++;
+#endif
+      break;
+    }
+    ctp = ctp->pnext;
+  }
+  chSysUnlock();
+
+  return ctp;
+#else
 
   /* Scanning registry.*/
   ctp = chRegFirstThread();
@@ -231,6 +411,7 @@ thread_t *chRegFindThreadByPointer(thread_t *tp) {
   } while (ctp != NULL);
 
   return NULL;
+#endif
 }
 
 #if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE) ||  \
@@ -263,6 +444,205 @@ thread_t *chRegFindThreadByWorkingArea(stkalign_t *wa) {
 }
 #endif
 
+/**
+ * @brief   Takes a snapshot of the registry.
+ * @details The state of up to @p n threads, oldest first, is copied in a
+ *          single critical zone without taking references, the zone
+ *          duration is bounded by @p n. The stack space of the copied
+ *          threads, if available, is then scanned in short critical zones
+ *          guarded by the registry generation counter.
+ * @note    The records are consistent with each other, all of them are
+ *          taken at the same instant. Only the stack values are collected
+ *          later.
+ *
+ * @param[out] buf      pointer to an array of @p thread_snapshot_t records
+ * @param[in] n         number of records in the array
+ * @return              The number of records written.
+ *
+ * @api
+ */
+size_t chRegSnapshot(thread_snapshot_t *buf, size_t n) {
+  thread_t *tp;
+  size_t i;
+#if (CH_DBG_FILL_THREADS == TRUE) &&                                        \
+    ((CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE))
+  ucnt_t seq;
+  size_t j;
+#endif
+
+  chDbgCheck((buf != NULL) || (n == (size_t)0));
+
+  chSysLock();
+#if CH_DBG_STATISTICS == TRUE
+  /* The running thread is charged with the time since it was switched
+     in.*/
+  _stats_update_runtime();
+#endif
+#if (CH_DBG_FILL_THREADS == TRUE) &&                                        \
+    ((CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE))
+  seq = ch.rlist.regseq;
+#endif
+  i  = (size_t)0;
+  tp = ch.rlist.newer;
+  while ((i < n) && (tp != (thread_t *)&ch.rlist)) {
+    buf[i].tp      = tp;
+    buf[i].name    = tp->name;
+    buf[i].prio    = tp->prio;
+    buf[i].state   = tp->state;
+#if CH_DBG_THREADS_PROFILING == TRUE
+    buf[i].time    = tp->time;
+#endif
+#if CH_DBG_STATISTICS == TRUE
+    buf[i].runtime = tp->runtime;
+    buf[i].load    = tp->load;
+#endif
+    i++;
+    tp = tp->newer;
+  }
+  chSysUnlock();
+
+#if (CH_DBG_FILL_THREADS == TRUE) &&                                        \
+    ((CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE))
+  for (j = (size_t)0; j < i; j++) {
+    buf[j].stkfree = reg_stack_free(buf[j].tp, seq);
+  }
+#endif
+
+  return i;
+}
+
+#if (CH_DBG_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Closes the current load window and starts a new one.
+ * @details The load of each thread in the registry, and of the ISRs, is
+ *          calculated over the time elapsed since the previous invocation
+ *          then it can be retrieved using @p chRegGetThreadLoadX().
+ *          Invoking this function periodically gives the CPU usage over a
+ *          sliding window of the same period.
+ * @note    The window length is the sum of the time accounted to all
+ *          threads and ISRs, threads terminated during the window are
+ *          no more accounted.
+ * @note    The function scans the whole registry within a critical zone,
+ *          the critical zone duration is proportional to the number of
+ *          threads.
+ *
+ * @api
+ */
+void chRegUpdateLoad(void) {
+  thread_t *tp;
+  rttime_t window;
+
+  chSysLock();
+
+  /* The running thread is charged with the time since it was switched
+     in.*/
+  _stats_update_runtime();
+
+  /* Total time accounted since the previous window.*/
+  window = ch.kernel_stats.isr_cumulative - ch.kernel_stats.isr_loadmark;
+  tp = ch.rlist.newer;
+  while (tp != (thread_t *)&ch.rlist) {
+    window += tp->runtime - tp->loadmark;
+    tp = tp->newer;
+  }
+
+  /* Calculating the loads and starting the new window.*/
+  tp = ch.rlist.newer;
+  while (tp != (thread_t *)&ch.rlist) {
+    tp->load = reg_load_percent(tp->runtime - tp->loadmark, window);
+    tp->loadmark = tp->runtime;
+    tp = tp->newer;
+  }
+  ch.kernel_stats.isr_load = reg_load_percent(ch.kernel_stats.isr_cumulative -
+                                              ch.kernel_stats.isr_loadmark,
+                                              window);
+  ch.kernel_stats.isr_loadmark = ch.kernel_stats.isr_cumulative;
+
+  chSysUnlock();
+}
+#endif /* CH_DBG_STATISTICS == TRUE */
+
+#if (CH_CFG_REGISTRY_INDEX_SIZE > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Hashes a thread name.
+ * @details FNV-1a hash of the name string.
+ *
+ * @param[in] name      the thread name or @p NULL
+ * @return              The name hash, zero for a @p NULL name.
+ *
+ * @notapi
+ */
+uint32_t _reg_hash_name(const char *name) {
+  uint32_t hash;
+
+  if (name == NULL) {
+    return 0U;
+  }
+
+  hash = 2166136261U;
+  while (*name != '\0') {
+    hash ^= (uint32_t)(uint8_t)*name++;
+    hash *= 16777619U;
+  }
+
+  return hash;
+}
+
+/**
+ * @brief   Adds a thread to the registry index.
+ * @note    This function is invoked by @p REG_INSERT().
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] hash      hash of the thread name
+ *
+ * @notapi
+ */
+void _reg_index_insert(thread_t *tp, uint32_t hash) {
+  thread_t **tpp = &ch.regptrs[REG_BUCKET(REG_PTR_HASH(tp))];
+
+  tp->nhash = hash;
+  reg_names_insert(tp);
+  tp->pnext = *tpp;
+  *tpp = tp;
+}
+
+/**
+ * @brief   Removes a thread from the registry index.
+ * @note    This function is invoked by @p REG_REMOVE().
+ *
+ * @param[in] tp        pointer to the thread
+ *
+ * @notapi
+ */
+void _reg_index_remove(thread_t *tp) {
+  thread_t **tpp = &ch.regptrs[REG_BUCKET(REG_PTR_HASH(tp))];
+
+  reg_names_remove(tp);
+  while (*tpp != tp) {
+    chDbgAssert(*tpp != NULL, "not in index");
+    tpp = &(*tpp)->pnext;
+  }
+  *tpp = tp->pnext;
+}
+
+/**
+ * @brief   Changes the name of a thread in the registry index.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] name      the new thread name
+ * @param[in] hash      hash of the new thread name
+ *
+ * @notapi
+ */
+void _reg_index_rename(thread_t *tp, const char *name, uint32_t hash) {
+
+  reg_names_remove(tp);
+  tp->name  = name;
+  tp->nhash = hash;
+  reg_names_insert(tp);
+}
+#endif /* CH_CFG_REGISTRY_INDEX_SIZE > 0 */
+
 #endif /* CH_CFG_USE_REGISTRY == TRUE */
 
 /** @} */
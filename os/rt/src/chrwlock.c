@@ -0,0 +1,506 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chrwlock.c
+ * @brief   Reader-writer locks code.
+ *
+ * @addtogroup rwlocks
+ * @details Reader-writer locks related APIs and services.
+ *          <h2>Operation mode</h2>
+ *          A reader-writer lock is a threads synchronization object that
+ *          can be in three distinct states:
+ *          - Not owned (unlocked).
+ *          - Owned by one or more readers (read locked).
+ *          - Owned by a single writer (write locked).
+ *          .
+ *          Operations defined for reader-writer locks:
+ *          - <b>Read Lock</b>: The lock is acquired in shared mode if it is
+ *            not owned by a writer and no writers are waiting for it, else
+ *            the thread is queued in the readers queue ordered by priority.
+ *          - <b>Read Unlock</b>: The shared ownership is released, the
+ *            last reader leaving the lock resumes the highest priority
+ *            waiting writer, if any.
+ *          - <b>Write Lock</b>: The lock is acquired in exclusive mode if it
+ *            is not owned, else the thread is queued in the writers queue
+ *            ordered by priority.
+ *          - <b>Write Unlock</b>: The exclusive ownership is released, the
+ *            highest priority waiting writer, if any, is resumed and made
+ *            owner of the lock, else all the waiting readers are resumed.
+ *          .
+ *          <h2>Writer preference</h2>
+ *          Readers are not allowed to acquire a lock while writers are
+ *          waiting for it, this prevents writers starvation when the lock
+ *          is read frequently.
+ *
+ *          <h2>Priority inheritance</h2>
+ *          A thread queued on a write locked lock boosts the priority of
+ *          the writer, the original priority is restored when the write
+ *          lock is released. Readers do not inherit priority because the
+ *          shared owners are not tracked.
+ *
+ *          <h2>Constraints</h2>
+ *          Reader-writer locks are not recursive, a thread owning the lock
+ *          must not try to lock it again. Write locks and mutexes must be
+ *          released in reverse lock order.
+ * @pre     In order to use the reader-writer locks APIs the
+ *          @p CH_CFG_USE_RWLOCKS option must be enabled in @p chconf.h.
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Raises the priority of a thread owning a write lock.
+ * @details If the thread is itself waiting on a mutex then the mutex owner
+ *          is boosted too.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] prio      the inherited priority
+ *
+ * @notapi
+ */
+static void rw_boost(thread_t *tp, tprio_t prio) {
+
+  while (tp->prio < prio) {
+    tp->prio = prio;
+
+    /* The following states need priority queues reordering.*/
+    switch (tp->state) {
+#if CH_CFG_USE_MUTEXES == TRUE
+    case CH_STATE_WTMTX:
+      /* Re-enqueues the mutex owner with its new priority.*/
+      queue_prio_insert(queue_dequeue(tp), &tp->u.wtmtxp->queue);
+      tp = tp->u.wtmtxp->owner;
+      /*lint -e{9042} [16.1] Continues the while.*/
+      continue;
+#endif
+    case CH_STATE_READY:
+      /* Re-enqueues tp with its new priority on the ready list.*/
+      (void) chSchRequeueReadyI(tp);
+      break;
+    default:
+      /* Nothing to do for other states.*/
+      break;
+    }
+    break;
+  }
+}
+
+/**
+ * @brief   Assigns the write lock to a thread.
+ * @details The thread inherits the priority of the threads still waiting
+ *          on the lock.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ * @param[in] tp        pointer to the new writer thread
+ *
+ * @notapi
+ */
+static void rw_set_writer(rwlock_t *rwp, thread_t *tp) {
+
+  rwp->writer = tp;
+  rwp->wprio = tp->prio;
+  if (queue_notempty(&rwp->wqueue)) {
+    rw_boost(tp, rwp->wqueue.next->prio);
+  }
+  if (queue_notempty(&rwp->rqueue)) {
+    rw_boost(tp, rwp->rqueue.next->prio);
+  }
+}
+
+/**
+ * @brief   Resumes the next writer waiting on the lock.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @notapi
+ */
+static void rw_wakeup_writer(rwlock_t *rwp) {
+  thread_t *tp = queue_fifo_remove(&rwp->wqueue);
+
+  rw_set_writer(rwp, tp);
+  tp->u.rdymsg = MSG_OK;
+  (void) chSchReadyI(tp);
+}
+
+/**
+ * @brief   Resumes all the readers waiting on the lock.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @notapi
+ */
+static void rw_wakeup_readers(rwlock_t *rwp) {
+
+  while (queue_notempty(&rwp->rqueue)) {
+    thread_t *tp = queue_fifo_remove(&rwp->rqueue);
+
+    rwp->readers++;
+    tp->u.rdymsg = MSG_OK;
+    (void) chSchReadyI(tp);
+  }
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a @p rwlock_t structure.
+ *
+ * @param[out] rwp      pointer to a @p rwlock_t structure
+ *
+ * @init
+ */
+void chRWLockObjectInit(rwlock_t *rwp) {
+
+  chDbgCheck(rwp != NULL);
+
+  queue_init(&rwp->rqueue);
+  queue_init(&rwp->wqueue);
+  rwp->writer  = NULL;
+  rwp->readers = (cnt_t)0;
+  rwp->wprio   = (tprio_t)0;
+}
+
+/**
+ * @brief   Acquires the lock in shared mode.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @api
+ */
+void chRWLockReadLock(rwlock_t *rwp) {
+
+  chSysLock();
+  chRWLockReadLockS(rwp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Acquires the lock in shared mode.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @sclass
+ */
+void chRWLockReadLockS(rwlock_t *rwp) {
+
+  (void) chRWLockReadLockTimeoutS(rwp, TIME_INFINITE);
+}
+
+/**
+ * @brief   Acquires the lock in shared mode with timeout specification.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the lock has been acquired.
+ * @retval MSG_TIMEOUT  if the lock has not been acquired within the
+ *                      specified timeout.
+ *
+ * @api
+ */
+msg_t chRWLockReadLockTimeout(rwlock_t *rwp, sysinterval_t timeout) {
+  msg_t msg;
+
+  chSysLock();
+  msg = chRWLockReadLockTimeoutS(rwp, timeout);
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Acquires the lock in shared mode with timeout specification.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the lock has been acquired.
+ * @retval MSG_TIMEOUT  if the lock has not been acquired within the
+ *                      specified timeout.
+ *
+ * @sclass
+ */
+msg_t chRWLockReadLockTimeoutS(rwlock_t *rwp, sysinterval_t timeout) {
+  thread_t *ctp = currp;
+
+  chDbgCheckClassS();
+  chDbgCheck(rwp != NULL);
+  chDbgAssert(rwp->writer != ctp, "already write locked");
+
+  /* Writer preference, readers are held back while writers are waiting.*/
+  if ((rwp->writer == NULL) && queue_isempty(&rwp->wqueue)) {
+    rwp->readers++;
+    return MSG_OK;
+  }
+
+  if (TIME_IMMEDIATE == timeout) {
+    return MSG_TIMEOUT;
+  }
+
+  /* Priority inheritance toward the writer, if any.*/
+  if (rwp->writer != NULL) {
+    rw_boost(rwp->writer, ctp->prio);
+  }
+
+  queue_prio_insert(ctp, &rwp->rqueue);
+  ctp->u.wtobjp = rwp;
+
+  /* The thread waking this one accounts it as reader.*/
+  return chSchGoSleepTimeoutS(CH_STATE_QUEUED, timeout);
+}
+
+/**
+ * @brief   Releases the lock from shared mode.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @api
+ */
+void chRWLockReadUnlock(rwlock_t *rwp) {
+
+  chSysLock();
+  chRWLockReadUnlockS(rwp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Releases the lock from shared mode.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @sclass
+ */
+void chRWLockReadUnlockS(rwlock_t *rwp) {
+
+  chDbgCheckClassS();
+  chDbgCheck(rwp != NULL);
+  chDbgAssert(rwp->readers > (cnt_t)0, "not read locked");
+
+  /* The last reader leaving passes the lock to the next writer.*/
+  rwp->readers--;
+  if ((rwp->readers == (cnt_t)0) && queue_notempty(&rwp->wqueue)) {
+    rw_wakeup_writer(rwp);
+  }
+}
+
+/**
+ * @brief   Acquires the lock in exclusive mode.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @api
+ */
+void chRWLockWriteLock(rwlock_t *rwp) {
+
+  chSysLock();
+  chRWLockWriteLockS(rwp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Acquires the lock in exclusive mode.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @sclass
+ */
+void chRWLockWriteLockS(rwlock_t *rwp) {
+
+  (void) chRWLockWriteLockTimeoutS(rwp, TIME_INFINITE);
+}
+
+/**
+ * @brief   Acquires the lock in exclusive mode with timeout specification.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the lock has been acquired.
+ * @retval MSG_TIMEOUT  if the lock has not been acquired within the
+ *                      specified timeout.
+ *
+ * @api
+ */
+msg_t chRWLockWriteLockTimeout(rwlock_t *rwp, sysinterval_t timeout) {
+  msg_t msg;
+
+  chSysLock();
+  msg = chRWLockWriteLockTimeoutS(rwp, timeout);
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Acquires the lock in exclusive mode with timeout specification.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the lock has been acquired.
+ * @retval MSG_TIMEOUT  if the lock has not been acquired within the
+ *                      specified timeout.
+ *
+ * @sclass
+ */
+msg_t chRWLockWriteLockTimeoutS(rwlock_t *rwp, sysinterval_t timeout) {
+  thread_t *ctp = currp;
+  msg_t msg;
+
+  chDbgCheckClassS();
+  chDbgCheck(rwp != NULL);
+  chDbgAssert(rwp->writer != ctp, "already write locked");
+
+  if ((rwp->writer == NULL) && (rwp->readers == (cnt_t)0)) {
+    rw_set_writer(rwp, ctp);
+    return MSG_OK;
+  }
+
+  if (TIME_IMMEDIATE == timeout) {
+    return MSG_TIMEOUT;
+  }
+
+  /* Priority inheritance toward the writer, if any.*/
+  if (rwp->writer != NULL) {
+    rw_boost(rwp->writer, ctp->prio);
+  }
+
+  queue_prio_insert(ctp, &rwp->wqueue);
+  ctp->u.wtobjp = rwp;
+  msg = chSchGoSleepTimeoutS(CH_STATE_QUEUED, timeout);
+
+  /* If this was the last waiting writer then the readers held back by the
+     writer preference can proceed.*/
+  if ((msg == MSG_TIMEOUT) && (rwp->writer == NULL) &&
+      queue_isempty(&rwp->wqueue) && queue_notempty(&rwp->rqueue)) {
+    rw_wakeup_readers(rwp);
+    chSchRescheduleS();
+  }
+
+  return msg;
+}
+
+/**
+ * @brief   Releases the lock from exclusive mode.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @api
+ */
+void chRWLockWriteUnlock(rwlock_t *rwp) {
+
+  chSysLock();
+  chRWLockWriteUnlockS(rwp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Releases the lock from exclusive mode.
+ * @details The writer priority is restored, waiting writers are resumed
+ *          first, if there are no waiting writers then all the waiting
+ *          readers are resumed.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @sclass
+ */
+void chRWLockWriteUnlockS(rwlock_t *rwp) {
+  thread_t *ctp = currp;
+  tprio_t newprio;
+
+  chDbgCheckClassS();
+  chDbgCheck(rwp != NULL);
+  chDbgAssert(rwp->writer == ctp, "not owner");
+
+  /* Recalculates the writer priority, the priority inherited from the
+     owned mutexes is preserved.*/
+  newprio = rwp->wprio;
+  if (ctp->realprio > newprio) {
+    newprio = ctp->realprio;
+  }
+#if CH_CFG_USE_MUTEXES == TRUE
+  {
+    mutex_t *mp = ctp->mtxlist;
+
+    while (mp != NULL) {
+      if (chMtxQueueNotEmptyS(mp) && (mp->queue.next->prio > newprio)) {
+        newprio = mp->queue.next->prio;
+      }
+      mp = mp->next;
+    }
+  }
+#endif
+  ctp->prio = newprio;
+
+  rwp->writer = NULL;
+  if (queue_notempty(&rwp->wqueue)) {
+    rw_wakeup_writer(rwp);
+  }
+  else {
+    rw_wakeup_readers(rwp);
+  }
+}
+
+#endif /* CH_CFG_USE_RWLOCKS == TRUE */
+
+/** @} */
@@ -32,6 +32,30 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+#if (CH_CFG_READY_LIST_BITMAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Count of leading zeros of a non-zero 32 bits word.
+ * @note    The port layer can provide an optimized @p port_clz() macro,
+ *          the GCC builtin maps on the @p CLZ instruction on ARMv7-M and
+ *          later architectures.
+ */
+#if defined(port_clz)
+#define rl_clz(x)           port_clz(x)
+#elif defined(__GNUC__)
+#define rl_clz(x)           ((unsigned)__builtin_clz(x))
+#endif
+
+/**
+ * @brief   Bit mask of a priority level inside its bitmap word.
+ */
+#define rl_bit(prio)        (0x80000000U >> ((unsigned)(prio) & 31U))
+
+/**
+ * @brief   Ready list header as a thread pointer.
+ */
+#define rl_header()         ((thread_t *)&ch.rlist.queue)
+#endif /* CH_CFG_READY_LIST_BITMAP == TRUE */
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -53,6 +77,193 @@ ch_system_t ch;
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_READY_LIST_BITMAP == TRUE) || defined(__DOXYGEN__)
+#if !defined(rl_clz)
+CH_HOTPATH static unsigned rl_clz(uint32_t x) {
+  unsigned n = 0U;
+
+  if ((x & 0xFFFF0000U) == 0U) {
+    n += 16U;
+    x <<= 16;
+  }
+  if ((x & 0xFF000000U) == 0U) {
+    n += 8U;
+    x <<= 8;
+  }
+  if ((x & 0xF0000000U) == 0U) {
+    n += 4U;
+    x <<= 4;
+  }
+  if ((x & 0xC0000000U) == 0U) {
+    n += 2U;
+    x <<= 2;
+  }
+  if ((x & 0x80000000U) == 0U) {
+    n += 1U;
+  }
+
+  return n;
+}
+#endif /* !defined(rl_clz) */
+
+/**
+ * @brief   Finds the insertion point for a priority level.
+ * @details The function returns the last thread in the ready list having
+ *          priority greater or equal to the specified level or the list
+ *          header if there are no such threads.
+ *
+ * @param[in] prio      the priority level, it can be one level above
+ *                      @p HIGHPRIO
+ * @return              The thread behind which the insertion must happen.
+ */
+CH_HOTPATH static thread_t *rl_find_pred(unsigned prio) {
+  unsigned w = prio >> 5;
+  uint32_t bits;
+
+  if (w >= CH_SCH_BITMAP_WORDS) {
+    return rl_header();
+  }
+
+  /* Levels equal or greater than prio in the same word.*/
+  bits = ch.rlist.bitmap[w] & (0xFFFFFFFFU >> (prio & 31U));
+  if (bits == 0U) {
+
+    /* Non-empty words above the current one.*/
+    bits = ch.rlist.summary & ((0xFFFFFFFFU >> w) >> 1);
+    if (bits == 0U) {
+      return rl_header();
+    }
+    w = rl_clz(bits);
+    bits = ch.rlist.bitmap[w];
+  }
+
+  return ch.rlist.tails[(w << 5) + rl_clz(bits)];
+}
+
+/**
+ * @brief   Links a thread in the ready list after the specified thread.
+ *
+ * @param[in] tp        the thread to be inserted
+ * @param[in] cp        the thread, or header, preceding the insertion point
+ */
+CH_HOTPATH static void rl_insert_after(thread_t *tp, thread_t *cp) {
+
+  tp->queue.prev             = cp;
+  tp->queue.next             = cp->queue.next;
+  tp->queue.next->queue.prev = tp;
+  cp->queue.next             = tp;
+}
+
+/**
+ * @brief   Marks a priority level as non-empty.
+ *
+ * @param[in] tp        the thread becoming the last of its level
+ */
+CH_HOTPATH static void rl_set_tail(thread_t *tp) {
+  unsigned prio = (unsigned)tp->rdyprio;
+
+  ch.rlist.tails[prio] = tp;
+  ch.rlist.bitmap[prio >> 5] |= rl_bit(prio);
+  ch.rlist.summary |= rl_bit(prio >> 5);
+}
+
+/**
+ * @brief   Unlinks a thread from the ready list updating the index.
+ *
+ * @param[in] tp        the thread to be removed
+ * @return              The removed thread pointer.
+ */
+CH_HOTPATH static thread_t *rl_remove(thread_t *tp) {
+  unsigned prio = (unsigned)tp->rdyprio;
+
+  if (ch.rlist.tails[prio] == tp) {
+    thread_t *pp = tp->queue.prev;
+
+    if ((pp != rl_header()) && (pp->rdyprio == tp->rdyprio)) {
+      /* The previous thread becomes the last of the level.*/
+      ch.rlist.tails[prio] = pp;
+    }
+    else {
+      /* The level becomes empty.*/
+      ch.rlist.bitmap[prio >> 5] &= ~rl_bit(prio);
+      if (ch.rlist.bitmap[prio >> 5] == 0U) {
+        ch.rlist.summary &= ~rl_bit(prio >> 5);
+      }
+    }
+  }
+
+  return queue_dequeue(tp);
+}
+
+/**
+ * @brief   Removes the first thread from the ready list.
+ *
+ * @return              The removed thread pointer.
+ */
+CH_HOTPATH static inline thread_t *rl_fifo_remove(void) {
+
+  return rl_remove(ch.rlist.queue.next);
+}
+#else /* CH_CFG_READY_LIST_BITMAP == FALSE */
+#define rl_fifo_remove()    queue_fifo_remove(&ch.rlist.queue)
+#endif /* CH_CFG_READY_LIST_BITMAP == FALSE */
+
+#if (CH_CFG_EDF_PRIO > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Inserts a thread of the EDF band in the ready list.
+ * @details The thread is positioned by deadline among the threads of the
+ *          band, behind or ahead of the threads having the same deadline.
+ *
+ * @param[in] tp        the thread to be inserted
+ * @param[in] ahead     insertion ahead of the threads having the same
+ *                      deadline
+ */
+CH_HOTPATH static void rl_edf_insert(thread_t *tp, bool ahead) {
+  thread_t *cp;
+
+#if CH_CFG_READY_LIST_BITMAP == TRUE
+  unsigned prio = (unsigned)tp->prio;
+  thread_t *pp;
+  bool tail;
+
+  /* Scanning the band starting from its first thread, the thread becomes
+     the last of the band if inserted at its end.*/
+  tp->rdyprio = tp->prio;
+  tail = (ch.rlist.bitmap[prio >> 5] & rl_bit(prio)) == 0U;
+  pp = rl_find_pred(prio + 1U);
+  cp = pp->queue.next;
+  while ((cp != rl_header()) && (cp->rdyprio == tp->rdyprio) &&
+         (ahead ? chSchIsEarlierX(cp->deadline, tp->deadline) :
+                  !chSchIsEarlierX(tp->deadline, cp->deadline))) {
+    pp = cp;
+    cp = cp->queue.next;
+  }
+  tail = tail || (ch.rlist.tails[prio] == pp);
+  rl_insert_after(tp, pp);
+  if (tail) {
+    rl_set_tail(tp);
+  }
+#else
+  /* Skipping threads with higher priority then scanning the band, the list
+     header priority terminates both loops.*/
+  cp = (thread_t *)&ch.rlist.queue;
+  do {
+    cp = cp->queue.next;
+  } while (cp->prio > tp->prio);
+  while ((cp->prio == tp->prio) &&
+         (ahead ? chSchIsEarlierX(cp->deadline, tp->deadline) :
+                  !chSchIsEarlierX(tp->deadline, cp->deadline))) {
+    cp = cp->queue.next;
+  }
+  /* Insertion on prev.*/
+  tp->queue.next             = cp;
+  tp->queue.prev             = cp->queue.prev;
+  tp->queue.prev->queue.next = tp;
+  cp->queue.prev             = tp;
+#endif
+}
+#endif /* CH_CFG_EDF_PRIO > 0 */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -66,9 +277,30 @@ void _scheduler_init(void) {
 
   queue_init(&ch.rlist.queue);
   ch.rlist.prio = NOPRIO;
+#if CH_CFG_READY_LIST_BITMAP == TRUE
+  {
+    unsigned i;
+
+    ch.rlist.summary = 0U;
+    for (i = 0U; i < CH_SCH_BITMAP_WORDS; i++) {
+      ch.rlist.bitmap[i] = 0U;
+    }
+  }
+#endif
 #if CH_CFG_USE_REGISTRY == TRUE
   ch.rlist.newer = (thread_t *)&ch.rlist;
   ch.rlist.older = (thread_t *)&ch.rlist;
+  ch.rlist.regseq = (ucnt_t)0;
+#endif
+#if CH_CFG_REGISTRY_INDEX_SIZE > 0
+  {
+    unsigned i;
+
+    for (i = 0U; i < (unsigned)CH_CFG_REGISTRY_INDEX_SIZE; i++) {
+      ch.regnames[i] = NULL;
+      ch.regptrs[i]  = NULL;
+    }
+  }
 #endif
 }
 
@@ -76,7 +308,9 @@ void _scheduler_init(void) {
 /**
  * @brief   Inserts a thread into a priority ordered queue.
  * @note    The insertion is done by scanning the list from the highest
- *          priority toward the lowest.
+ *          priority toward the lowest, if @p CH_CFG_QUEUE_BUCKETS is
+ *          enabled then the list is scanned backward one priority bucket
+ *          at time.
  *
  * @param[in] tp        the pointer to the thread to be inserted in the list
  * @param[in] tqp       the pointer to the threads list header
@@ -85,6 +319,19 @@ void _scheduler_init(void) {
  */
 void queue_prio_insert(thread_t *tp, threads_queue_t *tqp) {
 
+#if CH_CFG_QUEUE_BUCKETS == TRUE
+  /* Scanning backward one bucket at time, the thread is inserted behind
+     the last bucket with higher or equal priority.*/
+  thread_t *cp = tqp->prev;
+  while ((cp != (thread_t *)tqp) && (cp->prio < tp->prio)) {
+    cp = cp->qbucket->queue.prev;
+  }
+  tp->queue.prev             = cp;
+  tp->queue.next             = cp->queue.next;
+  tp->queue.next->queue.prev = tp;
+  cp->queue.next             = tp;
+  queue_bucket_link(tp, cp, tqp);
+#else
   thread_t *cp = (thread_t *)tqp;
   do {
     cp = cp->queue.next;
@@ -93,6 +340,7 @@ void queue_prio_insert(thread_t *tp, threads_queue_t *tqp) {
   tp->queue.prev             = cp->queue.prev;
   tp->queue.prev->queue.next = tp;
   cp->queue.prev             = tp;
+#endif
 }
 
 /**
@@ -105,6 +353,9 @@ void queue_prio_insert(thread_t *tp, threads_queue_t *tqp) {
  */
 void queue_insert(thread_t *tp, threads_queue_t *tqp) {
 
+#if CH_CFG_QUEUE_BUCKETS == TRUE
+  queue_bucket_link(tp, tqp->prev, tqp);
+#endif
   tp->queue.next             = (thread_t *)tqp;
   tp->queue.prev             = tqp->prev;
   tp->queue.prev->queue.next = tp;
@@ -124,6 +375,9 @@ void queue_insert(thread_t *tp, threads_queue_t *tqp) {
 thread_t *queue_fifo_remove(threads_queue_t *tqp) {
   thread_t *tp = tqp->next;
 
+#if CH_CFG_QUEUE_BUCKETS == TRUE
+  queue_bucket_unlink(tp);
+#endif
   tqp->next             = tp->queue.next;
   tqp->next->queue.prev = (thread_t *)tqp;
 
@@ -143,6 +397,9 @@ thread_t *queue_fifo_remove(threads_queue_t *tqp) {
 thread_t *queue_lifo_remove(threads_queue_t *tqp) {
   thread_t *tp = tqp->prev;
 
+#if CH_CFG_QUEUE_BUCKETS == TRUE
+  queue_bucket_unlink(tp);
+#endif
   tqp->prev             = tp->queue.prev;
   tqp->prev->queue.next = (thread_t *)tqp;
 
@@ -161,6 +418,9 @@ thread_t *queue_lifo_remove(threads_queue_t *tqp) {
  */
 thread_t *queue_dequeue(thread_t *tp) {
 
+#if CH_CFG_QUEUE_BUCKETS == TRUE
+  queue_bucket_unlink(tp);
+#endif
   tp->queue.prev->queue.next = tp->queue.next;
   tp->queue.next->queue.prev = tp->queue.prev;
 
@@ -215,7 +475,7 @@ thread_t *list_remove(threads_list_t *tlp) {
  *
  * @iclass
  */
-thread_t *chSchReadyI(thread_t *tp) {
+CH_HOTPATH thread_t *chSchReadyI(thread_t *tp) {
   thread_t *cp;
 
   chDbgCheckClassI();
@@ -224,7 +484,22 @@ thread_t *chSchReadyI(thread_t *tp) {
               (tp->state != CH_STATE_FINAL),
               "invalid state");
 
+  _wprof_wakeup(tp, false);
   tp->state = CH_STATE_READY;
+#if CH_CFG_EDF_PRIO > 0
+  if (tp->prio == (tprio_t)CH_CFG_EDF_PRIO) {
+    rl_edf_insert(tp, false);
+    return tp;
+  }
+#endif
+#if CH_CFG_READY_LIST_BITMAP == TRUE
+  /* Insertion behind the last thread with higher or equal priority, the
+     thread becomes the last of its level.*/
+  tp->rdyprio = tp->prio;
+  cp = rl_find_pred((unsigned)tp->prio);
+  rl_insert_after(tp, cp);
+  rl_set_tail(tp);
+#else
   cp = (thread_t *)&ch.rlist.queue;
   do {
     cp = cp->queue.next;
@@ -234,6 +509,7 @@ thread_t *chSchReadyI(thread_t *tp) {
   tp->queue.prev             = cp->queue.prev;
   tp->queue.prev->queue.next = tp;
   cp->queue.prev             = tp;
+#endif
 
   return tp;
 }
@@ -254,7 +530,7 @@ thread_t *chSchReadyI(thread_t *tp) {
  *
  * @iclass
  */
-thread_t *chSchReadyAheadI(thread_t *tp) {
+CH_HOTPATH thread_t *chSchReadyAheadI(thread_t *tp) {
   thread_t *cp;
 
   chDbgCheckClassI();
@@ -263,7 +539,24 @@ thread_t *chSchReadyAheadI(thread_t *tp) {
               (tp->state != CH_STATE_FINAL),
               "invalid state");
 
+  _wprof_wakeup(tp, false);
   tp->state = CH_STATE_READY;
+#if CH_CFG_EDF_PRIO > 0
+  if (tp->prio == (tprio_t)CH_CFG_EDF_PRIO) {
+    rl_edf_insert(tp, true);
+    return tp;
+  }
+#endif
+#if CH_CFG_READY_LIST_BITMAP == TRUE
+  /* Insertion behind the last thread with higher priority, the thread
+     becomes the last of its level only if the level was empty.*/
+  tp->rdyprio = tp->prio;
+  cp = rl_find_pred((unsigned)tp->prio + 1U);
+  rl_insert_after(tp, cp);
+  if ((ch.rlist.bitmap[(unsigned)tp->prio >> 5] & rl_bit(tp->prio)) == 0U) {
+    rl_set_tail(tp);
+  }
+#else
   cp = (thread_t *)&ch.rlist.queue;
   do {
     cp = cp->queue.next;
@@ -273,10 +566,60 @@ thread_t *chSchReadyAheadI(thread_t *tp) {
   tp->queue.prev             = cp->queue.prev;
   tp->queue.prev->queue.next = tp;
   cp->queue.prev             = tp;
+#endif
 
   return tp;
 }
 
+#if (CH_CFG_READY_LIST_BITMAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Removes a thread from the ready list.
+ * @details The thread is removed from the ready list regardless of its
+ *          relative position, this is required when a ready thread changes
+ *          priority and must be re-enqueued.
+ * @pre     The thread must be in @p CH_STATE_READY state.
+ *
+ * @param[in] tp        the pointer to the thread to be removed
+ * @return              The removed thread pointer.
+ *
+ * @iclass
+ */
+thread_t *chSchDequeueReadyI(thread_t *tp) {
+
+  chDbgCheckClassI();
+  chDbgCheck(tp != NULL);
+  chDbgAssert(tp->state == CH_STATE_READY, "not ready");
+
+  return rl_remove(tp);
+}
+#endif /* CH_CFG_READY_LIST_BITMAP == TRUE */
+
+/**
+ * @brief   Re-enqueues a thread in the ready list.
+ * @details The thread is removed from the ready list and inserted again
+ *          behind the threads with higher or equal priority, this is
+ *          required after the priority of a ready thread has been changed.
+ * @pre     The thread must be in @p CH_STATE_READY state.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel.
+ *
+ * @param[in] tp        the thread to be re-enqueued
+ * @return              The thread pointer.
+ *
+ * @iclass
+ */
+thread_t *chSchRequeueReadyI(thread_t *tp) {
+
+  (void) chSchDequeueReadyI(tp);
+#if CH_DBG_ENABLE_ASSERTS == TRUE
+  /* The thread is no more in the ready list but its state is still ready,
+     changing it prevents the state assertion in chSchReadyI().*/
+  tp->state = CH_STATE_CURRENT;
+#endif
+
+  return chSchReadyI(tp);
+}
+
 /**
  * @brief   Puts the current thread to sleep into the specified state.
  * @details The thread goes into a sleeping state. The possible
@@ -286,22 +629,23 @@ thread_t *chSchReadyAheadI(thread_t *tp) {
  *
  * @sclass
  */
-void chSchGoSleepS(tstate_t newstate) {
+CH_HOTPATH void chSchGoSleepS(tstate_t newstate) {
   thread_t *otp = currp;
 
   chDbgCheckClassS();
 
   /* New state.*/
   otp->state = newstate;
+  _wprof_sleep(otp);
 
 #if CH_CFG_TIME_QUANTUM > 0
   /* The thread is renouncing its remaining time slices so it will have a new
      time quantum when it will wakeup.*/
-  otp->ticks = (tslices_t)CH_CFG_TIME_QUANTUM;
+  otp->ticks = otp->quantum;
 #endif
 
   /* Next thread in ready list becomes current.*/
-  currp = queue_fifo_remove(&ch.rlist.queue);
+  currp = rl_fifo_remove();
   currp->state = CH_STATE_CURRENT;
 
   /* Handling idle-enter hook.*/
@@ -316,7 +660,7 @@ void chSchGoSleepS(tstate_t newstate) {
 /*
  * Timeout wakeup callback.
  */
-static void wakeup(void *p) {
+CH_HOTPATH static void wakeup(void *p) {
   thread_t *tp = (thread_t *)p;
 
   chSysLockFromISR();
@@ -329,6 +673,22 @@ static void wakeup(void *p) {
   case CH_STATE_SUSPENDED:
     *tp->u.wttrp = NULL;
     break;
+#if CH_CFG_USE_MESSAGES == TRUE
+  case CH_STATE_SNDMSG:
+    /* The message has already been taken by the receiver, the sender
+       waits for the release.*/
+    chSysUnlockFromISR();
+    return;
+#endif
+#if (CH_CFG_USE_CONDVARS == TRUE) &&                                        \
+    (CH_CFG_USE_CONDVARS_TIMEOUT == TRUE) &&                                \
+    (CH_CFG_CONDVARS_WAIT_MORPHING == TRUE)
+  case CH_STATE_WTMTX:
+    /* The thread has been released from a condition variable and moved
+       on the mutex queue, it waits for the mutex.*/
+    chSysUnlockFromISR();
+    return;
+#endif
 #if CH_CFG_USE_SEMAPHORES == TRUE
   case CH_STATE_WTSEM:
     chSemFastSignalI(tp->u.wtsemp);
@@ -336,6 +696,10 @@ static void wakeup(void *p) {
     /* Falls through.*/
   case CH_STATE_QUEUED:
     /* Falls through.*/
+#if CH_CFG_USE_MESSAGES == TRUE
+  case CH_STATE_SNDMSGQ:
+    /* Falls through.*/
+#endif
 #if (CH_CFG_USE_CONDVARS == TRUE) && (CH_CFG_USE_CONDVARS_TIMEOUT == TRUE)
   case CH_STATE_WTCOND:
 #endif
@@ -346,6 +710,7 @@ static void wakeup(void *p) {
     /* Any other state, nothing to do.*/
     break;
   }
+  _wprof_wakeup(tp, true);
   tp->u.rdymsg = MSG_TIMEOUT;
   (void) chSchReadyI(tp);
   chSysUnlockFromISR();
@@ -372,7 +737,8 @@ static void wakeup(void *p) {
  *
  * @sclass
  */
-msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout) {
+CH_HOTPATH msg_t chSchGoSleepTimeoutS(tstate_t newstate,
+                                      sysinterval_t timeout) {
 
   chDbgCheckClassS();
 
@@ -392,6 +758,51 @@ msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout) {
   return currp->u.rdymsg;
 }
 
+/**
+ * @brief   Puts the current thread to sleep into the specified state with
+ *          a tolerant timeout specification.
+ * @details The thread goes into a sleeping state, if it is not awakened
+ *          explicitly then it is forcibly awakened with a @p MSG_TIMEOUT
+ *          low level message after a time between @p timeout and
+ *          @p timeout + @p slack ticks. The timeout is allowed to share
+ *          the deadline of other timers in order to save alarm interrupts
+ *          in tick-less mode, see @p chVTDoSetWindowI().
+ *
+ * @param[in] newstate  the new thread state
+ * @param[in] timeout   the minimum number of ticks before the operation
+ *                      timeouts, the special values are handled as follow:
+ *                      - @a TIME_INFINITE the thread enters an infinite sleep
+ *                        state, this is equivalent to invoking
+ *                        @p chSchGoSleepS() but, of course, less efficient.
+ *                      - @a TIME_IMMEDIATE this value is not allowed.
+ *                      .
+ * @param[in] slack     the number of ticks the timeout can be postponed
+ * @return              The wakeup message.
+ * @retval MSG_TIMEOUT  if a timeout occurs.
+ *
+ * @sclass
+ */
+msg_t chSchGoSleepWithSlackS(tstate_t newstate, sysinterval_t timeout,
+                             sysinterval_t slack) {
+
+  chDbgCheckClassS();
+
+  if (TIME_INFINITE != timeout) {
+    virtual_timer_t vt;
+
+    chVTDoSetWindowI(&vt, timeout, slack, wakeup, currp);
+    chSchGoSleepS(newstate);
+    if (chVTIsArmedI(&vt)) {
+      chVTDoResetI(&vt);
+    }
+  }
+  else {
+    chSchGoSleepS(newstate);
+  }
+
+  return currp->u.rdymsg;
+}
+
 /**
  * @brief   Wakes up a thread.
  * @details The thread is inserted into the ready list or immediately made
@@ -409,11 +820,25 @@ msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout) {
  *
  * @sclass
  */
-void chSchWakeupS(thread_t *ntp, msg_t msg) {
+CH_HOTPATH void chSchWakeupS(thread_t *ntp, msg_t msg) {
   thread_t *otp = currp;
 
   chDbgCheckClassS();
 
+  /* The thread could be switched in without passing through the ready
+     list.*/
+  _wprof_wakeup(ntp, false);
+
+#if CH_CFG_USE_SCHED_BATCH == TRUE
+  if (otp->batch > (uint8_t)0) {
+    /* Inside a batch the thread is just made ready, the reschedule is
+       deferred to the end of the batch.*/
+    ntp->u.rdymsg = msg;
+    (void) chSchReadyI(ntp);
+    return;
+  }
+#endif
+
   chDbgAssert((ch.rlist.queue.next == (thread_t *)&ch.rlist.queue) ||
               (ch.rlist.current->prio >= ch.rlist.queue.next->prio),
               "priority order violation");
@@ -426,7 +851,7 @@ void chSchWakeupS(thread_t *ntp, msg_t msg) {
      one then it is just inserted in the ready list else it made
      running immediately and the invoking thread goes in the ready
      list instead.*/
-  if (ntp->prio <= otp->prio) {
+  if (!chSchHasPrecedenceX(ntp, otp)) {
     (void) chSchReadyI(ntp);
   }
   else {
@@ -453,10 +878,17 @@ void chSchWakeupS(thread_t *ntp, msg_t msg) {
  *
  * @sclass
  */
-void chSchRescheduleS(void) {
+CH_HOTPATH void chSchRescheduleS(void) {
 
   chDbgCheckClassS();
 
+#if CH_CFG_USE_SCHED_BATCH == TRUE
+  /* Reschedule deferred to the end of the batch.*/
+  if (currp->batch > (uint8_t)0) {
+    return;
+  }
+#endif
+
   if (chSchIsRescRequiredI()) {
     chSchDoRescheduleAhead();
   }
@@ -476,21 +908,34 @@ void chSchRescheduleS(void) {
  *
  * @special
  */
-bool chSchIsPreemptionRequired(void) {
-  tprio_t p1 = firstprio(&ch.rlist.queue);
-  tprio_t p2 = currp->prio;
+CH_HOTPATH bool chSchIsPreemptionRequired(void) {
+  thread_t *ntp = ch.rlist.queue.next;
+
+#if CH_CFG_USE_SCHED_BATCH == TRUE
+  /* No preemption inside a batch.*/
+  if (currp->batch > (uint8_t)0) {
+    return false;
+  }
+#endif
 
 #if CH_CFG_TIME_QUANTUM > 0
   /* If the running thread has not reached its time quantum, reschedule only
      if the first thread on the ready queue has a higher priority.
      Otherwise, if the running thread has used up its time quantum, reschedule
-     if the first thread on the ready queue has equal or higher priority.*/
-  return (currp->ticks > (tslices_t)0) ? (p1 > p2) : (p1 >= p2);
+     if the first thread on the ready queue has equal or higher priority.
+     Round robin does not apply to the EDF band.*/
+#if CH_CFG_EDF_PRIO > 0
+  if ((currp->ticks == (tslices_t)0) &&
+      (currp->prio != (tprio_t)CH_CFG_EDF_PRIO)) {
 #else
-  /* If the round robin preemption feature is not enabled then performs a
-     simpler comparison.*/
-  return p1 > p2;
+  if (currp->ticks == (tslices_t)0) {
+#endif
+    return ntp->prio >= currp->prio;
+  }
 #endif
+
+  /* Preemption if the first thread has precedence.*/
+  return chSchHasPrecedenceX(ntp, currp);
 }
 #endif /* !defined(CH_SCH_IS_PREEMPTION_REQUIRED_HOOKED) */
 
@@ -504,11 +949,11 @@ bool chSchIsPreemptionRequired(void) {
  *
  * @special
  */
-void chSchDoRescheduleBehind(void) {
+CH_HOTPATH void chSchDoRescheduleBehind(void) {
   thread_t *otp = currp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
-  currp = queue_fifo_remove(&ch.rlist.queue);
+  currp = rl_fifo_remove();
   currp->state = CH_STATE_CURRENT;
 
   /* Handling idle-leave hook.*/
@@ -518,7 +963,7 @@ void chSchDoRescheduleBehind(void) {
 
 #if CH_CFG_TIME_QUANTUM > 0
   /* It went behind peers so it gets a new time quantum.*/
-  otp->ticks = (tslices_t)CH_CFG_TIME_QUANTUM;
+  otp->ticks = otp->quantum;
 #endif
 
   /* Placing in ready list behind peers.*/
@@ -537,11 +982,11 @@ void chSchDoRescheduleBehind(void) {
  *
  * @special
  */
-void chSchDoRescheduleAhead(void) {
+CH_HOTPATH void chSchDoRescheduleAhead(void) {
   thread_t *otp = currp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
-  currp = queue_fifo_remove(&ch.rlist.queue);
+  currp = rl_fifo_remove();
   currp->state = CH_STATE_CURRENT;
 
   /* Handling idle-leave hook.*/
@@ -567,11 +1012,11 @@ void chSchDoRescheduleAhead(void) {
  *
  * @special
  */
-void chSchDoReschedule(void) {
+CH_HOTPATH void chSchDoReschedule(void) {
   thread_t *otp = currp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
-  currp = queue_fifo_remove(&ch.rlist.queue);
+  currp = rl_fifo_remove();
   currp->state = CH_STATE_CURRENT;
 
   /* Handling idle-leave hook.*/
@@ -582,14 +1027,14 @@ void chSchDoReschedule(void) {
 #if CH_CFG_TIME_QUANTUM > 0
   /* If CH_CFG_TIME_QUANTUM is enabled then there are two different scenarios
      to handle on preemption: time quantum elapsed or not.*/
-  if (currp->ticks == (tslices_t)0) {
+  if (otp->ticks == (tslices_t)0) {
 
     /* The thread consumed its time quantum so it is enqueued behind threads
        with same priority level, however, it acquires a new time quantum.*/
     otp = chSchReadyI(otp);
 
     /* The thread being swapped out receives a new time quantum.*/
-    otp->ticks = (tslices_t)CH_CFG_TIME_QUANTUM;
+    otp->ticks = otp->quantum;
   }
   else {
     /* The thread didn't consume all its time quantum so it is put ahead of
@@ -607,4 +1052,44 @@ void chSchDoReschedule(void) {
 }
 #endif /*!defined(CH_SCH_DO_RESCHEDULE_HOOKED) */
 
+#if (CH_CFG_USE_SCHED_BATCH == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Opens a scheduler batch scope.
+ * @details The reschedule points reached by the current thread until the
+ *          matching @p chSchBatchEnd() only make the awakened threads
+ *          ready, a single reschedule decision is taken at the end of the
+ *          outermost scope. Preemption by ISRs is also deferred.
+ * @note    Scopes can be nested.
+ * @note    The batch should be kept short because higher priority threads
+ *          are delayed until its end. Going to sleep inside a batch is
+ *          allowed, other threads are scheduled normally.
+ *
+ * @api
+ */
+void chSchBatchBegin(void) {
+
+  chSysLock();
+  chDbgAssert(currp->batch < (uint8_t)255, "too many nested batches");
+  currp->batch++;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Closes a scheduler batch scope.
+ * @details When the outermost scope is closed a reschedule is performed
+ *          if a higher priority thread has been made ready inside the
+ *          batch.
+ *
+ * @api
+ */
+void chSchBatchEnd(void) {
+
+  chSysLock();
+  chDbgAssert(currp->batch > (uint8_t)0, "not in a batch");
+  currp->batch--;
+  chSchRescheduleS();
+  chSysUnlock();
+}
+#endif /* CH_CFG_USE_SCHED_BATCH == TRUE */
+
 /** @} */
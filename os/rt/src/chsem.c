@@ -100,6 +100,9 @@ void chSemObjectInit(semaphore_t *sp, cnt_t n) {
 
   queue_init(&sp->queue);
   sp->cnt = n;
+#if CH_CFG_USE_WAIT_MULTIPLE == TRUE
+  wait_list_init(&sp->waiters);
+#endif
 }
 
 /**
@@ -158,6 +161,11 @@ void chSemResetI(semaphore_t *sp, cnt_t n) {
   while (++cnt <= (cnt_t)0) {
     chSchReadyI(queue_lifo_remove(&sp->queue))->u.rdymsg = MSG_RESET;
   }
+#if CH_CFG_USE_WAIT_MULTIPLE == TRUE
+  if (n > (cnt_t)0) {
+    chWaitNotifyI(&sp->waiters);
+  }
+#endif
 }
 
 /**
@@ -302,6 +310,31 @@ void chSemSignal(semaphore_t *sp) {
   if (++sp->cnt <= (cnt_t)0) {
     chSchWakeupS(queue_fifo_remove(&sp->queue), MSG_OK);
   }
+#if CH_CFG_USE_WAIT_MULTIPLE == TRUE
+  else {
+    chWaitNotifyI(&sp->waiters);
+    chSchRescheduleS();
+  }
+#endif
+  chSysUnlock();
+}
+
+/**
+ * @brief   Performs multiple signal operations on a semaphore.
+ * @details All the awakened threads are made ready before a single
+ *          reschedule decision is taken, this is more efficient than
+ *          calling @p chSemSignal() @p n times.
+ *
+ * @param[in] sp        pointer to a @p semaphore_t structure
+ * @param[in] n         number of signal operations, it must be positive
+ *
+ * @api
+ */
+void chSemSignalN(semaphore_t *sp, cnt_t n) {
+
+  chSysLock();
+  chSemAddCounterI(sp, n);
+  chSchRescheduleS();
   chSysUnlock();
 }
 
@@ -331,6 +364,11 @@ void chSemSignalI(semaphore_t *sp) {
     tp->u.rdymsg = MSG_OK;
     (void) chSchReadyI(tp);
   }
+#if CH_CFG_USE_WAIT_MULTIPLE == TRUE
+  else {
+    chWaitNotifyI(&sp->waiters);
+  }
+#endif
 }
 
 /**
@@ -354,12 +392,28 @@ void chSemAddCounterI(semaphore_t *sp, cnt_t n) {
               ((sp->cnt < (cnt_t)0) && queue_notempty(&sp->queue)),
               "inconsistent semaphore");
 
-  while (n > (cnt_t)0) {
-    if (++sp->cnt <= (cnt_t)0) {
+  /* The number of threads to be awakened is known in advance, the counter
+     is updated once.*/
+  if (sp->cnt < (cnt_t)0) {
+    cnt_t w = -sp->cnt;
+
+    if (w > n) {
+      w = n;
+    }
+    sp->cnt += n;
+    while (w > (cnt_t)0) {
       chSchReadyI(queue_fifo_remove(&sp->queue))->u.rdymsg = MSG_OK;
+      w--;
     }
-    n--;
   }
+  else {
+    sp->cnt += n;
+  }
+#if CH_CFG_USE_WAIT_MULTIPLE == TRUE
+  if (sp->cnt > (cnt_t)0) {
+    chWaitNotifyI(&sp->waiters);
+  }
+#endif
 }
 
 /**
@@ -390,6 +444,11 @@ msg_t chSemSignalWait(semaphore_t *sps, semaphore_t *spw) {
   if (++sps->cnt <= (cnt_t)0) {
     chSchReadyI(queue_fifo_remove(&sps->queue))->u.rdymsg = MSG_OK;
   }
+#if CH_CFG_USE_WAIT_MULTIPLE == TRUE
+  else {
+    chWaitNotifyI(&sps->waiters);
+  }
+#endif
   if (--spw->cnt < (cnt_t)0) {
     thread_t *ctp = currp;
     sem_insert(ctp, &spw->queue);
@@ -50,6 +50,25 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Charges a thread with the time elapsed since the last switch.
+ * @details The ISRs time accumulated in the meantime is not accounted to
+ *          the thread.
+ *
+ * @param[in] tp        the thread being charged, it must be the running
+ *                      thread
+ */
+static void stats_charge_runtime(thread_t *tp) {
+  rtcnt_t now = chSysGetRealtimeCounterX();
+  rtcnt_t elapsed = now - ch.kernel_stats.lastswc;
+
+  if (elapsed > ch.kernel_stats.isr_pending) {
+    tp->runtime += (rttime_t)(elapsed - ch.kernel_stats.isr_pending);
+  }
+  ch.kernel_stats.isr_pending = (rtcnt_t)0;
+  ch.kernel_stats.lastswc = now;
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -63,8 +82,21 @@ void _stats_init(void) {
 
   ch.kernel_stats.n_irq = (ucnt_t)0;
   ch.kernel_stats.n_ctxswc = (ucnt_t)0;
+  ch.kernel_stats.n_vtsaved = (ucnt_t)0;
+#if CH_CFG_USE_TM_HISTOGRAM == TRUE
+  chTMObjectInitHistogram(&ch.kernel_stats.m_crit_thd,
+                          &ch.kernel_stats.h_crit_thd);
+  chTMObjectInitHistogram(&ch.kernel_stats.m_crit_isr,
+                          &ch.kernel_stats.h_crit_isr);
+#else
   chTMObjectInit(&ch.kernel_stats.m_crit_thd);
   chTMObjectInit(&ch.kernel_stats.m_crit_isr);
+#endif
+  ch.kernel_stats.isr_cumulative = (rttime_t)0;
+  ch.kernel_stats.isr_loadmark = (rttime_t)0;
+  ch.kernel_stats.isr_load = (uint8_t)0;
+  ch.kernel_stats.isr_nesting = (cnt_t)0;
+  ch.kernel_stats.isr_pending = (rtcnt_t)0;
 }
 
 /**
@@ -77,6 +109,56 @@ void _stats_increase_irq(void) {
   port_unlock_from_isr();
 }
 
+/**
+ * @brief   Starts the measurement of an ISR execution time.
+ * @note    Only the outermost ISR of a nested sequence is measured.
+ */
+void _stats_start_measure_isr(void) {
+
+  port_lock_from_isr();
+  if (ch.kernel_stats.isr_nesting++ == (cnt_t)0) {
+    ch.kernel_stats.isr_start = chSysGetRealtimeCounterX();
+  }
+  port_unlock_from_isr();
+}
+
+/**
+ * @brief   Stops the measurement of an ISR execution time.
+ * @details The measured time is accumulated and it will be subtracted from
+ *          the run time of the interrupted thread.
+ */
+void _stats_stop_measure_isr(void) {
+
+  port_lock_from_isr();
+  if (--ch.kernel_stats.isr_nesting == (cnt_t)0) {
+    rtcnt_t t = chSysGetRealtimeCounterX() - ch.kernel_stats.isr_start;
+
+    ch.kernel_stats.isr_cumulative += (rttime_t)t;
+    ch.kernel_stats.isr_pending += t;
+  }
+  port_unlock_from_isr();
+}
+
+/**
+ * @brief   Charges the current thread with its run time.
+ * @details The run time of the current thread is brought up to date, it
+ *          is normally updated on context switch only.
+ * @note    It is invoked from within a kernel critical zone.
+ */
+void _stats_update_runtime(void) {
+
+  stats_charge_runtime(currp);
+}
+
+/**
+ * @brief   Increases the saved timer alarms counter.
+ * @note    It is invoked from within a kernel critical zone.
+ */
+void _stats_increase_vtsaved(void) {
+
+  ch.kernel_stats.n_vtsaved++;
+}
+
 /**
  * @brief   Updates context switch related statistics.
  *
@@ -87,6 +169,7 @@ void _stats_ctxswc(thread_t *ntp, thread_t *otp) {
 
   ch.kernel_stats.n_ctxswc++;
   chTMChainMeasurementToX(&otp->stats, &ntp->stats);
+  stats_charge_runtime(otp);
 }
 
 /**
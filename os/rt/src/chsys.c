@@ -43,13 +43,40 @@
 /**
  * @brief   Idle thread working area.
  */
-THD_WORKING_AREA(ch_idle_thread_wa, PORT_IDLE_THREAD_STACK_SIZE);
+CH_FASTDATA THD_WORKING_AREA(ch_idle_thread_wa, PORT_IDLE_THREAD_STACK_SIZE);
 #endif
 
 /*===========================================================================*/
 /* Module local types.                                                       */
 /*===========================================================================*/
 
+#if (CH_CFG_CACHE_LAYOUT == TRUE) || defined(__DOXYGEN__)
+/*
+ * Compile-time checks of the cache lines aware layout, a negative array
+ * size is an error.
+ */
+#define CH_CACHE_LINE_CHECK(name, cond)                                     \
+  typedef char name[(cond) ? 1 : -1]
+
+/* Thread state within the first line, the fields following it depend
+   on the configuration.*/
+CH_CACHE_LINE_CHECK(ch_check_thread_size,
+                    (sizeof (thread_t) % PORT_CACHE_LINE_SIZE) == 0U);
+CH_CACHE_LINE_CHECK(ch_check_thread_state,
+                    offsetof(thread_t, state) < PORT_CACHE_LINE_SIZE);
+
+/* System data areas starting on a line.*/
+CH_CACHE_LINE_CHECK(ch_check_rlist,
+                    (offsetof(ch_system_t, rlist) %
+                     PORT_CACHE_LINE_SIZE) == 0U);
+CH_CACHE_LINE_CHECK(ch_check_vtlist,
+                    (offsetof(ch_system_t, vtlist) %
+                     PORT_CACHE_LINE_SIZE) == 0U);
+CH_CACHE_LINE_CHECK(ch_check_dbg,
+                    (offsetof(ch_system_t, dbg) %
+                     PORT_CACHE_LINE_SIZE) == 0U);
+#endif
+
 /*===========================================================================*/
 /* Module local variables.                                                   */
 /*===========================================================================*/
@@ -73,6 +100,11 @@ static void _idle_thread(void *p) {
 
   (void)p;
 
+#if (CH_CFG_USE_THREADS_TABLE == TRUE) && (CH_DBG_FILL_THREADS == TRUE)
+  /* Deferred stacks fill of the static threads table.*/
+  _thread_table_fill();
+#endif
+
   while (true) {
     /*lint -save -e522 [2.2] Apparently no side effects because it contains
       an asm instruction.*/
@@ -83,6 +115,236 @@ static void _idle_thread(void *p) {
 }
 #endif /* CH_CFG_NO_IDLE_THREAD == FALSE */
 
+/**
+ * @brief   Moves an incremental integrity check to the next enabled check.
+ *
+ * @param[in] icp       pointer to an @p integrity_check_t structure
+ */
+static void integrity_next(integrity_check_t *icp) {
+  unsigned mask = icp->current;
+
+  do {
+    mask <<= 1;
+    if (mask > CH_INTEGRITY_PORT) {
+      mask = CH_INTEGRITY_RLIST;
+      icp->passes++;
+    }
+  } while ((icp->testmask & mask) == 0U);
+
+  icp->current = mask;
+  icp->cursor  = NULL;
+#if CH_CFG_VT_WHEEL == TRUE
+  icp->slot    = 0U;
+#endif
+}
+
+/**
+ * @brief   Incremental ready list check.
+ *
+ * @param[in] icp       pointer to an @p integrity_check_t structure
+ * @param[in,out] np    pointer to the remaining elements budget
+ * @return              The test result.
+ */
+static bool integrity_rlist(integrity_check_t *icp, unsigned *np) {
+  thread_t *tp = (thread_t *)icp->cursor;
+
+  /* If the cursor thread left the ready list then the scan is restarted
+     from the list header.*/
+  if ((tp == NULL) || (tp->state != CH_STATE_READY)) {
+    tp = (thread_t *)&ch.rlist.queue;
+  }
+
+  while (*np > 0U) {
+    thread_t *ntp = tp->queue.next;
+
+    (*np)--;
+
+    /* Links must be consistent in both directions.*/
+    if (ntp->queue.prev != tp) {
+      return true;
+    }
+
+    if (ntp == (thread_t *)&ch.rlist.queue) {
+      integrity_next(icp);
+      return false;
+    }
+
+    /* Only ready threads can be in the ready list.*/
+    if (ntp->state != CH_STATE_READY) {
+      return true;
+    }
+
+#if CH_CFG_READY_LIST_BITMAP == TRUE
+    /* The last thread of each level must be indexed in the bitmap.*/
+    if ((ntp->queue.next == (thread_t *)&ch.rlist.queue) ||
+        (ntp->queue.next->rdyprio != ntp->rdyprio)) {
+      if ((ch.rlist.tails[ntp->rdyprio] != ntp) ||
+          ((ch.rlist.bitmap[(unsigned)ntp->rdyprio >> 5] &
+            (0x80000000U >> ((unsigned)ntp->rdyprio & 31U))) == 0U)) {
+        return true;
+      }
+    }
+#endif
+
+    tp = ntp;
+    icp->cursor = (void *)tp;
+  }
+
+  return false;
+}
+
+#if (CH_CFG_VT_WHEEL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Checks if a timers list element is a wheel slot header.
+ *
+ * @param[in] vtp       pointer to the list element
+ * @return              The check result.
+ */
+static bool integrity_is_slot(const virtual_timer_t *vtp) {
+  const vt_slot_t *p = (const vt_slot_t *)(const void *)vtp;
+
+  return (p >= &ch.vtlist.slots[0][0]) &&
+         (p < &ch.vtlist.slots[0][0] +
+              ((unsigned)CH_CFG_VT_WHEEL_LEVELS * CH_VT_WHEEL_SLOTS));
+}
+
+/**
+ * @brief   Incremental timers wheel check.
+ *
+ * @param[in] icp       pointer to an @p integrity_check_t structure
+ * @param[in,out] np    pointer to the remaining elements budget
+ * @return              The test result.
+ */
+static bool integrity_vtlist(integrity_check_t *icp, unsigned *np) {
+  unsigned k = icp->slot / CH_VT_WHEEL_SLOTS;
+  unsigned i = icp->slot % CH_VT_WHEEL_SLOTS;
+  virtual_timer_t *shp = (virtual_timer_t *)&ch.vtlist.slots[k][i];
+  virtual_timer_t *vtp = (virtual_timer_t *)icp->cursor;
+
+  /* If the cursor timer is no more armed then the slot scan is restarted
+     from the slot header.*/
+  if ((vtp == NULL) || (vtp->func == NULL)) {
+    vtp = shp;
+
+    /* The slot must be marked in the bitmap if not empty.*/
+    if ((shp->next != shp) !=
+        ((ch.vtlist.bitmap[k] & ((uint32_t)1U << i)) != 0U)) {
+      return true;
+    }
+  }
+
+  while (*np > 0U) {
+    virtual_timer_t *nvtp = vtp->next;
+
+    (*np)--;
+
+    /* Links must be consistent in both directions.*/
+    if (nvtp->prev != vtp) {
+      return true;
+    }
+
+    /* The cursor timer could have been moved to another slot, the header
+       closing the scan is not necessarily the one of the current slot.*/
+    if (integrity_is_slot(nvtp)) {
+      icp->slot++;
+      icp->cursor = NULL;
+      if (icp->slot >= ((unsigned)CH_CFG_VT_WHEEL_LEVELS * CH_VT_WHEEL_SLOTS)) {
+        integrity_next(icp);
+      }
+      return false;
+    }
+
+    /* Only armed timers can be in the list.*/
+    if (nvtp->func == NULL) {
+      return true;
+    }
+
+    vtp = nvtp;
+    icp->cursor = (void *)vtp;
+  }
+
+  return false;
+}
+#else /* CH_CFG_VT_WHEEL == FALSE */
+static bool integrity_vtlist(integrity_check_t *icp, unsigned *np) {
+  virtual_timer_t *vtp = (virtual_timer_t *)icp->cursor;
+
+  /* If the cursor timer is no more armed then the scan is restarted
+     from the list header.*/
+  if ((vtp == NULL) || (vtp->func == NULL)) {
+    vtp = (virtual_timer_t *)&ch.vtlist;
+  }
+
+  while (*np > 0U) {
+    virtual_timer_t *nvtp = vtp->next;
+
+    (*np)--;
+
+    /* Links must be consistent in both directions.*/
+    if (nvtp->prev != vtp) {
+      return true;
+    }
+
+    if (nvtp == (virtual_timer_t *)&ch.vtlist) {
+      integrity_next(icp);
+      return false;
+    }
+
+    /* Only armed timers can be in the list.*/
+    if (nvtp->func == NULL) {
+      return true;
+    }
+
+    vtp = nvtp;
+    icp->cursor = (void *)vtp;
+  }
+
+  return false;
+}
+#endif /* CH_CFG_VT_WHEEL == FALSE */
+
+#if (CH_CFG_USE_REGISTRY == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Incremental registry check.
+ *
+ * @param[in] icp       pointer to an @p integrity_check_t structure
+ * @param[in,out] np    pointer to the remaining elements budget
+ * @return              The test result.
+ */
+static bool integrity_registry(integrity_check_t *icp, unsigned *np) {
+  thread_t *tp = (thread_t *)icp->cursor;
+
+  /* If threads have been created or removed since the cursor has been
+     taken then the scan is restarted from the registry header.*/
+  if ((tp == NULL) || (icp->regseq != ch.rlist.regseq)) {
+    tp = (thread_t *)&ch.rlist;
+    icp->cursor = NULL;
+    icp->regseq = ch.rlist.regseq;
+  }
+
+  while (*np > 0U) {
+    thread_t *ntp = tp->newer;
+
+    (*np)--;
+
+    /* Links must be consistent in both directions.*/
+    if (ntp->older != tp) {
+      return true;
+    }
+
+    if (ntp == (thread_t *)&ch.rlist) {
+      integrity_next(icp);
+      return false;
+    }
+
+    tp = ntp;
+    icp->cursor = (void *)tp;
+  }
+
+  return false;
+}
+#endif /* CH_CFG_USE_REGISTRY == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -122,6 +384,9 @@ void chSysInit(void) {
 #if CH_DBG_STATISTICS == TRUE
   _stats_init();
 #endif
+#if CH_DBG_WAIT_PROFILE == TRUE
+  _wprof_init();
+#endif
 
 #if CH_CFG_NO_IDLE_THREAD == FALSE
   /* Now this instructions flow becomes the main thread.*/
@@ -156,6 +421,7 @@ void chSysInit(void) {
 #if CH_DBG_STATISTICS == TRUE
   /* Starting measurement for this thread.*/
   chTMStartMeasurementX(&currp->stats);
+  ch.kernel_stats.lastswc = chSysGetRealtimeCounterX();
 #endif
 
   /* Initialization hook.*/
@@ -164,6 +430,11 @@ void chSysInit(void) {
   /* It is alive now.*/
   chSysEnable();
 
+#if CH_CFG_USE_TIMESTAMP == TRUE
+  /* Time stamps extension timer.*/
+  _vt_stamp_init();
+#endif
+
 #if CH_CFG_NO_IDLE_THREAD == FALSE
   {
     static const thread_descriptor_t idle_descriptor = {
@@ -181,6 +452,11 @@ void chSysInit(void) {
     (void) chThdCreate(&idle_descriptor);
   }
 #endif
+
+#if CH_CFG_USE_THREADS_TABLE == TRUE
+  /* Threads of the static threads table.*/
+  _thread_table_create();
+#endif
 }
 
 /**
@@ -265,10 +541,58 @@ bool chSysIntegrityCheckI(unsigned testmask) {
     if (n != (cnt_t)0) {
       return true;
     }
+
+#if CH_CFG_READY_LIST_BITMAP == TRUE
+    /* The last thread of each level must be indexed in the bitmap.*/
+    tp = ch.rlist.queue.next;
+    while (tp != (thread_t *)&ch.rlist.queue) {
+      if ((tp->queue.next == (thread_t *)&ch.rlist.queue) ||
+          (tp->queue.next->rdyprio != tp->rdyprio)) {
+        if ((ch.rlist.tails[tp->rdyprio] != tp) ||
+            ((ch.rlist.bitmap[(unsigned)tp->rdyprio >> 5] &
+              (0x80000000U >> ((unsigned)tp->rdyprio & 31U))) == 0U)) {
+          return true;
+        }
+      }
+      tp = tp->queue.next;
+    }
+#endif
   }
 
   /* Timers list integrity check.*/
   if ((testmask & CH_INTEGRITY_VTLIST) != 0U) {
+#if CH_CFG_VT_WHEEL == TRUE
+    unsigned k, i;
+
+    /* Scanning all the wheel slots.*/
+    for (k = 0U; k < (unsigned)CH_CFG_VT_WHEEL_LEVELS; k++) {
+      for (i = 0U; i < CH_VT_WHEEL_SLOTS; i++) {
+        virtual_timer_t *shp = (virtual_timer_t *)&ch.vtlist.slots[k][i];
+        virtual_timer_t *vtp;
+
+        /* Scanning the slot forward and backward.*/
+        n = (cnt_t)0;
+        vtp = shp->next;
+        while (vtp != shp) {
+          n++;
+          vtp = vtp->next;
+        }
+        vtp = shp->prev;
+        while (vtp != shp) {
+          n--;
+          vtp = vtp->prev;
+        }
+
+        /* The number of elements must match and the slot must be
+           marked in the bitmap if not empty.*/
+        if ((n != (cnt_t)0) ||
+            ((shp->next != shp) !=
+             ((ch.vtlist.bitmap[k] & ((uint32_t)1U << i)) != 0U))) {
+          return true;
+        }
+      }
+    }
+#else
     virtual_timer_t * vtp;
 
     /* Scanning the timers list forward.*/
@@ -290,6 +614,7 @@ bool chSysIntegrityCheckI(unsigned testmask) {
     if (n != (cnt_t)0) {
       return true;
     }
+#endif
   }
 
 #if CH_CFG_USE_REGISTRY == TRUE
@@ -327,6 +652,96 @@ bool chSysIntegrityCheckI(unsigned testmask) {
   return false;
 }
 
+/**
+ * @brief   Initializes an incremental integrity check.
+ *
+ * @param[out] icp      pointer to an @p integrity_check_t structure
+ * @param[in] testmask  Each bit in this mask is associated to a test to be
+ *                      performed, at least one test must be enabled.
+ *
+ * @init
+ */
+void chSysIntegrityObjectInit(integrity_check_t *icp, unsigned testmask) {
+
+  chDbgCheck((icp != NULL) &&
+             ((testmask & (CH_INTEGRITY_RLIST | CH_INTEGRITY_VTLIST |
+                           CH_INTEGRITY_REGISTRY | CH_INTEGRITY_PORT)) != 0U));
+
+  icp->testmask = testmask;
+  icp->current  = CH_INTEGRITY_PORT;
+  icp->passes   = (ucnt_t)0;
+#if CH_CFG_USE_REGISTRY == TRUE
+  icp->regseq   = (ucnt_t)0;
+#endif
+  integrity_next(icp);
+
+  /* The initial wrap is not a completed pass.*/
+  icp->passes   = (ucnt_t)0;
+}
+
+/**
+ * @brief   Incremental system integrity check.
+ * @details Performs the same checks of @p chSysIntegrityCheckI() but it
+ *          visits at most @p n list elements on each invocation, the scan
+ *          is resumed from where the previous step left it. The critical
+ *          zone can be released between steps so the function is suitable
+ *          for continuous background checking, for example from
+ *          @p CH_CFG_IDLE_LOOP_HOOK or from a low priority thread.
+ * @note    Elements are checked against their neighbours only, if the list
+ *          changed since the previous step then the scan is restarted from
+ *          the list header, this is not considered a failure. Lists under
+ *          heavy churn could be checked partially in a pass.
+ * @note    The port check, if enabled, is always performed as one step.
+ * @note    Completed passes are counted in the @p passes field of the
+ *          state structure.
+ *
+ * @param[in] icp       pointer to an @p integrity_check_t structure
+ * @param[in] n         maximum number of list elements to be checked
+ * @return              The test result.
+ * @retval false        The test succeeded.
+ * @retval true         Test failed.
+ *
+ * @iclass
+ */
+bool chSysIntegrityStepI(integrity_check_t *icp, unsigned n) {
+
+  chDbgCheckClassI();
+  chDbgCheck((icp != NULL) && (n > 0U));
+
+  while (n > 0U) {
+    switch (icp->current) {
+    case CH_INTEGRITY_RLIST:
+      if (integrity_rlist(icp, &n)) {
+        return true;
+      }
+      break;
+    case CH_INTEGRITY_VTLIST:
+      if (integrity_vtlist(icp, &n)) {
+        return true;
+      }
+      break;
+#if CH_CFG_USE_REGISTRY == TRUE
+    case CH_INTEGRITY_REGISTRY:
+      if (integrity_registry(icp, &n)) {
+        return true;
+      }
+      break;
+#endif
+    default:
+#if defined(PORT_INTEGRITY_CHECK)
+      if (icp->current == CH_INTEGRITY_PORT) {
+        PORT_INTEGRITY_CHECK();
+      }
+#endif
+      n--;
+      integrity_next(icp);
+      break;
+    }
+  }
+
+  return false;
+}
+
 /**
  * @brief   Handles time ticks for round robin preemption and timer increments.
  * @details Decrements the remaining time quantum of the running thread
@@ -338,7 +753,7 @@ bool chSysIntegrityCheckI(unsigned testmask) {
  *
  * @iclass
  */
-void chSysTimerHandlerI(void) {
+CH_HOTPATH void chSysTimerHandlerI(void) {
 
   chDbgCheckClassI();
 
@@ -349,6 +764,12 @@ void chSysTimerHandlerI(void) {
     currp->ticks--;
   }
 #endif
+#if CH_CFG_USE_BUDGET == TRUE
+  /* Running thread budget accounting.*/
+  if (currp->budgetp != NULL) {
+    _thread_budget_tick(currp);
+  }
+#endif
 #if CH_DBG_THREADS_PROFILING == TRUE
   currp->time++;
 #endif
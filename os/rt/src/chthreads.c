@@ -54,6 +54,11 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+/**
+ * @brief   Size of the stack area filled per critical zone.
+ */
+#define THD_TABLE_FILL_CHUNK                64U
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -66,10 +71,121 @@
 /* Module local variables.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_THREAD_SPECIFIC_KEYS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Next thread specific data key.
+ */
+static thdkey_t nextkey = (thdkey_t)0;
+#endif
+
 /*===========================================================================*/
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_BUDGET == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Changes the own priority of a thread.
+ * @details A priority boosted by the priority inheritance mechanism is
+ *          not lowered, a ready thread is re-enqueued with its new
+ *          priority.
+ * @note    Threads waiting on priority ordered queues keep their position
+ *          until they are enqueued again.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] prio      the new priority level
+ *
+ * @notapi
+ */
+static void thd_set_own_prio(thread_t *tp, tprio_t prio) {
+
+#if CH_CFG_USE_MUTEXES == TRUE
+  if ((tp->prio != tp->realprio) && (prio < tp->prio)) {
+    tp->realprio = prio;
+    return;
+  }
+  tp->realprio = prio;
+#endif
+  tp->prio = prio;
+
+  if (tp->state == CH_STATE_READY) {
+    /* Re-enqueues tp with its new priority on the ready list.*/
+    (void) chSchRequeueReadyI(tp);
+  }
+}
+
+/**
+ * @brief   Budget replenishment timer callback.
+ *
+ * @param[in] p         pointer to the @p thread_budget_t object
+ *
+ * @notapi
+ */
+static void thd_budget_replenish(void *p) {
+  thread_budget_t *bp = (thread_budget_t *)p;
+
+  chSysLockFromISR();
+
+  /* A demoted thread is restored to its priority, the preemption, if
+     required, is performed on ISR exit.*/
+  if (bp->remaining == (sysinterval_t)0) {
+    thd_set_own_prio(bp->tp, bp->prio);
+  }
+  bp->remaining = bp->budget;
+  chVTDoSetI(&bp->vt, bp->period, thd_budget_replenish, p);
+
+  chSysUnlockFromISR();
+}
+#endif /* CH_CFG_USE_BUDGET == TRUE */
+
+#if (CH_CFG_USE_PERIODIC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Periodic thread release timer callback.
+ * @details The next release is computed from the schedule and not from
+ *          the callback time so there is no drift. A release happening
+ *          while the thread is not waiting is accounted as missed.
+ *
+ * @param[in] p         pointer to the @p periodic_thread_t object
+ *
+ * @notapi
+ */
+static void thd_periodic_release(void *p) {
+  periodic_thread_t *ptp = (periodic_thread_t *)p;
+  sysinterval_t delay;
+
+  chSysLockFromISR();
+
+  ptp->next = chTimeAddX(ptp->next, ptp->period);
+#if CH_CFG_USE_TIMESTAMP == TRUE
+  ptp->stamp += (systimestamp_t)ptp->period;
+#endif
+#if CH_CFG_EDF_PRIO > 0
+  /* The deadline of the activation is the next release.*/
+  ptp->tp->deadline = ptp->next;
+#endif
+
+  if (ptp->trp != NULL) {
+#if CH_CFG_USE_TM == TRUE
+    chTMStartMeasurementX(&ptp->jitter);
+#endif
+    chThdResumeI(&ptp->trp, MSG_OK);
+  }
+  else {
+    ptp->overruns++;
+    ptp->missed = true;
+  }
+
+  /* If the callback is late by more than a period then the timer is
+     triggered as soon as possible.*/
+  delay = chTimeDiffX(chVTGetSystemTimeX(), ptp->next);
+  if ((delay == (sysinterval_t)0) || (delay > ptp->period)) {
+    delay = (sysinterval_t)1;
+  }
+  chVTDoSetI(&ptp->vt, delay, thd_periodic_release, p);
+
+  chSysUnlockFromISR();
+}
+#endif /* CH_CFG_USE_PERIODIC == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -92,6 +208,10 @@ thread_t *_thread_init(thread_t *tp, const char *name, tprio_t prio) {
   tp->flags     = CH_FLAG_MODE_STATIC;
 #if CH_CFG_TIME_QUANTUM > 0
   tp->ticks     = (tslices_t)CH_CFG_TIME_QUANTUM;
+  tp->quantum   = (tslices_t)CH_CFG_TIME_QUANTUM;
+#endif
+#if CH_CFG_EDF_PRIO > 0
+  tp->deadline  = chVTGetSystemTimeX();
 #endif
 #if CH_CFG_USE_MUTEXES == TRUE
   tp->realprio  = prio;
@@ -100,6 +220,18 @@ thread_t *_thread_init(thread_t *tp, const char *name, tprio_t prio) {
 #if CH_CFG_USE_EVENTS == TRUE
   tp->epending  = (eventmask_t)0;
 #endif
+#if CH_CFG_USE_SCHED_BATCH == TRUE
+  tp->batch     = (uint8_t)0;
+#endif
+#if CH_CFG_USE_BUDGET == TRUE
+  tp->budgetp   = NULL;
+#endif
+#if CH_CFG_QUEUE_BUCKETS == TRUE
+  tp->qbpos     = CH_QBUCKET_NONE;
+#endif
+#if CH_CFG_USE_PERIODIC == TRUE
+  tp->periodicp = NULL;
+#endif
 #if CH_DBG_THREADS_PROFILING == TRUE
   tp->time      = (systime_t)0;
 #endif
@@ -118,6 +250,21 @@ thread_t *_thread_init(thread_t *tp, const char *name, tprio_t prio) {
 #endif
 #if CH_DBG_STATISTICS == TRUE
   chTMObjectInit(&tp->stats);
+  tp->runtime = (rttime_t)0;
+  tp->loadmark = (rttime_t)0;
+  tp->load = (uint8_t)0;
+#endif
+#if CH_DBG_WAIT_PROFILE == TRUE
+  tp->wpstate = CH_STATE_READY;
+#endif
+#if CH_CFG_THREAD_SPECIFIC_KEYS > 0
+  {
+    unsigned i;
+
+    for (i = 0U; i < (unsigned)CH_CFG_THREAD_SPECIFIC_KEYS; i++) {
+      tp->specific[i] = NULL;
+    }
+  }
 #endif
   CH_CFG_THREAD_INIT_HOOK(tp);
   return tp;
@@ -141,6 +288,67 @@ void _thread_memfill(uint8_t *startp, uint8_t *endp, uint8_t v) {
 }
 #endif /* CH_DBG_FILL_THREADS */
 
+#if (CH_CFG_USE_THREADS_TABLE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Creates the threads of the static threads table.
+ * @details All the threads are created and made ready within a single
+ *          critical zone, a single reschedule is performed at the end.
+ * @note    The working areas are not filled on creation, see
+ *          @p _thread_table_fill().
+ *
+ * @notapi
+ */
+void _thread_table_create(void) {
+  const thread_descriptor_t *tdp;
+
+  chSysLock();
+  for (tdp = &ch_threads_table[0]; tdp->funcp != NULL; tdp++) {
+    (void) chSchReadyI(chThdCreateSuspendedI(tdp));
+  }
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+#if (CH_DBG_FILL_THREADS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Fills the unused stacks of the static threads table.
+ * @details The part of each stack below the saved context is filled in
+ *          small chunks, the thread cannot run while a chunk is filled so
+ *          the area in use is never touched.
+ * @note    This function is invoked by the idle thread, the table threads
+ *          are not supposed to terminate and have their working areas
+ *          reused.
+ *
+ * @notapi
+ */
+void _thread_table_fill(void) {
+  const thread_descriptor_t *tdp;
+
+  for (tdp = &ch_threads_table[0]; tdp->funcp != NULL; tdp++) {
+    thread_t *tp = (thread_t *)((uint8_t *)tdp->wend -
+                                MEM_ALIGN_NEXT(sizeof (thread_t),
+                                               PORT_STACK_ALIGN));
+    uint8_t *p = (uint8_t *)tdp->wbase;
+    uint8_t *limit;
+
+    do {
+      uint8_t *endp;
+
+      chSysLock();
+      limit = (uint8_t *)tp->ctx.sp;
+      endp  = p + THD_TABLE_FILL_CHUNK;
+      if (endp > limit) {
+        endp = limit;
+      }
+      _thread_memfill(p, endp, CH_DBG_STACK_FILL_VALUE);
+      chSysUnlock();
+      p = endp;
+    } while (p < limit);
+  }
+}
+#endif /* CH_DBG_FILL_THREADS == TRUE */
+#endif /* CH_CFG_USE_THREADS_TABLE == TRUE */
+
 /**
  * @brief   Creates a new thread into a static memory area.
  * @details The new thread is initialized but not inserted in the ready list,
@@ -170,7 +378,7 @@ thread_t *chThdCreateSuspendedI(const thread_descriptor_t *tdp) {
   chDbgCheckClassI();
   chDbgCheck(tdp != NULL);
   chDbgCheck(MEM_IS_ALIGNED(tdp->wbase, PORT_WORKING_AREA_ALIGN) &&
-             MEM_IS_ALIGNED(tdp->wend, PORT_STACK_ALIGN) &&
+             MEM_IS_ALIGNED(tdp->wend, THD_WORKING_AREA_END_ALIGN) &&
              (tdp->wend > tdp->wbase) &&
              (((size_t)tdp->wend - (size_t)tdp->wbase) >= THD_WORKING_AREA_SIZE(0)));
   chDbgCheck((tdp->prio <= HIGHPRIO) && (tdp->funcp != NULL));
@@ -327,7 +535,7 @@ thread_t *chThdCreateStatic(void *wsp, size_t size,
   chDbgCheck((wsp != NULL) &&
              MEM_IS_ALIGNED(wsp, PORT_WORKING_AREA_ALIGN) &&
              (size >= THD_WORKING_AREA_SIZE(0)) &&
-             MEM_IS_ALIGNED(size, PORT_STACK_ALIGN) &&
+             MEM_IS_ALIGNED(size, THD_WORKING_AREA_END_ALIGN) &&
              (prio <= HIGHPRIO) && (pf != NULL));
 
 #if (CH_CFG_USE_REGISTRY == TRUE) &&                                        \
@@ -448,6 +656,11 @@ void chThdRelease(thread_t *tp) {
     case CH_FLAG_MODE_MPOOL:
       chPoolFree(tp->mpool, chThdGetWorkingAreaX(tp));
       break;
+#endif
+#if CH_CFG_USE_THREAD_CACHE == TRUE
+    case CH_FLAG_MODE_CACHE:
+      _thread_cache_free(tp);
+      break;
 #endif
     default:
       /* Nothing else to do for static threads.*/
@@ -507,6 +720,22 @@ void chThdExitS(msg_t msg) {
   /* Exit handler hook.*/
   CH_CFG_THREAD_EXIT_HOOK(tp);
 
+#if CH_CFG_USE_BUDGET == TRUE
+  /* The budget object could be in the thread working area.*/
+  if (tp->budgetp != NULL) {
+    chVTDoResetI(&tp->budgetp->vt);
+    tp->budgetp = NULL;
+  }
+#endif
+
+#if CH_CFG_USE_PERIODIC == TRUE
+  /* Stopping the release schedule.*/
+  if (tp->periodicp != NULL) {
+    chVTDoResetI(&tp->periodicp->vt);
+    tp->periodicp = NULL;
+  }
+#endif
+
 #if CH_CFG_USE_WAITEXIT == TRUE
   /* Waking up any waiting thread.*/
   while (list_notempty(&tp->waiting)) {
@@ -601,6 +830,9 @@ tprio_t chThdSetPriority(tprio_t newprio) {
   chDbgCheck(newprio <= HIGHPRIO);
 
   chSysLock();
+#if CH_CFG_USE_BUDGET == TRUE
+  chDbgAssert(currp->budgetp == NULL, "budgeted thread");
+#endif
 #if CH_CFG_USE_MUTEXES == TRUE
   oldprio = currp->realprio;
   if ((currp->prio == currp->realprio) || (newprio > currp->prio)) {
@@ -617,6 +849,122 @@ tprio_t chThdSetPriority(tprio_t newprio) {
   return oldprio;
 }
 
+#if (CH_CFG_TIME_QUANTUM > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Changes the running thread time quantum.
+ * @details Threads at the same priority level are served in round robin,
+ *          each one for its own time quantum.
+ * @note    The new quantum is used starting from the next time slice, the
+ *          current one is not affected.
+ *
+ * @param[in] quantum   the new time quantum in system ticks
+ * @return              The old time quantum.
+ *
+ * @api
+ */
+tslices_t chThdSetQuantum(tslices_t quantum) {
+  tslices_t oldquantum;
+
+  chDbgCheck(quantum > (tslices_t)0);
+
+  chSysLock();
+  oldquantum = currp->quantum;
+  currp->quantum = quantum;
+  chSysUnlock();
+
+  return oldquantum;
+}
+#endif /* CH_CFG_TIME_QUANTUM > 0 */
+
+#if (CH_CFG_USE_BUDGET == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Accounts a system tick to a budgeted thread.
+ * @details The thread is demoted to its background priority when the
+ *          budget is used up.
+ * @note    This is an internal functions, do not use it in application code.
+ *
+ * @param[in] tp        pointer to the running thread
+ *
+ * @notapi
+ */
+void _thread_budget_tick(thread_t *tp) {
+  thread_budget_t *bp = tp->budgetp;
+
+  if (bp->remaining > (sysinterval_t)0) {
+    bp->remaining--;
+    if (bp->remaining == (sysinterval_t)0) {
+      thd_set_own_prio(tp, bp->lowprio);
+    }
+  }
+}
+
+/**
+ * @brief   Assigns an execution budget to the running thread.
+ * @details The thread can run at its current priority for @p budget ticks
+ *          in each @p period, when the budget is used up the thread is
+ *          demoted to @p lowprio until the next replenishment.
+ * @pre     The thread must not change priority while a budget is
+ *          assigned.
+ * @note    The budget is accounted on system ticks, the thread running
+ *          when a tick occurs is charged for the whole tick.
+ *
+ * @param[out] bp       pointer to a @p thread_budget_t object, it must
+ *                      remain valid until the budget is cleared or the
+ *                      thread terminates
+ * @param[in] budget    execution budget in system ticks
+ * @param[in] period    replenishment period in system ticks, it must be
+ *                      greater than @p budget
+ * @param[in] lowprio   priority level after the budget is used up, it
+ *                      must be lower than the current priority
+ *
+ * @api
+ */
+void chThdSetBudget(thread_budget_t *bp, sysinterval_t budget,
+                    sysinterval_t period, tprio_t lowprio) {
+
+  chDbgCheck((bp != NULL) && (budget > (sysinterval_t)0) &&
+             (period > budget) && (period != TIME_INFINITE));
+
+  chSysLock();
+  chDbgAssert(currp->budgetp == NULL, "budget already assigned");
+#if CH_CFG_USE_MUTEXES == TRUE
+  chDbgAssert(lowprio < currp->realprio, "invalid priority");
+  bp->prio      = currp->realprio;
+#else
+  chDbgAssert(lowprio < currp->prio, "invalid priority");
+  bp->prio      = currp->prio;
+#endif
+  bp->tp        = currp;
+  bp->budget    = budget;
+  bp->period    = period;
+  bp->remaining = budget;
+  bp->lowprio   = lowprio;
+  currp->budgetp = bp;
+  chVTDoSetI(&bp->vt, period, thd_budget_replenish, (void *)bp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Removes the execution budget from the running thread.
+ * @details The thread is restored to its priority if demoted.
+ *
+ * @api
+ */
+void chThdClearBudget(void) {
+  thread_budget_t *bp;
+
+  chSysLock();
+  bp = currp->budgetp;
+  chDbgAssert(bp != NULL, "no budget");
+  chVTDoResetI(&bp->vt);
+  if (bp->remaining == (sysinterval_t)0) {
+    thd_set_own_prio(currp, bp->prio);
+  }
+  currp->budgetp = NULL;
+  chSysUnlock();
+}
+#endif /* CH_CFG_USE_BUDGET == TRUE */
+
 /**
  * @brief   Requests a thread termination.
  * @pre     The target thread must be written to invoke periodically
@@ -655,6 +1003,30 @@ void chThdSleep(sysinterval_t time) {
   chSysUnlock();
 }
 
+/**
+ * @brief   Suspends the invoking thread for a tolerant time.
+ * @details The thread is awakened after a time between @p time and
+ *          @p time + @p slack, in tick-less mode the kernel can merge the
+ *          wakeup with other timers deadlines falling within the tolerance
+ *          in order to save alarm interrupts.
+ *
+ * @param[in] time      the minimum delay in system ticks, the special values
+ *                      are handled as follow:
+ *                      - @a TIME_INFINITE the thread enters an infinite sleep
+ *                        state.
+ *                      - @a TIME_IMMEDIATE this value is not allowed.
+ *                      .
+ * @param[in] slack     the number of ticks the wakeup can be postponed
+ *
+ * @api
+ */
+void chThdSleepWithSlack(sysinterval_t time, sysinterval_t slack) {
+
+  chSysLock();
+  chThdSleepWithSlackS(time, slack);
+  chSysUnlock();
+}
+
 /**
  * @brief   Suspends the invoking thread until the system time arrives to the
  *          specified value.
@@ -679,6 +1051,37 @@ void chThdSleepUntil(systime_t time) {
   chSysUnlock();
 }
 
+#if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Suspends the invoking thread until the time stamp arrives to the
+ *          specified value.
+ * @details Unlike @p chThdSleepUntil() there is no wrap ambiguity, if the
+ *          specified time stamp is in the past then the function returns
+ *          immediately. Deadlines farther than the maximum interval are
+ *          reached with multiple sleeps.
+ *
+ * @param[in] stamp     absolute time stamp
+ *
+ * @api
+ */
+void chThdSleepUntilTimeStamp(systimestamp_t stamp) {
+  systimestamp_t now;
+
+  chSysLock();
+  now = chVTGetTimeStampI();
+  while (now < stamp) {
+    systimestamp_t delta = stamp - now;
+
+    if (delta > (systimestamp_t)TIME_MAX_INTERVAL) {
+      delta = (systimestamp_t)TIME_MAX_INTERVAL;
+    }
+    chThdSleepS((sysinterval_t)delta);
+    now = chVTGetTimeStampI();
+  }
+  chSysUnlock();
+}
+#endif /* CH_CFG_USE_TIMESTAMP == TRUE */
+
 /**
  * @brief   Suspends the invoking thread until the system time arrives to the
  *          specified value.
@@ -706,6 +1109,162 @@ systime_t chThdSleepUntilWindowed(systime_t prev, systime_t next) {
   return next;
 }
 
+#if (CH_CFG_USE_PERIODIC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Creates a periodic thread.
+ * @details The thread is started immediately, the following releases
+ *          happen every @p period ticks from the creation time. The
+ *          thread body invokes @p chThdWaitNextPeriod() at the end of
+ *          each activation.
+ * @note    If the thread is in the EDF priority band then the deadline
+ *          of each activation is the following release.
+ *
+ * @param[out] ptp      pointer to a @p periodic_thread_t object, it must
+ *                      remain valid while the thread is running
+ * @param[in] tdp       pointer to a thread descriptor
+ * @param[in] period    release period in system ticks
+ * @return              The pointer to the @p thread_t structure allocated for
+ *                      the thread.
+ *
+ * @api
+ */
+thread_t *chPeriodicThreadCreate(periodic_thread_t *ptp,
+                                 const thread_descriptor_t *tdp,
+                                 sysinterval_t period) {
+  thread_t *tp;
+
+  chDbgCheck((ptp != NULL) && (tdp != NULL) &&
+             (period != TIME_IMMEDIATE) && (period != TIME_INFINITE));
+
+#if CH_DBG_FILL_THREADS == TRUE
+  _thread_memfill((uint8_t *)tdp->wbase,
+                  (uint8_t *)tdp->wend,
+                  CH_DBG_STACK_FILL_VALUE);
+#endif
+
+  ptp->trp      = NULL;
+  ptp->period   = period;
+  ptp->overruns = (ucnt_t)0;
+  ptp->missed   = false;
+#if CH_CFG_USE_TM == TRUE
+  chTMObjectInit(&ptp->jitter);
+#endif
+
+  chSysLock();
+  tp = chThdCreateSuspendedI(tdp);
+  ptp->tp       = tp;
+#if CH_CFG_USE_TIMESTAMP == TRUE
+  /* The low bits of a fresh time stamp are the current system time.*/
+  ptp->stamp    = chVTGetTimeStampI() + (systimestamp_t)period;
+  ptp->next     = (systime_t)ptp->stamp;
+#else
+  ptp->next     = chTimeAddX(chVTGetSystemTimeX(), period);
+#endif
+  tp->periodicp = ptp;
+#if CH_CFG_EDF_PRIO > 0
+  tp->deadline  = ptp->next;
+#endif
+  chVTDoSetI(&ptp->vt, period, thd_periodic_release, (void *)ptp);
+  chSchWakeupS(tp, MSG_OK);
+  chSysUnlock();
+
+  return tp;
+}
+
+/**
+ * @brief   Waits for the next release of the invoking periodic thread.
+ * @details If a release has been missed since the previous invocation
+ *          then the function returns immediately, the thread is expected
+ *          to catch up and wait again, the following releases stay
+ *          aligned to the original schedule.
+ *
+ * @return              The release status.
+ * @retval MSG_OK       if the thread has been released on time.
+ * @retval MSG_TIMEOUT  if one or more releases have been missed.
+ *
+ * @api
+ */
+msg_t chThdWaitNextPeriod(void) {
+  periodic_thread_t *ptp = chThdGetSelfX()->periodicp;
+  msg_t msg;
+
+  chDbgAssert(ptp != NULL, "not a periodic thread");
+
+  chSysLock();
+  if (ptp->missed) {
+    ptp->missed = false;
+    msg = MSG_TIMEOUT;
+  }
+  else {
+    msg = chThdSuspendS(&ptp->trp);
+#if CH_CFG_USE_TM == TRUE
+    chTMStopMeasurementX(&ptp->jitter);
+#endif
+  }
+  chSysUnlock();
+
+  return msg;
+}
+#endif /* CH_CFG_USE_PERIODIC == TRUE */
+
+#if (CH_CFG_EDF_PRIO > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Changes the running thread absolute deadline.
+ * @details Threads at the @p CH_CFG_EDF_PRIO priority level are scheduled
+ *          in deadline order, the thread with the earliest deadline runs
+ *          first.
+ * @note    The deadline has no effect on threads at other priority levels.
+ *
+ * @param[in] deadline  absolute system time of the deadline
+ *
+ * @api
+ */
+void chThdSetDeadline(systime_t deadline) {
+
+  chSysLock();
+  currp->deadline = deadline;
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Suspends the invoking thread until the next release time.
+ * @details Periodic threads in the EDF band use this function in place of
+ *          @p chThdSleepUntilWindowed(), the thread is made ready at
+ *          @p next and competes with its peers using the specified
+ *          deadline.
+ * @note    The system time is assumed to be between @p prev and @p next
+ *          else the call is assumed to have been called outside the
+ *          allowed time interval, in this case no sleep is performed.
+ * @see     chThdSleepUntilWindowed()
+ *
+ * @param[in] prev      absolute system time of the previous release
+ * @param[in] next      absolute system time of the next release
+ * @param[in] deadline  absolute system time of the deadline of the next
+ *                      activation
+ * @return              the @p next parameter
+ *
+ * @api
+ */
+systime_t chThdSleepUntilRelease(systime_t prev, systime_t next,
+                                 systime_t deadline) {
+  systime_t time;
+
+  chSysLock();
+  currp->deadline = deadline;
+  time = chVTGetSystemTimeX();
+  if (chTimeIsInRangeX(time, prev, next)) {
+    chThdSleepS(chTimeDiffX(time, next));
+  }
+  else {
+    chSchRescheduleS();
+  }
+  chSysUnlock();
+
+  return next;
+}
+#endif /* CH_CFG_EDF_PRIO > 0 */
+
 /**
  * @brief   Yields the time slot.
  * @details Yields the CPU control to the next thread in the ready list with
@@ -868,6 +1427,10 @@ msg_t chThdEnqueueTimeoutS(threads_queue_t *tqp, sysinterval_t timeout) {
   }
 
   queue_insert(currp, tqp);
+#if CH_DBG_WAIT_PROFILE == TRUE
+  /* The queue is the wait object reported by the wait profiler.*/
+  currp->u.wtobjp = (void *)tqp;
+#endif
 
   return chSchGoSleepTimeoutS(CH_STATE_QUEUED, timeout);
 }
@@ -903,4 +1466,89 @@ void chThdDequeueAllI(threads_queue_t *tqp, msg_t msg) {
   }
 }
 
+#if ((CH_DBG_FILL_THREADS == TRUE) &&                                       \
+     ((CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE))) || \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Returns the never used stack space of the specified thread.
+ * @details The working area is scanned starting from its base, where the
+ *          stack limit is, until the first byte not matching the
+ *          @p CH_DBG_STACK_FILL_VALUE filler is found. The scan time is
+ *          proportional to the free space, not to the working area size,
+ *          and it is performed one machine word at time.
+ * @note    The working area must have been filled on creation, threads
+ *          created using @p chThdCreateSuspendedI() or @p chThdCreateI()
+ *          are not filled and the returned value is meaningless.
+ * @note    For the main thread the scan is bounded only by the first used
+ *          location of its stack.
+ *
+ * @param[in] tp        pointer to the thread
+ * @return              The high-water mark as number of never used bytes.
+ * @retval 0            if the working area base is not known.
+ *
+ * @xclass
+ */
+size_t chThdGetStackFreeX(thread_t *tp) {
+  const size_t pattern = ((size_t)-1 / (size_t)0xFFU) *
+                         (size_t)CH_DBG_STACK_FILL_VALUE;
+  const uint8_t *bp, *endp;
+
+  chDbgCheck(tp != NULL);
+
+  if (tp->wabase == NULL) {
+    return (size_t)0;
+  }
+
+  /* Threads created in a working area have the thread structure at the top
+     of it, this is the scan limit. The main thread structure is placed
+     elsewhere, the limit is implicitly the used part of its stack.*/
+  bp   = (const uint8_t *)tp->wabase;
+  endp = (const uint8_t *)tp;
+  if (endp <= bp) {
+    endp = NULL;
+  }
+
+  /* Word scan, the working area base is at least word-aligned.*/
+  while (((endp == NULL) || ((bp + sizeof (size_t)) <= endp)) &&
+         (*(const size_t *)bp == pattern)) {
+    bp += sizeof (size_t);
+  }
+
+  /* Byte scan of the partially used word.*/
+  while (((endp == NULL) || (bp < endp)) &&
+         (*bp == (uint8_t)CH_DBG_STACK_FILL_VALUE)) {
+    bp++;
+  }
+
+  return (size_t)(bp - (const uint8_t *)tp->wabase);
+}
+#endif /* CH_DBG_FILL_THREADS == TRUE */
+
+#if (CH_CFG_THREAD_SPECIFIC_KEYS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Allocates a thread specific data key.
+ * @details The key indexes a data slot of every thread, the slots of
+ *          all threads are initially @p NULL. Keys are meant to be
+ *          allocated by libraries during their initialization, there is
+ *          no way to release a key.
+ * @pre     The number of allocated keys must not exceed
+ *          @p CH_CFG_THREAD_SPECIFIC_KEYS.
+ *
+ * @return              The allocated key.
+ *
+ * @api
+ */
+thdkey_t chThdCreateKey(void) {
+  thdkey_t key;
+
+  chSysLock();
+  chDbgAssert(nextkey < (thdkey_t)CH_CFG_THREAD_SPECIFIC_KEYS,
+              "keys exhausted");
+  key = nextkey++;
+  chSysUnlock();
+
+  return key;
+}
+#endif /* CH_CFG_THREAD_SPECIFIC_KEYS > 0 */
+
 /** @} */
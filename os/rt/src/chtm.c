@@ -50,6 +50,31 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_TM_HISTOGRAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the histogram bucket of a measurement.
+ * @details The bucket is the number of significant bits of the value, it
+ *          is found by bisection in a constant number of steps.
+ *
+ * @param[in] v         measured value
+ * @return              The bucket index.
+ */
+static inline unsigned tm_bucket(rtcnt_t v) {
+  unsigned width = (unsigned)sizeof (rtcnt_t) * 4U;
+  unsigned bucket = 0U;
+
+  while (width > 0U) {
+    if ((v >> width) != (rtcnt_t)0) {
+      v >>= width;
+      bucket += width;
+    }
+    width >>= 1;
+  }
+
+  return bucket + (unsigned)v;
+}
+#endif
+
 static inline void tm_stop(time_measurement_t *tmp,
                            rtcnt_t now,
                            rtcnt_t offset) {
@@ -63,6 +88,11 @@ static inline void tm_stop(time_measurement_t *tmp,
   if (tmp->last < tmp->best) {
     tmp->best = tmp->last;
   }
+#if CH_CFG_USE_TM_HISTOGRAM == TRUE
+  if (tmp->histogram != NULL) {
+    tmp->histogram->buckets[tm_bucket(tmp->last)]++;
+  }
+#endif
 }
 
 /*===========================================================================*/
@@ -101,7 +131,87 @@ void chTMObjectInit(time_measurement_t *tmp) {
   tmp->last       = (rtcnt_t)0;
   tmp->n          = (ucnt_t)0;
   tmp->cumulative = (rttime_t)0;
+#if CH_CFG_USE_TM_HISTOGRAM == TRUE
+  tmp->histogram  = NULL;
+#endif
+}
+
+#if (CH_CFG_USE_TM_HISTOGRAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a @p TimeMeasurement object with an histogram.
+ * @details Each measurement is also counted in the log2-bucketed histogram
+ *          attached to the object.
+ *
+ * @param[out] tmp      pointer to a @p TimeMeasurement structure
+ * @param[out] hp       pointer to a @p tm_histogram_t structure
+ *
+ * @init
+ */
+void chTMObjectInitHistogram(time_measurement_t *tmp, tm_histogram_t *hp) {
+  unsigned i;
+
+  chDbgCheck(hp != NULL);
+
+  chTMObjectInit(tmp);
+  for (i = 0U; i < CH_TM_HISTOGRAM_BUCKETS; i++) {
+    hp->buckets[i] = (ucnt_t)0;
+  }
+  tmp->histogram = hp;
+}
+
+/**
+ * @brief   Returns a percentile of the measurements.
+ * @details The value returned is the upper bound of the histogram bucket
+ *          containing the percentile, limited to the worst measurement.
+ * @note    The result is approximated by excess by less than a factor two.
+ *
+ * @param[in] tmp       pointer to a @p TimeMeasurement structure with an
+ *                      attached histogram
+ * @param[in] permille  the percentile in parts per thousand, for example
+ *                      999 for the 99.9th percentile
+ * @return              The percentile value.
+ * @retval 0            if there are no measurements.
+ *
+ * @xclass
+ */
+rtcnt_t chTMGetPercentileX(const time_measurement_t *tmp, unsigned permille) {
+  rttime_t target, count;
+  unsigned i;
+
+  chDbgCheck((tmp != NULL) && (tmp->histogram != NULL) &&
+             (permille <= 1000U));
+
+  /* Number of measurements that must be at or below the percentile,
+     rounded up.*/
+  target = (((rttime_t)tmp->n * (rttime_t)permille) + 999U) / 1000U;
+  if (target == (rttime_t)0) {
+    return (rtcnt_t)0;
+  }
+
+  count = (rttime_t)0;
+  for (i = 0U; i < CH_TM_HISTOGRAM_BUCKETS; i++) {
+    count += (rttime_t)tmp->histogram->buckets[i];
+    if (count >= target) {
+      rtcnt_t bound;
+
+      /* Upper bound of the bucket.*/
+      if (i == 0U) {
+        bound = (rtcnt_t)0;
+      }
+      else if (i >= (CH_TM_HISTOGRAM_BUCKETS - 1U)) {
+        bound = (rtcnt_t)-1;
+      }
+      else {
+        bound = ((rtcnt_t)1 << i) - (rtcnt_t)1;
+      }
+
+      return bound < tmp->worst ? bound : tmp->worst;
+    }
+  }
+
+  return tmp->worst;
 }
+#endif /* CH_CFG_USE_TM_HISTOGRAM == TRUE */
 
 /**
  * @brief   Starts a measurement.
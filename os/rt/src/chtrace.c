@@ -88,6 +88,7 @@ void _trace_init(void) {
   ch.dbg.trace_buffer.suspended = (uint16_t)~CH_DBG_TRACE_MASK;
   ch.dbg.trace_buffer.size      = CH_DBG_TRACE_BUFFER_SIZE;
   ch.dbg.trace_buffer.ptr       = &ch.dbg.trace_buffer.buffer[0];
+  ch.dbg.trace_buffer.user_enabled = (uint32_t)CH_DBG_TRACE_USER_MASK;
   for (i = 0U; i < (unsigned)CH_DBG_TRACE_BUFFER_SIZE; i++) {
     ch.dbg.trace_buffer.buffer[i].type = CH_TRACE_TYPE_UNUSED;
   }
@@ -170,26 +171,45 @@ void _trace_halt(const char *reason) {
 }
 
 /**
- * @brief   Adds an user trace record to the trace buffer.
+ * @brief   Inserts in the circular debug trace buffer an user record.
+ * @note    Use @p chDbgWriteTraceUserI() or @p chDbgWriteTraceUser()
+ *          instead, the macros filter the disabled events at compile time.
  *
+ * @param[in] id        user event identifier
  * @param[in] up1       user parameter 1
  * @param[in] up2       user parameter 2
  *
- * @iclass
+ * @notapi
  */
-void chDbgWriteTraceI(void *up1, void *up2) {
+void _trace_user(uint8_t id, void *up1, void *up2) {
 
   chDbgCheckClassI();
+  chDbgCheck(id <= CH_TRACE_USER_MAX_ID);
 
-  if ((ch.dbg.trace_buffer.suspended & CH_DBG_TRACE_MASK_USER) == 0U) {
+  if (((ch.dbg.trace_buffer.suspended & CH_DBG_TRACE_MASK_USER) == 0U) &&
+      ((ch.dbg.trace_buffer.user_enabled & (1UL << id)) != 0U)) {
     ch.dbg.trace_buffer.ptr->type       = CH_TRACE_TYPE_USER;
-    ch.dbg.trace_buffer.ptr->state      = 0;
+    ch.dbg.trace_buffer.ptr->state      = id;
     ch.dbg.trace_buffer.ptr->u.user.up1 = up1;
     ch.dbg.trace_buffer.ptr->u.user.up2 = up2;
     trace_next();
   }
 }
 
+/**
+ * @brief   Adds an user trace record to the trace buffer.
+ * @note    The record is written as user event zero.
+ *
+ * @param[in] up1       user parameter 1
+ * @param[in] up2       user parameter 2
+ *
+ * @iclass
+ */
+void chDbgWriteTraceI(void *up1, void *up2) {
+
+  _trace_user((uint8_t)0, up1, up2);
+}
+
 /**
  * @brief   Adds an user trace record to the trace buffer.
  *
@@ -260,6 +280,70 @@ void chDbgResumeTrace(uint16_t mask) {
   chDbgResumeTraceI(mask);
   chSysUnlock();
 }
+
+/**
+ * @brief   Sets the mask of the trace events to be recorded.
+ * @details Events not in the mask are suspended, the others are resumed.
+ *
+ * @param[in] mask      mask of the trace events to be recorded
+ *
+ * @iclass
+ */
+void chDbgSetTraceMaskI(uint16_t mask) {
+
+  chDbgCheckClassI();
+
+  ch.dbg.trace_buffer.suspended = (uint16_t)~mask;
+}
+
+/**
+ * @brief   Sets the mask of the trace events to be recorded.
+ * @details Events not in the mask are suspended, the others are resumed.
+ *
+ * @param[in] mask      mask of the trace events to be recorded
+ *
+ * @api
+ */
+void chDbgSetTraceMask(uint16_t mask) {
+
+  chSysLock();
+  chDbgSetTraceMaskI(mask);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Sets the mask of the user trace events to be recorded.
+ * @note    Events disabled at compile time using
+ *          @p CH_DBG_TRACE_USER_MASK cannot be enabled.
+ *
+ * @param[in] mask      mask of the user events, one bit for each event
+ *                      identifier
+ *
+ * @iclass
+ */
+void chDbgSetTraceUserMaskI(uint32_t mask) {
+
+  chDbgCheckClassI();
+
+  ch.dbg.trace_buffer.user_enabled = mask;
+}
+
+/**
+ * @brief   Sets the mask of the user trace events to be recorded.
+ * @note    Events disabled at compile time using
+ *          @p CH_DBG_TRACE_USER_MASK cannot be enabled.
+ *
+ * @param[in] mask      mask of the user events, one bit for each event
+ *                      identifier
+ *
+ * @api
+ */
+void chDbgSetTraceUserMask(uint32_t mask) {
+
+  chSysLock();
+  chDbgSetTraceUserMaskI(mask);
+  chSysUnlock();
+}
 #endif /* CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED */
 
 /** @} */
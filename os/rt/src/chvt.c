@@ -32,6 +32,33 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+#if (CH_CFG_VT_WHEEL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Slots index mask.
+ */
+#define WHEEL_MASK          ((sysinterval_t)CH_VT_WHEEL_SLOTS - (sysinterval_t)1)
+
+/**
+ * @brief   Number of wheel time bits below a level.
+ */
+#define WHEEL_SHIFT(k)      ((unsigned)(k) * CH_VT_WHEEL_BITS)
+
+/**
+ * @brief   Index of the current slot of a level.
+ */
+#define WHEEL_CURRENT(k)    ((unsigned)((ch.vtlist.wtime >> WHEEL_SHIFT(k)) & \
+                                        WHEEL_MASK))
+
+/**
+ * @brief   Count of trailing zeros of a non-zero 32 bits word.
+ */
+#if defined(port_ctz)
+#define wheel_ctz(x)        port_ctz(x)
+#elif defined(__GNUC__)
+#define wheel_ctz(x)        ((unsigned)__builtin_ctz(x))
+#endif
+#endif /* CH_CFG_VT_WHEEL == TRUE */
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -44,10 +71,280 @@
 /* Module local variables.                                                   */
 /*===========================================================================*/
 
+#if ((CH_CFG_USE_TIMESTAMP == TRUE) && (CH_CFG_ST_RESOLUTION < 64)) ||      \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Time stamp refresh timer.
+ */
+static virtual_timer_t stamp_vt;
+#endif
+
 /*===========================================================================*/
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if ((CH_CFG_USE_TIMESTAMP == TRUE) && (CH_CFG_ST_RESOLUTION < 64)) ||      \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Time stamp refresh callback.
+ * @details The time stamp is updated each half system time range so the
+ *          system time cannot wrap twice between two updates.
+ */
+static void vt_stamp_refresh(void *p) {
+
+  (void)p;
+
+  chSysLockFromISR();
+  (void) chVTGetTimeStampI();
+  chVTDoSetI(&stamp_vt, (sysinterval_t)(TIME_MAX_SYSTIME / 2U),
+             vt_stamp_refresh, NULL);
+  chSysUnlockFromISR();
+}
+#endif
+
+#if (CH_CFG_VT_WHEEL == TRUE) || defined(__DOXYGEN__)
+#if !defined(wheel_ctz)
+static unsigned wheel_ctz(uint32_t x) {
+  unsigned n = 0U;
+
+  while ((x & 1U) == 0U) {
+    x >>= 1;
+    n++;
+  }
+
+  return n;
+}
+#endif /* !defined(wheel_ctz) */
+
+/**
+ * @brief   Returns @p true if the timing wheel is empty.
+ */
+static bool wheel_is_empty(void) {
+  unsigned k;
+
+  for (k = 0U; k < (unsigned)CH_CFG_VT_WHEEL_LEVELS; k++) {
+    if (ch.vtlist.bitmap[k] != 0U) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief   Interval from the wheel time to the processing time of a slot.
+ * @note    For level zero the slot processing time is the timers expiration
+ *          time, for upper levels it is the time the timers are cascaded
+ *          toward lower levels.
+ *
+ * @note    The current slot of an upper level is processed after a full
+ *          level rotation, the current slot of level zero is always empty.
+ *
+ * @param[in] k         the wheel level
+ * @param[in] idx       the slot index
+ * @return              The interval in ticks.
+ */
+static sysinterval_t wheel_slot_interval(unsigned k, unsigned idx) {
+  sysinterval_t n, base;
+
+  n    = ((sysinterval_t)idx - (sysinterval_t)WHEEL_CURRENT(k)) & WHEEL_MASK;
+  base = ch.vtlist.wtime >> WHEEL_SHIFT(k);
+  if (n == (sysinterval_t)0) {
+    n = (sysinterval_t)CH_VT_WHEEL_SLOTS;
+  }
+
+  return ((base + n) << WHEEL_SHIFT(k)) - ch.vtlist.wtime;
+}
+
+/**
+ * @brief   Interval from the wheel time to the next wheel event.
+ * @details The next event is the processing of the nearest non-empty slot
+ *          among all levels.
+ * @pre     The wheel must not be empty.
+ *
+ * @return              The interval in ticks.
+ */
+static sysinterval_t wheel_next_interval(void) {
+  sysinterval_t interval = (sysinterval_t)-1;
+  unsigned k;
+
+  for (k = 0U; k < (unsigned)CH_CFG_VT_WHEEL_LEVELS; k++) {
+    uint32_t bm = ch.vtlist.bitmap[k];
+
+    if (bm != 0U) {
+      unsigned r = (WHEEL_CURRENT(k) + 1U) & (unsigned)WHEEL_MASK;
+      sysinterval_t i;
+
+      /* Rotating the bitmap so that the slot following the current one
+         is in bit zero.*/
+      if (r != 0U) {
+        bm = (bm >> r) | (bm << (CH_VT_WHEEL_SLOTS - r));
+      }
+      i = wheel_slot_interval(k, (wheel_ctz(bm) + r) & (unsigned)WHEEL_MASK);
+      if (i < interval) {
+        interval = i;
+      }
+    }
+  }
+
+  return interval;
+}
+
+/**
+ * @brief   Inserts a timer in the wheel according to its expiration time.
+ * @note    Timers farther than the wheel span are placed in the farthest
+ *          slot of the upper level, they are re-inserted when the slot is
+ *          processed.
+ *
+ * @param[in] vtp       the timer to be inserted
+ * @return              The interval from the wheel time to the processing
+ *                      time of the slot the timer has been inserted into.
+ */
+static sysinterval_t wheel_insert(virtual_timer_t *vtp) {
+  sysinterval_t d = vtp->expires - ch.vtlist.wtime;
+  unsigned k, idx;
+  vt_slot_t *sp;
+
+  k = 0U;
+  while ((k < ((unsigned)CH_CFG_VT_WHEEL_LEVELS - 1U)) &&
+         ((d >> WHEEL_SHIFT(k)) >= (sysinterval_t)CH_VT_WHEEL_SLOTS)) {
+    k++;
+  }
+  if ((d >> WHEEL_SHIFT(k)) >= (sysinterval_t)CH_VT_WHEEL_SLOTS) {
+    /* Beyond the wheel span, it goes in the current slot of the upper
+       level which is processed after a full wheel rotation.*/
+    idx = WHEEL_CURRENT(k);
+  }
+  else {
+    idx = (unsigned)((vtp->expires >> WHEEL_SHIFT(k)) & WHEEL_MASK);
+  }
+
+  /* Insertion at the end of the slot list.*/
+  sp = &ch.vtlist.slots[k][idx];
+  vtp->next = (virtual_timer_t *)sp;
+  vtp->prev = sp->prev;
+  vtp->prev->next = vtp;
+  sp->prev = vtp;
+  ch.vtlist.bitmap[k] |= (uint32_t)1U << idx;
+
+  return wheel_slot_interval(k, idx);
+}
+
+/**
+ * @brief   Unlinks a timer from its wheel slot.
+ *
+ * @param[in] vtp       the timer to be removed
+ */
+static void wheel_remove(virtual_timer_t *vtp) {
+
+  if (vtp->next == vtp->prev) {
+    /* It is the only timer in the slot, the slot becomes empty, the
+       slot position is derived from the header address.*/
+    unsigned n = (unsigned)((vt_slot_t *)vtp->next - &ch.vtlist.slots[0][0]);
+
+    ch.vtlist.bitmap[n / CH_VT_WHEEL_SLOTS] &=
+        ~((uint32_t)1U << (n % CH_VT_WHEEL_SLOTS));
+  }
+  vtp->prev->next = vtp->next;
+  vtp->next->prev = vtp->prev;
+}
+
+#if (CH_CFG_ST_TIMEDELTA > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Programs the alarm for a wheel event.
+ *
+ * @param[in] now       the current system time
+ * @param[in] interval  interval from the wheel time to the event
+ * @param[in] start     @p true if the alarm must be started, @p false if
+ *                      it is already running
+ */
+static void wheel_set_alarm(systime_t now, sysinterval_t interval,
+                            bool start) {
+  sysinterval_t nowdelta = chTimeDiffX(ch.vtlist.lasttime, now);
+
+  /* Making sure to not schedule an event closer than CH_CFG_ST_TIMEDELTA
+     ticks from now.*/
+  if (interval < (nowdelta + (sysinterval_t)CH_CFG_ST_TIMEDELTA)) {
+    interval = nowdelta + (sysinterval_t)CH_CFG_ST_TIMEDELTA;
+  }
+#if CH_CFG_INTERVALS_SIZE > CH_CFG_ST_RESOLUTION
+  /* The delta could be too large for the physical timer to handle.*/
+  else if (interval > (sysinterval_t)TIME_MAX_SYSTIME) {
+    interval = (sysinterval_t)TIME_MAX_SYSTIME;
+  }
+#endif
+
+  ch.vtlist.alarm = ch.vtlist.wtime + interval;
+  if (start) {
+    port_timer_start_alarm(chTimeAddX(ch.vtlist.lasttime, interval));
+  }
+  else {
+    port_timer_set_alarm(chTimeAddX(ch.vtlist.lasttime, interval));
+  }
+}
+#endif /* CH_CFG_ST_TIMEDELTA > 0 */
+
+/**
+ * @brief   Processes the wheel at the current wheel time.
+ * @details Slots of upper levels reaching their processing time are
+ *          cascaded toward lower levels then all timers in the current
+ *          level zero slot are fired, timers having the same deadline are
+ *          served in a single pass.
+ */
+CH_HOTPATH static void wheel_process(void) {
+  unsigned k;
+  vt_slot_t *sp;
+
+  /* Cascading upper levels.*/
+  for (k = (unsigned)CH_CFG_VT_WHEEL_LEVELS - 1U; k > 0U; k--) {
+    unsigned idx = WHEEL_CURRENT(k);
+
+    if (((ch.vtlist.wtime & ((((sysinterval_t)1) << WHEEL_SHIFT(k)) -
+                             (sysinterval_t)1)) == (sysinterval_t)0) &&
+        ((ch.vtlist.bitmap[k] & ((uint32_t)1U << idx)) != 0U)) {
+      virtual_timer_t *vtp;
+
+      /* The slot is detached then its timers are re-inserted.*/
+      sp = &ch.vtlist.slots[k][idx];
+      vtp = sp->next;
+      sp->prev->next = NULL;
+      sp->next = (virtual_timer_t *)sp;
+      sp->prev = (virtual_timer_t *)sp;
+      ch.vtlist.bitmap[k] &= ~((uint32_t)1U << idx);
+      while (vtp != NULL) {
+        virtual_timer_t *next = vtp->next;
+
+        (void) wheel_insert(vtp);
+        vtp = next;
+      }
+    }
+  }
+
+  /* Firing all timers in the current slot.*/
+  sp = &ch.vtlist.slots[0][WHEEL_CURRENT(0U)];
+  while (sp->next != (virtual_timer_t *)sp) {
+    virtual_timer_t *vtp = sp->next;
+    vtfunc_t fn;
+
+    wheel_remove(vtp);
+    fn = vtp->func;
+    vtp->func = NULL;
+
+#if CH_CFG_ST_TIMEDELTA > 0
+    /* If the wheel becomes empty then the alarm is stopped.*/
+    if (wheel_is_empty()) {
+      port_timer_stop_alarm();
+    }
+#endif
+
+    /* The callback is invoked outside the kernel critical zone.*/
+    chSysUnlockFromISR();
+    fn(vtp->par);
+    chSysLockFromISR();
+  }
+}
+#endif /* CH_CFG_VT_WHEEL == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -60,15 +357,53 @@
  */
 void _vt_init(void) {
 
+#if CH_CFG_VT_WHEEL == TRUE
+  unsigned k, i;
+
+  for (k = 0U; k < (unsigned)CH_CFG_VT_WHEEL_LEVELS; k++) {
+    for (i = 0U; i < CH_VT_WHEEL_SLOTS; i++) {
+      ch.vtlist.slots[k][i].next = (virtual_timer_t *)&ch.vtlist.slots[k][i];
+      ch.vtlist.slots[k][i].prev = (virtual_timer_t *)&ch.vtlist.slots[k][i];
+    }
+    ch.vtlist.bitmap[k] = 0U;
+  }
+  ch.vtlist.wtime = (sysinterval_t)0;
+#else
   ch.vtlist.next = (virtual_timer_t *)&ch.vtlist;
   ch.vtlist.prev = (virtual_timer_t *)&ch.vtlist;
   ch.vtlist.delta = (sysinterval_t)-1;
+#endif
 #if CH_CFG_ST_TIMEDELTA == 0
   ch.vtlist.systime = (systime_t)0;
 #else /* CH_CFG_ST_TIMEDELTA > 0 */
   ch.vtlist.lasttime = (systime_t)0;
 #endif /* CH_CFG_ST_TIMEDELTA > 0 */
+#if CH_CFG_USE_TIMESTAMP == TRUE
+  ch.vtlist.laststamp = (systimestamp_t)0;
+#endif
+}
+
+#if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Time stamps initialization.
+ * @details The time stamp is aligned to the current system time and the
+ *          refresh timer is started.
+ * @note    Internal use only, it is invoked when the system is started
+ *          because it requires the system time to be running.
+ *
+ * @notapi
+ */
+void _vt_stamp_init(void) {
+
+  chSysLock();
+  ch.vtlist.laststamp = (systimestamp_t)chVTGetSystemTimeX();
+#if CH_CFG_ST_RESOLUTION < 64
+  chVTDoSetI(&stamp_vt, (sysinterval_t)(TIME_MAX_SYSTIME / 2U),
+             vt_stamp_refresh, NULL);
+#endif
+  chSysUnlock();
 }
+#endif /* CH_CFG_USE_TIMESTAMP == TRUE */
 
 /**
  * @brief   Enables a virtual timer.
@@ -94,6 +429,56 @@ void _vt_init(void) {
  */
 void chVTDoSetI(virtual_timer_t *vtp, sysinterval_t delay,
                 vtfunc_t vtfunc, void *par) {
+#if CH_CFG_VT_WHEEL == TRUE
+
+  chDbgCheckClassI();
+  chDbgCheck((vtp != NULL) && (vtfunc != NULL) && (delay != TIME_IMMEDIATE));
+
+  vtp->par = par;
+  vtp->func = vtfunc;
+
+#if CH_CFG_ST_TIMEDELTA > 0
+  {
+    systime_t now = chVTGetSystemTimeX();
+    sysinterval_t nowdelta, interval;
+    bool empty = wheel_is_empty();
+
+    /* If the requested delay is lower than the minimum safe delta then it
+       is raised to the minimum safe value.*/
+    if (delay < (sysinterval_t)CH_CFG_ST_TIMEDELTA) {
+      delay = (sysinterval_t)CH_CFG_ST_TIMEDELTA;
+    }
+
+    /* If the wheel is empty then there are no events to be processed, the
+       wheel time is moved to the current time.*/
+    if (empty) {
+      ch.vtlist.wtime += chTimeDiffX(ch.vtlist.lasttime, now);
+      ch.vtlist.lasttime = now;
+    }
+
+    /* Expiration time relative to the wheel time, saturated in the
+       unlikely case the delay exceeds the numeric range.*/
+    nowdelta = chTimeDiffX(ch.vtlist.lasttime, now);
+    if (delay > ((sysinterval_t)-1 - nowdelta)) {
+      delay = (sysinterval_t)-1 - nowdelta;
+    }
+    vtp->expires = ch.vtlist.wtime + nowdelta + delay;
+    interval = wheel_insert(vtp);
+
+    /* The alarm is moved only if the new event is closer than the
+       currently programmed alarm.*/
+    if (empty) {
+      wheel_set_alarm(now, interval, true);
+    }
+    else if (interval < (ch.vtlist.alarm - ch.vtlist.wtime)) {
+      wheel_set_alarm(now, interval, false);
+    }
+  }
+#else /* CH_CFG_ST_TIMEDELTA == 0 */
+  vtp->expires = ch.vtlist.wtime + delay;
+  (void) wheel_insert(vtp);
+#endif /* CH_CFG_ST_TIMEDELTA == 0 */
+#else /* CH_CFG_VT_WHEEL == FALSE */
   virtual_timer_t *p;
   sysinterval_t delta;
 
@@ -198,6 +583,7 @@ void chVTDoSetI(virtual_timer_t *vtp, sysinterval_t delay,
   /* Special case when the timer is in last position in the list, the
      value in the header must be restored.*/
   ch.vtlist.delta = (sysinterval_t)-1;
+#endif /* CH_CFG_VT_WHEEL == FALSE */
 }
 
 /**
@@ -214,7 +600,18 @@ void chVTDoResetI(virtual_timer_t *vtp) {
   chDbgCheck(vtp != NULL);
   chDbgAssert(vtp->func != NULL, "timer not set or already triggered");
 
-#if CH_CFG_ST_TIMEDELTA == 0
+#if CH_CFG_VT_WHEEL == TRUE
+  wheel_remove(vtp);
+  vtp->func = NULL;
+
+#if CH_CFG_ST_TIMEDELTA > 0
+  /* If the wheel become empty then the alarm timer is stopped, else the
+     alarm is left as it is, an early alarm is harmless.*/
+  if (wheel_is_empty()) {
+    port_timer_stop_alarm();
+  }
+#endif
+#elif CH_CFG_ST_TIMEDELTA == 0
 
   /* The delta of the timer is added to the next timer.*/
   vtp->next->delta += vtp->delta;
@@ -296,4 +693,220 @@ void chVTDoResetI(virtual_timer_t *vtp) {
 #endif /* CH_CFG_ST_TIMEDELTA > 0 */
 }
 
+/**
+ * @brief   Enables a virtual timer with an expiration window.
+ * @details The timer is enabled and programmed to trigger after a delay
+ *          between @p delay and @p delay + @p slack ticks. If an armed
+ *          timer already has a deadline within the window then the new
+ *          timer shares that deadline and both are served by the same
+ *          alarm interrupt, else the timer expires at the end of the
+ *          window so that following timers have a chance to share its
+ *          deadline.
+ * @pre     The timer must not be already armed before calling this function.
+ * @note    The callback function is invoked from interrupt context.
+ * @note    Deadlines are coalesced in tick-less mode only, in tick mode the
+ *          timer is simply programmed to trigger after @p delay ticks.
+ * @note    In the timing wheel implementation only deadlines falling in
+ *          the first wheel level are considered for coalescing.
+ *
+ * @param[out] vtp      the @p virtual_timer_t structure pointer
+ * @param[in] delay     the minimum number of ticks before the operation
+ *                      timeouts, the special values are handled as follow:
+ *                      - @a TIME_INFINITE is allowed but interpreted as a
+ *                        normal time specification.
+ *                      - @a TIME_IMMEDIATE this value is not allowed.
+ *                      .
+ * @param[in] slack     the number of ticks the expiration can be postponed
+ *                      beyond @p delay
+ * @param[in] vtfunc    the timer callback function. After invoking the
+ *                      callback the timer is disabled and the structure can
+ *                      be disposed or reused.
+ * @param[in] par       a parameter that will be passed to the callback
+ *                      function
+ *
+ * @iclass
+ */
+void chVTDoSetWindowI(virtual_timer_t *vtp, sysinterval_t delay,
+                      sysinterval_t slack, vtfunc_t vtfunc, void *par) {
+#if CH_CFG_ST_TIMEDELTA > 0
+  sysinterval_t nowdelta, first, last;
+
+  chDbgCheckClassI();
+  chDbgCheck((vtp != NULL) && (vtfunc != NULL) && (delay != TIME_IMMEDIATE));
+
+  /* Same minimum delay enforced by chVTDoSetI().*/
+  if (delay < (sysinterval_t)CH_CFG_ST_TIMEDELTA) {
+    delay = (sysinterval_t)CH_CFG_ST_TIMEDELTA;
+  }
+
+  /* The window end is saturated to the numeric range.*/
+  if (slack > ((sysinterval_t)-1 - delay)) {
+    slack = (sysinterval_t)-1 - delay;
+  }
+
+  /* Window boundaries as deltas from 'lasttime', if the window start
+     exceeds the numeric range then there is no coalescing.*/
+  nowdelta = chTimeDiffX(ch.vtlist.lasttime, chVTGetSystemTimeX());
+  first = nowdelta + delay;
+  if (first >= nowdelta) {
+    last = first + slack;
+    if (last < first) {
+      last = (sysinterval_t)-1;
+    }
+#if CH_CFG_VT_WHEEL == TRUE
+    /* Level zero slots hold timers with the same expiration time, looking
+       for a non-empty slot within the window.*/
+    if (first < (sysinterval_t)CH_VT_WHEEL_SLOTS) {
+      uint32_t bm = ch.vtlist.bitmap[0];
+      unsigned r = (unsigned)((ch.vtlist.wtime + first) & WHEEL_MASK);
+      sysinterval_t n;
+
+      if (last >= (sysinterval_t)CH_VT_WHEEL_SLOTS) {
+        last = (sysinterval_t)CH_VT_WHEEL_SLOTS - (sysinterval_t)1;
+      }
+      n = last - first + (sysinterval_t)1;
+
+      /* Rotating the bitmap so that the window start is in bit zero then
+         masking the bits beyond the window end.*/
+      if (r != 0U) {
+        bm = (bm >> r) | (bm << (CH_VT_WHEEL_SLOTS - r));
+      }
+      bm &= ((uint32_t)1U << n) - 1U;
+      if (bm != 0U) {
+        _stats_increase_vtsaved();
+        chVTDoSetI(vtp, delay + (sysinterval_t)wheel_ctz(bm), vtfunc, par);
+        return;
+      }
+    }
+#else /* CH_CFG_VT_WHEEL == FALSE */
+    virtual_timer_t *p = ch.vtlist.next;
+    sysinterval_t deadline = (sysinterval_t)0;
+
+    /* The delta list is scanned looking for the first deadline not
+       preceding the window start.*/
+    while (p != (virtual_timer_t *)&ch.vtlist) {
+      if (p->delta > ((sysinterval_t)-1 - deadline)) {
+        break;
+      }
+      deadline += p->delta;
+      if (deadline >= first) {
+        if (deadline <= last) {
+          /* The deadline is shared, no alarm is added.*/
+          _stats_increase_vtsaved();
+          chVTDoSetI(vtp, deadline - nowdelta, vtfunc, par);
+          return;
+        }
+        break;
+      }
+      p = p->next;
+    }
+#endif /* CH_CFG_VT_WHEEL == FALSE */
+  }
+
+  /* No deadline to share, the timer expires at the end of the window.*/
+  chVTDoSetI(vtp, delay + slack, vtfunc, par);
+#else /* CH_CFG_ST_TIMEDELTA == 0 */
+
+  (void)slack;
+
+  chVTDoSetI(vtp, delay, vtfunc, par);
+#endif /* CH_CFG_ST_TIMEDELTA == 0 */
+}
+
+#if (CH_CFG_VT_WHEEL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the time interval until the next timer event.
+ * @note    The return value is not perfectly accurate and can report values
+ *          in excess of @p CH_CFG_ST_TIMEDELTA ticks.
+ * @note    In the timing wheel implementation the next event can be the
+ *          cascading of an upper wheel level so the reported interval is
+ *          a lower bound of the time until the next timer expiration.
+ *
+ * @param[out] timep    pointer to a variable that will contain the time
+ *                      interval until the next timer elapses. This pointer
+ *                      can be @p NULL if the information is not required.
+ * @return              The time, in ticks, until next time event.
+ * @retval false        if the timers list is empty.
+ * @retval true         if the timers list contains at least one timer.
+ *
+ * @iclass
+ */
+bool chVTGetTimersStateI(sysinterval_t *timep) {
+
+  chDbgCheckClassI();
+
+  if (wheel_is_empty()) {
+    return false;
+  }
+
+  if (timep != NULL) {
+#if CH_CFG_ST_TIMEDELTA == 0
+    *timep = wheel_next_interval();
+#else
+    sysinterval_t interval = wheel_next_interval();
+    sysinterval_t nowdelta = chTimeDiffX(ch.vtlist.lasttime,
+                                         chVTGetSystemTimeX());
+
+    *timep = (interval > nowdelta) ? (interval - nowdelta) :
+                                     (sysinterval_t)0;
+#endif
+  }
+
+  return true;
+}
+
+/**
+ * @brief   Virtual timers ticker.
+ * @note    The system lock is released before entering the callback and
+ *          re-acquired immediately after. It is callback's responsibility
+ *          to acquire the lock if needed. This is done in order to reduce
+ *          interrupts jitter when many timers are in use.
+ *
+ * @iclass
+ */
+CH_HOTPATH void chVTDoTickI(void) {
+
+  chDbgCheckClassI();
+
+#if CH_CFG_ST_TIMEDELTA == 0
+  ch.vtlist.systime++;
+  ch.vtlist.wtime++;
+  wheel_process();
+#else /* CH_CFG_ST_TIMEDELTA > 0 */
+  systime_t now;
+  sysinterval_t interval, nowdelta;
+
+  /* Processing all wheel events between the wheel time and now.*/
+  while (true) {
+    now = chVTGetSystemTimeX();
+    nowdelta = chTimeDiffX(ch.vtlist.lasttime, now);
+
+    if (wheel_is_empty()) {
+      /* Nothing else to process, the wheel time follows the system
+         time.*/
+      ch.vtlist.wtime += nowdelta;
+      ch.vtlist.lasttime = now;
+      return;
+    }
+
+    interval = wheel_next_interval();
+    if (interval > nowdelta) {
+      break;
+    }
+
+    /* The wheel time is moved to the event time.*/
+    ch.vtlist.wtime += interval;
+    ch.vtlist.lasttime = chTimeAddX(ch.vtlist.lasttime, interval);
+    wheel_process();
+  }
+
+  /* The time slice without events is consumed and the alarm is programmed
+     for the next event.*/
+  ch.vtlist.wtime += nowdelta;
+  ch.vtlist.lasttime = now;
+  wheel_set_alarm(now, interval - nowdelta, false);
+#endif /* CH_CFG_ST_TIMEDELTA > 0 */
+}
+#endif /* CH_CFG_VT_WHEEL == TRUE */
+
 /** @} */
@@ -0,0 +1,346 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chwaitm.c
+ * @brief   Multiple objects wait code.
+ *
+ * @addtogroup waitmultiple
+ * @details Multiple objects wait related APIs and services.
+ *          <h2>Operation mode</h2>
+ *          A thread can wait on an array of wait objects, each object
+ *          refers to a semaphore, a mailbox or to the thread own events.
+ *          While waiting, the objects are linked in the lists of the
+ *          semaphores and mailboxes, the kernel objects notify the
+ *          waiting threads when they become ready:
+ *          - A semaphore is ready when its counter is positive.
+ *          - A mailbox is ready when it contains messages or it is in
+ *            reset state.
+ *          - Events are ready when any of the specified events is
+ *            pending.
+ *          .
+ *          The thread is woken up when any object or all the objects
+ *          are ready depending on the wait mode, the ready objects are
+ *          marked and the thread then takes them using the normal APIs,
+ *          for example @p chSemWaitTimeout() or @p chMBFetchTimeout()
+ *          with @p TIME_IMMEDIATE.<br>
+ *          Waiting does not consume the objects, a ready object can be
+ *          taken by another thread before the awakened thread runs so
+ *          the non-blocking operations must be checked.
+ *          <h2>Cancellation</h2>
+ *          The wait objects are unlinked by the waiting thread itself on
+ *          wakeup or timeout, the notification and timeout paths do not
+ *          scan the objects lists.
+ * @pre     In order to use the multiple objects wait APIs the
+ *          @p CH_CFG_USE_WAIT_MULTIPLE option must be enabled in
+ *          @p chconf.h.
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_WAIT_MULTIPLE == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/**
+ * @brief   Multiple wait descriptor.
+ * @details It is allocated on the stack of the waiting thread and
+ *          referenced by its @p wtobjp field.
+ */
+typedef struct {
+  wait_object_t         *objects;   /**< @brief Wait objects array.         */
+  unsigned              n;          /**< @brief Number of wait objects.     */
+  waitmode_t            mode;       /**< @brief Wait mode.                  */
+} wait_multiple_t;
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the list of the kernel object of a wait object.
+ *
+ * @param[in] wop       pointer to the wait object
+ * @return              The objects list or @p NULL if the object is not
+ *                      linked in a list.
+ *
+ * @notapi
+ */
+static wait_list_t *wait_get_list(wait_object_t *wop) {
+
+  switch (wop->type) {
+#if CH_CFG_USE_SEMAPHORES == TRUE
+  case CH_WAIT_SEMAPHORE:
+    return &((semaphore_t *)wop->object)->waiters;
+#endif
+#if CH_CFG_USE_MAILBOXES == TRUE
+  case CH_WAIT_MAILBOX:
+    return &((mailbox_t *)wop->object)->waiters;
+#endif
+  default:
+    return NULL;
+  }
+}
+
+/**
+ * @brief   Evaluates the ready state of a wait object.
+ *
+ * @param[in] wop       pointer to the wait object
+ * @return              The object state.
+ *
+ * @notapi
+ */
+static bool wait_is_ready(wait_object_t *wop) {
+
+  switch (wop->type) {
+#if CH_CFG_USE_SEMAPHORES == TRUE
+  case CH_WAIT_SEMAPHORE:
+    return (bool)(((semaphore_t *)wop->object)->cnt > (cnt_t)0);
+#endif
+#if CH_CFG_USE_MAILBOXES == TRUE
+  case CH_WAIT_MAILBOX:
+    return (bool)((((mailbox_t *)wop->object)->cnt > (size_t)0) ||
+                  ((mailbox_t *)wop->object)->reset);
+#endif
+#if CH_CFG_USE_EVENTS == TRUE
+  case CH_WAIT_EVENTS:
+    return (bool)((wop->thread->epending & wop->events) != (eventmask_t)0);
+#endif
+  default:
+    return false;
+  }
+}
+
+/**
+ * @brief   Updates the ready state of the wait objects.
+ *
+ * @param[in] wmp       pointer to the multiple wait descriptor
+ * @return              The wait condition state.
+ *
+ * @notapi
+ */
+static bool wait_check(wait_multiple_t *wmp) {
+  unsigned i, nready = 0U;
+
+  for (i = 0U; i < wmp->n; i++) {
+    wait_object_t *wop = &wmp->objects[i];
+
+    wop->ready = wait_is_ready(wop);
+    if (wop->ready) {
+      nready++;
+    }
+  }
+
+  if (wmp->mode == CH_WAIT_ALL) {
+    return (bool)(nready == wmp->n);
+  }
+
+  return (bool)(nready > 0U);
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Waits on multiple objects.
+ * @details The invoking thread waits until any or all the objects are
+ *          ready, depending on @p mode. The @p ready field of each object
+ *          is updated on return and is accessible using
+ *          @p chWaitObjectIsReadyX().
+ *
+ * @param[in] objects   pointer to an array of initialized wait objects
+ * @param[in] n         number of wait objects, it must be positive
+ * @param[in] mode      the wait mode:
+ *                      - @a CH_WAIT_ANY wakes on the first ready object.
+ *                      - @a CH_WAIT_ALL wakes when all the objects are
+ *                        ready at the same time.
+ *                      .
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the wait condition has been satisfied.
+ * @retval MSG_TIMEOUT  if the wait condition has not been satisfied within
+ *                      the specified timeout.
+ *
+ * @api
+ */
+msg_t chWaitMultipleTimeout(wait_object_t *objects, unsigned n,
+                            waitmode_t mode, sysinterval_t timeout) {
+  msg_t msg;
+
+  chSysLock();
+  msg = chWaitMultipleTimeoutS(objects, n, mode, timeout);
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Waits on multiple objects.
+ * @details The invoking thread waits until any or all the objects are
+ *          ready, depending on @p mode. The @p ready field of each object
+ *          is updated on return and is accessible using
+ *          @p chWaitObjectIsReadyX().
+ *
+ * @param[in] objects   pointer to an array of initialized wait objects
+ * @param[in] n         number of wait objects, it must be positive
+ * @param[in] mode      the wait mode:
+ *                      - @a CH_WAIT_ANY wakes on the first ready object.
+ *                      - @a CH_WAIT_ALL wakes when all the objects are
+ *                        ready at the same time.
+ *                      .
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the wait condition has been satisfied.
+ * @retval MSG_TIMEOUT  if the wait condition has not been satisfied within
+ *                      the specified timeout.
+ *
+ * @sclass
+ */
+msg_t chWaitMultipleTimeoutS(wait_object_t *objects, unsigned n,
+                             waitmode_t mode, sysinterval_t timeout) {
+  thread_t *ctp = currp;
+  wait_multiple_t wm;
+  msg_t msg;
+  unsigned i;
+
+  chDbgCheckClassS();
+  chDbgCheck((objects != NULL) && (n > 0U));
+
+  wm.objects = objects;
+  wm.n       = n;
+  wm.mode    = mode;
+  for (i = 0U; i < n; i++) {
+    objects[i].thread = ctp;
+  }
+
+  /* Fast path, the condition is already satisfied.*/
+  if (wait_check(&wm)) {
+    return MSG_OK;
+  }
+  if (TIME_IMMEDIATE == timeout) {
+    return MSG_TIMEOUT;
+  }
+
+  /* Linking the wait objects in the lists of their kernel objects.*/
+  for (i = 0U; i < n; i++) {
+    wait_object_t *wop = &objects[i];
+    wait_list_t *wlp = wait_get_list(wop);
+
+    if (wlp != NULL) {
+      wop->next = (wait_object_t *)wlp;
+      wop->prev = wlp->prev;
+      wop->prev->next = wop;
+      wlp->prev = wop;
+    }
+  }
+
+  ctp->u.wtobjp = (void *)&wm;
+  msg = chSchGoSleepTimeoutS(CH_STATE_WTMULTI, timeout);
+
+  /* Unlinking, the objects lists are not scanned.*/
+  for (i = 0U; i < n; i++) {
+    wait_object_t *wop = &objects[i];
+
+    if (wait_get_list(wop) != NULL) {
+      wop->prev->next = wop->next;
+      wop->next->prev = wop->prev;
+    }
+  }
+
+  /* The objects state is refreshed on exit, it can have changed since
+     the wakeup.*/
+  (void) wait_check(&wm);
+
+  return msg;
+}
+
+/**
+ * @brief   Notifies the threads waiting on multiple objects.
+ * @details The function is invoked by the kernel objects when they become
+ *          ready, the threads whose wait condition is satisfied are made
+ *          ready for execution.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel. Note that
+ *          interrupt handlers always reschedule on exit so an explicit
+ *          reschedule must not be performed in ISRs.
+ *
+ * @param[in] wlp       pointer to the wait objects list of the kernel object
+ *
+ * @iclass
+ */
+void chWaitNotifyI(wait_list_t *wlp) {
+  wait_object_t *wop = wlp->next;
+
+  chDbgCheckClassI();
+
+  /* Awakened threads unlink their objects when running so the list is
+     not modified here.*/
+  while (wop != (wait_object_t *)wlp) {
+    chWaitNotifyThreadI(wop->thread);
+    wop = wop->next;
+  }
+}
+
+/**
+ * @brief   Re-evaluates the wait condition of a thread.
+ * @details If the thread is waiting on multiple objects and its wait
+ *          condition is satisfied then it is made ready for execution.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel. Note that
+ *          interrupt handlers always reschedule on exit so an explicit
+ *          reschedule must not be performed in ISRs.
+ *
+ * @param[in] tp        the thread to be checked
+ *
+ * @iclass
+ */
+void chWaitNotifyThreadI(thread_t *tp) {
+
+  chDbgCheckClassI();
+
+  if ((tp->state == CH_STATE_WTMULTI) &&
+      wait_check((wait_multiple_t *)tp->u.wtobjp)) {
+    tp->u.rdymsg = MSG_OK;
+    (void) chSchReadyI(tp);
+  }
+}
+
+#endif /* CH_CFG_USE_WAIT_MULTIPLE == TRUE */
+
+/** @} */
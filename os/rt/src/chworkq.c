@@ -0,0 +1,377 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chworkq.c
+ * @brief   Work queues code.
+ *
+ * @addtogroup workqueues
+ * @details Work queues related APIs and services.
+ *          <h2>Operation mode</h2>
+ *          A work queue is a FIFO of works, a work is a function and an
+ *          argument to be executed in thread context. Works are submitted
+ *          to a queue from threads or ISRs and are executed by the worker
+ *          threads serving the queue, in submission order.<br>
+ *          A queue can be served by one or more worker threads, queues
+ *          served by workers at different priorities allow to defer ISR
+ *          work with different latency requirements without dedicating a
+ *          thread to each driver.<br>
+ *          Delayed works are submitted to their queue on expiration of
+ *          an embedded virtual timer.
+ *          <h2>Constraints</h2>
+ *          A work can be pending in a single queue at time, submitting a
+ *          pending work has no effect. A work can be submitted again from
+ *          its own function.
+ * @pre     In order to use the work queues APIs the @p CH_CFG_USE_WORKQUEUES
+ *          option must be enabled in @p chconf.h.
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_WORKQUEUES == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Worker thread function.
+ *
+ * @param[in] p         pointer to the served @p work_queue_t structure
+ */
+static THD_FUNCTION(wq_worker, p) {
+  work_queue_t *wqp = (work_queue_t *)p;
+
+  while (true) {
+    work_t *wp;
+
+    chSysLock();
+    while (wqp->head == NULL) {
+      (void) chThdEnqueueTimeoutS(&wqp->workers, TIME_INFINITE);
+    }
+
+    /* Removing the work from the queue, from now on it can be submitted
+       again.*/
+    wp = wqp->head;
+    wqp->head = wp->next;
+    wp->wqp = NULL;
+    chSysUnlock();
+
+    wp->func(wp->arg);
+  }
+}
+
+/**
+ * @brief   Delayed works timer callback.
+ *
+ * @param[in] p         pointer to the @p delayed_work_t structure
+ */
+static void wq_delayed_cb(void *p) {
+  delayed_work_t *dwp = (delayed_work_t *)p;
+
+  chSysLockFromISR();
+  (void) chWorkSubmitI(dwp->target, &dwp->work);
+  chSysUnlockFromISR();
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a @p work_queue_t structure.
+ *
+ * @param[out] wqp      pointer to a @p work_queue_t structure
+ *
+ * @init
+ */
+void chWorkQueueObjectInit(work_queue_t *wqp) {
+
+  chDbgCheck(wqp != NULL);
+
+  wqp->head = NULL;
+  wqp->tail = NULL;
+  chThdQueueObjectInit(&wqp->workers);
+}
+
+/**
+ * @brief   Creates a worker thread serving a work queue.
+ * @details The worker thread is created into a static memory area, more
+ *          workers can serve the same queue.
+ *
+ * @param[out] wqp      pointer to the served @p work_queue_t structure
+ * @param[out] wsp      pointer to a working area dedicated to the worker
+ * @param[in] size      size of the working area
+ * @param[in] prio      the priority level for the worker
+ * @param[in] name      the name of the worker thread
+ * @return              The pointer to the @p thread_t structure allocated
+ *                      for the worker.
+ *
+ * @api
+ */
+thread_t *chWorkQueueAddWorker(work_queue_t *wqp, void *wsp, size_t size,
+                               tprio_t prio, const char *name) {
+  thread_descriptor_t td = {
+    name,
+    (stkalign_t *)wsp,
+    (stkalign_t *)((uint8_t *)wsp + size),
+    prio,
+    wq_worker,
+    (void *)wqp
+  };
+
+  chDbgCheck(wqp != NULL);
+
+  return chThdCreate(&td);
+}
+
+/**
+ * @brief   Initializes a @p work_t structure.
+ *
+ * @param[out] wp       pointer to a @p work_t structure
+ * @param[in] func      the work function
+ * @param[in] arg       the work function argument
+ *
+ * @init
+ */
+void chWorkObjectInit(work_t *wp, workfunc_t func, void *arg) {
+
+  chDbgCheck((wp != NULL) && (func != NULL));
+
+  wp->next = NULL;
+  wp->wqp  = NULL;
+  wp->func = func;
+  wp->arg  = arg;
+}
+
+/**
+ * @brief   Submits a work to a work queue.
+ * @details The work is appended to the queue and an idle worker, if any,
+ *          is resumed.
+ * @note    This function does not reschedule.
+ *
+ * @param[in] wqp       pointer to the @p work_queue_t structure
+ * @param[in] wp        pointer to the @p work_t structure
+ * @return              The operation status.
+ * @retval true         if the work has been queued.
+ * @retval false        if the work was already pending.
+ *
+ * @iclass
+ */
+bool chWorkSubmitI(work_queue_t *wqp, work_t *wp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((wqp != NULL) && (wp != NULL));
+
+  if (wp->wqp != NULL) {
+    return false;
+  }
+
+  wp->next = NULL;
+  wp->wqp  = wqp;
+  if (wqp->head == NULL) {
+    wqp->head = wp;
+  }
+  else {
+    wqp->tail->next = wp;
+  }
+  wqp->tail = wp;
+
+  chThdDequeueNextI(&wqp->workers, MSG_OK);
+
+  return true;
+}
+
+/**
+ * @brief   Submits a work to a work queue.
+ * @details The work is appended to the queue and an idle worker, if any,
+ *          is resumed.
+ *
+ * @param[in] wqp       pointer to the @p work_queue_t structure
+ * @param[in] wp        pointer to the @p work_t structure
+ * @return              The operation status.
+ * @retval true         if the work has been queued.
+ * @retval false        if the work was already pending.
+ *
+ * @api
+ */
+bool chWorkSubmit(work_queue_t *wqp, work_t *wp) {
+  bool b;
+
+  chSysLock();
+  b = chWorkSubmitI(wqp, wp);
+  chSchRescheduleS();
+  chSysUnlock();
+
+  return b;
+}
+
+/**
+ * @brief   Removes a pending work from its queue.
+ * @note    A work already taken by a worker cannot be canceled.
+ *
+ * @param[in] wp        pointer to the @p work_t structure
+ * @return              The operation status.
+ * @retval true         if the work has been removed.
+ * @retval false        if the work was not pending.
+ *
+ * @iclass
+ */
+bool chWorkCancelI(work_t *wp) {
+  work_queue_t *wqp;
+  work_t *prev;
+
+  chDbgCheckClassI();
+  chDbgCheck(wp != NULL);
+
+  wqp = wp->wqp;
+  if (wqp == NULL) {
+    return false;
+  }
+
+  if (wqp->head == wp) {
+    prev = NULL;
+    wqp->head = wp->next;
+  }
+  else {
+    /* Searching the predecessor in the queue.*/
+    prev = wqp->head;
+    while (prev->next != wp) {
+      prev = prev->next;
+    }
+    prev->next = wp->next;
+  }
+  if (wqp->tail == wp) {
+    wqp->tail = prev;
+  }
+  wp->wqp = NULL;
+
+  return true;
+}
+
+/**
+ * @brief   Initializes a @p delayed_work_t structure.
+ *
+ * @param[out] dwp      pointer to a @p delayed_work_t structure
+ * @param[in] func      the work function
+ * @param[in] arg       the work function argument
+ *
+ * @init
+ */
+void chDelayedWorkObjectInit(delayed_work_t *dwp, workfunc_t func, void *arg) {
+
+  chDbgCheck(dwp != NULL);
+
+  chWorkObjectInit(&dwp->work, func, arg);
+  chVTObjectInit(&dwp->vt);
+  dwp->target = NULL;
+}
+
+/**
+ * @brief   Submits a work to a work queue after a delay.
+ * @details If the delayed work is already armed then its timer is
+ *          restarted with the new delay.
+ * @note    This function does not reschedule.
+ *
+ * @param[in] wqp       pointer to the @p work_queue_t structure
+ * @param[in] dwp       pointer to the @p delayed_work_t structure
+ * @param[in] delay     the number of ticks before the work is submitted,
+ *                      the special values are handled as follow:
+ *                      - @a TIME_INFINITE is allowed but interpreted as a
+ *                        normal time specification.
+ *                      - @a TIME_IMMEDIATE this value is not allowed.
+ *                      .
+ *
+ * @iclass
+ */
+void chWorkSubmitDelayedI(work_queue_t *wqp, delayed_work_t *dwp,
+                          sysinterval_t delay) {
+
+  chDbgCheckClassI();
+  chDbgCheck((wqp != NULL) && (dwp != NULL));
+
+  dwp->target = wqp;
+  chVTSetI(&dwp->vt, delay, wq_delayed_cb, (void *)dwp);
+}
+
+/**
+ * @brief   Submits a work to a work queue after a delay.
+ * @details If the delayed work is already armed then its timer is
+ *          restarted with the new delay.
+ *
+ * @param[in] wqp       pointer to the @p work_queue_t structure
+ * @param[in] dwp       pointer to the @p delayed_work_t structure
+ * @param[in] delay     the number of ticks before the work is submitted,
+ *                      the special values are handled as follow:
+ *                      - @a TIME_INFINITE is allowed but interpreted as a
+ *                        normal time specification.
+ *                      - @a TIME_IMMEDIATE this value is not allowed.
+ *                      .
+ *
+ * @api
+ */
+void chWorkSubmitDelayed(work_queue_t *wqp, delayed_work_t *dwp,
+                         sysinterval_t delay) {
+
+  chSysLock();
+  chWorkSubmitDelayedI(wqp, dwp, delay);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Cancels a delayed work.
+ * @details The timer is stopped and the work is removed from the queue if
+ *          already submitted.
+ *
+ * @param[in] dwp       pointer to the @p delayed_work_t structure
+ * @return              The operation status.
+ * @retval true         if the delayed work has been canceled.
+ * @retval false        if the delayed work was neither armed nor pending.
+ *
+ * @iclass
+ */
+bool chWorkCancelDelayedI(delayed_work_t *dwp) {
+
+  chDbgCheckClassI();
+  chDbgCheck(dwp != NULL);
+
+  if (chVTIsArmedI(&dwp->vt)) {
+    chVTDoResetI(&dwp->vt);
+    return true;
+  }
+
+  return chWorkCancelI(&dwp->work);
+}
+
+#endif /* CH_CFG_USE_WORKQUEUES == TRUE */
+
+/** @} */
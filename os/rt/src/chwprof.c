@@ -0,0 +1,229 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chwprof.c
+ * @brief   Wait profiler module code.
+ *
+ * @addtogroup wait_profiler
+ * @details Wait profiler.
+ *          <h2>Operation mode</h2>
+ *          When a thread goes to sleep the start time, the wait state and
+ *          the wait object are stored in the thread structure. On wakeup
+ *          the wait time is accumulated in the table entry matching the
+ *          thread, the object and the state, the entry also records the
+ *          thread performing the wakeup so contended objects and their
+ *          releasers can be identified.<br>
+ *          The table is an hash table with linear probing, when it is
+ *          full further waits are only counted as dropped.
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_DBG_WAIT_PROFILE == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Finds or allocates the entry of a wait.
+ *
+ * @param[in] tp        the waiting thread
+ * @return              The entry or @p NULL if the table is full.
+ */
+static wait_profile_entry_t *wprof_lookup(thread_t *tp) {
+  uint32_t h, i;
+
+  h = (uint32_t)(((uintptr_t)tp >> 3) ^ ((uintptr_t)tp->wpobjp >> 2) ^
+                 (uintptr_t)tp->wpstate) * 0x9E3779B1U;
+  h >>= 16;
+  for (i = 0U; i < (uint32_t)CH_DBG_WAIT_PROFILE_ENTRIES; i++) {
+    wait_profile_entry_t *wpep;
+
+    wpep = &ch.wait_profile.entries[(h + i) &
+                                    ((uint32_t)CH_DBG_WAIT_PROFILE_ENTRIES - 1U)];
+    if (wpep->tp == NULL) {
+      wpep->tp = tp;
+#if CH_CFG_USE_REGISTRY == TRUE
+      wpep->name = tp->name;
+#endif
+      wpep->objp = tp->wpobjp;
+      wpep->state = tp->wpstate;
+      wpep->waker = NULL;
+      wpep->n = (ucnt_t)0;
+      wpep->n_timeout = (ucnt_t)0;
+      wpep->worst = (rtcnt_t)0;
+      wpep->cumulative = (rttime_t)0;
+      return wpep;
+    }
+    if ((wpep->tp == tp) && (wpep->objp == tp->wpobjp) &&
+        (wpep->state == tp->wpstate)) {
+      return wpep;
+    }
+  }
+
+  return NULL;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes the wait profiler module.
+ *
+ * @init
+ */
+void _wprof_init(void) {
+  unsigned i;
+
+  for (i = 0U; i < (unsigned)CH_DBG_WAIT_PROFILE_ENTRIES; i++) {
+    ch.wait_profile.entries[i].tp = NULL;
+  }
+  ch.wait_profile.n_dropped = (ucnt_t)0;
+}
+
+/**
+ * @brief   Records the start of a wait.
+ * @note    Invoked with the thread already in its wait state, the wait
+ *          object is taken from the thread structure.
+ *
+ * @param[in] tp        the thread going to sleep
+ *
+ * @notapi
+ */
+void _wprof_sleep(thread_t *tp) {
+
+  switch (tp->state) {
+  case CH_STATE_SUSPENDED:
+  case CH_STATE_QUEUED:
+  case CH_STATE_WTSEM:
+  case CH_STATE_WTMTX:
+  case CH_STATE_WTCOND:
+    tp->wpobjp = tp->u.wtobjp;
+    break;
+  case CH_STATE_FINAL:
+    /* Not a wait.*/
+    return;
+  default:
+    tp->wpobjp = NULL;
+    break;
+  }
+  tp->wpstate = tp->state;
+  tp->wpstart = chSysGetRealtimeCounterX();
+}
+
+/**
+ * @brief   Records the end of a wait.
+ * @note    The function does nothing if the thread is not waiting, it
+ *          can be invoked more than once for the same wakeup.
+ *
+ * @param[in] tp        the thread being awakened
+ * @param[in] timeout   the wait has been terminated by a timeout
+ *
+ * @notapi
+ */
+void _wprof_wakeup(thread_t *tp, bool timeout) {
+  wait_profile_entry_t *wpep;
+  rtcnt_t t;
+
+  if (tp->wpstate == CH_STATE_READY) {
+    return;
+  }
+
+  t = chSysGetRealtimeCounterX() - tp->wpstart;
+  wpep = wprof_lookup(tp);
+  tp->wpstate = CH_STATE_READY;
+  if (wpep == NULL) {
+    ch.wait_profile.n_dropped++;
+    return;
+  }
+
+  wpep->n++;
+  if (timeout) {
+    wpep->n_timeout++;
+    wpep->waker = NULL;
+  }
+  else {
+    wpep->waker = port_is_isr_context() ? NULL : currp;
+  }
+  wpep->cumulative += (rttime_t)t;
+  if (t > wpep->worst) {
+    wpep->worst = t;
+  }
+}
+
+/**
+ * @brief   Clears the wait profiler table.
+ *
+ * @api
+ */
+void chWaitProfileReset(void) {
+
+  chSysLock();
+  _wprof_init();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Returns a copy of a wait profiler entry.
+ * @note    Entries of terminated threads are retained until the table
+ *          is reset.
+ *
+ * @param[in] i         entry index, from zero to
+ *                      @p CH_DBG_WAIT_PROFILE_ENTRIES - 1
+ * @param[out] wpep     pointer to the destination structure
+ * @return              The entry state.
+ * @retval false        if the entry is free.
+ * @retval true         if the entry has been copied.
+ *
+ * @api
+ */
+bool chWaitProfileGetEntry(unsigned i, wait_profile_entry_t *wpep) {
+
+  chDbgCheck((i < (unsigned)CH_DBG_WAIT_PROFILE_ENTRIES) && (wpep != NULL));
+
+  chSysLock();
+  *wpep = ch.wait_profile.entries[i];
+  chSysUnlock();
+
+  return wpep->tp != NULL;
+}
+
+#endif /* CH_DBG_WAIT_PROFILE == TRUE */
+
+/** @} */
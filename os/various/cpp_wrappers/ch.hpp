@@ -2303,6 +2303,241 @@ namespace chibios_rt {
 #endif /* CH_CFG_USE_CONDVARS == TRUE */
 #endif /* CH_CFG_USE_MUTEXES == TRUE */
 
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::RWLock                                                     *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Class encapsulating a reader-writer lock.
+   */
+  class RWLock {
+    /**
+     * @brief   Embedded @p rwlock_t structure.
+     */
+    rwlock_t rwlock;
+
+  public:
+    /**
+     * @brief   RWLock object constructor.
+     * @details The embedded @p rwlock_t structure is initialized.
+     *
+     * @init
+     */
+    RWLock(void) {
+
+      chRWLockObjectInit(&rwlock);
+    }
+
+    /**
+     * @brief   Acquires the lock in shared mode.
+     *
+     * @api
+     */
+    void readLock(void) {
+
+      chRWLockReadLock(&rwlock);
+    }
+
+    /**
+     * @brief   Acquires the lock in shared mode.
+     *
+     * @sclass
+     */
+    void readLockS(void) {
+
+      chRWLockReadLockS(&rwlock);
+    }
+
+    /**
+     * @brief   Acquires the lock in shared mode with timeout specification.
+     *
+     * @param[in] timeout   the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The operation status.
+     * @retval MSG_OK       if the lock has been acquired.
+     * @retval MSG_TIMEOUT  if the lock has not been acquired within the
+     *                      specified timeout.
+     *
+     * @api
+     */
+    msg_t readLockTimeout(sysinterval_t timeout) {
+
+      return chRWLockReadLockTimeout(&rwlock, timeout);
+    }
+
+    /**
+     * @brief   Acquires the lock in shared mode with timeout specification.
+     *
+     * @param[in] timeout   the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The operation status.
+     * @retval MSG_OK       if the lock has been acquired.
+     * @retval MSG_TIMEOUT  if the lock has not been acquired within the
+     *                      specified timeout.
+     *
+     * @sclass
+     */
+    msg_t readLockTimeoutS(sysinterval_t timeout) {
+
+      return chRWLockReadLockTimeoutS(&rwlock, timeout);
+    }
+
+    /**
+     * @brief   Releases the lock from shared mode.
+     *
+     * @api
+     */
+    void readUnlock(void) {
+
+      chRWLockReadUnlock(&rwlock);
+    }
+
+    /**
+     * @brief   Releases the lock from shared mode.
+     * @post    This function does not reschedule so a call to a rescheduling
+     *          function must be performed before unlocking the kernel.
+     *
+     * @sclass
+     */
+    void readUnlockS(void) {
+
+      chRWLockReadUnlockS(&rwlock);
+    }
+
+    /**
+     * @brief   Acquires the lock in exclusive mode.
+     *
+     * @api
+     */
+    void writeLock(void) {
+
+      chRWLockWriteLock(&rwlock);
+    }
+
+    /**
+     * @brief   Acquires the lock in exclusive mode.
+     *
+     * @sclass
+     */
+    void writeLockS(void) {
+
+      chRWLockWriteLockS(&rwlock);
+    }
+
+    /**
+     * @brief   Acquires the lock in exclusive mode with timeout specification.
+     *
+     * @param[in] timeout   the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The operation status.
+     * @retval MSG_OK       if the lock has been acquired.
+     * @retval MSG_TIMEOUT  if the lock has not been acquired within the
+     *                      specified timeout.
+     *
+     * @api
+     */
+    msg_t writeLockTimeout(sysinterval_t timeout) {
+
+      return chRWLockWriteLockTimeout(&rwlock, timeout);
+    }
+
+    /**
+     * @brief   Acquires the lock in exclusive mode with timeout specification.
+     *
+     * @param[in] timeout   the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The operation status.
+     * @retval MSG_OK       if the lock has been acquired.
+     * @retval MSG_TIMEOUT  if the lock has not been acquired within the
+     *                      specified timeout.
+     *
+     * @sclass
+     */
+    msg_t writeLockTimeoutS(sysinterval_t timeout) {
+
+      return chRWLockWriteLockTimeoutS(&rwlock, timeout);
+    }
+
+    /**
+     * @brief   Releases the lock from exclusive mode.
+     *
+     * @api
+     */
+    void writeUnlock(void) {
+
+      chRWLockWriteUnlock(&rwlock);
+    }
+
+    /**
+     * @brief   Releases the lock from exclusive mode.
+     * @post    This function does not reschedule so a call to a rescheduling
+     *          function must be performed before unlocking the kernel.
+     *
+     * @sclass
+     */
+    void writeUnlockS(void) {
+
+      chRWLockWriteUnlockS(&rwlock);
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::ReadLocker                                                 *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   RAII helper for reader-writer locks in shared mode.
+   */
+  class ReadLocker
+  {
+    RWLock& rwlock;
+
+  public:
+      ReadLocker(RWLock& l) : rwlock(l) {
+
+        rwlock.readLock();
+      }
+
+      ~ReadLocker() {
+
+        rwlock.readUnlock();
+      }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::WriteLocker                                                *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   RAII helper for reader-writer locks in exclusive mode.
+   */
+  class WriteLocker
+  {
+    RWLock& rwlock;
+
+  public:
+      WriteLocker(RWLock& l) : rwlock(l) {
+
+        rwlock.writeLock();
+      }
+
+      ~WriteLocker() {
+
+        rwlock.writeUnlock();
+      }
+  };
+#endif /* CH_CFG_USE_RWLOCKS == TRUE */
+
 #if (CH_CFG_USE_EVENTS == TRUE) || defined(__DOXYGEN__)
   /*------------------------------------------------------------------------*
    * chibios_rt::EvtListener                                                *
@@ -2911,6 +3146,18 @@ namespace chibios_rt {
 
       chPoolFreeI(&pool, objp);
     }
+
+    /**
+     * @brief   Returns a pointer to the embedded @p memory_pool_t structure.
+     *
+     * @return              The pointer to the memory pool.
+     *
+     * @xclass
+     */
+    memory_pool_t *getPoolX(void) {
+
+      return &pool;
+    }
   };
 
   /*------------------------------------------------------------------------*
@@ -3057,6 +3304,18 @@ namespace chibios_rt {
 
       return chHeapStatus(&heap, &frag, largestp);
     }
+
+    /**
+     * @brief   Returns a pointer to the embedded @p memory_heap_t structure.
+     *
+     * @return              The pointer to the heap.
+     *
+     * @xclass
+     */
+    memory_heap_t *getHeapX(void) {
+
+      return &heap;
+    }
   };
 #endif /* CH_CFG_USE_MEMPOOLS == TRUE */
 
@@ -3125,6 +3384,43 @@ namespace chibios_rt {
      * @api
      */
     virtual msg_t get(void) = 0;
+
+    /**
+     * @brief   Sequential Stream vectored write.
+     * @details The function writes data from a list of buffers to a stream
+     *          as a single operation.
+     *
+     * @param[in] iov       pointer to an array of @p stream_iovec_t elements
+     * @param[in] n         number of elements in the array
+     * @return              The number of bytes transferred.
+     *
+     * @api
+     */
+    virtual size_t writev(const stream_iovec_t *iov, const size_t n) = 0;
+
+    /**
+     * @brief   Sequential Stream get read buffer.
+     * @details The function returns a pointer to the data available in the
+     *          stream internal buffers without copying it.
+     *
+     * @param[out] np       pointer to a variable receiving the number of
+     *                      contiguous bytes available in the buffer
+     * @return              A pointer to the available data.
+     * @retval NULL         if an end-of-file condition has been met or the
+     *                      stream has no internal buffers.
+     *
+     * @api
+     */
+    virtual const uint8_t *getrbuf(size_t *np) = 0;
+
+    /**
+     * @brief   Sequential Stream release read buffer.
+     *
+     * @param[in] n         number of bytes consumed
+     *
+     * @api
+     */
+    virtual void relrbuf(const size_t n) = 0;
   };
 }
 
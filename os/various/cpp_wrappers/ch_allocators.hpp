@@ -0,0 +1,430 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    ch_allocators.hpp
+ * @brief   C++ standard library allocators over the kernel allocators.
+ * @details Allocator adapters usable with the STL containers and, when the
+ *          standard library provides them, polymorphic memory resources:
+ * @code
+ * static chibios_rt::ObjectsPool<node_t, 32> nodes;
+ *
+ * std::list<int, chibios_rt::PoolAllocator<int>>
+ *     l(chibios_rt::PoolAllocator<int>(nodes.getPoolX()));
+ * std::vector<int, chibios_rt::HeapAllocator<int>> v;
+ * @endcode
+ *
+ * @addtogroup cpp_library
+ * @{
+ */
+
+#include <cstddef>
+#include <new>
+
+#include "ch.hpp"
+
+#ifndef _CH_ALLOCATORS_HPP_
+#define _CH_ALLOCATORS_HPP_
+
+#if (__cplusplus >= 201703L) && defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define CH_CPP_HAS_PMR                      TRUE
+#endif
+#endif
+
+#if !defined(CH_CPP_HAS_PMR)
+#define CH_CPP_HAS_PMR                      FALSE
+#endif
+
+namespace chibios_rt {
+
+  /**
+   * @brief   Allocation failure handler.
+   * @details Throws @p std::bad_alloc if exceptions are enabled else the
+   *          system is halted.
+   *
+   * @notapi
+   */
+  [[noreturn]] inline void _allocation_failure(void) {
+
+#if defined(__cpp_exceptions)
+    throw std::bad_alloc();
+#else
+    chSysHalt("out of memory");
+    while (true) {
+    }
+#endif
+  }
+
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::HeapAllocator                                              *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Standard allocator over a @p memory_heap_t.
+   * @note    A @p nullptr heap means the default heap.
+   */
+  template <typename T>
+  class HeapAllocator {
+    template <typename U> friend class HeapAllocator;
+
+    memory_heap_t *heapp;
+
+  public:
+    typedef T value_type;
+
+    /**
+     * @brief   HeapAllocator constructor.
+     *
+     * @param[in] hp        pointer to the heap or @p nullptr for the default
+     *                      heap
+     */
+    HeapAllocator(memory_heap_t *hp = nullptr) noexcept : heapp(hp) {
+    }
+
+    /**
+     * @brief   HeapAllocator constructor.
+     *
+     * @param[in] heap      the heap object
+     */
+    HeapAllocator(Heap &heap) noexcept : heapp(heap.getHeapX()) {
+    }
+
+    /**
+     * @brief   Rebinding constructor.
+     */
+    template <typename U>
+    HeapAllocator(const HeapAllocator<U> &other) noexcept :
+      heapp(other.heapp) {
+    }
+
+    /**
+     * @brief   Allocates an array of @p n objects.
+     */
+    T *allocate(size_t n) {
+      unsigned align = alignof (T) < CH_HEAP_ALIGNMENT ?
+                       CH_HEAP_ALIGNMENT : (unsigned)alignof (T);
+      void *p;
+
+      if (n > (size_t)-1 / sizeof (T)) {
+        _allocation_failure();
+      }
+      p = chHeapAllocAligned(heapp, n * sizeof (T), align);
+      if (p == nullptr) {
+        _allocation_failure();
+      }
+      return static_cast<T *>(p);
+    }
+
+    /**
+     * @brief   Releases an array allocated by @p allocate().
+     */
+    void deallocate(T *p, size_t n) noexcept {
+
+      (void)n;
+      chHeapFree(p);
+    }
+
+    template <typename U>
+    bool operator==(const HeapAllocator<U> &other) const noexcept {
+
+      return heapp == other.heapp;
+    }
+
+    template <typename U>
+    bool operator!=(const HeapAllocator<U> &other) const noexcept {
+
+      return heapp != other.heapp;
+    }
+  };
+#endif /* CH_CFG_USE_HEAP == TRUE */
+
+#if (CH_CFG_USE_MEMPOOLS == TRUE) || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::PoolAllocator                                              *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Standard allocator over a @p memory_pool_t.
+   * @details Only single objects can be allocated, it is meant for node
+   *          based containers like @p std::list, @p std::map and
+   *          @p std::set. The pool objects must be large enough for the
+   *          container nodes, not just for @p T.
+   * @note    The allocation is an O(1) operation.
+   */
+  template <typename T>
+  class PoolAllocator {
+    template <typename U> friend class PoolAllocator;
+
+    memory_pool_t *mp;
+
+  public:
+    typedef T value_type;
+
+    /**
+     * @brief   PoolAllocator constructor.
+     *
+     * @param[in] mp        pointer to the memory pool
+     */
+    PoolAllocator(memory_pool_t *mp) noexcept : mp(mp) {
+    }
+
+    /**
+     * @brief   PoolAllocator constructor.
+     *
+     * @param[in] pool      the memory pool object
+     */
+    PoolAllocator(MemoryPool &pool) noexcept : mp(pool.getPoolX()) {
+    }
+
+    /**
+     * @brief   Rebinding constructor.
+     */
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> &other) noexcept : mp(other.mp) {
+    }
+
+    /**
+     * @brief   Allocates one object.
+     */
+    T *allocate(size_t n) {
+      void *p;
+
+      if ((n != (size_t)1) || (sizeof (T) > mp->object_size) ||
+          (alignof (T) > mp->align)) {
+        _allocation_failure();
+      }
+      p = chPoolAlloc(mp);
+      if (p == nullptr) {
+        _allocation_failure();
+      }
+      return static_cast<T *>(p);
+    }
+
+    /**
+     * @brief   Releases an object allocated by @p allocate().
+     */
+    void deallocate(T *p, size_t n) noexcept {
+
+      (void)n;
+      chPoolFree(mp, p);
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U> &other) const noexcept {
+
+      return mp == other.mp;
+    }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U> &other) const noexcept {
+
+      return mp != other.mp;
+    }
+  };
+#endif /* CH_CFG_USE_MEMPOOLS == TRUE */
+
+#if (CH_CPP_HAS_PMR == TRUE) || defined(__DOXYGEN__)
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::HeapResource                                               *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Memory resource over a @p memory_heap_t.
+   */
+  class HeapResource : public std::pmr::memory_resource {
+    memory_heap_t *heapp;
+
+  public:
+    /**
+     * @brief   HeapResource constructor.
+     *
+     * @param[in] hp        pointer to the heap or @p nullptr for the default
+     *                      heap
+     */
+    HeapResource(memory_heap_t *hp = nullptr) noexcept : heapp(hp) {
+    }
+
+  protected:
+    void *do_allocate(size_t bytes, size_t alignment) override {
+      void *p;
+
+      if (alignment < CH_HEAP_ALIGNMENT) {
+        alignment = CH_HEAP_ALIGNMENT;
+      }
+      p = chHeapAllocAligned(heapp, bytes, (unsigned)alignment);
+      if (p == nullptr) {
+        _allocation_failure();
+      }
+      return p;
+    }
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+
+      (void)bytes;
+      (void)alignment;
+      chHeapFree(p);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other)
+                                                const noexcept override {
+      const HeapResource *hrp = dynamic_cast<const HeapResource *>(&other);
+
+      return (hrp != nullptr) && (hrp->heapp == heapp);
+    }
+  };
+#endif /* CH_CFG_USE_HEAP == TRUE */
+
+#if (CH_CFG_USE_MEMPOOLS == TRUE) || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::PoolResource                                               *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Memory resource over a @p memory_pool_t.
+   * @details Requests not larger than the pool objects are served in O(1),
+   *          larger or more aligned requests fail.
+   */
+  class PoolResource : public std::pmr::memory_resource {
+    memory_pool_t *mp;
+
+  public:
+    /**
+     * @brief   PoolResource constructor.
+     *
+     * @param[in] mp        pointer to the memory pool
+     */
+    PoolResource(memory_pool_t *mp) noexcept : mp(mp) {
+    }
+
+  protected:
+    void *do_allocate(size_t bytes, size_t alignment) override {
+      void *p;
+
+      if ((bytes > mp->object_size) || (alignment > mp->align)) {
+        _allocation_failure();
+      }
+      p = chPoolAlloc(mp);
+      if (p == nullptr) {
+        _allocation_failure();
+      }
+      return p;
+    }
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+
+      (void)bytes;
+      (void)alignment;
+      chPoolFree(mp, p);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other)
+                                                const noexcept override {
+
+      return this == &other;
+    }
+  };
+#endif /* CH_CFG_USE_MEMPOOLS == TRUE */
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::ArenaResource                                              *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Monotonic arena memory resource.
+   * @details Allocations are carved sequentially from a static buffer,
+   *          deallocation does nothing, the whole arena is released at
+   *          once using @p release(). There is no upstream resource, an
+   *          exhausted arena fails the allocation.
+   * @note    Allocations are performed within a short critical zone so the
+   *          arena can be shared among threads.
+   */
+  class ArenaResource : public std::pmr::memory_resource {
+    uint8_t *base;
+    size_t size;
+    size_t next;
+
+  public:
+    /**
+     * @brief   ArenaResource constructor.
+     *
+     * @param[in] buffer    arena buffer base
+     * @param[in] size      arena buffer size
+     */
+    ArenaResource(void *buffer, size_t size) noexcept :
+      base(static_cast<uint8_t *>(buffer)), size(size), next(0) {
+    }
+
+    /**
+     * @brief   Releases all the allocations.
+     * @pre     No allocated object must be in use.
+     *
+     * @api
+     */
+    void release(void) noexcept {
+
+      chSysLock();
+      next = 0;
+      chSysUnlock();
+    }
+
+    /**
+     * @brief   Returns the number of used bytes, alignment gaps included.
+     *
+     * @xclass
+     */
+    size_t getUsedX(void) const noexcept {
+
+      return next;
+    }
+
+  protected:
+    void *do_allocate(size_t bytes, size_t alignment) override {
+      uintptr_t start;
+      void *p = nullptr;
+
+      chSysLock();
+      start = MEM_ALIGN_NEXT((uintptr_t)base + next, alignment);
+      if ((start - (uintptr_t)base <= size) &&
+          (bytes <= size - (start - (uintptr_t)base))) {
+        next = (start - (uintptr_t)base) + bytes;
+        p = reinterpret_cast<void *>(start);
+      }
+      chSysUnlock();
+
+      if (p == nullptr) {
+        _allocation_failure();
+      }
+      return p;
+    }
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+
+      (void)p;
+      (void)bytes;
+      (void)alignment;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other)
+                                                const noexcept override {
+
+      return this == &other;
+    }
+  };
+#endif /* CH_CPP_HAS_PMR == TRUE */
+}
+
+#endif /* _CH_ALLOCATORS_HPP_ */
+
+/** @} */
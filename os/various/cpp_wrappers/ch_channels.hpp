@@ -0,0 +1,267 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    ch_channels.hpp
+ * @brief   Typed messages channels over objects FIFOs.
+ * @details Objects are constructed in place into the channel slots and
+ *          are received as scoped handles, the object is destroyed and its
+ *          slot returned when the handle goes out of scope:
+ * @code
+ * static chibios_rt::Channel<frame_t, 8> frames;
+ *
+ * frames.emplace(TIME_INFINITE, id, payload);
+ *
+ * auto msg = frames.receive();
+ * if (msg) {
+ *   process(msg->payload);
+ * }
+ * @endcode
+ *
+ * @addtogroup cpp_library
+ * @{
+ */
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#include <ch.h>
+
+#ifndef _CH_CHANNELS_HPP_
+#define _CH_CHANNELS_HPP_
+
+#if (CH_CFG_USE_OBJ_FIFOS == TRUE) || defined(__DOXYGEN__)
+
+namespace chibios_rt {
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::Channel                                                    *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Typed messages channel with storage for @p N objects.
+   * @note    The receiving side must be a thread, handles are released
+   *          using API class functions.
+   *
+   * @param T               the objects type
+   * @param N               the number of objects
+   */
+  template <typename T, size_t N>
+  class Channel {
+    static_assert(N > 0U, "zero sized channel");
+
+    /* Free slots hold the pool link so they must be able to contain and
+       be aligned as a pointer.*/
+    static constexpr size_t slot_align =
+        alignof (T) > alignof (void *) ? alignof (T) : alignof (void *);
+    static constexpr size_t slot_size =
+        ((sizeof (T) > sizeof (void *) ? sizeof (T) : sizeof (void *)) +
+         slot_align - 1U) & ~(slot_align - 1U);
+
+    objects_fifo_t          fifo;
+    msg_t                   msgbuf[N];
+    alignas(slot_align) unsigned char slots[N * slot_size];
+
+    void release(T *objp) noexcept {
+
+      objp->~T();
+      chFifoReturnObject(&fifo, static_cast<void *>(objp));
+    }
+
+  public:
+    /**
+     * @brief   Scoped handle to a received object.
+     */
+    class Message {
+      Channel               *chp;
+      T                     *objp;
+
+      friend class Channel;
+
+      Message(Channel *c, T *p) noexcept : chp(c), objp(p) {
+      }
+
+    public:
+      Message(Message &&m) noexcept : chp(m.chp), objp(m.objp) {
+
+        m.objp = nullptr;
+      }
+
+      Message &operator=(Message &&m) noexcept {
+
+        if (this != &m) {
+          reset();
+          chp    = m.chp;
+          objp   = m.objp;
+          m.objp = nullptr;
+        }
+        return *this;
+      }
+
+      Message(const Message &) = delete;
+      Message &operator=(const Message &) = delete;
+
+      ~Message() {
+
+        reset();
+      }
+
+      /**
+       * @brief   Destroys the object and returns its slot.
+       *
+       * @api
+       */
+      void reset(void) noexcept {
+
+        if (objp != nullptr) {
+          chp->release(objp);
+          objp = nullptr;
+        }
+      }
+
+      /**
+       * @brief   Returns @p false if no object has been received.
+       */
+      explicit operator bool(void) const noexcept {
+
+        return objp != nullptr;
+      }
+
+      T *get(void) const noexcept {
+
+        return objp;
+      }
+
+      T &operator*(void) const noexcept {
+
+        return *objp;
+      }
+
+      T *operator->(void) const noexcept {
+
+        return objp;
+      }
+    };
+
+    /**
+     * @brief   Channel constructor.
+     *
+     * @init
+     */
+    Channel(void) noexcept {
+
+      chFifoObjectInit(&fifo, slot_size, N, (unsigned)slot_align,
+                       static_cast<void *>(slots), msgbuf);
+    }
+
+    Channel(const Channel &) = delete;
+    Channel &operator=(const Channel &) = delete;
+
+    /**
+     * @brief   Constructs an object into a free slot and sends it.
+     *
+     * @param[in] timeout   the number of ticks before the operation timeouts
+     *                      waiting for a free slot
+     * @param[in] args      the object constructor arguments
+     * @return              The operation status.
+     * @retval MSG_OK       if the object has been sent.
+     * @retval MSG_TIMEOUT  if a free slot was not available in time.
+     *
+     * @api
+     */
+    template <typename... A>
+    msg_t emplace(sysinterval_t timeout, A &&... args) {
+      void *p = chFifoTakeObjectTimeout(&fifo, timeout);
+
+      if (p == nullptr) {
+        return MSG_TIMEOUT;
+      }
+      chFifoSendObject(&fifo, static_cast<void *>(
+                       new (p) T(std::forward<A>(args)...)));
+
+      return MSG_OK;
+    }
+
+    /**
+     * @brief   Constructs an object into a free slot and sends it.
+     * @note    The object constructor is invoked in I-Locked state.
+     *
+     * @param[in] args      the object constructor arguments
+     * @return              The operation status.
+     * @retval MSG_OK       if the object has been sent.
+     * @retval MSG_TIMEOUT  if a free slot is not available.
+     *
+     * @iclass
+     */
+    template <typename... A>
+    msg_t emplaceI(A &&... args) {
+      void *p = chFifoTakeObjectI(&fifo);
+
+      if (p == nullptr) {
+        return MSG_TIMEOUT;
+      }
+      chFifoSendObjectI(&fifo, static_cast<void *>(
+                        new (p) T(std::forward<A>(args)...)));
+
+      return MSG_OK;
+    }
+
+    /**
+     * @brief   Moves an object into a free slot and sends it.
+     *
+     * @api
+     */
+    msg_t send(T &&obj, sysinterval_t timeout = TIME_INFINITE) {
+
+      return emplace(timeout, std::move(obj));
+    }
+
+    /**
+     * @brief   Copies an object into a free slot and sends it.
+     *
+     * @api
+     */
+    msg_t send(const T &obj, sysinterval_t timeout = TIME_INFINITE) {
+
+      return emplace(timeout, obj);
+    }
+
+    /**
+     * @brief   Receives an object.
+     *
+     * @param[in] timeout   the number of ticks before the operation timeouts
+     * @return              A scoped handle to the object, the handle is
+     *                      empty if the operation timed out.
+     *
+     * @api
+     */
+    Message receive(sysinterval_t timeout = TIME_INFINITE) noexcept {
+      void *p;
+
+      if (chFifoReceiveObjectTimeout(&fifo, &p, timeout) != MSG_OK) {
+        return Message(this, nullptr);
+      }
+
+      return Message(this, static_cast<T *>(p));
+    }
+  };
+}
+
+#endif /* CH_CFG_USE_OBJ_FIFOS == TRUE */
+
+#endif /* _CH_CHANNELS_HPP_ */
+
+/** @} */
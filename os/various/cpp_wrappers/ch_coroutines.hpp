@@ -0,0 +1,723 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    ch_coroutines.hpp
+ * @brief   C++20 coroutines executor and awaitables.
+ * @details Coroutines are resumed by one or more executor threads and
+ *          share their stacks, a suspended coroutine only uses its heap
+ *          allocated frame. Objects that can be awaited are coroutine
+ *          aware versions of the kernel objects, kernel semaphores and
+ *          mailboxes cannot be awaited because they block the calling
+ *          thread:
+ * @code
+ * static chibios_rt::co::Executor exec;
+ * static chibios_rt::co::Signal spi_done;
+ *
+ * static void spicb(SPIDriver *spip) {
+ *
+ *   chSysLockFromISR();
+ *   spi_done.signalI(MSG_OK);
+ *   chSysUnlockFromISR();
+ * }
+ *
+ * static chibios_rt::co::Task poller(void) {
+ *
+ *   while (true) {
+ *     spiStartExchange(&SPID1, 16, txbuf, rxbuf);
+ *     co_await spi_done.wait();
+ *     co_await chibios_rt::co::sleep(TIME_MS2I(10));
+ *   }
+ * }
+ *
+ * exec.spawn(poller());
+ * exec.run();
+ * @endcode
+ *
+ * @addtogroup cpp_library
+ * @{
+ */
+
+#include <ch.h>
+
+#ifndef _CH_COROUTINES_HPP_
+#define _CH_COROUTINES_HPP_
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#define CH_CPP_HAS_COROUTINES               TRUE
+#endif
+#endif
+
+#if !defined(CH_CPP_HAS_COROUTINES)
+#define CH_CPP_HAS_COROUTINES               FALSE
+#endif
+
+#if (CH_CPP_HAS_COROUTINES == TRUE) || defined(__DOXYGEN__)
+
+#if CH_CFG_USE_SEMAPHORES == FALSE
+#error "C++ coroutines require CH_CFG_USE_SEMAPHORES"
+#endif
+
+#if CH_CFG_USE_HEAP == FALSE
+#error "C++ coroutines require CH_CFG_USE_HEAP"
+#endif
+
+namespace chibios_rt {
+
+/**
+ * @brief   Coroutines support.
+ */
+namespace co {
+
+  class Executor;
+
+  /**
+   * @brief   Suspended coroutine descriptor.
+   * @details Waiters are embedded in the awaitables and live in the
+   *          coroutine frame while the coroutine is suspended.
+   */
+  struct Waiter {
+    Waiter                  *next;
+    std::coroutine_handle<> handle;
+    Executor                *exec;
+    msg_t                   msg;
+  };
+
+  /**
+   * @brief   Waiters FIFO.
+   */
+  struct WaitersQueue {
+    Waiter                  *head = nullptr;
+    Waiter                  *tail = nullptr;
+
+    bool isEmpty(void) const noexcept {
+
+      return head == nullptr;
+    }
+
+    void insert(Waiter *wp) noexcept {
+
+      wp->next = nullptr;
+      if (tail == nullptr) {
+        head = wp;
+      }
+      else {
+        tail->next = wp;
+      }
+      tail = wp;
+    }
+
+    Waiter *remove(void) noexcept {
+      Waiter *wp = head;
+
+      if (wp != nullptr) {
+        head = wp->next;
+        if (head == nullptr) {
+          tail = nullptr;
+        }
+      }
+      return wp;
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::co::Executor                                               *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Coroutines executor.
+   * @details Ready coroutines are resumed in FIFO order by the threads
+   *          invoking @p run(), more threads can serve the same executor.
+   */
+  class Executor {
+    WaitersQueue            ready;
+    semaphore_t             sem;
+
+  public:
+    Executor(void) noexcept {
+
+      chSemObjectInit(&sem, (cnt_t)0);
+    }
+
+    Executor(const Executor &) = delete;
+    Executor &operator=(const Executor &) = delete;
+
+    /**
+     * @brief   Makes a suspended coroutine ready.
+     *
+     * @param[in] wp        the suspended coroutine waiter
+     * @param[in] msg       the message returned by the awaitable
+     *
+     * @iclass
+     */
+    void readyI(Waiter *wp, msg_t msg) noexcept {
+
+      chDbgCheckClassI();
+
+      wp->msg = msg;
+      ready.insert(wp);
+      chSemSignalI(&sem);
+    }
+
+    /**
+     * @brief   Executor loop, it never returns.
+     *
+     * @api
+     */
+    [[noreturn]] void run(void) noexcept {
+
+      while (true) {
+        Waiter *wp;
+
+        (void) chSemWait(&sem);
+
+        chSysLock();
+        wp = ready.remove();
+        chSysUnlock();
+
+        if (wp != nullptr) {
+          wp->handle.resume();
+        }
+      }
+    }
+
+    /**
+     * @brief   Static loop function for @p chThdCreateStatic().
+     *
+     * @param[in] p         pointer to the executor
+     */
+    static void thread(void *p) {
+
+      static_cast<Executor *>(p)->run();
+    }
+
+    inline bool spawn(class Task &&task) noexcept;
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::co::Task                                                   *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Coroutine return type.
+   * @details Frames are allocated from the default heap, the coroutine
+   *          frame is released when the coroutine returns.
+   */
+  class Task {
+  public:
+    struct promise_type {
+      Waiter                waiter;
+
+      static void *operator new(size_t size) noexcept {
+
+        return chHeapAlloc(NULL, size);
+      }
+
+      static void operator delete(void *p) noexcept {
+
+        chHeapFree(p);
+      }
+
+      static Task get_return_object_on_allocation_failure(void) noexcept {
+
+        return Task(nullptr);
+      }
+
+      Task get_return_object(void) noexcept {
+
+        return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+      }
+
+      std::suspend_always initial_suspend(void) noexcept {
+
+        return {};
+      }
+
+      std::suspend_never final_suspend(void) noexcept {
+
+        return {};
+      }
+
+      void return_void(void) noexcept {
+      }
+
+      void unhandled_exception(void) noexcept {
+
+        chSysHalt("coroutine exception");
+      }
+    };
+
+    using handle_t = std::coroutine_handle<promise_type>;
+
+  private:
+    handle_t                handle;
+
+    explicit Task(handle_t h) noexcept : handle(h) {
+    }
+
+    explicit Task(std::nullptr_t) noexcept : handle(nullptr) {
+    }
+
+    friend class Executor;
+
+  public:
+    Task(Task &&t) noexcept : handle(t.handle) {
+
+      t.handle = nullptr;
+    }
+
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    ~Task() {
+
+      /* A coroutine never started is destroyed with its owner.*/
+      if (handle) {
+        handle.destroy();
+      }
+    }
+
+    /**
+     * @brief   Returns @p false if the frame allocation failed.
+     */
+    bool isValid(void) const noexcept {
+
+      return (bool)handle;
+    }
+  };
+
+  /**
+   * @brief   Starts a coroutine on this executor.
+   *
+   * @param[in] task        the coroutine
+   * @return                The operation status.
+   * @retval false          if the coroutine frame allocation failed.
+   *
+   * @api
+   */
+  inline bool Executor::spawn(Task &&task) noexcept {
+    Task::handle_t h = task.handle;
+
+    if (!h) {
+      return false;
+    }
+    task.handle = nullptr;
+
+    h.promise().waiter.handle = h;
+    h.promise().waiter.exec   = this;
+
+    chSysLock();
+    readyI(&h.promise().waiter, MSG_OK);
+    chSchRescheduleS();
+    chSysUnlock();
+
+    return true;
+  }
+
+  /**
+   * @brief   Base of the awaitables.
+   * @details Binds the waiter to the calling coroutine and its executor.
+   *
+   * @notapi
+   */
+  class Awaitable {
+  protected:
+    Waiter                  waiter;
+
+    void bind(Task::handle_t h) noexcept {
+
+      waiter.handle = h;
+      waiter.exec   = h.promise().waiter.exec;
+    }
+
+  public:
+    /**
+     * @brief   Resumes a coroutine suspended on an awaitable.
+     *
+     * @iclass
+     */
+    static void wakeupI(Waiter *wp, msg_t msg) noexcept {
+
+      wp->exec->readyI(wp, msg);
+    }
+
+    msg_t await_resume(void) const noexcept {
+
+      return waiter.msg;
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::co::sleep                                                  *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Sleep awaitable over a virtual timer.
+   */
+  class SleepAwaitable : public Awaitable {
+    virtual_timer_t         vt;
+    sysinterval_t           interval;
+
+    static void wakeup(void *p) {
+      SleepAwaitable *sap = static_cast<SleepAwaitable *>(p);
+
+      chSysLockFromISR();
+      wakeupI(&sap->waiter, MSG_TIMEOUT);
+      chSysUnlockFromISR();
+    }
+
+  public:
+    explicit SleepAwaitable(sysinterval_t time) noexcept : interval(time) {
+
+      chVTObjectInit(&vt);
+    }
+
+    bool await_ready(void) const noexcept {
+
+      return interval == TIME_IMMEDIATE;
+    }
+
+    void await_suspend(Task::handle_t h) noexcept {
+
+      bind(h);
+
+      chSysLock();
+      chVTSetI(&vt, interval, wakeup, this);
+      chSysUnlock();
+    }
+  };
+
+  /**
+   * @brief   Suspends the coroutine for the specified time interval.
+   *
+   * @param[in] time        the delay in system ticks, @p TIME_INFINITE is
+   *                        not allowed
+   *
+   * @api
+   */
+  inline SleepAwaitable sleep(sysinterval_t time) noexcept {
+
+    chDbgCheck(time != TIME_INFINITE);
+
+    return SleepAwaitable(time);
+  }
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::co::Signal                                                 *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Completion signal usable from driver callbacks.
+   * @details Single waiter, a signal sent while no coroutine is waiting is
+   *          kept and returned by the next wait.
+   */
+  class Signal {
+    Waiter                  *waiting = nullptr;
+    bool                    pending = false;
+    msg_t                   msg = MSG_OK;
+
+  public:
+    class WaitAwaitable : public Awaitable {
+      Signal                &sig;
+
+    public:
+      explicit WaitAwaitable(Signal &s) noexcept : sig(s) {
+      }
+
+      bool await_ready(void) const noexcept {
+
+        return false;
+      }
+
+      bool await_suspend(Task::handle_t h) noexcept {
+
+        bind(h);
+
+        chSysLock();
+        if (sig.pending) {
+          sig.pending = false;
+          waiter.msg  = sig.msg;
+          chSysUnlock();
+          return false;
+        }
+        chDbgAssert(sig.waiting == nullptr, "already waiting");
+        sig.waiting = &waiter;
+        chSysUnlock();
+
+        return true;
+      }
+    };
+
+    /**
+     * @brief   Waits for the signal.
+     * @return              The message passed to @p signalI().
+     *
+     * @api
+     */
+    WaitAwaitable wait(void) noexcept {
+
+      return WaitAwaitable(*this);
+    }
+
+    /**
+     * @brief   Sends the signal.
+     *
+     * @param[in] m         the message to be returned by the wait
+     *
+     * @iclass
+     */
+    void signalI(msg_t m) noexcept {
+      Waiter *wp = waiting;
+
+      if (wp != nullptr) {
+        waiting = nullptr;
+        Awaitable::wakeupI(wp, m);
+      }
+      else {
+        pending = true;
+        msg     = m;
+      }
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::co::Semaphore                                              *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Counting semaphore for coroutines.
+   * @details Coroutines wait, threads and ISRs can signal.
+   */
+  class Semaphore {
+    WaitersQueue            queue;
+    cnt_t                   cnt;
+
+  public:
+    explicit Semaphore(cnt_t n) noexcept : cnt(n) {
+
+      chDbgCheck(n >= (cnt_t)0);
+    }
+
+    class WaitAwaitable : public Awaitable {
+      Semaphore             &sem;
+
+    public:
+      explicit WaitAwaitable(Semaphore &s) noexcept : sem(s) {
+      }
+
+      bool await_ready(void) const noexcept {
+
+        return false;
+      }
+
+      bool await_suspend(Task::handle_t h) noexcept {
+
+        bind(h);
+
+        chSysLock();
+        if (sem.cnt > (cnt_t)0) {
+          sem.cnt--;
+          waiter.msg = MSG_OK;
+          chSysUnlock();
+          return false;
+        }
+        sem.queue.insert(&waiter);
+        chSysUnlock();
+
+        return true;
+      }
+    };
+
+    /**
+     * @brief   Waits on the semaphore.
+     *
+     * @api
+     */
+    WaitAwaitable wait(void) noexcept {
+
+      return WaitAwaitable(*this);
+    }
+
+    /**
+     * @brief   Signals the semaphore.
+     *
+     * @iclass
+     */
+    void signalI(void) noexcept {
+      Waiter *wp = queue.remove();
+
+      chDbgCheckClassI();
+
+      if (wp != nullptr) {
+        Awaitable::wakeupI(wp, MSG_OK);
+      }
+      else {
+        cnt++;
+      }
+    }
+
+    /**
+     * @brief   Signals the semaphore.
+     *
+     * @api
+     */
+    void signal(void) noexcept {
+
+      chSysLock();
+      signalI();
+      chSchRescheduleS();
+      chSysUnlock();
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::co::Mailbox                                                *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Mailbox for coroutines.
+   * @details Coroutines fetch, threads and ISRs post without blocking. A
+   *          message posted while a coroutine is waiting is passed to it
+   *          directly.
+   *
+   * @param T               the messages type, it must fit a @p msg_t
+   * @param N               the mailbox size
+   */
+  template <typename T, size_t N>
+  class Mailbox {
+    static_assert(sizeof (T) <= sizeof (msg_t),
+                  "Mailbox type does not fit in msg_t");
+    static_assert(N > 0U, "zero sized mailbox");
+
+    msg_t                   buf[N];
+    size_t                  rd = 0U;
+    size_t                  cnt = 0U;
+    WaitersQueue            queue;
+
+    static msg_t tomsg(T v) noexcept {
+      msg_t m = 0;
+
+      __builtin_memcpy(&m, &v, sizeof (T));
+      return m;
+    }
+
+    static T fromMsg(msg_t m) noexcept {
+      T v;
+
+      __builtin_memcpy(&v, &m, sizeof (T));
+      return v;
+    }
+
+  public:
+    class FetchAwaitable : public Awaitable {
+      Mailbox               &mb;
+
+    public:
+      explicit FetchAwaitable(Mailbox &m) noexcept : mb(m) {
+      }
+
+      bool await_ready(void) const noexcept {
+
+        return false;
+      }
+
+      bool await_suspend(Task::handle_t h) noexcept {
+
+        bind(h);
+
+        chSysLock();
+        if (mb.cnt > 0U) {
+          waiter.msg = mb.buf[mb.rd];
+          mb.rd = (mb.rd + 1U) % N;
+          mb.cnt--;
+          chSysUnlock();
+          return false;
+        }
+        mb.queue.insert(&waiter);
+        chSysUnlock();
+
+        return true;
+      }
+
+      T await_resume(void) const noexcept {
+
+        return fromMsg(waiter.msg);
+      }
+    };
+
+    /**
+     * @brief   Fetches a message.
+     *
+     * @api
+     */
+    FetchAwaitable fetch(void) noexcept {
+
+      return FetchAwaitable(*this);
+    }
+
+    /**
+     * @brief   Posts a message.
+     *
+     * @param[in] msg       the message
+     * @return              The operation status.
+     * @retval MSG_OK       if the message has been posted.
+     * @retval MSG_TIMEOUT  if the mailbox is full.
+     *
+     * @iclass
+     */
+    msg_t postI(T msg) noexcept {
+      Waiter *wp = queue.remove();
+
+      chDbgCheckClassI();
+
+      if (wp != nullptr) {
+        Awaitable::wakeupI(wp, tomsg(msg));
+        return MSG_OK;
+      }
+      if (cnt >= N) {
+        return MSG_TIMEOUT;
+      }
+      buf[(rd + cnt) % N] = tomsg(msg);
+      cnt++;
+
+      return MSG_OK;
+    }
+
+    /**
+     * @brief   Posts a message.
+     *
+     * @param[in] msg       the message
+     * @return              The operation status.
+     * @retval MSG_OK       if the message has been posted.
+     * @retval MSG_TIMEOUT  if the mailbox is full.
+     *
+     * @api
+     */
+    msg_t post(T msg) noexcept {
+      msg_t rdy;
+
+      chSysLock();
+      rdy = postI(msg);
+      chSchRescheduleS();
+      chSysUnlock();
+
+      return rdy;
+    }
+  };
+}
+}
+
+#endif /* CH_CPP_HAS_COROUTINES == TRUE */
+
+#endif /* _CH_COROUTINES_HPP_ */
+
+/** @} */
@@ -0,0 +1,561 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    ch_format.hpp
+ * @brief   Compile-time checked formatted output.
+ * @details The format string is parsed at compile time, the conversions
+ *          are checked against the arguments types and each argument is
+ *          formatted by an emitter selected by its type, there is no
+ *          runtime format parsing and no varargs promotion. The syntax
+ *          is the one of @p chprintf() except that the @p * width and
+ *          precision are not supported, the output is buffered and
+ *          written to the stream in chunks:
+ * @code
+ * chibios_rt::print(chp, CH_FMT("t=%u v=%.3f %s\r\n"), t, v, name);
+ * @endcode
+ * @note    Requires C++14.
+ *
+ * @addtogroup cpp_library
+ * @{
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "hal.h"
+#include "chprintf.h"
+
+#ifndef _CH_FORMAT_HPP_
+#define _CH_FORMAT_HPP_
+
+/**
+ * @brief   Output buffer size.
+ * @details The formatted output is accumulated in a buffer allocated on
+ *          the stack and written to the stream in blocks.
+ */
+#if !defined(CH_FORMAT_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define CH_FORMAT_BUFFER_SIZE           32
+#endif
+
+/**
+ * @brief   Compile-time format string.
+ * @details Wraps a string literal into a type so the format string can be
+ *          parsed at compile time.
+ *
+ * @param[in] s         the format string literal
+ */
+#define CH_FMT(s)                                                           \
+  ([] {                                                                     \
+    struct _ch_fmt {                                                        \
+      static constexpr const char *get(void) {                              \
+        return s;                                                           \
+      }                                                                     \
+    };                                                                      \
+    return _ch_fmt{};                                                       \
+  }())
+
+namespace chibios_rt {
+
+  namespace format_detail {
+
+    /**
+     * @brief   Conversion specification.
+     */
+    struct Spec {
+      /**
+       * @brief   Position of the @p % character.
+       */
+      unsigned                  begin = 0U;
+      /**
+       * @brief   Position after the conversion character.
+       */
+      unsigned                  end = 0U;
+      /**
+       * @brief   Conversion character, zero if not found.
+       */
+      char                      conv = '\0';
+      /**
+       * @brief   Left alignment.
+       */
+      bool                      left = false;
+      /**
+       * @brief   Filler character.
+       */
+      char                      filler = ' ';
+      /**
+       * @brief   Field width.
+       */
+      unsigned                  width = 0U;
+      /**
+       * @brief   Precision.
+       */
+      unsigned                  precision = 0U;
+      /**
+       * @brief   Use of an unsupported @p * field.
+       */
+      bool                      star = false;
+    };
+
+    /**
+     * @brief   Parses the conversion specification @p n.
+     * @details A @p %% sequence is not a conversion, if the specification
+     *          does not exist the returned one has @p begin and @p end at
+     *          the end of the string.
+     */
+    constexpr Spec find(const char *s, unsigned n) {
+      unsigned i = 0U;
+
+      while (s[i] != '\0') {
+        Spec sp;
+
+        if (s[i] != '%') {
+          i++;
+          continue;
+        }
+        if (s[i + 1U] == '%') {
+          i += 2U;
+          continue;
+        }
+        sp.begin = i++;
+        if (s[i] == '-') {
+          sp.left = true;
+          i++;
+        }
+        if (s[i] == '0') {
+          sp.filler = '0';
+          i++;
+        }
+        while (((s[i] >= '0') && (s[i] <= '9')) || (s[i] == '*')) {
+          sp.star  = sp.star || (s[i] == '*');
+          sp.width = (sp.width * 10U) + (unsigned)(s[i] - '0');
+          i++;
+        }
+        if (s[i] == '.') {
+          i++;
+          while (((s[i] >= '0') && (s[i] <= '9')) || (s[i] == '*')) {
+            sp.star      = sp.star || (s[i] == '*');
+            sp.precision = (sp.precision * 10U) + (unsigned)(s[i] - '0');
+            i++;
+          }
+        }
+        if ((s[i] == 'l') || (s[i] == 'L')) {
+          i++;
+        }
+        sp.conv = s[i];
+        if (s[i] != '\0') {
+          i++;
+        }
+        sp.end = i;
+        if (n == 0U) {
+          return sp;
+        }
+        n--;
+      }
+
+      Spec sp;
+      sp.begin = i;
+      sp.end   = i;
+      return sp;
+    }
+
+    /**
+     * @brief   Counts the conversion specifications.
+     */
+    constexpr unsigned count(const char *s) {
+      unsigned n = 0U;
+
+      while (find(s, n).conv != '\0') {
+        n++;
+      }
+      return n;
+    }
+
+    /**
+     * @brief   Type an argument is converted to before formatting.
+     */
+    template <typename T, bool = std::is_integral<T>::value>
+    struct arg_type {
+      typedef typename std::conditional<
+                std::is_floating_point<T>::value, float,
+                typename std::conditional<
+                  std::is_convertible<T, const char *>::value,
+                  const char *, void>::type>::type type;
+    };
+
+    template <typename T>
+    struct arg_type<T, true> {
+      typedef typename std::conditional<
+                std::is_signed<T>::value,
+                typename std::conditional<(sizeof (T) <= 4U),
+                                          int32_t, int64_t>::type,
+                typename std::conditional<(sizeof (T) <= 4U),
+                                          uint32_t, uint64_t>::type>::type
+              type;
+    };
+
+    /**
+     * @brief   Checks a conversion against an argument type.
+     */
+    template <typename T>
+    constexpr bool accepts(const Spec &sp) {
+      typedef typename arg_type<typename std::decay<T>::type>::type A;
+
+      if (sp.star) {
+        return false;
+      }
+      switch (sp.conv) {
+      case 'd':
+      case 'D':
+      case 'i':
+      case 'I':
+      case 'u':
+      case 'U':
+      case 'x':
+      case 'X':
+      case 'o':
+      case 'O':
+      case 'q':
+      case 'Q':
+      case 'c':
+        return std::is_integral<A>::value;
+      case 'f':
+        return std::is_floating_point<A>::value;
+      case 's':
+        return std::is_same<A, const char *>::value;
+      default:
+        return false;
+      }
+    }
+
+    template <typename F>
+    constexpr bool check_args(unsigned i) {
+
+      return count(F::get()) == i;
+    }
+
+    template <typename F, typename T, typename... A>
+    constexpr bool check_args(unsigned i) {
+
+      return accepts<T>(find(F::get(), i)) && check_args<F, A...>(i + 1U);
+    }
+
+    /**
+     * @brief   Buffered stream writer.
+     */
+    template <size_t N>
+    class Writer {
+      BaseSequentialStream      *chp;
+      size_t                    n;
+      int                       total;
+      uint8_t                   buf[N];
+
+    public:
+      Writer(BaseSequentialStream *chp) : chp(chp), n(0U), total(0) {
+      }
+
+      void flush(void) {
+
+        if (n > 0U) {
+          (void) streamWrite(chp, buf, n);
+          n = 0U;
+        }
+      }
+
+      void put(char c) {
+
+        buf[n++] = (uint8_t)c;
+        total++;
+        if (n >= N) {
+          flush();
+        }
+      }
+
+      void fill(char c, unsigned cnt) {
+
+        while (cnt-- > 0U) {
+          put(c);
+        }
+      }
+
+      /**
+       * @brief   Writes a literal part of the format string.
+       * @details The @p %% sequences are written as a single @p %.
+       */
+      void literal(const char *s, unsigned from, unsigned to) {
+
+        while (from < to) {
+          if ((s[from] == '%') && (s[from + 1U] == '%')) {
+            from++;
+          }
+          put(s[from++]);
+        }
+      }
+
+      /**
+       * @brief   Writes a formatted field with padding.
+       */
+      void field(const Spec &sp, const char *s, unsigned len) {
+        unsigned pad = sp.width > len ? sp.width - len : 0U;
+
+        if (!sp.left) {
+          if ((*s == '-') && (sp.filler == '0')) {
+            put(*s++);
+            len--;
+          }
+          fill(sp.filler, pad);
+        }
+        while (len-- > 0U) {
+          put(*s++);
+        }
+        if (sp.left) {
+          fill(sp.filler, pad);
+        }
+      }
+
+      int finish(void) {
+
+        flush();
+        return total;
+      }
+    };
+
+    /**
+     * @brief   Unsigned conversion, returns the start of the digits.
+     * @details Digits are generated backward from @p end.
+     */
+    template <typename U>
+    inline char *utoa(char *end, U num, unsigned radix) {
+
+      do {
+        unsigned d = (unsigned)(num % (U)radix);
+        *--end = (char)(d < 10U ? '0' + d : 'A' + (d - 10U));
+        num /= (U)radix;
+      } while (num != 0U);
+      return end;
+    }
+
+    /**
+     * @brief   Minimum digits unsigned decimal conversion.
+     */
+    inline char *utoa10(char *end, uint32_t num, unsigned mindigits) {
+      char *p = utoa(end, num, 10U);
+
+      while ((unsigned)(end - p) < mindigits) {
+        *--p = '0';
+      }
+      return p;
+    }
+
+    inline unsigned radix(char conv) {
+
+      return (conv == 'x') || (conv == 'X') ? 16U :
+             (conv == 'o') || (conv == 'O') ? 8U : 10U;
+    }
+
+    /**
+     * @brief   Fixed point conversion.
+     */
+    inline char *qtoa(char *end, uint32_t num, const Spec &sp) {
+      static const uint32_t pow10[9] = {
+        10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+        1000000000
+      };
+      unsigned fbits = sp.conv == 'Q' ? 31U : 15U;
+      unsigned precision = sp.precision;
+      uint32_t mask = ((uint32_t)1U << fbits) - 1U;
+      char *p;
+
+      if ((precision == 0U) || (precision > 9U)) {
+        precision = sp.conv == 'Q' ? 9U : 5U;
+      }
+      p = utoa10(end, (uint32_t)(((uint64_t)(num & mask) *
+                                  pow10[precision - 1U]) >> fbits),
+                 precision);
+      *--p = '.';
+      return utoa(p, num >> fbits, 10U);
+    }
+
+    template <size_t N, typename U>
+    inline void emit_unsigned(Writer<N> &w, const Spec &sp, U v, bool neg) {
+      char buf[40];
+      char *end = buf + sizeof buf;
+      char *p;
+
+      if (sp.conv == 'c') {
+        buf[0] = (char)v;
+        w.field(sp, buf, 1U);
+        return;
+      }
+      if ((sp.conv == 'q') || (sp.conv == 'Q')) {
+        p = qtoa(end, (uint32_t)v, sp);
+      }
+      else {
+        p = utoa(end, v, radix(sp.conv));
+      }
+      if (neg) {
+        *--p = '-';
+      }
+      w.field(sp, p, (unsigned)(end - p));
+    }
+
+    /**
+     * @name    Typed emitters
+     * @{
+     */
+    template <size_t N>
+    inline void emit(Writer<N> &w, const Spec &sp, uint32_t v) {
+
+      emit_unsigned(w, sp, v, false);
+    }
+
+    template <size_t N>
+    inline void emit(Writer<N> &w, const Spec &sp, int32_t v) {
+
+      if ((v < 0) && (sp.conv != 'c') && (radix(sp.conv) == 10U)) {
+        emit_unsigned(w, sp, 0U - (uint32_t)v, true);
+      }
+      else {
+        emit_unsigned(w, sp, (uint32_t)v, false);
+      }
+    }
+
+    template <size_t N>
+    inline void emit(Writer<N> &w, const Spec &sp, uint64_t v) {
+
+      if ((v >> 32) == 0U) {
+        emit_unsigned(w, sp, (uint32_t)v, false);
+      }
+      else {
+        emit_unsigned(w, sp, v, false);
+      }
+    }
+
+    template <size_t N>
+    inline void emit(Writer<N> &w, const Spec &sp, int64_t v) {
+
+      if ((v < 0) && (sp.conv != 'c') && (radix(sp.conv) == 10U)) {
+        emit_unsigned(w, sp, 0U - (uint64_t)v, true);
+      }
+      else {
+        emit(w, sp, (uint64_t)v);
+      }
+    }
+
+    template <size_t N>
+    inline void emit(Writer<N> &w, const Spec &sp, float v) {
+      static const uint32_t pow10[9] = {
+        10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+        1000000000
+      };
+      unsigned precision = sp.precision;
+      char buf[32];
+      char *end = buf + sizeof buf;
+      char *p;
+      bool neg = v < 0.0f;
+      uint32_t l;
+
+      if ((precision == 0U) || (precision > 9U)) {
+        precision = 9U;
+      }
+      if (neg) {
+        v = -v;
+      }
+      l = (uint32_t)v;
+      p = utoa10(end, (uint32_t)((v - (float)l) *
+                                 (float)pow10[precision - 1U]), precision);
+      *--p = '.';
+      p = utoa(p, l, 10U);
+      if (neg) {
+        *--p = '-';
+      }
+      w.field(sp, p, (unsigned)(end - p));
+    }
+
+    template <size_t N>
+    inline void emit(Writer<N> &w, const Spec &sp, const char *s) {
+      unsigned len = 0U;
+      unsigned max = sp.precision == 0U ? 32767U : sp.precision;
+      Spec fsp = sp;
+
+      if (s == nullptr) {
+        s = "(null)";
+      }
+      while ((len < max) && (s[len] != '\0')) {
+        len++;
+      }
+      fsp.filler = ' ';
+      w.field(fsp, s, len);
+    }
+    /** @} */
+
+    /**
+     * @brief   Formats the argument @p I.
+     * @details The literal text preceding the conversion is written
+     *          first, the conversion is a compile-time constant.
+     */
+    template <typename F, unsigned I, size_t N, typename T>
+    inline void format_arg(Writer<N> &w, unsigned &pos, const T &arg) {
+      constexpr Spec sp = find(F::get(), I);
+      typedef typename arg_type<typename std::decay<T>::type>::type A;
+
+      w.literal(F::get(), pos, sp.begin);
+      pos = sp.end;
+      emit(w, sp, static_cast<A>(arg));
+    }
+
+    template <typename F, size_t N, typename... A, size_t... I>
+    inline void format_all(Writer<N> &w, std::index_sequence<I...>,
+                           const A &... args) {
+      unsigned pos = 0U;
+      int seq[] = {0, (format_arg<F, (unsigned)I>(w, pos, args), 0)...};
+
+      (void)seq;
+      w.literal(F::get(), pos, find(F::get(), sizeof... (A)).end);
+    }
+  }
+
+  /**
+   * @brief   Compile-time checked formatted output.
+   * @details The format string is checked against the arguments at
+   *          compile time.
+   *
+   * @param[in] chp         pointer to a @p BaseSequentialStream object
+   * @param[in] fmt         format string, wrapped by @p CH_FMT()
+   * @param[in] args        the arguments
+   * @return                The number of bytes written.
+   *
+   * @api
+   */
+  template <typename F, typename... A>
+  inline int print(BaseSequentialStream *chp, F fmt, const A &... args) {
+    format_detail::Writer<CH_FORMAT_BUFFER_SIZE> w(chp);
+
+    (void)fmt;
+    static_assert(format_detail::check_args<F, A...>(0U),
+                  "format string does not match the arguments");
+
+    format_detail::format_all<F>(w, std::index_sequence_for<A...>{},
+                                 args...);
+    return w.finish();
+  }
+}
+
+#endif /* _CH_FORMAT_HPP_ */
+
+/** @} */
@@ -0,0 +1,405 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    ch_lite.hpp
+ * @brief   Header-only C++ wrappers without virtual functions.
+ * @details The classes in the @p chibios_rt::lite namespace are thin
+ *          templates over the kernel objects, all the calls are resolved
+ *          at compile time and inline completely, there are no virtual
+ *          tables and no out of line code. Threads use the CRTP idiom
+ *          instead of a virtual @p main():
+ * @code
+ * class Blinker : public chibios_rt::lite::Thread<Blinker, 128> {
+ * public:
+ *   void main(void) {
+ *     while (true) {
+ *       chThdSleepMilliseconds(500);
+ *     }
+ *   }
+ * };
+ *
+ * static Blinker blinker;
+ * static chibios_rt::lite::Mailbox<packet_t *, 8> mb;
+ *
+ * blinker.start(NORMALPRIO + 1);
+ * @endcode
+ *
+ * @addtogroup cpp_library
+ * @{
+ */
+
+#include <ch.h>
+
+#ifndef _CH_LITE_HPP_
+#define _CH_LITE_HPP_
+
+/**
+ * @brief   Minimum stack size accepted by the thread templates.
+ * @details The stack size is checked at compile time, the size is the
+ *          space available to the thread code, the port overhead is added
+ *          by @p THD_WORKING_AREA().
+ */
+#if !defined(CH_CPP_LITE_MIN_STACK_SIZE) || defined(__DOXYGEN__)
+#define CH_CPP_LITE_MIN_STACK_SIZE          64U
+#endif
+
+namespace chibios_rt {
+
+/**
+ * @brief   Wrappers without virtual functions.
+ */
+namespace lite {
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::lite::CriticalSectionLocker                                *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   RAII helper for reentrant critical sections.
+   * @details Usable from any context.
+   */
+  class CriticalSectionLocker {
+    const syssts_t sts;
+
+  public:
+    CriticalSectionLocker(void) noexcept : sts(chSysGetStatusAndLockX()) {
+    }
+
+    ~CriticalSectionLocker() {
+
+      chSysRestoreStatusX(sts);
+    }
+
+    CriticalSectionLocker(const CriticalSectionLocker &) = delete;
+    CriticalSectionLocker &operator=(const CriticalSectionLocker &) = delete;
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::lite::SysLocker                                            *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   RAII helper for threads critical sections.
+   * @details Cheaper than @p CriticalSectionLocker, usable from thread
+   *          context only and not reentrant.
+   */
+  class SysLocker {
+  public:
+    SysLocker(void) noexcept {
+
+      chSysLock();
+    }
+
+    ~SysLocker() {
+
+      chSysUnlock();
+    }
+
+    SysLocker(const SysLocker &) = delete;
+    SysLocker &operator=(const SysLocker &) = delete;
+  };
+
+#if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::lite::MutexLocker                                          *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   RAII helper for mutexes.
+   */
+  class MutexLocker {
+    mutex_t &mtx;
+
+  public:
+    MutexLocker(mutex_t &m) noexcept : mtx(m) {
+
+      chMtxLock(&mtx);
+    }
+
+    ~MutexLocker() {
+
+      chMtxUnlock(&mtx);
+    }
+
+    MutexLocker(const MutexLocker &) = delete;
+    MutexLocker &operator=(const MutexLocker &) = delete;
+  };
+#endif /* CH_CFG_USE_MUTEXES == TRUE */
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::lite::Thread                                               *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Static thread template using CRTP.
+   * @details The derived class @p D must implement a non-virtual
+   *          <tt>void main(void)</tt>, the entry point is resolved at
+   *          compile time.
+   *
+   * @param D               the derived class
+   * @param S               the stack size available to the thread
+   */
+  template <typename D, size_t S>
+  class Thread {
+    static_assert(S >= CH_CPP_LITE_MIN_STACK_SIZE,
+                  "thread stack size below CH_CPP_LITE_MIN_STACK_SIZE");
+
+    THD_WORKING_AREA(wa, S);
+
+    static void entry(void *arg) {
+
+      static_cast<D *>(arg)->main();
+    }
+
+  public:
+    /**
+     * @brief   Working area size, port overhead included.
+     */
+    static constexpr size_t working_area_size = sizeof (wa);
+
+    /**
+     * @brief   Starts the thread.
+     *
+     * @param[in] prio      thread priority
+     * @return              The pointer to the @p thread_t structure.
+     *
+     * @api
+     */
+    thread_t *start(tprio_t prio) {
+
+      return chThdCreateStatic(wa, sizeof (wa), prio, entry,
+                               static_cast<D *>(this));
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::lite::StaticThread                                         *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Static thread template over a plain thread function.
+   *
+   * @param F               the thread function
+   * @param S               the stack size available to the thread
+   */
+  template <tfunc_t F, size_t S>
+  class StaticThread {
+    static_assert(F != nullptr, "null thread function");
+    static_assert(S >= CH_CPP_LITE_MIN_STACK_SIZE,
+                  "thread stack size below CH_CPP_LITE_MIN_STACK_SIZE");
+
+    THD_WORKING_AREA(wa, S);
+
+  public:
+    /**
+     * @brief   Working area size, port overhead included.
+     */
+    static constexpr size_t working_area_size = sizeof (wa);
+
+    /**
+     * @brief   Starts the thread.
+     *
+     * @param[in] prio      thread priority
+     * @param[in] arg       the thread function argument
+     * @return              The pointer to the @p thread_t structure.
+     *
+     * @api
+     */
+    thread_t *start(tprio_t prio, void *arg = nullptr) {
+
+      return chThdCreateStatic(wa, sizeof (wa), prio, F, arg);
+    }
+  };
+
+#if (CH_CFG_USE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::lite::Mailbox                                              *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Typed mailbox with its messages buffer.
+   * @details @p T must be a pointer or an integral type fitting a
+   *          @p msg_t, conversions are resolved at compile time and
+   *          generate no code.
+   *
+   * @param T               the messages type
+   * @param N               the mailbox size
+   */
+  template <typename T, size_t N>
+  class Mailbox {
+    static_assert(sizeof (T) <= sizeof (msg_t),
+                  "Mailbox type does not fit in msg_t");
+    static_assert(N > 0U, "zero sized mailbox");
+
+    msg_t                   buf[N];
+    mailbox_t               mb;
+
+    static msg_t tomsg(T v) noexcept {
+      msg_t m = 0;
+
+      __builtin_memcpy(&m, &v, sizeof (T));
+      return m;
+    }
+
+    static T fromMsg(msg_t m) noexcept {
+      T v;
+
+      __builtin_memcpy(&v, &m, sizeof (T));
+      return v;
+    }
+
+  public:
+    /**
+     * @brief   Mailbox constructor.
+     *
+     * @init
+     */
+    Mailbox(void) noexcept {
+
+      chMBObjectInit(&mb, buf, (size_t)N);
+    }
+
+    Mailbox(const Mailbox &) = delete;
+    Mailbox &operator=(const Mailbox &) = delete;
+
+    /**
+     * @brief   Posts a message, see @p chMBPostTimeout().
+     *
+     * @api
+     */
+    msg_t post(T msg, sysinterval_t timeout) noexcept {
+
+      return chMBPostTimeout(&mb, tomsg(msg), timeout);
+    }
+
+    /**
+     * @brief   Posts a message, see @p chMBPostTimeoutS().
+     *
+     * @sclass
+     */
+    msg_t postS(T msg, sysinterval_t timeout) noexcept {
+
+      return chMBPostTimeoutS(&mb, tomsg(msg), timeout);
+    }
+
+    /**
+     * @brief   Posts a message, see @p chMBPostI().
+     *
+     * @iclass
+     */
+    msg_t postI(T msg) noexcept {
+
+      return chMBPostI(&mb, tomsg(msg));
+    }
+
+    /**
+     * @brief   Posts an high priority message, see
+     *          @p chMBPostAheadTimeout().
+     *
+     * @api
+     */
+    msg_t postAhead(T msg, sysinterval_t timeout) noexcept {
+
+      return chMBPostAheadTimeout(&mb, tomsg(msg), timeout);
+    }
+
+    /**
+     * @brief   Posts an high priority message, see @p chMBPostAheadI().
+     *
+     * @iclass
+     */
+    msg_t postAheadI(T msg) noexcept {
+
+      return chMBPostAheadI(&mb, tomsg(msg));
+    }
+
+    /**
+     * @brief   Retrieves a message, see @p chMBFetchTimeout().
+     *
+     * @api
+     */
+    msg_t fetch(T &msg, sysinterval_t timeout) noexcept {
+      msg_t m, rdy;
+
+      rdy = chMBFetchTimeout(&mb, &m, timeout);
+      if (rdy == MSG_OK) {
+        msg = fromMsg(m);
+      }
+      return rdy;
+    }
+
+    /**
+     * @brief   Retrieves a message, see @p chMBFetchTimeoutS().
+     *
+     * @sclass
+     */
+    msg_t fetchS(T &msg, sysinterval_t timeout) noexcept {
+      msg_t m, rdy;
+
+      rdy = chMBFetchTimeoutS(&mb, &m, timeout);
+      if (rdy == MSG_OK) {
+        msg = fromMsg(m);
+      }
+      return rdy;
+    }
+
+    /**
+     * @brief   Retrieves a message, see @p chMBFetchI().
+     *
+     * @iclass
+     */
+    msg_t fetchI(T &msg) noexcept {
+      msg_t m, rdy;
+
+      rdy = chMBFetchI(&mb, &m);
+      if (rdy == MSG_OK) {
+        msg = fromMsg(m);
+      }
+      return rdy;
+    }
+
+    /**
+     * @brief   Resets the mailbox, see @p chMBReset().
+     *
+     * @api
+     */
+    void reset(void) noexcept {
+
+      chMBReset(&mb);
+    }
+
+    /**
+     * @brief   Returns the number of used message slots.
+     *
+     * @iclass
+     */
+    size_t getUsedCountI(void) const noexcept {
+
+      return chMBGetUsedCountI(&mb);
+    }
+
+    /**
+     * @brief   Returns the number of free message slots.
+     *
+     * @iclass
+     */
+    size_t getFreeCountI(void) const noexcept {
+
+      return chMBGetFreeCountI(&mb);
+    }
+  };
+#endif /* CH_CFG_USE_MAILBOXES == TRUE */
+}
+}
+
+#endif /* _CH_LITE_HPP_ */
+
+/** @} */
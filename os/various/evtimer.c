@@ -41,10 +41,45 @@
 /* Module local variables.                                                   */
 /*===========================================================================*/
 
+#if (EVT_CFG_SHARED_TIMERS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   List of the groups owners.
+ */
+static event_timer_t *groups;
+#endif
+
 /*===========================================================================*/
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if EVT_CFG_SHARED_TIMERS == TRUE
+static void tmrcb(void *p) {
+  event_timer_t *etp = p;
+
+  chSysLockFromISR();
+  etp->et_last = chVTGetSystemTimeX();
+  chVTDoSetI(&etp->et_vt, etp->et_interval, tmrcb, etp);
+  do {
+    chEvtBroadcastI(&etp->et_es);
+    etp = etp->et_next;
+  } while (etp != NULL);
+  chSysUnlockFromISR();
+}
+
+/**
+ * @brief   Removes a group owner from the groups list.
+ *
+ * @param[in] etp       pointer to the group owner
+ */
+static void group_remove(event_timer_t *etp) {
+  event_timer_t **pp = &groups;
+
+  while (*pp != etp) {
+    pp = &(*pp)->et_nextgroup;
+  }
+  *pp = etp->et_nextgroup;
+}
+#else
 static void tmrcb(void *p) {
   event_timer_t *etp = p;
 
@@ -53,6 +88,7 @@ static void tmrcb(void *p) {
   chVTDoSetI(&etp->et_vt, etp->et_interval, tmrcb, etp);
   chSysUnlockFromISR();
 }
+#endif
 
 /*===========================================================================*/
 /* Module exported functions.                                                */
@@ -69,6 +105,9 @@ void evtObjectInit(event_timer_t *etp, systime_t time) {
   chEvtObjectInit(&etp->et_es);
   chVTObjectInit(&etp->et_vt);
   etp->et_interval = time;
+#if EVT_CFG_SHARED_TIMERS == TRUE
+  etp->et_owner = NULL;
+#endif
 }
 
 /**
@@ -78,8 +117,88 @@ void evtObjectInit(event_timer_t *etp, systime_t time) {
  * @param[in] etp       pointer to an initialized @p event_timer_t structure.
  */
 void evtStart(event_timer_t *etp) {
+#if EVT_CFG_SHARED_TIMERS == TRUE
+  event_timer_t *owner;
+
+  chSysLock();
+  if (etp->et_owner == NULL) {
+    /* Searching for a running group with the same interval.*/
+    owner = groups;
+    while ((owner != NULL) && (owner->et_interval != etp->et_interval)) {
+      owner = owner->et_nextgroup;
+    }
+
+    if (owner != NULL) {
+      /* Joining the group.*/
+      etp->et_owner  = owner;
+      etp->et_next   = owner->et_next;
+      owner->et_next = etp;
+    }
+    else {
+      /* New group, this timer owns the virtual timer.*/
+      etp->et_owner     = etp;
+      etp->et_next      = NULL;
+      etp->et_nextgroup = groups;
+      groups            = etp;
+      etp->et_last      = chVTGetSystemTimeX();
+      chVTDoSetI(&etp->et_vt, etp->et_interval, tmrcb, etp);
+    }
+  }
+  chSysUnlock();
+#else
 
   chVTSet(&etp->et_vt, etp->et_interval, tmrcb, etp);
+#endif
+}
+
+/**
+ * @brief   Stops the timer.
+ * @details If the timer was already stopped then the function has no effect.
+ *
+ * @param[in] etp       pointer to an initialized @p event_timer_t structure.
+ */
+void evtStop(event_timer_t *etp) {
+#if EVT_CFG_SHARED_TIMERS == TRUE
+  event_timer_t *owner, *next, **pp;
+  sysinterval_t elapsed;
+
+  chSysLock();
+  owner = etp->et_owner;
+  if (owner == etp) {
+    chVTResetI(&etp->et_vt);
+    group_remove(etp);
+
+    /* The next timer in the group, if any, becomes the owner keeping the
+       phase of the group.*/
+    next = etp->et_next;
+    if (next != NULL) {
+      next->et_nextgroup = groups;
+      groups             = next;
+      next->et_last      = etp->et_last;
+      for (owner = next; owner != NULL; owner = owner->et_next) {
+        owner->et_owner = next;
+      }
+      elapsed = chVTTimeElapsedSinceX(next->et_last);
+      chVTDoSetI(&next->et_vt,
+                 elapsed < next->et_interval ? next->et_interval - elapsed :
+                                               (sysinterval_t)1,
+                 tmrcb, next);
+    }
+  }
+  else if (owner != NULL) {
+    /* Leaving the group.*/
+    pp = &owner->et_next;
+    while (*pp != etp) {
+      pp = &(*pp)->et_next;
+    }
+    *pp = etp->et_next;
+  }
+  etp->et_owner = NULL;
+  chSysUnlock();
+#else
+
+  chVTReset(&etp->et_vt);
+#endif
 }
 
 /** @} */
@@ -33,6 +33,19 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Shared virtual timers.
+ * @details If enabled, running event timers having the same interval share
+ *          a single virtual timer, the events of the whole group are
+ *          broadcast from a single callback.
+ * @note    A timer started while another timer of the same interval is
+ *          running joins its phase, the first event can be generated
+ *          earlier than one interval after @p evtStart().
+ */
+#if !defined(EVT_CFG_SHARED_TIMERS) || defined(__DOXYGEN__)
+#define EVT_CFG_SHARED_TIMERS               FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -51,11 +64,35 @@
 /**
  * @brief   Type of a event timer structure.
  */
-typedef struct {
+typedef struct event_timer event_timer_t;
+
+/**
+ * @brief   Structure representing an event timer.
+ */
+struct event_timer {
   virtual_timer_t       et_vt;
   event_source_t        et_es;
   systime_t             et_interval;
-} event_timer_t;
+#if (EVT_CFG_SHARED_TIMERS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Timer owning the virtual timer of the group, @p NULL if the
+   *          timer is stopped.
+   */
+  event_timer_t         *et_owner;
+  /**
+   * @brief   Next timer in the group.
+   */
+  event_timer_t         *et_next;
+  /**
+   * @brief   Next group owner, only used by the owner.
+   */
+  event_timer_t         *et_nextgroup;
+  /**
+   * @brief   Last virtual timer arm time, only used by the owner.
+   */
+  systime_t             et_last;
+#endif
+};
 
 /*===========================================================================*/
 /* Module macros.                                                            */
@@ -70,6 +107,7 @@ extern "C" {
 #endif
   void evtObjectInit(event_timer_t *etp, systime_t time);
   void evtStart(event_timer_t *etp);
+  void evtStop(event_timer_t *etp);
 #ifdef __cplusplus
 }
 #endif
@@ -78,17 +116,6 @@ extern "C" {
 /* Module inline functions.                                                  */
 /*===========================================================================*/
 
-/**
- * @brief   Stops the timer.
- * @details If the timer was already stopped then the function has no effect.
- *
- * @param[in] etp       pointer to an initialized @p event_timer_t structure.
- */
-static inline void evtStop(event_timer_t *etp) {
-
-  chVTReset(&etp->et_vt);
-}
-
 #endif /* EVTIMER_H */
 
 /** @} */
@@ -1,10 +1,12 @@
 # FATFS files.
 FATFSSRC = $(CHIBIOS)/os/various/fatfs_bindings/fatfs_diskio.c \
            $(CHIBIOS)/os/various/fatfs_bindings/fatfs_syscall.c \
+           $(CHIBIOS)/os/various/fatfs_bindings/fatfs_stream.c \
            $(CHIBIOS)/ext/fatfs/src/ff.c \
            $(CHIBIOS)/ext/fatfs/src/ffunicode.c
 
-FATFSINC = $(CHIBIOS)/ext/fatfs/src
+FATFSINC = $(CHIBIOS)/ext/fatfs/src \
+           $(CHIBIOS)/os/various/fatfs_bindings
 
 # Shared variables
 ALLCSRC += $(FATFSSRC)
@@ -5,6 +5,8 @@
 /* disk I/O modules and attach it to FatFs module with common interface. */
 /*-----------------------------------------------------------------------*/
 
+#include <string.h>
+
 #include "hal.h"
 #include "ffconf.h"
 #include "diskio.h"
@@ -33,6 +35,28 @@ extern SDCDriver FATFS_HAL_DEVICE;
 extern RTCDriver RTCD1;
 #endif
 
+/* Number of sectors kept in the LRU sectors cache, zero disables it.*/
+#if !defined(FATFS_CACHE_SECTORS)
+#define FATFS_CACHE_SECTORS 0
+#endif
+
+/* Number of sectors read in advance when consecutive single sectors are
+   requested, it requires an additional buffer of the same size.*/
+#if !defined(FATFS_CACHE_READ_AHEAD)
+#define FATFS_CACHE_READ_AHEAD 0
+#endif
+
+/* Single sector writes are kept in the cache until a CTRL_SYNC or their
+   eviction if enabled, else they are written through.*/
+#if !defined(FATFS_CACHE_WRITE_BACK)
+#define FATFS_CACHE_WRITE_BACK FALSE
+#endif
+
+#if (FATFS_CACHE_SECTORS > 0) && \
+    (FATFS_CACHE_READ_AHEAD >= FATFS_CACHE_SECTORS)
+#error "FATFS_CACHE_READ_AHEAD must be lower than FATFS_CACHE_SECTORS"
+#endif
+
 /*-----------------------------------------------------------------------*/
 /* Correspondence between physical drive number and physical drive.      */
 
@@ -40,6 +64,283 @@ extern RTCDriver RTCD1;
 #define SDC     0
 
 
+/*-----------------------------------------------------------------------*/
+/* Device transfers.                                                     */
+
+static DRESULT device_read (
+    BYTE *buff,       /* Data buffer to store read data */
+    DWORD sector,     /* Sector address (LBA) */
+    UINT count        /* Number of sectors to read */
+)
+{
+#if HAL_USE_MMC_SPI
+  if (mmcStartSequentialRead(&FATFS_HAL_DEVICE, sector))
+    return RES_ERROR;
+  while (count > 0) {
+    if (mmcSequentialRead(&FATFS_HAL_DEVICE, buff))
+      return RES_ERROR;
+    buff += MMCSD_BLOCK_SIZE;
+    count--;
+  }
+  if (mmcStopSequentialRead(&FATFS_HAL_DEVICE))
+      return RES_ERROR;
+  return RES_OK;
+#else
+  if (sdcRead(&FATFS_HAL_DEVICE, sector, buff, count))
+    return RES_ERROR;
+  return RES_OK;
+#endif
+}
+
+#if !FF_FS_READONLY
+static DRESULT device_write (
+    const BYTE *buff, /* Data to be written */
+    DWORD sector,     /* Sector address (LBA) */
+    UINT count        /* Number of sectors to write */
+)
+{
+#if HAL_USE_MMC_SPI
+  if (mmcStartSequentialWrite(&FATFS_HAL_DEVICE, sector))
+      return RES_ERROR;
+  while (count > 0) {
+      if (mmcSequentialWrite(&FATFS_HAL_DEVICE, buff))
+          return RES_ERROR;
+      buff += MMCSD_BLOCK_SIZE;
+      count--;
+  }
+  if (mmcStopSequentialWrite(&FATFS_HAL_DEVICE))
+      return RES_ERROR;
+  return RES_OK;
+#else
+  if (sdcWrite(&FATFS_HAL_DEVICE, sector, buff, count))
+    return RES_ERROR;
+  return RES_OK;
+#endif
+}
+#endif /* !FF_FS_READONLY */
+
+
+#if FATFS_CACHE_SECTORS > 0
+/*-----------------------------------------------------------------------*/
+/* Sectors cache.                                                        */
+
+typedef struct {
+  DWORD         sector;     /* Cached sector address */
+  uint32_t      stamp;      /* Last access time, for LRU replacement */
+  bool          valid;      /* Entry contains a sector */
+  bool          dirty;      /* Sector not yet written to the device */
+  uint32_t      data[MMCSD_BLOCK_SIZE / sizeof (uint32_t)];
+} cache_entry_t;
+
+static cache_entry_t cache[FATFS_CACHE_SECTORS];
+static uint32_t cache_clock;
+
+#if FATFS_CACHE_READ_AHEAD > 0
+static DWORD cache_next;
+static uint32_t cache_ra_buffer[(FATFS_CACHE_READ_AHEAD + 1) *
+                                MMCSD_BLOCK_SIZE / sizeof (uint32_t)];
+#endif
+
+static cache_entry_t *cache_lookup (DWORD sector)
+{
+  unsigned i;
+
+  for (i = 0; i < FATFS_CACHE_SECTORS; i++) {
+    if (cache[i].valid && (cache[i].sector == sector))
+      return &cache[i];
+  }
+  return NULL;
+}
+
+static DRESULT cache_flush_entry (cache_entry_t *cep)
+{
+#if !FF_FS_READONLY
+  if (cep->dirty) {
+    if (device_write((const BYTE *)cep->data, cep->sector, 1) != RES_OK)
+      return RES_ERROR;
+    cep->dirty = false;
+  }
+#else
+  (void)cep;
+#endif
+  return RES_OK;
+}
+
+/* Returns a free entry for the specified sector, the least recently used
+   one is written back if necessary and reused.*/
+static cache_entry_t *cache_alloc (DWORD sector)
+{
+  cache_entry_t *cep = &cache[0];
+  unsigned i;
+
+  for (i = 0; i < FATFS_CACHE_SECTORS; i++) {
+    if (!cache[i].valid) {
+      cep = &cache[i];
+      break;
+    }
+    if (cache[i].stamp < cep->stamp)
+      cep = &cache[i];
+  }
+  if (cep->valid && (cache_flush_entry(cep) != RES_OK))
+    return NULL;
+  cep->sector = sector;
+  cep->valid  = false;
+  cep->dirty  = false;
+  return cep;
+}
+
+static void cache_touch (cache_entry_t *cep)
+{
+  cep->valid = true;
+  cep->stamp = ++cache_clock;
+}
+
+/* Drops the cached sectors in the specified range, dirty ones included.*/
+static void cache_discard (DWORD start, DWORD end)
+{
+  unsigned i;
+
+  for (i = 0; i < FATFS_CACHE_SECTORS; i++) {
+    if ((cache[i].sector >= start) && (cache[i].sector <= end)) {
+      cache[i].valid = false;
+      cache[i].dirty = false;
+    }
+  }
+}
+
+static DRESULT cache_sync (void)
+{
+  DRESULT res = RES_OK;
+  unsigned i;
+
+  for (i = 0; i < FATFS_CACHE_SECTORS; i++) {
+    if (cache[i].valid && (cache_flush_entry(&cache[i]) != RES_OK))
+      res = RES_ERROR;
+  }
+  return res;
+}
+
+#if FATFS_CACHE_READ_AHEAD > 0
+/* Loads the specified sector and the following ones in the cache using
+   a single multi-sector transfer.*/
+static DRESULT cache_read_ahead (DWORD sector)
+{
+  cache_entry_t *cep;
+  unsigned i;
+
+  /* Sectors in the range are written back first, an entry evicted while
+     filling the cache must match the device content.*/
+  for (i = 0; i <= FATFS_CACHE_READ_AHEAD; i++) {
+    cep = cache_lookup(sector + i);
+    if ((cep != NULL) && (cache_flush_entry(cep) != RES_OK))
+      return RES_ERROR;
+  }
+
+  if (device_read((BYTE *)cache_ra_buffer, sector,
+                  FATFS_CACHE_READ_AHEAD + 1) != RES_OK)
+    return RES_ERROR;
+
+  for (i = 0; i <= FATFS_CACHE_READ_AHEAD; i++) {
+    if (cache_lookup(sector + i) == NULL) {
+      cep = cache_alloc(sector + i);
+      if (cep == NULL)
+        return RES_ERROR;
+      memcpy(cep->data, (BYTE *)cache_ra_buffer + i * MMCSD_BLOCK_SIZE,
+             MMCSD_BLOCK_SIZE);
+      cache_touch(cep);
+    }
+  }
+  return RES_OK;
+}
+#endif
+
+static DRESULT cache_read (
+    BYTE *buff,       /* Data buffer to store read data */
+    DWORD sector,     /* Sector address (LBA) */
+    UINT count        /* Number of sectors to read */
+)
+{
+  cache_entry_t *cep;
+  unsigned i;
+
+  if (count == 1) {
+    cep = cache_lookup(sector);
+#if FATFS_CACHE_READ_AHEAD > 0
+    /* Sequential access, the failure of the read ahead is not an error,
+       the transfer could cross the end of the device.*/
+    if ((cep == NULL) && (sector == cache_next) &&
+        (cache_read_ahead(sector) == RES_OK))
+      cep = cache_lookup(sector);
+    cache_next = sector + 1;
+#endif
+    if (cep == NULL) {
+      cep = cache_alloc(sector);
+      if (cep == NULL)
+        return RES_ERROR;
+      if (device_read((BYTE *)cep->data, sector, 1) != RES_OK)
+        return RES_ERROR;
+    }
+    cache_touch(cep);
+    memcpy(buff, cep->data, MMCSD_BLOCK_SIZE);
+    return RES_OK;
+  }
+
+  /* Multiple sectors are read directly from the device then the sectors
+     not yet written back are replaced by their cached copy.*/
+  if (device_read(buff, sector, count) != RES_OK)
+    return RES_ERROR;
+  for (i = 0; i < FATFS_CACHE_SECTORS; i++) {
+    if (cache[i].dirty && (cache[i].sector >= sector) &&
+        (cache[i].sector - sector < count))
+      memcpy(buff + (cache[i].sector - sector) * MMCSD_BLOCK_SIZE,
+             cache[i].data, MMCSD_BLOCK_SIZE);
+  }
+  return RES_OK;
+}
+
+#if !FF_FS_READONLY
+static DRESULT cache_write (
+    const BYTE *buff, /* Data to be written */
+    DWORD sector,     /* Sector address (LBA) */
+    UINT count        /* Number of sectors to write */
+)
+{
+  cache_entry_t *cep;
+  unsigned i;
+
+#if FATFS_CACHE_WRITE_BACK == TRUE
+  if (count == 1) {
+    cep = cache_lookup(sector);
+    if (cep == NULL) {
+      cep = cache_alloc(sector);
+      if (cep == NULL)
+        return RES_ERROR;
+    }
+    memcpy(cep->data, buff, MMCSD_BLOCK_SIZE);
+    cep->dirty = true;
+    cache_touch(cep);
+    return RES_OK;
+  }
+#endif
+
+  /* Written through, the cached copies are updated.*/
+  if (device_write(buff, sector, count) != RES_OK)
+    return RES_ERROR;
+  for (i = 0; i < FATFS_CACHE_SECTORS; i++) {
+    cep = &cache[i];
+    if (cep->valid && (cep->sector >= sector) &&
+        (cep->sector - sector < count)) {
+      memcpy(cep->data, buff + (cep->sector - sector) * MMCSD_BLOCK_SIZE,
+             MMCSD_BLOCK_SIZE);
+      cep->dirty = false;
+    }
+  }
+  return RES_OK;
+}
+#endif /* !FF_FS_READONLY */
+#endif /* FATFS_CACHE_SECTORS > 0 */
+
+
 
 /*-----------------------------------------------------------------------*/
 /* Inidialize a Drive                                                    */
@@ -50,6 +351,11 @@ DSTATUS disk_initialize (
 {
   DSTATUS stat;
 
+#if FATFS_CACHE_SECTORS > 0
+  /* The medium could have been replaced.*/
+  cache_discard(0, (DWORD)-1);
+#endif
+
   switch (pdrv) {
 #if HAL_USE_MMC_SPI
   case MMC:
@@ -124,26 +430,15 @@ DRESULT disk_read (
   switch (pdrv) {
 #if HAL_USE_MMC_SPI
   case MMC:
-    if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
-      return RES_NOTRDY;
-    if (mmcStartSequentialRead(&FATFS_HAL_DEVICE, sector))
-      return RES_ERROR;
-    while (count > 0) {
-      if (mmcSequentialRead(&FATFS_HAL_DEVICE, buff))
-        return RES_ERROR;
-      buff += MMCSD_BLOCK_SIZE;
-      count--;
-    }
-    if (mmcStopSequentialRead(&FATFS_HAL_DEVICE))
-        return RES_ERROR;
-    return RES_OK;
 #else
   case SDC:
+#endif
     if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
       return RES_NOTRDY;
-    if (sdcRead(&FATFS_HAL_DEVICE, sector, buff, count))
-      return RES_ERROR;
-    return RES_OK;
+#if FATFS_CACHE_SECTORS > 0
+    return cache_read(buff, sector, count);
+#else
+    return device_read(buff, sector, count);
 #endif
   }
   return RES_PARERR;
@@ -169,24 +464,15 @@ DRESULT disk_write (
         return RES_NOTRDY;
     if (mmcIsWriteProtected(&FATFS_HAL_DEVICE))
         return RES_WRPRT;
-    if (mmcStartSequentialWrite(&FATFS_HAL_DEVICE, sector))
-        return RES_ERROR;
-    while (count > 0) {
-        if (mmcSequentialWrite(&FATFS_HAL_DEVICE, buff))
-            return RES_ERROR;
-        buff += MMCSD_BLOCK_SIZE;
-        count--;
-    }
-    if (mmcStopSequentialWrite(&FATFS_HAL_DEVICE))
-        return RES_ERROR;
-    return RES_OK;
 #else
   case SDC:
     if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
       return RES_NOTRDY;
-    if (sdcWrite(&FATFS_HAL_DEVICE, sector, buff, count))
-      return RES_ERROR;
-    return RES_OK;
+#endif
+#if FATFS_CACHE_SECTORS > 0
+    return cache_write(buff, sector, count);
+#else
+    return device_write(buff, sector, count);
 #endif
   }
   return RES_PARERR;
@@ -211,7 +497,11 @@ DRESULT disk_ioctl (
   case MMC:
     switch (cmd) {
     case CTRL_SYNC:
+#if FATFS_CACHE_SECTORS > 0
+        return cache_sync();
+#else
         return RES_OK;
+#endif
 #if FF_MAX_SS > FF_MIN_SS
     case GET_SECTOR_SIZE:
         *((WORD *)buff) = MMCSD_BLOCK_SIZE;
@@ -219,6 +509,9 @@ DRESULT disk_ioctl (
 #endif
 #if FF_USE_TRIM
     case CTRL_TRIM:
+#if FATFS_CACHE_SECTORS > 0
+        cache_discard(*((DWORD *)buff), *((DWORD *)buff + 1));
+#endif
         mmcErase(&FATFS_HAL_DEVICE, *((DWORD *)buff), *((DWORD *)buff + 1));
         return RES_OK;
 #endif
@@ -229,7 +522,11 @@ DRESULT disk_ioctl (
   case SDC:
     switch (cmd) {
     case CTRL_SYNC:
+#if FATFS_CACHE_SECTORS > 0
+        return cache_sync();
+#else
         return RES_OK;
+#endif
     case GET_SECTOR_COUNT:
         *((DWORD *)buff) = mmcsdGetCardCapacity(&FATFS_HAL_DEVICE);
         return RES_OK;
@@ -243,6 +540,9 @@ DRESULT disk_ioctl (
         return RES_OK;
 #if FF_USE_TRIM
     case CTRL_TRIM:
+#if FATFS_CACHE_SECTORS > 0
+        cache_discard(*((DWORD *)buff), *((DWORD *)buff + 1));
+#endif
         sdcErase(&FATFS_HAL_DEVICE, *((DWORD *)buff), *((DWORD *)buff + 1));
         return RES_OK;
 #endif
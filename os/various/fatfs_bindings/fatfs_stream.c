@@ -0,0 +1,231 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    fatfs_stream.c
+ * @brief   FatFS contiguous streaming files code.
+ *
+ * @addtogroup FATFS_STREAM
+ * @details Files are preallocated contiguously using @p f_expand() then
+ *          whole sectors are written directly on the device, there is no
+ *          cluster allocation and no FAT update while streaming. The
+ *          directory entry is only updated by @p fatfsStreamSync() and
+ *          @p fatfsStreamClose().
+ * @{
+ */
+
+#include "hal.h"
+#include "ffconf.h"
+#include "diskio.h"
+#include "fatfs_stream.h"
+
+#if (FF_USE_EXPAND && !FF_FS_READONLY) || defined(__DOXYGEN__)
+
+#if FF_MAX_SS != 512
+#error "streaming files require 512 bytes sectors"
+#endif
+
+#if FATFS_STREAM_USE_ASYNC == TRUE
+#if !HAL_USE_SDC || (SDC_USE_ASYNC_TRANSFERS == FALSE)
+#error "FATFS_STREAM_USE_ASYNC requires SDC_USE_ASYNC_TRANSFERS"
+#endif
+
+#if defined(FATFS_CACHE_SECTORS) && (FATFS_CACHE_SECTORS > 0)
+#error "FATFS_STREAM_USE_ASYNC requires the sectors cache disabled"
+#endif
+
+#if !defined(FATFS_HAL_DEVICE)
+#define FATFS_HAL_DEVICE SDCD1
+#endif
+
+extern SDCDriver FATFS_HAL_DEVICE;
+#endif
+
+/* File modified flag, same value of FA_MODIFIED, private to ff.c.*/
+#define STREAM_FA_MODIFIED      0x40
+
+/*
+ * Waits for the write in progress, if any.
+ */
+static FRESULT stream_wait(fatfs_stream_t *fsp) {
+
+#if FATFS_STREAM_USE_ASYNC == TRUE
+  if (fsp->pending) {
+    fsp->pending = false;
+    if (sdcWaitTransfers(&FATFS_HAL_DEVICE) != HAL_SUCCESS)
+      return FR_DISK_ERR;
+  }
+#else
+  (void)fsp;
+#endif
+
+  return FR_OK;
+}
+
+/**
+ * @brief   Prepares a file for streaming.
+ * @details The file is expanded to the specified size in contiguous
+ *          clusters. If @p FF_USE_TRIM is enabled the area is also erased
+ *          in advance, this avoids erase cycles while writing.
+ *
+ * @param[out] fsp      pointer to the @p fatfs_stream_t object
+ * @param[in] fp        empty file open for writing
+ * @param[in] size      size to be preallocated in bytes
+ * @return              The operation status.
+ * @retval FR_OK        if the file has been preallocated.
+ * @retval FR_DENIED    if there is no contiguous space on the volume.
+ *
+ * @api
+ */
+FRESULT fatfsStreamOpen(fatfs_stream_t *fsp, FIL *fp, FSIZE_t size) {
+  FATFS *fs;
+  FRESULT res;
+
+  osalDbgCheck((fsp != NULL) && (fp != NULL) && (size > 0U));
+
+  fs = fp->obj.fs;
+  size = (size + (FSIZE_t)(FF_MAX_SS - 1)) & ~(FSIZE_t)(FF_MAX_SS - 1);
+  res = f_expand(fp, size, 1);
+  if (res != FR_OK)
+    return res;
+
+  fsp->fp      = fp;
+  fsp->sector  = fs->database + ((DWORD)fs->csize * (fp->obj.sclust - 2U));
+  fsp->count   = (DWORD)(size / FF_MAX_SS);
+  fsp->written = 0U;
+#if FATFS_STREAM_USE_ASYNC == TRUE
+  fsp->pending = false;
+#endif
+
+#if FF_USE_TRIM
+  {
+    DWORD range[2];
+
+    range[0] = fsp->sector;
+    range[1] = fsp->sector + fsp->count - 1U;
+    (void)disk_ioctl(fs->pdrv, CTRL_TRIM, range);
+  }
+#endif
+
+  return FR_OK;
+}
+
+/**
+ * @brief   Writes sectors at the end of the streamed data.
+ * @note    In asynchronous mode the buffer must not be modified until the
+ *          next invocation of a streaming function returns.
+ *
+ * @param[in] fsp       pointer to the @p fatfs_stream_t object
+ * @param[in] buf       pointer to the data, it must be word aligned
+ * @param[in] n         number of sectors to write
+ * @return              The operation status.
+ * @retval FR_OK        if the write succeeded or has been started.
+ * @retval FR_DENIED    if the preallocated space is exhausted.
+ * @retval FR_DISK_ERR  if a write failed.
+ *
+ * @api
+ */
+FRESULT fatfsStreamWrite(fatfs_stream_t *fsp, const void *buf, UINT n) {
+  DWORD sector;
+  FRESULT res;
+
+  osalDbgCheck((fsp != NULL) && (buf != NULL) && (n > 0U));
+
+  if (n > fsp->count - fsp->written)
+    return FR_DENIED;
+
+  res = stream_wait(fsp);
+  if (res != FR_OK)
+    return res;
+
+  sector = fsp->sector + fsp->written;
+  fsp->written += n;
+#if FATFS_STREAM_USE_ASYNC == TRUE
+  if (sdcStartWrite(&FATFS_HAL_DEVICE, sector,
+                    (const uint8_t *)buf, n, NULL) != HAL_SUCCESS)
+    return FR_DISK_ERR;
+  fsp->pending = true;
+#else
+  if (disk_write(fsp->fp->obj.fs->pdrv, (const BYTE *)buf,
+                 sector, n) != RES_OK)
+    return FR_DISK_ERR;
+#endif
+
+  return FR_OK;
+}
+
+/**
+ * @brief   Records the streamed data size in the directory entry.
+ * @details The file size is set to the written data while the cluster
+ *          chain keeps its preallocated size, after a power loss the file
+ *          contains the data written before the last synchronization.
+ *
+ * @param[in] fsp       pointer to the @p fatfs_stream_t object
+ * @return              The operation status.
+ *
+ * @api
+ */
+FRESULT fatfsStreamSync(fatfs_stream_t *fsp) {
+  FIL *fp;
+  FSIZE_t size;
+  FRESULT res;
+
+  osalDbgCheck(fsp != NULL);
+
+  res = stream_wait(fsp);
+  if (res != FR_OK)
+    return res;
+
+  /* The preallocated size is restored in the file object, it is required
+     by the final truncation.*/
+  fp = fsp->fp;
+  size = fp->obj.objsize;
+  fp->obj.objsize = (FSIZE_t)fsp->written * FF_MAX_SS;
+  fp->flag |= STREAM_FA_MODIFIED;
+  res = f_sync(fp);
+  fp->obj.objsize = size;
+
+  return res;
+}
+
+/**
+ * @brief   Closes a streaming file.
+ * @details The clusters following the written data are released.
+ *
+ * @param[in] fsp       pointer to the @p fatfs_stream_t object
+ * @return              The operation status.
+ *
+ * @api
+ */
+FRESULT fatfsStreamClose(fatfs_stream_t *fsp) {
+  FRESULT res;
+
+  osalDbgCheck(fsp != NULL);
+
+  res = stream_wait(fsp);
+  if (res == FR_OK)
+    res = f_lseek(fsp->fp, (FSIZE_t)fsp->written * FF_MAX_SS);
+  if (res == FR_OK)
+    res = f_truncate(fsp->fp);
+  if (res == FR_OK)
+    res = f_close(fsp->fp);
+
+  return res;
+}
+
+#endif /* FF_USE_EXPAND && !FF_FS_READONLY */
+
+/** @} */
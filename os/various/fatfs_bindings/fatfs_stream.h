@@ -0,0 +1,84 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    fatfs_stream.h
+ * @brief   FatFS contiguous streaming files macros and structures.
+ *
+ * @addtogroup FATFS_STREAM
+ * @{
+ */
+
+#ifndef FATFS_STREAM_H
+#define FATFS_STREAM_H
+
+#include "hal.h"
+#include "ff.h"
+
+/**
+ * @brief   Asynchronous writes.
+ * @details If enabled the sectors are written using @p sdcStartWrite(), a
+ *          write returns while the card is being programmed and the
+ *          application can fill its next buffer.
+ * @note    Requires the SDC driver with @p SDC_USE_ASYNC_TRANSFERS
+ *          enabled, the FatFS bindings sectors cache must be disabled.
+ */
+#if !defined(FATFS_STREAM_USE_ASYNC) || defined(__DOXYGEN__)
+#define FATFS_STREAM_USE_ASYNC              FALSE
+#endif
+
+/**
+ * @brief   Type of a contiguous streaming file.
+ */
+typedef struct {
+  /**
+   * @brief   Underlying file object.
+   */
+  FIL                       *fp;
+  /**
+   * @brief   First sector of the file.
+   */
+  DWORD                     sector;
+  /**
+   * @brief   Number of preallocated sectors.
+   */
+  DWORD                     count;
+  /**
+   * @brief   Number of written sectors.
+   */
+  DWORD                     written;
+#if (FATFS_STREAM_USE_ASYNC == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   A write is in progress.
+   */
+  bool                      pending;
+#endif
+} fatfs_stream_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  FRESULT fatfsStreamOpen(fatfs_stream_t *fsp, FIL *fp, FSIZE_t size);
+  FRESULT fatfsStreamWrite(fatfs_stream_t *fsp, const void *buf, UINT n);
+  FRESULT fatfsStreamSync(fatfs_stream_t *fsp);
+  FRESULT fatfsStreamClose(fatfs_stream_t *fsp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FATFS_STREAM_H */
+
+/** @} */
@@ -22,19 +22,42 @@
 #include "hal.h"
 #include "ff.h"
 
+/* Volumes are locked using mutexes instead of semaphores, the priority
+   of a thread owning a volume is raised while higher priority threads
+   wait for it. FF_SYNC_t must be defined as mutex_t* and FF_FS_TIMEOUT
+   is ignored.*/
+#if !defined(FATFS_SYNC_USE_MUTEXES)
+#define FATFS_SYNC_USE_MUTEXES FALSE
+#endif
+
+/* Number of LFN working buffers allocated from a static pool, requests
+   exceeding the pool or the buffer size are served by the heap.*/
+#if !defined(FATFS_LFN_BUFFERS)
+#define FATFS_LFN_BUFFERS FF_VOLUMES
+#endif
+
 #if FF_FS_REENTRANT
 /*------------------------------------------------------------------------*/
 /* Static array of Synchronization Objects                                */
 /*------------------------------------------------------------------------*/
+#if FATFS_SYNC_USE_MUTEXES == TRUE
+static mutex_t ff_mtx[FF_VOLUMES];
+#else
 static semaphore_t ff_sem[FF_VOLUMES];
+#endif
 
 /*------------------------------------------------------------------------*/
 /* Create a Synchronization Object                                        */
 /*------------------------------------------------------------------------*/
 int ff_cre_syncobj(BYTE vol, FF_SYNC_t *sobj) {
 
+#if FATFS_SYNC_USE_MUTEXES == TRUE
+  *sobj = &ff_mtx[vol];
+  chMtxObjectInit(*sobj);
+#else
   *sobj = &ff_sem[vol];
   chSemObjectInit(*sobj, 1);
+#endif
   return TRUE;
 }
 
@@ -43,7 +66,11 @@ int ff_cre_syncobj(BYTE vol, FF_SYNC_t *sobj) {
 /*------------------------------------------------------------------------*/
 int ff_del_syncobj(FF_SYNC_t sobj) {
 
+#if FATFS_SYNC_USE_MUTEXES == TRUE
+  (void)sobj;
+#else
   chSemReset(sobj, 0);
+#endif
   return TRUE;
 }
 
@@ -52,8 +79,13 @@ int ff_del_syncobj(FF_SYNC_t sobj) {
 /*------------------------------------------------------------------------*/
 int ff_req_grant(FF_SYNC_t sobj) {
 
+#if FATFS_SYNC_USE_MUTEXES == TRUE
+  chMtxLock(sobj);
+  return TRUE;
+#else
   msg_t msg = chSemWaitTimeout(sobj, (systime_t)FF_FS_TIMEOUT);
   return msg == MSG_OK;
+#endif
 }
 
 /*------------------------------------------------------------------------*/
@@ -61,16 +93,57 @@ int ff_req_grant(FF_SYNC_t sobj) {
 /*------------------------------------------------------------------------*/
 void ff_rel_grant(FF_SYNC_t sobj) {
 
+#if FATFS_SYNC_USE_MUTEXES == TRUE
+  chMtxUnlock(sobj);
+#else
   chSemSignal(sobj);
+#endif
 }
 #endif /* FF_FS_REENTRANT */
 
 #if FF_USE_LFN == 3	/* LFN with a working buffer on the heap */
+/*------------------------------------------------------------------------*/
+/* Static pool of LFN working buffers                                     */
+/*------------------------------------------------------------------------*/
+#if FATFS_LFN_BUFFERS > 0
+/* Size of the LFN working buffer requested by ff.c, it includes the
+   directory entries block if exFAT is enabled.*/
+#if FF_FS_EXFAT
+#define LFN_BUFFER_SIZE ((FF_MAX_LFN + 1) * 2 + (FF_MAX_LFN + 44U) / 15U * 32U)
+#else
+#define LFN_BUFFER_SIZE ((FF_MAX_LFN + 1) * 2)
+#endif
+
+#define LFN_BLOCK_SIZE  MEM_ALIGN_NEXT(LFN_BUFFER_SIZE, PORT_NATURAL_ALIGN)
+
+static void *lfn_buffers[FATFS_LFN_BUFFERS][LFN_BLOCK_SIZE / sizeof (void *)];
+static MEMORYPOOL_DECL(lfn_pool, LFN_BLOCK_SIZE, PORT_NATURAL_ALIGN, NULL);
+static bool lfn_pool_loaded = false;
+#endif
+
 /*------------------------------------------------------------------------*/
 /* Allocate a memory block                                                */
 /*------------------------------------------------------------------------*/
 void *ff_memalloc(UINT size) {
 
+#if FATFS_LFN_BUFFERS > 0
+  if (size <= LFN_BLOCK_SIZE) {
+    void *p;
+
+    chSysLock();
+    if (!lfn_pool_loaded) {
+      unsigned i;
+
+      for (i = 0U; i < FATFS_LFN_BUFFERS; i++)
+        chPoolAddI(&lfn_pool, lfn_buffers[i]);
+      lfn_pool_loaded = true;
+    }
+    p = chPoolAllocI(&lfn_pool);
+    chSysUnlock();
+    if (p != NULL)
+      return p;
+  }
+#endif
   return chHeapAlloc(NULL, size);
 }
 
@@ -79,6 +152,13 @@ void *ff_memalloc(UINT size) {
 /*------------------------------------------------------------------------*/
 void ff_memfree(void *mblock) {
 
+#if FATFS_LFN_BUFFERS > 0
+  if (((void **)mblock >= &lfn_buffers[0][0]) &&
+      ((void **)mblock < &lfn_buffers[FATFS_LFN_BUFFERS][0])) {
+    chPoolFree(&lfn_pool, mblock);
+    return;
+  }
+#endif
   chHeapFree(mblock);
 }
 #endif /* FF_USE_LFN == 3 */
@@ -62,8 +62,31 @@
 #include "arch/cc.h"
 #include "arch/sys_arch.h"
 
+#if SYS_ARCH_STATISTICS == TRUE
+sys_arch_stats_t sys_arch_stats;
+
+#define SYS_ARCH_STATS_INC(x) (sys_arch_stats.x++)
+#else
+#define SYS_ARCH_STATS_INC(x)
+#endif
+
+#if SYS_ARCH_STATIC_MBOXES > 0
+/* Statically allocated mailbox.*/
+typedef struct {
+  mailbox_t mb;
+  msg_t     buffer[SYS_ARCH_STATIC_MBOX_SIZE];
+} static_mbox_t;
+
+static static_mbox_t static_mboxes[SYS_ARCH_STATIC_MBOXES];
+static MEMORYPOOL_DECL(mbox_pool, sizeof (static_mbox_t), PORT_NATURAL_ALIGN,
+                       NULL);
+#endif
+
 void sys_init(void) {
 
+#if SYS_ARCH_STATIC_MBOXES > 0
+  chPoolLoadArray(&mbox_pool, static_mboxes, SYS_ARCH_STATIC_MBOXES);
+#endif
 }
 
 err_t sys_sem_new(sys_sem_t *sem, u8_t count) {
@@ -126,6 +149,29 @@ void sys_sem_set_invalid(sys_sem_t *sem) {
   *sem = SYS_SEM_NULL;
 }
 
+#if SYS_ARCH_STATIC_MBOXES > 0
+err_t sys_mbox_new(sys_mbox_t *mbox, int size) {
+  static_mbox_t *smp;
+
+  if (size > SYS_ARCH_STATIC_MBOX_SIZE) {
+    *mbox = SYS_MBOX_NULL;
+    SYS_STATS_INC(mbox.err);
+    return ERR_MEM;
+  }
+  smp = chPoolAlloc(&mbox_pool);
+  if (smp == NULL) {
+    *mbox = SYS_MBOX_NULL;
+    SYS_STATS_INC(mbox.err);
+    return ERR_MEM;
+  }
+  else {
+    chMBObjectInit(&smp->mb, smp->buffer, (size_t)size);
+    *mbox = &smp->mb;
+    SYS_STATS_INC(mbox.used);
+    return ERR_OK;
+  }
+}
+#else
 err_t sys_mbox_new(sys_mbox_t *mbox, int size) {
 
   *mbox = chHeapAlloc(NULL, sizeof(mailbox_t) + sizeof(msg_t) * size);
@@ -139,6 +185,7 @@ err_t sys_mbox_new(sys_mbox_t *mbox, int size) {
     return ERR_OK;
   }
 }
+#endif
 
 void sys_mbox_free(sys_mbox_t *mbox) {
   cnt_t tmpcnt;
@@ -154,25 +201,62 @@ void sys_mbox_free(sys_mbox_t *mbox) {
     SYS_STATS_INC(mbox.err);
     chMBReset(*mbox);
   }
+#if SYS_ARCH_STATIC_MBOXES > 0
+  /* The mailbox is the first field of the pool object.*/
+  chPoolFree(&mbox_pool, *mbox);
+#else
   chHeapFree(*mbox);
+#endif
   *mbox = SYS_MBOX_NULL;
   SYS_STATS_DEC(mbox.used);
 }
 
 void sys_mbox_post(sys_mbox_t *mbox, void *msg) {
 
-  chMBPostTimeout(*mbox, (msg_t)msg, TIME_INFINITE);
+  chSysLock();
+  if (chMBGetFreeCountI(*mbox) == (size_t)0) {
+    SYS_ARCH_STATS_INC(mbox_full);
+  }
+  (void) chMBPostTimeoutS(*mbox, (msg_t)msg, TIME_INFINITE);
+  chSysUnlock();
 }
 
 err_t sys_mbox_trypost(sys_mbox_t *mbox, void *msg) {
+  msg_t result;
+
+  chSysLock();
+  result = chMBPostI(*mbox, (msg_t)msg);
+  if (result != MSG_OK) {
+    SYS_ARCH_STATS_INC(mbox_full);
+  }
+  else {
+    chSchRescheduleS();
+  }
+  chSysUnlock();
 
-  if (chMBPostTimeout(*mbox, (msg_t)msg, TIME_IMMEDIATE) == MSG_TIMEOUT) {
+  if (result != MSG_OK) {
     SYS_STATS_INC(mbox.err);
     return ERR_MEM;
   }
   return ERR_OK;
 }
 
+err_t sys_mbox_trypost_fromisr(sys_mbox_t *mbox, void *msg) {
+  msg_t result;
+
+  chSysLockFromISR();
+  result = chMBPostI(*mbox, (msg_t)msg);
+  if (result != MSG_OK) {
+    SYS_ARCH_STATS_INC(mbox_full);
+  }
+  chSysUnlockFromISR();
+
+  if (result != MSG_OK) {
+    return ERR_MEM;
+  }
+  return ERR_OK;
+}
+
 u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout) {
   systime_t start;
   sysinterval_t tmo, remaining;
@@ -180,6 +264,9 @@ u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout) {
   chSysLock();
   tmo = timeout > 0 ? TIME_MS2I((time_msecs_t)timeout) : TIME_INFINITE;
   start = chVTGetSystemTimeX();
+  if (chMBGetUsedCountI(*mbox) == (size_t)0) {
+    SYS_ARCH_STATS_INC(mbox_empty);
+  }
   if (chMBFetchTimeoutS(*mbox, (msg_t *)msg, tmo) != MSG_OK) {
     chSysUnlock();
     return SYS_ARCH_TIMEOUT;
@@ -216,8 +303,18 @@ sys_thread_t sys_thread_new(const char *name, lwip_thread_fn thread,
 }
 
 sys_prot_t sys_arch_protect(void) {
+#if SYS_ARCH_STATISTICS == TRUE
+  syssts_t sts = chSysGetStatusAndLockX();
 
+  /* Counted from within the lock.*/
+  SYS_ARCH_STATS_INC(protect);
+  if (!port_irq_enabled(sts)) {
+    SYS_ARCH_STATS_INC(nested);
+  }
+  return sts;
+#else
   return chSysGetStatusAndLockX();
+#endif
 }
 
 void sys_arch_unprotect(sys_prot_t pval) {
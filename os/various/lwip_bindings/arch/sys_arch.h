@@ -65,4 +65,35 @@ typedef syssts_t        sys_prot_t;
 /* let sys.h use binary semaphores for mutexes */
 #define LWIP_COMPAT_MUTEX 1
 
+/* Number of mailboxes allocated from a static pool, if zero the mailboxes
+   are allocated from the heap.*/
+#if !defined(SYS_ARCH_STATIC_MBOXES)
+#define SYS_ARCH_STATIC_MBOXES 0
+#endif
+
+/* Maximum size of a statically allocated mailbox.*/
+#if !defined(SYS_ARCH_STATIC_MBOX_SIZE)
+#define SYS_ARCH_STATIC_MBOX_SIZE 16
+#endif
+
+/* Enables the sys_arch statistics.*/
+#if !defined(SYS_ARCH_STATISTICS)
+#define SYS_ARCH_STATISTICS FALSE
+#endif
+
+#if SYS_ARCH_STATISTICS == TRUE
+/* sys_arch statistics, updated from within the kernel lock.*/
+typedef struct {
+  uint32_t protect;     /* sys_arch_protect() invocations.                */
+  uint32_t nested;      /* Invocations with protection already active.    */
+  uint32_t mbox_full;   /* Posts finding the mailbox full.                */
+  uint32_t mbox_empty;  /* Fetches finding the mailbox empty.             */
+} sys_arch_stats_t;
+
+extern sys_arch_stats_t sys_arch_stats;
+#endif
+
+/* Posts a message from ISR context without waiting.*/
+err_t sys_mbox_trypost_fromisr(sys_mbox_t *mbox, void *msg);
+
 #endif /* __SYS_ARCH_H__ */
@@ -81,6 +81,39 @@
 
 #define PERIODIC_TIMER_ID       1
 #define FRAME_RECEIVED_ID       2
+#define LINK_CHANGED_ID         4
+
+/*
+ * Zero-copy operations, MAC buffers are lent to the stack as custom pbufs
+ * and pbuf chains are transmitted directly from their payload.
+ */
+#if (MAC_USE_ZERO_COPY == TRUE) && (MAC_SUPPORTS_BUFFERS_LENDING == TRUE) && \
+    LWIP_SUPPORT_CUSTOM_PBUF && (ETH_PAD_SIZE == 0)
+#define LWIP_MAC_LENDING        TRUE
+#else
+#define LWIP_MAC_LENDING        FALSE
+#endif
+
+#if (LWIP_RX_POLLING == TRUE) && (MAC_SUPPORTS_RECEIVE_POLLING == FALSE)
+#error "LWIP_RX_POLLING requires a MAC driver supporting receive polling"
+#endif
+
+#if (LWIP_LINK_EVENTS == TRUE) && (MAC_SUPPORTS_LINK_EVENTS == FALSE)
+#error "LWIP_LINK_EVENTS requires a MAC driver supporting link events"
+#endif
+
+#if (LWIP_MAC_TIMESTAMPS == TRUE) && (MAC_SUPPORTS_TIMESTAMPS == FALSE)
+#error "LWIP_MAC_TIMESTAMPS requires a MAC driver supporting time stamps"
+#endif
+
+/*
+ * Multicast groups are filtered by the MAC if it supports frame filters.
+ */
+#if (MAC_SUPPORTS_FILTERS == TRUE) && (LWIP_IGMP || LWIP_IPV6_MLD)
+#define LWIP_MAC_FILTERS        TRUE
+#else
+#define LWIP_MAC_FILTERS        FALSE
+#endif
 
 /*
  * Suspension point for initialization procedure.
@@ -92,6 +125,163 @@ thread_reference_t lwip_trp = NULL;
  */
 static THD_WORKING_AREA(wa_lwip_thread, LWIP_THREAD_STACK_SIZE);
 
+/*
+ * Reception statistics.
+ */
+static lwipthread_rx_stats_t rx_stats;
+
+#if LWIP_MAC_LENDING == TRUE
+/*
+ * Custom pbuf wrapping a received frame buffer lent by the MAC.
+ */
+typedef struct {
+  struct pbuf_custom    pc;
+  uint8_t               *buf;
+} lent_pbuf_t;
+
+static lent_pbuf_t lent_pbufs[LWIP_MAC_LENT_FRAMES];
+static MEMORYPOOL_DECL(lent_pool, sizeof (lent_pbuf_t), PORT_NATURAL_ALIGN,
+                       NULL);
+
+/*
+ * Gives back a lent buffer to the MAC when the stack frees its pbuf.
+ */
+static void lent_pbuf_free(struct pbuf *p) {
+  lent_pbuf_t *lp = (lent_pbuf_t *)p;
+
+  macReturnReceiveBuffer(&ETHD1, lp->buf);
+  chPoolFree(&lent_pool, lp);
+}
+
+/*
+ * Releases a pbuf chain after its transmission.
+ */
+static void lent_frame_release(MACDriver *macp, void *frame) {
+
+  (void)macp;
+  pbuf_free((struct pbuf *)frame);
+}
+
+/*
+ * Transmits a pbuf chain without copying it, the chain is referenced until
+ * the MAC has sent it. Returns MSG_RESET if the chain cannot be transmitted
+ * from its buffers.
+ */
+static msg_t low_level_lend_output(struct pbuf *p) {
+  MACTransmitBuffer tb[MAC_MAX_TRANSMIT_BUFFERS];
+  struct pbuf *q;
+  size_t n = 0;
+
+  for (q = p; q != NULL; q = q->next) {
+    if (q->len > 0U) {
+      /* Too fragmented or payload possibly not reachable by the DMA.*/
+      if ((n >= MAC_MAX_TRANSMIT_BUFFERS) ||
+          ((q->type != PBUF_RAM) && (q->type != PBUF_POOL)))
+        return MSG_RESET;
+      tb[n].buf  = (const uint8_t *)q->payload;
+      tb[n].size = (size_t)q->len;
+      n++;
+    }
+  }
+
+  pbuf_ref(p);
+  if (macWaitTransmitBuffers(&ETHD1, tb, n, p,
+                             TIME_MS2I(LWIP_SEND_TIMEOUT)) != MSG_OK) {
+    pbuf_free(p);
+    return MSG_TIMEOUT;
+  }
+  return MSG_OK;
+}
+
+/*
+ * Wraps the frame buffer into a custom pbuf, returns NULL if the buffer
+ * cannot be lent.
+ */
+static struct pbuf *low_level_lend_input(MACReceiveDescriptor *rdp) {
+  lent_pbuf_t *lp;
+  uint8_t *buf;
+
+  lp = chPoolAlloc(&lent_pool);
+  if (lp == NULL)
+    return NULL;
+
+  buf = macLendReceiveBuffer(rdp);
+  if (buf == NULL) {
+    chPoolFree(&lent_pool, lp);
+    return NULL;
+  }
+
+  lp->buf = buf;
+  lp->pc.custom_free_function = lent_pbuf_free;
+  return pbuf_alloced_custom(PBUF_RAW, (u16_t)rdp->size, PBUF_REF, &lp->pc,
+                             buf, (u16_t)rdp->size);
+}
+#endif /* LWIP_MAC_LENDING == TRUE */
+
+#if LWIP_MAC_FILTERS == TRUE
+/*
+ * Adds or removes a multicast MAC address in the MAC filter.
+ */
+static err_t low_level_mac_filter(const uint8_t *addr,
+                                  enum netif_mac_filter_action action) {
+  msg_t msg;
+
+  if (action == NETIF_ADD_MAC_FILTER)
+    msg = macAddFilterAddress(&ETHD1, addr);
+  else
+    msg = macRemoveFilterAddress(&ETHD1, addr);
+
+  return msg == MSG_OK ? ERR_OK : ERR_IF;
+}
+
+#if LWIP_IGMP
+/*
+ * IPv4 multicast group filter, the MAC address is 01:00:5E followed by
+ * the low 23 bits of the group address.
+ */
+static err_t low_level_igmp_mac_filter(struct netif *netif,
+                                       const ip4_addr_t *group,
+                                       enum netif_mac_filter_action action) {
+  uint8_t addr[6];
+
+  (void)netif;
+
+  addr[0] = 0x01;
+  addr[1] = 0x00;
+  addr[2] = 0x5E;
+  addr[3] = ip4_addr2(group) & 0x7F;
+  addr[4] = ip4_addr3(group);
+  addr[5] = ip4_addr4(group);
+
+  return low_level_mac_filter(addr, action);
+}
+#endif
+
+#if LWIP_IPV6_MLD
+/*
+ * IPv6 multicast group filter, the MAC address is 33:33 followed by
+ * the low 32 bits of the group address.
+ */
+static err_t low_level_mld_mac_filter(struct netif *netif,
+                                      const ip6_addr_t *group,
+                                      enum netif_mac_filter_action action) {
+  uint8_t addr[6];
+  const uint8_t *p = (const uint8_t *)&group->addr[3];
+
+  (void)netif;
+
+  addr[0] = 0x33;
+  addr[1] = 0x33;
+  addr[2] = p[0];
+  addr[3] = p[1];
+  addr[4] = p[2];
+  addr[5] = p[3];
+
+  return low_level_mac_filter(addr, action);
+}
+#endif
+#endif /* LWIP_MAC_FILTERS == TRUE */
+
 /*
  * Initialization.
  */
@@ -106,6 +296,27 @@ static void low_level_init(struct netif *netif) {
   /* don't set NETIF_FLAG_ETHARP if this device is not an Ethernet one */
   netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_LINK_UP;
 
+#if LWIP_MAC_FILTERS == TRUE
+  /* Joined multicast groups are added to the MAC filter, other multicast
+     frames are discarded by the MAC.*/
+#if LWIP_IGMP
+  netif->flags |= NETIF_FLAG_IGMP;
+  netif_set_igmp_mac_filter(netif, low_level_igmp_mac_filter);
+#endif
+#if LWIP_IPV6_MLD
+  {
+    ip6_addr_t allnodes;
+
+    netif->flags |= NETIF_FLAG_MLD6;
+    netif_set_mld_mac_filter(netif, low_level_mld_mac_filter);
+
+    /* The all-nodes group is never joined through MLD.*/
+    ip6_addr_set_allnodes_linklocal(&allnodes);
+    (void)low_level_mld_mac_filter(netif, &allnodes, NETIF_ADD_MAC_FILTER);
+  }
+#endif
+#endif
+
   /* Do whatever else is needed to initialize interface. */
 }
 
@@ -127,19 +338,45 @@ static void low_level_init(struct netif *netif) {
 static err_t low_level_output(struct netif *netif, struct pbuf *p) {
   struct pbuf *q;
   MACTransmitDescriptor td;
+#if LWIP_MAC_LENDING == TRUE
+  msg_t msg;
+#endif
+#if LWIP_MAC_TIMESTAMPS == TRUE
+  bool ts = LWIP_TX_TIMESTAMP_HOOK(p);
+#endif
 
   (void)netif;
-  if (macWaitTransmitDescriptor(&ETHD1, &td, TIME_MS2I(LWIP_SEND_TIMEOUT)) != MSG_OK)
+#if LWIP_MAC_LENDING == TRUE
+#if LWIP_MAC_TIMESTAMPS == TRUE
+  /* Time stamps are only available for frames copied in the MAC buffers.*/
+  if (ts)
+    msg = MSG_RESET;
+  else
+#endif
+  msg = low_level_lend_output(p);
+  if (msg == MSG_TIMEOUT)
     return ERR_TIMEOUT;
 
+  /* Copying the chain if it cannot be sent from its buffers.*/
+  if (msg == MSG_RESET)
+#endif
+  {
+    if (macWaitTransmitDescriptor(&ETHD1, &td, TIME_MS2I(LWIP_SEND_TIMEOUT)) != MSG_OK)
+      return ERR_TIMEOUT;
+
 #if ETH_PAD_SIZE
-  pbuf_header(p, -ETH_PAD_SIZE);        /* drop the padding word */
+    pbuf_header(p, -ETH_PAD_SIZE);        /* drop the padding word */
 #endif
 
-  /* Iterates through the pbuf chain. */
-  for(q = p; q != NULL; q = q->next)
-    macWriteTransmitDescriptor(&td, (uint8_t *)q->payload, (size_t)q->len);
-  macReleaseTransmitDescriptor(&td);
+    /* Iterates through the pbuf chain. */
+    for(q = p; q != NULL; q = q->next)
+      macWriteTransmitDescriptor(&td, (uint8_t *)q->payload, (size_t)q->len);
+#if LWIP_MAC_TIMESTAMPS == TRUE
+    if (ts)
+      macRequestTransmitTimestamp(&td);
+#endif
+    macReleaseTransmitDescriptor(&td);
+  }
 
   MIB2_STATS_NETIF_ADD(netif, ifoutoctets, p->tot_len);
   if (((u8_t*)p->payload)[0] & 1) {
@@ -174,6 +411,10 @@ static bool low_level_input(struct netif *netif, struct pbuf **pbuf) {
   MACReceiveDescriptor rd;
   struct pbuf *q;
   u16_t len;
+#if LWIP_MAC_TIMESTAMPS == TRUE
+  mac_timestamp_t ts;
+  bool tsvalid;
+#endif
 
   (void)netif;
 
@@ -184,10 +425,21 @@ static bool low_level_input(struct netif *netif, struct pbuf **pbuf) {
 
   len = (u16_t)rd.size;
 
+#if LWIP_MAC_TIMESTAMPS == TRUE
+  /* The time stamp is fetched before the descriptor can be released.*/
+  tsvalid = macGetReceiveTimestamp(&rd, &ts);
+#endif
+
 #if ETH_PAD_SIZE
   len += ETH_PAD_SIZE;        /* allow room for Ethernet padding */
 #endif
 
+#if LWIP_MAC_LENDING == TRUE
+  /* The frame buffer is passed to the stack if possible, in this case
+     there is nothing left to be read from the descriptor.*/
+  *pbuf = low_level_lend_input(&rd);
+  if (*pbuf == NULL)
+#endif
   /* We allocate a pbuf chain of pbufs from the pool. */
   *pbuf = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
 
@@ -201,6 +453,11 @@ static bool low_level_input(struct netif *netif, struct pbuf **pbuf) {
       macReadReceiveDescriptor(&rd, (uint8_t *)q->payload, (size_t)q->len);
     macReleaseReceiveDescriptor(&rd);
 
+#if LWIP_MAC_TIMESTAMPS == TRUE
+    if (tsvalid)
+      LWIP_RX_TIMESTAMP_HOOK(*pbuf, &ts);
+#endif
+
     MIB2_STATS_NETIF_ADD(netif, ifinoctets, *pbuf->tot_len);
 
     if (*(uint8_t *)((*pbuf)->payload) & 1) {
@@ -273,13 +530,22 @@ static err_t ethernetif_init(struct netif *netif) {
  * @return The function does not return.
  */
 static THD_FUNCTION(lwip_thread, p) {
+#if LWIP_LINK_EVENTS == FALSE
   event_timer_t evt;
+#endif
   event_listener_t el0, el1;
   ip_addr_t ip, gateway, netmask;
   static struct netif thisif = { 0 };
+#if LWIP_MAC_LENDING == TRUE
+  static const MACConfig mac_config = {thisif.hwaddr, lent_frame_release};
+#else
   static const MACConfig mac_config = {thisif.hwaddr};
+#endif
   net_addr_mode_t addressMode;
   err_t result;
+#if LWIP_RX_POLLING == TRUE
+  bool polling = false;
+#endif
 
   chRegSetThreadName(LWIP_THREAD_NAME);
 
@@ -322,6 +588,10 @@ static THD_FUNCTION(lwip_thread, p) {
     thisif.hostname = LWIP_NETIF_HOSTNAME_STRING;
 #endif
 
+#if LWIP_MAC_LENDING == TRUE
+  chPoolLoadArray(&lent_pool, lent_pbufs, LWIP_MAC_LENT_FRAMES);
+#endif
+
   macStart(&ETHD1, &mac_config);
 
   /* Add interface. */
@@ -347,12 +617,18 @@ static THD_FUNCTION(lwip_thread, p) {
       break;
   }
 
-  /* Setup event sources.*/
+  /* Setup event sources, the link status is read once on start.*/
+#if LWIP_LINK_EVENTS == TRUE
+  chEvtRegisterMask(macGetLinkEventSource(&ETHD1), &el0, LINK_CHANGED_ID);
+  chEvtAddEvents(LINK_CHANGED_ID);
+#else
   evtObjectInit(&evt, LWIP_LINK_POLL_INTERVAL);
   evtStart(&evt);
   chEvtRegisterMask(&evt.et_es, &el0, PERIODIC_TIMER_ID);
+  chEvtAddEvents(PERIODIC_TIMER_ID);
+#endif
   chEvtRegisterMask(macGetReceiveEventSource(&ETHD1), &el1, FRAME_RECEIVED_ID);
-  chEvtAddEvents(PERIODIC_TIMER_ID | FRAME_RECEIVED_ID);
+  chEvtAddEvents(FRAME_RECEIVED_ID);
 
   /* Resumes the caller and goes to the final priority.*/
   chThdResume(&lwip_trp, MSG_OK);
@@ -360,8 +636,14 @@ static THD_FUNCTION(lwip_thread, p) {
 
   while (true) {
     eventmask_t mask = chEvtWaitAny(ALL_EVENTS);
-    if (mask & PERIODIC_TIMER_ID) {
+    if (mask & (PERIODIC_TIMER_ID | LINK_CHANGED_ID)) {
       bool current_link_status = macPollLinkStatus(&ETHD1);
+#if LWIP_MAC_LENDING == TRUE
+      /* Frames sent while the stack is idle are released here.*/
+      LOCK_TCPIP_CORE();
+      macReleaseTransmittedFrames(&ETHD1);
+      UNLOCK_TCPIP_CORE();
+#endif
       if (current_link_status != netif_is_link_up(&thisif)) {
         if (current_link_status) {
           tcpip_callback_with_block((tcpip_callback_fn) netif_set_link_up,
@@ -384,7 +666,22 @@ static THD_FUNCTION(lwip_thread, p) {
     
     if (mask & FRAME_RECEIVED_ID) {
       struct pbuf *p;
+#if LWIP_RX_POLLING == TRUE
+      unsigned n = 0U;
+
+      /* Further frames are not notified until the ring has been drained.*/
+      if (!polling) {
+        chSysLock();
+        macDisableReceiveInterruptI(&ETHD1);
+        chSysUnlock();
+        rx_stats.wakeups++;
+      }
+#else
+      rx_stats.wakeups++;
+#endif
+      rx_stats.polls++;
       while (low_level_input(&thisif, &p)) {
+        rx_stats.frames++;
         if (p != NULL) {
           struct eth_hdr *ethhdr = p->payload;
           switch (htons(ethhdr->type)) {
@@ -400,11 +697,48 @@ static THD_FUNCTION(lwip_thread, p) {
               pbuf_free(p);
           }
         }
+#if LWIP_RX_POLLING == TRUE
+        if (++n >= LWIP_RX_POLL_BUDGET)
+          break;
+#endif
+      }
+#if (LWIP_MAC_LENDING == TRUE) && (LWIP_LINK_EVENTS == TRUE)
+      /* There is no periodic release, frames sent in reply to the received
+         ones are released here.*/
+      LOCK_TCPIP_CORE();
+      macReleaseTransmittedFrames(&ETHD1);
+      UNLOCK_TCPIP_CORE();
+#endif
+#if LWIP_RX_POLLING == TRUE
+      polling = n >= LWIP_RX_POLL_BUDGET;
+      if (polling) {
+        /* Budget exhausted, polling again after the other events.*/
+        chEvtAddEvents(FRAME_RECEIVED_ID);
       }
+      else {
+        /* Ring drained, a frame received in the meantime is notified
+           immediately.*/
+        chSysLock();
+        macEnableReceiveInterruptI(&ETHD1);
+        chSysUnlock();
+      }
+#endif
     }
   }
 }
 
+/**
+ * @brief   Returns the reception statistics.
+ *
+ * @param[out] statsp   pointer to the structure receiving the statistics
+ */
+void lwipGetReceiveStatistics(lwipthread_rx_stats_t *statsp) {
+
+  chSysLock();
+  *statsp = rx_stats;
+  chSysUnlock();
+}
+
 /**
  * @brief   Initializes the lwIP subsystem.
  * @note    The function exits after the initialization is finished.
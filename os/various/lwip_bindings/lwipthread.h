@@ -68,6 +68,21 @@
 #define LWIP_LINK_POLL_INTERVAL             TIME_S2I(5)
 #endif
 
+/**
+ * @brief   Link status driven by link change events.
+ * @details If enabled the link status is read when the MAC driver notifies
+ *          a link change instead of every @p LWIP_LINK_POLL_INTERVAL, the
+ *          thread is not woken up while the network is idle.
+ * @note    Requires a MAC driver supporting link change events, the board
+ *          or the application must route the PHY interrupt line to
+ *          @p macLinkChangedI().
+ * @note    Lent transmitted frames are released on the next transmission
+ *          or reception.
+ */
+#if !defined(LWIP_LINK_EVENTS) || defined(__DOXYGEN__)
+#define LWIP_LINK_EVENTS                    FALSE
+#endif
+
 /**
  *  @brief  IP Address.
  */
@@ -96,6 +111,75 @@
 #define LWIP_SEND_TIMEOUT                   50
 #endif
 
+/**
+ * @brief   Maximum number of received frames lent to the stack.
+ * @details Received frames are passed to the stack without copying them
+ *          if the MAC driver supports buffers lending and
+ *          @p MAC_USE_ZERO_COPY is enabled, frames exceeding this number
+ *          are copied into pool pbufs.
+ */
+#if !defined(LWIP_MAC_LENT_FRAMES) || defined(__DOXYGEN__)
+#define LWIP_MAC_LENT_FRAMES                4
+#endif
+
+/**
+ * @brief   Polled reception mode.
+ * @details If enabled the MAC receive interrupt is disabled after the first
+ *          frame notification and the descriptors are polled until the
+ *          ring is empty, the interrupt is then enabled again.
+ * @note    Requires a MAC driver supporting the receive interrupt masking.
+ */
+#if !defined(LWIP_RX_POLLING) || defined(__DOXYGEN__)
+#define LWIP_RX_POLLING                     FALSE
+#endif
+
+/**
+ * @brief   Maximum number of frames received in a single polling pass.
+ * @details When the budget is exhausted the thread serves its other events
+ *          before polling again, the interrupt is kept disabled.
+ */
+#if !defined(LWIP_RX_POLL_BUDGET) || defined(__DOXYGEN__)
+#define LWIP_RX_POLL_BUDGET                 16
+#endif
+
+/**
+ * @brief   Enables the IEEE 1588 frame time stamps.
+ * @details Received frames time stamps are passed to
+ *          @p LWIP_RX_TIMESTAMP_HOOK(), transmit time stamps are requested
+ *          for the frames selected by @p LWIP_TX_TIMESTAMP_HOOK() and
+ *          can be retrieved using @p macWaitTransmitTimestamp().
+ * @note    Requires a MAC driver supporting time stamps.
+ */
+#if !defined(LWIP_MAC_TIMESTAMPS) || defined(__DOXYGEN__)
+#define LWIP_MAC_TIMESTAMPS                 FALSE
+#endif
+
+/**
+ * @brief   Transmit time stamp selection hook.
+ * @details Returns @p true if a time stamp must be requested for the
+ *          frame, time stamped frames are always copied in the MAC
+ *          buffers.
+ *
+ * @param[in] p         pointer to the frame @p pbuf
+ */
+#if !defined(LWIP_TX_TIMESTAMP_HOOK) || defined(__DOXYGEN__)
+#define LWIP_TX_TIMESTAMP_HOOK(p)           false
+#endif
+
+/**
+ * @brief   Receive time stamp hook.
+ * @details Invoked for each received frame having a valid time stamp.
+ *
+ * @param[in] p         pointer to the frame @p pbuf
+ * @param[in] tsp       pointer to the @p mac_timestamp_t time stamp
+ */
+#if !defined(LWIP_RX_TIMESTAMP_HOOK) || defined(__DOXYGEN__)
+#define LWIP_RX_TIMESTAMP_HOOK(p, tsp)      {                               \
+  (void)(p);                                                                \
+  (void)(tsp);                                                              \
+}
+#endif
+
 /**
  * @brief   Link speed.
  */
@@ -234,10 +318,31 @@ typedef struct lwipthread_opts {
 #endif
 } lwipthread_opts_t;
 
+/**
+ * @brief   Reception statistics.
+ * @note    The ratio between @p frames and @p wakeups is the average number
+ *          of frames served for each receive notification.
+ */
+typedef struct lwipthread_rx_stats {
+  /**
+   * @brief   Number of receive notifications from the MAC driver.
+   */
+  uint32_t        wakeups;
+  /**
+   * @brief   Number of descriptors polling passes.
+   */
+  uint32_t        polls;
+  /**
+   * @brief   Number of frames received.
+   */
+  uint32_t        frames;
+} lwipthread_rx_stats_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
   void lwipInit(const lwipthread_opts_t *opts);
+  void lwipGetReceiveStatistics(lwipthread_rx_stats_t *statsp);
 #ifdef __cplusplus
 }
 #endif
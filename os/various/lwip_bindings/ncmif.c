@@ -0,0 +1,279 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file ncmif.c
+ * @brief lwIP network interface over USB CDC-NCM code.
+ * @details The interface is added using the @p ncmifInit() function and a
+ *          pointer to an @p ncmif_config_t structure as state:
+ * @code
+ *          netifapi_netif_add(&ncmnetif, &ip, &netmask, &gateway,
+ *                             (void *)&ncmif_config, ncmifInit,
+ *                             tcpip_input);
+ * @endcode
+ *          Received datagrams are lent to the stack as custom pbufs
+ *          referencing the NTB buffers, transmitted frames are written
+ *          directly in the NTB being aggregated.
+ * @addtogroup LWIP_NCMIF
+ * @{
+ */
+
+#include "hal.h"
+
+#include "lwipthread.h"
+#include "ncmif.h"
+
+#include <lwip/opt.h>
+#include <lwip/def.h>
+#include <lwip/pbuf.h>
+#include <lwip/stats.h>
+#include <lwip/snmp.h>
+#include <lwip/tcpip.h>
+#include <netif/etharp.h>
+
+/*
+ * Zero-copy reception, datagrams are lent to the stack if the IP header
+ * they contain is word aligned.
+ */
+#if LWIP_SUPPORT_CUSTOM_PBUF && (ETH_PAD_SIZE == 0)
+#define NCMIF_LENDING           TRUE
+#else
+#define NCMIF_LENDING           FALSE
+#endif
+
+/*
+ * Stack area for the receive thread.
+ */
+static THD_WORKING_AREA(wa_ncmif_thread, NCMIF_THREAD_STACK_SIZE);
+
+#if NCMIF_LENDING == TRUE
+/*
+ * Custom pbuf wrapping a received datagram.
+ */
+typedef struct {
+  struct pbuf_custom    pc;
+  USBNCMDriver          *ncmp;
+  ncm_datagram_t        dg;
+} lent_datagram_t;
+
+static lent_datagram_t lent_datagrams[NCMIF_LENT_DATAGRAMS];
+static MEMORYPOOL_DECL(lent_pool, sizeof (lent_datagram_t),
+                       PORT_NATURAL_ALIGN, NULL);
+
+/*
+ * Gives back a datagram to the driver when the stack frees its pbuf.
+ */
+static void lent_datagram_free(struct pbuf *p) {
+  lent_datagram_t *lp = (lent_datagram_t *)p;
+
+  ncmReleaseDatagram(lp->ncmp, &lp->dg);
+  chPoolFree(&lent_pool, lp);
+}
+
+/*
+ * Wraps a datagram into a custom pbuf, returns NULL if the datagram
+ * cannot be lent.
+ */
+static struct pbuf *low_level_lend_input(USBNCMDriver *ncmp,
+                                         const ncm_datagram_t *dgp) {
+  lent_datagram_t *lp;
+
+  if ((((size_t)dgp->buffer + SIZEOF_ETH_HDR) & 3U) != 0U)
+    return NULL;
+
+  lp = chPoolAlloc(&lent_pool);
+  if (lp == NULL)
+    return NULL;
+
+  lp->ncmp = ncmp;
+  lp->dg   = *dgp;
+  lp->pc.custom_free_function = lent_datagram_free;
+  return pbuf_alloced_custom(PBUF_RAW, (u16_t)dgp->size, PBUF_REF, &lp->pc,
+                             dgp->buffer, (u16_t)dgp->size);
+}
+#endif /* NCMIF_LENDING == TRUE */
+
+/*
+ * Transmits a frame, the pbuf chain is gathered directly in the NTB being
+ * aggregated.
+ */
+static err_t low_level_output(struct netif *netif, struct pbuf *p) {
+  const ncmif_config_t *cfg = (const ncmif_config_t *)netif->state;
+  uint8_t *buf;
+
+#if ETH_PAD_SIZE
+  pbuf_header(p, -ETH_PAD_SIZE);        /* drop the padding word */
+#endif
+
+  if ((p->tot_len > NCM_MAX_FRAME_SIZE) ||
+      (ncmGetTransmitBufferTimeout(cfg->ncmp, (size_t)p->tot_len, &buf,
+                                   TIME_MS2I(NCMIF_SEND_TIMEOUT)) != MSG_OK)) {
+#if ETH_PAD_SIZE
+    pbuf_header(p, ETH_PAD_SIZE);       /* reclaim the padding word */
+#endif
+    LINK_STATS_INC(link.drop);
+    MIB2_STATS_NETIF_INC(netif, ifoutdiscards);
+    return ERR_TIMEOUT;
+  }
+
+  (void)pbuf_copy_partial(p, buf, p->tot_len, 0);
+  ncmPostTransmitBuffer(cfg->ncmp, (size_t)p->tot_len);
+
+  MIB2_STATS_NETIF_ADD(netif, ifoutoctets, p->tot_len);
+  if (((u8_t*)p->payload)[0] & 1) {
+    /* broadcast or multicast packet*/
+    MIB2_STATS_NETIF_INC(netif, ifoutnucastpkts);
+  }
+  else {
+    /* unicast packet */
+    MIB2_STATS_NETIF_INC(netif, ifoutucastpkts);
+  }
+
+#if ETH_PAD_SIZE
+  pbuf_header(p, ETH_PAD_SIZE);         /* reclaim the padding word */
+#endif
+
+  LINK_STATS_INC(link.xmit);
+
+  return ERR_OK;
+}
+
+/*
+ * Converts a received datagram in a pbuf, returns NULL on memory error.
+ */
+static struct pbuf *low_level_input(struct netif *netif,
+                                    const ncm_datagram_t *dgp) {
+  const ncmif_config_t *cfg = (const ncmif_config_t *)netif->state;
+  struct pbuf *p;
+
+#if NCMIF_LENDING == TRUE
+  /* The datagram is passed to the stack if possible.*/
+  p = low_level_lend_input(cfg->ncmp, dgp);
+  if (p == NULL)
+#endif
+  {
+    p = pbuf_alloc(PBUF_RAW, (u16_t)(dgp->size + ETH_PAD_SIZE), PBUF_POOL);
+    if (p != NULL) {
+#if ETH_PAD_SIZE
+      pbuf_header(p, -ETH_PAD_SIZE);    /* drop the padding word */
+#endif
+      (void)pbuf_take(p, dgp->buffer, (u16_t)dgp->size);
+#if ETH_PAD_SIZE
+      pbuf_header(p, ETH_PAD_SIZE);     /* reclaim the padding word */
+#endif
+    }
+    ncmReleaseDatagram(cfg->ncmp, dgp);
+  }
+
+  if (p == NULL) {
+    LINK_STATS_INC(link.memerr);
+    LINK_STATS_INC(link.drop);
+    MIB2_STATS_NETIF_INC(netif, ifindiscards);
+    return NULL;
+  }
+
+  MIB2_STATS_NETIF_ADD(netif, ifinoctets, p->tot_len);
+  if (dgp->buffer[0] & 1) {
+    /* broadcast or multicast packet*/
+    MIB2_STATS_NETIF_INC(netif, ifinnucastpkts);
+  }
+  else {
+    /* unicast packet*/
+    MIB2_STATS_NETIF_INC(netif, ifinucastpkts);
+  }
+  LINK_STATS_INC(link.recv);
+
+  return p;
+}
+
+/*
+ * Receive thread, it also follows the state of the data interface.
+ */
+static THD_FUNCTION(ncmif_thread, arg) {
+  struct netif *netif = (struct netif *)arg;
+  const ncmif_config_t *cfg = (const ncmif_config_t *)netif->state;
+  ncm_datagram_t dg;
+  struct pbuf *p;
+  bool link = false;
+  msg_t msg;
+
+  chRegSetThreadName(NCMIF_THREAD_NAME);
+
+  while (true) {
+    msg = ncmReceiveDatagramTimeout(cfg->ncmp, &dg, NCMIF_LINK_POLL_INTERVAL);
+
+    if (ncmIsActiveX(cfg->ncmp) != link) {
+      link = !link;
+      if (link)
+        tcpip_callback_with_block((tcpip_callback_fn) netif_set_link_up,
+                                  netif, 0);
+      else
+        tcpip_callback_with_block((tcpip_callback_fn) netif_set_link_down,
+                                  netif, 0);
+    }
+
+    if (msg == MSG_OK) {
+      p = low_level_input(netif, &dg);
+      if ((p != NULL) && (netif->input(p, netif) != ERR_OK))
+        pbuf_free(p);
+    }
+    else if (msg == MSG_RESET) {
+      /* Data interface not enabled.*/
+      chThdSleep(NCMIF_LINK_POLL_INTERVAL);
+    }
+  }
+}
+
+/**
+ * @brief   Network interface initialization.
+ * @details This function must be passed to @p netif_add() or
+ *          @p netifapi_netif_add(), the interface state must point to an
+ *          @p ncmif_config_t structure. The receive thread is started.
+ * @note    Only one interface can be added.
+ *
+ * @param[in] netif     the lwIP network interface
+ * @return              The operation status.
+ */
+err_t ncmifInit(struct netif *netif) {
+  const ncmif_config_t *cfg;
+
+  osalDbgAssert((netif != NULL) && (netif->state != NULL), "invalid netif");
+
+  cfg = (const ncmif_config_t *)netif->state;
+
+  MIB2_INIT_NETIF(netif, snmp_ifType_ethernet_csmacd,
+                  cfg->ncmp->config->speed);
+
+  netif->name[0]    = LWIP_IFNAME0;
+  netif->name[1]    = LWIP_IFNAME1;
+  netif->output     = etharp_output;
+  netif->linkoutput = low_level_output;
+  netif->hwaddr_len = ETHARP_HWADDR_LEN;
+  MEMCPY(netif->hwaddr, cfg->macaddress, ETHARP_HWADDR_LEN);
+  netif->mtu        = LWIP_NETIF_MTU;
+  netif->flags      = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP;
+
+#if NCMIF_LENDING == TRUE
+  chPoolLoadArray(&lent_pool, lent_datagrams, NCMIF_LENT_DATAGRAMS);
+#endif
+
+  chThdCreateStatic(wa_ncmif_thread, sizeof (wa_ncmif_thread),
+                    NCMIF_THREAD_PRIORITY, ncmif_thread, netif);
+
+  return ERR_OK;
+}
+
+/** @} */
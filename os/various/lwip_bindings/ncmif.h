@@ -0,0 +1,106 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file ncmif.h
+ * @brief lwIP network interface over USB CDC-NCM macros and structures.
+ * @addtogroup LWIP_NCMIF
+ * @{
+ */
+
+#ifndef NCMIF_H
+#define NCMIF_H
+
+#include <lwip/opt.h>
+#include <lwip/netif.h>
+
+#include "hal_usb_ncm.h"
+
+/**
+ * @brief   Receive thread name.
+ */
+#if !defined(NCMIF_THREAD_NAME) || defined(__DOXYGEN__)
+#define NCMIF_THREAD_NAME                   "ncmif"
+#endif
+
+/**
+ * @brief   Receive thread priority.
+ */
+#if !defined(NCMIF_THREAD_PRIORITY) || defined(__DOXYGEN__)
+#define NCMIF_THREAD_PRIORITY               (LOWPRIO + 1)
+#endif
+
+/**
+ * @brief   Receive thread stack size.
+ */
+#if !defined(NCMIF_THREAD_STACK_SIZE) || defined(__DOXYGEN__)
+#define NCMIF_THREAD_STACK_SIZE             512
+#endif
+
+/**
+ * @brief   Maximum number of received datagrams lent to the stack.
+ * @details Received datagrams are passed to the stack as references to the
+ *          NTB buffers, datagrams exceeding this number are copied into
+ *          pool pbufs.
+ * @note    An NTB buffer is reused for reception only after all its lent
+ *          datagrams have been freed by the stack.
+ */
+#if !defined(NCMIF_LENT_DATAGRAMS) || defined(__DOXYGEN__)
+#define NCMIF_LENT_DATAGRAMS                8
+#endif
+
+/**
+ * @brief   Link poll interval.
+ */
+#if !defined(NCMIF_LINK_POLL_INTERVAL) || defined(__DOXYGEN__)
+#define NCMIF_LINK_POLL_INTERVAL            TIME_MS2I(100)
+#endif
+
+/**
+ * @brief   Transmission timeout in milliseconds.
+ */
+#if !defined(NCMIF_SEND_TIMEOUT) || defined(__DOXYGEN__)
+#define NCMIF_SEND_TIMEOUT                  50
+#endif
+
+/**
+ * @brief   Network interface configuration structure.
+ * @details A pointer to this structure is the state of the interface.
+ */
+typedef struct ncmif_config {
+  /**
+   * @brief   USB CDC-NCM driver.
+   */
+  USBNCMDriver      *ncmp;
+  /**
+   * @brief   Interface MAC address.
+   * @note    It must differ from the address reported to the host by the
+   *          @p iMACAddress string descriptor.
+   */
+  const uint8_t     *macaddress;
+} ncmif_config_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  err_t ncmifInit(struct netif *netif);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NCMIF_H */
+
+/** @} */
@@ -0,0 +1,219 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file netfile.c
+ * @brief lwIP netconn to FatFS file transfers code.
+ * @details File contents are transmitted from buffers referenced by the
+ *          TCP segments, the data is not copied into pbufs and a buffer
+ *          is read again from the file only after the remote end has
+ *          acknowledged its content. Received pbufs are written into the
+ *          file directly from their payload.
+ * @addtogroup LWIP_NETFILE
+ * @{
+ */
+
+#include "hal.h"
+
+#include "netfile.h"
+
+#include <lwip/tcp.h>
+#include <lwip/tcpip.h>
+
+/*
+ * Sequence numbers comparison.
+ */
+#define NETFILE_SEQ_GEQ(a, b)   ((s32_t)((u32_t)(a) - (u32_t)(b)) >= 0)
+
+/*
+ * Waits until all the data enqueued before the specified sequence number
+ * has been acknowledged.
+ */
+static err_t netfile_wait_ack(struct netconn *conn, u32_t seq) {
+
+  while (true) {
+    err_t err = ERR_OK;
+    bool acked = false;
+
+    LOCK_TCPIP_CORE();
+    /* The segments are freed with the PCB if the connection is lost.*/
+    if (conn->pcb.tcp == NULL)
+      err = ERR_CLSD;
+    else
+      acked = NETFILE_SEQ_GEQ(conn->pcb.tcp->lastack, seq);
+    UNLOCK_TCPIP_CORE();
+
+    if (err != ERR_OK)
+      return err;
+    if (acked)
+      return ERR_OK;
+
+    chThdSleep(NETFILE_ACK_POLL_INTERVAL);
+  }
+}
+
+/*
+ * Returns the sequence number following the last enqueued byte.
+ */
+static u32_t netfile_get_seq(struct netconn *conn) {
+  u32_t seq = 0U;
+
+  LOCK_TCPIP_CORE();
+  if (conn->pcb.tcp != NULL)
+    seq = conn->pcb.tcp->snd_lbb;
+  UNLOCK_TCPIP_CORE();
+
+  return seq;
+}
+
+/**
+ * @brief   Transmits part of a file over a TCP connection.
+ * @details The file is read in the buffers of the transfer object, the
+ *          buffers are enqueued using @p NETCONN_NOCOPY and reused after
+ *          the remote end acknowledged them.
+ * @note    The function returns after all the sent data has been
+ *          acknowledged or the connection has been lost, the transfer
+ *          object can then be reused.
+ *
+ * @param[in] nfp       pointer to a @p netfile_t object
+ * @param[in] conn      TCP connection
+ * @param[in] fp        file open for reading, the transfer starts from
+ *                      the current position
+ * @param[in] n         maximum number of bytes to be sent
+ * @param[out] sentp    pointer to a variable receiving the number of bytes
+ *                      sent or @p NULL
+ * @return              The operation status.
+ * @retval ERR_OK       if @p n bytes have been sent or the end of the file
+ *                      has been reached.
+ * @retval ERR_VAL      if a file read error occurred.
+ * @retval ERR_CLSD     if the connection has been lost.
+ */
+err_t netfileSend(netfile_t *nfp, struct netconn *conn,
+                  FIL *fp, size_t n, size_t *sentp) {
+  unsigned i, used;
+  size_t sent;
+  u32_t last;
+  err_t err, ackerr;
+
+  osalDbgCheck((nfp != NULL) && (conn != NULL) && (fp != NULL));
+
+  i     = 0U;
+  used  = 0U;
+  sent  = 0U;
+  last  = netfile_get_seq(conn);
+  err   = ERR_OK;
+  while (n > 0U) {
+    uint8_t *buf = (uint8_t *)nfp->buffers[i];
+    UINT br;
+
+    /* The buffer is read again after the stack released it.*/
+    if (used >= NETFILE_BUFFERS_NUMBER) {
+      err = netfile_wait_ack(conn, nfp->seqend[i]);
+      if (err != ERR_OK)
+        break;
+    }
+
+    if (f_read(fp, buf, n < NETFILE_BUFFER_SIZE ? n : NETFILE_BUFFER_SIZE,
+               &br) != FR_OK) {
+      err = ERR_VAL;
+      break;
+    }
+    if (br == 0U)
+      break;
+    n -= br;
+
+    /* The buffer is referenced by the enqueued segments, the push flag is
+       only set on the last one. A failed write could have enqueued part
+       of the buffer so the sequence number is recorded anyway.*/
+    err = netconn_write(conn, buf, br,
+                        NETCONN_NOCOPY | (n > 0U ? NETCONN_MORE : 0U));
+    last = netfile_get_seq(conn);
+    nfp->seqend[i] = last;
+    used++;
+    if (++i >= NETFILE_BUFFERS_NUMBER)
+      i = 0U;
+    if (err != ERR_OK)
+      break;
+    sent += br;
+  }
+
+  /* Draining, the buffers must not be referenced on exit.*/
+  ackerr = netfile_wait_ack(conn, last);
+  if (err == ERR_OK)
+    err = ackerr;
+
+  if (sentp != NULL)
+    *sentp = sent;
+
+  return err;
+}
+
+/**
+ * @brief   Receives data from a TCP connection into a file.
+ * @details The payload of the received pbufs is written at the current
+ *          position of the file.
+ * @note    Data following the first @p n bytes in the same pbuf is
+ *          discarded.
+ *
+ * @param[in] conn      TCP connection
+ * @param[in] fp        file open for writing
+ * @param[in] n         number of bytes to be received
+ * @param[out] receivedp pointer to a variable receiving the number of bytes
+ *                      written into the file or @p NULL
+ * @return              The operation status.
+ * @retval ERR_OK       if @p n bytes have been received.
+ * @retval ERR_VAL      if a file write error occurred.
+ * @retval ERR_CLSD     if the connection has been closed before receiving
+ *                      @p n bytes.
+ */
+err_t netfileReceive(struct netconn *conn, FIL *fp,
+                     size_t n, size_t *receivedp) {
+  size_t received;
+  err_t err;
+
+  osalDbgCheck((conn != NULL) && (fp != NULL));
+
+  received = 0U;
+  err      = ERR_OK;
+  while (received < n) {
+    struct pbuf *p, *q;
+
+    err = netconn_recv_tcp_pbuf(conn, &p);
+    if (err != ERR_OK)
+      break;
+
+    for (q = p; (q != NULL) && (received < n); q = q->next) {
+      size_t len = q->len < n - received ? q->len : n - received;
+      UINT bw;
+
+      if ((f_write(fp, q->payload, len, &bw) != FR_OK) || (bw != len)) {
+        err = ERR_VAL;
+        break;
+      }
+      received += len;
+    }
+    pbuf_free(p);
+    if (err != ERR_OK)
+      break;
+  }
+
+  if (receivedp != NULL)
+    *receivedp = received;
+
+  return err;
+}
+
+/** @} */
@@ -0,0 +1,101 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file netfile.h
+ * @brief lwIP netconn to FatFS file transfers macros and structures.
+ * @addtogroup LWIP_NETFILE
+ * @{
+ */
+
+#ifndef NETFILE_H
+#define NETFILE_H
+
+#include <lwip/opt.h>
+#include <lwip/api.h>
+
+#include "ff.h"
+
+/**
+ * @brief   Number of transmit buffers.
+ * @details A buffer is read from the file while the previous ones are
+ *          transmitted or waiting to be acknowledged.
+ */
+#if !defined(NETFILE_BUFFERS_NUMBER) || defined(__DOXYGEN__)
+#define NETFILE_BUFFERS_NUMBER              2
+#endif
+
+/**
+ * @brief   Size of a transmit buffer.
+ * @note    It must be a multiple of the sector size, whole sectors are
+ *          read by FatFS directly into the buffer if the file position is
+ *          sector aligned.
+ */
+#if !defined(NETFILE_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define NETFILE_BUFFER_SIZE                 2048
+#endif
+
+/**
+ * @brief   Interval between checks of the acknowledged sequence number.
+ */
+#if !defined(NETFILE_ACK_POLL_INTERVAL) || defined(__DOXYGEN__)
+#define NETFILE_ACK_POLL_INTERVAL           TIME_MS2I(2)
+#endif
+
+#if NETFILE_BUFFERS_NUMBER < 2
+#error "NETFILE_BUFFERS_NUMBER must be at least 2"
+#endif
+
+#if (NETFILE_BUFFER_SIZE % FF_MAX_SS) != 0
+#error "NETFILE_BUFFER_SIZE must be a multiple of FF_MAX_SS"
+#endif
+
+#if !LWIP_TCPIP_CORE_LOCKING
+#error "netfile requires LWIP_TCPIP_CORE_LOCKING"
+#endif
+
+/**
+ * @brief   Transfer object.
+ * @details It holds the buffers referenced by the stack while the data is
+ *          not acknowledged, an object can be used by a single transfer
+ *          at time.
+ */
+typedef struct netfile {
+  /**
+   * @brief   Buffers sent without copying them into pbufs.
+   */
+  uint32_t          buffers[NETFILE_BUFFERS_NUMBER][NETFILE_BUFFER_SIZE /
+                                                    sizeof (uint32_t)];
+  /**
+   * @brief   Sequence number following the last byte of each buffer.
+   */
+  u32_t             seqend[NETFILE_BUFFERS_NUMBER];
+} netfile_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  err_t netfileSend(netfile_t *nfp, struct netconn *conn,
+                    FIL *fp, size_t n, size_t *sentp);
+  err_t netfileReceive(struct netconn *conn, FIL *fp,
+                       size_t n, size_t *receivedp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NETFILE_H */
+
+/** @} */
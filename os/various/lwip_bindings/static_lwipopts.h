@@ -37,6 +37,41 @@
 
 #define MEM_ALIGNMENT                   4
 
+/* Checksums handled by the MAC are not computed by the stack.*/
+#include "hal.h"
+
+#if defined(MAC_CHECKSUM_TX_OFFLOAD)
+#if (MAC_CHECKSUM_TX_OFFLOAD & MAC_CHECKSUM_IP) && !defined(CHECKSUM_GEN_IP)
+#define CHECKSUM_GEN_IP                 0
+#endif
+#if (MAC_CHECKSUM_TX_OFFLOAD & MAC_CHECKSUM_TCP) && !defined(CHECKSUM_GEN_TCP)
+#define CHECKSUM_GEN_TCP                0
+#endif
+#if (MAC_CHECKSUM_TX_OFFLOAD & MAC_CHECKSUM_UDP) && !defined(CHECKSUM_GEN_UDP)
+#define CHECKSUM_GEN_UDP                0
+#endif
+#if (MAC_CHECKSUM_TX_OFFLOAD & MAC_CHECKSUM_ICMP) && !defined(CHECKSUM_GEN_ICMP)
+#define CHECKSUM_GEN_ICMP               0
+#define CHECKSUM_GEN_ICMP6              0
+#endif
+#endif
+
+#if defined(MAC_CHECKSUM_RX_OFFLOAD)
+#if (MAC_CHECKSUM_RX_OFFLOAD & MAC_CHECKSUM_IP) && !defined(CHECKSUM_CHECK_IP)
+#define CHECKSUM_CHECK_IP               0
+#endif
+#if (MAC_CHECKSUM_RX_OFFLOAD & MAC_CHECKSUM_TCP) && !defined(CHECKSUM_CHECK_TCP)
+#define CHECKSUM_CHECK_TCP              0
+#endif
+#if (MAC_CHECKSUM_RX_OFFLOAD & MAC_CHECKSUM_UDP) && !defined(CHECKSUM_CHECK_UDP)
+#define CHECKSUM_CHECK_UDP              0
+#endif
+#if (MAC_CHECKSUM_RX_OFFLOAD & MAC_CHECKSUM_ICMP) && !defined(CHECKSUM_CHECK_ICMP)
+#define CHECKSUM_CHECK_ICMP             0
+#define CHECKSUM_CHECK_ICMP6            0
+#endif
+#endif
+
 #endif  /* STATIC_LWIPOPTS_H */
 
 /** @} */
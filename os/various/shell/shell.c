@@ -47,6 +47,33 @@ event_source_t shell_terminated;
 /* Module local types.                                                       */
 /*===========================================================================*/
 
+#if (SHELL_OUTPUT_BUFFER_SIZE > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Buffered output stream.
+ * @details Stream passed to the commands, output is accumulated and
+ *          written to the channel in blocks, input is read directly from
+ *          the channel after flushing the pending output.
+ */
+typedef struct {
+  /**
+   * @brief   Virtual Methods Table.
+   */
+  const struct BaseSequentialStreamVMT *vmt;
+  /**
+   * @brief   Shell channel.
+   */
+  BaseSequentialStream  *chp;
+  /**
+   * @brief   Number of buffered bytes.
+   */
+  size_t                n;
+  /**
+   * @brief   Output buffer.
+   */
+  uint8_t               buf[SHELL_OUTPUT_BUFFER_SIZE];
+} shell_output_t;
+#endif
+
 /*===========================================================================*/
 /* Module local variables.                                                   */
 /*===========================================================================*/
@@ -55,6 +82,55 @@ event_source_t shell_terminated;
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (SHELL_OUTPUT_BUFFER_SIZE > 0) || defined(__DOXYGEN__)
+static void out_flush(shell_output_t *sop) {
+
+  if (sop->n > 0U) {
+    (void) streamWrite(sop->chp, sop->buf, sop->n);
+    sop->n = 0U;
+  }
+}
+
+static size_t out_writes(void *ip, const uint8_t *bp, size_t n) {
+  shell_output_t *sop = ip;
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    sop->buf[sop->n++] = bp[i];
+    if (sop->n >= (size_t)SHELL_OUTPUT_BUFFER_SIZE) {
+      out_flush(sop);
+    }
+  }
+  return n;
+}
+
+static size_t out_reads(void *ip, uint8_t *bp, size_t n) {
+  shell_output_t *sop = ip;
+
+  out_flush(sop);
+  return streamRead(sop->chp, bp, n);
+}
+
+static msg_t out_put(void *ip, uint8_t b) {
+
+  (void) out_writes(ip, &b, 1U);
+  return MSG_OK;
+}
+
+static msg_t out_get(void *ip) {
+  shell_output_t *sop = ip;
+
+  out_flush(sop);
+  return streamGet(sop->chp);
+}
+
+static const struct BaseSequentialStreamVMT out_vmt = {
+  (size_t)0, out_writes, out_reads, out_put, out_get,
+  streamDefaultWriteV, streamDefaultGetReadBuffer,
+  streamDefaultReleaseReadBuffer
+};
+#endif
+
 static char *parse_arguments(char *str, char **saveptr) {
   char *p;
 
@@ -337,6 +413,14 @@ THD_FUNCTION(shellThread, p) {
   const ShellCommand *scp = scfg->sc_commands;
   char *lp, *cmd, *tokp, line[SHELL_MAX_LINE_LENGTH];
   char *args[SHELL_MAX_ARGUMENTS + 1];
+#if SHELL_OUTPUT_BUFFER_SIZE > 0
+  shell_output_t out;
+
+  out.vmt = &out_vmt;
+  out.chp = chp;
+  out.n   = 0U;
+  chp = (BaseSequentialStream *)(void *)&out;
+#endif
 
 #if SHELL_USE_HISTORY == TRUE
   *(scfg->sc_histbuf) = 0;
@@ -356,6 +440,9 @@ THD_FUNCTION(shellThread, p) {
   chprintf(chp, "ChibiOS/RT Shell" SHELL_NEWLINE_STR);
   while (!chThdShouldTerminateX()) {
     chprintf(chp, SHELL_PROMPT_STR);
+#if SHELL_OUTPUT_BUFFER_SIZE > 0
+    out_flush(&out);
+#endif
     if (shellGetLine(scfg, line, sizeof(line), shp)) {
 #if (SHELL_CMD_EXIT_ENABLED == TRUE) && !defined(_CHIBIOS_NIL_)
       chprintf(chp, SHELL_NEWLINE_STR);
@@ -398,6 +485,9 @@ THD_FUNCTION(shellThread, p) {
       }
     }
   }
+#if SHELL_OUTPUT_BUFFER_SIZE > 0
+  out_flush(&out);
+#endif
   shellExit(MSG_OK);
 }
 
@@ -99,6 +99,19 @@
 #define SHELL_PROMPT_STR            "ch> "
 #endif
 
+/**
+ * @brief   Commands output buffer size.
+ * @details If greater than zero the commands output is accumulated in a
+ *          buffer allocated on the shell thread stack and written to the
+ *          channel in blocks instead of one character at time, the buffer
+ *          is flushed when full, before reading from the channel and at
+ *          the end of each command.
+ * @note    The default is zero, no buffering.
+ */
+#if !defined(SHELL_OUTPUT_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define SHELL_OUTPUT_BUFFER_SIZE    0
+#endif
+
 /**
  * @brief   Newline string
  */
@@ -110,6 +123,10 @@
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if SHELL_OUTPUT_BUFFER_SIZE < 0
+#error "invalid SHELL_OUTPUT_BUFFER_SIZE value"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
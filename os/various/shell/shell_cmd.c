@@ -22,6 +22,7 @@
  * @{
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "ch.h"
@@ -55,6 +56,44 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (SHELL_CMD_TOP_ENABLED == TRUE) || (SHELL_CMD_IRQSTAT_ENABLED == TRUE) || \
+    (SHELL_CMD_VTSTAT_ENABLED == TRUE) ||                                   \
+    (SHELL_CMD_HEAPSTAT_ENABLED == TRUE) || defined(__DOXYGEN__)
+/* Decodes the optional "[period [count]]" arguments of the live commands,
+   a zero period means a single snapshot.*/
+static bool get_refresh(int argc, char *argv[],
+                        unsigned *periodp, unsigned *countp) {
+
+  if (argc > 2) {
+    return false;
+  }
+  if (argc > 0) {
+    *periodp = (unsigned)atoi(argv[0]);
+    *countp  = 10U;
+  }
+  if (argc > 1) {
+    *countp  = (unsigned)atoi(argv[1]);
+  }
+  if (*countp == 0U) {
+    *countp = 1U;
+  }
+  return true;
+}
+
+/* Waits for the next refresh, returns false after the last one.*/
+static bool next_refresh(BaseSequentialStream *chp,
+                         unsigned period, unsigned *countp) {
+
+  if ((--*countp == 0U) || (period == 0U) || chThdShouldTerminateX()) {
+    return false;
+  }
+  chThdSleepMilliseconds(period);
+  /* Clearing the screen before the next refresh.*/
+  chprintf(chp, "\033[2J\033[H");
+  return true;
+}
+#endif
+
 #if ((SHELL_CMD_EXIT_ENABLED == TRUE) && !defined(_CHIBIOS_NIL_)) ||        \
     defined(__DOXYGEN__)
 static void cmd_exit(BaseSequentialStream *chp, int argc, char *argv[]) {
@@ -171,6 +210,266 @@ static void cmd_threads(BaseSequentialStream *chp, int argc, char *argv[]) {
 }
 #endif
 
+#if (SHELL_CMD_STACKS_ENABLED == TRUE) || defined(__DOXYGEN__)
+static void cmd_stacks(BaseSequentialStream *chp, int argc, char *argv[]) {
+  thread_t *tp;
+
+  (void)argv;
+  if (argc > 0) {
+    shellUsage(chp, "stacks");
+    return;
+  }
+  chprintf(chp, "stklimit     size     used     free         name" SHELL_NEWLINE_STR);
+  tp = chRegFirstThread();
+  do {
+    uint32_t stklimit = (uint32_t)tp->wabase;
+    uint32_t free = (uint32_t)chThdGetStackFreeX(tp);
+    uint32_t size = 0U;
+
+    /* The thread structure is at the top of its working area, the main
+       thread stack size is not known.*/
+    if ((stklimit != 0U) && ((uint32_t)tp > stklimit)) {
+      size = (uint32_t)tp - stklimit;
+    }
+    if (size > 0U) {
+      chprintf(chp, "%08lx %8lu %8lu %8lu %12s" SHELL_NEWLINE_STR,
+               stklimit, size, size - free, free,
+               tp->name == NULL ? "" : tp->name);
+    }
+    else {
+      chprintf(chp, "%08lx        -        - %8lu %12s" SHELL_NEWLINE_STR,
+               stklimit, free, tp->name == NULL ? "" : tp->name);
+    }
+    tp = chRegNextThread(tp);
+  } while (tp != NULL);
+}
+#endif
+
+#if (SHELL_CMD_TOP_ENABLED == TRUE) || defined(__DOXYGEN__)
+static void cmd_top(BaseSequentialStream *chp, int argc, char *argv[]) {
+  static const char *states[] = {CH_STATE_NAMES};
+  unsigned period = 1000U, count = 1U;
+  ucnt_t nctxswc, nirq;
+  thread_t *tp;
+
+  if (!get_refresh(argc, argv, &period, &count) || (period == 0U)) {
+    shellUsage(chp, "top [period_ms [count]]");
+    return;
+  }
+
+  /* Starting the first load window.*/
+  chRegUpdateLoad();
+  nctxswc = ch.kernel_stats.n_ctxswc;
+  nirq    = ch.kernel_stats.n_irq;
+  do {
+    ucnt_t dctxswc, dirq;
+
+    chThdSleepMilliseconds(period);
+    chRegUpdateLoad();
+    dctxswc = ch.kernel_stats.n_ctxswc - nctxswc;
+    dirq    = ch.kernel_stats.n_irq - nirq;
+    nctxswc = ch.kernel_stats.n_ctxswc;
+    nirq    = ch.kernel_stats.n_irq;
+
+    chprintf(chp, "\033[2J\033[H");
+    chprintf(chp, "ctxsw/s %8lu   irq/s %8lu   isr load %3u%%" SHELL_NEWLINE_STR,
+             (uint32_t)(((uint64_t)dctxswc * 1000U) / period),
+             (uint32_t)(((uint64_t)dirq * 1000U) / period),
+             (unsigned)ch.kernel_stats.isr_load);
+    chprintf(chp, "worst critical zone: thd %lu isr %lu cycles" SHELL_NEWLINE_STR,
+             (uint32_t)ch.kernel_stats.m_crit_thd.worst,
+             (uint32_t)ch.kernel_stats.m_crit_isr.worst);
+    chprintf(chp, SHELL_NEWLINE_STR "    addr prio     state  cpu         name" SHELL_NEWLINE_STR);
+    tp = chRegFirstThread();
+    do {
+      chprintf(chp, "%08lx %4lu %9s %3u%% %12s" SHELL_NEWLINE_STR,
+               (uint32_t)tp, (uint32_t)tp->prio, states[tp->state],
+               chRegGetThreadLoadX(tp), tp->name == NULL ? "" : tp->name);
+      tp = chRegNextThread(tp);
+    } while (tp != NULL);
+  } while ((--count > 0U) && !chThdShouldTerminateX());
+}
+#endif
+
+#if (SHELL_CMD_IRQSTAT_ENABLED == TRUE) || defined(__DOXYGEN__)
+static void cmd_irqstat(BaseSequentialStream *chp, int argc, char *argv[]) {
+  unsigned period = 0U, count = 1U;
+  ucnt_t nirq = ch.kernel_stats.n_irq;
+
+  if (!get_refresh(argc, argv, &period, &count)) {
+    shellUsage(chp, "irqstat [period_ms [count]]");
+    return;
+  }
+
+  do {
+    time_measurement_t crit;
+
+    chSysLock();
+    crit = ch.kernel_stats.m_crit_isr;
+    chSysUnlock();
+
+    chprintf(chp, "irq count        : %lu" SHELL_NEWLINE_STR,
+             (uint32_t)ch.kernel_stats.n_irq);
+    if (period > 0U) {
+      chprintf(chp, "irq/s            : %lu" SHELL_NEWLINE_STR,
+               (uint32_t)(((uint64_t)(ch.kernel_stats.n_irq - nirq) * 1000U) /
+                          period));
+      nirq = ch.kernel_stats.n_irq;
+    }
+    chprintf(chp, "isr load         : %u%%" SHELL_NEWLINE_STR,
+             (unsigned)ch.kernel_stats.isr_load);
+    chprintf(chp, "isr crit. zones  : %lu" SHELL_NEWLINE_STR,
+             (uint32_t)crit.n);
+    chprintf(chp, "isr crit. best   : %lu cycles" SHELL_NEWLINE_STR,
+             (uint32_t)crit.best);
+    chprintf(chp, "isr crit. worst  : %lu cycles" SHELL_NEWLINE_STR,
+             (uint32_t)crit.worst);
+    chprintf(chp, "thd crit. worst  : %lu cycles" SHELL_NEWLINE_STR,
+             (uint32_t)ch.kernel_stats.m_crit_thd.worst);
+  } while (next_refresh(chp, period, &count));
+}
+#endif
+
+#if (SHELL_CMD_VTSTAT_ENABLED == TRUE) || defined(__DOXYGEN__)
+static void cmd_vtstat(BaseSequentialStream *chp, int argc, char *argv[]) {
+  unsigned period = 0U, count = 1U;
+
+  if (!get_refresh(argc, argv, &period, &count)) {
+    shellUsage(chp, "vtstat [period_ms [count]]");
+    return;
+  }
+
+  do {
+    sysinterval_t next;
+    unsigned armed = 0U;
+    bool active;
+#if CH_CFG_VT_WHEEL == FALSE
+    sysinterval_t last = (sysinterval_t)0;
+    virtual_timer_t *vtp;
+#else
+    unsigned level, slot;
+#endif
+
+    /* Scanning the timers within a critical zone, the zone duration is
+       proportional to the number of armed timers.*/
+    chSysLock();
+    active = chVTGetTimersStateI(&next);
+#if CH_CFG_VT_WHEEL == FALSE
+    for (vtp = ch.vtlist.next; vtp != (virtual_timer_t *)&ch.vtlist;
+         vtp = vtp->next) {
+      last += vtp->delta;
+      armed++;
+    }
+#else
+    for (level = 0U; level < (unsigned)CH_CFG_VT_WHEEL_LEVELS; level++) {
+      for (slot = 0U; slot < (unsigned)CH_VT_WHEEL_SLOTS; slot++) {
+        virtual_timer_t *vtp = ch.vtlist.slots[level][slot].next;
+
+        while (vtp != (virtual_timer_t *)&ch.vtlist.slots[level][slot]) {
+          armed++;
+          vtp = vtp->next;
+        }
+      }
+    }
+#endif
+    chSysUnlock();
+
+    chprintf(chp, "system time      : %lu" SHELL_NEWLINE_STR,
+             (unsigned long)chVTGetSystemTime());
+    chprintf(chp, "armed timers     : %u" SHELL_NEWLINE_STR, armed);
+    if (active) {
+      chprintf(chp, "next timeout in  : %lu ticks" SHELL_NEWLINE_STR,
+               (unsigned long)next);
+    }
+#if CH_CFG_VT_WHEEL == FALSE
+    if (armed > 0U) {
+      chprintf(chp, "last timeout in  : %lu ticks" SHELL_NEWLINE_STR,
+               (unsigned long)last);
+    }
+#endif
+#if CH_DBG_STATISTICS == TRUE
+    chprintf(chp, "coalesced alarms : %lu" SHELL_NEWLINE_STR,
+             (uint32_t)ch.kernel_stats.n_vtsaved);
+#endif
+  } while (next_refresh(chp, period, &count));
+}
+#endif
+
+#if (SHELL_CMD_HEAPSTAT_ENABLED == TRUE) || defined(__DOXYGEN__)
+static void cmd_heapstat(BaseSequentialStream *chp, int argc, char *argv[]) {
+  unsigned period = 0U, count = 1U;
+
+  if (!get_refresh(argc, argv, &period, &count)) {
+    shellUsage(chp, "heapstat [period_ms [count]]");
+    return;
+  }
+
+  do {
+    size_t n, total, largest;
+    unsigned frag = 0U;
+
+    n = chHeapStatus(NULL, &total, &largest);
+    /* Fragmentation is the part of the free memory not usable for an
+       allocation as large as the whole free memory.*/
+    if (total > 0U) {
+      frag = (unsigned)(100U - ((largest * 100U) / total));
+    }
+    chprintf(chp, "heap fragments   : %u" SHELL_NEWLINE_STR, n);
+    chprintf(chp, "heap free total  : %u bytes" SHELL_NEWLINE_STR, total);
+    chprintf(chp, "heap free largest: %u bytes" SHELL_NEWLINE_STR, largest);
+    chprintf(chp, "fragmentation    : %u%%" SHELL_NEWLINE_STR, frag);
+#if CH_CFG_USE_MEMCORE == TRUE
+    chprintf(chp, "core free memory : %u bytes" SHELL_NEWLINE_STR,
+             chCoreGetStatusX());
+#endif
+  } while (next_refresh(chp, period, &count));
+}
+#endif
+
+#if (SHELL_CMD_WAITSTAT_ENABLED == TRUE) || defined(__DOXYGEN__)
+static void cmd_waitstat(BaseSequentialStream *chp, int argc, char *argv[]) {
+  static const char *states[] = {CH_STATE_NAMES};
+  wait_profile_entry_t wpe;
+  unsigned i;
+
+  if ((argc > 1) || ((argc == 1) && strcmp(argv[0], "reset"))) {
+    shellUsage(chp, "waitstat [reset]");
+    return;
+  }
+  if (argc == 1) {
+    chWaitProfileReset();
+    return;
+  }
+
+  chprintf(chp, "        name      obj     state      n   tmo   cumulative"
+                "      worst    waker" SHELL_NEWLINE_STR);
+  for (i = 0U; i < (unsigned)CH_DBG_WAIT_PROFILE_ENTRIES; i++) {
+    const char *name = "";
+
+    if (!chWaitProfileGetEntry(i, &wpe)) {
+      continue;
+    }
+#if CH_CFG_USE_REGISTRY == TRUE
+    if (wpe.name != NULL) {
+      name = wpe.name;
+    }
+#endif
+    chprintf(chp, "%12s %08lx %9s %6lu %5lu %12lu %10lu ",
+             name, (uint32_t)wpe.objp, states[wpe.state],
+             (uint32_t)wpe.n, (uint32_t)wpe.n_timeout,
+             (uint32_t)wpe.cumulative, (uint32_t)wpe.worst);
+    if (wpe.waker == NULL) {
+      chprintf(chp, "  isr/tmo" SHELL_NEWLINE_STR);
+    }
+    else {
+      chprintf(chp, "%08lx" SHELL_NEWLINE_STR, (uint32_t)wpe.waker);
+    }
+  }
+  chprintf(chp, "dropped waits: %lu" SHELL_NEWLINE_STR,
+           (uint32_t)ch.wait_profile.n_dropped);
+}
+#endif
+
 #if (SHELL_CMD_TEST_ENABLED == TRUE) || defined(__DOXYGEN__)
 static THD_FUNCTION(test_rt, arg) {
   BaseSequentialStream *chp = (BaseSequentialStream *)arg;
@@ -238,6 +537,24 @@ const ShellCommand shell_local_commands[] = {
 #if SHELL_CMD_THREADS_ENABLED == TRUE
   {"threads", cmd_threads},
 #endif
+#if SHELL_CMD_STACKS_ENABLED == TRUE
+  {"stacks", cmd_stacks},
+#endif
+#if SHELL_CMD_TOP_ENABLED == TRUE
+  {"top", cmd_top},
+#endif
+#if SHELL_CMD_IRQSTAT_ENABLED == TRUE
+  {"irqstat", cmd_irqstat},
+#endif
+#if SHELL_CMD_VTSTAT_ENABLED == TRUE
+  {"vtstat", cmd_vtstat},
+#endif
+#if SHELL_CMD_HEAPSTAT_ENABLED == TRUE
+  {"heapstat", cmd_heapstat},
+#endif
+#if SHELL_CMD_WAITSTAT_ENABLED == TRUE
+  {"waitstat", cmd_waitstat},
+#endif
 #if SHELL_CMD_TEST_ENABLED == TRUE
   {"test", cmd_test},
 #endif
@@ -57,6 +57,30 @@
 #define SHELL_CMD_THREADS_ENABLED           TRUE
 #endif
 
+#if !defined(SHELL_CMD_STACKS_ENABLED) || defined(__DOXYGEN__)
+#define SHELL_CMD_STACKS_ENABLED            FALSE
+#endif
+
+#if !defined(SHELL_CMD_TOP_ENABLED) || defined(__DOXYGEN__)
+#define SHELL_CMD_TOP_ENABLED               FALSE
+#endif
+
+#if !defined(SHELL_CMD_IRQSTAT_ENABLED) || defined(__DOXYGEN__)
+#define SHELL_CMD_IRQSTAT_ENABLED           FALSE
+#endif
+
+#if !defined(SHELL_CMD_VTSTAT_ENABLED) || defined(__DOXYGEN__)
+#define SHELL_CMD_VTSTAT_ENABLED            FALSE
+#endif
+
+#if !defined(SHELL_CMD_HEAPSTAT_ENABLED) || defined(__DOXYGEN__)
+#define SHELL_CMD_HEAPSTAT_ENABLED          FALSE
+#endif
+
+#if !defined(SHELL_CMD_WAITSTAT_ENABLED) || defined(__DOXYGEN__)
+#define SHELL_CMD_WAITSTAT_ENABLED          FALSE
+#endif
+
 #if !defined(SHELL_CMD_TEST_ENABLED) || defined(__DOXYGEN__)
 #define SHELL_CMD_TEST_ENABLED              TRUE
 #endif
@@ -81,6 +105,39 @@
 #error "SHELL_CMD_THREADS_ENABLED requires CH_CFG_USE_REGISTRY"
 #endif
 
+#if (SHELL_CMD_STACKS_ENABLED == TRUE) && (CH_CFG_USE_REGISTRY == FALSE)
+#error "SHELL_CMD_STACKS_ENABLED requires CH_CFG_USE_REGISTRY"
+#endif
+
+#if (SHELL_CMD_STACKS_ENABLED == TRUE) && (CH_DBG_FILL_THREADS == FALSE)
+#error "SHELL_CMD_STACKS_ENABLED requires CH_DBG_FILL_THREADS"
+#endif
+
+#if (SHELL_CMD_STACKS_ENABLED == TRUE) &&                                   \
+    (CH_DBG_ENABLE_STACK_CHECK == FALSE) && (CH_CFG_USE_DYNAMIC == FALSE)
+#error "SHELL_CMD_STACKS_ENABLED requires CH_DBG_ENABLE_STACK_CHECK or CH_CFG_USE_DYNAMIC"
+#endif
+
+#if (SHELL_CMD_TOP_ENABLED == TRUE) && (CH_CFG_USE_REGISTRY == FALSE)
+#error "SHELL_CMD_TOP_ENABLED requires CH_CFG_USE_REGISTRY"
+#endif
+
+#if (SHELL_CMD_TOP_ENABLED == TRUE) && (CH_DBG_STATISTICS == FALSE)
+#error "SHELL_CMD_TOP_ENABLED requires CH_DBG_STATISTICS"
+#endif
+
+#if (SHELL_CMD_IRQSTAT_ENABLED == TRUE) && (CH_DBG_STATISTICS == FALSE)
+#error "SHELL_CMD_IRQSTAT_ENABLED requires CH_DBG_STATISTICS"
+#endif
+
+#if (SHELL_CMD_HEAPSTAT_ENABLED == TRUE) && (CH_CFG_USE_HEAP == FALSE)
+#error "SHELL_CMD_HEAPSTAT_ENABLED requires CH_CFG_USE_HEAP"
+#endif
+
+#if (SHELL_CMD_WAITSTAT_ENABLED == TRUE) && (CH_DBG_WAIT_PROFILE == FALSE)
+#error "SHELL_CMD_WAITSTAT_ENABLED requires CH_DBG_WAIT_PROFILE"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -61,9 +61,11 @@
 #include <sys/types.h>
 
 #include "ch.h"
-#if defined(STDOUT_SD) || defined(STDIN_SD)
+#if defined(STDOUT_SD) || defined(STDIN_SD) ||                              \
+    defined(STDOUT_STREAM) || defined(STDIN_STREAM)
 #include "hal.h"
 #endif
+#include "syscalls.h"
 
 /***************************************************************************/
 
@@ -78,6 +80,13 @@ int _read_r(struct _reent *r, int file, char * ptr, int len)
   }
   len = sdRead(&STDIN_SD, (uint8_t *)ptr, (size_t)len);
   return len;
+#elif defined(STDIN_STREAM)
+  if (!len || (file != 0)) {
+    __errno_r(r) = EINVAL;
+    return -1;
+  }
+  len = streamRead(STDIN_STREAM, (uint8_t *)ptr, (size_t)len);
+  return len;
 #else
   (void)file;
   (void)ptr;
@@ -114,6 +123,14 @@ int _write_r(struct _reent *r, int file, char * ptr, int len)
     return -1;
   }
   sdWrite(&STDOUT_SD, (uint8_t *)ptr, (size_t)len);
+#elif defined(STDOUT_STREAM)
+  /* The stdio buffer is written in a single operation, stderr shares the
+     same stream.*/
+  if ((file != 1) && (file != 2)) {
+    __errno_r(r) = EINVAL;
+    return -1;
+  }
+  streamWrite(STDOUT_STREAM, (uint8_t *)ptr, (size_t)len);
 #endif
   return len;
 }
@@ -154,6 +171,119 @@ caddr_t _sbrk_r(struct _reent *r, int incr)
 
 /***************************************************************************/
 
+#if SYSCALLS_USE_HEAP == TRUE
+__attribute__((used))
+void *_malloc_r(struct _reent *r, size_t size)
+{
+  void *p;
+
+  p = chHeapAlloc(NULL, size);
+  if (p == NULL) {
+    __errno_r(r) = ENOMEM;
+  }
+  return p;
+}
+
+__attribute__((used))
+void *_memalign_r(struct _reent *r, size_t align, size_t size)
+{
+  void *p;
+
+  p = chHeapAllocAligned(NULL, size, (unsigned)align);
+  if (p == NULL) {
+    __errno_r(r) = ENOMEM;
+  }
+  return p;
+}
+
+__attribute__((used))
+void _free_r(struct _reent *r, void *p)
+{
+  (void)r;
+
+  if (p != NULL) {
+    chHeapFree(p);
+  }
+}
+
+__attribute__((used))
+void *_calloc_r(struct _reent *r, size_t n, size_t size)
+{
+  void *p;
+
+  if ((size != 0U) && (n > (size_t)-1 / size)) {
+    __errno_r(r) = ENOMEM;
+    return NULL;
+  }
+  p = _malloc_r(r, n * size);
+  if (p != NULL) {
+    memset(p, 0, n * size);
+  }
+  return p;
+}
+
+__attribute__((used))
+void *_realloc_r(struct _reent *r, void *p, size_t size)
+{
+  void *np;
+  size_t oldsize;
+
+  if (p == NULL) {
+    return _malloc_r(r, size);
+  }
+  if (size == 0U) {
+    _free_r(r, p);
+    return NULL;
+  }
+
+  /* The block is kept if it is already large enough.*/
+  oldsize = chHeapGetSize(p);
+  if (size <= oldsize) {
+    return p;
+  }
+  np = _malloc_r(r, size);
+  if (np != NULL) {
+    memcpy(np, p, oldsize);
+    chHeapFree(p);
+  }
+  return np;
+}
+
+/* The non-reentrant entry points are also replaced so that newlib
+   allocator objects are never linked.*/
+__attribute__((used))
+void *malloc(size_t size)
+{
+  return _malloc_r(_REENT, size);
+}
+
+__attribute__((used))
+void free(void *p)
+{
+  _free_r(_REENT, p);
+}
+
+__attribute__((used))
+void *calloc(size_t n, size_t size)
+{
+  return _calloc_r(_REENT, n, size);
+}
+
+__attribute__((used))
+void *realloc(void *p, size_t size)
+{
+  return _realloc_r(_REENT, p, size);
+}
+
+__attribute__((used))
+void *memalign(size_t align, size_t size)
+{
+  return _memalign_r(_REENT, align, size);
+}
+#endif /* SYSCALLS_USE_HEAP == TRUE */
+
+/***************************************************************************/
+
 __attribute__((used))
 int _fstat_r(struct _reent *r, int file, struct stat * st)
 {
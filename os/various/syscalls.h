@@ -0,0 +1,128 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    syscalls.h
+ * @brief   Newlib bindings settings and kernel hooks.
+ * @details This header can be included from @p chconf.h in order to give
+ *          each thread its own newlib reentrancy structure:
+ * @code
+ * #define SYSCALLS_USE_THREAD_REENT           TRUE
+ * #include "syscalls.h"
+ *
+ * #define CH_CFG_THREAD_EXTRA_FIELDS                                       \
+ *   SYSCALLS_THREAD_EXTRA_FIELDS
+ *
+ * #define CH_CFG_THREAD_INIT_HOOK(tp) {                                    \
+ *   SYSCALLS_THREAD_INIT_HOOK(tp);                                         \
+ * }
+ *
+ * #define CH_CFG_CONTEXT_SWITCH_HOOK(ntp, otp) {                           \
+ *   SYSCALLS_CONTEXT_SWITCH_HOOK(ntp, otp);                                \
+ * }
+ * @endcode
+ *
+ * @addtogroup syscalls
+ * @{
+ */
+
+#ifndef SYSCALLS_H
+#define SYSCALLS_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Routes the newlib allocator to the default heap.
+ * @details If enabled @p malloc(), @p free() and the related functions are
+ *          implemented using @p chHeapAlloc() and @p chHeapFree(), newlib
+ *          does not manage an arena of its own and its allocator lock is
+ *          no more involved. The heap backend selected in @p chconf.h is
+ *          used.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(SYSCALLS_USE_HEAP) || defined(__DOXYGEN__)
+#define SYSCALLS_USE_HEAP                   FALSE
+#endif
+
+/**
+ * @brief   Per-thread newlib reentrancy structures.
+ * @details If enabled the @p SYSCALLS_xxx_HOOK macros place a
+ *          <tt>struct _reent</tt> in each thread and switch
+ *          @p _impure_ptr on context switch.
+ * @note    The structure is part of @p thread_t so it is allocated in the
+ *          thread working area, its size is much smaller with newlib-nano.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(SYSCALLS_USE_THREAD_REENT) || defined(__DOXYGEN__)
+#define SYSCALLS_USE_THREAD_REENT           FALSE
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+#if (SYSCALLS_USE_THREAD_REENT == TRUE) || defined(__DOXYGEN__)
+#include <reent.h>
+
+/**
+ * @brief   Threads descriptor fields.
+ */
+#define SYSCALLS_THREAD_EXTRA_FIELDS                                        \
+  struct _reent         reent;
+
+/**
+ * @brief   Threads initialization hook.
+ * @note    The stdio buffers allocated by a thread are not released when it
+ *          terminates, invoke @p _reclaim_reent() on its @p reent field
+ *          from another thread before freeing the working area.
+ */
+#define SYSCALLS_THREAD_INIT_HOOK(tp)                                       \
+  _REENT_INIT_PTR(&(tp)->reent)
+
+/**
+ * @brief   Context switch hook.
+ */
+#define SYSCALLS_CONTEXT_SWITCH_HOOK(ntp, otp) {                            \
+  (void)(otp);                                                              \
+  _impure_ptr = &(ntp)->reent;                                              \
+}
+#endif /* SYSCALLS_USE_THREAD_REENT == TRUE */
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* SYSCALLS_H */
+
+/** @} */
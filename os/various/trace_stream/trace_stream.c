@@ -0,0 +1,357 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    trace_stream.c
+ * @brief   Trace records streaming code.
+ *
+ * @addtogroup trace_stream
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+#include "trace_stream.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum size of an unencoded frame.
+ */
+#define FRAME_MAX_SIZE              (2U + 5U + 5U + (2U * 10U))
+
+/**
+ * @brief   Maximum thread name length in name frames.
+ */
+#define NAME_MAX_SIZE               16U
+
+/**
+ * @brief   Buffer index mask.
+ */
+#define BUFFER_MASK                 ((size_t)TRACE_STREAM_BUFFER_SIZE - 1U)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/**
+ * @brief   Frame under construction.
+ */
+typedef struct {
+  size_t                n;
+  uint8_t               data[FRAME_MAX_SIZE + NAME_MAX_SIZE];
+} frame_t;
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Trace stream state.
+ */
+static struct {
+  const TraceStreamConfig   *config;
+  size_t                    wridx;
+  size_t                    rdidx;
+  uint32_t                  lost;
+  uint8_t                   seq;
+  uint32_t                  last_rtstamp;
+  systime_t                 last_time;
+  uint8_t                   buffer[TRACE_STREAM_BUFFER_SIZE];
+} trs;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static void put_byte(frame_t *fp, uint8_t b) {
+
+  fp->data[fp->n++] = b;
+}
+
+static void put_varint(frame_t *fp, uintptr_t v) {
+
+  while (v >= 0x80U) {
+    put_byte(fp, (uint8_t)(v | 0x80U));
+    v >>= 7;
+  }
+  put_byte(fp, (uint8_t)v);
+}
+
+/**
+ * @brief   Starts a frame.
+ * @note    The sequence number is increased also for frames that are
+ *          going to be dropped, the host detects losses from the gaps.
+ */
+static void frame_start(frame_t *fp, uint8_t type, uint8_t state) {
+
+  fp->n = 0U;
+  put_byte(fp, trs.seq++);
+  put_byte(fp, (uint8_t)((type & 7U) | (uint8_t)(state << 3)));
+}
+
+/**
+ * @brief   COBS-encodes a frame into the buffer.
+ * @note    Must be invoked with the kernel locked.
+ *
+ * @return              The operation status.
+ * @retval false        if the frame has been queued.
+ * @retval true         if the frame has been dropped for lack of space.
+ */
+static bool frame_commit(const frame_t *fp) {
+  size_t i, code_idx, wr;
+  uint8_t code;
+
+  /* Worst case COBS overhead is one byte every 254 plus the terminator.*/
+  if ((TRACE_STREAM_BUFFER_SIZE - (trs.wridx - trs.rdidx)) < (fp->n + 2U)) {
+    trs.lost++;
+    return true;
+  }
+
+  wr       = trs.wridx;
+  code_idx = wr++;
+  code     = 1U;
+  for (i = 0U; i < fp->n; i++) {
+    if (fp->data[i] == 0U) {
+      trs.buffer[code_idx & BUFFER_MASK] = code;
+      code_idx = wr++;
+      code     = 1U;
+    }
+    else {
+      trs.buffer[wr++ & BUFFER_MASK] = fp->data[i];
+      code++;
+    }
+  }
+  trs.buffer[code_idx & BUFFER_MASK] = code;
+  trs.buffer[wr++ & BUFFER_MASK] = 0U;
+  trs.wridx = wr;
+
+  return false;
+}
+
+#if CH_CFG_USE_REGISTRY == TRUE
+/**
+ * @brief   Sends the names of all the threads in the registry.
+ */
+static void send_names(void) {
+  thread_t *tp;
+
+  tp = chRegFirstThread();
+  do {
+    frame_t f;
+    const char *s = tp->name;
+    size_t n = 0U;
+
+    chSysLock();
+    frame_start(&f, CH_TRACE_TYPE_UNUSED, TRACE_STREAM_CTRL_NAME);
+    put_varint(&f, (uintptr_t)tp);
+    while ((s != NULL) && (*s != '\0') && (n < NAME_MAX_SIZE)) {
+      put_byte(&f, (uint8_t)*s++);
+      n++;
+    }
+    (void) frame_commit(&f);
+    chSysUnlock();
+    tp = chRegNextThread(tp);
+  } while (tp != NULL);
+}
+#endif
+
+/**
+ * @brief   Writes a chunk of encoded data to the sink.
+ */
+static void sink_write(const uint8_t *bp, size_t n) {
+
+  if (trs.config->tsc_channel != NULL) {
+    (void) streamWrite(trs.config->tsc_channel, bp, n);
+    return;
+  }
+
+#if TRACE_STREAM_USE_ITM == TRUE
+  /* Data is discarded if the ITM or the stimulus port are not enabled by
+     the debugger.*/
+  if (((ITM->TCR & ITM_TCR_ITMENA_Msk) != 0U) &&
+      ((ITM->TER & (1UL << TRACE_STREAM_ITM_PORT)) != 0U)) {
+    while (n > 0U) {
+      while (ITM->PORT[TRACE_STREAM_ITM_PORT].u32 == 0U) {
+      }
+      ITM->PORT[TRACE_STREAM_ITM_PORT].u8 = *bp++;
+      n--;
+    }
+  }
+#endif
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Trace stream initialization.
+ * @details A header frame carrying the format version and the time bases
+ *          is queued.
+ * @note    Must be invoked before @p chSysInit(), records are not
+ *          streamed until this function is invoked.
+ *
+ * @param[in] tscp      pointer to a @p TraceStreamConfig object
+ */
+void trsInit(const TraceStreamConfig *tscp) {
+  frame_t f;
+
+  osalDbgCheck(tscp != NULL);
+
+  trs.config       = tscp;
+  trs.wridx        = 0U;
+  trs.rdidx        = 0U;
+  trs.lost         = 0U;
+  trs.seq          = 0U;
+  trs.last_rtstamp = 0U;
+  trs.last_time    = (systime_t)0;
+
+  frame_start(&f, CH_TRACE_TYPE_UNUSED, TRACE_STREAM_CTRL_HEADER);
+  put_varint(&f, TRACE_STREAM_VERSION);
+  put_varint(&f, CH_CFG_ST_FREQUENCY);
+  put_varint(&f, tscp->tsc_rtfreq);
+  (void) frame_commit(&f);
+}
+
+/**
+ * @brief   Trace record hook.
+ * @details Encodes a trace record in a frame with time stamps relative to
+ *          the previous sent record, pointers are encoded as variable
+ *          length integers.
+ * @note    This function is meant to be invoked from @p CH_CFG_TRACE_HOOK,
+ *          the kernel is already locked.
+ *
+ * @param[in] tep       pointer to the trace record
+ *
+ * @notapi
+ */
+void trsRecordHook(const ch_trace_event_t *tep) {
+  frame_t f;
+  uint32_t rtstamp = (uint32_t)tep->rtstamp;
+
+  if (trs.config == NULL) {
+    return;
+  }
+
+  frame_start(&f, (uint8_t)tep->type, (uint8_t)tep->state);
+  put_varint(&f, (uintptr_t)((rtstamp - trs.last_rtstamp) & 0x00FFFFFFU));
+  put_varint(&f, (uintptr_t)(systime_t)(tep->time - trs.last_time));
+  switch (tep->type) {
+  case CH_TRACE_TYPE_SWITCH:
+    put_varint(&f, (uintptr_t)tep->u.sw.ntp);
+    put_varint(&f, (uintptr_t)tep->u.sw.wtobjp);
+    break;
+  case CH_TRACE_TYPE_ISR_ENTER:
+  case CH_TRACE_TYPE_ISR_LEAVE:
+    put_varint(&f, (uintptr_t)tep->u.isr.name);
+    break;
+  case CH_TRACE_TYPE_HALT:
+    put_varint(&f, (uintptr_t)tep->u.halt.reason);
+    break;
+  case CH_TRACE_TYPE_USER:
+    put_varint(&f, (uintptr_t)tep->u.user.up1);
+    put_varint(&f, (uintptr_t)tep->u.user.up2);
+    break;
+  default:
+    break;
+  }
+
+  /* Time stamps are relative to the last frame actually queued.*/
+  if (!frame_commit(&f)) {
+    trs.last_rtstamp = rtstamp;
+    trs.last_time    = tep->time;
+  }
+}
+
+/**
+ * @brief   Moves a chunk of encoded data from the buffer to the sink.
+ *
+ * @return              The number of bytes written to the sink.
+ *
+ * @api
+ */
+size_t trsDrain(void) {
+  uint8_t chunk[TRACE_STREAM_CHUNK_SIZE];
+  size_t n;
+
+  chSysLock();
+  n = 0U;
+  while ((trs.rdidx != trs.wridx) && (n < sizeof chunk)) {
+    chunk[n++] = trs.buffer[trs.rdidx++ & BUFFER_MASK];
+  }
+  chSysUnlock();
+
+  if (n > 0U) {
+    sink_write(chunk, n);
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Returns the number of frames dropped because the buffer was full.
+ *
+ * @return              The number of dropped frames.
+ *
+ * @xclass
+ */
+uint32_t trsGetLostX(void) {
+
+  return trs.lost;
+}
+
+/**
+ * @brief   Trace stream drain thread.
+ * @details The thread continuously moves the encoded data to the sink,
+ *          the threads names are sent periodically.
+ * @note    The activity of this thread is part of the trace, it should
+ *          run at low priority.
+ *
+ * @param[in] p         unused
+ */
+THD_FUNCTION(trsThread, p) {
+#if CH_CFG_USE_REGISTRY == TRUE
+  systime_t last = chVTGetSystemTimeX();
+#endif
+
+  (void)p;
+
+  chRegSetThreadName("trace");
+
+#if CH_CFG_USE_REGISTRY == TRUE
+  send_names();
+#endif
+  while (true) {
+    if (trsDrain() == 0U) {
+      chThdSleep(TRACE_STREAM_POLL_INTERVAL);
+    }
+#if CH_CFG_USE_REGISTRY == TRUE
+    if (chVTTimeElapsedSinceX(last) >= TRACE_STREAM_NAMES_INTERVAL) {
+      last = chVTGetSystemTimeX();
+      send_names();
+    }
+#endif
+  }
+}
+
+/** @} */
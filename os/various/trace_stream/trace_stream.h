@@ -0,0 +1,164 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    trace_stream.h
+ * @brief   Trace records streaming macros and structures.
+ *
+ * @addtogroup trace_stream
+ * @{
+ */
+
+#ifndef TRACE_STREAM_H
+#define TRACE_STREAM_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Stream format version, sent in the header frame.
+ */
+#define TRACE_STREAM_VERSION        1U
+
+/**
+ * @name    Control frame sub-types
+ * @note    Control frames use the @p CH_TRACE_TYPE_UNUSED record type, the
+ *          sub-type is sent in place of the thread state.
+ * @{
+ */
+#define TRACE_STREAM_CTRL_HEADER    0U
+#define TRACE_STREAM_CTRL_NAME      1U
+/** @} */
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of the encoded frames buffer.
+ * @note    Must be a power of two.
+ */
+#if !defined(TRACE_STREAM_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define TRACE_STREAM_BUFFER_SIZE    1024
+#endif
+
+/**
+ * @brief   Maximum number of bytes written to the sink in a single burst.
+ */
+#if !defined(TRACE_STREAM_CHUNK_SIZE) || defined(__DOXYGEN__)
+#define TRACE_STREAM_CHUNK_SIZE     64
+#endif
+
+/**
+ * @brief   Drain thread polling interval when the buffer is empty.
+ */
+#if !defined(TRACE_STREAM_POLL_INTERVAL) || defined(__DOXYGEN__)
+#define TRACE_STREAM_POLL_INTERVAL  TIME_MS2I(2)
+#endif
+
+/**
+ * @brief   Interval between threads names dumps.
+ * @note    Names are only sent if @p CH_CFG_USE_REGISTRY is enabled.
+ */
+#if !defined(TRACE_STREAM_NAMES_INTERVAL) || defined(__DOXYGEN__)
+#define TRACE_STREAM_NAMES_INTERVAL TIME_MS2I(1000)
+#endif
+
+/**
+ * @brief   Enables the ITM/SWO sink.
+ * @note    Requires a Cortex-M core with ITM and the CMSIS headers.
+ */
+#if !defined(TRACE_STREAM_USE_ITM) || defined(__DOXYGEN__)
+#define TRACE_STREAM_USE_ITM        FALSE
+#endif
+
+/**
+ * @brief   ITM stimulus port used by the ITM sink.
+ */
+#if !defined(TRACE_STREAM_ITM_PORT) || defined(__DOXYGEN__)
+#define TRACE_STREAM_ITM_PORT       1
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CH_DBG_TRACE_MASK == CH_DBG_TRACE_MASK_DISABLED
+#error "trace streaming requires CH_DBG_TRACE_MASK"
+#endif
+
+#if (TRACE_STREAM_BUFFER_SIZE & (TRACE_STREAM_BUFFER_SIZE - 1)) != 0
+#error "TRACE_STREAM_BUFFER_SIZE is not a power of two"
+#endif
+
+#if TRACE_STREAM_BUFFER_SIZE < 64
+#error "TRACE_STREAM_BUFFER_SIZE too small"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Trace stream configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Sink stream, @p NULL selects the ITM sink.
+   * @note    Any @p BaseSequentialStream is allowed, a DMA-driven UART can
+   *          be used through a serial or UART based stream.
+   */
+  BaseSequentialStream  *tsc_channel;
+  /**
+   * @brief   Realtime counter frequency, zero if unknown.
+   * @note    The host decoder uses the system time when not specified.
+   */
+  uint32_t              tsc_rtfreq;
+} TraceStreamConfig;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Hook to be used as @p CH_CFG_TRACE_HOOK in chconf.h.
+ */
+#define TRACE_STREAM_HOOK(tep)      trsRecordHook(tep)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void trsInit(const TraceStreamConfig *tscp);
+  void trsRecordHook(const ch_trace_event_t *tep);
+  size_t trsDrain(void);
+  uint32_t trsGetLostX(void);
+  THD_FUNCTION(trsThread, p);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* TRACE_STREAM_H */
+
+/** @} */
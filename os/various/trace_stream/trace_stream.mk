@@ -0,0 +1,8 @@
+# Trace stream files.
+TRACESTREAMSRC = $(CHIBIOS)/os/various/trace_stream/trace_stream.c
+
+TRACESTREAMINC = $(CHIBIOS)/os/various/trace_stream
+
+# Shared variables
+ALLCSRC += $(TRACESTREAMSRC)
+ALLINC  += $(TRACESTREAMINC)
@@ -41,6 +41,7 @@
 #include "wolfssl_chibios.h"
 #include "user_settings.h"
 
+#ifndef WOLFSSL_CHIBIOS_HALCRYPTO
 unsigned int chibios_rand_generate(void)
 {
   static unsigned int last_value=0;
@@ -77,4 +78,5 @@ int custom_rand_generate_block(unsigned char* output, unsigned int sz)
     }
     return 0;
 }
+#endif
 
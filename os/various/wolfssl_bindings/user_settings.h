@@ -41,6 +41,19 @@
 #define HAVE_ONE_TIME_AUTH
 #define WOLFSSL_DH_CONST
 		
+/* HAL crypto driver offload (AES-CBC/HMAC-SHA256 records, TRNG) */
+//#define WOLFSSL_CHIBIOS_HALCRYPTO
+
+/* Client sessions kept for resumption, see sslconn_connect() */
+#define WOLFSSL_CHIBIOS_SESSION_CACHE_SIZE 4
+
+#ifdef WOLFSSL_CHIBIOS_HALCRYPTO
+#define ATOMIC_USER
+
+int halcry_rand_block(unsigned char *output, unsigned int sz);
+
+#define CUSTOM_RAND_GENERATE_BLOCK halcry_rand_block
+#else
 /* HW RNG support */
 
 unsigned int chibios_rand_generate(void);
@@ -48,6 +61,7 @@ int custom_rand_generate_block(unsigned char* output, unsigned int sz);
 
 #define CUSTOM_RAND_GENERATE chibios_rand_generate
 #define CUSTOM_RAND_TYPE uint32_t
+#endif
 
 #define HAVE_ED25519
 #define HAVE_POLY1305
@@ -3,7 +3,8 @@ WOLFSSL = 	$(CHIBIOS)/ext/wolfssl
 
 WOLFBINDSRC = \
         $(CHIBIOS)/os/various/wolfssl_bindings/wolfssl_chibios.c \
-        $(CHIBIOS)/os/various/wolfssl_bindings/hwrng.c
+        $(CHIBIOS)/os/various/wolfssl_bindings/hwrng.c \
+        $(CHIBIOS)/os/various/wolfssl_bindings/wolfssl_halcrypto.c
 
 WOLFCRYPTSRC = \
 	$(WOLFSSL)/wolfcrypt/src/sha.c \
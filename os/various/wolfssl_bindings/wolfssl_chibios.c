@@ -46,8 +46,86 @@
 #include "lwip/sockets.h"
 #include "lwip/tcp.h"
 #include <string.h>
+#if WOLFSSL_CHIBIOS_SESSION_CACHE_SIZE > 0
+#include "wolfssl/internal.h"
+#endif
 static int wolfssl_is_initialized = 0;
 
+#if WOLFSSL_CHIBIOS_SESSION_CACHE_SIZE > 0
+/* Client session cache, a zero stamp marks a free entry.*/
+struct sslsession {
+    ip_addr_t addr;
+    u16_t port;
+    uint32_t stamp;
+    WOLFSSL_SESSION session;
+};
+
+static struct sslsession ssl_session_cache[WOLFSSL_CHIBIOS_SESSION_CACHE_SIZE];
+static uint32_t ssl_session_stamp = 0;
+static MUTEX_DECL(ssl_session_mtx);
+
+static struct sslsession *session_find(const ip_addr_t *addr, u16_t port)
+{
+    int i;
+
+    for (i = 0; i < WOLFSSL_CHIBIOS_SESSION_CACHE_SIZE; i++) {
+        struct sslsession *s = &ssl_session_cache[i];
+        if ((s->stamp != 0) && (s->port == port) &&
+            ip_addr_cmp(&s->addr, addr))
+            return s;
+    }
+    return NULL;
+}
+
+static void session_restore(WOLFSSL *ssl, const ip_addr_t *addr, u16_t port)
+{
+    struct sslsession *s;
+
+    chMtxLock(&ssl_session_mtx);
+    s = session_find(addr, port);
+    if (s) {
+        s->stamp = ++ssl_session_stamp;
+        wolfSSL_set_session(ssl, &s->session);
+    }
+    chMtxUnlock(&ssl_session_mtx);
+}
+
+static void session_save(WOLFSSL *ssl, const ip_addr_t *addr, u16_t port)
+{
+    WOLFSSL_SESSION *sess = wolfSSL_get_session(ssl);
+    struct sslsession *s;
+    int i;
+
+    if (!sess)
+        return;
+
+    chMtxLock(&ssl_session_mtx);
+    s = session_find(addr, port);
+    if (!s) {
+        /* Free or least recently used entry.*/
+        s = &ssl_session_cache[0];
+        for (i = 1; i < WOLFSSL_CHIBIOS_SESSION_CACHE_SIZE; i++) {
+            if (ssl_session_cache[i].stamp < s->stamp)
+                s = &ssl_session_cache[i];
+        }
+    }
+    memcpy(&s->session, sess, sizeof(WOLFSSL_SESSION));
+    ip_addr_copy(s->addr, *addr);
+    s->port = port;
+    s->stamp = ++ssl_session_stamp;
+    chMtxUnlock(&ssl_session_mtx);
+}
+#endif
+
+void sslconn_session_flush(void)
+{
+#if WOLFSSL_CHIBIOS_SESSION_CACHE_SIZE > 0
+    chMtxLock(&ssl_session_mtx);
+    memset(ssl_session_cache, 0, sizeof(ssl_session_cache));
+    chMtxUnlock(&ssl_session_mtx);
+#endif
+}
+
 sslconn *sslconn_accept(sslconn *sk)
 {
   sslconn *new;
@@ -65,6 +143,9 @@ sslconn *sslconn_accept(sslconn *sk)
   new->ssl = wolfSSL_new(new->ctx);
   wolfSSL_SetIOReadCtx(new->ssl, new);
   wolfSSL_SetIOWriteCtx(new->ssl, new);
+#ifdef WOLFSSL_CHIBIOS_HALCRYPTO
+  halcry_bind_ssl(new->ssl, &new->cry);
+#endif
 
   if (wolfSSL_accept(new->ssl) == SSL_SUCCESS) {
     wolfSSL_set_using_nonblock(new->ssl, 1);
@@ -92,6 +173,10 @@ sslconn *sslconn_new(enum netconn_type t, WOLFSSL_METHOD* method)
     sk->ctx = wolfSSL_CTX_new(method);
     if (!sk->ctx)
         goto error;
+#ifdef WOLFSSL_CHIBIOS_HALCRYPTO
+    if (halcry_bind_ctx(sk->ctx) != 0)
+        goto error;
+#endif
     sk->conn = netconn_new(t);
     if (!sk->conn)
         goto error;
@@ -106,6 +191,33 @@ error:
     return NULL;
 }
 
+int sslconn_connect(sslconn *sk, const ip_addr_t *addr, u16_t port)
+{
+    if (netconn_connect(sk->conn, addr, port) != ERR_OK)
+        return -1;
+    sk->ssl = wolfSSL_new(sk->ctx);
+    if (!sk->ssl)
+        return -1;
+    wolfSSL_SetIOReadCtx(sk->ssl, sk);
+    wolfSSL_SetIOWriteCtx(sk->ssl, sk);
+#ifdef WOLFSSL_CHIBIOS_HALCRYPTO
+    halcry_bind_ssl(sk->ssl, &sk->cry);
+#endif
+#if WOLFSSL_CHIBIOS_SESSION_CACHE_SIZE > 0
+    session_restore(sk->ssl, addr, port);
+#endif
+
+    if (wolfSSL_connect(sk->ssl) != SSL_SUCCESS) {
+        wolfSSL_free(sk->ssl);
+        sk->ssl = NULL;
+        return -1;
+    }
+#if WOLFSSL_CHIBIOS_SESSION_CACHE_SIZE > 0
+    session_save(sk->ssl, addr, port);
+#endif
+    return 0;
+}
+
 void sslconn_close(sslconn *sk)
 {
     netconn_delete(sk->conn);
@@ -202,7 +314,6 @@ uint32_t TimeNowInMilliseconds(void)
 
 void *chHeapRealloc (void *addr, uint32_t size)
 {
-    union heap_header *hp;
     uint32_t prev_size, new_size;
 
     void *ptr;
@@ -211,9 +322,7 @@ void *chHeapRealloc (void *addr, uint32_t size)
         return chHeapAlloc(NULL, size);
     }
 
-    /* previous allocated segment is preceded by an heap_header */
-    hp = addr - sizeof(union heap_header);
-    prev_size = hp->used.size; /* size is always multiple of 8 */
+    prev_size = chHeapGetSize(addr);
 
     /* check new size memory alignment */
     if(size % 8 == 0) {
@@ -44,20 +44,34 @@
 #include "lwip/arch.h"
 #include "lwip/api.h"
 #include "user_settings.h"
+#ifdef WOLFSSL_CHIBIOS_HALCRYPTO
+#include "wolfssl_halcrypto.h"
+#endif
 #define XMALLOC(s,h,t) chibios_alloc(h,s)
 #define XFREE(p,h,t)   chibios_free(p)
 
+/* Number of client sessions kept for resumption, zero disables the cache.
+   The cache is statically allocated, one entry for each server address.*/
+#ifndef WOLFSSL_CHIBIOS_SESSION_CACHE_SIZE
+#define WOLFSSL_CHIBIOS_SESSION_CACHE_SIZE 4
+#endif
+
 struct sslconn {
     WOLFSSL_CTX *ctx;
     WOLFSSL *ssl;
     struct netconn *conn;
+#ifdef WOLFSSL_CHIBIOS_HALCRYPTO
+    halcry_state cry;
+#endif
 };
 
 typedef struct sslconn sslconn;
 
 sslconn *sslconn_accept(struct sslconn *sk);
 sslconn *sslconn_new(enum netconn_type t, WOLFSSL_METHOD *method);
+int sslconn_connect(sslconn *sk, const ip_addr_t *addr, u16_t port);
 void sslconn_close(sslconn *sk);
+void sslconn_session_flush(void);
 
 int wolfssl_send_cb(WOLFSSL* ssl, char *buf, int sz, void *ctx);
 int wolfssl_recv_cb(WOLFSSL *ssl, char *buf, int sz, void *ctx);
@@ -0,0 +1,241 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+/*
+ * **** This file incorporates work covered by the following copyright and ****
+ * **** permission notice:                                                 ****
+ *
+ * Copyright (C) 2006-2017 wolfSSL Inc.
+ *
+ * This file is part of wolfSSL.
+ *
+ * wolfSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335, USA
+ *
+ */
+
+#include "hal.h"
+#include "wolfssl_halcrypto.h"
+#include "wolfssl/wolfcrypt/hmac.h"
+#include <string.h>
+
+#ifdef WOLFSSL_CHIBIOS_HALCRYPTO
+
+#define HALCRY_AES_BLOCK 16
+
+/* Some LLDs hash through a buffer provided by the caller in the SHA
+   context, HAL_CRY_WOLF_SHABUFF_SIZE enables its setup.*/
+#ifdef HAL_CRY_WOLF_SHABUFF_SIZE
+static uint8_t halcry_shabuffer[HAL_CRY_WOLF_SHABUFF_SIZE];
+#define HALCRY_HMAC_SETUP(hp) {                                             \
+    (hp)->shacontext.sha.sha_buffer = halcry_shabuffer;                     \
+    (hp)->shacontext.sha.sha_buffer_size = HAL_CRY_WOLF_SHABUFF_SIZE;       \
+}
+#else
+#define HALCRY_HMAC_SETUP(hp)
+#endif
+
+static int halcry_hmac(WOLFSSL *ssl, int verify, const byte *inner,
+                       const byte *in, word32 sz, byte *out)
+{
+    HMACSHA256Context hmac;
+    cryerror_t err;
+
+    err = cryLoadTransientKey(&CRY_DRV, cry_algo_hmac,
+                              (size_t)wolfSSL_GetHmacSize(ssl),
+                              wolfSSL_GetMacSecret(ssl, verify));
+    if (err != CRY_NOERROR)
+        return -1;
+
+    HALCRY_HMAC_SETUP(&hmac);
+    err = cryHMACSHA256Init(&CRY_DRV, &hmac);
+    if (err == CRY_NOERROR)
+        err = cryHMACSHA256Update(&CRY_DRV, &hmac,
+                                  WOLFSSL_TLS_HMAC_INNER_SZ, inner);
+    if (err == CRY_NOERROR)
+        err = cryHMACSHA256Update(&CRY_DRV, &hmac, sz, in);
+    if (err == CRY_NOERROR)
+        err = cryHMACSHA256Final(&CRY_DRV, &hmac, out);
+
+    return err == CRY_NOERROR ? 0 : -1;
+}
+
+/* Loads the write key of a side and, the first time, the initial IV.*/
+static int halcry_load(WOLFSSL *ssl, int client, struct halcry_cbc *cbc)
+{
+    const byte *key;
+    const byte *iv;
+
+    if (client) {
+        key = wolfSSL_GetClientWriteKey(ssl);
+        iv  = wolfSSL_GetClientWriteIV(ssl);
+    }
+    else {
+        key = wolfSSL_GetServerWriteKey(ssl);
+        iv  = wolfSSL_GetServerWriteIV(ssl);
+    }
+
+    if (!cbc->ready) {
+        memcpy(cbc->iv, iv, HALCRY_AES_BLOCK);
+        cbc->ready = 1;
+    }
+
+    if (cryLoadTransientKey(&CRY_DRV, cry_algo_aes,
+                            (size_t)wolfSSL_GetKeySize(ssl),
+                            key) != CRY_NOERROR)
+        return -1;
+    return 0;
+}
+
+static int halcry_supported(WOLFSSL *ssl)
+{
+    return (wolfSSL_GetBulkCipher(ssl) == wolfssl_aes) &&
+           (wolfSSL_GetCipherType(ssl) == WOLFSSL_BLOCK_TYPE) &&
+           (wolfSSL_GetHmacType(ssl) == WC_SHA256);
+}
+
+/* Record layer callbacks */
+static int halcry_mac_encrypt_cb(WOLFSSL *ssl, unsigned char *macOut,
+                                 const unsigned char *macIn,
+                                 unsigned int macInSz, int macContent,
+                                 int macVerify, unsigned char *encOut,
+                                 const unsigned char *encIn,
+                                 unsigned int encSz, void *ctx)
+{
+    halcry_state *st = (halcry_state *)ctx;
+    byte inner[WOLFSSL_TLS_HMAC_INNER_SZ];
+
+    if ((st == NULL) || !halcry_supported(ssl))
+        return -1;
+
+    wolfSSL_SetTlsHmacInner(ssl, inner, macInSz, macContent, macVerify);
+    if (halcry_hmac(ssl, macVerify, inner, macIn, macInSz, macOut) != 0)
+        return -1;
+
+    if (halcry_load(ssl, wolfSSL_GetSide(ssl) == WOLFSSL_CLIENT_END,
+                    &st->enc) != 0)
+        return -1;
+    if (cryEncryptAES_CBC(&CRY_DRV, CRYD_KEY, encSz, encIn, encOut,
+                          st->enc.iv) != CRY_NOERROR)
+        return -1;
+
+    /* Chaining, the next record starts from the last cyphertext block.*/
+    memcpy(st->enc.iv, encOut + encSz - HALCRY_AES_BLOCK, HALCRY_AES_BLOCK);
+    return 0;
+}
+
+static int halcry_decrypt_verify_cb(WOLFSSL *ssl, unsigned char *decOut,
+                                    const unsigned char *decIn,
+                                    unsigned int decSz, int macContent,
+                                    int macVerify, unsigned int *padSz,
+                                    void *ctx)
+{
+    halcry_state *st = (halcry_state *)ctx;
+    byte inner[WOLFSSL_TLS_HMAC_INNER_SZ];
+    byte verify[WC_SHA256_DIGEST_SIZE];
+    byte next_iv[HALCRY_AES_BLOCK];
+    unsigned int digestSz, pad, ivExtra = 0, i;
+    int macInSz;
+    byte diff;
+
+    if ((st == NULL) || !halcry_supported(ssl) ||
+        (decSz < HALCRY_AES_BLOCK))
+        return -1;
+
+    /* The input can be overwritten by an in place decryption.*/
+    memcpy(next_iv, decIn + decSz - HALCRY_AES_BLOCK, HALCRY_AES_BLOCK);
+
+    if (halcry_load(ssl, wolfSSL_GetSide(ssl) != WOLFSSL_CLIENT_END,
+                    &st->dec) != 0)
+        return -1;
+    if (cryDecryptAES_CBC(&CRY_DRV, CRYD_KEY, decSz, decIn, decOut,
+                          st->dec.iv) != CRY_NOERROR)
+        return -1;
+    memcpy(st->dec.iv, next_iv, HALCRY_AES_BLOCK);
+
+    digestSz = (unsigned int)wolfSSL_GetHmacSize(ssl);
+    pad = decOut[decSz - 1];
+    if (wolfSSL_IsTLSv1_1(ssl))
+        ivExtra = (unsigned int)wolfSSL_GetCipherBlockSize(ssl);
+
+    macInSz = (int)decSz - (int)(ivExtra + digestSz + pad + 1);
+    if (macInSz < 0)
+        return -1;
+    *padSz = digestSz + pad + 1;
+
+    wolfSSL_SetTlsHmacInner(ssl, inner, (word32)macInSz, macContent,
+                            macVerify);
+    if (halcry_hmac(ssl, macVerify, inner, decOut + ivExtra,
+                    (word32)macInSz, verify) != 0)
+        return -1;
+
+    /* Constant time comparison of the MAC.*/
+    diff = 0;
+    for (i = 0; i < digestSz; i++)
+        diff |= verify[i] ^ decOut[ivExtra + macInSz + i];
+    return diff == 0 ? 0 : -1;
+}
+
+/* Restricts the context to the offloaded suites and installs the record
+   layer callbacks, halcry_bind_ssl() must be called on each session.*/
+int halcry_bind_ctx(WOLFSSL_CTX *ctx)
+{
+    if (wolfSSL_CTX_set_cipher_list(ctx, WOLFSSL_HALCRYPTO_CIPHER_LIST) !=
+        SSL_SUCCESS)
+        return -1;
+
+    wolfSSL_CTX_SetMacEncryptCb(ctx, halcry_mac_encrypt_cb);
+    wolfSSL_CTX_SetDecryptVerifyCb(ctx, halcry_decrypt_verify_cb);
+    return 0;
+}
+
+void halcry_bind_ssl(WOLFSSL *ssl, halcry_state *st)
+{
+    memset(st, 0, sizeof(halcry_state));
+    wolfSSL_SetMacEncryptCtx(ssl, st);
+    wolfSSL_SetDecryptVerifyCtx(ssl, st);
+}
+
+/* RNG, used as CUSTOM_RAND_GENERATE_BLOCK. The TRNG is read in 16 bytes
+   units, the minimum granularity of the supported devices.*/
+int halcry_rand_block(unsigned char *output, unsigned int sz)
+{
+    uint32_t buf[4];
+    unsigned int n;
+
+    while (sz > 0) {
+        if (cryTRNG(&CRY_DRV, sizeof(buf), (uint8_t *)buf) != CRY_NOERROR)
+            return -1;
+        n = sz < sizeof(buf) ? sz : sizeof(buf);
+        memcpy(output, buf, n);
+        output += n;
+        sz -= n;
+    }
+    memset(buf, 0, sizeof(buf));
+    return 0;
+}
+
+#endif /* WOLFSSL_CHIBIOS_HALCRYPTO */
@@ -0,0 +1,83 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+/*
+ * **** This file incorporates work covered by the following copyright and ****
+ * **** permission notice:                                                 ****
+ *
+ * Copyright (C) 2006-2017 wolfSSL Inc.
+ *
+ * This file is part of wolfSSL.
+ *
+ * wolfSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335, USA
+ *
+ */
+#ifndef WOLFSSL_HALCRYPTO_H
+#define WOLFSSL_HALCRYPTO_H
+#include "hal.h"
+#include "wolfssl/ssl.h"
+#include "wolfssl/wolfcrypt/types.h"
+#include "user_settings.h"
+
+/* Crypto driver used by the bindings, CRYD_KEY is the key slot reserved
+   for the record layer keys.*/
+#ifndef CRY_DRV
+#define CRY_DRV         CRYD1
+#endif
+
+#ifndef CRYD_KEY
+#define CRYD_KEY        0
+#endif
+
+/* Cipher suites that can be fully processed by the HAL crypto driver, the
+   record layer is offloaded only for AES-CBC with HMAC-SHA256.*/
+#ifndef WOLFSSL_HALCRYPTO_CIPHER_LIST
+#define WOLFSSL_HALCRYPTO_CIPHER_LIST                                       \
+    "ECDHE-RSA-AES128-SHA256:ECDHE-ECDSA-AES128-SHA256:"                    \
+    "AES128-SHA256:AES256-SHA256"
+#endif
+
+/* CBC chaining state of one direction of a connection.*/
+struct halcry_cbc {
+    uint8_t iv[16];
+    int ready;
+};
+
+/* Record layer state of a connection.*/
+struct halcry_state {
+    struct halcry_cbc enc;
+    struct halcry_cbc dec;
+};
+
+typedef struct halcry_state halcry_state;
+
+int halcry_bind_ctx(WOLFSSL_CTX *ctx);
+void halcry_bind_ssl(WOLFSSL *ssl, halcry_state *st);
+
+int halcry_rand_block(unsigned char *output, unsigned int sz);
+
+#endif
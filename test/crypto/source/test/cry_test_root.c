@@ -30,6 +30,8 @@
  * - @subpage cry_test_sequence_007
  * - @subpage cry_test_sequence_008
  * - @subpage cry_test_sequence_009
+ * - @subpage cry_test_sequence_010
+ * - @subpage cry_test_sequence_011
  * .
  */
 
@@ -60,6 +62,8 @@ const testsequence_t * const cry_test_suite_array[] = {
   &cry_test_sequence_007,
   &cry_test_sequence_008,
   &cry_test_sequence_009,
+  &cry_test_sequence_010,
+  &cry_test_sequence_011,
   NULL
 };
 
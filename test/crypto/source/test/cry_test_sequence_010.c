@@ -0,0 +1,331 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "cry_test_root.h"
+
+/**
+ * @file    cry_test_sequence_010.c
+ * @brief   Test Sequence 010 code.
+ *
+ * @page cry_test_sequence_010 [10] AES CTR streaming
+ *
+ * File: @ref cry_test_sequence_010.c
+ *
+ * <h2>Description</h2>
+ * AES CTR streaming.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage cry_test_010_001
+ * - @subpage cry_test_010_002
+ * .
+ */
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+/* Buffer size for each SHA transfer.*/
+#define MAX_SHA_BLOCK_SIZE          TEST_MSG_DATA_BYTE_LEN
+
+static uint32_t shabuffer[MAX_SHA_BLOCK_SIZE / 4];
+
+static const CRYConfig config_Polling = {
+    TRANSFER_POLLING,
+    AES_CFBS_128       //cfbs
+};
+
+static const CRYConfig config_DMA = {
+    TRANSFER_DMA,
+    AES_CFBS_128       //cfbs
+};
+
+static cryerror_t crySHA256(CRYDriver *cryp, size_t size,const uint8_t *in, uint8_t *out) {
+
+	cryerror_t ret;
+	SHA256Context shactxp;
+
+    shactxp.sha.sha_buffer = (uint8_t*)&shabuffer[0];
+	shactxp.sha.sha_buffer_size = MAX_SHA_BLOCK_SIZE;
+
+	ret = crySHA256Init(cryp,&shactxp);
+
+	ret = crySHA256Update(cryp,&shactxp,size,in);
+
+	ret = crySHA256Final(cryp,&shactxp,out);
+
+
+	return ret;
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page cry_test_010_001 [10.1] AES CTR Streaming Polling
+ *
+ * <h2>Description</h2>
+ * testing AES CTR streaming against the single operation.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.1.1] loading the key with 16 byte size.
+ * - [10.1.2] Encrypt in a single operation.
+ * - [10.1.3] Encrypt using a stream in chunks of different sizes.
+ * - [10.1.4] Decrypt and hash using a stream.
+ * .
+ */
+
+static void cry_test_010_001_setup(void) {
+  memcpy((char*) msg_clear, test_plain_data, TEST_DATA_BYTE_LEN);
+  memset(msg_encrypted, 0xff, TEST_MSG_DATA_BYTE_LEN);
+  memset(msg_decrypted, 0xff, TEST_MSG_DATA_BYTE_LEN);
+  cryStart(&CRYD1, &config_Polling);
+}
+
+static void cry_test_010_001_teardown(void) {
+  cryStop(&CRYD1);
+}
+
+static void cry_test_010_001_execute(void) {
+  cryerror_t ret;
+  AESCTRContext ctrctx;
+  SHA256Context shactx;
+  uint32_t ref_digest[8];
+  uint32_t digest[8];
+  size_t n, pos;
+
+  /* [10.1.1] loading the key with 16 byte size.*/
+  test_set_step(1);
+  {
+    ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_aes,16, (uint8_t *) test_keys);
+
+    test_assert(ret == CRY_NOERROR, "failed load transient key");
+  }
+
+  /* [10.1.2] Encrypt in a single operation.*/
+  test_set_step(2);
+  {
+    ret = cryEncryptAES_CTR(&CRYD1, 0,TEST_DATA_BYTE_LEN, (uint8_t*) msg_clear, (uint8_t*) msg_encrypted, (uint8_t*) test_vectors);
+
+    test_assert(ret == CRY_NOERROR, "encrypt failed");
+
+    SHOW_ENCRYPDATA(TEST_DATA_WORD_LEN);
+  }
+
+  /* [10.1.3] Encrypt using a stream in chunks of different sizes.*/
+  test_set_step(3);
+  {
+    ret = cryAESCTRInit(&CRYD1, &ctrctx, 0, (uint8_t*) test_vectors);
+
+    test_assert(ret == CRY_NOERROR, "stream init failed");
+
+    for (pos = 0, n = 1; pos < TEST_DATA_BYTE_LEN; pos += n, n = n * 3 + 1) {
+      if (n > TEST_DATA_BYTE_LEN - pos) {
+        n = TEST_DATA_BYTE_LEN - pos;
+      }
+      ret = cryAESCTRUpdate(&CRYD1, &ctrctx, n, (uint8_t*) msg_clear + pos, (uint8_t*) msg_decrypted + pos);
+
+      test_assert(ret == CRY_NOERROR, "stream encrypt failed");
+    }
+
+    cryAESCTRFinal(&CRYD1, &ctrctx);
+
+    for (int i = 0; i < TEST_DATA_WORD_LEN; i++) {
+      test_assert(msg_decrypted[i] == msg_encrypted[i], "encrypt mismatch");
+    }
+  }
+
+  /* [10.1.4] Decrypt and hash using a stream.*/
+  test_set_step(4);
+  {
+    ret = crySHA256(&CRYD1, TEST_DATA_BYTE_LEN, (uint8_t*) msg_encrypted, (uint8_t*) ref_digest);
+
+    test_assert(ret == CRY_NOERROR, "sha256 failed");
+
+    memset(msg_decrypted, 0xff, TEST_MSG_DATA_BYTE_LEN);
+    shactx.sha.sha_buffer = (uint8_t*)&shabuffer[0];
+    shactx.sha.sha_buffer_size = MAX_SHA_BLOCK_SIZE;
+    ret = crySHA256Init(&CRYD1, &shactx);
+
+    test_assert(ret == CRY_NOERROR, "sha256 init failed");
+
+    cryAESCTRInit(&CRYD1, &ctrctx, 0, (uint8_t*) test_vectors);
+    ret = cryAESCTRSHA256Update(&CRYD1, &ctrctx, &shactx, false, TEST_DATA_BYTE_LEN, (uint8_t*) msg_encrypted, (uint8_t*) msg_decrypted);
+
+    test_assert(ret == CRY_NOERROR, "stream decrypt failed");
+
+    ret = crySHA256Final(&CRYD1, &shactx, (uint8_t*) digest);
+
+    test_assert(ret == CRY_NOERROR, "sha256 final failed");
+
+    SHOW_DECRYPDATA(TEST_DATA_WORD_LEN);
+
+    for (int i = 0; i < TEST_DATA_WORD_LEN; i++) {
+      test_assert(msg_decrypted[i] == msg_clear[i], "decrypt mismatch");
+    }
+
+    for (int i = 0; i < 8; i++) {
+      test_assert(digest[i] == ref_digest[i], "sha256 mismatch");
+    }
+  }
+}
+
+static const testcase_t cry_test_010_001 = {
+  "AES CTR Streaming Polling",
+  cry_test_010_001_setup,
+  cry_test_010_001_teardown,
+  cry_test_010_001_execute
+};
+
+/**
+ * @page cry_test_010_002 [10.2] AES CTR Streaming DMA
+ *
+ * <h2>Description</h2>
+ * testing AES CTR streaming against the single operation.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.2.1] loading the key with 16 byte size.
+ * - [10.2.2] Encrypt in a single operation.
+ * - [10.2.3] Encrypt using a stream in chunks of different sizes.
+ * - [10.2.4] Decrypt and hash using a stream.
+ * .
+ */
+
+static void cry_test_010_002_setup(void) {
+  memcpy((char*) msg_clear, test_plain_data, TEST_DATA_BYTE_LEN);
+  memset(msg_encrypted, 0xff, TEST_MSG_DATA_BYTE_LEN);
+  memset(msg_decrypted, 0xff, TEST_MSG_DATA_BYTE_LEN);
+  cryStart(&CRYD1, &config_DMA);
+}
+
+static void cry_test_010_002_teardown(void) {
+  cryStop(&CRYD1);
+}
+
+static void cry_test_010_002_execute(void) {
+  cryerror_t ret;
+  AESCTRContext ctrctx;
+  SHA256Context shactx;
+  uint32_t ref_digest[8];
+  uint32_t digest[8];
+  size_t n, pos;
+
+  /* [10.2.1] loading the key with 16 byte size.*/
+  test_set_step(1);
+  {
+    ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_aes,16, (uint8_t *) test_keys);
+
+    test_assert(ret == CRY_NOERROR, "failed load transient key");
+  }
+
+  /* [10.2.2] Encrypt in a single operation.*/
+  test_set_step(2);
+  {
+    ret = cryEncryptAES_CTR(&CRYD1, 0,TEST_DATA_BYTE_LEN, (uint8_t*) msg_clear, (uint8_t*) msg_encrypted, (uint8_t*) test_vectors);
+
+    test_assert(ret == CRY_NOERROR, "encrypt failed");
+
+    SHOW_ENCRYPDATA(TEST_DATA_WORD_LEN);
+  }
+
+  /* [10.2.3] Encrypt using a stream in chunks of different sizes.*/
+  test_set_step(3);
+  {
+    ret = cryAESCTRInit(&CRYD1, &ctrctx, 0, (uint8_t*) test_vectors);
+
+    test_assert(ret == CRY_NOERROR, "stream init failed");
+
+    for (pos = 0, n = 1; pos < TEST_DATA_BYTE_LEN; pos += n, n = n * 3 + 1) {
+      if (n > TEST_DATA_BYTE_LEN - pos) {
+        n = TEST_DATA_BYTE_LEN - pos;
+      }
+      ret = cryAESCTRUpdate(&CRYD1, &ctrctx, n, (uint8_t*) msg_clear + pos, (uint8_t*) msg_decrypted + pos);
+
+      test_assert(ret == CRY_NOERROR, "stream encrypt failed");
+    }
+
+    cryAESCTRFinal(&CRYD1, &ctrctx);
+
+    for (int i = 0; i < TEST_DATA_WORD_LEN; i++) {
+      test_assert(msg_decrypted[i] == msg_encrypted[i], "encrypt mismatch");
+    }
+  }
+
+  /* [10.2.4] Decrypt and hash using a stream.*/
+  test_set_step(4);
+  {
+    ret = crySHA256(&CRYD1, TEST_DATA_BYTE_LEN, (uint8_t*) msg_encrypted, (uint8_t*) ref_digest);
+
+    test_assert(ret == CRY_NOERROR, "sha256 failed");
+
+    memset(msg_decrypted, 0xff, TEST_MSG_DATA_BYTE_LEN);
+    shactx.sha.sha_buffer = (uint8_t*)&shabuffer[0];
+    shactx.sha.sha_buffer_size = MAX_SHA_BLOCK_SIZE;
+    ret = crySHA256Init(&CRYD1, &shactx);
+
+    test_assert(ret == CRY_NOERROR, "sha256 init failed");
+
+    cryAESCTRInit(&CRYD1, &ctrctx, 0, (uint8_t*) test_vectors);
+    ret = cryAESCTRSHA256Update(&CRYD1, &ctrctx, &shactx, false, TEST_DATA_BYTE_LEN, (uint8_t*) msg_encrypted, (uint8_t*) msg_decrypted);
+
+    test_assert(ret == CRY_NOERROR, "stream decrypt failed");
+
+    ret = crySHA256Final(&CRYD1, &shactx, (uint8_t*) digest);
+
+    test_assert(ret == CRY_NOERROR, "sha256 final failed");
+
+    SHOW_DECRYPDATA(TEST_DATA_WORD_LEN);
+
+    for (int i = 0; i < TEST_DATA_WORD_LEN; i++) {
+      test_assert(msg_decrypted[i] == msg_clear[i], "decrypt mismatch");
+    }
+
+    for (int i = 0; i < 8; i++) {
+      test_assert(digest[i] == ref_digest[i], "sha256 mismatch");
+    }
+  }
+}
+
+static const testcase_t cry_test_010_002 = {
+  "AES CTR Streaming DMA",
+  cry_test_010_002_setup,
+  cry_test_010_002_teardown,
+  cry_test_010_002_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const cry_test_sequence_010_array[] = {
+  &cry_test_010_001,
+  &cry_test_010_002,
+  NULL
+};
+
+/**
+ * @brief   AES CTR streaming.
+ */
+const testsequence_t cry_test_sequence_010 = {
+  "AES CTR streaming",
+  cry_test_sequence_010_array
+};
@@ -0,0 +1,531 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "cry_test_root.h"
+
+/**
+ * @file    cry_test_sequence_011.c
+ * @brief   Test Sequence 011 code.
+ *
+ * @page cry_test_sequence_011 [11] Benchmarks
+ *
+ * File: @ref cry_test_sequence_011.c
+ *
+ * <h2>Description</h2>
+ * Throughput benchmarks, each algorithm is measured for buffer sizes
+ * from 16 bytes up to CRY_BENCH_MAX_SIZE bytes. The results are reported
+ * in bytes per second and, under RT, in realtime counter cycles per byte.
+ * The implementation in use, hardware or fallback, is reported for each
+ * algorithm.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage cry_test_011_001
+ * - @subpage cry_test_011_002
+ * - @subpage cry_test_011_003
+ * - @subpage cry_test_011_004
+ * - @subpage cry_test_011_005
+ * .
+ */
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+/* Largest buffer size measured, sizes go from 16 bytes up to this value
+   in steps of 4x.*/
+#if !defined(CRY_BENCH_MAX_SIZE)
+#define CRY_BENCH_MAX_SIZE          16384
+#endif
+
+/* Measurement window for each buffer size.*/
+#if !defined(CRY_BENCH_WINDOW)
+#define CRY_BENCH_WINDOW            TIME_MS2I(100)
+#endif
+
+#define BENCH_IMPL(hw)              ((hw) ? "hardware" : "fallback")
+
+ALIGNED_VAR(4) static uint32_t bench_in[CRY_BENCH_MAX_SIZE / 4];
+ALIGNED_VAR(4) static uint32_t bench_out[CRY_BENCH_MAX_SIZE / 4];
+ALIGNED_VAR(4) static uint32_t bench_digest[8];
+
+static const CRYConfig config_Polling = {
+    TRANSFER_POLLING,
+    AES_CFBS_128       //cfbs
+};
+
+static const CRYConfig config_DMA = {
+    TRANSFER_DMA,
+    AES_CFBS_128       //cfbs
+};
+
+typedef cryerror_t (*bench_op_t)(CRYDriver *cryp, size_t size);
+
+static cryerror_t bench_aes_ecb(CRYDriver *cryp, size_t size) {
+
+  return cryEncryptAES_ECB(cryp, 0, size, (const uint8_t *)bench_in,
+                           (uint8_t *)bench_out);
+}
+
+static cryerror_t bench_aes_cbc(CRYDriver *cryp, size_t size) {
+
+  return cryEncryptAES_CBC(cryp, 0, size, (const uint8_t *)bench_in,
+                           (uint8_t *)bench_out, (const uint8_t *)test_vectors);
+}
+
+static cryerror_t bench_aes_ctr(CRYDriver *cryp, size_t size) {
+
+  return cryEncryptAES_CTR(cryp, 0, size, (const uint8_t *)bench_in,
+                           (uint8_t *)bench_out, (const uint8_t *)test_vectors);
+}
+
+static cryerror_t bench_sha1(CRYDriver *cryp, size_t size) {
+  SHA1Context shactx;
+  cryerror_t ret;
+
+  shactx.sha.sha_buffer = (uint8_t *)bench_out;
+  shactx.sha.sha_buffer_size = CRY_BENCH_MAX_SIZE;
+
+  ret = crySHA1Init(cryp, &shactx);
+  if (ret == CRY_NOERROR) {
+    ret = crySHA1Update(cryp, &shactx, size, (const uint8_t *)bench_in);
+  }
+  if (ret == CRY_NOERROR) {
+    ret = crySHA1Final(cryp, &shactx, (uint8_t *)bench_digest);
+  }
+
+  return ret;
+}
+
+static cryerror_t bench_sha256(CRYDriver *cryp, size_t size) {
+  SHA256Context shactx;
+  cryerror_t ret;
+
+  shactx.sha.sha_buffer = (uint8_t *)bench_out;
+  shactx.sha.sha_buffer_size = CRY_BENCH_MAX_SIZE;
+
+  ret = crySHA256Init(cryp, &shactx);
+  if (ret == CRY_NOERROR) {
+    ret = crySHA256Update(cryp, &shactx, size, (const uint8_t *)bench_in);
+  }
+  if (ret == CRY_NOERROR) {
+    ret = crySHA256Final(cryp, &shactx, (uint8_t *)bench_digest);
+  }
+
+  return ret;
+}
+
+static cryerror_t bench_trng(CRYDriver *cryp, size_t size) {
+
+  return cryTRNG(cryp, size, (uint8_t *)bench_out);
+}
+
+static void bench_record(const char *name, size_t size, const char *stat,
+                         uint32_t value, const char *unit) {
+  char metric[28];
+  char digits[8];
+  unsigned i = 0U, n = 0U;
+
+  while ((*name != '\0') && (i < sizeof metric - sizeof digits - 2U)) {
+    metric[i++] = *name++;
+  }
+  metric[i++] = '.';
+  do {
+    digits[n++] = (char)('0' + (size % 10U));
+    size /= 10U;
+  } while ((size > 0U) && (n < sizeof digits));
+  while (n > 0U) {
+    metric[i++] = digits[--n];
+  }
+  while ((*stat != '\0') && (i < sizeof metric - 1U)) {
+    metric[i++] = *stat++;
+  }
+  metric[i] = '\0';
+
+  test_emit_record(metric, value, unit);
+}
+
+/*
+ * Measures an operation over all the buffer sizes, the operation is
+ * repeated until the measurement window expires. Algorithms not
+ * supported by either the LLD or the fallback are skipped.
+ */
+static cryerror_t bench_measure(const char *name, bench_op_t op, bool hw) {
+  size_t size;
+
+  test_print("--- ");
+  test_print(name);
+  test_print(" implementation: ");
+  test_println(BENCH_IMPL(hw));
+
+  for (size = 16U; size <= CRY_BENCH_MAX_SIZE; size *= 4U) {
+    systime_t start, end;
+    sysinterval_t interval;
+    uint64_t bytes = 0U;
+    uint32_t bps;
+    cryerror_t ret;
+#if defined(_CHIBIOS_RT_)
+    rtcnt_t cnt;
+    uint32_t cpb;
+#endif
+
+    /* Starting at the beginning of a tick.*/
+    osalThreadSleep((sysinterval_t)1);
+    start = osalOsGetSystemTimeX();
+    end = osalTimeAddX(start, CRY_BENCH_WINDOW);
+#if defined(_CHIBIOS_RT_)
+    cnt = chSysGetRealtimeCounterX();
+#endif
+    do {
+      ret = op(&CRYD1, size);
+      if (ret != CRY_NOERROR) {
+        if ((ret == CRY_ERR_INV_ALGO) && (bytes == 0U)) {
+          test_println("--- not supported");
+          return CRY_NOERROR;
+        }
+        return ret;
+      }
+      bytes += size;
+    } while (osalTimeIsInRangeX(osalOsGetSystemTimeX(), start, end));
+#if defined(_CHIBIOS_RT_)
+    cnt = chSysGetRealtimeCounterX() - cnt;
+#endif
+    interval = osalTimeDiffX(start, osalOsGetSystemTimeX());
+    bps = (uint32_t)((bytes * (uint64_t)OSAL_ST_FREQUENCY) /
+                     (uint64_t)interval);
+
+    test_print("--- Score : ");
+    test_print(name);
+    test_print(" ");
+    test_printn((uint32_t)size);
+    test_print(" B: ");
+    test_printn(bps);
+#if defined(_CHIBIOS_RT_)
+    /* Cycles per byte with two decimals.*/
+    cpb = (uint32_t)(((uint64_t)cnt * 100U) / bytes);
+    test_print(" B/S, ");
+    test_printn(cpb / 100U);
+    test_print(cpb % 100U < 10U ? ".0" : ".");
+    test_printn(cpb % 100U);
+    test_println(" cycles/B");
+    bench_record(name, size, ".cyc",
+                 (uint32_t)(((uint64_t)cnt * 1024U) / bytes), "cycles/KB");
+#else
+    test_println(" B/S");
+#endif
+    bench_record(name, size, "", bps, "B/S");
+  }
+
+  return CRY_NOERROR;
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page cry_test_011_001 [11.1] AES Polling throughput
+ *
+ * <h2>Description</h2>
+ * AES encryption throughput with a 16 bytes key in polled mode.
+ *
+ * <h2>Test Steps</h2>
+ * - [11.1.1] loading the key with 16 byte size.
+ * - [11.1.2] AES ECB.
+ * - [11.1.3] AES CBC.
+ * - [11.1.4] AES CTR.
+ * .
+ */
+
+static void cry_test_011_001_setup(void) {
+  memset(bench_in, 0x55, sizeof bench_in);
+  cryStart(&CRYD1, &config_Polling);
+}
+
+static void cry_test_011_001_teardown(void) {
+  cryStop(&CRYD1);
+}
+
+static void cry_test_011_001_execute(void) {
+  cryerror_t ret;
+
+  /* [11.1.1] loading the key with 16 byte size.*/
+  test_set_step(1);
+  {
+    ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_aes,16, (uint8_t *) test_keys);
+
+    test_assert(ret == CRY_NOERROR, "failed load transient key");
+  }
+
+  /* [11.1.2] AES ECB.*/
+  test_set_step(2);
+  {
+    ret = bench_measure("aes_ecb", bench_aes_ecb, CRY_LLD_SUPPORTS_AES_ECB);
+
+    test_assert(ret == CRY_NOERROR, "encrypt failed");
+  }
+
+  /* [11.1.3] AES CBC.*/
+  test_set_step(3);
+  {
+    ret = bench_measure("aes_cbc", bench_aes_cbc, CRY_LLD_SUPPORTS_AES_CBC);
+
+    test_assert(ret == CRY_NOERROR, "encrypt failed");
+  }
+
+  /* [11.1.4] AES CTR.*/
+  test_set_step(4);
+  {
+    ret = bench_measure("aes_ctr", bench_aes_ctr, CRY_LLD_SUPPORTS_AES_CTR);
+
+    test_assert(ret == CRY_NOERROR, "encrypt failed");
+  }
+}
+
+static const testcase_t cry_test_011_001 = {
+  "AES Polling throughput",
+  cry_test_011_001_setup,
+  cry_test_011_001_teardown,
+  cry_test_011_001_execute
+};
+
+/**
+ * @page cry_test_011_002 [11.2] AES DMA throughput
+ *
+ * <h2>Description</h2>
+ * AES encryption throughput with a 16 bytes key in DMA mode.
+ *
+ * <h2>Test Steps</h2>
+ * - [11.2.1] loading the key with 16 byte size.
+ * - [11.2.2] AES ECB.
+ * - [11.2.3] AES CBC.
+ * - [11.2.4] AES CTR.
+ * .
+ */
+
+static void cry_test_011_002_setup(void) {
+  memset(bench_in, 0x55, sizeof bench_in);
+  cryStart(&CRYD1, &config_DMA);
+}
+
+static void cry_test_011_002_teardown(void) {
+  cryStop(&CRYD1);
+}
+
+static void cry_test_011_002_execute(void) {
+  cryerror_t ret;
+
+  /* [11.2.1] loading the key with 16 byte size.*/
+  test_set_step(1);
+  {
+    ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_aes,16, (uint8_t *) test_keys);
+
+    test_assert(ret == CRY_NOERROR, "failed load transient key");
+  }
+
+  /* [11.2.2] AES ECB.*/
+  test_set_step(2);
+  {
+    ret = bench_measure("aes_ecb_dma", bench_aes_ecb, CRY_LLD_SUPPORTS_AES_ECB);
+
+    test_assert(ret == CRY_NOERROR, "encrypt failed");
+  }
+
+  /* [11.2.3] AES CBC.*/
+  test_set_step(3);
+  {
+    ret = bench_measure("aes_cbc_dma", bench_aes_cbc, CRY_LLD_SUPPORTS_AES_CBC);
+
+    test_assert(ret == CRY_NOERROR, "encrypt failed");
+  }
+
+  /* [11.2.4] AES CTR.*/
+  test_set_step(4);
+  {
+    ret = bench_measure("aes_ctr_dma", bench_aes_ctr, CRY_LLD_SUPPORTS_AES_CTR);
+
+    test_assert(ret == CRY_NOERROR, "encrypt failed");
+  }
+}
+
+static const testcase_t cry_test_011_002 = {
+  "AES DMA throughput",
+  cry_test_011_002_setup,
+  cry_test_011_002_teardown,
+  cry_test_011_002_execute
+};
+
+/**
+ * @page cry_test_011_003 [11.3] SHA Polling throughput
+ *
+ * <h2>Description</h2>
+ * SHA1 and SHA256 throughput in polled mode, each operation includes
+ * the context initialization and the final digest.
+ *
+ * <h2>Test Steps</h2>
+ * - [11.3.1] SHA1.
+ * - [11.3.2] SHA256.
+ * .
+ */
+
+static void cry_test_011_003_setup(void) {
+  memset(bench_in, 0x55, sizeof bench_in);
+  cryStart(&CRYD1, &config_Polling);
+}
+
+static void cry_test_011_003_teardown(void) {
+  cryStop(&CRYD1);
+}
+
+static void cry_test_011_003_execute(void) {
+  cryerror_t ret;
+
+  /* [11.3.1] SHA1.*/
+  test_set_step(1);
+  {
+    ret = bench_measure("sha1", bench_sha1, CRY_LLD_SUPPORTS_SHA1);
+
+    test_assert(ret == CRY_NOERROR, "sha1 failed");
+  }
+
+  /* [11.3.2] SHA256.*/
+  test_set_step(2);
+  {
+    ret = bench_measure("sha256", bench_sha256, CRY_LLD_SUPPORTS_SHA256);
+
+    test_assert(ret == CRY_NOERROR, "sha256 failed");
+  }
+}
+
+static const testcase_t cry_test_011_003 = {
+  "SHA Polling throughput",
+  cry_test_011_003_setup,
+  cry_test_011_003_teardown,
+  cry_test_011_003_execute
+};
+
+/**
+ * @page cry_test_011_004 [11.4] SHA DMA throughput
+ *
+ * <h2>Description</h2>
+ * SHA1 and SHA256 throughput in DMA mode, each operation includes the
+ * context initialization and the final digest.
+ *
+ * <h2>Test Steps</h2>
+ * - [11.4.1] SHA1.
+ * - [11.4.2] SHA256.
+ * .
+ */
+
+static void cry_test_011_004_setup(void) {
+  memset(bench_in, 0x55, sizeof bench_in);
+  cryStart(&CRYD1, &config_DMA);
+}
+
+static void cry_test_011_004_teardown(void) {
+  cryStop(&CRYD1);
+}
+
+static void cry_test_011_004_execute(void) {
+  cryerror_t ret;
+
+  /* [11.4.1] SHA1.*/
+  test_set_step(1);
+  {
+    ret = bench_measure("sha1_dma", bench_sha1, CRY_LLD_SUPPORTS_SHA1);
+
+    test_assert(ret == CRY_NOERROR, "sha1 failed");
+  }
+
+  /* [11.4.2] SHA256.*/
+  test_set_step(2);
+  {
+    ret = bench_measure("sha256_dma", bench_sha256, CRY_LLD_SUPPORTS_SHA256);
+
+    test_assert(ret == CRY_NOERROR, "sha256 failed");
+  }
+}
+
+static const testcase_t cry_test_011_004 = {
+  "SHA DMA throughput",
+  cry_test_011_004_setup,
+  cry_test_011_004_teardown,
+  cry_test_011_004_execute
+};
+
+/**
+ * @page cry_test_011_005 [11.5] TRNG throughput
+ *
+ * <h2>Description</h2>
+ * TRNG throughput in polled mode.
+ *
+ * <h2>Test Steps</h2>
+ * - [11.5.1] Random generation.
+ * .
+ */
+
+static void cry_test_011_005_setup(void) {
+  cryStart(&CRYD1, &config_Polling);
+}
+
+static void cry_test_011_005_teardown(void) {
+  cryStop(&CRYD1);
+}
+
+static void cry_test_011_005_execute(void) {
+  cryerror_t ret;
+
+  /* [11.5.1] Random generation.*/
+  test_set_step(1);
+  {
+    ret = bench_measure("trng", bench_trng, CRY_LLD_SUPPORTS_TRNG);
+
+    test_assert(ret == CRY_NOERROR, "failed random");
+  }
+}
+
+static const testcase_t cry_test_011_005 = {
+  "TRNG throughput",
+  cry_test_011_005_setup,
+  cry_test_011_005_teardown,
+  cry_test_011_005_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const cry_test_sequence_011_array[] = {
+  &cry_test_011_001,
+  &cry_test_011_002,
+  &cry_test_011_003,
+  &cry_test_011_004,
+  &cry_test_011_005,
+  NULL
+};
+
+/**
+ * @brief   Benchmarks.
+ */
+const testsequence_t cry_test_sequence_011 = {
+  "Benchmarks",
+  cry_test_sequence_011_array
+};
@@ -56,6 +56,11 @@ static const char *test_failure_message;
 static char test_tokens_buffer[TEST_MAX_TOKENS];
 static char *test_tokp;
 static BaseSequentialStream *test_chp;
+#if TEST_EMIT_RECORDS == TRUE
+static const char *test_suite_name;
+static int test_seq_id, test_case_id;
+static uint32_t test_config_hash;
+#endif
 
 /*===========================================================================*/
 /* Module local functions.                                                   */
@@ -102,6 +107,36 @@ static void print_fat_line(void) {
   streamWrite(test_chp, (const uint8_t *)"\r\n", 2);
 }
 
+#if TEST_EMIT_RECORDS == TRUE
+/* FNV-1a hash step over a string.*/
+static uint32_t hash_string(uint32_t h, const char *s) {
+
+  while (*s) {
+    h ^= (uint32_t)(unsigned char)*s++;
+    h *= 16777619U;
+  }
+  return h;
+}
+
+static void print_hex32(uint32_t n) {
+  int i;
+
+  for (i = 28; i >= 0; i -= 4)
+    streamPut(test_chp, "0123456789abcdef"[(n >> i) & 15U]);
+}
+
+static void print_json_string(const char *s) {
+
+  streamPut(test_chp, '"');
+  while (*s) {
+    if ((*s == '"') || (*s == '\\'))
+      streamPut(test_chp, '\\');
+    streamPut(test_chp, *s++);
+  }
+  streamPut(test_chp, '"');
+}
+#endif
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -220,6 +255,49 @@ void test_emit_token_i(char token) {
     *test_tokp++ = token;
 }
 
+/**
+ * @brief   Emits a benchmark record.
+ * @details The record is a JSON object on a single line, for example:
+ *          @code
+ *          {"suite":"RT","test":"10.1","metric":"msgs","value":1000,
+ *           "unit":"msgs/S","config":"811c9dc5"}
+ *          @endcode
+ *          Units ending in "/S" are throughputs, higher values are better,
+ *          for all the others lower values are better.
+ * @note    The function does nothing if @p TEST_EMIT_RECORDS is disabled.
+ * @note    This function can only be called from test_case execute context.
+ *
+ * @param[in] metric    name of the metric, unique within the test case
+ * @param[in] value     measured value
+ * @param[in] unit      unit of the value
+ *
+ * @api
+ */
+void test_emit_record(const char *metric, uint32_t value, const char *unit) {
+
+#if TEST_EMIT_RECORDS == TRUE
+  test_print("{\"suite\":");
+  print_json_string(test_suite_name);
+  test_print(",\"test\":\"");
+  test_printn((uint32_t)test_seq_id);
+  test_print(".");
+  test_printn((uint32_t)test_case_id);
+  test_print("\",\"metric\":");
+  print_json_string(metric);
+  test_print(",\"value\":");
+  test_printn(value);
+  test_print(",\"unit\":");
+  print_json_string(unit);
+  test_print(",\"config\":\"");
+  print_hex32(test_config_hash);
+  test_println("\"}");
+#else
+  (void)metric;
+  (void)value;
+  (void)unit;
+#endif
+}
+
 /**
  * @brief   Test execution thread function.
  *
@@ -244,6 +322,17 @@ msg_t test_execute(BaseSequentialStream *stream, const testsuite_t *tsp) {
   else {
     test_println("*** Test Suite");
   }
+#if TEST_EMIT_RECORDS == TRUE
+  test_suite_name  = tsp->name != NULL ? tsp->name : "Test Suite";
+  test_config_hash = hash_string(2166136261U, test_suite_name);
+#if defined(PLATFORM_NAME)
+  test_config_hash = hash_string(test_config_hash, PLATFORM_NAME);
+#endif
+#if defined(BOARD_NAME)
+  test_config_hash = hash_string(test_config_hash, BOARD_NAME);
+#endif
+  test_config_hash = hash_string(test_config_hash, TEST_CONFIG_STRING);
+#endif
   test_println("***");
   test_print("*** Compiled:     ");
   test_println(__DATE__ " - " __TIME__);
@@ -255,6 +344,11 @@ msg_t test_execute(BaseSequentialStream *stream, const testsuite_t *tsp) {
   test_print("*** Test Board:   ");
   test_println(BOARD_NAME);
 #endif
+#if TEST_EMIT_RECORDS == TRUE
+  test_print("*** Config hash:  ");
+  print_hex32(test_config_hash);
+  test_println("");
+#endif
 #if defined(TEST_REPORT_HOOK_HEADER)
   TEST_REPORT_HOOK_HEADER
 #endif
@@ -283,6 +377,10 @@ msg_t test_execute(BaseSequentialStream *stream, const testsuite_t *tsp) {
       test_println(")");
 #if TEST_DELAY_BETWEEN_TESTS > 0
       osalThreadSleepMilliseconds(TEST_DELAY_BETWEEN_TESTS);
+#endif
+#if TEST_EMIT_RECORDS == TRUE
+      test_seq_id  = tseq + 1;
+      test_case_id = tcase + 1;
 #endif
       execute_test(tsp->sequences[tseq]->cases[tcase]);
       if (test_local_fail) {
@@ -54,6 +54,28 @@
 #define TEST_SHOW_SEQUENCES                 TRUE
 #endif
 
+/**
+ * @brief   Emission of benchmark records.
+ * @details If enabled the benchmark results are also emitted as JSON lines
+ *          records, one per metric, tagged with the test case identifier
+ *          and the configuration hash. The @p tools/bench/benchcmp.py
+ *          script compares the records of two runs.
+ */
+#if !defined(TEST_EMIT_RECORDS) || defined(__DOXYGEN__)
+#define TEST_EMIT_RECORDS                   FALSE
+#endif
+
+/**
+ * @brief   Configuration description string.
+ * @details This string is hashed with the platform and board names into
+ *          the configuration hash of the records, it should describe the
+ *          build options affecting performance, compiler flags for
+ *          example.
+ */
+#if !defined(TEST_CONFIG_STRING) || defined(__DOXYGEN__)
+#define TEST_CONFIG_STRING                  ""
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -201,6 +223,7 @@ extern "C" {
   void test_println(const char *msgp);
   void test_emit_token(char token);
   void test_emit_token_i(char token);
+  void test_emit_record(const char *metric, uint32_t value, const char *unit);
   msg_t test_execute(BaseSequentialStream *stream, const testsuite_t *tsp);
 #ifdef __cplusplus
 }
@@ -23,6 +23,7 @@
  * <h2>Test Sequences</h2>
  * - @subpage mfs_test_sequence_001
  * - @subpage mfs_test_sequence_002
+ * - @subpage mfs_test_sequence_003
  * .
  */
 
@@ -46,6 +47,9 @@
 const testsequence_t * const mfs_test_suite_array[] = {
   &mfs_test_sequence_001,
   &mfs_test_sequence_002,
+#if (CH_CFG_USE_TM) || defined(__DOXYGEN__)
+  &mfs_test_sequence_003,
+#endif
   NULL
 };
 
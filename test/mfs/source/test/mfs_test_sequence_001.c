@@ -37,6 +37,10 @@
  * - @subpage mfs_test_001_005
  * - @subpage mfs_test_001_006
  * - @subpage mfs_test_001_007
+ * - @subpage mfs_test_001_008
+ * - @subpage mfs_test_001_009
+ * - @subpage mfs_test_001_010
+ * - @subpage mfs_test_001_011
  * .
  */
 
@@ -777,6 +781,468 @@ static const testcase_t mfs_test_001_007 = {
   mfs_test_001_007_execute
 };
 
+/**
+ * @page mfs_test_001_008 [1.8] Testing incremental garbage collection
+ *
+ * <h2>Description</h2>
+ * The garbage collection is performed in steps interleaved with write
+ * operations and the state of both banks is checked.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.8.1] Filling up the storage leaving space for one record,
+ *   MFS_NO_ERROR is expected.
+ * - [1.8.2] Erasing two records, MFS_NO_ERROR is expected.
+ * - [1.8.3] Performing a single garbage collection step, the collection
+ *   is expected to be in progress.
+ * - [1.8.4] Updating a record already copied by the collection,
+ *   MFS_NO_ERROR is expected.
+ * - [1.8.5] Completing the garbage collection, MFS object state is
+ *   checked for correctness after the operation.
+ * - [1.8.6] Checking for all records in the new bank, MFS_NO_ERROR is
+ *   expected for each existing record.
+ * .
+ */
+
+static void mfs_test_001_008_setup(void) {
+  mfsStart(&mfs1, &mfscfg1);
+  mfsErase(&mfs1);
+}
+
+static void mfs_test_001_008_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_001_008_execute(void) {
+
+  /* [1.8.1] Filling up the storage leaving space for one record,
+     MFS_NO_ERROR is expected.*/
+  test_set_step(1);
+  {
+    mfs_id_t id;
+    mfs_id_t id_max = (mfscfg1.bank_size - sizeof (mfs_bank_header_t)) /
+                      (sizeof (mfs_data_header_t) + sizeof pattern512);
+
+    for (id = 1; id < id_max; id++) {
+      mfs_error_t err;
+
+      err = mfsWriteRecord(&mfs1, id, sizeof pattern512, pattern512);
+      test_assert(err == MFS_NO_ERROR, "error creating the record");
+    }
+  }
+
+  /* [1.8.2] Erasing two records, MFS_NO_ERROR is expected.*/
+  test_set_step(2);
+  {
+    mfs_error_t err;
+
+    err = mfsEraseRecord(&mfs1, 1);
+    test_assert(err == MFS_NO_ERROR, "error erasing the record");
+    err = mfsEraseRecord(&mfs1, 2);
+    test_assert(err == MFS_NO_ERROR, "error erasing the record");
+  }
+
+  /* [1.8.3] Performing a single garbage collection step, the collection is
+     expected to be in progress.*/
+  test_set_step(3);
+  {
+    mfs_error_t err;
+
+    err = mfsPerformGarbageCollectionStep(&mfs1, (sysinterval_t)0);
+    test_assert(err == MFS_NO_ERROR, "garbage collection step failed");
+    test_assert(mfsIsGarbageCollectionPending(&mfs1), "collection not started");
+    test_assert(mfs1.current_counter == 1, "not first instance");
+    test_assert(mfs1.current_bank == MFS_BANK_0, "unexpected bank");
+  }
+
+  /* [1.8.4] Updating a record already copied by the collection,
+     MFS_NO_ERROR is expected.*/
+  test_set_step(4);
+  {
+    mfs_error_t err;
+    size_t size;
+
+    err = mfsWriteRecord(&mfs1, 3, sizeof pattern3, pattern3);
+    test_assert(err == MFS_NO_ERROR, "error updating the record");
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 3, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record not found");
+    test_assert(size == sizeof pattern3, "unexpected record length");
+    test_assert(memcmp(pattern3, mfs_buffer, size) == 0, "wrong record content");
+  }
+
+  /* [1.8.5] Completing the garbage collection, MFS object state is checked
+     for correctness after the operation.*/
+  test_set_step(5);
+  {
+    mfs_error_t err;
+
+    err = mfsPerformGarbageCollectionStep(&mfs1, TIME_INFINITE);
+    test_assert(err == MFS_NO_ERROR, "garbage collection step failed");
+    test_assert(!mfsIsGarbageCollectionPending(&mfs1), "collection not completed");
+    test_assert(mfs1.current_counter == 2, "not second instance");
+    test_assert(mfs1.current_bank == MFS_BANK_1, "unexpected bank");
+    test_assert(bank_verify_erased(MFS_BANK_0) == FLASH_NO_ERROR, "bank 0 not erased");
+  }
+
+  /* [1.8.6] Checking for all records in the new bank, MFS_NO_ERROR is
+     expected for each existing record.*/
+  test_set_step(6);
+  {
+    mfs_id_t id;
+    mfs_id_t id_max = (mfscfg1.bank_size - sizeof (mfs_bank_header_t)) /
+                      (sizeof (mfs_data_header_t) + sizeof pattern512);
+
+    for (id = 1; id <= MFS_CFG_MAX_RECORDS; id++) {
+      mfs_error_t err;
+      size_t size;
+
+      size = sizeof mfs_buffer;
+      err = mfsReadRecord(&mfs1, id, &size, mfs_buffer);
+      if (id == 3) {
+        test_assert(err == MFS_NO_ERROR, "record not found");
+        test_assert(size == sizeof pattern3, "unexpected record length");
+        test_assert(memcmp(pattern3, mfs_buffer, size) == 0, "wrong record content");
+      }
+      else if ((id > 3) && (id < id_max)) {
+        test_assert(err == MFS_NO_ERROR, "record not found");
+        test_assert(size == sizeof pattern512, "unexpected record length");
+        test_assert(memcmp(pattern512, mfs_buffer, size) == 0, "wrong record content");
+      }
+      else {
+        test_assert(err == MFS_ERR_NOT_FOUND, "found unexpected record");
+      }
+    }
+  }
+}
+
+static const testcase_t mfs_test_001_008 = {
+  "Testing incremental garbage collection",
+  mfs_test_001_008_setup,
+  mfs_test_001_008_teardown,
+  mfs_test_001_008_execute
+};
+
+/**
+ * @page mfs_test_001_009 [1.9] Testing index checkpoints
+ *
+ * <h2>Description</h2>
+ * The records index is saved by mfsStop() and loaded back by mfsStart(),
+ * records written after the checkpoint are found by scanning the
+ * storage.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.9.1] Writing three records, MFS_NO_ERROR is expected.
+ * - [1.9.2] Stopping and restarting the driver, the index checkpoint is
+ *   expected to be used.
+ * - [1.9.3] Updating record 1 and erasing record 2 without a checkpoint,
+ *   then restarting the driver, MFS_NO_ERROR is expected.
+ * - [1.9.4] Checking the records state, the changes made after the
+ *   checkpoint are expected to be found.
+ * .
+ */
+
+static void mfs_test_001_009_setup(void) {
+  mfsStart(&mfs1, &mfscfg1);
+  mfsErase(&mfs1);
+}
+
+static void mfs_test_001_009_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_001_009_execute(void) {
+
+  /* [1.9.1] Writing three records, MFS_NO_ERROR is expected.*/
+  test_set_step(1);
+  {
+    mfs_error_t err;
+
+    err = mfsWriteRecord(&mfs1, 1, sizeof pattern1, pattern1);
+    test_assert(err == MFS_NO_ERROR, "error creating record 1");
+    err = mfsWriteRecord(&mfs1, 2, sizeof pattern2, pattern2);
+    test_assert(err == MFS_NO_ERROR, "error creating record 2");
+    err = mfsWriteRecord(&mfs1, 3, sizeof pattern3, pattern3);
+    test_assert(err == MFS_NO_ERROR, "error creating record 3");
+  }
+
+  /* [1.9.2] Stopping and restarting the driver, the index checkpoint is
+     expected to be used.*/
+  test_set_step(2);
+  {
+    mfs_error_t err;
+
+    mfsStop(&mfs1);
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "initialization error");
+    test_assert(mfs1.locators == 1U, "checkpoint not written");
+    test_assert(mfs1.index_end == mfs1.next_offset, "checkpoint not used");
+    test_assert(mfs1.records == 3U, "wrong number of records");
+  }
+
+  /* [1.9.3] Updating record 1 and erasing record 2 without a checkpoint,
+     then restarting the driver, MFS_NO_ERROR is expected.*/
+  test_set_step(3);
+  {
+    mfs_error_t err;
+
+    err = mfsWriteRecord(&mfs1, 1, sizeof pattern3, pattern3);
+    test_assert(err == MFS_NO_ERROR, "error updating record 1");
+    err = mfsEraseRecord(&mfs1, 2);
+    test_assert(err == MFS_NO_ERROR, "error erasing record 2");
+    err = mfsSync(&mfs1);
+    test_assert(err == MFS_NO_ERROR, "synchronization failed");
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "initialization error");
+    test_assert(mfs1.locators == 1U, "unexpected checkpoint");
+    test_assert(mfs1.index_end < mfs1.next_offset, "records not scanned");
+  }
+
+  /* [1.9.4] Checking the records state, the changes made after the
+     checkpoint are expected to be found.*/
+  test_set_step(4);
+  {
+    mfs_error_t err;
+    size_t size;
+
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 1, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record 1 not found");
+    test_assert(size == sizeof pattern3, "unexpected record length");
+    test_assert(memcmp(pattern3, mfs_buffer, size) == 0, "wrong record content");
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 2, &size, mfs_buffer);
+    test_assert(err == MFS_ERR_NOT_FOUND, "record 2 not erased");
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 3, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record 3 not found");
+    test_assert(size == sizeof pattern3, "unexpected record length");
+    test_assert(memcmp(pattern3, mfs_buffer, size) == 0, "wrong record content");
+  }
+}
+
+static const testcase_t mfs_test_001_009 = {
+  "Testing index checkpoints",
+  mfs_test_001_009_setup,
+  mfs_test_001_009_teardown,
+  mfs_test_001_009_execute
+};
+
+#if (MFS_CFG_WRITE_CACHE_RECORDS > 0) || defined(__DOXYGEN__)
+/**
+ * @page mfs_test_001_010 [1.10] Testing the write-back cache
+ *
+ * <h2>Description</h2>
+ * Multiple updates of a cached record are coalesced in RAM and written
+ * to flash as a single record by mfsSync().
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - MFS_CFG_WRITE_CACHE_RECORDS > 0
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [1.10.1] Updating the same record twice, the record is expected to
+ *   be cached and not written to flash.
+ * - [1.10.2] Calling mfsSync(), a single record instance is expected to
+ *   be written to flash.
+ * - [1.10.3] Restarting the driver, the record is expected to be found
+ *   in flash.
+ * .
+ */
+
+static void mfs_test_001_010_setup(void) {
+  mfsStart(&mfs1, &mfscfg1);
+  mfsErase(&mfs1);
+}
+
+static void mfs_test_001_010_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_001_010_execute(void) {
+  flash_offset_t offset;
+
+  /* [1.10.1] Updating the same record twice, the record is expected to be
+     cached and not written to flash.*/
+  test_set_step(1);
+  {
+    mfs_error_t err;
+    size_t size;
+
+    offset = mfs1.next_offset;
+    err = mfsWriteRecord(&mfs1, 1, sizeof pattern1, pattern1);
+    test_assert(err == MFS_NO_ERROR, "error creating the record");
+    err = mfsWriteRecord(&mfs1, 1, sizeof pattern2, pattern2);
+    test_assert(err == MFS_NO_ERROR, "error updating the record");
+    test_assert(mfs1.next_offset == offset, "record written to flash");
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 1, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record not found");
+    test_assert(size == sizeof pattern2, "unexpected record length");
+    test_assert(memcmp(pattern2, mfs_buffer, size) == 0, "wrong record content");
+  }
+
+  /* [1.10.2] Calling mfsSync(), a single record instance is expected to be
+     written to flash.*/
+  test_set_step(2);
+  {
+    mfs_error_t err;
+
+    err = mfsSync(&mfs1);
+    test_assert(err == MFS_NO_ERROR, "synchronization failed");
+    test_assert(mfs1.next_offset == offset + sizeof (mfs_data_header_t) +
+                                    sizeof pattern2, "unexpected flash usage");
+  }
+
+  /* [1.10.3] Restarting the driver, the record is expected to be found in
+     flash.*/
+  test_set_step(3);
+  {
+    mfs_error_t err;
+    size_t size;
+
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "initialization error");
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 1, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record not found");
+    test_assert(size == sizeof pattern2, "unexpected record length");
+    test_assert(memcmp(pattern2, mfs_buffer, size) == 0, "wrong record content");
+  }
+}
+
+static const testcase_t mfs_test_001_010 = {
+  "Testing the write-back cache",
+  mfs_test_001_010_setup,
+  mfs_test_001_010_teardown,
+  mfs_test_001_010_execute
+};
+#endif /* MFS_CFG_WRITE_CACHE_RECORDS > 0 */
+
+/**
+ * @page mfs_test_001_011 [1.11] Testing record streams
+ *
+ * <h2>Description</h2>
+ * A large record is written and read back in chunks using record
+ * streams, an incomplete write stream is expected to leave the previous
+ * record content unchanged.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.11.1] Writing a record in chunks using a write stream, the record
+ *   is expected to be readable using mfsReadRecord().
+ * - [1.11.2] Reading the record in chunks using a read stream, the
+ *   content is expected to match.
+ * - [1.11.3] Closing an incomplete write stream, an error is expected
+ *   and the previous record content must be unchanged.
+ * - [1.11.4] Restarting the driver, the record is expected to be
+ *   unchanged.
+ * .
+ */
+
+static void mfs_test_001_011_setup(void) {
+  mfsStart(&mfs1, &mfscfg1);
+  mfsErase(&mfs1);
+}
+
+static void mfs_test_001_011_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_001_011_execute(void) {
+
+  /* [1.11.1] Writing a record in chunks using a write stream, the record
+     is expected to be readable using mfsReadRecord().*/
+  test_set_step(1);
+  {
+    mfs_error_t err;
+    mfs_record_stream_t rs;
+    size_t size, i;
+
+    err = mfsCreateRecordStream(&mfs1, 1, sizeof pattern512, &rs);
+    test_assert(err == MFS_NO_ERROR, "error creating the stream");
+    for (i = 0U; i < sizeof pattern512; i += 64U) {
+      err = mfsWriteRecordStream(&mfs1, &rs, 64U, &pattern512[i]);
+      test_assert(err == MFS_NO_ERROR, "error writing the stream");
+    }
+    err = mfsCloseRecordStream(&mfs1, &rs);
+    test_assert(err == MFS_NO_ERROR, "error closing the stream");
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 1, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record not found");
+    test_assert(size == sizeof pattern512, "unexpected record length");
+    test_assert(memcmp(pattern512, mfs_buffer, size) == 0, "wrong record content");
+  }
+
+  /* [1.11.2] Reading the record in chunks using a read stream, the content
+     is expected to match.*/
+  test_set_step(2);
+  {
+    mfs_error_t err;
+    mfs_record_stream_t rs;
+    size_t size, total;
+
+    err = mfsOpenRecordStream(&mfs1, 1, &rs);
+    test_assert(err == MFS_NO_ERROR, "error opening the stream");
+    test_assert(rs.size == sizeof pattern512, "unexpected record length");
+    total = 0U;
+    do {
+      size = 100U;
+      err = mfsReadRecordStream(&mfs1, &rs, &size, &mfs_buffer[total]);
+      test_assert(err == MFS_NO_ERROR, "error reading the stream");
+      total += size;
+    } while (size > 0U);
+    test_assert(total == sizeof pattern512, "unexpected record length");
+    test_assert(memcmp(pattern512, mfs_buffer, total) == 0, "wrong record content");
+    err = mfsCloseRecordStream(&mfs1, &rs);
+    test_assert(err == MFS_NO_ERROR, "error closing the stream");
+  }
+
+  /* [1.11.3] Closing an incomplete write stream, an error is expected and
+     the previous record content must be unchanged.*/
+  test_set_step(3);
+  {
+    mfs_error_t err;
+    mfs_record_stream_t rs;
+    size_t size;
+
+    err = mfsCreateRecordStream(&mfs1, 1, sizeof pattern1, &rs);
+    test_assert(err == MFS_NO_ERROR, "error creating the stream");
+    err = mfsWriteRecordStream(&mfs1, &rs, 4U, pattern1);
+    test_assert(err == MFS_NO_ERROR, "error writing the stream");
+    err = mfsCloseRecordStream(&mfs1, &rs);
+    test_assert(err == MFS_ERR_INV_SIZE, "incomplete stream not detected");
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 1, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record not found");
+    test_assert(size == sizeof pattern512, "unexpected record length");
+    test_assert(memcmp(pattern512, mfs_buffer, size) == 0, "wrong record content");
+  }
+
+  /* [1.11.4] Restarting the driver, the record is expected to be
+     unchanged.*/
+  test_set_step(4);
+  {
+    mfs_error_t err;
+    size_t size;
+
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "initialization error");
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 1, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record not found");
+    test_assert(size == sizeof pattern512, "unexpected record length");
+    test_assert(memcmp(pattern512, mfs_buffer, size) == 0, "wrong record content");
+  }
+}
+
+static const testcase_t mfs_test_001_011 = {
+  "Testing record streams",
+  mfs_test_001_011_setup,
+  mfs_test_001_011_teardown,
+  mfs_test_001_011_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -792,6 +1258,12 @@ const testcase_t * const mfs_test_sequence_001_array[] = {
   &mfs_test_001_005,
   &mfs_test_001_006,
   &mfs_test_001_007,
+  &mfs_test_001_008,
+  &mfs_test_001_009,
+#if (MFS_CFG_WRITE_CACHE_RECORDS > 0) || defined(__DOXYGEN__)
+  &mfs_test_001_010,
+#endif
+  &mfs_test_001_011,
   NULL
 };
 
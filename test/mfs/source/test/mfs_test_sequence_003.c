@@ -0,0 +1,485 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "mfs_test_root.h"
+
+/**
+ * @file    mfs_test_sequence_003.c
+ * @brief   Test Sequence 003 code.
+ *
+ * @page mfs_test_sequence_003 [3] Benchmarks
+ *
+ * File: @ref mfs_test_sequence_003.c
+ *
+ * <h2>Description</h2>
+ * This sequence measures the MFS performance on the configured flash
+ * device: mount time against the bank fill level, write latency
+ * distribution including the writes triggering a garbage collection,
+ * read throughput and flash erases per logical write. Times are
+ * measured in realtime counter cycles.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_TM
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage mfs_test_003_001
+ * - @subpage mfs_test_003_002
+ * - @subpage mfs_test_003_003
+ * - @subpage mfs_test_003_004
+ * .
+ */
+
+#if (CH_CFG_USE_TM) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+#include "hal_mfs.h"
+
+/* Number of distinct records written by the benchmarks.*/
+#define BENCH_RECORDS               8U
+
+/* Size of the records written by the mount and latency benchmarks.*/
+#define BENCH_RECORD_SIZE           32U
+
+/* Number of mount operations measured for each fill level.*/
+#define BENCH_MOUNT_REPEAT          4U
+
+/* Garbage collection cycles performed by the latency and write
+   amplification benchmarks.*/
+#define BENCH_GC_CYCLES             4U
+
+/* Read benchmark measurement window.*/
+#define BENCH_READ_WINDOW           TIME_MS2I(100)
+
+static time_measurement_t bench_tm;
+static time_measurement_t bench_gc_tm;
+#if CH_CFG_USE_TM_HISTOGRAM
+static tm_histogram_t bench_histogram;
+#endif
+
+static void bench_record(const char *name, const char *stat, uint32_t value,
+                         const char *unit) {
+  char metric[16];
+  unsigned i = 0U;
+
+  while ((*name != '\0') && (i < sizeof metric - 1U)) {
+    metric[i++] = *name++;
+  }
+  if (*stat != '\0') {
+    if (i < sizeof metric - 1U) {
+      metric[i++] = '.';
+    }
+    while ((*stat != '\0') && (i < sizeof metric - 1U)) {
+      metric[i++] = *stat++;
+    }
+  }
+  metric[i] = '\0';
+
+  test_emit_record(metric, value, unit);
+}
+
+static void bench_print_tm(const char *name, const time_measurement_t *tmp) {
+  uint32_t avg;
+
+  test_print("--- Score : ");
+  test_print(name);
+  test_print(" ");
+  if (tmp->n == 0U) {
+    test_println("no samples");
+    return;
+  }
+  avg = (uint32_t)(tmp->cumulative / (rttime_t)tmp->n);
+  test_printn((uint32_t)tmp->best);
+  test_print("/");
+  test_printn(avg);
+  test_print("/");
+#if CH_CFG_USE_TM_HISTOGRAM
+  if (tmp->histogram != NULL) {
+    test_printn((uint32_t)chTMGetPercentileX(tmp, 990U));
+  }
+  else {
+    test_print("-");
+  }
+#else
+  test_print("-");
+#endif
+  test_print("/");
+  test_printn((uint32_t)tmp->worst);
+  test_println(" cycles min/avg/p99/max");
+  bench_record(name, "min", (uint32_t)tmp->best, "cycles");
+  bench_record(name, "avg", avg, "cycles");
+#if CH_CFG_USE_TM_HISTOGRAM
+  if (tmp->histogram != NULL) {
+    bench_record(name, "p99", (uint32_t)chTMGetPercentileX(tmp, 990U),
+                 "cycles");
+  }
+#endif
+  bench_record(name, "max", (uint32_t)tmp->worst, "cycles");
+}
+
+static mfs_error_t bench_write(mfs_id_t id, size_t n) {
+  mfs_error_t err;
+
+  err = mfsWriteRecord(&mfs1, id, n, mfs_buffer);
+#if MFS_CFG_WRITE_CACHE_RECORDS > 0
+  /* Cached writes are flushed, the benchmarks measure the flash.*/
+  if (err == MFS_NO_ERROR) {
+    err = mfsSync(&mfs1);
+  }
+#endif
+
+  return err;
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page mfs_test_003_001 [3.1] Mount time
+ *
+ * <h2>Description</h2>
+ * The time taken by mfsStart() is measured with the current bank filled
+ * at 0%, 25%, 50% and 75% of its size.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.1.1] The flash is erased and MFS is started.
+ * - [3.1.2] The bank is filled at each level and the mount time is
+ *   measured.
+ * .
+ */
+
+static void mfs_test_003_001_setup(void) {
+  mfsObjectInit(&mfs1);
+  memset(mfs_buffer, 0x55, sizeof mfs_buffer);
+}
+
+static void mfs_test_003_001_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_003_001_execute(void) {
+
+  /* [3.1.1] The flash is erased and MFS is started.*/
+  test_set_step(1);
+  {
+    mfs_error_t err;
+
+    test_assert(bank_erase(MFS_BANK_0) == FLASH_NO_ERROR, "Bank 0 erase failure");
+    test_assert(bank_erase(MFS_BANK_1) == FLASH_NO_ERROR, "Bank 1 erase failure");
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "initialization error");
+  }
+
+  /* [3.1.2] The bank is filled at each level and the mount time is
+     measured.*/
+  test_set_step(2);
+  {
+    static const char *levels[] = {"mount.0", "mount.25", "mount.50", "mount.75"};
+    uint32_t counter = mfs1.current_counter;
+    mfs_id_t id = 1U;
+    unsigned i, j;
+
+    for (i = 0U; i < 4U; i++) {
+      mfs_error_t err;
+
+      while (mfs1.next_offset < (mfscfg1.bank_size * i) / 4U) {
+        err = bench_write(id, BENCH_RECORD_SIZE);
+        test_assert(err == MFS_NO_ERROR, "error writing record");
+        id = (mfs_id_t)((id % BENCH_RECORDS) + 1U);
+      }
+      test_assert(mfs1.current_counter == counter, "unexpected garbage collection");
+
+      chTMObjectInit(&bench_tm);
+      for (j = 0U; j < BENCH_MOUNT_REPEAT; j++) {
+        mfsStop(&mfs1);
+        chTMStartMeasurementX(&bench_tm);
+        err = mfsStart(&mfs1, &mfscfg1);
+        chTMStopMeasurementX(&bench_tm);
+        test_assert(err == MFS_NO_ERROR, "initialization error");
+      }
+      bench_print_tm(levels[i], &bench_tm);
+    }
+  }
+}
+
+static const testcase_t mfs_test_003_001 = {
+  "Mount time",
+  mfs_test_003_001_setup,
+  mfs_test_003_001_teardown,
+  mfs_test_003_001_execute
+};
+
+/**
+ * @page mfs_test_003_002 [3.2] Write latency
+ *
+ * <h2>Description</h2>
+ * Records are rewritten until several garbage collections happened, the
+ * latency distribution of all the writes and of the writes triggering a
+ * garbage collection is measured.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.2.1] The flash is erased and MFS is started.
+ * - [3.2.2] Records are written measuring each write.
+ * .
+ */
+
+static void mfs_test_003_002_setup(void) {
+  mfsObjectInit(&mfs1);
+  memset(mfs_buffer, 0x55, sizeof mfs_buffer);
+}
+
+static void mfs_test_003_002_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_003_002_execute(void) {
+
+  /* [3.2.1] The flash is erased and MFS is started.*/
+  test_set_step(1);
+  {
+    mfs_error_t err;
+
+    test_assert(bank_erase(MFS_BANK_0) == FLASH_NO_ERROR, "Bank 0 erase failure");
+    test_assert(bank_erase(MFS_BANK_1) == FLASH_NO_ERROR, "Bank 1 erase failure");
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "initialization error");
+  }
+
+  /* [3.2.2] Records are written measuring each write.*/
+  test_set_step(2);
+  {
+    uint32_t start = mfs1.current_counter;
+    mfs_id_t id = 1U;
+
+#if CH_CFG_USE_TM_HISTOGRAM
+    chTMObjectInitHistogram(&bench_tm, &bench_histogram);
+#else
+    chTMObjectInit(&bench_tm);
+#endif
+    chTMObjectInit(&bench_gc_tm);
+    while (mfs1.current_counter - start < BENCH_GC_CYCLES) {
+      uint32_t counter = mfs1.current_counter;
+      mfs_error_t err;
+
+      /* The GC measurement is only stopped if a collection happened.*/
+      chTMStartMeasurementX(&bench_gc_tm);
+      chTMStartMeasurementX(&bench_tm);
+      err = bench_write(id, BENCH_RECORD_SIZE);
+      chTMStopMeasurementX(&bench_tm);
+      if (mfs1.current_counter != counter) {
+        chTMStopMeasurementX(&bench_gc_tm);
+      }
+      test_assert(err == MFS_NO_ERROR, "error writing record");
+      id = (mfs_id_t)((id % BENCH_RECORDS) + 1U);
+    }
+    bench_print_tm("write", &bench_tm);
+    bench_print_tm("gc", &bench_gc_tm);
+  }
+}
+
+static const testcase_t mfs_test_003_002 = {
+  "Write latency",
+  mfs_test_003_002_setup,
+  mfs_test_003_002_teardown,
+  mfs_test_003_002_execute
+};
+
+/**
+ * @page mfs_test_003_003 [3.3] Read throughput
+ *
+ * <h2>Description</h2>
+ * A record is read repeatedly for a fixed time window, the throughput is
+ * measured for records of 16, 64 and 256 bytes.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.3.1] The flash is erased and MFS is started.
+ * - [3.3.2] The read throughput is measured for each record size.
+ * .
+ */
+
+static void mfs_test_003_003_setup(void) {
+  mfsObjectInit(&mfs1);
+  memset(mfs_buffer, 0x55, sizeof mfs_buffer);
+}
+
+static void mfs_test_003_003_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_003_003_execute(void) {
+
+  /* [3.3.1] The flash is erased and MFS is started.*/
+  test_set_step(1);
+  {
+    mfs_error_t err;
+
+    test_assert(bank_erase(MFS_BANK_0) == FLASH_NO_ERROR, "Bank 0 erase failure");
+    test_assert(bank_erase(MFS_BANK_1) == FLASH_NO_ERROR, "Bank 1 erase failure");
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "initialization error");
+  }
+
+  /* [3.3.2] The read throughput is measured for each record size.*/
+  test_set_step(2);
+  {
+    static const char *names[] = {"read.16", "read.64", "read.256"};
+    size_t n;
+    unsigned i;
+
+    for (i = 0U, n = 16U; n <= 256U; i++, n *= 4U) {
+      systime_t start, end;
+      uint32_t bytes = 0U, bps;
+      mfs_error_t err;
+
+      err = bench_write((mfs_id_t)(i + 1U), n);
+      test_assert(err == MFS_NO_ERROR, "error writing record");
+
+      osalThreadSleep((sysinterval_t)1);
+      start = osalOsGetSystemTimeX();
+      end = osalTimeAddX(start, BENCH_READ_WINDOW);
+      do {
+        size_t size = sizeof mfs_buffer;
+
+        err = mfsReadRecord(&mfs1, (mfs_id_t)(i + 1U), &size, mfs_buffer);
+        test_assert(err == MFS_NO_ERROR, "error reading record");
+        test_assert(size == n, "unexpected record size");
+        bytes += (uint32_t)n;
+      } while (osalTimeIsInRangeX(osalOsGetSystemTimeX(), start, end));
+      bps = (uint32_t)(((uint64_t)bytes * (uint64_t)OSAL_ST_FREQUENCY) /
+                       (uint64_t)osalTimeDiffX(start, osalOsGetSystemTimeX()));
+
+      test_print("--- Score : ");
+      test_print(names[i]);
+      test_print(" ");
+      test_printn(bps);
+      test_println(" B/S");
+      bench_record(names[i], "", bps, "B/S");
+    }
+  }
+}
+
+static const testcase_t mfs_test_003_003 = {
+  "Read throughput",
+  mfs_test_003_003_setup,
+  mfs_test_003_003_teardown,
+  mfs_test_003_003_execute
+};
+
+/**
+ * @page mfs_test_003_004 [3.4] Write amplification
+ *
+ * <h2>Description</h2>
+ * Records of 16, 64 and 256 bytes are rewritten until several garbage
+ * collections happened, the number of erased sectors per 1000 logical
+ * writes is reported.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.4.1] The number of erased sectors is measured for each record
+ *   size.
+ * .
+ */
+
+static void mfs_test_003_004_setup(void) {
+  mfsObjectInit(&mfs1);
+  memset(mfs_buffer, 0x55, sizeof mfs_buffer);
+}
+
+static void mfs_test_003_004_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_003_004_execute(void) {
+
+  /* [3.4.1] The number of erased sectors is measured for each record
+     size.*/
+  test_set_step(1);
+  {
+    static const char *names[] = {"wamp.16", "wamp.64", "wamp.256"};
+    size_t n;
+    unsigned i;
+
+    for (i = 0U, n = 16U; n <= 256U; i++, n *= 4U) {
+      uint32_t start, writes = 0U, erases;
+      mfs_id_t id = 1U;
+      mfs_error_t err;
+
+      test_assert(bank_erase(MFS_BANK_0) == FLASH_NO_ERROR, "Bank 0 erase failure");
+      test_assert(bank_erase(MFS_BANK_1) == FLASH_NO_ERROR, "Bank 1 erase failure");
+      err = mfsStart(&mfs1, &mfscfg1);
+      test_assert(err == MFS_NO_ERROR, "initialization error");
+
+      start = mfs1.current_counter;
+      while (mfs1.current_counter - start < BENCH_GC_CYCLES) {
+        err = bench_write(id, n);
+        test_assert(err == MFS_NO_ERROR, "error writing record");
+        id = (mfs_id_t)((id % BENCH_RECORDS) + 1U);
+        writes++;
+      }
+
+      /* Each collection erases the sectors of the previous bank.*/
+      erases = (mfs1.current_counter - start) * (uint32_t)mfscfg1.bank0_sectors;
+      erases = (erases * 1000U) / writes;
+
+      test_print("--- Score : ");
+      test_print(names[i]);
+      test_print(" ");
+      test_printn(erases);
+      test_println(" erases per 1000 writes");
+      bench_record(names[i], "", erases, "erases/Kwr");
+      mfsStop(&mfs1);
+    }
+  }
+}
+
+static const testcase_t mfs_test_003_004 = {
+  "Write amplification",
+  mfs_test_003_004_setup,
+  mfs_test_003_004_teardown,
+  mfs_test_003_004_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const mfs_test_sequence_003_array[] = {
+  &mfs_test_003_001,
+  &mfs_test_003_002,
+  &mfs_test_003_003,
+  &mfs_test_003_004,
+  NULL
+};
+
+/**
+ * @brief   Benchmarks.
+ */
+const testsequence_t mfs_test_sequence_003 = {
+  "Benchmarks",
+  mfs_test_sequence_003_array
+};
+
+#endif /* CH_CFG_USE_TM */
@@ -20,6 +20,8 @@
  * - @subpage nasa_osal_test_002_002
  * - @subpage nasa_osal_test_002_003
  * - @subpage nasa_osal_test_002_004
+ * - @subpage nasa_osal_test_002_005
+ * - @subpage nasa_osal_test_002_006
  * .
  */
 
@@ -368,6 +370,181 @@ static const testcase_t nasa_osal_test_002_004 = {
   nasa_osal_test_002_004_execute
 };
 
+/**
+ * @page nasa_osal_test_002_005 [2.5] OS_QueueAllocPtr(), OS_QueuePutPtr(), OS_QueueGetPtrs() and OS_QueueReleasePtr() functionality
+ *
+ * <h2>Description</h2>
+ * Messages are exchanged using the zero-copy queue extensions.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.5.1] Filling the queue in place using OS_QueueAllocPtr() and
+ *   OS_QueuePutPtr().
+ * - [2.5.2] Allocation from a full queue, an error is expected.
+ * - [2.5.3] Retrieving all the messages using OS_QueueGetPtrs() then
+ *   releasing them using OS_QueueReleasePtr().
+ * - [2.5.4] Get operation using OS_QueueGetPtr() in non-blocking mode,
+ *   an error is expected.
+ * .
+ */
+
+static void nasa_osal_test_002_005_setup(void) {
+  qid = 0;
+  (void) OS_QueueCreate(&qid, "test queue", 4, MESSAGE_SIZE, 0);
+}
+
+static void nasa_osal_test_002_005_teardown(void) {
+  if (qid != 0) {
+    OS_QueueDelete(qid);
+  }
+}
+
+static void nasa_osal_test_002_005_execute(void) {
+  unsigned i;
+  void *p;
+
+  /* [2.5.1] Filling the queue in place using OS_QueueAllocPtr() and
+     OS_QueuePutPtr().*/
+  test_set_step(1);
+  {
+    for (i = 0; i < 4; i++) {
+      int32 err;
+
+      err = OS_QueueAllocPtr(qid, &p, OS_CHECK);
+      test_assert(err == OS_SUCCESS, "allocation failed");
+      strcpy(p, "Hello World");
+
+      err = OS_QueuePutPtr(qid, p, 12);
+      test_assert(err == OS_SUCCESS, "put failed");
+    }
+  }
+
+  /* [2.5.2] Allocation from a full queue, an error is expected.*/
+  test_set_step(2);
+  {
+    int32 err;
+
+    err = OS_QueueAllocPtr(qid, &p, OS_CHECK);
+    test_assert(err == OS_QUEUE_FULL, "unexpected error code");
+  }
+
+  /* [2.5.3] Retrieving all the messages using OS_QueueGetPtrs() then
+     releasing them using OS_QueueReleasePtr().*/
+  test_set_step(3);
+  {
+    int32 err;
+    void *ptrs[8];
+    uint32 sizes[8], count;
+
+    err = OS_QueueGetPtrs(qid, ptrs, sizes, 8, &count, OS_CHECK);
+    test_assert(err == OS_SUCCESS, "get failed");
+    test_assert(count == 4, "wrong messages count");
+
+    for (i = 0; i < count; i++) {
+      test_assert(sizes[i] == 12, "wrong message size");
+      test_assert(strcmp(ptrs[i], "Hello World") == 0, "wrong message");
+
+      err = OS_QueueReleasePtr(qid, ptrs[i]);
+      test_assert(err == OS_SUCCESS, "release failed");
+    }
+  }
+
+  /* [2.5.4] Get operation using OS_QueueGetPtr() in non-blocking mode,
+     an error is expected.*/
+  test_set_step(4);
+  {
+    int32 err;
+    uint32 copied;
+
+    err = OS_QueueGetPtr(qid, &p, &copied, OS_CHECK);
+    test_assert(err == OS_QUEUE_EMPTY, "unexpected error code");
+  }
+}
+
+static const testcase_t nasa_osal_test_002_005 = {
+  "OS_QueueAllocPtr(), OS_QueuePutPtr(), OS_QueueGetPtrs() and OS_QueueReleasePtr() functionality",
+  nasa_osal_test_002_005_setup,
+  nasa_osal_test_002_005_teardown,
+  nasa_osal_test_002_005_execute
+};
+
+/**
+ * @page nasa_osal_test_002_006 [2.6] Queues throughput
+ *
+ * <h2>Description</h2>
+ * Messages are put and retrieved back for one second, the number of
+ * messages exchanged per second is printed.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.6.1] Exchanging messages using OS_QueuePut() and OS_QueueGet().
+ * - [2.6.2] Exchanging messages using the zero-copy extensions.
+ * .
+ */
+
+static void nasa_osal_test_002_006_setup(void) {
+  qid = 0;
+  (void) OS_QueueCreate(&qid, "test queue", 4, MESSAGE_SIZE, 0);
+}
+
+static void nasa_osal_test_002_006_teardown(void) {
+  if (qid != 0) {
+    OS_QueueDelete(qid);
+  }
+}
+
+static void nasa_osal_test_002_006_execute(void) {
+  uint32 n;
+  systime_t start, end;
+
+  /* [2.6.1] Exchanging messages using OS_QueuePut() and
+     OS_QueueGet().*/
+  test_set_step(1);
+  {
+    char data[MESSAGE_SIZE];
+    uint32 copied;
+
+    n = 0;
+    start = chVTGetSystemTimeX();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      (void) OS_QueuePut(qid, "Hello World", 12, 0);
+      (void) OS_QueueGet(qid, data, MESSAGE_SIZE, &copied, OS_CHECK);
+      n++;
+    } while (chVTIsSystemTimeWithinX(start, end));
+
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" msgs/S");
+  }
+
+  /* [2.6.2] Exchanging messages using the zero-copy extensions.*/
+  test_set_step(2);
+  {
+    void *p;
+    uint32 copied;
+
+    n = 0;
+    start = chVTGetSystemTimeX();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      (void) OS_QueueAllocPtr(qid, &p, OS_CHECK);
+      (void) OS_QueuePutPtr(qid, p, 12);
+      (void) OS_QueueGetPtr(qid, &p, &copied, OS_CHECK);
+      (void) OS_QueueReleasePtr(qid, p);
+      n++;
+    } while (chVTIsSystemTimeWithinX(start, end));
+
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" msgs/S");
+  }
+}
+
+static const testcase_t nasa_osal_test_002_006 = {
+  "Queues throughput",
+  nasa_osal_test_002_006_setup,
+  nasa_osal_test_002_006_teardown,
+  nasa_osal_test_002_006_execute
+};
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -380,6 +557,8 @@ const testcase_t * const nasa_osal_test_sequence_002_array[] = {
   &nasa_osal_test_002_002,
   &nasa_osal_test_002_003,
   &nasa_osal_test_002_004,
+  &nasa_osal_test_002_005,
+  &nasa_osal_test_002_006,
   NULL
 };
 
@@ -3,7 +3,9 @@ TESTSRC += ${CHIBIOS}/test/nil/source/test/nil_test_root.c \
            ${CHIBIOS}/test/nil/source/test/nil_test_sequence_001.c \
            ${CHIBIOS}/test/nil/source/test/nil_test_sequence_002.c \
            ${CHIBIOS}/test/nil/source/test/nil_test_sequence_003.c \
-           ${CHIBIOS}/test/nil/source/test/nil_test_sequence_004.c
+           ${CHIBIOS}/test/nil/source/test/nil_test_sequence_004.c \
+           ${CHIBIOS}/test/nil/source/test/nil_test_sequence_005.c \
+           ${CHIBIOS}/test/nil/source/test/nil_test_sequence_006.c
 
 # Required include directories
 TESTINC += ${CHIBIOS}/test/nil/source/test
@@ -25,6 +25,8 @@
  * - @subpage nil_test_sequence_002
  * - @subpage nil_test_sequence_003
  * - @subpage nil_test_sequence_004
+ * - @subpage nil_test_sequence_005
+ * - @subpage nil_test_sequence_006
  * .
  */
 
@@ -52,6 +54,12 @@ const testsequence_t * const nil_test_suite_array[] = {
   &nil_test_sequence_003,
 #endif
   &nil_test_sequence_004,
+#if (CH_CFG_NUM_TASKS > 0) || defined(__DOXYGEN__)
+  &nil_test_sequence_005,
+#endif
+#if (CH_CFG_USE_MAILBOXES) || defined(__DOXYGEN__)
+  &nil_test_sequence_006,
+#endif
   NULL
 };
 
@@ -69,9 +77,14 @@ const testsuite_t nil_test_suite = {
 
 semaphore_t gsem1, gsem2;
 thread_reference_t gtr1;
+#if CH_CFG_USE_MAILBOXES == TRUE
+mailbox_t gmb1;
+static msg_t gmb1_buffer[4];
+#endif
 
 /*
- * Support thread.
+ * Support thread, when mailboxes are enabled it also consumes the
+ * messages posted into gmb1 while waiting for the next period.
  */
 THD_WORKING_AREA(wa_test_support, 128);
 THD_FUNCTION(test_support, arg) {
@@ -84,6 +97,9 @@ THD_FUNCTION(test_support, arg) {
   /* Initializing global resources.*/
   chSemObjectInit(&gsem1, 0);
   chSemObjectInit(&gsem2, 0);
+#if CH_CFG_USE_MAILBOXES == TRUE
+  chMBObjectInit(&gmb1, gmb1_buffer, 4);
+#endif
 
   while (true) {
     chSysLock();
@@ -97,8 +113,38 @@ THD_FUNCTION(test_support, arg) {
     chSchRescheduleS();
     chSysUnlock();
 
+#if CH_CFG_USE_MAILBOXES == TRUE
+    {
+      systime_t start = chVTGetSystemTimeX();
+      sysinterval_t elapsed;
+      msg_t msg;
+
+      while ((elapsed = chVTTimeElapsedSinceX(start)) < TIME_MS2I(250)) {
+        (void)chMBFetchTimeout(&gmb1, &msg, TIME_MS2I(250) - elapsed);
+      }
+    }
+#else
     chThdSleepMilliseconds(250);
+#endif
   }
 }
 
+#if CH_CFG_NUM_TASKS > 0
+eventmask_t gtskevents;
+
+/*
+ * Tasks dispatcher working area.
+ */
+THD_WORKING_AREA(wa_test_dispatcher, 128);
+
+/*
+ * Test task, the argument is the token to be emitted.
+ */
+TASK_FUNCTION(test_task, arg, events) {
+
+  gtskevents |= events;
+  test_emit_token((char)(uintptr_t)arg);
+}
+#endif
+
 #endif /* !defined(__DOXYGEN__) */
@@ -28,6 +28,8 @@
 #include "nil_test_sequence_002.h"
 #include "nil_test_sequence_003.h"
 #include "nil_test_sequence_004.h"
+#include "nil_test_sequence_005.h"
+#include "nil_test_sequence_006.h"
 
 #if !defined(__DOXYGEN__)
 
@@ -52,11 +54,21 @@ extern "C" {
 
 extern semaphore_t gsem1, gsem2;
 extern thread_reference_t gtr1;
+#if CH_CFG_USE_MAILBOXES == TRUE
+extern mailbox_t gmb1;
+#endif
 extern THD_WORKING_AREA(wa_test_support, 128);
 
 void test_print_port_info(void);
 THD_FUNCTION(test_support, arg);
 
+#if CH_CFG_NUM_TASKS > 0
+extern eventmask_t gtskevents;
+extern THD_WORKING_AREA(wa_test_dispatcher, 128);
+
+TASK_FUNCTION(test_task, arg, events);
+#endif
+
 #endif /* !defined(__DOXYGEN__) */
 
 #endif /* NIL_TEST_ROOT_H */
@@ -163,6 +163,9 @@ static void nil_test_001_003_execute(void) {
     test_print("--- CH_CFG_NUM_THREADS:                 ");
     test_printn(CH_CFG_NUM_THREADS);
     test_println("");
+    test_print("--- CH_CFG_NUM_TASKS:                   ");
+    test_printn(CH_CFG_NUM_TASKS);
+    test_println("");
     test_print("--- CH_CFG_ST_RESOLUTION:               ");
     test_printn(CH_CFG_ST_RESOLUTION);
     test_println("");
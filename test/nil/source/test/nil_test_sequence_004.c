@@ -32,6 +32,7 @@
  * <h2>Test Cases</h2>
  * - @subpage nil_test_004_001
  * - @subpage nil_test_004_002
+ * - @subpage nil_test_004_003
  * .
  */
 
@@ -182,6 +183,66 @@ static const testcase_t nil_test_004_002 = {
 };
 #endif /* CH_CFG_USE_EVENTS */
 
+#if (CH_CFG_USE_EVENTS) || defined(__DOXYGEN__)
+/**
+ * @page nil_test_004_003 [4.3] Events Listeners functionality
+ *
+ * <h2>Description</h2>
+ * Event listeners functionality is tested.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_EVENTS
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [4.3.1] The current thread is registered on a listener then the
+ *   listener is signaled, the function chEvtWaitAnyTimeout() must
+ *   return the registered mask.
+ * - [4.3.2] The current thread is unregistered then the listener is
+ *   signaled, no event must be pending.
+ * .
+ */
+
+static void nil_test_004_003_execute(void) {
+  event_listener_t el;
+  eventmask_t events;
+
+  /* [4.3.1] The current thread is registered on a listener then the
+     listener is signaled, the function chEvtWaitAnyTimeout() must
+     return the registered mask.*/
+  test_set_step(1);
+  {
+    chEvtListenerObjectInit(&el);
+    chThdGetSelfX()->epmask = 0;
+    chEvtListenerRegister(&el, 0x10);
+    test_assert(chEvtListenerIsRegisteredI(&el), "not listening");
+    chEvtListenerSignal(&el);
+    events = chEvtWaitAnyTimeout(ALL_EVENTS, TIME_IMMEDIATE);
+    test_assert((eventmask_t)0x10 == events, "wrong events mask");
+  }
+
+  /* [4.3.2] The current thread is unregistered then the listener is
+     signaled, no event must be pending.*/
+  test_set_step(2);
+  {
+    chEvtListenerUnregister(&el);
+    test_assert(!chEvtListenerIsRegisteredI(&el), "still listening");
+    chEvtListenerSignal(&el);
+    events = chEvtWaitAnyTimeout(ALL_EVENTS, TIME_IMMEDIATE);
+    test_assert((eventmask_t)0 == events, "unexpected events");
+  }
+}
+
+static const testcase_t nil_test_004_003 = {
+  "Events Listeners functionality",
+  NULL,
+  NULL,
+  nil_test_004_003_execute
+};
+#endif /* CH_CFG_USE_EVENTS */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -193,6 +254,9 @@ const testcase_t * const nil_test_sequence_004_array[] = {
   &nil_test_004_001,
 #if (CH_CFG_USE_EVENTS) || defined(__DOXYGEN__)
   &nil_test_004_002,
+#endif
+#if (CH_CFG_USE_EVENTS) || defined(__DOXYGEN__)
+  &nil_test_004_003,
 #endif
   NULL
 };
@@ -0,0 +1,190 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "nil_test_root.h"
+
+/**
+ * @file    nil_test_sequence_005.c
+ * @brief   Test Sequence 005 code.
+ *
+ * @page nil_test_sequence_005 [5] Run-to-completion Tasks
+ *
+ * File: @ref nil_test_sequence_005.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the ChibiOS/NIL functionalities related to
+ * run-to-completion tasks. The test application must define two tasks
+ * running test_task() with arguments 'A' and 'B' and a dispatcher
+ * thread with priority higher than the tester thread.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_NUM_TASKS > 0
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage nil_test_005_001
+ * - @subpage nil_test_005_002
+ * .
+ */
+
+#if (CH_CFG_NUM_TASKS > 0) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page nil_test_005_001 [5.1] Tasks posting and priority
+ *
+ * <h2>Description</h2>
+ * Tasks are posted and the execution order is tested.
+ *
+ * <h2>Test Steps</h2>
+ * - [5.1.1] Both tasks are posted in reverse order from within a
+ *   critical zone, the tasks must be executed in priority order.
+ * - [5.1.2] The first task is posted twice, the task must be executed
+ *   once for each post.
+ * - [5.1.3] The second task is posted using the API function, the task
+ *   must be executed immediately.
+ * .
+ */
+
+static void nil_test_005_001_execute(void) {
+
+  /* [5.1.1] Both tasks are posted in reverse order from within a
+     critical zone, the tasks must be executed in priority order.*/
+  test_set_step(1);
+  {
+    chSysLock();
+    chTaskPostI(&nil.tasks[1]);
+    chTaskPostI(&nil.tasks[0]);
+    chSchRescheduleS();
+    chSysUnlock();
+    test_assert_sequence("AB", "invalid sequence");
+  }
+
+  /* [5.1.2] The first task is posted twice, the task must be executed
+     once for each post.*/
+  test_set_step(2);
+  {
+    chSysLock();
+    chTaskPostI(&nil.tasks[1]);
+    chTaskPostI(&nil.tasks[0]);
+    chTaskPostI(&nil.tasks[0]);
+    chSchRescheduleS();
+    chSysUnlock();
+    test_assert_sequence("AAB", "invalid sequence");
+  }
+
+  /* [5.1.3] The second task is posted using the API function, the task
+     must be executed immediately.*/
+  test_set_step(3);
+  {
+    chTaskPost(&nil.tasks[1]);
+    test_assert_sequence("B", "invalid sequence");
+  }
+}
+
+static const testcase_t nil_test_005_001 = {
+  "Tasks posting and priority",
+  NULL,
+  NULL,
+  nil_test_005_001_execute
+};
+
+/**
+ * @page nil_test_005_002 [5.2] Tasks events
+ *
+ * <h2>Description</h2>
+ * Events are signaled to a task and the events passed to the task
+ * function are tested.
+ *
+ * <h2>Test Steps</h2>
+ * - [5.2.1] Two events are signaled to the first task from within a
+ *   critical zone, the task must be executed once with both events.
+ * - [5.2.2] An empty events mask is signaled, the task must not be
+ *   executed, then a single event is signaled using the API function.
+ * .
+ */
+
+static void nil_test_005_002_setup(void) {
+  gtskevents = (eventmask_t)0;
+}
+
+static void nil_test_005_002_execute(void) {
+
+  /* [5.2.1] Two events are signaled to the first task from within a
+     critical zone, the task must be executed once with both events.*/
+  test_set_step(1);
+  {
+    chSysLock();
+    chTaskSignalI(&nil.tasks[0], 0x01);
+    chTaskSignalI(&nil.tasks[0], 0x04);
+    chSchRescheduleS();
+    chSysUnlock();
+    test_assert_sequence("A", "invalid sequence");
+    test_assert((eventmask_t)0x05 == gtskevents, "wrong events mask");
+  }
+
+  /* [5.2.2] An empty events mask is signaled, the task must not be
+     executed, then a single event is signaled using the API function.*/
+  test_set_step(2);
+  {
+    gtskevents = (eventmask_t)0;
+    chTaskSignal(&nil.tasks[0], (eventmask_t)0);
+    test_assert_sequence("", "invalid sequence");
+    chTaskSignal(&nil.tasks[0], 0x10);
+    test_assert_sequence("A", "invalid sequence");
+    test_assert((eventmask_t)0x10 == gtskevents, "wrong events mask");
+  }
+}
+
+static const testcase_t nil_test_005_002 = {
+  "Tasks events",
+  nil_test_005_002_setup,
+  NULL,
+  nil_test_005_002_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const nil_test_sequence_005_array[] = {
+  &nil_test_005_001,
+  &nil_test_005_002,
+  NULL
+};
+
+/**
+ * @brief   Run-to-completion Tasks.
+ */
+const testsequence_t nil_test_sequence_005 = {
+  "Run-to-completion Tasks",
+  nil_test_sequence_005_array
+};
+
+#endif /* CH_CFG_NUM_TASKS > 0 */
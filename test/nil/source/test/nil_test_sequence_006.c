@@ -0,0 +1,132 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "nil_test_root.h"
+
+/**
+ * @file    nil_test_sequence_006.c
+ * @brief   Test Sequence 006 code.
+ *
+ * @page nil_test_sequence_006 [6] Benchmarks
+ *
+ * File: @ref nil_test_sequence_006.c
+ *
+ * <h2>Description</h2>
+ * This module implements a series of system benchmarks. The scores are
+ * measured the same way as in the ChibiOS/RT benchmarks sequence in
+ * order to allow a direct comparison between the two kernels.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MAILBOXES
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage nil_test_006_001
+ * .
+ */
+
+#if (CH_CFG_USE_MAILBOXES) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page nil_test_006_001 [6.1] Mailboxes post/fetch performance
+ *
+ * <h2>Description</h2>
+ * The support thread has a higher priority than the tester thread and
+ * is blocked fetching from the gmb1 mailbox, each post wakes the
+ * support thread which fetches the message and blocks again. The
+ * messages throughput per second is measured and the result printed
+ * on the output log.
+ *
+ * <h2>Test Steps</h2>
+ * - [6.1.1] Messages are posted in a one second time window, each post
+ *   wakes the blocked support thread.
+ * - [6.1.2] Score is printed.
+ * .
+ */
+
+static void nil_test_006_001_execute(void) {
+  uint32_t n;
+
+  /* [6.1.1] Messages are posted in a one second time window, each post
+     wakes the blocked support thread.*/
+  test_set_step(1);
+  {
+    systime_t start;
+
+    n = 0;
+    chThdSleep(1);
+    start = chVTGetSystemTimeX();
+    do {
+      (void)chMBPostTimeout(&gmb1, (msg_t)1, TIME_INFINITE);
+      n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTTimeElapsedSinceX(start) < TIME_MS2I(1000));
+  }
+
+  /* [6.1.2] Score is printed.*/
+  test_set_step(2);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_print(" msgs/S, ");
+    test_printn(n << 1);
+    test_println(" ctxswc/S");
+    test_emit_record("msgs", n, "msgs/S");
+    test_emit_record("ctxswc", n << 1, "ctxswc/S");
+  }
+}
+
+static const testcase_t nil_test_006_001 = {
+  "Mailboxes post/fetch performance",
+  NULL,
+  NULL,
+  nil_test_006_001_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const nil_test_sequence_006_array[] = {
+  &nil_test_006_001,
+  NULL
+};
+
+/**
+ * @brief   Benchmarks.
+ */
+const testsequence_t nil_test_sequence_006 = {
+  "Benchmarks",
+  nil_test_sequence_006_array
+};
+
+#endif /* CH_CFG_USE_MAILBOXES */
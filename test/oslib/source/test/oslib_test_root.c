@@ -26,6 +26,10 @@
  * - @subpage oslib_test_sequence_003
  * - @subpage oslib_test_sequence_004
  * - @subpage oslib_test_sequence_005
+ * - @subpage oslib_test_sequence_006
+ * - @subpage oslib_test_sequence_007
+ * - @subpage oslib_test_sequence_008
+ * - @subpage oslib_test_sequence_009
  * .
  */
 
@@ -61,6 +65,18 @@ const testsequence_t * const oslib_test_suite_array[] = {
 #endif
 #if ((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) || defined(__DOXYGEN__)
   &oslib_test_sequence_005,
+#endif
+#if (CH_CFG_USE_RING_BUFFERS) || defined(__DOXYGEN__)
+  &oslib_test_sequence_006,
+#endif
+#if (CH_CFG_USE_OBJ_PFIFOS) || defined(__DOXYGEN__)
+  &oslib_test_sequence_007,
+#endif
+#if (CH_CFG_USE_TOPICS) || defined(__DOXYGEN__)
+  &oslib_test_sequence_008,
+#endif
+#if (CH_CFG_USE_WATCHDOG) || defined(__DOXYGEN__)
+  &oslib_test_sequence_009,
 #endif
   NULL
 };
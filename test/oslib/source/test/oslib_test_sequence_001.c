@@ -39,6 +39,7 @@
  * - @subpage oslib_test_001_001
  * - @subpage oslib_test_001_002
  * - @subpage oslib_test_001_003
+ * - @subpage oslib_test_001_004
  * .
  */
 
@@ -391,6 +392,99 @@ static const testcase_t oslib_test_001_003 = {
   oslib_test_001_003_execute
 };
 
+/**
+ * @page oslib_test_001_004 [1.4] Mailbox array API, non-blocking tests
+ *
+ * <h2>Description</h2>
+ * The mailbox array API is tested without triggering blocking
+ * conditions.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.4.1] Posting more messages than the mailbox size, only the free
+ *   slots must be filled.
+ * - [1.4.2] Fetching all the messages using chMBFetchArrayTimeout(), the
+ *   order must be preserved.
+ * - [1.4.3] Posting and fetching across the buffer boundary using the
+ *   I-Class functions, the order must be preserved.
+ * - [1.4.4] Testing the behavior in reset state, no messages can be
+ *   transferred.
+ * .
+ */
+
+static void oslib_test_001_004_setup(void) {
+  chMBObjectInit(&mb1, mb_buffer, MB_SIZE);
+}
+
+static void oslib_test_001_004_teardown(void) {
+  chMBReset(&mb1);
+}
+
+static void oslib_test_001_004_execute(void) {
+  static const msg_t pattern[MB_SIZE + 2] = {'A', 'B', 'C', 'D', 'E', 'F'};
+  msg_t msgs[MB_SIZE + 2];
+  size_t n, i;
+
+  /* [1.4.1] Posting more messages than the mailbox size, only the free
+     slots must be filled.*/
+  test_set_step(1);
+  {
+    n = chMBPostArrayTimeout(&mb1, pattern, MB_SIZE + 2, TIME_IMMEDIATE);
+    test_assert(n == MB_SIZE, "wrong number of posted messages");
+    chSysLock();
+    n = chMBPostArrayI(&mb1, pattern, 1);
+    chSysUnlock();
+    test_assert(n == 0U, "full mailbox accepted messages");
+  }
+
+  /* [1.4.2] Fetching all the messages using chMBFetchArrayTimeout(), the
+     order must be preserved.*/
+  test_set_step(2);
+  {
+    n = chMBFetchArrayTimeout(&mb1, msgs, MB_SIZE + 2, TIME_IMMEDIATE);
+    test_assert(n == MB_SIZE, "wrong number of fetched messages");
+    for (i = 0U; i < MB_SIZE; i++) {
+      test_assert(msgs[i] == pattern[i], "wrong message");
+    }
+    test_assert_lock(chMBGetUsedCountI(&mb1) == 0, "still full");
+  }
+
+  /* [1.4.3] Posting and fetching across the buffer boundary using the
+     I-Class functions, the order must be preserved.*/
+  test_set_step(3);
+  {
+    chSysLock();
+    n = chMBPostArrayI(&mb1, pattern, 3);
+    chSysUnlock();
+    test_assert(n == 3U, "wrong number of posted messages");
+    chSysLock();
+    n = chMBFetchArrayI(&mb1, msgs, MB_SIZE);
+    chSysUnlock();
+    test_assert(n == 3U, "wrong number of fetched messages");
+    for (i = 0U; i < 3U; i++) {
+      test_assert(msgs[i] == pattern[i], "wrong message");
+    }
+  }
+
+  /* [1.4.4] Testing the behavior in reset state, no messages can be
+     transferred.*/
+  test_set_step(4);
+  {
+    chMBReset(&mb1);
+    n = chMBPostArrayTimeout(&mb1, pattern, 1, TIME_IMMEDIATE);
+    test_assert(n == 0U, "posted in reset state");
+    n = chMBFetchArrayTimeout(&mb1, msgs, 1, TIME_IMMEDIATE);
+    test_assert(n == 0U, "fetched in reset state");
+    chMBResumeX(&mb1);
+  }
+}
+
+static const testcase_t oslib_test_001_004 = {
+  "Mailbox array API, non-blocking tests",
+  oslib_test_001_004_setup,
+  oslib_test_001_004_teardown,
+  oslib_test_001_004_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -402,6 +496,7 @@ const testcase_t * const oslib_test_sequence_001_array[] = {
   &oslib_test_001_001,
   &oslib_test_001_002,
   &oslib_test_001_003,
+  &oslib_test_001_004,
   NULL
 };
 
@@ -38,6 +38,7 @@
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_002_001
  * - @subpage oslib_test_002_002
+ * - @subpage oslib_test_002_003
  * .
  */
 
@@ -340,6 +341,131 @@ static const testcase_t oslib_test_002_002 = {
   oslib_test_002_002_execute
 };
 
+/**
+ * @page oslib_test_002_003 [2.3] Pipes zero-copy API
+ *
+ * <h2>Description</h2>
+ * The zero-copy reserve/commit and peek/release API is tested, including
+ * the behavior at the buffer wrap boundary.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.3.1] Reserving the whole buffer, filling it in place and
+ *   committing.
+ * - [2.3.2] Peeking the whole buffer, checking the content and
+ *   releasing.
+ * - [2.3.3] Moving the pointers close to the buffer end then checking
+ *   that reserved and peeked regions are limited by the wrap boundary.
+ * - [2.3.4] Peeking an empty pipe and reserving space in a full pipe,
+ *   both operations must time out.
+ * .
+ */
+
+static void oslib_test_002_003_setup(void) {
+  chPipeObjectInit(&pipe1, buffer, PIPE_SIZE);
+}
+
+static void oslib_test_002_003_execute(void) {
+
+  /* [2.3.1] Reserving the whole buffer, filling it in place and
+     committing.*/
+  test_set_step(1);
+  {
+    size_t n;
+    uint8_t *wp;
+
+    n = chPipeWriteReserve(&pipe1, &wp, PIPE_SIZE, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE, "wrong size");
+    test_assert(wp == pipe1.buffer, "wrong pointer");
+    memcpy(wp, pipe_pattern, n);
+    chPipeWriteCommit(&pipe1, n);
+    test_assert((pipe1.rdptr == pipe1.buffer) &&
+                (pipe1.wrptr == pipe1.buffer) &&
+                (pipe1.cnt == PIPE_SIZE),
+                "invalid pipe state");
+  }
+
+  /* [2.3.2] Peeking the whole buffer, checking the content and releasing.*/
+  test_set_step(2);
+  {
+    size_t n;
+    const uint8_t *rp;
+
+    n = chPipeReadPeek(&pipe1, &rp, PIPE_SIZE, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE, "wrong size");
+    test_assert(memcmp(pipe_pattern, rp, n) == 0, "content mismatch");
+    chPipeReadRelease(&pipe1, n);
+    test_assert((pipe1.rdptr == pipe1.buffer) &&
+                (pipe1.wrptr == pipe1.buffer) &&
+                (pipe1.cnt == 0),
+                "invalid pipe state");
+  }
+
+  /* [2.3.3] Moving the pointers close to the buffer end then checking that
+     reserved and peeked regions are limited by the wrap boundary.*/
+  test_set_step(3);
+  {
+    size_t n;
+    uint8_t *wp;
+    const uint8_t *rp;
+    uint8_t buf[PIPE_SIZE];
+
+    n = chPipeWriteTimeout(&pipe1, pipe_pattern, PIPE_SIZE - 4, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE - 4, "wrong size");
+    n = chPipeReadTimeout(&pipe1, buf, PIPE_SIZE - 4, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE - 4, "wrong size");
+
+    n = chPipeWriteReserve(&pipe1, &wp, PIPE_SIZE, TIME_IMMEDIATE);
+    test_assert(n == 4, "wrong size");
+    memcpy(wp, pipe_pattern, n);
+    chPipeWriteCommit(&pipe1, n);
+    test_assert((pipe1.wrptr == pipe1.buffer) &&
+                (pipe1.cnt == 4),
+                "invalid pipe state");
+
+    n = chPipeWriteReserve(&pipe1, &wp, PIPE_SIZE, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE - 4, "wrong size");
+    test_assert(wp == pipe1.buffer, "wrong pointer");
+    chPipeWriteCommit(&pipe1, 0);
+
+    n = chPipeReadPeek(&pipe1, &rp, PIPE_SIZE, TIME_IMMEDIATE);
+    test_assert(n == 4, "wrong size");
+    test_assert(memcmp(pipe_pattern, rp, n) == 0, "content mismatch");
+    chPipeReadRelease(&pipe1, n);
+    test_assert((pipe1.rdptr == pipe1.buffer) &&
+                (pipe1.wrptr == pipe1.buffer) &&
+                (pipe1.cnt == 0),
+                "invalid pipe state");
+  }
+
+  /* [2.3.4] Peeking an empty pipe and reserving space in a full pipe, both
+     operations must time out.*/
+  test_set_step(4);
+  {
+    size_t n;
+    uint8_t *wp;
+    const uint8_t *rp;
+
+    n = chPipeReadPeek(&pipe1, &rp, PIPE_SIZE, TIME_IMMEDIATE);
+    test_assert(n == 0, "wrong size");
+
+    n = chPipeWriteTimeout(&pipe1, pipe_pattern, PIPE_SIZE, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE, "wrong size");
+    n = chPipeWriteReserve(&pipe1, &wp, PIPE_SIZE, TIME_IMMEDIATE);
+    test_assert(n == 0, "wrong size");
+    test_assert((pipe1.rdptr == pipe1.buffer) &&
+                (pipe1.wrptr == pipe1.buffer) &&
+                (pipe1.cnt == PIPE_SIZE),
+                "invalid pipe state");
+  }
+}
+
+static const testcase_t oslib_test_002_003 = {
+  "Pipes zero-copy API",
+  oslib_test_002_003_setup,
+  NULL,
+  oslib_test_002_003_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -350,6 +476,7 @@ static const testcase_t oslib_test_002_002 = {
 const testcase_t * const oslib_test_sequence_002_array[] = {
   &oslib_test_002_001,
   &oslib_test_002_002,
+  &oslib_test_002_003,
   NULL
 };
 
@@ -39,6 +39,7 @@
  * - @subpage oslib_test_003_001
  * - @subpage oslib_test_003_002
  * - @subpage oslib_test_003_003
+ * - @subpage oslib_test_003_004
  * .
  */
 
@@ -50,11 +51,11 @@
 
 #define MEMORY_POOL_SIZE 4
 
-static uint32_t objects[MEMORY_POOL_SIZE];
-static MEMORYPOOL_DECL(mp1, sizeof (uint32_t), PORT_NATURAL_ALIGN, NULL);
+static uintptr_t objects[MEMORY_POOL_SIZE];
+static MEMORYPOOL_DECL(mp1, sizeof (uintptr_t), PORT_NATURAL_ALIGN, NULL);
 
 #if CH_CFG_USE_SEMAPHORES
-static GUARDEDMEMORYPOOL_DECL(gmp1, sizeof (uint32_t), PORT_NATURAL_ALIGN);
+static GUARDEDMEMORYPOOL_DECL(gmp1, sizeof (uintptr_t), PORT_NATURAL_ALIGN);
 #endif
 
 static void *null_provider(size_t size, unsigned align) {
@@ -89,7 +90,7 @@ static void *null_provider(size_t size, unsigned align) {
  */
 
 static void oslib_test_003_001_setup(void) {
-  chPoolObjectInit(&mp1, sizeof (uint32_t), NULL);
+  chPoolObjectInit(&mp1, sizeof (uintptr_t), NULL);
 }
 
 static void oslib_test_003_001_execute(void) {
@@ -138,7 +139,7 @@ static void oslib_test_003_001_execute(void) {
      more memory.*/
   test_set_step(7);
   {
-    chPoolObjectInit(&mp1, sizeof (uint32_t), null_provider);
+    chPoolObjectInit(&mp1, sizeof (uintptr_t), null_provider);
     test_assert(chPoolAlloc(&mp1) == NULL, "provider returned memory");
   }
 }
@@ -176,7 +177,7 @@ static const testcase_t oslib_test_003_001 = {
  */
 
 static void oslib_test_003_002_setup(void) {
-  chGuardedPoolObjectInit(&gmp1, sizeof (uint32_t));
+  chGuardedPoolObjectInit(&gmp1, sizeof (uintptr_t));
 }
 
 static void oslib_test_003_002_execute(void) {
@@ -253,7 +254,7 @@ static const testcase_t oslib_test_003_002 = {
  */
 
 static void oslib_test_003_003_setup(void) {
-  chGuardedPoolObjectInit(&gmp1, sizeof (uint32_t));
+  chGuardedPoolObjectInit(&gmp1, sizeof (uintptr_t));
 }
 
 static void oslib_test_003_003_execute(void) {
@@ -274,6 +275,89 @@ static const testcase_t oslib_test_003_003 = {
 };
 #endif /* CH_CFG_USE_SEMAPHORES */
 
+#if (CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_003_004 [3.4] Guarded Memory Pools magazines
+ *
+ * <h2>Description</h2>
+ * A magazine is used over a guarded memory pool, refill and flush
+ * operations are tested.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_SEMAPHORES
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [3.4.1] Adding the objects to the guarded pool and initializing a
+ *   magazine of four objects.
+ * - [3.4.2] Allocating an object, the magazine must be refilled with
+ *   half of its capacity.
+ * - [3.4.3] Allocating another object, the guarded pool must not be
+ *   touched.
+ * - [3.4.4] Releasing the objects and flushing the magazine, all the
+ *   objects must be back in the guarded pool.
+ * .
+ */
+
+static void oslib_test_003_004_setup(void) {
+  chGuardedPoolObjectInit(&gmp1, sizeof (uintptr_t));
+}
+
+static void oslib_test_003_004_execute(void) {
+  pool_magazine_t mg;
+  void *p1, *p2;
+
+  /* [3.4.1] Adding the objects to the guarded pool and initializing a
+     magazine of four objects.*/
+  test_set_step(1);
+  {
+    chGuardedPoolLoadArray(&gmp1, objects, MEMORY_POOL_SIZE);
+    chMagazineObjectInit(&mg, &gmp1, 4);
+  }
+
+  /* [3.4.2] Allocating an object, the magazine must be refilled with half
+     of its capacity.*/
+  test_set_step(2);
+  {
+    p1 = chMagazineAllocTimeout(&mg, TIME_IMMEDIATE);
+    test_assert(p1 != NULL, "allocation failed");
+    test_assert(mg.cnt == 1U, "wrong cached objects");
+    test_assert_lock(chSemGetCounterI(&gmp1.sem) == MEMORY_POOL_SIZE - 2, "wrong pool counter");
+  }
+
+  /* [3.4.3] Allocating another object, the guarded pool must not be
+     touched.*/
+  test_set_step(3);
+  {
+    p2 = chMagazineAllocTimeout(&mg, TIME_IMMEDIATE);
+    test_assert(p2 != NULL, "allocation failed");
+    test_assert(mg.cnt == 0U, "wrong cached objects");
+    test_assert_lock(chSemGetCounterI(&gmp1.sem) == MEMORY_POOL_SIZE - 2, "wrong pool counter");
+  }
+
+  /* [3.4.4] Releasing the objects and flushing the magazine, all the
+     objects must be back in the guarded pool.*/
+  test_set_step(4);
+  {
+    chMagazineFree(&mg, p1);
+    chMagazineFree(&mg, p2);
+    test_assert(mg.cnt == 2U, "wrong cached objects");
+    chMagazineFlush(&mg);
+    test_assert(mg.cnt == 0U, "not flushed");
+    test_assert_lock(chSemGetCounterI(&gmp1.sem) == MEMORY_POOL_SIZE, "wrong pool counter");
+  }
+}
+
+static const testcase_t oslib_test_003_004 = {
+  "Guarded Memory Pools magazines",
+  oslib_test_003_004_setup,
+  NULL,
+  oslib_test_003_004_execute
+};
+#endif /* CH_CFG_USE_SEMAPHORES */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -288,6 +372,9 @@ const testcase_t * const oslib_test_sequence_003_array[] = {
 #endif
 #if (CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
   &oslib_test_003_003,
+#endif
+#if (CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
+  &oslib_test_003_004,
 #endif
   NULL
 };
@@ -38,6 +38,8 @@
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_004_001
  * - @subpage oslib_test_004_002
+ * - @subpage oslib_test_004_003
+ * - @subpage oslib_test_004_004
  * .
  */
 
@@ -48,7 +50,13 @@
  ****************************************************************************/
 
 #define ALLOC_SIZE 16
-#define HEAP_SIZE (ALLOC_SIZE * 8)
+
+/* Space taken by the largest block allocated by the tests, the header
+   plus the rounded up size. It is never smaller than the minimum TLSF
+   block, an header plus an alignment unit.*/
+#define BLOCK_SIZE (sizeof (heap_header_t) +                              \
+                    MEM_ALIGN_NEXT(ALLOC_SIZE + 1, CH_HEAP_ALIGNMENT))
+#define HEAP_SIZE (BLOCK_SIZE * 8U)
 
 static memory_heap_t test_heap;
 static uint8_t test_heap_buffer[HEAP_SIZE];
@@ -256,6 +264,196 @@ static const testcase_t oslib_test_004_002 = {
   oslib_test_004_002_execute
 };
 
+#if (CH_CFG_HEAP_SLAB == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_004_003 [4.3] Default heap slab classes
+ *
+ * <h2>Description</h2>
+ * The slab front-end of the default heap is tested, small blocks must be
+ * served by the slab classes and larger blocks must bypass them.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_HEAP_SLAB == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [4.3.1] Allocating a block of the smallest class size, the
+ *   allocation must be accounted by the class.
+ * - [4.3.2] Allocating again the same size, the freed block must be
+ *   reused from the class pool.
+ * - [4.3.3] Allocating a block larger than the largest class, the slab
+ *   classes must not be involved.
+ * .
+ */
+
+static void oslib_test_004_003_execute(void) {
+  void *p1, *p2;
+  size_t size;
+  ucnt_t hits, misses, h, m;
+
+  /* [4.3.1] Allocating a block of the smallest class size, the allocation
+     must be accounted by the class.*/
+  test_set_step(1);
+  {
+    size = chHeapSlabStatus(0U, &hits, &misses);
+    p1 = chHeapAlloc(NULL, size);
+    test_assert(p1 != NULL, "allocation failed");
+    test_assert(chHeapGetSize(p1) == size, "wrong size");
+    (void)chHeapSlabStatus(0U, &h, &m);
+    test_assert((h + m) == (hits + misses + 1U), "not accounted");
+    chHeapFree(p1);
+  }
+
+  /* [4.3.2] Allocating again the same size, the freed block must be reused
+     from the class pool.*/
+  test_set_step(2);
+  {
+    (void)chHeapSlabStatus(0U, &hits, &misses);
+    p2 = chHeapAlloc(NULL, size);
+    test_assert(p2 == p1, "block not reused");
+    (void)chHeapSlabStatus(0U, &h, &m);
+    test_assert((h == hits + 1U) && (m == misses), "not a hit");
+    chHeapFree(p2);
+  }
+
+  /* [4.3.3] Allocating a block larger than the largest class, the slab
+     classes must not be involved.*/
+  test_set_step(3);
+  {
+    unsigned i;
+
+    hits = (ucnt_t)0;
+    for (i = 0U; i < (unsigned)CH_CFG_HEAP_SLAB_CLASSES; i++) {
+      (void)chHeapSlabStatus(i, &h, &m);
+      hits += h + m;
+    }
+    p1 = chHeapAlloc(NULL, CH_HEAP_SLAB_MAX_SIZE + 1U);
+    test_assert(p1 != NULL, "allocation failed");
+    m = (ucnt_t)0;
+    for (i = 0U; i < (unsigned)CH_CFG_HEAP_SLAB_CLASSES; i++) {
+      (void)chHeapSlabStatus(i, &h, &misses);
+      m += h + misses;
+    }
+    test_assert(m == hits, "slab involved");
+    chHeapFree(p1);
+  }
+}
+
+static const testcase_t oslib_test_004_003 = {
+  "Default heap slab classes",
+  NULL,
+  NULL,
+  oslib_test_004_003_execute
+};
+#endif /* CH_CFG_HEAP_SLAB == TRUE */
+
+/**
+ * @page oslib_test_004_004 [4.4] Blocks reallocation
+ *
+ * <h2>Description</h2>
+ * A block is grown and shrunk in place using chHeapRealloc() then a
+ * block followed by an allocated block is grown. The test expects the
+ * content to be preserved and the heap to be back to the initial
+ * status.
+ *
+ * <h2>Test Steps</h2>
+ * - [4.4.1] Getting the heap state before the test.
+ * - [4.4.2] Allocating a block and filling it with a pattern.
+ * - [4.4.3] Growing the block, the following free space must be used in
+ *   place.
+ * - [4.4.4] Shrinking the block in place then freeing it, the heap must
+ *   be back to the initial state.
+ * - [4.4.5] Growing a block of the default heap followed by an
+ *   allocated block, the content must be preserved.
+ * .
+ */
+
+static void oslib_test_004_004_setup(void) {
+  chHeapObjectInit(&test_heap, test_heap_buffer, sizeof(test_heap_buffer));
+}
+
+static void oslib_test_004_004_execute(void) {
+  uint8_t *p1, *p2, *p3;
+  size_t n1, total1, largest1;
+  size_t n2, total2, largest2;
+  unsigned i;
+
+  /* [4.4.1] Getting the heap state before the test.*/
+  test_set_step(1);
+  {
+    n1 = chHeapStatus(&test_heap, &total1, &largest1);
+    test_assert(n1 == 1, "heap fragmented");
+  }
+
+  /* [4.4.2] Allocating a block and filling it with a pattern.*/
+  test_set_step(2);
+  {
+    p1 = chHeapAlloc(&test_heap, ALLOC_SIZE);
+    test_assert(p1 != NULL, "allocation failed");
+    for (i = 0U; i < ALLOC_SIZE; i++) {
+      p1[i] = (uint8_t)i;
+    }
+  }
+
+  /* [4.4.3] Growing the block, the following free space must be used in
+     place.*/
+  test_set_step(3);
+  {
+    p2 = chHeapRealloc(p1, ALLOC_SIZE * 2);
+    test_assert(p2 == p1, "block moved");
+    test_assert(chHeapGetSize(p2) == ALLOC_SIZE * 2, "wrong size");
+    for (i = 0U; i < ALLOC_SIZE; i++) {
+      test_assert(p2[i] == (uint8_t)i, "content changed");
+    }
+  }
+
+  /* [4.4.4] Shrinking the block in place then freeing it, the heap must
+     be back to the initial state.*/
+  test_set_step(4);
+  {
+    p2 = chHeapRealloc(p1, ALLOC_SIZE / 2);
+    test_assert(p2 == p1, "block moved");
+    test_assert(chHeapGetSize(p2) == ALLOC_SIZE / 2, "wrong size");
+    for (i = 0U; i < ALLOC_SIZE / 2; i++) {
+      test_assert(p2[i] == (uint8_t)i, "content changed");
+    }
+    chHeapFree(p2);
+    n2 = chHeapStatus(&test_heap, &total2, &largest2);
+    test_assert(n1 == n2, "fragmentation changed");
+    test_assert(total1 == total2, "total free space changed");
+    test_assert(largest1 == largest2, "largest fragment size changed");
+  }
+
+  /* [4.4.5] Growing a block of the default heap followed by an
+     allocated block, the content must be preserved.*/
+  test_set_step(5);
+  {
+    p1 = chHeapAlloc(NULL, ALLOC_SIZE);
+    p3 = chHeapAlloc(NULL, ALLOC_SIZE);
+    test_assert((p1 != NULL) && (p3 != NULL), "allocation failed");
+    for (i = 0U; i < ALLOC_SIZE; i++) {
+      p1[i] = (uint8_t)i;
+    }
+    p2 = chHeapRealloc(p1, ALLOC_SIZE * 4);
+    test_assert(p2 != NULL, "reallocation failed");
+    test_assert(chHeapGetSize(p2) == ALLOC_SIZE * 4, "wrong size");
+    for (i = 0U; i < ALLOC_SIZE; i++) {
+      test_assert(p2[i] == (uint8_t)i, "content changed");
+    }
+    chHeapFree(p2);
+    chHeapFree(p3);
+  }
+}
+
+static const testcase_t oslib_test_004_004 = {
+  "Blocks reallocation",
+  oslib_test_004_004_setup,
+  NULL,
+  oslib_test_004_004_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -266,6 +464,10 @@ static const testcase_t oslib_test_004_002 = {
 const testcase_t * const oslib_test_sequence_004_array[] = {
   &oslib_test_004_001,
   &oslib_test_004_002,
+#if (CH_CFG_HEAP_SLAB == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_004_003,
+#endif
+  &oslib_test_004_004,
   NULL
 };
 
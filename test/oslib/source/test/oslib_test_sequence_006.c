@@ -0,0 +1,278 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "oslib_test_root.h"
+
+/**
+ * @file    oslib_test_sequence_006.c
+ * @brief   Test Sequence 006 code.
+ *
+ * @page oslib_test_sequence_006 [6] Ring Buffers
+ *
+ * File: @ref oslib_test_sequence_006.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the ChibiOS library functionalities related to
+ * ring buffers.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_RING_BUFFERS
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage oslib_test_006_001
+ * - @subpage oslib_test_006_002
+ * .
+ */
+
+#if (CH_CFG_USE_RING_BUFFERS) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+#define RB_SIZE 16
+
+static uint8_t rb_buffer[RB_SIZE];
+static RING_BUFFER_DECL(rb1, rb_buffer, RB_SIZE);
+
+static const uint8_t rb_pattern[] = "0123456789ABCDEF";
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page oslib_test_006_001 [6.1] Ring buffers zero-copy API
+ *
+ * <h2>Description</h2>
+ * The ring buffer reserve/commit and peek/release functionality is
+ * tested by loading and emptying it, wrapping conditions are tested.
+ *
+ * <h2>Test Steps</h2>
+ * - [6.1.1] Reserving space in the empty ring buffer, the whole buffer
+ *   must be available.
+ * - [6.1.2] Committing data in the empty ring buffer, the transition
+ *   must be reported.
+ * - [6.1.3] Committing more data, the transition must not be reported.
+ * - [6.1.4] Peeking and releasing all data.
+ * - [6.1.5] Filling the ring buffer across the buffer boundary, the
+ *   reserved space must be limited to the buffer end.
+ * - [6.1.6] Emptying the ring buffer across the buffer boundary, the
+ *   data must be limited to the buffer end.
+ * .
+ */
+
+static void oslib_test_006_001_setup(void) {
+  chRBObjectInit(&rb1, rb_buffer, RB_SIZE);
+}
+
+static void oslib_test_006_001_execute(void) {
+
+  /* [6.1.1] Reserving space in the empty ring buffer, the whole buffer
+     must be available.*/
+  test_set_step(1);
+  {
+    uint8_t *p;
+    size_t n;
+
+    p = chRBReserveX(&rb1, &n);
+    test_assert((p == rb_buffer) && (n == RB_SIZE), "wrong reserved space");
+    test_assert(chRBGetUsedCountX(&rb1) == 0, "not empty");
+  }
+
+  /* [6.1.2] Committing data in the empty ring buffer, the transition must
+     be reported.*/
+  test_set_step(2);
+  {
+    uint8_t *p;
+    size_t n;
+
+    p = chRBReserveX(&rb1, &n);
+    memcpy(p, rb_pattern, 4);
+    test_assert(chRBCommitX(&rb1, 4) == true, "transition not reported");
+    test_assert(chRBGetUsedCountX(&rb1) == 4, "wrong used count");
+  }
+
+  /* [6.1.3] Committing more data, the transition must not be reported.*/
+  test_set_step(3);
+  {
+    uint8_t *p;
+    size_t n;
+
+    p = chRBReserveX(&rb1, &n);
+    test_assert((p == rb_buffer + 4) && (n == RB_SIZE - 4), "wrong reserved space");
+    memcpy(p, rb_pattern + 4, 4);
+    test_assert(chRBCommitX(&rb1, 4) == false, "unexpected transition");
+    test_assert(chRBGetUsedCountX(&rb1) == 8, "wrong used count");
+  }
+
+  /* [6.1.4] Peeking and releasing all data.*/
+  test_set_step(4);
+  {
+    const uint8_t *p;
+    size_t n;
+
+    p = chRBPeekX(&rb1, &n);
+    test_assert((p == rb_buffer) && (n == 8), "wrong data");
+    test_assert(memcmp(rb_pattern, p, 8) == 0, "content mismatch");
+    chRBReleaseX(&rb1, n);
+    test_assert(chRBGetUsedCountX(&rb1) == 0, "not empty");
+  }
+
+  /* [6.1.5] Filling the ring buffer across the buffer boundary, the
+     reserved space must be limited to the buffer end.*/
+  test_set_step(5);
+  {
+    uint8_t *p;
+    size_t n;
+
+    p = chRBReserveX(&rb1, &n);
+    test_assert((p == rb_buffer + 8) && (n == RB_SIZE - 8), "wrong reserved space");
+    memcpy(p, rb_pattern, n);
+    (void) chRBCommitX(&rb1, n);
+    p = chRBReserveX(&rb1, &n);
+    test_assert((p == rb_buffer) && (n == 8), "wrong reserved space");
+    memcpy(p, rb_pattern + 8, n);
+    (void) chRBCommitX(&rb1, n);
+    p = chRBReserveX(&rb1, &n);
+    test_assert(n == 0, "not full");
+    test_assert(chRBGetFreeCountX(&rb1) == 0, "wrong free count");
+  }
+
+  /* [6.1.6] Emptying the ring buffer across the buffer boundary, the data
+     must be limited to the buffer end.*/
+  test_set_step(6);
+  {
+    const uint8_t *p;
+    size_t n;
+
+    p = chRBPeekX(&rb1, &n);
+    test_assert((p == rb_buffer + 8) && (n == RB_SIZE - 8), "wrong data");
+    test_assert(memcmp(rb_pattern, p, n) == 0, "content mismatch");
+    chRBReleaseX(&rb1, n);
+    p = chRBPeekX(&rb1, &n);
+    test_assert((p == rb_buffer) && (n == 8), "wrong data");
+    test_assert(memcmp(rb_pattern + 8, p, n) == 0, "content mismatch");
+    chRBReleaseX(&rb1, n);
+    p = chRBPeekX(&rb1, &n);
+    test_assert(n == 0, "not empty");
+  }
+}
+
+static const testcase_t oslib_test_006_001 = {
+  "Ring buffers zero-copy API",
+  oslib_test_006_001_setup,
+  NULL,
+  oslib_test_006_001_execute
+};
+
+/**
+ * @page oslib_test_006_002 [6.2] Ring buffers blocking API
+ *
+ * <h2>Description</h2>
+ * The ring buffer read and wait functions are tested for timeouts.
+ *
+ * <h2>Test Steps</h2>
+ * - [6.2.1] Waiting while the ring buffer is empty, must timeout.
+ * - [6.2.2] Committing data and waking up, no thread is waiting.
+ * - [6.2.3] Reading more data than available, must timeout after a
+ *   partial read.
+ * .
+ */
+
+static void oslib_test_006_002_setup(void) {
+  chRBObjectInit(&rb1, rb_buffer, RB_SIZE);
+}
+
+static void oslib_test_006_002_execute(void) {
+
+  /* [6.2.1] Waiting while the ring buffer is empty, must timeout.*/
+  test_set_step(1);
+  {
+    msg_t msg;
+
+    msg = chRBWaitTimeout(&rb1, TIME_IMMEDIATE);
+    test_assert(msg == MSG_TIMEOUT, "wrong wake-up message");
+    msg = chRBWaitTimeout(&rb1, TIME_MS2I(10));
+    test_assert(msg == MSG_TIMEOUT, "wrong wake-up message");
+  }
+
+  /* [6.2.2] Committing data and waking up, no thread is waiting.*/
+  test_set_step(2);
+  {
+    uint8_t *p;
+    size_t n;
+
+    p = chRBReserveX(&rb1, &n);
+    memcpy(p, rb_pattern, 4);
+    if (chRBCommitX(&rb1, 4)) {
+      chSysLock();
+      chRBWakeupI(&rb1);
+      chSysUnlock();
+    }
+    test_assert(chRBWaitTimeout(&rb1, TIME_IMMEDIATE) == MSG_OK,
+                "wrong wake-up message");
+  }
+
+  /* [6.2.3] Reading more data than available, must timeout after a partial
+     read.*/
+  test_set_step(3);
+  {
+    size_t n;
+    uint8_t buf[RB_SIZE];
+
+    n = chRBReadTimeout(&rb1, buf, 8, TIME_MS2I(10));
+    test_assert(n == 4, "wrong size");
+    test_assert(memcmp(rb_pattern, buf, 4) == 0, "content mismatch");
+    test_assert(chRBGetUsedCountX(&rb1) == 0, "not empty");
+  }
+}
+
+static const testcase_t oslib_test_006_002 = {
+  "Ring buffers blocking API",
+  oslib_test_006_002_setup,
+  NULL,
+  oslib_test_006_002_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const oslib_test_sequence_006_array[] = {
+  &oslib_test_006_001,
+  &oslib_test_006_002,
+  NULL
+};
+
+/**
+ * @brief   Ring Buffers.
+ */
+const testsequence_t oslib_test_sequence_006 = {
+  "Ring Buffers",
+  oslib_test_sequence_006_array
+};
+
+#endif /* CH_CFG_USE_RING_BUFFERS */
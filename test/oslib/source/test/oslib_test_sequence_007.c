@@ -0,0 +1,207 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "oslib_test_root.h"
+
+/**
+ * @file    oslib_test_sequence_007.c
+ * @brief   Test Sequence 007 code.
+ *
+ * @page oslib_test_sequence_007 [7] Priority Objects FIFOs
+ *
+ * File: @ref oslib_test_sequence_007.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the ChibiOS library functionalities related to
+ * priority objects FIFOs.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_OBJ_PFIFOS
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage oslib_test_007_001
+ * - @subpage oslib_test_007_002
+ * .
+ */
+
+#if (CH_CFG_USE_OBJ_PFIFOS) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#define PF_SIZE 4
+
+static uintptr_t pf_objects[PF_SIZE];
+static pfifo_slot_t pf_slots[PF_SIZE];
+static prio_objects_fifo_t pf1;
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page oslib_test_007_001 [7.1] Priority objects FIFOs ordering
+ *
+ * <h2>Description</h2>
+ * Objects are sent with different keys, the receiver must get them
+ * ordered by key, objects with the same key must be received in the
+ * order they have been sent.
+ *
+ * <h2>Test Steps</h2>
+ * - [7.1.1] Sending all the objects with keys 20, 10, 30 and 10, the
+ *   FIFO must be full.
+ * - [7.1.2] Receiving all the objects, the order must be 1, 3, 0 and 2.
+ * - [7.1.3] Testing deadlines across the keys wrap, 0x00000010 must
+ *   follow 0xFFFFFFF0.
+ * .
+ */
+
+static void oslib_test_007_001_setup(void) {
+  chPFifoObjectInit(&pf1, sizeof (uintptr_t), PF_SIZE,
+                    PORT_NATURAL_ALIGN, pf_objects, pf_slots);
+}
+
+static void oslib_test_007_001_execute(void) {
+
+  /* [7.1.1] Sending all the objects with keys 20, 10, 30 and 10, the FIFO
+     must be full.*/
+  test_set_step(1);
+  {
+    static const pfifokey_t keys[PF_SIZE] = {20U, 10U, 30U, 10U};
+    unsigned i;
+
+    for (i = 0U; i < PF_SIZE; i++) {
+      uint32_t *objp = chPFifoTakeObjectTimeout(&pf1, TIME_IMMEDIATE);
+      test_assert(objp != NULL, "object not available");
+      *objp = i;
+      chPFifoSendObject(&pf1, objp, keys[i]);
+    }
+    test_assert(chPFifoTakeObjectTimeout(&pf1, TIME_IMMEDIATE) == NULL,
+                "pool not empty");
+    test_assert_lock(chPFifoGetUsedCountI(&pf1) == PF_SIZE, "wrong count");
+  }
+
+  /* [7.1.2] Receiving all the objects, the order must be 1, 3, 0 and 2.*/
+  test_set_step(2);
+  {
+    static const uint32_t order[PF_SIZE] = {1U, 3U, 0U, 2U};
+    unsigned i;
+
+    for (i = 0U; i < PF_SIZE; i++) {
+      void *objp;
+      msg_t msg = chPFifoReceiveObjectTimeout(&pf1, &objp, TIME_IMMEDIATE);
+      test_assert(msg == MSG_OK, "wrong wake-up message");
+      test_assert(*(uint32_t *)objp == order[i], "wrong order");
+      chPFifoReturnObject(&pf1, objp);
+    }
+  }
+
+  /* [7.1.3] Testing deadlines across the keys wrap, 0x00000010 must follow
+     0xFFFFFFF0.*/
+  test_set_step(3);
+  {
+    void *objp;
+    uint32_t *p1, *p2;
+
+    p1 = chPFifoTakeObjectTimeout(&pf1, TIME_IMMEDIATE);
+    p2 = chPFifoTakeObjectTimeout(&pf1, TIME_IMMEDIATE);
+    chPFifoSendObject(&pf1, p1, 0x00000010U);
+    chPFifoSendObject(&pf1, p2, 0xFFFFFFF0U);
+    (void) chPFifoReceiveObjectTimeout(&pf1, &objp, TIME_IMMEDIATE);
+    test_assert(objp == p2, "wrong order");
+    chPFifoReturnObject(&pf1, objp);
+    (void) chPFifoReceiveObjectTimeout(&pf1, &objp, TIME_IMMEDIATE);
+    test_assert(objp == p1, "wrong order");
+    chPFifoReturnObject(&pf1, objp);
+  }
+}
+
+static const testcase_t oslib_test_007_001 = {
+  "Priority objects FIFOs ordering",
+  oslib_test_007_001_setup,
+  NULL,
+  oslib_test_007_001_execute
+};
+
+/**
+ * @page oslib_test_007_002 [7.2] Priority objects FIFOs timeouts
+ *
+ * <h2>Description</h2>
+ * The priority objects FIFO receive functions are tested for timeouts.
+ *
+ * <h2>Test Steps</h2>
+ * - [7.2.1] Receiving from the empty FIFO, must timeout.
+ * .
+ */
+
+static void oslib_test_007_002_setup(void) {
+  chPFifoObjectInit(&pf1, sizeof (uintptr_t), PF_SIZE,
+                    PORT_NATURAL_ALIGN, pf_objects, pf_slots);
+}
+
+static void oslib_test_007_002_execute(void) {
+
+  /* [7.2.1] Receiving from the empty FIFO, must timeout.*/
+  test_set_step(1);
+  {
+    void *objp;
+    msg_t msg;
+
+    msg = chPFifoReceiveObjectTimeout(&pf1, &objp, TIME_IMMEDIATE);
+    test_assert(msg == MSG_TIMEOUT, "wrong wake-up message");
+    msg = chPFifoReceiveObjectTimeout(&pf1, &objp, TIME_MS2I(10));
+    test_assert(msg == MSG_TIMEOUT, "wrong wake-up message");
+    chSysLock();
+    msg = chPFifoReceiveObjectI(&pf1, &objp);
+    chSysUnlock();
+    test_assert(msg == MSG_TIMEOUT, "wrong wake-up message");
+  }
+}
+
+static const testcase_t oslib_test_007_002 = {
+  "Priority objects FIFOs timeouts",
+  oslib_test_007_002_setup,
+  NULL,
+  oslib_test_007_002_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const oslib_test_sequence_007_array[] = {
+  &oslib_test_007_001,
+  &oslib_test_007_002,
+  NULL
+};
+
+/**
+ * @brief   Priority Objects FIFOs.
+ */
+const testsequence_t oslib_test_sequence_007 = {
+  "Priority Objects FIFOs",
+  oslib_test_sequence_007_array
+};
+
+#endif /* CH_CFG_USE_OBJ_PFIFOS */
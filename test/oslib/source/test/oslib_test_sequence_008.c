@@ -0,0 +1,335 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "oslib_test_root.h"
+
+/**
+ * @file    oslib_test_sequence_008.c
+ * @brief   Test Sequence 008 code.
+ *
+ * @page oslib_test_sequence_008 [8] Topics Bus
+ *
+ * File: @ref oslib_test_sequence_008.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the ChibiOS library functionalities related to the
+ * topics bus.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_TOPICS
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage oslib_test_008_001
+ * - @subpage oslib_test_008_002
+ * - @subpage oslib_test_008_003
+ * .
+ */
+
+#if (CH_CFG_USE_TOPICS) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#define TP_POOL_SIZE    4U
+#define TP_QUEUE_SIZE   2U
+#define TP_SUBSCRIBERS  3U
+
+typedef struct {
+  topic_message_t hdr;
+  uint32_t        value;
+} tp_msg_t;
+
+static tp_msg_t tp_msgs[TP_POOL_SIZE];
+static memory_pool_t tp_pool;
+static topic_t tp1;
+static topic_subscriber_t tp_subs[TP_SUBSCRIBERS];
+static topic_message_t *tp_bufs[TP_SUBSCRIBERS][TP_QUEUE_SIZE];
+
+static void tp_init(void) {
+
+  chPoolObjectInit(&tp_pool, sizeof (tp_msg_t), NULL);
+  chPoolLoadArray(&tp_pool, tp_msgs, TP_POOL_SIZE);
+  chTopicObjectInit(&tp1);
+}
+
+static unsigned tp_pool_count(void) {
+  struct pool_header *php;
+  unsigned n = 0U;
+
+  chSysLock();
+  for (php = tp_pool.next; php != NULL; php = php->next) {
+    n++;
+  }
+  chSysUnlock();
+
+  return n;
+}
+
+static tp_msg_t *tp_publish(uint32_t value) {
+  tp_msg_t *p = (tp_msg_t *)chTopicAllocMessage(&tp_pool);
+
+  if (p != NULL) {
+    p->value = value;
+    chTopicPublish(&tp1, &p->hdr);
+  }
+
+  return p;
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page oslib_test_008_001 [8.1] Topics messages fan-out
+ *
+ * <h2>Description</h2>
+ * A message is published on a topic with three subscribers, all the
+ * subscribers must receive the same message and the message must be returned
+ * to the pool after the last release.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.1.1] Subscribing three subscribers and publishing a message, each
+ *   subscriber must receive the same message.
+ * - [8.1.2] Releasing the message once for each subscriber, it must be
+ *   returned to the pool after the last release.
+ * - [8.1.3] Publishing two messages then unsubscribing all the subscribers,
+ *   the queued messages must be released.
+ * - [8.1.4] Publishing a message on a topic without subscribers, the message
+ *   must be released immediately.
+ * .
+ */
+
+static void oslib_test_008_001_setup(void) {
+  tp_init();
+}
+
+static void oslib_test_008_001_execute(void) {
+  tp_msg_t *p;
+  unsigned i;
+
+  /* [8.1.1] Subscribing three subscribers and publishing a message, each
+     subscriber must receive the same message.*/
+  test_set_step(1);
+  {
+    for (i = 0U; i < TP_SUBSCRIBERS; i++) {
+      chTopicSubscriberObjectInit(&tp_subs[i], tp_bufs[i], TP_QUEUE_SIZE,
+                                  TOPIC_DROP_NEWEST);
+      chTopicSubscribe(&tp1, &tp_subs[i]);
+    }
+    p = tp_publish(42U);
+    test_assert(p != NULL, "allocation failed");
+    test_assert(tp_pool_count() == TP_POOL_SIZE - 1U, "wrong pool count");
+    for (i = 0U; i < TP_SUBSCRIBERS; i++) {
+      topic_message_t *msgp;
+      msg_t msg = chTopicReceiveTimeout(&tp_subs[i], &msgp, TIME_IMMEDIATE);
+      test_assert(msg == MSG_OK, "no message");
+      test_assert(msgp == &p->hdr, "wrong message");
+      test_assert(((tp_msg_t *)msgp)->value == 42U, "wrong value");
+    }
+  }
+
+  /* [8.1.2] Releasing the message once for each subscriber, it must be
+     returned to the pool after the last release.*/
+  test_set_step(2);
+  {
+    for (i = 0U; i < TP_SUBSCRIBERS; i++) {
+      test_assert(tp_pool_count() == TP_POOL_SIZE - 1U, "released too early");
+      chTopicRelease(&p->hdr);
+    }
+    test_assert(tp_pool_count() == TP_POOL_SIZE, "not released");
+  }
+
+  /* [8.1.3] Publishing two messages then unsubscribing all the subscribers,
+     the queued messages must be released.*/
+  test_set_step(3);
+  {
+    test_assert(tp_publish(1U) != NULL, "allocation failed");
+    test_assert(tp_publish(2U) != NULL, "allocation failed");
+    test_assert(tp_pool_count() == TP_POOL_SIZE - 2U, "wrong pool count");
+    for (i = 0U; i < TP_SUBSCRIBERS; i++) {
+      chTopicUnsubscribe(&tp1, &tp_subs[i]);
+    }
+    test_assert(tp_pool_count() == TP_POOL_SIZE, "not released");
+  }
+
+  /* [8.1.4] Publishing a message on a topic without subscribers, the message
+     must be released immediately.*/
+  test_set_step(4);
+  {
+    test_assert(tp_publish(3U) != NULL, "allocation failed");
+    test_assert(tp_pool_count() == TP_POOL_SIZE, "not released");
+  }
+}
+
+static const testcase_t oslib_test_008_001 = {
+  "Topics messages fan-out",
+  oslib_test_008_001_setup,
+  NULL,
+  oslib_test_008_001_execute
+};
+
+/**
+ * @page oslib_test_008_002 [8.2] Topics drop policies
+ *
+ * <h2>Description</h2>
+ * Messages are published on two subscribers with full queues, the drop newest
+ * subscriber must keep the oldest messages, the drop oldest subscriber must
+ * keep the newest messages.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.2.1] Publishing three messages, each subscriber must drop one message.
+ * - [8.2.2] Receiving all the messages, the drop newest subscriber must
+ *   receive messages 1 and 2, the drop oldest subscriber messages 2 and 3.
+ * .
+ */
+
+static void oslib_test_008_002_setup(void) {
+  tp_init();
+  chTopicSubscriberObjectInit(&tp_subs[0], tp_bufs[0], TP_QUEUE_SIZE,
+                              TOPIC_DROP_NEWEST);
+  chTopicSubscriberObjectInit(&tp_subs[1], tp_bufs[1], TP_QUEUE_SIZE,
+                              TOPIC_DROP_OLDEST);
+  chTopicSubscribe(&tp1, &tp_subs[0]);
+  chTopicSubscribe(&tp1, &tp_subs[1]);
+}
+
+static void oslib_test_008_002_teardown(void) {
+  chTopicUnsubscribe(&tp1, &tp_subs[0]);
+  chTopicUnsubscribe(&tp1, &tp_subs[1]);
+}
+
+static void oslib_test_008_002_execute(void) {
+  topic_message_t *msgp;
+  unsigned i, j;
+
+  /* [8.2.1] Publishing three messages, each subscriber must drop one
+     message.*/
+  test_set_step(1);
+  {
+    for (i = 1U; i <= 3U; i++) {
+      test_assert(tp_publish(i) != NULL, "allocation failed");
+    }
+    test_assert(chTopicGetDropsX(&tp_subs[0]) == (ucnt_t)1, "wrong drops");
+    test_assert(chTopicGetDropsX(&tp_subs[1]) == (ucnt_t)1, "wrong drops");
+    test_assert(tp_pool_count() == TP_POOL_SIZE - 3U, "wrong pool count");
+  }
+
+  /* [8.2.2] Receiving all the messages, the drop newest subscriber must
+     receive messages 1 and 2, the drop oldest subscriber messages 2 and 3.*/
+  test_set_step(2);
+  {
+    static const uint32_t expected[2][TP_QUEUE_SIZE] = {{1U, 2U}, {2U, 3U}};
+
+    for (i = 0U; i < 2U; i++) {
+      for (j = 0U; j < TP_QUEUE_SIZE; j++) {
+        msg_t msg = chTopicReceiveTimeout(&tp_subs[i], &msgp, TIME_IMMEDIATE);
+        test_assert(msg == MSG_OK, "no message");
+        test_assert(((tp_msg_t *)msgp)->value == expected[i][j],
+                    "wrong message");
+        chTopicRelease(msgp);
+      }
+    }
+    test_assert(tp_pool_count() == TP_POOL_SIZE, "not released");
+  }
+}
+
+static const testcase_t oslib_test_008_002 = {
+  "Topics drop policies",
+  oslib_test_008_002_setup,
+  oslib_test_008_002_teardown,
+  oslib_test_008_002_execute
+};
+
+/**
+ * @page oslib_test_008_003 [8.3] Topics timeouts
+ *
+ * <h2>Description</h2>
+ * The topics receive functions are tested for timeouts.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.3.1] Receiving from an empty subscriber, must timeout.
+ * .
+ */
+
+static void oslib_test_008_003_setup(void) {
+  tp_init();
+  chTopicSubscriberObjectInit(&tp_subs[0], tp_bufs[0], TP_QUEUE_SIZE,
+                              TOPIC_DROP_NEWEST);
+  chTopicSubscribe(&tp1, &tp_subs[0]);
+}
+
+static void oslib_test_008_003_teardown(void) {
+  chTopicUnsubscribe(&tp1, &tp_subs[0]);
+}
+
+static void oslib_test_008_003_execute(void) {
+
+  /* [8.3.1] Receiving from an empty subscriber, must timeout.*/
+  test_set_step(1);
+  {
+    topic_message_t *msgp;
+    msg_t msg;
+    size_t pending;
+
+    msg = chTopicReceiveTimeout(&tp_subs[0], &msgp, TIME_IMMEDIATE);
+    test_assert(msg == MSG_TIMEOUT, "wrong wake-up message");
+    msg = chTopicReceiveTimeout(&tp_subs[0], &msgp, TIME_MS2I(10));
+    test_assert(msg == MSG_TIMEOUT, "wrong wake-up message");
+    chSysLock();
+    msg = chTopicReceiveI(&tp_subs[0], &msgp);
+    pending = chTopicGetPendingI(&tp_subs[0]);
+    chSysUnlock();
+    test_assert(msg == MSG_TIMEOUT, "wrong wake-up message");
+    test_assert(pending == (size_t)0, "not empty");
+  }
+}
+
+static const testcase_t oslib_test_008_003 = {
+  "Topics timeouts",
+  oslib_test_008_003_setup,
+  oslib_test_008_003_teardown,
+  oslib_test_008_003_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const oslib_test_sequence_008_array[] = {
+  &oslib_test_008_001,
+  &oslib_test_008_002,
+  &oslib_test_008_003,
+  NULL
+};
+
+/**
+ * @brief   Topics Bus.
+ */
+const testsequence_t oslib_test_sequence_008 = {
+  "Topics Bus",
+  oslib_test_sequence_008_array
+};
+
+#endif /* CH_CFG_USE_TOPICS */
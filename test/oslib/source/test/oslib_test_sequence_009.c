@@ -0,0 +1,282 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "oslib_test_root.h"
+
+/**
+ * @file    oslib_test_sequence_009.c
+ * @brief   Test Sequence 009 code.
+ *
+ * @page oslib_test_sequence_009 [9] Watchdog Monitor
+ *
+ * File: @ref oslib_test_sequence_009.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the ChibiOS library functionalities related to the
+ * watchdog monitor.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_WATCHDOG
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage oslib_test_009_001
+ * - @subpage oslib_test_009_002
+ * - @subpage oslib_test_009_003
+ * .
+ */
+
+#if (CH_CFG_USE_WATCHDOG) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+static watchdog_monitor_t wm1;
+static watchdog_slot_t ws1, ws2;
+static unsigned wm_feeds, wm_fails;
+static watchdog_slot_t *wm_failed;
+
+static void wm_feed(watchdog_monitor_t *wmp) {
+
+  (void)wmp;
+  wm_feeds++;
+}
+
+static void wm_fail(watchdog_monitor_t *wmp, watchdog_slot_t *wsp) {
+
+  (void)wmp;
+  wm_fails++;
+  wm_failed = wsp;
+}
+
+static void wm_init(void) {
+
+  wm_feeds  = 0U;
+  wm_fails  = 0U;
+  wm_failed = NULL;
+  chWdgObjectInit(&wm1, TIME_MS2I(10), wm_feed, wm_fail);
+}
+
+static void wm_run(unsigned n, bool hb2) {
+
+  while (n-- > 0U) {
+    chThdSleepMilliseconds(5);
+    chWdgHeartbeat(&ws1);
+    if (hb2) {
+      chWdgHeartbeat(&ws2);
+    }
+  }
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page oslib_test_009_001 [9.1] Watchdog monitor feeding
+ *
+ * <h2>Description</h2>
+ * Two slots are registered and kept alive, the monitor must keep feeding
+ * without failures.
+ *
+ * <h2>Test Steps</h2>
+ * - [9.1.1] Registering two slots and starting the monitor, the feed
+ *   callback must be invoked immediately.
+ * - [9.1.2] Sending heartbeats on both slots for 100mS, the monitor must
+ *   keep feeding without failures.
+ * .
+ */
+
+static void oslib_test_009_001_setup(void) {
+  wm_init();
+}
+
+static void oslib_test_009_001_teardown(void) {
+  chWdgStop(&wm1);
+}
+
+static void oslib_test_009_001_execute(void) {
+
+  /* [9.1.1] Registering two slots and starting the monitor, the feed
+     callback must be invoked immediately.*/
+  test_set_step(1);
+  {
+    chWdgRegister(&wm1, &ws1, TIME_MS2I(50));
+    chWdgRegister(&wm1, &ws2, TIME_MS2I(30));
+    chWdgStart(&wm1);
+    test_assert(wm_feeds == 1U, "not fed");
+  }
+
+  /* [9.1.2] Sending heartbeats on both slots for 100mS, the monitor must
+     keep feeding without failures.*/
+  test_set_step(2);
+  {
+    wm_run(20U, true);
+    test_assert(wm_feeds > 5U, "not fed");
+    test_assert(wm_fails == 0U, "failure detected");
+    test_assert(chWdgGetFailedX(&wm1) == NULL, "failure detected");
+  }
+}
+
+static const testcase_t oslib_test_009_001 = {
+  "Watchdog monitor feeding",
+  oslib_test_009_001_setup,
+  oslib_test_009_001_teardown,
+  oslib_test_009_001_execute
+};
+
+/**
+ * @page oslib_test_009_002 [9.2] Watchdog monitor failure
+ *
+ * <h2>Description</h2>
+ * One of two slots misses its deadline, the failure must be reported once
+ * and the feeding must stop.
+ *
+ * <h2>Test Steps</h2>
+ * - [9.2.1] Sending heartbeats on the first slot only for 100mS, the second
+ *   slot must be reported as failed.
+ * - [9.2.2] Sending heartbeats on both slots for 50mS, the monitor must not
+ *   feed again.
+ * .
+ */
+
+static void oslib_test_009_002_setup(void) {
+  wm_init();
+  chWdgRegister(&wm1, &ws1, TIME_MS2I(50));
+  chWdgRegister(&wm1, &ws2, TIME_MS2I(30));
+  chWdgStart(&wm1);
+}
+
+static void oslib_test_009_002_teardown(void) {
+  chWdgStop(&wm1);
+}
+
+static void oslib_test_009_002_execute(void) {
+  unsigned feeds;
+
+  /* [9.2.1] Sending heartbeats on the first slot only for 100mS, the
+     second slot must be reported as failed.*/
+  test_set_step(1);
+  {
+    wm_run(20U, false);
+    test_assert(wm_fails == 1U, "failure not reported once");
+    test_assert(wm_failed == &ws2, "wrong slot");
+    test_assert(chWdgGetFailedX(&wm1) == &ws2, "wrong slot");
+  }
+
+  /* [9.2.2] Sending heartbeats on both slots for 50mS, the monitor must
+     not feed again.*/
+  test_set_step(2);
+  {
+    feeds = wm_feeds;
+    wm_run(10U, true);
+    test_assert(wm_feeds == feeds, "fed after failure");
+    test_assert(wm_fails == 1U, "failure reported again");
+  }
+}
+
+static const testcase_t oslib_test_009_002 = {
+  "Watchdog monitor failure",
+  oslib_test_009_002_setup,
+  oslib_test_009_002_teardown,
+  oslib_test_009_002_execute
+};
+
+/**
+ * @page oslib_test_009_003 [9.3] Watchdog monitor slots removal
+ *
+ * <h2>Description</h2>
+ * An unregistered slot is no more supervised.
+ *
+ * <h2>Test Steps</h2>
+ * - [9.3.1] Registering two slots then unregistering the second one,
+ *   sending heartbeats on the first slot only for 100mS, no failures must
+ *   be reported.
+ * - [9.3.2] Unregistering the first slot and waiting 100mS, the monitor
+ *   must keep feeding without slots.
+ * .
+ */
+
+static void oslib_test_009_003_setup(void) {
+  wm_init();
+  chWdgStart(&wm1);
+}
+
+static void oslib_test_009_003_teardown(void) {
+  chWdgStop(&wm1);
+}
+
+static void oslib_test_009_003_execute(void) {
+  unsigned feeds;
+
+  /* [9.3.1] Registering two slots then unregistering the second one,
+     sending heartbeats on the first slot only for 100mS, no failures must
+     be reported.*/
+  test_set_step(1);
+  {
+    chWdgRegister(&wm1, &ws1, TIME_MS2I(50));
+    chWdgRegister(&wm1, &ws2, TIME_MS2I(30));
+    chWdgUnregister(&wm1, &ws2);
+    wm_run(20U, false);
+    test_assert(wm_fails == 0U, "failure detected");
+  }
+
+  /* [9.3.2] Unregistering the first slot and waiting 100mS, the monitor
+     must keep feeding without slots.*/
+  test_set_step(2);
+  {
+    chWdgUnregister(&wm1, &ws1);
+    feeds = wm_feeds;
+    chThdSleepMilliseconds(100);
+    test_assert(wm_feeds > feeds, "not fed");
+    test_assert(wm_fails == 0U, "failure detected");
+  }
+}
+
+static const testcase_t oslib_test_009_003 = {
+  "Watchdog monitor slots removal",
+  oslib_test_009_003_setup,
+  oslib_test_009_003_teardown,
+  oslib_test_009_003_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const oslib_test_sequence_009_array[] = {
+  &oslib_test_009_001,
+  &oslib_test_009_002,
+  &oslib_test_009_003,
+  NULL
+};
+
+/**
+ * @brief   Watchdog Monitor.
+ */
+const testsequence_t oslib_test_sequence_009 = {
+  "Watchdog Monitor",
+  oslib_test_sequence_009_array
+};
+
+#endif /* CH_CFG_USE_WATCHDOG */
@@ -31,6 +31,8 @@
  * - @subpage rt_test_sequence_008
  * - @subpage rt_test_sequence_009
  * - @subpage rt_test_sequence_010
+ * - @subpage rt_test_sequence_011
+ * - @subpage rt_test_sequence_012
  * .
  */
 
@@ -72,6 +74,12 @@ const testsequence_t * const rt_test_suite_array[] = {
   &rt_test_sequence_009,
 #endif
   &rt_test_sequence_010,
+#if (CH_CFG_USE_TM) || defined(__DOXYGEN__)
+  &rt_test_sequence_011,
+#endif
+#if (CH_CFG_USE_TM) || defined(__DOXYGEN__)
+  &rt_test_sequence_012,
+#endif
   NULL
 };
 
@@ -139,4 +147,20 @@ systime_t test_wait_tick(void) {
   return chVTGetSystemTime();
 }
 
+#if CH_CFG_USE_THREADS_TABLE == TRUE
+/*
+ * Static threads table thread, the application must declare it in its
+ * threads table.
+ */
+thread_t *test_table_tp;
+void *test_table_arg;
+THD_WORKING_AREA(wa_test_table, THREADS_STACK_SIZE);
+THD_FUNCTION(test_table_thread, arg) {
+
+  test_table_tp  = chThdGetSelfX();
+  test_table_arg = arg;
+  chThdSleep(TIME_INFINITE);
+}
+#endif
+
 #endif /* !defined(__DOXYGEN__) */
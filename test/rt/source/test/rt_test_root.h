@@ -34,6 +34,8 @@
 #include "rt_test_sequence_008.h"
 #include "rt_test_sequence_009.h"
 #include "rt_test_sequence_010.h"
+#include "rt_test_sequence_011.h"
+#include "rt_test_sequence_012.h"
 
 #if !defined(__DOXYGEN__)
 
@@ -92,6 +94,14 @@ void test_terminate_threads(void);
 void test_wait_threads(void);
 systime_t test_wait_tick(void);
 
+#if CH_CFG_USE_THREADS_TABLE == TRUE
+extern thread_t *test_table_tp;
+extern void *test_table_arg;
+extern THD_WORKING_AREA(wa_test_table, THREADS_STACK_SIZE);
+
+THD_FUNCTION(test_table_thread, arg);
+#endif
+
 #endif /* !defined(__DOXYGEN__) */
 
 #endif /* RT_TEST_ROOT_H */
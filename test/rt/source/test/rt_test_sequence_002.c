@@ -37,6 +37,9 @@
  * - @subpage rt_test_002_002
  * - @subpage rt_test_002_003
  * - @subpage rt_test_002_004
+ * - @subpage rt_test_002_005
+ * - @subpage rt_test_002_006
+ * - @subpage rt_test_002_007
  * .
  */
 
@@ -265,6 +268,220 @@ static const testcase_t rt_test_002_004 = {
   rt_test_002_004_execute
 };
 
+#if (CH_CFG_USE_TM_HISTOGRAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_002_005 [2.5] Time measurement histograms
+ *
+ * <h2>Description</h2>
+ * A time measurement object with an attached histogram is used for a
+ * series of measurements, the histogram and the percentiles are checked
+ * for consistency.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_TM_HISTOGRAM == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [2.5.1] Performing 100 measurements, the histogram must count all of
+ *   them.
+ * - [2.5.2] Querying percentiles, the values must be within the best and
+ *   worst measurements.
+ * .
+ */
+
+static void rt_test_002_005_execute(void) {
+  time_measurement_t tm;
+  tm_histogram_t h;
+
+  /* [2.5.1] Performing 100 measurements, the histogram must count all of
+     them.*/
+  test_set_step(1);
+  {
+    unsigned i;
+    ucnt_t n;
+
+    chTMObjectInitHistogram(&tm, &h);
+    for (i = 0U; i < 100U; i++) {
+      chTMStartMeasurementX(&tm);
+      chTMStopMeasurementX(&tm);
+    }
+    n = (ucnt_t)0;
+    for (i = 0U; i < CH_TM_HISTOGRAM_BUCKETS; i++) {
+      n += h.buckets[i];
+    }
+    test_assert(tm.n == (ucnt_t)100, "wrong measurements count");
+    test_assert(n == (ucnt_t)100, "wrong histogram count");
+  }
+
+  /* [2.5.2] Querying percentiles, the values must be within the best and
+     worst measurements.*/
+  test_set_step(2);
+  {
+    rtcnt_t p50 = chTMGetPercentileX(&tm, 500U);
+
+    test_assert(chTMGetPercentileX(&tm, 0U) == (rtcnt_t)0, "wrong 0th percentile");
+    test_assert(chTMGetPercentileX(&tm, 1000U) == tm.worst, "wrong 100th percentile");
+    test_assert((p50 >= tm.best) && (p50 <= tm.worst), "wrong median");
+    test_assert(chTMGetPercentileX(&tm, 999U) >= p50, "not monotonic");
+  }
+}
+
+static const testcase_t rt_test_002_005 = {
+  "Time measurement histograms",
+  NULL,
+  NULL,
+  rt_test_002_005_execute
+};
+#endif /* CH_CFG_USE_TM_HISTOGRAM == TRUE */
+
+/**
+ * @page rt_test_002_006 [2.6] Incremental system integrity check
+ *
+ * <h2>Description</h2>
+ * The incremental integrity check is stepped one element at time, full
+ * passes must be completed without failures also when the checked lists
+ * change between steps.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.6.1] Stepping all the checks, two full passes must be completed
+ *   without failures.
+ * - [2.6.2] Arming and resetting a timer between steps, the scan must
+ *   be restarted without failures.
+ * .
+ */
+
+static void rt_test_002_006_execute(void) {
+  integrity_check_t ic;
+  unsigned i;
+  bool result;
+
+  /* [2.6.1] Stepping all the checks, two full passes must be completed
+     without failures.*/
+  test_set_step(1);
+  {
+    chSysIntegrityObjectInit(&ic, CH_INTEGRITY_RLIST | CH_INTEGRITY_VTLIST |
+                                  CH_INTEGRITY_REGISTRY | CH_INTEGRITY_PORT);
+    result = false;
+    for (i = 0U; (i < 10000U) && (ic.passes < (ucnt_t)2) && !result; i++) {
+      chSysLock();
+      result = chSysIntegrityStepI(&ic, 1U);
+      chSysUnlock();
+    }
+    test_assert(result == false, "integrity check failed");
+    test_assert(ic.passes >= (ucnt_t)2, "passes not completed");
+  }
+
+  /* [2.6.2] Arming and resetting a timer between steps, the scan must
+     be restarted without failures.*/
+  test_set_step(2);
+  {
+    virtual_timer_t vt;
+
+    chVTObjectInit(&vt);
+    chSysIntegrityObjectInit(&ic, CH_INTEGRITY_VTLIST);
+    result = false;
+    for (i = 0U; (i < 10000U) && (ic.passes < (ucnt_t)2) && !result; i++) {
+      chSysLock();
+      if ((i & 1U) == 0U) {
+        chVTSetI(&vt, TIME_MS2I(100), vtcb, NULL);
+      }
+      else {
+        chVTResetI(&vt);
+      }
+      result = chSysIntegrityStepI(&ic, 1U);
+      chSysUnlock();
+    }
+    chVTReset(&vt);
+    test_assert(result == false, "integrity check failed");
+    test_assert(ic.passes >= (ucnt_t)2, "passes not completed");
+  }
+}
+
+static const testcase_t rt_test_002_006 = {
+  "Incremental system integrity check",
+  NULL,
+  NULL,
+  rt_test_002_006_execute
+};
+
+#if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_002_007 [2.7] Time stamps
+ *
+ * <h2>Description</h2>
+ * The 64 bits time stamps API is tested, time stamps must be monotonic
+ * and usable as absolute deadlines.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_TIMESTAMP == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [2.7.1] Reading time stamps while the system time advances, the
+ *   time stamps must be increasing.
+ * - [2.7.2] Sleeping until a time stamp 10mS in the future, the thread
+ *   must not be woken up before.
+ * - [2.7.3] Sleeping until a time stamp in the past, the function must
+ *   return immediately.
+ * .
+ */
+
+static void rt_test_002_007_execute(void) {
+
+  /* [2.7.1] Reading time stamps while the system time advances, the
+     time stamps must be increasing.*/
+  test_set_step(1);
+  {
+    systimestamp_t stamp, last;
+    unsigned i;
+
+    last = chVTGetTimeStamp();
+    for (i = 0U; i < 4U; i++) {
+      systime_t time = chVTGetSystemTimeX();
+      while (time == chVTGetSystemTimeX()) {
+#if defined(SIMULATOR)
+        _sim_check_for_interrupts();
+#endif
+      }
+      stamp = chVTGetTimeStamp();
+      test_assert(stamp > last, "not monotonic");
+      last = stamp;
+    }
+  }
+
+  /* [2.7.2] Sleeping until a time stamp 10mS in the future, the thread
+     must not be woken up before.*/
+  test_set_step(2);
+  {
+    systimestamp_t target = chVTGetTimeStamp() + (systimestamp_t)TIME_MS2I(10);
+
+    chThdSleepUntilTimeStamp(target);
+    test_assert(chVTGetTimeStamp() >= target, "woken up too early");
+  }
+
+  /* [2.7.3] Sleeping until a time stamp in the past, the function must
+     return immediately.*/
+  test_set_step(3);
+  {
+    systime_t time = chVTGetSystemTimeX();
+
+    chThdSleepUntilTimeStamp((systimestamp_t)0);
+    test_assert_time_window(time, chTimeAddX(time, 2), "not immediate");
+  }
+}
+
+static const testcase_t rt_test_002_007 = {
+  "Time stamps",
+  NULL,
+  NULL,
+  rt_test_002_007_execute
+};
+#endif /* CH_CFG_USE_TIMESTAMP == TRUE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -277,6 +494,13 @@ const testcase_t * const rt_test_sequence_002_array[] = {
   &rt_test_002_002,
   &rt_test_002_003,
   &rt_test_002_004,
+#if (CH_CFG_USE_TM_HISTOGRAM == TRUE) || defined(__DOXYGEN__)
+  &rt_test_002_005,
+#endif
+  &rt_test_002_006,
+#if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
+  &rt_test_002_007,
+#endif
   NULL
 };
 
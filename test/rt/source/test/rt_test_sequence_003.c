@@ -34,6 +34,15 @@
  * - @subpage rt_test_003_002
  * - @subpage rt_test_003_003
  * - @subpage rt_test_003_004
+ * - @subpage rt_test_003_005
+ * - @subpage rt_test_003_006
+ * - @subpage rt_test_003_007
+ * - @subpage rt_test_003_008
+ * - @subpage rt_test_003_009
+ * - @subpage rt_test_003_010
+ * - @subpage rt_test_003_011
+ * - @subpage rt_test_003_012
+ * - @subpage rt_test_003_013
  * .
  */
 
@@ -46,6 +55,97 @@ static THD_FUNCTION(thread, p) {
   test_emit_token(*(char *)p);
 }
 
+#if ((CH_DBG_FILL_THREADS == TRUE) &&                                       \
+     ((CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE))) || \
+    defined(__DOXYGEN__)
+static THD_FUNCTION(stkthread, p) {
+  volatile uint8_t buf[THREADS_STACK_SIZE / 2];
+  unsigned i;
+
+  for (i = 0U; i < sizeof buf; i++) {
+    buf[i] = (uint8_t)~CH_DBG_STACK_FILL_VALUE;
+  }
+  test_emit_token(*(char *)p);
+}
+#endif
+
+#if (CH_CFG_USE_WORKQUEUES == TRUE) || defined(__DOXYGEN__)
+static work_queue_t wq1;
+
+static void work_emit(void *p) {
+
+  test_emit_token(*(char *)p);
+}
+
+static void work_exit(void *p) {
+
+  (void)p;
+  chThdExit(MSG_OK);
+}
+#endif
+
+#if (CH_CFG_USE_BUDGET == TRUE) || defined(__DOXYGEN__)
+static thread_budget_t budget1;
+#endif
+
+#if ((CH_CFG_EDF_PRIO > 0) && (CH_CFG_EDF_PRIO < 255)) || defined(__DOXYGEN__)
+static thread_t *edf_thread(unsigned i, const char *name, systime_t deadline) {
+  thread_descriptor_t td = {
+    name,
+    (stkalign_t *)wa[i],
+    (stkalign_t *)((uint8_t *)wa[i] + WA_SIZE),
+    (tprio_t)CH_CFG_EDF_PRIO,
+    thread,
+    (void *)name
+  };
+  thread_t *tp;
+
+  tp = chThdCreateSuspended(&td);
+  tp->deadline = deadline;
+
+  return chThdStart(tp);
+}
+#endif
+
+#if (CH_CFG_USE_PERIODIC == TRUE) || defined(__DOXYGEN__)
+static periodic_thread_t pt1;
+
+static THD_FUNCTION(periodic_thread, p) {
+
+  (void)p;
+  test_emit_token('A');
+  test_emit_token(chThdWaitNextPeriod() == MSG_OK ? 'B' : 'X');
+  chThdSleep((sysinterval_t)25);
+  test_emit_token(chThdWaitNextPeriod() == MSG_TIMEOUT ? 'C' : 'X');
+  test_emit_token(chThdWaitNextPeriod() == MSG_OK ? 'D' : 'X');
+}
+#endif
+
+#if (CH_DBG_WAIT_PROFILE == TRUE) || defined(__DOXYGEN__)
+static thread_reference_t wptr;
+
+static THD_FUNCTION(wprof_thread, p) {
+
+  chSysLock();
+  (void) chThdSuspendS(&wptr);
+  chSysUnlock();
+  test_emit_token(*(char *)p);
+}
+
+static bool wprof_find(thread_t *tp, void *objp, tstate_t state,
+                       wait_profile_entry_t *wpep) {
+  unsigned i;
+
+  for (i = 0U; i < (unsigned)CH_DBG_WAIT_PROFILE_ENTRIES; i++) {
+    if (chWaitProfileGetEntry(i, wpep) && (wpep->tp == tp) &&
+        (wpep->objp == objp) && (wpep->state == state)) {
+      return true;
+    }
+  }
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -70,6 +170,8 @@ static THD_FUNCTION(thread, p) {
  *   for 1 second and on exit the system time is verified again.
  * - [3.1.5] Function chThdSleepUntil() is tested with a timeline of
  *   "now" + 100 ticks.
+ * - [3.1.6] Function chThdSleepWithSlack() is tested with a delay of
+ *   100 ticks and a slack of 10 ticks.
  * .
  */
 
@@ -133,6 +235,17 @@ static void rt_test_003_001_execute(void) {
                             chTimeAddX(time, 100 + CH_CFG_ST_TIMEDELTA + 1),
                             "out of time window");
   }
+
+  /* [3.1.6] Function chThdSleepWithSlack() is tested with a delay of
+     100 ticks and a slack of 10 ticks.*/
+  test_set_step(6);
+  {
+    time = chVTGetSystemTimeX();
+    chThdSleepWithSlack(100, 10);
+    test_assert_time_window(chTimeAddX(time, 100),
+                            chTimeAddX(time, 100 + 10 + CH_CFG_ST_TIMEDELTA + 1),
+                            "out of time window");
+  }
 }
 
 static const testcase_t rt_test_003_001 = {
@@ -325,6 +438,729 @@ static const testcase_t rt_test_003_004 = {
 };
 #endif /* CH_CFG_USE_MUTEXES */
 
+#if (CH_CFG_USE_WORKQUEUES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_003_005 [3.5] Work queues functionality
+ *
+ * <h2>Description</h2>
+ * A work queue served by a worker thread is created, works and delayed
+ * works are submitted and canceled, the execution order is tested.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_WORKQUEUES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [3.5.1] Initializing the works and creating a worker thread at
+ *   priority P(+1).
+ * - [3.5.2] Submitting three works in a critical zone, submitting a
+ *   pending work must fail, the works must be executed in submission
+ *   order.
+ * - [3.5.3] Submitting works and canceling one of them before the worker
+ *   is able to execute it.
+ * - [3.5.4] Submitting a delayed work, it must be executed after the
+ *   delay.
+ * - [3.5.5] Submitting and canceling a delayed work, it must not be
+ *   executed.
+ * - [3.5.6] Submitting a work terminating the worker thread.
+ * .
+ */
+
+static void rt_test_003_005_setup(void) {
+  chWorkQueueObjectInit(&wq1);
+}
+
+static void rt_test_003_005_execute(void) {
+  work_t w1, w2, w3, wexit;
+  delayed_work_t dw1;
+
+  /* [3.5.1] Initializing the works and creating a worker thread at
+     priority P(+1).*/
+  test_set_step(1);
+  {
+    chWorkObjectInit(&w1, work_emit, "A");
+    chWorkObjectInit(&w2, work_emit, "B");
+    chWorkObjectInit(&w3, work_emit, "C");
+    chWorkObjectInit(&wexit, work_exit, NULL);
+    chDelayedWorkObjectInit(&dw1, work_emit, "D");
+    threads[0] = chWorkQueueAddWorker(&wq1, wa[0], WA_SIZE, chThdGetPriorityX()+1, "worker");
+  }
+
+  /* [3.5.2] Submitting three works in a critical zone, submitting a
+     pending work must fail, the works must be executed in submission
+     order.*/
+  test_set_step(2);
+  {
+    bool b;
+
+    chSysLock();
+    (void) chWorkSubmitI(&wq1, &w1);
+    (void) chWorkSubmitI(&wq1, &w2);
+    (void) chWorkSubmitI(&wq1, &w3);
+    b = chWorkSubmitI(&wq1, &w1);
+    chSchRescheduleS();
+    chSysUnlock();
+    test_assert(b == false, "pending work submitted");
+    test_assert_sequence("ABC", "invalid sequence");
+  }
+
+  /* [3.5.3] Submitting works and canceling one of them before the worker
+     is able to execute it.*/
+  test_set_step(3);
+  {
+    bool b;
+
+    chSysLock();
+    (void) chWorkSubmitI(&wq1, &w1);
+    (void) chWorkSubmitI(&wq1, &w2);
+    (void) chWorkSubmitI(&wq1, &w3);
+    b = chWorkCancelI(&w2);
+    chSchRescheduleS();
+    chSysUnlock();
+    test_assert(b == true, "not canceled");
+    test_assert_sequence("AC", "invalid sequence");
+  }
+
+  /* [3.5.4] Submitting a delayed work, it must be executed after the
+     delay.*/
+  test_set_step(4);
+  {
+    chWorkSubmitDelayed(&wq1, &dw1, TIME_MS2I(50));
+    test_assert_lock(chDelayedWorkIsPendingI(&dw1), "not pending");
+    test_assert_sequence("", "executed too early");
+    chThdSleepMilliseconds(100);
+    test_assert_sequence("D", "invalid sequence");
+    test_assert_lock(!chDelayedWorkIsPendingI(&dw1), "still pending");
+  }
+
+  /* [3.5.5] Submitting and canceling a delayed work, it must not be
+     executed.*/
+  test_set_step(5);
+  {
+    bool b;
+
+    chWorkSubmitDelayed(&wq1, &dw1, TIME_MS2I(50));
+    chSysLock();
+    b = chWorkCancelDelayedI(&dw1);
+    chSysUnlock();
+    test_assert(b == true, "not canceled");
+    chThdSleepMilliseconds(100);
+    test_assert_sequence("", "canceled work executed");
+  }
+
+  /* [3.5.6] Submitting a work terminating the worker thread.*/
+  test_set_step(6);
+  {
+    (void) chWorkSubmit(&wq1, &wexit);
+    test_wait_threads();
+  }
+}
+
+static const testcase_t rt_test_003_005 = {
+  "Work queues functionality",
+  rt_test_003_005_setup,
+  NULL,
+  rt_test_003_005_execute
+};
+#endif /* CH_CFG_USE_WORKQUEUES == TRUE */
+
+#if ((CH_DBG_FILL_THREADS == TRUE) && ((CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE))) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_003_006 [3.6] Stack high-water mark
+ *
+ * <h2>Description</h2>
+ * Two threads are created, one of them uses a larger stack frame, the
+ * never used stack space of both threads is measured using
+ * chThdGetStackFreeX().
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_DBG_FILL_THREADS == TRUE) && ((CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE))
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [3.6.1] Creating a thread using a stack buffer and a thread not
+ *   using it, the threads are then terminated.
+ * - [3.6.2] Before running the threads only the initial context is on
+ *   the stacks, the free space must be the same.
+ * - [3.6.3] Measuring the stack space after execution, the used stack
+ *   must account for the thread activity and for the stack buffer.
+ * .
+ */
+
+static void rt_test_003_006_execute(void) {
+  thread_t *tp0, *tp1;
+  size_t free0, free1;
+
+  /* [3.6.1] Creating a thread using a stack buffer and a thread not using
+     it, the threads are then terminated.*/
+  test_set_step(1);
+  {
+    tp0 = threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()-1, stkthread, "A");
+    tp1 = threads[1] = chThdCreateStatic(wa[1], WA_SIZE, chThdGetPriorityX()-1, thread, "B");
+    free0 = chThdGetStackFreeX(tp0);
+    free1 = chThdGetStackFreeX(tp1);
+    test_wait_threads();
+    test_assert_sequence("AB", "invalid sequence");
+  }
+
+  /* [3.6.2] Before running the threads only the initial context is on
+     the stacks, the free space must be the same.*/
+  test_set_step(2);
+  {
+    test_assert((free0 > 0U) && (free0 < WA_SIZE), "wrong free space");
+    test_assert(free0 == free1, "different free space");
+  }
+
+  /* [3.6.3] Measuring the stack space after execution, the used stack
+     must account for the thread activity and for the stack buffer.*/
+  test_set_step(3);
+  {
+    test_assert(chThdGetStackFreeX(tp0) + (THREADS_STACK_SIZE / 2) <=
+                (size_t)((uint8_t *)tp0 - (uint8_t *)wa[0]), "buffer not accounted");
+    test_assert(chThdGetStackFreeX(tp1) < free1, "stack use not accounted");
+  }
+}
+
+static const testcase_t rt_test_003_006 = {
+  "Stack high-water mark",
+  NULL,
+  NULL,
+  rt_test_003_006_execute
+};
+#endif /* (CH_DBG_FILL_THREADS == TRUE) && ((CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE)) */
+
+#if (CH_CFG_USE_REGISTRY == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_003_007 [3.7] Registry snapshot
+ *
+ * <h2>Description</h2>
+ * A registry snapshot is taken while two threads are ready then the
+ * records are checked against the registry content.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_REGISTRY == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [3.7.1] Creating two threads with lower priority, they cannot run
+ *   before the snapshot is taken.
+ * - [3.7.2] Counting the threads in the registry then taking a
+ *   snapshot, the number of records must match.
+ * - [3.7.3] The records of the created threads are checked, they are
+ *   the newest threads in the registry.
+ * - [3.7.4] Terminating the threads, snapshots limited to zero and one
+ *   records are taken.
+ * .
+ */
+
+static void rt_test_003_007_execute(void) {
+  thread_snapshot_t snap[8];
+  thread_t *tp;
+  size_t cnt, n;
+
+  /* [3.7.1] Creating two threads with lower priority, they cannot run
+     before the snapshot is taken.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()-1, thread, "A");
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, chThdGetPriorityX()-2, thread, "B");
+  }
+
+  /* [3.7.2] Counting the threads in the registry then taking a
+     snapshot, the number of records must match.*/
+  test_set_step(2);
+  {
+    cnt = 0U;
+    tp = chRegFirstThread();
+    do {
+      cnt++;
+      tp = chRegNextThread(tp);
+    } while (tp != NULL);
+    n = chRegSnapshot(snap, 8U);
+    test_assert(n == ((cnt < 8U) ? cnt : 8U), "wrong records count");
+  }
+
+  /* [3.7.3] The records of the created threads are checked, they are
+     the newest threads in the registry.*/
+  test_set_step(3);
+  {
+    if (cnt <= 8U) {
+      test_assert(snap[n - 2U].tp == threads[0], "thread A not found");
+      test_assert(snap[n - 1U].tp == threads[1], "thread B not found");
+      test_assert(snap[n - 2U].name == chRegGetThreadNameX(threads[0]), "wrong name");
+      test_assert(snap[n - 1U].prio == chThdGetPriorityX() - 2, "wrong priority");
+      test_assert(snap[n - 1U].state == CH_STATE_READY, "wrong state");
+#if (CH_DBG_FILL_THREADS == TRUE) &&                                        \
+    ((CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE))
+      test_assert((snap[n - 1U].stkfree > 0U) && (snap[n - 1U].stkfree < WA_SIZE),
+                  "wrong free stack");
+#endif
+    }
+  }
+
+  /* [3.7.4] Terminating the threads, snapshots limited to zero and one
+     records are taken.*/
+  test_set_step(4);
+  {
+    test_wait_threads();
+    test_assert_sequence("AB", "invalid sequence");
+    test_assert(chRegSnapshot(snap, 0U) == 0U, "wrong records count");
+    test_assert(chRegSnapshot(snap, 1U) == 1U, "wrong records count");
+  }
+}
+
+static const testcase_t rt_test_003_007 = {
+  "Registry snapshot",
+  NULL,
+  NULL,
+  rt_test_003_007_execute
+};
+#endif /* CH_CFG_USE_REGISTRY == TRUE */
+
+#if (CH_CFG_USE_BUDGET == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_003_008 [3.8] Threads execution budget
+ *
+ * <h2>Description</h2>
+ * A budget is assigned to the tester thread, the thread is demoted
+ * when the budget is used up and restored on replenishment.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_BUDGET == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [3.8.1] A budget of two ticks over a period of twenty ticks is
+ *   assigned, the priority must not change.
+ * - [3.8.2] Two ticks are charged to the thread, it must be demoted
+ *   when the budget is used up.
+ * - [3.8.3] Waiting for the replenishment, the priority must be
+ *   restored.
+ * - [3.8.4] The budget is removed, the priority must not change.
+ * .
+ */
+
+static void rt_test_003_008_teardown(void) {
+  if (chThdGetSelfX()->budgetp != NULL) {
+    chThdClearBudget();
+  }
+}
+
+static void rt_test_003_008_execute(void) {
+  tprio_t prio;
+
+  /* [3.8.1] A budget of two ticks over a period of twenty ticks is
+     assigned, the priority must not change.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+    chThdSetBudget(&budget1, (sysinterval_t)2, (sysinterval_t)20, prio - 1);
+    test_assert(chThdGetPriorityX() == prio, "priority changed");
+  }
+
+  /* [3.8.2] Two ticks are charged to the thread, it must be demoted
+     when the budget is used up.*/
+  test_set_step(2);
+  {
+    chSysLock();
+    _thread_budget_tick(chThdGetSelfX());
+    _thread_budget_tick(chThdGetSelfX());
+    chSysUnlock();
+    test_assert(chThdGetPriorityX() == prio - 1, "not demoted");
+  }
+
+  /* [3.8.3] Waiting for the replenishment, the priority must be
+     restored.*/
+  test_set_step(3);
+  {
+    chThdSleep((sysinterval_t)30);
+    test_assert(chThdGetPriorityX() == prio, "not restored");
+  }
+
+  /* [3.8.4] The budget is removed, the priority must not change.*/
+  test_set_step(4);
+  {
+    chThdClearBudget();
+    test_assert(chThdGetSelfX()->budgetp == NULL, "budget not removed");
+    test_assert(chThdGetPriorityX() == prio, "priority changed");
+  }
+}
+
+static const testcase_t rt_test_003_008 = {
+  "Threads execution budget",
+  NULL,
+  rt_test_003_008_teardown,
+  rt_test_003_008_execute
+};
+#endif /* CH_CFG_USE_BUDGET == TRUE */
+
+#if ((CH_CFG_EDF_PRIO > 0) && (CH_CFG_EDF_PRIO < 255)) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_003_009 [3.9] EDF priority band
+ *
+ * <h2>Description</h2>
+ * Threads in the EDF priority band are created with different
+ * deadlines, they must be executed in deadline order regardless of the
+ * creation order.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_EDF_PRIO > 0) && (CH_CFG_EDF_PRIO < 255)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [3.9.1] The tester priority is raised above the band then four
+ *   threads are created in the band, they cannot run before the
+ *   priority is restored.
+ * - [3.9.2] The tester priority is restored, the threads must have
+ *   been executed in deadline order, threads with the same deadline in
+ *   creation order.
+ * .
+ */
+
+static void rt_test_003_009_execute(void) {
+  tprio_t prio;
+  systime_t now;
+
+  /* [3.9.1] The tester priority is raised above the band then four
+     threads are created in the band, they cannot run before the
+     priority is restored.*/
+  test_set_step(1);
+  {
+    prio = chThdSetPriority((tprio_t)CH_CFG_EDF_PRIO + 1);
+    now = chVTGetSystemTime();
+    threads[0] = edf_thread(0, "A", chTimeAddX(now, (sysinterval_t)300));
+    threads[1] = edf_thread(1, "B", chTimeAddX(now, (sysinterval_t)100));
+    threads[2] = edf_thread(2, "C", chTimeAddX(now, (sysinterval_t)200));
+    threads[3] = edf_thread(3, "D", chTimeAddX(now, (sysinterval_t)100));
+  }
+
+  /* [3.9.2] The tester priority is restored, the threads must have
+     been executed in deadline order, threads with the same deadline in
+     creation order.*/
+  test_set_step(2);
+  {
+    chThdSetPriority(prio);
+    test_wait_threads();
+    test_assert_sequence("BDCA", "invalid sequence");
+  }
+}
+
+static const testcase_t rt_test_003_009 = {
+  "EDF priority band",
+  NULL,
+  NULL,
+  rt_test_003_009_execute
+};
+#endif /* (CH_CFG_EDF_PRIO > 0) && (CH_CFG_EDF_PRIO < 255) */
+
+#if (CH_CFG_USE_PERIODIC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_003_010 [3.10] Periodic threads
+ *
+ * <h2>Description</h2>
+ * A periodic thread with a period of ten ticks is created, one of its
+ * activations lasts longer than two periods, the missed releases must
+ * be reported and accounted.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_PERIODIC == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [3.10.1] The periodic thread is created and the test waits for its
+ *   termination, the releases must happen on schedule except the ones
+ *   missed during the long activation.
+ * - [3.10.2] The missed releases are checked, the long activation
+ *   covered two releases.
+ * .
+ */
+
+static void rt_test_003_010_execute(void) {
+  thread_descriptor_t td = {
+    "periodic",
+    (stkalign_t *)wa[0],
+    (stkalign_t *)((uint8_t *)wa[0] + WA_SIZE),
+    chThdGetPriorityX() + 1,
+    periodic_thread,
+    NULL
+  };
+  systime_t time;
+
+  /* [3.10.1] The periodic thread is created and the test waits for its
+     termination, the releases must happen on schedule except the ones
+     missed during the long activation.*/
+  test_set_step(1);
+  {
+    time = chVTGetSystemTime();
+    threads[0] = chPeriodicThreadCreate(&pt1, &td, (sysinterval_t)10);
+    test_wait_threads();
+    test_assert_sequence("ABCD", "invalid sequence");
+    test_assert_time_window(chTimeAddX(time, (sysinterval_t)40),
+                            chTimeAddX(time, (sysinterval_t)40 + CH_CFG_ST_TIMEDELTA + 1),
+                            "out of time window");
+  }
+
+  /* [3.10.2] The missed releases are checked, the long activation
+     covered two releases.*/
+  test_set_step(2);
+  {
+    test_assert(chPeriodicGetOverrunsX(&pt1) == 2U, "wrong overruns count");
+  }
+}
+
+static const testcase_t rt_test_003_010 = {
+  "Periodic threads",
+  NULL,
+  NULL,
+  rt_test_003_010_execute
+};
+#endif /* CH_CFG_USE_PERIODIC == TRUE */
+
+#if (CH_DBG_WAIT_PROFILE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_003_011 [3.11] Wait profiler
+ *
+ * <h2>Description</h2>
+ * The waits of the test thread and of a suspended thread are recorded
+ * by the wait profiler, the entries are then checked.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_DBG_WAIT_PROFILE == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [3.11.1] The table is reset and the test thread sleeps, the wait
+ *   must be recorded as a timeout without waker.
+ * - [3.11.2] A thread suspends itself on a reference and it is resumed
+ *   by the test thread, the wait must be attributed to the reference
+ *   and the waker must be the test thread.
+ * .
+ */
+
+static void rt_test_003_011_execute(void) {
+  wait_profile_entry_t wpe;
+  thread_t *tp;
+
+  /* [3.11.1] The table is reset and the test thread sleeps, the wait
+     must be recorded as a timeout without waker.*/
+  test_set_step(1);
+  {
+    chWaitProfileReset();
+    chThdSleep((sysinterval_t)10);
+    test_assert(wprof_find(chThdGetSelfX(), NULL, CH_STATE_SLEEPING, &wpe),
+                "entry not found");
+    test_assert(wpe.n == (ucnt_t)1, "wrong waits count");
+    test_assert(wpe.n_timeout == (ucnt_t)1, "wrong timeouts count");
+    test_assert(wpe.waker == NULL, "wrong waker");
+    test_assert(wpe.worst > (rtcnt_t)0, "wait time not recorded");
+  }
+
+  /* [3.11.2] A thread suspends itself on a reference and it is resumed
+     by the test thread, the wait must be attributed to the reference
+     and the waker must be the test thread.*/
+  test_set_step(2);
+  {
+    tp = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() + 1,
+                           wprof_thread, "A");
+    threads[0] = tp;
+    chThdResume(&wptr, MSG_OK);
+    test_wait_threads();
+    test_assert_sequence("A", "invalid sequence");
+    test_assert(wprof_find(tp, (void *)&wptr, CH_STATE_SUSPENDED, &wpe),
+                "entry not found");
+    test_assert(wpe.n == (ucnt_t)1, "wrong waits count");
+    test_assert(wpe.n_timeout == (ucnt_t)0, "wrong timeouts count");
+    test_assert(wpe.waker == chThdGetSelfX(), "wrong waker");
+  }
+}
+
+static const testcase_t rt_test_003_011 = {
+  "Wait profiler",
+  NULL,
+  NULL,
+  rt_test_003_011_execute
+};
+#endif /* CH_DBG_WAIT_PROFILE == TRUE */
+
+#if (CH_CFG_USE_REGISTRY == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_003_012 [3.12] Registry lookups
+ *
+ * <h2>Description</h2>
+ * Threads are looked up in the registry by name and by pointer, the
+ * lookups are repeated after renaming and terminating the threads.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_REGISTRY == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [3.12.1] Creating two threads with lower priority, they cannot run
+ *   before the lookups are performed.
+ * - [3.12.2] The threads are looked up by name, an unknown name must not
+ *   be found.
+ * - [3.12.3] The threads are looked up by pointer, a pointer not belonging
+ *   to a thread must not be found.
+ * - [3.12.4] A thread is renamed, it must only be found under the new
+ *   name.
+ * - [3.12.5] Terminating the threads, they must no more be found.
+ * .
+ */
+
+static void rt_test_003_012_execute(void) {
+  thread_t *tp;
+
+  /* [3.12.1] Creating two threads with lower priority, they cannot run
+     before the lookups are performed.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()-1, thread, "A");
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, chThdGetPriorityX()-2, thread, "B");
+    chRegSetThreadNameX(threads[0], "A");
+    chRegSetThreadNameX(threads[1], "B");
+  }
+
+  /* [3.12.2] The threads are looked up by name, an unknown name must not
+     be found.*/
+  test_set_step(2);
+  {
+    tp = chRegFindThreadByName("A");
+    test_assert(tp == threads[0], "thread A not found");
+#if CH_CFG_USE_DYNAMIC == TRUE
+    chThdRelease(tp);
+#endif
+    tp = chRegFindThreadByName("B");
+    test_assert(tp == threads[1], "thread B not found");
+#if CH_CFG_USE_DYNAMIC == TRUE
+    chThdRelease(tp);
+#endif
+    test_assert(chRegFindThreadByName("unknown") == NULL, "unknown name found");
+  }
+
+  /* [3.12.3] The threads are looked up by pointer, a pointer not belonging
+     to a thread must not be found.*/
+  test_set_step(3);
+  {
+    tp = chRegFindThreadByPointer(threads[0]);
+    test_assert(tp == threads[0], "thread A not found");
+#if CH_CFG_USE_DYNAMIC == TRUE
+    chThdRelease(tp);
+#endif
+    test_assert(chRegFindThreadByPointer((thread_t *)&tp) == NULL,
+                "invalid pointer found");
+  }
+
+  /* [3.12.4] A thread is renamed, it must only be found under the new
+     name.*/
+  test_set_step(4);
+  {
+    chRegSetThreadNameX(threads[1], "C");
+    test_assert(chRegFindThreadByName("B") == NULL, "old name found");
+    tp = chRegFindThreadByName("C");
+    test_assert(tp == threads[1], "thread C not found");
+#if CH_CFG_USE_DYNAMIC == TRUE
+    chThdRelease(tp);
+#endif
+  }
+
+  /* [3.12.5] Terminating the threads, they must no more be found.*/
+  test_set_step(5);
+  {
+    test_wait_threads();
+    test_assert_sequence("AB", "invalid sequence");
+    test_assert(chRegFindThreadByName("A") == NULL, "thread A found");
+    test_assert(chRegFindThreadByName("C") == NULL, "thread C found");
+  }
+}
+
+static const testcase_t rt_test_003_012 = {
+  "Registry lookups",
+  NULL,
+  NULL,
+  rt_test_003_012_execute
+};
+#endif /* CH_CFG_USE_REGISTRY == TRUE */
+
+#if (CH_CFG_USE_THREADS_TABLE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_003_013 [3.13] Static threads table
+ *
+ * <h2>Description</h2>
+ * The thread declared in the application threads table is checked, it
+ * must have been created and started by chSysInit().
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_THREADS_TABLE == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [3.13.1] The table thread must have run and received its argument,
+ *   its descriptor must be at the end of its working area.
+ * - [3.13.2] The table thread must be sleeping.
+ * - [3.13.3] The table thread must be in the registry.
+ * .
+ */
+
+static void rt_test_003_013_execute(void) {
+
+  /* [3.13.1] The table thread must have run and received its argument,
+     its descriptor must be at the end of its working area.*/
+  test_set_step(1);
+  {
+    test_assert(test_table_tp != NULL, "table thread not started");
+    test_assert(test_table_arg == (void *)wa_test_table, "wrong argument");
+    test_assert(((uint8_t *)test_table_tp > (uint8_t *)wa_test_table) &&
+                ((uint8_t *)test_table_tp < ((uint8_t *)wa_test_table +
+                                             sizeof (wa_test_table))),
+                "not within the working area");
+  }
+
+  /* [3.13.2] The table thread must be sleeping.*/
+  test_set_step(2);
+  {
+    test_assert_lock(test_table_tp->state == CH_STATE_SLEEPING,
+                     "not sleeping");
+  }
+
+  /* [3.13.3] The table thread must be in the registry.*/
+  test_set_step(3);
+  {
+#if CH_CFG_USE_REGISTRY == TRUE
+    thread_t *tp = chRegFindThreadByPointer(test_table_tp);
+    test_assert(tp == test_table_tp, "not in registry");
+#if CH_CFG_USE_DYNAMIC == TRUE
+    chThdRelease(tp);
+#endif
+#endif
+  }
+}
+
+static const testcase_t rt_test_003_013 = {
+  "Static threads table",
+  NULL,
+  NULL,
+  rt_test_003_013_execute
+};
+#endif /* CH_CFG_USE_THREADS_TABLE == TRUE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -338,6 +1174,33 @@ const testcase_t * const rt_test_sequence_003_array[] = {
   &rt_test_003_003,
 #if (CH_CFG_USE_MUTEXES) || defined(__DOXYGEN__)
   &rt_test_003_004,
+#endif
+#if (CH_CFG_USE_WORKQUEUES == TRUE) || defined(__DOXYGEN__)
+  &rt_test_003_005,
+#endif
+#if ((CH_DBG_FILL_THREADS == TRUE) && ((CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE))) || defined(__DOXYGEN__)
+  &rt_test_003_006,
+#endif
+#if (CH_CFG_USE_REGISTRY == TRUE) || defined(__DOXYGEN__)
+  &rt_test_003_007,
+#endif
+#if (CH_CFG_USE_BUDGET == TRUE) || defined(__DOXYGEN__)
+  &rt_test_003_008,
+#endif
+#if ((CH_CFG_EDF_PRIO > 0) && (CH_CFG_EDF_PRIO < 255)) || defined(__DOXYGEN__)
+  &rt_test_003_009,
+#endif
+#if (CH_CFG_USE_PERIODIC == TRUE) || defined(__DOXYGEN__)
+  &rt_test_003_010,
+#endif
+#if (CH_DBG_WAIT_PROFILE == TRUE) || defined(__DOXYGEN__)
+  &rt_test_003_011,
+#endif
+#if (CH_CFG_USE_REGISTRY == TRUE) || defined(__DOXYGEN__)
+  &rt_test_003_012,
+#endif
+#if (CH_CFG_USE_THREADS_TABLE == TRUE) || defined(__DOXYGEN__)
+  &rt_test_003_013,
 #endif
   NULL
 };
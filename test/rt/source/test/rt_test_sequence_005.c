@@ -42,6 +42,10 @@
  * - @subpage rt_test_005_004
  * - @subpage rt_test_005_005
  * - @subpage rt_test_005_006
+ * - @subpage rt_test_005_007
+ * - @subpage rt_test_005_008
+ * - @subpage rt_test_005_009
+ * - @subpage rt_test_005_010
  * .
  */
 
@@ -83,6 +87,20 @@ static THD_FUNCTION(thread4, p) {
   chBSemSignal((binary_semaphore_t *)p);
 }
 
+static THD_FUNCTION(thread5, p) {
+
+  chFSemWait((fast_semaphore_t *)p);
+  test_emit_token('A');
+}
+
+#if ((CH_CFG_USE_WAIT_MULTIPLE == TRUE) && (CH_CFG_USE_EVENTS == TRUE)) || defined(__DOXYGEN__)
+static THD_FUNCTION(thread6, p) {
+
+  chThdSleepMilliseconds(50);
+  chEvtSignal((thread_t *)p, (eventmask_t)1);
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -488,6 +506,344 @@ static const testcase_t rt_test_005_006 = {
   rt_test_005_006_execute
 };
 
+/**
+ * @page rt_test_005_007 [5.7] Multiple signal operations
+ *
+ * <h2>Description</h2>
+ * The function chSemSignalN() is tested, all the waiting threads are
+ * awakened by a single call and the excess is added to the counter.
+ *
+ * <h2>Test Steps</h2>
+ * - [5.7.1] Three threads with priorities higher than the tester are
+ *   created, they enqueue on the semaphore initialized to zero.
+ * - [5.7.2] The function chSemSignalN() is invoked with a value greater
+ *   than the number of waiting threads, the activation sequence and the
+ *   counter are tested.
+ * .
+ */
+
+static void rt_test_005_007_setup(void) {
+  chSemObjectInit(&sem1, 0);
+}
+
+static void rt_test_005_007_execute(void) {
+
+  /* [5.7.1] Three threads with priorities higher than the tester are
+     created, they enqueue on the semaphore initialized to zero.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()+1, thread1, "A");
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, chThdGetPriorityX()+2, thread1, "B");
+    threads[2] = chThdCreateStatic(wa[2], WA_SIZE, chThdGetPriorityX()+3, thread1, "C");
+  }
+
+  /* [5.7.2] The function chSemSignalN() is invoked with a value greater
+     than the number of waiting threads, the activation sequence and the
+     counter are tested.*/
+  test_set_step(2);
+  {
+    chSemSignalN(&sem1, 4);
+    test_wait_threads();
+    test_assert_sequence("CBA", "invalid sequence");
+    test_assert_lock(chSemGetCounterI(&sem1) == 1, "wrong counter value");
+  }
+}
+
+static const testcase_t rt_test_005_007 = {
+  "Multiple signal operations",
+  rt_test_005_007_setup,
+  NULL,
+  rt_test_005_007_execute
+};
+
+#if (CH_CFG_USE_SCHED_BATCH == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_005_008 [5.8] Scheduler batch
+ *
+ * <h2>Description</h2>
+ * The reschedule points reached inside a scheduler batch are deferred to
+ * the end of the batch.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_SCHED_BATCH == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [5.8.1] Three threads with priorities higher than the tester are
+ *   created, they enqueue on the semaphore initialized to zero.
+ * - [5.8.2] A batch is opened and the semaphore is signaled three times,
+ *   the threads must be ready but not yet executed when the batch is
+ *   closed.
+ * - [5.8.3] The activation sequence is tested, the threads must have
+ *   been executed in priority order after the end of the batch.
+ * .
+ */
+
+static void rt_test_005_008_setup(void) {
+  chSemObjectInit(&sem1, 0);
+}
+
+static void rt_test_005_008_execute(void) {
+
+  /* [5.8.1] Three threads with priorities higher than the tester are
+     created, they enqueue on the semaphore initialized to zero.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()+1, thread1, "A");
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, chThdGetPriorityX()+2, thread1, "B");
+    threads[2] = chThdCreateStatic(wa[2], WA_SIZE, chThdGetPriorityX()+3, thread1, "C");
+  }
+
+  /* [5.8.2] A batch is opened and the semaphore is signaled three times,
+     the threads must be ready but not yet executed when the batch is
+     closed.*/
+  test_set_step(2);
+  {
+    bool ready;
+
+    chSchBatchBegin();
+    chSemSignal(&sem1);
+    chSemSignal(&sem1);
+    chSemSignal(&sem1);
+    ready = (threads[0]->state == CH_STATE_READY) &&
+            (threads[1]->state == CH_STATE_READY) &&
+            (threads[2]->state == CH_STATE_READY);
+    chSchBatchEnd();
+    test_assert(ready, "threads executed inside the batch");
+  }
+
+  /* [5.8.3] The activation sequence is tested, the threads must have been
+     executed in priority order after the end of the batch.*/
+  test_set_step(3);
+  {
+    test_wait_threads();
+    test_assert_sequence("CBA", "invalid sequence");
+  }
+}
+
+static const testcase_t rt_test_005_008 = {
+  "Scheduler batch",
+  rt_test_005_008_setup,
+  NULL,
+  rt_test_005_008_execute
+};
+#endif /* CH_CFG_USE_SCHED_BATCH == TRUE */
+
+/**
+ * @page rt_test_005_009 [5.9] Fast semaphores functionality
+ *
+ * <h2>Description</h2>
+ * The fast semaphores APIs are tested, the fast path is taken when the
+ * counter is positive and the threads are queued on the semaphore when
+ * it is not.
+ *
+ * <h2>Test Steps</h2>
+ * - [5.9.1] Initializing the fast semaphore with counter two, two wait
+ *   operations must not block.
+ * - [5.9.2] Waiting on the fast semaphore with timeout, the counter must
+ *   be restored after the timeout.
+ * - [5.9.3] Creating a thread that waits on the fast semaphore, the
+ *   counter must become negative.
+ * - [5.9.4] Signaling the fast semaphore, the thread must be resumed.
+ * - [5.9.5] Signaling the fast semaphore twice, the counter must be
+ *   increased.
+ * .
+ */
+
+static void rt_test_005_009_execute(void) {
+  fast_semaphore_t fsem;
+
+  /* [5.9.1] Initializing the fast semaphore with counter two, two wait
+     operations must not block.*/
+  test_set_step(1);
+  {
+    msg_t msg;
+
+    chFSemObjectInit(&fsem, 2);
+    msg = chFSemWait(&fsem);
+    test_assert(msg == MSG_OK, "wrong returned message");
+    msg = chFSemWait(&fsem);
+    test_assert(msg == MSG_OK, "wrong returned message");
+    test_assert_lock(chFSemGetCounterI(&fsem) == 0, "wrong counter value");
+  }
+
+  /* [5.9.2] Waiting on the fast semaphore with timeout, the counter must
+     be restored after the timeout.*/
+  test_set_step(2);
+  {
+    msg_t msg;
+
+    msg = chFSemWaitTimeout(&fsem, TIME_IMMEDIATE);
+    test_assert(msg == MSG_TIMEOUT, "wrong returned message");
+    test_assert_lock(chFSemGetCounterI(&fsem) == 0, "wrong counter value");
+    msg = chFSemWaitTimeout(&fsem, TIME_MS2I(10));
+    test_assert(msg == MSG_TIMEOUT, "wrong returned message");
+    test_assert_lock(chFSemGetCounterI(&fsem) == 0, "wrong counter value");
+  }
+
+  /* [5.9.3] Creating a thread that waits on the fast semaphore, the
+     counter must become negative.*/
+  test_set_step(3);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()+1, thread5, &fsem);
+    test_assert_lock(chFSemGetCounterI(&fsem) == -1, "wrong counter value");
+  }
+
+  /* [5.9.4] Signaling the fast semaphore, the thread must be resumed.*/
+  test_set_step(4);
+  {
+    chFSemSignal(&fsem);
+    test_wait_threads();
+    test_assert_sequence("A", "invalid sequence");
+    test_assert_lock(chFSemGetCounterI(&fsem) == 0, "wrong counter value");
+  }
+
+  /* [5.9.5] Signaling the fast semaphore twice, the counter must be
+     increased.*/
+  test_set_step(5);
+  {
+    chFSemSignal(&fsem);
+    chFSemSignal(&fsem);
+    test_assert_lock(chFSemGetCounterI(&fsem) == 2, "wrong counter value");
+  }
+}
+
+static const testcase_t rt_test_005_009 = {
+  "Fast semaphores functionality",
+  NULL,
+  NULL,
+  rt_test_005_009_execute
+};
+
+#if ((CH_CFG_USE_WAIT_MULTIPLE == TRUE) && (CH_CFG_USE_EVENTS == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_005_010 [5.10] Multiple objects wait
+ *
+ * <h2>Description</h2>
+ * A thread waits on a semaphore and on an event at the same time, the wait
+ * returns when any object or all the objects are ready and the ready
+ * objects are marked.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_WAIT_MULTIPLE == TRUE) && (CH_CFG_USE_EVENTS == TRUE)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [5.10.1] Initializing the semaphore to zero, waiting with immediate
+ *   timeout on the semaphore and on an event must fail and no objects must
+ *   be ready.
+ * - [5.10.2] A thread signals the semaphore after a delay, the wait on any
+ *   object must return with only the semaphore ready, the semaphore is
+ *   then taken without blocking.
+ * - [5.10.3] A thread signals the event after a delay, the wait on any
+ *   object must return with only the event ready.
+ * - [5.10.4] The semaphore is signaled, waiting on all the objects must
+ *   timeout with only the semaphore ready.
+ * - [5.10.5] A thread signals the event after a delay, the wait on all the
+ *   objects must return with both objects ready.
+ * .
+ */
+
+static void rt_test_005_010_execute(void) {
+  wait_object_t objects[2];
+
+  /* [5.10.1] Initializing the semaphore to zero, waiting with immediate
+     timeout on the semaphore and on an event must fail and no objects must
+     be ready.*/
+  test_set_step(1);
+  {
+    msg_t msg;
+
+    chSemObjectInit(&sem1, 0);
+    chWaitObjectInitSem(&objects[0], &sem1);
+    chWaitObjectInitEvt(&objects[1], (eventmask_t)1);
+    (void) chEvtGetAndClearEvents(ALL_EVENTS);
+    msg = chWaitMultipleTimeout(objects, 2, CH_WAIT_ANY, TIME_IMMEDIATE);
+    test_assert(msg == MSG_TIMEOUT, "wrong returned message");
+    test_assert(!chWaitObjectIsReadyX(&objects[0]), "semaphore ready");
+    test_assert(!chWaitObjectIsReadyX(&objects[1]), "event ready");
+  }
+
+  /* [5.10.2] A thread signals the semaphore after a delay, the wait on any
+     object must return with only the semaphore ready, the semaphore is
+     then taken without blocking.*/
+  test_set_step(2);
+  {
+    msg_t msg;
+
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() - 1,
+                                   thread2, 0);
+    msg = chWaitMultipleTimeout(objects, 2, CH_WAIT_ANY, TIME_INFINITE);
+    test_wait_threads();
+    test_assert(msg == MSG_OK, "wrong returned message");
+    test_assert(chWaitObjectIsReadyX(&objects[0]), "semaphore not ready");
+    test_assert(!chWaitObjectIsReadyX(&objects[1]), "event ready");
+    msg = chSemWaitTimeout(&sem1, TIME_IMMEDIATE);
+    test_assert(msg == MSG_OK, "wrong returned message");
+  }
+
+  /* [5.10.3] A thread signals the event after a delay, the wait on any
+     object must return with only the event ready.*/
+  test_set_step(3);
+  {
+    msg_t msg;
+
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() - 1,
+                                   thread6, chThdGetSelfX());
+    msg = chWaitMultipleTimeout(objects, 2, CH_WAIT_ANY, TIME_INFINITE);
+    test_wait_threads();
+    test_assert(msg == MSG_OK, "wrong returned message");
+    test_assert(!chWaitObjectIsReadyX(&objects[0]), "semaphore ready");
+    test_assert(chWaitObjectIsReadyX(&objects[1]), "event not ready");
+    test_assert(chEvtGetAndClearEvents(ALL_EVENTS) == (eventmask_t)1,
+                "wrong pending events");
+  }
+
+  /* [5.10.4] The semaphore is signaled, waiting on all the objects must
+     timeout with only the semaphore ready.*/
+  test_set_step(4);
+  {
+    msg_t msg;
+
+    chSemSignal(&sem1);
+    msg = chWaitMultipleTimeout(objects, 2, CH_WAIT_ALL, TIME_MS2I(10));
+    test_assert(msg == MSG_TIMEOUT, "wrong returned message");
+    test_assert(chWaitObjectIsReadyX(&objects[0]), "semaphore not ready");
+    test_assert(!chWaitObjectIsReadyX(&objects[1]), "event ready");
+  }
+
+  /* [5.10.5] A thread signals the event after a delay, the wait on all the
+     objects must return with both objects ready.*/
+  test_set_step(5);
+  {
+    msg_t msg;
+
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() - 1,
+                                   thread6, chThdGetSelfX());
+    msg = chWaitMultipleTimeout(objects, 2, CH_WAIT_ALL, TIME_INFINITE);
+    test_wait_threads();
+    test_assert(msg == MSG_OK, "wrong returned message");
+    test_assert(chWaitObjectIsReadyX(&objects[0]), "semaphore not ready");
+    test_assert(chWaitObjectIsReadyX(&objects[1]), "event not ready");
+    (void) chEvtGetAndClearEvents(ALL_EVENTS);
+    msg = chSemWaitTimeout(&sem1, TIME_IMMEDIATE);
+    test_assert(msg == MSG_OK, "wrong returned message");
+    test_assert_lock(chSemGetCounterI(&sem1) == 0, "wrong counter value");
+  }
+}
+
+static const testcase_t rt_test_005_010 = {
+  "Multiple objects wait",
+  NULL,
+  NULL,
+  rt_test_005_010_execute
+};
+#endif /* (CH_CFG_USE_WAIT_MULTIPLE == TRUE) && (CH_CFG_USE_EVENTS == TRUE) */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -502,6 +858,14 @@ const testcase_t * const rt_test_sequence_005_array[] = {
   &rt_test_005_004,
   &rt_test_005_005,
   &rt_test_005_006,
+  &rt_test_005_007,
+#if (CH_CFG_USE_SCHED_BATCH == TRUE) || defined(__DOXYGEN__)
+  &rt_test_005_008,
+#endif
+  &rt_test_005_009,
+#if ((CH_CFG_USE_WAIT_MULTIPLE == TRUE) && (CH_CFG_USE_EVENTS == TRUE)) || defined(__DOXYGEN__)
+  &rt_test_005_010,
+#endif
   NULL
 };
 
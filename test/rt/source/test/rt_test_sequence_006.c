@@ -45,6 +45,12 @@
  * - @subpage rt_test_006_007
  * - @subpage rt_test_006_008
  * - @subpage rt_test_006_009
+ * - @subpage rt_test_006_010
+ * - @subpage rt_test_006_011
+ * - @subpage rt_test_006_012
+ * - @subpage rt_test_006_013
+ * - @subpage rt_test_006_014
+ * - @subpage rt_test_006_015
  * .
  */
 
@@ -228,6 +234,44 @@ static THD_FUNCTION(thread9, p) {
 }
 #endif /* CH_CFG_USE_CONDVARS */
 
+#if (CH_CFG_MUTEXES_SPIN_COUNT > 0) || defined(__DOXYGEN__)
+static THD_FUNCTION(thread10, p) {
+
+  chMtxLock(&m1);
+  chThdYield();
+  chMtxUnlock(&m1);
+  test_emit_token(*(char *)p);
+}
+#endif /* CH_CFG_MUTEXES_SPIN_COUNT > 0 */
+
+#if (CH_CFG_USE_RWLOCKS) || defined(__DOXYGEN__)
+static RWLOCK_DECL(rw1);
+
+static THD_FUNCTION(thread11, p) {
+
+  chRWLockReadLock(&rw1);
+  test_emit_token(*(char *)p);
+  chRWLockReadUnlock(&rw1);
+}
+
+static THD_FUNCTION(thread12, p) {
+
+  chRWLockWriteLock(&rw1);
+  test_emit_token(*(char *)p);
+  chRWLockWriteUnlock(&rw1);
+}
+
+static THD_FUNCTION(thread13, p) {
+
+  if (chRWLockWriteLockTimeout(&rw1, TIME_MS2I(50)) == MSG_OK) {
+    chRWLockWriteUnlock(&rw1);
+  }
+  else {
+    test_emit_token(*(char *)p);
+  }
+}
+#endif /* CH_CFG_USE_RWLOCKS */
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -1033,6 +1077,439 @@ static const testcase_t rt_test_006_009 = {
 };
 #endif /* CH_CFG_USE_CONDVARS */
 
+#if (CH_CFG_USE_MUTEXES_CEILING) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_006_010 [6.10] Priority ceiling test
+ *
+ * <h2>Description</h2>
+ * A mutex with a ceiling priority is locked, the priority of the owner
+ * must be raised to the ceiling immediately and a thread with priority
+ * between the base and the ceiling priority must not preempt the owner.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MUTEXES_CEILING
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [6.10.1] Getting the initial priority.
+ * - [6.10.2] Locking the mutex, the priority must be raised to the
+ *   ceiling.
+ * - [6.10.3] Creating a thread at priority P(+1) that locks the mutex,
+ *   it must not preempt the owner.
+ * - [6.10.4] Unlocking the mutex, the priority must return to the base
+ *   priority and the thread must complete.
+ * .
+ */
+
+static void rt_test_006_010_setup(void) {
+  chMtxObjectInitCeiling(&m1, chThdGetPriorityX()+2);
+}
+
+static void rt_test_006_010_execute(void) {
+  tprio_t prio;
+
+  /* [6.10.1] Getting the initial priority.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+  }
+
+  /* [6.10.2] Locking the mutex, the priority must be raised to the
+     ceiling.*/
+  test_set_step(2);
+  {
+    chMtxLock(&m1);
+    test_assert(chThdGetPriorityX() == prio+2, "not at ceiling priority");
+  }
+
+  /* [6.10.3] Creating a thread at priority P(+1) that locks the mutex, it
+     must not preempt the owner.*/
+  test_set_step(3);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+1, thread1, "B");
+    test_emit_token('A');
+  }
+
+  /* [6.10.4] Unlocking the mutex, the priority must return to the base
+     priority and the thread must complete.*/
+  test_set_step(4);
+  {
+    chMtxUnlock(&m1);
+    test_assert(chThdGetPriorityX() == prio, "wrong priority level");
+    test_wait_threads();
+    test_assert_sequence("AB", "invalid sequence");
+  }
+}
+
+static const testcase_t rt_test_006_010 = {
+  "Priority ceiling test",
+  rt_test_006_010_setup,
+  NULL,
+  rt_test_006_010_execute
+};
+#endif /* CH_CFG_USE_MUTEXES_CEILING */
+
+#if (CH_CFG_MUTEXES_SPIN_COUNT > 0) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_006_011 [6.11] Adaptive mutex test
+ *
+ * <h2>Description</h2>
+ * A thread at the same priority of the tester thread locks the mutex and
+ * yields, the tester thread tries to lock the mutex and yields back to
+ * the owner instead of sleeping on the mutex.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_MUTEXES_SPIN_COUNT > 0
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [6.11.1] Creating a thread at the same priority of the tester thread
+ *   and yielding to it, the thread locks the mutex and yields back.
+ * - [6.11.2] Locking the mutex, the owner is given the chance to unlock
+ *   it and complete before the lock is acquired.
+ * .
+ */
+
+static void rt_test_006_011_setup(void) {
+  chMtxObjectInit(&m1);
+}
+
+static void rt_test_006_011_execute(void) {
+
+  /* [6.11.1] Creating a thread at the same priority of the tester thread
+     and yielding to it, the thread locks the mutex and yields back.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX(), thread10, "A");
+    chThdYield();
+    test_assert(m1.owner == threads[0], "not owned");
+  }
+
+  /* [6.11.2] Locking the mutex, the owner is given the chance to unlock it
+     and complete before the lock is acquired.*/
+  test_set_step(2);
+  {
+    chMtxLock(&m1);
+    test_emit_token('B');
+    test_assert(m1.owner == chThdGetSelfX(), "not owner");
+    #if CH_DBG_STATISTICS == TRUE
+    test_assert(m1.n_spinacq == 1U, "not acquired by spinning");
+    #endif
+    chMtxUnlock(&m1);
+    test_wait_threads();
+    test_assert_sequence("AB", "invalid sequence");
+  }
+}
+
+static const testcase_t rt_test_006_011 = {
+  "Adaptive mutex test",
+  rt_test_006_011_setup,
+  NULL,
+  rt_test_006_011_execute
+};
+#endif /* CH_CFG_MUTEXES_SPIN_COUNT > 0 */
+
+#if (CH_CFG_USE_RWLOCKS) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_006_012 [6.12] Reader-writer lock writer preference test
+ *
+ * <h2>Description</h2>
+ * The lock is read locked by the tester thread, a writer and then a
+ * reader with higher priority are enqueued on the lock, the reader must
+ * be held back by the waiting writer.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_RWLOCKS
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [6.12.1] Getting the initial priority.
+ * - [6.12.2] Read locking the lock, a second read lock is allowed, a
+ *   write lock is not.
+ * - [6.12.3] Creating a writer at priority P(+1) and a reader at
+ *   priority P(+2), both must wait.
+ * - [6.12.4] Read unlocking the lock, the writer must complete before
+ *   the reader.
+ * .
+ */
+
+static void rt_test_006_012_setup(void) {
+  chRWLockObjectInit(&rw1);
+}
+
+static void rt_test_006_012_execute(void) {
+  tprio_t prio;
+
+  /* [6.12.1] Getting the initial priority.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+  }
+
+  /* [6.12.2] Read locking the lock, a second read lock is allowed, a write
+     lock is not.*/
+  test_set_step(2);
+  {
+    chRWLockReadLock(&rw1);
+    test_assert(chRWLockReadLockTimeout(&rw1, TIME_IMMEDIATE) == MSG_OK, "not read locked");
+    chRWLockReadUnlock(&rw1);
+    test_assert(chRWLockWriteLockTimeout(&rw1, TIME_IMMEDIATE) == MSG_TIMEOUT, "write locked");
+    test_assert_lock(chRWLockGetReadersI(&rw1) == 1, "wrong readers count");
+  }
+
+  /* [6.12.3] Creating a writer at priority P(+1) and a reader at priority
+     P(+2), both must wait.*/
+  test_set_step(3);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+1, thread12, "A");
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio+2, thread11, "B");
+    test_assert_sequence("", "not waiting");
+  }
+
+  /* [6.12.4] Read unlocking the lock, the writer must complete before the
+     reader.*/
+  test_set_step(4);
+  {
+    chRWLockReadUnlock(&rw1);
+    test_wait_threads();
+    test_assert_sequence("AB", "invalid sequence");
+    test_assert_lock(chRWLockGetReadersI(&rw1) == 0, "still read locked");
+    test_assert_lock(chRWLockGetWriterI(&rw1) == NULL, "still write locked");
+  }
+}
+
+static const testcase_t rt_test_006_012 = {
+  "Reader-writer lock writer preference test",
+  rt_test_006_012_setup,
+  NULL,
+  rt_test_006_012_execute
+};
+#endif /* CH_CFG_USE_RWLOCKS */
+
+#if (CH_CFG_USE_RWLOCKS) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_006_013 [6.13] Reader-writer lock priority inheritance test
+ *
+ * <h2>Description</h2>
+ * The lock is write locked by the tester thread, a reader with higher
+ * priority is enqueued on the lock, the writer must inherit the reader
+ * priority until the lock is released.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_RWLOCKS
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [6.13.1] Getting the initial priority.
+ * - [6.13.2] Write locking the lock.
+ * - [6.13.3] Creating a reader at priority P(+1), it must wait and boost
+ *   the writer priority.
+ * - [6.13.4] Write unlocking the lock, the priority must be restored and
+ *   the reader must complete.
+ * .
+ */
+
+static void rt_test_006_013_setup(void) {
+  chRWLockObjectInit(&rw1);
+}
+
+static void rt_test_006_013_execute(void) {
+  tprio_t prio;
+
+  /* [6.13.1] Getting the initial priority.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+  }
+
+  /* [6.13.2] Write locking the lock.*/
+  test_set_step(2);
+  {
+    chRWLockWriteLock(&rw1);
+    test_assert_lock(chRWLockGetWriterI(&rw1) == chThdGetSelfX(), "not owner");
+  }
+
+  /* [6.13.3] Creating a reader at priority P(+1), it must wait and boost
+     the writer priority.*/
+  test_set_step(3);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+1, thread11, "A");
+    test_assert(chThdGetPriorityX() == prio+1, "not boosted");
+    test_assert_sequence("", "not waiting");
+  }
+
+  /* [6.13.4] Write unlocking the lock, the priority must be restored and
+     the reader must complete.*/
+  test_set_step(4);
+  {
+    chRWLockWriteUnlock(&rw1);
+    test_assert(chThdGetPriorityX() == prio, "wrong priority level");
+    test_assert_sequence("A", "invalid sequence");
+    test_wait_threads();
+  }
+}
+
+static const testcase_t rt_test_006_013 = {
+  "Reader-writer lock priority inheritance test",
+  rt_test_006_013_setup,
+  NULL,
+  rt_test_006_013_execute
+};
+#endif /* CH_CFG_USE_RWLOCKS */
+
+#if (CH_CFG_USE_RWLOCKS) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_006_014 [6.14] Reader-writer lock timeout test
+ *
+ * <h2>Description</h2>
+ * The lock is read locked by the tester thread, a writer with timeout
+ * and a reader are enqueued on the lock, when the writer times out the
+ * reader must be able to acquire the lock.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_RWLOCKS
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [6.14.1] Getting the initial priority.
+ * - [6.14.2] Read locking the lock and creating a writer with timeout at
+ *   priority P(+1) and a reader at priority P(+2).
+ * - [6.14.3] Waiting for the writer timeout, the reader is resumed by
+ *   the writer and must complete while the lock is still read locked.
+ * .
+ */
+
+static void rt_test_006_014_setup(void) {
+  chRWLockObjectInit(&rw1);
+}
+
+static void rt_test_006_014_execute(void) {
+  tprio_t prio;
+
+  /* [6.14.1] Getting the initial priority.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+  }
+
+  /* [6.14.2] Read locking the lock and creating a writer with timeout at
+     priority P(+1) and a reader at priority P(+2).*/
+  test_set_step(2);
+  {
+    chRWLockReadLock(&rw1);
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+1, thread13, "A");
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio+2, thread11, "B");
+    test_assert_sequence("", "not waiting");
+  }
+
+  /* [6.14.3] Waiting for the writer timeout, the reader is resumed by
+     the writer and must complete while the lock is still read locked.*/
+  test_set_step(3);
+  {
+    chThdSleepMilliseconds(100);
+    test_assert_sequence("BA", "invalid sequence");
+    chRWLockReadUnlock(&rw1);
+    test_wait_threads();
+  }
+}
+
+static const testcase_t rt_test_006_014 = {
+  "Reader-writer lock timeout test",
+  rt_test_006_014_setup,
+  NULL,
+  rt_test_006_014_execute
+};
+#endif /* CH_CFG_USE_RWLOCKS */
+
+#if (CH_CFG_USE_CONDVARS) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_006_015 [6.15] Condition Variable equal priorities test
+ *
+ * <h2>Description</h2>
+ * Five threads, with mixed and repeated priorities, take a mutex and
+ * then enter a conditional variable queue, the tester thread then
+ * proceeds to signal the conditional variable. The test expects the
+ * threads to reach their goal in decreasing priority order and in
+ * arrival order among threads with the same priority.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_CONDVARS
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [6.15.1] Getting the initial priority.
+ * - [6.15.2] Starting the five threads, the threads will queue on the
+ *   condition variable, threads with the same priority are started in
+ *   alphabetical order.
+ * - [6.15.3] Atomically signaling the condition variable five times
+ *   then waiting for the threads to terminate, the order is tested.
+ * .
+ */
+
+static void rt_test_006_015_setup(void) {
+  chCondObjectInit(&c1);
+  chMtxObjectInit(&m1);
+}
+
+static void rt_test_006_015_execute(void) {
+  tprio_t prio;
+
+  /* [6.15.1] Getting the initial priority.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+  }
+
+  /* [6.15.2] Starting the five threads, the threads will queue on the
+     condition variable, threads with the same priority are started in
+     alphabetical order.*/
+  test_set_step(2);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+1, thread6, "D");
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio+2, thread6, "B");
+    threads[2] = chThdCreateStatic(wa[2], WA_SIZE, prio+1, thread6, "E");
+    threads[3] = chThdCreateStatic(wa[3], WA_SIZE, prio+2, thread6, "C");
+    threads[4] = chThdCreateStatic(wa[4], WA_SIZE, prio+3, thread6, "A");
+    test_assert_sequence("", "not waiting");
+  }
+
+  /* [6.15.3] Atomically signaling the condition variable five times
+     then waiting for the threads to terminate, the order is tested.*/
+  test_set_step(3);
+  {
+    chSysLock();
+    chCondSignalI(&c1);
+    chCondSignalI(&c1);
+    chCondSignalI(&c1);
+    chCondSignalI(&c1);
+    chCondSignalI(&c1);
+    chSchRescheduleS();
+    chSysUnlock();
+    test_wait_threads();
+    test_assert_sequence("ABCDE", "invalid sequence");
+  }
+}
+
+static const testcase_t rt_test_006_015 = {
+  "Condition Variable equal priorities test",
+  rt_test_006_015_setup,
+  NULL,
+  rt_test_006_015_execute
+};
+#endif /* CH_CFG_USE_CONDVARS */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -1063,6 +1540,24 @@ const testcase_t * const rt_test_sequence_006_array[] = {
 #endif
 #if (CH_CFG_USE_CONDVARS) || defined(__DOXYGEN__)
   &rt_test_006_009,
+#endif
+#if (CH_CFG_USE_MUTEXES_CEILING) || defined(__DOXYGEN__)
+  &rt_test_006_010,
+#endif
+#if (CH_CFG_MUTEXES_SPIN_COUNT > 0) || defined(__DOXYGEN__)
+  &rt_test_006_011,
+#endif
+#if (CH_CFG_USE_RWLOCKS) || defined(__DOXYGEN__)
+  &rt_test_006_012,
+#endif
+#if (CH_CFG_USE_RWLOCKS) || defined(__DOXYGEN__)
+  &rt_test_006_013,
+#endif
+#if (CH_CFG_USE_RWLOCKS) || defined(__DOXYGEN__)
+  &rt_test_006_014,
+#endif
+#if (CH_CFG_USE_CONDVARS) || defined(__DOXYGEN__)
+  &rt_test_006_015,
 #endif
   NULL
 };
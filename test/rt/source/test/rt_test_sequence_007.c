@@ -37,6 +37,7 @@
  *
  * <h2>Test Cases</h2>
  * - @subpage rt_test_007_001
+ * - @subpage rt_test_007_002
  * .
  */
 
@@ -46,6 +47,8 @@
  * Shared code.
  ****************************************************************************/
 
+#include <string.h>
+
 static THD_FUNCTION(msg_thread1, p) {
 
   chMsgSend(p, 'A');
@@ -54,6 +57,12 @@ static THD_FUNCTION(msg_thread1, p) {
   chMsgSend(p, 'D');
 }
 
+static THD_FUNCTION(msg_thread2, p) {
+
+  (void) chMsgSendPayloadTimeout(p, "payload", sizeof "payload",
+                                 TIME_INFINITE);
+}
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -107,6 +116,76 @@ static const testcase_t rt_test_007_001 = {
   rt_test_007_001_execute
 };
 
+/**
+ * @page rt_test_007_002 [7.2] Messages timeouts and payloads
+ *
+ * <h2>Description</h2>
+ * The timeout of both the send and the wait operations is tested, then a
+ * payload is sent by a messenger thread and accessed in place by the
+ * tester thread.
+ *
+ * <h2>Test Steps</h2>
+ * - [7.2.1] Waiting for a message with timeout, no message is sent so
+ *   the function must fail.
+ * - [7.2.2] Sending a message to the tester thread itself with timeout,
+ *   the message is never received so the function must fail and the
+ *   message must be removed from the queue.
+ * - [7.2.3] Starting a messenger thread sending a payload, the payload
+ *   is checked in place and then the sender is released.
+ * .
+ */
+
+static void rt_test_007_002_execute(void) {
+  thread_t *tp;
+  msg_t msg;
+
+  /* [7.2.1] Waiting for a message with timeout, no message is sent so the
+     function must fail.*/
+  test_set_step(1);
+  {
+    tp = chMsgWaitTimeout(TIME_IMMEDIATE);
+    test_assert(tp == NULL, "message received");
+    tp = chMsgWaitTimeout(TIME_MS2I(10));
+    test_assert(tp == NULL, "message received");
+  }
+
+  /* [7.2.2] Sending a message to the tester thread itself with timeout,
+     the message is never received so the function must fail and the
+     message must be removed from the queue.*/
+  test_set_step(2);
+  {
+    msg = chMsgSendTimeout(chThdGetSelfX(), 'A', TIME_MS2I(10));
+    test_assert(msg == MSG_TIMEOUT, "wrong wake-up message");
+    chSysLock();
+    test_assert(!chMsgIsPendingI(chThdGetSelfX()), "message still queued");
+    chSysUnlock();
+  }
+
+  /* [7.2.3] Starting a messenger thread sending a payload, the payload is
+     checked in place and then the sender is released.*/
+  test_set_step(3);
+  {
+    const msg_payload_t *pp;
+
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() + 1,
+                                   msg_thread2, chThdGetSelfX());
+    tp = chMsgWaitTimeout(TIME_MS2I(100));
+    test_assert(tp != NULL, "message not received");
+    pp = chMsgGetPayload(tp);
+    test_assert(pp->size == sizeof "payload", "wrong payload size");
+    test_assert(memcmp(pp->buf, "payload", pp->size) == 0, "wrong payload");
+    chMsgRelease(tp, MSG_OK);
+    test_wait_threads();
+  }
+}
+
+static const testcase_t rt_test_007_002 = {
+  "Messages timeouts and payloads",
+  NULL,
+  NULL,
+  rt_test_007_002_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -116,6 +195,7 @@ static const testcase_t rt_test_007_001 = {
  */
 const testcase_t * const rt_test_sequence_007_array[] = {
   &rt_test_007_001,
+  &rt_test_007_002,
   NULL
 };
 
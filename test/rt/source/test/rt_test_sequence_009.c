@@ -38,6 +38,7 @@
  * <h2>Test Cases</h2>
  * - @subpage rt_test_009_001
  * - @subpage rt_test_009_002
+ * - @subpage rt_test_009_003
  * .
  */
 
@@ -53,6 +54,9 @@ static memory_heap_t heap1;
 #if CH_CFG_USE_MEMPOOLS
 static memory_pool_t mp1;
 #endif
+#if CH_CFG_USE_THREAD_CACHE
+static thread_cache_t cache1;
+#endif
 
 static THD_FUNCTION(dyn_thread1, p) {
 
@@ -263,6 +267,111 @@ static const testcase_t rt_test_009_002 = {
 };
 #endif /* CH_CFG_USE_MEMPOOLS */
 
+#if (CH_CFG_USE_THREAD_CACHE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_009_003 [9.3] Threads creation from Threads Cache
+ *
+ * <h2>Description</h2>
+ * Two threads are started from a threads cache able to hold a single
+ * working area, when the threads terminate one working area is kept in
+ * the cache. A third thread is then started.<br> The test expects the
+ * third thread to reuse the cached working area and the heap to be
+ * restored when the cache is flushed.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_THREAD_CACHE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [9.3.1] Getting base priority for threads and heap info before the
+ *   test.
+ * - [9.3.2] Creating two threads, the working areas are allocated from
+ *   the heap.
+ * - [9.3.3] Letting threads execute then checking the start order, the
+ *   working area of the first thread is kept in the cache.
+ * - [9.3.4] Creating a third thread, the cached working area is
+ *   expected to be reused.
+ * - [9.3.5] Flushing the cache then getting heap info again for
+ *   verification.
+ * .
+ */
+
+static void rt_test_009_003_setup(void) {
+  chHeapObjectInit(&heap1, test_buffer, sizeof test_buffer);
+  chThdCacheObjectInit(&cache1, &heap1,
+                       THD_WORKING_AREA_SIZE(THREADS_STACK_SIZE), 1);
+}
+
+static void rt_test_009_003_execute(void) {
+  size_t n1, total1, largest1;
+  size_t n2, total2, largest2;
+  stkalign_t *wsp;
+  tprio_t prio;
+
+  /* [9.3.1] Getting base priority for threads and heap info before the
+     test.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+    n1 = chHeapStatus(&heap1, &total1, &largest1);
+    test_assert(n1 == 1, "heap fragmented");
+  }
+
+  /* [9.3.2] Creating two threads, the working areas are allocated from
+     the heap.*/
+  test_set_step(2);
+  {
+    threads[0] = chThdSpawnFromCache(&cache1, "dyn1", prio-1, dyn_thread1, "A");
+    threads[1] = chThdSpawnFromCache(&cache1, "dyn2", prio-2, dyn_thread1, "B");
+    test_assert((threads[0] != NULL) && (threads[1] != NULL),
+                "thread creation failed");
+    wsp = chThdGetWorkingAreaX(threads[0]);
+  }
+
+  /* [9.3.3] Letting threads execute then checking the start order, the
+     working area of the first thread is kept in the cache.*/
+  test_set_step(3);
+  {
+    test_wait_threads();
+    test_assert_sequence("AB", "invalid sequence");
+    test_assert(cache1.cnt == 1, "not cached");
+  }
+
+  /* [9.3.4] Creating a third thread, the cached working area is
+     expected to be reused.*/
+  test_set_step(4);
+  {
+    threads[0] = chThdSpawnFromCache(&cache1, "dyn3", prio-1, dyn_thread1, "C");
+    test_assert(threads[0] != NULL, "thread creation failed");
+    test_assert(chThdGetWorkingAreaX(threads[0]) == wsp, "working area not reused");
+    test_assert(cache1.cnt == 0, "cache not empty");
+    test_wait_threads();
+    test_assert_sequence("C", "invalid sequence");
+  }
+
+  /* [9.3.5] Flushing the cache then getting heap info again for
+     verification.*/
+  test_set_step(5);
+  {
+    chThdCacheFlush(&cache1);
+    test_assert(cache1.cnt == 0, "cache not empty");
+    n2 = chHeapStatus(&heap1, &total2, &largest2);
+    test_assert(n1 == n2, "fragmentation changed");
+    test_assert(total1 == total2, "total free space changed");
+    test_assert(largest1 == largest2, "largest fragment size changed");
+  }
+}
+
+static const testcase_t rt_test_009_003 = {
+  "Threads creation from Threads Cache",
+  rt_test_009_003_setup,
+  NULL,
+  rt_test_009_003_execute
+};
+#endif /* CH_CFG_USE_THREAD_CACHE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -276,6 +385,9 @@ const testcase_t * const rt_test_sequence_009_array[] = {
 #endif
 #if (CH_CFG_USE_MEMPOOLS) || defined(__DOXYGEN__)
   &rt_test_009_002,
+#endif
+#if (CH_CFG_USE_THREAD_CACHE) || defined(__DOXYGEN__)
+  &rt_test_009_003,
 #endif
   NULL
 };
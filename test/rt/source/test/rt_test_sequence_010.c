@@ -46,6 +46,7 @@
  * - @subpage rt_test_010_010
  * - @subpage rt_test_010_011
  * - @subpage rt_test_010_012
+ * - @subpage rt_test_010_013
  * .
  */
 
@@ -59,6 +60,12 @@ static semaphore_t sem1;
 #if CH_CFG_USE_MUTEXES || defined(__DOXYGEN__)
 static mutex_t mtx1;
 #endif
+#if CH_CFG_USE_MAILBOXES || defined(__DOXYGEN__)
+#define MB_SIZE 4
+
+static msg_t mb_buffer[MB_SIZE];
+static mailbox_t mb1;
+#endif
 
 static void tmo(void *param) {(void)param;}
 
@@ -134,6 +141,17 @@ static THD_FUNCTION(bmk_thread8, p) {
   } while(!chThdShouldTerminateX());
 }
 
+#if CH_CFG_USE_MAILBOXES
+static THD_FUNCTION(bmk_thread9, p) {
+  msg_t msg;
+
+  (void)p;
+  do {
+    (void)chMBFetchTimeout(&mb1, &msg, TIME_INFINITE);
+  } while (msg);
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -188,6 +206,8 @@ static void rt_test_010_001_execute(void) {
     test_print(" msgs/S, ");
     test_printn(n << 1);
     test_println(" ctxswc/S");
+    test_emit_record("msgs", n, "msgs/S");
+    test_emit_record("ctxswc", n << 1, "ctxswc/S");
   }
 }
 
@@ -249,6 +269,8 @@ static void rt_test_010_002_execute(void) {
     test_print(" msgs/S, ");
     test_printn(n << 1);
     test_println(" ctxswc/S");
+    test_emit_record("msgs", n, "msgs/S");
+    test_emit_record("ctxswc", n << 1, "ctxswc/S");
   }
 }
 
@@ -323,6 +345,8 @@ static void rt_test_010_003_execute(void) {
     test_print(" msgs/S, ");
     test_printn(n << 1);
     test_println(" ctxswc/S");
+    test_emit_record("msgs", n, "msgs/S");
+    test_emit_record("ctxswc", n << 1, "ctxswc/S");
   }
 }
 
@@ -402,6 +426,7 @@ static void rt_test_010_004_execute(void) {
     test_print("--- Score : ");
     test_printn(n * 2);
     test_println(" ctxswc/S");
+    test_emit_record("ctxswc", n * 2, "ctxswc/S");
   }
 }
 
@@ -458,6 +483,7 @@ static void rt_test_010_005_execute(void) {
     test_print("--- Score : ");
     test_printn(n);
     test_println(" threads/S");
+    test_emit_record("threads", n, "threads/S");
   }
 }
 
@@ -519,6 +545,7 @@ static void rt_test_010_006_execute(void) {
     test_print("--- Score : ");
     test_printn(n);
     test_println(" threads/S");
+    test_emit_record("threads", n, "threads/S");
   }
 }
 
@@ -607,6 +634,8 @@ static void rt_test_010_007_execute(void) {
     test_print(" reschedules/S, ");
     test_printn(n * 6);
     test_println(" ctxswc/S");
+    test_emit_record("reschedules", n, "reschedules/S");
+    test_emit_record("ctxswc", n * 6, "ctxswc/S");
   }
 }
 
@@ -667,6 +696,7 @@ static void rt_test_010_008_execute(void) {
     test_print("--- Score : ");
     test_printn(n);
     test_println(" ctxswc/S");
+    test_emit_record("ctxswc", n, "ctxswc/S");
   }
 }
 
@@ -727,6 +757,7 @@ static void rt_test_010_009_execute(void) {
     test_print("--- Score : ");
     test_printn(n * 2);
     test_println(" timers/S");
+    test_emit_record("timers", n * 2, "timers/S");
   }
 }
 
@@ -798,6 +829,7 @@ static void rt_test_010_010_execute(void) {
     test_print("--- Score : ");
     test_printn(n * 4);
     test_println(" wait+signal/S");
+    test_emit_record("wait+signal", n * 4, "wait+signal/S");
   }
 }
 
@@ -870,6 +902,7 @@ static void rt_test_010_011_execute(void) {
     test_print("--- Score : ");
     test_printn(n * 4);
     test_println(" lock+unlock/S");
+    test_emit_record("lock+unlock", n * 4, "lock+unlock/S");
   }
 }
 
@@ -908,6 +941,7 @@ static void rt_test_010_012_execute(void) {
     test_print("--- System: ");
     test_printn(sizeof(ch_system_t));
     test_println(" bytes");
+    test_emit_record("ch_system_t", sizeof(ch_system_t), "bytes");
   }
 
   /* [10.12.2] The size of a thread structure is printed.*/
@@ -916,6 +950,7 @@ static void rt_test_010_012_execute(void) {
     test_print("--- Thread: ");
     test_printn(sizeof(thread_t));
     test_println(" bytes");
+    test_emit_record("thread_t", sizeof(thread_t), "bytes");
   }
 
   /* [10.12.3] The size of a virtual timer structure is printed.*/
@@ -924,6 +959,7 @@ static void rt_test_010_012_execute(void) {
     test_print("--- Timer : ");
     test_printn(sizeof(virtual_timer_t));
     test_println(" bytes");
+    test_emit_record("virtual_timer_t", sizeof(virtual_timer_t), "bytes");
   }
 
   /* [10.12.4] The size of a semaphore structure is printed.*/
@@ -933,6 +969,7 @@ static void rt_test_010_012_execute(void) {
     test_print("--- Semaph: ");
     test_printn(sizeof(semaphore_t));
     test_println(" bytes");
+    test_emit_record("semaphore_t", sizeof(semaphore_t), "bytes");
 #endif
   }
 
@@ -943,6 +980,7 @@ static void rt_test_010_012_execute(void) {
     test_print("--- Mutex : ");
     test_printn(sizeof(mutex_t));
     test_println(" bytes");
+    test_emit_record("mutex_t", sizeof(mutex_t), "bytes");
 #endif
   }
 
@@ -953,6 +991,7 @@ static void rt_test_010_012_execute(void) {
     test_print("--- CondV.: ");
     test_printn(sizeof(condition_variable_t));
     test_println(" bytes");
+    test_emit_record("condition_variable_t", sizeof(condition_variable_t), "bytes");
 #endif
   }
 
@@ -963,6 +1002,7 @@ static void rt_test_010_012_execute(void) {
     test_print("--- EventS: ");
     test_printn(sizeof(event_source_t));
     test_println(" bytes");
+    test_emit_record("event_source_t", sizeof(event_source_t), "bytes");
 #endif
   }
 
@@ -973,6 +1013,7 @@ static void rt_test_010_012_execute(void) {
     test_print("--- EventL: ");
     test_printn(sizeof(event_listener_t));
     test_println(" bytes");
+    test_emit_record("event_listener_t", sizeof(event_listener_t), "bytes");
 #endif
   }
 
@@ -983,6 +1024,7 @@ static void rt_test_010_012_execute(void) {
     test_print("--- MailB.: ");
     test_printn(sizeof(mailbox_t));
     test_println(" bytes");
+    test_emit_record("mailbox_t", sizeof(mailbox_t), "bytes");
 #endif
   }
 }
@@ -994,6 +1036,87 @@ static const testcase_t rt_test_010_012 = {
   rt_test_010_012_execute
 };
 
+#if (CH_CFG_USE_MAILBOXES) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_010_013 [10.13] Mailboxes post/fetch performance
+ *
+ * <h2>Description</h2>
+ * A consumer thread is created with a higher priority than the
+ * producer thread and blocks fetching from an empty mailbox, each
+ * post wakes the consumer which fetches the message and blocks again.
+ * The messages throughput per second is measured and the result
+ * printed on the output log.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MAILBOXES
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.13.1] The consumer thread is started at a higher priority than
+ *   the current thread, it blocks on the empty mailbox.
+ * - [10.13.2] Messages are posted in a one second time window, each
+ *   post wakes the blocked consumer.
+ * - [10.13.3] Score is printed.
+ * .
+ */
+
+static void rt_test_010_013_setup(void) {
+  chMBObjectInit(&mb1, mb_buffer, MB_SIZE);
+}
+
+static void rt_test_010_013_execute(void) {
+  uint32_t n;
+
+  /* [10.13.1] The consumer thread is started at a higher priority than
+     the current thread, it blocks on the empty mailbox.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()+1, bmk_thread9, NULL);
+  }
+
+  /* [10.13.2] Messages are posted in a one second time window, each
+     post wakes the blocked consumer.*/
+  test_set_step(2);
+  {
+    systime_t start, end;
+
+    n = 0;
+    start = test_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      (void)chMBPostTimeout(&mb1, (msg_t)1, TIME_INFINITE);
+      n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+    (void)chMBPostTimeout(&mb1, (msg_t)0, TIME_INFINITE);
+    test_wait_threads();
+  }
+
+  /* [10.13.3] Score is printed.*/
+  test_set_step(3);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_print(" msgs/S, ");
+    test_printn(n << 1);
+    test_println(" ctxswc/S");
+    test_emit_record("msgs", n, "msgs/S");
+    test_emit_record("ctxswc", n << 1, "ctxswc/S");
+  }
+}
+
+static const testcase_t rt_test_010_013 = {
+  "Mailboxes post/fetch performance",
+  rt_test_010_013_setup,
+  NULL,
+  rt_test_010_013_execute
+};
+#endif /* CH_CFG_USE_MAILBOXES */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -1026,6 +1149,9 @@ const testcase_t * const rt_test_sequence_010_array[] = {
   &rt_test_010_011,
 #endif
   &rt_test_010_012,
+#if (CH_CFG_USE_MAILBOXES) || defined(__DOXYGEN__)
+  &rt_test_010_013,
+#endif
   NULL
 };
 
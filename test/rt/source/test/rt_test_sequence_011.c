@@ -0,0 +1,652 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "rt_test_root.h"
+
+/**
+ * @file    rt_test_sequence_011.c
+ * @brief   Test Sequence 011 code.
+ *
+ * @page rt_test_sequence_011 [11] Latency benchmarks
+ *
+ * File: @ref rt_test_sequence_011.c
+ *
+ * <h2>Description</h2>
+ * This module implements a series of interrupt to thread latency
+ * benchmarks. A virtual timer callback, running in ISR context, wakes up
+ * a thread using several mechanisms, the time between the wakeup in the
+ * ISR and the thread execution is measured using the realtime
+ * counter.<br> The minimum, average, 99th percentile and maximum
+ * latencies are reported, variants with background ready threads allow
+ * to evaluate the scheduler behavior.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_TM
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage rt_test_011_001
+ * - @subpage rt_test_011_002
+ * - @subpage rt_test_011_003
+ * - @subpage rt_test_011_004
+ * - @subpage rt_test_011_005
+ * - @subpage rt_test_011_006
+ * - @subpage rt_test_011_007
+ * .
+ */
+
+#if (CH_CFG_USE_TM) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+/* Number of samples for each latency measurement.*/
+#define LAT_SAMPLES         1000U
+
+static virtual_timer_t lat_vt;
+static time_measurement_t lat_tm;
+#if CH_CFG_USE_TM_HISTOGRAM || defined(__DOXYGEN__)
+static tm_histogram_t lat_hist;
+#endif
+static void (*lat_wakeup)(void);
+
+#if CH_CFG_USE_SEMAPHORES || defined(__DOXYGEN__)
+static semaphore_t lat_sem;
+#endif
+#if CH_CFG_USE_EVENTS || defined(__DOXYGEN__)
+static thread_t *lat_tp;
+#endif
+#if CH_CFG_USE_MAILBOXES || defined(__DOXYGEN__)
+static msg_t lat_mb_buffer[1];
+static MAILBOX_DECL(lat_mb, lat_mb_buffer, 1);
+#endif
+static thread_reference_t lat_tr;
+
+/* Timer callback, the measurement is started in ISR context just before
+   waking up the measuring thread.*/
+static void lat_cb(void *p) {
+
+  (void)p;
+  chSysLockFromISR();
+  chTMStartMeasurementX(&lat_tm);
+  lat_wakeup();
+  chSysUnlockFromISR();
+}
+
+/* Performs the measurements, the wait function stops the measurement as
+   soon as the thread is woken up.*/
+static void lat_run(void (*wakeupi)(void), void (*wait)(void)) {
+  unsigned i;
+
+  lat_wakeup = wakeupi;
+#if CH_CFG_USE_TM_HISTOGRAM
+  chTMObjectInitHistogram(&lat_tm, &lat_hist);
+#else
+  chTMObjectInit(&lat_tm);
+#endif
+  chVTObjectInit(&lat_vt);
+  (void) test_wait_tick();
+  for (i = 0U; i < LAT_SAMPLES; i++) {
+    chVTSet(&lat_vt, TIME_MS2I(1), lat_cb, NULL);
+    wait();
+  }
+}
+
+/* Prints the measurement results.*/
+static void lat_print(void) {
+
+  test_print("--- Score : ");
+  test_printn((uint32_t)lat_tm.best);
+  test_print("/");
+  test_printn((uint32_t)(lat_tm.cumulative / (rttime_t)lat_tm.n));
+  test_print("/");
+#if CH_CFG_USE_TM_HISTOGRAM
+  test_printn((uint32_t)chTMGetPercentileX(&lat_tm, 990U));
+#else
+  test_print("-");
+#endif
+  test_print("/");
+  test_printn((uint32_t)lat_tm.worst);
+  test_println(" cycles min/avg/p99/max");
+  test_emit_record("min", (uint32_t)lat_tm.best, "cycles");
+  test_emit_record("avg", (uint32_t)(lat_tm.cumulative / (rttime_t)lat_tm.n),
+                   "cycles");
+#if CH_CFG_USE_TM_HISTOGRAM
+  test_emit_record("p99", (uint32_t)chTMGetPercentileX(&lat_tm, 990U),
+                   "cycles");
+#endif
+  test_emit_record("max", (uint32_t)lat_tm.worst, "cycles");
+}
+
+#if CH_CFG_USE_SEMAPHORES || defined(__DOXYGEN__)
+static void lat_sem_wakeup(void) {
+
+  chSemSignalI(&lat_sem);
+}
+
+static void lat_sem_wait(void) {
+
+  (void) chSemWait(&lat_sem);
+  chTMStopMeasurementX(&lat_tm);
+}
+#endif
+
+#if CH_CFG_USE_EVENTS || defined(__DOXYGEN__)
+static void lat_evt_wakeup(void) {
+
+  chEvtSignalI(lat_tp, EVENT_MASK(0));
+}
+
+static void lat_evt_wait(void) {
+
+  (void) chEvtWaitAny(EVENT_MASK(0));
+  chTMStopMeasurementX(&lat_tm);
+}
+#endif
+
+#if CH_CFG_USE_MAILBOXES || defined(__DOXYGEN__)
+static void lat_mb_wakeup(void) {
+
+  (void) chMBPostI(&lat_mb, (msg_t)0);
+}
+
+static void lat_mb_wait(void) {
+  msg_t msg;
+
+  (void) chMBFetchTimeout(&lat_mb, &msg, TIME_INFINITE);
+  chTMStopMeasurementX(&lat_tm);
+}
+#endif
+
+static void lat_resume_wakeup(void) {
+
+  chThdResumeI(&lat_tr, MSG_OK);
+}
+
+static void lat_resume_wait(void) {
+
+  /* The timeout covers the case where the timer fires before the thread
+     is suspended, the sample is discarded.*/
+  chSysLock();
+  if (chThdSuspendTimeoutS(&lat_tr, TIME_MS2I(100)) == MSG_OK) {
+    chTMStopMeasurementX(&lat_tm);
+  }
+  chSysUnlock();
+}
+
+#if (CH_CFG_USE_DYNAMIC && CH_CFG_USE_HEAP) || defined(__DOXYGEN__)
+/* Maximum number of background ready threads.*/
+#define LAT_MAX_READY       32U
+
+static thread_t *lat_ready[LAT_MAX_READY];
+
+static THD_FUNCTION(lat_ready_thread, p) {
+
+  (void)p;
+  while (!chThdShouldTerminateX()) {
+    chThdYield();
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  }
+}
+
+/* Creates the background ready threads at a lower priority, returns false
+   if there is not enough memory.*/
+static bool lat_ready_start(unsigned n) {
+  unsigned i;
+
+  for (i = 0U; i < LAT_MAX_READY; i++) {
+    lat_ready[i] = NULL;
+  }
+  for (i = 0U; i < n; i++) {
+    lat_ready[i] = chThdCreateFromHeap(NULL, THD_WORKING_AREA_SIZE(64),
+                                       "ready", chThdGetPriorityX() - 1,
+                                       lat_ready_thread, NULL);
+    if (lat_ready[i] == NULL) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void lat_ready_stop(void) {
+  unsigned i;
+
+  for (i = 0U; i < LAT_MAX_READY; i++) {
+    if (lat_ready[i] != NULL) {
+      chThdTerminate(lat_ready[i]);
+    }
+  }
+  for (i = 0U; i < LAT_MAX_READY; i++) {
+    if (lat_ready[i] != NULL) {
+      (void) chThdWait(lat_ready[i]);
+      lat_ready[i] = NULL;
+    }
+  }
+}
+#endif
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+#if (CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_011_001 [11.1] Semaphore wakeup latency
+ *
+ * <h2>Description</h2>
+ * The thread waits on a semaphore, the semaphore is signaled from the
+ * ISR, the latency distribution is measured.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_SEMAPHORES
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.1.1] The latency is measured over a series of wakeups.
+ * - [11.1.2] Score is printed.
+ * .
+ */
+
+static void rt_test_011_001_setup(void) {
+  chSemObjectInit(&lat_sem, 0);
+}
+
+static void rt_test_011_001_execute(void) {
+
+  /* [11.1.1] The latency is measured over a series of wakeups.*/
+  test_set_step(1);
+  {
+    lat_run(lat_sem_wakeup, lat_sem_wait);
+  }
+
+  /* [11.1.2] Score is printed.*/
+  test_set_step(2);
+  {
+    lat_print();
+  }
+}
+
+static const testcase_t rt_test_011_001 = {
+  "Semaphore wakeup latency",
+  rt_test_011_001_setup,
+  NULL,
+  rt_test_011_001_execute
+};
+#endif /* CH_CFG_USE_SEMAPHORES */
+
+#if (CH_CFG_USE_EVENTS) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_011_002 [11.2] Event wakeup latency
+ *
+ * <h2>Description</h2>
+ * The thread waits for an event, the event is signaled from the ISR, the
+ * latency distribution is measured.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_EVENTS
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.2.1] The latency is measured over a series of wakeups.
+ * - [11.2.2] Score is printed.
+ * .
+ */
+
+static void rt_test_011_002_setup(void) {
+  lat_tp = chThdGetSelfX();
+  (void) chEvtGetAndClearEvents(ALL_EVENTS);
+}
+
+static void rt_test_011_002_teardown(void) {
+  (void) chEvtGetAndClearEvents(ALL_EVENTS);
+}
+
+static void rt_test_011_002_execute(void) {
+
+  /* [11.2.1] The latency is measured over a series of wakeups.*/
+  test_set_step(1);
+  {
+    lat_run(lat_evt_wakeup, lat_evt_wait);
+  }
+
+  /* [11.2.2] Score is printed.*/
+  test_set_step(2);
+  {
+    lat_print();
+  }
+}
+
+static const testcase_t rt_test_011_002 = {
+  "Event wakeup latency",
+  rt_test_011_002_setup,
+  rt_test_011_002_teardown,
+  rt_test_011_002_execute
+};
+#endif /* CH_CFG_USE_EVENTS */
+
+#if (CH_CFG_USE_MAILBOXES) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_011_003 [11.3] Mailbox wakeup latency
+ *
+ * <h2>Description</h2>
+ * The thread waits for a message on a mailbox, the message is posted
+ * from the ISR, the latency distribution is measured.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MAILBOXES
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.3.1] The latency is measured over a series of wakeups.
+ * - [11.3.2] Score is printed.
+ * .
+ */
+
+static void rt_test_011_003_setup(void) {
+  chMBReset(&lat_mb);
+  chMBResumeX(&lat_mb);
+}
+
+static void rt_test_011_003_execute(void) {
+
+  /* [11.3.1] The latency is measured over a series of wakeups.*/
+  test_set_step(1);
+  {
+    lat_run(lat_mb_wakeup, lat_mb_wait);
+  }
+
+  /* [11.3.2] Score is printed.*/
+  test_set_step(2);
+  {
+    lat_print();
+  }
+}
+
+static const testcase_t rt_test_011_003 = {
+  "Mailbox wakeup latency",
+  rt_test_011_003_setup,
+  NULL,
+  rt_test_011_003_execute
+};
+#endif /* CH_CFG_USE_MAILBOXES */
+
+/**
+ * @page rt_test_011_004 [11.4] Resume wakeup latency
+ *
+ * <h2>Description</h2>
+ * The thread suspends itself on a thread reference, the thread is
+ * resumed from the ISR using chThdResumeI(), the latency distribution is
+ * measured.
+ *
+ * <h2>Test Steps</h2>
+ * - [11.4.1] The latency is measured over a series of wakeups.
+ * - [11.4.2] Score is printed.
+ * .
+ */
+
+static void rt_test_011_004_execute(void) {
+
+  /* [11.4.1] The latency is measured over a series of wakeups.*/
+  test_set_step(1);
+  {
+    lat_run(lat_resume_wakeup, lat_resume_wait);
+  }
+
+  /* [11.4.2] Score is printed.*/
+  test_set_step(2);
+  {
+    lat_print();
+  }
+}
+
+static const testcase_t rt_test_011_004 = {
+  "Resume wakeup latency",
+  NULL,
+  NULL,
+  rt_test_011_004_execute
+};
+
+#if (CH_CFG_USE_DYNAMIC && CH_CFG_USE_HEAP) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_011_005 [11.5] Resume wakeup latency with 1 ready thread
+ *
+ * <h2>Description</h2>
+ * The thread suspends itself on a thread reference, the thread is
+ * resumed from the ISR using chThdResumeI() while 1 lower priority
+ * thread is ready, the latency distribution is measured.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_DYNAMIC && CH_CFG_USE_HEAP
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.5.1] Starting the ready threads, the benchmark is skipped if
+ *   there is not enough memory.
+ * - [11.5.2] The latency is measured over a series of wakeups.
+ * - [11.5.3] Score is printed.
+ * .
+ */
+
+static void rt_test_011_005_teardown(void) {
+  lat_ready_stop();
+}
+
+static void rt_test_011_005_execute(void) {
+
+  /* [11.5.1] Starting the ready threads, the benchmark is skipped if there
+     is not enough memory.*/
+  test_set_step(1);
+  {
+    if (!lat_ready_start(1U)) {
+      test_println("--- Score : not enough memory, skipped");
+      return;
+    }
+  }
+
+  /* [11.5.2] The latency is measured over a series of wakeups.*/
+  test_set_step(2);
+  {
+    lat_run(lat_resume_wakeup, lat_resume_wait);
+  }
+
+  /* [11.5.3] Score is printed.*/
+  test_set_step(3);
+  {
+    lat_print();
+  }
+}
+
+static const testcase_t rt_test_011_005 = {
+  "Resume wakeup latency with 1 ready thread",
+  NULL,
+  rt_test_011_005_teardown,
+  rt_test_011_005_execute
+};
+#endif /* CH_CFG_USE_DYNAMIC && CH_CFG_USE_HEAP */
+
+#if (CH_CFG_USE_DYNAMIC && CH_CFG_USE_HEAP) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_011_006 [11.6] Resume wakeup latency with 8 ready threads
+ *
+ * <h2>Description</h2>
+ * The thread suspends itself on a thread reference, the thread is
+ * resumed from the ISR using chThdResumeI() while 8 lower priority
+ * threads are ready, the latency distribution is measured.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_DYNAMIC && CH_CFG_USE_HEAP
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.6.1] Starting the ready threads, the benchmark is skipped if
+ *   there is not enough memory.
+ * - [11.6.2] The latency is measured over a series of wakeups.
+ * - [11.6.3] Score is printed.
+ * .
+ */
+
+static void rt_test_011_006_teardown(void) {
+  lat_ready_stop();
+}
+
+static void rt_test_011_006_execute(void) {
+
+  /* [11.6.1] Starting the ready threads, the benchmark is skipped if there
+     is not enough memory.*/
+  test_set_step(1);
+  {
+    if (!lat_ready_start(8U)) {
+      test_println("--- Score : not enough memory, skipped");
+      return;
+    }
+  }
+
+  /* [11.6.2] The latency is measured over a series of wakeups.*/
+  test_set_step(2);
+  {
+    lat_run(lat_resume_wakeup, lat_resume_wait);
+  }
+
+  /* [11.6.3] Score is printed.*/
+  test_set_step(3);
+  {
+    lat_print();
+  }
+}
+
+static const testcase_t rt_test_011_006 = {
+  "Resume wakeup latency with 8 ready threads",
+  NULL,
+  rt_test_011_006_teardown,
+  rt_test_011_006_execute
+};
+#endif /* CH_CFG_USE_DYNAMIC && CH_CFG_USE_HEAP */
+
+#if (CH_CFG_USE_DYNAMIC && CH_CFG_USE_HEAP) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_011_007 [11.7] Resume wakeup latency with 32 ready threads
+ *
+ * <h2>Description</h2>
+ * The thread suspends itself on a thread reference, the thread is
+ * resumed from the ISR using chThdResumeI() while 32 lower priority
+ * threads are ready, the latency distribution is measured.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_DYNAMIC && CH_CFG_USE_HEAP
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.7.1] Starting the ready threads, the benchmark is skipped if
+ *   there is not enough memory.
+ * - [11.7.2] The latency is measured over a series of wakeups.
+ * - [11.7.3] Score is printed.
+ * .
+ */
+
+static void rt_test_011_007_teardown(void) {
+  lat_ready_stop();
+}
+
+static void rt_test_011_007_execute(void) {
+
+  /* [11.7.1] Starting the ready threads, the benchmark is skipped if there
+     is not enough memory.*/
+  test_set_step(1);
+  {
+    if (!lat_ready_start(32U)) {
+      test_println("--- Score : not enough memory, skipped");
+      return;
+    }
+  }
+
+  /* [11.7.2] The latency is measured over a series of wakeups.*/
+  test_set_step(2);
+  {
+    lat_run(lat_resume_wakeup, lat_resume_wait);
+  }
+
+  /* [11.7.3] Score is printed.*/
+  test_set_step(3);
+  {
+    lat_print();
+  }
+}
+
+static const testcase_t rt_test_011_007 = {
+  "Resume wakeup latency with 32 ready threads",
+  NULL,
+  rt_test_011_007_teardown,
+  rt_test_011_007_execute
+};
+#endif /* CH_CFG_USE_DYNAMIC && CH_CFG_USE_HEAP */
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const rt_test_sequence_011_array[] = {
+#if (CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
+  &rt_test_011_001,
+#endif
+#if (CH_CFG_USE_EVENTS) || defined(__DOXYGEN__)
+  &rt_test_011_002,
+#endif
+#if (CH_CFG_USE_MAILBOXES) || defined(__DOXYGEN__)
+  &rt_test_011_003,
+#endif
+  &rt_test_011_004,
+#if (CH_CFG_USE_DYNAMIC && CH_CFG_USE_HEAP) || defined(__DOXYGEN__)
+  &rt_test_011_005,
+#endif
+#if (CH_CFG_USE_DYNAMIC && CH_CFG_USE_HEAP) || defined(__DOXYGEN__)
+  &rt_test_011_006,
+#endif
+#if (CH_CFG_USE_DYNAMIC && CH_CFG_USE_HEAP) || defined(__DOXYGEN__)
+  &rt_test_011_007,
+#endif
+  NULL
+};
+
+/**
+ * @brief   Latency benchmarks.
+ */
+const testsequence_t rt_test_sequence_011 = {
+  "Latency benchmarks",
+  rt_test_sequence_011_array
+};
+
+#endif /* CH_CFG_USE_TM */
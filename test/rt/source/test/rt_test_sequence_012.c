@@ -0,0 +1,711 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "rt_test_root.h"
+
+/**
+ * @file    rt_test_sequence_012.c
+ * @brief   Test Sequence 012 code.
+ *
+ * @page rt_test_sequence_012 [12] Scalability benchmarks
+ *
+ * File: @ref rt_test_sequence_012.c
+ *
+ * <h2>Description</h2>
+ * This module implements a series of scalability benchmarks. The cost of
+ * virtual timers, heap and memory pools operations is measured while the
+ * number of armed timers, the heap fragmentation or the number of
+ * competing threads grows.<br> The best, average and worst execution
+ * times are reported, the worst thread critical zone is also reported
+ * when the kernel statistics are enabled.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_TM
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage rt_test_012_001
+ * - @subpage rt_test_012_002
+ * - @subpage rt_test_012_003
+ * - @subpage rt_test_012_004
+ * - @subpage rt_test_012_005
+ * - @subpage rt_test_012_006
+ * - @subpage rt_test_012_007
+ * - @subpage rt_test_012_008
+ * .
+ */
+
+#if (CH_CFG_USE_TM) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+/* Number of measured operations in each benchmark.*/
+#define SCL_SAMPLES         100U
+
+static time_measurement_t scl_tm1, scl_tm2;
+
+/* Emits a record for a statistic of a measurement, the metric name is
+   composed as "name.stat".*/
+static void scl_record(const char *name, const char *stat, uint32_t value) {
+  char metric[16], *p = metric;
+
+  while ((*name != '\0') && (p < &metric[sizeof metric - 5U]))
+    *p++ = *name++;
+  *p++ = '.';
+  while (*stat != '\0')
+    *p++ = *stat++;
+  *p = '\0';
+  test_emit_record(metric, value, "cycles");
+}
+
+/* Prints a measurement as best/average/worst cycles.*/
+static void scl_print(const char *name, time_measurement_t *tmp) {
+
+  test_print("--- Score : ");
+  test_print(name);
+  test_print(" ");
+  test_printn((uint32_t)tmp->best);
+  test_print("/");
+  test_printn((uint32_t)(tmp->cumulative / (rttime_t)tmp->n));
+  test_print("/");
+  test_printn((uint32_t)tmp->worst);
+  test_println(" cycles min/avg/max");
+  scl_record(name, "min", (uint32_t)tmp->best);
+  scl_record(name, "avg", (uint32_t)(tmp->cumulative / (rttime_t)tmp->n));
+  scl_record(name, "max", (uint32_t)tmp->worst);
+}
+
+/* Resets the worst critical zone statistic, it is only available with the
+   kernel statistics enabled.*/
+static void scl_crit_reset(void) {
+
+  chTMObjectInit(&scl_tm1);
+  chTMObjectInit(&scl_tm2);
+#if CH_DBG_STATISTICS
+  chSysLock();
+  ch.kernel_stats.m_crit_thd.worst = (rtcnt_t)0;
+  chSysUnlock();
+#endif
+}
+
+static void scl_crit_print(void) {
+
+#if CH_DBG_STATISTICS
+  test_print("--- Crit. : ");
+  test_printn((uint32_t)ch.kernel_stats.m_crit_thd.worst);
+  test_println(" cycles worst thread critical zone");
+  test_emit_record("crit", (uint32_t)ch.kernel_stats.m_crit_thd.worst,
+                   "cycles");
+#endif
+}
+
+#if CH_CFG_USE_HEAP || defined(__DOXYGEN__)
+static void scl_vt_cb(void *p) {
+
+  (void)p;
+}
+
+/* Arms n timers with delays spread over a long interval, measures the
+   insertion and removal of one more timer in the armed list.*/
+static bool scl_vt_run(unsigned n) {
+  virtual_timer_t *vts, vt;
+  unsigned i;
+
+  vts = chHeapAlloc(NULL, n * sizeof (virtual_timer_t));
+  if (vts == NULL) {
+    return false;
+  }
+
+  scl_crit_reset();
+  chVTObjectInit(&vt);
+  for (i = 0U; i < n; i++) {
+    chVTObjectInit(&vts[i]);
+    chVTSet(&vts[i], TIME_S2I(10) + (sysinterval_t)((i * 7919U) % n),
+            scl_vt_cb, NULL);
+  }
+  for (i = 0U; i < SCL_SAMPLES; i++) {
+    chSysLock();
+    chTMStartMeasurementX(&scl_tm1);
+    chVTSetI(&vt, TIME_S2I(10) + (sysinterval_t)((i * 104729U) % n),
+             scl_vt_cb, NULL);
+    chTMStopMeasurementX(&scl_tm1);
+    chTMStartMeasurementX(&scl_tm2);
+    chVTResetI(&vt);
+    chTMStopMeasurementX(&scl_tm2);
+    chSysUnlock();
+  }
+  for (i = 0U; i < n; i++) {
+    chVTReset(&vts[i]);
+  }
+  chHeapFree(vts);
+
+  return true;
+}
+#endif
+
+#if CH_CFG_USE_HEAP || defined(__DOXYGEN__)
+static memory_heap_t scl_heap;
+
+/* Creates the requested number of holes in the heap free list then
+   measures allocations bigger than the holes, the free list has to be
+   scanned up to its end.*/
+static bool scl_heap_run(unsigned holes) {
+  void *blocks[2];
+  unsigned i;
+
+  chHeapObjectInit(&scl_heap, test_buffer, sizeof test_buffer);
+  scl_crit_reset();
+
+  /* Pairs of blocks are allocated, the second one of each pair is kept
+     allocated as a separator, the first one is freed later.*/
+  for (i = 0U; i < holes; i++) {
+    blocks[0] = chHeapAlloc(&scl_heap, CH_HEAP_ALIGNMENT);
+    blocks[1] = chHeapAlloc(&scl_heap, CH_HEAP_ALIGNMENT);
+    if ((blocks[0] == NULL) || (blocks[1] == NULL)) {
+      return false;
+    }
+    chHeapFree(blocks[0]);
+  }
+
+  for (i = 0U; i < SCL_SAMPLES; i++) {
+    void *p;
+
+    chTMStartMeasurementX(&scl_tm1);
+    p = chHeapAlloc(&scl_heap, CH_HEAP_ALIGNMENT * 4U);
+    chTMStopMeasurementX(&scl_tm1);
+    if (p == NULL) {
+      return false;
+    }
+    chTMStartMeasurementX(&scl_tm2);
+    chHeapFree(p);
+    chTMStopMeasurementX(&scl_tm2);
+  }
+
+  return true;
+}
+#endif
+
+#if CH_CFG_USE_MEMPOOLS || defined(__DOXYGEN__)
+static memory_pool_t scl_mp;
+static void *scl_mp_objects[16][2];
+
+static THD_FUNCTION(scl_pool_thread, p) {
+
+  (void)p;
+  while (!chThdShouldTerminateX()) {
+    void *objp = chPoolAlloc(&scl_mp);
+
+    chThdYield();
+    if (objp != NULL) {
+      chPoolFree(&scl_mp, objp);
+    }
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  }
+}
+
+/* Measures pool allocations and releases while other threads at the
+   same priority use the same pool.*/
+static void scl_pool_run(unsigned nthreads) {
+  unsigned i;
+
+  chPoolObjectInit(&scl_mp, sizeof scl_mp_objects[0], NULL);
+  chPoolLoadArray(&scl_mp, scl_mp_objects, 16);
+  scl_crit_reset();
+
+  for (i = 0U; i < nthreads; i++) {
+    threads[i] = chThdCreateStatic(wa[i], WA_SIZE, chThdGetPriorityX(),
+                                   scl_pool_thread, NULL);
+  }
+  for (i = 0U; i < SCL_SAMPLES; i++) {
+    void *objp;
+
+    chTMStartMeasurementX(&scl_tm1);
+    objp = chPoolAlloc(&scl_mp);
+    chTMStopMeasurementX(&scl_tm1);
+    chThdYield();
+    if (objp != NULL) {
+      chTMStartMeasurementX(&scl_tm2);
+      chPoolFree(&scl_mp, objp);
+      chTMStopMeasurementX(&scl_tm2);
+    }
+  }
+  for (i = 0U; i < nthreads; i++) {
+    chThdTerminate(threads[i]);
+  }
+  test_wait_threads();
+}
+#endif
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+#if (CH_CFG_USE_HEAP) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_001 [12.1] Virtual timers with 10 armed timers
+ *
+ * <h2>Description</h2>
+ * A virtual timer is repeatedly armed and disarmed while other 10 timers
+ * are armed, the insertion cost depends on the length of the timers
+ * list.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_HEAP
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.1.1] Arming 10 timers then measuring set and reset operations,
+ *   the benchmark is skipped if there is not enough memory.
+ * - [12.1.2] Scores are printed.
+ * .
+ */
+
+static void rt_test_012_001_execute(void) {
+
+  /* [12.1.1] Arming 10 timers then measuring set and reset operations, the
+     benchmark is skipped if there is not enough memory.*/
+  test_set_step(1);
+  {
+    if (!scl_vt_run(10U)) {
+      test_println("--- Score : not enough memory, skipped");
+      return;
+    }
+  }
+
+  /* [12.1.2] Scores are printed.*/
+  test_set_step(2);
+  {
+    test_println("");
+    scl_print("set", &scl_tm1);
+    scl_print("reset", &scl_tm2);
+    scl_crit_print();
+  }
+}
+
+static const testcase_t rt_test_012_001 = {
+  "Virtual timers with 10 armed timers",
+  NULL,
+  NULL,
+  rt_test_012_001_execute
+};
+#endif /* CH_CFG_USE_HEAP */
+
+#if (CH_CFG_USE_HEAP) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_002 [12.2] Virtual timers with 100 armed timers
+ *
+ * <h2>Description</h2>
+ * A virtual timer is repeatedly armed and disarmed while other 100
+ * timers are armed, the insertion cost depends on the length of the
+ * timers list.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_HEAP
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.2.1] Arming 100 timers then measuring set and reset operations,
+ *   the benchmark is skipped if there is not enough memory.
+ * - [12.2.2] Scores are printed.
+ * .
+ */
+
+static void rt_test_012_002_execute(void) {
+
+  /* [12.2.1] Arming 100 timers then measuring set and reset operations,
+     the benchmark is skipped if there is not enough memory.*/
+  test_set_step(1);
+  {
+    if (!scl_vt_run(100U)) {
+      test_println("--- Score : not enough memory, skipped");
+      return;
+    }
+  }
+
+  /* [12.2.2] Scores are printed.*/
+  test_set_step(2);
+  {
+    test_println("");
+    scl_print("set", &scl_tm1);
+    scl_print("reset", &scl_tm2);
+    scl_crit_print();
+  }
+}
+
+static const testcase_t rt_test_012_002 = {
+  "Virtual timers with 100 armed timers",
+  NULL,
+  NULL,
+  rt_test_012_002_execute
+};
+#endif /* CH_CFG_USE_HEAP */
+
+#if (CH_CFG_USE_HEAP) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_003 [12.3] Virtual timers with 1000 armed timers
+ *
+ * <h2>Description</h2>
+ * A virtual timer is repeatedly armed and disarmed while other 1000
+ * timers are armed, the insertion cost depends on the length of the
+ * timers list.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_HEAP
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.3.1] Arming 1000 timers then measuring set and reset operations,
+ *   the benchmark is skipped if there is not enough memory.
+ * - [12.3.2] Scores are printed.
+ * .
+ */
+
+static void rt_test_012_003_execute(void) {
+
+  /* [12.3.1] Arming 1000 timers then measuring set and reset operations,
+     the benchmark is skipped if there is not enough memory.*/
+  test_set_step(1);
+  {
+    if (!scl_vt_run(1000U)) {
+      test_println("--- Score : not enough memory, skipped");
+      return;
+    }
+  }
+
+  /* [12.3.2] Scores are printed.*/
+  test_set_step(2);
+  {
+    test_println("");
+    scl_print("set", &scl_tm1);
+    scl_print("reset", &scl_tm2);
+    scl_crit_print();
+  }
+}
+
+static const testcase_t rt_test_012_003 = {
+  "Virtual timers with 1000 armed timers",
+  NULL,
+  NULL,
+  rt_test_012_003_execute
+};
+#endif /* CH_CFG_USE_HEAP */
+
+#if (CH_CFG_USE_HEAP) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_004 [12.4] Heap allocation with 0 free fragments
+ *
+ * <h2>Description</h2>
+ * Blocks are allocated from and returned to a heap whose free list
+ * contains 0 fragments too small to satisfy the request.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_HEAP
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.4.1] Fragmenting the heap then measuring allocate and free
+ *   operations, the benchmark is skipped if there is not enough memory.
+ * - [12.4.2] Scores are printed.
+ * .
+ */
+
+static void rt_test_012_004_execute(void) {
+
+  /* [12.4.1] Fragmenting the heap then measuring allocate and free
+     operations, the benchmark is skipped if there is not enough memory.*/
+  test_set_step(1);
+  {
+    if (!scl_heap_run(0U)) {
+      test_println("--- Score : not enough memory, skipped");
+      return;
+    }
+  }
+
+  /* [12.4.2] Scores are printed.*/
+  test_set_step(2);
+  {
+    test_println("");
+    scl_print("alloc", &scl_tm1);
+    scl_print("free", &scl_tm2);
+    scl_crit_print();
+  }
+}
+
+static const testcase_t rt_test_012_004 = {
+  "Heap allocation with 0 free fragments",
+  NULL,
+  NULL,
+  rt_test_012_004_execute
+};
+#endif /* CH_CFG_USE_HEAP */
+
+#if (CH_CFG_USE_HEAP) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_005 [12.5] Heap allocation with 8 free fragments
+ *
+ * <h2>Description</h2>
+ * Blocks are allocated from and returned to a heap whose free list
+ * contains 8 fragments too small to satisfy the request.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_HEAP
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.5.1] Fragmenting the heap then measuring allocate and free
+ *   operations, the benchmark is skipped if there is not enough memory.
+ * - [12.5.2] Scores are printed.
+ * .
+ */
+
+static void rt_test_012_005_execute(void) {
+
+  /* [12.5.1] Fragmenting the heap then measuring allocate and free
+     operations, the benchmark is skipped if there is not enough memory.*/
+  test_set_step(1);
+  {
+    if (!scl_heap_run(8U)) {
+      test_println("--- Score : not enough memory, skipped");
+      return;
+    }
+  }
+
+  /* [12.5.2] Scores are printed.*/
+  test_set_step(2);
+  {
+    test_println("");
+    scl_print("alloc", &scl_tm1);
+    scl_print("free", &scl_tm2);
+    scl_crit_print();
+  }
+}
+
+static const testcase_t rt_test_012_005 = {
+  "Heap allocation with 8 free fragments",
+  NULL,
+  NULL,
+  rt_test_012_005_execute
+};
+#endif /* CH_CFG_USE_HEAP */
+
+#if (CH_CFG_USE_HEAP) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_006 [12.6] Heap allocation with 32 free fragments
+ *
+ * <h2>Description</h2>
+ * Blocks are allocated from and returned to a heap whose free list
+ * contains 32 fragments too small to satisfy the request.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_HEAP
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.6.1] Fragmenting the heap then measuring allocate and free
+ *   operations, the benchmark is skipped if there is not enough memory.
+ * - [12.6.2] Scores are printed.
+ * .
+ */
+
+static void rt_test_012_006_execute(void) {
+
+  /* [12.6.1] Fragmenting the heap then measuring allocate and free
+     operations, the benchmark is skipped if there is not enough memory.*/
+  test_set_step(1);
+  {
+    if (!scl_heap_run(32U)) {
+      test_println("--- Score : not enough memory, skipped");
+      return;
+    }
+  }
+
+  /* [12.6.2] Scores are printed.*/
+  test_set_step(2);
+  {
+    test_println("");
+    scl_print("alloc", &scl_tm1);
+    scl_print("free", &scl_tm2);
+    scl_crit_print();
+  }
+}
+
+static const testcase_t rt_test_012_006 = {
+  "Heap allocation with 32 free fragments",
+  NULL,
+  NULL,
+  rt_test_012_006_execute
+};
+#endif /* CH_CFG_USE_HEAP */
+
+#if (CH_CFG_USE_MEMPOOLS) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_007 [12.7] Memory pool with 1 concurrent thread
+ *
+ * <h2>Description</h2>
+ * Objects are allocated from and returned to a memory pool while 1 other
+ * thread at the same priority use the same pool.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MEMPOOLS
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.7.1] Starting the competing threads then measuring allocate and
+ *   free operations.
+ * - [12.7.2] Scores are printed.
+ * .
+ */
+
+static void rt_test_012_007_execute(void) {
+
+  /* [12.7.1] Starting the competing threads then measuring allocate and
+     free operations.*/
+  test_set_step(1);
+  {
+    scl_pool_run(1U);
+  }
+
+  /* [12.7.2] Scores are printed.*/
+  test_set_step(2);
+  {
+    test_println("");
+    scl_print("alloc", &scl_tm1);
+    scl_print("free", &scl_tm2);
+    scl_crit_print();
+  }
+}
+
+static const testcase_t rt_test_012_007 = {
+  "Memory pool with 1 concurrent thread",
+  NULL,
+  NULL,
+  rt_test_012_007_execute
+};
+#endif /* CH_CFG_USE_MEMPOOLS */
+
+#if (CH_CFG_USE_MEMPOOLS) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_008 [12.8] Memory pool with 4 concurrent threads
+ *
+ * <h2>Description</h2>
+ * Objects are allocated from and returned to a memory pool while 4 other
+ * threads at the same priority use the same pool.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MEMPOOLS
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.8.1] Starting the competing threads then measuring allocate and
+ *   free operations.
+ * - [12.8.2] Scores are printed.
+ * .
+ */
+
+static void rt_test_012_008_execute(void) {
+
+  /* [12.8.1] Starting the competing threads then measuring allocate and
+     free operations.*/
+  test_set_step(1);
+  {
+    scl_pool_run(4U);
+  }
+
+  /* [12.8.2] Scores are printed.*/
+  test_set_step(2);
+  {
+    test_println("");
+    scl_print("alloc", &scl_tm1);
+    scl_print("free", &scl_tm2);
+    scl_crit_print();
+  }
+}
+
+static const testcase_t rt_test_012_008 = {
+  "Memory pool with 4 concurrent threads",
+  NULL,
+  NULL,
+  rt_test_012_008_execute
+};
+#endif /* CH_CFG_USE_MEMPOOLS */
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const rt_test_sequence_012_array[] = {
+#if (CH_CFG_USE_HEAP) || defined(__DOXYGEN__)
+  &rt_test_012_001,
+#endif
+#if (CH_CFG_USE_HEAP) || defined(__DOXYGEN__)
+  &rt_test_012_002,
+#endif
+#if (CH_CFG_USE_HEAP) || defined(__DOXYGEN__)
+  &rt_test_012_003,
+#endif
+#if (CH_CFG_USE_HEAP) || defined(__DOXYGEN__)
+  &rt_test_012_004,
+#endif
+#if (CH_CFG_USE_HEAP) || defined(__DOXYGEN__)
+  &rt_test_012_005,
+#endif
+#if (CH_CFG_USE_HEAP) || defined(__DOXYGEN__)
+  &rt_test_012_006,
+#endif
+#if (CH_CFG_USE_MEMPOOLS) || defined(__DOXYGEN__)
+  &rt_test_012_007,
+#endif
+#if (CH_CFG_USE_MEMPOOLS) || defined(__DOXYGEN__)
+  &rt_test_012_008,
+#endif
+  NULL
+};
+
+/**
+ * @brief   Scalability benchmarks.
+ */
+const testsequence_t rt_test_sequence_012 = {
+  "Scalability benchmarks",
+  rt_test_sequence_012_array
+};
+
+#endif /* CH_CFG_USE_TM */
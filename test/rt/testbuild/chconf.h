@@ -123,6 +123,27 @@
 #define CH_CFG_MEMCORE_SIZE                 0x20000
 #endif
 
+/**
+ * @brief   Number of additional memory regions.
+ * @details Regions are further core allocators over memory areas with
+ *          specific attributes, they are registered by the application
+ *          using @p chCoreRegionInit().
+ *
+ * @note    Requires @p CH_CFG_USE_MEMCORE.
+ */
+#if !defined(CH_CFG_MEMCORE_REGIONS)
+#define CH_CFG_MEMCORE_REGIONS              2
+#endif
+
+/**
+ * @brief   Attributes of the main core memory.
+ *
+ * @note    Requires @p CH_CFG_USE_MEMCORE.
+ */
+#if !defined(CH_CFG_MEMCORE_ATTRS)
+#define CH_CFG_MEMCORE_ATTRS                CH_MEM_ATTR_NONE
+#endif
+
 /**
  * @brief   Idle thread automatic spawn suppression.
  * @details When this option is activated the function @p chSysInit()
@@ -155,6 +176,64 @@
 #define CH_CFG_OPTIMIZE_SPEED               TRUE
 #endif
 
+/**
+ * @brief   Bitmap-indexed ready list.
+ * @details If enabled then the ready list insertion and removal operations
+ *          are performed in constant time using a priority bitmap.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires one pointer of RAM for each priority level.
+ */
+#if !defined(CH_CFG_READY_LIST_BITMAP)
+#define CH_CFG_READY_LIST_BITMAP            FALSE
+#endif
+
+/**
+ * @brief   Priority buckets in threads queues.
+ * @details If enabled then the threads waiting in priority ordered queues
+ *          are grouped by priority, insertions skip whole buckets.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires one pointer and one byte of RAM in each thread.
+ */
+#if !defined(CH_CFG_QUEUE_BUCKETS)
+#define CH_CFG_QUEUE_BUCKETS                TRUE
+#endif
+
+/**
+ * @brief   Timing wheel virtual timers.
+ * @details If enabled then the virtual timers are organized in a
+ *          hierarchical timing wheel, arming and disarming timers have
+ *          a bounded cost regardless of the number of armed timers.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_VT_WHEEL)
+#define CH_CFG_VT_WHEEL                     FALSE
+#endif
+
+/**
+ * @brief   Number of levels of the timing wheel.
+ * @details Each level has 32 slots, the wheel spans 2^(5 * levels) ticks.
+ *
+ * @note    The default is 4.
+ * @note    Requires @p CH_CFG_VT_WHEEL.
+ */
+#if !defined(CH_CFG_VT_WHEEL_LEVELS)
+#define CH_CFG_VT_WHEEL_LEVELS              4
+#endif
+
+/**
+ * @brief   64 bits monotonic time stamps.
+ * @details If enabled then the system time is extended to a 64 bits
+ *          time stamp that never wraps, see @p chVTGetTimeStampI().
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_TIMESTAMP)
+#define CH_CFG_USE_TIMESTAMP                TRUE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -175,6 +254,18 @@
 #define CH_CFG_USE_TM                       TRUE
 #endif
 
+/**
+ * @brief   Time Measurement histograms.
+ * @details If enabled then a log2-bucketed histogram can be attached to
+ *          time measurement objects for percentile queries, the kernel
+ *          statistics use it for the critical zones measurements.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_TM_HISTOGRAM)
+#define CH_CFG_USE_TM_HISTOGRAM             TRUE
+#endif
+
 /**
  * @brief   Threads registry APIs.
  * @details If enabled then the registry APIs are included in the kernel.
@@ -185,6 +276,19 @@
 #define CH_CFG_USE_REGISTRY                 TRUE
 #endif
 
+/**
+ * @brief   Registry index size.
+ * @details If non-zero the registry threads are indexed by name and by
+ *          pointer in hash tables with this number of buckets, the
+ *          registry find functions do not scan the whole registry.
+ *
+ * @note    The default is zero, the feature is disabled.
+ * @note    It must be a power of two.
+ */
+#if !defined(CH_CFG_REGISTRY_INDEX_SIZE)
+#define CH_CFG_REGISTRY_INDEX_SIZE          16
+#endif
+
 /**
  * @brief   Threads synchronization APIs.
  * @details If enabled then the @p chThdWait() function is included in
@@ -196,6 +300,65 @@
 #define CH_CFG_USE_WAITEXIT                 TRUE
 #endif
 
+/**
+ * @brief   Scheduler batches APIs.
+ * @details If enabled then the @p chSchBatchBegin() and @p chSchBatchEnd()
+ *          functions are included in the kernel, reschedule points inside
+ *          a batch are deferred to its end.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_SCHED_BATCH)
+#define CH_CFG_USE_SCHED_BATCH              TRUE
+#endif
+
+/**
+ * @brief   Threads execution budgets APIs.
+ * @details If enabled then the @p chThdSetBudget() and
+ *          @p chThdClearBudget() functions are included in the kernel, a
+ *          budgeted thread is demoted to a background priority when its
+ *          budget is used up.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_BUDGET)
+#define CH_CFG_USE_BUDGET                   TRUE
+#endif
+
+/**
+ * @brief   Periodic threads APIs.
+ * @details If enabled then the @p chPeriodicThreadCreate() and
+ *          @p chThdWaitNextPeriod() functions are included in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_PERIODIC)
+#define CH_CFG_USE_PERIODIC                 TRUE
+#endif
+
+/**
+ * @brief   Earliest deadline first priority band.
+ * @details Threads at this priority level are scheduled in deadline order,
+ *          deadlines are set using @p chThdSetDeadline() and
+ *          @p chThdSleepUntilRelease().
+ *
+ * @note    The default is zero, the feature is disabled.
+ */
+#if !defined(CH_CFG_EDF_PRIO)
+#define CH_CFG_EDF_PRIO                     136
+#endif
+
+/**
+ * @brief   Static threads table.
+ * @details If enabled then the threads described in the application
+ *          threads table are created by @p chSysInit().
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_THREADS_TABLE)
+#define CH_CFG_USE_THREADS_TABLE            TRUE
+#endif
+
 /**
  * @brief   Semaphores APIs.
  * @details If enabled then the Semaphores APIs are included in the kernel.
@@ -241,6 +404,31 @@
 #define CH_CFG_USE_MUTEXES_RECURSIVE        FALSE
 #endif
 
+/**
+ * @brief   Priority ceiling mutexes.
+ * @details If enabled then mutexes can be given a ceiling priority using
+ *          @p chMtxObjectInitCeiling(), those mutexes use the immediate
+ *          priority ceiling protocol instead of priority inheritance.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_MUTEXES.
+ */
+#if !defined(CH_CFG_USE_MUTEXES_CEILING)
+#define CH_CFG_USE_MUTEXES_CEILING          TRUE
+#endif
+
+/**
+ * @brief   Adaptive mutexes spin count.
+ * @details Number of times a thread yields to a ready mutex owner at the
+ *          same priority before going to sleep on the mutex.
+ *
+ * @note    The default is 0, adaptive behavior disabled.
+ * @note    Requires @p CH_CFG_USE_MUTEXES.
+ */
+#if !defined(CH_CFG_MUTEXES_SPIN_COUNT)
+#define CH_CFG_MUTEXES_SPIN_COUNT           2
+#endif
+
 /**
  * @brief   Conditional Variables APIs.
  * @details If enabled then the conditional variables APIs are included
@@ -265,6 +453,17 @@
 #define CH_CFG_USE_CONDVARS_TIMEOUT         TRUE
 #endif
 
+/**
+ * @brief   Reader-writer locks APIs.
+ * @details If enabled then the reader-writer locks APIs are included
+ *          in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_RWLOCKS)
+#define CH_CFG_USE_RWLOCKS                  TRUE
+#endif
+
 /**
  * @brief   Events Flags APIs.
  * @details If enabled then the event flags APIs are included in the kernel.
@@ -287,6 +486,18 @@
 #define CH_CFG_USE_EVENTS_TIMEOUT           TRUE
 #endif
 
+/**
+ * @brief   Multiple objects wait APIs.
+ * @details If enabled then the @p chWaitMultipleTimeout() API is included
+ *          in the kernel, a thread can wait on several semaphores,
+ *          mailboxes and its own events at once.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_WAIT_MULTIPLE)
+#define CH_CFG_USE_WAIT_MULTIPLE            TRUE
+#endif
+
 /**
  * @brief   Synchronous Messages APIs.
  * @details If enabled then the synchronous messages APIs are included
@@ -311,6 +522,17 @@
 #define CH_CFG_USE_MESSAGES_PRIORITY        FALSE
 #endif
 
+/**
+ * @brief   Work queues APIs.
+ * @details If enabled then the work queues APIs are included in the
+ *          kernel, works are executed in thread context by worker threads.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_WORKQUEUES)
+#define CH_CFG_USE_WORKQUEUES               TRUE
+#endif
+
 /**
  * @brief   Mailboxes APIs.
  * @details If enabled then the asynchronous messages (mailboxes) APIs are
@@ -348,6 +570,31 @@
 #define CH_CFG_USE_HEAP                     TRUE
 #endif
 
+/**
+ * @brief   TLSF heap allocator.
+ * @details If enabled then the heap uses a Two-Level Segregated Fit
+ *          allocator with constant time allocation and release instead
+ *          of the first-fit allocator.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_HEAP.
+ */
+#if !defined(CH_CFG_HEAP_ALGORITHM_TLSF)
+#define CH_CFG_HEAP_ALGORITHM_TLSF          FALSE
+#endif
+
+/**
+ * @brief   Slab front-end for the default heap.
+ * @details If enabled then small allocations from the default heap are
+ *          served by per-size-class memory pools refilled from the heap.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_HEAP and @p CH_CFG_USE_MEMPOOLS.
+ */
+#if !defined(CH_CFG_HEAP_SLAB)
+#define CH_CFG_HEAP_SLAB                    FALSE
+#endif
+
 /**
  * @brief   Memory Pools Allocator APIs.
  * @details If enabled then the memory pools allocator APIs are included
@@ -359,6 +606,19 @@
 #define CH_CFG_USE_MEMPOOLS                 TRUE
 #endif
 
+/**
+ * @brief   Lock-free memory pools.
+ * @details If enabled then memory pools objects are allocated and released
+ *          using exclusive load/store instructions without entering
+ *          critical zones.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires an ARMv7-M or ARMv7E-M port.
+ */
+#if !defined(CH_CFG_POOL_LOCKFREE)
+#define CH_CFG_POOL_LOCKFREE                FALSE
+#endif
+
 /**
  * @brief   Objects FIFOs APIs.
  * @details If enabled then the objects FIFOs APIs are included
@@ -381,6 +641,52 @@
 #define CH_CFG_USE_PIPES                    TRUE
 #endif
 
+/**
+ * @brief   Ring buffers APIs.
+ * @details If enabled then the lock-free single producer single consumer
+ *          ring buffers APIs are included in the kernel.
+ *
+ * @note    The default is @p TRUE.
+ */
+#if !defined(CH_CFG_USE_RING_BUFFERS)
+#define CH_CFG_USE_RING_BUFFERS             TRUE
+#endif
+
+/**
+ * @brief   Priority objects FIFOs APIs.
+ * @details If enabled then the objects FIFOs ordered by key are included
+ *          in the kernel.
+ *
+ * @note    The default is @p TRUE.
+ * @note    Requires @p CH_CFG_USE_MEMPOOLS and @p CH_CFG_USE_SEMAPHORES.
+ */
+#if !defined(CH_CFG_USE_OBJ_PFIFOS)
+#define CH_CFG_USE_OBJ_PFIFOS               TRUE
+#endif
+
+/**
+ * @brief   Topics bus APIs.
+ * @details If enabled then the publish/subscribe topics are included in
+ *          the kernel.
+ *
+ * @note    The default is @p TRUE.
+ * @note    Requires @p CH_CFG_USE_MEMPOOLS.
+ */
+#if !defined(CH_CFG_USE_TOPICS)
+#define CH_CFG_USE_TOPICS                   TRUE
+#endif
+
+/**
+ * @brief   Watchdog monitor APIs.
+ * @details If enabled then the threads watchdog monitor is included in
+ *          the kernel.
+ *
+ * @note    The default is @p TRUE.
+ */
+#if !defined(CH_CFG_USE_WATCHDOG)
+#define CH_CFG_USE_WATCHDOG                 TRUE
+#endif
+
 /**
  * @brief   Dynamic Threads APIs.
  * @details If enabled then the dynamic threads creation APIs are included
@@ -394,6 +700,18 @@
 #define CH_CFG_USE_DYNAMIC                  TRUE
 #endif
 
+/**
+ * @brief   Dynamic threads cache.
+ * @details If enabled then the working areas of terminated dynamic
+ *          threads can be kept in a cache and reused.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_DYNAMIC and @p CH_CFG_USE_HEAP.
+ */
+#if !defined(CH_CFG_USE_THREAD_CACHE)
+#define CH_CFG_USE_THREAD_CACHE             TRUE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -575,6 +893,27 @@
 #define CH_DBG_THREADS_PROFILING            TRUE
 #endif
 
+/**
+ * @brief   Debug option, wait profiler.
+ * @details If enabled then the time spent by threads waiting is recorded
+ *          for each thread, wait object and wait state.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_DBG_WAIT_PROFILE)
+#define CH_DBG_WAIT_PROFILE                 TRUE
+#endif
+
+/**
+ * @brief   Wait profiler table size.
+ * @note    It must be a power of two.
+ *
+ * @note    The default is 32.
+ */
+#if !defined(CH_DBG_WAIT_PROFILE_ENTRIES)
+#define CH_DBG_WAIT_PROFILE_ENTRIES         32
+#endif
+
 /** @} */
 
 /*===========================================================================*/
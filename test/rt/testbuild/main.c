@@ -24,6 +24,16 @@
 #include "oslib_test_root.h"
 #include "console.h"
 
+#if CH_CFG_USE_THREADS_TABLE == TRUE
+/*
+ * Static threads table, the test thread is created by chSysInit().
+ */
+THD_TABLE_BEGIN
+  THD_TABLE_ENTRY(wa_test_table, "table", NORMALPRIO + 1, test_table_thread,
+                  (void *)wa_test_table)
+THD_TABLE_END
+#endif
+
 /*
  * Simulator main.
  */
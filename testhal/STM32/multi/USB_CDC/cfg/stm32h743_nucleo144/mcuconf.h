@@ -197,12 +197,17 @@
 /*
  * CAN driver system settings.
  */
-#define STM32_CAN_USE_CAN1                  FALSE
-#define STM32_CAN_USE_CAN2                  FALSE
-#define STM32_CAN_USE_CAN3                  FALSE
-#define STM32_CAN_CAN1_IRQ_PRIORITY         11
-#define STM32_CAN_CAN2_IRQ_PRIORITY         11
-#define STM32_CAN_CAN3_IRQ_PRIORITY         11
+#define STM32_CAN_USE_FDCAN1                FALSE
+#define STM32_CAN_USE_FDCAN2                FALSE
+#define STM32_CAN_FDCAN1_IRQ_PRIORITY       11
+#define STM32_CAN_FDCAN2_IRQ_PRIORITY       11
+#define STM32_CAN_STD_FILTERS               16
+#define STM32_CAN_EXT_FILTERS               8
+#define STM32_CAN_RX_FIFO0_SIZE             16
+#define STM32_CAN_RX_FIFO1_SIZE             8
+#define STM32_CAN_TX_FIFO_SIZE              8
+#define STM32_CAN_RX_FIFO0_WATERMARK        0
+#define STM32_CAN_RX_FIFO0_TIMEOUT          1000
 
 /*
  * DAC driver system settings.
@@ -15,6 +15,7 @@
 */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "ch.h"
@@ -32,25 +33,27 @@
 
 #define SHELL_WA_SIZE   THD_WORKING_AREA_SIZE(2048)
 
+/* Block written by the "write" and "bench" commands.*/
+static const uint8_t wrbuf[] =
+    "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+    "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+    "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+    "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+    "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+    "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+    "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+    "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+    "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+    "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+    "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+    "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+    "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+    "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+    "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+    "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef";
+
 /* Can be measured using dd if=/dev/xxxx of=/dev/null bs=512 count=10000.*/
 static void cmd_write(BaseSequentialStream *chp, int argc, char *argv[]) {
-  static uint8_t buf[] =
-      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
-      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
-      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
-      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
-      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
-      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
-      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
-      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
-      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
-      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
-      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
-      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
-      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
-      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
-      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
-      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef";
 
   (void)argv;
   if (argc > 0) {
@@ -61,19 +64,51 @@ static void cmd_write(BaseSequentialStream *chp, int argc, char *argv[]) {
   while (chnGetTimeout((BaseChannel *)chp, TIME_IMMEDIATE) == Q_TIMEOUT) {
 #if 1
     /* Writing in channel mode.*/
-    chnWrite(&PORTAB_SDU1, buf, sizeof buf - 1);
+    chnWrite(&PORTAB_SDU1, wrbuf, sizeof wrbuf - 1);
 #else
     /* Writing in buffer mode.*/
     (void) obqGetEmptyBufferTimeout(&PORTAB_SDU1.obqueue, TIME_INFINITE);
-    memcpy(PORTAB_SDU1.obqueue.ptr, buf, SERIAL_USB_BUFFERS_SIZE);
+    memcpy(PORTAB_SDU1.obqueue.ptr, wrbuf, SERIAL_USB_BUFFERS_SIZE);
     obqPostFullBuffer(&PORTAB_SDU1.obqueue, SERIAL_USB_BUFFERS_SIZE);
 #endif
   }
   chprintf(chp, "\r\n\nstopped\r\n");
 }
 
+/* Start "cat /dev/xxxx >/dev/null" on the host before launching the
+   benchmark, the measured throughput is printed when done.*/
+static void cmd_bench(BaseSequentialStream *chp, int argc, char *argv[]) {
+  unsigned i, kbytes = 1024U;
+  systime_t start;
+  uint32_t ms;
+
+  if (argc > 1) {
+    chprintf(chp, "Usage: bench [kbytes]\r\n");
+    return;
+  }
+  if (argc == 1) {
+    kbytes = (unsigned)atoi(argv[0]);
+  }
+
+  /* Waiting for the output queue to drain before starting the measure.*/
+  chThdSleepMilliseconds(100);
+
+  start = chVTGetSystemTimeX();
+  for (i = 0U; i < kbytes; i++) {
+    chnWrite(&PORTAB_SDU1, wrbuf, sizeof wrbuf - 1);
+  }
+  ms = (uint32_t)TIME_I2MS(chTimeDiffX(start, chVTGetSystemTimeX()));
+  if (ms == 0U) {
+    ms = 1U;
+  }
+
+  chprintf(chp, "\r\n\n%u KB in %u ms, %u KB/s\r\n",
+           kbytes, (unsigned)ms, (unsigned)((kbytes * 1000U) / ms));
+}
+
 static const ShellCommand commands[] = {
   {"write", cmd_write},
+  {"bench", cmd_bench},
   {NULL, NULL}
 };
 
@@ -0,0 +1,446 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    drv_bench.c
+ * @brief   HAL drivers throughput benchmark code.
+ *
+ * @addtogroup DRV_BENCH
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#include "drv_bench.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/**
+ * @brief   Snapshot of the counters at the start or end of a window.
+ */
+typedef struct {
+  rtcnt_t               cnt;
+#if DRV_BENCH_USE_STATISTICS
+  rttime_t              idle;
+  ucnt_t                irq;
+#endif
+} bench_mark_t;
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*
+ * Asynchronous transfers completion.
+ */
+static thread_reference_t bench_tr;
+static bool bench_done;
+static msg_t bench_msg;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static void bench_get_mark(bench_mark_t *mp) {
+
+  osalSysLock();
+  mp->cnt  = chSysGetRealtimeCounterX();
+#if DRV_BENCH_USE_STATISTICS
+  mp->idle = chSysGetIdleThreadX()->runtime;
+  mp->irq  = ch.kernel_stats.n_irq;
+#endif
+  osalSysUnlock();
+}
+
+static void bench_record(const char *name, const char *path, size_t size,
+                         const char *stat, uint32_t value, const char *unit) {
+  char metric[32];
+  char digits[8];
+  unsigned i = 0U, n = 0U;
+
+  while ((*name != '\0') && (i < 12U)) {
+    metric[i++] = *name++;
+  }
+  metric[i++] = '.';
+  while (*path != '\0') {
+    metric[i++] = *path++;
+  }
+  metric[i++] = '.';
+  do {
+    digits[n++] = (char)('0' + (size % 10U));
+    size /= 10U;
+  } while ((size > 0U) && (n < sizeof digits));
+  while (n > 0U) {
+    metric[i++] = digits[--n];
+  }
+  while ((*stat != '\0') && (i < sizeof metric - 1U)) {
+    metric[i++] = *stat++;
+  }
+  metric[i] = '\0';
+
+  test_emit_record(metric, value, unit);
+}
+
+static msg_t bench_wait_completion(void) {
+  msg_t msg = MSG_OK;
+
+  osalSysLock();
+  while (!bench_done && (msg == MSG_OK)) {
+    msg = osalThreadSuspendTimeoutS(&bench_tr, DRV_BENCH_CFG_TIMEOUT);
+  }
+  if (msg == MSG_OK) {
+    msg = bench_msg;
+  }
+  osalSysUnlock();
+
+  return msg;
+}
+
+/*
+ * Runs the transfers of one buffer size for the measurement window.
+ */
+static bool bench_measure(const drv_bench_config_t *cfg, bool async,
+                          size_t n) {
+  const char *path = async ? "async" : "blk";
+  bench_mark_t start, end;
+  systime_t t0, t1;
+  uint64_t bytes = 0U;
+  uint32_t bps;
+
+  /* Starting at the beginning of a tick.*/
+  osalThreadSleep((sysinterval_t)1);
+  t0 = osalOsGetSystemTimeX();
+  t1 = osalTimeAddX(t0, DRV_BENCH_CFG_WINDOW);
+  bench_get_mark(&start);
+  do {
+    msg_t msg;
+
+    if (async) {
+      bench_done = false;
+      msg = cfg->start(cfg->param, n);
+      if (msg == MSG_OK) {
+        msg = bench_wait_completion();
+      }
+    }
+    else {
+      msg = cfg->transfer(cfg->param, n);
+    }
+    if (msg != MSG_OK) {
+      return true;
+    }
+    bytes += n;
+  } while (osalTimeIsInRangeX(osalOsGetSystemTimeX(), t0, t1));
+  bench_get_mark(&end);
+  bps = (uint32_t)((bytes * (uint64_t)OSAL_ST_FREQUENCY) /
+                   (uint64_t)osalTimeDiffX(t0, osalOsGetSystemTimeX()));
+
+  test_print("--- Score : ");
+  test_print(cfg->name);
+  test_print(" ");
+  test_print(path);
+  test_print(" ");
+  test_printn((uint32_t)n);
+  test_print(" B: ");
+  test_printn(bps);
+#if DRV_BENCH_USE_STATISTICS
+  {
+    rttime_t total = (rttime_t)(rtcnt_t)(end.cnt - start.cnt);
+    rttime_t idle = end.idle - start.idle;
+    uint32_t load, irqs;
+
+    /* CPU load in permille, everything not spent in the idle thread.*/
+    if (idle > total) {
+      idle = total;
+    }
+    load = 1000U - (uint32_t)((idle * 1000U) / total);
+    irqs = (uint32_t)(((uint64_t)(end.irq - start.irq) * 1048576U) / bytes);
+    test_print(" B/S, CPU ");
+    test_printn(load / 10U);
+    test_print(".");
+    test_printn(load % 10U);
+    test_print("%, ");
+    test_printn(irqs);
+    test_println(" IRQs/MB");
+    bench_record(cfg->name, path, n, ".cpu", load, "permille");
+    bench_record(cfg->name, path, n, ".irq", irqs, "IRQs/MB");
+  }
+#else
+  (void)end;
+  test_println(" B/S");
+#endif
+  bench_record(cfg->name, path, n, "", bps, "B/S");
+
+  return false;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Executes a driver benchmark.
+ * @details The blocking and asynchronous transfer functions are measured
+ *          for each buffer size. The function is meant to be invoked
+ *          from the execute function of a test case, failed transfers
+ *          are reported as test failures.
+ *
+ * @param[in] cfg       pointer to the benchmark configuration
+ */
+void drv_bench_execute(const drv_bench_config_t *cfg) {
+  const size_t *sp;
+
+  if (cfg->transfer != NULL) {
+    for (sp = cfg->sizes; *sp != 0U; sp++) {
+      test_assert(!bench_measure(cfg, false, *sp), "transfer failed");
+    }
+  }
+
+  if (cfg->start != NULL) {
+    for (sp = cfg->sizes; *sp != 0U; sp++) {
+      test_assert(!bench_measure(cfg, true, *sp), "transfer failed");
+    }
+  }
+}
+
+/**
+ * @brief   Notifies the end of an asynchronous transfer.
+ *
+ * @param[in] msg       transfer result
+ *
+ * @iclass
+ */
+void drv_bench_complete_i(msg_t msg) {
+
+  bench_done = true;
+  bench_msg  = msg;
+  osalThreadResumeI(&bench_tr, MSG_OK);
+}
+
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   SPI blocking transfer.
+ *
+ * @param[in] p         pointer to a @p drv_bench_spi_t structure
+ * @param[in] n         number of bytes to be exchanged
+ * @return              The operation status.
+ */
+msg_t drv_bench_spi_transfer(void *p, size_t n) {
+  drv_bench_spi_t *bp = (drv_bench_spi_t *)p;
+
+  spiExchange(bp->spip, n, bp->txbuf, bp->rxbuf);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   SPI asynchronous transfer.
+ *
+ * @param[in] p         pointer to a @p drv_bench_spi_t structure
+ * @param[in] n         number of bytes to be exchanged
+ * @return              The operation status.
+ */
+msg_t drv_bench_spi_start(void *p, size_t n) {
+  drv_bench_spi_t *bp = (drv_bench_spi_t *)p;
+
+  spiStartExchange(bp->spip, n, bp->txbuf, bp->rxbuf);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   SPI end of transfer callback.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ */
+void drv_bench_spi_cb(SPIDriver *spip) {
+
+  (void)spip;
+
+  osalSysLockFromISR();
+  drv_bench_complete_i(MSG_OK);
+  osalSysUnlockFromISR();
+}
+#endif /* HAL_USE_SPI == TRUE */
+
+#if (HAL_USE_UART == TRUE) || defined(__DOXYGEN__)
+#if (UART_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   UART blocking transmission.
+ *
+ * @param[in] p         pointer to a @p drv_bench_uart_t structure
+ * @param[in] n         number of bytes to be transmitted
+ * @return              The operation status.
+ */
+msg_t drv_bench_uart_transfer(void *p, size_t n) {
+  drv_bench_uart_t *bp = (drv_bench_uart_t *)p;
+
+  return uartSendFullTimeout(bp->uartp, &n, bp->txbuf, DRV_BENCH_CFG_TIMEOUT);
+}
+#endif /* UART_USE_WAIT == TRUE */
+
+/**
+ * @brief   UART asynchronous transmission.
+ *
+ * @param[in] p         pointer to a @p drv_bench_uart_t structure
+ * @param[in] n         number of bytes to be transmitted
+ * @return              The operation status.
+ */
+msg_t drv_bench_uart_start(void *p, size_t n) {
+  drv_bench_uart_t *bp = (drv_bench_uart_t *)p;
+
+  uartStartSend(bp->uartp, n, bp->txbuf);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   UART physical end of transmission callback.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ */
+void drv_bench_uart_cb(UARTDriver *uartp) {
+
+  (void)uartp;
+
+  osalSysLockFromISR();
+  drv_bench_complete_i(MSG_OK);
+  osalSysUnlockFromISR();
+}
+#endif /* HAL_USE_UART == TRUE */
+
+/**
+ * @brief   Serial channel blocking write.
+ *
+ * @param[in] p         pointer to a @p drv_bench_channel_t structure
+ * @param[in] n         number of bytes to be written
+ * @return              The operation status.
+ */
+msg_t drv_bench_channel_transfer(void *p, size_t n) {
+  drv_bench_channel_t *bp = (drv_bench_channel_t *)p;
+
+  if (chnWriteTimeout(bp->chp, bp->txbuf, n, DRV_BENCH_CFG_TIMEOUT) != n) {
+    return MSG_TIMEOUT;
+  }
+
+  return MSG_OK;
+}
+
+#if (HAL_USE_SDC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   SDC blocking transfer.
+ *
+ * @param[in] p         pointer to a @p drv_bench_sdc_t structure
+ * @param[in] n         number of bytes to be read or written
+ * @return              The operation status.
+ */
+msg_t drv_bench_sdc_transfer(void *p, size_t n) {
+  drv_bench_sdc_t *bp = (drv_bench_sdc_t *)p;
+  bool result;
+
+  if ((n % MMCSD_BLOCK_SIZE) != 0U) {
+    return MSG_RESET;
+  }
+
+  if (bp->write) {
+    result = sdcWrite(bp->sdcp, bp->startblk, bp->buf,
+                      (uint32_t)(n / MMCSD_BLOCK_SIZE));
+  }
+  else {
+    result = sdcRead(bp->sdcp, bp->startblk, bp->buf,
+                     (uint32_t)(n / MMCSD_BLOCK_SIZE));
+  }
+
+  return result == HAL_SUCCESS ? MSG_OK : MSG_RESET;
+}
+
+#if (SDC_USE_ASYNC_TRANSFERS == TRUE) || defined(__DOXYGEN__)
+static void bench_sdc_cb(SDCDriver *sdcp, bool result) {
+
+  (void)sdcp;
+
+  osalSysLockFromISR();
+  drv_bench_complete_i(result == HAL_SUCCESS ? MSG_OK : MSG_RESET);
+  osalSysUnlockFromISR();
+}
+
+/**
+ * @brief   SDC asynchronous transfer.
+ *
+ * @param[in] p         pointer to a @p drv_bench_sdc_t structure
+ * @param[in] n         number of bytes to be read or written
+ * @return              The operation status.
+ */
+msg_t drv_bench_sdc_start(void *p, size_t n) {
+  drv_bench_sdc_t *bp = (drv_bench_sdc_t *)p;
+  bool result;
+
+  if ((n % MMCSD_BLOCK_SIZE) != 0U) {
+    return MSG_RESET;
+  }
+
+  if (bp->write) {
+    result = sdcStartWrite(bp->sdcp, bp->startblk, bp->buf,
+                           (uint32_t)(n / MMCSD_BLOCK_SIZE), bench_sdc_cb);
+  }
+  else {
+    result = sdcStartRead(bp->sdcp, bp->startblk, bp->buf,
+                          (uint32_t)(n / MMCSD_BLOCK_SIZE), bench_sdc_cb);
+  }
+
+  return result == HAL_SUCCESS ? MSG_OK : MSG_RESET;
+}
+#endif /* SDC_USE_ASYNC_TRANSFERS == TRUE */
+#endif /* HAL_USE_SDC == TRUE */
+
+#if ((HAL_USE_MAC == TRUE) && (MAC_USE_ZERO_COPY == FALSE)) ||              \
+    defined(__DOXYGEN__)
+/**
+ * @brief   MAC frame transmission.
+ * @note    The function returns when the frame has been queued, the
+ *          sustained throughput is limited by the transmit descriptors
+ *          becoming available again.
+ *
+ * @param[in] p         pointer to a @p drv_bench_mac_t structure
+ * @param[in] n         frame size
+ * @return              The operation status.
+ */
+msg_t drv_bench_mac_transfer(void *p, size_t n) {
+  drv_bench_mac_t *bp = (drv_bench_mac_t *)p;
+  MACTransmitDescriptor td;
+  msg_t msg;
+
+  msg = macWaitTransmitDescriptor(bp->macp, &td, DRV_BENCH_CFG_TIMEOUT);
+  if (msg == MSG_OK) {
+    (void)macWriteTransmitDescriptor(&td, bp->txbuf, n);
+    macReleaseTransmitDescriptor(&td);
+  }
+
+  return msg;
+}
+#endif /* (HAL_USE_MAC == TRUE) && (MAC_USE_ZERO_COPY == FALSE) */
+
+/** @} */
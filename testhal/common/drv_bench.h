@@ -0,0 +1,227 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    drv_bench.h
+ * @brief   HAL drivers throughput benchmark header.
+ * @details The benchmark is executed from a test case of a test suite
+ *          using @p drv_bench_execute(), results are printed and emitted
+ *          as records by the test harness. For each buffer size the
+ *          driver transfers run for a measurement window, the sustained
+ *          throughput is reported together with the CPU load and the
+ *          IRQs per megabyte when @p CH_DBG_STATISTICS is enabled.<br>
+ *          Adapters are provided for the SPI, UART, serial channels
+ *          (SERIAL and SERIAL_USB), SDC and MAC drivers, the driver
+ *          configuration decides DMA usage, the same driver can be
+ *          measured from several test cases using different
+ *          configurations.
+ *
+ * @addtogroup DRV_BENCH
+ * @{
+ */
+
+#ifndef DRV_BENCH_H
+#define DRV_BENCH_H
+
+#include "ch_test.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Measurement window for each buffer size.
+ */
+#if !defined(DRV_BENCH_CFG_WINDOW) || defined(__DOXYGEN__)
+#define DRV_BENCH_CFG_WINDOW                TIME_MS2I(1000)
+#endif
+
+/**
+ * @brief   Timeout of a single transfer.
+ */
+#if !defined(DRV_BENCH_CFG_TIMEOUT) || defined(__DOXYGEN__)
+#define DRV_BENCH_CFG_TIMEOUT               TIME_MS2I(1000)
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/**
+ * @brief   CPU load and IRQs accounting availability.
+ */
+#define DRV_BENCH_USE_STATISTICS                                            \
+  ((CH_DBG_STATISTICS == TRUE) && (CH_CFG_NO_IDLE_THREAD == FALSE))
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a transfer function.
+ * @details For blocking transfers the function returns at the end of
+ *          the transfer. For asynchronous transfers the function starts
+ *          the transfer and the end is notified by calling
+ *          @p drv_bench_complete_i().
+ *
+ * @param[in] p         adapter parameter
+ * @param[in] n         number of bytes to be transferred
+ * @return              The operation status.
+ * @retval MSG_OK       if the transfer has been performed or started.
+ */
+typedef msg_t (*drv_bench_xfer_t)(void *p, size_t n);
+
+/**
+ * @brief   Benchmark configuration.
+ */
+typedef struct {
+  /**
+   * @brief   Name used in results and records.
+   */
+  const char            *name;
+  /**
+   * @brief   Adapter parameter.
+   */
+  void                  *param;
+  /**
+   * @brief   Blocking transfer function or @p NULL.
+   */
+  drv_bench_xfer_t      transfer;
+  /**
+   * @brief   Asynchronous transfer start function or @p NULL.
+   */
+  drv_bench_xfer_t      start;
+  /**
+   * @brief   Zero-terminated list of buffer sizes.
+   */
+  const size_t          *sizes;
+} drv_bench_config_t;
+
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   SPI adapter parameter.
+ * @note    For asynchronous transfers the @p end_cb field of the SPI
+ *          configuration must be @p drv_bench_spi_cb().
+ */
+typedef struct {
+  SPIDriver             *spip;
+  const void            *txbuf;
+  void                  *rxbuf;
+} drv_bench_spi_t;
+#endif
+
+#if (HAL_USE_UART == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   UART adapter parameter.
+ * @note    For asynchronous transfers the @p txend2_cb field of the UART
+ *          configuration must be @p drv_bench_uart_cb().
+ */
+typedef struct {
+  UARTDriver            *uartp;
+  const void            *txbuf;
+} drv_bench_uart_t;
+#endif
+
+/**
+ * @brief   Serial channel adapter parameter.
+ */
+typedef struct {
+  BaseChannel           *chp;
+  const uint8_t         *txbuf;
+} drv_bench_channel_t;
+
+#if (HAL_USE_SDC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   SDC adapter parameter.
+ * @note    Sizes must be multiple of @p MMCSD_BLOCK_SIZE.
+ */
+typedef struct {
+  SDCDriver             *sdcp;
+  uint8_t               *buf;
+  uint32_t              startblk;
+  bool                  write;
+} drv_bench_sdc_t;
+#endif
+
+#if ((HAL_USE_MAC == TRUE) && (MAC_USE_ZERO_COPY == FALSE)) ||              \
+    defined(__DOXYGEN__)
+/**
+ * @brief   MAC adapter parameter.
+ * @note    Sizes are frame sizes, the buffer must contain a valid
+ *          Ethernet header.
+ */
+typedef struct {
+  MACDriver             *macp;
+  uint8_t               *txbuf;
+} drv_bench_mac_t;
+#endif
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void drv_bench_execute(const drv_bench_config_t *cfg);
+  void drv_bench_complete_i(msg_t msg);
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+  msg_t drv_bench_spi_transfer(void *p, size_t n);
+  msg_t drv_bench_spi_start(void *p, size_t n);
+  void drv_bench_spi_cb(SPIDriver *spip);
+#endif
+#if (HAL_USE_UART == TRUE) || defined(__DOXYGEN__)
+#if (UART_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+  msg_t drv_bench_uart_transfer(void *p, size_t n);
+#endif
+  msg_t drv_bench_uart_start(void *p, size_t n);
+  void drv_bench_uart_cb(UARTDriver *uartp);
+#endif
+  msg_t drv_bench_channel_transfer(void *p, size_t n);
+#if (HAL_USE_SDC == TRUE) || defined(__DOXYGEN__)
+  msg_t drv_bench_sdc_transfer(void *p, size_t n);
+#if (SDC_USE_ASYNC_TRANSFERS == TRUE) || defined(__DOXYGEN__)
+  msg_t drv_bench_sdc_start(void *p, size_t n);
+#endif
+#endif
+#if ((HAL_USE_MAC == TRUE) && (MAC_USE_ZERO_COPY == FALSE)) ||              \
+    defined(__DOXYGEN__)
+  msg_t drv_bench_mac_transfer(void *p, size_t n);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* DRV_BENCH_H */
+
+/** @} */
@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+#
+#   ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+#
+
+"""Comparator for the benchmark records of the ChibiOS test suites.
+
+Reads two captures of a test suite run built with TEST_EMIT_RECORDS
+enabled, the baseline and the new run, and compares the metrics of each
+test case. Units ending in "/S" are throughputs where higher is better,
+for all the other units (cycles, bytes) lower is better.
+
+The exit status is 1 if a metric regressed beyond the threshold or is
+missing from the new run, 0 otherwise, so the script can gate a release
+process. Anything in the captures that is not a record is ignored.
+
+Usage: benchcmp.py [-t PERCENT] [-a] [-s] [-v] BASELINE NEW
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    """Returns the records of a capture as a dictionary indexed by
+    (test, metric) and the set of configuration hashes found."""
+    records = {}
+    configs = set()
+    with open(path, "r", errors="replace") as f:
+        for line in f:
+            start = line.find("{")
+            if start < 0:
+                continue
+            try:
+                rec = json.loads(line[start:].strip())
+            except ValueError:
+                continue
+            if not isinstance(rec, dict) or \
+               not all(k in rec for k in ("test", "metric", "value", "unit")):
+                continue
+            key = (rec.get("suite", ""), rec["test"], rec["metric"])
+            records[key] = rec
+            configs.add(rec.get("config", ""))
+    return records, configs
+
+
+def higher_is_better(unit):
+    return unit.endswith("/S")
+
+
+def test_order(key):
+    suite, test, metric = key
+    try:
+        seq, case = (int(x) for x in test.split("."))
+    except ValueError:
+        seq, case = 0, 0
+    return (suite, seq, case, metric)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline", help="baseline run capture")
+    parser.add_argument("new", help="new run capture")
+    parser.add_argument("-t", "--threshold", type=float, default=5.0,
+                        help="allowed degradation in percent (default 5)")
+    parser.add_argument("-a", "--allow-missing", action="store_true",
+                        help="metrics missing in the new run are not errors")
+    parser.add_argument("-s", "--strict-config", action="store_true",
+                        help="different configuration hashes are an error")
+    parser.add_argument("-v", "--verbose", action="store_true",
+                        help="also list the unchanged metrics")
+    args = parser.parse_args()
+
+    base, base_cfg = load(args.baseline)
+    new, new_cfg = load(args.new)
+    if not base:
+        sys.exit("no records in %s" % args.baseline)
+
+    failed = False
+    if base_cfg != new_cfg:
+        print("configuration hash differs: %s -> %s" %
+              (",".join(sorted(base_cfg)), ",".join(sorted(new_cfg))))
+        failed = failed or args.strict_config
+
+    limit = args.threshold / 100.0
+    regressions = improvements = 0
+    for key in sorted(set(base) | set(new), key=test_order):
+        suite, test, metric = key
+        name = "%s %s" % (test, metric)
+        if key not in new:
+            print("MISSING    %s" % name)
+            failed = failed or not args.allow_missing
+            continue
+        if key not in base:
+            print("NEW        %-28s %12d %s" %
+                  (name, new[key]["value"], new[key]["unit"]))
+            continue
+        b = base[key]["value"]
+        n = new[key]["value"]
+        unit = new[key]["unit"]
+        if b == 0:
+            change = 0.0 if n == 0 else float("inf")
+        else:
+            change = (n - b) / float(b)
+        if not higher_is_better(unit):
+            change = -change
+        if change < -limit:
+            tag = "REGRESSION"
+            regressions += 1
+            failed = True
+        elif change > limit:
+            tag = "IMPROVED  "
+            improvements += 1
+        elif args.verbose:
+            tag = "          "
+        else:
+            continue
+        print("%s %-28s %12d -> %12d %-10s %+7.2f%%" %
+              (tag, name, b, n, unit, change * 100.0))
+
+    print("%d metrics compared, %d regressions, %d improvements" %
+          (len(set(base) & set(new)), regressions, improvements))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
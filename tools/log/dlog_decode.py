@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+#
+#   ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+#
+
+"""Decoder for the deferred log binary frames (os/hal/lib/streams/deflog).
+
+Reads a raw capture of the frames sent by dlogSendNext() and prints the
+formatted log lines, format strings and %s arguments are resolved using the
+firmware ELF file.
+
+Usage: dlog_decode.py -e ELF [-p PREFIX] [-a ARGBITS] CAPTURE
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+
+SPEC = re.compile(r"%([-+ #0]*)(\*|\d*)(?:\.(\*|\d*))?(l?)([a-zA-Z%])")
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data) + 1:
+            raise ValueError("bad COBS frame")
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def frames(raw):
+    for chunk in raw.split(b"\x00"):
+        if chunk:
+            try:
+                yield cobs_decode(chunk)
+            except ValueError:
+                yield None
+
+
+def varint(buf, pos):
+    value = 0
+    shift = 0
+    while True:
+        b = buf[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        shift += 7
+        if b < 0x80:
+            return value, pos
+
+
+def load_image(elf, prefix):
+    """Returns a function resolving string pointers using the ELF file."""
+    image = {}
+    try:
+        sections = subprocess.run([prefix + "objdump", "-h", "-w", elf],
+                                  capture_output=True, text=True,
+                                  check=True).stdout
+    except (OSError, subprocess.CalledProcessError):
+        sections = ""
+    for line in sections.splitlines():
+        fields = line.split()
+        if len(fields) > 6 and fields[1].startswith(".") and \
+           "LOAD" in line and "CONTENTS" in line:
+            name, size, vma = fields[1], int(fields[2], 16), int(fields[3], 16)
+            dump = subprocess.run([prefix + "objcopy", "-O", "binary",
+                                   "--only-section", name, elf, "/dev/stdout"],
+                                  capture_output=True).stdout
+            image[vma] = dump[:size]
+
+    def resolve(ptr):
+        for vma, data in image.items():
+            if vma <= ptr < vma + len(data):
+                end = data.find(b"\x00", ptr - vma)
+                return data[ptr - vma:end].decode("latin-1")
+        return None
+    return resolve
+
+
+def signed(value, bits):
+    value &= (1 << bits) - 1
+    return value - (1 << bits) if value >> (bits - 1) else value
+
+
+def format_record(fmt, args, resolve, bits):
+    """Formats a record following the chprintf() conventions."""
+    args = list(args)
+
+    def take():
+        return args.pop(0) if args else 0
+
+    def conv(m):
+        flags, width, prec, long, c = m.groups()
+        if c == "%":
+            return "%"
+        if width == "*":
+            width = str(signed(take(), bits))
+        if prec == "*":
+            prec = str(take())
+        spec = "%" + flags + width + ("." + prec if prec else "")
+        lower = c.lower()
+        if lower in "di":
+            return (spec + "d") % signed(take(), bits)
+        if lower in "uxo":
+            # chprintf() prints hexadecimal digits in upper case.
+            return (spec + {"u": "d", "x": "X", "o": "o"}[lower]) % take()
+        if lower == "q":
+            fbits = 31 if (c == "Q" or long) else 15
+            digits = int(prec) if prec and 0 < int(prec) <= 9 else \
+                (9 if fbits == 31 else 5)
+            v = signed(take(), 32 if fbits == 31 else bits)
+            mag = -v if v < 0 else v
+            frac = ((mag & ((1 << fbits) - 1)) * 10 ** digits) >> fbits
+            text = "%s%d.%0*d" % ("-" if v < 0 else "", mag >> fbits,
+                                  digits, frac)
+            return ("%" + flags.replace("0", "") + width + "s") % text
+        if c == "c":
+            return (spec + "c") % chr(take() & 0xFF)
+        if c == "s":
+            ptr = take()
+            s = resolve(ptr)
+            return (spec + "s") % (s if s is not None else "<0x%x>" % ptr)
+        if c == "p":
+            return "0x%x" % take()
+        return "%" + c
+    return SPEC.sub(conv, fmt)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", help="raw frames capture file")
+    parser.add_argument("-e", "--elf", required=True,
+                        help="firmware ELF, resolves the format strings")
+    parser.add_argument("-p", "--prefix", default="arm-none-eabi-",
+                        help="binutils prefix (default arm-none-eabi-)")
+    parser.add_argument("-a", "--argbits", type=int, default=32,
+                        help="target pointer size in bits (default 32)")
+    args = parser.parse_args()
+
+    with open(args.capture, "rb") as fh:
+        raw = fh.read()
+    resolve = load_image(args.elf, args.prefix)
+
+    last = None
+    lost = 0
+    for f in frames(raw):
+        if f is None:
+            print("<corrupted frame>")
+            continue
+        try:
+            pos = 0
+            seq, pos = varint(f, pos)
+            fmtp, pos = varint(f, pos)
+            time, pos = varint(f, pos)
+            n, pos = varint(f, pos)
+            values = []
+            for _ in range(n):
+                v, pos = varint(f, pos)
+                values.append(v)
+        except IndexError:
+            print("<truncated frame>")
+            continue
+        if last is not None and seq != ((last + 1) & 0xFFFFFF):
+            missing = (seq - last - 1) & 0xFFFFFF
+            lost += missing
+            print("<lost %d records>" % missing)
+        last = seq
+        fmt = resolve(fmtp)
+        if fmt is None:
+            line = "<fmt 0x%x> %s" % (fmtp, " ".join("0x%x" % v
+                                                      for v in values))
+        else:
+            line = format_record(fmt, values, resolve, args.argbits)
+        sys.stdout.write("[%10d] %s" % (time, line))
+        if not line.endswith("\n"):
+            sys.stdout.write("\n")
+    if lost:
+        sys.stderr.write("warning: at least %d records lost\n" % lost)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,239 @@
+#!/usr/bin/env python3
+#
+#   ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+#
+
+"""Decoder for the ChibiOS/RT trace stream (os/various/trace_stream).
+
+Reads a raw capture of the stream (SWO with the ITM framing removed, or
+UART) and writes a Chrome trace JSON file that can be loaded in
+chrome://tracing or in the Perfetto UI.
+
+Usage: trace_decode.py [-e ELF] [-p PREFIX] [-o OUT.json] CAPTURE
+"""
+
+import argparse
+import json
+import subprocess
+import sys
+
+TYPE_UNUSED = 0
+TYPE_SWITCH = 1
+TYPE_ISR_ENTER = 2
+TYPE_ISR_LEAVE = 3
+TYPE_HALT = 4
+TYPE_USER = 5
+
+CTRL_HEADER = 0
+CTRL_NAME = 1
+
+STATE_NAMES = ["READY", "CURRENT", "WTSTART", "SUSPENDED", "QUEUED",
+               "WTSEM", "WTMTX", "WTCOND", "SLEEPING", "WTEXIT", "WTOREVT",
+               "WTANDEVT", "SNDMSGQ", "SNDMSG", "WTMSG", "FINAL"]
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data) + 1:
+            raise ValueError("bad COBS frame")
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def frames(raw):
+    for chunk in raw.split(b"\x00"):
+        if chunk:
+            try:
+                yield cobs_decode(chunk)
+            except ValueError:
+                yield None
+
+
+def varint(buf, pos):
+    value = 0
+    shift = 0
+    while True:
+        b = buf[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        shift += 7
+        if b < 0x80:
+            return value, pos
+
+
+def load_strings(elf, prefix):
+    """Returns a function resolving string pointers using the ELF file."""
+    try:
+        sections = subprocess.run([prefix + "objdump", "-h", "-w", elf],
+                                  capture_output=True, text=True,
+                                  check=True).stdout
+    except (OSError, subprocess.CalledProcessError):
+        return lambda ptr: "0x%x" % ptr
+    image = {}
+    for line in sections.splitlines():
+        fields = line.split()
+        if len(fields) > 6 and fields[1].startswith(".") and \
+           "LOAD" in line and "CONTENTS" in line:
+            name, size, vma = fields[1], int(fields[2], 16), int(fields[3], 16)
+            dump = subprocess.run([prefix + "objcopy", "-O", "binary", "--only-section",
+                                   name, elf, "/dev/stdout"],
+                                  capture_output=True).stdout
+            image[vma] = dump[:size]
+
+    def resolve(ptr):
+        for vma, data in image.items():
+            if vma <= ptr < vma + len(data):
+                end = data.find(b"\x00", ptr - vma)
+                return data[ptr - vma:end].decode("latin-1")
+        return "0x%x" % ptr
+    return resolve
+
+
+class Decoder:
+
+    def __init__(self, resolve):
+        self.resolve = resolve
+        self.events = []
+        self.names = {}
+        self.stfreq = 1000
+        self.rtfreq = 0
+        self.rt = 0
+        self.st = 0
+        self.seq = None
+        self.current = None
+        self.lost = 0
+
+    def timestamp(self):
+        """Current time in microseconds."""
+        if self.rtfreq:
+            return self.rt * 1e6 / self.rtfreq
+        return self.st * 1e6 / self.stfreq
+
+    def advance(self, drt, dst):
+        self.st += dst
+        if self.rtfreq:
+            # The realtime delta is 24 bits wide, wraps are recovered using
+            # the system time delta.
+            expected = dst * self.rtfreq // self.stfreq
+            wraps = max(0, round((expected - drt) / float(1 << 24)))
+            self.rt += drt + wraps * (1 << 24)
+
+    def emit(self, ev):
+        ev.setdefault("pid", 1)
+        ev.setdefault("ts", self.timestamp())
+        self.events.append(ev)
+
+    def thread_name(self, tp):
+        return self.names.get(tp, "0x%x" % tp)
+
+    def frame(self, f):
+        if f is None or len(f) < 2:
+            self.emit({"name": "corrupted frame", "ph": "i", "s": "g",
+                       "tid": 0})
+            return
+        seq = f[0]
+        if self.seq is not None and seq != ((self.seq + 1) & 0xFF):
+            missing = (seq - self.seq - 1) & 0xFF
+            self.lost += missing
+            self.emit({"name": "lost %d records" % missing, "ph": "i",
+                       "s": "g", "tid": 0})
+        self.seq = seq
+        rtype = f[1] & 7
+        state = f[1] >> 3
+        pos = 2
+        if rtype == TYPE_UNUSED:
+            if state == CTRL_HEADER:
+                version, pos = varint(f, pos)
+                self.stfreq, pos = varint(f, pos)
+                self.rtfreq, pos = varint(f, pos)
+                self.rt = self.st = 0
+                self.current = None
+            elif state == CTRL_NAME:
+                tp, pos = varint(f, pos)
+                name = f[pos:].decode("latin-1")
+                if self.names.get(tp) != name:
+                    self.names[tp] = name
+                    self.events.append({"name": "thread_name", "ph": "M",
+                                        "pid": 1, "tid": tp,
+                                        "args": {"name": name}})
+            return
+        drt, pos = varint(f, pos)
+        dst, pos = varint(f, pos)
+        self.advance(drt, dst)
+        if rtype == TYPE_SWITCH:
+            ntp, pos = varint(f, pos)
+            wtobj, pos = varint(f, pos)
+            if self.current is not None:
+                self.emit({"name": self.thread_name(self.current), "ph": "E",
+                           "tid": self.current,
+                           "args": {"state": STATE_NAMES[state]
+                                    if state < len(STATE_NAMES) else state,
+                                    "wtobj": "0x%x" % wtobj}})
+            self.current = ntp
+            self.emit({"name": self.thread_name(ntp), "ph": "B", "tid": ntp})
+        elif rtype in (TYPE_ISR_ENTER, TYPE_ISR_LEAVE):
+            name, pos = varint(f, pos)
+            self.emit({"name": self.resolve(name),
+                       "ph": "B" if rtype == TYPE_ISR_ENTER else "E",
+                       "tid": 0})
+        elif rtype == TYPE_HALT:
+            reason, pos = varint(f, pos)
+            self.emit({"name": "halt: %s" % self.resolve(reason), "ph": "i",
+                       "s": "g", "tid": 0})
+        elif rtype == TYPE_USER:
+            up1, pos = varint(f, pos)
+            up2, pos = varint(f, pos)
+            self.emit({"name": "user %d" % state, "ph": "i", "s": "t",
+                       "tid": self.current or 0,
+                       "args": {"up1": "0x%x" % up1, "up2": "0x%x" % up2}})
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", help="raw stream capture file")
+    parser.add_argument("-e", "--elf", help="firmware ELF, resolves names")
+    parser.add_argument("-p", "--prefix", default="arm-none-eabi-",
+                        help="binutils prefix (default arm-none-eabi-)")
+    parser.add_argument("-o", "--output", default="-",
+                        help="output JSON file (default stdout)")
+    args = parser.parse_args()
+
+    with open(args.capture, "rb") as fh:
+        raw = fh.read()
+    resolve = load_strings(args.elf, args.prefix) if args.elf else \
+        (lambda ptr: "0x%x" % ptr)
+
+    dec = Decoder(resolve)
+    dec.events.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": 0,
+                       "args": {"name": "ISR"}})
+    for f in frames(raw):
+        dec.frame(f)
+
+    out = sys.stdout if args.output == "-" else open(args.output, "w")
+    json.dump({"traceEvents": dec.events, "displayTimeUnit": "ns"}, out)
+    if out is not sys.stdout:
+        out.close()
+    if dec.lost:
+        sys.stderr.write("warning: at least %d records lost\n" % dec.lost)
+
+
+if __name__ == "__main__":
+    main()